@@ -1197,6 +1197,17 @@ public:
     return MCEInstance;
   }
 
+  struct IndependentDisassembler {
+    std::unique_ptr<MCContext> LocalCtx;
+    std::unique_ptr<MCDisassembler> DisAsm;
+  };
+
+  /// Create an MCDisassembler that doesn't share any state with the main one
+  /// available through BinaryContext::DisAsm. MCDisassembler is not
+  /// thread-safe, hence threads decoding instructions concurrently should each
+  /// use their own instance.
+  IndependentDisassembler createIndependentMCDisassembler() const;
+
   /// Creating MCStreamer instance.
   std::unique_ptr<MCStreamer>
   createStreamer(llvm::raw_pwrite_stream &OS) const {
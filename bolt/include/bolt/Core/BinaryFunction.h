@@ -259,6 +259,17 @@ private:
   /// goto labels.
   std::set<uint64_t> ExternallyReferencedOffsets;
 
+  /// Instruction decoded by predecode() ahead of disassemble().
+  struct PredecodedInstruction {
+    uint64_t Offset;
+    uint64_t Size;
+    MCInst Inst;
+  };
+
+  /// Instructions decoded by predecode() in the order of their offsets.
+  /// Consumed and released by disassemble().
+  std::vector<PredecodedInstruction> PredecodedInstructions;
+
   /// Offsets of indirect branches with unknown destinations.
   std::set<uint64_t> UnknownIndirectBranchOffsets;
 
@@ -2104,6 +2115,13 @@ public:
   /// Returns false if disassembly failed.
   bool disassemble();
 
+  /// Decode raw instructions of the function using \p DisAsm and keep them
+  /// for a subsequent call to disassemble(). Decoding does not touch any state
+  /// shared with other functions, hence different functions could be
+  /// predecoded in parallel, as long as each thread uses its own disassembler.
+  /// Symbolization and the rest of disassemble() remain sequential.
+  void predecode(const MCDisassembler &DisAsm);
+
   /// Scan function for references to other functions. In relocation mode,
   /// add relocations for external references.
   ///
@@ -423,6 +423,15 @@ public:
     llvm_unreachable("not implemented");
   }
 
+  /// Create non-atomic increment of contents of \p Target by the value stored
+  /// at \p Increment for sampled Instrumentation
+  virtual void createInstrSampledIncMemory(InstructionListType &Instrs,
+                                           const MCSymbol *Target,
+                                           const MCSymbol *Increment,
+                                           MCContext *Ctx, bool IsLeaf) const {
+    llvm_unreachable("not implemented");
+  }
+
   /// Return a register number that is guaranteed to not match with
   /// any real register on the underlying architecture.
   virtual MCPhysReg getNoRegister() const {
@@ -111,6 +111,10 @@ struct InstrumentationSummary {
   MCSymbol *IndCallCounterFuncPtr;
   MCSymbol *IndTailCallCounterFuncPtr;
 
+  /// Value added to counters in sampled instrumentation mode. The runtime
+  /// toggles it between 1 and 0 to open and close counting windows.
+  MCSymbol *SampleIncrement{nullptr};
+
   /// Intra-function control flow and direct calls
   std::vector<FunctionDescription> FunctionDescriptions;
 
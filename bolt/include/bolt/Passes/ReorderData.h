@@ -31,6 +31,11 @@ private:
   std::pair<DataOrder, unsigned>
   sortedByCount(BinaryContext &BC, const BinarySection &Section) const;
 
+  /// Cluster hot symbols accessed from the same basic blocks, up to a size
+  /// limit, and sort clusters by access density.
+  std::pair<DataOrder, unsigned>
+  sortedByAffinity(BinaryContext &BC, const BinarySection &Section) const;
+
   std::pair<DataOrder, unsigned>
   sortedByFunc(BinaryContext &BC, const BinarySection &Section,
                std::map<uint64_t, BinaryFunction> &BFs) const;
@@ -15,6 +15,7 @@
 #include <cstdint>
 #include <map>
 #include <system_error>
+#include <vector>
 
 namespace llvm {
 class raw_ostream;
@@ -58,6 +59,11 @@ class BinaryFunction;
 /// The information on whether a given entry is a BB start or an instruction
 /// that changes control flow is encoded in the last (highest) bit of VALUE.
 ///
+/// In the serialized form, maps are sorted by function address and entries of
+/// each map are sorted by KEY, using fixed-size records. When reading, the maps
+/// are not copied: lookups binary search the section contents in place, so
+/// the cost of parsing does not depend on the number of entries.
+///
 /// Notes:
 /// Instructions that will never appear in LBR because they do not cause control
 /// flow change are omitted from this map. Basic block locations are recorded
@@ -82,15 +88,22 @@ public:
   /// function
   void write(raw_ostream &OS);
 
-  /// Read the serialized address translation tables and load them internally
-  /// in memory. Return a parse error if failed.
+  /// Validate the serialized address translation tables and index them by
+  /// function address. Entries are looked up directly in \p Buf, which must
+  /// outlive this object. Return a parse error if failed.
   std::error_code parse(StringRef Buf);
 
-  /// If the maps are loaded in memory, perform the lookup to translate LBR
-  /// addresses in \p Func.
+  /// If the maps are loaded, perform the lookup to translate LBR addresses in
+  /// \p Func.
   uint64_t translate(const BinaryFunction &Func, uint64_t Offset,
                      bool IsBranchSrc) const;
 
+  /// Translate \p Offset in the function, or the cold part of a function,
+  /// at output address \p FuncAddress. Does not depend on the BinaryContext
+  /// and can be used concurrently.
+  uint64_t translate(uint64_t FuncAddress, uint64_t Offset,
+                     bool IsBranchSrc) const;
+
   /// Use the map keys containing basic block addresses to infer fall-throughs
   /// taken in the path started at FirstLBR.To and ending at SecondLBR.From.
   /// Return NoneType if trace is invalid or the list of fall-throughs
@@ -99,6 +112,11 @@ public:
                                                      uint64_t From,
                                                      uint64_t To) const;
 
+  /// Same as above for the function at output address \p FuncAddress.
+  Optional<FallthroughListTy> getFallthroughsInTrace(uint64_t FuncAddress,
+                                                     uint64_t From,
+                                                     uint64_t To) const;
+
   /// If available, fetch the address of the hot part linked to the cold part
   /// at \p Address. Return 0 otherwise.
   uint64_t fetchParentAddress(uint64_t Address) const;
@@ -115,10 +133,30 @@ private:
   void writeEntriesForBB(MapTy &Map, const BinaryBasicBlock &BB,
                          uint64_t FuncAddress);
 
+  /// Translation map of a function as stored in the serialized section
+  struct SerializedMap {
+    uint64_t Address;
+    /// NumEntries pairs of 32-bit little-endian KEY and VALUE
+    StringRef Entries;
+
+    size_t size() const { return Entries.size() / 8; }
+    uint32_t getKey(size_t Index) const;
+    uint32_t getValue(size_t Index) const;
+    /// Index of the first entry with KEY greater than \p Offset
+    size_t upperBound(uint64_t Offset) const;
+  };
+
+  /// Return the parsed map for the function at \p Address, or nullptr
+  const SerializedMap *getSerializedMap(uint64_t Address) const;
+
   BinaryContext &BC;
 
+  /// Maps being written to the output binary
   std::map<uint64_t, MapTy> Maps;
 
+  /// Maps read from the input binary, sorted by function address
+  std::vector<SerializedMap> SerializedMaps;
+
   /// Links outlined cold bocks to their original function
   std::map<uint64_t, uint64_t> ColdPartSource;
 
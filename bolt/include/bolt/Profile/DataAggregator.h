@@ -127,6 +127,16 @@ private:
     uint64_t MispredCount{0};
   };
 
+  /// Branches and fall-throughs aggregated from a subset of the LBR samples,
+  /// together with the trace statistics collected while aggregating them.
+  struct LBRAggregation {
+    std::unordered_map<Trace, BranchInfo, TraceHash> BranchLBRs;
+    std::unordered_map<Trace, FTInfo, TraceHash> FallthroughLBRs;
+    uint64_t NumTraces{0};
+    uint64_t NumInvalidTraces{0};
+    uint64_t NumLongRangeTraces{0};
+  };
+
   /// Intermediate storage for profile data. We save the results of parsing
   /// and use them later for processing and assigning profile.
   std::unordered_map<Trace, BranchInfo, TraceHash> BranchLBRs;
@@ -288,6 +298,12 @@ private:
   /// return the error. Otherwise, return the parsed sample.
   ErrorOr<PerfBranchSample> parseBranchSample();
 
+  /// Aggregate the taken branches and fall-through traces of \p Samples into
+  /// \p Aggr. Only reads the state of the aggregator, so disjoint sets of
+  /// samples can be aggregated in parallel.
+  void aggregateLBRs(ArrayRef<PerfBranchSample> Samples,
+                     LBRAggregation &Aggr) const;
+
   /// Parse a single perf sample containing a PID associated with an event name
   /// and a PC
   ErrorOr<PerfBasicSample> parseBasicSample();
@@ -247,6 +247,16 @@ BinaryContext::createBinaryContext(const ObjectFile *File, bool IsPIC,
   return BC;
 }
 
+BinaryContext::IndependentDisassembler
+BinaryContext::createIndependentMCDisassembler() const {
+  IndependentDisassembler DisAsmInstance;
+  DisAsmInstance.LocalCtx.reset(
+      new MCContext(*TheTriple, AsmInfo.get(), MRI.get(), STI.get()));
+  DisAsmInstance.DisAsm.reset(
+      TheTarget->createMCDisassembler(*STI, *DisAsmInstance.LocalCtx));
+  return DisAsmInstance;
+}
+
 bool BinaryContext::forceSymbolRelocations(StringRef SymbolName) const {
   if (opts::HotText &&
       (SymbolName == "__hot_start" || SymbolName == "__hot_end"))
@@ -1024,6 +1024,30 @@ bool BinaryFunction::isZeroPaddingAt(uint64_t Offset) const {
   return true;
 }
 
+void BinaryFunction::predecode(const MCDisassembler &DisAsm) {
+  ErrorOr<ArrayRef<uint8_t>> ErrorOrFunctionData = getData();
+  if (!ErrorOrFunctionData)
+    return;
+  ArrayRef<uint8_t> FunctionData = *ErrorOrFunctionData;
+
+  PredecodedInstructions.clear();
+  uint64_t Size = 0; // instruction size
+  for (uint64_t Offset = 0; Offset < getSize(); Offset += Size) {
+    if (const size_t DataInCodeSize = getSizeOfDataInCodeAt(Offset)) {
+      Size = DataInCodeSize;
+      continue;
+    }
+
+    MCInst Instruction;
+    // Leave error reporting to disassemble().
+    if (!DisAsm.getInstruction(Instruction, Size, FunctionData.slice(Offset),
+                               getAddress() + Offset, nulls()))
+      break;
+
+    PredecodedInstructions.push_back({Offset, Size, std::move(Instruction)});
+  }
+}
+
 bool BinaryFunction::disassemble() {
   NamedRegionTimer T("disassemble", "Disassemble function", "buildfuncs",
                      "Build Binary Functions", opts::TimeBuild);
@@ -1198,6 +1222,7 @@ bool BinaryFunction::disassemble() {
     }
   };
 
+  auto NextPredecoded = PredecodedInstructions.begin();
   uint64_t Size = 0; // instruction size
   for (uint64_t Offset = 0; Offset < getSize(); Offset += Size) {
     MCInst Instruction;
@@ -1209,9 +1234,25 @@ bool BinaryFunction::disassemble() {
       continue;
     }
 
-    if (!BC.DisAsm->getInstruction(Instruction, Size,
-                                   FunctionData.slice(Offset),
-                                   AbsoluteInstrAddr, nulls())) {
+    // Use the instruction decoded by predecode() if there is one at this
+    // offset. Otherwise, decode it now.
+    while (NextPredecoded != PredecodedInstructions.end() &&
+           NextPredecoded->Offset < Offset)
+      ++NextPredecoded;
+    bool Decoded;
+    if (NextPredecoded != PredecodedInstructions.end() &&
+        NextPredecoded->Offset == Offset) {
+      Instruction = std::move(NextPredecoded->Inst);
+      Size = NextPredecoded->Size;
+      ++NextPredecoded;
+      Decoded = true;
+    } else {
+      Decoded = BC.DisAsm->getInstruction(Instruction, Size,
+                                          FunctionData.slice(Offset),
+                                          AbsoluteInstrAddr, nulls());
+    }
+
+    if (!Decoded) {
       // Functions with "soft" boundaries, e.g. coming from assembly source,
       // can have 0-byte padding at the end.
       if (isZeroPaddingAt(Offset))
@@ -1418,6 +1459,7 @@ add_instruction:
     addInstruction(Offset, std::move(Instruction));
   }
 
+  clearList(PredecodedInstructions);
   clearList(Relocations);
 
   if (!IsSimple) {
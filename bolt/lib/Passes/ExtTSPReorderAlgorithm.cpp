@@ -36,6 +36,7 @@
 #include "bolt/Core/BinaryFunction.h"
 #include "bolt/Passes/ReorderAlgorithm.h"
 #include "llvm/Support/CommandLine.h"
+#include <queue>
 
 using namespace llvm;
 using namespace bolt;
@@ -614,45 +615,92 @@ private:
     }
   }
 
+  /// A candidate pair of chains for merging. The key fields are copied from
+  /// the chains so that the ordering of the queue is not affected when the
+  /// chains are merged with others and the candidate becomes stale.
+  struct MergeCandidate {
+    double Score;
+    uint64_t Samples;
+    size_t PredId;
+    size_t SuccId;
+    Chain *ChainPred;
+    Chain *ChainSucc;
+
+    /// Returns true iff Other is preferred over this; ties are broken as in
+    /// compareChainPairs.
+    bool operator<(const MergeCandidate &Other) const {
+      if (Score != Other.Score)
+        return Score < Other.Score;
+      if (Samples != Other.Samples)
+        return Samples > Other.Samples;
+      if (PredId != Other.PredId)
+        return PredId > Other.PredId;
+      return SuccId > Other.SuccId;
+    }
+  };
+
+  /// Compute the gain of merging ChainSucc after ChainPred and, if positive,
+  /// add the pair to the queue of candidates
+  void addMergeCandidate(std::priority_queue<MergeCandidate> &Candidates,
+                         Chain *ChainPred, Chain *ChainSucc, Edge *ChainEdge) {
+    // Ignore loop edges
+    if (ChainPred == ChainSucc)
+      return;
+
+    const MergeGainTy Gain = mergeGain(ChainPred, ChainSucc, ChainEdge);
+    if (Gain.score() <= EPS)
+      return;
+
+    Candidates.push({Gain.score(),
+                     ChainPred->executionCount() + ChainSucc->executionCount(),
+                     ChainPred->id(), ChainSucc->id(), ChainPred, ChainSucc});
+  }
+
   /// Merge pairs of chains while improving the ExtTSP objective
+  ///
+  /// The gain of merging two chains depends only on the two chains, so it
+  /// only needs to be recomputed for the neighbors of a newly merged chain.
+  /// Candidates are kept in a priority queue, and the ones that became stale
+  /// after a merge are dropped when they reach the top of the queue. This
+  /// avoids rescanning all pairs of chains after every merge.
   void mergeChainPairs() {
-    while (HotChains.size() > 1) {
-      Chain *BestChainPred = nullptr;
-      Chain *BestChainSucc = nullptr;
-      auto BestGain = MergeGainTy();
-      // Iterate over all pairs of chains
-      for (Chain *ChainPred : HotChains) {
-        // Get candidates for merging with the current chain
-        for (auto EdgeIter : ChainPred->edges()) {
-          Chain *ChainSucc = EdgeIter.first;
-          Edge *ChainEdge = EdgeIter.second;
-          // Ignore loop edges
-          if (ChainPred == ChainSucc)
-            continue;
-
-          // Compute the gain of merging the two chains
-          MergeGainTy CurGain = mergeGain(ChainPred, ChainSucc, ChainEdge);
-          if (CurGain.score() <= EPS)
-            continue;
-
-          if (BestGain < CurGain ||
-              (std::abs(CurGain.score() - BestGain.score()) < EPS &&
-               compareChainPairs(ChainPred, ChainSucc, BestChainPred,
-                                 BestChainSucc))) {
-            BestGain = CurGain;
-            BestChainPred = ChainPred;
-            BestChainSucc = ChainSucc;
-          }
-        }
-      }
+    std::priority_queue<MergeCandidate> Candidates;
+    for (Chain *ChainPred : HotChains) {
+      if (ChainPred->blocks().empty())
+        continue;
+      for (std::pair<Chain *, Edge *> EdgeIter : ChainPred->edges())
+        addMergeCandidate(Candidates, ChainPred, EdgeIter.first,
+                          EdgeIter.second);
+    }
 
-      // Stop merging when there is no improvement
-      if (BestGain.score() <= EPS)
-        break;
+    while (!Candidates.empty()) {
+      const MergeCandidate Candidate = Candidates.top();
+      Candidates.pop();
+
+      // Skip candidates involving a chain merged away since the candidate was
+      // added
+      Chain *ChainPred = Candidate.ChainPred;
+      Chain *ChainSucc = Candidate.ChainSucc;
+      if (ChainPred->blocks().empty() || ChainSucc->blocks().empty())
+        continue;
+      Edge *ChainEdge = ChainPred->getEdge(ChainSucc);
+      assert(ChainEdge && "no edge between chains of a merge candidate");
+
+      // Skip candidates whose gain changed since the candidate was added; the
+      // up-to-date gain has been queued when the chains were last merged
+      const MergeGainTy Gain = mergeGain(ChainPred, ChainSucc, ChainEdge);
+      if (Gain.score() != Candidate.Score)
+        continue;
 
       // Merge the best pair of chains
-      mergeChains(BestChainPred, BestChainSucc, BestGain.mergeOffset(),
-                  BestGain.mergeType());
+      mergeChains(ChainPred, ChainSucc, Gain.mergeOffset(), Gain.mergeType());
+
+      // Queue the updated gains of the neighbors of the merged chain
+      for (std::pair<Chain *, Edge *> EdgeIter : ChainPred->edges()) {
+        Chain *Other = EdgeIter.first;
+        addMergeCandidate(Candidates, ChainPred, Other, EdgeIter.second);
+        addMergeCandidate(Candidates, Other, ChainPred, EdgeIter.second);
+      }
     }
   }
 
@@ -814,10 +862,6 @@ private:
       Into->setScore(score(MergedBlocks, SelfEdge->jumps()));
     }
 
-    // Remove chain From from the list of active chains
-    auto Iter = std::remove(HotChains.begin(), HotChains.end(), From);
-    HotChains.erase(Iter, HotChains.end());
-
     // Invalidate caches
     for (std::pair<Chain *, Edge *> EdgeIter : Into->edges())
       EdgeIter.second->invalidateCache();
@@ -870,7 +914,8 @@ private:
   // All chains of blocks
   std::vector<Chain> AllChains;
 
-  // Active chains. The vector gets updated at runtime when chains are merged
+  // Chains with a positive execution count. Chains merged into others are
+  // left empty rather than removed from the vector
   std::vector<Chain *> HotChains;
 
   // All edges between chains
@@ -55,6 +55,19 @@ cl::opt<uint32_t> InstrumentationSleepTime(
              "program and the profile is not being dumped at the end."),
     cl::init(0), cl::Optional, cl::cat(BoltInstrCategory));
 
+cl::opt<uint32_t> InstrumentationSampleOffTime(
+    "instrumentation-sample-off-time",
+    cl::desc("enable sampled instrumentation: stop counting for this many "
+             "seconds between counting windows, and update counters without "
+             "atomic operations (default: 0 = always count)"),
+    cl::init(0), cl::Optional, cl::cat(BoltInstrCategory));
+
+cl::opt<uint32_t> InstrumentationSampleOnTime(
+    "instrumentation-sample-on-time",
+    cl::desc("length in seconds of counting windows in sampled instrumentation "
+             "(use with instrumentation-sample-off-time option, default: 1)"),
+    cl::init(1), cl::Optional, cl::cat(BoltInstrCategory));
+
 cl::opt<bool> InstrumentationNoCountersClear(
     "instrumentation-no-counters-clear",
     cl::desc("Don't clear counters across dumps "
@@ -177,7 +190,12 @@ Instrumentation::createInstrumentationSnippet(BinaryContext &BC, bool IsLeaf) {
   Label = BC.Ctx->createNamedTempSymbol("InstrEntry");
   Summary->Counters.emplace_back(Label);
   InstructionListType CounterInstrs;
-  BC.MIB->createInstrIncMemory(CounterInstrs, Label, &*BC.Ctx, IsLeaf);
+  if (Summary->SampleIncrement)
+    BC.MIB->createInstrSampledIncMemory(CounterInstrs, Label,
+                                        Summary->SampleIncrement, &*BC.Ctx,
+                                        IsLeaf);
+  else
+    BC.MIB->createInstrIncMemory(CounterInstrs, Label, &*BC.Ctx, IsLeaf);
   return CounterInstrs;
 }
 
@@ -526,6 +544,9 @@ void Instrumentation::runOnFunctions(BinaryContext &BC) {
       BC.Ctx->getOrCreateSymbol("__bolt_ind_call_counter_func_pointer");
   Summary->IndTailCallCounterFuncPtr =
       BC.Ctx->getOrCreateSymbol("__bolt_ind_tailcall_counter_func_pointer");
+  if (opts::InstrumentationSampleOffTime)
+    Summary->SampleIncrement =
+        BC.Ctx->getOrCreateSymbol("__bolt_instr_sample_increment");
 
   createAuxiliaryFunctions(BC);
 
@@ -45,7 +45,8 @@ ReorderData("reorder-data",
 
 enum ReorderAlgo : char {
   REORDER_COUNT         = 0,
-  REORDER_FUNCS         = 1
+  REORDER_FUNCS         = 1,
+  REORDER_AFFINITY      = 2
 };
 
 static cl::opt<ReorderAlgo>
@@ -58,7 +59,10 @@ ReorderAlgorithm("reorder-data-algo",
       "sort hot data by read counts"),
     clEnumValN(REORDER_FUNCS,
       "funcs",
-      "sort hot data by hot function usage and count")),
+      "sort hot data by hot function usage and count"),
+    clEnumValN(REORDER_AFFINITY,
+      "affinity",
+      "cluster hot data accessed from the same basic blocks")),
   cl::ZeroOrMore,
   cl::cat(BoltOptCategory));
 
@@ -76,6 +80,14 @@ ReorderDataMaxBytes("reorder-data-max-bytes",
   cl::init(std::numeric_limits<unsigned>::max()),
   cl::cat(BoltOptCategory));
 
+static cl::opt<unsigned>
+ReorderDataClusterSize("reorder-data-cluster-size",
+  cl::desc("maximum size in bytes of a cluster of co-accessed data "
+           "(for -reorder-data-algo=affinity)"),
+  cl::ZeroOrMore,
+  cl::init(4096),
+  cl::cat(BoltOptCategory));
+
 static cl::list<std::string>
 ReorderSymbols("reorder-symbols",
   cl::CommaSeparated,
@@ -338,6 +350,135 @@ ReorderData::sortedByCount(BinaryContext &BC,
   return std::make_pair(Order, SplitPoint);
 }
 
+std::pair<DataOrder, unsigned>
+ReorderData::sortedByAffinity(BinaryContext &BC,
+                              const BinarySection &Section) const {
+  // Limit on the number of objects from a single basic block contributing to
+  // affinity, to keep the number of pairs linear in the profile size.
+  constexpr size_t MaxObjectsPerBlock = 16;
+
+  DataOrder Order = baseOrder(BC, Section);
+
+  // Hot objects of the section, indexed in their original order.
+  DataOrder Hot;
+  std::unordered_map<const BinaryData *, size_t> HotIndex;
+  for (const DataOrder::value_type &Entry : Order) {
+    if (!Entry.second)
+      continue;
+    HotIndex[Entry.first] = Hot.size();
+    Hot.push_back(Entry);
+  }
+
+  // Affinity of a pair of objects is the number of accesses to both of them
+  // from the same basic block.
+  std::map<std::pair<size_t, size_t>, uint64_t> Affinity;
+  for (auto &BFI : BC.getBinaryFunctions()) {
+    const BinaryFunction &BF = BFI.second;
+    if (!BF.hasMemoryProfile())
+      continue;
+
+    for (const BinaryBasicBlock &BB : BF) {
+      std::map<size_t, uint64_t> Accessed;
+      for (const MCInst &Inst : BB) {
+        auto ErrorOrMemAccesssProfile =
+            BC.MIB->tryGetAnnotationAs<MemoryAccessProfile>(
+                Inst, "MemoryAccessProfile");
+        if (!ErrorOrMemAccesssProfile)
+          continue;
+
+        for (const AddressAccess &AccessInfo :
+             ErrorOrMemAccesssProfile.get().AddressAccessInfo) {
+          if (!AccessInfo.MemoryObject)
+            continue;
+          auto It = HotIndex.find(AccessInfo.MemoryObject->getAtomicRoot());
+          if (It != HotIndex.end())
+            Accessed[It->second] += AccessInfo.Count;
+        }
+      }
+      if (Accessed.size() < 2)
+        continue;
+
+      std::vector<std::pair<size_t, uint64_t>> Objects(Accessed.begin(),
+                                                       Accessed.end());
+      if (Objects.size() > MaxObjectsPerBlock) {
+        std::stable_sort(Objects.begin(), Objects.end(),
+                         [](const std::pair<size_t, uint64_t> &A,
+                            const std::pair<size_t, uint64_t> &B) {
+                           return A.second > B.second;
+                         });
+        Objects.resize(MaxObjectsPerBlock);
+      }
+      for (size_t I = 0; I < Objects.size(); ++I)
+        for (size_t J = I + 1; J < Objects.size(); ++J)
+          Affinity[std::minmax(Objects[I].first, Objects[J].first)] +=
+              std::min(Objects[I].second, Objects[J].second);
+    }
+  }
+
+  // Greedily merge clusters connected by the heaviest affinity edges as long
+  // as the merged cluster fits into the size limit, so that data accessed
+  // together shares cache lines and pages.
+  struct Cluster {
+    std::vector<size_t> Members;
+    uint64_t Size;
+    uint64_t Count;
+  };
+  std::vector<Cluster> Clusters;
+  std::vector<size_t> ClusterOf(Hot.size());
+  Clusters.reserve(Hot.size());
+  for (size_t I = 0; I < Hot.size(); ++I) {
+    ClusterOf[I] = I;
+    Clusters.push_back({{I}, Hot[I].first->getSize(), Hot[I].second});
+  }
+
+  std::vector<std::pair<std::pair<size_t, size_t>, uint64_t>> Edges(
+      Affinity.begin(), Affinity.end());
+  std::stable_sort(Edges.begin(), Edges.end(),
+                   [](const std::pair<std::pair<size_t, size_t>, uint64_t> &A,
+                      const std::pair<std::pair<size_t, size_t>, uint64_t> &B) {
+                     return A.second > B.second;
+                   });
+  for (const std::pair<std::pair<size_t, size_t>, uint64_t> &Edge : Edges) {
+    Cluster &Into = Clusters[ClusterOf[Edge.first.first]];
+    Cluster &From = Clusters[ClusterOf[Edge.first.second]];
+    if (&Into == &From || Into.Size + From.Size > opts::ReorderDataClusterSize)
+      continue;
+
+    for (size_t Member : From.Members)
+      ClusterOf[Member] = ClusterOf[Edge.first.first];
+    Into.Members.insert(Into.Members.end(), From.Members.begin(),
+                        From.Members.end());
+    Into.Size += From.Size;
+    Into.Count += From.Count;
+    From.Members.clear();
+  }
+
+  // Order clusters by access density.
+  std::vector<const Cluster *> SortedClusters;
+  for (const Cluster &C : Clusters)
+    if (!C.Members.empty())
+      SortedClusters.push_back(&C);
+  std::stable_sort(SortedClusters.begin(), SortedClusters.end(),
+                   [](const Cluster *A, const Cluster *B) {
+                     const double ADensity =
+                         double(A->Count) / std::max<uint64_t>(A->Size, 1);
+                     const double BDensity =
+                         double(B->Count) / std::max<uint64_t>(B->Size, 1);
+                     return ADensity > BDensity;
+                   });
+
+  DataOrder NewOrder;
+  NewOrder.reserve(Order.size());
+  for (const Cluster *C : SortedClusters)
+    for (size_t Member : C->Members)
+      NewOrder.push_back(Hot[Member]);
+  for (const DataOrder::value_type &Entry : Order)
+    if (!Entry.second)
+      NewOrder.push_back(Entry);
+
+  return std::make_pair(NewOrder, Hot.size());
+}
+
 // TODO
 // add option for cache-line alignment (or just use cache-line when section
 // is writeable)?
@@ -497,6 +638,9 @@ void ReorderData::runOnFunctions(BinaryContext &BC) {
     if (opts::ReorderAlgorithm == opts::ReorderAlgo::REORDER_COUNT) {
       outs() << "BOLT-INFO: reorder-sections: ordering data by count\n";
       std::tie(Order, SplitPointIdx) = sortedByCount(BC, *Section);
+    } else if (opts::ReorderAlgorithm == opts::ReorderAlgo::REORDER_AFFINITY) {
+      outs() << "BOLT-INFO: reorder-sections: ordering data by affinity\n";
+      std::tie(Order, SplitPointIdx) = sortedByAffinity(BC, *Section);
     } else {
       outs() << "BOLT-INFO: reorder-sections: ordering data by funcs\n";
       std::tie(Order, SplitPointIdx) =
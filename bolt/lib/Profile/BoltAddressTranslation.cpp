@@ -9,6 +9,7 @@
 #include "bolt/Profile/BoltAddressTranslation.h"
 #include "bolt/Core/BinaryFunction.h"
 #include "llvm/Support/DataExtractor.h"
+#include "llvm/Support/Endian.h"
 #include "llvm/Support/Errc.h"
 
 #define DEBUG_TYPE "bolt-bat"
@@ -149,26 +150,30 @@ std::error_code BoltAddressTranslation::parse(StringRef Buf) {
 
   const uint32_t NumFunctions = DE.getU32(&Offset);
   LLVM_DEBUG(dbgs() << "Parsing " << NumFunctions << " functions\n");
+  SerializedMaps.clear();
+  SerializedMaps.reserve(NumFunctions);
   for (uint32_t I = 0; I < NumFunctions; ++I) {
     if (Buf.size() - Offset < 12)
       return make_error_code(llvm::errc::io_error);
 
     const uint64_t Address = DE.getU64(&Offset);
-    const uint32_t NumEntries = DE.getU32(&Offset);
-    MapTy Map;
+    const uint64_t NumEntries = DE.getU32(&Offset);
 
     LLVM_DEBUG(dbgs() << "Parsing " << NumEntries << " entries for 0x"
                       << Twine::utohexstr(Address) << "\n");
     if (Buf.size() - Offset < 8 * NumEntries)
       return make_error_code(llvm::errc::io_error);
-    for (uint32_t J = 0; J < NumEntries; ++J) {
-      const uint32_t OutputAddr = DE.getU32(&Offset);
-      const uint32_t InputAddr = DE.getU32(&Offset);
-      Map.insert(std::pair<uint32_t, uint32_t>(OutputAddr, InputAddr));
-      LLVM_DEBUG(dbgs() << Twine::utohexstr(OutputAddr) << " -> "
-                        << Twine::utohexstr(InputAddr) << "\n");
-    }
-    Maps.insert(std::pair<uint64_t, MapTy>(Address, Map));
+
+    // Entries are written in the order of their keys and are searched in
+    // place.
+    SerializedMap Map{Address, Buf.substr(Offset, 8 * NumEntries)};
+    for (size_t J = 1; J < Map.size(); ++J)
+      if (Map.getKey(J - 1) >= Map.getKey(J))
+        return make_error_code(llvm::errc::io_error);
+    if (!SerializedMaps.empty() && SerializedMaps.back().Address >= Address)
+      return make_error_code(llvm::errc::io_error);
+    SerializedMaps.push_back(Map);
+    Offset += 8 * NumEntries;
   }
 
   if (Buf.size() - Offset < 4)
@@ -179,92 +184,137 @@ std::error_code BoltAddressTranslation::parse(StringRef Buf) {
   for (uint32_t I = 0; I < NumColdEntries; ++I) {
     if (Buf.size() - Offset < 16)
       return make_error_code(llvm::errc::io_error);
-    const uint32_t ColdAddress = DE.getU64(&Offset);
-    const uint32_t HotAddress = DE.getU64(&Offset);
+    const uint64_t ColdAddress = DE.getU64(&Offset);
+    const uint64_t HotAddress = DE.getU64(&Offset);
     ColdPartSource.insert(
         std::pair<uint64_t, uint64_t>(ColdAddress, HotAddress));
     LLVM_DEBUG(dbgs() << Twine::utohexstr(ColdAddress) << " -> "
                       << Twine::utohexstr(HotAddress) << "\n");
   }
-  outs() << "BOLT-INFO: Parsed " << Maps.size() << " BAT entries\n";
+  outs() << "BOLT-INFO: Parsed " << SerializedMaps.size() << " BAT entries\n";
   outs() << "BOLT-INFO: Parsed " << NumColdEntries
          << " BAT cold-to-hot entries\n";
 
   return std::error_code();
 }
 
+uint32_t
+BoltAddressTranslation::SerializedMap::getKey(size_t Index) const {
+  return support::endian::read32le(Entries.data() + 8 * Index);
+}
+
+uint32_t
+BoltAddressTranslation::SerializedMap::getValue(size_t Index) const {
+  return support::endian::read32le(Entries.data() + 8 * Index + 4);
+}
+
+size_t
+BoltAddressTranslation::SerializedMap::upperBound(uint64_t Offset) const {
+  size_t Begin = 0;
+  size_t End = size();
+  while (Begin < End) {
+    const size_t Mid = Begin + (End - Begin) / 2;
+    if (getKey(Mid) <= Offset)
+      Begin = Mid + 1;
+    else
+      End = Mid;
+  }
+  return Begin;
+}
+
+const BoltAddressTranslation::SerializedMap *
+BoltAddressTranslation::getSerializedMap(uint64_t Address) const {
+  auto Iter = llvm::partition_point(
+      SerializedMaps,
+      [&](const SerializedMap &Map) { return Map.Address < Address; });
+  if (Iter == SerializedMaps.end() || Iter->Address != Address)
+    return nullptr;
+  return &*Iter;
+}
+
 uint64_t BoltAddressTranslation::translate(const BinaryFunction &Func,
                                            uint64_t Offset,
                                            bool IsBranchSrc) const {
-  auto Iter = Maps.find(Func.getAddress());
-  if (Iter == Maps.end())
+  return translate(Func.getAddress(), Offset, IsBranchSrc);
+}
+
+uint64_t BoltAddressTranslation::translate(uint64_t FuncAddress,
+                                           uint64_t Offset,
+                                           bool IsBranchSrc) const {
+  const SerializedMap *Map = getSerializedMap(FuncAddress);
+  if (!Map)
     return Offset;
 
-  const MapTy &Map = Iter->second;
-  auto KeyVal = Map.upper_bound(Offset);
-  if (KeyVal == Map.begin())
+  size_t Index = Map->upperBound(Offset);
+  if (Index == 0)
     return Offset;
 
-  --KeyVal;
+  --Index;
 
-  const uint32_t Val = KeyVal->second & ~BRANCHENTRY;
+  const uint32_t Val = Map->getValue(Index) & ~BRANCHENTRY;
   // Branch source addresses are translated to the first instruction of the
   // source BB to avoid accounting for modifications BOLT may have made in the
   // BB regarding deletion/addition of instructions.
   if (IsBranchSrc)
     return Val;
-  return Offset - KeyVal->first + Val;
+  return Offset - Map->getKey(Index) + Val;
 }
 
 Optional<BoltAddressTranslation::FallthroughListTy>
 BoltAddressTranslation::getFallthroughsInTrace(const BinaryFunction &Func,
                                                uint64_t From,
                                                uint64_t To) const {
+  return getFallthroughsInTrace(Func.getAddress(), From, To);
+}
+
+Optional<BoltAddressTranslation::FallthroughListTy>
+BoltAddressTranslation::getFallthroughsInTrace(uint64_t FuncAddress,
+                                               uint64_t From,
+                                               uint64_t To) const {
   SmallVector<std::pair<uint64_t, uint64_t>, 16> Res;
 
   // Filter out trivial case
   if (From >= To)
     return Res;
 
-  From -= Func.getAddress();
-  To -= Func.getAddress();
+  From -= FuncAddress;
+  To -= FuncAddress;
 
-  auto Iter = Maps.find(Func.getAddress());
-  if (Iter == Maps.end())
+  const SerializedMap *Map = getSerializedMap(FuncAddress);
+  if (!Map)
     return NoneType();
 
-  const MapTy &Map = Iter->second;
-  auto FromIter = Map.upper_bound(From);
-  if (FromIter == Map.begin())
+  size_t FromIndex = Map->upperBound(From);
+  if (FromIndex == 0)
     return Res;
   // Skip instruction entries, to create fallthroughs we are only interested in
   // BB boundaries
   do {
-    if (FromIter == Map.begin())
+    if (FromIndex == 0)
       return Res;
-    --FromIter;
-  } while (FromIter->second & BRANCHENTRY);
+    --FromIndex;
+  } while (Map->getValue(FromIndex) & BRANCHENTRY);
 
-  auto ToIter = Map.upper_bound(To);
-  if (ToIter == Map.begin())
+  size_t ToIndex = Map->upperBound(To);
+  if (ToIndex == 0)
     return Res;
-  --ToIter;
-  if (FromIter->first >= ToIter->first)
+  --ToIndex;
+  if (Map->getKey(FromIndex) >= Map->getKey(ToIndex))
     return Res;
 
-  for (auto Iter = FromIter; Iter != ToIter;) {
-    const uint32_t Src = Iter->first;
-    if (Iter->second & BRANCHENTRY) {
-      ++Iter;
+  for (size_t Index = FromIndex; Index != ToIndex;) {
+    const uint32_t Src = Map->getKey(Index);
+    if (Map->getValue(Index) & BRANCHENTRY) {
+      ++Index;
       continue;
     }
 
-    ++Iter;
-    while (Iter->second & BRANCHENTRY && Iter != ToIter)
-      ++Iter;
-    if (Iter->second & BRANCHENTRY)
+    ++Index;
+    while (Map->getValue(Index) & BRANCHENTRY && Index != ToIndex)
+      ++Index;
+    if (Map->getValue(Index) & BRANCHENTRY)
       break;
-    Res.emplace_back(Src, Iter->first);
+    Res.emplace_back(Src, Map->getKey(Index));
   }
 
   return Res;
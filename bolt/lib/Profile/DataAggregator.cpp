@@ -14,6 +14,7 @@
 #include "bolt/Profile/DataAggregator.h"
 #include "bolt/Core/BinaryContext.h"
 #include "bolt/Core/BinaryFunction.h"
+#include "bolt/Core/ParallelUtilities.h"
 #include "bolt/Profile/BoltAddressTranslation.h"
 #include "bolt/Profile/Heatmap.h"
 #include "bolt/Utils/CommandLineOpts.h"
@@ -25,6 +26,7 @@
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/Regex.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include <map>
@@ -1357,6 +1359,73 @@ std::error_code DataAggregator::printLBRHeatMap() {
   return std::error_code();
 }
 
+void DataAggregator::aggregateLBRs(ArrayRef<PerfBranchSample> Samples,
+                                   LBRAggregation &Aggr) const {
+  for (const PerfBranchSample &Sample : Samples) {
+    // LBRs are stored in reverse execution order. NextPC refers to the next
+    // recorded executed PC. The function containing it is looked up lazily,
+    // or carried over from the source of the previous LBR entry, so that each
+    // entry costs two address lookups.
+    uint64_t NextPC = opts::UseEventPC ? Sample.PC : 0;
+    const BinaryFunction *NextBF = nullptr;
+    bool HasNextBF = false;
+    for (const LBREntry &LBR : Sample.LBR) {
+      const BinaryFunction *FromBF =
+          getBinaryFunctionContainingAddress(LBR.From);
+      const BinaryFunction *ToBF = getBinaryFunctionContainingAddress(LBR.To);
+      if (NextPC) {
+        // Record fall-through trace.
+        const uint64_t TraceFrom = LBR.To;
+        const uint64_t TraceTo = NextPC;
+        const BinaryFunction *TraceBF = ToBF;
+        if (TraceBF && TraceBF->containsAddress(TraceTo)) {
+          FTInfo &Info = Aggr.FallthroughLBRs[Trace(TraceFrom, TraceTo)];
+          if (TraceBF->containsAddress(LBR.From))
+            ++Info.InternCount;
+          else
+            ++Info.ExternCount;
+        } else {
+          if (!HasNextBF)
+            NextBF = getBinaryFunctionContainingAddress(TraceTo);
+          if (TraceBF && NextBF) {
+            LLVM_DEBUG(dbgs()
+                       << "Invalid trace starting in "
+                       << TraceBF->getPrintName() << " @ "
+                       << Twine::utohexstr(TraceFrom - TraceBF->getAddress())
+                       << " and ending @ " << Twine::utohexstr(TraceTo)
+                       << '\n');
+            ++Aggr.NumInvalidTraces;
+          } else {
+            LLVM_DEBUG(dbgs()
+                       << "Out of range trace starting in "
+                       << (TraceBF ? TraceBF->getPrintName() : "None") << " @ "
+                       << Twine::utohexstr(
+                              TraceFrom - (TraceBF ? TraceBF->getAddress() : 0))
+                       << " and ending in "
+                       << (NextBF ? NextBF->getPrintName() : "None") << " @ "
+                       << Twine::utohexstr(
+                              TraceTo - (NextBF ? NextBF->getAddress() : 0))
+                       << '\n');
+            ++Aggr.NumLongRangeTraces;
+          }
+        }
+        ++Aggr.NumTraces;
+      }
+      NextPC = LBR.From;
+      NextBF = FromBF;
+      HasNextBF = true;
+
+      const uint64_t From = FromBF ? LBR.From : 0;
+      const uint64_t To = ToBF ? LBR.To : 0;
+      if (!From && !To)
+        continue;
+      BranchInfo &Info = Aggr.BranchLBRs[Trace(From, To)];
+      ++Info.TakenCount;
+      Info.MispredCount += LBR.Mispred;
+    }
+  }
+}
+
 std::error_code DataAggregator::parseBranchEvents() {
   outs() << "PERF2BOLT: parse branch events...\n";
   NamedRegionTimer T("parseBranch", "Parsing branch events", TimerGroupName,
@@ -1369,6 +1438,32 @@ std::error_code DataAggregator::parseBranchEvents() {
   uint64_t NumTraces = 0;
   bool NeedsSkylakeFix = false;
 
+  // Samples are parsed sequentially and aggregated in batches. Each batch is
+  // split into one slice per thread, and every slice is aggregated into its
+  // own maps. The maps are merged in slice order once all samples are read.
+  constexpr size_t BatchSize = 1 << 14;
+  const unsigned NumSlices =
+      opts::NoThreads ? 1 : std::max(1U, opts::ThreadCount.getValue());
+  std::vector<LBRAggregation> Slices(NumSlices);
+  std::vector<PerfBranchSample> Batch;
+  Batch.reserve(BatchSize);
+
+  auto aggregateBatch = [&]() {
+    if (NumSlices == 1) {
+      aggregateLBRs(Batch, Slices.front());
+    } else {
+      ThreadPool &Pool = ParallelUtilities::getThreadPool();
+      const size_t SliceSize = divideCeil(Batch.size(), NumSlices);
+      for (unsigned I = 0; I < NumSlices && I * SliceSize < Batch.size(); ++I) {
+        ArrayRef<PerfBranchSample> Slice =
+            makeArrayRef(Batch).slice(I * SliceSize).take_front(SliceSize);
+        Pool.async([&, Slice, I] { aggregateLBRs(Slice, Slices[I]); });
+      }
+      Pool.wait();
+    }
+    Batch.clear();
+  };
+
   while (hasData() && NumTotalSamples < opts::MaxSamples) {
     ++NumTotalSamples;
 
@@ -1395,79 +1490,39 @@ std::error_code DataAggregator::parseBranchEvents() {
       NeedsSkylakeFix = true;
     }
 
-    // LBRs are stored in reverse execution order. NextPC refers to the next
-    // recorded executed PC.
-    uint64_t NextPC = opts::UseEventPC ? Sample.PC : 0;
-    uint32_t NumEntry = 0;
-    for (const LBREntry &LBR : Sample.LBR) {
-      ++NumEntry;
-      // Hardware bug workaround: Intel Skylake (which has 32 LBR entries)
-      // sometimes record entry 32 as an exact copy of entry 31. This will cause
-      // us to likely record an invalid trace and generate a stale function for
-      // BAT mode (non BAT disassembles the function and is able to ignore this
-      // trace at aggregation time). Drop first 2 entries (last two, in
-      // chronological order)
-      if (NeedsSkylakeFix && NumEntry <= 2)
-        continue;
-      if (NextPC) {
-        // Record fall-through trace.
-        const uint64_t TraceFrom = LBR.To;
-        const uint64_t TraceTo = NextPC;
-        const BinaryFunction *TraceBF =
-            getBinaryFunctionContainingAddress(TraceFrom);
-        if (TraceBF && TraceBF->containsAddress(TraceTo)) {
-          FTInfo &Info = FallthroughLBRs[Trace(TraceFrom, TraceTo)];
-          if (TraceBF->containsAddress(LBR.From))
-            ++Info.InternCount;
-          else
-            ++Info.ExternCount;
-        } else {
-          if (TraceBF && getBinaryFunctionContainingAddress(TraceTo)) {
-            LLVM_DEBUG(dbgs()
-                       << "Invalid trace starting in "
-                       << TraceBF->getPrintName() << " @ "
-                       << Twine::utohexstr(TraceFrom - TraceBF->getAddress())
-                       << " and ending @ " << Twine::utohexstr(TraceTo)
-                       << '\n');
-            ++NumInvalidTraces;
-          } else {
-            LLVM_DEBUG(dbgs()
-                       << "Out of range trace starting in "
-                       << (TraceBF ? TraceBF->getPrintName() : "None") << " @ "
-                       << Twine::utohexstr(
-                              TraceFrom - (TraceBF ? TraceBF->getAddress() : 0))
-                       << " and ending in "
-                       << (getBinaryFunctionContainingAddress(TraceTo)
-                               ? getBinaryFunctionContainingAddress(TraceTo)
-                                     ->getPrintName()
-                               : "None")
-                       << " @ "
-                       << Twine::utohexstr(
-                              TraceTo -
-                              (getBinaryFunctionContainingAddress(TraceTo)
-                                   ? getBinaryFunctionContainingAddress(TraceTo)
-                                         ->getAddress()
-                                   : 0))
-                       << '\n');
-            ++NumLongRangeTraces;
-          }
-        }
-        ++NumTraces;
-      }
-      NextPC = LBR.From;
-
-      uint64_t From = LBR.From;
-      if (!getBinaryFunctionContainingAddress(From))
-        From = 0;
-      uint64_t To = LBR.To;
-      if (!getBinaryFunctionContainingAddress(To))
-        To = 0;
-      if (!From && !To)
-        continue;
-      BranchInfo &Info = BranchLBRs[Trace(From, To)];
-      ++Info.TakenCount;
-      Info.MispredCount += LBR.Mispred;
+    // Hardware bug workaround: Intel Skylake (which has 32 LBR entries)
+    // sometimes record entry 32 as an exact copy of entry 31. This will cause
+    // us to likely record an invalid trace and generate a stale function for
+    // BAT mode (non BAT disassembles the function and is able to ignore this
+    // trace at aggregation time). Drop first 2 entries (last two, in
+    // chronological order)
+    if (NeedsSkylakeFix)
+      Sample.LBR.erase(Sample.LBR.begin(),
+                       Sample.LBR.begin() +
+                           std::min<size_t>(2, Sample.LBR.size()));
+
+    Batch.emplace_back(std::move(Sample));
+    if (Batch.size() == BatchSize)
+      aggregateBatch();
+  }
+  aggregateBatch();
+
+  for (LBRAggregation &Slice : Slices) {
+    for (const auto &Entry : Slice.BranchLBRs) {
+      BranchInfo &Info = BranchLBRs[Entry.first];
+      Info.TakenCount += Entry.second.TakenCount;
+      Info.MispredCount += Entry.second.MispredCount;
+    }
+    for (const auto &Entry : Slice.FallthroughLBRs) {
+      FTInfo &Info = FallthroughLBRs[Entry.first];
+      Info.InternCount += Entry.second.InternCount;
+      Info.ExternCount += Entry.second.ExternCount;
     }
+    NumTraces += Slice.NumTraces;
+    NumInvalidTraces += Slice.NumInvalidTraces;
+    NumLongRangeTraces += Slice.NumLongRangeTraces;
+    clear(Slice.BranchLBRs);
+    clear(Slice.FallthroughLBRs);
   }
 
   for (const auto &LBR : BranchLBRs) {
@@ -9,6 +9,7 @@
 #include "bolt/Profile/YAMLProfileReader.h"
 #include "bolt/Core/BinaryBasicBlock.h"
 #include "bolt/Core/BinaryFunction.h"
+#include "bolt/Core/ParallelUtilities.h"
 #include "bolt/Passes/MCF.h"
 #include "bolt/Profile/ProfileYAMLMapping.h"
 #include "bolt/Utils/Utils.h"
@@ -87,7 +88,8 @@ bool YAMLProfileReader::parseFunctionProfile(
 
   BF.setExecutionCount(YamlBF.ExecCount);
 
-  if (!opts::IgnoreHash && YamlBF.Hash != BF.computeHash(/*UseDFS=*/true)) {
+  // The hash was computed by readProfile() and the CFG has not changed since.
+  if (!opts::IgnoreHash && YamlBF.Hash != BF.getHash()) {
     if (opts::Verbosity >= 1)
       errs() << "BOLT-WARNING: function hash mismatch\n";
     ProfileMatched = false;
@@ -313,6 +315,15 @@ Error YAMLProfileReader::readProfile(BinaryContext &BC) {
     return false;
   };
 
+  // Hashing traverses every instruction of every function. Compute hashes once
+  // per function in parallel. Matching below and parseFunctionProfile() use
+  // the cached values.
+  if (!opts::IgnoreHash)
+    ParallelUtilities::runOnEachFunction(
+        BC, ParallelUtilities::SchedulingPolicy::SP_BB_LINEAR,
+        [](BinaryFunction &BF) { BF.computeHash(/*UseDFS=*/true); },
+        /*SkipPredicate=*/nullptr, "computeHash");
+
   // We have to do 2 passes since LTO introduces an ambiguity in function
   // names. The first pass assigns profiles that match 100% by name and
   // by hash. The second pass allows name ambiguity for LTO private functions.
@@ -323,10 +334,6 @@ Error YAMLProfileReader::readProfile(BinaryContext &BC) {
     // the profile.
     Function.setExecutionCount(BinaryFunction::COUNT_NO_PROFILE);
 
-    // Recompute hash once per function.
-    if (!opts::IgnoreHash)
-      Function.computeHash(/*UseDFS=*/true);
-
     for (StringRef FunctionName : Function.getNames()) {
       auto PI = ProfileNameToProfile.find(FunctionName);
       if (PI == ProfileNameToProfile.end())
@@ -2673,6 +2673,27 @@ void RewriteInstance::processProfileData() {
 void RewriteInstance::disassembleFunctions() {
   NamedRegionTimer T("disassembleFunctions", "disassemble functions",
                      TimerGroupName, TimerGroupDesc, opts::TimeRewrite);
+
+  // Decoding instructions does not depend on other functions and could be
+  // done in parallel ahead of symbolization, which has to stay sequential.
+  if (!opts::SequentialDisassembly && !opts::NoThreads) {
+    ParallelUtilities::WorkFuncTy WorkFun = [&](BinaryFunction &BF) {
+      BinaryContext::IndependentDisassembler DisAsm =
+          BC->createIndependentMCDisassembler();
+      if (DisAsm.DisAsm)
+        BF.predecode(*DisAsm.DisAsm);
+    };
+
+    ParallelUtilities::PredicateTy SkipPredicate =
+        [&](const BinaryFunction &BF) {
+      return BF.getSize() == 0 || !BF.getData() || !shouldDisassemble(BF);
+    };
+
+    ParallelUtilities::runOnEachFunction(
+        *BC, ParallelUtilities::SchedulingPolicy::SP_INST_LINEAR, WorkFun,
+        SkipPredicate, "predecode");
+  }
+
   for (auto &BFI : BC->getBinaryFunctions()) {
     BinaryFunction &Function = BFI.second;
 
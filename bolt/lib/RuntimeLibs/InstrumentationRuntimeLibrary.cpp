@@ -34,6 +34,8 @@ extern cl::opt<bool> ConservativeInstrumentation;
 extern cl::opt<std::string> InstrumentationFilename;
 extern cl::opt<std::string> InstrumentationBinpath;
 extern cl::opt<uint32_t> InstrumentationSleepTime;
+extern cl::opt<uint32_t> InstrumentationSampleOnTime;
+extern cl::opt<uint32_t> InstrumentationSampleOffTime;
 extern cl::opt<bool> InstrumentationNoCountersClear;
 extern cl::opt<bool> InstrumentationWaitForks;
 extern cl::opt<JumpTableSupportLevel> JumpTables;
@@ -161,9 +163,16 @@ void InstrumentationRuntimeLibrary::emitBinary(BinaryContext &BC,
   emitLabelByName("__bolt_instr_locations");
   for (MCSymbol *const &Label : Summary->Counters)
     emitFill(sizeof(uint64_t), Label);
+  // Follows the counters so that it shares their memory with the process
+  // that toggles it in sampled mode
+  emitIntValue("__bolt_instr_sample_increment", 1, sizeof(uint64_t));
 
   emitPadding(BC.RegularPageSize);
   emitIntValue("__bolt_instr_sleep_time", opts::InstrumentationSleepTime);
+  emitIntValue("__bolt_instr_sample_on_time",
+               opts::InstrumentationSampleOnTime);
+  emitIntValue("__bolt_instr_sample_off_time",
+               opts::InstrumentationSampleOffTime);
   emitIntValue("__bolt_instr_no_counters_clear",
                !!opts::InstrumentationNoCountersClear, 1);
   emitIntValue("__bolt_instr_conservative", !!opts::ConservativeInstrumentation,
@@ -3432,6 +3432,56 @@ public:
                                   /*NoFlagsClobber=*/true);
   }
 
+  void createInstrSampledIncMemory(InstructionListType &Instrs,
+                                   const MCSymbol *Target,
+                                   const MCSymbol *Increment, MCContext *Ctx,
+                                   bool IsLeaf) const override {
+    unsigned int I = 0;
+
+    Instrs.resize(IsLeaf ? 17 : 15);
+    // Don't clobber application red zone (ABI dependent)
+    if (IsLeaf)
+      createStackPointerIncrement(Instrs[I++], 128,
+                                  /*NoFlagsClobber=*/true);
+
+    // PUSHF
+    createPushRegister(Instrs[I++], X86::RAX, 8);
+    createClearRegWithNoEFlagsUpdate(Instrs[I++], X86::RAX, 8);
+    createX86Lahf(Instrs[I++]);
+    createPushRegister(Instrs[I++], X86::RAX, 8);
+    createClearRegWithNoEFlagsUpdate(Instrs[I++], X86::RAX, 8);
+    createX86SaveOVFlagToRegister(Instrs[I++], X86::AL);
+    // MOV Increment(%rip), %rcx
+    // ADD %rcx, Target(%rip)
+    // No LOCK prefix: a sampled profile tolerates an occasional lost update
+    // from concurrent increments of the same counter.
+    createPushRegister(Instrs[I++], X86::RCX, 8);
+    createLoad(Instrs[I++], X86::RIP, 1, X86::NoRegister, 0,
+               MCSymbolRefExpr::create(Increment, MCSymbolRefExpr::VK_None,
+                                       *Ctx),
+               X86::NoRegister, X86::RCX, 8);
+    MCInst &AddInst = Instrs[I++];
+    AddInst.setOpcode(X86::ADD64mr);
+    AddInst.clear();
+    AddInst.addOperand(MCOperand::createReg(X86::RIP));        // BaseReg
+    AddInst.addOperand(MCOperand::createImm(1));               // ScaleAmt
+    AddInst.addOperand(MCOperand::createReg(X86::NoRegister)); // IndexReg
+    AddInst.addOperand(MCOperand::createExpr(MCSymbolRefExpr::create(
+        Target, MCSymbolRefExpr::VK_None, *Ctx)));             // Displacement
+    AddInst.addOperand(MCOperand::createReg(X86::NoRegister)); // AddrSegmentReg
+    AddInst.addOperand(MCOperand::createReg(X86::RCX));
+    createPopRegister(Instrs[I++], X86::RCX, 8);
+    // POPF
+    createAddRegImm(Instrs[I++], X86::AL, 127, 1);
+    createPopRegister(Instrs[I++], X86::RAX, 8);
+    createX86Sahf(Instrs[I++]);
+    createPopRegister(Instrs[I++], X86::RAX, 8);
+
+    if (IsLeaf)
+      createStackPointerDecrement(Instrs[I], 128,
+                                  /*NoFlagsClobber=*/true);
+  }
+
   void createSwap(MCInst &Inst, MCPhysReg Source, MCPhysReg MemBaseReg,
                   int64_t Disp) const {
     Inst.setOpcode(X86::XCHG64rm);
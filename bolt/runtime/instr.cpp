@@ -84,8 +84,13 @@ extern uint32_t __bolt_instr_num_ind_calls;
 extern uint32_t __bolt_instr_num_ind_targets;
 // Number of function descriptions
 extern uint32_t __bolt_instr_num_funcs;
+// Value added to counters in sampled mode, follows the counters in memory
+extern uint64_t __bolt_instr_sample_increment;
 // Time to sleep across dumps (when we write the fdata profile to disk)
 extern uint32_t __bolt_instr_sleep_time;
+// Lengths of counting and paused windows in sampled mode, 0 if disabled
+extern uint32_t __bolt_instr_sample_on_time;
+extern uint32_t __bolt_instr_sample_off_time;
 // Do not clear counters across dumps, rewrite file with the updated values
 extern bool __bolt_instr_no_counters_clear;
 // Wait until all forks of instrumented process will finish
@@ -1493,10 +1498,12 @@ __bolt_instr_data_dump() {
 }
 
 /// Event loop for our child process spawned during setup to dump profile data
-/// at user-specified intervals
+/// at user-specified intervals and to alternate counting windows in sampled
+/// mode
 void watchProcess() {
   timespec ts, rem;
   uint64_t Ellapsed = 0ull;
+  uint64_t SampleEllapsed = 0ull;
   uint64_t ppid;
   if (__bolt_instr_wait_forks) {
     // Store parent pgid
@@ -1525,7 +1532,22 @@ void watchProcess() {
       break;
     }
 
-    if (++Ellapsed < __bolt_instr_sleep_time)
+    // Counters share memory with the instrumented process, so does the value
+    // its instrumentation adds to them
+    if (__bolt_instr_sample_off_time != 0) {
+      ++SampleEllapsed;
+      if (__bolt_instr_sample_increment &&
+          SampleEllapsed >= __bolt_instr_sample_on_time) {
+        __bolt_instr_sample_increment = 0;
+        SampleEllapsed = 0;
+      } else if (!__bolt_instr_sample_increment &&
+                 SampleEllapsed >= __bolt_instr_sample_off_time) {
+        __bolt_instr_sample_increment = 1;
+        SampleEllapsed = 0;
+      }
+    }
+
+    if (__bolt_instr_sleep_time == 0 || ++Ellapsed < __bolt_instr_sleep_time)
       continue;
 
     Ellapsed = 0;
@@ -1547,8 +1569,7 @@ extern "C" void __attribute((force_align_arg_pointer)) __bolt_instr_setup() {
   const uint64_t CountersStart =
       reinterpret_cast<uint64_t>(&__bolt_instr_locations[0]);
   const uint64_t CountersEnd = alignTo(
-      reinterpret_cast<uint64_t>(&__bolt_instr_locations[__bolt_num_counters]),
-      0x1000);
+      reinterpret_cast<uint64_t>(&__bolt_instr_sample_increment + 1), 0x1000);
   DEBUG(reportNumber("replace mmap start: ", CountersStart, 16));
   DEBUG(reportNumber("replace mmap stop: ", CountersEnd, 16));
   assert (CountersEnd > CountersStart, "no counters");
@@ -1557,6 +1578,7 @@ extern "C" void __attribute((force_align_arg_pointer)) __bolt_instr_setup() {
   __mmap(CountersStart, CountersEnd - CountersStart,
          0x3 /*PROT_READ|PROT_WRITE*/,
          0x31 /*MAP_ANONYMOUS | MAP_SHARED | MAP_FIXED*/, -1, 0);
+  __bolt_instr_sample_increment = 1;
 
   __bolt_ind_call_counter_func_pointer = __bolt_instr_indirect_call;
   __bolt_ind_tailcall_counter_func_pointer = __bolt_instr_indirect_tailcall;
@@ -1568,7 +1590,7 @@ extern "C" void __attribute((force_align_arg_pointer)) __bolt_instr_setup() {
     GlobalIndCallCounters =
         new (GlobalAlloc, 0) IndirectCallHashTable[__bolt_instr_num_ind_calls];
 
-  if (__bolt_instr_sleep_time != 0) {
+  if (__bolt_instr_sleep_time != 0 || __bolt_instr_sample_off_time != 0) {
     // Separate instrumented process to the own process group
     if (__bolt_instr_wait_forks)
       __setpgid(0, 0);
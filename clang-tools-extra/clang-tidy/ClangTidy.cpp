@@ -23,6 +23,7 @@
 #include "clang-tidy-config.h"
 #include "clang/AST/ASTConsumer.h"
 #include "clang/ASTMatchers/ASTMatchFinder.h"
+#include "clang/Basic/Version.h"
 #include "clang/Format/Format.h"
 #include "clang/Frontend/ASTConsumers.h"
 #include "clang/Frontend/CompilerInstance.h"
@@ -39,7 +40,13 @@
 #include "clang/Tooling/Refactoring.h"
 #include "clang/Tooling/ReplacementsYaml.h"
 #include "clang/Tooling/Tooling.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/Process.h"
+#include "llvm/Support/xxhash.h"
 #include <algorithm>
 #include <utility>
 
@@ -498,6 +505,106 @@ getCheckNames(const ClangTidyOptions &Options,
   return Factory.getCheckNames();
 }
 
+namespace {
+/// The files a translation unit read, with a hash of their contents.
+using InputFileHashes = std::vector<std::pair<std::string, uint64_t>>;
+
+/// Remembers the files on which no check reported anything, so that a later
+/// run can skip them.
+///
+/// There is one entry per input file, named after a hash of everything that
+/// could change the result other than file contents: the clang-tidy version,
+/// the compile commands, the options for the file and the line filter. The
+/// entry lists the files the translation unit read and a hash of each, and is
+/// only used while all of them still have that hash. A header that is added
+/// earlier in the include path than one the translation unit read is not
+/// noticed.
+class CleanFileCache {
+public:
+  CleanFileCache(StringRef Dir, ClangTidyContext &Context,
+                 const CompilationDatabase &Compilations,
+                 llvm::vfs::FileSystem &FS)
+      : Dir(Dir), Context(Context), Compilations(Compilations), FS(FS) {}
+
+  /// Whether \p File was clean when it was last analyzed with the same
+  /// configuration, and none of the files it read has changed since.
+  bool isClean(StringRef File) {
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Entry =
+        llvm::MemoryBuffer::getFile(getEntryPath(File));
+    if (!Entry)
+      return false;
+    SmallVector<StringRef, 32> Lines;
+    (*Entry)->getBuffer().split(Lines, '\n', /*MaxSplit=*/-1,
+                                /*KeepEmpty=*/false);
+    if (Lines.empty())
+      return false;
+    for (StringRef Line : Lines) {
+      StringRef Hash, Path;
+      std::tie(Hash, Path) = Line.split(' ');
+      uint64_t Expected;
+      if (Hash.getAsInteger(16, Expected))
+        return false;
+      llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Input =
+          FS.getBufferForFile(Path);
+      if (!Input || llvm::xxHash64((*Input)->getBuffer()) != Expected)
+        return false;
+    }
+    return true;
+  }
+
+  /// Records that \p File is clean, having read \p Inputs.
+  void markClean(StringRef File, const InputFileHashes &Inputs) {
+    if (Inputs.empty())
+      return;
+    std::string Text;
+    llvm::raw_string_ostream OS(Text);
+    for (const auto &Input : Inputs)
+      OS << llvm::format_hex_no_prefix(Input.second, 16) << ' ' << Input.first
+         << '\n';
+    std::string EntryPath = getEntryPath(File);
+    if (llvm::sys::fs::create_directories(Dir))
+      return;
+    // A failure to write the entry only costs a later run some time.
+    llvm::consumeError(llvm::writeFileAtomically(EntryPath + "-%%%%%%%%",
+                                                 EntryPath, OS.str()));
+  }
+
+private:
+  std::string getEntryPath(StringRef File) {
+    llvm::MD5 Hash;
+    auto Add = [&Hash](StringRef S) {
+      Hash.update(S);
+      Hash.update(StringRef("\0", 1));
+    };
+    Add(getClangFullVersion());
+    Add(File);
+    Add(Context.canEnableAnalyzerAlphaCheckers() ? "alpha" : "");
+    for (const CompileCommand &Command :
+         Compilations.getCompileCommands(File)) {
+      Add(Command.Directory);
+      for (const std::string &Arg : Command.CommandLine)
+        Add(Arg);
+    }
+    Add(configurationAsText(Context.getOptionsForFile(File)));
+    for (const FileFilter &Filter : Context.getGlobalOptions().LineFilter) {
+      Add(Filter.Name);
+      for (const FileFilter::LineRange &Range : Filter.LineRanges)
+        Add(std::to_string(Range.first) + "-" + std::to_string(Range.second));
+    }
+    llvm::MD5::MD5Result Result;
+    Hash.final(Result);
+    SmallString<256> Path(Dir);
+    llvm::sys::path::append(Path, Result.digest());
+    return std::string(Path.str());
+  }
+
+  std::string Dir;
+  ClangTidyContext &Context;
+  const CompilationDatabase &Compilations;
+  llvm::vfs::FileSystem &FS;
+};
+} // namespace
+
 ClangTidyOptions::OptionMap
 getCheckOptions(const ClangTidyOptions &Options,
                 bool AllowEnablingAnalyzerAlphaCheckers) {
@@ -515,10 +622,7 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
              ArrayRef<std::string> InputFiles,
              llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS,
              bool ApplyAnyFix, bool EnableCheckProfile,
-             llvm::StringRef StoreCheckProfile) {
-  ClangTool Tool(Compilations, InputFiles,
-                 std::make_shared<PCHContainerOperations>(), BaseFS);
-
+             llvm::StringRef StoreCheckProfile, llvm::StringRef CacheDir) {
   // Add extra arguments passed by the clang-tidy command-line.
   ArgumentsAdjuster PerFileExtraArgumentsInserter =
       [&Context](const CommandLineArguments &Args, StringRef Filename) {
@@ -537,8 +641,6 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
         return AdjustedArgs;
       };
 
-  Tool.appendArgumentsAdjuster(PerFileExtraArgumentsInserter);
-  Tool.appendArgumentsAdjuster(getStripPluginsAdjuster());
   Context.setEnableProfiling(EnableCheckProfile);
   Context.setProfileStoragePrefix(StoreCheckProfile);
 
@@ -546,15 +648,15 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
   DiagnosticsEngine DE(new DiagnosticIDs(), new DiagnosticOptions(),
                        &DiagConsumer, /*ShouldOwnClient=*/false);
   Context.setDiagnosticsEngine(&DE);
-  Tool.setDiagnosticConsumer(&DiagConsumer);
 
   class ActionFactory : public FrontendActionFactory {
   public:
     ActionFactory(ClangTidyContext &Context,
-                  IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS)
-        : ConsumerFactory(Context, std::move(BaseFS)) {}
+                  IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> BaseFS,
+                  InputFileHashes *Inputs)
+        : ConsumerFactory(Context, std::move(BaseFS)), Inputs(Inputs) {}
     std::unique_ptr<FrontendAction> create() override {
-      return std::make_unique<Action>(&ConsumerFactory);
+      return std::make_unique<Action>(&ConsumerFactory, Inputs);
     }
 
     bool runInvocation(std::shared_ptr<CompilerInvocation> Invocation,
@@ -570,21 +672,73 @@ runClangTidy(clang::tidy::ClangTidyContext &Context,
   private:
     class Action : public ASTFrontendAction {
     public:
-      Action(ClangTidyASTConsumerFactory *Factory) : Factory(Factory) {}
+      Action(ClangTidyASTConsumerFactory *Factory, InputFileHashes *Inputs)
+          : Factory(Factory), Inputs(Inputs) {}
       std::unique_ptr<ASTConsumer> CreateASTConsumer(CompilerInstance &Compiler,
                                                      StringRef File) override {
         return Factory->createASTConsumer(Compiler, File);
       }
 
+      void EndSourceFileAction() override {
+        if (!Inputs)
+          return;
+        // Only files whose contents were read can affect the result. A file
+        // without an absolute path can't be found again by a later run, so
+        // it makes the translation unit uncacheable.
+        const SourceManager &SM = getCompilerInstance().getSourceManager();
+        for (auto I = SM.fileinfo_begin(), E = SM.fileinfo_end(); I != E;
+             ++I) {
+          llvm::Optional<llvm::MemoryBufferRef> Buffer =
+              I->second->getBufferIfLoaded();
+          if (!Buffer)
+            continue;
+          StringRef Path = I->first->tryGetRealPathName();
+          if (Path.empty() || !llvm::sys::path::is_absolute(Path)) {
+            Inputs->clear();
+            return;
+          }
+          Inputs->emplace_back(Path.str(),
+                               llvm::xxHash64(Buffer->getBuffer()));
+        }
+      }
+
     private:
       ClangTidyASTConsumerFactory *Factory;
+      InputFileHashes *Inputs;
     };
 
     ClangTidyASTConsumerFactory ConsumerFactory;
+    InputFileHashes *Inputs;
+  };
+
+  auto RunTool = [&](ArrayRef<std::string> Files, ActionFactory &Factory) {
+    ClangTool Tool(Compilations, Files,
+                   std::make_shared<PCHContainerOperations>(), BaseFS);
+    Tool.appendArgumentsAdjuster(PerFileExtraArgumentsInserter);
+    Tool.appendArgumentsAdjuster(getStripPluginsAdjuster());
+    Tool.setDiagnosticConsumer(&DiagConsumer);
+    return Tool.run(&Factory);
   };
 
-  ActionFactory Factory(Context, std::move(BaseFS));
-  Tool.run(&Factory);
+  if (CacheDir.empty()) {
+    ActionFactory Factory(Context, BaseFS, /*Inputs=*/nullptr);
+    RunTool(InputFiles, Factory);
+    return DiagConsumer.take();
+  }
+
+  // With a cache, the files are run one at a time, so that the diagnostics
+  // and the inputs of each can be told apart.
+  CleanFileCache Cache(CacheDir, Context, Compilations, *BaseFS);
+  for (const std::string &File : InputFiles) {
+    if (Cache.isClean(File))
+      continue;
+    InputFileHashes Inputs;
+    ActionFactory Factory(Context, BaseFS, &Inputs);
+    size_t NumErrorsBefore = DiagConsumer.getNumCapturedErrors();
+    int Status = RunTool(File, Factory);
+    if (Status == 0 && DiagConsumer.getNumCapturedErrors() == NumErrorsBefore)
+      Cache.markClean(File, Inputs);
+  }
   return DiagConsumer.take();
 }
 
@@ -282,10 +282,11 @@ ClangTidyDiagnosticConsumer::ClangTidyDiagnosticConsumer(
       RemoveIncompatibleErrors(RemoveIncompatibleErrors),
       GetFixesFromNotes(GetFixesFromNotes),
       EnableNolintBlocks(EnableNolintBlocks), LastErrorRelatesToUserCode(false),
-      LastErrorPassesLineFilter(false), LastErrorWasIgnored(false) {}
+      LastErrorPassesLineFilter(false), LastErrorWasIgnored(false),
+      LastErrorFinalized(true) {}
 
 void ClangTidyDiagnosticConsumer::finalizeLastError() {
-  if (!Errors.empty()) {
+  if (!Errors.empty() && !LastErrorFinalized) {
     ClangTidyError &Error = Errors.back();
     if (Error.DiagnosticName == "clang-tidy-config") {
       // Never ignore these.
@@ -305,6 +306,7 @@ void ClangTidyDiagnosticConsumer::finalizeLastError() {
   }
   LastErrorRelatesToUserCode = false;
   LastErrorPassesLineFilter = false;
+  LastErrorFinalized = true;
 }
 
 static bool isNOLINTFound(StringRef NolintDirectiveText, StringRef CheckName,
@@ -600,6 +602,7 @@ void ClangTidyDiagnosticConsumer::HandleDiagnostic(
                             Context.treatAsError(CheckName);
     Errors.emplace_back(CheckName, Level, Context.getCurrentBuildDirectory(),
                         IsWarningAsError);
+    LastErrorFinalized = false;
   }
 
   if (ExternalDiagEngine) {
@@ -917,6 +920,11 @@ struct EqualClangTidyError {
 };
 } // end anonymous namespace
 
+size_t ClangTidyDiagnosticConsumer::getNumCapturedErrors() {
+  finalizeLastError();
+  return Errors.size();
+}
+
 std::vector<ClangTidyError> ClangTidyDiagnosticConsumer::take() {
   finalizeLastError();
 
@@ -262,6 +262,11 @@ public:
   // Retrieve the diagnostics that were captured.
   std::vector<ClangTidyError> take();
 
+  /// Returns the number of diagnostics captured so far that passed the
+  /// filters. Must only be called between translation units, when the notes
+  /// of the last diagnostic are all in.
+  size_t getNumCapturedErrors();
+
 private:
   void finalizeLastError();
   void removeIncompatibleErrors();
@@ -288,6 +293,7 @@ private:
   bool LastErrorRelatesToUserCode;
   bool LastErrorPassesLineFilter;
   bool LastErrorWasIgnored;
+  bool LastErrorFinalized;
 };
 
 } // end namespace tidy
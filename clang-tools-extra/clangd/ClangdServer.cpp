@@ -348,8 +348,13 @@ void ClangdServer::codeComplete(PathRef File, Position Pos,
   auto CodeCompleteOpts = Opts;
   if (!CodeCompleteOpts.Index) // Respect overridden index.
     CodeCompleteOpts.Index = Index;
+  // Don't let background indexing start new tasks until we're done.
+  llvm::Optional<BackgroundQueue::PauseScope> PauseIndexing;
+  if (BackgroundIdx)
+    PauseIndexing.emplace(BackgroundIdx->pause());
 
   auto Task = [Pos, CodeCompleteOpts, File = File.str(), CB = std::move(CB),
+               PauseIndexing = std::move(PauseIndexing),
                this](llvm::Expected<InputsAndPreamble> IP) mutable {
     if (!IP)
       return CB(IP.takeError());
@@ -409,9 +414,13 @@ void ClangdServer::codeComplete(PathRef File, Position Pos,
 void ClangdServer::signatureHelp(PathRef File, Position Pos,
                                  MarkupKind DocumentationFormat,
                                  Callback<SignatureHelp> CB) {
+  // Don't let background indexing start new tasks until we're done.
+  llvm::Optional<BackgroundQueue::PauseScope> PauseIndexing;
+  if (BackgroundIdx)
+    PauseIndexing.emplace(BackgroundIdx->pause());
 
   auto Action = [Pos, File = File.str(), CB = std::move(CB),
-                 DocumentationFormat,
+                 DocumentationFormat, PauseIndexing = std::move(PauseIndexing),
                  this](llvm::Expected<InputsAndPreamble> IP) mutable {
     if (!IP)
       return CB(IP.takeError());
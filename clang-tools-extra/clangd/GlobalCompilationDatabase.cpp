@@ -28,6 +28,7 @@
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/Program.h"
 #include "llvm/Support/VirtualFileSystem.h"
@@ -218,7 +219,11 @@ DirectoryBasedGlobalCompilationDatabase::DirectoryCache::CachedFile::load(
   if (HasOldData && Stat->getLastModificationTime() == ModifiedTime &&
       Stat->getSize() == Size)
     return {LoadResult::FoundSameData, nullptr};
-  auto Buf = FS.getBufferForFile(Path);
+  // Don't mmap: the JSON database keeps the buffer, and the build system may
+  // overwrite the file.
+  auto Buf = FS.getBufferForFile(Path, /*FileSize=*/-1,
+                                 /*RequiresNullTerminator=*/true,
+                                 /*IsVolatile=*/true);
   if (!Buf || (*Buf)->getBufferSize() != Stat->getSize()) {
     // Don't clear the cache - possible we're seeing inconsistent size as the
     // file is being recreated. If it ends up identical later, great!
@@ -246,9 +251,11 @@ DirectoryBasedGlobalCompilationDatabase::DirectoryCache::CachedFile::load(
 
 // Adapt CDB-loading functions to a common interface for DirectoryCache::load().
 static std::unique_ptr<tooling::CompilationDatabase>
-parseJSON(PathRef Path, llvm::StringRef Data, std::string &Error) {
+parseJSON(PathRef Path, std::unique_ptr<llvm::MemoryBuffer> Data,
+          std::string &Error) {
+  // The buffer can be large, so hand it over rather than copying it.
   if (auto CDB = tooling::JSONCompilationDatabase::loadFromBuffer(
-          Data, Error, tooling::JSONCommandLineSyntax::AutoDetect)) {
+          std::move(Data), Error, tooling::JSONCommandLineSyntax::AutoDetect)) {
     // FS used for expanding response files.
     // FIXME: ExpandResponseFilesDatabase appears not to provide the usual
     // thread-safety guarantees, as the access to FS is not locked!
@@ -262,9 +269,10 @@ parseJSON(PathRef Path, llvm::StringRef Data, std::string &Error) {
   return nullptr;
 }
 static std::unique_ptr<tooling::CompilationDatabase>
-parseFixed(PathRef Path, llvm::StringRef Data, std::string &Error) {
+parseFixed(PathRef Path, std::unique_ptr<llvm::MemoryBuffer> Data,
+           std::string &Error) {
   return tooling::FixedCompilationDatabase::loadFromBuffer(
-      llvm::sys::path::parent_path(Path), Data, Error);
+      llvm::sys::path::parent_path(Path), Data->getBuffer(), Error);
 }
 
 bool DirectoryBasedGlobalCompilationDatabase::DirectoryCache::load(
@@ -281,7 +289,7 @@ bool DirectoryBasedGlobalCompilationDatabase::DirectoryCache::load(
     // Wrapper for {Fixed,JSON}CompilationDatabase::loadFromBuffer.
     std::unique_ptr<tooling::CompilationDatabase> (*Parser)(
         PathRef,
-        /*Data*/ llvm::StringRef,
+        /*Data*/ std::unique_ptr<llvm::MemoryBuffer>,
         /*ErrorMsg*/ std::string &);
   };
   for (const auto &Entry : {CDBFile{&CompileCommandsJson, parseJSON},
@@ -307,7 +315,7 @@ bool DirectoryBasedGlobalCompilationDatabase::DirectoryCache::load(
       return true;
     case CachedFile::LoadResult::FoundNewData:
       // We have a new CDB!
-      CDB = Entry.Parser(Entry.File->Path, Loaded.Buffer->getBuffer(), Error);
+      CDB = Entry.Parser(Entry.File->Path, std::move(Loaded.Buffer), Error);
       if (CDB)
         log("{0} compilation database from {1}", Active ? "Reloaded" : "Loaded",
             Entry.File->Path);
@@ -282,6 +282,18 @@ void applyWarningOptions(llvm::ArrayRef<std::string> ExtraArgs,
   }
 }
 
+// The factories of all linked-in clang-tidy checks. They are the same for every
+// AST we build, so we only instantiate the modules once.
+const tidy::ClangTidyCheckFactories &getCheckFactories() {
+  static const tidy::ClangTidyCheckFactories *CTFactories = [] {
+    auto *CTFactories = new tidy::ClangTidyCheckFactories;
+    for (const auto &E : tidy::ClangTidyModuleRegistry::entries())
+      E.instantiate()->addCheckFactories(*CTFactories);
+    return CTFactories;
+  }();
+  return *CTFactories;
+}
+
 } // namespace
 
 llvm::Optional<ParsedAST>
@@ -410,15 +422,12 @@ ParsedAST::build(llvm::StringRef Filename, const ParseInputs &Inputs,
   // diagnostics.
   if (PreserveDiags) {
     trace::Span Tracer("ClangTidyInit");
-    tidy::ClangTidyCheckFactories CTFactories;
-    for (const auto &E : tidy::ClangTidyModuleRegistry::entries())
-      E.instantiate()->addCheckFactories(CTFactories);
     CTContext.emplace(std::make_unique<tidy::DefaultOptionsProvider>(
         tidy::ClangTidyGlobalOptions(), ClangTidyOpts));
     CTContext->setDiagnosticsEngine(&Clang->getDiagnostics());
     CTContext->setASTContext(&Clang->getASTContext());
     CTContext->setCurrentFile(Filename);
-    CTChecks = CTFactories.createChecks(CTContext.getPointer());
+    CTChecks = getCheckFactories().createChecks(CTContext.getPointer());
     llvm::erase_if(CTChecks, [&](const auto &Check) {
       return !Check->isLanguageVersionSupported(CTContext->getLangOpts());
     });
@@ -183,6 +183,44 @@ private:
   std::vector<KVPair> LRU; /* GUARDED_BY(Mut) */
 };
 
+/// An LRU cache of the preambles of recently closed files.
+/// When one of them is opened again, its new worker starts from the cached
+/// preamble, which is reused if it is still compatible with the new inputs.
+class TUScheduler::ClosedPreambleCache {
+public:
+  ClosedPreambleCache(unsigned MaxRetained) : MaxRetained(MaxRetained) {}
+
+  /// Stores the preamble of a file that was just closed, possibly removing
+  /// the least recently closed one.
+  void put(PathRef File, std::shared_ptr<const PreambleData> Preamble) {
+    if (!MaxRetained || !Preamble)
+      return;
+    LRU.insert(LRU.begin(), {File.str(), std::move(Preamble)});
+    if (LRU.size() > MaxRetained)
+      LRU.pop_back();
+  }
+
+  /// Returns the cached preamble of \p File, if any, and removes it from the
+  /// cache.
+  std::shared_ptr<const PreambleData> take(PathRef File) {
+    auto It =
+        llvm::find_if(LRU, [&](const KVPair &P) { return P.first == File; });
+    if (It == LRU.end())
+      return nullptr;
+    std::shared_ptr<const PreambleData> Preamble = std::move(It->second);
+    LRU.erase(It);
+    return Preamble;
+  }
+
+private:
+  using KVPair = std::pair<std::string, std::shared_ptr<const PreambleData>>;
+
+  unsigned MaxRetained;
+  /// Items sorted in LRU order, i.e. first item is the most recently closed
+  /// one.
+  std::vector<KVPair> LRU;
+};
+
 /// A map from header files to an opened "proxy" file that includes them.
 /// If you open the header, the compile command from the proxy file is used.
 ///
@@ -361,6 +399,13 @@ public:
         StoreInMemory(StorePreambleInMemory), RunSync(RunSync), Status(Status),
         ASTPeer(AW), HeaderIncluders(HeaderIncluders) {}
 
+  /// Starts from \p Preamble, built for the same file by an earlier worker,
+  /// instead of building the first preamble from scratch if it is compatible.
+  /// Must be called before the first update.
+  void setBaseline(std::shared_ptr<const PreambleData> Preamble) {
+    LatestBuild = std::move(Preamble);
+  }
+
   /// It isn't guaranteed that each requested version will be built. If there
   /// are multiple update requests while building a preamble, only the last one
   /// will be built.
@@ -524,6 +569,11 @@ public:
   ~ASTWorker();
 
   void update(ParseInputs Inputs, WantDiagnostics, bool ContentChanged);
+  /// Reuses \p Preamble, built for the same file by an earlier worker, if it
+  /// is compatible with the first inputs. Must be called before update().
+  void setBaselinePreamble(std::shared_ptr<const PreambleData> Preamble) {
+    PreamblePeer.setBaseline(std::move(Preamble));
+  }
   void
   runWithAST(llvm::StringRef Name,
              llvm::unique_function<void(llvm::Expected<InputsAndAST>)> Action,
@@ -1508,7 +1558,9 @@ TUScheduler::TUScheduler(const GlobalCompilationDatabase &CDB,
       Barrier(Opts.AsyncThreadsCount), QuickRunBarrier(Opts.AsyncThreadsCount),
       IdleASTs(
           std::make_unique<ASTCache>(Opts.RetentionPolicy.MaxRetainedASTs)),
-      HeaderIncluders(std::make_unique<HeaderIncluderCache>()) {
+      HeaderIncluders(std::make_unique<HeaderIncluderCache>()),
+      ClosedPreambles(std::make_unique<ClosedPreambleCache>(
+          Opts.RetentionPolicy.MaxRetainedClosedPreambles)) {
   // Avoid null checks everywhere.
   if (!Opts.ContextProvider) {
     this->Opts.ContextProvider = [](llvm::StringRef) {
@@ -1553,6 +1605,8 @@ bool TUScheduler::update(PathRef File, ParseInputs Inputs,
         ASTWorker::create(File, CDB, *IdleASTs, *HeaderIncluders,
                           WorkerThreads ? WorkerThreads.getPointer() : nullptr,
                           Barrier, Opts, *Callbacks);
+    if (auto Preamble = ClosedPreambles->take(File))
+      Worker->setBaselinePreamble(std::move(Preamble));
     FD = std::unique_ptr<FileData>(
         new FileData{Inputs.Contents, std::move(Worker)});
     ContentChanged = true;
@@ -1569,10 +1623,15 @@ bool TUScheduler::update(PathRef File, ParseInputs Inputs,
 }
 
 void TUScheduler::remove(PathRef File) {
-  bool Removed = Files.erase(File);
-  if (!Removed)
+  auto It = Files.find(File);
+  if (It == Files.end()) {
     elog("Trying to remove file from TUScheduler that is not tracked: {0}",
          File);
+    return;
+  }
+  ClosedPreambles->put(File,
+                       It->getValue()->Worker->getPossiblyStalePreamble());
+  Files.erase(It);
   // We don't call HeaderIncluders.remove(File) here.
   // If we did, we'd avoid potentially stale header/mainfile associations.
   // However, it would mean that closing a mainfile could invalidate the
@@ -64,6 +64,10 @@ struct ASTRetentionPolicy {
   /// Maximum number of ASTs to be retained in memory when there are no pending
   /// requests for them.
   unsigned MaxRetainedASTs = 3;
+  /// Maximum number of preambles of closed files to keep, to be reused if the
+  /// files are opened again with the same preamble section and compile
+  /// command.
+  unsigned MaxRetainedClosedPreambles = 0;
 };
 
 /// Clangd may wait after an update to see if another one comes along.
@@ -314,6 +318,7 @@ public:
   class ASTCache;
   /// Tracks headers included by open files, to get known-good compile commands.
   class HeaderIncluderCache;
+  class ClosedPreambleCache;
 
   // The file being built/processed in the current thread. This is a hack in
   // order to get the file name into the index implementations. Do not depend on
@@ -337,6 +342,7 @@ private:
   llvm::StringMap<std::unique_ptr<FileData>> Files;
   std::unique_ptr<ASTCache> IdleASTs;
   std::unique_ptr<HeaderIncluderCache> HeaderIncluders;
+  std::unique_ptr<ClosedPreambleCache> ClosedPreambles;
   // None when running tasks synchronously and non-None when running tasks
   // asynchronously.
   llvm::Optional<AsyncTaskRunner> PreambleTasks;
@@ -0,0 +1,85 @@
+//===--- FuzzyMatchBenchmark.cpp - Clangd fuzzy matching benchmarks -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Measures FuzzyMatcher on the kind of input code completion gives it: the
+// few characters typed so far, against thousands of identifiers in a mix of
+// camelCase, PascalCase and snake_case, most of which do not match.
+//
+//===----------------------------------------------------------------------===//
+
+#include "../FuzzyMatch.h"
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/StringRef.h"
+#include <string>
+#include <vector>
+
+namespace clang {
+namespace clangd {
+namespace {
+
+// Builds Count identifiers out of common identifier words.
+std::vector<std::string> buildCandidates(unsigned Count) {
+  const char *Words[] = {
+      "get",   "set",    "is",     "has",    "make",   "create",  "unique",
+      "ptr",   "buffer", "string", "size",   "index",  "symbol",  "token",
+      "range", "file",   "path",   "name",   "type",   "decl",    "expr",
+      "info",  "kind",   "begin",  "end",    "value",  "context", "manager",
+      "list",  "map"};
+  constexpr unsigned NumWords = sizeof(Words) / sizeof(Words[0]);
+  std::vector<std::string> Result;
+  // A simple LCG keeps the list the same from run to run.
+  unsigned Seed = 1;
+  auto Next = [&] { return (Seed = Seed * 1103515245 + 12345) >> 16; };
+  for (unsigned I = 0; I < Count; ++I) {
+    std::string Name;
+    enum { CamelCase, PascalCase, SnakeCase } Style =
+        static_cast<decltype(Style)>(Next() % 3);
+    unsigned Parts = Next() % 3 + 1;
+    for (unsigned J = 0; J < Parts; ++J) {
+      std::string Part = Words[Next() % NumWords];
+      if (Style == SnakeCase && J)
+        Name += '_';
+      if ((Style == CamelCase && J) || Style == PascalCase)
+        Part[0] = Part[0] - 'a' + 'A';
+      Name += Part;
+    }
+    Result.push_back(std::move(Name));
+  }
+  return Result;
+}
+
+void matchAll(benchmark::State &State, llvm::StringRef Pattern) {
+  std::vector<std::string> Candidates = buildCandidates(State.range(0));
+  for (auto _ : State) {
+    FuzzyMatcher Matcher(Pattern);
+    unsigned Matches = 0;
+    for (const std::string &Candidate : Candidates)
+      if (Matcher.match(Candidate))
+        ++Matches;
+    benchmark::DoNotOptimize(Matches);
+  }
+  State.SetItemsProcessed(State.iterations() * Candidates.size());
+}
+
+void OneChar(benchmark::State &State) { matchAll(State, "s"); }
+BENCHMARK(OneChar)->Arg(10000);
+
+void Prefix(benchmark::State &State) { matchAll(State, "get"); }
+BENCHMARK(Prefix)->Arg(10000);
+
+void Initials(benchmark::State &State) { matchAll(State, "gsi"); }
+BENCHMARK(Initials)->Arg(10000);
+
+void MixedCase(benchmark::State &State) { matchAll(State, "makeUniq"); }
+BENCHMARK(MixedCase)->Arg(10000);
+
+} // namespace
+} // namespace clangd
+} // namespace clang
+
+BENCHMARK_MAIN();
@@ -79,6 +79,7 @@ static void MemQueries(benchmark::State &State) {
   for (auto _ : State)
     for (const auto &Request : Requests)
       Mem->fuzzyFind(Request, [](const Symbol &S) {});
+  State.SetItemsProcessed(State.iterations() * Requests.size());
 }
 BENCHMARK(MemQueries);
 
@@ -88,6 +89,8 @@ static void DexQueries(benchmark::State &State) {
   for (auto _ : State)
     for (const auto &Request : Requests)
       Dex->fuzzyFind(Request, [](const Symbol &S) {});
+  // Report queries per second, the inverse of the mean query latency.
+  State.SetItemsProcessed(State.iterations() * Requests.size());
 }
 BENCHMARK(DexQueries);
 
@@ -101,6 +101,21 @@ public:
   // Reducing the boost of a tag affects future tasks but not current ones.
   void boost(llvm::StringRef Tag, unsigned NewPriority);
 
+  // While a PauseScope is alive, workers don't start new tasks, so that
+  // latency-sensitive work elsewhere gets the CPU. Running tasks continue.
+  class PauseScope {
+  public:
+    PauseScope(PauseScope &&Other) : Q(Other.Q) { Other.Q = nullptr; }
+    PauseScope &operator=(PauseScope &&) = delete;
+    ~PauseScope();
+
+  private:
+    friend class BackgroundQueue;
+    explicit PauseScope(BackgroundQueue &Q);
+    BackgroundQueue *Q;
+  };
+  PauseScope pause() { return PauseScope(*this); }
+
   // Process items on the queue until the queue is stopped.
   // If the queue becomes empty, OnIdle will be called (on one worker).
   void work(std::function<void()> OnIdle = nullptr);
@@ -122,6 +137,7 @@ private:
   Stats Stat;
   std::condition_variable CV;
   bool ShouldStop = false;
+  unsigned Pauses = 0; // Number of live PauseScopes.
   std::vector<Task> Queue; // max-heap
   llvm::StringMap<unsigned> Boosts;
   std::function<void(Stats)> OnProgress;
@@ -163,6 +179,10 @@ public:
   /// Typically used to index TUs when headers are opened.
   void boostRelated(llvm::StringRef Path);
 
+  /// Holds off starting new indexing tasks while the returned object is
+  /// alive. Typically used while serving latency-sensitive requests.
+  BackgroundQueue::PauseScope pause() { return Queue.pause(); }
+
   // Cause background threads to stop after ther current task, any remaining
   // tasks will be discarded.
   void stop() {
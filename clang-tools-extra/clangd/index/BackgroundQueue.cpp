@@ -23,7 +23,8 @@ void BackgroundQueue::work(std::function<void()> OnIdle) {
     llvm::Optional<Task> Task;
     {
       std::unique_lock<std::mutex> Lock(Mu);
-      CV.wait(Lock, [&] { return ShouldStop || !Queue.empty(); });
+      CV.wait(Lock,
+              [&] { return ShouldStop || (!Queue.empty() && !Pauses); });
       if (ShouldStop) {
         Queue.clear();
         CV.notify_all();
@@ -132,6 +133,22 @@ void BackgroundQueue::boost(llvm::StringRef Tag, unsigned NewPriority) {
   // No need to signal, only rearranged items in the queue.
 }
 
+BackgroundQueue::PauseScope::PauseScope(BackgroundQueue &Q) : Q(&Q) {
+  std::lock_guard<std::mutex> Lock(Q.Mu);
+  ++Q.Pauses;
+}
+
+BackgroundQueue::PauseScope::~PauseScope() {
+  if (!Q)
+    return;
+  {
+    std::lock_guard<std::mutex> Lock(Q->Mu);
+    assert(Q->Pauses > 0 && "before decrementing");
+    --Q->Pauses;
+  }
+  Q->CV.notify_all();
+}
+
 bool BackgroundQueue::blockUntilIdleForTest(
     llvm::Optional<double> TimeoutSeconds) {
   std::unique_lock<std::mutex> Lock(Mu);
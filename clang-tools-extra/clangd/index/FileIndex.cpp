@@ -443,22 +443,37 @@ void FileIndex::updatePreamble(PathRef Path, llvm::StringRef Version,
         std::make_unique<RelationSlab>(std::move(*IF->Relations)),
         /*CountReferences=*/false);
   }
-  size_t IndexVersion = 0;
-  auto NewIndex = PreambleSymbols.buildIndex(
-      IndexType::Heavy, DuplicateHandling::PickOne, &IndexVersion);
-  {
-    std::lock_guard<std::mutex> Lock(UpdateIndexMu);
-    if (IndexVersion <= PreambleIndexVersion) {
-      // We lost the race, some other thread built a later version.
-      return;
-    }
+
+  // Building the preamble index is expensive, and many preambles are often
+  // built at once, e.g. when a lot of files are opened. Rather than each
+  // thread building its own index, which is outdated as soon as the next one
+  // is done, a thread that finds a build in progress leaves its update to the
+  // building thread, which builds again until it has seen every update.
+  std::unique_lock<std::mutex> Lock(UpdateIndexMu);
+  if (BuildingPreambleIndex) {
+    PreambleIndexOutdated = true;
+    return;
+  }
+  BuildingPreambleIndex = true;
+  do {
+    PreambleIndexOutdated = false;
+    Lock.unlock();
+    size_t IndexVersion = 0;
+    auto NewIndex = PreambleSymbols.buildIndex(
+        IndexType::Heavy, DuplicateHandling::PickOne, &IndexVersion);
+    Lock.lock();
+    // The index may already have this version, if the previous build started
+    // after the last update.
+    if (IndexVersion <= PreambleIndexVersion)
+      continue;
     PreambleIndexVersion = IndexVersion;
     PreambleIndex.reset(std::move(NewIndex));
     vlog(
         "Build dynamic index for header symbols with estimated memory usage of "
         "{0} bytes",
         PreambleIndex.estimateMemoryUsage());
-  }
+  } while (PreambleIndexOutdated);
+  BuildingPreambleIndex = false;
 }
 
 void FileIndex::updateMain(PathRef Path, ParsedAST &AST) {
@@ -150,6 +150,10 @@ private:
   std::mutex UpdateIndexMu;
   unsigned MainIndexVersion = 0;
   unsigned PreambleIndexVersion = 0;
+  // Whether a thread is building the preamble index, and whether
+  // PreambleSymbols changed since it started.
+  bool BuildingPreambleIndex = false;
+  bool PreambleIndexOutdated = false;
 };
 
 using SlabTuple = std::tuple<SymbolSlab, RefSlab, RelationSlab>;
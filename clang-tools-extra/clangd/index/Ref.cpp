@@ -61,7 +61,10 @@ RefSlab RefSlab::Builder::build() && {
     llvm::sort(Refs); // By file, affects xrefs display order.
     Result.emplace_back(Sym, llvm::ArrayRef<Ref>(Refs).copy(Arena));
   }
-  return RefSlab(std::move(Result), std::move(Arena), Entries.size());
+  // The builder is consumed, and every ref now has a copy on the arena.
+  size_t NumRefs = Entries.size();
+  llvm::DenseSet<Entry>().swap(Entries);
+  return RefSlab(std::move(Result), std::move(Arena), NumRefs);
 }
 
 } // namespace clangd
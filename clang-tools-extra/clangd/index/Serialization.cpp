@@ -207,8 +207,10 @@ public:
   }
 };
 
+// The strings point into the table they were read from: the uncompressed
+// data owned here, or the input itself, which must outlive the table.
 struct StringTableIn {
-  llvm::BumpPtrAllocator Arena;
+  llvm::SmallVector<char, 0> UncompressedStorage;
   std::vector<llvm::StringRef> Strings;
 };
 
@@ -218,8 +220,8 @@ llvm::Expected<StringTableIn> readStringTable(llvm::StringRef Data) {
   if (R.err())
     return error("Truncated string table");
 
+  StringTableIn Table;
   llvm::StringRef Uncompressed;
-  llvm::SmallString<1> UncompressedStorage;
   if (UncompressedSize == 0) // No compression
     Uncompressed = R.rest();
   else if (llvm::zlib::isAvailable()) {
@@ -232,21 +234,22 @@ llvm::Expected<StringTableIn> readStringTable(llvm::StringRef Data) {
       return error("Bad stri table: uncompress {0} -> {1} bytes is implausible",
                    R.rest().size(), UncompressedSize);
 
-    if (llvm::Error E = llvm::zlib::uncompress(R.rest(), UncompressedStorage,
-                                               UncompressedSize))
+    if (llvm::Error E = llvm::zlib::uncompress(
+            R.rest(), Table.UncompressedStorage, UncompressedSize))
       return std::move(E);
-    Uncompressed = UncompressedStorage;
+    Uncompressed = llvm::StringRef(Table.UncompressedStorage.data(),
+                                   Table.UncompressedStorage.size());
   } else
     return error("Compressed string table, but zlib is unavailable");
 
-  StringTableIn Table;
-  llvm::StringSaver Saver(Table.Arena);
+  // Every string is followed by its null terminator, so it can be used in
+  // place; the builders of the slabs make their own copies.
   R = Reader(Uncompressed);
   for (Reader R(Uncompressed); !R.eof();) {
     auto Len = R.rest().find(0);
     if (Len == llvm::StringRef::npos)
       return error("Bad string table: not null terminated");
-    Table.Strings.push_back(Saver.save(R.consume(Len)));
+    Table.Strings.push_back(R.consume(Len));
     R.consume8();
   }
   if (R.err())
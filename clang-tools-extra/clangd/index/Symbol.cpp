@@ -48,7 +48,12 @@ static void own(Symbol &S, llvm::UniqueStringSaver &Strings) {
 }
 
 void SymbolSlab::Builder::insert(const Symbol &S) {
-  own(Symbols[S.ID] = S, UniqueStrings);
+  auto R = Symbols.try_emplace(S.ID, S);
+  if (!R.second) {
+    R.first->second = S;
+    HasUnusedStrings = true;
+  }
+  own(R.first->second, UniqueStrings);
 }
 
 SymbolSlab SymbolSlab::Builder::build() && {
@@ -57,13 +62,21 @@ SymbolSlab SymbolSlab::Builder::build() && {
   SortedSymbols.reserve(Symbols.size());
   for (auto &Entry : Symbols)
     SortedSymbols.push_back(std::move(Entry.second));
+  // The builder is consumed: free its storage as early as possible, which
+  // matters when all symbols of a project are built at once.
+  llvm::DenseMap<SymbolID, Symbol>().swap(Symbols);
   llvm::sort(SortedSymbols,
              [](const Symbol &L, const Symbol &R) { return L.ID < R.ID; });
+  // Unless symbols were overwritten or erased, every string in the arena is
+  // used and unique, and there is no need to copy them again.
+  if (!HasUnusedStrings)
+    return SymbolSlab(std::move(Arena), std::move(SortedSymbols));
   // We may have unused strings from overwritten symbols. Build a new arena.
   llvm::BumpPtrAllocator NewArena;
   llvm::UniqueStringSaver Strings(NewArena);
   for (auto &S : SortedSymbols)
     own(S, Strings);
+  Arena = llvm::BumpPtrAllocator();
   return SymbolSlab(std::move(NewArena), std::move(SortedSymbols));
 }
 
@@ -206,7 +206,10 @@ public:
     void insert(const Symbol &S);
 
     /// Removes the symbol with an ID, if it exists.
-    void erase(const SymbolID &ID) { Symbols.erase(ID); }
+    void erase(const SymbolID &ID) {
+      if (Symbols.erase(ID))
+        HasUnusedStrings = true;
+    }
 
     /// Returns the symbol with an ID, if it exists. Valid until insert/remove.
     const Symbol *find(const SymbolID &ID) {
@@ -223,6 +226,9 @@ public:
     llvm::UniqueStringSaver UniqueStrings;
     /// Values are indices into Symbols vector.
     llvm::DenseMap<SymbolID, Symbol> Symbols;
+    /// Whether symbols were overwritten or erased, which may leave strings
+    /// in the arena that no symbol uses.
+    bool HasUnusedStrings = false;
   };
 
 private:
@@ -26,7 +26,7 @@ public:
   explicit ChunkIterator(const Token *Tok, llvm::ArrayRef<Chunk> Chunks)
       : Tok(Tok), Chunks(Chunks), CurrentChunk(Chunks.begin()) {
     if (!Chunks.empty()) {
-      DecompressedChunk = CurrentChunk->decompress();
+      CurrentChunk->decompress(DecompressedChunk);
       CurrentID = DecompressedChunk.begin();
     }
   }
@@ -94,7 +94,7 @@ private:
     ++CurrentChunk;
     if (CurrentChunk == Chunks.end()) // Reached the end of PostingList.
       return;
-    DecompressedChunk = CurrentChunk->decompress();
+    CurrentChunk->decompress(DecompressedChunk);
     CurrentID = DecompressedChunk.begin();
   }
 
@@ -102,11 +102,22 @@ private:
   void advanceToChunk(DocID ID) {
     if ((CurrentChunk != Chunks.end() - 1) &&
         ((CurrentChunk + 1)->Head <= ID)) {
+      // The iterators of an AND usually advance to IDs close to the current
+      // one, so gallop over the chunks before searching the last step of the
+      // gallop, instead of searching all remaining chunks.
+      auto First = CurrentChunk + 1;
+      size_t Step = 1;
+      while (Step < size_t(Chunks.end() - First) && First[Step].Head <= ID) {
+        First += Step;
+        Step *= 2;
+      }
+      // First->Head <= ID, and Last is either the end or has Head > ID.
+      auto Last = First + std::min<size_t>(Step, Chunks.end() - First);
       CurrentChunk =
-          std::partition_point(CurrentChunk + 1, Chunks.end(),
-                               [&](const Chunk &C) { return C.Head < ID; });
-      --CurrentChunk;
-      DecompressedChunk = CurrentChunk->decompress();
+          std::partition_point(First + 1, Last,
+                               [&](const Chunk &C) { return C.Head <= ID; }) -
+          1;
+      CurrentChunk->decompress(DecompressedChunk);
       CurrentID = DecompressedChunk.begin();
     }
   }
@@ -182,38 +193,39 @@ std::vector<Chunk> encodeStream(llvm::ArrayRef<DocID> Documents) {
   return std::vector<Chunk>(Result); // no move, shrink-to-fit
 }
 
-/// Reads variable length DocID from the buffer and updates the buffer size. If
-/// the stream is terminated, return None.
-llvm::Optional<DocID> readVByte(llvm::ArrayRef<uint8_t> &Bytes) {
-  if (Bytes.front() == 0 || Bytes.empty())
-    return None;
-  DocID Result = 0;
-  bool HasNextByte = true;
-  for (size_t Length = 0; HasNextByte && !Bytes.empty(); ++Length) {
-    assert(Length <= 5 && "Malformed VByte encoding sequence.");
+} // namespace
+
+void Chunk::decompress(llvm::SmallVectorImpl<DocID> &Result) const {
+  Result.clear();
+  Result.push_back(Head);
+  // Decode the whole payload in one pass, one byte at a time. Each delta is
+  // at least 1, so a zero byte where an encoding starts is the padding after
+  // the last one.
+  DocID Current = Head;
+  DocID Delta = 0;
+  unsigned Shift = 0;
+  for (uint8_t Byte : Payload) {
+    if (Byte == 0 && Shift == 0)
+      break;
+    assert(Shift <= BitsPerEncodingByte * 4 &&
+           "Malformed VByte encoding sequence.");
     // Write meaningful bits to the correct place in the document decoding.
-    Result |= (Bytes.front() & 0x7f) << (BitsPerEncodingByte * Length);
-    if ((Bytes.front() & 0x80) == 0)
-      HasNextByte = false;
-    Bytes = Bytes.drop_front();
+    Delta |= DocID(Byte & 0x7f) << Shift;
+    if (Byte & 0x80) {
+      Shift += BitsPerEncodingByte;
+      continue;
+    }
+    Current += Delta;
+    Result.push_back(Current);
+    Delta = 0;
+    Shift = 0;
   }
-  return Result;
 }
 
-} // namespace
-
 llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Chunk::decompress() const {
-  llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Result{Head};
-  llvm::ArrayRef<uint8_t> Bytes(Payload);
-  DocID Delta;
-  for (DocID Current = Head; !Bytes.empty(); Current += Delta) {
-    auto MaybeDelta = readVByte(Bytes);
-    if (!MaybeDelta)
-      break;
-    Delta = *MaybeDelta;
-    Result.push_back(Current + Delta);
-  }
-  return llvm::SmallVector<DocID, Chunk::PayloadSize + 1>{Result};
+  llvm::SmallVector<DocID, Chunk::PayloadSize + 1> Result;
+  decompress(Result);
+  return Result;
 }
 
 PostingList::PostingList(llvm::ArrayRef<DocID> Documents)
@@ -127,6 +127,13 @@ public:
 private:
   using stopwatch = std::chrono::steady_clock;
 
+  // Results are written with a buffer hint, so that gRPC coalesces them into
+  // fewer frames instead of flushing the stream after every item. The final
+  // message is written without one and flushes everything before it.
+  static grpc::WriteOptions streamResultOptions() {
+    return grpc::WriteOptions().set_buffer_hint();
+  }
+
   grpc::Status Lookup(grpc::ServerContext *Context,
                       const LookupRequest *Request,
                       grpc::ServerWriter<LookupReply> *Reply) override {
@@ -155,9 +162,9 @@ private:
         return;
       }
       LookupReply NextMessage;
-      *NextMessage.mutable_stream_result() = *SerializedItem;
+      *NextMessage.mutable_stream_result() = std::move(*SerializedItem);
       logResponse(NextMessage);
-      Reply->Write(NextMessage);
+      Reply->Write(NextMessage, streamResultOptions());
       ++Sent;
     });
     if (HasMore)
@@ -201,9 +208,9 @@ private:
         return;
       }
       FuzzyFindReply NextMessage;
-      *NextMessage.mutable_stream_result() = *SerializedItem;
+      *NextMessage.mutable_stream_result() = std::move(*SerializedItem);
       logResponse(NextMessage);
-      Reply->Write(NextMessage);
+      Reply->Write(NextMessage, streamResultOptions());
       ++Sent;
     });
     FuzzyFindReply LastMessage;
@@ -243,9 +250,9 @@ private:
         return;
       }
       RefsReply NextMessage;
-      *NextMessage.mutable_stream_result() = *SerializedItem;
+      *NextMessage.mutable_stream_result() = std::move(*SerializedItem);
       logResponse(NextMessage);
-      Reply->Write(NextMessage);
+      Reply->Write(NextMessage, streamResultOptions());
       ++Sent;
     });
     RefsReply LastMessage;
@@ -289,9 +296,9 @@ private:
             return;
           }
           RelationsReply NextMessage;
-          *NextMessage.mutable_stream_result() = *SerializedItem;
+          *NextMessage.mutable_stream_result() = std::move(*SerializedItem);
           logResponse(NextMessage);
-          Reply->Write(NextMessage);
+          Reply->Write(NextMessage, streamResultOptions());
           ++Sent;
         });
     RelationsReply LastMessage;
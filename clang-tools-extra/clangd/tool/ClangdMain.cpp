@@ -398,6 +398,15 @@ opt<PCHStorageFlag> PCHStorage{
     init(PCHStorageFlag::Disk),
 };
 
+opt<unsigned> RetainedClosedPreambles{
+    "retained-closed-preambles",
+    cat(Misc),
+    desc("Number of preambles of closed files to keep in case they are "
+         "opened again (default=0)"),
+    init(0),
+    Hidden,
+};
+
 opt<bool> Sync{
     "sync",
     cat(Misc),
@@ -880,6 +889,7 @@ clangd accepts flags on the commandline, and in the CLANGD_FLAGS environment var
     Opts.StaticIndex = PAI.get();
   }
   Opts.AsyncThreadsCount = WorkerThreadsCount;
+  Opts.RetentionPolicy.MaxRetainedClosedPreambles = RetainedClosedPreambles;
   Opts.FoldingRanges = FoldingRanges;
   Opts.MemoryCleanup = getMemoryCleanupFunction();
 
@@ -824,6 +824,24 @@ TEST(BackgroundQueueTest, Boost) {
   }
 }
 
+TEST(BackgroundQueueTest, Pause) {
+  std::atomic<bool> Ran(false);
+  BackgroundQueue Q;
+  llvm::Optional<BackgroundQueue::PauseScope> Pause;
+  Pause.emplace(Q.pause());
+  Q.push(BackgroundQueue::Task([&] { Ran = true; }));
+
+  std::thread Worker([&] { Q.work(); });
+  EXPECT_FALSE(Q.blockUntilIdleForTest(0.1)) << "task started while paused";
+  EXPECT_FALSE(Ran);
+
+  Pause.reset();
+  EXPECT_TRUE(Q.blockUntilIdleForTest(10));
+  EXPECT_TRUE(Ran);
+  Q.stop();
+  Worker.join();
+}
+
 TEST(BackgroundQueueTest, Duplicates) {
   std::string Sequence;
   BackgroundQueue::Task A([&] { Sequence.push_back('A'); });
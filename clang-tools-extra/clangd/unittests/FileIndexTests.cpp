@@ -575,6 +575,33 @@ TEST(FileIndexTest, Threadsafety) {
   EXPECT_THAT(runFuzzyFind(M, "xxx"), ::testing::SizeIs(Count));
 }
 
+// Verifies that concurrent calls to updatePreamble don't "lose" any updates,
+// even though only one of them may build the index.
+TEST(FileIndexTest, PreambleThreadsafety) {
+  FileIndex M;
+  Notification Go;
+
+  constexpr int Count = 10;
+  {
+    AsyncTaskRunner Pool;
+    for (unsigned I = 0; I < Count; ++I) {
+      TestTU TU;
+      TU.Filename = llvm::formatv("x{0}.cpp", I).str();
+      TU.HeaderFilename = llvm::formatv("x{0}.h", I).str();
+      TU.HeaderCode = llvm::formatv("int xxx{0};", I).str();
+      Pool.runAsync(TU.Filename, [&, Filename(testPath(TU.Filename)),
+                                  AST(TU.build())]() mutable {
+        Go.wait();
+        M.updatePreamble(Filename, /*Version=*/"null", AST.getASTContext(),
+                         AST.getPreprocessor(), AST.getCanonicalIncludes());
+      });
+    }
+    Go.notify();
+  }
+
+  EXPECT_THAT(runFuzzyFind(M, "xxx"), ::testing::SizeIs(Count));
+}
+
 TEST(FileShardedIndexTest, Sharding) {
   auto AHeaderUri = URI::create(testPath("a.h")).toString();
   auto BHeaderUri = URI::create(testPath("b.h")).toString();
@@ -284,6 +284,22 @@ TEST(FuzzyMatch, InitialismAndPrefix) {
   EXPECT_THAT("up", matches("[up]per_bound", 1.f));
 }
 
+// match() only fills in the part of the score table it needs, so scores must
+// not depend on what the matcher saw before.
+TEST(FuzzyMatch, ReusedMatcher) {
+  std::vector<std::string> Words = {"unique_ptr", "up", "u_p",
+                                    "make_unique_ptr", "UniquePtr", "upper",
+                                    "uxp", "unused_parameter"};
+  for (llvm::StringRef Pattern : {"u", "up", "u_p", "unp"}) {
+    FuzzyMatcher Reused(Pattern);
+    for (const std::string &Word : Words)
+      Reused.match(Word);
+    for (auto It = Words.rbegin(); It != Words.rend(); ++It)
+      EXPECT_EQ(FuzzyMatcher(Pattern).match(*It), Reused.match(*It))
+          << "[" << Pattern << "] against " << *It;
+  }
+}
+
 // Returns pretty-printed segmentation of Text.
 // e.g. std::basic_string --> +--  +---- +-----
 std::string segment(llvm::StringRef Text) {
@@ -1190,6 +1190,47 @@ TEST_F(TUSchedulerTests, OnlyPublishWhenPreambleIsBuilt) {
   EXPECT_EQ(PreamblePublishCount, 2);
 }
 
+TEST_F(TUSchedulerTests, ReusesPreambleOfClosedFile) {
+  struct PreamblePublishCounter : public ParsingCallbacks {
+    PreamblePublishCounter(int &PreamblePublishCount)
+        : PreamblePublishCount(PreamblePublishCount) {}
+    void onPreamblePublished(PathRef File) override { ++PreamblePublishCount; }
+    int &PreamblePublishCount;
+  };
+
+  int PreamblePublishCount = 0;
+  auto Opts = optsForTest();
+  Opts.RetentionPolicy.MaxRetainedClosedPreambles = 1;
+  TUScheduler S(CDB, Opts,
+                std::make_unique<PreamblePublishCounter>(PreamblePublishCount));
+
+  Path File = testPath("foo.cpp");
+  S.update(File, getInputs(File, "#define FOO\nint x;"), WantDiagnostics::Auto);
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  EXPECT_EQ(PreamblePublishCount, 1);
+
+  // Reopening the file with the same preamble section reuses the preamble.
+  S.remove(File);
+  S.update(File, getInputs(File, "#define FOO\nint y;"), WantDiagnostics::Auto);
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  EXPECT_EQ(PreamblePublishCount, 1);
+  EXPECT_EQ(S.fileStats().lookup(File).PreambleBuilds, 1u);
+
+  // A different preamble section is built again.
+  S.remove(File);
+  S.update(File, getInputs(File, "#define BAR\nint y;"), WantDiagnostics::Auto);
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  EXPECT_EQ(PreamblePublishCount, 2);
+
+  // Another file does not get the cached preamble.
+  S.remove(File);
+  Path Other = testPath("bar.cpp");
+  S.update(Other, getInputs(Other, "#define BAR\nint y;"),
+           WantDiagnostics::Auto);
+  ASSERT_TRUE(S.blockUntilIdle(timeoutSeconds(10)));
+  EXPECT_EQ(PreamblePublishCount, 3);
+}
+
 // If a header file is missing from the CDB (or inferred using heuristics), and
 // it's included by another open file, then we parse it using that files flags.
 TEST_F(TUSchedulerTests, IncluderCache) {
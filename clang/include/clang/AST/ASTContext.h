@@ -613,11 +613,15 @@ private:
   /// to decide which entities should be instrumented.
   std::unique_ptr<ProfileList> ProfList;
 
+  /// The allocator for AST objects when the ASTContext was not given one.
+  llvm::BumpPtrAllocator OwnedAlloc;
+
   /// The allocator used to create AST objects.
   ///
   /// AST objects are never destructed; rather, all memory associated with the
-  /// AST objects will be released when the ASTContext itself is destroyed.
-  mutable llvm::BumpPtrAllocator BumpAlloc;
+  /// AST objects will be released when the ASTContext itself is destroyed,
+  /// or when the arena it was given is reset.
+  llvm::BumpPtrAllocator &BumpAlloc;
 
   /// Allocator for partial diagnostics.
   PartialDiagnostic::DiagStorageAllocator DiagAllocator;
@@ -1137,9 +1141,14 @@ public:
   /// Keep track of CUDA/HIP device-side variables ODR-used by host code.
   llvm::DenseSet<const VarDecl *> CUDADeviceVarODRUsedByHost;
 
+  /// \param Arena If non-null, the allocator for the AST objects, which
+  /// must outlive the context. A process that builds one AST after another,
+  /// such as a compile server, can call Arena->ResetKeepingSlabs() after
+  /// destroying each context to build the next AST in the same memory.
   ASTContext(LangOptions &LOpts, SourceManager &SM, IdentifierTable &idents,
              SelectorTable &sels, Builtin::Context &builtins,
-             TranslationUnitKind TUKind);
+             TranslationUnitKind TUKind,
+             llvm::BumpPtrAllocator *Arena = nullptr);
   ASTContext(const ASTContext &) = delete;
   ASTContext &operator=(const ASTContext &) = delete;
   ~ASTContext();
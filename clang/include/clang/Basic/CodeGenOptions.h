@@ -291,6 +291,11 @@ public:
   /// -fsymbol-partition (see https://lld.llvm.org/Partitions.html).
   std::string SymbolPartition;
 
+  /// The directory shared by the translation units of a build in which they
+  /// claim the linkonce_odr template instantiations they emit, specified with
+  /// -flinkonce-odr-registry=.
+  std::string LinkOnceODRRegistry;
+
   enum RemarkKind {
     RK_Missing,            // Remark argument not present on the command line.
     RK_Enabled,            // Remark enabled via '-Rgroup'.
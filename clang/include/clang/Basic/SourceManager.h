@@ -683,6 +683,13 @@ class SourceManager : public RefCountedBase<SourceManager> {
   /// expansion.
   SmallVector<SrcMgr::SLocEntry, 0> LocalSLocEntryTable;
 
+  /// The offsets of the entries in LocalSLocEntryTable.
+  ///
+  /// These are kept apart from the entries themselves so that the binary
+  /// search in getFileIDLocal touches a sixth of the memory it would touch in
+  /// the table.
+  SmallVector<SourceLocation::UIntTy, 0> LocalSLocEntryOffsets;
+
   /// The table of SLocEntries that are loaded from other modules.
   ///
   /// Negative FileIDs are indexes into this table. To get from ID to an index,
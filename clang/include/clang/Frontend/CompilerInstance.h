@@ -21,6 +21,7 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/IntrusiveRefCntPtr.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Allocator.h"
 #include "llvm/Support/BuryPointer.h"
 #include "llvm/Support/FileSystem.h"
 #include <cassert>
@@ -47,6 +48,7 @@ class InMemoryModuleCache;
 class Module;
 class Preprocessor;
 class Sema;
+class SharedHeaderLookupCache;
 class SourceManager;
 class TargetInfo;
 enum class DisableValidationForModuleKind;
@@ -94,9 +96,16 @@ class CompilerInstance : public ModuleLoader {
   /// The preprocessor.
   std::shared_ptr<Preprocessor> PP;
 
+  /// The #include lookup results that createPreprocessor shares with other
+  /// compiler instances, if any.
+  std::shared_ptr<SharedHeaderLookupCache> SharedHeaderLookups;
+
   /// The AST context.
   IntrusiveRefCntPtr<ASTContext> Context;
 
+  /// The allocator that createASTContext gives the AST context, if any.
+  llvm::BumpPtrAllocator *ASTArena = nullptr;
+
   /// An optional sema source that will be attached to sema.
   IntrusiveRefCntPtr<ExternalSemaSource> ExternalSemaSrc;
 
@@ -472,6 +481,19 @@ public:
   /// setASTContext - Replace the current AST context.
   void setASTContext(ASTContext *Value);
 
+  /// Have createPreprocessor share the results of #include lookups along the
+  /// search paths with the other compiler instances given \p Cache, such as
+  /// those of a compile server.
+  void
+  setSharedHeaderLookupCache(std::shared_ptr<SharedHeaderLookupCache> Cache) {
+    SharedHeaderLookups = std::move(Cache);
+  }
+
+  /// Have createASTContext allocate the AST in \p Arena, so that a process
+  /// compiling several translation units can reuse its memory. The arena
+  /// must outlive the AST context.
+  void setASTArena(llvm::BumpPtrAllocator *Arena) { ASTArena = Arena; }
+
   /// Replace the current Sema; the compiler instance takes ownership
   /// of S.
   void setSema(Sema *S);
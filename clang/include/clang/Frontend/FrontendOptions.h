@@ -455,6 +455,14 @@ public:
   /// Minimum time granularity (in microseconds) traced by time profiler.
   unsigned TimeTraceGranularity;
 
+  /// Number of sections per thread kept by the time profiler, or 0 to keep
+  /// all of them.
+  unsigned TimeTraceRingBufferSize;
+
+  /// Minimum compilation time (in milliseconds) for the time trace to be
+  /// written.
+  unsigned TimeTraceMinDuration;
+
 public:
   FrontendOptions()
       : DisableFree(false), RelocatablePCH(false), ShowHelp(false),
@@ -466,7 +474,8 @@ public:
         ASTDumpLookups(false), BuildingImplicitModule(false),
         BuildingImplicitModuleUsesLock(true), ModulesEmbedAllFiles(false),
         IncludeTimestamps(true), UseTemporary(true),
-        AllowPCMWithCompilerErrors(false), TimeTraceGranularity(500) {}
+        AllowPCMWithCompilerErrors(false), TimeTraceGranularity(500),
+        TimeTraceRingBufferSize(0), TimeTraceMinDuration(0) {}
 
   /// getInputKindForExtension - Return the appropriate input kind for a file
   /// extension. For example, "c" would return Language::C.
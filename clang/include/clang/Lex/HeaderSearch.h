@@ -20,6 +20,7 @@
 #include "clang/Lex/ModuleMap.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/SmallString.h"
@@ -30,6 +31,7 @@
 #include <cassert>
 #include <cstddef>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -152,6 +154,34 @@ public:
   virtual HeaderFileInfo GetHeaderFileInfo(const FileEntry *FE) = 0;
 };
 
+/// The results of HeaderSearch::LookupFile along the search directories,
+/// shared by the HeaderSearch objects that are given the same cache, such as
+/// those of the translation units a compile server builds. Results are only
+/// reused between HeaderSearch objects with the same search directories.
+///
+/// A shared result is trusted the same way a HeaderSearch trusts its own
+/// results within a translation unit: a header that has since been added
+/// to an earlier search directory is not found. This class is thread-safe.
+class SharedHeaderLookupCache {
+public:
+  /// Returns the index of the search directory in which a lookup of
+  /// \p Filename from \p StartIdx found the file, or the number of search
+  /// directories if it found nothing. Returns None if there is no result.
+  Optional<unsigned> lookup(StringRef SearchDirsKey, StringRef Filename,
+                            unsigned StartIdx);
+
+  /// Records the result of a lookup of \p Filename from \p StartIdx.
+  void insert(StringRef SearchDirsKey, StringRef Filename, unsigned StartIdx,
+              unsigned HitIdx);
+
+private:
+  std::mutex Mutex;
+
+  /// The hit index for each start index and file name, for each
+  /// configuration of search directories.
+  llvm::StringMap<llvm::StringMap<unsigned>> Results;
+};
+
 /// This structure is used to record entries in our framework cache.
 struct FrameworkCacheEntry {
   /// The directory entry which should be used for the cached framework.
@@ -233,6 +263,13 @@ class HeaderSearch {
   };
   llvm::StringMap<LookupFileCacheInfo, llvm::BumpPtrAllocator> LookupFileCache;
 
+  /// Lookup results shared with other HeaderSearch objects, if any.
+  std::shared_ptr<SharedHeaderLookupCache> SharedLookupCache;
+
+  /// Identifies the search directories in SharedLookupCache. Computed on
+  /// first use, and cleared when the search directories change.
+  std::string SharedLookupCacheKey;
+
   /// Collection mapping a framework or subframework
   /// name like "Carbon" to the Carbon.framework directory.
   llvm::StringMap<FrameworkCacheEntry, llvm::BumpPtrAllocator> FrameworkMap;
@@ -296,6 +333,13 @@ public:
   void AddSystemSearchPath(const DirectoryLookup &dir) {
     SearchDirs.push_back(dir);
     SearchDirsUsage.push_back(false);
+    SharedLookupCacheKey.clear();
+  }
+
+  /// Share the results of LookupFile with the other HeaderSearch objects
+  /// that have the same search directories and are given \p Cache.
+  void setSharedLookupCache(std::shared_ptr<SharedHeaderLookupCache> Cache) {
+    SharedLookupCache = std::move(Cache);
   }
 
   /// Set the list of system header prefixes.
@@ -714,6 +758,10 @@ private:
   /// using the search path at index `HitIdx`.
   void cacheLookupSuccess(LookupFileCacheInfo &CacheLookup, unsigned HitIdx,
                           SourceLocation IncludeLoc);
+
+  /// Returns the key of the search directories in SharedLookupCache.
+  StringRef getSharedLookupCacheKey();
+
   /// Note that a lookup at the given include location was successful using the
   /// search path at index `HitIdx`.
   void noteLookupUsage(unsigned HitIdx, SourceLocation IncludeLoc);
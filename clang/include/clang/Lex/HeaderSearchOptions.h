@@ -178,6 +178,10 @@ public:
   /// The set of user-provided virtual filesystem overlay files.
   std::vector<std::string> VFSOverlayFiles;
 
+  /// The set of user-provided stat cache files, see
+  /// llvm::vfs::StatCacheFileSystem.
+  std::vector<std::string> VFSStatCacheFiles;
+
   /// Include the compiler builtin includes.
   unsigned UseBuiltinIncludes : 1;
 
@@ -248,6 +252,10 @@ public:
     VFSOverlayFiles.push_back(std::string(Name));
   }
 
+  void AddVFSStatCacheFile(StringRef Name) {
+    VFSStatCacheFiles.push_back(std::string(Name));
+  }
+
   void AddPrebuiltModulePath(StringRef Name) {
     PrebuiltModulePaths.push_back(std::string(Name));
   }
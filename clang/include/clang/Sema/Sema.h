@@ -898,6 +898,14 @@ public:
       LateParsedTemplateMapT;
   LateParsedTemplateMapT LateParsedTemplateMap;
 
+  /// Member functions whose bodies were kept as tokens under
+  /// -flazy-inline-method-bodies and have not been odr-used yet.
+  llvm::SmallPtrSet<const FunctionDecl *, 16> LazyMethodBodies;
+
+  /// Member functions whose bodies were kept as tokens and have been odr-used,
+  /// to be parsed at the end of the translation unit.
+  SmallVector<FunctionDecl *, 16> PendingLazyMethodBodies;
+
   /// Callback to the parser to parse templated functions when needed.
   typedef void LateTemplateParserCB(void *P, LateParsedTemplate &LPT);
   typedef void LateTemplateParserCleanupCB(void *P);
@@ -7266,6 +7274,15 @@ public:
   void UnmarkAsLateParsedTemplate(FunctionDecl *FD);
   bool IsInsideALocalClassWithinATemplateFunction();
 
+  /// Whether the body of the inline member function \p D can be kept as
+  /// tokens and parsed only once it is odr-used.
+  bool canParseMethodBodyLazily(Decl *D);
+  /// Keep the tokens of the body of \p MD until it is odr-used.
+  void MarkAsLazilyParsedMethod(CXXMethodDecl *MD, CachedTokens &Toks);
+  /// Parse the bodies of the lazily parsed member functions that have been
+  /// odr-used. Returns true if there were any.
+  bool ParsePendingLazyMethodBodies();
+
   Decl *ActOnStaticAssertDeclaration(SourceLocation StaticAssertLoc,
                                      Expr *AssertExpr,
                                      Expr *AssertMessageExpr,
@@ -7717,6 +7734,33 @@ public:
                                SourceLocation TemplateLoc,
                               TemplateArgumentListInfo &TemplateArgs);
 
+private:
+  /// The result of substituting a list of canonical, non-dependent template
+  /// arguments into the pattern of an alias template.
+  struct AliasTemplateSubstitution : llvm::FastFoldingSetNode {
+    AliasTemplateSubstitution(const llvm::FoldingSetNodeID &ID, QualType Type)
+        : FastFoldingSetNode(ID), Type(Type) {}
+
+    QualType Type;
+  };
+
+  /// Caches the successful substitutions into alias templates, so that
+  /// naming the same alias template specialization again does not transform
+  /// its pattern again.
+  llvm::FoldingSet<AliasTemplateSubstitution> AliasTemplateSubstitutions;
+
+  /// Whether the substitutions into an alias template can be cached, which
+  /// is the case unless its pattern contains expressions whose meaning may
+  /// depend on where the specialization is named.
+  llvm::DenseMap<const TypeAliasTemplateDecl *, bool> CacheableAliasTemplates;
+
+  unsigned NumAliasTemplateSubstitutionHits = 0;
+  unsigned NumAliasTemplateSubstitutionMisses = 0;
+
+  bool isAliasTemplateSubstitutionCacheable(TypeAliasTemplateDecl *Template);
+
+public:
+
   TypeResult
   ActOnTemplateIdType(Scope *S, CXXScopeSpec &SS, SourceLocation TemplateKWLoc,
                       TemplateTy Template, IdentifierInfo *TemplateII,
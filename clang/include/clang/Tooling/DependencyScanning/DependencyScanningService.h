@@ -49,7 +49,8 @@ public:
   DependencyScanningService(ScanningMode Mode, ScanningOutputFormat Format,
                             bool ReuseFileManager = true,
                             bool SkipExcludedPPRanges = true,
-                            bool OptimizeArgs = false);
+                            bool OptimizeArgs = false,
+                            StringRef ResultCacheDir = StringRef());
 
   ScanningMode getMode() const { return Mode; }
 
@@ -61,6 +62,8 @@ public:
 
   bool canOptimizeArgs() const { return OptimizeArgs; }
 
+  StringRef getResultCacheDir() const { return ResultCacheDir; }
+
   DependencyScanningFilesystemSharedCache &getSharedCache() {
     return SharedCache;
   }
@@ -75,6 +78,9 @@ private:
   const bool SkipExcludedPPRanges;
   /// Whether to optimize the modules' command-line arguments.
   const bool OptimizeArgs;
+  /// The directory in which to keep the results of make-format scans across
+  /// runs, or empty.
+  const std::string ResultCacheDir;
   /// The global file system cache.
   DependencyScanningFilesystemSharedCache SharedCache;
 };
@@ -80,6 +80,10 @@ public:
   /// return it. If \p ModuleName isn't empty, this function returns the
   /// dependency information of module \p ModuleName.
   ///
+  /// If the service has a result cache directory, the result for a
+  /// translation unit is taken from there when none of its dependencies have
+  /// changed size or modification time since it was stored.
+  ///
   /// \returns A \c StringError with the diagnostic output if clang errors
   /// occurred, dependency file contents otherwise.
   llvm::Expected<std::string>
@@ -105,6 +109,7 @@ public:
 
 private:
   DependencyScanningWorker Worker;
+  std::string ResultCacheDir;
 };
 
 } // end namespace dependencies
@@ -75,6 +75,17 @@ public:
   loadFromBuffer(StringRef DatabaseString, std::string &ErrorMessage,
                  JSONCommandLineSyntax Syntax);
 
+  /// Loads a JSON compilation database from a data buffer, taking ownership
+  /// of the buffer instead of copying it.
+  ///
+  /// The buffer must be null-terminated, and must not change while the
+  /// database is alive.
+  ///
+  /// Returns NULL and sets ErrorMessage if the database could not be loaded.
+  static std::unique_ptr<JSONCompilationDatabase>
+  loadFromBuffer(std::unique_ptr<llvm::MemoryBuffer> DatabaseBuffer,
+                 std::string &ErrorMessage, JSONCommandLineSyntax Syntax);
+
   /// Returns all compile commands in which the specified file was
   /// compiled.
   ///
@@ -851,6 +851,46 @@ namespace {
     /// The number of heap allocations performed so far in this evaluation.
     unsigned NumHeapAllocs = 0;
 
+    /// A call whose result may be reused by identical calls later in this
+    /// evaluation, because it passes and returns only scalars and does not
+    /// touch anything outside its own frames but objects that cannot change.
+    struct MemoizableCall {
+      /// The arguments of the call, which live in the caller's frame.
+      CallRef Arguments;
+      /// The index of the oldest frame holding an object the call accessed,
+      /// or 0 if it accessed a non-constant object outside of any frame.
+      unsigned OldestAccessedFrame;
+    };
+
+    /// The innermost memoizable call being evaluated, if any.
+    MemoizableCall *CurrentMemoizableCall = nullptr;
+
+    /// The results of the memoizable calls evaluated so far, keyed on the
+    /// callee, the evaluation mode and the argument values.
+    std::map<llvm::FoldingSetNodeID, APValue> MemoizedCalls;
+
+    /// Note that the current memoizable call, if any, accessed the object
+    /// designated by Base.
+    void noteObjectAccess(APValue::LValueBase Base) {
+      MemoizableCall *Call = CurrentMemoizableCall;
+      if (!Call)
+        return;
+      unsigned Index = Base.getCallIndex();
+      if (Index == Call->Arguments.CallIndex &&
+          Base.getVersion() == Call->Arguments.Version)
+        return; // One of the call's own parameters.
+      if (!Index) {
+        const ValueDecl *VD = Base.dyn_cast<const ValueDecl *>();
+        bool IsConstant = VD ? VD->getType().isConstQualified()
+                             : Base.is<TypeInfoLValue>() ||
+                                   isa_and_nonnull<StringLiteral>(
+                                       Base.dyn_cast<const Expr *>());
+        if (IsConstant && Base != EvaluatingDecl)
+          return;
+      }
+      Call->OldestAccessedFrame = std::min(Call->OldestAccessedFrame, Index);
+    }
+
     struct EvaluatingConstructorRAII {
       EvalInfo &EI;
       ObjectUnderConstruction Object;
@@ -3957,6 +3997,8 @@ static CompleteObject findCompleteObject(EvalInfo &Info, const Expr *E,
     return CompleteObject();
   }
 
+  Info.noteObjectAccess(LVal.Base);
+
   CallStackFrame *Frame = nullptr;
   unsigned Depth = 0;
   if (LVal.getLValueCallIndex()) {
@@ -6092,7 +6134,45 @@ static bool HandleFunctionCall(SourceLocation CallLoc,
   if (!Info.CheckCallLimit(CallLoc))
     return false;
 
+  // A call to a function that takes and returns scalars gives the same result
+  // for the same arguments, as long as it accesses only its own frames and
+  // objects that cannot change during this evaluation. Look for the result of
+  // an identical call first.
+  llvm::FoldingSetNodeID MemoKey;
+  QualType ReturnType = Callee->getReturnType();
+  bool Memoizable = !This && Call && !Callee->isVariadic() &&
+                    (ReturnType->isIntegralOrEnumerationType() ||
+                     ReturnType->isRealFloatingType()) &&
+                    !Info.checkingPotentialConstantExpression() &&
+                    !Info.checkingForUndefinedBehavior() &&
+                    !Info.SpeculativeEvaluationDepth;
+  if (Memoizable) {
+    MemoKey.AddPointer(Callee->getCanonicalDecl());
+    MemoKey.AddInteger(unsigned(Info.EvalMode));
+    MemoKey.AddBoolean(Info.InConstantContext);
+    for (const ParmVarDecl *PVD : Callee->parameters()) {
+      APValue *Arg = Info.getParamSlot(Call, PVD);
+      if (!Arg || !(Arg->isInt() || Arg->isFloat())) {
+        Memoizable = false;
+        break;
+      }
+      Arg->Profile(MemoKey);
+    }
+  }
+  if (Memoizable) {
+    auto Known = Info.MemoizedCalls.find(MemoKey);
+    if (Known != Info.MemoizedCalls.end()) {
+      Result = Known->second;
+      return true;
+    }
+  }
+
   CallStackFrame Frame(Info, CallLoc, Callee, This, Call);
+  EvalInfo::MemoizableCall Memo = {Call, Frame.Index};
+  llvm::SaveAndRestore<EvalInfo::MemoizableCall *> SaveMemo(
+      Info.CurrentMemoizableCall);
+  if (Memoizable)
+    Info.CurrentMemoizableCall = &Memo;
 
   // For a trivial copy or move assignment, perform an APValue copy. This is
   // essential for unions, where the operations performed by the assignment
@@ -6133,6 +6213,14 @@ static bool HandleFunctionCall(SourceLocation CallLoc,
 
   StmtResult Ret = {Result, ResultSlot};
   EvalStmtResult ESR = EvaluateStmt(Ret, Info, Body);
+  if (Memoizable) {
+    if (ESR == ESR_Returned && Memo.OldestAccessedFrame >= Frame.Index)
+      Info.MemoizedCalls.insert({MemoKey, Result});
+    // The enclosing memoizable call accessed whatever this one accessed.
+    if (EvalInfo::MemoizableCall *Outer = SaveMemo.get())
+      Outer->OldestAccessedFrame =
+          std::min(Outer->OldestAccessedFrame, Memo.OldestAccessedFrame);
+  }
   if (ESR == ESR_Succeeded) {
     if (Callee->getReturnType()->isVoidType())
       return true;
@@ -1239,7 +1239,9 @@ void EmitAssemblyHelper::RunOptimizationPipeline(
                             ? getDefaultProfileGenName()
                             : CodeGenOpts.InstrProfileOutput,
                         "", "", PGOOptions::IRInstr, PGOOptions::NoCSAction,
-                        CodeGenOpts.DebugInfoForProfiling);
+                        CodeGenOpts.DebugInfoForProfiling,
+                        /*PseudoProbeForProfiling=*/false,
+                        CodeGenOpts.AtomicProfileUpdate);
   else if (CodeGenOpts.hasProfileIRUse()) {
     // -fprofile-use.
     auto CSAction = CodeGenOpts.hasProfileCSIRUse() ? PGOOptions::CSIRUse
@@ -1277,13 +1279,16 @@ void EmitAssemblyHelper::RunOptimizationPipeline(
                                      ? getDefaultProfileGenName()
                                      : CodeGenOpts.InstrProfileOutput;
       PGOOpt->CSAction = PGOOptions::CSIRInstr;
+      PGOOpt->AtomicCounterUpdate = CodeGenOpts.AtomicProfileUpdate;
     } else
       PGOOpt = PGOOptions("",
                           CodeGenOpts.InstrProfileOutput.empty()
                               ? getDefaultProfileGenName()
                               : CodeGenOpts.InstrProfileOutput,
                           "", PGOOptions::NoAction, PGOOptions::CSIRInstr,
-                          CodeGenOpts.DebugInfoForProfiling);
+                          CodeGenOpts.DebugInfoForProfiling,
+                          /*PseudoProbeForProfiling=*/false,
+                          CodeGenOpts.AtomicProfileUpdate);
   }
   if (TM)
     TM->setPGOOption(PGOOpt);
@@ -1492,6 +1497,7 @@ void EmitAssemblyHelper::RunOptimizationPipeline(
 
   // Now that we have all of the passes ready, run them.
   PrettyStackTraceString CrashInfo("Optimizer");
+  llvm::TimeTraceScope TimeScope("Optimizer");
   MPM.run(*TheModule, MAM);
 }
 
@@ -1525,6 +1531,7 @@ void EmitAssemblyHelper::RunCodegenPipeline(
   }
 
   PrettyStackTraceString CrashInfo("Code generation");
+  llvm::TimeTraceScope TimeScope("CodeGenPasses");
   CodeGenPasses.run(*TheModule);
 }
 
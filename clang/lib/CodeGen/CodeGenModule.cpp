@@ -45,6 +45,7 @@
 #include "clang/Basic/Version.h"
 #include "clang/CodeGen/ConstantInitBuilder.h"
 #include "clang/Frontend/FrontendDiagnostic.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/ADT/Triple.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
@@ -60,7 +61,10 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/ConvertUTF.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/X86TargetParser.h"
 
@@ -2500,6 +2504,20 @@ void CodeGenModule::EmitDeferred() {
   CurDeclsToEmit.swap(DeferredDeclsToEmit);
 
   for (GlobalDecl &D : CurDeclsToEmit) {
+    // Decls are often queued again after they were emitted. Skip those by
+    // name before GetAddrOfGlobal arranges their type. A definition that
+    // came from another decl with the same mangled name still goes the long
+    // way, which diagnoses the conflict.
+    StringRef MangledName = getMangledName(D);
+    if (llvm::GlobalValue *Existing = GetGlobalValue(MangledName)) {
+      GlobalDecl EmittedGD;
+      if (!Existing->isDeclaration() &&
+          lookupRepresentativeDecl(MangledName, EmittedGD) &&
+          EmittedGD.getCanonicalDecl().getDecl() ==
+              D.getCanonicalDecl().getDecl())
+        continue;
+    }
+
     // We should call GetAddrOfGlobal with IsForDefinition set to true in order
     // to get GlobalValue with exactly the type we need, not something that
     // might had been created for another decl with the same mangled name but
@@ -2511,7 +2529,7 @@ void CodeGenModule::EmitDeferred() {
     // IsForDefinition equal to true. Query mangled names table to get
     // GlobalValue.
     if (!GV)
-      GV = GetGlobalValue(getMangledName(D));
+      GV = GetGlobalValue(MangledName);
 
     // Make sure GetGlobalValue returned non-null.
     assert(GV);
@@ -5003,6 +5021,82 @@ void CodeGenModule::HandleCXXStaticMemberVarInstantiation(VarDecl *VD) {
   EmitTopLevelDecl(VD);
 }
 
+/// Claims the entry \p Key of the -flinkonce-odr-registry directory \p Dir
+/// for the translation unit \p Owner. Returns true if \p Owner holds it,
+/// false if another translation unit does, and None if the registry cannot
+/// be used.
+static llvm::Optional<bool> claimRegistryEntry(StringRef Dir, StringRef Key,
+                                               StringRef Owner) {
+  SmallString<128> Path(Dir);
+  llvm::sys::path::append(Path, Key);
+  if (auto Buf = llvm::MemoryBuffer::getFile(Path))
+    return (*Buf)->getBuffer() == Owner;
+
+  // Write the owner to a file of our own and link it to the entry, which
+  // fails if another translation unit got there first. Readers never see a
+  // partially written entry this way, and no locks are needed.
+  if (llvm::sys::fs::create_directories(Dir))
+    return None;
+  int FD;
+  SmallString<128> TempPath;
+  if (llvm::sys::fs::createUniqueFile(Path + "-%%%%%%%%", FD, TempPath))
+    return None;
+  {
+    llvm::raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    OS << Owner;
+    OS.close();
+    if (OS.has_error()) {
+      OS.clear_error();
+      llvm::sys::fs::remove(TempPath);
+      return None;
+    }
+  }
+  std::error_code EC = llvm::sys::fs::create_hard_link(TempPath, Path);
+  llvm::sys::fs::remove(TempPath);
+  if (!EC)
+    return true;
+  if (auto Buf = llvm::MemoryBuffer::getFile(Path))
+    return (*Buf)->getBuffer() == Owner;
+  return None;
+}
+
+bool CodeGenModule::isLinkOnceODRClaimedElsewhere(GlobalDecl GD,
+                                                  llvm::Function *Fn) {
+  const auto *D = cast<FunctionDecl>(GD.getDecl());
+  if (CodeGenOpts.LinkOnceODRRegistry.empty() ||
+      !Fn->hasLinkOnceODRLinkage() ||
+      D->getTemplateSpecializationKind() != TSK_ImplicitInstantiation)
+    return false;
+  // Structors can be emitted as aliases of each other, which need a
+  // definition to point to.
+  if (isa<CXXConstructorDecl>(D) || isa<CXXDestructorDecl>(D) ||
+      D->isMultiVersion())
+    return false;
+  FunctionDecl *Pattern = D->getTemplateInstantiationPattern();
+  if (!Pattern)
+    return false;
+
+  // The mangled name covers the template arguments, and the ODR hash of the
+  // pattern the definition they were substituted into.
+  llvm::MD5 Hash;
+  Hash.update(getTarget().getTriple().str());
+  Hash.update(Fn->getName());
+  Hash.update(llvm::utostr(Pattern->getODRHash()));
+  llvm::MD5::MD5Result Result;
+  Hash.final(Result);
+
+  llvm::Optional<bool> Ours =
+      claimRegistryEntry(CodeGenOpts.LinkOnceODRRegistry, Result.digest(),
+                         getModule().getModuleIdentifier());
+  if (!Ours)
+    return false;
+  // The owner's copy must survive optimization even where it is not used,
+  // since the other translation units do not emit one.
+  if (*Ours)
+    Fn->setLinkage(llvm::GlobalValue::WeakODRLinkage);
+  return !*Ours;
+}
+
 void CodeGenModule::EmitGlobalFunctionDefinition(GlobalDecl GD,
                                                  llvm::GlobalValue *GV) {
   const auto *D = cast<FunctionDecl>(GD.getDecl());
@@ -5028,12 +5122,24 @@ void CodeGenModule::EmitGlobalFunctionDefinition(GlobalDecl GD,
   auto *Fn = cast<llvm::Function>(GV);
   setFunctionLinkage(GD, Fn);
 
+  // If another translation unit emits the definition, only keep a copy for
+  // inlining, or nothing at all when not optimizing.
+  bool ClaimedElsewhere = isLinkOnceODRClaimedElsewhere(GD, Fn);
+  if (ClaimedElsewhere) {
+    if (CodeGenOpts.OptimizationLevel == 0) {
+      Fn->setLinkage(llvm::GlobalValue::ExternalLinkage);
+      return;
+    }
+    Fn->setLinkage(llvm::GlobalValue::AvailableExternallyLinkage);
+  }
+
   // FIXME: this is redundant with part of setFunctionDefinitionAttributes
   setGVProperties(Fn, GD);
 
   MaybeHandleStaticInExternC(D, Fn);
 
-  maybeSetTrivialComdat(*D, *Fn);
+  if (!ClaimedElsewhere)
+    maybeSetTrivialComdat(*D, *Fn);
 
   // Set CodeGen attributes that represent floating point environment.
   setLLVMFunctionFEnvAttributes(D, Fn);
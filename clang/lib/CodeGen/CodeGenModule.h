@@ -1489,6 +1489,11 @@ private:
   void EmitGlobalFunctionDefinition(GlobalDecl GD, llvm::GlobalValue *GV);
   void EmitMultiVersionFunctionDefinition(GlobalDecl GD, llvm::GlobalValue *GV);
 
+  /// Check the -flinkonce-odr-registry for the linkonce_odr instantiation
+  /// \p Fn. Returns true if another translation unit emits its definition,
+  /// and makes \p Fn weak_odr if this one does.
+  bool isLinkOnceODRClaimedElsewhere(GlobalDecl GD, llvm::Function *Fn);
+
   void EmitGlobalVarDefinition(const VarDecl *D, bool IsTentative = false);
   void EmitExternalVarDeclaration(const VarDecl *D);
   void EmitAliasDefinition(GlobalDecl GD);
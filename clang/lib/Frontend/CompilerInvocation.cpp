@@ -2962,6 +2962,9 @@ static void GenerateHeaderSearchArgs(HeaderSearchOptions &Opts,
 
   for (const std::string &F : Opts.VFSOverlayFiles)
     GenerateArg(Args, OPT_ivfsoverlay, F, SA);
+
+  for (const std::string &F : Opts.VFSStatCacheFiles)
+    GenerateArg(Args, OPT_ivfsstatcache, F, SA);
 }
 
 static bool ParseHeaderSearchArgs(HeaderSearchOptions &Opts, ArgList &Args,
@@ -3096,6 +3099,9 @@ static bool ParseHeaderSearchArgs(HeaderSearchOptions &Opts, ArgList &Args,
   for (const auto *A : Args.filtered(OPT_ivfsoverlay))
     Opts.AddVFSOverlayFile(A->getValue());
 
+  for (const auto *A : Args.filtered(OPT_ivfsstatcache))
+    Opts.AddVFSStatCacheFile(A->getValue());
+
   return Diags.getNumErrors() == NumErrorsBefore;
 }
 
@@ -4669,12 +4675,35 @@ IntrusiveRefCntPtr<llvm::vfs::FileSystem>
 clang::createVFSFromCompilerInvocation(
     const CompilerInvocation &CI, DiagnosticsEngine &Diags,
     IntrusiveRefCntPtr<llvm::vfs::FileSystem> BaseFS) {
-  if (CI.getHeaderSearchOpts().VFSOverlayFiles.empty())
+  const HeaderSearchOptions &HSOpts = CI.getHeaderSearchOpts();
+  if (HSOpts.VFSOverlayFiles.empty() && HSOpts.VFSStatCacheFiles.empty())
     return BaseFS;
 
   IntrusiveRefCntPtr<llvm::vfs::FileSystem> Result = BaseFS;
+  // The stat caches describe the real file system, so they go below the
+  // overlays.
+  for (const auto &File : HSOpts.VFSStatCacheFiles) {
+    llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Buffer =
+        Result->getBufferForFile(File);
+    if (!Buffer) {
+      Diags.Report(diag::warn_vfs_stat_cache_ignored)
+          << File << Buffer.getError().message();
+      continue;
+    }
+
+    auto FSOrErr =
+        llvm::vfs::StatCacheFileSystem::create(std::move(*Buffer), Result);
+    if (!FSOrErr) {
+      Diags.Report(diag::warn_vfs_stat_cache_ignored)
+          << File << llvm::toString(FSOrErr.takeError());
+      continue;
+    }
+
+    Result = std::move(*FSOrErr);
+  }
+
   // earlier vfs files are on the bottom
-  for (const auto &File : CI.getHeaderSearchOpts().VFSOverlayFiles) {
+  for (const auto &File : HSOpts.VFSOverlayFiles) {
     llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Buffer =
         Result->getBufferForFile(File);
     if (!Buffer) {
@@ -12,7 +12,10 @@
 
 #include "IncrementalExecutor.h"
 
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
 #include "llvm/ExecutionEngine/ExecutionEngine.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
 #include "llvm/ExecutionEngine/Orc/CompileUtils.h"
 #include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
 #include "llvm/ExecutionEngine/Orc/IRCompileLayer.h"
@@ -20,20 +23,134 @@
 #include "llvm/ExecutionEngine/Orc/RTDyldObjectLinkingLayer.h"
 #include "llvm/ExecutionEngine/SectionMemoryManager.h"
 #include "llvm/IR/Module.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <mutex>
 
 namespace clang {
 
+namespace {
+/// Keeps the object code compiled for each module in a directory, so that a
+/// later session compiling the same module, for example the same prelude,
+/// loads the object instead of running the code generator again.
+///
+/// A module is looked up by a hash of its bitcode and of the target it is
+/// compiled for. Failures to read or write the directory are not errors; the
+/// module is compiled as usual.
+class JITObjectCache : public llvm::ObjectCache {
+  std::string Dir;
+  std::string TargetKey;
+
+  /// The paths computed by getObject for modules that are being compiled.
+  /// The code generator changes the module before notifyObjectCompiled is
+  /// called, so the hash cannot be computed again at that point.
+  std::mutex PendingLock;
+  llvm::DenseMap<const llvm::Module *, std::string> PendingPaths;
+
+public:
+  JITObjectCache(llvm::StringRef Dir, std::string TargetKey)
+      : Dir(Dir), TargetKey(std::move(TargetKey)) {}
+
+  std::unique_ptr<llvm::MemoryBuffer>
+  getObject(const llvm::Module *M) override {
+    std::string Path = getPath(*M);
+    auto Buf = llvm::MemoryBuffer::getFile(Path, /*IsText=*/false,
+                                           /*RequiresNullTerminator=*/false);
+    if (Buf)
+      return std::move(*Buf);
+    std::lock_guard<std::mutex> Guard(PendingLock);
+    PendingPaths[M] = std::move(Path);
+    return nullptr;
+  }
+
+  void notifyObjectCompiled(const llvm::Module *M,
+                            llvm::MemoryBufferRef Obj) override {
+    std::string Path;
+    {
+      std::lock_guard<std::mutex> Guard(PendingLock);
+      auto It = PendingPaths.find(M);
+      if (It == PendingPaths.end())
+        return;
+      Path = std::move(It->second);
+      PendingPaths.erase(It);
+    }
+
+    // Write to a temporary file and rename it, so that concurrent sessions
+    // never see a partial object.
+    int FD;
+    llvm::SmallString<128> TempPath;
+    if (llvm::sys::fs::createUniqueFile(Path + "-%%%%%%.tmp", FD, TempPath))
+      return;
+    {
+      llvm::raw_fd_ostream OS(FD, /*shouldClose=*/true);
+      OS << Obj.getBuffer();
+      OS.close();
+      if (OS.has_error()) {
+        OS.clear_error();
+        llvm::sys::fs::remove(TempPath);
+        return;
+      }
+    }
+    if (llvm::sys::fs::rename(TempPath, Path))
+      llvm::sys::fs::remove(TempPath);
+  }
+
+private:
+  std::string getPath(const llvm::Module &M) const {
+    llvm::SmallString<0> Bitcode;
+    llvm::raw_svector_ostream OS(Bitcode);
+    llvm::WriteBitcodeToFile(M, OS);
+
+    llvm::SHA1 Hasher;
+    Hasher.update(TargetKey);
+    Hasher.update(Bitcode);
+    llvm::SmallString<128> Path(Dir);
+    llvm::sys::path::append(Path,
+                            "jit-" + llvm::toHex(Hasher.result()) + ".o");
+    return std::string(Path.str());
+  }
+};
+} // end anonymous namespace
+
 IncrementalExecutor::IncrementalExecutor(llvm::orc::ThreadSafeContext &TSC,
                                          llvm::Error &Err,
-                                         const llvm::Triple &Triple)
+                                         const llvm::Triple &Triple,
+                                         llvm::StringRef ObjectCacheDir)
     : TSCtx(TSC) {
   using namespace llvm::orc;
   llvm::ErrorAsOutParameter EAO(&Err);
 
   auto JTMB = JITTargetMachineBuilder(Triple);
-  if (auto JitOrErr = LLJITBuilder().setJITTargetMachineBuilder(JTMB).create())
+  LLJITBuilder Builder;
+  Builder.setJITTargetMachineBuilder(JTMB);
+  if (!ObjectCacheDir.empty()) {
+    if (std::error_code EC =
+            llvm::sys::fs::create_directories(ObjectCacheDir)) {
+      Err = llvm::createStringError(EC, "cannot create JIT object cache '" +
+                                            ObjectCacheDir + "'");
+      return;
+    }
+    ObjCache = std::make_unique<JITObjectCache>(
+        ObjectCacheDir, Triple.str() + ";" + JTMB.getCPU() + ";" +
+                            JTMB.getFeatures().getString());
+    Builder.setCompileFunctionCreator(
+        [this](JITTargetMachineBuilder JTMB)
+            -> llvm::Expected<std::unique_ptr<IRCompileLayer::IRCompiler>> {
+          auto TM = JTMB.createTargetMachine();
+          if (!TM)
+            return TM.takeError();
+          return std::make_unique<TMOwningSimpleCompiler>(std::move(*TM),
+                                                          ObjCache.get());
+        });
+  }
+
+  if (auto JitOrErr = Builder.create())
     Jit = std::move(*JitOrErr);
   else {
     Err = JitOrErr.takeError();
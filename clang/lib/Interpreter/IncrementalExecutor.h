@@ -22,6 +22,7 @@
 namespace llvm {
 class Error;
 class Module;
+class ObjectCache;
 namespace orc {
 class LLJIT;
 class ThreadSafeContext;
@@ -31,14 +32,20 @@ class ThreadSafeContext;
 namespace clang {
 class IncrementalExecutor {
   using CtorDtorIterator = llvm::orc::CtorDtorIterator;
+  /// Cache of compiled objects used by the JIT, if any. Declared before the
+  /// JIT so that it outlives it.
+  std::unique_ptr<llvm::ObjectCache> ObjCache;
   std::unique_ptr<llvm::orc::LLJIT> Jit;
   llvm::orc::ThreadSafeContext &TSCtx;
 
 public:
   enum SymbolNameKind { IRName, LinkerName };
 
+  /// \param ObjectCacheDir if not empty, the directory in which the object
+  /// code of every module is kept and reused across sessions.
   IncrementalExecutor(llvm::orc::ThreadSafeContext &TSC, llvm::Error &Err,
-                      const llvm::Triple &Triple);
+                      const llvm::Triple &Triple,
+                      llvm::StringRef ObjectCacheDir = "");
   ~IncrementalExecutor();
 
   llvm::Error addModule(std::unique_ptr<llvm::Module> M);
@@ -207,7 +207,8 @@ llvm::Error Interpreter::Execute(PartialTranslationUnit &T) {
     const llvm::Triple &Triple =
         getCompilerInstance()->getASTContext().getTargetInfo().getTriple();
     llvm::Error Err = llvm::Error::success();
-    IncrExecutor = std::make_unique<IncrementalExecutor>(*TSCtx, Err, Triple);
+    IncrExecutor = std::make_unique<IncrementalExecutor>(*TSCtx, Err, Triple,
+                                                         JITObjectCacheDir);
 
     if (Err)
       return Err;
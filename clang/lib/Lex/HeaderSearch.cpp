@@ -37,6 +37,7 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/VirtualFileSystem.h"
+#include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
@@ -79,6 +80,36 @@ HeaderFileInfo::getControllingMacro(ExternalPreprocessorSource *External) {
 
 ExternalHeaderFileInfoSource::~ExternalHeaderFileInfoSource() = default;
 
+/// Returns the key of the lookup of \p Filename from \p StartIdx.
+static SmallString<128> getSharedLookupKey(StringRef Filename,
+                                           unsigned StartIdx) {
+  SmallString<128> Key;
+  llvm::raw_svector_ostream(Key) << StartIdx << ':' << Filename;
+  return Key;
+}
+
+Optional<unsigned> SharedHeaderLookupCache::lookup(StringRef SearchDirsKey,
+                                                   StringRef Filename,
+                                                   unsigned StartIdx) {
+  SmallString<128> Key = getSharedLookupKey(Filename, StartIdx);
+  std::lock_guard<std::mutex> Lock(Mutex);
+  auto Dirs = Results.find(SearchDirsKey);
+  if (Dirs == Results.end())
+    return None;
+  auto Result = Dirs->second.find(Key);
+  if (Result == Dirs->second.end())
+    return None;
+  return Result->second;
+}
+
+void SharedHeaderLookupCache::insert(StringRef SearchDirsKey,
+                                     StringRef Filename, unsigned StartIdx,
+                                     unsigned HitIdx) {
+  SmallString<128> Key = getSharedLookupKey(Filename, StartIdx);
+  std::lock_guard<std::mutex> Lock(Mutex);
+  Results[SearchDirsKey][Key] = HitIdx;
+}
+
 HeaderSearch::HeaderSearch(std::shared_ptr<HeaderSearchOptions> HSOpts,
                            SourceManager &SourceMgr, DiagnosticsEngine &Diags,
                            const LangOptions &LangOpts,
@@ -121,6 +152,7 @@ void HeaderSearch::SetSearchPaths(
   SystemDirIdx = systemDirIdx;
   NoCurDirSearch = noCurDirSearch;
   SearchDirToHSEntry = std::move(searchDirToHSEntry);
+  SharedLookupCacheKey.clear();
   //LookupFileCache.clear();
 }
 
@@ -131,6 +163,25 @@ void HeaderSearch::AddSearchPath(const DirectoryLookup &dir, bool isAngled) {
   if (!isAngled)
     AngledDirIdx++;
   SystemDirIdx++;
+  SharedLookupCacheKey.clear();
+}
+
+StringRef HeaderSearch::getSharedLookupCacheKey() {
+  if (!SharedLookupCacheKey.empty())
+    return SharedLookupCacheKey;
+
+  // Relative search directories and overlays are resolved against the
+  // working directory, so it is part of the key.
+  llvm::raw_string_ostream OS(SharedLookupCacheKey);
+  OS << FileMgr.getFileSystemOpts().WorkingDir << '\0' << AngledDirIdx << ','
+     << SystemDirIdx << '\0';
+  for (const std::string &Overlay : HSOpts->VFSOverlayFiles)
+    OS << Overlay << '\0';
+  for (const DirectoryLookup &DL : SearchDirs)
+    OS << DL.getLookupType() << DL.getDirCharacteristic()
+       << DL.isIndexHeaderMap() << DL.getName() << '\0';
+  OS.flush();
+  return SharedLookupCacheKey;
 }
 
 std::vector<bool> HeaderSearch::computeUserEntryUsage() const {
@@ -990,6 +1041,12 @@ Optional<FileEntryRef> HeaderSearch::LookupFile(
     // our search start.  We will fill in our found location below, so prime the
     // start point value.
     CacheLookup.reset(/*StartIdx=*/i+1);
+
+    // Another translation unit may have done the same lookup already.
+    if (!SkipCache && SharedLookupCache)
+      if (Optional<unsigned> HitIdx = SharedLookupCache->lookup(
+              getSharedLookupCacheKey(), Filename, i))
+        i = *HitIdx;
   }
 
   SmallString<64> MappedName;
@@ -1069,6 +1126,9 @@ Optional<FileEntryRef> HeaderSearch::LookupFile(
 
     // Remember this location for the next lookup we do.
     cacheLookupSuccess(CacheLookup, i, IncludeLoc);
+    if (SharedLookupCache && !CacheLookup.MappedName)
+      SharedLookupCache->insert(getSharedLookupCacheKey(), Filename,
+                                CacheLookup.StartIdx - 1, i);
     return File;
   }
 
@@ -1114,6 +1174,9 @@ Optional<FileEntryRef> HeaderSearch::LookupFile(
 
   // Otherwise, didn't find it. Remember we didn't find this.
   CacheLookup.HitIdx = SearchDirs.size();
+  if (SharedLookupCache && !CacheLookup.MappedName)
+    SharedLookupCache->insert(getSharedLookupCacheKey(), Filename,
+                              CacheLookup.StartIdx - 1, SearchDirs.size());
   return None;
 }
 
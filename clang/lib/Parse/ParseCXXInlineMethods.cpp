@@ -529,6 +529,13 @@ void Parser::ParseLexedMethodDefs(ParsingClass &Class) {
 }
 
 void Parser::ParseLexedMethodDef(LexedMethod &LM) {
+  // With -flazy-inline-method-bodies, keep the tokens of the body, and parse
+  // them at the end of the translation unit if the function is odr-used.
+  if (Actions.canParseMethodBodyLazily(LM.D)) {
+    Actions.MarkAsLazilyParsedMethod(cast<CXXMethodDecl>(LM.D), LM.Toks);
+    return;
+  }
+
   // If this is a member template, introduce the template parameter scope.
   ReenterTemplateScopeRAII InFunctionTemplateScope(*this, LM.D);
 
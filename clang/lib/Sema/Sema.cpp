@@ -473,6 +473,13 @@ Sema::~Sema() {
   for (auto *Node : Satisfactions)
     delete Node;
 
+  // Delete cached alias template substitutions.
+  std::vector<AliasTemplateSubstitution *> Substitutions;
+  for (auto &Node : AliasTemplateSubstitutions)
+    Substitutions.push_back(&Node);
+  for (auto *Node : Substitutions)
+    delete Node;
+
   threadSafety::threadSafetyCleanup(ThreadSafetyDeclCache);
 
   // Destroys data sharing attributes stack for OpenMP
@@ -550,6 +557,10 @@ void Sema::addExternalSource(ExternalSemaSource *E) {
 void Sema::PrintStats() const {
   llvm::errs() << "\n*** Semantic Analysis Stats:\n";
   llvm::errs() << NumSFINAEErrors << " SFINAE diagnostics trapped.\n";
+  llvm::errs() << NumAliasTemplateSubstitutionHits << " of "
+               << NumAliasTemplateSubstitutionHits +
+                      NumAliasTemplateSubstitutionMisses
+               << " alias template substitutions taken from the cache.\n";
 
   BumpAlloc.PrintStats();
   AnalysisWarnings.PrintStats();
@@ -929,7 +940,10 @@ static bool MethodsAndNestedClassesComplete(const CXXRecordDecl *RD,
                                   E = RD->decls_end();
        I != E && Complete; ++I) {
     if (const CXXMethodDecl *M = dyn_cast<CXXMethodDecl>(*I))
-      Complete = M->isDefined() || M->isDefaulted() ||
+      // A body left unparsed by -flazy-inline-method-bodies may use members
+      // the rest of the class does not.
+      Complete = (M->isDefined() && !M->isLateTemplateParsed()) ||
+                 M->isDefaulted() ||
                  (M->isPure() && !isa<CXXDestructorDecl>(M));
     else if (const FunctionTemplateDecl *F = dyn_cast<FunctionTemplateDecl>(*I))
       // If the template function is marked as late template parsed at this
@@ -1067,6 +1081,23 @@ void Sema::ActOnEndOfTranslationUnitFragment(TUFragmentKind Kind) {
     PerformPendingInstantiations();
   }
 
+  // Parse the bodies of the lazily parsed member functions that were
+  // odr-used. They can use more templates, virtual functions and lazily
+  // parsed functions in turn.
+  while (ParsePendingLazyMethodBodies()) {
+    DefineUsedVTables();
+    llvm::TimeTraceScope TimeScope("PerformPendingInstantiations");
+    PerformPendingInstantiations();
+  }
+
+  if (llvm::timeTraceProfilerEnabled()) {
+    llvm::TimeTraceScope TimeScope("AliasTemplateSubstitutionCache", [&]() {
+      return (Twine(NumAliasTemplateSubstitutionHits) + " hits, " +
+              Twine(NumAliasTemplateSubstitutionMisses) + " misses")
+          .str();
+    });
+  }
+
   emitDeferredDiags();
 
   assert(LateParsedInstantiations.empty() &&
@@ -17321,6 +17321,10 @@ void Sema::MarkFunctionReferenced(SourceLocation Loc, FunctionDecl *Func,
             Consumer.HandleCXXImplicitFunctionInstantiation(Func);
           }
         }
+      } else if (LazyMethodBodies.erase(Func)) {
+        // The body was kept as tokens; parse it at the end of the
+        // translation unit.
+        PendingLazyMethodBodies.push_back(Func);
       } else {
         // Walk redefinitions, as some of them may be instantiable.
         for (auto i : Func->redecls()) {
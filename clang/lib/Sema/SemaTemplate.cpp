@@ -3634,6 +3634,44 @@ Sema::findFailedBooleanCondition(Expr *Cond) {
   return { FailedCond, Description };
 }
 
+namespace {
+
+/// Finds the expressions in an alias template pattern that may mean something
+/// different depending on where a specialization of the alias is named: those
+/// that involve name lookup, overload resolution or access checks when they
+/// are instantiated, and lambdas, which have a new closure type every time.
+class ContextSensitiveExprFinder
+    : public RecursiveASTVisitor<ContextSensitiveExprFinder> {
+public:
+  bool Found = false;
+
+  bool VisitStmt(Stmt *S) {
+    auto *E = dyn_cast<Expr>(S);
+    if (E && !E->isTypeDependent() &&
+        isa<IntegerLiteral, CharacterLiteral, CXXBoolLiteralExpr, ParenExpr,
+            ImplicitCastExpr, UnaryOperator, BinaryOperator,
+            ConditionalOperator, DeclRefExpr, SizeOfPackExpr,
+            UnaryExprOrTypeTraitExpr>(E))
+      return true;
+    Found = true;
+    return false;
+  }
+};
+
+} // end anonymous namespace
+
+bool Sema::isAliasTemplateSubstitutionCacheable(
+    TypeAliasTemplateDecl *Template) {
+  auto Known = CacheableAliasTemplates.find(Template);
+  if (Known != CacheableAliasTemplates.end())
+    return Known->second;
+
+  ContextSensitiveExprFinder Finder;
+  if (TypeSourceInfo *TSI = Template->getTemplatedDecl()->getTypeSourceInfo())
+    Finder.TraverseTypeLoc(TSI->getTypeLoc());
+  return CacheableAliasTemplates[Template] = !Finder.Found;
+}
+
 QualType Sema::CheckTemplateIdType(TemplateName Name,
                                    SourceLocation TemplateLoc,
                                    TemplateArgumentListInfo &TemplateArgs) {
@@ -3685,6 +3723,29 @@ QualType Sema::CheckTemplateIdType(TemplateName Name,
     if (Pattern->isInvalidDecl())
       return QualType();
 
+    // Naming a specialization we substituted before yields the same type,
+    // unless the pattern may mean something else at this point of use.
+    llvm::FoldingSetNodeID ID;
+    void *InsertPos = nullptr;
+    bool Cacheable =
+        !Name.isDependent() &&
+        !TemplateSpecializationType::anyDependentTemplateArguments(
+            TemplateArgs, Converted) &&
+        isAliasTemplateSubstitutionCacheable(AliasTemplate);
+    if (Cacheable) {
+      ID.AddPointer(AliasTemplate->getCanonicalDecl());
+      for (const TemplateArgument &Arg : Converted)
+        Arg.Profile(ID, Context);
+      if (AliasTemplateSubstitution *Known =
+              AliasTemplateSubstitutions.FindNodeOrInsertPos(ID, InsertPos)) {
+        ++NumAliasTemplateSubstitutionHits;
+        return Context.getTemplateSpecializationType(Name, TemplateArgs,
+                                                     Known->Type);
+      }
+      ++NumAliasTemplateSubstitutionMisses;
+    }
+    unsigned NumErrorsBefore = getDiagnostics().getNumErrors();
+
     TemplateArgumentList StackTemplateArgs(TemplateArgumentList::OnStack,
                                            Converted);
 
@@ -3737,6 +3798,16 @@ QualType Sema::CheckTemplateIdType(TemplateName Name,
 
       return QualType();
     }
+
+    // Only remember substitutions that produced no errors, outside of SFINAE
+    // contexts, where diagnostics are suppressed. The substitution may have
+    // added entries of its own, so look for the insert position again.
+    if (Cacheable && !CanonType->isInstantiationDependentType() &&
+        getDiagnostics().getNumErrors() == NumErrorsBefore &&
+        !isSFINAEContext() &&
+        !AliasTemplateSubstitutions.FindNodeOrInsertPos(ID, InsertPos))
+      AliasTemplateSubstitutions.InsertNode(
+          new AliasTemplateSubstitution(ID, CanonType), InsertPos);
   } else if (Name.isDependent() ||
              TemplateSpecializationType::anyDependentTemplateArguments(
                  TemplateArgs, Converted)) {
@@ -10949,6 +11020,53 @@ void Sema::UnmarkAsLateParsedTemplate(FunctionDecl *FD) {
   FD->setLateTemplateParsed(false);
 }
 
+bool Sema::canParseMethodBodyLazily(Decl *D) {
+  // The body might be needed without being odr-used while serializing the
+  // AST, for code completion, or by the device-side compilation models.
+  if (!getLangOpts().LazyInlineMethodBodies || TUKind != TU_Complete ||
+      getLangOpts().Modules || PP.isCodeCompletionEnabled() ||
+      getLangOpts().CUDA || getLangOpts().OpenMP || getLangOpts().SYCLIsDevice)
+    return false;
+
+  // Member templates and members of templates have their own late parsing.
+  // Bodies needed for constant evaluation or return type deduction, and those
+  // emitted whether or not they are used, are parsed as usual.
+  auto *MD = dyn_cast_or_null<CXXMethodDecl>(D);
+  if (!MD || MD->isInvalidDecl() || MD->isDependentContext() ||
+      MD->isConstexpr() || MD->getReturnType()->getContainedAutoType() ||
+      MD->hasAttr<UsedAttr>() || MD->hasAttr<RetainAttr>() ||
+      MD->hasAttr<DLLExportAttr>() || MD->hasAttr<DLLImportAttr>())
+    return false;
+  const CXXRecordDecl *RD = MD->getParent();
+  return !RD->isLocalClass() && !RD->isLambda();
+}
+
+void Sema::MarkAsLazilyParsedMethod(CXXMethodDecl *MD, CachedTokens &Toks) {
+  MarkAsLateParsedTemplate(MD, MD, Toks);
+  // A body parsed earlier in the class may already have odr-used it.
+  if (MD->isUsed(/*CheckUsedAttr=*/false))
+    PendingLazyMethodBodies.push_back(MD);
+  else
+    LazyMethodBodies.insert(MD);
+}
+
+bool Sema::ParsePendingLazyMethodBodies() {
+  if (PendingLazyMethodBodies.empty() || !LateTemplateParser)
+    return false;
+
+  // Parsing a body can odr-use more of these functions.
+  for (unsigned I = 0; I != PendingLazyMethodBodies.size(); ++I) {
+    FunctionDecl *FD = PendingLazyMethodBodies[I];
+    auto LPT = LateParsedTemplateMap.find(FD);
+    assert(LPT != LateParsedTemplateMap.end() && "no tokens for the body");
+    LateTemplateParser(OpaqueParser, *LPT->second);
+    // Hand the definition to the consumer, like an instantiation.
+    Consumer.HandleTopLevelDecl(DeclGroupRef(FD));
+  }
+  PendingLazyMethodBodies.clear();
+  return true;
+}
+
 bool Sema::IsInsideALocalClassWithinATemplateFunction() {
   DeclContext *DC = CurContext;
 
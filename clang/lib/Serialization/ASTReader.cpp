@@ -2644,9 +2644,14 @@ ASTReader::ReadControlBlock(ModuleFile &F,
 
       // All user input files reside at the index range [0, NumUserInputs), and
       // system input files reside at [NumUserInputs, NumInputs). For explicitly
-      // loaded module files, ignore missing inputs.
+      // loaded module files, ignore missing inputs. An implicit module that
+      // this process built, or already validated, can't be rebuilt, and its
+      // inputs went through the same FileManager, so skip those too.
+      bool IsFinalImplicitModule =
+          F.Kind == MK_ImplicitModule &&
+          getModuleManager().getModuleCache().isPCMFinal(F.FileName);
       if (!DisableValidation && F.Kind != MK_ExplicitModule &&
-          F.Kind != MK_PrebuiltModule) {
+          F.Kind != MK_PrebuiltModule && !IsFinalImplicitModule) {
         bool Complain = (ClientLoadCapabilities & ARR_OutOfDate) == 0;
 
         // If we are reading a module, we will create a verification timestamp,
@@ -4290,11 +4295,12 @@ ASTReader::ASTReadResult ASTReader::ReadAST(StringRef FileName,
     }
 
     // Preload all the pending interesting identifiers by marking them out of
-    // date.
+    // date. Only the key and the ID of each one are read here; the rest of its
+    // data is read when it is first used.
+    ASTIdentifierLookupTrait Trait(*this, F);
     for (auto Offset : F.PreloadIdentifierOffsets) {
       const unsigned char *Data = F.IdentifierTableData + Offset;
 
-      ASTIdentifierLookupTrait Trait(*this, F);
       auto KeyDataLen = Trait.ReadKeyDataLength(Data);
       auto Key = Trait.ReadKey(Data, KeyDataLen.first);
       auto &II = PP.getIdentifierTable().getOwn(Key);
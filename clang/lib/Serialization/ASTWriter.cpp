@@ -98,6 +98,7 @@
 #include "llvm/Support/LEB128.h"
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/OnDiskHashTable.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SHA1.h"
 #include "llvm/Support/VersionTuple.h"
@@ -1993,24 +1994,31 @@ void ASTWriter::WriteHeaderSearch(const HeaderSearch &HS) {
     free(const_cast<char *>(SavedStrings[I]));
 }
 
+/// Compresses the contents of a source-location buffer, without its
+/// terminating null character. Returns false if it is stored uncompressed.
+static bool compressBlob(StringRef Blob, SmallVectorImpl<char> &Compressed) {
+  // We expect that almost all PCM consumers will not want its contents.
+  if (!llvm::zlib::isAvailable())
+    return false;
+  llvm::Error E = llvm::zlib::compress(Blob.drop_back(1), Compressed);
+  if (!E)
+    return true;
+  llvm::consumeError(std::move(E));
+  return false;
+}
+
 static void emitBlob(llvm::BitstreamWriter &Stream, StringRef Blob,
+                     bool IsCompressed, StringRef CompressedBuffer,
                      unsigned SLocBufferBlobCompressedAbbrv,
                      unsigned SLocBufferBlobAbbrv) {
   using RecordDataType = ASTWriter::RecordData::value_type;
 
-  // Compress the buffer if possible. We expect that almost all PCM
-  // consumers will not want its contents.
-  SmallString<0> CompressedBuffer;
-  if (llvm::zlib::isAvailable()) {
-    llvm::Error E = llvm::zlib::compress(Blob.drop_back(1), CompressedBuffer);
-    if (!E) {
-      RecordDataType Record[] = {SM_SLOC_BUFFER_BLOB_COMPRESSED,
-                                 Blob.size() - 1};
-      Stream.EmitRecordWithBlob(SLocBufferBlobCompressedAbbrv, Record,
-                                CompressedBuffer);
-      return;
-    }
-    llvm::consumeError(std::move(E));
+  if (IsCompressed) {
+    RecordDataType Record[] = {SM_SLOC_BUFFER_BLOB_COMPRESSED,
+                               Blob.size() - 1};
+    Stream.EmitRecordWithBlob(SLocBufferBlobCompressedAbbrv, Record,
+                              CompressedBuffer);
+    return;
   }
 
   RecordDataType Record[] = {SM_SLOC_BUFFER_BLOB};
@@ -2041,6 +2049,50 @@ void ASTWriter::WriteSourceManagerBlock(SourceManager &SourceMgr,
       CreateSLocBufferBlobAbbrev(Stream, true);
   unsigned SLocExpansionAbbrv = CreateSLocExpansionAbbrev(Stream);
 
+  // Returns the contents of the buffer stored after the record of a local
+  // source-location entry, if it has one. Include the implicit terminating
+  // null character in the on-disk buffer if we're writing it uncompressed.
+  auto GetBufferBlob =
+      [&](const SrcMgr::SLocEntry &SLoc) -> llvm::Optional<StringRef> {
+    if (!SLoc.isFile())
+      return llvm::None;
+    const SrcMgr::ContentCache &Content = SLoc.getFile().getContentCache();
+    if (Content.OrigEntry &&
+        (SkippedModuleMaps.count(Content.OrigEntry) ||
+         !(Content.BufferOverridden || Content.IsTransient)))
+      return llvm::None;
+    llvm::Optional<llvm::MemoryBufferRef> Buffer =
+        Content.getBufferOrNone(PP.getDiagnostics(), PP.getFileManager());
+    if (!Buffer)
+      Buffer = llvm::MemoryBufferRef("<<<INVALID BUFFER>>>", "");
+    return StringRef(Buffer->getBufferStart(), Buffer->getBufferSize() + 1);
+  };
+
+  // Compressing the buffers takes most of the time spent writing this block,
+  // and each of them is independent of the others, so compress them all up
+  // front in parallel. The records are still written in order, so the output
+  // does not depend on the number of threads. Getting the buffers may read
+  // files and emit diagnostics, so that part stays on this thread.
+  std::vector<unsigned> BlobEntries;
+  std::vector<StringRef> Blobs;
+  for (unsigned I = 1, N = SourceMgr.local_sloc_entry_size(); I != N; ++I) {
+    if (llvm::Optional<StringRef> Blob =
+            GetBufferBlob(SourceMgr.getLocalSLocEntry(I))) {
+      BlobEntries.push_back(I);
+      Blobs.push_back(*Blob);
+    }
+  }
+  struct CompressedBlob {
+    SmallString<0> Data;
+    bool IsCompressed = false;
+  };
+  std::vector<CompressedBlob> CompressedBlobs(Blobs.size());
+  llvm::parallelForEachN(0, Blobs.size(), [&](size_t I) {
+    CompressedBlobs[I].IsCompressed =
+        compressBlob(Blobs[I], CompressedBlobs[I].Data);
+  });
+  unsigned NextBlob = 0;
+
   // Write out the source location entry table. We skip the first
   // entry, which is always the same dummy entry.
   std::vector<uint32_t> SLocEntryOffsets;
@@ -2130,15 +2182,15 @@ void ASTWriter::WriteSourceManagerBlock(SourceManager &SourceMgr,
       }
 
       if (EmitBlob) {
-        // Include the implicit terminating null character in the on-disk buffer
-        // if we're writing it uncompressed.
-        llvm::Optional<llvm::MemoryBufferRef> Buffer =
-            Content->getBufferOrNone(PP.getDiagnostics(), PP.getFileManager());
-        if (!Buffer)
-          Buffer = llvm::MemoryBufferRef("<<<INVALID BUFFER>>>", "");
-        StringRef Blob(Buffer->getBufferStart(), Buffer->getBufferSize() + 1);
-        emitBlob(Stream, Blob, SLocBufferBlobCompressedAbbrv,
+        assert(NextBlob < BlobEntries.size() && BlobEntries[NextBlob] == I &&
+               "Buffer blobs out of sync with the entries");
+        CompressedBlob &Compressed = CompressedBlobs[NextBlob];
+        emitBlob(Stream, Blobs[NextBlob], Compressed.IsCompressed,
+                 Compressed.Data, SLocBufferBlobCompressedAbbrv,
                  SLocBufferBlobAbbrv);
+        // Release the compressed copy once it is in the stream.
+        Compressed.Data = SmallString<0>();
+        ++NextBlob;
       }
     } else {
       // The source location entry is a macro expansion.
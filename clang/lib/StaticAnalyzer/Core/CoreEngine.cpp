@@ -119,11 +119,10 @@ bool CoreEngine::ExecuteWorkList(const LocationContext *L, unsigned Steps,
 
   // Check if we have a steps limit
   bool UnlimitedSteps = Steps == 0;
-  // Cap our pre-reservation in the event that the user specifies
-  // a very large number of maximum steps.
-  const unsigned PreReservationCap = 4000000;
-  if(!UnlimitedSteps)
-    G.reserve(std::min(Steps,PreReservationCap));
+  // Don't size the graph for the steps limit up front: most functions finish
+  // with a small fraction of it, and a bucket array that large costs a page
+  // fault for nearly every node. Growing the graph on demand costs about two
+  // extra hashes per node in total.
 
   while (WList->hasWork()) {
     if (!UnlimitedSteps) {
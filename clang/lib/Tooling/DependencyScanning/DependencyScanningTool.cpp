@@ -7,7 +7,13 @@
 //===----------------------------------------------------------------------===//
 
 #include "clang/Tooling/DependencyScanning/DependencyScanningTool.h"
+#include "clang/Basic/Version.h"
 #include "clang/Frontend/Utils.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 
 namespace clang{
 namespace tooling{
@@ -43,7 +49,87 @@ FullDependencies::getAdditionalArgsWithoutModulePaths() const {
 
 DependencyScanningTool::DependencyScanningTool(
     DependencyScanningService &Service)
-    : Worker(Service) {}
+    : Worker(Service), ResultCacheDir(Service.getResultCacheDir()) {}
+
+// An entry of the result cache lists the size, the modification time and the
+// absolute path of each dependency on a line of its own, followed by an empty
+// line and the dependency file contents.
+
+static std::string
+getResultCachePath(StringRef Dir, const std::vector<std::string> &CommandLine,
+                   StringRef CWD) {
+  llvm::MD5 Hash;
+  auto Add = [&Hash](StringRef S) {
+    Hash.update(S);
+    Hash.update(StringRef("\0", 1));
+  };
+  Add(getClangFullVersion());
+  Add(CWD);
+  for (const std::string &Arg : CommandLine)
+    Add(Arg);
+  llvm::MD5::MD5Result Result;
+  Hash.final(Result);
+  SmallString<256> Path(Dir);
+  llvm::sys::path::append(Path, Result.digest());
+  return std::string(Path.str());
+}
+
+static llvm::Optional<std::string> readCachedResult(StringRef EntryPath) {
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> Entry =
+      llvm::MemoryBuffer::getFile(EntryPath);
+  if (!Entry)
+    return None;
+  StringRef Rest = (*Entry)->getBuffer();
+  while (!Rest.empty()) {
+    StringRef Line;
+    std::tie(Line, Rest) = Rest.split('\n');
+    if (Line.empty())
+      return Rest.str();
+    StringRef Size, Time, Path;
+    std::tie(Size, Line) = Line.split(' ');
+    std::tie(Time, Path) = Line.split(' ');
+    uint64_t ExpectedSize;
+    int64_t ExpectedTime;
+    if (Size.getAsInteger(10, ExpectedSize) ||
+        Time.getAsInteger(10, ExpectedTime))
+      return None;
+    llvm::sys::fs::file_status Status;
+    if (llvm::sys::fs::status(Path, Status) ||
+        Status.getSize() != ExpectedSize ||
+        Status.getLastModificationTime().time_since_epoch().count() !=
+            ExpectedTime)
+      return None;
+  }
+  return None;
+}
+
+static void writeCachedResult(StringRef Dir, StringRef EntryPath,
+                              ArrayRef<std::string> Dependencies, StringRef CWD,
+                              StringRef Output,
+                              llvm::sys::TimePoint<> ScanStart) {
+  std::string Text;
+  llvm::raw_string_ostream OS(Text);
+  for (const std::string &Dep : Dependencies) {
+    SmallString<256> Path(Dep);
+    llvm::sys::fs::make_absolute(CWD, Path);
+    llvm::sys::fs::file_status Status;
+    if (llvm::sys::fs::status(Path, Status))
+      return;
+    // On a file system with coarse timestamps, a file written shortly before
+    // the scan could be written again without its time changing.
+    if (Status.getLastModificationTime() + std::chrono::seconds(2) > ScanStart)
+      return;
+    OS << Status.getSize() << ' '
+       << Status.getLastModificationTime().time_since_epoch().count() << ' '
+       << Path << '\n';
+  }
+  OS << '\n' << Output;
+  if (llvm::sys::fs::create_directories(Dir))
+    return;
+  // A failure to write the entry only costs a later scan some time.
+  llvm::consumeError(
+      llvm::writeFileAtomically(EntryPath + "-%%%%%%%%", EntryPath, OS.str()));
+}
 
 llvm::Expected<std::string> DependencyScanningTool::getDependencyFile(
     const std::vector<std::string> &CommandLine, StringRef CWD,
@@ -94,11 +180,21 @@ llvm::Expected<std::string> DependencyScanningTool::getDependencyFile(
       Generator.printDependencies(S);
     }
 
+    ArrayRef<std::string> getDependencies() const { return Dependencies; }
+
   private:
     std::unique_ptr<DependencyOutputOptions> Opts;
     std::vector<std::string> Dependencies;
   };
 
+  std::string EntryPath;
+  llvm::sys::TimePoint<> ScanStart = std::chrono::system_clock::now();
+  if (!ResultCacheDir.empty() && !ModuleName) {
+    EntryPath = getResultCachePath(ResultCacheDir, CommandLine, CWD);
+    if (llvm::Optional<std::string> Cached = readCachedResult(EntryPath))
+      return std::move(*Cached);
+  }
+
   MakeDependencyPrinterConsumer Consumer;
   auto Result =
       Worker.computeDependencies(CWD, CommandLine, Consumer, ModuleName);
@@ -106,6 +202,9 @@ llvm::Expected<std::string> DependencyScanningTool::getDependencyFile(
     return std::move(Result);
   std::string Output;
   Consumer.printDependencies(Output);
+  if (!EntryPath.empty())
+    writeCachedResult(ResultCacheDir, EntryPath, Consumer.getDependencies(),
+                      CWD, Output, ScanStart);
   return Output;
 }
 
@@ -202,19 +202,21 @@ JSONCompilationDatabase::loadFromFile(StringRef FilePath,
     ErrorMessage = "Error while opening JSON database: " + Result.message();
     return nullptr;
   }
-  std::unique_ptr<JSONCompilationDatabase> Database(
-      new JSONCompilationDatabase(std::move(*DatabaseBuffer), Syntax));
-  if (!Database->parse(ErrorMessage))
-    return nullptr;
-  return Database;
+  return loadFromBuffer(std::move(*DatabaseBuffer), ErrorMessage, Syntax);
 }
 
 std::unique_ptr<JSONCompilationDatabase>
 JSONCompilationDatabase::loadFromBuffer(StringRef DatabaseString,
                                         std::string &ErrorMessage,
                                         JSONCommandLineSyntax Syntax) {
-  std::unique_ptr<llvm::MemoryBuffer> DatabaseBuffer(
-      llvm::MemoryBuffer::getMemBufferCopy(DatabaseString));
+  return loadFromBuffer(llvm::MemoryBuffer::getMemBufferCopy(DatabaseString),
+                        ErrorMessage, Syntax);
+}
+
+std::unique_ptr<JSONCompilationDatabase>
+JSONCompilationDatabase::loadFromBuffer(
+    std::unique_ptr<llvm::MemoryBuffer> DatabaseBuffer,
+    std::string &ErrorMessage, JSONCommandLineSyntax Syntax) {
   std::unique_ptr<JSONCompilationDatabase> Database(
       new JSONCompilationDatabase(std::move(DatabaseBuffer), Syntax));
   if (!Database->parse(ErrorMessage))
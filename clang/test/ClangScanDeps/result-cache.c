@@ -0,0 +1,40 @@
+// Check that -result-cache-dir reuses the result of a scan, and that it scans
+// again when a dependency changes.
+
+// RUN: rm -rf %t && split-file %s %t
+// RUN: sed -e "s|DIR|%/t|g" %t/cdb.json.template > %t/cdb.json
+// RUN: touch -t 202001010000 %t/tu.c %t/a.h %t/b.h
+//
+// RUN: clang-scan-deps -compilation-database %t/cdb.json -j 1 \
+// RUN:   -result-cache-dir %t/cache | FileCheck %s --check-prefix=FIRST
+// RUN: ls %t/cache | count 1
+// RUN: clang-scan-deps -compilation-database %t/cdb.json -j 1 \
+// RUN:   -result-cache-dir %t/cache | FileCheck %s --check-prefix=FIRST
+//
+// RUN: echo '#include "b.h"' >> %t/a.h
+// RUN: clang-scan-deps -compilation-database %t/cdb.json -j 1 \
+// RUN:   -result-cache-dir %t/cache | FileCheck %s --check-prefix=SECOND
+
+// FIRST:      tu.o:
+// FIRST-NEXT:   tu.c
+// FIRST-NEXT:   a.h
+// FIRST-NOT:    b.h
+
+// SECOND:      tu.o:
+// SECOND-NEXT:   tu.c
+// SECOND-NEXT:   a.h
+// SECOND-NEXT:   b.h
+
+//--- cdb.json.template
+[{
+  "directory": "DIR",
+  "command": "clang -E DIR/tu.c -o DIR/tu.o",
+  "file": "DIR/tu.c"
+}]
+
+//--- tu.c
+#include "a.h"
+
+//--- a.h
+
+//--- b.h
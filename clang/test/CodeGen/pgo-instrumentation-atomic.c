@@ -0,0 +1,11 @@
+/// -fprofile-update=atomic makes IR PGO instrumentation update the counters
+/// atomically.
+// RUN: %clang_cc1 %s -triple x86_64 -emit-llvm -fprofile-instrument=llvm -fprofile-update=atomic -o - | FileCheck %s
+// RUN: %clang_cc1 %s -triple x86_64 -emit-llvm -fprofile-instrument=llvm -o - | FileCheck %s --check-prefix=NONATOMIC
+
+// CHECK-LABEL: define {{.*}}@foo
+// CHECK: atomicrmw add {{.*}}@__profc_foo{{.*}} monotonic
+// NONATOMIC-LABEL: define {{.*}}@foo
+// NONATOMIC-NOT: atomicrmw
+// NONATOMIC: store {{.*}}@__profc_foo
+void foo() {}
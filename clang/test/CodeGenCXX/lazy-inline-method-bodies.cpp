@@ -0,0 +1,23 @@
+// RUN: %clang_cc1 -triple x86_64-linux-gnu -flazy-inline-method-bodies -emit-llvm -o - %s | FileCheck %s --implicit-check-not=_ZN1S6unusedEv
+// RUN: %clang_cc1 -triple x86_64-linux-gnu -flazy-inline-method-bodies -fsyntax-only -verify %s
+// expected-no-diagnostics
+
+struct S {
+  int x;
+  S() : x(0) {}
+  int used() { return helper() + 1; }
+  int helper() { return x; }
+  // Never odr-used, so its body is not parsed.
+  int unused() { return undeclared(); }
+  virtual int virt() { return x * 2; }
+};
+
+int f() {
+  S s;
+  return s.used();
+}
+
+// CHECK-DAG: define linkonce_odr {{.*}} @_ZN1SC2Ev(
+// CHECK-DAG: define linkonce_odr {{.*}}i32 @_ZN1S4usedEv(
+// CHECK-DAG: define linkonce_odr {{.*}}i32 @_ZN1S6helperEv(
+// CHECK-DAG: define linkonce_odr {{.*}}i32 @_ZN1S4virtEv(
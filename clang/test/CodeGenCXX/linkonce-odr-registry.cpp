@@ -0,0 +1,36 @@
+// RUN: rm -rf %t && split-file %s %t
+// RUN: %clang_cc1 -triple x86_64-linux-gnu -emit-llvm -flinkonce-odr-registry=%t/registry -I%t %t/a.cpp -o - | FileCheck %s --check-prefix=OWNER
+// RUN: %clang_cc1 -triple x86_64-linux-gnu -emit-llvm -flinkonce-odr-registry=%t/registry -I%t %t/b.cpp -o - | FileCheck %s --check-prefix=OTHER
+// RUN: %clang_cc1 -triple x86_64-linux-gnu -emit-llvm -O1 -disable-llvm-passes -flinkonce-odr-registry=%t/registry -I%t %t/b.cpp -o - | FileCheck %s --check-prefix=OTHER-OPT
+//
+// Compiling the owner again keeps its claim.
+// RUN: %clang_cc1 -triple x86_64-linux-gnu -emit-llvm -flinkonce-odr-registry=%t/registry -I%t %t/a.cpp -o - | FileCheck %s --check-prefix=OWNER
+
+//--- t.h
+template <typename T> T twice(T X) { return X + X; }
+template <typename T> struct S {
+  S() {}
+  T get() { return 1; }
+};
+inline int notTemplate() { return 2; }
+
+//--- a.cpp
+#include "t.h"
+int a() { return twice(1) + S<int>().get() + notTemplate(); }
+
+// OWNER-DAG: define weak_odr {{.*}}i32 @_Z5twiceIiET_S0_(i32 {{.*}}) {{.*}}comdat
+// OWNER-DAG: define weak_odr {{.*}}i32 @_ZN1SIiE3getEv({{.*}}) {{.*}}comdat
+// OWNER-DAG: define linkonce_odr {{.*}}i32 @_Z11notTemplatev()
+
+//--- b.cpp
+#include "t.h"
+int b() { return twice(1) + twice(1L) + S<int>().get() + notTemplate(); }
+
+// OTHER-DAG: declare {{.*}}i32 @_Z5twiceIiET_S0_(i32
+// OTHER-DAG: declare {{.*}}i32 @_ZN1SIiE3getEv(
+// OTHER-DAG: define weak_odr {{.*}}i64 @_Z5twiceIlET_S0_(
+// OTHER-DAG: define linkonce_odr {{.*}} @_ZN1SIiEC2Ev(
+// OTHER-DAG: define linkonce_odr {{.*}}i32 @_Z11notTemplatev()
+
+// OTHER-OPT-DAG: define available_externally {{.*}}i32 @_Z5twiceIiET_S0_(i32
+// OTHER-OPT-DAG: define available_externally {{.*}}i32 @_ZN1SIiE3getEv(
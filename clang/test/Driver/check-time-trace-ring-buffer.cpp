@@ -0,0 +1,27 @@
+// RUN: rm -f %T/check-time-trace-ring-buffer.json
+// RUN: %clangxx -S -ftime-trace -ftime-trace-granularity=0 -ftime-trace-ring-buffer=4 -o %T/check-time-trace-ring-buffer %s
+// RUN: cat %T/check-time-trace-ring-buffer.json \
+// RUN:   | %python -c 'import json, sys; events = [e for e in json.load(sys.stdin)["traceEvents"] if e["ph"] == "X" and not e["name"].startswith("Total ")]; print(len(events))' \
+// RUN:   | FileCheck %s
+
+// The sections that ended last are kept.
+// CHECK: 4
+
+// RUN: rm -f %T/check-time-trace-min-duration.json
+// RUN: %clangxx -S -ftime-trace -ftime-trace-min-duration=1000000 -o %T/check-time-trace-min-duration %s
+// RUN: not ls %T/check-time-trace-min-duration.json
+
+// RUN: %clangxx -### -S -ftime-trace -ftime-trace-ring-buffer=4096 -ftime-trace-min-duration=10000 %s 2>&1 \
+// RUN:   | FileCheck --check-prefix=DRIVER %s
+// DRIVER: "-ftime-trace-ring-buffer=4096" "-ftime-trace-min-duration=10000"
+
+template <typename T>
+struct Struct {
+  T Num;
+};
+
+int main() {
+  Struct<int> S;
+
+  return 0;
+}
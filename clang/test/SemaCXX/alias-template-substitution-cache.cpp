@@ -0,0 +1,25 @@
+// RUN: %clang_cc1 -std=c++20 -fsyntax-only -verify -print-stats %s 2>&1 | FileCheck %s
+
+// CHECK: {{[1-9][0-9]*}} of {{[0-9]+}} alias template substitutions taken from the cache.
+
+namespace reuse {
+template <class T> struct Box { using type = T; };
+template <class T> using Unbox = typename Box<T>::type;
+static_assert(__is_same(Unbox<int>, int));
+static_assert(__is_same(Unbox<int>, int));
+static_assert(__is_same(Unbox<const int>, const int));
+
+template <int N> using Array = Box<int[N + 1]>;
+static_assert(__is_same(Array<1>, Box<int[2]>));
+static_assert(__is_same(Array<1>, Box<int[2]>));
+static_assert(__is_same(Array<2>, Box<int[3]>));
+}
+
+namespace sfinae {
+// A substitution failure is not remembered.
+template <class T> using Type = typename T::type; // expected-error {{type 'int' cannot be used prior to '::' because it has no members}}
+template <class T> Type<T> f(int);
+template <class T> void f(...);
+void g() { f<int>(0); }
+Type<int> x; // expected-note {{in instantiation of template type alias 'Type' requested here}}
+}
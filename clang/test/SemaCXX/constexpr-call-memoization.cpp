@@ -0,0 +1,16 @@
+// RUN: %clang_cc1 -std=c++14 -fsyntax-only -verify %s -fconstexpr-steps 10000
+// expected-no-diagnostics
+
+// Without reusing the results of earlier calls with the same argument, this
+// takes about fib(N) steps.
+constexpr unsigned long long fib(int n) {
+  return n < 2 ? n : fib(n - 1) + fib(n - 2);
+}
+static_assert(fib(80) == 23416728348467685ULL, "");
+
+// Constant globals cannot change during an evaluation, so calls that read
+// them can be reused too.
+constexpr int Table[] = {1, 2, 3};
+constexpr int sum(int n) { return n < 0 ? 0 : Table[n % 3] + sum(n - 1); }
+constexpr int twice(int n) { return sum(n) + sum(n); }
+static_assert(twice(300) == 2 * (100 * 6 + 1), "");
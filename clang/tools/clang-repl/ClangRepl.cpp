@@ -28,6 +28,10 @@ static llvm::cl::list<std::string>
               llvm::cl::CommaSeparated);
 static llvm::cl::opt<bool> OptHostSupportsJit("host-supports-jit",
                                               llvm::cl::Hidden);
+static llvm::cl::opt<std::string> OptJITObjectCache(
+    "jit-object-cache", llvm::cl::value_desc("dir"),
+    llvm::cl::desc("Keep the JIT-compiled code in <dir> and reuse it in "
+                   "later sessions"));
 static llvm::cl::list<std::string> OptInputs(llvm::cl::Positional,
                                              llvm::cl::ZeroOrMore,
                                              llvm::cl::desc("[code to run]"));
@@ -84,6 +88,8 @@ int main(int argc, const char **argv) {
   CI->LoadRequestedPlugins();
 
   auto Interp = ExitOnErr(clang::Interpreter::create(std::move(CI)));
+  if (!OptJITObjectCache.empty())
+    Interp->setJITObjectCacheDirectory(OptJITObjectCache);
   for (const std::string &input : OptInputs) {
     if (auto Err = Interp->ParseAndExecute(input))
       llvm::logAllUnhandledErrors(std::move(Err), llvm::errs(), "error: ");
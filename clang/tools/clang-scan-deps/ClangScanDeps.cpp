@@ -175,6 +175,13 @@ static llvm::cl::opt<bool> OptimizeArgs(
     llvm::cl::desc("Whether to optimize command-line arguments of modules."),
     llvm::cl::init(false), llvm::cl::cat(DependencyScannerCategory));
 
+static llvm::cl::opt<std::string> ResultCacheDir(
+    "result-cache-dir",
+    llvm::cl::desc("Keep the results of make-format scans in this directory, "
+                   "and reuse them while the dependencies of a translation "
+                   "unit keep their size and modification time."),
+    llvm::cl::cat(DependencyScannerCategory));
+
 llvm::cl::opt<unsigned>
     NumThreads("j", llvm::cl::Optional,
                llvm::cl::desc("Number of worker threads to use (default: use "
@@ -531,7 +538,8 @@ int main(int argc, const char **argv) {
   SharedStream DependencyOS(llvm::outs());
 
   DependencyScanningService Service(ScanMode, Format, ReuseFileManager,
-                                    SkipExcludedPPRanges, OptimizeArgs);
+                                    SkipExcludedPPRanges, OptimizeArgs,
+                                    ResultCacheDir);
   llvm::ThreadPool Pool(llvm::hardware_concurrency(NumThreads));
   std::vector<std::unique_ptr<DependencyScanningTool>> WorkerTools;
   for (unsigned I = 0; I < Pool.getThreadCount(); ++I)
@@ -0,0 +1,60 @@
+//===--- clang-stat-cache/ClangStatCache.cpp --------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Writes a stat cache for a directory tree that does not change between
+/// compilations, such as an SDK. Compilations that get the cache with
+/// -ivfsstatcache answer the status queries of header search under the tree
+/// from it instead of from the file system.
+///
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Support/VirtualFileSystem.h"
+#include "llvm/Support/WithColor.h"
+
+using namespace llvm;
+
+static cl::opt<std::string> Root(cl::Positional, cl::Required,
+                                 cl::desc("<directory>"));
+
+static cl::opt<std::string> Output("o", cl::Required,
+                                   cl::desc("Output stat cache file"),
+                                   cl::value_desc("filename"));
+
+int main(int argc, char **argv) {
+  InitLLVM X(argc, argv);
+  cl::ParseCommandLineOptions(
+      argc, argv,
+      "Writes a stat cache for the directory tree at <directory>, for use with "
+      "-ivfsstatcache.\nThe cache must be written again whenever anything in "
+      "the tree changes.\n");
+
+  auto reportError = [argv](Error E) {
+    logAllUnhandledErrors(std::move(E), WithColor::error(errs(), argv[0]));
+    return 1;
+  };
+
+  SmallString<256> RootPath(Root);
+  if (std::error_code EC = sys::fs::make_absolute(RootPath))
+    return reportError(createFileError(Root, EC));
+
+  std::error_code EC;
+  ToolOutputFile Out(Output, EC, sys::fs::OF_None);
+  if (EC)
+    return reportError(createFileError(Output, EC));
+  if (Error E = vfs::StatCacheFileSystem::writeStatCache(RootPath, Out.os()))
+    return reportError(std::move(E));
+  Out.keep();
+  return 0;
+}
@@ -0,0 +1,269 @@
+//===--- clang-time-trace-merge/ClangTimeTraceMerge.cpp ---------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// Combines the -ftime-trace files of the compilations of a build into
+/// reports that rank what the build spends its time on:
+///
+/// - headers, by the time spent parsing them including what they include;
+/// - template families, the instantiations of a template with any template
+///   arguments, by the time spent instantiating them;
+/// - functions, by the time the optimizer and the code generator spend on
+///   them.
+///
+/// A section that is nested in one of the same kind and name, such as a
+/// template instantiated recursively, is counted once.
+///
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/Optional.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/ToolOutputFile.h"
+#include "llvm/Support/WithColor.h"
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+static cl::list<std::string> Inputs(cl::Positional, cl::OneOrMore,
+                                    cl::desc("<trace files>"));
+
+static cl::opt<std::string> Output("o", cl::init("-"),
+                                   cl::desc("Output report file"),
+                                   cl::value_desc("filename"));
+
+static cl::opt<unsigned> Top("top", cl::init(20),
+                             cl::desc("Number of entries in each report "
+                                      "(0 for all)"));
+
+namespace {
+
+enum ReportKind {
+  RK_Header,
+  RK_Template,
+  RK_Optimization,
+  RK_CodeGen,
+  RK_NumReports
+};
+
+const char *const ReportTitles[RK_NumReports] = {
+    "Headers by inclusive parse time",
+    "Template families by instantiation time",
+    "Functions by optimization time",
+    "Functions by code generation time",
+};
+
+struct Entry {
+  uint64_t Micros = 0;
+  unsigned Count = 0;
+};
+
+struct Event {
+  StringRef Name;
+  StringRef Detail;
+  int64_t TID;
+  uint64_t Start;
+  uint64_t End;
+};
+
+/// An event that encloses the one being looked at. Kind is RK_NumReports
+/// for events that are not counted in any report.
+struct OpenEvent {
+  uint64_t End;
+  StringRef Name;
+  ReportKind Kind;
+  std::string Key;
+};
+
+/// Returns \p Name with the arguments of every template in it left out, so
+/// "std::vector<int>::push_back" becomes "std::vector<>::push_back".
+std::string getTemplateFamily(StringRef Name) {
+  std::string Family;
+  unsigned Depth = 0;
+  for (size_t I = 0, E = Name.size(); I != E; ++I) {
+    char C = Name[I];
+    // The '<' of "operator<" and the like does not open a list.
+    if (C == '<' && Name.take_front(I).endswith("operator")) {
+      StringRef Op = Name.substr(I);
+      for (StringRef Candidate : {"<=>", "<<=", "<<", "<=", "<"})
+        if (Op.startswith(Candidate)) {
+          if (Depth == 0)
+            Family += Candidate.str();
+          I += Candidate.size() - 1;
+          break;
+        }
+      continue;
+    }
+    if (C == '<') {
+      if (Depth++ == 0)
+        Family += C;
+      continue;
+    }
+    if (C == '>' && Depth > 0) {
+      if (--Depth == 0)
+        Family += C;
+      continue;
+    }
+    if (Depth == 0)
+      Family += C;
+  }
+  return Family;
+}
+
+class ReportBuilder {
+  StringMap<Entry> Reports[RK_NumReports];
+
+  /// Returns the report \p E is counted in and its key there, or None.
+  static Optional<std::pair<ReportKind, std::string>>
+  classify(const Event &E, ArrayRef<OpenEvent> Stack) {
+    if (E.Name == "Source")
+      return std::make_pair(RK_Header, E.Detail.str());
+    if (E.Name == "InstantiateFunction" || E.Name == "InstantiateClass")
+      return std::make_pair(RK_Template, getTemplateFamily(E.Detail));
+    if (E.Name == "OptFunction") {
+      bool InCodeGen = llvm::any_of(Stack, [](const OpenEvent &O) {
+        return O.Name == "CodeGenPasses";
+      });
+      return std::make_pair(InCodeGen ? RK_CodeGen : RK_Optimization,
+                            E.Detail.str());
+    }
+    return None;
+  }
+
+public:
+  Error addTrace(StringRef File) {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> Buf = MemoryBuffer::getFile(File);
+    if (!Buf)
+      return createFileError(File, Buf.getError());
+    Expected<json::Value> Trace = json::parse((*Buf)->getBuffer());
+    if (!Trace)
+      return createFileError(File, Trace.takeError());
+    const json::Object *Root = Trace->getAsObject();
+    const json::Array *TraceEvents =
+        Root ? Root->getArray("traceEvents") : nullptr;
+    if (!TraceEvents)
+      return createFileError(File, createStringError(inconvertibleErrorCode(),
+                                                     "not a time trace"));
+
+    std::vector<Event> Events;
+    for (const json::Value &V : *TraceEvents) {
+      const json::Object *O = V.getAsObject();
+      if (!O || O->getString("ph") != StringRef("X"))
+        continue;
+      Optional<StringRef> Name = O->getString("name");
+      Optional<int64_t> TID = O->getInteger("tid");
+      Optional<int64_t> TS = O->getInteger("ts");
+      Optional<int64_t> Dur = O->getInteger("dur");
+      // The totals the profiler adds at the end are not sections.
+      if (!Name || Name->startswith("Total ") || !TID || !TS || !Dur)
+        continue;
+      Event E{*Name, "", *TID, uint64_t(*TS), uint64_t(*TS + *Dur)};
+      if (const json::Object *Args = O->getObject("args"))
+        if (Optional<StringRef> Detail = Args->getString("detail"))
+          E.Detail = *Detail;
+      Events.push_back(E);
+    }
+
+    // Enclosing sections start first, and end last among those starting at
+    // the same time.
+    llvm::sort(Events, [](const Event &A, const Event &B) {
+      if (A.TID != B.TID)
+        return A.TID < B.TID;
+      if (A.Start != B.Start)
+        return A.Start < B.Start;
+      return A.End > B.End;
+    });
+
+    SmallVector<OpenEvent, 32> Stack;
+    for (size_t I = 0, N = Events.size(); I != N; ++I) {
+      const Event &E = Events[I];
+      if (I && Events[I - 1].TID != E.TID)
+        Stack.clear();
+      while (!Stack.empty() && Stack.back().End <= E.Start)
+        Stack.pop_back();
+
+      OpenEvent Open{E.End, E.Name, RK_NumReports, ""};
+      if (auto Class = classify(E, Stack)) {
+        Open.Kind = Class->first;
+        Open.Key = std::move(Class->second);
+        bool Nested = llvm::any_of(Stack, [&](const OpenEvent &O) {
+          return O.Kind == Open.Kind && O.Key == Open.Key;
+        });
+        if (!Nested) {
+          Entry &Ent = Reports[Open.Kind][Open.Key];
+          Ent.Micros += E.End - E.Start;
+          ++Ent.Count;
+        }
+      }
+      Stack.push_back(std::move(Open));
+    }
+    return Error::success();
+  }
+
+  void print(raw_ostream &OS) const {
+    for (unsigned K = 0; K != RK_NumReports; ++K) {
+      std::vector<const StringMapEntry<Entry> *> Sorted;
+      for (const StringMapEntry<Entry> &Ent : Reports[K])
+        Sorted.push_back(&Ent);
+      llvm::sort(Sorted, [](const StringMapEntry<Entry> *A,
+                            const StringMapEntry<Entry> *B) {
+        if (A->getValue().Micros != B->getValue().Micros)
+          return A->getValue().Micros > B->getValue().Micros;
+        return A->getKey() < B->getKey();
+      });
+      if (Top && Sorted.size() > Top)
+        Sorted.resize(Top);
+
+      if (K)
+        OS << "\n";
+      OS << "*** " << ReportTitles[K] << "\n";
+      OS << "  Total (ms)     Count  Name\n";
+      for (const StringMapEntry<Entry> *Ent : Sorted)
+        OS << format("%12.1f  %8u  ", Ent->getValue().Micros / 1000.0,
+                     Ent->getValue().Count)
+           << Ent->getKey() << "\n";
+    }
+  }
+};
+
+} // namespace
+
+int main(int argc, char **argv) {
+  InitLLVM X(argc, argv);
+  cl::ParseCommandLineOptions(
+      argc, argv,
+      "Combines the -ftime-trace files of a build into reports of the "
+      "headers,\ntemplates and functions that take the most time.\n");
+
+  auto reportError = [argv](Error E) {
+    logAllUnhandledErrors(std::move(E), WithColor::error(errs(), argv[0]));
+    return 1;
+  };
+
+  ReportBuilder Builder;
+  for (const std::string &Input : Inputs)
+    if (Error E = Builder.addTrace(Input))
+      return reportError(std::move(E));
+
+  std::error_code EC;
+  ToolOutputFile Out(Output, EC, sys::fs::OF_Text);
+  if (EC)
+    return reportError(createFileError(Output, EC));
+  Builder.print(Out.os());
+  Out.keep();
+  return 0;
+}
@@ -0,0 +1,97 @@
+//===-- cc1serve_main.cpp - Clang compile server --------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This is the entry point to the clang -cc1serve functionality, which runs
+// one -cc1 job after another in the same process, so that a build system can
+// keep a compiler process around and not pay the startup of a new process and
+// of the target registry for every translation unit.
+//
+// The server reads one -cc1 command line per line from standard input, quoted
+// like a response file, runs it, and then writes "exit <status>" and a newline
+// to standard output. Diagnostics go to standard error as usual. Jobs must not
+// write their output to standard output, and should use -working-directory
+// instead of relying on the working directory of the server.
+//
+// Each job gets a new CompilerInstance, so no AST or preprocessor state is
+// carried from one job to the next. Jobs with -mllvm options are rejected,
+// because those options are global to the process and would apply to every
+// later job too.
+//
+//===----------------------------------------------------------------------===//
+
+#include "clang/Basic/LLVM.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/StringSaver.h"
+#include "llvm/Support/raw_ostream.h"
+#include <cstdio>
+
+using namespace clang;
+
+extern int cc1_main(ArrayRef<const char *> Argv, const char *Argv0,
+                    void *MainAddr);
+
+/// Reads a line from standard input into \p Line, without the newline.
+/// Returns false at the end of the input.
+static bool readLine(SmallVectorImpl<char> &Line) {
+  Line.clear();
+  int C;
+  while ((C = std::getchar()) != EOF && C != '\n')
+    Line.push_back(C);
+  return C != EOF || !Line.empty();
+}
+
+static int runJob(StringRef CommandLine, const char *Argv0, void *MainAddr) {
+  llvm::BumpPtrAllocator A;
+  llvm::StringSaver Saver(A);
+  SmallVector<const char *, 256> Args;
+  llvm::cl::TokenizeGNUCommandLine(CommandLine, Saver, Args);
+  llvm::cl::ExpandResponseFiles(Saver, &llvm::cl::TokenizeGNUCommandLine, Args,
+                                /*MarkEOLs=*/false);
+  if (Args.empty() || StringRef(Args[0]) != "-cc1") {
+    llvm::errs() << "error: -cc1serve only runs -cc1 jobs\n";
+    return 1;
+  }
+  if (llvm::any_of(Args, [](const char *A) {
+        return StringRef(A) == "-mllvm";
+      })) {
+    llvm::errs() << "error: -cc1serve cannot run jobs with -mllvm options\n";
+    return 1;
+  }
+
+  // The process outlives the job, so the job has to free what it allocates.
+  llvm::erase_if(Args,
+                 [](const char *A) { return StringRef(A) == "-disable-free"; });
+
+  // Options that the previous job parsed must not count against this one.
+  llvm::cl::ResetAllOptionOccurrences();
+  return cc1_main(Args, Argv0, MainAddr);
+}
+
+int cc1serve_main(ArrayRef<const char *> Argv, const char *Argv0,
+                  void *MainAddr) {
+  if (!Argv.empty()) {
+    llvm::errs() << "error: -cc1serve takes no arguments\n";
+    return 1;
+  }
+
+  SmallString<4096> Line;
+  while (readLine(Line)) {
+    if (StringRef(Line).trim().empty())
+      continue;
+    int Status = runJob(Line, Argv0, MainAddr);
+    llvm::outs() << "exit " << Status << '\n';
+    llvm::outs().flush();
+    llvm::errs().flush();
+  }
+  return 0;
+}
@@ -514,6 +514,29 @@ TEST_F(SourceManagerTest, isMainFile) {
   EXPECT_FALSE(SourceMgr.isMainFile(*SecondFile));
 }
 
+TEST_F(SourceManagerTest, getFileIDOfManyExpansions) {
+  std::unique_ptr<llvm::MemoryBuffer> Buf =
+      llvm::MemoryBuffer::getMemBuffer("int x;");
+  FileID MainFileID = SourceMgr.createFileID(std::move(Buf));
+  SourceMgr.setMainFileID(MainFileID);
+  SourceLocation Start = SourceMgr.getLocForStartOfFile(MainFileID);
+
+  // Create enough entries that looking one up far from the last lookup takes
+  // the binary search rather than the linear scan.
+  std::vector<SourceLocation> Expansions;
+  for (unsigned I = 0; I != 1000; ++I)
+    Expansions.push_back(SourceMgr.createExpansionLoc(
+        Start, Start, Start.getLocWithOffset(1), /*TokLength=*/I % 7 + 1));
+
+  for (unsigned I = 0; I != Expansions.size(); I += 37) {
+    FileID FID = SourceMgr.getFileID(Expansions[I]);
+    EXPECT_EQ(Expansions[I].getOffset(),
+              SourceMgr.getSLocEntry(FID).getOffset());
+    EXPECT_EQ(FID, SourceMgr.getFileID(Expansions[I].getLocWithOffset(I % 7)));
+  }
+  EXPECT_EQ(MainFileID, SourceMgr.getFileID(Start.getLocWithOffset(3)));
+}
+
 #endif
 
 } // anonymous namespace
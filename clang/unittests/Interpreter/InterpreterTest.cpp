@@ -20,6 +20,8 @@
 #include "clang/Sema/Lookup.h"
 #include "clang/Sema/Sema.h"
 
+#include "llvm/ADT/ScopeExit.h"
+#include "llvm/Support/FileSystem.h"
 #include "llvm/Support/TargetSelect.h"
 
 #include "gmock/gmock.h"
@@ -248,4 +250,42 @@ TEST(IncrementalProcessing, InstantiateTemplate) {
   EXPECT_EQ(42, fn(NewA));
 }
 
+static unsigned countFiles(llvm::StringRef Dir) {
+  unsigned Count = 0;
+  std::error_code EC;
+  for (llvm::sys::fs::directory_iterator I(Dir, EC), E; I != E && !EC;
+       I.increment(EC))
+    ++Count;
+  return Count;
+}
+
+#ifdef _AIX
+TEST(IncrementalProcessing, DISABLED_JITObjectCache) {
+#else
+TEST(IncrementalProcessing, JITObjectCache) {
+#endif
+  llvm::SmallString<128> CacheDir;
+  ASSERT_FALSE(llvm::sys::fs::createUniqueDirectory("jit-cache", CacheDir));
+  auto Cleanup = llvm::make_scope_exit(
+      [&] { llvm::sys::fs::remove_directories(CacheDir); });
+
+  const char *Code = "extern \"C\" int cached() { return 42; }";
+  for (unsigned Session = 0; Session != 2; ++Session) {
+    std::unique_ptr<Interpreter> Interp = createInterpreter();
+    Interp->setJITObjectCacheDirectory(CacheDir);
+    auto &PTU(cantFail(Interp->Parse(Code)));
+    if (llvm::Error Err = Interp->Execute(PTU)) {
+      // We cannot execute on the platform.
+      consumeError(std::move(Err));
+      return;
+    }
+    // The second session reads the object the first one stored.
+    EXPECT_EQ(1U, countFiles(CacheDir));
+
+    typedef int (*CachedFn)();
+    auto Fn = (CachedFn)cantFail(Interp->getSymbolAddress("cached"));
+    EXPECT_EQ(42, Fn());
+  }
+}
+
 } // end anonymous namespace
@@ -186,6 +186,59 @@ TEST_F(HeaderSearchTest, NestedFramework) {
             "Sub/Sub.h");
 }
 
+TEST_F(HeaderSearchTest, SharedLookupCache) {
+  auto addFile = [&](StringRef Name) {
+    VFS->addFile(Name, 0, llvm::MemoryBuffer::getMemBuffer(""), /*User=*/None,
+                 /*Group=*/None, llvm::sys::fs::file_type::regular_file);
+  };
+  auto lookup = [](HeaderSearch &HS, StringRef Name) -> std::string {
+    Optional<FileEntryRef> File = HS.LookupFile(
+        Name, SourceLocation(), /*isAngled=*/false, /*FromDir=*/nullptr,
+        /*CurDir=*/nullptr, /*Includers=*/{}, /*SearchPath=*/nullptr,
+        /*RelativePath=*/nullptr, /*RequestingModule=*/nullptr,
+        /*SuggestedModule=*/nullptr, /*IsMapped=*/nullptr,
+        /*IsFrameworkFound=*/nullptr);
+    return File ? File->getName().str() : "";
+  };
+
+  auto Cache = std::make_shared<SharedHeaderLookupCache>();
+  addSearchDir("/a");
+  addSearchDir("/b");
+  addFile("/b/t.h");
+  Search.setSharedLookupCache(Cache);
+  EXPECT_EQ("/b/t.h", lookup(Search, "t.h"));
+  EXPECT_EQ("", lookup(Search, "missing.h"));
+
+  // A header search with the same directories in another file manager, as
+  // in the next translation unit of a compile server. It goes straight to
+  // /b, so it does not see the header added to /a.
+  addFile("/a/t.h");
+  addFile("/a/missing.h");
+  auto search = [&](FileManager &FM, SourceManager &SM,
+                    std::shared_ptr<SharedHeaderLookupCache> Shared) {
+    auto HS = std::make_unique<HeaderSearch>(
+        std::make_shared<HeaderSearchOptions>(), SM, Diags, LangOpts,
+        Target.get());
+    for (StringRef Dir : {"/a", "/b"})
+      HS->AddSearchPath(DirectoryLookup(*FM.getOptionalDirectoryRef(Dir),
+                                        SrcMgr::C_User, /*isFramework=*/false),
+                        /*isAngled=*/false);
+    HS->setSharedLookupCache(std::move(Shared));
+    return HS;
+  };
+  FileManager OtherFileMgr(FileMgrOpts, VFS);
+  SourceManager OtherSourceMgr(Diags, OtherFileMgr);
+  auto Other = search(OtherFileMgr, OtherSourceMgr, Cache);
+  EXPECT_EQ("/b/t.h", lookup(*Other, "t.h"));
+  EXPECT_EQ("", lookup(*Other, "missing.h"));
+
+  FileManager UncachedFileMgr(FileMgrOpts, VFS);
+  SourceManager UncachedSourceMgr(Diags, UncachedFileMgr);
+  auto Uncached = search(UncachedFileMgr, UncachedSourceMgr, nullptr);
+  EXPECT_EQ("/a/t.h", lookup(*Uncached, "t.h"));
+  EXPECT_EQ("/a/missing.h", lookup(*Uncached, "missing.h"));
+}
+
 // Helper struct with null terminator character to make MemoryBuffer happy.
 template <class FileTy, class PaddingTy>
 struct NullTerminatedFile : public FileTy {
@@ -620,6 +620,22 @@ TEST_F(LexerTest, FindNextToken) {
                                                 "xyz", "=", "abcd", ";"));
 }
 
+TEST_F(LexerTest, LongLineComments) {
+  // Comments that end before, at and after a 16 byte boundary, with DOS
+  // newlines and escaped newlines, and one that runs to the end of the file.
+  CheckLex("// a comment that is longer than sixteen characters\n"
+           "a\n"
+           "// 0123456789abcd\n"
+           "b\n"
+           "// a comment with a DOS-style newline at the end\r\n"
+           "c\n"
+           "// a comment continued on the next line \\\n"
+           "d\n"
+           "e // and a comment at the end of the file, without a newline",
+           {tok::identifier, tok::identifier, tok::identifier,
+            tok::identifier});
+}
+
 TEST_F(LexerTest, CreatedFIDCountForPredefinedBuffer) {
   TrivialModuleLoader ModLoader;
   auto PP = CreatePP("", ModLoader);
@@ -106,6 +106,23 @@ TEST(JSONCompilationDatabase, GetAllFiles) {
       << ErrorMessage;
 }
 
+TEST(JSONCompilationDatabase, LoadFromOwnedBuffer) {
+  std::string ErrorMessage;
+  std::unique_ptr<CompilationDatabase> Database =
+      JSONCompilationDatabase::loadFromBuffer(
+          llvm::MemoryBuffer::getMemBufferCopy(
+              "[{\"directory\":\"//net/dir\","
+              "\"command\":\"command\","
+              "\"file\":\"file1\"}]"),
+          ErrorMessage, JSONCommandLineSyntax::Gnu);
+  ASSERT_TRUE(Database) << ErrorMessage;
+  std::vector<CompileCommand> Commands = Database->getAllCompileCommands();
+  ASSERT_EQ(1u, Commands.size());
+  EXPECT_EQ("//net/dir", Commands[0].Directory);
+  EXPECT_EQ("file1", Commands[0].Filename);
+  EXPECT_THAT(Commands[0].CommandLine, ElementsAre("command"));
+}
+
 TEST(JSONCompilationDatabase, GetAllCompileCommands) {
   std::string ErrorMessage;
   EXPECT_EQ(
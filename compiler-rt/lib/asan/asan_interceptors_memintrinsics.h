@@ -23,20 +23,13 @@ DECLARE_REAL(void*, memset, void *block, int c, uptr size)
 
 namespace __asan {
 
-// Return true if we can quickly decide that the region is unpoisoned.
-// We assume that a redzone is at least 16 bytes.
+// Return true if we can quickly decide that the region is unpoisoned. Small
+// regions, which are the common case for interceptors like memcpy, are checked
+// exactly without calling __asan_region_is_poisoned().
 static inline bool QuickCheckForUnpoisonedRegion(uptr beg, uptr size) {
   if (size == 0) return true;
-  if (size <= 32)
-    return !AddressIsPoisoned(beg) &&
-           !AddressIsPoisoned(beg + size - 1) &&
-           !AddressIsPoisoned(beg + size / 2);
-  if (size <= 64)
-    return !AddressIsPoisoned(beg) &&
-           !AddressIsPoisoned(beg + size / 4) &&
-           !AddressIsPoisoned(beg + size - 1) &&
-           !AddressIsPoisoned(beg + 3 * size / 4) &&
-           !AddressIsPoisoned(beg + size / 2);
+  if (size <= kSmallRegionMaxSize)
+    return !SmallRegionIsPoisoned(beg, size);
   return false;
 }
 
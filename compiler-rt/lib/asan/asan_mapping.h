@@ -381,6 +381,23 @@ static inline bool AddressIsPoisoned(uptr a) {
   return false;
 }
 
+// The largest region that QuickCheckForUnpoisonedRegion() checks exactly.
+static const uptr kSmallRegionMaxSize = 64;
+
+// Exact check of a region of at most kSmallRegionMaxSize bytes. Only the last
+// byte and the shadow of the granules before it need to be looked at, since a
+// partially addressable granule is addressable from its start.
+static inline bool SmallRegionIsPoisoned(uptr beg, uptr size) {
+  uptr last = beg + size - 1;
+  if (AddressIsPoisoned(last))
+    return true;
+  const u8 *shadow = (const u8 *)MEM_TO_SHADOW(beg);
+  const u8 *shadow_last = (const u8 *)MEM_TO_SHADOW(last);
+  u8 all = 0;
+  for (; shadow < shadow_last; shadow++) all |= *shadow;
+  return all != 0;
+}
+
 // Must be after all calls to PROFILE_ASAN_MAPPING().
 static const uptr kAsanMappingProfileSize = __LINE__;
 
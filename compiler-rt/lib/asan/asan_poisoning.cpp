@@ -181,6 +181,8 @@ uptr __asan_region_is_poisoned(uptr beg, uptr size) {
   if (!AddrIsInMem(end))
     return end;
   CHECK_LT(beg, end);
+  if (size <= kSmallRegionMaxSize && !SmallRegionIsPoisoned(beg, size))
+    return 0;
   uptr aligned_b = RoundUpTo(beg, ASAN_SHADOW_GRANULARITY);
   uptr aligned_e = RoundDownTo(end, ASAN_SHADOW_GRANULARITY);
   uptr shadow_beg = MemToShadow(aligned_b);
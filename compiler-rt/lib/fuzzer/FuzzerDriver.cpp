@@ -523,7 +523,8 @@ void Merge(Fuzzer *F, FuzzingOptions &Options,
   std::vector<std::string> NewFiles;
   std::set<uint32_t> NewFeatures, NewCov;
   CrashResistantMerge(Args, OldCorpus, NewCorpus, &NewFiles, {}, &NewFeatures,
-                      {}, &NewCov, CFPath, true, Flags.set_cover_merge);
+                      {}, &NewCov, CFPath, true, Flags.set_cover_merge,
+                      std::max(Flags.jobs, 1U));
   for (auto &Path : NewFiles)
     F->WriteToOutputCorpus(FileToVector(Path, Options.MaxLen));
   // We are done, delete the control file if it was a temporary one.
@@ -648,7 +649,7 @@ int FuzzerDriver(int *argc, char ***argv, UserCallback Callback) {
     EF->LLVMFuzzerInitialize(argc, argv);
   if (EF->__msan_scoped_disable_interceptor_checks)
     EF->__msan_scoped_disable_interceptor_checks();
-  const std::vector<std::string> Args(*argv, *argv + *argc);
+  std::vector<std::string> Args(*argv, *argv + *argc);
   assert(!Args.empty());
   ProgName = new std::string(Args[0]);
   if (Argv0 != *ProgName) {
@@ -661,18 +662,31 @@ int FuzzerDriver(int *argc, char ***argv, UserCallback Callback) {
     return 0;
   }
 
+  // Start the fork servers while the process has a single thread. The jobs
+  // forked from them continue from here with their own arguments.
+  if (Flags.fork > 0 && Flags.fork_server) {
+    std::vector<std::string> JobArgs;
+    if (StartForkServers(Flags.fork + 1, &JobArgs)) {
+      Args = JobArgs;
+      ParseFlags(Args, EF);
+    }
+  }
+
   if (Flags.close_fd_mask & 2)
     DupAndCloseStderr();
   if (Flags.close_fd_mask & 1)
     CloseStdout();
 
-  if (Flags.jobs > 0 && Flags.workers == 0) {
+  // When merging, the jobs are the inner processes the inputs are split
+  // between. See Merge().
+  bool IsMerge = Flags.merge || Flags.set_cover_merge;
+  if (Flags.jobs > 0 && Flags.workers == 0 && !IsMerge) {
     Flags.workers = std::min(NumberOfCpuCores() / 2, Flags.jobs);
     if (Flags.workers > 1)
       Printf("Running %u workers\n", Flags.workers);
   }
 
-  if (Flags.workers > 0 && Flags.jobs > 0)
+  if (Flags.workers > 0 && Flags.jobs > 0 && !IsMerge)
     return RunInMultipleProcesses(Args, Flags.workers, Flags.jobs);
 
   FuzzingOptions Options;
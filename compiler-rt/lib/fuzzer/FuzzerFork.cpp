@@ -234,7 +234,7 @@ struct GlobalEnv {
         !Job->Cmd.getFlagValue("set_cover_merge").compare("1");
     CrashResistantMerge(Args, {}, MergeCandidates, &FilesToAdd, Features,
                         &NewFeatures, Cov, &NewCov, Job->CFPath, false,
-                        IsSetCoverMerge);
+                        IsSetCoverMerge, /*NumJobs=*/1);
     for (auto &Path : FilesToAdd) {
       auto U = FileToVector(Path);
       auto NewPath = DirPlusFile(MainCorpusDir, Hash(U));
@@ -303,7 +303,7 @@ struct JobQueue {
 void WorkerThread(JobQueue *FuzzQ, JobQueue *MergeQ) {
   while (auto Job = FuzzQ->Pop()) {
     // Printf("WorkerThread: job %p\n", Job);
-    Job->ExitCode = ExecuteCommand(Job->Cmd);
+    Job->ExitCode = ExecuteCommandWithForkServer(Job->Cmd);
     MergeQ->Push(Job);
   }
 }
@@ -347,7 +347,7 @@ void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
     std::set<uint32_t> NewFeatures, NewCov;
     CrashResistantMerge(Env.Args, {}, SeedFiles, &Env.Files, Env.Features,
                         &NewFeatures, Env.Cov, &NewCov, CFPath,
-                        /*Verbose=*/false, /*IsSetCoverMerge=*/false);
+                        /*Verbose=*/false, /*IsSetCoverMerge=*/false, NumJobs);
     Env.Features.insert(NewFeatures.begin(), NewFeatures.end());
     Env.Cov.insert(NewFeatures.begin(), NewFeatures.end());
     RemoveFile(CFPath);
@@ -410,7 +410,8 @@ void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
       Env.FilesSizes.clear();
       CrashResistantMerge(Env.Args, {}, CurrentSeedFiles, &Env.Files,
                           TmpFeatures, &TmpNewFeatures, TmpCov, &TmpNewCov,
-                          CFPath, /*Verbose=*/false, /*IsSetCoverMerge=*/false);
+                          CFPath, /*Verbose=*/false, /*IsSetCoverMerge=*/false,
+                          NumJobs);
       for (auto &path : Env.Files)
         Env.FilesSizes.push_back(FileSize(path));
       RemoveFile(CFPath);
@@ -16,9 +16,21 @@
 #include <string>
 
 namespace fuzzer {
+class Command;
+
 void FuzzWithFork(Random &Rand, const FuzzingOptions &Options,
                   const std::vector<std::string> &Args,
                   const std::vector<std::string> &CorpusDirs, int NumJobs);
+
+// Fork NumServers fork servers from the current process, which must not have
+// started threads. Returns true in the processes forked by the servers to run
+// a command, with the arguments of the command in JobArgs, and false in the
+// current process.
+bool StartForkServers(size_t NumServers, std::vector<std::string> *JobArgs);
+
+// Run Cmd in a process forked by an idle fork server, waiting for one if they
+// are all busy. Runs Cmd with ExecuteCommand() if there are no fork servers.
+int ExecuteCommandWithForkServer(const Command &Cmd);
 } // namespace fuzzer
 
 #endif // LLVM_FUZZER_FORK_H
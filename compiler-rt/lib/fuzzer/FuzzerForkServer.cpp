@@ -0,0 +1,276 @@
+//===- FuzzerForkServer.cpp - fork jobs from an initialized process -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+// Fork servers for -fork=N -fork_server=1.
+//
+// A fork server is a process forked from the fuzzer once the target has been
+// initialized (global constructors and LLVMFuzzerInitialize), but before the
+// fuzzer itself is set up. It receives commands of the same binary from the
+// fork mode process, and runs each of them by forking itself: the forked
+// process returns from StartForkServers() with the arguments of the command,
+// and FuzzerDriver() continues with them. The target is thus initialized once
+// instead of once per job, which is most of the cost of short jobs for
+// targets with an expensive setup.
+//
+// Every server runs one command at a time and reports its exit code, so the
+// fork mode process has a pool of servers, one per worker thread plus one for
+// the merges it runs itself.
+//===----------------------------------------------------------------------===//
+
+#include "FuzzerCommand.h"
+#include "FuzzerFork.h"
+#include "FuzzerIO.h"
+#include "FuzzerPlatform.h"
+#include "FuzzerUtil.h"
+
+#include <condition_variable>
+#include <mutex>
+
+#if LIBFUZZER_POSIX
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace fuzzer {
+
+#if LIBFUZZER_POSIX
+
+namespace {
+
+// Sent back by a server that failed to fork, in place of an exit code.
+const int kForkServerError = -1;
+
+#ifdef MSG_NOSIGNAL
+const int kSendFlags = MSG_NOSIGNAL;
+#else
+const int kSendFlags = 0;
+#endif
+
+bool SendAll(int Fd, const void *Data, size_t Size) {
+  const char *P = static_cast<const char *>(Data);
+  while (Size) {
+    ssize_t N = send(Fd, P, Size, kSendFlags);
+    if (N < 0 && errno == EINTR)
+      continue;
+    if (N <= 0)
+      return false;
+    P += N;
+    Size -= N;
+  }
+  return true;
+}
+
+bool RecvAll(int Fd, void *Data, size_t Size) {
+  char *P = static_cast<char *>(Data);
+  while (Size) {
+    ssize_t N = recv(Fd, P, Size, 0);
+    if (N < 0 && errno == EINTR)
+      continue;
+    if (N <= 0)
+      return false;
+    P += N;
+    Size -= N;
+  }
+  return true;
+}
+
+bool SendString(int Fd, const std::string &S) {
+  uint32_t Size = S.size();
+  return SendAll(Fd, &Size, sizeof(Size)) && SendAll(Fd, S.data(), Size);
+}
+
+bool RecvString(int Fd, std::string *S) {
+  uint32_t Size;
+  if (!RecvAll(Fd, &Size, sizeof(Size)))
+    return false;
+  S->resize(Size);
+  return RecvAll(Fd, &(*S)[0], Size);
+}
+
+// A request is the arguments of the command followed by its output file and
+// whether stderr is redirected to it.
+bool SendRequest(int Fd, const Command &Cmd) {
+  auto &Args = Cmd.getArguments();
+  uint32_t NumArgs = Args.size();
+  if (!SendAll(Fd, &NumArgs, sizeof(NumArgs)))
+    return false;
+  for (auto &Arg : Args)
+    if (!SendString(Fd, Arg))
+      return false;
+  uint8_t Combined = Cmd.isOutAndErrCombined();
+  return SendString(Fd, Cmd.getOutputFile()) &&
+         SendAll(Fd, &Combined, sizeof(Combined));
+}
+
+bool RecvRequest(int Fd, std::vector<std::string> *Args,
+                 std::string *OutputFile, bool *Combined) {
+  uint32_t NumArgs;
+  if (!RecvAll(Fd, &NumArgs, sizeof(NumArgs)))
+    return false;
+  Args->resize(NumArgs);
+  for (auto &Arg : *Args)
+    if (!RecvString(Fd, &Arg))
+      return false;
+  uint8_t C;
+  if (!RecvString(Fd, OutputFile) || !RecvAll(Fd, &C, sizeof(C)))
+    return false;
+  *Combined = C;
+  return true;
+}
+
+// Redirect the output of a forked command like the shell would.
+void RedirectOutput(const std::string &OutputFile, bool Combined) {
+  if (!OutputFile.empty()) {
+    int Fd = open(OutputFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (Fd >= 0) {
+      dup2(Fd, STDOUT_FILENO);
+      close(Fd);
+    }
+  }
+  if (Combined)
+    dup2(STDOUT_FILENO, STDERR_FILENO);
+}
+
+// The main loop of a server. Returns true in the forked processes, with the
+// arguments of the command they run, and false once the fork mode process is
+// gone.
+bool RunForkServer(int Fd, std::vector<std::string> *JobArgs) {
+  // Interrupts are handled by the commands, which report them in their exit
+  // code.
+  signal(SIGINT, SIG_IGN);
+  std::vector<std::string> Args;
+  std::string OutputFile;
+  bool Combined;
+  while (RecvRequest(Fd, &Args, &OutputFile, &Combined)) {
+    pid_t Pid = fork();
+    if (Pid == 0) {
+      close(Fd);
+      signal(SIGINT, SIG_DFL);
+      RedirectOutput(OutputFile, Combined);
+      *JobArgs = Args;
+      return true;
+    }
+    int ExitCode = kForkServerError;
+    int Status;
+    if (Pid > 0) {
+      while (waitpid(Pid, &Status, 0) < 0 && errno == EINTR) {
+      }
+      // Report a command killed by a signal like the shell does.
+      ExitCode = WIFEXITED(Status) ? WEXITSTATUS(Status)
+                                   : 128 + WTERMSIG(Status);
+    }
+    if (!SendAll(Fd, &ExitCode, sizeof(ExitCode)))
+      break;
+  }
+  return false;
+}
+
+// The idle servers, and the number of servers that are still alive.
+std::mutex ForkServersMu;
+std::condition_variable ForkServersCv;
+std::vector<int> *IdleForkServers;
+size_t NumForkServers = 0;
+
+bool AcquireForkServer(int *Fd) {
+  std::unique_lock<std::mutex> Lock(ForkServersMu);
+  ForkServersCv.wait(Lock, [] {
+    return !NumForkServers || !IdleForkServers->empty();
+  });
+  if (!NumForkServers)
+    return false;
+  *Fd = IdleForkServers->back();
+  IdleForkServers->pop_back();
+  return true;
+}
+
+void ReleaseForkServer(int Fd, bool IsAlive) {
+  {
+    std::lock_guard<std::mutex> Lock(ForkServersMu);
+    if (IsAlive) {
+      IdleForkServers->push_back(Fd);
+    } else {
+      close(Fd);
+      NumForkServers--;
+    }
+  }
+  // Wake up all of the waiters if the last server is gone.
+  ForkServersCv.notify_all();
+}
+
+} // namespace
+
+bool StartForkServers(size_t NumServers, std::vector<std::string> *JobArgs) {
+  // Output buffered so far must not be written again by the forked processes.
+  fflush(nullptr);
+  IdleForkServers = new std::vector<int>;
+  for (size_t i = 0; i < NumServers; i++) {
+    int Fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, Fds)) {
+      Printf("WARNING: -fork_server: socketpair failed: %s\n",
+             strerror(errno));
+      break;
+    }
+    pid_t Pid = fork();
+    if (Pid < 0) {
+      Printf("WARNING: -fork_server: fork failed: %s\n", strerror(errno));
+      close(Fds[0]);
+      close(Fds[1]);
+      break;
+    }
+    if (Pid == 0) {
+      // Close the ends of the other servers, so that they see the fork mode
+      // process exit.
+      for (int Fd : *IdleForkServers)
+        close(Fd);
+      IdleForkServers->clear();
+      close(Fds[0]);
+      if (RunForkServer(Fds[1], JobArgs))
+        return true;
+      _Exit(0);
+    }
+    close(Fds[1]);
+    // Don't leak the server to the processes started with ExecuteCommand().
+    fcntl(Fds[0], F_SETFD, FD_CLOEXEC);
+    IdleForkServers->push_back(Fds[0]);
+  }
+  NumForkServers = IdleForkServers->size();
+  return false;
+}
+
+int ExecuteCommandWithForkServer(const Command &Cmd) {
+  int Fd;
+  if (!IdleForkServers || !AcquireForkServer(&Fd))
+    return ExecuteCommand(Cmd);
+  int ExitCode;
+  bool IsAlive =
+      SendRequest(Fd, Cmd) && RecvAll(Fd, &ExitCode, sizeof(ExitCode));
+  ReleaseForkServer(Fd, IsAlive);
+  if (!IsAlive || ExitCode == kForkServerError)
+    return ExecuteCommand(Cmd);
+  return ExitCode;
+}
+
+#else
+
+bool StartForkServers(size_t NumServers, std::vector<std::string> *JobArgs) {
+  Printf("WARNING: -fork_server is not supported on this platform\n");
+  return false;
+}
+
+int ExecuteCommandWithForkServer(const Command &Cmd) {
+  return ExecuteCommand(Cmd);
+}
+
+#endif // LIBFUZZER_POSIX
+
+} // namespace fuzzer
@@ -9,16 +9,20 @@
 //===----------------------------------------------------------------------===//
 
 #include "FuzzerCommand.h"
+#include "FuzzerFork.h"
 #include "FuzzerMerge.h"
 #include "FuzzerIO.h"
 #include "FuzzerInternal.h"
 #include "FuzzerTracePC.h"
 #include "FuzzerUtil.h"
 
+#include <atomic>
 #include <fstream>
 #include <iterator>
+#include <queue>
 #include <set>
 #include <sstream>
+#include <thread>
 #include <unordered_set>
 
 namespace fuzzer {
@@ -304,69 +308,59 @@ size_t Merger::SetCoverMerge(const std::set<uint32_t> &InitialFeatures,
     AllFeatures.insert(F % kFeatureSetSize);
   }
 
-  std::set<size_t> RemainingFiles;
   for (size_t i = NumFilesInFirstCorpus; i < Files.size(); ++i) {
-    // Construct an incremental sequence which represent the
-    // indices to all files (excluding those in the initial corpus).
-    // RemainingFiles = range(NumFilesInFirstCorpus..Files.size()).
-    RemainingFiles.insert(i);
     // Insert this file's unique features to all features.
     for (const auto &F : Files[i].Features)
       AllFeatures.insert(F % kFeatureSetSize);
   }
 
-  // Integrate files into Covered until set is complete.
-  while (NumCovered != AllFeatures.size()) {
-    // Index to file with largest number of unique features.
-    size_t MaxFeaturesIndex = NumFilesInFirstCorpus;
-    // Indices to remove from RemainingFiles.
-    std::set<size_t> RemoveIndices;
-    // Running max unique feature count.
-    // Updated upon finding a file with more features.
-    size_t MaxNumFeatures = 0;
-
-    // Iterate over all files not yet integrated into Covered,
-    // to find the file which has the largest number of
-    // features that are not already in Covered.
-    for (const auto &i : RemainingFiles) {
-      const auto &File = Files[i];
-      size_t CurrentUnique = 0;
-      // Count number of features in this file
-      // which are not yet in Covered.
-      for (const auto &F : File.Features)
-        if (!Covered[F % kFeatureSetSize])
-          ++CurrentUnique;
-
-      if (CurrentUnique == 0) {
-        // All features in this file are already in Covered: skip next time.
-        RemoveIndices.insert(i);
-      } else if (CurrentUnique > MaxNumFeatures ||
-                 (CurrentUnique == MaxNumFeatures &&
-                  File.Size < Files[MaxFeaturesIndex].Size)) {
-        // Update the max features file based on unique features
-        // Break ties by selecting smaller files.
-        MaxNumFeatures = CurrentUnique;
-        MaxFeaturesIndex = i;
-      }
-    }
-    // Must be a valid index/
-    assert(MaxFeaturesIndex < Files.size());
-    // Remove any feature-less files found.
-    for (const auto &i : RemoveIndices)
-      RemainingFiles.erase(i);
-    if (MaxNumFeatures == 0) {
-      // Did not find a file that adds unique features.
-      // This means that we should have no remaining files.
-      assert(RemainingFiles.size() == 0);
-      assert(NumCovered == AllFeatures.size());
-      break;
+  // Count the features of a file which are not yet in Covered.
+  auto CountUncovered = [&](const MergeFileInfo &File) {
+    size_t NumUncovered = 0;
+    for (const auto &F : File.Features)
+      if (!Covered[F % kFeatureSetSize])
+        ++NumUncovered;
+    return NumUncovered;
+  };
+
+  // Candidates are ordered by their number of uncovered features, then
+  // smaller files first, then by index.
+  struct Candidate {
+    size_t NumUncovered;
+    size_t Idx;
+  };
+  auto IsWorse = [&](const Candidate &A, const Candidate &B) {
+    if (A.NumUncovered != B.NumUncovered)
+      return A.NumUncovered < B.NumUncovered;
+    if (Files[A.Idx].Size != Files[B.Idx].Size)
+      return Files[A.Idx].Size > Files[B.Idx].Size;
+    return A.Idx > B.Idx;
+  };
+  std::priority_queue<Candidate, std::vector<Candidate>, decltype(IsWorse)>
+      Candidates(IsWorse);
+  for (size_t i = NumFilesInFirstCorpus; i < Files.size(); ++i)
+    if (size_t NumUncovered = CountUncovered(Files[i]))
+      Candidates.push({NumUncovered, i});
+
+  // Integrate files into Covered until set is complete, choosing the file
+  // with the largest number of features that are not already in Covered.
+  // The number of uncovered features of a file can only decrease as files
+  // are integrated, so the count computed when a candidate was queued is an
+  // upper bound. A candidate whose count is still exact when it reaches the
+  // top of the queue is thus the best file, and only the files that reach
+  // the top need to be recounted (lazy greedy evaluation).
+  while (NumCovered != AllFeatures.size() && !Candidates.empty()) {
+    Candidate Top = Candidates.top();
+    Candidates.pop();
+    size_t NumUncovered = CountUncovered(Files[Top.Idx]);
+    if (NumUncovered == 0)
+      continue;
+    if (NumUncovered < Top.NumUncovered) {
+      Candidates.push({NumUncovered, Top.Idx});
+      continue;
     }
 
-    // MaxFeaturesIndex must be an element of Remaining.
-    assert(RemainingFiles.find(MaxFeaturesIndex) != RemainingFiles.end());
-    // Remove the file with the most features from Remaining.
-    RemainingFiles.erase(MaxFeaturesIndex);
-    const auto &MaxFeatureFile = Files[MaxFeaturesIndex];
+    const auto &MaxFeatureFile = Files[Top.Idx];
     // Add the features of the max feature file to Covered.
     for (const auto &F : MaxFeatureFile.Features) {
       if (!Covered[F % kFeatureSetSize]) {
@@ -423,6 +417,122 @@ WriteNewControlFile(const std::string &CFPath,
   return FilesToUse.size();
 }
 
+// Execute the inner process until it passes.
+// Every inner process should execute at least one input.
+static void RunMergeInnerSteps(const Command &BaseCmd,
+                               const std::string &CFPath, size_t NumAttempts,
+                               bool V, bool IsSetCoverMerge) {
+  for (size_t Attempt = 1; Attempt <= NumAttempts; Attempt++) {
+    Fuzzer::MaybeExitGracefully();
+    VPrintf(V, "MERGE-OUTER: attempt %zd\n", Attempt);
+    Command Cmd(BaseCmd);
+    Cmd.addFlag("merge_control_file", CFPath);
+    // If we are going to use the set cover implementation for
+    // minimization add the merge_inner=2 internal flag.
+    Cmd.addFlag("merge_inner", IsSetCoverMerge ? "2" : "1");
+    if (!V) {
+      Cmd.setOutputFile(getDevNull());
+      Cmd.combineOutAndErr();
+    }
+    auto ExitCode = ExecuteCommandWithForkServer(Cmd);
+    if (!ExitCode) {
+      VPrintf(V, "MERGE-OUTER: successful in %zd attempt(s)\n", Attempt);
+      break;
+    }
+  }
+}
+
+// Process the inputs of the control file that were not processed yet in
+// NumJobs parallel inner processes, and append their results to the control
+// file as if a single inner process had processed them.
+//
+// The inputs are dealt round-robin to the jobs, so that each job processes
+// inputs of all sizes, smallest first. Every job has its own control file,
+// which makes it crash resistant like a single inner process.
+static void ParallelMergeInnerSteps(const Command &BaseCmd,
+                                    const std::string &CFPath, size_t NumJobs,
+                                    bool V, bool IsSetCoverMerge) {
+  Merger M;
+  std::ifstream IF(CFPath);
+  M.ParseOrExit(IF, false);
+  IF.close();
+  size_t First = M.FirstNotProcessedFile;
+  NumJobs = std::min(NumJobs, M.Files.size() - First);
+  if (!NumJobs)
+    return;
+  VPrintf(V, "MERGE-OUTER: processing %zd files in %zd parallel jobs\n",
+          M.Files.size() - First, NumJobs);
+
+  // Write the control file of each job.
+  std::vector<std::string> JobCFPaths(NumJobs);
+  std::vector<size_t> JobNumFiles(NumJobs);
+  for (size_t Job = 0; Job < NumJobs; Job++) {
+    JobCFPaths[Job] = CFPath + ".job" + std::to_string(Job);
+    size_t NumFiles = 0, NumFilesInFirstCorpus = 0;
+    for (size_t i = First + Job; i < M.Files.size(); i += NumJobs) {
+      NumFiles++;
+      if (i < M.NumFilesInFirstCorpus)
+        NumFilesInFirstCorpus++;
+    }
+    JobNumFiles[Job] = NumFiles;
+    RemoveFile(JobCFPaths[Job]);
+    std::ofstream JobCF(JobCFPaths[Job]);
+    JobCF << NumFiles << "\n" << NumFilesInFirstCorpus << "\n";
+    for (size_t i = First + Job; i < M.Files.size(); i += NumJobs)
+      JobCF << M.Files[i].Name << "\n";
+    if (!JobCF) {
+      Printf("MERGE-OUTER: failed to write to the control file: %s\n",
+             JobCFPaths[Job].c_str());
+      exit(1);
+    }
+  }
+
+  std::atomic<size_t> NextJob(0);
+  auto WorkerThread = [&]() {
+    for (size_t Job; (Job = NextJob++) < NumJobs;)
+      RunMergeInnerSteps(BaseCmd, JobCFPaths[Job], JobNumFiles[Job],
+                         /*V=*/false, IsSetCoverMerge);
+  };
+  std::vector<std::thread> Threads;
+  for (size_t i = 0; i < NumJobs; i++)
+    Threads.push_back(std::thread(WorkerThread));
+  for (auto &T : Threads)
+    T.join();
+
+  // Append the results of the jobs to the control file, in the order of the
+  // inputs. Stop at the first input that was not processed, if any, since
+  // the inputs of the control file are processed in order.
+  std::vector<Merger> JobMergers(NumJobs);
+  for (size_t Job = 0; Job < NumJobs; Job++) {
+    std::ifstream JobCF(JobCFPaths[Job]);
+    JobMergers[Job].ParseOrExit(JobCF, true);
+  }
+  std::ofstream OF(CFPath, std::ofstream::out | std::ofstream::app);
+  size_t NumProcessed = 0;
+  for (size_t i = First; i < M.Files.size(); i++, NumProcessed++) {
+    const Merger &JobM = JobMergers[(i - First) % NumJobs];
+    size_t JobIdx = (i - First) / NumJobs;
+    if (JobIdx >= JobM.FirstNotProcessedFile)
+      break;
+    // Inputs that failed are recorded as processed without features.
+    const MergeFileInfo &File = JobM.Files[JobIdx];
+    OF << "STARTED " << i << " " << File.Size << "\n";
+    OF << "FT " << i;
+    for (uint32_t F : File.Features)
+      OF << " " << F;
+    OF << "\n";
+    OF << "COV " << i;
+    for (uint32_t C : File.Cov)
+      OF << " " << C;
+    OF << "\n";
+  }
+  OF.close();
+  for (auto &JobCFPath : JobCFPaths)
+    RemoveFile(JobCFPath);
+  VPrintf(V, "MERGE-OUTER: %zd files processed by the parallel jobs\n",
+          NumProcessed);
+}
+
 // Outer process. Does not call the target code and thus should not fail.
 void CrashResistantMerge(const std::vector<std::string> &Args,
                          const std::vector<SizedFile> &OldCorpus,
@@ -433,7 +543,7 @@ void CrashResistantMerge(const std::vector<std::string> &Args,
                          const std::set<uint32_t> &InitialCov,
                          std::set<uint32_t> *NewCov, const std::string &CFPath,
                          bool V, /*Verbose*/
-                         bool IsSetCoverMerge) {
+                         bool IsSetCoverMerge, size_t NumJobs) {
   if (NewCorpus.empty() && OldCorpus.empty()) return;  // Nothing to merge.
   size_t NumAttempts = 0;
   std::vector<MergeFileInfo> KnownFiles;
@@ -484,31 +594,18 @@ void CrashResistantMerge(const std::vector<std::string> &Args,
     NumAttempts = WriteNewControlFile(CFPath, OldCorpus, NewCorpus, KnownFiles);
   }
 
-  // Execute the inner process until it passes.
-  // Every inner process should execute at least one input.
   Command BaseCmd(Args);
   BaseCmd.removeFlag("merge");
   BaseCmd.removeFlag("set_cover_merge");
   BaseCmd.removeFlag("fork");
   BaseCmd.removeFlag("collect_data_flow");
-  for (size_t Attempt = 1; Attempt <= NumAttempts; Attempt++) {
-    Fuzzer::MaybeExitGracefully();
-    VPrintf(V, "MERGE-OUTER: attempt %zd\n", Attempt);
-    Command Cmd(BaseCmd);
-    Cmd.addFlag("merge_control_file", CFPath);
-    // If we are going to use the set cover implementation for
-    // minimization add the merge_inner=2 internal flag.
-    Cmd.addFlag("merge_inner", IsSetCoverMerge ? "2" : "1");
-    if (!V) {
-      Cmd.setOutputFile(getDevNull());
-      Cmd.combineOutAndErr();
-    }
-    auto ExitCode = ExecuteCommand(Cmd);
-    if (!ExitCode) {
-      VPrintf(V, "MERGE-OUTER: successful in %zd attempt(s)\n", Attempt);
-      break;
-    }
-  }
+  BaseCmd.removeFlag("jobs");
+  BaseCmd.removeFlag("workers");
+  if (NumJobs > 1)
+    ParallelMergeInnerSteps(BaseCmd, CFPath, NumJobs, V, IsSetCoverMerge);
+  else
+    RunMergeInnerSteps(BaseCmd, CFPath, NumAttempts, V, IsSetCoverMerge);
+
   // Read the control file and do the merge.
   Merger M;
   std::ifstream IF(CFPath);
@@ -35,6 +35,10 @@
 //   It uses a single pass greedy algorithm choosing first the smallest inputs
 //   within the same size the inputs that have more new features.
 //
+//   With NumJobs > 1, the inputs are split between several inner processes
+//   running in parallel, each with its own control file. Once they are done
+//   the outer process appends their results to the main control file.
+//
 //===----------------------------------------------------------------------===//
 
 #ifndef LLVM_FUZZER_MERGE_H
@@ -86,7 +90,7 @@ void CrashResistantMerge(const std::vector<std::string> &Args,
                          std::set<uint32_t> *NewFeatures,
                          const std::set<uint32_t> &InitialCov,
                          std::set<uint32_t> *NewCov, const std::string &CFPath,
-                         bool Verbose, bool IsSetCoverMerge);
+                         bool Verbose, bool IsSetCoverMerge, size_t NumJobs);
 
 }  // namespace fuzzer
 
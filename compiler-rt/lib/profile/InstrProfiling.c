@@ -20,6 +20,8 @@
 #define INSTR_PROF_VALUE_PROF_DATA
 #include "profile/InstrProfData.inc"
 
+COMPILER_RT_VISIBILITY void (*lprofResetCounterShardsHook)(void) = NULL;
+
 COMPILER_RT_VISIBILITY uint64_t __llvm_profile_get_magic(void) {
   return sizeof(void *) == sizeof(uint64_t) ? (INSTR_PROF_RAW_MAGIC_64)
                                             : (INSTR_PROF_RAW_MAGIC_32);
@@ -46,6 +48,8 @@ COMPILER_RT_VISIBILITY void __llvm_profile_reset_counters(void) {
   char *E = __llvm_profile_end_counters();
 
   memset(I, 0, E - I);
+  if (lprofResetCounterShardsHook)
+    lprofResetCounterShardsHook();
 
   const __llvm_profile_data *DataBegin = __llvm_profile_begin_data();
   const __llvm_profile_data *DataEnd = __llvm_profile_end_data();
@@ -184,6 +184,11 @@ unsigned lprofProfileDumped(void);
 void lprofSetProfileDumped(unsigned);
 
 COMPILER_RT_VISIBILITY extern void (*FreeHook)(void *);
+/* Hooks to merge per-thread counter shards into the counters section, and to
+ * reset them. They are set when the first shard is allocated, see
+ * InstrProfilingShard.c. */
+COMPILER_RT_VISIBILITY extern void (*lprofMergeCounterShardsHook)(void);
+COMPILER_RT_VISIBILITY extern void (*lprofResetCounterShardsHook)(void);
 COMPILER_RT_VISIBILITY extern uint8_t *DynamicBufferIOBuffer;
 COMPILER_RT_VISIBILITY extern uint32_t VPBufferSize;
 COMPILER_RT_VISIBILITY extern uint32_t VPMaxNumValsPerSite;
@@ -0,0 +1,22 @@
+/*===- InstrProfilingSampling.c - Sampled instrumentation state -----------===*\
+|*
+|* Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+|* See https://llvm.org/LICENSE.txt for license information.
+|* SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+|*
+\*===----------------------------------------------------------------------===*/
+
+#include <stdint.h>
+
+#include "InstrProfiling.h"
+
+/* uint32_t __llvm_profile_sampling
+ *
+ * Support for -sampled-instrumentation. Instrumented functions count their
+ * entries by the current thread in this variable, modulo the sampling period,
+ * and only update their counters during the first entries of each period. The
+ * period and burst duration are chosen at compile time, so the counts are
+ * scaled down by the same factor for all functions of a module.
+ */
+COMPILER_RT_VISIBILITY COMPILER_RT_THREAD_LOCAL uint32_t
+    INSTR_PROF_PROFILE_SAMPLING_VAR = 0;
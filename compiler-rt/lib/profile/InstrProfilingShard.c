@@ -0,0 +1,147 @@
+/*===- InstrProfilingShard.c - Per-thread profile counter shards ----------===*\
+|*
+|* Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+|* See https://llvm.org/LICENSE.txt for license information.
+|* SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+|*
+\*===----------------------------------------------------------------------===*/
+
+/* Support for -instrprof-per-thread-counters. Instead of updating the counters
+ * section directly, instrumented code updates a private copy of the section
+ * (a shard) owned by the current thread. This avoids contention and false
+ * sharing between threads on the counters of hot functions.
+ *
+ * Instrumented functions load the thread-local shard offset on entry and call
+ * __llvm_profile_init_counter_shard() if it is zero. The counter address is
+ * then the address in the counters section plus the offset. Shards are
+ * allocated lazily, one per thread, and are reused by new threads once the
+ * owning thread exits. They are summed into the counters section whenever the
+ * profile is written, and zeroed when the counters are reset. */
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "InstrProfiling.h"
+#include "InstrProfilingInternal.h"
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+#define INSTR_PROF_VALUE_PROF_DATA
+#include "profile/InstrProfData.inc"
+
+/* The offset of the current thread's shard from the counters section, or 0 if
+ * the thread has no shard. */
+COMPILER_RT_VISIBILITY COMPILER_RT_THREAD_LOCAL intptr_t
+    INSTR_PROF_PROFILE_COUNTER_SHARD_OFFSET_VAR = 0;
+
+typedef struct CounterShard {
+  struct CounterShard *Next;
+  uint64_t *Counters;
+  /* Non-zero while a thread uses this shard. */
+  int InUse;
+} CounterShard;
+
+/* All of the allocated shards. Shards are never freed, so the list only grows
+ * by pushing to the front. */
+static CounterShard *ShardList = NULL;
+
+static uint64_t getNumCounters(void) {
+  return __llvm_profile_get_num_counters(__llvm_profile_begin_counters(),
+                                         __llvm_profile_end_counters());
+}
+
+/* Add the counts of all shards to the counters section, and zero the shards.
+ * Counts are exchanged atomically so that updates made concurrently to other
+ * counters of the same shard are not lost. */
+static void mergeCounterShards(void) {
+  uint64_t *Counters = (uint64_t *)__llvm_profile_begin_counters();
+  uint64_t NumCounters = getNumCounters(), I;
+  CounterShard *Shard;
+  for (Shard = ShardList; Shard; Shard = Shard->Next) {
+    for (I = 0; I < NumCounters; ++I) {
+      uint64_t Count = Shard->Counters[I];
+      if (!Count)
+        continue;
+#if COMPILER_RT_HAS_ATOMICS == 1 && !defined(_MSC_VER)
+      Count = __atomic_exchange_n(&Shard->Counters[I], 0, __ATOMIC_RELAXED);
+#else
+      Shard->Counters[I] = 0;
+#endif
+      Counters[I] += Count;
+    }
+  }
+}
+
+static void resetCounterShards(void) {
+  uint64_t NumCounters = getNumCounters(), I;
+  CounterShard *Shard;
+  for (Shard = ShardList; Shard; Shard = Shard->Next)
+    for (I = 0; I < NumCounters; ++I)
+      Shard->Counters[I] = 0;
+}
+
+#if !defined(_WIN32)
+static pthread_key_t ShardKey;
+static pthread_once_t ShardKeyOnce = PTHREAD_ONCE_INIT;
+
+/* Release the shard of an exiting thread, so that a new thread can reuse it.
+ * Its counts are kept until the next merge. */
+static void releaseCounterShard(void *Shard) {
+  COMPILER_RT_BOOL_CMPXCHG(&((CounterShard *)Shard)->InUse, 1, 0);
+}
+
+static void createShardKey(void) {
+  pthread_key_create(&ShardKey, releaseCounterShard);
+}
+#endif
+
+/* Return a shard that is not used by any thread, allocating a new one if
+ * necessary. Returns NULL if allocation fails. */
+static CounterShard *acquireCounterShard(void) {
+  CounterShard *Shard;
+  for (Shard = ShardList; Shard; Shard = Shard->Next)
+    if (COMPILER_RT_BOOL_CMPXCHG(&Shard->InUse, 0, 1))
+      return Shard;
+
+  Shard = (CounterShard *)calloc(1, sizeof(CounterShard));
+  if (!Shard)
+    return NULL;
+  Shard->Counters = (uint64_t *)calloc(getNumCounters(), sizeof(uint64_t));
+  if (!Shard->Counters) {
+    free(Shard);
+    return NULL;
+  }
+  Shard->InUse = 1;
+  do {
+    Shard->Next = ShardList;
+  } while (!COMPILER_RT_BOOL_CMPXCHG(&ShardList, Shard->Next, Shard));
+  return Shard;
+}
+
+COMPILER_RT_VISIBILITY intptr_t
+INSTR_PROF_PROFILE_INIT_COUNTER_SHARD_FUNC(void) {
+  CounterShard *Shard;
+
+  /* In continuous mode the counters section is mapped to the profile file and
+   * must be updated in place. Leaving the offset at 0 keeps updating the
+   * counters section, at the cost of calling this function again. */
+  if (__llvm_profile_is_continuous_mode_enabled() || !getNumCounters())
+    return 0;
+
+  Shard = acquireCounterShard();
+  if (!Shard)
+    return 0;
+
+  lprofMergeCounterShardsHook = mergeCounterShards;
+  lprofResetCounterShardsHook = resetCounterShards;
+#if !defined(_WIN32)
+  pthread_once(&ShardKeyOnce, createShardKey);
+  pthread_setspecific(ShardKey, Shard);
+#endif
+
+  INSTR_PROF_PROFILE_COUNTER_SHARD_OFFSET_VAR =
+      (intptr_t)Shard->Counters - (intptr_t)__llvm_profile_begin_counters();
+  return INSTR_PROF_PROFILE_COUNTER_SHARD_OFFSET_VAR;
+}
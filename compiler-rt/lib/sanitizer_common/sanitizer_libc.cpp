@@ -279,7 +279,14 @@ bool mem_is_zero(const char *beg, uptr size) {
   // Prologue.
   for (const char *mem = beg; mem < (char*)aligned_beg && mem < end; mem++)
     all |= *mem;
-  // Aligned loop.
+  if (all)
+    return false;
+  // Aligned loop. Four words are checked at a time, which compilers turn into
+  // vector ORs, and the loop stops at the first block that is not zero.
+  for (; aligned_end - aligned_beg >= 4; aligned_beg += 4) {
+    if (aligned_beg[0] | aligned_beg[1] | aligned_beg[2] | aligned_beg[3])
+      return false;
+  }
   for (; aligned_beg < aligned_end; aligned_beg++)
     all |= *aligned_beg;
   // Epilogue.
@@ -108,6 +108,16 @@ uptr StackStore::Pack(Compression type) {
   return res;
 }
 
+uptr StackStore::Evict(uptr max_allocated) {
+  uptr res = 0;
+  for (BlockInfo &b : blocks_) {
+    if (Allocated() <= max_allocated)
+      break;
+    res += b.Evict(this);
+  }
+  return res;
+}
+
 void StackStore::LockAll() {
   for (BlockInfo &b : blocks_) b.Lock();
 }
@@ -260,6 +270,8 @@ uptr *StackStore::BlockInfo::GetOrUnpack(StackStore *store) {
       return Get();
     case State::Packed:
       break;
+    case State::Evicted:
+      return nullptr;
   }
 
   u8 *ptr = reinterpret_cast<u8 *>(Get());
@@ -306,6 +318,7 @@ uptr StackStore::BlockInfo::Pack(Compression type, StackStore *store) {
   switch (state) {
     case State::Unpacked:
     case State::Packed:
+    case State::Evicted:
       return 0;
     case State::Storing:
       break;
@@ -361,6 +374,34 @@ uptr StackStore::BlockInfo::Pack(Compression type, StackStore *store) {
   return kBlockSizeBytes - packed_size_aligned;
 }
 
+uptr StackStore::BlockInfo::Evict(StackStore *store) {
+  SpinMutexLock l(&mtx_);
+  uptr size = 0;
+  switch (state) {
+    case State::Unpacked:
+    case State::Evicted:
+      return 0;
+    case State::Storing:
+      size = kBlockSizeBytes;
+      break;
+    case State::Packed:
+      size = RoundUpTo(reinterpret_cast<const PackedHeader *>(Get())->size,
+                       GetPageSizeCached());
+      break;
+  }
+
+  uptr *ptr = Get();
+  if (!ptr || !Stored(0))
+    return 0;
+
+  VPrintf(1, "Evicted block of %zu KiB\n", size >> 10);
+
+  atomic_store(&data_, 0, memory_order_release);
+  store->Unmap(ptr, size);
+  state = State::Evicted;
+  return size;
+}
+
 void StackStore::BlockInfo::TestOnlyUnmap(StackStore *store) {
   if (uptr *ptr = Get())
     store->Unmap(ptr, kBlockSizeBytes);
@@ -376,4 +417,9 @@ bool StackStore::BlockInfo::IsPacked() const {
   return state == State::Packed;
 }
 
+bool StackStore::BlockInfo::IsEvicted() const {
+  SpinMutexLock l(&mtx_);
+  return state == State::Evicted;
+}
+
 }  // namespace __sanitizer
@@ -46,6 +46,13 @@ class StackStore {
   // Returns the number of released bytes.
   uptr Pack(Compression type);
 
+  // Releases the oldest blocks which don't expect any more writes, until no
+  // more than `max_allocated` bytes are allocated. Blocks with traces that were
+  // already requested are kept, as the caller may still use them. Traces of
+  // released blocks are loaded as empty stacks.
+  // Returns the number of released bytes.
+  uptr Evict(uptr max_allocated);
+
   void LockAll();
   void UnlockAll();
 
@@ -96,6 +103,7 @@ class StackStore {
       Storing = 0,
       Packed,
       Unpacked,
+      Evicted,
     };
     State state SANITIZER_GUARDED_BY(mtx_);
 
@@ -106,9 +114,11 @@ class StackStore {
     uptr *GetOrCreate(StackStore *store);
     uptr *GetOrUnpack(StackStore *store);
     uptr Pack(Compression type, StackStore *store);
+    uptr Evict(StackStore *store);
     void TestOnlyUnmap(StackStore *store);
     bool Stored(uptr n);
     bool IsPacked() const;
+    bool IsEvicted() const;
     void Lock() SANITIZER_NO_THREAD_SAFETY_ANALYSIS { mtx_.Lock(); }
     void Unlock() SANITIZER_NO_THREAD_SAFETY_ANALYSIS { mtx_.Unlock(); }
   };
@@ -78,6 +78,8 @@ static void CompressStackStore() {
   u64 start = MonotonicNanoTime();
   uptr diff = stackStore.Pack(static_cast<StackStore::Compression>(
       Abs(common_flags()->compress_stack_depot)));
+  if (uptr limit_mb = common_flags()->stack_depot_limit_mb)
+    diff += stackStore.Evict(limit_mb << 20);
   if (!diff)
     return;
   u64 finish = MonotonicNanoTime();
@@ -123,7 +125,7 @@ static CompressThread compress_thread;
 
 void CompressThread::NewWorkNotify() {
   int compress = common_flags()->compress_stack_depot;
-  if (!compress)
+  if (!compress && !common_flags()->stack_depot_limit_mb)
     return;
   if (compress > 0 /* for testing or debugging */) {
     SpinMutexLock l(&mutex_);
@@ -64,6 +64,7 @@ class StackDepotBase {
  private:
   friend Node;
   u32 find(u32 s, args_type args, hash_type hash) const;
+  // Only used by LockAll(), as Put() is lock-free.
   static u32 lock(atomic_uint32_t *p);
   static void unlock(atomic_uint32_t *p, u32 s);
   atomic_uint32_t tab[kTabSize];  // Hash table of Node's.
@@ -127,24 +128,38 @@ u32 StackDepotBase<Node, kReservedBits, kTabSizeLog>::Put(args_type args,
   if (LIKELY(node))
     return node;
 
-  // If failed, lock, retry and insert new.
-  u32 s2 = lock(p);
-  if (s2 != s) {
-    node = find(s2, args, h);
-    if (node) {
-      unlock(p, s2);
-      return node;
+  // If failed, create a new node and push it to the list without locking. The
+  // lock bit is only set by LockAll(), in which case the push waits for
+  // UnlockAll().
+  u32 id = atomic_fetch_add(&n_uniq_ids, 1, memory_order_relaxed) + 1;
+  CHECK_EQ(id & kUnlockMask, id);
+  CHECK_EQ(id & (((u32)-1) >> kReservedBits), id);
+  Node &new_node = nodes[id];
+  new_node.store(id, args, h);
+  for (int i = 0;; i++) {
+    new_node.link = s;
+    u32 cmp = s;
+    if (atomic_compare_exchange_weak(p, &cmp, id, memory_order_release))
+      break;
+    if (cmp & kLockMask) {
+      if (i < 10)
+        proc_yield(10);
+      else
+        internal_sched_yield();
+      continue;
+    }
+    // Other nodes were pushed meanwhile, one of them may be the same stack.
+    // The new node is then left unreachable. This only happens if the same
+    // stack is inserted concurrently, so the wasted id is not a concern.
+    if (cmp != s) {
+      node = find(cmp, args, h);
+      if (node)
+        return node;
+      s = cmp;
     }
   }
-  s = atomic_fetch_add(&n_uniq_ids, 1, memory_order_relaxed) + 1;
-  CHECK_EQ(s & kUnlockMask, s);
-  CHECK_EQ(s & (((u32)-1) >> kReservedBits), s);
-  Node &new_node = nodes[s];
-  new_node.store(s, args, h);
-  new_node.link = s2;
-  unlock(p, s);
   if (inserted) *inserted = true;
-  return s;
+  return id;
 }
 
 template <class Node, int kReservedBits, int kTabSizeLog>
@@ -61,6 +61,12 @@ class StackStoreTest : public testing::Test {
     return res;
   }
 
+  uptr CountEvictedBlocks() const {
+    uptr res = 0;
+    for (const BlockInfo& b : store_.blocks_) res += b.IsEvicted();
+    return res;
+  }
+
   uptr IdToOffset(StackStore::Id id) const { return store_.IdToOffset(id); }
 
   static constexpr uptr kBlockSizeFrames = StackStore::kBlockSizeFrames;
@@ -128,6 +134,45 @@ TEST_F(StackStoreTest, ReadyToPack) {
   EXPECT_EQ(GetTotalFramesCount() / kBlockSizeFrames, total_ready);
 }
 
+TEST_F(StackStoreTest, Evict) {
+  std::vector<StackStore::Id> ids;
+  ForEachTrace([&](const StackTrace& s) {
+    uptr pack = 0;
+    ids.push_back(store_.Store(s, &pack));
+  });
+  // Keep the first block, which was requested.
+  EXPECT_NE(0u, store_.Load(ids[0]).size);
+
+  uptr limit = store_.Allocated() / 2;
+  uptr before = store_.Allocated();
+  uptr diff = store_.Evict(limit);
+  uptr after = store_.Allocated();
+  EXPECT_EQ(before - after, diff);
+  EXPECT_LE(after, limit);
+  EXPECT_GT(after, limit - kBlockSizeBytes);
+  uptr evicted = CountEvictedBlocks();
+  EXPECT_EQ(diff / kBlockSizeBytes, evicted);
+  EXPECT_EQ(0u, store_.Evict(limit));
+
+  // Traces of evicted blocks are empty, the others are kept.
+  uptr empty = 0;
+  auto id = ids.begin();
+  ForEachTrace([&](const StackTrace& s) {
+    StackTrace trace = store_.Load(*(id++));
+    if (!trace.trace) {
+      ++empty;
+      return;
+    }
+    EXPECT_EQ(s.size, trace.size);
+    EXPECT_EQ(s.tag, trace.tag);
+    EXPECT_EQ(std::vector<uptr>(s.trace, s.trace + s.size),
+              std::vector<uptr>(trace.trace, trace.trace + trace.size));
+  });
+  EXPECT_NE(0u, empty);
+  EXPECT_NE(0u, store_.Load(ids[0]).size);
+  EXPECT_EQ(evicted, CountEvictedBlocks());
+}
+
 struct StackStorePackTest : public StackStoreTest,
                             public ::testing::WithParamInterface<
                                 std::pair<StackStore::Compression, uptr>> {};
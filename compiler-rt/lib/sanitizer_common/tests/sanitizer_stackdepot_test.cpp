@@ -122,6 +122,29 @@ TEST_F(StackDepotTest, PrintNoLock) {
   }
 }
 
+TEST_F(StackDepotTest, Concurrent) {
+  const u32 n = 10000;
+  const int kThreads = 4;
+  std::vector<std::vector<u32>> ids(kThreads, std::vector<u32>(n));
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t]() {
+      for (u32 i = 0; i < n; ++i) {
+        uptr array[] = {0x111, i, 0x333};
+        StackTrace s(array, ARRAY_SIZE(array));
+        ids[t][i] = StackDepotPut(s);
+      }
+    });
+  }
+  for (auto& t : threads) t.join();
+  for (int t = 1; t < kThreads; ++t) EXPECT_EQ(ids[0], ids[t]);
+  for (u32 i = 0; i < n; ++i) {
+    StackTrace s = StackDepotGet(ids[0][i]);
+    ASSERT_EQ(3u, s.size);
+    EXPECT_EQ(i, s.trace[1]);
+  }
+}
+
 static struct StackDepotBenchmarkParams {
   int UniqueStacksPerThread;
   int RepeatPerThread;
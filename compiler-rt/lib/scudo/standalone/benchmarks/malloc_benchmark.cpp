@@ -106,4 +106,51 @@ BENCHMARK_TEMPLATE(BM_malloc_free_loop, scudo::FuchsiaConfig)
     ->Range(MinIters, MaxIters);
 #endif
 
+// Measures the throughput of an allocator shared by an increasing number of
+// threads, each allocating and freeing batches of chunks of various sizes.
+template <typename Config>
+static void BM_malloc_free_threads(benchmark::State &State) {
+  using AllocatorT = scudo::Allocator<Config, PostInitCallback<Config>>;
+  static AllocatorT *Allocator;
+  // Other threads wait for the first one to create the allocator when they
+  // enter the benchmark loop.
+  if (State.thread_index() == 0) {
+    Allocator = new AllocatorT;
+    CurrentAllocator = Allocator;
+  }
+
+  const size_t NumPtrs = 256;
+  std::vector<void *> Ptrs(NumPtrs);
+
+  for (auto _ : State) {
+    size_t SizeLog2 = 4;
+    for (void *&Ptr : Ptrs) {
+      Ptr = Allocator->allocate(1 << SizeLog2, scudo::Chunk::Origin::Malloc);
+      benchmark::DoNotOptimize(Ptr);
+      SizeLog2 = SizeLog2 == 12 ? 4 : SizeLog2 + 1;
+    }
+    for (void *Ptr : Ptrs)
+      Allocator->deallocate(Ptr, scudo::Chunk::Origin::Malloc);
+  }
+
+  State.SetItemsProcessed(uint64_t(State.iterations()) * NumPtrs);
+
+  // All of the threads are done with the allocator once they left the loop.
+  if (State.thread_index() == 0) {
+    Allocator->unmapTestOnly();
+    delete Allocator;
+  }
+}
+
+static const int MaxThreads = 128;
+
+BENCHMARK_TEMPLATE(BM_malloc_free_threads, scudo::AndroidConfig)
+    ->ThreadRange(1, MaxThreads)
+    ->UseRealTime();
+#if SCUDO_CAN_USE_PRIMARY64
+BENCHMARK_TEMPLATE(BM_malloc_free_threads, scudo::FuchsiaConfig)
+    ->ThreadRange(1, MaxThreads)
+    ->UseRealTime();
+#endif
+
 BENCHMARK_MAIN();
@@ -143,6 +143,12 @@ u32 getNumberOfCPUs() {
   return static_cast<u32>(CPU_COUNT(&CPUs));
 }
 
+s32 getCurrentCPU() {
+  // With glibc 2.35 and later, this reads the CPU number from the rseq area of
+  // the thread rather than issuing a system call.
+  return static_cast<s32>(sched_getcpu());
+}
+
 u32 getThreadID() {
 #if SCUDO_ANDROID
   return static_cast<u32>(gettid());
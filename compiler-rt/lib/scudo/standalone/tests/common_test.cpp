@@ -69,4 +69,8 @@ TEST(ScudoCommonTest, Zeros) {
   unmap(P, Size, 0, &Data);
 }
 
+TEST(ScudoCommonTest, SKIP_ON_FUCHSIA(CurrentCPU)) {
+  EXPECT_GE(getCurrentCPU(), 0);
+}
+
 } // namespace scudo
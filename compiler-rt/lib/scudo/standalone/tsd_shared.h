@@ -152,7 +152,9 @@ private:
 
   NOINLINE void initThread(Allocator *Instance) {
     initOnceMaybe(Instance);
-    // Initial context assignment is done in a plain round-robin fashion.
+    // Initial context assignment is done in a plain round-robin fashion. New
+    // threads usually start on the CPU of their creator, so following the CPU
+    // here would pile them up on the same context.
     const u32 Index = atomic_fetch_add(&CurrentIndex, 1U, memory_order_relaxed);
     setCurrentTSD(&TSDs[Index % NumberOfTSDs]);
     Instance->callPostInitCallback();
@@ -171,6 +173,17 @@ private:
       Inc = CoPrimes[R % NumberOfCoPrimes];
     }
     if (N > 1U) {
+      // First try the context of the CPU the thread runs on. Only one thread
+      // runs on a CPU at a time, so threads converging to the context of their
+      // CPU rarely contend for it.
+      const s32 CPU = getCurrentCPU();
+      if (CPU >= 0) {
+        TSD<Allocator> *CPUTSD = &TSDs[static_cast<u32>(CPU) % N];
+        if (CPUTSD != CurrentTSD && CPUTSD->tryLock()) {
+          setCurrentTSD(CPUTSD);
+          return CPUTSD;
+        }
+      }
       u32 Index = R % N;
       uptr LowestPrecedence = UINTPTR_MAX;
       TSD<Allocator> *CandidateTSD = nullptr;
@@ -18,10 +18,22 @@
 #include "sanitizer_common/sanitizer_mutex.h"
 #include "ubsan/ubsan_platform.h"
 
+// Number of shadow values (prior accesses) kept per shadow cell.
+// 2 halves the shadow memory, but races are missed more often.
+#ifndef TSAN_SHADOW_COUNT
+#  define TSAN_SHADOW_COUNT 4
+#endif
+#if TSAN_SHADOW_COUNT != 2 && TSAN_SHADOW_COUNT != 4
+#  error "TSAN_SHADOW_COUNT must be 2 or 4"
+#endif
+
 #ifndef TSAN_VECTORIZE
 #  define TSAN_VECTORIZE __SSE4_2__
 #endif
 
+// The vectorized shadow checks load a whole cell of 4 shadow values.
+#define TSAN_VECTORIZE_SHADOW (TSAN_VECTORIZE && TSAN_SHADOW_COUNT == 4)
+
 #if TSAN_VECTORIZE
 // <emmintrin.h> transitively includes <stdlib.h>,
 // and it's prohibited to include std headers into tsan runtime.
@@ -74,7 +86,8 @@ inline bool EpochOverflow(Epoch epoch) { return epoch == kEpochOver; }
 const uptr kShadowStackSize = 64 * 1024;
 
 // Count of shadow values in a shadow cell.
-const uptr kShadowCnt = 4;
+// The first two values of a freed cell hold the free marker and info.
+const uptr kShadowCnt = TSAN_SHADOW_COUNT;
 
 // That many user bytes are mapped onto a single shadow cell.
 const uptr kShadowCell = 8;
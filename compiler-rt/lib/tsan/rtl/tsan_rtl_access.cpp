@@ -177,7 +177,7 @@ NOINLINE void DoReportRace(ThreadState* thr, RawShadow* shadow_mem, Shadow cur,
     SlotLock(thr);
 }
 
-#if !TSAN_VECTORIZE
+#if !TSAN_VECTORIZE_SHADOW
 ALWAYS_INLINE
 bool ContainsSameAccess(RawShadow* s, Shadow cur, int unused0, int unused1,
                         AccessType typ) {
@@ -242,7 +242,7 @@ bool CheckRaces(ThreadState* thr, RawShadow* shadow_mem, Shadow cur,
 
 #  define LOAD_CURRENT_SHADOW(cur, shadow_mem) UNUSED int access = 0, shadow = 0
 
-#else /* !TSAN_VECTORIZE */
+#else /* !TSAN_VECTORIZE_SHADOW */
 
 ALWAYS_INLINE
 bool ContainsSameAccess(RawShadow* unused0, Shadow unused1, m128 shadow,
@@ -435,8 +435,8 @@ ALWAYS_INLINE USED void MemoryAccess(ThreadState* thr, uptr pc, uptr addr,
            static_cast<int>(thr->fast_state.epoch()), (void*)addr, size,
            static_cast<int>(typ), DumpShadow(memBuf[0], shadow_mem[0]),
            DumpShadow(memBuf[1], shadow_mem[1]),
-           DumpShadow(memBuf[2], shadow_mem[2]),
-           DumpShadow(memBuf[3], shadow_mem[3]));
+           DumpShadow(memBuf[2], shadow_mem[2 % kShadowCnt]),
+           DumpShadow(memBuf[3], shadow_mem[3 % kShadowCnt]));
 
   FastState fast_state = thr->fast_state;
   Shadow cur(fast_state, addr, size, typ);
@@ -538,7 +538,7 @@ void ShadowSet(RawShadow* p, RawShadow* end, RawShadow v) {
   UNUSED const uptr kAlign = kShadowCnt * kShadowSize;
   DCHECK_EQ(reinterpret_cast<uptr>(p) % kAlign, 0);
   DCHECK_EQ(reinterpret_cast<uptr>(end) % kAlign, 0);
-#if !TSAN_VECTORIZE
+#if !TSAN_VECTORIZE_SHADOW
   for (; p < end; p += kShadowCnt) {
     p[0] = v;
     for (uptr i = 1; i < kShadowCnt; i++) p[i] = Shadow::kEmpty;
@@ -616,7 +616,7 @@ void MemoryRangeFreed(ThreadState* thr, uptr pc, uptr addr, uptr size) {
   TraceMemoryAccessRange(thr, pc, addr, size, typ);
   RawShadow* shadow_mem = MemToShadow(addr);
   Shadow cur(thr->fast_state, 0, kShadowCell, typ);
-#if TSAN_VECTORIZE
+#if TSAN_VECTORIZE_SHADOW
   const m128 access = _mm_set1_epi32(static_cast<u32>(cur.raw()));
   const m128 freed = _mm_setr_epi32(
       static_cast<u32>(Shadow::FreedMarker()),
@@ -633,8 +633,8 @@ void MemoryRangeFreed(ThreadState* thr, uptr pc, uptr addr, uptr size) {
       return;
     StoreShadow(&shadow_mem[0], Shadow::FreedMarker());
     StoreShadow(&shadow_mem[1], Shadow::FreedInfo(cur.sid(), cur.epoch()));
-    StoreShadow(&shadow_mem[2], Shadow::kEmpty);
-    StoreShadow(&shadow_mem[3], Shadow::kEmpty);
+    for (uptr i = 2; i < kShadowCnt; i++)
+      StoreShadow(&shadow_mem[i], Shadow::kEmpty);
   }
 #endif
 }
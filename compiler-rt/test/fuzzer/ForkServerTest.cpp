@@ -0,0 +1,31 @@
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Reports whether the process running the inputs is the one that called
+// LLVMFuzzerInitialize. The fuzzer must find the string "Hi!".
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+static pid_t InitializedPid;
+
+extern "C" int LLVMFuzzerInitialize(int *argc, char ***argv) {
+  InitializedPid = getpid();
+  return 0;
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *Data, size_t Size) {
+  if (Size > 0 && Data[0] == 'H') {
+    if (Size > 1 && Data[1] == 'i') {
+      if (Size > 2 && Data[2] == '!') {
+        fprintf(stderr, "BINGO: initialized in %s\n",
+                InitializedPid == getpid() ? "this process" : "a parent");
+        exit(1);
+      }
+    }
+  }
+  return 0;
+}
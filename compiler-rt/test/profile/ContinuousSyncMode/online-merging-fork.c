@@ -0,0 +1,37 @@
+// REQUIRES: linux
+
+// Test that a pool of forked workers updates a single profile in the online
+// merging mode (%m) along with continuous mode (%c). The workers inherit the
+// mapping of the counters to the profile, so counts are only exact if they
+// are updated atomically.
+//
+// RUN: rm -rf %t.dir && mkdir -p %t.dir
+// RUN: %clang_pgogen -fprofile-update=atomic -mllvm -runtime-counter-relocation=true -o %t.exe %s
+// RUN: env LLVM_PROFILE_FILE="%t.dir/%m%c.profraw" %run %t.exe
+// RUN: llvm-profdata merge -o %t.profdata %t.dir
+// RUN: llvm-profdata show --counts --function=work %t.profdata | FileCheck %s
+
+// CHECK:      work:
+// CHECK:        Counters: 1
+// CHECK:        Block counts: [80000]
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define NUM_WORKERS 8
+#define NUM_CALLS 10000
+
+__attribute__((noinline)) void work(void) {}
+
+int main(void) {
+  for (int I = 0; I < NUM_WORKERS; ++I) {
+    if (fork() == 0) {
+      for (int J = 0; J < NUM_CALLS; ++J)
+        work();
+      _exit(0);
+    }
+  }
+  for (int I = 0; I < NUM_WORKERS; ++I)
+    wait(0);
+  return 0;
+}
@@ -0,0 +1,37 @@
+// RUN: rm -f %t.profraw
+// RUN: %clang_pgogen -O2 -mllvm -instrprof-per-thread-counters -lpthread -o %t %s
+// RUN: env LLVM_PROFILE_FILE=%t.profraw %run %t
+// RUN: llvm-profdata merge -o %t.profdata %t.profraw
+// RUN: llvm-profdata show --counts --function=work %t.profdata | FileCheck %s
+
+// Counter updates from concurrent threads go to per-thread shards, which are
+// summed when the profile is written, so no update is lost. The second round
+// of threads reuses the shards of the first.
+
+// CHECK: Function count: 4000000
+
+#include <pthread.h>
+
+#define NUM_THREADS 4
+#define NUM_ITERATIONS 500000
+
+volatile int sink;
+
+__attribute__((noinline)) void work(int i) { sink = i; }
+
+static void *run(void *arg) {
+  for (int i = 0; i < NUM_ITERATIONS; ++i)
+    work(i);
+  return 0;
+}
+
+int main() {
+  pthread_t threads[NUM_THREADS];
+  for (int round = 0; round < 2; ++round) {
+    for (int i = 0; i < NUM_THREADS; ++i)
+      pthread_create(&threads[i], 0, run, 0);
+    for (int i = 0; i < NUM_THREADS; ++i)
+      pthread_join(threads[i], 0);
+  }
+  return 0;
+}
@@ -0,0 +1,25 @@
+// RUN: rm -f %t.profraw
+// RUN: %clang_pgogen -O2 -mllvm -sampled-instrumentation \
+// RUN:   -mllvm -sampled-instr-period=100 \
+// RUN:   -mllvm -sampled-instr-burst-duration=10 -o %t %s
+// RUN: env LLVM_PROFILE_FILE=%t.profraw %run %t
+// RUN: llvm-profdata merge -o %t.profdata %t.profraw
+// RUN: llvm-profdata show --counts --function=work %t.profdata | FileCheck %s
+
+// Counters are only updated during the first 10 of every 100 function entries
+// of the thread. The entry of main is the first one of the first period, so
+// work is counted for 9 of its first 99 calls, then 10 of every 100 calls.
+
+// CHECK: Function count: 100000
+
+#define NUM_ITERATIONS 1000000
+
+volatile int sink;
+
+__attribute__((noinline)) void work(int i) { sink = i; }
+
+int main() {
+  for (int i = 0; i < NUM_ITERATIONS; ++i)
+    work(i);
+  return 0;
+}
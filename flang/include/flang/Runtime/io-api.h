@@ -128,7 +128,9 @@ Cookie IONAME(BeginUnformattedInput)(ExternalUnit = DefaultUnit,
     const char *sourceFile = nullptr, int sourceLine = 0);
 
 // Asynchronous I/O is supported (at most) for unformatted direct access
-// block transfers.
+// block transfers on units opened with ASYNCHRONOUS='YES'.  The returned
+// ID is passed to BeginWait(), whose statement reports any error in
+// the transfer; CLOSE discards unclaimed statuses.
 AsynchronousId IONAME(BeginAsynchronousOutput)(ExternalUnit, std::int64_t REC,
     const char *, std::size_t, const char *sourceFile = nullptr,
     int sourceLine = 0);
@@ -128,6 +128,15 @@ public:
     }
   }
 
+  // Writes any modified data and forgets the buffer's contents so that
+  // the file can be accessed by other means without going stale.
+  void Forget(IoErrorHandler &handler) {
+    Flush(handler);
+    if (!dirty_) {
+      Reset(fileOffset_);
+    }
+  }
+
 private:
   STORE &Store() { return static_cast<STORE &>(*this); }
 
@@ -8,4 +8,7 @@
    don't. */
 #cmakedefine01 HAVE_DECL_STRERROR_S
 
+/* Define to 1 if MATMUL may call CBLAS routines, and to 0 if not. */
+#cmakedefine01 FLANG_RUNTIME_USE_BLAS
+
 #endif
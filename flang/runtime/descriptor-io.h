@@ -23,6 +23,8 @@
 #include "flang/Common/uint128.h"
 #include "flang/Runtime/cpp-type.h"
 #include "flang/Runtime/descriptor.h"
+#include <algorithm>
+#include <limits>
 
 namespace Fortran::runtime::io::descr {
 template <typename A>
@@ -36,6 +38,29 @@ inline A &ExtractElement(IoStatementState &io, const Descriptor &descriptor,
   return *p;
 }
 
+// On output, a repeated data edit descriptor like "5F12.4" (or any
+// list-directed edit) is fetched once and applied to as many consecutive
+// elements as it covers, rather than walking the FORMAT for each element.
+// Input keeps taking one edit per element, since a list-directed "r*c"
+// repetition on input means something else.
+template <Direction DIR>
+inline int MaxEditRepeat(std::size_t remainingElements) {
+  if constexpr (DIR == Direction::Output) {
+    return static_cast<int>(std::min<std::size_t>(
+        remainingElements, std::numeric_limits<int>::max()));
+  } else {
+    return 1;
+  }
+}
+
+template <Direction DIR> inline int EditRepeat(const DataEdit &edit) {
+  if constexpr (DIR == Direction::Output) {
+    return std::max(edit.repeat, 1);
+  } else {
+    return 1;
+  }
+}
+
 // Per-category descriptor-based I/O templates
 
 // TODO (perhaps as a nontrivial but small starter project): implement
@@ -50,24 +75,28 @@ inline bool FormattedIntegerIO(
   descriptor.GetLowerBounds(subscripts);
   using IntType = CppTypeFor<TypeCategory::Integer, KIND>;
   bool anyInput{false};
-  for (std::size_t j{0}; j < numElements; ++j) {
-    if (auto edit{io.GetNextDataEdit()}) {
-      IntType &x{ExtractElement<IntType>(io, descriptor, subscripts)};
-      if constexpr (DIR == Direction::Output) {
-        if (!EditIntegerOutput<KIND>(io, *edit, x)) {
-          return false;
+  for (std::size_t j{0}; j < numElements;) {
+    if (auto edit{io.GetNextDataEdit(MaxEditRepeat<DIR>(numElements - j))}) {
+      for (int k{0}; k < EditRepeat<DIR>(*edit); ++k, ++j) {
+        IntType &x{ExtractElement<IntType>(io, descriptor, subscripts)};
+        if constexpr (DIR == Direction::Output) {
+          if (!EditIntegerOutput<KIND>(io, *edit, x)) {
+            return false;
+          }
+        } else if (edit->descriptor != DataEdit::ListDirectedNullValue) {
+          if (EditIntegerInput(
+                  io, *edit, reinterpret_cast<void *>(&x), KIND)) {
+            anyInput = true;
+          } else {
+            return anyInput && edit->IsNamelist();
+          }
         }
-      } else if (edit->descriptor != DataEdit::ListDirectedNullValue) {
-        if (EditIntegerInput(io, *edit, reinterpret_cast<void *>(&x), KIND)) {
-          anyInput = true;
-        } else {
-          return anyInput && edit->IsNamelist();
+        if (!descriptor.IncrementSubscripts(subscripts) &&
+            j + 1 < numElements) {
+          io.GetIoErrorHandler().Crash(
+              "FormattedIntegerIO: subscripts out of bounds");
         }
       }
-      if (!descriptor.IncrementSubscripts(subscripts) && j + 1 < numElements) {
-        io.GetIoErrorHandler().Crash(
-            "FormattedIntegerIO: subscripts out of bounds");
-      }
     } else {
       return false;
     }
@@ -83,24 +112,27 @@ inline bool FormattedRealIO(
   descriptor.GetLowerBounds(subscripts);
   using RawType = typename RealOutputEditing<KIND>::BinaryFloatingPoint;
   bool anyInput{false};
-  for (std::size_t j{0}; j < numElements; ++j) {
-    if (auto edit{io.GetNextDataEdit()}) {
-      RawType &x{ExtractElement<RawType>(io, descriptor, subscripts)};
-      if constexpr (DIR == Direction::Output) {
-        if (!RealOutputEditing<KIND>{io, x}.Edit(*edit)) {
-          return false;
+  for (std::size_t j{0}; j < numElements;) {
+    if (auto edit{io.GetNextDataEdit(MaxEditRepeat<DIR>(numElements - j))}) {
+      for (int k{0}; k < EditRepeat<DIR>(*edit); ++k, ++j) {
+        RawType &x{ExtractElement<RawType>(io, descriptor, subscripts)};
+        if constexpr (DIR == Direction::Output) {
+          if (!RealOutputEditing<KIND>{io, x}.Edit(*edit)) {
+            return false;
+          }
+        } else if (edit->descriptor != DataEdit::ListDirectedNullValue) {
+          if (EditRealInput<KIND>(io, *edit, reinterpret_cast<void *>(&x))) {
+            anyInput = true;
+          } else {
+            return anyInput && edit->IsNamelist();
+          }
         }
-      } else if (edit->descriptor != DataEdit::ListDirectedNullValue) {
-        if (EditRealInput<KIND>(io, *edit, reinterpret_cast<void *>(&x))) {
-          anyInput = true;
-        } else {
-          return anyInput && edit->IsNamelist();
+        if (!descriptor.IncrementSubscripts(subscripts) &&
+            j + 1 < numElements) {
+          io.GetIoErrorHandler().Crash(
+              "FormattedRealIO: subscripts out of bounds");
         }
       }
-      if (!descriptor.IncrementSubscripts(subscripts) && j + 1 < numElements) {
-        io.GetIoErrorHandler().Crash(
-            "FormattedRealIO: subscripts out of bounds");
-      }
     } else {
       return false;
     }
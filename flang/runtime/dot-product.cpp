@@ -83,6 +83,26 @@ static inline CppTypeFor<RCAT, RKIND> DoDotProduct(
           accum += std::conj(static_cast<AccumType>(*xp++)) *
               static_cast<AccumType>(*yp++);
         }
+      } else if constexpr (RCAT == TypeCategory::Real) {
+        // Independent partial sums, so that the loop can be vectorized
+        SubscriptValue j{0};
+        if (n >= static_cast<SubscriptValue>(2 * reductionLanes)) {
+          AccumType lanes[reductionLanes]{};
+          for (; j + static_cast<SubscriptValue>(reductionLanes) <= n;
+               j += reductionLanes) {
+            for (std::size_t k{0}; k < reductionLanes; ++k) {
+              lanes[k] += static_cast<AccumType>(xp[j + k]) *
+                  static_cast<AccumType>(yp[j + k]);
+            }
+          }
+          for (std::size_t k{0}; k < reductionLanes; ++k) {
+            accum += lanes[k];
+          }
+        }
+        for (; j < n; ++j) {
+          accum +=
+              static_cast<AccumType>(xp[j]) * static_cast<AccumType>(yp[j]);
+        }
       } else {
         for (SubscriptValue j{0}; j < n; ++j) {
           accum +=
@@ -276,9 +276,13 @@ bool RealOutputEditing<binaryPrecision>::EditFOutput(const DataEdit &edit) {
   // effective rounded fractional digits.
   int extraDigits{0};
   bool canIncrease{true};
+  decimal::ConversionToDecimalResult converted;
+  bool needConversion{true};
   while (true) {
-    decimal::ConversionToDecimalResult converted{
-        Convert(extraDigits + fracDigits, rounding, flags)};
+    if (needConversion) {
+      converted = Convert(extraDigits + fracDigits, rounding, flags);
+    }
+    needConversion = true;
     if (IsInfOrNaN(converted)) {
       return EmitPrefix(edit, converted.length, editWidth) &&
           io_.Emit(converted.str, converted.length) && EmitSuffix(edit);
@@ -289,10 +293,13 @@ bool RealOutputEditing<binaryPrecision>::EditFOutput(const DataEdit &edit) {
     int convertedDigits{static_cast<int>(converted.length) - signLength};
     int trailingOnes{0};
     if (expo > extraDigits && extraDigits >= 0 && canIncrease) {
+      int convertedFor{extraDigits + fracDigits};
       extraDigits = expo;
       if (!edit.digits.has_value()) { // F0
         fracDigits = sizeof buffer_ - extraDigits - 2; // sign & NUL
       }
+      // F0 keeps the same total digit count, so its conversion stands
+      needConversion = extraDigits + fracDigits != convertedFor;
       canIncrease = false; // only once
       continue;
     } else if (expo == -fracDigits && convertedDigits > 0) {
@@ -323,6 +323,32 @@ public:
   template <typename A> bool AccumulateAt(const SubscriptValue at[]) {
     return Accumulate(*array_.Element<A>(at));
   }
+  // Selects on independent lanes, written so that each selection maps to
+  // a vector maximum or minimum instruction
+  template <typename A> void AccumulateContiguous(const A *p, std::size_t n) {
+    std::size_t j{0};
+    if (n >= 2 * reductionLanes) {
+      Type lanes[reductionLanes];
+      for (std::size_t k{0}; k < reductionLanes; ++k) {
+        lanes[k] = MaxOrMinIdentity<CAT, KIND, IS_MAXVAL>::Value();
+      }
+      for (; j + reductionLanes <= n; j += reductionLanes) {
+        for (std::size_t k{0}; k < reductionLanes; ++k) {
+          if constexpr (IS_MAXVAL) {
+            lanes[k] = p[j + k] > lanes[k] ? p[j + k] : lanes[k];
+          } else {
+            lanes[k] = p[j + k] < lanes[k] ? p[j + k] : lanes[k];
+          }
+        }
+      }
+      for (std::size_t k{0}; k < reductionLanes; ++k) {
+        Accumulate(lanes[k]);
+      }
+    }
+    for (; j < n; ++j) {
+      Accumulate(p[j]);
+    }
+  }
 
 private:
   const Descriptor &array_;
@@ -461,13 +461,14 @@ DataEdit FormatControl<CONTEXT>::GetNextDataEdit(
   }
   edit.modes = context.mutableModes();
 
-  // Handle repeated nonparenthesized edit descriptors
+  // Handle repeated nonparenthesized edit descriptors; a repeat count
+  // that fits within maxRepeat is returned all at once
   if (repeat > maxRepeat) {
     stack_[height_].start = start; // after repeat count
     stack_[height_].remaining = repeat; // full count
     ++height_;
   }
-  edit.repeat = std::min(1, maxRepeat); // 0 if maxRepeat==0
+  edit.repeat = std::min(repeat, maxRepeat); // 0 if maxRepeat==0
   if (height_ > 1) { // Subtle: stack_[0].start doesn't necessarily point to '('
     int start{stack_[height_ - 1].start};
     if (format_[start] != '(') {
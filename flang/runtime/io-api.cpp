@@ -323,6 +323,42 @@ Cookie IONAME(BeginClose)(
   }
 }
 
+// Asynchronous transfers are performed immediately; their completion
+// statuses are retained until claimed by WAIT.
+AsynchronousId IONAME(BeginAsynchronousOutput)(ExternalUnit unitNumber,
+    std::int64_t rec, const char *data, std::size_t bytes,
+    const char *sourceFile, int sourceLine) {
+  Terminator terminator{sourceFile, sourceLine};
+  ExternalFileUnit &unit{
+      ExternalFileUnit::LookUpOrCrash(unitNumber, terminator)};
+  return unit.AsynchronousOutput(rec, data, bytes, terminator);
+}
+
+AsynchronousId IONAME(BeginAsynchronousInput)(ExternalUnit unitNumber,
+    std::int64_t rec, char *data, std::size_t bytes, const char *sourceFile,
+    int sourceLine) {
+  Terminator terminator{sourceFile, sourceLine};
+  ExternalFileUnit &unit{
+      ExternalFileUnit::LookUpOrCrash(unitNumber, terminator)};
+  return unit.AsynchronousInput(rec, data, bytes, terminator);
+}
+
+Cookie IONAME(BeginWait)(ExternalUnit unitNumber, AsynchronousId id) {
+  Terminator terminator;
+  ExternalFileUnit &unit{
+      ExternalFileUnit::LookUpOrCrash(unitNumber, terminator)};
+  return &unit.BeginIoStatement<ExternalMiscIoStatementState>(
+      unit, ExternalMiscIoStatementState::Wait, nullptr, 0, id);
+}
+
+Cookie IONAME(BeginWaitAll)(ExternalUnit unitNumber) {
+  Terminator terminator;
+  ExternalFileUnit &unit{
+      ExternalFileUnit::LookUpOrCrash(unitNumber, terminator)};
+  return &unit.BeginIoStatement<ExternalMiscIoStatementState>(
+      unit, ExternalMiscIoStatementState::WaitAll);
+}
+
 Cookie IONAME(BeginFlush)(
     ExternalUnit unitNumber, const char *sourceFile, int sourceLine) {
   Terminator terminator{sourceFile, sourceLine};
@@ -480,12 +480,18 @@ ExternalFileUnit *IoStatementState::GetExternalFileUnit() const {
 }
 
 bool IoStatementState::EmitRepeated(char ch, std::size_t n) {
+  // Emit in chunks rather than a character at a time; field padding
+  // and '*' fill are emitted for nearly every output item.
+  char chunk[64];
+  std::memset(chunk, ch, std::min(n, sizeof chunk));
   return std::visit(
-      [=](auto &x) {
-        for (std::size_t j{0}; j < n; ++j) {
-          if (!x.get().Emit(&ch, 1)) {
+      [&](auto &x) {
+        while (n > 0) {
+          std::size_t part{std::min(n, sizeof chunk)};
+          if (!x.get().Emit(chunk, part)) {
             return false;
           }
+          n -= part;
         }
         return true;
       },
@@ -815,6 +821,12 @@ int ExternalMiscIoStatementState::EndIoStatement() {
   case Rewind:
     ext.Rewind(*this);
     break;
+  case Wait:
+    ext.Wait(id_, *this);
+    break;
+  case WaitAll:
+    ext.WaitAll(*this);
+    break;
   }
   return ExternalIoStatementBase::EndIoStatement();
 }
@@ -1027,7 +1039,7 @@ bool InquireUnitState::Inquire(InquiryKeywordHash inquiry, bool &result) {
     result = unit().IsConnected();
     return true;
   case HashInquiryKeyword("PENDING"):
-    result = false; // asynchronous I/O is not implemented
+    result = false; // asynchronous transfers complete immediately
     return true;
   default:
     BadInquiryKeywordHashCrash(inquiry);
@@ -1039,7 +1051,7 @@ bool InquireUnitState::Inquire(
     InquiryKeywordHash inquiry, std::int64_t, bool &result) {
   switch (inquiry) {
   case HashInquiryKeyword("PENDING"):
-    result = false; // asynchronous I/O is not implemented
+    result = false; // asynchronous transfers complete immediately
     return true;
   default:
     BadInquiryKeywordHashCrash(inquiry);
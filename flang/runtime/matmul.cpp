@@ -17,15 +17,22 @@
 // of logical kinds (16).  A single template undergoes many instantiations
 // to cover all of the valid possibilities.
 //
-// Places where BLAS routines could be called are marked as TODO items.
+// Contiguous REAL and COMPLEX cases call BLAS routines when the runtime
+// is configured with FLANG_RUNTIME_USE_BLAS.
 
 #include "flang/Runtime/matmul.h"
+#include "config.h"
 #include "terminator.h"
 #include "tools.h"
 #include "flang/Runtime/c-or-cpp.h"
 #include "flang/Runtime/cpp-type.h"
 #include "flang/Runtime/descriptor.h"
+#include <algorithm>
 #include <cstring>
+#if FLANG_RUNTIME_USE_BLAS
+#include <cblas.h>
+#include <limits>
+#endif
 
 namespace Fortran::runtime {
 
@@ -69,23 +76,69 @@ private:
 //    DO 2 J = 1, NCOLS
 //     DO 2 I = 1, NROWS
 //   2  RES(I,J) = RES(I,J) + X(I,K)*Y(K,J) ! loop-invariant last term
+// The I and K loops are then blocked so that a block of X is reused from
+// the cache for every column of the result, and the K loop is unrolled so
+// that each element of the result is loaded and stored once per four
+// columns of X.  Each element of the result still accumulates its terms
+// in order of K.
+template <typename XT, typename YT, typename ResultType>
+inline void MatrixTimesMatrixBlock(ResultType *RESTRICT product,
+    SubscriptValue rows, SubscriptValue iBlock, SubscriptValue cols,
+    const XT *RESTRICT x, const YT *RESTRICT y, SubscriptValue n,
+    SubscriptValue kBlock) {
+  for (SubscriptValue j{0}; j < cols; ++j) {
+    ResultType *RESTRICT p{product + j * rows};
+    const YT *RESTRICT yp{y + j * n};
+    SubscriptValue k{0};
+    for (; k + 4 <= kBlock; k += 4) {
+      const XT *RESTRICT x0{x + k * rows};
+      const XT *RESTRICT x1{x0 + rows};
+      const XT *RESTRICT x2{x1 + rows};
+      const XT *RESTRICT x3{x2 + rows};
+      auto y0{static_cast<ResultType>(yp[k])};
+      auto y1{static_cast<ResultType>(yp[k + 1])};
+      auto y2{static_cast<ResultType>(yp[k + 2])};
+      auto y3{static_cast<ResultType>(yp[k + 3])};
+      for (SubscriptValue i{0}; i < iBlock; ++i) {
+        ResultType sum{p[i]};
+        sum += static_cast<ResultType>(x0[i]) * y0;
+        sum += static_cast<ResultType>(x1[i]) * y1;
+        sum += static_cast<ResultType>(x2[i]) * y2;
+        sum += static_cast<ResultType>(x3[i]) * y3;
+        p[i] = sum;
+      }
+    }
+    for (; k < kBlock; ++k) {
+      const XT *RESTRICT xp{x + k * rows};
+      auto yv{static_cast<ResultType>(yp[k])};
+      for (SubscriptValue i{0}; i < iBlock; ++i) {
+        p[i] += static_cast<ResultType>(xp[i]) * yv;
+      }
+    }
+  }
+}
+
+// Sizes of the blocks of MATMUL: a block of a column of the result should
+// stay in the L1 cache, and a block of X in the L2 cache.
+static constexpr std::size_t matmulResultBlockBytes{2 * 1024};
+static constexpr std::size_t matmulXBlockBytes{128 * 1024};
+
 template <TypeCategory RCAT, int RKIND, typename XT, typename YT>
 inline void MatrixTimesMatrix(CppTypeFor<RCAT, RKIND> *RESTRICT product,
     SubscriptValue rows, SubscriptValue cols, const XT *RESTRICT x,
     const YT *RESTRICT y, SubscriptValue n) {
   using ResultType = CppTypeFor<RCAT, RKIND>;
   std::memset(product, 0, rows * cols * sizeof *product);
-  const XT *RESTRICT xp0{x};
-  for (SubscriptValue k{0}; k < n; ++k) {
-    ResultType *RESTRICT p{product};
-    for (SubscriptValue j{0}; j < cols; ++j) {
-      const XT *RESTRICT xp{xp0};
-      auto yv{static_cast<ResultType>(y[k + j * n])};
-      for (SubscriptValue i{0}; i < rows; ++i) {
-        *p++ += static_cast<ResultType>(*xp++) * yv;
-      }
+  constexpr SubscriptValue iBlock{std::max<SubscriptValue>(
+      matmulResultBlockBytes / sizeof(ResultType), 4)};
+  constexpr SubscriptValue kBlock{
+      std::max<SubscriptValue>(matmulXBlockBytes / (iBlock * sizeof(XT)), 4)};
+  for (SubscriptValue i0{0}; i0 < rows; i0 += iBlock) {
+    for (SubscriptValue k0{0}; k0 < n; k0 += kBlock) {
+      MatrixTimesMatrixBlock<XT, YT, ResultType>(product + i0, rows,
+          std::min(iBlock, rows - i0), cols, x + i0 + k0 * rows, y + k0, n,
+          std::min(kBlock, n - k0));
     }
-    xp0 += rows;
   }
 }
 
@@ -103,18 +156,18 @@ inline void MatrixTimesMatrix(CppTypeFor<RCAT, RKIND> *RESTRICT product,
 //   DO 2 K = 1, N
 //    DO 2 J = 1, NROWS
 //   2 RES(J) = RES(J) + X(J,K)*Y(K)
+// The J loop is blocked as for matrix*matrix multiplication above.
 template <TypeCategory RCAT, int RKIND, typename XT, typename YT>
 inline void MatrixTimesVector(CppTypeFor<RCAT, RKIND> *RESTRICT product,
     SubscriptValue rows, SubscriptValue n, const XT *RESTRICT x,
     const YT *RESTRICT y) {
   using ResultType = CppTypeFor<RCAT, RKIND>;
   std::memset(product, 0, rows * sizeof *product);
-  for (SubscriptValue k{0}; k < n; ++k) {
-    ResultType *RESTRICT p{product};
-    auto yv{static_cast<ResultType>(*y++)};
-    for (SubscriptValue j{0}; j < rows; ++j) {
-      *p++ += static_cast<ResultType>(*x++) * yv;
-    }
+  constexpr SubscriptValue iBlock{std::max<SubscriptValue>(
+      matmulResultBlockBytes / sizeof(ResultType), 4)};
+  for (SubscriptValue i0{0}; i0 < rows; i0 += iBlock) {
+    MatrixTimesMatrixBlock<XT, YT, ResultType>(product + i0, rows,
+        std::min(iBlock, rows - i0), 1, x + i0, y, n, n);
   }
 }
 
@@ -125,30 +178,104 @@ inline void MatrixTimesVector(CppTypeFor<RCAT, RKIND> *RESTRICT product,
 //    RES(J) = 0
 //    DO 1 K = 1, N
 //   1 RES(J) = RES(J) + X(K)*Y(K,J)
-// With loop distribution and transposition to avoid the inner
-// sum reduction and one non-unit stride (the other remains):
-//   DO 1 J = 1, NCOLS
-//   1 RES(J) = 0
-//   DO 2 K = 1, N
-//    DO 2 J = 1, NCOLS
-//   2 RES(J) = RES(J) + X(K)*Y(K,J)
+// The inner sum reduction runs down a column of Y with unit stride.
 template <TypeCategory RCAT, int RKIND, typename XT, typename YT>
 inline void VectorTimesMatrix(CppTypeFor<RCAT, RKIND> *RESTRICT product,
     SubscriptValue n, SubscriptValue cols, const XT *RESTRICT x,
     const YT *RESTRICT y) {
   using ResultType = CppTypeFor<RCAT, RKIND>;
-  std::memset(product, 0, cols * sizeof *product);
-  for (SubscriptValue k{0}; k < n; ++k) {
-    ResultType *RESTRICT p{product};
-    auto xv{static_cast<ResultType>(*x++)};
-    const YT *RESTRICT yp{&y[k]};
-    for (SubscriptValue j{0}; j < cols; ++j) {
-      *p++ += xv * static_cast<ResultType>(*yp);
-      yp += n;
+  for (SubscriptValue j{0}; j < cols; ++j) {
+    ResultType sum{};
+    for (SubscriptValue k{0}; k < n; ++k) {
+      sum += static_cast<ResultType>(x[k]) * static_cast<ResultType>(y[k]);
+    }
+    product[j] = sum;
+    y += n;
+  }
+}
+
+#if FLANG_RUNTIME_USE_BLAS
+// BLAS routines take int extents
+static inline bool FitBlasInt(SubscriptValue a, SubscriptValue b) {
+  return a <= std::numeric_limits<int>::max() &&
+      b <= std::numeric_limits<int>::max();
+}
+
+// Calls xGEMM for matrices of the same REAL or COMPLEX type as the result;
+// returns false for other types.
+template <TypeCategory RCAT, int RKIND, typename XT, typename YT>
+inline bool CallBlasGemm(CppTypeFor<RCAT, RKIND> *product, SubscriptValue rows,
+    SubscriptValue cols, const XT *x, const YT *y, SubscriptValue n) {
+  using ResultType = CppTypeFor<RCAT, RKIND>;
+  if constexpr (std::is_same_v<XT, YT> && std::is_same_v<XT, ResultType>) {
+    if (!FitBlasInt(rows, cols) || !FitBlasInt(n, 1)) {
+      return false;
+    }
+    int m{static_cast<int>(rows)}, nc{static_cast<int>(cols)},
+        k{static_cast<int>(n)};
+    // Leading dimensions must be at least 1
+    int ldx{std::max(m, 1)}, ldy{std::max(k, 1)};
+    if constexpr (std::is_same_v<XT, float>) {
+      cblas_sgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, m, nc, k, 1.0f, x,
+          ldx, y, ldy, 0.0f, product, ldx);
+      return true;
+    } else if constexpr (std::is_same_v<XT, double>) {
+      cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, m, nc, k, 1.0, x,
+          ldx, y, ldy, 0.0, product, ldx);
+      return true;
+    } else if constexpr (std::is_same_v<XT, std::complex<float>>) {
+      const XT one{1.0f}, zero{0.0f};
+      cblas_cgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, m, nc, k, &one, x,
+          ldx, y, ldy, &zero, product, ldx);
+      return true;
+    } else if constexpr (std::is_same_v<XT, std::complex<double>>) {
+      const XT one{1.0}, zero{0.0};
+      cblas_zgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, m, nc, k, &one, x,
+          ldx, y, ldy, &zero, product, ldx);
+      return true;
     }
   }
+  return false;
 }
 
+// Calls xGEMV to multiply a rows x n matrix, or its transpose, by a vector
+// of the same REAL or COMPLEX type as the result; returns false for other
+// types.
+template <TypeCategory RCAT, int RKIND, typename MT, typename VT>
+inline bool CallBlasGemv(CppTypeFor<RCAT, RKIND> *product, bool transpose,
+    SubscriptValue rows, SubscriptValue n, const MT *matrix, const VT *vector) {
+  using ResultType = CppTypeFor<RCAT, RKIND>;
+  if constexpr (std::is_same_v<MT, VT> && std::is_same_v<MT, ResultType>) {
+    if (!FitBlasInt(rows, n)) {
+      return false;
+    }
+    int m{static_cast<int>(rows)}, nc{static_cast<int>(n)};
+    int ld{std::max(m, 1)};
+    auto trans{transpose ? CblasTrans : CblasNoTrans};
+    if constexpr (std::is_same_v<MT, float>) {
+      cblas_sgemv(CblasColMajor, trans, m, nc, 1.0f, matrix, ld, vector, 1,
+          0.0f, product, 1);
+      return true;
+    } else if constexpr (std::is_same_v<MT, double>) {
+      cblas_dgemv(CblasColMajor, trans, m, nc, 1.0, matrix, ld, vector, 1, 0.0,
+          product, 1);
+      return true;
+    } else if constexpr (std::is_same_v<MT, std::complex<float>>) {
+      const MT one{1.0f}, zero{0.0f};
+      cblas_cgemv(CblasColMajor, trans, m, nc, &one, matrix, ld, vector, 1,
+          &zero, product, 1);
+      return true;
+    } else if constexpr (std::is_same_v<MT, std::complex<double>>) {
+      const MT one{1.0}, zero{0.0};
+      cblas_zgemv(CblasColMajor, trans, m, nc, &one, matrix, ld, vector, 1,
+          &zero, product, 1);
+      return true;
+    }
+  }
+  return false;
+}
+#endif // FLANG_RUNTIME_USE_BLAS
+
 // Implements an instance of MATMUL for given argument types.
 template <bool IS_ALLOCATING, TypeCategory RCAT, int RKIND, typename XT,
     typename YT>
@@ -196,49 +323,38 @@ static inline void DoMatmul(
         (IS_ALLOCATING || result.IsContiguous())) {
       // Contiguous numeric matrices
       if (resRank == 2) { // M*M -> M
-        if (std::is_same_v<XT, YT>) {
-          if constexpr (std::is_same_v<XT, float>) {
-            // TODO: call BLAS-3 SGEMM
-          } else if constexpr (std::is_same_v<XT, double>) {
-            // TODO: call BLAS-3 DGEMM
-          } else if constexpr (std::is_same_v<XT, std::complex<float>>) {
-            // TODO: call BLAS-3 CGEMM
-          } else if constexpr (std::is_same_v<XT, std::complex<double>>) {
-            // TODO: call BLAS-3 ZGEMM
-          }
+#if FLANG_RUNTIME_USE_BLAS
+        if (CallBlasGemm<RCAT, RKIND, XT, YT>(
+                result.template OffsetElement<WriteResult>(), extent[0],
+                extent[1], x.OffsetElement<XT>(), y.OffsetElement<YT>(), n)) {
+          return;
         }
+#endif
         MatrixTimesMatrix<RCAT, RKIND, XT, YT>(
             result.template OffsetElement<WriteResult>(), extent[0], extent[1],
             x.OffsetElement<XT>(), y.OffsetElement<YT>(), n);
         return;
       } else if (xRank == 2) { // M*V -> V
-        if (std::is_same_v<XT, YT>) {
-          if constexpr (std::is_same_v<XT, float>) {
-            // TODO: call BLAS-2 SGEMV(x,y)
-          } else if constexpr (std::is_same_v<XT, double>) {
-            // TODO: call BLAS-2 DGEMV(x,y)
-          } else if constexpr (std::is_same_v<XT, std::complex<float>>) {
-            // TODO: call BLAS-2 CGEMV(x,y)
-          } else if constexpr (std::is_same_v<XT, std::complex<double>>) {
-            // TODO: call BLAS-2 ZGEMV(x,y)
-          }
+#if FLANG_RUNTIME_USE_BLAS
+        if (CallBlasGemv<RCAT, RKIND, XT, YT>(
+                result.template OffsetElement<WriteResult>(), false, extent[0],
+                n, x.OffsetElement<XT>(), y.OffsetElement<YT>())) {
+          return;
         }
+#endif
         MatrixTimesVector<RCAT, RKIND, XT, YT>(
             result.template OffsetElement<WriteResult>(), extent[0], n,
             x.OffsetElement<XT>(), y.OffsetElement<YT>());
         return;
       } else { // V*M -> V
-        if (std::is_same_v<XT, YT>) {
-          if constexpr (std::is_same_v<XT, float>) {
-            // TODO: call BLAS-2 SGEMV(y,x)
-          } else if constexpr (std::is_same_v<XT, double>) {
-            // TODO: call BLAS-2 DGEMV(y,x)
-          } else if constexpr (std::is_same_v<XT, std::complex<float>>) {
-            // TODO: call BLAS-2 CGEMV(y,x)
-          } else if constexpr (std::is_same_v<XT, std::complex<double>>) {
-            // TODO: call BLAS-2 ZGEMV(y,x)
-          }
+#if FLANG_RUNTIME_USE_BLAS
+        // Y is transposed to multiply X as a column vector
+        if (CallBlasGemv<RCAT, RKIND, YT, XT>(
+                result.template OffsetElement<WriteResult>(), true, n,
+                extent[0], y.OffsetElement<YT>(), x.OffsetElement<XT>())) {
+          return;
         }
+#endif
         VectorTimesMatrix<RCAT, RKIND, XT, YT>(
             result.template OffsetElement<WriteResult>(), n, extent[0],
             x.OffsetElement<XT>(), y.OffsetElement<YT>());
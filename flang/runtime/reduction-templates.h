@@ -25,6 +25,8 @@
 #include "tools.h"
 #include "flang/Runtime/cpp-type.h"
 #include "flang/Runtime/descriptor.h"
+#include <type_traits>
+#include <utility>
 
 namespace Fortran::runtime {
 
@@ -36,6 +38,21 @@ namespace Fortran::runtime {
 // array and does something with a scalar element, and a GetResult()
 // member function that copies a final result into its destination.
 
+// Accumulators may also support an AccumulateContiguous() member function
+// template that reduces a run of contiguous elements at once.  It is used
+// for unmasked contiguous data of any rank and should produce the same
+// result as AccumulateAt() applied to each element, but the accumulator
+// is free to keep several partial results in flight so that the loop can
+// be vectorized.
+template <typename ACCUMULATOR, typename TYPE, typename = void>
+struct HasAccumulateContiguous : std::false_type {};
+template <typename ACCUMULATOR, typename TYPE>
+struct HasAccumulateContiguous<ACCUMULATOR, TYPE,
+    std::void_t<decltype(std::declval<ACCUMULATOR &>()
+                             .template AccumulateContiguous<TYPE>(
+                                 std::declval<const TYPE *>(), std::size_t{}))>>
+    : std::true_type {};
+
 // Total reduction of the array argument to a scalar (or to a vector in the
 // cases of FINDLOC, MAXLOC, & MINLOC).  These are the cases without DIM= or
 // cases where the argument has rank 1 and DIM=, if present, must be 1.
@@ -67,6 +84,13 @@ inline void DoTotalReduction(const Descriptor &x, int dim,
     }
   }
   // No MASK=, or scalar MASK=.TRUE.
+  if constexpr (HasAccumulateContiguous<ACCUMULATOR, TYPE>::value) {
+    if (x.IsContiguous()) {
+      accumulator.template AccumulateContiguous<TYPE>(
+          x.OffsetElement<TYPE>(), x.Elements());
+      return;
+    }
+  }
   for (auto elements{x.Elements()}; elements--; x.IncrementSubscripts(xAt)) {
     if (!accumulator.template AccumulateAt<TYPE>(xAt)) {
       break; // cut short, result is known
@@ -117,6 +141,18 @@ inline void ReduceDimToScalar(const Descriptor &x, int zeroBasedDim,
   SubscriptValue xAt[maxRank];
   GetExpandedSubscripts(xAt, x, zeroBasedDim, subscripts);
   const auto &dim{x.GetDimension(zeroBasedDim)};
+  if constexpr (HasAccumulateContiguous<ACCUMULATOR, TYPE>::value) {
+    if (dim.ByteStride() == static_cast<SubscriptValue>(sizeof(TYPE))) {
+      accumulator.template AccumulateContiguous<TYPE>(
+          x.Element<TYPE>(xAt), dim.Extent());
+#ifdef _MSC_VER // work around MSVC spurious error
+      accumulator.GetResult(result, zeroBasedDim);
+#else
+      accumulator.template GetResult(result, zeroBasedDim);
+#endif
+      return;
+    }
+  }
   SubscriptValue at{dim.LowerBound()};
   for (auto n{dim.Extent()}; n-- > 0; ++at) {
     xAt[zeroBasedDim] = at;
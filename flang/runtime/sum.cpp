@@ -31,6 +31,13 @@ public:
     sum_ += *array_.Element<A>(at);
     return true;
   }
+  template <typename A> void AccumulateContiguous(const A *p, std::size_t n) {
+    INTERMEDIATE sum{0};
+    for (std::size_t j{0}; j < n; ++j) {
+      sum += p[j];
+    }
+    sum_ += sum;
+  }
 
 private:
   const Descriptor &array_;
@@ -47,7 +54,7 @@ public:
   }
   template <typename A> bool Accumulate(A x) {
     // Kahan summation
-    auto next{x + correction_};
+    auto next{x - correction_};
     auto oldSum{sum_};
     sum_ += next;
     correction_ = (sum_ - oldSum) - next; // algebraically zero
@@ -56,6 +63,29 @@ public:
   template <typename A> bool AccumulateAt(const SubscriptValue at[]) {
     return Accumulate(*array_.Element<A>(at));
   }
+  // Kahan summation on independent lanes, whose sums and pending
+  // corrections are then accumulated
+  template <typename A> void AccumulateContiguous(const A *p, std::size_t n) {
+    std::size_t j{0};
+    if (n >= 2 * reductionLanes) {
+      INTERMEDIATE sums[reductionLanes]{}, corrections[reductionLanes]{};
+      for (; j + reductionLanes <= n; j += reductionLanes) {
+        for (std::size_t k{0}; k < reductionLanes; ++k) {
+          INTERMEDIATE next{p[j + k] - corrections[k]};
+          INTERMEDIATE oldSum{sums[k]};
+          sums[k] += next;
+          corrections[k] = (sums[k] - oldSum) - next;
+        }
+      }
+      for (std::size_t k{0}; k < reductionLanes; ++k) {
+        Accumulate(sums[k]);
+        Accumulate(-corrections[k]);
+      }
+    }
+    for (; j < n; ++j) {
+      Accumulate(p[j]);
+    }
+  }
 
 private:
   const Descriptor &array_;
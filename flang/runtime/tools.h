@@ -341,5 +341,10 @@ using AccumulationType = CppTypeFor<CAT,
         ? std::max(KIND, static_cast<int>(sizeof(double)))
         : KIND>;
 
+// Loops over contiguous data that reduce floating-point values keep this
+// many independent partial results, since the compiler may not reassociate
+// a single one to vectorize the loop.
+static constexpr std::size_t reductionLanes{8};
+
 } // namespace Fortran::runtime
 #endif // FORTRAN_RUNTIME_TOOLS_H_
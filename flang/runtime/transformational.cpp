@@ -22,6 +22,7 @@
 #include "tools.h"
 #include "flang/Runtime/descriptor.h"
 #include <algorithm>
+#include <cstring>
 
 namespace Fortran::runtime {
 
@@ -129,6 +130,33 @@ static inline std::size_t AllocateResult(Descriptor &result,
   return elementLen;
 }
 
+// Copies the elements of a matrix with arbitrary strides into its
+// contiguous transpose in square tiles, so that the cache lines that are
+// read and those that are written are both reused within a tile.
+// ELEMENT_BYTES is zero when the element size is not a small power of two.
+template <std::size_t ELEMENT_BYTES>
+static void TransposeTiles(char *result, const char *matrix,
+    SubscriptValue rows, SubscriptValue cols, SubscriptValue rowByteStride,
+    SubscriptValue colByteStride, std::size_t elementBytes) {
+  static constexpr SubscriptValue tile{16};
+  const std::size_t bytes{ELEMENT_BYTES ? ELEMENT_BYTES : elementBytes};
+  for (SubscriptValue i0{0}; i0 < rows; i0 += tile) {
+    SubscriptValue i1{std::min(i0 + tile, rows)};
+    for (SubscriptValue j0{0}; j0 < cols; j0 += tile) {
+      SubscriptValue j1{std::min(j0 + tile, cols)};
+      for (SubscriptValue j{j0}; j < j1; ++j) {
+        const char *from{matrix + i0 * rowByteStride + j * colByteStride};
+        char *to{result + (j + i0 * cols) * bytes};
+        for (SubscriptValue i{i0}; i < i1; ++i) {
+          std::memcpy(to, from, bytes);
+          from += rowByteStride;
+          to += cols * bytes;
+        }
+      }
+    }
+  }
+}
+
 extern "C" {
 
 // CSHIFT where rank of ARRAY argument > 1
@@ -479,7 +507,44 @@ void RTNAME(Transpose)(Descriptor &result, const Descriptor &matrix,
   RUNTIME_CHECK(terminator, matrix.rank() == 2);
   SubscriptValue extent[2]{
       matrix.GetDimension(1).Extent(), matrix.GetDimension(0).Extent()};
-  AllocateResult(result, matrix, 2, extent, terminator, "TRANSPOSE");
+  std::size_t elementBytes{
+      AllocateResult(result, matrix, 2, extent, terminator, "TRANSPOSE")};
+  const DescriptorAddendum *addendum{result.Addendum()};
+  if (!addendum || !addendum->derivedType()) {
+    // Intrinsic types need no deep copies
+    char *to{result.OffsetElement<char>()};
+    const char *from{matrix.OffsetElement<char>()};
+    SubscriptValue rows{extent[1]}, cols{extent[0]};
+    SubscriptValue rowByteStride{matrix.GetDimension(0).ByteStride()};
+    SubscriptValue colByteStride{matrix.GetDimension(1).ByteStride()};
+    switch (elementBytes) {
+    case 1:
+      TransposeTiles<1>(
+          to, from, rows, cols, rowByteStride, colByteStride, elementBytes);
+      break;
+    case 2:
+      TransposeTiles<2>(
+          to, from, rows, cols, rowByteStride, colByteStride, elementBytes);
+      break;
+    case 4:
+      TransposeTiles<4>(
+          to, from, rows, cols, rowByteStride, colByteStride, elementBytes);
+      break;
+    case 8:
+      TransposeTiles<8>(
+          to, from, rows, cols, rowByteStride, colByteStride, elementBytes);
+      break;
+    case 16:
+      TransposeTiles<16>(
+          to, from, rows, cols, rowByteStride, colByteStride, elementBytes);
+      break;
+    default:
+      TransposeTiles<0>(
+          to, from, rows, cols, rowByteStride, colByteStride, elementBytes);
+      break;
+    }
+    return;
+  }
   SubscriptValue resultAt[2]{1, 1};
   SubscriptValue matrixLB[2];
   matrix.GetLowerBounds(matrixLB);
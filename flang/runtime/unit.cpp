@@ -608,6 +608,22 @@ void ExternalFileUnit::Rewind(IoErrorHandler &handler) {
   }
 }
 
+int ExternalFileUnit::AsynchronousOutput(std::int64_t rec, const char *data,
+    std::size_t bytes, const Terminator &terminator) {
+  CriticalSection critical{lock_};
+  IoErrorHandler handler{terminator};
+  auto at{BeginAsynchronousTransfer(rec, bytes, handler)};
+  return WriteAsynchronously(at, data, bytes, handler);
+}
+
+int ExternalFileUnit::AsynchronousInput(std::int64_t rec, char *data,
+    std::size_t bytes, const Terminator &terminator) {
+  CriticalSection critical{lock_};
+  IoErrorHandler handler{terminator};
+  auto at{BeginAsynchronousTransfer(rec, bytes, handler)};
+  return ReadAsynchronously(at, data, bytes, handler);
+}
+
 void ExternalFileUnit::EndIoStatement() {
   io_.reset();
   u_.emplace<std::monostate>();
@@ -656,6 +672,38 @@ void ExternalFileUnit::BeginSequentialVariableUnformattedInputRecord(
   positionInRecord = sizeof header;
 }
 
+// Validates an asynchronous block transfer and returns its file offset.
+// There is no I/O statement to which an error could be reported, so
+// errors here are fatal; errors in the transfer itself are reported
+// by the WAIT that claims it.
+std::int64_t ExternalFileUnit::BeginAsynchronousTransfer(
+    std::int64_t rec, std::size_t bytes, IoErrorHandler &handler) {
+  if (!mayAsynchronous()) {
+    handler.Crash("Asynchronous transfer on unit %d, which was not opened "
+                  "with ASYNCHRONOUS='YES'",
+        unitNumber());
+  } else if (access != Access::Direct || !openRecl ||
+      !isUnformatted.value_or(false)) {
+    handler.Crash("Asynchronous transfer on unit %d, which is not connected "
+                  "for unformatted direct access",
+        unitNumber());
+  } else if (rec < 1) {
+    handler.Crash("Asynchronous transfer on unit %d: REC=%jd is invalid",
+        unitNumber(), static_cast<std::intmax_t>(rec));
+  } else if (static_cast<std::int64_t>(bytes) > *openRecl) {
+    handler.Crash("Asynchronous transfer on unit %d: %zd bytes will not fit "
+                  "in a record of %jd bytes",
+        unitNumber(), bytes, static_cast<std::intmax_t>(*openRecl));
+  } else if (swapEndianness_) {
+    handler.Crash("Asynchronous transfer on unit %d: the data cannot be "
+                  "converted to the unit's CONVERT= byte order",
+        unitNumber());
+  }
+  // Synchronous transfers on this unit must see this one, and vice versa.
+  Forget(handler);
+  return (rec - 1) * *openRecl;
+}
+
 void ExternalFileUnit::BeginSequentialVariableFormattedInputRecord(
     IoErrorHandler &handler) {
   if (this == defaultInput) {
@@ -90,6 +90,14 @@ public:
   void Endfile(IoErrorHandler &);
   void Rewind(IoErrorHandler &);
   void EndIoStatement();
+
+  // Unformatted direct access block transfers for ASYNCHRONOUS='YES'
+  // units.  Each returns an ID whose status is claimed by a later WAIT.
+  int AsynchronousOutput(
+      std::int64_t rec, const char *, std::size_t, const Terminator &);
+  int AsynchronousInput(
+      std::int64_t rec, char *, std::size_t, const Terminator &);
+
   void SetPosition(std::int64_t pos) {
     frameOffsetInFile_ = pos;
     recordOffsetInFrame_ = 0;
@@ -108,6 +116,8 @@ private:
   void BackspaceFixedRecord(IoErrorHandler &);
   void BackspaceVariableUnformattedRecord(IoErrorHandler &);
   void BackspaceVariableFormattedRecord(IoErrorHandler &);
+  std::int64_t BeginAsynchronousTransfer(
+      std::int64_t rec, std::size_t, IoErrorHandler &);
   bool SetSequentialVariableFormattedRecordLength();
   void DoImpliedEndfile(IoErrorHandler &);
   void DoEndfile(IoErrorHandler &);
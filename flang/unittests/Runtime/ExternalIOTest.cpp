@@ -149,6 +149,96 @@ TEST(ExternalIOTests, TestDirectUnformattedSwapped) {
       << "EndIoStatement() for Close";
 }
 
+TEST(ExternalIOTests, TestDirectUnformattedAsynchronous) {
+  // OPEN(NEWUNIT=unit,ACCESS='DIRECT',ACTION='READWRITE',&
+  //   FORM='UNFORMATTED',RECL=8,STATUS='SCRATCH',ASYNCHRONOUS='YES')
+  Cookie io{IONAME(BeginOpenNewUnit)(__FILE__, __LINE__)};
+  ASSERT_TRUE(IONAME(SetAccess)(io, "DIRECT", 6)) << "SetAccess(DIRECT)";
+  ASSERT_TRUE(IONAME(SetAction)(io, "READWRITE", 9)) << "SetAction(READWRITE)";
+  ASSERT_TRUE(IONAME(SetForm)(io, "UNFORMATTED", 11)) << "SetForm(UNFORMATTED)";
+  ASSERT_TRUE(IONAME(SetAsynchronous)(io, "YES", 3)) << "SetAsynchronous(YES)";
+
+  std::int64_t buffer;
+  static constexpr std::size_t recl{sizeof buffer};
+  ASSERT_TRUE(IONAME(SetRecl)(io, recl)) << "SetRecl()";
+  ASSERT_TRUE(IONAME(SetStatus)(io, "SCRATCH", 7)) << "SetStatus(SCRATCH)";
+
+  int unit{-1};
+  ASSERT_TRUE(IONAME(GetNewUnit)(io, unit)) << "GetNewUnit()";
+  ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+      << "EndIoStatement() for OpenNewUnit";
+
+  // WRITE(UNIT=unit,REC=j,ASYNCHRONOUS='YES',ID=ids(j)) j
+  static constexpr int records{10};
+  std::int64_t out[records];
+  AsynchronousId ids[records];
+  for (int j{1}; j <= records; ++j) {
+    out[j - 1] = j;
+    ids[j - 1] = IONAME(BeginAsynchronousOutput)(unit, j,
+        reinterpret_cast<const char *>(&out[j - 1]), recl, __FILE__,
+        __LINE__);
+  }
+  for (int j{1}; j <= records; ++j) {
+    // WAIT(UNIT=unit,ID=ids(j))
+    io = IONAME(BeginWait)(unit, ids[j - 1]);
+    ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+        << "EndIoStatement() for Wait on record " << j;
+  }
+
+  // Synchronous READ(UNIT=unit,REC=j) sees the asynchronous WRITEs
+  for (int j{records}; j >= 1; --j) {
+    io = IONAME(BeginUnformattedInput)(unit, __FILE__, __LINE__);
+    ASSERT_TRUE(IONAME(SetRec)(io, j)) << "SetRec(" << j << ')';
+    ASSERT_TRUE(IONAME(InputUnformattedBlock)(
+        io, reinterpret_cast<char *>(&buffer), recl, recl))
+        << "InputUnformattedBlock()";
+    ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+        << "EndIoStatement() for InputUnformattedBlock";
+    ASSERT_EQ(buffer, j) << "Read back " << buffer
+                         << " from direct unformatted record " << j
+                         << ", expected " << j << '\n';
+  }
+
+  // Synchronous WRITE(UNIT=unit,REC=3) -3, then asynchronous READs
+  io = IONAME(BeginUnformattedOutput)(unit, __FILE__, __LINE__);
+  ASSERT_TRUE(IONAME(SetRec)(io, 3)) << "SetRec(3)";
+  buffer = -3;
+  ASSERT_TRUE(IONAME(OutputUnformattedBlock)(
+      io, reinterpret_cast<const char *>(&buffer), recl, recl))
+      << "OutputUnformattedBlock()";
+  ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+      << "EndIoStatement() for OutputUnformattedBlock";
+
+  std::int64_t in[records];
+  for (int j{1}; j <= records; ++j) {
+    // READ(UNIT=unit,REC=j,ASYNCHRONOUS='YES',ID=ids(j)) in(j)
+    ids[j - 1] = IONAME(BeginAsynchronousInput)(unit, j,
+        reinterpret_cast<char *>(&in[j - 1]), recl, __FILE__, __LINE__);
+  }
+  // WAIT(UNIT=unit)
+  io = IONAME(BeginWaitAll)(unit);
+  ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+      << "EndIoStatement() for WaitAll";
+  for (int j{1}; j <= records; ++j) {
+    ASSERT_EQ(in[j - 1], j == 3 ? -3 : j)
+        << "Asynchronous READ of direct unformatted record " << j;
+  }
+
+  // An asynchronous READ past the end of the file reports END at its WAIT
+  AsynchronousId past{IONAME(BeginAsynchronousInput)(unit, records + 1,
+      reinterpret_cast<char *>(&buffer), recl, __FILE__, __LINE__)};
+  io = IONAME(BeginWait)(unit, past);
+  IONAME(EnableHandlers)(io, true, false, true);
+  ASSERT_EQ(IONAME(EndIoStatement)(io), IostatEnd)
+      << "EndIoStatement() for Wait after asynchronous READ past EOF";
+
+  // CLOSE(UNIT=unit,STATUS='DELETE')
+  io = IONAME(BeginClose)(unit, __FILE__, __LINE__);
+  ASSERT_TRUE(IONAME(SetStatus)(io, "DELETE", 6)) << "SetStatus(DELETE)";
+  ASSERT_EQ(IONAME(EndIoStatement)(io), IostatOk)
+      << "EndIoStatement() for Close";
+}
+
 TEST(ExternalIOTests, TestSequentialFixedUnformatted) {
   // OPEN(NEWUNIT=unit,ACCESS='SEQUENTIAL',ACTION='READWRITE',&
   //   FORM='UNFORMATTED',RECL=8,STATUS='SCRATCH')
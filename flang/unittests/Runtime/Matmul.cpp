@@ -96,3 +96,68 @@ TEST(Matmul, Basic) {
   EXPECT_TRUE(
       static_cast<bool>(*result.ZeroBasedIndexedElement<std::uint16_t>(3)));
 }
+
+TEST(Matmul, LargeContiguous) {
+  // Large enough to span several blocks of the contiguous algorithms;
+  // small integral values keep every sum exact.
+  constexpr int rows{300}, n{70}, cols{130};
+  std::vector<double> xData(rows * n), yData(n * cols), vData(n), wData(rows);
+  for (int j{0}; j < rows * n; ++j) {
+    xData[j] = j % 7 - 3;
+  }
+  for (int j{0}; j < n * cols; ++j) {
+    yData[j] = j % 5 - 2;
+  }
+  for (int j{0}; j < n; ++j) {
+    vData[j] = j % 3 - 1;
+  }
+  for (int j{0}; j < rows; ++j) {
+    wData[j] = j % 4 - 2;
+  }
+  auto x{MakeArray<TypeCategory::Real, 8>(std::vector<int>{rows, n}, xData)};
+  auto y{MakeArray<TypeCategory::Real, 8>(std::vector<int>{n, cols}, yData)};
+  auto v{MakeArray<TypeCategory::Real, 8>(std::vector<int>{n}, vData)};
+  auto w{MakeArray<TypeCategory::Real, 8>(std::vector<int>{rows}, wData)};
+  StaticDescriptor<2, true> statDesc;
+  Descriptor &result{statDesc.descriptor()};
+
+  RTNAME(Matmul)(result, *x, *y, __FILE__, __LINE__);
+  ASSERT_EQ(result.rank(), 2);
+  ASSERT_EQ(result.GetDimension(0).Extent(), rows);
+  ASSERT_EQ(result.GetDimension(1).Extent(), cols);
+  for (int j{0}; j < cols; ++j) {
+    for (int i{0}; i < rows; ++i) {
+      double expect{0};
+      for (int k{0}; k < n; ++k) {
+        expect += xData[i + k * rows] * yData[k + j * n];
+      }
+      ASSERT_EQ(*result.ZeroBasedIndexedElement<double>(i + j * rows), expect)
+          << "at (" << i << ',' << j << ')';
+    }
+  }
+  result.Destroy();
+
+  RTNAME(Matmul)(result, *x, *v, __FILE__, __LINE__);
+  ASSERT_EQ(result.rank(), 1);
+  ASSERT_EQ(result.GetDimension(0).Extent(), rows);
+  for (int i{0}; i < rows; ++i) {
+    double expect{0};
+    for (int k{0}; k < n; ++k) {
+      expect += xData[i + k * rows] * vData[k];
+    }
+    ASSERT_EQ(*result.ZeroBasedIndexedElement<double>(i), expect) << i;
+  }
+  result.Destroy();
+
+  RTNAME(Matmul)(result, *w, *x, __FILE__, __LINE__);
+  ASSERT_EQ(result.rank(), 1);
+  ASSERT_EQ(result.GetDimension(0).Extent(), n);
+  for (int j{0}; j < n; ++j) {
+    double expect{0};
+    for (int k{0}; k < rows; ++k) {
+      expect += wData[k] * xData[k + j * rows];
+    }
+    ASSERT_EQ(*result.ZeroBasedIndexedElement<double>(j), expect) << j;
+  }
+  result.Destroy();
+}
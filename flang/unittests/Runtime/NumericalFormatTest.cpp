@@ -246,6 +246,52 @@ TEST(IOApiTests, DescriptorOutputTest) {
       << std::string{buffer, sizeof buffer} << "'";
 }
 
+TEST(IOApiTests, RepeatedEditDescriptorArrayOutputTest) {
+  // Repeated edit descriptors are applied to runs of array elements
+  static constexpr int rank{2};
+  static const SubscriptValue extent[]{2, 4}; // column-major
+  std::int32_t ints[]{1, 2, 3, 4, 5, 6, 7, 8};
+  double reals[]{0.5, -1.25, 2.0, 30.125, -0.75, 6.0, 7.5, 1e3};
+  StaticDescriptor<rank> intStatDesc, realStatDesc;
+  Descriptor &intDesc{intStatDesc.descriptor()};
+  Descriptor &realDesc{realStatDesc.descriptor()};
+  intDesc.Establish(TypeCategory::Integer, sizeof ints[0], ints, rank, extent);
+  realDesc.Establish(TypeCategory::Real, sizeof reals[0], reals, rank, extent);
+
+  using TestCaseTy = std::tuple<const char *, const Descriptor *, const char *>;
+  static const std::vector<TestCaseTy> testCases{
+      {"(8I3)", &intDesc, "  1  2  3  4  5  6  7  8"},
+      {"(I2,3I3,1X,2I2,2I4)", &intDesc, " 1  2  3  4  5 6   7   8"},
+      {"(20I3)", &intDesc, "  1  2  3  4  5  6  7  8"},
+      {"(3I2,'|',5I2)", &intDesc, " 1 2 3| 4 5 6 7 8"},
+      {"(4(1X,2I1))", &intDesc, " 12 34 56 78"},
+      {"(3F7.2,2(ES10.2),3F8.3)", &realDesc,
+          "   0.50  -1.25   2.00  3.01E+01 -7.50E-01   6.000   7.5001000.000"},
+  };
+
+  for (auto const &[format, desc, expect] : testCases) {
+    char buffer[80];
+    auto cookie{IONAME(BeginInternalFormattedOutput)(
+        buffer, sizeof buffer, format, std::strlen(format))};
+    EXPECT_TRUE(IONAME(OutputDescriptor)(cookie, *desc));
+    ASSERT_EQ(IONAME(EndIoStatement)(cookie), IostatOk)
+        << "'" << format << "' failed";
+    ASSERT_TRUE(
+        CompareFormattedStrings(expect, std::string{buffer, sizeof buffer}))
+        << "'" << format << "': expect '" << expect << "', got '"
+        << std::string{buffer, sizeof buffer} << "'";
+  }
+
+  // List-directed output of the whole array
+  char buffer[80];
+  auto cookie{IONAME(BeginInternalListOutput)(buffer, sizeof buffer)};
+  EXPECT_TRUE(IONAME(OutputDescriptor)(cookie, intDesc));
+  ASSERT_EQ(IONAME(EndIoStatement)(cookie), IostatOk);
+  ASSERT_TRUE(CompareFormattedStrings(
+      " 1 2 3 4 5 6 7 8", std::string{buffer, sizeof buffer}))
+      << "list-directed: got '" << std::string{buffer, sizeof buffer} << "'";
+}
+
 //------------------------------------------------------------------------------
 /// Tests for output formatting real values
 //------------------------------------------------------------------------------
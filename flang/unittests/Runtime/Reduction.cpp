@@ -544,3 +544,57 @@ TEST(Reductions, DotProduct) {
   EXPECT_FALSE(RTNAME(DotProductLogical)(
       *logicalVector2, *logicalVector1, __FILE__, __LINE__));
 }
+
+TEST(Reductions, LargeContiguous) {
+  // Long enough for the vectorized loops over contiguous data, with a
+  // remainder that is not a whole number of lanes
+  constexpr int rows{37}, cols{29};
+  std::vector<double> realData(rows * cols);
+  std::vector<std::int32_t> intData(rows * cols);
+  for (int j{0}; j < rows * cols; ++j) {
+    realData[j] = (j * 37) % 101 - 50;
+    intData[j] = (j * 53) % 97 - 48;
+  }
+  realData[555] = 1000;
+  realData[556] = -1000;
+  double realSum{0};
+  std::int32_t intSum{0};
+  for (int j{0}; j < rows * cols; ++j) {
+    realSum += realData[j];
+    intSum += intData[j];
+  }
+  auto real{MakeArray<TypeCategory::Real, 8>(
+      std::vector<int>{rows, cols}, realData)};
+  auto integer{MakeArray<TypeCategory::Integer, 4>(
+      std::vector<int>{rows, cols}, intData)};
+  EXPECT_EQ(RTNAME(SumInteger4)(*integer, __FILE__, __LINE__), intSum);
+  EXPECT_EQ(RTNAME(MaxvalReal8)(*real, __FILE__, __LINE__), 1000.0);
+  EXPECT_EQ(RTNAME(MinvalReal8)(*real, __FILE__, __LINE__), -1000.0);
+  EXPECT_EQ(RTNAME(SumReal8)(*real, __FILE__, __LINE__), realSum);
+
+  // SUM(ARRAY, DIM=1) reduces contiguous columns
+  StaticDescriptor<1, true> statDesc;
+  Descriptor &sums{statDesc.descriptor()};
+  RTNAME(SumDim)(sums, *integer, 1, __FILE__, __LINE__, nullptr);
+  ASSERT_EQ(sums.rank(), 1);
+  ASSERT_EQ(sums.GetDimension(0).Extent(), cols);
+  for (int j{0}; j < cols; ++j) {
+    std::int32_t expect{0};
+    for (int i{0}; i < rows; ++i) {
+      expect += intData[i + j * rows];
+    }
+    EXPECT_EQ(*sums.ZeroBasedIndexedElement<std::int32_t>(j), expect) << j;
+  }
+  sums.Destroy();
+
+  std::vector<double> vectorData(rows * cols - 1);
+  double dot{0};
+  for (std::size_t j{0}; j < vectorData.size(); ++j) {
+    vectorData[j] = j % 9 - 4;
+    dot += vectorData[j] * vectorData[j];
+  }
+  auto vector{MakeArray<TypeCategory::Real, 8>(
+      std::vector<int>{static_cast<int>(vectorData.size())}, vectorData)};
+  EXPECT_EQ(
+      RTNAME(DotProductReal8)(*vector, *vector, __FILE__, __LINE__), dot);
+}
@@ -317,3 +317,43 @@ TEST(Transformational, Unpack) {
   }
   result.Destroy();
 }
+
+TEST(Transformational, TransposeLarge) {
+  // Spans several tiles, with partial tiles at the edges
+  constexpr int rows{37}, cols{21};
+  std::vector<std::int64_t> data(rows * cols);
+  for (int j{0}; j < rows * cols; ++j) {
+    data[j] = j;
+  }
+  auto array{MakeArray<TypeCategory::Integer, 8>(
+      std::vector<int>{rows, cols}, data)};
+  StaticDescriptor<2, true> statDesc;
+  Descriptor &result{statDesc.descriptor()};
+  RTNAME(Transpose)(result, *array, __FILE__, __LINE__);
+  ASSERT_EQ(result.rank(), 2);
+  ASSERT_EQ(result.GetDimension(0).Extent(), cols);
+  ASSERT_EQ(result.GetDimension(1).Extent(), rows);
+  for (int i{0}; i < rows; ++i) {
+    for (int j{0}; j < cols; ++j) {
+      EXPECT_EQ(
+          *result.ZeroBasedIndexedElement<std::int64_t>(j + i * cols),
+          data[i + j * rows]);
+    }
+  }
+  result.Destroy();
+
+  // A section with a non-unit stride: every other row
+  array->GetDimension(0).SetByteStride(2 * sizeof(std::int64_t));
+  array->GetDimension(0).SetExtent((rows + 1) / 2);
+  RTNAME(Transpose)(result, *array, __FILE__, __LINE__);
+  ASSERT_EQ(result.GetDimension(0).Extent(), cols);
+  ASSERT_EQ(result.GetDimension(1).Extent(), (rows + 1) / 2);
+  for (int i{0}; i < (rows + 1) / 2; ++i) {
+    for (int j{0}; j < cols; ++j) {
+      EXPECT_EQ(
+          *result.ZeroBasedIndexedElement<std::int64_t>(j + i * cols),
+          data[2 * i + j * rows]);
+    }
+  }
+  result.Destroy();
+}
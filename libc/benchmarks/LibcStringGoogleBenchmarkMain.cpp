@@ -0,0 +1,114 @@
+//===-- Benchmark the string scanning functions ---------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace __llvm_libc {
+
+extern size_t strlen(const char *);
+extern char *strchr(const char *, int);
+extern void *memchr(const void *, int, size_t);
+extern int strcmp(const char *, const char *);
+extern size_t strspn(const char *, const char *);
+extern size_t strcspn(const char *, const char *);
+
+} // namespace __llvm_libc
+
+// Each function scans strings of State.range(0) bytes to their end, starting
+// at each of the kOffsets offsets from a cache line.
+static constexpr size_t kOffsets = 64;
+
+namespace {
+
+struct Strings {
+  // Leaves room for the string and its terminator at any offset.
+  explicit Strings(size_t Length)
+      : Stride((Length + 2 * kOffsets) / kOffsets * kOffsets),
+        Buffer(kOffsets * Stride + kOffsets, 'a') {
+    const uintptr_t Address = reinterpret_cast<uintptr_t>(Buffer.data());
+    Begin = Buffer.data() + (kOffsets - Address % kOffsets) % kOffsets;
+    for (size_t Offset = 0; Offset < kOffsets; ++Offset)
+      Begin[Offset * Stride + Offset + Length] = '\0';
+  }
+
+  char *get(size_t Offset) { return Begin + Offset * Stride + Offset; }
+
+  size_t Stride;
+  std::vector<char> Buffer;
+  char *Begin;
+};
+
+template <typename Function>
+void runBenchmark(benchmark::State &State, Function Scan) {
+  const size_t Length = State.range(0);
+  Strings Left(Length);
+  Strings Right(Length);
+  size_t Offset = 0;
+  for (auto _ : State) {
+    benchmark::DoNotOptimize(
+        Scan(Left.get(Offset), Right.get(kOffsets - 1 - Offset), Length));
+    Offset = (Offset + 1) % kOffsets;
+  }
+  State.SetBytesProcessed(State.iterations() * (Length + 1));
+}
+
+void BM_Strlen(benchmark::State &State) {
+  runBenchmark(State, [](const char *Str, const char *, size_t) {
+    return __llvm_libc::strlen(Str);
+  });
+}
+
+void BM_Strchr(benchmark::State &State) {
+  runBenchmark(State, [](const char *Str, const char *, size_t) {
+    return __llvm_libc::strchr(Str, 'z');
+  });
+}
+
+void BM_Memchr(benchmark::State &State) {
+  runBenchmark(State, [](const char *Str, const char *, size_t Length) {
+    return __llvm_libc::memchr(Str, 'z', Length + 1);
+  });
+}
+
+void BM_Strcmp(benchmark::State &State) {
+  runBenchmark(State, [](const char *Left, const char *Right, size_t) {
+    return __llvm_libc::strcmp(Left, Right);
+  });
+}
+
+// Sets of characters as commonly used by parsers, which the strings don't end.
+void BM_Strspn(benchmark::State &State) {
+  runBenchmark(State, [](const char *Str, const char *, size_t) {
+    return __llvm_libc::strspn(Str, "abcdef");
+  });
+}
+
+void BM_Strcspn(benchmark::State &State) {
+  runBenchmark(State, [](const char *Str, const char *, size_t) {
+    return __llvm_libc::strcspn(Str, " \t\r\n");
+  });
+}
+
+void BM_StrcspnLargeSet(benchmark::State &State) {
+  runBenchmark(State, [](const char *Str, const char *, size_t) {
+    return __llvm_libc::strcspn(Str, " \t\r\n,;:=(){}[]<>\"'");
+  });
+}
+
+} // namespace
+
+BENCHMARK(BM_Strlen)->RangeMultiplier(4)->Range(1, 1 << 16);
+BENCHMARK(BM_Strchr)->RangeMultiplier(4)->Range(1, 1 << 16);
+BENCHMARK(BM_Memchr)->RangeMultiplier(4)->Range(1, 1 << 16);
+BENCHMARK(BM_Strcmp)->RangeMultiplier(4)->Range(1, 1 << 16);
+BENCHMARK(BM_Strspn)->RangeMultiplier(4)->Range(1, 1 << 16);
+BENCHMARK(BM_Strcspn)->RangeMultiplier(4)->Range(1, 1 << 16);
+BENCHMARK(BM_StrcspnLargeSet)->RangeMultiplier(4)->Range(1, 1 << 16);
@@ -13,6 +13,7 @@
 #include "src/__support/common.h"
 #include "src/string/memory_utils/elements.h"
 #include "src/string/memory_utils/utils.h"
+#include "src/string/memory_utils/x86_dispatch.h"
 
 #include <stddef.h> // size_t
 
@@ -62,6 +63,11 @@ static inline void inline_memcpy(char *__restrict dst,
   // Whether target supports AVX instructions.
   constexpr bool HAS_AVX = LLVM_LIBC_IS_DEFINED(__AVX__);
 
+  // Whether to pick the large sizes strategy from the features of the host,
+  // see x86_dispatch.h.
+  constexpr bool USE_RUNTIME_DISPATCH =
+      LLVM_LIBC_IS_DEFINED(LLVM_LIBC_MEMCPY_X86_USE_RUNTIME_DISPATCH);
+
 #if defined(__AVX__)
   using LoopBlockSize = _64;
 #else
@@ -93,6 +99,10 @@ static inline void inline_memcpy(char *__restrict dst,
     return copy<HeadTail<_64>>(dst, src, count);
   if (HAS_AVX && count < 256)
     return copy<HeadTail<_128>>(dst, src, count);
+#if defined(LLVM_LIBC_ARCH_X86_64)
+  if (USE_RUNTIME_DISPATCH)
+    return dispatch_copy_large(dst, src, count);
+#endif // LLVM_LIBC_ARCH_X86_64
   if (count <= REP_MOVS_B_SIZE)
     return copy<Align<_32, Arg::Dst>::Then<Loop<LoopBlockSize>>>(dst, src,
                                                                  count);
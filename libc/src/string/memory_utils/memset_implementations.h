@@ -10,8 +10,10 @@
 #define LLVM_LIBC_SRC_STRING_MEMORY_UTILS_MEMSET_IMPLEMENTATIONS_H
 
 #include "src/__support/architectures.h"
+#include "src/__support/common.h"
 #include "src/string/memory_utils/elements.h"
 #include "src/string/memory_utils/utils.h"
+#include "src/string/memory_utils/x86_dispatch.h"
 
 #include <stddef.h> // size_t
 
@@ -54,6 +56,12 @@ inline static void inline_memset(char *dst, unsigned char value, size_t count) {
   // LLVM_LIBC_ARCH_X86
   /////////////////////////////////////////////////////////////////////////////
   using namespace __llvm_libc::x86;
+
+  // Whether to pick the large sizes strategy from the features of the host,
+  // see x86_dispatch.h.
+  constexpr bool USE_RUNTIME_DISPATCH =
+      LLVM_LIBC_IS_DEFINED(LLVM_LIBC_MEMSET_X86_USE_RUNTIME_DISPATCH);
+
   if (count == 0)
     return;
   if (count == 1)
@@ -72,6 +80,10 @@ inline static void inline_memset(char *dst, unsigned char value, size_t count) {
     return splat_set<HeadTail<_32>>(dst, value, count);
   if (count <= 128)
     return splat_set<HeadTail<_64>>(dst, value, count);
+#if defined(LLVM_LIBC_ARCH_X86_64)
+  if (USE_RUNTIME_DISPATCH)
+    return dispatch_set_large(dst, value, count);
+#endif // LLVM_LIBC_ARCH_X86_64
   return splat_set<Align<_32, Arg::Dst>::Then<Loop<_32>>>(dst, value, count);
 #elif defined(LLVM_LIBC_ARCH_AARCH64)
   /////////////////////////////////////////////////////////////////////////////
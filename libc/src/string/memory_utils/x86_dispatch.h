@@ -0,0 +1,469 @@
+//===-- Runtime dispatch of large memory operations for x86 -----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_STRING_MEMORY_UTILS_X86_DISPATCH_H
+#define LLVM_LIBC_SRC_STRING_MEMORY_UTILS_X86_DISPATCH_H
+
+#include "src/__support/architectures.h"
+
+#if defined(LLVM_LIBC_ARCH_X86_64)
+
+#include <immintrin.h>
+#include <stddef.h> // size_t
+#include <stdint.h> // uint32_t, uint64_t, uintptr_t
+
+// Design rationale
+// ================
+//
+// The element types of `elements_x86.h` are chosen at compile time from the
+// target features of the build, so a binary built for a generic x86-64 CPU
+// never uses AVX2 or AVX-512, even on hosts that have them. The small sizes
+// are dominated by branching, not by the width of the vectors, so they keep
+// using the compile time elements. This file handles the large sizes: the
+// kernels are compiled for each instruction set with the `target` attribute,
+// and the first call picks one from the features of the host, like an IFUNC
+// resolver would, and caches it in a function pointer.
+//
+// Depending on the size, the selected kernel then uses:
+// - a vector loop with aligned stores,
+// - `rep movsb` / `rep stosb`, when the CPU advertises fast strings (ERMS or
+//   FSRM) and the size is beyond the point where their startup cost pays off,
+// - non-temporal stores, when the size is a large fraction of the last level
+//   cache and the destination would only evict useful data from it.
+
+#define LLVM_LIBC_TARGET_AVX2 __attribute__((target("avx2")))
+#define LLVM_LIBC_TARGET_AVX512 __attribute__((target("avx512f")))
+
+namespace __llvm_libc {
+namespace x86 {
+
+struct CpuFeatures {
+  bool avx2 = false;
+  bool avx512 = false;
+  bool erms = false;
+  bool fsrm = false;
+  // The share in bytes of the largest cache for each logical processor which
+  // uses it, or zero if it could not be queried.
+  size_t last_level_cache_share = 0;
+};
+
+static inline void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+  asm volatile("cpuid"
+               : "=a"(regs[0]), "=b"(regs[1]), "=c"(regs[2]), "=d"(regs[3])
+               : "a"(leaf), "c"(subleaf));
+}
+
+// Returns the state components the OS saves on context switches (XCR0).
+static inline uint64_t xgetbv() {
+  uint32_t eax, edx;
+  asm volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+}
+
+// Returns the share of the largest cache described by the deterministic cache
+// parameters `leaf`, which is 4 on Intel and 0x8000001D on AMD, for each
+// logical processor which uses it.
+static inline size_t largest_cache_share(uint32_t leaf) {
+  size_t largest = 0;
+  size_t share = 0;
+  for (uint32_t subleaf = 0; subleaf < 16; ++subleaf) {
+    uint32_t regs[4];
+    cpuid(leaf, subleaf, regs);
+    const uint32_t type = regs[0] & 0x1F;
+    if (type == 0) // No more caches.
+      break;
+    if (type == 2) // Instruction cache.
+      continue;
+    const size_t ways = ((regs[1] >> 22) & 0x3FF) + 1;
+    const size_t partitions = ((regs[1] >> 12) & 0x3FF) + 1;
+    const size_t line_size = (regs[1] & 0xFFF) + 1;
+    const size_t sets = static_cast<size_t>(regs[2]) + 1;
+    const size_t size = ways * partitions * line_size * sets;
+    const size_t sharing = ((regs[0] >> 14) & 0xFFF) + 1;
+    if (size > largest) {
+      largest = size;
+      share = size / sharing;
+    }
+  }
+  return share;
+}
+
+static inline CpuFeatures get_cpu_features() {
+  CpuFeatures features;
+  uint32_t regs[4];
+  cpuid(0, 0, regs);
+  const uint32_t max_leaf = regs[0];
+  if (max_leaf < 7)
+    return features;
+  cpuid(1, 0, regs);
+  const bool osxsave = regs[2] & (1U << 27);
+  cpuid(7, 0, regs);
+  const uint32_t leaf7_ebx = regs[1];
+  const uint32_t leaf7_edx = regs[3];
+  features.erms = leaf7_ebx & (1U << 9);
+  features.fsrm = leaf7_edx & (1U << 4);
+  if (osxsave) {
+    // The vector registers are only usable if the OS saves them.
+    const uint64_t xcr0 = xgetbv();
+    const bool ymm_enabled = (xcr0 & 0x6) == 0x6;
+    const bool zmm_enabled = (xcr0 & 0xE6) == 0xE6;
+    features.avx2 = ymm_enabled && (leaf7_ebx & (1U << 5));
+    features.avx512 = zmm_enabled && (leaf7_ebx & (1U << 16));
+  }
+  features.last_level_cache_share = largest_cache_share(4);
+  if (features.last_level_cache_share == 0) {
+    cpuid(0x80000000, 0, regs);
+    if (regs[0] >= 0x8000001D)
+      features.last_level_cache_share = largest_cache_share(0x8000001D);
+  }
+  return features;
+}
+
+// Block operations for each instruction set, compiled for it with the `target`
+// attribute. They only take pointers and bytes, so that no vector crosses a
+// function compiled without the instruction set, and they are inlined into the
+// kernels below, which are compiled for the same set.
+// - `copy` and `set` access one vector at unaligned addresses,
+// - `copy4` and `set4` store four vectors to an aligned destination, with
+//   non-temporal stores if `NonTemporal` is set.
+struct Sse2Ops {
+  static constexpr size_t SIZE = 16;
+  static void copy(char *__restrict dst, const char *__restrict src) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst),
+                     _mm_loadu_si128(reinterpret_cast<const __m128i *>(src)));
+  }
+  template <bool NonTemporal>
+  static void copy4(char *__restrict dst, const char *__restrict src) {
+    const __m128i *s = reinterpret_cast<const __m128i *>(src);
+    __m128i *d = reinterpret_cast<__m128i *>(dst);
+    const __m128i v0 = _mm_loadu_si128(s), v1 = _mm_loadu_si128(s + 1);
+    const __m128i v2 = _mm_loadu_si128(s + 2), v3 = _mm_loadu_si128(s + 3);
+    if (NonTemporal) {
+      _mm_stream_si128(d, v0);
+      _mm_stream_si128(d + 1, v1);
+      _mm_stream_si128(d + 2, v2);
+      _mm_stream_si128(d + 3, v3);
+    } else {
+      _mm_store_si128(d, v0);
+      _mm_store_si128(d + 1, v1);
+      _mm_store_si128(d + 2, v2);
+      _mm_store_si128(d + 3, v3);
+    }
+  }
+  static void set(char *dst, unsigned char value) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_set1_epi8(value));
+  }
+  template <bool NonTemporal>
+  static void set4(char *dst, unsigned char value) {
+    __m128i *d = reinterpret_cast<__m128i *>(dst);
+    const __m128i v = _mm_set1_epi8(value);
+    for (int i = 0; i < 4; ++i) {
+      if (NonTemporal)
+        _mm_stream_si128(d + i, v);
+      else
+        _mm_store_si128(d + i, v);
+    }
+  }
+};
+
+struct Avx2Ops {
+  static constexpr size_t SIZE = 32;
+  LLVM_LIBC_TARGET_AVX2 static void copy(char *__restrict dst,
+                                         const char *__restrict src) {
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i *>(dst),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src)));
+  }
+  template <bool NonTemporal>
+  LLVM_LIBC_TARGET_AVX2 static void copy4(char *__restrict dst,
+                                          const char *__restrict src) {
+    const __m256i *s = reinterpret_cast<const __m256i *>(src);
+    __m256i *d = reinterpret_cast<__m256i *>(dst);
+    const __m256i v0 = _mm256_loadu_si256(s), v1 = _mm256_loadu_si256(s + 1);
+    const __m256i v2 = _mm256_loadu_si256(s + 2);
+    const __m256i v3 = _mm256_loadu_si256(s + 3);
+    if (NonTemporal) {
+      _mm256_stream_si256(d, v0);
+      _mm256_stream_si256(d + 1, v1);
+      _mm256_stream_si256(d + 2, v2);
+      _mm256_stream_si256(d + 3, v3);
+    } else {
+      _mm256_store_si256(d, v0);
+      _mm256_store_si256(d + 1, v1);
+      _mm256_store_si256(d + 2, v2);
+      _mm256_store_si256(d + 3, v3);
+    }
+  }
+  LLVM_LIBC_TARGET_AVX2 static void set(char *dst, unsigned char value) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst),
+                        _mm256_set1_epi8(value));
+  }
+  template <bool NonTemporal>
+  LLVM_LIBC_TARGET_AVX2 static void set4(char *dst, unsigned char value) {
+    __m256i *d = reinterpret_cast<__m256i *>(dst);
+    const __m256i v = _mm256_set1_epi8(value);
+    for (int i = 0; i < 4; ++i) {
+      if (NonTemporal)
+        _mm256_stream_si256(d + i, v);
+      else
+        _mm256_store_si256(d + i, v);
+    }
+  }
+};
+
+struct Avx512Ops {
+  static constexpr size_t SIZE = 64;
+  LLVM_LIBC_TARGET_AVX512 static void copy(char *__restrict dst,
+                                           const char *__restrict src) {
+    _mm512_storeu_si512(dst, _mm512_loadu_si512(src));
+  }
+  template <bool NonTemporal>
+  LLVM_LIBC_TARGET_AVX512 static void copy4(char *__restrict dst,
+                                            const char *__restrict src) {
+    const __m512i v0 = _mm512_loadu_si512(src);
+    const __m512i v1 = _mm512_loadu_si512(src + 64);
+    const __m512i v2 = _mm512_loadu_si512(src + 128);
+    const __m512i v3 = _mm512_loadu_si512(src + 192);
+    __m512i *d = reinterpret_cast<__m512i *>(dst);
+    if (NonTemporal) {
+      _mm512_stream_si512(d, v0);
+      _mm512_stream_si512(d + 1, v1);
+      _mm512_stream_si512(d + 2, v2);
+      _mm512_stream_si512(d + 3, v3);
+    } else {
+      _mm512_store_si512(d, v0);
+      _mm512_store_si512(d + 1, v1);
+      _mm512_store_si512(d + 2, v2);
+      _mm512_store_si512(d + 3, v3);
+    }
+  }
+  LLVM_LIBC_TARGET_AVX512 static void set(char *dst, unsigned char value) {
+    _mm512_storeu_si512(dst, _mm512_set1_epi8(value));
+  }
+  template <bool NonTemporal>
+  LLVM_LIBC_TARGET_AVX512 static void set4(char *dst, unsigned char value) {
+    __m512i *d = reinterpret_cast<__m512i *>(dst);
+    const __m512i v = _mm512_set1_epi8(value);
+    for (int i = 0; i < 4; ++i) {
+      if (NonTemporal)
+        _mm512_stream_si512(d + i, v);
+      else
+        _mm512_store_si512(d + i, v);
+    }
+  }
+};
+
+// Copies `count` bytes, with `count` >= Ops::SIZE. The first and last blocks
+// are copied with unaligned accesses, and the loop in between stores to
+// aligned addresses, four vectors at a time.
+template <typename Ops, bool NonTemporal>
+__attribute__((always_inline)) inline void
+copy_loop(char *__restrict dst, const char *__restrict src, size_t count) {
+  constexpr size_t SIZE = Ops::SIZE;
+  Ops::copy(dst, src);
+  size_t offset = SIZE - (reinterpret_cast<uintptr_t>(dst) & (SIZE - 1));
+  for (; offset + 4 * SIZE <= count; offset += 4 * SIZE)
+    Ops::template copy4<NonTemporal>(dst + offset, src + offset);
+  if (NonTemporal)
+    _mm_sfence(); // Orders the non-temporal stores with the ones that follow.
+  for (; offset + SIZE < count; offset += SIZE)
+    Ops::copy(dst + offset, src + offset);
+  Ops::copy(dst + count - SIZE, src + count - SIZE);
+}
+
+// Same as `copy_loop` for memset.
+template <typename Ops, bool NonTemporal>
+__attribute__((always_inline)) inline void set_loop(char *dst,
+                                                    unsigned char value,
+                                                    size_t count) {
+  constexpr size_t SIZE = Ops::SIZE;
+  Ops::set(dst, value);
+  size_t offset = SIZE - (reinterpret_cast<uintptr_t>(dst) & (SIZE - 1));
+  for (; offset + 4 * SIZE <= count; offset += 4 * SIZE)
+    Ops::template set4<NonTemporal>(dst + offset, value);
+  if (NonTemporal)
+    _mm_sfence();
+  for (; offset + SIZE < count; offset += SIZE)
+    Ops::set(dst + offset, value);
+  Ops::set(dst + count - SIZE, value);
+}
+
+// The thresholds the kernels use, set by the resolvers before they publish the
+// kernel.
+struct DispatchThresholds {
+  // `rep movsb` and `rep stosb` are used from this size on, if the CPU has fast
+  // strings. SIZE_MAX disables them.
+  size_t rep_string;
+  // Non-temporal stores are used from this size on.
+  size_t non_temporal;
+};
+
+// The variables of this file are function local statics with constant
+// initializers, which need neither guards nor a definition in a source file.
+static inline DispatchThresholds &dispatch_thresholds() {
+  static DispatchThresholds thresholds = {SIZE_MAX, SIZE_MAX};
+  return thresholds;
+}
+
+static inline DispatchThresholds
+compute_dispatch_thresholds(const CpuFeatures &features, size_t vector_size) {
+  DispatchThresholds thresholds = {SIZE_MAX, SIZE_MAX};
+  // Fast short `rep movsb` makes the instruction cheap to start, otherwise it
+  // only beats the vector loop once it can use full cache lines for a while,
+  // which takes longer with wider vectors.
+  if (features.fsrm)
+    thresholds.rep_string = 2048;
+  else if (features.erms)
+    thresholds.rep_string = 2048 * (vector_size / 16);
+  // Beyond three quarters of the share of the last level cache of the thread,
+  // the destination evicts the source and the data of the other threads from
+  // the cache anyway. Without cache information, the share defaults to 1 MiB.
+  const size_t cache_share = features.last_level_cache_share
+                                 ? features.last_level_cache_share
+                                 : 1024 * 1024;
+  thresholds.non_temporal = cache_share / 4 * 3;
+  return thresholds;
+}
+
+template <typename Ops>
+__attribute__((always_inline)) inline void
+copy_large(char *__restrict dst, const char *__restrict src, size_t count) {
+  DispatchThresholds &thresholds = dispatch_thresholds();
+  if (count >= __atomic_load_n(&thresholds.non_temporal, __ATOMIC_RELAXED))
+    return copy_loop<Ops, true>(dst, src, count);
+  if (count >= __atomic_load_n(&thresholds.rep_string, __ATOMIC_RELAXED))
+    asm volatile("rep movsb" : "+D"(dst), "+S"(src), "+c"(count) : : "memory");
+  else
+    copy_loop<Ops, false>(dst, src, count);
+}
+
+template <typename Ops>
+__attribute__((always_inline)) inline void
+set_large(char *dst, unsigned char value, size_t count) {
+  DispatchThresholds &thresholds = dispatch_thresholds();
+  if (count >= __atomic_load_n(&thresholds.non_temporal, __ATOMIC_RELAXED))
+    return set_loop<Ops, true>(dst, value, count);
+  if (count >= __atomic_load_n(&thresholds.rep_string, __ATOMIC_RELAXED))
+    asm volatile("rep stosb" : "+D"(dst), "+c"(count) : "a"(value) : "memory");
+  else
+    set_loop<Ops, false>(dst, value, count);
+}
+
+static inline void copy_large_sse2(char *__restrict dst,
+                                   const char *__restrict src, size_t count) {
+  copy_large<Sse2Ops>(dst, src, count);
+}
+
+LLVM_LIBC_TARGET_AVX2 static inline void
+copy_large_avx2(char *__restrict dst, const char *__restrict src,
+                size_t count) {
+  copy_large<Avx2Ops>(dst, src, count);
+}
+
+LLVM_LIBC_TARGET_AVX512 static inline void
+copy_large_avx512(char *__restrict dst, const char *__restrict src,
+                  size_t count) {
+  copy_large<Avx512Ops>(dst, src, count);
+}
+
+static inline void set_large_sse2(char *dst, unsigned char value,
+                                  size_t count) {
+  set_large<Sse2Ops>(dst, value, count);
+}
+
+LLVM_LIBC_TARGET_AVX2 static inline void
+set_large_avx2(char *dst, unsigned char value, size_t count) {
+  set_large<Avx2Ops>(dst, value, count);
+}
+
+LLVM_LIBC_TARGET_AVX512 static inline void
+set_large_avx512(char *dst, unsigned char value, size_t count) {
+  set_large<Avx512Ops>(dst, value, count);
+}
+
+using CopyLargeFn = void (*)(char *__restrict, const char *__restrict, size_t);
+using SetLargeFn = void (*)(char *, unsigned char, size_t);
+
+static inline void resolve_copy_large(char *__restrict dst,
+                                      const char *__restrict src, size_t count);
+static inline void resolve_set_large(char *dst, unsigned char value,
+                                     size_t count);
+
+// The selected kernels. They start as the resolvers, which replace themselves
+// on the first call. Racing resolvers compute the same values, and the release
+// store makes the thresholds visible before the kernel.
+static inline CopyLargeFn &copy_large_fn() {
+  static CopyLargeFn kernel = resolve_copy_large;
+  return kernel;
+}
+
+static inline SetLargeFn &set_large_fn() {
+  static SetLargeFn kernel = resolve_set_large;
+  return kernel;
+}
+
+template <typename Fn>
+static inline Fn select_kernel(Fn sse2, Fn avx2, Fn avx512) {
+  const CpuFeatures features = get_cpu_features();
+  size_t vector_size = 16;
+  Fn kernel = sse2;
+  if (features.avx512) {
+    vector_size = 64;
+    kernel = avx512;
+  } else if (features.avx2) {
+    vector_size = 32;
+    kernel = avx2;
+  }
+  const DispatchThresholds thresholds =
+      compute_dispatch_thresholds(features, vector_size);
+  DispatchThresholds &published = dispatch_thresholds();
+  __atomic_store_n(&published.rep_string, thresholds.rep_string,
+                   __ATOMIC_RELAXED);
+  __atomic_store_n(&published.non_temporal, thresholds.non_temporal,
+                   __ATOMIC_RELAXED);
+  return kernel;
+}
+
+static inline void resolve_copy_large(char *__restrict dst,
+                                      const char *__restrict src,
+                                      size_t count) {
+  const CopyLargeFn kernel = select_kernel<CopyLargeFn>(
+      copy_large_sse2, copy_large_avx2, copy_large_avx512);
+  __atomic_store_n(&copy_large_fn(), kernel, __ATOMIC_RELEASE);
+  kernel(dst, src, count);
+}
+
+static inline void resolve_set_large(char *dst, unsigned char value,
+                                     size_t count) {
+  const SetLargeFn kernel = select_kernel<SetLargeFn>(
+      set_large_sse2, set_large_avx2, set_large_avx512);
+  __atomic_store_n(&set_large_fn(), kernel, __ATOMIC_RELEASE);
+  kernel(dst, value, count);
+}
+
+// Copies `count` bytes with the kernel for the host, `count` must be at least
+// 256.
+static inline void dispatch_copy_large(char *__restrict dst,
+                                       const char *__restrict src,
+                                       size_t count) {
+  __atomic_load_n(&copy_large_fn(), __ATOMIC_ACQUIRE)(dst, src, count);
+}
+
+// Sets `count` bytes with the kernel for the host, `count` must be at least
+// 256.
+static inline void dispatch_set_large(char *dst, unsigned char value,
+                                      size_t count) {
+  __atomic_load_n(&set_large_fn(), __ATOMIC_ACQUIRE)(dst, value, count);
+}
+
+} // namespace x86
+} // namespace __llvm_libc
+
+#endif // defined(LLVM_LIBC_ARCH_X86_64)
+
+#endif // LLVM_LIBC_SRC_STRING_MEMORY_UTILS_X86_DISPATCH_H
@@ -0,0 +1,403 @@
+//===-- Vectorized string scanning ------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// The string functions don't know the size of the strings they scan, so they
+// may only read memory up to the byte which ends the scan. The functions below
+// read whole blocks of bytes at addresses aligned to the block size instead. An
+// aligned block never spans two pages, so its load cannot fault when one of its
+// bytes is readable. The bytes of the block before the start or after the end
+// of the string are read but ignored.
+//
+// A block type provides:
+// - SIZE, the number of bytes of a block, a power of two,
+// - T, the type of a loaded block,
+// - Mask, an integer with BITS_PER_BYTE bits for each byte of a block, ordered
+//   by address from the least significant bit, of which at least one bit is
+//   set for the bytes which match and all bits are clear for the others,
+// - load and loadu, which load a block from an aligned or any address,
+// - splat, which returns a block with all bytes equal to a value,
+// - eq, ne and zero, which return the mask of the bytes of a block which are
+//   equal to the bytes of another block, different from them, or zero.
+
+#ifndef LLVM_LIBC_SRC_STRING_SCAN_UTILS_H
+#define LLVM_LIBC_SRC_STRING_SCAN_UTILS_H
+
+#include "src/__support/architectures.h"
+#include "src/__support/common.h"
+
+#include <stddef.h> // size_t
+#include <stdint.h> // uint32_t, uint64_t, uintptr_t
+
+#if defined(LLVM_LIBC_ARCH_X86) && defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(LLVM_LIBC_ARCH_AARCH64) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Reading the bytes around a string is fine for the hardware but not for the
+// sanitizers. The attribute also has to be on all the functions called by the
+// scanning loops, as functions with different sanitizer attributes are not
+// inlined into each other.
+#if defined(__clang__)
+#define LLVM_LIBC_SCAN                                                         \
+  __attribute__((no_sanitize("address", "hwaddress", "memory", "thread")))
+#else
+#define LLVM_LIBC_SCAN                                                         \
+  __attribute__((no_sanitize("address", "hwaddress", "thread")))
+#endif
+
+namespace __llvm_libc {
+namespace scan {
+
+#if defined(LLVM_LIBC_ARCH_X86) && defined(__AVX2__)
+struct M256 {
+  static constexpr size_t SIZE = 32;
+  static constexpr size_t BITS_PER_BYTE = 1;
+  using T = __m256i;
+  using Mask = uint32_t;
+  LLVM_LIBC_SCAN static T load(const unsigned char *ptr) {
+    // NOLINTNEXTLINE(llvmlibc-callee-namespace)
+    return _mm256_load_si256(reinterpret_cast<const __m256i *>(ptr));
+  }
+  LLVM_LIBC_SCAN static T loadu(const unsigned char *ptr) {
+    // NOLINTNEXTLINE(llvmlibc-callee-namespace)
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));
+  }
+  LLVM_LIBC_SCAN static T splat(unsigned char value) {
+    // NOLINTNEXTLINE(llvmlibc-callee-namespace)
+    return _mm256_set1_epi8(static_cast<char>(value));
+  }
+  LLVM_LIBC_SCAN static Mask eq(T a, T b) {
+    // NOLINTNEXTLINE(llvmlibc-callee-namespace)
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b));
+  }
+  LLVM_LIBC_SCAN static Mask ne(T a, T b) { return ~eq(a, b); }
+  LLVM_LIBC_SCAN static Mask zero(T a) {
+    // NOLINTNEXTLINE(llvmlibc-callee-namespace)
+    return eq(a, _mm256_setzero_si256());
+  }
+};
+using Block = M256;
+#elif defined(LLVM_LIBC_ARCH_X86) && defined(__SSE2__)
+struct M128 {
+  static constexpr size_t SIZE = 16;
+  static constexpr size_t BITS_PER_BYTE = 1;
+  using T = __m128i;
+  using Mask = uint32_t;
+  LLVM_LIBC_SCAN static T load(const unsigned char *ptr) {
+    // NOLINTNEXTLINE(llvmlibc-callee-namespace)
+    return _mm_load_si128(reinterpret_cast<const __m128i *>(ptr));
+  }
+  LLVM_LIBC_SCAN static T loadu(const unsigned char *ptr) {
+    // NOLINTNEXTLINE(llvmlibc-callee-namespace)
+    return _mm_loadu_si128(reinterpret_cast<const __m128i_u *>(ptr));
+  }
+  LLVM_LIBC_SCAN static T splat(unsigned char value) {
+    // NOLINTNEXTLINE(llvmlibc-callee-namespace)
+    return _mm_set1_epi8(static_cast<char>(value));
+  }
+  LLVM_LIBC_SCAN static Mask eq(T a, T b) {
+    // NOLINTNEXTLINE(llvmlibc-callee-namespace)
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(a, b));
+  }
+  LLVM_LIBC_SCAN static Mask ne(T a, T b) { return eq(a, b) ^ 0xFFFF; }
+  LLVM_LIBC_SCAN static Mask zero(T a) {
+    // NOLINTNEXTLINE(llvmlibc-callee-namespace)
+    return eq(a, _mm_setzero_si128());
+  }
+};
+using Block = M128;
+#elif defined(LLVM_LIBC_ARCH_AARCH64) && defined(__ARM_NEON)
+struct N128 {
+  static constexpr size_t SIZE = 16;
+  // Neon has no movemask, narrowing the comparison keeps four bits per byte.
+  static constexpr size_t BITS_PER_BYTE = 4;
+  using T = uint8x16_t;
+  using Mask = uint64_t;
+  LLVM_LIBC_SCAN static T load(const unsigned char *ptr) {
+    return vld1q_u8(ptr);
+  }
+  LLVM_LIBC_SCAN static T loadu(const unsigned char *ptr) {
+    return vld1q_u8(ptr);
+  }
+  LLVM_LIBC_SCAN static T splat(unsigned char value) {
+    return vdupq_n_u8(value);
+  }
+  LLVM_LIBC_SCAN static Mask mask(uint8x16_t comparison) {
+    const uint8x8_t narrowed =
+        vshrn_n_u16(vreinterpretq_u16_u8(comparison), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+  }
+  LLVM_LIBC_SCAN static Mask eq(T a, T b) { return mask(vceqq_u8(a, b)); }
+  LLVM_LIBC_SCAN static Mask ne(T a, T b) {
+    return mask(vmvnq_u8(vceqq_u8(a, b)));
+  }
+  LLVM_LIBC_SCAN static Mask zero(T a) { return mask(vceqzq_u8(a)); }
+};
+using Block = N128;
+#else
+// Processes a machine word at a time, with the high bit of each byte as mask.
+struct Word {
+  using T = uintptr_t;
+  using Mask = uintptr_t;
+  static constexpr size_t SIZE = sizeof(T);
+  static constexpr size_t BITS_PER_BYTE = 8;
+  static constexpr T ONES = ~T(0) / 0xFF;
+  static constexpr T LOWS = ONES * 0x7F;
+  static constexpr T HIGHS = ONES * 0x80;
+  LLVM_LIBC_SCAN static T load(const unsigned char *ptr) {
+    T value;
+    __builtin_memcpy(&value, ptr, SIZE);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    // Puts the first byte in the least significant bits.
+    if (SIZE == 8)
+      value = static_cast<T>(__builtin_bswap64(value));
+    else
+      value = static_cast<T>(__builtin_bswap32(static_cast<uint32_t>(value)));
+#endif
+    return value;
+  }
+  LLVM_LIBC_SCAN static T loadu(const unsigned char *ptr) { return load(ptr); }
+  LLVM_LIBC_SCAN static T splat(unsigned char value) { return ONES * value; }
+  // Unlike the usual (a - ONES) & ~a & HIGHS, this doesn't propagate a borrow
+  // from a zero byte to the next one, so all the bits of the mask are exact.
+  LLVM_LIBC_SCAN static Mask zero(T a) {
+    return ~(((a & LOWS) + LOWS) | a | LOWS);
+  }
+  LLVM_LIBC_SCAN static Mask eq(T a, T b) { return zero(a ^ b); }
+  LLVM_LIBC_SCAN static Mask ne(T a, T b) { return eq(a, b) ^ HIGHS; }
+};
+using Block = Word;
+#endif
+
+// The smallest page size of the supported targets. Using a smaller value than
+// the actual page size only makes the checks below more conservative.
+static constexpr size_t PAGE_SIZE = 4096;
+
+template <typename B>
+LLVM_LIBC_SCAN static inline const unsigned char *
+align_down(const unsigned char *ptr) {
+  return reinterpret_cast<const unsigned char *>(
+      reinterpret_cast<uintptr_t>(ptr) & ~uintptr_t(B::SIZE - 1));
+}
+
+template <typename B>
+LLVM_LIBC_SCAN static inline bool may_cross_page(const unsigned char *ptr) {
+  return (reinterpret_cast<uintptr_t>(ptr) & (PAGE_SIZE - 1)) >
+         PAGE_SIZE - B::SIZE;
+}
+
+// The number of blocks which the loop over long strings checks at once, to
+// have more loads in flight. The groups are aligned on their size, so that they
+// don't span two pages either.
+static constexpr size_t GROUP = 4;
+
+template <typename B>
+LLVM_LIBC_SCAN static inline bool is_group_aligned(const unsigned char *ptr) {
+  return (reinterpret_cast<uintptr_t>(ptr) & (GROUP * B::SIZE - 1)) == 0;
+}
+
+// The mask of the bytes of a block from 'offset' onwards.
+template <typename B>
+LLVM_LIBC_SCAN static inline typename B::Mask from(size_t offset) {
+  return ~typename B::Mask(0) << (offset * B::BITS_PER_BYTE);
+}
+
+// The index of the first matching byte of a non-zero mask.
+template <typename B>
+LLVM_LIBC_SCAN static inline size_t first(typename B::Mask mask) {
+  return static_cast<size_t>(__builtin_ctzll(mask)) / B::BITS_PER_BYTE;
+}
+
+// The index of the first matching byte of a group, one of the masks being
+// non-zero.
+template <typename B>
+LLVM_LIBC_SCAN static inline size_t first(typename B::Mask mask0,
+                                          typename B::Mask mask1,
+                                          typename B::Mask mask2,
+                                          typename B::Mask mask3) {
+  if (mask0)
+    return first<B>(mask0);
+  if (mask1)
+    return B::SIZE + first<B>(mask1);
+  if (mask2)
+    return 2 * B::SIZE + first<B>(mask2);
+  return 3 * B::SIZE + first<B>(mask3);
+}
+
+// Returns the address of the first byte from 'src' which 'match' selects. The
+// string must contain such a byte, 'match' always selecting zero bytes.
+template <typename B, typename Match>
+LLVM_LIBC_SCAN static inline const unsigned char *
+find_first(const unsigned char *src, const Match &match) {
+  const unsigned char *block = align_down<B>(src);
+  typename B::Mask mask = match(B::load(block)) & from<B>(src - block);
+  if (mask)
+    return block + first<B>(mask);
+  for (block += B::SIZE; !is_group_aligned<B>(block); block += B::SIZE)
+    if ((mask = match(B::load(block))))
+      return block + first<B>(mask);
+  for (;; block += GROUP * B::SIZE) {
+    const typename B::Mask mask0 = match(B::load(block));
+    const typename B::Mask mask1 = match(B::load(block + B::SIZE));
+    const typename B::Mask mask2 = match(B::load(block + 2 * B::SIZE));
+    const typename B::Mask mask3 = match(B::load(block + 3 * B::SIZE));
+    if (mask0 | mask1 | mask2 | mask3)
+      return block + first<B>(mask0, mask1, mask2, mask3);
+  }
+}
+
+// Returns the address of the first of the 'n' bytes from 'src' which 'match'
+// selects, or nullptr if there is none.
+template <typename B, typename Match>
+LLVM_LIBC_SCAN static inline const unsigned char *
+find_first(const unsigned char *src, size_t n, const Match &match) {
+  if (n == 0)
+    return nullptr;
+  const unsigned char *block = align_down<B>(src);
+  const size_t offset = src - block;
+  // The number of bytes from 'block' to the end of the range, saturated as
+  // memchr may be given a size larger than the remaining address space.
+  size_t remaining = n > SIZE_MAX - offset ? SIZE_MAX : n + offset;
+  typename B::Mask mask = match(B::load(block)) & from<B>(offset);
+  while (!mask) {
+    if (remaining <= B::SIZE)
+      return nullptr;
+    remaining -= B::SIZE;
+    block += B::SIZE;
+    mask = match(B::load(block));
+  }
+  const size_t index = first<B>(mask);
+  return index < remaining ? block + index : nullptr;
+}
+
+template <typename B> struct Zero {
+  LLVM_LIBC_SCAN typename B::Mask operator()(typename B::T block) const {
+    return B::zero(block);
+  }
+};
+
+template <typename B> struct Byte {
+  typename B::T value;
+  LLVM_LIBC_SCAN typename B::Mask operator()(typename B::T block) const {
+    return B::eq(block, value);
+  }
+};
+
+template <typename B> struct ByteOrZero {
+  typename B::T value;
+  LLVM_LIBC_SCAN typename B::Mask operator()(typename B::T block) const {
+    return B::eq(block, value) | B::zero(block);
+  }
+};
+
+// The largest set of characters which 'span' compares with each block. Larger
+// sets are faster to look up one byte at a time in a bitset.
+static constexpr size_t MAX_SET_SIZE = 8;
+
+// Selects the bytes which are in the set, and the terminator, if 'IN_SET' is
+// false, or the bytes which aren't in the set if it is true. The set may not be
+// empty nor contain the terminator.
+template <typename B, bool IN_SET> struct Set {
+  typename B::T values[MAX_SET_SIZE];
+  size_t size;
+  LLVM_LIBC_SCAN typename B::Mask operator()(typename B::T block) const {
+    typename B::Mask mask;
+    if (IN_SET) {
+      mask = B::ne(block, values[0]);
+      for (size_t i = 1; i < size; ++i)
+        mask &= B::ne(block, values[i]);
+    } else {
+      mask = B::zero(block);
+      for (size_t i = 0; i < size; ++i)
+        mask |= B::eq(block, values[i]);
+    }
+    return mask;
+  }
+};
+
+// Returns the length of 'src'.
+LLVM_LIBC_SCAN static inline size_t string_length(const char *src) {
+  const unsigned char *str = reinterpret_cast<const unsigned char *>(src);
+  return find_first<Block>(str, Zero<Block>()) - str;
+}
+
+// Returns the first occurrence of 'ch' within the first 'n' characters of
+// 'src', or nullptr.
+LLVM_LIBC_SCAN static inline const unsigned char *
+find_byte(const unsigned char *src, unsigned char ch, size_t n) {
+  return find_first<Block>(src, n, Byte<Block>{Block::splat(ch)});
+}
+
+// Returns the first occurrence of 'ch' or of the terminator in 'src'.
+LLVM_LIBC_SCAN static inline const char *find_byte_or_zero(const char *src,
+                                                           unsigned char ch) {
+  return reinterpret_cast<const char *>(
+      find_first<Block>(reinterpret_cast<const unsigned char *>(src),
+                        ByteOrZero<Block>{Block::splat(ch)}));
+}
+
+// Returns the length of the initial segment of 'src' whose characters are all
+// in the 'size' characters of 'set' if 'IN_SET' is true, or all out of them if
+// it is false. 'size' must not be larger than MAX_SET_SIZE.
+template <bool IN_SET>
+LLVM_LIBC_SCAN static inline size_t span(const char *src, const char *set,
+                                         size_t size) {
+  if (IN_SET && size == 0)
+    return 0;
+  Set<Block, IN_SET> match;
+  match.size = size;
+  for (size_t i = 0; i < size; ++i)
+    match.values[i] = Block::splat(static_cast<unsigned char>(set[i]));
+  const unsigned char *str = reinterpret_cast<const unsigned char *>(src);
+  return find_first<Block>(str, match) - str;
+}
+
+// Returns the difference of the first different characters of 'left' and
+// 'right', or 0 if the strings are equal.
+LLVM_LIBC_SCAN static inline int compare_strings(const unsigned char *left,
+                                                 const unsigned char *right) {
+  using B = Block;
+  // Compares the first block, then aligns 'left' so that only the loads from
+  // 'right' may span two pages.
+  if (may_cross_page<B>(left) || may_cross_page<B>(right)) {
+    for (; reinterpret_cast<uintptr_t>(left) & (B::SIZE - 1); ++left, ++right)
+      if (*left != *right || *left == 0)
+        return *left - *right;
+  } else {
+    const typename B::T l = B::loadu(left);
+    const typename B::Mask mask = B::ne(l, B::loadu(right)) | B::zero(l);
+    if (mask) {
+      const size_t index = first<B>(mask);
+      return left[index] - right[index];
+    }
+    const size_t skip =
+        B::SIZE - (reinterpret_cast<uintptr_t>(left) & (B::SIZE - 1));
+    left += skip;
+    right += skip;
+  }
+  for (;; left += B::SIZE, right += B::SIZE) {
+    if (unlikely(may_cross_page<B>(right))) {
+      for (size_t i = 0; i < B::SIZE; ++i)
+        if (left[i] != right[i] || left[i] == 0)
+          return left[i] - right[i];
+      continue;
+    }
+    const typename B::T l = B::load(left);
+    const typename B::Mask mask = B::ne(l, B::loadu(right)) | B::zero(l);
+    if (mask) {
+      const size_t index = first<B>(mask);
+      return left[index] - right[index];
+    }
+  }
+}
+
+} // namespace scan
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_STRING_SCAN_UTILS_H
@@ -9,14 +9,14 @@
 #include "src/string/strchr.h"
 
 #include "src/__support/common.h"
+#include "src/string/scan_utils.h"
 
 namespace __llvm_libc {
 
 // TODO: Look at performance benefits of comparing words.
 LLVM_LIBC_FUNCTION(char *, strchr, (const char *src, int c)) {
   const char ch = c;
-  for (; *src && *src != ch; ++src)
-    ;
+  src = scan::find_byte_or_zero(src, ch);
   return *src == ch ? const_cast<char *>(src) : nullptr;
 }
 
@@ -9,15 +9,14 @@
 #include "src/string/strcmp.h"
 
 #include "src/__support/common.h"
+#include "src/string/scan_utils.h"
 
 namespace __llvm_libc {
 
 // TODO: Look at benefits for comparing words at a time.
 LLVM_LIBC_FUNCTION(int, strcmp, (const char *left, const char *right)) {
-  for (; *left && *left == *right; ++left, ++right)
-    ;
-  return *reinterpret_cast<const unsigned char *>(left) -
-         *reinterpret_cast<const unsigned char *>(right);
+  return scan::compare_strings(reinterpret_cast<const unsigned char *>(left),
+                               reinterpret_cast<const unsigned char *>(right));
 }
 
 } // namespace __llvm_libc
@@ -11,6 +11,7 @@
 
 #include "src/__support/CPP/Bitset.h"
 #include "src/__support/common.h"
+#include "src/string/scan_utils.h"
 #include <stddef.h> // size_t
 
 namespace __llvm_libc {
@@ -19,30 +20,29 @@ namespace internal {
 // Returns the length of a string, denoted by the first occurrence
 // of a null terminator.
 static inline size_t string_length(const char *src) {
-  size_t length;
-  for (length = 0; *src; ++src, ++length)
-    ;
-  return length;
+  return scan::string_length(src);
 }
 
 // Returns the first occurrence of 'ch' within the first 'n' characters of
 // 'src'. If 'ch' is not found, returns nullptr.
 static inline void *find_first_character(const unsigned char *src,
                                          unsigned char ch, size_t n) {
-  for (; n && *src != ch; --n, ++src)
-    ;
-  return n ? const_cast<unsigned char *>(src) : nullptr;
+  return const_cast<unsigned char *>(scan::find_byte(src, ch, n));
 }
 
 // Returns the maximum length span that contains only characters not found in
 // 'segment'. If no characters are found, returns the length of 'src'.
 static inline size_t complementary_span(const char *src, const char *segment) {
+  const size_t segment_length = string_length(segment);
+  if (segment_length <= scan::MAX_SET_SIZE)
+    return scan::span<false>(src, segment, segment_length);
+
   const char *initial = src;
   cpp::Bitset<256> bitset;
 
   for (; *segment; ++segment)
-    bitset.set(*segment);
-  for (; *src && !bitset.test(*src); ++src)
+    bitset.set(static_cast<unsigned char>(*segment));
+  for (; *src && !bitset.test(static_cast<unsigned char>(*src)); ++src)
     ;
   return src - initial;
 }
@@ -65,9 +65,10 @@ static inline char *string_token(char *__restrict src,
 
   cpp::Bitset<256> delimiter_set;
   for (; *delimiter_string != '\0'; ++delimiter_string)
-    delimiter_set.set(*delimiter_string);
+    delimiter_set.set(static_cast<unsigned char>(*delimiter_string));
 
-  for (; *src != '\0' && delimiter_set.test(*src); ++src)
+  for (; *src != '\0' && delimiter_set.test(static_cast<unsigned char>(*src));
+       ++src)
     ;
   if (*src == '\0') {
     *saveptr = src;
@@ -75,7 +76,7 @@ static inline char *string_token(char *__restrict src,
   }
   char *token = src;
   for (; *src != '\0'; ++src) {
-    if (delimiter_set.test(*src)) {
+    if (delimiter_set.test(static_cast<unsigned char>(*src))) {
       *src = '\0';
       ++src;
       break;
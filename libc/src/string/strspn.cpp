@@ -10,17 +10,22 @@
 
 #include "src/__support/CPP/Bitset.h"
 #include "src/__support/common.h"
+#include "src/string/string_utils.h"
 #include <stddef.h>
 
 namespace __llvm_libc {
 
 LLVM_LIBC_FUNCTION(size_t, strspn, (const char *src, const char *segment)) {
+  const size_t segment_length = internal::string_length(segment);
+  if (segment_length <= scan::MAX_SET_SIZE)
+    return scan::span<true>(src, segment, segment_length);
+
   const char *initial = src;
   cpp::Bitset<256> bitset;
 
   for (; *segment; ++segment)
-    bitset.set(*segment);
-  for (; *src && bitset.test(*src); ++src)
+    bitset.set(static_cast<unsigned char>(*segment));
+  for (; *src && bitset.test(static_cast<unsigned char>(*src)); ++src)
     ;
   return src - initial;
 }
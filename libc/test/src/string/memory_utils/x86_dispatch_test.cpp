@@ -0,0 +1,102 @@
+//===-- Unittests for x86 runtime dispatch --------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/__support/architectures.h"
+
+#if defined(LLVM_LIBC_ARCH_X86_64)
+
+#include "src/__support/CPP/Array.h"
+#include "src/string/memory_utils/x86_dispatch.h"
+#include "utils/UnitTest/Test.h"
+
+namespace __llvm_libc {
+namespace x86 {
+
+using Data = cpp::Array<char, 8192>;
+
+static constexpr size_t kSizes[] = {128, 129, 255, 256, 257, 1000, 4095, 4096};
+
+// Runs `test` with each kernel the host supports, and each strategy the
+// kernels pick from.
+template <typename CopyOrSet>
+static void for_each_kernel_and_strategy(CopyOrSet test) {
+  const CpuFeatures features = get_cpu_features();
+  const DispatchThresholds strategies[] = {
+      {SIZE_MAX, SIZE_MAX}, // Vector loop.
+      {0, SIZE_MAX},        // `rep movsb` / `rep stosb`.
+      {SIZE_MAX, 0},        // Non-temporal stores.
+  };
+  for (const DispatchThresholds &strategy : strategies) {
+    dispatch_thresholds() = strategy;
+    test(copy_large_sse2, set_large_sse2);
+    if (features.avx2)
+      test(copy_large_avx2, set_large_avx2);
+    if (features.avx512)
+      test(copy_large_avx512, set_large_avx512);
+  }
+  dispatch_thresholds() = {SIZE_MAX, SIZE_MAX};
+}
+
+TEST(LlvmLibcX86DispatchTest, CopyLarge) {
+  Data groundtruth;
+  for (size_t i = 0; i < groundtruth.size(); ++i)
+    groundtruth[i] = static_cast<char>(i * 7 + 3);
+  for_each_kernel_and_strategy([&](CopyLargeFn copy, SetLargeFn) {
+    for (size_t count : kSizes) {
+      for (size_t align = 0; align < 64; ++align) {
+        Data buffer;
+        for (auto &c : buffer)
+          c = 'x';
+        copy(&buffer[align], &groundtruth[1], count);
+        for (size_t i = 0; i < buffer.size(); ++i) {
+          const bool copied = i >= align && i < align + count;
+          ASSERT_EQ(buffer[i], copied ? groundtruth[1 + i - align] : 'x');
+        }
+      }
+    }
+  });
+}
+
+TEST(LlvmLibcX86DispatchTest, SetLarge) {
+  for_each_kernel_and_strategy([&](CopyLargeFn, SetLargeFn set) {
+    for (size_t count : kSizes) {
+      for (size_t align = 0; align < 64; ++align) {
+        Data buffer;
+        for (auto &c : buffer)
+          c = 'x';
+        set(&buffer[align], 0xA5, count);
+        for (size_t i = 0; i < buffer.size(); ++i) {
+          const bool set = i >= align && i < align + count;
+          ASSERT_EQ(buffer[i], set ? char(0xA5) : 'x');
+        }
+      }
+    }
+  });
+}
+
+TEST(LlvmLibcX86DispatchTest, Thresholds) {
+  CpuFeatures features;
+  features.last_level_cache_share = 8 * 1024 * 1024;
+  DispatchThresholds thresholds = compute_dispatch_thresholds(features, 32);
+  EXPECT_EQ(thresholds.rep_string, SIZE_MAX);
+  EXPECT_EQ(thresholds.non_temporal, size_t(6 * 1024 * 1024));
+  features.erms = true;
+  thresholds = compute_dispatch_thresholds(features, 32);
+  EXPECT_EQ(thresholds.rep_string, size_t(4096));
+  features.fsrm = true;
+  thresholds = compute_dispatch_thresholds(features, 32);
+  EXPECT_EQ(thresholds.rep_string, size_t(2048));
+  features.last_level_cache_share = 0;
+  thresholds = compute_dispatch_thresholds(features, 32);
+  EXPECT_EQ(thresholds.non_temporal, size_t(768 * 1024));
+}
+
+} // namespace x86
+} // namespace __llvm_libc
+
+#endif // defined(LLVM_LIBC_ARCH_X86_64)
@@ -0,0 +1,128 @@
+//===-- Unittests for scan_utils ------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/scan_utils.h"
+#include "utils/UnitTest/Test.h"
+
+namespace __llvm_libc {
+
+// Covers the strings starting at each offset of a block and ending in each of
+// the next few blocks, surrounded by bytes which would end the scan if they
+// were read as part of the string.
+static constexpr size_t MAX_OFFSET = 64;
+static constexpr size_t MAX_LENGTH = 160;
+static constexpr size_t BUFFER_SIZE = MAX_OFFSET + MAX_LENGTH + MAX_OFFSET;
+
+struct Buffer {
+  alignas(MAX_OFFSET) char data[BUFFER_SIZE];
+
+  // Fills the buffer with 'outside' and returns a string of 'length' copies of
+  // 'inside' at 'offset'.
+  char *string(size_t offset, size_t length, char inside, char outside) {
+    for (size_t i = 0; i < BUFFER_SIZE; ++i)
+      data[i] = outside;
+    char *str = data + offset;
+    for (size_t i = 0; i < length; ++i)
+      str[i] = inside;
+    str[length] = '\0';
+    return str;
+  }
+};
+
+TEST(LlvmLibcScanUtilsTest, StringLength) {
+  Buffer buffer;
+  for (size_t offset = 0; offset < MAX_OFFSET; ++offset)
+    for (size_t length = 0; length < MAX_LENGTH; ++length)
+      ASSERT_EQ(scan::string_length(buffer.string(offset, length, 'a', '\0')),
+                length);
+}
+
+TEST(LlvmLibcScanUtilsTest, FindByte) {
+  Buffer buffer;
+  for (size_t offset = 0; offset < MAX_OFFSET; ++offset) {
+    for (size_t length = 0; length < MAX_LENGTH; ++length) {
+      const unsigned char *str = reinterpret_cast<const unsigned char *>(
+          buffer.string(offset, length, 'a', '\xff'));
+      const unsigned char *not_found = nullptr;
+      // The terminator is the only match, and is found when in range.
+      for (size_t n = 0; n < length + 2; ++n)
+        ASSERT_EQ(scan::find_byte(str, '\0', n),
+                  n > length ? str + length : not_found);
+      // The bytes outside of the range are not matched.
+      ASSERT_EQ(scan::find_byte(str, '\xff', length), not_found);
+    }
+  }
+}
+
+TEST(LlvmLibcScanUtilsTest, FindByteOrZero) {
+  Buffer buffer;
+  for (size_t offset = 0; offset < MAX_OFFSET; ++offset) {
+    for (size_t length = 1; length < MAX_LENGTH; ++length) {
+      char *str = buffer.string(offset, length, 'a', 'b');
+      const char *first = str;
+      const char *last = str + length - 1;
+      ASSERT_EQ(scan::find_byte_or_zero(str, 'b'), last + 1);
+      str[length - 1] = 'b';
+      ASSERT_EQ(scan::find_byte_or_zero(str, 'b'), last);
+      str[0] = '\x80';
+      ASSERT_EQ(scan::find_byte_or_zero(str, '\x80'), first);
+    }
+  }
+}
+
+TEST(LlvmLibcScanUtilsTest, Span) {
+  const char set[] = "ab\xff\t;,.:";
+  static_assert(sizeof(set) - 1 == scan::MAX_SET_SIZE, "");
+  Buffer buffer;
+  for (size_t size = 1; size <= scan::MAX_SET_SIZE; ++size) {
+    const char last = set[size - 1];
+    for (size_t offset = 0; offset < MAX_OFFSET; ++offset) {
+      for (size_t length = 0; length < MAX_LENGTH; ++length) {
+        char *str = buffer.string(offset, length, last, last);
+        ASSERT_EQ(scan::span<true>(str, set, size), length);
+        ASSERT_EQ(scan::span<false>(str, set, size), size_t(0));
+        str = buffer.string(offset, length, 'z', last);
+        ASSERT_EQ(scan::span<true>(str, set, size), size_t(0));
+        ASSERT_EQ(scan::span<false>(str, set, size), length);
+      }
+    }
+  }
+}
+
+TEST(LlvmLibcScanUtilsTest, CompareStrings) {
+  Buffer left_buffer;
+  Buffer right_buffer;
+  // Each pair of offsets, modulo the size of the largest block.
+  for (size_t left_offset = 0; left_offset < 32; ++left_offset) {
+    for (size_t right_offset = 0; right_offset < 32; ++right_offset) {
+      for (size_t length = 0; length < MAX_LENGTH; length += 7) {
+        const unsigned char *left = reinterpret_cast<const unsigned char *>(
+            left_buffer.string(left_offset, length, 'a', 'c'));
+        unsigned char *right = reinterpret_cast<unsigned char *>(
+            right_buffer.string(right_offset, length, 'a', 'b'));
+        ASSERT_EQ(scan::compare_strings(left, right), 0);
+        if (length == 0)
+          continue;
+        // Compares the characters as unsigned.
+        right[length - 1] = 0x80;
+        ASSERT_LT(scan::compare_strings(left, right), 0);
+        ASSERT_GT(scan::compare_strings(right, left), 0);
+        // Stops at the first difference.
+        right[0] = 'b';
+        ASSERT_LT(scan::compare_strings(left, right), 0);
+        right[length - 1] = 'a';
+        right[0] = 'a';
+        // A prefix is smaller.
+        right[length - 1] = '\0';
+        ASSERT_GT(scan::compare_strings(left, right), 0);
+      }
+    }
+  }
+}
+
+} // namespace __llvm_libc
@@ -48,3 +48,9 @@ TEST(LlvmLibcStrCSpnTest, DuplicatedCharactersNotPartOfComplementarySpan) {
   EXPECT_EQ(__llvm_libc::strcspn("aaaa", "aa"), size_t{0});
   EXPECT_EQ(__llvm_libc::strcspn("aaaa", "baa"), size_t{0});
 }
+
+TEST(LlvmLibcStrCSpnTest, CharactersAboveSevenBits) {
+  EXPECT_EQ(__llvm_libc::strcspn("ab\xff", "\xff"), size_t{2});
+  // Larger segments are looked up in a bitset.
+  EXPECT_EQ(__llvm_libc::strcspn("ab\x80\xff", "0123456789\x80"), size_t{2});
+}
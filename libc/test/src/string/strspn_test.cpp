@@ -83,3 +83,10 @@ TEST(LlvmLibcStrSpnTest, DuplicatedCharactersToBeSearchedForShouldStillMatch) {
   EXPECT_EQ(__llvm_libc::strspn("aaa", "aa"), size_t{3});
   EXPECT_EQ(__llvm_libc::strspn("aaaa", "aa"), size_t{4});
 }
+
+TEST(LlvmLibcStrSpnTest, CharactersAboveSevenBits) {
+  EXPECT_EQ(__llvm_libc::strspn("\xff\xff" "a", "\xff"), size_t{2});
+  // Larger segments are looked up in a bitset.
+  EXPECT_EQ(__llvm_libc::strspn("\x80\xff" "a", "0123456789\x80\xff"),
+            size_t{2});
+}
@@ -14,10 +14,10 @@
 
 namespace {
 
-enum class ValueType { Uint32, Uint64, Pair, Tuple, String };
-struct AllValueTypes : EnumValuesAsTuple<AllValueTypes, ValueType, 5> {
+enum class ValueType { Uint32, Uint64, Float, Double, Pair, Tuple, String };
+struct AllValueTypes : EnumValuesAsTuple<AllValueTypes, ValueType, 7> {
   static constexpr const char* Names[] = {
-      "uint32", "uint64", "pair<uint32, uint32>",
+      "uint32", "uint64", "float", "double", "pair<uint32, uint32>",
       "tuple<uint32, uint64, uint32>", "string"};
 };
 
@@ -27,10 +27,14 @@ using Value = std::conditional_t<
     std::conditional_t<
         V() == ValueType::Uint64, uint64_t,
         std::conditional_t<
-            V() == ValueType::Pair, std::pair<uint32_t, uint32_t>,
-            std::conditional_t<V() == ValueType::Tuple,
-                               std::tuple<uint32_t, uint64_t, uint32_t>,
-                               std::string> > > >;
+            V() == ValueType::Float, float,
+            std::conditional_t<
+                V() == ValueType::Double, double,
+                std::conditional_t<
+                    V() == ValueType::Pair, std::pair<uint32_t, uint32_t>,
+                    std::conditional_t<V() == ValueType::Tuple,
+                                       std::tuple<uint32_t, uint64_t, uint32_t>,
+                                       std::string> > > > > >;
 
 enum class Order {
   Random,
@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+
+#include "CartesianBenchmarks.h"
+
+namespace {
+
+// The ranges hold zeros, except for a one in their last element, so that the
+// algorithms look at every element.
+template <class IntT>
+struct TestIntBase {
+  static std::vector<IntT> generateInput(size_t size) {
+    std::vector<IntT> Res(size);
+    Res.back() = 1;
+    return Res;
+  }
+};
+
+struct TestUint8 : TestIntBase<std::uint8_t> {
+  static constexpr const char* Name = "TestUint8";
+};
+
+struct TestInt16 : TestIntBase<std::int16_t> {
+  static constexpr const char* Name = "TestInt16";
+};
+
+struct TestInt32 : TestIntBase<std::int32_t> {
+  static constexpr const char* Name = "TestInt32";
+};
+
+struct TestInt64 : TestIntBase<std::int64_t> {
+  static constexpr const char* Name = "TestInt64";
+};
+
+using AllTestTypes = std::tuple<TestUint8, TestInt16, TestInt32, TestInt64>;
+
+struct FindAlg {
+  template <class V>
+  static void run(const V& Data, const V&) {
+    benchmark::DoNotOptimize(std::find(Data.begin(), Data.end(), Data.back()));
+  }
+
+  static constexpr const char* Name = "FindAlg";
+};
+
+struct CountAlg {
+  template <class V>
+  static void run(const V& Data, const V&) {
+    benchmark::DoNotOptimize(std::count(Data.begin(), Data.end(), Data.back()));
+  }
+
+  static constexpr const char* Name = "CountAlg";
+};
+
+struct MismatchAlg {
+  template <class V>
+  static void run(const V& Data, const V& Other) {
+    benchmark::DoNotOptimize(std::mismatch(Data.begin(), Data.end(), Other.begin()));
+  }
+
+  static constexpr const char* Name = "MismatchAlg";
+};
+
+struct EqualAlg {
+  template <class V>
+  static void run(const V& Data, const V& Other) {
+    benchmark::DoNotOptimize(std::equal(Data.begin(), Data.end(), Other.begin(), Other.end()));
+  }
+
+  static constexpr const char* Name = "EqualAlg";
+};
+
+struct MinElementAlg {
+  template <class V>
+  static void run(const V& Data, const V&) {
+    benchmark::DoNotOptimize(std::min_element(Data.begin(), Data.end()));
+  }
+
+  static constexpr const char* Name = "MinElementAlg";
+};
+
+struct MaxElementAlg {
+  template <class V>
+  static void run(const V& Data, const V&) {
+    benchmark::DoNotOptimize(std::max_element(Data.begin(), Data.end()));
+  }
+
+  static constexpr const char* Name = "MaxElementAlg";
+};
+
+using AllAlgs = std::tuple<FindAlg, CountAlg, MismatchAlg, EqualAlg, MinElementAlg, MaxElementAlg>;
+
+template <class Alg, class TestType>
+struct FindBench {
+  size_t Quantity;
+
+  std::string name() const {
+    return std::string("FindBench_") + Alg::Name + "_" + TestType::Name + '/' + std::to_string(Quantity);
+  }
+
+  void run(benchmark::State& state) const {
+    auto Data = TestType::generateInput(Quantity);
+    auto Other = Data;
+    Other.back() = 2;
+
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(Data);
+      Alg::run(Data, Other);
+    }
+  }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+
+  const std::vector<size_t> Quantities = {1 << 4, 1 << 8, 1 << 12, 1 << 16};
+  makeCartesianProductBenchmark<FindBench, AllAlgs, AllTestTypes>(Quantities);
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -0,0 +1,136 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+#include <utility>
+
+#include "CartesianBenchmarks.h"
+#include "benchmark/benchmark.h"
+#include "test_macros.h"
+
+// Compares std::function and std::move_only_function on callables of growing
+// size, and reports how often they allocate.
+
+#ifdef __cpp_lib_move_only_function
+
+static long AllocationCount = 0;
+
+void* operator new(std::size_t size) {
+  ++AllocationCount;
+  if (void* p = std::malloc(size ? size : 1))
+    return p;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+enum class WrapperType { Function, MoveOnlyFunction };
+
+struct AllWrapperTypes : EnumValuesAsTuple<AllWrapperTypes, WrapperType, 2> {
+  static constexpr const char* Names[] = {"Function", "MoveOnlyFunction"};
+};
+
+// The number of pointers captured by the callable.
+enum class CaptureSize { One, Two, Four, Six, Sixteen };
+
+struct AllCaptureSizes : EnumValuesAsTuple<AllCaptureSizes, CaptureSize, 5> {
+  static constexpr const char* Names[] = {"Capture1", "Capture2", "Capture4", "Capture6", "Capture16"};
+};
+
+template <int N>
+struct Functor {
+  void* captures[N];
+  int operator()(int x) const { return captures[0] == nullptr ? x : 0; }
+};
+
+template <WrapperType W>
+using Wrapper = std::conditional_t<W == WrapperType::Function, std::function<int(int)>,
+                                   std::move_only_function<int(int) const>>;
+
+template <WrapperType W>
+TEST_ALWAYS_INLINE inline Wrapper<W> MakeWrapper(CaptureSize size) {
+  switch (size) {
+  case CaptureSize::One:
+    return maybeOpaque(Functor<1>{}, true);
+  case CaptureSize::Two:
+    return maybeOpaque(Functor<2>{}, true);
+  case CaptureSize::Four:
+    return maybeOpaque(Functor<4>{}, true);
+  case CaptureSize::Six:
+    return maybeOpaque(Functor<6>{}, true);
+  case CaptureSize::Sixteen:
+    return maybeOpaque(Functor<16>{}, true);
+  }
+  return nullptr;
+}
+
+template <class Wrapper, class Size>
+struct ConstructAndDestroy {
+  static void run(benchmark::State& state) {
+    long allocations = AllocationCount;
+    for (auto _ : state)
+      benchmark::DoNotOptimize(MakeWrapper<Wrapper()>(Size()));
+    state.counters["allocs_per_iter"] =
+        benchmark::Counter(AllocationCount - allocations, benchmark::Counter::kAvgIterations);
+  }
+
+  static std::string name() { return "BM_ConstructAndDestroy" + Wrapper::name() + Size::name(); }
+};
+
+template <class Wrapper, class Size>
+struct Move {
+  static void run(benchmark::State& state) {
+    decltype(MakeWrapper<Wrapper()>(Size())) values[2] = {MakeWrapper<Wrapper()>(Size())};
+    int i = 0;
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(values);
+      benchmark::DoNotOptimize(values[i ^ 1] = std::move(values[i]));
+      i ^= 1;
+    }
+  }
+
+  static std::string name() { return "BM_Move" + Wrapper::name() + Size::name(); }
+};
+
+template <class Wrapper, class Size>
+struct Invoke {
+  static void run(benchmark::State& state) {
+    const auto value = MakeWrapper<Wrapper()>(Size());
+    for (auto _ : state) {
+      benchmark::DoNotOptimize(value);
+      benchmark::DoNotOptimize(value(42));
+    }
+  }
+
+  static std::string name() { return "BM_Invoke" + Wrapper::name() + Size::name(); }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+
+  makeCartesianProductBenchmark<ConstructAndDestroy, AllWrapperTypes, AllCaptureSizes>();
+  makeCartesianProductBenchmark<Move, AllWrapperTypes, AllCaptureSizes>();
+  makeCartesianProductBenchmark<Invoke, AllWrapperTypes, AllCaptureSizes>();
+  benchmark::RunSpecifiedBenchmarks();
+}
+
+#else
+
+int main(int, char**) { return 0; }
+
+#endif // __cpp_lib_move_only_function
@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+
+#include "benchmark/benchmark.h"
+
+// Measures how shared_mutex and shared_timed_mutex scale with the number of
+// threads which use them at the same time, when the threads only read, and
+// when one operation in WriteEvery writes, and how atomic::notify_all scales.
+
+namespace {
+
+template <class Mutex>
+struct Shared {
+  Mutex mutex;
+  long value = 0;
+};
+
+template <class Mutex, int WriteEvery>
+void BM_ReadMostly(benchmark::State& state) {
+  static Shared<Mutex> shared;
+  int i = 0;
+  for (auto _ : state) {
+    if (WriteEvery != 0 && ++i == WriteEvery) {
+      i = 0;
+      std::unique_lock<Mutex> lock(shared.mutex);
+      ++shared.value;
+    } else {
+      std::shared_lock<Mutex> lock(shared.mutex);
+      benchmark::DoNotOptimize(shared.value);
+    }
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_ReadMostly, std::shared_mutex, 0)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ReadMostly, std::shared_mutex, 100)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ReadMostly, std::shared_timed_mutex, 0)->ThreadRange(1, 32)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_ReadMostly, std::shared_timed_mutex, 100)->ThreadRange(1, 32)->UseRealTime();
+
+// Notifying an atomic which nobody waits for looks up its entry in the table
+// of waiters of the library, and checks that it has none.
+void BM_AtomicNotifyAll(benchmark::State& state) {
+  static std::atomic<unsigned> counter{0};
+  for (auto _ : state) {
+    counter.fetch_add(1, std::memory_order_relaxed);
+    counter.notify_all();
+  }
+}
+
+BENCHMARK(BM_AtomicNotifyAll)->ThreadRange(1, 32)->UseRealTime();
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,174 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// Benchmarks of std::unordered_map with the kinds of keys found in real
+// programs. Build with -D_LIBCPP_ABI_HASH_TABLE_POWER2_BUCKETS to compare the
+// power of two bucket counts with the default prime bucket counts.
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "CartesianBenchmarks.h"
+#include "benchmark/benchmark.h"
+#include "test_macros.h"
+
+namespace {
+
+// The kinds of keys:
+// - Id: consecutive integers, like database or entity ids.
+// - Pointer: integers which are multiples of 64, like addresses of objects.
+//   std::hash leaves them unchanged, so the low bits of the hashes are zero.
+// - Path: strings of about 30 characters, like file paths or URLs.
+// - Name: short strings, like identifiers.
+enum class KeyKind { Id, Pointer, Path, Name };
+struct AllKeyKinds : EnumValuesAsTuple<AllKeyKinds, KeyKind, 4> {
+  static constexpr const char* Names[] = {"Id", "Pointer", "Path", "Name"};
+};
+
+enum class Mode { Hit, Miss };
+struct AllModes : EnumValuesAsTuple<AllModes, Mode, 2> {
+  static constexpr const char* Names[] = {"Hit", "Miss"};
+};
+
+template <class K>
+using KeyType = std::conditional_t<K() == KeyKind::Id || K() == KeyKind::Pointer, uint64_t, std::string>;
+
+template <class K>
+using Map = std::unordered_map<KeyType<K>, uint64_t>;
+
+// Return the I-th key of the given kind. Odd values of I give the keys which
+// are not in the maps.
+template <class K>
+KeyType<K> makeKey(uint64_t I) {
+  if constexpr (K() == KeyKind::Id)
+    return I;
+  else if constexpr (K() == KeyKind::Pointer)
+    return 0x7f0000000000 + I * 64;
+  else if constexpr (K() == KeyKind::Path)
+    return "/usr/share/data/" + std::to_string(I / 1000) + "/item_" + std::to_string(I) + ".txt";
+  else
+    return "v" + std::to_string(I);
+}
+
+// Return the keys to look up, which are in the map for Mode::Hit, in random
+// order.
+template <class K>
+std::vector<KeyType<K> > makeKeys(size_t MapSize, Mode M) {
+  std::vector<KeyType<K> > Keys;
+  for (uint64_t I = 0; I < MapSize; ++I)
+    Keys.push_back(makeKey<K>(2 * I + (M == Mode::Miss)));
+  std::shuffle(Keys.begin(), Keys.end(), std::mt19937());
+  return Keys;
+}
+
+template <class K>
+Map<K> makeMap(size_t MapSize) {
+  Map<K> M;
+  for (uint64_t I = 0; I < MapSize; ++I)
+    M.emplace(makeKey<K>(2 * I), I);
+  return M;
+}
+
+struct Base {
+  size_t MapSize;
+  Base(size_t T) : MapSize(T) {}
+
+  std::string baseName() const { return "_MapSize=" + std::to_string(MapSize); }
+};
+
+template <class K>
+struct Insert : Base {
+  using Base::Base;
+
+  void run(benchmark::State& State) const {
+    auto Keys = makeKeys<K>(MapSize, Mode::Hit);
+    while (State.KeepRunningBatch(MapSize)) {
+      Map<K> M;
+      for (const auto& Key : Keys)
+        M.emplace(Key, 0);
+      benchmark::DoNotOptimize(M);
+    }
+  }
+
+  std::string name() const { return "BM_Insert" + K::name() + baseName(); }
+};
+
+template <class K, class HitOrMiss>
+struct Find : Base {
+  using Base::Base;
+
+  void run(benchmark::State& State) const {
+    auto M = makeMap<K>(MapSize);
+    auto Keys = makeKeys<K>(MapSize, HitOrMiss());
+    while (State.KeepRunningBatch(MapSize)) {
+      for (const auto& Key : Keys)
+        benchmark::DoNotOptimize(M.find(Key));
+    }
+  }
+
+  std::string name() const { return "BM_Find" + K::name() + HitOrMiss::name() + baseName(); }
+};
+
+template <class K>
+struct Iterate : Base {
+  using Base::Base;
+
+  void run(benchmark::State& State) const {
+    auto M = makeMap<K>(MapSize);
+    while (State.KeepRunningBatch(MapSize)) {
+      uint64_t Sum = 0;
+      for (const auto& KV : M)
+        Sum += KV.second;
+      benchmark::DoNotOptimize(Sum);
+    }
+  }
+
+  std::string name() const { return "BM_Iterate" + K::name() + baseName(); }
+};
+
+template <class K>
+struct Erase : Base {
+  using Base::Base;
+
+  void run(benchmark::State& State) const {
+    auto Keys = makeKeys<K>(MapSize, Mode::Hit);
+    auto Initial = makeMap<K>(MapSize);
+    while (State.KeepRunningBatch(MapSize)) {
+      State.PauseTiming();
+      Map<K> M = Initial;
+      State.ResumeTiming();
+      for (const auto& Key : Keys)
+        M.erase(Key);
+      benchmark::DoNotOptimize(M);
+    }
+  }
+
+  std::string name() const { return "BM_Erase" + K::name() + baseName(); }
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv))
+    return 1;
+
+  const std::vector<size_t> MapSize{100, 10000, 1000000};
+
+  makeCartesianProductBenchmark<Insert, AllKeyKinds>(MapSize);
+  makeCartesianProductBenchmark<Find, AllKeyKinds, AllModes>(MapSize);
+  makeCartesianProductBenchmark<Iterate, AllKeyKinds>(MapSize);
+  makeCartesianProductBenchmark<Erase, AllKeyKinds>(MapSize);
+
+  benchmark::RunSpecifiedBenchmarks();
+}
@@ -10,6 +10,8 @@
 #ifndef _LIBCPP___ALGORITHM_COUNT_H
 #define _LIBCPP___ALGORITHM_COUNT_H
 
+#include <__algorithm/simd_utils.h>
+#include <__algorithm/unwrap_iter.h>
 #include <__config>
 #include <__iterator/iterator_traits.h>
 
@@ -20,9 +22,8 @@
 _LIBCPP_BEGIN_NAMESPACE_STD
 
 template <class _InputIterator, class _Tp>
-_LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY _LIBCPP_CONSTEXPR_AFTER_CXX17
-    typename iterator_traits<_InputIterator>::difference_type
-    count(_InputIterator __first, _InputIterator __last, const _Tp& __value_) {
+inline _LIBCPP_INLINE_VISIBILITY _LIBCPP_CONSTEXPR_AFTER_CXX17 typename iterator_traits<_InputIterator>::difference_type
+__count(_InputIterator __first, _InputIterator __last, const _Tp& __value_) {
   typename iterator_traits<_InputIterator>::difference_type __r(0);
   for (; __first != __last; ++__first)
     if (*__first == __value_)
@@ -30,6 +31,24 @@ _LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY _LIBCPP_CONSTEXPR_AFTER_C
   return __r;
 }
 
+#if defined(_LIBCPP_HAS_ALGORITHM_VECTORIZATION)
+template <class _Tp, class _Up>
+inline _LIBCPP_INLINE_VISIBILITY typename enable_if<__can_simd_find<_Tp, _Up>::value, ptrdiff_t>::type
+__count(_Tp* __first, _Tp* __last, const _Up& __value_) {
+  return _VSTD::__simd_count(__first, __last, __value_);
+}
+#endif
+
+template <class _InputIterator, class _Tp>
+_LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY _LIBCPP_CONSTEXPR_AFTER_CXX17
+    typename iterator_traits<_InputIterator>::difference_type
+    count(_InputIterator __first, _InputIterator __last, const _Tp& __value_) {
+  // The explicit template arguments select the scalar loop, which is constexpr.
+  if (__libcpp_is_constant_evaluated())
+    return _VSTD::__count<_InputIterator, _Tp>(__first, __last, __value_);
+  return _VSTD::__count(_VSTD::__unwrap_iter(__first), _VSTD::__unwrap_iter(__last), __value_);
+}
+
 _LIBCPP_END_NAMESPACE_STD
 
 #endif // _LIBCPP___ALGORITHM_COUNT_H
@@ -11,6 +11,8 @@
 
 #include <__algorithm/comp.h>
 #include <__algorithm/comp_ref_type.h>
+#include <__algorithm/simd_utils.h>
+#include <__algorithm/unwrap_iter.h>
 #include <__config>
 #include <__iterator/iterator_traits.h>
 
@@ -36,12 +38,28 @@ __max_element(_ForwardIterator __first, _ForwardIterator __last, _Compare __comp
     return __first;
 }
 
+#if defined(_LIBCPP_HAS_ALGORITHM_VECTORIZATION)
+template <class _Compare, class _Tp>
+inline _LIBCPP_HIDE_FROM_ABI
+typename enable_if<__can_simd_min_max<_Tp, _Compare>::value, _Tp*>::type
+__max_element(_Tp* __first, _Tp* __last, _Compare __comp)
+{
+    if (__last - __first < static_cast<ptrdiff_t>(__simd_vector_bytes / sizeof(_Tp)))
+        return _VSTD::__max_element<_Compare, _Tp*>(__first, __last, __comp);
+    return _VSTD::__simd_min_max_element<true>(__first, __last);
+}
+#endif
+
 template <class _ForwardIterator, class _Compare>
 _LIBCPP_NODISCARD_EXT inline _LIBCPP_HIDE_FROM_ABI _LIBCPP_CONSTEXPR_AFTER_CXX11 _ForwardIterator
 max_element(_ForwardIterator __first, _ForwardIterator __last, _Compare __comp)
 {
     typedef typename __comp_ref_type<_Compare>::type _Comp_ref;
-    return _VSTD::__max_element<_Comp_ref>(__first, __last, __comp);
+    // The explicit template arguments select the scalar loop, which is constexpr.
+    if (__libcpp_is_constant_evaluated())
+        return _VSTD::__max_element<_Comp_ref, _ForwardIterator>(__first, __last, __comp);
+    return _VSTD::__rewrap_iter(__first,
+        _VSTD::__max_element<_Comp_ref>(_VSTD::__unwrap_iter(__first), _VSTD::__unwrap_iter(__last), __comp));
 }
 
 
@@ -11,6 +11,8 @@
 #define _LIBCPP___ALGORITHM_MISMATCH_H
 
 #include <__algorithm/comp.h>
+#include <__algorithm/simd_utils.h>
+#include <__algorithm/unwrap_iter.h>
 #include <__config>
 #include <__iterator/iterator_traits.h>
 #include <utility>
@@ -22,15 +24,43 @@
 _LIBCPP_BEGIN_NAMESPACE_STD
 
 template <class _InputIterator1, class _InputIterator2, class _BinaryPredicate>
-_LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
-    _LIBCPP_CONSTEXPR_AFTER_CXX17 pair<_InputIterator1, _InputIterator2>
-    mismatch(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2, _BinaryPredicate __pred) {
+inline _LIBCPP_INLINE_VISIBILITY _LIBCPP_CONSTEXPR_AFTER_CXX17 pair<_InputIterator1, _InputIterator2>
+__mismatch(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2, _BinaryPredicate& __pred) {
   for (; __first1 != __last1; ++__first1, (void)++__first2)
     if (!__pred(*__first1, *__first2))
       break;
   return pair<_InputIterator1, _InputIterator2>(__first1, __first2);
 }
 
+#if defined(_LIBCPP_HAS_ALGORITHM_VECTORIZATION)
+template <class _Tp, class _Up, class _BinaryPredicate>
+inline _LIBCPP_INLINE_VISIBILITY
+    typename enable_if<__can_simd_mismatch<_Tp, _Up, _BinaryPredicate>::value, pair<_Tp*, _Up*> >::type
+    __mismatch(_Tp* __first1, _Tp* __last1, _Up* __first2, _BinaryPredicate&) {
+  return _VSTD::__simd_mismatch(__first1, __last1, __first2);
+}
+#endif
+
+template <class _InputIterator1, class _InputIterator2, class _Tp, class _Up>
+inline _LIBCPP_INLINE_VISIBILITY pair<_InputIterator1, _InputIterator2>
+__rewrap_mismatch(_InputIterator1 __first1, _InputIterator2 __first2, pair<_Tp, _Up> __r) {
+  return pair<_InputIterator1, _InputIterator2>(_VSTD::__rewrap_iter(__first1, __r.first),
+                                                _VSTD::__rewrap_iter(__first2, __r.second));
+}
+
+template <class _InputIterator1, class _InputIterator2, class _BinaryPredicate>
+_LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
+    _LIBCPP_CONSTEXPR_AFTER_CXX17 pair<_InputIterator1, _InputIterator2>
+    mismatch(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2, _BinaryPredicate __pred) {
+  // The explicit template arguments select the scalar loop, which is constexpr.
+  if (__libcpp_is_constant_evaluated())
+    return _VSTD::__mismatch<_InputIterator1, _InputIterator2, _BinaryPredicate>(__first1, __last1, __first2, __pred);
+  return _VSTD::__rewrap_mismatch(
+      __first1, __first2,
+      _VSTD::__mismatch(_VSTD::__unwrap_iter(__first1), _VSTD::__unwrap_iter(__last1), _VSTD::__unwrap_iter(__first2),
+                        __pred));
+}
+
 template <class _InputIterator1, class _InputIterator2>
 _LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
     _LIBCPP_CONSTEXPR_AFTER_CXX17 pair<_InputIterator1, _InputIterator2>
@@ -42,16 +72,40 @@ _LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
 
 #if _LIBCPP_STD_VER > 11
 template <class _InputIterator1, class _InputIterator2, class _BinaryPredicate>
-_LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
-    _LIBCPP_CONSTEXPR_AFTER_CXX17 pair<_InputIterator1, _InputIterator2>
-    mismatch(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2, _InputIterator2 __last2,
-             _BinaryPredicate __pred) {
+inline _LIBCPP_INLINE_VISIBILITY _LIBCPP_CONSTEXPR_AFTER_CXX17 pair<_InputIterator1, _InputIterator2>
+__mismatch(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2, _InputIterator2 __last2,
+           _BinaryPredicate& __pred) {
   for (; __first1 != __last1 && __first2 != __last2; ++__first1, (void)++__first2)
     if (!__pred(*__first1, *__first2))
       break;
   return pair<_InputIterator1, _InputIterator2>(__first1, __first2);
 }
 
+#if defined(_LIBCPP_HAS_ALGORITHM_VECTORIZATION)
+template <class _Tp, class _Up, class _BinaryPredicate>
+inline _LIBCPP_INLINE_VISIBILITY
+    typename enable_if<__can_simd_mismatch<_Tp, _Up, _BinaryPredicate>::value, pair<_Tp*, _Up*> >::type
+    __mismatch(_Tp* __first1, _Tp* __last1, _Up* __first2, _Up* __last2, _BinaryPredicate&) {
+  if (__last2 - __first2 < __last1 - __first1)
+    __last1 = __first1 + (__last2 - __first2);
+  return _VSTD::__simd_mismatch(__first1, __last1, __first2);
+}
+#endif
+
+template <class _InputIterator1, class _InputIterator2, class _BinaryPredicate>
+_LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
+    _LIBCPP_CONSTEXPR_AFTER_CXX17 pair<_InputIterator1, _InputIterator2>
+    mismatch(_InputIterator1 __first1, _InputIterator1 __last1, _InputIterator2 __first2, _InputIterator2 __last2,
+             _BinaryPredicate __pred) {
+  if (__libcpp_is_constant_evaluated())
+    return _VSTD::__mismatch<_InputIterator1, _InputIterator2, _BinaryPredicate>(__first1, __last1, __first2, __last2,
+                                                                                 __pred);
+  return _VSTD::__rewrap_mismatch(__first1, __first2,
+                                  _VSTD::__mismatch(_VSTD::__unwrap_iter(__first1), _VSTD::__unwrap_iter(__last1),
+                                                    _VSTD::__unwrap_iter(__first2), _VSTD::__unwrap_iter(__last2),
+                                                    __pred));
+}
+
 template <class _InputIterator1, class _InputIterator2>
 _LIBCPP_NODISCARD_EXT inline _LIBCPP_INLINE_VISIBILITY
     _LIBCPP_CONSTEXPR_AFTER_CXX17 pair<_InputIterator1, _InputIterator2>
@@ -0,0 +1,240 @@
+// -*- C++ -*-
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _LIBCPP___ALGORITHM_SIMD_UTILS_H
+#define _LIBCPP___ALGORITHM_SIMD_UTILS_H
+
+#include <__algorithm/comp.h>
+#include <__config>
+#include <__utility/pair.h>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
+#pragma GCC system_header
+#endif
+
+// Clang and GCC both support vector types declared with the vector_size
+// attribute. They lower operations on them to the SIMD instructions of the
+// target, which are part of the baseline of x86-64 and AArch64, and to scalar
+// code on targets without SIMD instructions.
+#if defined(_LIBCPP_COMPILER_CLANG_BASED) || defined(_LIBCPP_COMPILER_GCC)
+#  define _LIBCPP_HAS_ALGORITHM_VECTORIZATION
+#endif
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+#if defined(_LIBCPP_HAS_ALGORITHM_VECTORIZATION)
+
+// The vectorized algorithms work on 16 byte vectors, the width of SSE2 and
+// NEON registers.
+static const size_t __simd_vector_bytes = 16;
+
+template <class _Ep>
+struct __simd_vector {
+  typedef _Ep type __attribute__((__vector_size__(16)));
+};
+
+typedef __simd_vector<uint64_t>::type __simd_u64_vector;
+
+// x86 only has comparisons of 64 bit lanes for equality since SSE4.1, and for
+// ordering since SSE4.2. Emulating them is slower than the scalar loops.
+#if (defined(__i386__) || defined(__x86_64__)) && !defined(__SSE4_1__)
+static const bool __simd_has_64_bit_equality = false;
+#else
+static const bool __simd_has_64_bit_equality = true;
+#endif
+#if (defined(__i386__) || defined(__x86_64__)) && !defined(__SSE4_2__)
+static const bool __simd_has_64_bit_ordering = false;
+#else
+static const bool __simd_has_64_bit_ordering = true;
+#endif
+
+// Whether elements of type _Tp are equal if and only if their bits are. bool
+// is left out, since other bit patterns than those of true and false are not
+// equal to either.
+template <class _Tp>
+struct __simd_bitwise_equality
+    : integral_constant<bool, (is_integral<_Tp>::value || is_pointer<_Tp>::value) && !is_same<_Tp, bool>::value &&
+                                  sizeof(_Tp) <= 8> {};
+
+// The integer type whose values are compared instead of those of _Tp when
+// looking for elements equal to a value, or void.
+template <class _Tp, bool = __simd_bitwise_equality<_Tp>::value &&
+                            (sizeof(_Tp) < 8 || __simd_has_64_bit_equality)>
+struct __simd_equality_element {
+  typedef void type;
+};
+
+template <class _Tp>
+struct __simd_equality_element<_Tp, true> {
+  typedef typename conditional<sizeof(_Tp) == 1, uint8_t,
+          typename conditional<sizeof(_Tp) == 2, uint16_t,
+          typename conditional<sizeof(_Tp) == 4, uint32_t, uint64_t>::type>::type>::type type;
+};
+
+// The integer type whose values are compared instead of those of _Tp when
+// looking for the smallest or largest element, or void.
+template <class _Tp, bool = is_integral<_Tp>::value>
+struct __simd_ordered_element {
+  typedef void type;
+};
+
+template <class _Tp>
+struct __simd_ordered_element<_Tp, true> {
+  typedef typename conditional<
+      is_same<_Tp, bool>::value || (sizeof(_Tp) > 8) || (sizeof(_Tp) == 8 && !__simd_has_64_bit_ordering), void,
+      typename conditional<is_signed<_Tp>::value, typename make_signed<_Tp>::type,
+                           typename make_unsigned<_Tp>::type>::type>::type type;
+};
+
+// Whether find and count of a value of type _Up in a range of _Tp can be
+// vectorized.
+template <class _Tp, class _Up>
+struct __can_simd_find
+    : integral_constant<bool, !is_volatile<_Tp>::value && is_same<typename remove_const<_Tp>::type, _Up>::value &&
+                                  !is_void<typename __simd_equality_element<_Up>::type>::value> {};
+
+// Whether mismatch and equal of ranges of _Tp and _Up compared with _Pred can
+// be vectorized.
+template <class _Tp, class _Up, class _Pred>
+struct __can_simd_mismatch
+    : integral_constant<bool, !is_volatile<_Tp>::value && !is_volatile<_Up>::value &&
+                                  is_same<typename remove_const<_Tp>::type, typename remove_const<_Up>::type>::value &&
+                                  is_same<_Pred, __equal_to<typename remove_const<_Tp>::type> >::value &&
+                                  __simd_bitwise_equality<typename remove_const<_Tp>::type>::value> {};
+
+// Whether min_element and max_element of a range of _Tp compared with _Comp
+// can be vectorized.
+template <class _Tp, class _Comp>
+struct __can_simd_min_max
+    : integral_constant<bool, !is_volatile<_Tp>::value &&
+                                  is_same<typename remove_reference<_Comp>::type,
+                                          __less<typename remove_const<_Tp>::type> >::value &&
+                                  !is_void<typename __simd_ordered_element<typename remove_const<_Tp>::type>::type>::value> {};
+
+template <class _Vec, class _Tp>
+inline _LIBCPP_HIDE_FROM_ABI _Vec __simd_load(const _Tp* __p) {
+  _Vec __v;
+  __builtin_memcpy(&__v, __p, sizeof(__v));
+  return __v;
+}
+
+template <class _Vec, class _Ep, class _Tp>
+inline _LIBCPP_HIDE_FROM_ABI _Vec __simd_splat(const _Tp& __x) {
+  _Ep __e;
+  __builtin_memcpy(&__e, &__x, sizeof(__e));
+  _Vec __v;
+  for (size_t __i = 0; __i != __simd_vector_bytes / sizeof(_Ep); ++__i)
+    __v[__i] = __e;
+  return __v;
+}
+
+// Returns whether any lane of the result of a vector comparison is set.
+template <class _Mask>
+inline _LIBCPP_HIDE_FROM_ABI bool __simd_any(_Mask __m) {
+  __simd_u64_vector __w = (__simd_u64_vector)__m;
+  return (__w[0] | __w[1]) != 0;
+}
+
+// The vectorized algorithms compare a vector of elements at a time, and let a
+// scalar loop find the exact position in the vector with a match, and handle
+// the elements after the last full vector.
+
+template <class _Tp, class _Up>
+inline _LIBCPP_HIDE_FROM_ABI _Tp* __simd_find(_Tp* __first, _Tp* __last, const _Up& __value) {
+  typedef typename __simd_equality_element<_Up>::type _Ep;
+  typedef typename __simd_vector<_Ep>::type _Vec;
+  const ptrdiff_t __n = __simd_vector_bytes / sizeof(_Tp);
+  const _Vec __v = _VSTD::__simd_splat<_Vec, _Ep>(__value);
+  for (; __last - __first >= __n; __first += __n)
+    if (_VSTD::__simd_any(_VSTD::__simd_load<_Vec>(__first) == __v))
+      break;
+  for (; __first != __last; ++__first)
+    if (*__first == __value)
+      break;
+  return __first;
+}
+
+template <class _Tp, class _Up>
+inline _LIBCPP_HIDE_FROM_ABI ptrdiff_t __simd_count(_Tp* __first, _Tp* __last, const _Up& __value) {
+  typedef typename __simd_equality_element<_Up>::type _Ep;
+  typedef typename __simd_vector<_Ep>::type _Vec;
+  const ptrdiff_t __n = __simd_vector_bytes / sizeof(_Tp);
+  const _Vec __v = _VSTD::__simd_splat<_Vec, _Ep>(__value);
+  ptrdiff_t __r = 0;
+  while (__last - __first >= __n) {
+    // Every lane counts the matches in at most 255 vectors, so that it can't
+    // overflow for one byte elements.
+    ptrdiff_t __vectors = (__last - __first) / __n;
+    if (__vectors > 255)
+      __vectors = 255;
+    _Vec __acc = _VSTD::__simd_splat<_Vec, _Ep>(_Ep(0));
+    for (; __vectors != 0; --__vectors, __first += __n)
+      __acc -= (_Vec)(_VSTD::__simd_load<_Vec>(__first) == __v);
+    for (ptrdiff_t __i = 0; __i != __n; ++__i)
+      __r += __acc[__i];
+  }
+  for (; __first != __last; ++__first)
+    if (*__first == __value)
+      ++__r;
+  return __r;
+}
+
+// Two vectors of elements are equal if their bytes are, so the elements are
+// compared as bytes, which all targets compare fastest.
+template <class _Tp, class _Up>
+inline _LIBCPP_HIDE_FROM_ABI pair<_Tp*, _Up*> __simd_mismatch(_Tp* __first1, _Tp* __last1, _Up* __first2) {
+  typedef __simd_vector<uint8_t>::type _Vec;
+  const ptrdiff_t __n = __simd_vector_bytes / sizeof(_Tp);
+  for (; __last1 - __first1 >= __n; __first1 += __n, __first2 += __n)
+    if (_VSTD::__simd_any(_VSTD::__simd_load<_Vec>(__first1) != _VSTD::__simd_load<_Vec>(__first2)))
+      break;
+  for (; __first1 != __last1; ++__first1, (void)++__first2)
+    if (!(*__first1 == *__first2))
+      break;
+  return pair<_Tp*, _Up*>(__first1, __first2);
+}
+
+// Returns the first smallest element of [__first, __last), or the first
+// largest one if _Max is true. The range must hold at least one vector of
+// elements. The smallest value is found with vector operations, then its
+// first position with __simd_find.
+template <bool _Max, class _Tp>
+inline _LIBCPP_HIDE_FROM_ABI _Tp* __simd_min_max_element(_Tp* __first, _Tp* __last) {
+  typedef typename remove_const<_Tp>::type _Vp;
+  typedef typename __simd_ordered_element<_Vp>::type _Ep;
+  typedef typename __simd_vector<_Ep>::type _Vec;
+  const ptrdiff_t __n = __simd_vector_bytes / sizeof(_Tp);
+  _Vec __m = _VSTD::__simd_load<_Vec>(__first);
+  _Tp* __p = __first + __n;
+  for (; __last - __p >= __n; __p += __n) {
+    _Vec __x = _VSTD::__simd_load<_Vec>(__p);
+    _Vec __better = _Max ? (_Vec)(__m < __x) : (_Vec)(__x < __m);
+    __m = (__x & __better) | (__m & ~__better);
+  }
+  // Elements looked at twice don't change the result.
+  if (__p != __last) {
+    _Vec __x = _VSTD::__simd_load<_Vec>(__last - __n);
+    _Vec __better = _Max ? (_Vec)(__m < __x) : (_Vec)(__x < __m);
+    __m = (__x & __better) | (__m & ~__better);
+  }
+  _Ep __r = __m[0];
+  for (ptrdiff_t __i = 1; __i != __n; ++__i)
+    if (_Max ? __r < __m[__i] : __m[__i] < __r)
+      __r = __m[__i];
+  return _VSTD::__simd_find(__first, __last, static_cast<_Vp>(__r));
+}
+
+#endif // _LIBCPP_HAS_ALGORITHM_VECTORIZATION
+
+_LIBCPP_END_NAMESPACE_STD
+
+#endif // _LIBCPP___ALGORITHM_SIMD_UTILS_H
@@ -14,9 +14,14 @@
 #include <__algorithm/min_element.h>
 #include <__algorithm/partial_sort.h>
 #include <__algorithm/unwrap_iter.h>
+#include <__bits>
 #include <__config>
+#include <__functional/operations.h>
+#include <__iterator/iterator_traits.h>
 #include <__utility/swap.h>
+#include <cstdint>
 #include <memory>
+#include <type_traits>
 
 #if defined(_LIBCPP_DEBUG_RANDOMIZE_UNSPECIFIED_STABILITY)
 #  include <__algorithm/shuffle.h>
@@ -123,6 +128,168 @@ __sort5(_ForwardIterator __x1, _ForwardIterator __x2, _ForwardIterator __x3,
     return __r;
 }
 
+// The comparators for which comparing arithmetic values has no side effects and
+// compiles to a single instruction.
+template <class _Compare>
+struct __is_simple_comparator : false_type {};
+template <class _Tp>
+struct __is_simple_comparator<__less<_Tp>&> : true_type {};
+template <class _Tp>
+struct __is_simple_comparator<less<_Tp>&> : true_type {};
+template <class _Tp>
+struct __is_simple_comparator<greater<_Tp>&> : true_type {};
+
+// Sorting networks and branchless partitioning are used for contiguous ranges
+// of small arithmetic values compared with a simple comparator. For these, the
+// results of comparisons are unpredictable but cheap to turn into conditional
+// moves, so avoiding branches beats doing fewer comparisons.
+template <class _Compare, class _Iter, class _Tp = typename iterator_traits<_Iter>::value_type>
+using __use_branchless_sort =
+    integral_constant<bool, __is_cpp17_contiguous_iterator<_Iter>::value && sizeof(_Tp) <= sizeof(void*) &&
+                                is_arithmetic<_Tp>::value && __is_simple_comparator<_Compare>::value>;
+
+// Ensures that *__x is not greater than *__y, without branches.
+template <class _Compare, class _RandomAccessIterator>
+inline _LIBCPP_HIDE_FROM_ABI void __cond_swap(_RandomAccessIterator __x, _RandomAccessIterator __y, _Compare __c) {
+  typedef typename iterator_traits<_RandomAccessIterator>::value_type value_type;
+  bool __r = __c(*__x, *__y);
+  value_type __tmp = __r ? *__x : *__y;
+  *__y = __r ? *__y : *__x;
+  *__x = __tmp;
+}
+
+// Sorts *__x, *__y and *__z without branches, given that *__y is not greater
+// than *__z.
+template <class _Compare, class _RandomAccessIterator>
+inline _LIBCPP_HIDE_FROM_ABI void __partially_sorted_swap(_RandomAccessIterator __x, _RandomAccessIterator __y,
+                                                          _RandomAccessIterator __z, _Compare __c) {
+  typedef typename iterator_traits<_RandomAccessIterator>::value_type value_type;
+  bool __r = __c(*__z, *__x);
+  value_type __tmp = __r ? *__z : *__x;
+  *__z = __r ? *__x : *__z;
+  __r = __c(__tmp, *__y);
+  *__x = __r ? *__x : *__y;
+  *__y = __r ? *__y : __tmp;
+}
+
+template <class _Compare, class _RandomAccessIterator>
+inline _LIBCPP_HIDE_FROM_ABI __enable_if_t<__use_branchless_sort<_Compare, _RandomAccessIterator>::value, void>
+__sort3_maybe_branchless(_RandomAccessIterator __x1, _RandomAccessIterator __x2, _RandomAccessIterator __x3,
+                         _Compare __c) {
+  _VSTD::__cond_swap<_Compare>(__x2, __x3, __c);
+  _VSTD::__partially_sorted_swap<_Compare>(__x1, __x2, __x3, __c);
+}
+
+template <class _Compare, class _RandomAccessIterator>
+inline _LIBCPP_HIDE_FROM_ABI __enable_if_t<!__use_branchless_sort<_Compare, _RandomAccessIterator>::value, void>
+__sort3_maybe_branchless(_RandomAccessIterator __x1, _RandomAccessIterator __x2, _RandomAccessIterator __x3,
+                         _Compare __c) {
+  _VSTD::__sort3<_Compare>(__x1, __x2, __x3, __c);
+}
+
+template <class _Compare, class _RandomAccessIterator>
+inline _LIBCPP_HIDE_FROM_ABI __enable_if_t<__use_branchless_sort<_Compare, _RandomAccessIterator>::value, void>
+__sort4_maybe_branchless(_RandomAccessIterator __x1, _RandomAccessIterator __x2, _RandomAccessIterator __x3,
+                         _RandomAccessIterator __x4, _Compare __c) {
+  _VSTD::__cond_swap<_Compare>(__x1, __x3, __c);
+  _VSTD::__cond_swap<_Compare>(__x2, __x4, __c);
+  _VSTD::__cond_swap<_Compare>(__x1, __x2, __c);
+  _VSTD::__cond_swap<_Compare>(__x3, __x4, __c);
+  _VSTD::__cond_swap<_Compare>(__x2, __x3, __c);
+}
+
+template <class _Compare, class _RandomAccessIterator>
+inline _LIBCPP_HIDE_FROM_ABI __enable_if_t<!__use_branchless_sort<_Compare, _RandomAccessIterator>::value, void>
+__sort4_maybe_branchless(_RandomAccessIterator __x1, _RandomAccessIterator __x2, _RandomAccessIterator __x3,
+                         _RandomAccessIterator __x4, _Compare __c) {
+  _VSTD::__sort4<_Compare>(__x1, __x2, __x3, __x4, __c);
+}
+
+template <class _Compare, class _RandomAccessIterator>
+inline _LIBCPP_HIDE_FROM_ABI __enable_if_t<__use_branchless_sort<_Compare, _RandomAccessIterator>::value, void>
+__sort5_maybe_branchless(_RandomAccessIterator __x1, _RandomAccessIterator __x2, _RandomAccessIterator __x3,
+                         _RandomAccessIterator __x4, _RandomAccessIterator __x5, _Compare __c) {
+  _VSTD::__cond_swap<_Compare>(__x1, __x2, __c);
+  _VSTD::__cond_swap<_Compare>(__x4, __x5, __c);
+  _VSTD::__partially_sorted_swap<_Compare>(__x3, __x4, __x5, __c);
+  _VSTD::__cond_swap<_Compare>(__x2, __x5, __c);
+  _VSTD::__partially_sorted_swap<_Compare>(__x1, __x3, __x4, __c);
+  _VSTD::__partially_sorted_swap<_Compare>(__x2, __x3, __x4, __c);
+}
+
+template <class _Compare, class _RandomAccessIterator>
+inline _LIBCPP_HIDE_FROM_ABI __enable_if_t<!__use_branchless_sort<_Compare, _RandomAccessIterator>::value, void>
+__sort5_maybe_branchless(_RandomAccessIterator __x1, _RandomAccessIterator __x2, _RandomAccessIterator __x3,
+                         _RandomAccessIterator __x4, _RandomAccessIterator __x5, _Compare __c) {
+  _VSTD::__sort5<_Compare>(__x1, __x2, __x3, __x4, __x5, __c);
+}
+
+// Partitions [__first, __last) around the pivot *__m, as in BlockQuicksort:
+// the elements of a block at each end of the range are compared to the pivot
+// without branches, the results are recorded in bitsets, and the misplaced
+// elements of the two blocks are then swapped pairwise. Returns the final
+// position __p of the pivot, such that [__first, __p) < *__p <= [__p + 1,
+// __last), and adds the number of swaps to __n_swaps. If the range is already
+// partitioned, no swaps are made and its order is preserved.
+template <class _Compare, class _RandomAccessIterator>
+_LIBCPP_HIDE_FROM_ABI _RandomAccessIterator
+__bitset_partition(_RandomAccessIterator __first, _RandomAccessIterator __last, _RandomAccessIterator __m,
+                   _Compare __comp, unsigned& __n_swaps) {
+  typedef typename iterator_traits<_RandomAccessIterator>::difference_type difference_type;
+  typedef typename iterator_traits<_RandomAccessIterator>::value_type value_type;
+  const difference_type __block_size = 64;
+
+  // Move the pivot out of the way. It is moved back into place at the end, so
+  // that an already partitioned range keeps its order.
+  swap(*__first, *__m);
+  const value_type __pivot(*__first);
+  _RandomAccessIterator __begin = __first;
+  ++__first;
+
+  // [__begin + 1, __first) < __pivot <= [__last, end), and bit __j of the
+  // bitsets is set if __first[__j], respectively __last[-1 - __j], is on the
+  // wrong side.
+  uint64_t __left_bitset = 0;
+  uint64_t __right_bitset = 0;
+  while (__last - __first >= 2 * __block_size) {
+    if (__left_bitset == 0) {
+      for (difference_type __j = 0; __j < __block_size; ++__j)
+        __left_bitset |= static_cast<uint64_t>(!__comp(__first[__j], __pivot)) << __j;
+    }
+    if (__right_bitset == 0) {
+      for (difference_type __j = 0; __j < __block_size; ++__j)
+        __right_bitset |= static_cast<uint64_t>(__comp(__last[-1 - __j], __pivot)) << __j;
+    }
+    while (__left_bitset != 0 && __right_bitset != 0) {
+      swap(__first[_VSTD::__libcpp_ctz(__left_bitset)], __last[-1 - _VSTD::__libcpp_ctz(__right_bitset)]);
+      ++__n_swaps;
+      __left_bitset &= __left_bitset - 1;
+      __right_bitset &= __right_bitset - 1;
+    }
+    if (__left_bitset == 0)
+      __first += __block_size;
+    if (__right_bitset == 0)
+      __last -= __block_size;
+  }
+
+  // Partition the remaining elements, including those of a block that was not
+  // completed.
+  for (_RandomAccessIterator __i = __first; __i != __last; ++__i) {
+    if (__comp(*__i, __pivot)) {
+      if (__i != __first) {
+        swap(*__i, *__first);
+        ++__n_swaps;
+      }
+      ++__first;
+    }
+  }
+
+  --__first;
+  *__begin = *__first;
+  *__first = __pivot;
+  return __first;
+}
+
 // Assumes size > 0
 template <class _Compare, class _BidirectionalIterator>
 _LIBCPP_CONSTEXPR_AFTER_CXX11 void
@@ -163,7 +330,7 @@ __insertion_sort_3(_RandomAccessIterator __first, _RandomAccessIterator __last,
     typedef typename iterator_traits<_RandomAccessIterator>::difference_type difference_type;
     typedef typename iterator_traits<_RandomAccessIterator>::value_type value_type;
     _RandomAccessIterator __j = __first+difference_type(2);
-    _VSTD::__sort3<_Compare>(__first, __first+difference_type(1), __j, __comp);
+    _VSTD::__sort3_maybe_branchless<_Compare>(__first, __first+difference_type(1), __j, __comp);
     for (_RandomAccessIterator __i = __j+difference_type(1); __i != __last; ++__i)
     {
         if (__comp(*__i, *__j))
@@ -197,18 +364,18 @@ __insertion_sort_incomplete(_RandomAccessIterator __first, _RandomAccessIterator
             swap(*__first, *__last);
         return true;
     case 3:
-        _VSTD::__sort3<_Compare>(__first, __first+difference_type(1), --__last, __comp);
+        _VSTD::__sort3_maybe_branchless<_Compare>(__first, __first+difference_type(1), --__last, __comp);
         return true;
     case 4:
-        _VSTD::__sort4<_Compare>(__first, __first+difference_type(1), __first+difference_type(2), --__last, __comp);
+        _VSTD::__sort4_maybe_branchless<_Compare>(__first, __first+difference_type(1), __first+difference_type(2), --__last, __comp);
         return true;
     case 5:
-        _VSTD::__sort5<_Compare>(__first, __first+difference_type(1), __first+difference_type(2), __first+difference_type(3), --__last, __comp);
+        _VSTD::__sort5_maybe_branchless<_Compare>(__first, __first+difference_type(1), __first+difference_type(2), __first+difference_type(3), --__last, __comp);
         return true;
     }
     typedef typename iterator_traits<_RandomAccessIterator>::value_type value_type;
     _RandomAccessIterator __j = __first+difference_type(2);
-    _VSTD::__sort3<_Compare>(__first, __first+difference_type(1), __j, __comp);
+    _VSTD::__sort3_maybe_branchless<_Compare>(__first, __first+difference_type(1), __j, __comp);
     const unsigned __limit = 8;
     unsigned __count = 0;
     for (_RandomAccessIterator __i = __j+difference_type(1); __i != __last; ++__i)
@@ -290,13 +457,13 @@ __introsort(_RandomAccessIterator __first, _RandomAccessIterator __last, _Compar
                 swap(*__first, *__last);
             return;
         case 3:
-            _VSTD::__sort3<_Compare>(__first, __first+difference_type(1), --__last, __comp);
+            _VSTD::__sort3_maybe_branchless<_Compare>(__first, __first+difference_type(1), --__last, __comp);
             return;
         case 4:
-            _VSTD::__sort4<_Compare>(__first, __first+difference_type(1), __first+difference_type(2), --__last, __comp);
+            _VSTD::__sort4_maybe_branchless<_Compare>(__first, __first+difference_type(1), __first+difference_type(2), --__last, __comp);
             return;
         case 5:
-            _VSTD::__sort5<_Compare>(__first, __first+difference_type(1), __first+difference_type(2), __first+difference_type(3), --__last, __comp);
+            _VSTD::__sort5_maybe_branchless<_Compare>(__first, __first+difference_type(1), __first+difference_type(2), __first+difference_type(3), --__last, __comp);
             return;
         }
         if (__len <= __limit)
@@ -398,38 +565,43 @@ __introsort(_RandomAccessIterator __first, _RandomAccessIterator __last, _Compar
             }
         }
         // It is known that *__i < *__m
-        ++__i;
-        // j points beyond range to be tested, *__m is known to be <= *__lm1
-        // if not yet partitioned...
-        if (__i < __j)
+        if (__use_branchless_sort<_Compare, _RandomAccessIterator>::value)
+            __i = _VSTD::__bitset_partition<_Compare>(__first, __last, __m, __comp, __n_swaps);
+        else
         {
-            // known that *(__i - 1) < *__m
-            // known that __i <= __m
-            while (true)
+            ++__i;
+            // j points beyond range to be tested, *__m is known to be <= *__lm1
+            // if not yet partitioned...
+            if (__i < __j)
             {
-                // __m still guards upward moving __i
-                while (__comp(*__i, *__m))
+                // known that *(__i - 1) < *__m
+                // known that __i <= __m
+                while (true)
+                {
+                    // __m still guards upward moving __i
+                    while (__comp(*__i, *__m))
+                        ++__i;
+                    // It is now known that a guard exists for downward moving __j
+                    while (!__comp(*--__j, *__m))
+                        ;
+                    if (__i > __j)
+                        break;
+                    swap(*__i, *__j);
+                    ++__n_swaps;
+                    // It is known that __m != __j
+                    // If __m just moved, follow it
+                    if (__m == __i)
+                        __m = __j;
                     ++__i;
-                // It is now known that a guard exists for downward moving __j
-                while (!__comp(*--__j, *__m))
-                    ;
-                if (__i > __j)
-                    break;
-                swap(*__i, *__j);
+                }
+            }
+            // [__first, __i) < *__m and *__m <= [__i, __last)
+            if (__i != __m && __comp(*__m, *__i))
+            {
+                swap(*__i, *__m);
                 ++__n_swaps;
-                // It is known that __m != __j
-                // If __m just moved, follow it
-                if (__m == __i)
-                    __m = __j;
-                ++__i;
             }
         }
-        // [__first, __i) < *__m and *__m <= [__i, __last)
-        if (__i != __m && __comp(*__m, *__i))
-        {
-            swap(*__i, *__m);
-            ++__n_swaps;
-        }
         // [__first, __i) < *__i and *__i <= [__i+1, __last)
         // If we were given a perfect partition, see if insertion sort is quick...
         if (__n_swaps == 0)
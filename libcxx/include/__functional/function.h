@@ -571,7 +571,11 @@ template <class _Rp, class... _ArgTypes> class __value_func<_Rp(_ArgTypes...)>
 // destruction.
 union __policy_storage
 {
+#ifdef _LIBCPP_ABI_OPTIMIZED_FUNCTION_LARGE_BUFFER
+    mutable char __small[sizeof(void*) * 6];
+#else
     mutable char __small[sizeof(void*) * 2];
+#endif
     void* __large;
 };
 
@@ -0,0 +1,202 @@
+// -*- C++ -*-
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _LIBCPP___FUNCTIONAL_MOVE_ONLY_FUNCTION_H
+#define _LIBCPP___FUNCTIONAL_MOVE_ONLY_FUNCTION_H
+
+#include <__config>
+#include <__debug>
+#include <__functional/invoke.h>
+#include <__utility/exchange.h>
+#include <__utility/forward.h>
+#include <__utility/in_place.h>
+#include <__utility/move.h>
+#include <__utility/swap.h>
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+
+#if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
+#pragma GCC system_header
+#endif
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+#if _LIBCPP_STD_VER > 20 && !defined(_LIBCPP_HAS_NO_CONCEPTS)
+
+// The size in bytes of the buffer in which move_only_function stores its
+// target without allocating. It is part of the ABI of move_only_function.
+// The default fits lambdas capturing up to six pointers, and makes
+// move_only_function as large as a cache line on 64 bit targets.
+#ifndef _LIBCPP_ABI_MOVE_ONLY_FUNCTION_BUFFER_SIZE
+#  define _LIBCPP_ABI_MOVE_ONLY_FUNCTION_BUFFER_SIZE (6 * sizeof(void*))
+#endif
+
+union __move_only_function_buffer {
+  void* __large_;
+  alignas(max_align_t) char __small_[_LIBCPP_ABI_MOVE_ONLY_FUNCTION_BUFFER_SIZE];
+};
+
+// How to move and destroy the target of a move_only_function. __relocate_ is
+// null if the target is relocated by copying the buffer, and __destroy_ is
+// null if the target needs no destruction.
+struct __move_only_function_ops {
+  void (*__relocate_)(__move_only_function_buffer* __dst, __move_only_function_buffer* __src) noexcept;
+  void (*__destroy_)(__move_only_function_buffer*) noexcept;
+};
+
+inline constexpr __move_only_function_ops __move_only_function_empty_ops = {nullptr, nullptr};
+
+template <class _Fp>
+struct __move_only_function_traits {
+  // Targets are stored in the buffer if they fit and can be moved without
+  // throwing, since the move constructor of move_only_function is noexcept.
+  static constexpr bool __is_small = sizeof(_Fp) <= sizeof(__move_only_function_buffer) &&
+                                     alignof(_Fp) <= alignof(__move_only_function_buffer) &&
+                                     is_nothrow_move_constructible_v<_Fp>;
+
+  _LIBCPP_HIDE_FROM_ABI static _Fp* __get(__move_only_function_buffer* __buf) noexcept {
+    if constexpr (__is_small)
+      return _VSTD::launder(reinterpret_cast<_Fp*>(__buf->__small_));
+    else
+      return static_cast<_Fp*>(__buf->__large_);
+  }
+
+  template <class... _Args>
+  _LIBCPP_HIDE_FROM_ABI static void __construct(__move_only_function_buffer* __buf, _Args&&... __args) {
+    if constexpr (__is_small)
+      ::new ((void*)__buf->__small_) _Fp(_VSTD::forward<_Args>(__args)...);
+    else
+      __buf->__large_ = new _Fp(_VSTD::forward<_Args>(__args)...);
+  }
+
+  _LIBCPP_HIDE_FROM_ABI static void __relocate(__move_only_function_buffer* __dst,
+                                               __move_only_function_buffer* __src) noexcept {
+    _Fp* __f = __get(__src);
+    ::new ((void*)__dst->__small_) _Fp(_VSTD::move(*__f));
+    __f->~_Fp();
+  }
+
+  _LIBCPP_HIDE_FROM_ABI static void __destroy(__move_only_function_buffer* __buf) noexcept {
+    if constexpr (__is_small)
+      __get(__buf)->~_Fp();
+    else
+      delete __get(__buf);
+  }
+
+  // Targets on the heap and trivially copyable targets in the buffer are
+  // relocated by copying the buffer.
+  static constexpr bool __is_trivially_relocatable = !__is_small || is_trivially_copyable_v<_Fp>;
+
+  static constexpr __move_only_function_ops __ops = {
+      __is_trivially_relocatable ? nullptr : &__relocate,
+      __is_small && is_trivially_destructible_v<_Fp> ? nullptr : &__destroy};
+};
+
+// The part of move_only_function which does not depend on its signature.
+class __move_only_function_base {
+protected:
+  _LIBCPP_HIDE_FROM_ABI __move_only_function_base() noexcept = default;
+
+  _LIBCPP_HIDE_FROM_ABI __move_only_function_base(__move_only_function_base&& __other) noexcept
+      : __ops_(__other.__ops_) {
+    __relocate(__ops_, &__buf_, &__other.__buf_);
+    __other.__ops_ = &__move_only_function_empty_ops;
+  }
+
+  _LIBCPP_HIDE_FROM_ABI ~__move_only_function_base() { __destroy(); }
+
+  template <class _Fp, class... _Args>
+  _LIBCPP_HIDE_FROM_ABI void __construct(_Args&&... __args) {
+    __move_only_function_traits<_Fp>::__construct(&__buf_, _VSTD::forward<_Args>(__args)...);
+    __ops_ = &__move_only_function_traits<_Fp>::__ops;
+  }
+
+  _LIBCPP_HIDE_FROM_ABI void __reset() noexcept {
+    __destroy();
+    __ops_ = &__move_only_function_empty_ops;
+  }
+
+  _LIBCPP_HIDE_FROM_ABI void __swap(__move_only_function_base& __other) noexcept {
+    __move_only_function_buffer __tmp;
+    __relocate(__ops_, &__tmp, &__buf_);
+    __relocate(__other.__ops_, &__buf_, &__other.__buf_);
+    __relocate(__ops_, &__other.__buf_, &__tmp);
+    _VSTD::swap(__ops_, __other.__ops_);
+  }
+
+  __move_only_function_buffer __buf_;
+  const __move_only_function_ops* __ops_ = &__move_only_function_empty_ops;
+
+private:
+  _LIBCPP_HIDE_FROM_ABI static void __relocate(const __move_only_function_ops* __ops,
+                                               __move_only_function_buffer* __dst,
+                                               __move_only_function_buffer* __src) noexcept {
+    if (__ops->__relocate_)
+      __ops->__relocate_(__dst, __src);
+    else
+      *__dst = *__src;
+  }
+
+  _LIBCPP_HIDE_FROM_ABI void __destroy() noexcept {
+    if (__ops_->__destroy_)
+      __ops_->__destroy_(&__buf_);
+  }
+};
+
+template <class...>
+class move_only_function;
+
+template <class _Tp>
+struct __is_move_only_function : false_type {};
+
+template <class... _Sig>
+struct __is_move_only_function<move_only_function<_Sig...>> : true_type {};
+
+// There is one partial specialization of move_only_function for every
+// combination of cv-qualifier and ref-qualifier of the signature. They are
+// generated by including move_only_function_impl.h with these macros defined.
+// _LIBCPP_MOVE_ONLY_FUNCTION_INV_QUALS is how the target is invoked.
+
+#define _LIBCPP_MOVE_ONLY_FUNCTION_CV
+#define _LIBCPP_MOVE_ONLY_FUNCTION_REF
+#define _LIBCPP_MOVE_ONLY_FUNCTION_INV_QUALS &
+#include <__functional/move_only_function_impl.h>
+
+#define _LIBCPP_MOVE_ONLY_FUNCTION_CV
+#define _LIBCPP_MOVE_ONLY_FUNCTION_REF &
+#define _LIBCPP_MOVE_ONLY_FUNCTION_INV_QUALS &
+#include <__functional/move_only_function_impl.h>
+
+#define _LIBCPP_MOVE_ONLY_FUNCTION_CV
+#define _LIBCPP_MOVE_ONLY_FUNCTION_REF &&
+#define _LIBCPP_MOVE_ONLY_FUNCTION_INV_QUALS &&
+#include <__functional/move_only_function_impl.h>
+
+#define _LIBCPP_MOVE_ONLY_FUNCTION_CV const
+#define _LIBCPP_MOVE_ONLY_FUNCTION_REF
+#define _LIBCPP_MOVE_ONLY_FUNCTION_INV_QUALS const&
+#include <__functional/move_only_function_impl.h>
+
+#define _LIBCPP_MOVE_ONLY_FUNCTION_CV const
+#define _LIBCPP_MOVE_ONLY_FUNCTION_REF &
+#define _LIBCPP_MOVE_ONLY_FUNCTION_INV_QUALS const&
+#include <__functional/move_only_function_impl.h>
+
+#define _LIBCPP_MOVE_ONLY_FUNCTION_CV const
+#define _LIBCPP_MOVE_ONLY_FUNCTION_REF &&
+#define _LIBCPP_MOVE_ONLY_FUNCTION_INV_QUALS const&&
+#include <__functional/move_only_function_impl.h>
+
+#endif // _LIBCPP_STD_VER > 20 && !defined(_LIBCPP_HAS_NO_CONCEPTS)
+
+_LIBCPP_END_NAMESPACE_STD
+
+#endif // _LIBCPP___FUNCTIONAL_MOVE_ONLY_FUNCTION_H
@@ -0,0 +1,130 @@
+// -*- C++ -*-
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// This header is included several times by move_only_function.h, once for
+// every combination of the cv-qualifier and ref-qualifier of the signature of
+// move_only_function. It has no include guard on purpose.
+
+#if !defined(_LIBCPP_MOVE_ONLY_FUNCTION_CV) || !defined(_LIBCPP_MOVE_ONLY_FUNCTION_REF) ||                           \
+    !defined(_LIBCPP_MOVE_ONLY_FUNCTION_INV_QUALS)
+#  error "This header must only be included by move_only_function.h"
+#endif
+
+template <class _Rp, class... _ArgTypes, bool _Noexcept>
+class _LIBCPP_TEMPLATE_VIS
+    move_only_function<_Rp(_ArgTypes...) _LIBCPP_MOVE_ONLY_FUNCTION_CV _LIBCPP_MOVE_ONLY_FUNCTION_REF noexcept(_Noexcept)>
+    : private __move_only_function_base {
+  using __call_t = _Rp (*)(__move_only_function_buffer*, _ArgTypes&&...) noexcept(_Noexcept);
+
+  template <class _VT>
+  static constexpr bool __is_callable_from =
+      _Noexcept ? is_nothrow_invocable_r_v<_Rp, _VT _LIBCPP_MOVE_ONLY_FUNCTION_CV _LIBCPP_MOVE_ONLY_FUNCTION_REF,
+                                           _ArgTypes...> &&
+                      is_nothrow_invocable_r_v<_Rp, _VT _LIBCPP_MOVE_ONLY_FUNCTION_INV_QUALS, _ArgTypes...>
+                : is_invocable_r_v<_Rp, _VT _LIBCPP_MOVE_ONLY_FUNCTION_CV _LIBCPP_MOVE_ONLY_FUNCTION_REF, _ArgTypes...> &&
+                      is_invocable_r_v<_Rp, _VT _LIBCPP_MOVE_ONLY_FUNCTION_INV_QUALS, _ArgTypes...>;
+
+  template <class _Fp>
+  _LIBCPP_HIDE_FROM_ABI static _Rp __call(__move_only_function_buffer* __buf,
+                                          _ArgTypes&&... __args) noexcept(_Noexcept) {
+    return __invoke_void_return_wrapper<_Rp>::__call(
+        static_cast<_Fp _LIBCPP_MOVE_ONLY_FUNCTION_INV_QUALS>(*__move_only_function_traits<_Fp>::__get(__buf)),
+        _VSTD::forward<_ArgTypes>(__args)...);
+  }
+
+  template <class _Fp, class... _Args>
+  _LIBCPP_HIDE_FROM_ABI void __construct(_Args&&... __args) {
+    __move_only_function_base::__construct<_Fp>(_VSTD::forward<_Args>(__args)...);
+    __call_ = &__call<_Fp>;
+  }
+
+  __call_t __call_ = nullptr;
+
+public:
+  using result_type = _Rp;
+
+  _LIBCPP_HIDE_FROM_ABI move_only_function() noexcept = default;
+
+  _LIBCPP_HIDE_FROM_ABI move_only_function(nullptr_t) noexcept {}
+
+  _LIBCPP_HIDE_FROM_ABI move_only_function(move_only_function&& __other) noexcept
+      : __move_only_function_base(_VSTD::move(__other)), __call_(_VSTD::exchange(__other.__call_, nullptr)) {}
+
+  template <class _Fp>
+    requires(!is_same_v<__uncvref_t<_Fp>, move_only_function> && !__is_inplace_type<_Fp>::value &&
+             is_constructible_v<decay_t<_Fp>, _Fp> && __is_callable_from<decay_t<_Fp>>)
+  _LIBCPP_HIDE_FROM_ABI move_only_function(_Fp&& __f) {
+    using _VT = decay_t<_Fp>;
+    if constexpr (is_function_v<remove_pointer_t<_VT>> || is_member_pointer_v<_VT> ||
+                  __is_move_only_function<_VT>::value) {
+      if (!__f)
+        return;
+    }
+    __construct<_VT>(_VSTD::forward<_Fp>(__f));
+  }
+
+  template <class _Tp, class... _Args>
+    requires is_constructible_v<_Tp, _Args...> && __is_callable_from<_Tp>
+  _LIBCPP_HIDE_FROM_ABI explicit move_only_function(in_place_type_t<_Tp>, _Args&&... __args) {
+    static_assert(is_same_v<decay_t<_Tp>, _Tp>, "move_only_function requires a decayed type in in_place_type_t");
+    __construct<_Tp>(_VSTD::forward<_Args>(__args)...);
+  }
+
+  template <class _Tp, class _Up, class... _Args>
+    requires is_constructible_v<_Tp, initializer_list<_Up>&, _Args...> && __is_callable_from<_Tp>
+  _LIBCPP_HIDE_FROM_ABI explicit move_only_function(in_place_type_t<_Tp>, initializer_list<_Up> __il,
+                                                    _Args&&... __args) {
+    static_assert(is_same_v<decay_t<_Tp>, _Tp>, "move_only_function requires a decayed type in in_place_type_t");
+    __construct<_Tp>(__il, _VSTD::forward<_Args>(__args)...);
+  }
+
+  move_only_function(const move_only_function&) = delete;
+
+  _LIBCPP_HIDE_FROM_ABI ~move_only_function() = default;
+
+  _LIBCPP_HIDE_FROM_ABI move_only_function& operator=(move_only_function&& __other) noexcept {
+    move_only_function(_VSTD::move(__other)).swap(*this);
+    return *this;
+  }
+
+  move_only_function& operator=(const move_only_function&) = delete;
+
+  _LIBCPP_HIDE_FROM_ABI move_only_function& operator=(nullptr_t) noexcept {
+    __move_only_function_base::__reset();
+    __call_ = nullptr;
+    return *this;
+  }
+
+  template <class _Fp>
+  _LIBCPP_HIDE_FROM_ABI move_only_function& operator=(_Fp&& __f) {
+    move_only_function(_VSTD::forward<_Fp>(__f)).swap(*this);
+    return *this;
+  }
+
+  _LIBCPP_HIDE_FROM_ABI void swap(move_only_function& __other) noexcept {
+    __move_only_function_base::__swap(__other);
+    _VSTD::swap(__call_, __other.__call_);
+  }
+
+  _LIBCPP_HIDE_FROM_ABI explicit operator bool() const noexcept { return __call_ != nullptr; }
+
+  _LIBCPP_HIDE_FROM_ABI _Rp operator()(_ArgTypes... __args) _LIBCPP_MOVE_ONLY_FUNCTION_CV
+      _LIBCPP_MOVE_ONLY_FUNCTION_REF noexcept(_Noexcept) {
+    _LIBCPP_ASSERT(__call_ != nullptr, "move_only_function::operator(): the function is empty");
+    return __call_(const_cast<__move_only_function_buffer*>(&__buf_), _VSTD::forward<_ArgTypes>(__args)...);
+  }
+
+  _LIBCPP_HIDE_FROM_ABI friend void swap(move_only_function& __x, move_only_function& __y) noexcept { __x.swap(__y); }
+
+  _LIBCPP_HIDE_FROM_ABI friend bool operator==(const move_only_function& __f, nullptr_t) noexcept { return !__f; }
+};
+
+#undef _LIBCPP_MOVE_ONLY_FUNCTION_CV
+#undef _LIBCPP_MOVE_ONLY_FUNCTION_REF
+#undef _LIBCPP_MOVE_ONLY_FUNCTION_INV_QUALS
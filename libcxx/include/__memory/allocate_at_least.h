@@ -0,0 +1,78 @@
+// -*- C++ -*-
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _LIBCPP___MEMORY_ALLOCATE_AT_LEAST_H
+#define _LIBCPP___MEMORY_ALLOCATE_AT_LEAST_H
+
+#include <__config>
+#include <__memory/allocator_traits.h>
+#include <cstddef>
+#include <type_traits>
+
+#if !defined(_LIBCPP_HAS_NO_PRAGMA_SYSTEM_HEADER)
+#pragma GCC system_header
+#endif
+
+_LIBCPP_BEGIN_NAMESPACE_STD
+
+#if _LIBCPP_STD_VER > 20
+
+template <class _Pointer>
+struct allocation_result {
+  _Pointer ptr;
+  size_t count;
+};
+
+template <class _Alloc, class = void>
+struct __has_allocate_at_least : false_type {};
+
+template <class _Alloc>
+struct __has_allocate_at_least<_Alloc, decltype((void)declval<_Alloc&>().allocate_at_least(declval<size_t>()))>
+    : true_type {};
+
+template <class _Alloc>
+[[nodiscard]] _LIBCPP_HIDE_FROM_ABI constexpr allocation_result<typename allocator_traits<_Alloc>::pointer>
+allocate_at_least(_Alloc& __alloc, size_t __n) {
+  if constexpr (__has_allocate_at_least<_Alloc>::value) {
+    return __alloc.allocate_at_least(__n);
+  } else {
+    return {__alloc.allocate(__n), __n};
+  }
+}
+
+#endif // _LIBCPP_STD_VER > 20
+
+// The storage which an allocator provided for __allocate_at_least. It must be
+// deallocated with a size between the requested one and count.
+template <class _Pointer>
+struct __allocation_result {
+  _Pointer ptr;
+  size_t count;
+};
+
+// Allocates storage for at least __n objects with std::allocate_at_least,
+// which lets allocators with size classes hand out the whole size class, so
+// that the containers can use it instead of reallocating. Before C++2b, it
+// allocates exactly __n objects.
+template <class _Alloc>
+_LIBCPP_NODISCARD _LIBCPP_HIDE_FROM_ABI _LIBCPP_CONSTEXPR_AFTER_CXX17
+__allocation_result<typename allocator_traits<_Alloc>::pointer> __allocate_at_least(_Alloc& __alloc, size_t __n) {
+#if _LIBCPP_STD_VER > 20
+  auto __result = _VSTD::allocate_at_least(__alloc, __n);
+  return {__result.ptr, __result.count};
+#else
+  __allocation_result<typename allocator_traits<_Alloc>::pointer> __result = {
+      allocator_traits<_Alloc>::allocate(__alloc, __n), __n};
+  return __result;
+#endif
+}
+
+_LIBCPP_END_NAMESPACE_STD
+
+#endif // _LIBCPP___MEMORY_ALLOCATE_AT_LEAST_H
@@ -11,7 +11,7 @@
 
 #include <atomic>
 #include <climits>
-#include <functional>
+#include <cstdint>
 #include <thread>
 
 #ifdef __linux__
@@ -88,7 +88,8 @@ static void __libcpp_platform_wake_by_address(__cxx_atomic_contention_t const vo
 
 #endif // __linux__
 
-static constexpr size_t __libcpp_contention_table_size = (1 << 8);  /* < there's no magic in this number */
+static constexpr size_t __libcpp_contention_table_bits = 8;  /* < there's no magic in this number */
+static constexpr size_t __libcpp_contention_table_size = (1 << __libcpp_contention_table_bits);
 
 struct alignas(64) /*  aim to avoid false sharing */ __libcpp_contention_table_entry
 {
@@ -100,11 +101,13 @@ struct alignas(64) /*  aim to avoid false sharing */ __libcpp_contention_table_e
 
 static __libcpp_contention_table_entry __libcpp_contention_table[ __libcpp_contention_table_size ];
 
-static hash<void const volatile*> __libcpp_contention_hasher;
+/* The entry is picked by the high bits of the address multiplied with the golden ratio, which
+   depend on all bits of the address, and are much cheaper to compute than hash<void*>. */
 
 static __libcpp_contention_table_entry* __libcpp_contention_state(void const volatile * p)
 {
-    return &__libcpp_contention_table[__libcpp_contention_hasher(p) & (__libcpp_contention_table_size - 1)];
+    uintptr_t const __h = reinterpret_cast<uintptr_t>(p) * static_cast<uintptr_t>(0x9E3779B97F4A7C15ull);
+    return &__libcpp_contention_table[__h >> (sizeof(uintptr_t) * CHAR_BIT - __libcpp_contention_table_bits)];
 }
 
 /* Given an atomic to track contention and an atomic to actually wait on, which may be
@@ -10,6 +10,7 @@
 #ifndef _LIBCPP_HAS_NO_THREADS
 
 #include "shared_mutex"
+#include "include/atomic_support.h"
 #if defined(__ELF__) && defined(_LIBCPP_LINK_PTHREAD_LIB)
 #pragma comment(lib, "pthread")
 #endif
@@ -22,16 +23,22 @@ __shared_mutex_base::__shared_mutex_base()
 {
 }
 
+// __state_ is only changed while holding __mut_, except by the lock-free
+// fast paths of shared_mutex, which change the number of readers while no
+// writer has entered. Hence it is updated with atomic operations here.
+
 // Exclusive ownership
 
 void
 __shared_mutex_base::lock()
 {
     unique_lock<mutex> lk(__mut_);
-    while (__state_ & __write_entered_)
+    while (__libcpp_atomic_load(&__state_) & __write_entered_)
         __gate1_.wait(lk);
-    __state_ |= __write_entered_;
-    while (__state_ & __n_readers_)
+    // Sets __write_entered_, which is clear.
+    __libcpp_atomic_add(&__state_, __write_entered_);
+    // The number of readers only changes while holding __mut_ from now on.
+    while (__libcpp_atomic_load(&__state_) & __n_readers_)
         __gate2_.wait(lk);
 }
 
@@ -39,19 +46,18 @@ bool
 __shared_mutex_base::try_lock()
 {
     unique_lock<mutex> lk(__mut_);
-    if (__state_ == 0)
-    {
-        __state_ = __write_entered_;
-        return true;
-    }
-    return false;
+    unsigned state = 0;
+    while (!__libcpp_atomic_compare_exchange(&__state_, &state, __write_entered_))
+        if (state != 0)
+            return false;
+    return true;
 }
 
 void
 __shared_mutex_base::unlock()
 {
     lock_guard<mutex> _(__mut_);
-    __state_ = 0;
+    __libcpp_atomic_store(&__state_, 0u);
     __gate1_.notify_all();
 }
 
@@ -61,25 +67,25 @@ void
 __shared_mutex_base::lock_shared()
 {
     unique_lock<mutex> lk(__mut_);
-    while ((__state_ & __write_entered_) || (__state_ & __n_readers_) == __n_readers_)
-        __gate1_.wait(lk);
-    unsigned num_readers = (__state_ & __n_readers_) + 1;
-    __state_ &= ~__n_readers_;
-    __state_ |= num_readers;
+    unsigned state = __libcpp_atomic_load(&__state_);
+    do
+    {
+        while ((state & __write_entered_) || (state & __n_readers_) == __n_readers_)
+        {
+            __gate1_.wait(lk);
+            state = __libcpp_atomic_load(&__state_);
+        }
+    } while (!__libcpp_atomic_compare_exchange(&__state_, &state, state + 1));
 }
 
 bool
 __shared_mutex_base::try_lock_shared()
 {
     unique_lock<mutex> lk(__mut_);
-    unsigned num_readers = __state_ & __n_readers_;
-    if (!(__state_ & __write_entered_) && num_readers != __n_readers_)
-    {
-        ++num_readers;
-        __state_ &= ~__n_readers_;
-        __state_ |= num_readers;
-        return true;
-    }
+    unsigned state = __libcpp_atomic_load(&__state_);
+    while (!(state & __write_entered_) && (state & __n_readers_) != __n_readers_)
+        if (__libcpp_atomic_compare_exchange(&__state_, &state, state + 1))
+            return true;
     return false;
 }
 
@@ -87,10 +93,9 @@ void
 __shared_mutex_base::unlock_shared()
 {
     lock_guard<mutex> _(__mut_);
-    unsigned num_readers = (__state_ & __n_readers_) - 1;
-    __state_ &= ~__n_readers_;
-    __state_ |= num_readers;
-    if (__state_ & __write_entered_)
+    unsigned state = __libcpp_atomic_add(&__state_, -1);
+    unsigned num_readers = state & __n_readers_;
+    if (state & __write_entered_)
     {
         if (num_readers == 0)
             __gate2_.notify_one();
@@ -0,0 +1,152 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <algorithm>
+
+// Check find, count, mismatch, equal, min_element and max_element against
+// scalar loops, for element types and sizes which use the vectorized code
+// paths, and for the elements before, in and after the last full vector.
+
+// UNSUPPORTED: c++03
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <vector>
+
+#include "test_macros.h"
+
+static std::uint64_t state = 88172645463325252ull;
+
+static std::uint64_t next() {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+template <class T>
+void test_find_count(const std::vector<T>& v, T value) {
+  std::size_t first = 0;
+  while (first < v.size() && !(v[first] == value))
+    ++first;
+  std::ptrdiff_t n = 0;
+  for (std::size_t i = 0; i < v.size(); ++i)
+    n += v[i] == value;
+
+  assert(std::find(v.begin(), v.end(), value) == v.begin() + first);
+  assert(std::find(v.data(), v.data() + v.size(), value) == v.data() + first);
+  assert(std::count(v.begin(), v.end(), value) == n);
+}
+
+template <class T>
+void test_mismatch(const std::vector<T>& v, const std::vector<T>& w) {
+  std::size_t first = 0;
+  while (first < v.size() && v[first] == w[first])
+    ++first;
+
+  assert(std::mismatch(v.begin(), v.end(), w.begin()).first == v.begin() + first);
+  assert(std::mismatch(v.begin(), v.end(), w.begin()).second == w.begin() + first);
+  assert(std::equal(v.begin(), v.end(), w.begin()) == (first == v.size()));
+#if TEST_STD_VER > 11
+  assert(std::equal(v.begin(), v.end(), w.begin(), w.end()) == (first == v.size()));
+  std::size_t half = v.size() / 2;
+  assert(std::mismatch(v.begin(), v.end(), w.begin(), w.begin() + half).first ==
+         v.begin() + std::min(first, half));
+#endif
+  std::list<T> l(w.begin(), w.end());
+  assert(std::mismatch(v.begin(), v.end(), l.begin()).first == v.begin() + first);
+}
+
+template <class T>
+void test_min_max(const std::vector<T>& v) {
+  std::size_t min = 0;
+  std::size_t max = 0;
+  for (std::size_t i = 1; i < v.size(); ++i) {
+    if (v[i] < v[min])
+      min = i;
+    if (v[max] < v[i])
+      max = i;
+  }
+
+  assert(std::min_element(v.begin(), v.end()) == v.begin() + (v.empty() ? 0 : min));
+  assert(std::max_element(v.begin(), v.end()) == v.begin() + (v.empty() ? 0 : max));
+}
+
+template <class T>
+void test() {
+  for (int size = 0; size < 600; size = size < 70 ? size + 1 : size * 2) {
+    for (int range = 2; range <= 1000; range *= 10) {
+      std::vector<T> v(size);
+      for (std::size_t i = 0; i < v.size(); ++i)
+        v[i] = static_cast<T>(next() % range - (range / 2));
+      test_find_count(v, static_cast<T>(next() % range - (range / 2)));
+      test_min_max(v);
+
+      std::vector<T> w = v;
+      test_mismatch(v, w);
+      if (size != 0) {
+        std::size_t i = next() % size;
+        w[i] = static_cast<T>(w[i] + 1);
+        test_mismatch(v, w);
+      }
+    }
+  }
+}
+
+void test_pointers() {
+  int a[37];
+  std::vector<int*> v;
+  for (int i = 0; i < 100; ++i)
+    v.push_back(&a[i % 37]);
+  for (int i = 0; i < 37; ++i)
+    test_find_count(v, &a[i]);
+  test_find_count(v, static_cast<int*>(nullptr));
+  std::vector<int*> w = v;
+  w[90] = nullptr;
+  test_mismatch(v, w);
+}
+
+#if TEST_STD_VER > 17
+constexpr bool test_constexpr() {
+  int a[40] = {};
+  a[33] = 5;
+  a[20] = -3;
+  assert(std::find(a, a + 40, 5) == a + 33);
+  assert(std::count(a, a + 40, 0) == 38);
+  assert(std::mismatch(a, a + 40, a).first == a + 40);
+  assert(std::equal(a, a + 40, a));
+  assert(std::min_element(a, a + 40) == a + 20);
+  assert(std::max_element(a, a + 40) == a + 33);
+  return true;
+}
+#endif
+
+int main(int, char**) {
+  test<char>();
+  test<signed char>();
+  test<unsigned char>();
+  test<short>();
+  test<unsigned short>();
+  test<int>();
+  test<unsigned>();
+  test<long long>();
+  test<unsigned long long>();
+  test<wchar_t>();
+  test<char16_t>();
+  test<char32_t>();
+  test<float>();
+  test_pointers();
+#if TEST_STD_VER > 17
+  static_assert(test_constexpr());
+#endif
+
+  return 0;
+}
@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17, c++20
+
+// <vector>
+
+// Make sure that vector keeps the storage which allocate_at_least returns
+// beyond what it asked for as capacity, and deallocates it with a valid size.
+
+#include <cassert>
+#include <climits>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "test_macros.h"
+
+template <class T>
+struct size_class_allocator {
+  using value_type = T;
+
+  size_class_allocator() = default;
+  template <class U>
+  size_class_allocator(const size_class_allocator<U>&) {}
+
+  static std::size_t round(std::size_t n) { return (n + 15) / 16 * 16; }
+
+  T* allocate(std::size_t n) { return std::allocator<T>().allocate(n); }
+  std::allocation_result<T*> allocate_at_least(std::size_t n) {
+    return {std::allocator<T>().allocate(round(n)), round(n)};
+  }
+  void deallocate(T* p, std::size_t n) {
+    assert(n == round(n));
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  template <class U>
+  bool operator==(const size_class_allocator<U>&) const { return true; }
+};
+
+int main(int, char**) {
+  {
+    std::vector<int, size_class_allocator<int> > v(5);
+    assert(v.capacity() == 16);
+    v.reserve(17);
+    assert(v.capacity() == 32);
+    const int* data = v.data();
+    v.resize(32);
+    assert(v.data() == data);
+    v.push_back(1);
+    assert(v.capacity() == 64);
+  }
+  {
+    std::vector<int, size_class_allocator<int> > v(std::size_t(0));
+    for (int i = 0; i != 100; ++i)
+      v.push_back(i);
+    assert(v.capacity() % 16 == 0);
+    v.shrink_to_fit();
+    assert(v.capacity() == 112);
+  }
+  {
+    std::vector<bool, size_class_allocator<bool> > v(1);
+    assert(v.capacity() == 16 * sizeof(std::size_t) * CHAR_BIT);
+  }
+
+  return 0;
+}
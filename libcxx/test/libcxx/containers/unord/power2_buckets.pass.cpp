@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// <unordered_map>
+
+// Check that with _LIBCPP_ABI_HASH_TABLE_POWER2_BUCKETS the bucket count is
+// always a power of two, and that hashes which only differ in their high bits
+// are still spread over the buckets.
+
+// ADDITIONAL_COMPILE_FLAGS: -D_LIBCPP_ABI_HASH_TABLE_POWER2_BUCKETS
+
+#include <unordered_map>
+#include <cassert>
+#include <cstddef>
+
+#include "test_macros.h"
+
+static bool is_power_of_two(std::size_t n) { return n != 0 && (n & (n - 1)) == 0; }
+
+template <class C>
+static void check_buckets(const C& c) {
+  assert(is_power_of_two(c.bucket_count()));
+  std::size_t n = 0;
+  for (std::size_t b = 0; b < c.bucket_count(); ++b) {
+    for (typename C::const_local_iterator i = c.begin(b); i != c.end(b); ++i) {
+      assert(c.bucket(i->first) == b);
+      ++n;
+    }
+  }
+  assert(n == c.size());
+}
+
+int main(int, char**) {
+  {
+    typedef std::unordered_map<std::size_t, int> C;
+    C c;
+    for (std::size_t i = 0; i < 10000; ++i) {
+      c[i] = static_cast<int>(i);
+      assert(is_power_of_two(c.bucket_count()));
+    }
+    check_buckets(c);
+    for (std::size_t i = 0; i < 10000; ++i)
+      assert(c.find(i)->second == static_cast<int>(i));
+    for (std::size_t i = 0; i < 10000; i += 2)
+      assert(c.erase(i) == 1);
+    check_buckets(c);
+    for (std::size_t i = 0; i < 10000; ++i)
+      assert(c.count(i) == i % 2);
+  }
+  {
+    // Keys which are all equal modulo any bucket count.
+    typedef std::unordered_map<std::size_t, int> C;
+    C c;
+    const int shift = sizeof(std::size_t) * 8 - 12;
+    for (std::size_t i = 0; i < 1024; ++i)
+      c[i << shift] = static_cast<int>(i);
+    check_buckets(c);
+    std::size_t max_bucket_size = 0;
+    for (std::size_t b = 0; b < c.bucket_count(); ++b)
+      if (c.bucket_size(b) > max_bucket_size)
+        max_bucket_size = c.bucket_size(b);
+    assert(max_bucket_size <= 8);
+  }
+  {
+    typedef std::unordered_map<int, int> C;
+    C c;
+    c.rehash(1);
+    assert(c.bucket_count() == 2);
+    c.rehash(100);
+    assert(c.bucket_count() == 128);
+    c.rehash(128);
+    assert(c.bucket_count() == 128);
+    for (int i = 0; i < 10; ++i)
+      c[i] = i;
+    c.rehash(0);
+    assert(c.bucket_count() == 16);
+    check_buckets(c);
+    c.clear();
+    c.rehash(0);
+    assert(c.bucket_count() == 0);
+    c[42] = 42;
+    assert(is_power_of_two(c.bucket_count()));
+    assert(c.at(42) == 42);
+  }
+
+  return 0;
+}
@@ -0,0 +1,85 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17, c++20
+
+// <string>
+
+// Make sure that basic_string keeps the storage which allocate_at_least
+// returns beyond what it asked for as capacity, and deallocates it with a
+// size between the requested and the returned one.
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "test_macros.h"
+
+template <class T>
+struct size_class_allocator {
+  using value_type = T;
+
+  size_class_allocator() = default;
+  template <class U>
+  size_class_allocator(const size_class_allocator<U>&) {}
+
+  static std::size_t round(std::size_t n) {
+    std::size_t c = 64;
+    while (c < n)
+      c *= 2;
+    return c;
+  }
+
+  T* allocate(std::size_t n) { return std::allocator<T>().allocate(n); }
+  std::allocation_result<T*> allocate_at_least(std::size_t n) {
+    return {std::allocator<T>().allocate(round(n)), round(n)};
+  }
+  void deallocate(T* p, std::size_t n) {
+    assert(round(n) == n);
+    std::allocator<T>().deallocate(p, n);
+  }
+
+  template <class U>
+  bool operator==(const size_class_allocator<U>&) const { return true; }
+};
+
+template <class CharT>
+void test() {
+  using S = std::basic_string<CharT, std::char_traits<CharT>, size_class_allocator<CharT> >;
+  {
+    S s(40, CharT('a'));
+    assert(s.capacity() == 63);
+    const CharT* data = s.data();
+    s.append(23, CharT('b'));
+    assert(s.data() == data);
+    s.push_back(CharT('c'));
+    assert(s.capacity() == 127);
+    s.reserve(200);
+    assert(s.capacity() == 255);
+    s.shrink_to_fit();
+    assert(s.capacity() == 127);
+    assert(s.size() == 64);
+  }
+  {
+    S s;
+    for (int i = 0; i != 1000; ++i)
+      s.push_back(CharT('a' + i % 26));
+    assert(s.capacity() == 1023);
+    S t = s + s;
+    assert(t.size() == 2000);
+    assert(t.capacity() == 2047);
+  }
+}
+
+int main(int, char**) {
+  test<char>();
+  test<char32_t>();
+
+  return 0;
+}
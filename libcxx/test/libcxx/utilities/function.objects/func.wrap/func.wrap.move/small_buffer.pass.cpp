@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17, c++20
+// UNSUPPORTED: libcpp-no-concepts
+
+// <functional>
+
+// Check that move_only_function stores targets of up to six pointers, which
+// can be moved without throwing, without allocating.
+
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "count_new.h"
+#include "test_macros.h"
+
+struct ThrowingMove {
+  void* p[2];
+  ThrowingMove() = default;
+  ThrowingMove(ThrowingMove&&) noexcept(false) {}
+  int operator()() const { return 42; }
+};
+
+int main(int, char**) {
+  globalMemCounter.reset();
+  {
+    int a = 1, b = 2, c = 3, d = 4, e = 5, f = 6;
+    std::move_only_function<int()> fn = [&a, &b, &c, &d, &e, &f] { return a + b + c + d + e + f; };
+    assert(fn() == 21);
+    std::move_only_function<int()> moved = std::move(fn);
+    assert(moved() == 21);
+    assert(globalMemCounter.checkNewCalledEq(0));
+  }
+  {
+    std::move_only_function<int()> fn = [p = std::make_unique<int>(42)] { return *p; };
+    assert(globalMemCounter.checkNewCalledEq(1));
+    std::move_only_function<int()> moved = std::move(fn);
+    assert(moved() == 42);
+    assert(globalMemCounter.checkNewCalledEq(1));
+  }
+  assert(globalMemCounter.checkOutstandingNewEq(0));
+  globalMemCounter.reset();
+  {
+    void* p[7] = {};
+    std::move_only_function<int()> fn = [p] { return p[6] == nullptr ? 42 : 0; };
+    assert(fn() == 42);
+    assert(globalMemCounter.checkNewCalledEq(1));
+  }
+  assert(globalMemCounter.checkOutstandingNewEq(0));
+  globalMemCounter.reset();
+  {
+    // Targets which may throw when moved are allocated, so that moving the
+    // move_only_function cannot throw.
+    std::move_only_function<int()> fn = ThrowingMove();
+    assert(fn() == 42);
+    assert(globalMemCounter.checkNewCalledEq(1));
+  }
+  assert(globalMemCounter.checkOutstandingNewEq(0));
+
+  return 0;
+}
@@ -40,6 +40,21 @@ int main(int, char**)
     std::reverse(v.begin(), v.end());
     assert(std::is_sorted(v.begin(), v.end()));
     }
+    {
+    // Arithmetic values with a standard comparator, in ranges of various
+    // sizes with and without duplicates.
+    for (int m = 13; m <= 1009; m += 996)
+    {
+        for (int n = 0; n < 1000; n += 37)
+        {
+            std::vector<double> v(n);
+            for (int i = 0; i < n; ++i)
+                v[i] = (i * 7919) % m;
+            std::sort(v.begin(), v.end(), std::greater<double>());
+            assert(std::is_sorted(v.begin(), v.end(), std::greater<double>()));
+        }
+    }
+    }
 
 #if TEST_STD_VER >= 11
     {
@@ -447,17 +447,11 @@
 #   error "__cpp_lib_addressof_constexpr should have the value 201603L in c++2b"
 # endif
 
-# if !defined(_LIBCPP_VERSION)
-#   ifndef __cpp_lib_allocate_at_least
-#     error "__cpp_lib_allocate_at_least should be defined in c++2b"
-#   endif
-#   if __cpp_lib_allocate_at_least != 202106L
-#     error "__cpp_lib_allocate_at_least should have the value 202106L in c++2b"
-#   endif
-# else // _LIBCPP_VERSION
-#   ifdef __cpp_lib_allocate_at_least
-#     error "__cpp_lib_allocate_at_least should not be defined because it is unimplemented in libc++!"
-#   endif
+# ifndef __cpp_lib_allocate_at_least
+#   error "__cpp_lib_allocate_at_least should be defined in c++2b"
+# endif
+# if __cpp_lib_allocate_at_least != 202106L
+#   error "__cpp_lib_allocate_at_least should have the value 202106L in c++2b"
 # endif
 
 # ifndef __cpp_lib_allocator_traits_is_always_equal
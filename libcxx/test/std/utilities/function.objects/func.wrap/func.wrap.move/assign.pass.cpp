@@ -0,0 +1,108 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17, c++20
+// UNSUPPORTED: libcpp-no-concepts
+
+// <functional>
+
+// move_only_function& operator=(move_only_function&&);
+// move_only_function& operator=(nullptr_t) noexcept;
+// template<class F> move_only_function& operator=(F&&);
+// void swap(move_only_function&) noexcept;
+// friend void swap(move_only_function&, move_only_function&) noexcept;
+// ~move_only_function();
+
+#include <cassert>
+#include <functional>
+#include <utility>
+
+#include "test_macros.h"
+
+// Counts the live instances, to check that every target is destroyed once.
+template <int Size>
+struct Tracked {
+  static int alive;
+  int value;
+  char padding[Size] = {};
+
+  explicit Tracked(int v) : value(v) { ++alive; }
+  Tracked(const Tracked& other) : value(other.value) { ++alive; }
+  Tracked(Tracked&& other) noexcept : value(other.value) { ++alive; }
+  ~Tracked() { --alive; }
+
+  int operator()() const { return value; }
+};
+
+template <int Size>
+int Tracked<Size>::alive = 0;
+
+using Small = Tracked<1>;
+using Large = Tracked<1024>;
+
+using F = std::move_only_function<int()>;
+
+template <class A, class B>
+void test_swap() {
+  {
+    F f = A(1);
+    F g = B(2);
+    f.swap(g);
+    assert(f() == 2);
+    assert(g() == 1);
+    swap(f, g);
+    assert(f() == 1);
+    assert(g() == 2);
+    f.swap(f);
+    assert(f() == 1);
+    F empty;
+    f.swap(empty);
+    assert(!f);
+    assert(empty() == 1);
+  }
+  assert(A::alive == 0);
+  assert(B::alive == 0);
+}
+
+template <class A, class B>
+void test_assign() {
+  {
+    F f = A(1);
+    F g = B(2);
+    f = std::move(g);
+    assert(f() == 2);
+    assert(!g);
+    f = A(3);
+    assert(f() == 3);
+    f = [] { return 4; };
+    assert(f() == 4);
+    f = nullptr;
+    assert(!f);
+    f = B(5);
+    assert(f() == 5);
+  }
+  assert(A::alive == 0);
+  assert(B::alive == 0);
+}
+
+int main(int, char**) {
+  static_assert(std::is_nothrow_move_assignable_v<F>);
+  static_assert(std::is_nothrow_swappable_v<F>);
+  static_assert(noexcept(std::declval<F&>() = nullptr));
+
+  test_swap<Small, Small>();
+  test_swap<Small, Large>();
+  test_swap<Large, Small>();
+  test_swap<Large, Large>();
+  test_assign<Small, Small>();
+  test_assign<Small, Large>();
+  test_assign<Large, Small>();
+  test_assign<Large, Large>();
+
+  return 0;
+}
@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17, c++20
+// UNSUPPORTED: libcpp-no-concepts
+
+// <functional>
+
+// R operator()(ArgTypes...) cv ref noexcept(noex);
+
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "test_macros.h"
+
+enum class Called { None, Lvalue, ConstLvalue, Rvalue, ConstRvalue };
+
+struct Qualified {
+  Called operator()() & { return Called::Lvalue; }
+  Called operator()() const& { return Called::ConstLvalue; }
+  Called operator()() && { return Called::Rvalue; }
+  Called operator()() const&& { return Called::ConstRvalue; }
+};
+
+struct Counter {
+  int count = 0;
+  int operator()() { return ++count; }
+};
+
+struct NothrowAdd {
+  int operator()(int x, int y) const noexcept { return x + y; }
+};
+
+template <class F, class... Args>
+concept Callable = requires(F f, Args... args) { std::forward<F>(f)(args...); };
+
+using Mutable = std::move_only_function<Called()>;
+using Const = std::move_only_function<Called() const>;
+using Lvalue = std::move_only_function<Called()&>;
+using Rvalue = std::move_only_function<Called() &&>;
+using ConstRvalue = std::move_only_function<Called() const&&>;
+
+static_assert(Callable<Mutable&>);
+static_assert(!Callable<const Mutable&>);
+static_assert(Callable<const Const&>);
+static_assert(Callable<Lvalue&>);
+static_assert(!Callable<Lvalue&&>);
+static_assert(Callable<Rvalue&&>);
+static_assert(!Callable<Rvalue&>);
+static_assert(Callable<const ConstRvalue&&>);
+
+static_assert(!noexcept(std::declval<std::move_only_function<int()>&>()()));
+static_assert(noexcept(std::declval<std::move_only_function<int() noexcept>&>()()));
+
+int main(int, char**) {
+  {
+    Mutable f = Qualified();
+    assert(f() == Called::Lvalue);
+    Const c = Qualified();
+    assert(c() == Called::ConstLvalue);
+    Lvalue l = Qualified();
+    assert(l() == Called::Lvalue);
+    Rvalue r = Qualified();
+    assert(std::move(r)() == Called::Rvalue);
+    ConstRvalue cr = Qualified();
+    assert(std::move(std::as_const(cr))() == Called::ConstRvalue);
+  }
+  {
+    // The target is invoked in place, so its state is kept between calls.
+    std::move_only_function<int()> f = Counter();
+    assert(f() == 1);
+    assert(f() == 2);
+    auto g = std::move(f);
+    assert(g() == 3);
+  }
+  {
+    std::move_only_function<int(int, int) const noexcept> f = NothrowAdd();
+    assert(f(40, 2) == 42);
+  }
+  {
+    int calls = 0;
+    std::move_only_function<void(int)> f = [&calls](int x) {
+      calls += x;
+      return x;
+    };
+    f(42);
+    assert(calls == 42);
+  }
+  {
+    std::move_only_function<std::unique_ptr<int>(std::unique_ptr<int>)> f = [](std::unique_ptr<int> p) {
+      ++*p;
+      return p;
+    };
+    auto p = f(std::make_unique<int>(41));
+    assert(*p == 42);
+  }
+
+  return 0;
+}
@@ -0,0 +1,145 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17, c++20
+// UNSUPPORTED: libcpp-no-concepts
+
+// <functional>
+
+// template<class R, class... ArgTypes>
+// class move_only_function<R(ArgTypes...) cv ref noexcept(noex)>
+
+// move_only_function() noexcept;
+// move_only_function(nullptr_t) noexcept;
+// move_only_function(move_only_function&&) noexcept;
+// template<class F> move_only_function(F&&);
+// template<class T, class... Args>
+//   explicit move_only_function(in_place_type_t<T>, Args&&...);
+// template<class T, class U, class... Args>
+//   explicit move_only_function(in_place_type_t<T>, initializer_list<U>, Args&&...);
+
+#include <cassert>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include "test_macros.h"
+
+int add(int x, int y) { return x + y; }
+
+struct MoveOnly {
+  std::unique_ptr<int> p;
+  explicit MoveOnly(int x) : p(new int(x)) {}
+  int operator()(int y) const { return *p + y; }
+};
+
+// Larger than any buffer, so it is always allocated.
+struct Large {
+  int values[64] = {};
+  int operator()(int y) const { return values[0] + values[63] + y; }
+};
+
+struct FromList {
+  int sum = 0;
+  FromList(std::initializer_list<int> il, int extra) {
+    for (int x : il)
+      sum += x;
+    sum += extra;
+  }
+  int operator()(int y) const { return sum + y; }
+};
+
+struct S {
+  int value;
+  int get(int y) const { return value + y; }
+};
+
+using F = std::move_only_function<int(int)>;
+
+static_assert(std::is_nothrow_default_constructible_v<F>);
+static_assert(std::is_nothrow_constructible_v<F, std::nullptr_t>);
+static_assert(std::is_nothrow_move_constructible_v<F>);
+static_assert(!std::is_copy_constructible_v<F>);
+static_assert(!std::is_copy_assignable_v<F>);
+static_assert(std::is_same_v<F::result_type, int>);
+
+static_assert(!std::is_constructible_v<F, int (*)(int, int)>);
+static_assert(std::is_constructible_v<F, MoveOnly>);
+static_assert(!std::is_constructible_v<F, MoveOnly&>);
+static_assert(!std::is_constructible_v<std::move_only_function<int(int) noexcept>, MoveOnly>);
+static_assert(std::is_constructible_v<std::move_only_function<int(int) const>, MoveOnly>);
+static_assert(std::is_constructible_v<std::move_only_function<int(int)&&>, MoveOnly>);
+static_assert(std::is_constructible_v<std::move_only_function<void(int)>, MoveOnly>);
+
+int main(int, char**) {
+  {
+    F f;
+    assert(!f);
+    assert(f == nullptr);
+    F g = nullptr;
+    assert(!g);
+  }
+  {
+    F f = [](int x) { return x * 2; };
+    assert(f);
+    assert(f(21) == 42);
+  }
+  {
+    F f = MoveOnly(40);
+    assert(f(2) == 42);
+    F g = std::move(f);
+    assert(!f);
+    assert(g(2) == 42);
+  }
+  {
+    Large l;
+    l.values[0] = 20;
+    l.values[63] = 20;
+    F f = l;
+    assert(f(2) == 42);
+    F g = std::move(f);
+    assert(!f);
+    assert(g(2) == 42);
+  }
+  {
+    int a = 1, b = 2, c = 3, d = 4, e = 5, h = 6;
+    F f = [a, b, c, d, e, h](int x) { return a + b + c + d + e + h + x; };
+    assert(f(21) == 42);
+  }
+  {
+    std::move_only_function<int(int, int)> f = add;
+    assert(f(40, 2) == 42);
+    int (*null)(int, int) = nullptr;
+    std::move_only_function<int(int, int)> g = null;
+    assert(!g);
+  }
+  {
+    std::move_only_function<int(const S&, int)> f = &S::get;
+    assert(f(S{40}, 2) == 42);
+    int (S::*null)(int) const = nullptr;
+    std::move_only_function<int(const S&, int)> g = null;
+    assert(!g);
+    std::move_only_function<int(const S&)> h = &S::value;
+    assert(h(S{42}) == 42);
+  }
+  {
+    std::move_only_function<int(int) const> empty;
+    F f = std::move(empty);
+    assert(!f);
+  }
+  {
+    F f(std::in_place_type<MoveOnly>, 40);
+    assert(f(2) == 42);
+    F g(std::in_place_type<FromList>, {10, 20, 5}, 5);
+    assert(g(2) == 42);
+  }
+
+  return 0;
+}
@@ -0,0 +1,47 @@
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// UNSUPPORTED: c++03, c++11, c++14, c++17, c++20
+
+// <memory>
+
+// allocator:
+// constexpr allocation_result<T*> allocate_at_least(size_t n);
+
+#include <cassert>
+#include <concepts>
+#include <memory>
+
+#include "test_macros.h"
+
+template <class T>
+constexpr bool test() {
+  std::allocator<T> a;
+  std::same_as<std::allocation_result<T*>> decltype(auto) ret = a.allocate_at_least(10);
+  assert(ret.ptr != nullptr);
+  assert(ret.count >= 10);
+  a.deallocate(ret.ptr, ret.count);
+
+  std::allocator<const T> ca;
+  std::same_as<std::allocation_result<const T*>> decltype(auto) cret = ca.allocate_at_least(10);
+  assert(cret.ptr != nullptr);
+  assert(cret.count >= 10);
+  ca.deallocate(cret.ptr, cret.count);
+
+  return true;
+}
+
+struct alignas(64) OverAligned {};
+
+int main(int, char**) {
+  test<int>();
+  test<OverAligned>();
+  static_assert(test<int>());
+
+  return 0;
+}
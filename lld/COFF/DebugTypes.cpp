@@ -46,9 +46,12 @@ class TypeServerIpiSource;
 // before any dependent OBJ.
 class TypeServerSource : public TpiSource {
 public:
-  explicit TypeServerSource(COFFLinkerContext &ctx, PDBInputFile *f)
+  explicit TypeServerSource(COFFLinkerContext &ctx, PDBInputFile *f,
+                            bool isTypeServer = true)
       : TpiSource(ctx, PDB, nullptr), pdbInputFile(f) {
-    if (f->loadErr && *f->loadErr)
+    // The previous PDB of a /pdbincremental link is not referenced by any
+    // object file, so it is not registered as a type server.
+    if (!isTypeServer || (f->loadErr && *f->loadErr))
       return;
     pdb::PDBFile &file = f->session->getPDBFile();
     auto expectedInfo = file.getPDBInfoStream();
@@ -185,6 +188,23 @@ TpiSource *lld::coff::makeTypeServerSource(COFFLinkerContext &ctx,
   return tpiSource;
 }
 
+// The types of the PDB written by the previous /pdbincremental link are merged
+// like those of a type server, but ahead of every other source. Since the
+// first source wins every ghash conflict and keeps its record order, all types
+// of the previous link keep their type indices, and the symbol streams of
+// unchanged object files come out byte-for-byte identical.
+TpiSource *lld::coff::makeIncrementalBaseSource(COFFLinkerContext &ctx,
+                                                PDBInputFile *pdbInputFile) {
+  auto *tpiSource =
+      make<TypeServerSource>(ctx, pdbInputFile, /*isTypeServer=*/false);
+  tpiSource->isIncrementalBase = true;
+  if (pdbInputFile->session->getPDBFile().hasPDBIpiStream()) {
+    tpiSource->ipiSrc = make<TypeServerIpiSource>(ctx);
+    tpiSource->ipiSrc->isIncrementalBase = true;
+  }
+  return tpiSource;
+}
+
 TpiSource *lld::coff::makeUseTypeServerSource(COFFLinkerContext &ctx,
                                               ObjFile *file,
                                               TypeServer2Record ts) {
@@ -1140,6 +1160,11 @@ void TypeMerger::sortDependencies() {
   std::vector<TpiSource *> objs;
   for (TpiSource *s : ctx.tpiSourceList)
     (s->isDependency() ? deps : objs).push_back(s);
+  // The previous PDB of a /pdbincremental link goes before everything else so
+  // that its types keep their indices.
+  std::stable_partition(deps.begin(), deps.end(), [](TpiSource *s) {
+    return s->isIncrementalBase;
+  });
   uint32_t numDeps = deps.size();
   uint32_t numObjs = objs.size();
   ctx.tpiSourceList = std::move(deps);
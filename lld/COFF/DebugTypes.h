@@ -114,6 +114,9 @@ public:
 
   const TpiKind kind;
   bool ownedGHashes = true;
+  /// Set for the TPI and IPI streams of the PDB written by the previous
+  /// /pdbincremental link. These sources are merged before all others.
+  bool isIncrementalBase = false;
   uint32_t tpiSrcIdx = 0;
 
 protected:
@@ -169,6 +172,8 @@ public:
 TpiSource *makeTpiSource(COFFLinkerContext &ctx, ObjFile *f);
 TpiSource *makeTypeServerSource(COFFLinkerContext &ctx,
                                 PDBInputFile *pdbInputFile);
+TpiSource *makeIncrementalBaseSource(COFFLinkerContext &ctx,
+                                     PDBInputFile *pdbInputFile);
 TpiSource *makeUseTypeServerSource(COFFLinkerContext &ctx, ObjFile *file,
                                    llvm::codeview::TypeServer2Record ts);
 TpiSource *makePrecompSource(COFFLinkerContext &ctx, ObjFile *file);
@@ -1755,6 +1755,13 @@ void LinkerDriver::linkerMain(ArrayRef<const char *> argsArr) {
   config->debugDwarf = debug == DebugKind::Dwarf;
   config->debugGHashes = debug == DebugKind::GHash || debug == DebugKind::Full;
   config->debugSymtab = debug == DebugKind::Symtab;
+  config->pdbIncremental =
+      args.hasFlag(OPT_pdb_incremental, OPT_pdb_incremental_no, false);
+  if (config->pdbIncremental && !config->debugGHashes) {
+    warn("ignoring '/pdbincremental' because global type hashing is "
+         "disabled; use '/debug:ghash' to enable it");
+    config->pdbIncremental = false;
+  }
   config->autoImport =
       args.hasFlag(OPT_auto_import, OPT_auto_import_no, config->mingw);
   config->pseudoRelocs = args.hasFlag(
@@ -12,12 +12,14 @@
 #include "Config.h"
 #include "DebugTypes.h"
 #include "Driver.h"
+#include "InputFiles.h"
 #include "SymbolTable.h"
 #include "Symbols.h"
 #include "TypeMerger.h"
 #include "Writer.h"
 #include "lld/Common/ErrorHandler.h"
 #include "lld/Common/Timer.h"
+#include "lld/Common/Version.h"
 #include "llvm/DebugInfo/CodeView/DebugFrameDataSubsection.h"
 #include "llvm/DebugInfo/CodeView/DebugSubsectionRecord.h"
 #include "llvm/DebugInfo/CodeView/GlobalTypeTableBuilder.h"
@@ -50,11 +52,13 @@
 #include "llvm/Support/BinaryByteStream.h"
 #include "llvm/Support/CRC.h"
 #include "llvm/Support/Endian.h"
+#include "llvm/Support/EndianStream.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/FormatAdapters.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/ScopedPrinter.h"
+#include "llvm/Support/xxhash.h"
 #include <memory>
 
 using namespace llvm;
@@ -91,6 +95,23 @@ public:
   /// Add named streams specified on the command line.
   void addNamedStreams();
 
+  /// Load the PDB written by the previous /pdbincremental link, if any.
+  void loadPreviousPdb();
+
+  /// Record the module keys of this link for the next /pdbincremental link.
+  void addIncrementalState();
+
+  /// Return a key that identifies the module symbol stream of the given
+  /// object file. If two links compute the same key for an object file, its
+  /// module symbol streams are identical.
+  uint64_t computeModuleKey(TpiSource *source);
+
+  /// Return the module symbol records of the given object file from the
+  /// previous PDB if they can be reused, or None otherwise. symbolsSize is the
+  /// size of the records without the stream signature.
+  Optional<ArrayRef<uint8_t>> findPreviousModuleSymbols(ObjFile &file,
+                                                        uint32_t symbolsSize);
+
   /// Link CodeView from each object file in the symbol table into the PDB.
   void addObjectsToPDB();
 
@@ -157,7 +178,19 @@ private:
 
   llvm::SmallString<128> nativePath;
 
+  /// The PDB written by the previous /pdbincremental link.
+  pdb::PDBFile *previousPdb = nullptr;
+
+  /// Map from module keys of the previous link to module indices in the
+  /// previous PDB.
+  DenseMap<uint64_t, uint32_t> previousModules;
+
+  /// Module keys of this link, indexed by module index. Zero means the module
+  /// has no key.
+  std::vector<uint64_t> moduleKeys;
+
   // For statistics
+  uint64_t reusedModules = 0;
   uint64_t globalSymbols = 0;
   uint64_t moduleSymbols = 0;
   uint64_t publicSymbols = 0;
@@ -910,10 +943,16 @@ getFileName(const DebugStringTableSubsectionRef &strings,
 void DebugSHandler::finish() {
   pdb::DbiStreamBuilder &dbiBuilder = linker.builder.getDbiBuilder();
 
-  // If we found any symbol records for the module symbol stream, defer them.
-  if (moduleStreamSize > kSymbolStreamMagicSize)
-    file.moduleDBI->addUnmergedSymbols(&file, moduleStreamSize -
-                                                  kSymbolStreamMagicSize);
+  // If we found any symbol records for the module symbol stream, defer them,
+  // unless the previous PDB has the very same records.
+  if (moduleStreamSize > kSymbolStreamMagicSize) {
+    uint32_t symbolsSize = moduleStreamSize - kSymbolStreamMagicSize;
+    if (Optional<ArrayRef<uint8_t>> symbols =
+            linker.findPreviousModuleSymbols(file, symbolsSize))
+      file.moduleDBI->addSymbolsInBulk(*symbols);
+    else
+      file.moduleDBI->addUnmergedSymbols(&file, symbolsSize);
+  }
 
   // We should have seen all debug subsections across the entire object file now
   // which means that if a StringTable subsection and Checksums subsection were
@@ -1017,6 +1056,10 @@ void PDBLinker::addDebugSymbols(TpiSource *source) {
     return;
 
   ScopedTimer t(ctx.symbolMergingTimer);
+  if (config->pdbIncremental)
+    moduleKeys[source->file->moduleDBI->getModuleIndex()] =
+        computeModuleKey(source);
+
   pdb::DbiStreamBuilder &dbiBuilder = builder.getDbiBuilder();
   DebugSHandler dsh(*this, *source->file, source);
   // Now do all live .debug$S and .debug$F sections.
@@ -1135,6 +1178,12 @@ void PDBLinker::addObjectsToPDB() {
   // Create module descriptors
   for_each(ctx.objFileInstances, [&](ObjFile *obj) { createModuleDBI(obj); });
 
+  // The previous PDB must be loaded before type sources are sorted.
+  if (config->pdbIncremental) {
+    moduleKeys.resize(ctx.objFileInstances.size());
+    loadPreviousPdb();
+  }
+
   // Reorder dependency type sources to come first.
   tMerger.sortDependencies();
 
@@ -1231,6 +1280,8 @@ void PDBLinker::printStats() {
   print(globalSymbols, "Global symbol records");
   print(moduleSymbols, "Module symbol records");
   print(publicSymbols, "Public symbol records");
+  if (config->pdbIncremental)
+    print(reusedModules, "Reused module symbol streams");
 
   auto printLargeInputTypeRecs = [&](StringRef name,
                                      ArrayRef<uint32_t> recCounts,
@@ -1321,6 +1372,180 @@ void PDBLinker::addNamedStreams() {
   }
 }
 
+// /pdbincremental stores the module keys of a link in this named stream.
+static constexpr const char *incrementalStateStream = "/lld/incremental";
+
+namespace {
+struct IncrementalStateHeader {
+  support::ulittle32_t version;
+  support::ulittle32_t numModules;
+};
+} // namespace
+
+enum : uint32_t { kIncrementalStateVersion = 1 };
+
+void PDBLinker::loadPreviousPdb() {
+  // Read the file into memory rather than mapping it, since it is about to be
+  // overwritten.
+  ErrorOr<std::unique_ptr<MemoryBuffer>> mbOrErr = MemoryBuffer::getFile(
+      config->pdbPath, /*IsText=*/false, /*RequiresNullTerminator=*/false,
+      /*IsVolatile=*/true);
+  if (!mbOrErr) {
+    log("/pdbincremental: no previous PDB: " + mbOrErr.getError().message());
+    return;
+  }
+  MemoryBufferRef mbref = (*mbOrErr)->getMemBufferRef();
+  driver->takeBuffer(std::move(*mbOrErr));
+
+  std::unique_ptr<pdb::IPDBSession> session;
+  if (Error e = pdb::NativeSession::createFromPdb(
+          MemoryBuffer::getMemBuffer(mbref, false), session)) {
+    log("/pdbincremental: cannot read previous PDB: " + toString(std::move(e)));
+    return;
+  }
+  pdb::PDBFile &pdbFile =
+      static_cast<pdb::NativeSession *>(session.get())->getPDBFile();
+
+  // Only reuse PDBs written by a /pdbincremental link, so that the types of
+  // unrelated PDBs do not leak into this one.
+  auto stateOrErr = pdbFile.safelyCreateNamedStream(incrementalStateStream);
+  if (!stateOrErr) {
+    log("/pdbincremental: previous PDB has no incremental state: " +
+        toString(stateOrErr.takeError()));
+    return;
+  }
+  BinaryStreamReader reader(**stateOrErr);
+  const IncrementalStateHeader *header;
+  FixedStreamArray<support::ulittle64_t> keys;
+  if (Error e = reader.readObject(header)) {
+    log("/pdbincremental: corrupt incremental state: " +
+        toString(std::move(e)));
+    return;
+  }
+  if (header->version != kIncrementalStateVersion) {
+    log("/pdbincremental: unknown incremental state version");
+    return;
+  }
+  if (Error e = reader.readArray(keys, header->numModules)) {
+    log("/pdbincremental: corrupt incremental state: " +
+        toString(std::move(e)));
+    return;
+  }
+
+  // The previous types are merged first, so they must all be readable.
+  auto dbiOrErr = pdbFile.getPDBDbiStream();
+  auto tpiOrErr = pdbFile.getPDBTpiStream();
+  Error ipiErr = Error::success();
+  if (pdbFile.hasPDBIpiStream())
+    ipiErr = pdbFile.getPDBIpiStream().takeError();
+  if (Error e = joinErrors(
+          joinErrors(dbiOrErr.takeError(), tpiOrErr.takeError()),
+          std::move(ipiErr))) {
+    log("/pdbincremental: cannot read previous PDB: " + toString(std::move(e)));
+    return;
+  }
+  // The machine type enumerations of COFF and PDB mirror each other.
+  if (static_cast<unsigned>(dbiOrErr->getMachineType()) != config->machine) {
+    log("/pdbincremental: previous PDB is for a different machine");
+    return;
+  }
+
+  uint32_t numModules =
+      std::min<uint32_t>(keys.size(), dbiOrErr->modules().getModuleCount());
+  for (uint32_t modi = 0; modi < numModules; ++modi)
+    if (keys[modi] != 0)
+      previousModules.try_emplace(keys[modi], modi);
+
+  auto *file = make<PDBInputFile>(ctx, mbref);
+  file->session.reset(static_cast<pdb::NativeSession *>(session.release()));
+  previousPdb = &file->session->getPDBFile();
+  makeIncrementalBaseSource(ctx, file);
+  log("/pdbincremental: loaded " + Twine(tpiOrErr->getNumTypeRecords()) +
+      " type records and " + Twine(previousModules.size()) +
+      " module keys from " + config->pdbPath);
+}
+
+uint64_t PDBLinker::computeModuleKey(TpiSource *source) {
+  // The module symbol stream is a function of the relocated .debug$S
+  // sections and of the type index maps. Hash those, as well as the linker
+  // version, which determines how they are combined.
+  std::vector<uint64_t> hashes;
+  hashes.push_back(xxHash64(getLLDVersion()));
+  std::vector<uint8_t> buffer;
+  for (SectionChunk *debugChunk : source->file->getDebugChunks()) {
+    if (!debugChunk->live || debugChunk->getSize() == 0 ||
+        debugChunk->getSectionName() != ".debug$S")
+      continue;
+    buffer.resize(debugChunk->getSize());
+    debugChunk->writeTo(buffer.data());
+    hashes.push_back(xxHash64(buffer));
+  }
+  auto hashMap = [&](ArrayRef<TypeIndex> map) {
+    hashes.push_back(xxHash64(makeArrayRef(
+        reinterpret_cast<const uint8_t *>(map.data()),
+        map.size() * sizeof(TypeIndex))));
+  };
+  hashMap(source->tpiMap);
+  hashMap(source->ipiMap);
+
+  uint64_t key = xxHash64(makeArrayRef(
+      reinterpret_cast<const uint8_t *>(hashes.data()),
+      hashes.size() * sizeof(uint64_t)));
+  // Zero is reserved for modules without a key.
+  return key ? key : 1;
+}
+
+Optional<ArrayRef<uint8_t>>
+PDBLinker::findPreviousModuleSymbols(ObjFile &file, uint32_t symbolsSize) {
+  if (!previousPdb)
+    return None;
+  uint64_t key = moduleKeys[file.moduleDBI->getModuleIndex()];
+  auto it = previousModules.find(key);
+  if (it == previousModules.end())
+    return None;
+
+  // The symbols must have the size we have just computed for them. Anything
+  // else means that the key is not trustworthy, so rebuild the symbols.
+  pdb::DbiStream &dbi = cantFail(previousPdb->getPDBDbiStream());
+  pdb::DbiModuleDescriptor desc = dbi.modules().getModuleDescriptor(it->second);
+  uint16_t streamIndex = desc.getModuleStreamIndex();
+  if (streamIndex == pdb::kInvalidStreamIndex ||
+      desc.getSymbolDebugInfoByteSize() !=
+          symbolsSize + kSymbolStreamMagicSize)
+    return None;
+
+  auto streamOrErr = previousPdb->safelyCreateIndexedStream(streamIndex);
+  if (!streamOrErr) {
+    consumeError(streamOrErr.takeError());
+    return None;
+  }
+  ArrayRef<uint8_t> symbols;
+  if (Error e = (*streamOrErr)
+                    ->readBytes(kSymbolStreamMagicSize, symbolsSize, symbols)) {
+    consumeError(std::move(e));
+    return None;
+  }
+
+  // The stream data may live in a cache of the stream, so copy it out.
+  uint8_t *buf = bAlloc.Allocate<uint8_t>(symbols.size());
+  memcpy(buf, symbols.data(), symbols.size());
+  ++reusedModules;
+  return makeArrayRef(buf, symbols.size());
+}
+
+void PDBLinker::addIncrementalState() {
+  std::string data;
+  raw_string_ostream os(data);
+  support::endian::write<uint32_t>(os, kIncrementalStateVersion,
+                                   support::little);
+  support::endian::write<uint32_t>(os, moduleKeys.size(), support::little);
+  for (uint64_t key : moduleKeys)
+    support::endian::write<uint64_t>(os, key, support::little);
+  exitOnErr(builder.addNamedStream(incrementalStateStream, os.str()));
+  log("/pdbincremental: reused " + Twine(reusedModules) + " of " +
+      Twine(moduleKeys.size()) + " module symbol streams");
+}
+
 static codeview::CPUType toCodeViewMachine(COFF::MachineTypes machine) {
   switch (machine) {
   case COFF::IMAGE_FILE_MACHINE_AMD64:
@@ -1575,6 +1800,8 @@ void lld::coff::createPDB(COFFLinkerContext &ctx,
   pdb.addSections(sectionTable);
   pdb.addNatvisFiles();
   pdb.addNamedStreams();
+  if (config->pdbIncremental)
+    pdb.addIncrementalState();
   pdb.addPublicsToPDB();
 
   ScopedTimer t2(ctx.diskCommitTimer);
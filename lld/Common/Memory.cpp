@@ -7,16 +7,27 @@
 //===----------------------------------------------------------------------===//
 
 #include "lld/Common/Memory.h"
+#include <mutex>
 
 using namespace llvm;
 using namespace lld;
 
 BumpPtrAllocator lld::bAlloc;
 StringSaver lld::saver{bAlloc};
+ConcurrentBumpPtrAllocator lld::cbAlloc;
 std::vector<SpecificAllocBase *> lld::SpecificAllocBase::instances;
 
+// Singletons for different types may be constructed by different threads.
+static std::mutex instancesMutex;
+
+SpecificAllocBase::SpecificAllocBase() {
+  std::lock_guard<std::mutex> lock(instancesMutex);
+  instances.push_back(this);
+}
+
 void lld::freeArena() {
   for (SpecificAllocBase *alloc : SpecificAllocBase::instances)
     alloc->reset();
   bAlloc.Reset();
+  cbAlloc.Reset();
 }
@@ -46,6 +46,9 @@ enum class BsymbolicKind { None, NonWeakFunctions, Functions, All };
 // For --build-id.
 enum class BuildIdKind { None, Fast, Md5, Sha1, Hexstring, Uuid };
 
+// For --compress-debug-sections.
+enum class DebugCompressionKind { None, Zlib, Zstd };
+
 // For --discard-{all,locals,none}.
 enum class DiscardPolicy { Default, All, Locals, None };
 
@@ -127,6 +130,7 @@ struct Configuration {
   llvm::StringRef soName;
   llvm::StringRef sysroot;
   llvm::StringRef thinLTOCacheDir;
+  llvm::StringRef thinLTOFunctionCacheDir;
   llvm::StringRef thinLTOIndexOnlyArg;
   llvm::StringRef whyExtract;
   StringRef zBtiReport = "none";
@@ -157,8 +161,9 @@ struct Configuration {
   bool callGraphProfileSort;
   bool checkSections;
   bool checkDynamicRelocs;
-  bool compressDebugSections;
+  DebugCompressionKind compressDebugSections;
   bool cref;
+  bool debugNames;
   std::vector<std::pair<llvm::GlobPattern, uint64_t>> deadRelocInNonAlloc;
   bool defineCommon;
   bool demangle = true;
@@ -180,6 +185,7 @@ struct Configuration {
   bool gnuUnique;
   bool hasDynSymTab;
   bool ignoreDataAddressEquality;
+  bool incremental;
   bool ignoreFunctionAddressEquality;
   bool ltoCSProfileGenerate;
   bool ltoPGOWarnMismatch;
@@ -214,6 +220,7 @@ struct Configuration {
   bool shared;
   bool symbolic;
   bool isStatic = false;
+  bool streamOutput;
   bool sysvHash = false;
   bool target1Rel;
   bool trace;
@@ -314,8 +321,9 @@ struct Configuration {
 
   // True if we need to set the DF_STATIC_TLS flag to an output file, which
   // works as a hint to the dynamic loader that the shared object contains code
-  // compiled with the initial-exec TLS model.
-  bool hasTlsIe = false;
+  // compiled with the initial-exec TLS model. This is set by
+  // TargetInfo::getRelExpr() from the parallel relocation scan.
+  std::atomic<bool> hasTlsIe{false};
 
   // Holds set of ELF header flags for the target.
   uint32_t eflags = 0;
@@ -33,7 +33,7 @@ public:
   }
 
   InputSection *getInfoSection() const {
-    return cast<InputSection>(infoSection.sec);
+    return cast_or_null<InputSection>(infoSection.sec);
   }
 
   const llvm::DWARFSection &getLoclistsSection() const override {
@@ -68,6 +68,10 @@ public:
     return gnuPubtypesSection;
   }
 
+  const LLDDWARFSection &getNamesSection() const override {
+    return namesSection;
+  }
+
   StringRef getFileName() const override { return ""; }
   StringRef getAbbrevSection() const override { return abbrevSection; }
   StringRef getStrSection() const override { return strSection; }
@@ -90,6 +94,7 @@ private:
   LLDDWARFSection gnuPubtypesSection;
   LLDDWARFSection infoSection;
   LLDDWARFSection loclistsSection;
+  LLDDWARFSection namesSection;
   LLDDWARFSection rangesSection;
   LLDDWARFSection rnglistsSection;
   LLDDWARFSection strOffsetsSection;
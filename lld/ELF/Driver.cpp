@@ -25,6 +25,7 @@
 #include "Driver.h"
 #include "Config.h"
 #include "ICF.h"
+#include "Incremental.h"
 #include "InputFiles.h"
 #include "InputSection.h"
 #include "LinkerScript.h"
@@ -86,6 +87,8 @@ bool elf::link(ArrayRef<const char *> args, bool canExitEarly,
     freeArena();
 
     inputSections.clear();
+    dependentSectionMap.clear();
+    jumpInstrMods.clear();
     outputSections.clear();
     memoryBuffers.clear();
     archiveFiles.clear();
@@ -346,14 +349,23 @@ static void checkOptions() {
       error("-r and -shared may not be used together");
     if (config->gdbIndex)
       error("-r and --gdb-index may not be used together");
+    if (config->debugNames)
+      error("-r and --debug-names may not be used together");
     if (config->icf != ICFLevel::None)
       error("-r and --icf may not be used together");
     if (config->pie)
       error("-r and -pie may not be used together");
     if (config->exportDynamic)
       error("-r and --export-dynamic may not be used together");
+    if (config->incremental)
+      error("-r and --incremental may not be used together");
   }
 
+  // An input section folded by ICF may be shared by several object files, so
+  // it cannot be patched on behalf of one of them.
+  if (config->incremental && config->icf != ICFLevel::None)
+    error("--icf and --incremental may not be used together");
+
   if (config->executeOnly) {
     if (config->emachine != EM_AARCH64)
       error("--execute-only is only supported on AArch64 targets");
@@ -911,15 +923,23 @@ template <class ELFT> static void readCallGraphsFromObjectFiles() {
   }
 }
 
-static bool getCompressDebugSections(opt::InputArgList &args) {
+static DebugCompressionKind
+getCompressDebugSections(opt::InputArgList &args) {
   StringRef s = args.getLastArgValue(OPT_compress_debug_sections, "none");
   if (s == "none")
-    return false;
-  if (s != "zlib")
-    error("unknown --compress-debug-sections value: " + s);
-  if (!zlib::isAvailable())
-    error("--compress-debug-sections: zlib is not available");
-  return true;
+    return DebugCompressionKind::None;
+  if (s == "zlib") {
+    if (!zlib::isAvailable())
+      error("--compress-debug-sections: zlib is not available");
+    return DebugCompressionKind::Zlib;
+  }
+  if (s == "zstd") {
+    if (!zstd::isAvailable())
+      error("--compress-debug-sections: zstd is not available");
+    return DebugCompressionKind::Zstd;
+  }
+  error("unknown --compress-debug-sections value: " + s);
+  return DebugCompressionKind::None;
 }
 
 static StringRef getAliasSpelling(opt::Arg *arg) {
@@ -1009,6 +1029,8 @@ static void readConfigs(opt::InputArgList &args) {
   config->chroot = args.getLastArgValue(OPT_chroot);
   config->compressDebugSections = getCompressDebugSections(args);
   config->cref = args.hasArg(OPT_cref);
+  config->debugNames =
+      args.hasFlag(OPT_debug_names, OPT_no_debug_names, false);
   config->defineCommon = args.hasFlag(OPT_define_common, OPT_no_define_common,
                                       !args.hasArg(OPT_relocatable));
   config->optimizeBBJumps =
@@ -1053,6 +1075,8 @@ static void readConfigs(opt::InputArgList &args) {
       args.hasArg(OPT_ignore_data_address_equality);
   config->ignoreFunctionAddressEquality =
       args.hasArg(OPT_ignore_function_address_equality);
+  config->incremental =
+      args.hasFlag(OPT_incremental, OPT_no_incremental, false);
   config->init = args.getLastArgValue(OPT_init, "_init");
   config->ltoAAPipeline = args.getLastArgValue(OPT_lto_aa_pipeline);
   config->ltoCSProfileGenerate = args.hasArg(OPT_lto_cs_profile_generate);
@@ -1125,6 +1149,8 @@ static void readConfigs(opt::InputArgList &args) {
   config->soName = args.getLastArgValue(OPT_soname);
   config->sortSection = getSortSection(args);
   config->splitStackAdjustSize = args::getInteger(args, OPT_split_stack_adjust_size, 16384);
+  config->streamOutput =
+      args.hasFlag(OPT_stream_output, OPT_no_stream_output, false);
   config->strip = getStrip(args);
   config->sysroot = args.getLastArgValue(OPT_sysroot);
   config->target1Rel = args.hasFlag(OPT_target1_rel, OPT_target1_abs, false);
@@ -1134,6 +1160,8 @@ static void readConfigs(opt::InputArgList &args) {
       parseCachePruningPolicy(args.getLastArgValue(OPT_thinlto_cache_policy)),
       "--thinlto-cache-policy: invalid cache policy");
   config->thinLTOEmitImportsFiles = args.hasArg(OPT_thinlto_emit_imports_files);
+  config->thinLTOFunctionCacheDir =
+      args.getLastArgValue(OPT_thinlto_function_cache_dir);
   config->thinLTOIndexOnly = args.hasArg(OPT_thinlto_index_only) ||
                              args.hasArg(OPT_thinlto_index_only_eq);
   config->thinLTOIndexOnlyArg = args.getLastArgValue(OPT_thinlto_index_only_eq);
@@ -2269,6 +2297,12 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &args) {
   if (errorCount())
     return;
 
+  // With --incremental, try to update the previous output in place. If that
+  // is not possible, fall back to a regular link, which also saves the state
+  // needed by the next incremental link.
+  if (config->incremental && tryIncrementalLink<ELFT>(args, files))
+    return;
+
   // Use default entry point name if no name was given via the command
   // line nor linker scripts. For some reason, MIPS entry point name is
   // different from others.
@@ -2286,6 +2320,23 @@ template <class ELFT> void LinkerDriver::link(opt::InputArgList &args) {
   for (StringRef name : config->undefined)
     addUnusedUndefined(name)->referenced = true;
 
+  // Insert the global symbols of the leading object files into the symbol
+  // table using multiple threads. This is the same as what parseFile() would
+  // do first for these files, because no archive or shared object precedes
+  // them. Symbol resolution is still done serially below, so the result does
+  // not depend on the number of threads.
+  if (config->emachine != EM_MIPS) {
+    llvm::TimeTraceScope timeScope("Insert symbols");
+    SmallVector<ObjFile<ELFT> *, 0> objs;
+    for (InputFile *f : files) {
+      if (f->kind() != InputFile::ObjKind || f->lazy ||
+          f->ekind != config->ekind || f->emachine != config->emachine)
+        break;
+      objs.push_back(cast<ObjFile<ELFT>>(f));
+    }
+    symtab->insertGlobals<ELFT>(objs);
+  }
+
   // Add all files to the symbol table. This will add almost all
   // symbols that we need to the symbol table. This process might
   // add files to the link, via autolinking, these files are always
@@ -494,7 +494,7 @@ template <class ELFT> void ICF<ELFT>::run() {
   // Initially, we use hash values to partition sections.
   parallelForEach(sections, [&](InputSection *s) {
     // Set MSB to 1 to avoid collisions with unique IDs.
-    s->eqClass[0] = xxHash64(s->data()) | (1U << 31);
+    s->eqClass[0] = xxh3_64bits(s->data()) | (1U << 31);
   });
 
   // Perform 2 rounds of relocation hash propagation. 2 is an empirical value to
@@ -546,7 +546,7 @@ template <class ELFT> void ICF<ELFT>::run() {
       // At this point we know sections merged are fully identical and hence
       // we want to remove duplicate implicit dependencies such as link order
       // and relocation sections.
-      for (InputSection *isec : sections[i]->dependentSections)
+      for (InputSection *isec : sections[i]->getDependentSections())
         isec->markDead();
     }
   });
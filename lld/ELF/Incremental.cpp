@@ -0,0 +1,910 @@
+//===- Incremental.cpp ----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements --incremental. When only a few object files have
+// changed since the last link, --incremental updates the previous output in
+// place instead of linking it again from scratch.
+//
+// A full link with --incremental leaves some padding after each allocated
+// input section that can safely be padded (see getIncrementalPadding()). Each
+// such section thus occupies a "slot" in the output that is larger than the
+// section itself. Once the output is written, we save a state file next to
+// it. The state file records the following:
+//
+//  - the files that have been read and their sizes and timestamps,
+//  - for each object file, the location of the slot of each padded section,
+//    and hash values of all other sections and of all local symbols,
+//  - for each object file, the global symbols it defines,
+//  - the addresses of all global symbols after the link.
+//
+// The next link with the same command line compares its input files with the
+// state file. Suppose some object files given directly on the command line
+// have changed, while each of them still has the same sections and defines
+// the same symbols at the same section offsets, and each padded section still
+// fits its slot. Then no symbol in the output moves. It is enough to apply
+// relocations to the new sections using the saved symbol addresses and copy
+// them into their slots. The only other things to update are the st_size
+// fields of the changed files' symbols in .symtab and the build ID.
+//
+// If any of these conditions does not hold, we fall back to a full link,
+// which writes a new state file. For example, this happens if a non-padded
+// section (e.g. .eh_frame or a debug section) changes, a symbol is added, or
+// a relocation needs a GOT, PLT or dynamic relocation that the output does
+// not already have. It also happens if any input other than an object file
+// changes, e.g. an archive, a shared library or a linker script. Run lld with
+// --verbose to see the reason.
+//
+// For now only x86-64 and AArch64 outputs can be patched.
+//
+//===----------------------------------------------------------------------===//
+
+#include "Incremental.h"
+#include "Config.h"
+#include "InputFiles.h"
+#include "InputSection.h"
+#include "OutputSections.h"
+#include "SymbolTable.h"
+#include "Symbols.h"
+#include "SyntheticSections.h"
+#include "Target.h"
+#include "Writer.h"
+#include "lld/Common/ErrorHandler.h"
+#include "lld/Common/Strings.h"
+#include "lld/Common/Version.h"
+#include "llvm/ADT/CachedHashString.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Option/ArgList.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Parallel.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/xxhash.h"
+
+using namespace llvm;
+using namespace llvm::ELF;
+using namespace llvm::object;
+using namespace llvm::support::endian;
+using namespace lld;
+using namespace lld::elf;
+
+// Bump this when the format of the state file changes.
+static constexpr unsigned stateVersion = 1;
+
+// A hash value of the linker version, the working directory and the command
+// line. A state file can only be used by a link with the same hash value.
+static uint64_t argsHash;
+
+// Flags of global symbols in the state file.
+enum : uint8_t {
+  SYM_PREEMPTIBLE = 1 << 0,
+  SYM_IFUNC = 1 << 1,
+  SYM_ABSOLUTE = 1 << 2,
+};
+
+static std::string getStatePath() {
+  return (config->outputFile + ".lld-incremental").str();
+}
+
+namespace {
+struct FileStamp {
+  uint64_t size = -1;
+  int64_t mtime = 0;
+
+  bool operator==(const FileStamp &other) const {
+    return size == other.size && mtime == other.mtime;
+  }
+};
+} // namespace
+
+static FileStamp getStamp(StringRef path) {
+  sys::fs::file_status st;
+  if (sys::fs::status(path, st))
+    return {};
+  return {st.getSize(),
+          st.getLastModificationTime().time_since_epoch().count()};
+}
+
+static uint64_t hashArgs(opt::InputArgList &args) {
+  SmallString<0> buf;
+  raw_svector_ostream os(buf);
+  SmallString<128> cwd;
+  sys::fs::current_path(cwd);
+  os << getLLDVersion() << '\0' << cwd << '\0';
+  for (opt::Arg *arg : args)
+    os << arg->getAsString(args) << '\0';
+  return xxHash64(buf);
+}
+
+// Returns true if an output linked with the current options can be patched.
+static bool isPatchable() {
+  if (config->emachine != EM_X86_64 && config->emachine != EM_AARCH64)
+    return false;
+
+  // We do not update auxiliary outputs, and the Cortex-A53 erratum fix may
+  // patch the contents of any executable section.
+  return config->outputFile != "-" && !config->oFormatBinary &&
+         !config->emitRelocs && !config->fixCortexA53Errata843419 &&
+         config->buildId != BuildIdKind::Hexstring && config->mapFile.empty() &&
+         !config->cref && config->whyExtract.empty() &&
+         config->printArchiveStats.empty() && config->dependencyFile.empty() &&
+         !tar;
+}
+
+uint64_t elf::getIncrementalPadding(const InputSection *sec) {
+  OutputSection *osec = sec->getParent();
+  if (!osec || sec->kind() != SectionBase::Regular ||
+      !(sec->flags & SHF_ALLOC) || !sec->file ||
+      sec->file->kind() != InputFile::ObjKind)
+    return 0;
+
+  // Padding would break sections that are read as arrays or lists of records,
+  // and the prologues and epilogues that make up .init and .fini.
+  if ((sec->flags & SHF_LINK_ORDER) || sec->type == SHT_NOTE ||
+      sec->type == SHT_INIT_ARRAY || sec->type == SHT_FINI_ARRAY ||
+      sec->type == SHT_PREINIT_ARRAY)
+    return 0;
+  StringRef name = osec->name;
+  if (isValidCIdentifier(name) || name == ".init" || name == ".fini" ||
+      name == ".ctors" || name == ".dtors")
+    return 0;
+
+  // Leave room for the section to grow by a quarter.
+  return alignTo(sec->getSize() / 4 + 16, 16);
+}
+
+// Sections that do not end up in the output as they are. Their contents are
+// covered by the hash values of other sections and symbols.
+static bool isIgnoredSection(uint32_t type) {
+  switch (type) {
+  case SHT_NULL:
+  case SHT_SYMTAB:
+  case SHT_SYMTAB_SHNDX:
+  case SHT_STRTAB:
+  case SHT_REL:
+  case SHT_RELA:
+  case SHT_LLVM_ADDRSIG:
+  case SHT_LLVM_CALL_GRAPH_PROFILE:
+    return true;
+  default:
+    return false;
+  }
+}
+
+template <class ELFT>
+static std::vector<const typename ELFT::Shdr *>
+getRelocSections(ArrayRef<typename ELFT::Shdr> shdrs) {
+  std::vector<const typename ELFT::Shdr *> ret(shdrs.size());
+  for (const typename ELFT::Shdr &sec : shdrs)
+    if ((sec.sh_type == SHT_REL || sec.sh_type == SHT_RELA) &&
+        sec.sh_info < shdrs.size())
+      ret[sec.sh_info] = &sec;
+  return ret;
+}
+
+// The header fields a padded section must keep.
+template <class ELFT>
+static uint64_t hashSlotHeader(const typename ELFT::Shdr &sec, StringRef name) {
+  SmallString<64> buf;
+  raw_svector_ostream os(buf);
+  os << name << '\0' << uint64_t(sec.sh_type) << ' ' << uint64_t(sec.sh_flags);
+  return xxHash64(buf);
+}
+
+template <class ELFT>
+static uint64_t hashSection(const ELFFile<ELFT> &obj,
+                            const typename ELFT::Shdr &sec,
+                            const typename ELFT::Shdr *relSec, StringRef name) {
+  SmallString<128> buf;
+  raw_svector_ostream os(buf);
+  os << name << '\0' << uint64_t(sec.sh_type) << ' ' << uint64_t(sec.sh_flags)
+     << ' ' << uint64_t(sec.sh_addralign) << ' ' << uint64_t(sec.sh_entsize)
+     << ' ' << uint64_t(sec.sh_link) << ' ' << uint64_t(sec.sh_info) << ' '
+     << uint64_t(sec.sh_size);
+  if (sec.sh_type != SHT_NOBITS)
+    os << ' ' << xxh3_64bits(check(obj.getSectionContents(sec)));
+  if (relSec)
+    os << ' ' << xxh3_64bits(check(obj.getSectionContents(*relSec)));
+  return xxHash64(buf);
+}
+
+template <class ELFT>
+static uint64_t hashSymbol(const typename ELFT::Sym &sym, StringRef strtab) {
+  SmallString<64> buf;
+  raw_svector_ostream os(buf);
+  os << check(sym.getName(strtab)) << '\0' << unsigned(sym.st_info) << ' '
+     << unsigned(sym.st_other) << ' ' << unsigned(sym.st_shndx) << ' '
+     << uint64_t(sym.st_value);
+  return xxHash64(buf);
+}
+
+template <class ELFT>
+static uint64_t hashLocals(ArrayRef<typename ELFT::Sym> syms,
+                           StringRef strtab) {
+  SmallVector<uint64_t, 0> hashes;
+  for (const typename ELFT::Sym &sym : syms)
+    hashes.push_back(hashSymbol<ELFT>(sym, strtab));
+  return xxHash64(toStringRef(makeArrayRef(
+      reinterpret_cast<const uint8_t *>(hashes.data()), hashes.size() * 8)));
+}
+
+template <class ELFT> static size_t getFirstGlobal(ObjFile<ELFT> &file) {
+  return file.template getELFSyms<ELFT>().size() -
+         file.template getGlobalELFSyms<ELFT>().size();
+}
+
+template <class ELFT> void elf::writeIncrementalState() {
+  llvm::TimeTraceScope timeScope("Write incremental state");
+  using Elf_Shdr = typename ELFT::Shdr;
+  using Elf_Sym = typename ELFT::Sym;
+
+  std::string path = getStatePath();
+  for (const CachedHashString &s : config->dependencyFiles) {
+    if (s.val().find_first_of("\t\n") != StringRef::npos) {
+      log("--incremental: cannot save the state of " + s.val());
+      sys::fs::remove(path);
+      return;
+    }
+  }
+
+  std::error_code ec;
+  raw_fd_ostream os(path, ec, sys::fs::OF_None);
+  if (ec) {
+    warn("cannot open " + path + ": " + ec.message());
+    return;
+  }
+
+  FileStamp out = getStamp(config->outputFile);
+  os << "lld-incremental\t" << stateVersion << '\t' << argsHash << '\n';
+  os << "output\t" << out.size << '\t' << out.mtime << '\n';
+  for (const CachedHashString &s : config->dependencyFiles) {
+    FileStamp st = getStamp(s.val());
+    os << "input\t" << st.size << '\t' << st.mtime << '\t' << s.val() << '\n';
+  }
+
+  // The build ID is a hash value of the output with zeroes in place of the
+  // build IDs, so we need to know where they are to recompute it.
+  if (config->buildId != BuildIdKind::None)
+    for (Partition &part : partitions)
+      if (part.buildId && part.buildId->getParent())
+        os << "buildid\t"
+           << part.buildId->getParent()->offset + part.buildId->outSecOff + 16
+           << '\t' << part.buildId->hashSize << '\n';
+
+  // Map symbols to the file offsets of their .symtab entries.
+  DenseMap<const Symbol *, uint64_t> symtabOffsets;
+  if (in.symTab && in.symTab->getParent()) {
+    uint64_t off = in.symTab->getParent()->offset + in.symTab->outSecOff;
+    for (const SymbolTableEntry &ent : in.symTab->getSymbols())
+      symtabOffsets[ent.sym] = off += sizeof(Elf_Sym);
+  }
+
+  for (ELFFileBase *f : objectFiles) {
+    auto *file = cast<ObjFile<ELFT>>(f);
+    if (!file->archiveName.empty())
+      continue;
+
+    const ELFFile<ELFT> obj = file->getObj();
+    ArrayRef<Elf_Shdr> shdrs = file->template getELFShdrs<ELFT>();
+    ArrayRef<Elf_Sym> eSyms = file->template getELFSyms<ELFT>();
+    ArrayRef<Symbol *> syms = file->getSymbols();
+    StringRef strtab = file->getStringTable();
+    size_t firstGlobal = getFirstGlobal(*file);
+    os << "object\t" << shdrs.size() << '\t' << eSyms.size() << '\t'
+       << hashLocals<ELFT>(eSyms.take_front(firstGlobal), strtab) << '\t'
+       << file->getName() << '\n';
+
+    StringRef shstrtab = CHECK(obj.getSectionStringTable(shdrs), file);
+    std::vector<const Elf_Shdr *> relSecs = getRelocSections<ELFT>(shdrs);
+    ArrayRef<InputSectionBase *> sections = file->getSections();
+    for (size_t i = 0, e = shdrs.size(); i != e; ++i) {
+      const Elf_Shdr &sec = shdrs[i];
+      if (isIgnoredSection(sec.sh_type))
+        continue;
+      StringRef name = CHECK(obj.getSectionName(sec, shstrtab), file);
+      auto *isec = dyn_cast_or_null<InputSection>(sections[i]);
+      if (uint64_t pad = isec ? getIncrementalPadding(isec) : 0) {
+        OutputSection *osec = isec->getParent();
+        std::array<uint8_t, 4> filler = osec->getFiller();
+        os << "slot\t" << i << '\t' << hashSlotHeader<ELFT>(sec, name) << '\t'
+           << osec->offset + isec->outSecOff << '\t' << isec->getVA() << '\t'
+           << isec->getSize() + pad << '\t' << read32be(filler.data()) << '\t'
+           << (osec->type == SHT_NOBITS) << '\n';
+        continue;
+      }
+      os << "section\t" << i << '\t'
+         << hashSection<ELFT>(obj, sec, relSecs[i], name) << '\n';
+    }
+
+    for (size_t i = 1; i < firstGlobal; ++i)
+      if (uint64_t off = symtabOffsets.lookup(syms[i]))
+        os << "local\t" << i << '\t' << off << '\n';
+    for (size_t i = firstGlobal, e = eSyms.size(); i != e; ++i) {
+      const Elf_Sym &eSym = eSyms[i];
+      if (eSym.st_shndx == SHN_UNDEF)
+        continue;
+      Symbol *sym = syms[i];
+      bool prevailing = sym->file == file;
+      os << "global\t" << i << '\t' << hashSymbol<ELFT>(eSym, strtab) << '\t'
+         << uint64_t(eSym.st_size) << '\t'
+         << (prevailing ? symtabOffsets.lookup(sym) : 0) << '\t'
+         << (prevailing && sym->includeInDynsym()) << '\n';
+    }
+  }
+
+  for (Symbol *sym : symtab->symbols()) {
+    uint64_t va = 0;
+    uint8_t flags = 0;
+    if (auto *d = dyn_cast<Defined>(sym)) {
+      if (d->section && !d->section->isLive())
+        continue;
+      va = d->getVA();
+      if (!d->section)
+        flags |= SYM_ABSOLUTE;
+    } else if (!sym->isShared()) {
+      continue;
+    }
+    if (sym->isPreemptible)
+      flags |= SYM_PREEMPTIBLE;
+    if (sym->isGnuIFunc())
+      flags |= SYM_IFUNC;
+    os << "symbol\t" << va << '\t' << (sym->isInGot() ? sym->getGotVA() : 0)
+       << '\t' << (sym->isInPlt() ? sym->getPltVA() : 0) << '\t'
+       << unsigned(flags) << '\t' << sym->getName() << '\n';
+  }
+}
+
+namespace {
+struct Slot {
+  uint64_t headerHash;
+  uint64_t fileOff;
+  uint64_t va;
+  uint64_t capacity;
+  uint32_t filler;
+  uint8_t noBits;
+};
+
+struct GlobalDef {
+  uint64_t hash;
+  uint64_t size;
+  uint64_t symtabOff;
+  uint8_t dynsym;
+};
+
+struct ObjectState {
+  StringRef path;
+  uint64_t numSections;
+  uint64_t numSymbols;
+  uint64_t localsHash;
+  DenseMap<uint32_t, Slot> slots;
+  DenseMap<uint32_t, uint64_t> sectionHashes;
+  DenseMap<uint32_t, GlobalDef> globals;
+  SmallVector<std::pair<uint32_t, uint64_t>, 0> locals;
+};
+
+struct GlobalSym {
+  uint64_t va;
+  uint64_t gotVA;
+  uint64_t pltVA;
+  uint8_t flags;
+};
+
+// The contents of a state file. StringRefs point into the file's buffer.
+struct IncrementalState {
+  bool parse(StringRef data);
+
+  uint64_t version = 0;
+  uint64_t argsHash = 0;
+  FileStamp output;
+  SmallVector<std::pair<StringRef, FileStamp>, 0> inputs;
+  SmallVector<std::pair<uint64_t, uint64_t>, 0> buildIds;
+  std::vector<ObjectState> objects;
+  DenseMap<CachedHashStringRef, GlobalSym> symbols;
+};
+
+// A range of bytes to be written to the output.
+struct Patch {
+  uint64_t fileOff;
+  SmallVector<uint8_t, 0> data;
+};
+} // namespace
+
+bool IncrementalState::parse(StringRef data) {
+  SmallVector<StringRef, 8> f;
+  auto num = [&](size_t i, auto &v) {
+    return i < f.size() && to_integer(f[i], v, 10);
+  };
+
+  ObjectState *obj = nullptr;
+  while (!data.empty()) {
+    StringRef line;
+    std::tie(line, data) = data.split('\n');
+    StringRef kind = line.split('\t').first;
+    f.clear();
+
+    // The last field of "input", "object" and "symbol" is a path or a
+    // symbol name, which may contain anything but a tab or a newline.
+    if (kind == "input") {
+      line.split(f, '\t', 3);
+      FileStamp st;
+      if (f.size() != 4 || !num(1, st.size) || !num(2, st.mtime))
+        return false;
+      inputs.push_back({f[3], st});
+    } else if (kind == "object") {
+      line.split(f, '\t', 4);
+      objects.emplace_back();
+      obj = &objects.back();
+      if (f.size() != 5 || !num(1, obj->numSections) ||
+          !num(2, obj->numSymbols) || !num(3, obj->localsHash))
+        return false;
+      obj->path = f[4];
+    } else if (kind == "symbol") {
+      line.split(f, '\t', 5);
+      GlobalSym sym;
+      if (f.size() != 6 || !num(1, sym.va) || !num(2, sym.gotVA) ||
+          !num(3, sym.pltVA) || !num(4, sym.flags))
+        return false;
+      symbols[CachedHashStringRef(f[5])] = sym;
+    } else if (kind == "slot") {
+      line.split(f, '\t');
+      uint32_t idx;
+      Slot slot;
+      if (!obj || !num(1, idx) || !num(2, slot.headerHash) ||
+          !num(3, slot.fileOff) || !num(4, slot.va) || !num(5, slot.capacity) ||
+          !num(6, slot.filler) || !num(7, slot.noBits))
+        return false;
+      obj->slots[idx] = slot;
+    } else if (kind == "section") {
+      line.split(f, '\t');
+      uint32_t idx;
+      uint64_t hash;
+      if (!obj || !num(1, idx) || !num(2, hash))
+        return false;
+      obj->sectionHashes[idx] = hash;
+    } else if (kind == "global") {
+      line.split(f, '\t');
+      uint32_t idx;
+      GlobalDef def;
+      if (!obj || !num(1, idx) || !num(2, def.hash) || !num(3, def.size) ||
+          !num(4, def.symtabOff) || !num(5, def.dynsym))
+        return false;
+      obj->globals[idx] = def;
+    } else if (kind == "local") {
+      line.split(f, '\t');
+      uint32_t idx;
+      uint64_t off;
+      if (!obj || !num(1, idx) || !num(2, off))
+        return false;
+      obj->locals.push_back({idx, off});
+    } else if (kind == "buildid") {
+      line.split(f, '\t');
+      uint64_t off, size;
+      if (!num(1, off) || !num(2, size))
+        return false;
+      buildIds.push_back({off, size});
+    } else if (kind == "output") {
+      line.split(f, '\t');
+      if (!num(1, output.size) || !num(2, output.mtime))
+        return false;
+    } else if (kind == "lld-incremental") {
+      line.split(f, '\t');
+      if (!num(1, version) || !num(2, argsHash))
+        return false;
+    } else if (!line.empty()) {
+      return false;
+    }
+  }
+  return version == stateVersion;
+}
+
+// Computes the new contents of the slots of a changed object file and the
+// updates to .symtab. Returns false with a reason if the file cannot be
+// patched in place.
+template <class ELFT>
+static bool planPatches(ObjFile<ELFT> &file, const ObjectState &st,
+                        const IncrementalState &state,
+                        std::vector<Patch> &patches, std::string &reason) {
+  using Elf_Shdr = typename ELFT::Shdr;
+  using Elf_Sym = typename ELFT::Sym;
+
+  auto fail = [&](const Twine &msg) {
+    reason = (toString(&file) + ": " + msg).str();
+    return false;
+  };
+
+  const ELFFile<ELFT> obj = file.getObj();
+  ArrayRef<Elf_Shdr> shdrs = file.template getELFShdrs<ELFT>();
+  ArrayRef<Elf_Sym> eSyms = file.template getELFSyms<ELFT>();
+  StringRef strtab = file.getStringTable();
+  size_t firstGlobal = getFirstGlobal(file);
+  if (shdrs.size() != st.numSections)
+    return fail("the number of sections changed");
+  if (eSyms.size() != st.numSymbols ||
+      hashLocals<ELFT>(eSyms.take_front(firstGlobal), strtab) != st.localsHash)
+    return fail("local symbols changed");
+
+  // Check that sections that are not padded are unchanged, and that padded
+  // ones still fit their slots.
+  StringRef shstrtab = CHECK(obj.getSectionStringTable(shdrs), &file);
+  std::vector<const Elf_Shdr *> relSecs = getRelocSections<ELFT>(shdrs);
+  SmallVector<const Slot *, 0> slots(shdrs.size());
+  for (size_t i = 0, e = shdrs.size(); i != e; ++i) {
+    const Elf_Shdr &sec = shdrs[i];
+    auto slotIt = st.slots.find(i);
+    auto hashIt = st.sectionHashes.find(i);
+    if (isIgnoredSection(sec.sh_type)) {
+      if (slotIt != st.slots.end() || hashIt != st.sectionHashes.end())
+        return fail("the type of section " + Twine(i) + " changed");
+      continue;
+    }
+
+    StringRef name = CHECK(obj.getSectionName(sec, shstrtab), &file);
+    if (slotIt == st.slots.end()) {
+      if (hashIt == st.sectionHashes.end() ||
+          hashIt->second != hashSection<ELFT>(obj, sec, relSecs[i], name))
+        return fail("section " + name + " changed");
+      continue;
+    }
+
+    const Slot &slot = slotIt->second;
+    if (slot.headerHash != hashSlotHeader<ELFT>(sec, name) ||
+        (sec.sh_flags & SHF_COMPRESSED))
+      return fail("the type or flags of section " + name + " changed");
+    if (sec.sh_size > slot.capacity)
+      return fail("section " + name + " does not fit its slot");
+    if (sec.sh_addralign > 1 && slot.va % sec.sh_addralign)
+      return fail("the alignment of section " + name + " increased");
+    if (!slot.noBits && slot.fileOff + slot.capacity > state.output.size)
+      return fail("the slot of section " + name + " is out of bounds");
+    slots[i] = &slot;
+  }
+
+  // Check that global symbols are defined at the same offsets as before.
+  // Symbol sizes may change, so update them in .symtab.
+  auto addSizePatch = [&](uint64_t symtabOff, uint64_t size) {
+    Elf_Sym tmp;
+    tmp.st_size = size;
+    const uint8_t *p = reinterpret_cast<const uint8_t *>(&tmp.st_size);
+    patches.push_back({symtabOff + (p - reinterpret_cast<uint8_t *>(&tmp)),
+                       SmallVector<uint8_t, 0>(p, p + sizeof(tmp.st_size))});
+  };
+  for (size_t i = firstGlobal, e = eSyms.size(); i != e; ++i) {
+    const Elf_Sym &eSym = eSyms[i];
+    auto it = st.globals.find(i);
+    if (eSym.st_shndx == SHN_UNDEF) {
+      if (it != st.globals.end())
+        return fail("a global symbol is no longer defined");
+      continue;
+    }
+    StringRef name = CHECK(eSym.getName(strtab), &file);
+    if (it == st.globals.end() ||
+        it->second.hash != hashSymbol<ELFT>(eSym, strtab))
+      return fail("global symbol " + name + " was added or moved");
+    const GlobalDef &def = it->second;
+    if (def.size == eSym.st_size)
+      continue;
+    if (def.dynsym)
+      return fail("the size of exported symbol " + name + " changed");
+    if (def.symtabOff)
+      addSizePatch(def.symtabOff, eSym.st_size);
+  }
+  for (const std::pair<uint32_t, uint64_t> &local : st.locals)
+    if (local.first < eSyms.size())
+      addSizePatch(local.second, eSyms[local.first].st_size);
+
+  // Compute the new contents of the slots.
+  for (size_t i = 0, e = shdrs.size(); i != e; ++i) {
+    const Slot *slot = slots[i];
+    if (!slot || slot->noBits)
+      continue;
+    const Elf_Shdr &sec = shdrs[i];
+    patches.push_back({slot->fileOff, {}});
+    SmallVector<uint8_t, 0> &buf = patches.back().data;
+    buf.resize(slot->capacity);
+    if (sec.sh_type != SHT_NOBITS) {
+      ArrayRef<uint8_t> data = CHECK(obj.getSectionContents(sec), &file);
+      memcpy(buf.data(), data.data(), data.size());
+    }
+
+    // Fill the rest of the slot in the same way as OutputSection::writeTo.
+    uint8_t filler[4];
+    write32be(filler, slot->filler);
+    for (size_t j = sec.sh_size; j != slot->capacity; ++j)
+      buf[j] = filler[(j - sec.sh_size) % 4];
+
+    auto relocate = [&](uint64_t offset, RelType type, uint32_t symIndex,
+                        int64_t addend, bool implicitAddend) {
+      if (offset >= sec.sh_size || symIndex >= eSyms.size())
+        return fail("invalid relocation");
+      uint8_t *loc = buf.data() + offset;
+      if (implicitAddend)
+        addend = target->getImplicitAddend(loc, type);
+
+      const Elf_Sym &eSym = eSyms[symIndex];
+      StringRef name = CHECK(eSym.getName(strtab), &file);
+      Defined sym(&file, name, eSym.getBinding(), eSym.st_other,
+                  eSym.getType(), eSym.st_value, eSym.st_size,
+                  /*section=*/nullptr);
+      RelExpr expr = target->getRelExpr(type, sym, loc);
+      if (expr == R_NONE)
+        return true;
+
+      // Find the address of the target symbol.
+      GlobalSym s = {};
+      if (symIndex >= firstGlobal) {
+        auto it = state.symbols.find(CachedHashStringRef(name));
+        if (it == state.symbols.end())
+          return fail("new reference to " + name);
+        s = it->second;
+      } else if (eSym.getType() == STT_TLS || eSym.getType() == STT_GNU_IFUNC) {
+        return fail("reference to local symbol " + name);
+      } else if (eSym.st_shndx == SHN_ABS) {
+        s.va = eSym.st_value;
+        s.flags = SYM_ABSOLUTE;
+      } else if (eSym.st_shndx < slots.size() && slots[eSym.st_shndx]) {
+        s.va = slots[eSym.st_shndx]->va + eSym.st_value;
+      } else {
+        return fail("reference to a section that is not padded");
+      }
+      if (s.flags & SYM_IFUNC)
+        return fail("reference to ifunc " + name);
+
+      bool preemptible = s.flags & SYM_PREEMPTIBLE;
+      uint64_t p = slot->va + offset;
+      uint64_t val;
+      switch (expr) {
+      case R_ABS:
+        // Outside of low page bits, an absolute reference to a relocatable
+        // address needs a dynamic relocation in a PIC output.
+        if (preemptible || (config->isPic && !(s.flags & SYM_ABSOLUTE) &&
+                            !target->usesOnlyLowPageBits(type)))
+          return fail("relocation to " + name + " needs a dynamic relocation");
+        val = s.va + addend;
+        break;
+      case R_PC:
+        if (preemptible)
+          return fail("relocation to " + name + " needs a dynamic relocation");
+        val = s.va + addend - p;
+        break;
+      case R_AARCH64_PAGE_PC:
+        if (preemptible)
+          return fail("relocation to " + name + " needs a dynamic relocation");
+        val = getAArch64Page(s.va + addend) - getAArch64Page(p);
+        break;
+      case R_PLT_PC:
+        if (preemptible) {
+          if (!s.pltVA)
+            return fail("call to " + name + " needs a new PLT entry");
+          s.va = s.pltVA;
+        }
+        if (target->needsThunks && !target->inBranchRange(type, p, s.va))
+          return fail("call to " + name + " needs a thunk");
+        val = s.va + addend - p;
+        break;
+      case R_GOT_PC:
+        // Relax the GOT reference in the same way as a full link would.
+        if (!preemptible && !(s.flags & SYM_ABSOLUTE)) {
+          RelExpr relaxed = target->adjustGotPcExpr(type, addend, loc);
+          if (relaxed == R_RELAX_GOT_PC || relaxed == R_RELAX_GOT_PC_NOPIC) {
+            val = s.va + addend - (relaxed == R_RELAX_GOT_PC ? p : 0);
+            target->relaxGot(loc, {relaxed, type, offset, addend, &sym}, val);
+            return true;
+          }
+        }
+        if (!s.gotVA)
+          return fail("reference to " + name + " needs a new GOT entry");
+        val = s.gotVA + addend - p;
+        break;
+      case R_GOT:
+        if (!s.gotVA)
+          return fail("reference to " + name + " needs a new GOT entry");
+        val = s.gotVA + addend;
+        break;
+      case R_AARCH64_GOT_PAGE_PC:
+        if (!s.gotVA)
+          return fail("reference to " + name + " needs a new GOT entry");
+        val = getAArch64Page(s.gotVA + addend) - getAArch64Page(p);
+        break;
+      default:
+        return fail("unsupported relocation " + toString(type) + " against " +
+                    name);
+      }
+      target->relocate(loc, {expr, type, offset, addend, &sym}, val);
+      return true;
+    };
+
+    const Elf_Shdr *relSec = relSecs[i];
+    if (!relSec)
+      continue;
+    if (relSec->sh_type == SHT_RELA) {
+      for (const typename ELFT::Rela &rel : CHECK(obj.relas(*relSec), &file))
+        if (!relocate(rel.r_offset, rel.getType(config->isMips64EL),
+                      rel.getSymbol(config->isMips64EL), rel.r_addend, false))
+          return false;
+    } else {
+      for (const typename ELFT::Rel &rel : CHECK(obj.rels(*relSec), &file))
+        if (!relocate(rel.r_offset, rel.getType(config->isMips64EL),
+                      rel.getSymbol(config->isMips64EL), 0, true))
+          return false;
+    }
+  }
+  return true;
+}
+
+// Rewrites the state file with new timestamps of the output and the changed
+// input files. Patching does not change anything else in it.
+static void updateState(StringRef path, StringRef data,
+                        const StringSet<> &changed) {
+  std::string tmpPath = path.str() + ".tmp";
+  std::error_code ec;
+  {
+    raw_fd_ostream os(tmpPath, ec, sys::fs::OF_None);
+    if (ec) {
+      warn("cannot open " + tmpPath + ": " + ec.message());
+      sys::fs::remove(path);
+      return;
+    }
+    while (!data.empty()) {
+      StringRef line;
+      std::tie(line, data) = data.split('\n');
+      if (line.startswith("output\t")) {
+        FileStamp st = getStamp(config->outputFile);
+        os << "output\t" << st.size << '\t' << st.mtime << '\n';
+        continue;
+      }
+      if (line.startswith("input\t")) {
+        StringRef inputPath = line.split('\t').second.split('\t').second.split(
+            '\t').second;
+        if (changed.count(inputPath)) {
+          FileStamp st = getStamp(inputPath);
+          os << "input\t" << st.size << '\t' << st.mtime << '\t' << inputPath
+             << '\n';
+          continue;
+        }
+      }
+      os << line << '\n';
+    }
+  }
+  if ((ec = sys::fs::rename(tmpPath, path))) {
+    warn("cannot rename " + tmpPath + ": " + ec.message());
+    sys::fs::remove(path);
+  }
+}
+
+template <class ELFT>
+bool elf::tryIncrementalLink(opt::InputArgList &args,
+                             ArrayRef<InputFile *> files) {
+  llvm::TimeTraceScope timeScope("Incremental link");
+  argsHash = hashArgs(args);
+
+  // Do not even pad sections if we could not patch the output.
+  if (!isPatchable()) {
+    log("--incremental: the output cannot be patched with these options");
+    config->incremental = false;
+    return false;
+  }
+
+  std::string path = getStatePath();
+  ErrorOr<std::unique_ptr<MemoryBuffer>> mbOrErr =
+      MemoryBuffer::getFile(path, /*IsText=*/false,
+                            /*RequiresNullTerminator=*/false);
+  if (!mbOrErr)
+    return false;
+
+  auto fail = [](const Twine &msg) {
+    log("--incremental: " + msg + "; doing a full link");
+    return false;
+  };
+
+  IncrementalState state;
+  StringRef data = (*mbOrErr)->getBuffer();
+  if (!state.parse(data))
+    return fail(path + " is invalid");
+  if (state.argsHash != argsHash)
+    return fail("the command line changed");
+  if (!(getStamp(config->outputFile) == state.output))
+    return fail(config->outputFile + " has been modified");
+
+  // Find the input files that have changed.
+  if (state.inputs.size() != config->dependencyFiles.size())
+    return fail("the set of input files changed");
+  StringSet<> changed;
+  for (size_t i = 0, e = state.inputs.size(); i != e; ++i) {
+    StringRef input = config->dependencyFiles[i].val();
+    if (state.inputs[i].first != input)
+      return fail("the set of input files changed");
+    if (!(getStamp(input) == state.inputs[i].second))
+      changed.insert(input);
+  }
+  if (changed.empty()) {
+    log("--incremental: " + config->outputFile + " is up to date");
+    return true;
+  }
+
+  StringMap<ObjFile<ELFT> *> objFiles;
+  for (InputFile *f : files)
+    if (auto *obj = dyn_cast<ObjFile<ELFT>>(f))
+      if (obj->archiveName.empty() && !obj->lazy)
+        objFiles.try_emplace(obj->getName(), obj);
+
+  std::vector<Patch> patches;
+  std::string reason;
+  size_t numPatchedFiles = 0;
+  for (const ObjectState &obj : state.objects) {
+    if (!changed.count(obj.path))
+      continue;
+    ObjFile<ELFT> *file = objFiles.lookup(obj.path);
+    if (!file)
+      return fail(obj.path + " is no longer a plain object file");
+    if (!planPatches(*file, obj, state, patches, reason))
+      return fail(reason);
+    ++numPatchedFiles;
+  }
+  if (numPatchedFiles != changed.size())
+    return fail("an input file other than an object file changed");
+
+  // A relocation overflowed. The error has been reported.
+  if (errorCount())
+    return true;
+
+  {
+    llvm::TimeTraceScope timeScope("Patch output file");
+    Expected<sys::fs::file_t> fdOrErr = sys::fs::openNativeFileForReadWrite(
+        config->outputFile, sys::fs::CD_OpenExisting, sys::fs::OF_None);
+    if (!fdOrErr) {
+      consumeError(fdOrErr.takeError());
+      return fail("cannot open " + config->outputFile);
+    }
+    sys::fs::file_t fd = *fdOrErr;
+    std::error_code ec;
+    sys::fs::mapped_file_region map(fd, sys::fs::mapped_file_region::readwrite,
+                                    state.output.size, 0, ec);
+    if (ec) {
+      sys::fs::closeFile(fd);
+      return fail("cannot map " + config->outputFile + ": " + ec.message());
+    }
+
+    uint8_t *buf = reinterpret_cast<uint8_t *>(map.data());
+    parallelForEach(patches, [&](const Patch &p) {
+      memcpy(buf + p.fileOff, p.data.data(), p.data.size());
+    });
+
+    if (!state.buildIds.empty()) {
+      for (std::pair<uint64_t, uint64_t> id : state.buildIds)
+        memset(buf + id.first, 0, id.second);
+      std::vector<uint8_t> buildId(state.buildIds[0].second);
+      computeBuildId(buildId, {buf, size_t(state.output.size)});
+      for (std::pair<uint64_t, uint64_t> id : state.buildIds)
+        memcpy(buf + id.first, buildId.data(), buildId.size());
+    }
+
+    map.unmap();
+    sys::fs::closeFile(fd);
+  }
+
+  log("--incremental: patched " + Twine(numPatchedFiles) + " file(s) into " +
+      config->outputFile);
+  updateState(path, data, changed);
+  return true;
+}
+
+template bool elf::tryIncrementalLink<ELF32LE>(opt::InputArgList &,
+                                               ArrayRef<InputFile *>);
+template bool elf::tryIncrementalLink<ELF32BE>(opt::InputArgList &,
+                                               ArrayRef<InputFile *>);
+template bool elf::tryIncrementalLink<ELF64LE>(opt::InputArgList &,
+                                               ArrayRef<InputFile *>);
+template bool elf::tryIncrementalLink<ELF64BE>(opt::InputArgList &,
+                                               ArrayRef<InputFile *>);
+
+template void elf::writeIncrementalState<ELF32LE>();
+template void elf::writeIncrementalState<ELF32BE>();
+template void elf::writeIncrementalState<ELF64LE>();
+template void elf::writeIncrementalState<ELF64BE>();
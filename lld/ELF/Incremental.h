@@ -0,0 +1,43 @@
+//===- Incremental.h --------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLD_ELF_INCREMENTAL_H
+#define LLD_ELF_INCREMENTAL_H
+
+#include "lld/Common/LLVM.h"
+#include <cstdint>
+
+namespace llvm {
+namespace opt {
+class InputArgList;
+}
+} // namespace llvm
+
+namespace lld {
+namespace elf {
+class InputFile;
+class InputSection;
+
+// Returns the number of bytes reserved after an input section for
+// --incremental, or 0 if the section cannot be patched in place.
+uint64_t getIncrementalPadding(const InputSection *sec);
+
+// Tries to update the output of the previous --incremental link in place.
+// Returns true if the output is up to date (or an error was reported), and
+// false if a full link is needed.
+template <class ELFT>
+bool tryIncrementalLink(llvm::opt::InputArgList &args,
+                        ArrayRef<InputFile *> files);
+
+// Saves the state of a full link for the next --incremental link.
+template <class ELFT> void writeIncrementalState();
+
+} // namespace elf
+} // namespace lld
+
+#endif
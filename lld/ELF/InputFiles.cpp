@@ -442,6 +442,11 @@ bool ObjFile<ELFT>::shouldMerge(const Elf_Shdr &sec, StringRef name) {
   if (config->optimize == 0 && !config->relocatable)
     return false;
 
+  // With --incremental, allocated mergeable sections are kept as regular input
+  // sections so that each of them gets its own patchable slot in the output.
+  if (config->incremental && (sec.sh_flags & SHF_ALLOC))
+    return false;
+
   // A mergeable section with size 0 is useless because they don't have
   // any data to merge. A mergeable string section with size 0 can be
   // argued as invalid because it doesn't end with a null character.
@@ -680,7 +685,7 @@ void ObjFile<ELFT>::initializeSections(bool ignoreComdats) {
             *this, sec, check(obj.getSectionName(sec, shstrtab)));
         // If the relocated section is discarded (due to /DISCARD/ or
         // --gc-sections), the relocation section should be discarded as well.
-        s->dependentSections.push_back(isec);
+        s->addDependentSection(isec);
         sections[i] = isec;
       }
       continue;
@@ -700,7 +705,7 @@ void ObjFile<ELFT>::initializeSections(bool ignoreComdats) {
     // A SHF_LINK_ORDER section is discarded if its linked-to section is
     // discarded.
     InputSection *isec = cast<InputSection>(this->sections[i]);
-    linkSec->dependentSections.push_back(isec);
+    linkSec->addDependentSection(isec);
     if (!isa<InputSection>(linkSec))
       error("a section " + isec->name +
             " with SHF_LINK_ORDER should not refer a non-regular section: " +
@@ -26,7 +26,6 @@
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/xxhash.h"
 #include <algorithm>
-#include <mutex>
 #include <set>
 #include <unordered_set>
 #include <vector>
@@ -42,6 +41,9 @@ using namespace lld::elf;
 
 SmallVector<InputSectionBase *, 0> elf::inputSections;
 DenseSet<std::pair<const Symbol *, uint64_t>> elf::ppc64noTocRelax;
+DenseMap<const InputSectionBase *, TinyPtrVector<InputSection *>>
+    elf::dependentSectionMap;
+DenseMap<const InputSectionBase *, JumpInstrMod> elf::jumpInstrMods;
 
 // Returns a string to construct an error message.
 std::string lld::toString(const InputSectionBase *sec) {
@@ -77,14 +79,11 @@ InputSectionBase::InputSectionBase(InputFile *file, uint64_t flags,
     fatal(toString(this) + ": sh_addralign is not a power of 2");
   this->alignment = v;
 
-  // In ELF, each section can be compressed by zlib, and if compressed,
-  // section name may be mangled by appending "z" (e.g. ".zdebug_info").
-  // If that's the case, demangle section name so that we can handle a
-  // section as if it weren't compressed.
+  // In ELF, each section can be compressed by zlib or zstd, and if
+  // compressed by zlib, section name may be mangled by appending "z" (e.g.
+  // ".zdebug_info"). If that's the case, demangle section name so that we can
+  // handle a section as if it weren't compressed.
   if ((flags & SHF_COMPRESSED) || name.startswith(".zdebug")) {
-    if (!zlib::isAvailable())
-      error(toString(file) + ": contains a compressed section, " +
-            "but zlib is not available");
     switch (config->ekind) {
     case ELF32LEKind:
       parseCompressedHeader<ELF32LE>();
@@ -137,16 +136,17 @@ size_t InputSectionBase::getSize() const {
   return rawData.size() - bytesDropped;
 }
 
+Error InputSectionBase::uncompressTo(char *buf, size_t &size) const {
+  if (compressedWithZstd)
+    return zstd::uncompress(toStringRef(rawData), buf, size);
+  return zlib::uncompress(toStringRef(rawData), buf, size);
+}
+
 void InputSectionBase::uncompress() const {
   size_t size = uncompressedSize;
-  char *uncompressedBuf;
-  {
-    static std::mutex mu;
-    std::lock_guard<std::mutex> lock(mu);
-    uncompressedBuf = bAlloc.Allocate<char>(size);
-  }
+  char *uncompressedBuf = cbAlloc.Allocate<char>(size);
 
-  if (Error e = zlib::uncompress(toStringRef(rawData), uncompressedBuf, size))
+  if (Error e = uncompressTo(uncompressedBuf, size))
     fatal(toString(this) +
           ": uncompress failed: " + llvm::toString(std::move(e)));
   rawData = makeArrayRef((uint8_t *)uncompressedBuf, size);
@@ -215,12 +215,17 @@ OutputSection *SectionBase::getOutputSection() {
 }
 
 // When a section is compressed, `rawData` consists with a header followed
-// by zlib-compressed data. This function parses a header to initialize
-// `uncompressedSize` member and remove the header from `rawData`.
+// by zlib- or zstd-compressed data. This function parses a header to
+// initialize `uncompressedSize` member and remove the header from `rawData`.
 template <typename ELFT> void InputSectionBase::parseCompressedHeader() {
   // Old-style header
   if (!(flags & SHF_COMPRESSED)) {
     assert(name.startswith(".zdebug"));
+    if (!zlib::isAvailable()) {
+      error(toString(file) + ": contains a compressed section, " +
+            "but zlib is not available");
+      return;
+    }
     if (!toStringRef(rawData).startswith("ZLIB")) {
       error(toString(this) + ": corrupted compressed section header");
       return;
@@ -250,7 +255,20 @@ template <typename ELFT> void InputSectionBase::parseCompressedHeader() {
   }
 
   auto *hdr = reinterpret_cast<const typename ELFT::Chdr *>(rawData.data());
-  if (hdr->ch_type != ELFCOMPRESS_ZLIB) {
+  if (hdr->ch_type == ELFCOMPRESS_ZLIB) {
+    if (!zlib::isAvailable()) {
+      error(toString(file) + ": contains a compressed section, " +
+            "but zlib is not available");
+      return;
+    }
+  } else if (hdr->ch_type == ELFCOMPRESS_ZSTD) {
+    if (!zstd::isAvailable()) {
+      error(toString(file) + ": contains a zstd-compressed section, " +
+            "but zstd is not available");
+      return;
+    }
+    compressedWithZstd = true;
+  } else {
     error(toString(this) + ": unsupported compression type");
     return;
   }
@@ -267,6 +285,20 @@ InputSection *InputSectionBase::getLinkOrderDep() const {
   return cast<InputSection>(file->getSections()[link]);
 }
 
+ArrayRef<InputSection *> InputSectionBase::getDependentSections() const {
+  if (!hasDependentSections)
+    return {};
+  auto it = dependentSectionMap.find(this);
+  if (it == dependentSectionMap.end())
+    return {};
+  return it->second;
+}
+
+void InputSectionBase::addDependentSection(InputSection *isec) {
+  dependentSectionMap[this].push_back(isec);
+  hasDependentSections = true;
+}
+
 // Find a function symbol that encloses a given location.
 Defined *InputSectionBase::getEnclosingFunction(uint64_t offset) {
   for (Symbol *b : file->getSymbols())
@@ -1119,9 +1151,11 @@ void InputSectionBase::relocateAlloc(uint8_t *buf, uint8_t *bufEnd) {
   // a jmp insn must be modified to shrink the jmp insn or to flip the jmp
   // insn.  This is primarily used to relax and optimize jumps created with
   // basic block sections.
-  if (jumpInstrMod) {
-    target.applyJumpInstrMod(buf + jumpInstrMod->offset, jumpInstrMod->original,
-                             jumpInstrMod->size);
+  if (!jumpInstrMods.empty()) {
+    auto it = jumpInstrMods.find(this);
+    if (it != jumpInstrMods.end())
+      target.applyJumpInstrMod(buf + it->second.offset, it->second.original,
+                               it->second.size);
   }
 }
 
@@ -1252,7 +1286,7 @@ template <class ELFT> void InputSection::writeTo(uint8_t *buf) {
   // to the buffer.
   if (uncompressedSize >= 0) {
     size_t size = uncompressedSize;
-    if (Error e = zlib::uncompress(toStringRef(rawData), (char *)buf, size))
+    if (Error e = uncompressTo((char *)buf, size))
       fatal(toString(this) +
             ": uncompress failed: " + llvm::toString(std::move(e)));
     uint8_t *bufEnd = buf + size;
@@ -1276,7 +1310,7 @@ void InputSection::replace(InputSection *other) {
   // able to access it.
   if (partition != other->partition) {
     partition = 1;
-    for (InputSection *isec : dependentSections)
+    for (InputSection *isec : getDependentSections())
       isec->partition = 1;
   }
 
@@ -1390,7 +1424,7 @@ void MergeInputSection::splitStrings(ArrayRef<uint8_t> data, size_t entSize) {
       fatal(toString(this) + ": string is not null terminated");
     size_t size = end + entSize;
 
-    pieces.emplace_back(off, xxHash64(s.substr(0, size)), live);
+    pieces.emplace_back(off, xxh3_64bits(s.substr(0, size)), live);
     s = s.substr(size);
     off += size;
   }
@@ -1406,7 +1440,7 @@ void MergeInputSection::splitNonStrings(ArrayRef<uint8_t> data,
 
   pieces.assign(size / entSize, SectionPiece(0, 0, false));
   for (size_t i = 0, j = 0; i != size; i += entSize, j++)
-    pieces[j] = {i, (uint32_t)xxHash64(data.slice(i, entSize)), live};
+    pieces[j] = {i, (uint32_t)xxh3_64bits(data.slice(i, entSize)), live};
 }
 
 template <class ELFT>
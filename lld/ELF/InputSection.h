@@ -54,7 +54,7 @@ public:
 
   uint8_t sectionKind : 3;
 
-  // The next two bit fields are only used by InputSectionBase, but we
+  // The next three bit fields are only used by InputSectionBase, but we
   // put them here so the struct packs better.
 
   uint8_t bss : 1;
@@ -62,6 +62,10 @@ public:
   // Set for sections that should not be folded by ICF.
   uint8_t keepUnique : 1;
 
+  // Set if the compressed contents of an input section are zstd rather than
+  // zlib data.
+  uint8_t compressedWithZstd : 1;
+
   // The 1-indexed partition that this section is assigned to by the garbage
   // collector, or 0 if this section is dead. Normally there is only one
   // partition, so this will either be 0 or 1.
@@ -96,8 +100,8 @@ protected:
                         uint32_t entsize, uint32_t alignment, uint32_t type,
                         uint32_t info, uint32_t link)
       : name(name), sectionKind(sectionKind), bss(false), keepUnique(false),
-        partition(0), alignment(alignment), flags(flags), entsize(entsize),
-        type(type), link(link), info(info) {}
+        compressedWithZstd(false), partition(0), alignment(alignment),
+        flags(flags), entsize(entsize), type(type), link(link), info(info) {}
 };
 
 // This corresponds to a section of an input file.
@@ -136,6 +140,9 @@ public:
   // deleteFallThruJmpInsn.
   bool nopFiller = false;
 
+  // Whether dependentSectionMap has an entry for this section.
+  bool hasDependentSections = false;
+
   void drop_back(unsigned num) {
     assert(bytesDropped + num < 256);
     bytesDropped += num;
@@ -171,8 +178,10 @@ public:
 
   template <class ELFT> RelsOrRelas<ELFT> relsOrRelas() const;
 
-  // InputSections that are dependent on us (reverse dependency for GC)
-  llvm::TinyPtrVector<InputSection *> dependentSections;
+  // InputSections that are dependent on us (reverse dependency for GC). Few
+  // sections have them, so they are kept in dependentSectionMap.
+  ArrayRef<InputSection *> getDependentSections() const;
+  void addDependentSection(InputSection *isec);
 
   // Returns the size of this section (even if this is a common or BSS.)
   size_t getSize() const;
@@ -202,12 +211,6 @@ public:
   // This vector contains such "cooked" relocations.
   SmallVector<Relocation, 0> relocations;
 
-  // These are modifiers to jump instructions that are necessary when basic
-  // block sections are enabled.  Basic block sections creates opportunities to
-  // relax jump instructions at basic block boundaries after reordering the
-  // basic blocks.
-  JumpInstrMod *jumpInstrMod = nullptr;
-
   // A function compiled with -fsplit-stack calling a function
   // compiled without -fsplit-stack needs its prologue adjusted. Find
   // such functions and adjust their prologues.  This is very similar
@@ -226,6 +229,7 @@ public:
 protected:
   template <typename ELFT>
   void parseCompressedHeader();
+  Error uncompressTo(char *buf, size_t &size) const;
   void uncompress() const;
 
   mutable ArrayRef<uint8_t> rawData;
@@ -379,7 +383,7 @@ private:
   template <class ELFT> void copyShtGroup(uint8_t *buf);
 };
 
-static_assert(sizeof(InputSection) <= 160, "InputSection is too big");
+static_assert(sizeof(InputSection) <= 144, "InputSection is too big");
 
 inline bool isDebugSection(const InputSectionBase &sec) {
   return (sec.flags & llvm::ELF::SHF_ALLOC) == 0 &&
@@ -389,6 +393,23 @@ inline bool isDebugSection(const InputSectionBase &sec) {
 // The list of all input sections.
 extern SmallVector<InputSectionBase *, 0> inputSections;
 
+// Members of InputSectionBase that only a few sections have are stored in
+// these side tables, which keeps InputSectionBase small for links with
+// millions of sections.
+//
+// dependentSectionMap maps a section to the sections that are dependent on
+// it, i.e. SHF_LINK_ORDER sections and relocation sections for -r or
+// --emit-relocs.
+//
+// jumpInstrMods maps a section to a modifier of a jump instruction. They are
+// necessary when basic block sections are enabled. Basic block sections
+// creates opportunities to relax jump instructions at basic block boundaries
+// after reordering the basic blocks.
+extern llvm::DenseMap<const InputSectionBase *,
+                      llvm::TinyPtrVector<InputSection *>>
+    dependentSectionMap;
+extern llvm::DenseMap<const InputSectionBase *, JumpInstrMod> jumpInstrMods;
+
 // The set of TOC entries (.toc + addend) for which we should not apply
 // toc-indirect to toc-relative relaxation. const Symbol * refers to the
 // STT_SECTION symbol associated to the .toc input section.
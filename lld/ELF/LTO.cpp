@@ -134,6 +134,7 @@ static lto::Config createConfig() {
 
   c.PTO.LoopVectorization = c.OptLevel > 1;
   c.PTO.SLPVectorization = c.OptLevel > 1;
+  c.PTO.FunctionCacheDir = std::string(config->thinLTOFunctionCacheDir);
 
   // Set up a custom pipeline if we've been asked to.
   c.OptPipeline = std::string(config->ltoNewPmPasses);
@@ -350,6 +351,8 @@ std::vector<InputFile *> BitcodeCompiler::compile() {
 
   if (!config->thinLTOCacheDir.empty())
     pruneCache(config->thinLTOCacheDir, config->thinLTOCachePolicy);
+  if (!config->thinLTOFunctionCacheDir.empty())
+    pruneCache(config->thinLTOFunctionCacheDir, config->thinLTOCachePolicy);
 
   if (!config->ltoObjPath.empty()) {
     saveBuffer(buf[0], config->ltoObjPath);
@@ -12,6 +12,7 @@
 
 #include "LinkerScript.h"
 #include "Config.h"
+#include "Incremental.h"
 #include "InputSection.h"
 #include "OutputSections.h"
 #include "SymbolTable.h"
@@ -566,7 +567,7 @@ void LinkerScript::discard(InputSectionBase &s) {
 
   s.markDead();
   s.parent = nullptr;
-  for (InputSection *sec : s.dependentSections)
+  for (InputSection *sec : s.getDependentSections())
     discard(*sec);
 }
 
@@ -859,7 +860,7 @@ void LinkerScript::addOrphanSections() {
           add(relIS);
     add(isec);
     if (config->relocatable)
-      for (InputSectionBase *depSec : isec->dependentSections)
+      for (InputSectionBase *depSec : isec->getDependentSections())
         if (depSec->flags & SHF_LINK_ORDER)
           add(depSec);
   }
@@ -1049,6 +1050,8 @@ void LinkerScript::assignOffsets(OutputSection *sec) {
       dot = alignTo(dot, isec->alignment);
       isec->outSecOff = dot - sec->addr;
       dot += isec->getSize();
+      if (config->incremental)
+        dot += getIncrementalPadding(isec);
 
       // Update output section size after adding each section. This is so that
       // SIZEOF works correctly in the case below:
@@ -294,7 +294,7 @@ template <class ELFT> void MarkLive<ELFT>::run() {
       bool isRel = sec->type == SHT_REL || sec->type == SHT_RELA;
       if (!isRel && !sec->nextInSectionGroup) {
         sec->markLive();
-        for (InputSection *isec : sec->dependentSections)
+        for (InputSection *isec : sec->getDependentSections())
           isec->markLive();
       }
     }
@@ -327,7 +327,7 @@ template <class ELFT> void MarkLive<ELFT>::mark() {
     for (const typename ELFT::Rela &rel : rels.relas)
       resolveReloc(sec, rel, false);
 
-    for (InputSectionBase *isec : sec.dependentSections)
+    for (InputSectionBase *isec : sec.getDependentSections())
       enqueue(isec, 0);
 
     // Mark the next group member.
@@ -12,9 +12,12 @@
 #include "SymbolTable.h"
 #include "SyntheticSections.h"
 #include "Target.h"
+#include "Writer.h"
+#include "lld/Common/Arrays.h"
 #include "lld/Common/Memory.h"
 #include "lld/Common/Strings.h"
 #include "llvm/BinaryFormat/Dwarf.h"
+#include "llvm/Config/config.h" // LLVM_ENABLE_ZLIB
 #include "llvm/Support/Compression.h"
 #include "llvm/Support/MD5.h"
 #include "llvm/Support/MathExtras.h"
@@ -24,6 +27,10 @@
 #include <regex>
 #include <unordered_set>
 
+#if LLVM_ENABLE_ZLIB
+#include <zlib.h>
+#endif
+
 using namespace llvm;
 using namespace llvm::dwarf;
 using namespace llvm::object;
@@ -284,38 +291,119 @@ static void fill(uint8_t *buf, size_t size,
   memcpy(buf + i, filler.data(), size - i);
 }
 
+#if LLVM_ENABLE_ZLIB
+static SmallVector<char, 0> deflateShard(ArrayRef<uint8_t> in, int level,
+                                         int flush) {
+  // 15 and 8 are default. windowBits=-15 is negative to generate raw deflate
+  // data with no zlib header or trailer.
+  z_stream s = {};
+  deflateInit2(&s, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY);
+  s.next_in = const_cast<uint8_t *>(in.data());
+  s.avail_in = in.size();
+
+  // Allocate a buffer of half of the input size, and grow it by 1.5x if
+  // insufficient.
+  SmallVector<char, 0> out;
+  size_t pos = 0;
+  out.resize(std::max<size_t>(in.size() / 2, 64));
+  do {
+    if (pos == out.size())
+      out.resize(out.size() * 3 / 2);
+    s.next_out = reinterpret_cast<Bytef *>(out.data()) + pos;
+    s.avail_out = out.size() - pos;
+    (void)deflate(&s, flush);
+    pos = reinterpret_cast<char *>(s.next_out) - out.data();
+  } while (s.avail_out == 0);
+  assert(s.avail_in == 0);
+
+  out.truncate(pos);
+  deflateEnd(&s);
+  return out;
+}
+#endif
+
 // Compress section contents if this section contains debug info.
 template <class ELFT> void OutputSection::maybeCompress() {
   using Elf_Chdr = typename ELFT::Chdr;
 
   // Compress only DWARF debug sections.
-  if (!config->compressDebugSections || (flags & SHF_ALLOC) ||
-      !name.startswith(".debug_"))
+  if (config->compressDebugSections == DebugCompressionKind::None ||
+      (flags & SHF_ALLOC) || !name.startswith(".debug_"))
     return;
 
   llvm::TimeTraceScope timeScope("Compress debug sections");
 
-  // Create a section header.
-  zDebugHeader.resize(sizeof(Elf_Chdr));
-  auto *hdr = reinterpret_cast<Elf_Chdr *>(zDebugHeader.data());
-  hdr->ch_type = ELFCOMPRESS_ZLIB;
-  hdr->ch_size = size;
-  hdr->ch_addralign = alignment;
-
-  // Write section contents to a temporary buffer and compress it.
-  std::vector<uint8_t> buf(size);
-  writeTo<ELFT>(buf.data());
-  // We chose 1 as the default compression level because it is the fastest. If
-  // -O2 is given, we use level 6 to compress debug info more by ~15%. We found
-  // that level 7 to 9 doesn't make much difference (~1% more compression) while
-  // they take significant amount of time (~2x), so level 6 seems enough.
-  if (Error e = zlib::compress(toStringRef(buf), compressedData,
-                               config->optimize >= 2 ? 6 : 1))
-    fatal("compress failed: " + llvm::toString(std::move(e)));
-
-  // Update section headers.
-  size = sizeof(Elf_Chdr) + compressedData.size();
+  // Write uncompressed data to a temporary zero-initialized buffer.
+  auto buf = std::make_unique<uint8_t[]>(size);
+  writeTo<ELFT>(buf.get());
+
+  // Split input into 1-MiB shards.
+  constexpr size_t shardSize = 1 << 20;
+  std::vector<ArrayRef<uint8_t>> shardsIn =
+      split(makeArrayRef<uint8_t>(buf.get(), size), shardSize);
+  if (shardsIn.empty())
+    shardsIn.emplace_back();
+  const size_t numShards = shardsIn.size();
+  auto shardsOut = std::make_unique<SmallVector<char, 0>[]>(numShards);
+
+  // Compress each shard as an independent zstd frame. A sequence of frames is
+  // itself a valid zstd stream, so the shards are simply concatenated. As with
+  // zlib, a higher level is used with -O2.
+  if (config->compressDebugSections == DebugCompressionKind::Zstd) {
+    const int level = config->optimize >= 2 ? zstd::DefaultCompression
+                                            : zstd::BestSpeedCompression;
+    parallelForEachN(0, numShards, [&](size_t i) {
+      if (Error e = zstd::compress(toStringRef(shardsIn[i]), shardsOut[i],
+                                   level))
+        fatal(name + ": compress failed: " + llvm::toString(std::move(e)));
+    });
+
+    compressed.uncompressedSize = size;
+    compressed.zstd = true;
+    size = sizeof(Elf_Chdr);
+    for (size_t i = 0; i != numShards; ++i)
+      size += shardsOut[i].size();
+    compressed.shards = std::move(shardsOut);
+    compressed.numShards = numShards;
+    flags |= SHF_COMPRESSED;
+    return;
+  }
+
+#if LLVM_ENABLE_ZLIB
+  // We chose 1 (Z_BEST_SPEED) as the default compression level because it is
+  // the fastest. If -O2 is given, we use level 6 to compress debug info more by
+  // ~15%. We found that level 7 to 9 doesn't make much difference (~1% more
+  // compression) while they take significant amount of time (~2x), so level 6
+  // seems enough.
+  const int level = config->optimize >= 2 ? 6 : Z_BEST_SPEED;
+
+  // Compress shards and compute Adler-32 checksums. Use Z_SYNC_FLUSH for all
+  // shards but the last to flush the output to a byte boundary to be
+  // concatenated with the next shard. Each shard starts with an empty
+  // dictionary, so the shards are independent and the concatenation is still a
+  // single valid deflate stream.
+  auto shardsAdler = std::make_unique<uint32_t[]>(numShards);
+  parallelForEachN(0, numShards, [&](size_t i) {
+    shardsOut[i] = deflateShard(shardsIn[i], level,
+                                i != numShards - 1 ? Z_SYNC_FLUSH : Z_FINISH);
+    shardsAdler[i] = adler32(1, shardsIn[i].data(), shardsIn[i].size());
+  });
+
+  // Update section size and combine Adler-32 checksums.
+  uint32_t checksum = 1;       // Initial Adler-32 value
+  compressed.uncompressedSize = size;
+  size = sizeof(Elf_Chdr) + 2; // Elf_Chdr and zlib header
+  for (size_t i = 0; i != numShards; ++i) {
+    size += shardsOut[i].size();
+    checksum = adler32_combine(checksum, shardsAdler[i], shardsIn[i].size());
+  }
+  size += 4; // checksum
+
+  compressed.shards = std::move(shardsOut);
+  compressed.numShards = numShards;
+  compressed.checksum = checksum;
   flags |= SHF_COMPRESSED;
+#endif
 }
 
 static void writeInt(uint8_t *buf, uint64_t data, uint64_t size) {
@@ -339,10 +427,30 @@ template <class ELFT> void OutputSection::writeTo(uint8_t *buf) {
   // If --compress-debug-section is specified and if this is a debug section,
   // we've already compressed section contents. If that's the case,
   // just write it down.
-  if (!compressedData.empty()) {
-    memcpy(buf, zDebugHeader.data(), zDebugHeader.size());
-    memcpy(buf + zDebugHeader.size(), compressedData.data(),
-           compressedData.size());
+  if (compressed.shards) {
+    auto *chdr = reinterpret_cast<typename ELFT::Chdr *>(buf);
+    chdr->ch_type = compressed.zstd ? ELFCOMPRESS_ZSTD : ELFCOMPRESS_ZLIB;
+    chdr->ch_size = compressed.uncompressedSize;
+    chdr->ch_addralign = alignment;
+    buf += sizeof(*chdr);
+
+    // Compute shard offsets. zstd frames need no header or trailer.
+    auto offsets = std::make_unique<size_t[]>(compressed.numShards);
+    offsets[0] = compressed.zstd ? 0 : 2; // zlib header
+    for (size_t i = 1; i != compressed.numShards; ++i)
+      offsets[i] = offsets[i - 1] + compressed.shards[i - 1].size();
+
+    if (!compressed.zstd) {
+      buf[0] = 0x78; // CMF
+      buf[1] = 0x01; // FLG: best speed
+    }
+    parallelForEachN(0, compressed.numShards, [&](size_t i) {
+      memcpy(buf + offsets[i], compressed.shards[i].data(),
+             compressed.shards[i].size());
+    });
+
+    if (!compressed.zstd)
+      write32be(buf + (size - sizeof(*chdr) - 4), compressed.checksum);
     return;
   }
 
@@ -353,7 +461,7 @@ template <class ELFT> void OutputSection::writeTo(uint8_t *buf) {
   if (nonZeroFiller)
     fill(buf, sections.empty() ? size : sections[0]->outSecOff, filler);
 
-  parallelForEachN(0, sections.size(), [&](size_t i) {
+  auto writeOne = [&](size_t i) {
     InputSection *isec = sections[i];
     isec->writeTo<ELFT>(buf + isec->outSecOff);
 
@@ -371,7 +479,27 @@ template <class ELFT> void OutputSection::writeTo(uint8_t *buf) {
       } else
         fill(start, end - start, filler);
     }
-  });
+  };
+
+  // With --stream-output, write input sections in batches of roughly
+  // streamBatchSize bytes and release each batch before starting the next
+  // one, so that at most one batch of this section is resident at a time.
+  // Sections compressed or written to a temporary buffer are written at once.
+  if (!config->streamOutput || buf != Out::bufferStart + offset) {
+    parallelForEachN(0, sections.size(), writeOne);
+  } else {
+    const uint64_t streamBatchSize = 64 << 20;
+    for (size_t begin = 0, end; begin != sections.size(); begin = end) {
+      uint64_t batchOff = begin ? sections[begin]->outSecOff : 0;
+      for (end = begin + 1; end != sections.size(); ++end)
+        if (sections[end]->outSecOff - batchOff >= streamBatchSize)
+          break;
+      parallelForEachN(begin, end, writeOne);
+      uint64_t batchEnd =
+          end == sections.size() ? size : sections[end]->outSecOff;
+      releaseOutputPages(offset + batchOff, batchEnd - batchOff);
+    }
+  }
 
   // Linker scripts may have BYTE()-family commands with which you
   // can write arbitrary bytes to the output. Process them if any.
@@ -110,12 +110,19 @@ public:
   void sortInitFini();
   void sortCtorsDtors();
 
-private:
-  // Used for implementation of --compress-debug-sections option.
-  SmallVector<uint8_t, 0> zDebugHeader;
-  SmallVector<char, 0> compressedData;
-
   std::array<uint8_t, 4> getFiller();
+
+private:
+  // Used for implementation of --compress-debug-sections option. The section
+  // contents are compressed as independent shards that together form a single
+  // zlib or zstd stream; see maybeCompress().
+  struct {
+    std::unique_ptr<SmallVector<char, 0>[]> shards;
+    size_t numShards = 0;
+    uint32_t checksum = 0;
+    uint64_t uncompressedSize;
+    bool zstd = false;
+  } compressed;
 };
 
 int getPriority(StringRef s);
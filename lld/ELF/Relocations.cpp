@@ -55,6 +55,7 @@
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/Demangle/Demangle.h"
 #include "llvm/Support/Endian.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 
@@ -307,7 +308,8 @@ static void replaceWithDefined(Symbol &sym, SectionBase &sec, uint64_t value,
   sym.exportDynamic = true;
   sym.isUsedInRegularObj = true;
   // A copy relocated alias may need a GOT entry.
-  sym.needsGot = old.needsGot;
+  if (old.hasFlag(NEEDS_GOT))
+    sym.setFlags(NEEDS_GOT);
 }
 
 // Reserve space in .bss or .bss.rel.ro for copy relocation.
@@ -585,7 +587,8 @@ struct UndefinedDiag {
   bool isWarning;
 };
 
-static std::vector<UndefinedDiag> undefs;
+// Undefined symbol diagnostics, one vector per relocation scan shard.
+static SmallVector<std::vector<UndefinedDiag>, 0> undefs;
 
 // Check whether the definition name def is a mangled function name that matches
 // the reference name ref.
@@ -789,10 +792,18 @@ static void reportUndefinedSymbol(const UndefinedDiag &undef,
 }
 
 template <class ELFT> void elf::reportUndefinedSymbols() {
+  // Concatenate the shards in order so that diagnostics are reported in the
+  // order a serial scan would have found them.
+  std::vector<UndefinedDiag> diags;
+  for (std::vector<UndefinedDiag> &v : undefs)
+    diags.insert(diags.end(), std::make_move_iterator(v.begin()),
+                 std::make_move_iterator(v.end()));
+  undefs.clear();
+
   // Find the first "undefined symbol" diagnostic for each diagnostic, and
   // collect all "referenced from" lines at the first diagnostic.
   DenseMap<Symbol *, UndefinedDiag *> firstRef;
-  for (UndefinedDiag &undef : undefs) {
+  for (UndefinedDiag &undef : diags) {
     assert(undef.locs.size() == 1);
     if (UndefinedDiag *canon = firstRef.lookup(undef.sym)) {
       canon->locs.push_back(undef.locs[0]);
@@ -802,10 +813,9 @@ template <class ELFT> void elf::reportUndefinedSymbols() {
   }
 
   // Enable spell corrector for the first 2 diagnostics.
-  for (auto it : enumerate(undefs))
+  for (auto it : enumerate(diags))
     if (!it.value().locs.empty())
       reportUndefinedSymbol<ELFT>(it.value(), it.index() < 2);
-  undefs.clear();
 }
 
 // Report an undefined symbol if necessary.
@@ -815,7 +825,7 @@ static bool maybeReportUndefined(Undefined &sym, InputSectionBase &sec,
   // If versioned, issue an error (even if the symbol is weak) because we don't
   // know the defining filename which is required to construct a Verneed entry.
   if (sym.hasVersionSuffix) {
-    undefs.push_back({&sym, {{&sec, offset}}, false});
+    undefs[relocScanShard].push_back({&sym, {{&sec, offset}}, false});
     return true;
   }
   if (sym.isWeak())
@@ -840,7 +850,7 @@ static bool maybeReportUndefined(Undefined &sym, InputSectionBase &sec,
   bool isWarning =
       (config->unresolvedSymbols == UnresolvedPolicy::Warn && canBeExternal) ||
       config->noinhibitExec;
-  undefs.push_back({&sym, {{&sec, offset}}, isWarning});
+  undefs[relocScanShard].push_back({&sym, {{&sec, offset}}, isWarning});
   return !isWarning;
 }
 
@@ -860,6 +870,9 @@ RelType RelocationScanner::getMipsN32RelType(RelTy *&rel) const {
   return type;
 }
 
+// If shard is true, the relocation is buffered for the relocation scan shard of
+// the calling thread. See RelocationBaseSection::addReloc().
+template <bool shard = false>
 static void addRelativeReloc(InputSectionBase &isec, uint64_t offsetInSec,
                              Symbol &sym, int64_t addend, RelExpr expr,
                              RelType type) {
@@ -873,11 +886,11 @@ static void addRelativeReloc(InputSectionBase &isec, uint64_t offsetInSec,
   // address.
   if (part.relrDyn && isec.alignment >= 2 && offsetInSec % 2 == 0) {
     isec.relocations.push_back({expr, type, offsetInSec, addend, &sym});
-    part.relrDyn->relocs.push_back({&isec, offsetInSec});
+    part.relrDyn->addRelativeReloc<shard>(isec, offsetInSec);
     return;
   }
-  part.relaDyn->addRelativeReloc(target->relativeRel, isec, offsetInSec, sym,
-                                 addend, type, expr);
+  part.relaDyn->addRelativeReloc<shard>(target->relativeRel, isec, offsetInSec,
+                                        sym, addend, type, expr);
 }
 
 template <class PltSection, class GotPltSection>
@@ -1046,13 +1059,13 @@ void RelocationScanner::processAux(RelExpr expr, RelType type, uint64_t offset,
   if (canWrite) {
     RelType rel = target.getDynRel(type);
     if (expr == R_GOT || (rel == target.symbolicRel && !sym.isPreemptible)) {
-      addRelativeReloc(sec, offset, sym, addend, expr, type);
+      addRelativeReloc<true>(sec, offset, sym, addend, expr, type);
       return;
     } else if (rel != 0) {
       if (config->emachine == EM_MIPS && rel == target.symbolicRel)
         rel = target.relativeRel;
-      sec.getPartition().relaDyn->addSymbolReloc(rel, sec, offset, sym, addend,
-                                                 type);
+      sec.getPartition().relaDyn->addSymbolReloc<true>(rel, sec, offset, sym,
+                                                       addend, type);
 
       // MIPS ABI turns using of GOT and dynamic relocations inside out.
       // While regular ABI uses dynamic relocations to fill up GOT entries
@@ -1092,7 +1105,7 @@ void RelocationScanner::processAux(RelExpr expr, RelType type, uint64_t offset,
                 " against symbol '" + toString(*ss) +
                 "'; recompile with -fPIC or remove '-z nocopyreloc'" +
                 getLocation(sec, sym, offset));
-        sym.needsCopy = true;
+        sym.setFlags(NEEDS_COPY);
       }
       sec.relocations.push_back({expr, type, offset, addend, &sym});
       return;
@@ -1130,8 +1143,7 @@ void RelocationScanner::processAux(RelExpr expr, RelType type, uint64_t offset,
         errorOrWarn("symbol '" + toString(sym) +
                     "' cannot be preempted; recompile with -fPIE" +
                     getLocation(sec, sym, offset));
-      sym.needsCopy = true;
-      sym.needsPlt = true;
+      sym.setFlags(NEEDS_COPY | NEEDS_PLT);
       sec.relocations.push_back({expr, type, offset, addend, &sym});
       return;
     }
@@ -1185,7 +1197,7 @@ static unsigned handleTlsRelocation(RelType type, Symbol &sym,
             R_TLSDESC_GOTPLT>(expr) &&
       config->shared) {
     if (expr != R_TLSDESC_CALL) {
-      sym.needsTlsDesc = true;
+      sym.setFlags(NEEDS_TLSDESC);
       c.relocations.push_back({expr, type, offset, addend, &sym});
     }
     return 1;
@@ -1223,7 +1235,7 @@ static unsigned handleTlsRelocation(RelType type, Symbol &sym,
     }
     if (expr == R_TLSLD_HINT)
       return 1;
-    sym.needsTlsLd = true;
+    sym.setFlags(NEEDS_TLSLD);
     c.relocations.push_back({expr, type, offset, addend, &sym});
     return 1;
   }
@@ -1239,7 +1251,7 @@ static unsigned handleTlsRelocation(RelType type, Symbol &sym,
   // Local-Dynamic sequence where offset of tls variable relative to dynamic
   // thread pointer is stored in the got. This cannot be relaxed to Local-Exec.
   if (expr == R_TLSLD_GOT_OFF) {
-    sym.needsGotDtprel = true;
+    sym.setFlags(NEEDS_GOT_DTPREL);
     c.relocations.push_back({expr, type, offset, addend, &sym});
     return 1;
   }
@@ -1247,7 +1259,7 @@ static unsigned handleTlsRelocation(RelType type, Symbol &sym,
   if (oneof<R_AARCH64_TLSDESC_PAGE, R_TLSDESC, R_TLSDESC_CALL, R_TLSDESC_PC,
             R_TLSDESC_GOTPLT, R_TLSGD_GOT, R_TLSGD_GOTPLT, R_TLSGD_PC>(expr)) {
     if (!toExecRelax) {
-      sym.needsTlsGd = true;
+      sym.setFlags(NEEDS_TLSGD);
       c.relocations.push_back({expr, type, offset, addend, &sym});
       return 1;
     }
@@ -1255,7 +1267,7 @@ static unsigned handleTlsRelocation(RelType type, Symbol &sym,
     // Global-Dynamic relocs can be relaxed to Initial-Exec or Local-Exec
     // depending on the symbol being locally defined or not.
     if (sym.isPreemptible) {
-      sym.needsTlsGdToIe = true;
+      sym.setFlags(NEEDS_TLSGD_TO_IE);
       c.relocations.push_back(
           {target->adjustTlsExpr(type, R_RELAX_TLS_GD_TO_IE), type, offset,
            addend, &sym});
@@ -1275,10 +1287,10 @@ static unsigned handleTlsRelocation(RelType type, Symbol &sym,
       c.relocations.push_back(
           {R_RELAX_TLS_IE_TO_LE, type, offset, addend, &sym});
     } else if (expr != R_TLSIE_HINT) {
-      sym.needsTlsIe = true;
+      sym.setFlags(NEEDS_TLSIE);
       // R_GOT needs a relative relocation for PIC on i386 and Hexagon.
       if (expr == R_GOT && config->isPic && !target->usesOnlyLowPageBits(type))
-        addRelativeReloc(c, offset, sym, addend, expr, type);
+        addRelativeReloc<true>(c, offset, sym, addend, expr, type);
       else
         c.relocations.push_back({expr, type, offset, addend, &sym});
     }
@@ -1414,7 +1426,8 @@ template <class ELFT, class RelTy> void RelocationScanner::scanOne(RelTy *&i) {
   // direct relocation on through.
   if (sym.isGnuIFunc() && config->zIfuncNoplt) {
     sym.exportDynamic = true;
-    mainPart->relaDyn->addSymbolReloc(type, sec, offset, sym, addend, type);
+    mainPart->relaDyn->addSymbolReloc<true>(type, sec, offset, sym, addend,
+                                            type);
     return;
   }
 
@@ -1429,12 +1442,12 @@ template <class ELFT, class RelTy> void RelocationScanner::scanOne(RelTy *&i) {
       // ftp://www.linux-mips.org/pub/linux/mips/doc/ABI/mipsabi.pdf
       in.mipsGot->addEntry(*sec.file, sym, addend, expr);
     } else {
-      sym.needsGot = true;
+      sym.setFlags(NEEDS_GOT);
     }
   } else if (needsPlt(expr)) {
-    sym.needsPlt = true;
+    sym.setFlags(NEEDS_PLT);
   } else {
-    sym.hasDirectReloc = true;
+    sym.setFlags(HAS_DIRECT_RELOC);
   }
 
   processAux(expr, type, offset, sym, addend);
@@ -1506,7 +1519,7 @@ void RelocationScanner::scan(ArrayRef<RelTy> rels) {
                       });
 }
 
-template <class ELFT> void elf::scanRelocations(InputSectionBase &s) {
+template <class ELFT> static void scanSection(InputSectionBase &s) {
   RelocationScanner scanner(s);
   const RelsOrRelas<ELFT> rels = s.template relsOrRelas<ELFT>();
   if (rels.areRelocsRel())
@@ -1515,6 +1528,70 @@ template <class ELFT> void elf::scanRelocations(InputSectionBase &s) {
     scanner.template scan<ELFT>(rels.relas);
 }
 
+LLVM_THREAD_LOCAL unsigned elf::relocScanShard = 0;
+
+template <class ELFT> void elf::scanRelocations() {
+  // Scan all relocations. Each relocation goes through a series of tests to
+  // determine if it needs special treatment, such as creating GOT, PLT,
+  // copy relocations, etc. Note that relocations for non-alloc sections are
+  // directly processed by InputSection::relocateNonAlloc.
+  SmallVector<InputSectionBase *, 0> sections;
+  for (InputSectionBase *sec : inputSections)
+    if (sec->isLive() && isa<InputSection>(sec) && (sec->flags & SHF_ALLOC))
+      sections.push_back(sec);
+  for (Partition &part : partitions) {
+    for (EhInputSection *sec : part.ehFrame->sections)
+      sections.push_back(sec);
+    if (part.armExidx && part.armExidx->isLive())
+      for (InputSection *sec : part.armExidx->exidxSections)
+        sections.push_back(sec);
+  }
+
+  // Symbol flags and the GOT/GOTPLT markers are updated atomically, and
+  // dynamic relocations and undefined symbol diagnostics are buffered per
+  // shard. MIPS and PPC64 update more shared state (the MIPS GOT, the PPC64
+  // TOC relaxation set and per-file flags) and -z ifunc-noplt sets
+  // exportDynamic, so scan serially for them.
+  const bool serial = config->emachine == EM_MIPS ||
+                      config->emachine == EM_PPC64 || config->zIfuncNoplt;
+
+  // Use more shards than threads so that a few sections with many
+  // relocations do not leave the other threads idle.
+  size_t numShards = 1;
+  if (!serial)
+    numShards = std::max<size_t>(
+        1, std::min<size_t>(sections.size(),
+                            parallel::strategy.compute_thread_count() * 8));
+
+  for (Partition &part : partitions) {
+    part.relaDyn->initShards(numShards);
+    if (part.relrDyn)
+      part.relrDyn->initShards(numShards);
+  }
+  undefs.resize(numShards);
+
+  // Shards are contiguous ranges of sections, so merging them in shard order
+  // produces the same output as scanning all sections on one thread.
+  auto scanShard = [&](size_t shard) {
+    relocScanShard = shard;
+    size_t begin = sections.size() * shard / numShards;
+    size_t end = sections.size() * (shard + 1) / numShards;
+    for (size_t i = begin; i != end; ++i)
+      scanSection<ELFT>(*sections[i]);
+  };
+  if (numShards == 1)
+    scanShard(0);
+  else
+    parallelForEachN(0, numShards, scanShard);
+  relocScanShard = 0;
+
+  for (Partition &part : partitions) {
+    part.relaDyn->mergeRels();
+    if (part.relrDyn)
+      part.relrDyn->mergeRels();
+  }
+}
+
 static bool handleNonPreemptibleIfunc(Symbol &sym) {
   // Handle a reference to a non-preemptible ifunc. These are special in a
   // few ways:
@@ -1559,7 +1636,8 @@ static bool handleNonPreemptibleIfunc(Symbol &sym) {
   if (!sym.isGnuIFunc() || sym.isPreemptible || config->zIfuncNoplt)
     return false;
   // Skip unreferenced non-preemptible ifunc.
-  if (!(sym.needsGot || sym.needsPlt || sym.hasDirectReloc))
+  if (!sym.hasFlag(NEEDS_GOT) && !sym.hasFlag(NEEDS_PLT) &&
+      !sym.hasFlag(HAS_DIRECT_RELOC))
     return true;
 
   sym.isInIplt = true;
@@ -1575,7 +1653,7 @@ static bool handleNonPreemptibleIfunc(Symbol &sym) {
   sym.allocateAux();
   symAux.back().pltIdx = symAux[directSym->auxIdx].pltIdx;
 
-  if (sym.hasDirectReloc) {
+  if (sym.hasFlag(HAS_DIRECT_RELOC)) {
     // Change the value to the IPLT and redirect all references to it.
     auto &d = cast<Defined>(sym);
     d.section = in.iplt.get();
@@ -1585,9 +1663,9 @@ static bool handleNonPreemptibleIfunc(Symbol &sym) {
     // don't try to call the PLT as if it were an ifunc resolver.
     d.type = STT_FUNC;
 
-    if (sym.needsGot)
+    if (sym.hasFlag(NEEDS_GOT))
       addGotEntry(sym);
-  } else if (sym.needsGot) {
+  } else if (sym.hasFlag(NEEDS_GOT)) {
     // Redirect GOT accesses to point to the Igot.
     sym.gotInIgot = true;
   }
@@ -1602,24 +1680,24 @@ void elf::postScanRelocations() {
       return;
     sym.allocateAux();
 
-    if (sym.needsGot)
+    if (sym.hasFlag(NEEDS_GOT))
       addGotEntry(sym);
-    if (sym.needsPlt)
+    if (sym.hasFlag(NEEDS_PLT))
       addPltEntry(*in.plt, *in.gotPlt, *in.relaPlt, target->pltRel, sym);
-    if (sym.needsCopy) {
+    if (sym.hasFlag(NEEDS_COPY)) {
       if (sym.isObject()) {
         addCopyRelSymbol(cast<SharedSymbol>(sym));
         // needsCopy is cleared for sym and its aliases so that in later
         // iterations aliases won't cause redundant copies.
-        assert(!sym.needsCopy);
+        assert(!sym.hasFlag(NEEDS_COPY));
       } else {
-        assert(sym.isFunc() && sym.needsPlt);
+        assert(sym.isFunc() && sym.hasFlag(NEEDS_PLT));
         if (!sym.isDefined()) {
           replaceWithDefined(sym, *in.plt,
                              target->pltHeaderSize +
                                  target->pltEntrySize * sym.getPltIdx(),
                              0);
-          sym.needsCopy = true;
+          sym.setFlags(NEEDS_COPY);
           if (config->emachine == EM_PPC) {
             // PPC32 canonical PLT entries are at the beginning of .glink
             cast<Defined>(sym).value = in.plt->headerSize;
@@ -1634,13 +1712,13 @@ void elf::postScanRelocations() {
       return;
     bool isLocalInExecutable = !sym.isPreemptible && !config->shared;
 
-    if (sym.needsTlsDesc) {
+    if (sym.hasFlag(NEEDS_TLSDESC)) {
       in.got->addTlsDescEntry(sym);
       mainPart->relaDyn->addAddendOnlyRelocIfNonPreemptible(
           target->tlsDescRel, *in.got, in.got->getTlsDescOffset(sym), sym,
           target->tlsDescRel);
     }
-    if (sym.needsTlsGd) {
+    if (sym.hasFlag(NEEDS_TLSGD)) {
       in.got->addDynTlsEntry(sym);
       uint64_t off = in.got->getGlobalDynOffset(sym);
       if (isLocalInExecutable)
@@ -1661,13 +1739,13 @@ void elf::postScanRelocations() {
         in.got->relocations.push_back(
             {R_ABS, target->tlsOffsetRel, offsetOff, 0, &sym});
     }
-    if (sym.needsTlsGdToIe) {
+    if (sym.hasFlag(NEEDS_TLSGD_TO_IE)) {
       in.got->addEntry(sym);
       mainPart->relaDyn->addSymbolReloc(target->tlsGotRel, *in.got,
                                         sym.getGotOffset(), sym);
     }
 
-    if (sym.needsTlsLd && in.got->addTlsIndex()) {
+    if (sym.hasFlag(NEEDS_TLSLD) && in.got->addTlsIndex()) {
       if (isLocalInExecutable)
         in.got->relocations.push_back(
             {R_ADDEND, target->symbolicRel, in.got->getTlsIndexOff(), 1, &sym});
@@ -1675,13 +1753,13 @@ void elf::postScanRelocations() {
         mainPart->relaDyn->addReloc({target->tlsModuleIndexRel, in.got.get(),
                                      in.got->getTlsIndexOff()});
     }
-    if (sym.needsGotDtprel) {
+    if (sym.hasFlag(NEEDS_GOT_DTPREL)) {
       in.got->addEntry(sym);
       in.got->relocations.push_back(
           {R_ABS, target->tlsOffsetRel, sym.getGotOffset(), 0, &sym});
     }
 
-    if (sym.needsTlsIe && !sym.needsTlsGdToIe)
+    if (sym.hasFlag(NEEDS_TLSIE) && !sym.hasFlag(NEEDS_TLSGD_TO_IE))
       addTpOffsetGotEntry(sym);
   };
 
@@ -2216,10 +2294,10 @@ void elf::hexagonTLSSymbolUpdate(ArrayRef<OutputSection *> outputSections) {
       });
 }
 
-template void elf::scanRelocations<ELF32LE>(InputSectionBase &);
-template void elf::scanRelocations<ELF32BE>(InputSectionBase &);
-template void elf::scanRelocations<ELF64LE>(InputSectionBase &);
-template void elf::scanRelocations<ELF64BE>(InputSectionBase &);
+template void elf::scanRelocations<ELF32LE>();
+template void elf::scanRelocations<ELF32BE>();
+template void elf::scanRelocations<ELF64LE>();
+template void elf::scanRelocations<ELF64BE>();
 template void elf::reportUndefinedSymbols<ELF32LE>();
 template void elf::reportUndefinedSymbols<ELF32BE>();
 template void elf::reportUndefinedSymbols<ELF64LE>();
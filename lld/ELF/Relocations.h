@@ -11,6 +11,7 @@
 
 #include "lld/Common/LLVM.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/Compiler.h"
 #include <map>
 #include <vector>
 
@@ -122,10 +123,17 @@ struct JumpInstrMod {
   unsigned size;
 };
 
-// This function writes undefined symbol diagnostics to an internal buffer.
-// Call reportUndefinedSymbols() after calling scanRelocations() to emit
-// the diagnostics.
-template <class ELFT> void scanRelocations(InputSectionBase &);
+// The index of the shard that the current thread is scanning. Only meaningful
+// during scanRelocations().
+extern LLVM_THREAD_LOCAL unsigned relocScanShard;
+
+// Scan the relocations of all live allocatable sections. Sections are split
+// into contiguous shards that are scanned in parallel; dynamic relocations are
+// buffered per shard and merged in shard order, so the result is the same as a
+// serial scan. This function writes undefined symbol diagnostics to an internal
+// buffer. Call reportUndefinedSymbols() after calling scanRelocations() to
+// emit the diagnostics.
+template <class ELFT> void scanRelocations();
 void postScanRelocations();
 
 template <class ELFT> void reportUndefinedSymbols();
@@ -22,6 +22,7 @@
 #include "lld/Common/Memory.h"
 #include "lld/Common/Strings.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Parallel.h"
 
 using namespace llvm;
 using namespace llvm::object;
@@ -33,9 +34,12 @@ std::unique_ptr<SymbolTable> elf::symtab;
 
 void SymbolTable::wrap(Symbol *sym, Symbol *real, Symbol *wrap) {
   // Redirect __real_foo to the original foo and foo to the original __wrap_foo.
-  int &idx1 = symMap[CachedHashStringRef(sym->getName())];
-  int &idx2 = symMap[CachedHashStringRef(real->getName())];
-  int &idx3 = symMap[CachedHashStringRef(wrap->getName())];
+  CachedHashStringRef key1(sym->getName());
+  CachedHashStringRef key2(real->getName());
+  CachedHashStringRef key3(wrap->getName());
+  int &idx1 = getSymMap(key1)[key1];
+  int &idx2 = getSymMap(key2)[key2];
+  int &idx3 = getSymMap(key3)[key3];
 
   idx2 = idx1;
   idx1 = idx3;
@@ -56,20 +60,45 @@ void SymbolTable::wrap(Symbol *sym, Symbol *real, Symbol *wrap) {
   real->isUsedInRegularObj = false;
 }
 
+// Initializes a symbol created by insert() or insertGlobals(). *sym was not
+// initialized by a constructor. Fields that may get referenced when it is a
+// placeholder must be initialized here.
+static void initPlaceholder(Symbol *sym, StringRef name, bool hasAt) {
+  sym->setName(name);
+  sym->symbolKind = Symbol::PlaceholderKind;
+  sym->versionId = VER_NDX_GLOBAL;
+  sym->visibility = STV_DEFAULT;
+  sym->isUsedInRegularObj = false;
+  sym->exportDynamic = false;
+  sym->inDynamicList = false;
+  sym->canInline = true;
+  sym->referenced = false;
+  sym->traced = false;
+  sym->scriptDefined = false;
+  if (hasAt)
+    sym->hasVersionSuffix = true;
+  sym->partition = 1;
+}
+
+// <name>@@<version> means the symbol is the default version. In that case
+// <name>@@<version> will be used to resolve references to <name>.
+//
+// Since this is a hot path, the following string search code is optimized
+// for speed. StringRef::find(char) is much faster than StringRef::find(
+// StringRef).
+static StringRef getStem(StringRef name, size_t pos) {
+  if (pos != StringRef::npos && pos + 1 < name.size() && name[pos + 1] == '@')
+    return name.take_front(pos);
+  return name;
+}
+
 // Find an existing symbol or create a new one.
 Symbol *SymbolTable::insert(StringRef name) {
-  // <name>@@<version> means the symbol is the default version. In that
-  // case <name>@@<version> will be used to resolve references to <name>.
-  //
-  // Since this is a hot path, the following string search code is
-  // optimized for speed. StringRef::find(char) is much faster than
-  // StringRef::find(StringRef).
-  StringRef stem = name;
   size_t pos = name.find('@');
-  if (pos != StringRef::npos && pos + 1 < name.size() && name[pos + 1] == '@')
-    stem = name.take_front(pos);
+  StringRef stem = getStem(name, pos);
 
-  auto p = symMap.insert({CachedHashStringRef(stem), (int)symVector.size()});
+  CachedHashStringRef key(stem);
+  auto p = getSymMap(key).insert({key, (int)symVector.size()});
   if (!p.second) {
     Symbol *sym = symVector[p.first->second];
     if (stem.size() != name.size()) {
@@ -81,26 +110,153 @@ Symbol *SymbolTable::insert(StringRef name) {
 
   Symbol *sym = reinterpret_cast<Symbol *>(make<SymbolUnion>());
   symVector.push_back(sym);
-
-  // *sym was not initialized by a constructor. Fields that may get referenced
-  // when it is a placeholder must be initialized here.
-  sym->setName(name);
-  sym->symbolKind = Symbol::PlaceholderKind;
-  sym->versionId = VER_NDX_GLOBAL;
-  sym->visibility = STV_DEFAULT;
-  sym->isUsedInRegularObj = false;
-  sym->exportDynamic = false;
-  sym->inDynamicList = false;
-  sym->canInline = true;
-  sym->referenced = false;
-  sym->traced = false;
-  sym->scriptDefined = false;
-  if (pos != StringRef::npos)
-    sym->hasVersionSuffix = true;
-  sym->partition = 1;
+  initPlaceholder(sym, name, pos != StringRef::npos);
   return sym;
 }
 
+namespace {
+// A global symbol name of an object file, seen by insertGlobals().
+struct GlobalName {
+  const char *data;
+  uint32_t size;
+  uint32_t hash;
+};
+} // namespace
+
+// insertGlobals() works on batches of this many symbols to bound the memory
+// used for bookkeeping.
+static constexpr size_t insertBatchSize = 1 << 22;
+
+template <class ELFT>
+void SymbolTable::insertGlobals(ArrayRef<ObjFile<ELFT> *> files) {
+  enum : uint8_t { FIRST = 1, HAS_AT = 2, DEFAULT_VERSION = 4 };
+
+  while (!files.empty()) {
+    // Take the next batch of files. offsets[i] is the index of the first
+    // symbol of batch[i] among all symbols of the batch.
+    SmallVector<size_t, 0> offsets = {0};
+    size_t numFiles = 0;
+    do {
+      ObjFile<ELFT> *file = files[numFiles];
+      offsets.push_back(offsets.back() +
+                        file->template getGlobalELFSyms<ELFT>().size());
+    } while (++numFiles != files.size() && offsets.back() < insertBatchSize);
+    ArrayRef<ObjFile<ELFT> *> batch = files.take_front(numFiles);
+    files = files.drop_front(numFiles);
+    size_t n = offsets.back();
+
+    // Compute the hash values of the names.
+    std::vector<GlobalName> names(n);
+    std::vector<uint8_t> flags(n);
+    parallelForEachN(0, batch.size(), [&](size_t i) {
+      ObjFile<ELFT> *file = batch[i];
+      StringRef strtab = file->getStringTable();
+      size_t idx = offsets[i];
+      for (const typename ELFT::Sym &eSym :
+           file->template getGlobalELFSyms<ELFT>()) {
+        StringRef name = CHECK(eSym.getName(strtab), file);
+        size_t pos = name.find('@');
+        StringRef stem = getStem(name, pos);
+        names[idx] = {stem.data(), uint32_t(stem.size()),
+                      CachedHashStringRef(stem).hash()};
+        if (pos != StringRef::npos)
+          flags[idx] = stem.size() == name.size() ? HAS_AT
+                                                  : HAS_AT | DEFAULT_VERSION;
+        ++idx;
+      }
+    });
+
+    // Group the symbols by shard, preserving their order.
+    auto getShard = [](uint32_t hash) {
+      return hash >> (32 - symMapShardBits);
+    };
+    std::array<size_t, (1 << symMapShardBits) + 1> shardBegin = {};
+    for (const GlobalName &name : names)
+      ++shardBegin[getShard(name.hash) + 1];
+    for (size_t i = 1; i != shardBegin.size(); ++i)
+      shardBegin[i] += shardBegin[i - 1];
+    std::vector<uint32_t> order(n);
+    {
+      std::array<size_t, (1 << symMapShardBits) + 1> pos = shardBegin;
+      for (size_t i = 0; i != n; ++i)
+        order[pos[getShard(names[i].hash)]++] = i;
+    }
+
+    // Insert the names into the shards. An existing entry maps to an index
+    // into symVector. An entry added here temporarily maps to -1 minus the
+    // index of the symbol that added it. For each symbol, `firsts` holds the
+    // value of the entry after its insertion.
+    std::vector<int> firsts(n);
+    parallelForEachN(0, symMap.size(), [&](size_t shard) {
+      for (size_t j = shardBegin[shard]; j != shardBegin[shard + 1]; ++j) {
+        uint32_t i = order[j];
+        CachedHashStringRef key({names[i].data, names[i].size}, names[i].hash);
+        auto p = symMap[shard].insert({key, -1 - int(i)});
+        firsts[i] = p.first->second;
+        if (p.second)
+          flags[i] |= FIRST;
+      }
+    });
+
+    // Assign symVector indices to new symbols in the same order as insert().
+    size_t numNew = count_if(flags, [](uint8_t f) { return f & FIRST; });
+    SymbolUnion *newSyms =
+        getSpecificAllocSingleton<SymbolUnion>().Allocate(numNew);
+    for (size_t i = 0; i != n; ++i) {
+      if (flags[i] & FIRST) {
+        firsts[i] = symVector.size();
+        symVector.push_back(reinterpret_cast<Symbol *>(newSyms++));
+      }
+    }
+
+    // Fix up the entries added above.
+    parallelForEachN(0, symMap.size(), [&](size_t shard) {
+      for (size_t j = shardBegin[shard]; j != shardBegin[shard + 1]; ++j) {
+        uint32_t i = order[j];
+        if (flags[i] & FIRST)
+          symMap[shard]
+              .find(CachedHashStringRef({names[i].data, names[i].size},
+                                        names[i].hash))
+              ->second = firsts[i];
+      }
+    });
+
+    // Initialize the new symbols and fill in the symbol arrays of the files.
+    parallelForEachN(0, batch.size(), [&](size_t i) {
+      ObjFile<ELFT> *file = batch[i];
+      typename ELFT::SymRange eSyms = file->template getGlobalELFSyms<ELFT>();
+      file->symbols.resize(file->template getELFSyms<ELFT>().size());
+      MutableArrayRef<Symbol *> syms = file->getMutableGlobalSymbols();
+      for (size_t j = 0, e = syms.size(); j != e; ++j) {
+        size_t idx = offsets[i] + j;
+        int v = firsts[idx];
+        syms[j] = symVector[v < 0 ? firsts[-1 - v] : v];
+        if (flags[idx] & FIRST) {
+          new (syms[j]) SymbolUnion();
+          initPlaceholder(syms[j],
+                          CHECK(eSyms[j].getName(file->getStringTable()), file),
+                          flags[idx] & HAS_AT);
+        }
+      }
+    });
+
+    // A later <name>@@<version> renames an existing symbol <name>. Do that in
+    // order so that the last one wins, as it does with insert().
+    for (size_t i = 0; i != batch.size(); ++i) {
+      ObjFile<ELFT> *file = batch[i];
+      typename ELFT::SymRange eSyms = file->template getGlobalELFSyms<ELFT>();
+      ArrayRef<Symbol *> syms = file->getGlobalSymbols();
+      for (size_t j = 0, e = syms.size(); j != e; ++j) {
+        if ((flags[offsets[i] + j] & (FIRST | DEFAULT_VERSION)) !=
+            DEFAULT_VERSION)
+          continue;
+        syms[j]->setName(CHECK(eSyms[j].getName(file->getStringTable()), file));
+        syms[j]->hasVersionSuffix = true;
+      }
+    }
+  }
+}
+
 Symbol *SymbolTable::addSymbol(const Symbol &newSym) {
   Symbol *sym = insert(newSym.getName());
   sym->resolve(newSym);
@@ -108,8 +264,9 @@ Symbol *SymbolTable::addSymbol(const Symbol &newSym) {
 }
 
 Symbol *SymbolTable::find(StringRef name) {
-  auto it = symMap.find(CachedHashStringRef(name));
-  if (it == symMap.end())
+  CachedHashStringRef key(name);
+  auto it = getSymMap(key).find(key);
+  if (it == getSymMap(key).end())
     return nullptr;
   return symVector[it->second];
 }
@@ -330,3 +487,8 @@ void SymbolTable::scanVersionScript() {
   // --dynamic-list.
   handleDynamicList();
 }
+
+template void SymbolTable::insertGlobals(ArrayRef<ObjFile<ELF32LE> *>);
+template void SymbolTable::insertGlobals(ArrayRef<ObjFile<ELF32BE> *>);
+template void SymbolTable::insertGlobals(ArrayRef<ObjFile<ELF64LE> *>);
+template void SymbolTable::insertGlobals(ArrayRef<ObjFile<ELF64BE> *>);
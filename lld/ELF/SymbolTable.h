@@ -15,6 +15,7 @@
 #include "llvm/ADT/CachedHashString.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/STLExtras.h"
+#include <array>
 
 namespace lld {
 namespace elf {
@@ -39,6 +40,11 @@ public:
 
   Symbol *insert(StringRef name);
 
+  // Inserts the global symbols of the given object files, using multiple
+  // threads. The result is the same as calling insert() for each of them in
+  // order, so symbol resolution can then be done serially as usual.
+  template <class ELFT> void insertGlobals(ArrayRef<ObjFile<ELFT> *> files);
+
   Symbol *addSymbol(const Symbol &newSym);
 
   void scanVersionScript();
@@ -73,7 +79,17 @@ private:
   // but a bit inefficient.
   // FIXME: Experiment with passing in a custom hashing or sorting the symbols
   // once symbol resolution is finished.
-  llvm::DenseMap<llvm::CachedHashStringRef, int> symMap;
+  //
+  // symMap is split into shards by the upper bits of the hash values, so that
+  // insertGlobals() can fill the shards concurrently.
+  static constexpr unsigned symMapShardBits = 6;
+  std::array<llvm::DenseMap<llvm::CachedHashStringRef, int>,
+             1 << symMapShardBits>
+      symMap;
+  llvm::DenseMap<llvm::CachedHashStringRef, int> &
+  getSymMap(llvm::CachedHashStringRef key) {
+    return symMap[key.hash() >> (32 - symMapShardBits)];
+  }
   SmallVector<Symbol *, 0> symVector;
 
   // A map from demangled symbol names to their symbol objects.
@@ -21,6 +21,7 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/Object/Archive.h"
 #include "llvm/Object/ELF.h"
+#include <atomic>
 #include <tuple>
 
 namespace lld {
@@ -53,6 +54,21 @@ struct SymbolAux {
 
 extern SmallVector<SymbolAux, 0> symAux;
 
+// Values of Symbol::flags. NEEDS_COPY is set if the symbol needs a canonical
+// PLT entry, or (during postScanRelocations) a copy relocation.
+enum : uint16_t {
+  NEEDS_GOT = 1 << 0,
+  NEEDS_PLT = 1 << 1,
+  HAS_DIRECT_RELOC = 1 << 2,
+  NEEDS_COPY = 1 << 3,
+  NEEDS_TLSDESC = 1 << 4,
+  NEEDS_TLSGD = 1 << 5,
+  NEEDS_TLSGD_TO_IE = 1 << 6,
+  NEEDS_GOT_DTPREL = 1 << 7,
+  NEEDS_TLSIE = 1 << 8,
+  NEEDS_TLSLD = 1 << 9,
+};
+
 // The base class for real symbol classes.
 class Symbol {
 public:
@@ -256,12 +272,15 @@ protected:
         canInline(false), referenced(false), traced(false),
         hasVersionSuffix(false), isInIplt(false), gotInIgot(false),
         isPreemptible(false), used(!config->gcSections), folded(false),
-        needsTocRestore(false), scriptDefined(false), needsCopy(false),
-        needsGot(false), needsPlt(false), needsTlsDesc(false),
-        needsTlsGd(false), needsTlsGdToIe(false), needsTlsLd(false),
-        needsGotDtprel(false), needsTlsIe(false), hasDirectReloc(false) {}
+        needsTocRestore(false), scriptDefined(false) {}
 
 public:
+  // std::atomic is not copyable, but a Symbol is otherwise plain data that is
+  // routinely copied byte-wise (see replace()), so do the same here.
+  Symbol(const Symbol &other) {
+    memcpy(static_cast<void *>(this), &other, sizeof(Symbol));
+  }
+
   // True if this symbol is in the Iplt sub-section of the Plt and the Igot
   // sub-section of the .got.plt or .got.
   uint8_t isInIplt : 1;
@@ -289,25 +308,23 @@ public:
   // True if this symbol is defined by a linker script.
   uint8_t scriptDefined : 1;
 
-  // True if this symbol needs a canonical PLT entry, or (during
-  // postScanRelocations) a copy relocation.
-  uint8_t needsCopy : 1;
-
-  // Temporary flags used to communicate which symbol entries need PLT and GOT
-  // entries during postScanRelocations();
-  uint8_t needsGot : 1;
-  uint8_t needsPlt : 1;
-  uint8_t needsTlsDesc : 1;
-  uint8_t needsTlsGd : 1;
-  uint8_t needsTlsGdToIe : 1;
-  uint8_t needsTlsLd : 1;
-  uint8_t needsGotDtprel : 1;
-  uint8_t needsTlsIe : 1;
-  uint8_t hasDirectReloc : 1;
+  // Temporary flags (see the enum above) used to communicate which symbol
+  // entries need PLT and GOT entries during postScanRelocations(). They are set
+  // concurrently by the parallel relocation scan, hence the atomic.
+  std::atomic<uint16_t> flags{0};
+
+  void setFlags(uint16_t bits) {
+    flags.fetch_or(bits, std::memory_order_relaxed);
+  }
+  bool hasFlag(uint16_t bit) const {
+    assert(bit && (bit & (bit - 1)) == 0 && "expected a single flag");
+    return flags.load(std::memory_order_relaxed) & bit;
+  }
 
   bool needsDynReloc() const {
-    return needsCopy || needsGot || needsPlt || needsTlsDesc || needsTlsGd ||
-           needsTlsGdToIe || needsTlsLd || needsGotDtprel || needsTlsIe;
+    return flags.load(std::memory_order_relaxed) &
+           (NEEDS_COPY | NEEDS_GOT | NEEDS_PLT | NEEDS_TLSDESC | NEEDS_TLSGD |
+            NEEDS_TLSGD_TO_IE | NEEDS_GOT_DTPREL | NEEDS_TLSIE | NEEDS_TLSLD);
   }
   void allocateAux() {
     assert(auxIdx == uint32_t(-1));
@@ -30,9 +30,11 @@
 #include "llvm/ADT/SetOperations.h"
 #include "llvm/ADT/StringExtras.h"
 #include "llvm/BinaryFormat/Dwarf.h"
+#include "llvm/DebugInfo/DWARF/DWARFAcceleratorTable.h"
 #include "llvm/DebugInfo/DWARF/DWARFDebugPubTable.h"
 #include "llvm/Object/ELFObjectFile.h"
 #include "llvm/Support/Compression.h"
+#include "llvm/Support/DJB.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/LEB128.h"
 #include "llvm/Support/MD5.h"
@@ -444,8 +446,8 @@ void EhFrameSection::addSection(EhInputSection *sec) {
   alignment = std::max(alignment, sec->alignment);
   sections.push_back(sec);
 
-  for (auto *ds : sec->dependentSections)
-    dependentSections.push_back(ds);
+  for (InputSection *ds : sec->getDependentSections())
+    addDependentSection(ds);
 }
 
 // Used by ICF<ELFT>::handleLSDA(). This function is very similar to
@@ -1594,28 +1596,6 @@ RelocationBaseSection::RelocationBaseSection(StringRef name, uint32_t type,
     : SyntheticSection(SHF_ALLOC, type, config->wordsize, name),
       dynamicTag(dynamicTag), sizeDynamicTag(sizeDynamicTag) {}
 
-void RelocationBaseSection::addSymbolReloc(RelType dynType,
-                                           InputSectionBase &isec,
-                                           uint64_t offsetInSec, Symbol &sym,
-                                           int64_t addend,
-                                           Optional<RelType> addendRelType) {
-  addReloc(DynamicReloc::AgainstSymbol, dynType, isec, offsetInSec, sym, addend,
-           R_ADDEND, addendRelType ? *addendRelType : target->noneRel);
-}
-
-void RelocationBaseSection::addRelativeReloc(
-    RelType dynType, InputSectionBase &inputSec, uint64_t offsetInSec,
-    Symbol &sym, int64_t addend, RelType addendRelType, RelExpr expr) {
-  // This function should only be called for non-preemptible symbols or
-  // RelExpr values that refer to an address inside the output file (e.g. the
-  // address of the GOT entry for a potentially preemptible symbol).
-  assert((!sym.isPreemptible || expr == R_GOT) &&
-         "cannot add relative relocation against preemptible symbol");
-  assert(expr != R_ADDEND && "expected non-addend relocation expression");
-  addReloc(DynamicReloc::AddendOnlyWithTargetVA, dynType, inputSec, offsetInSec,
-           sym, addend, expr, addendRelType);
-}
-
 void RelocationBaseSection::addAddendOnlyRelocIfNonPreemptible(
     RelType dynType, InputSectionBase &isec, uint64_t offsetInSec, Symbol &sym,
     RelType addendRelType) {
@@ -1628,23 +1608,15 @@ void RelocationBaseSection::addAddendOnlyRelocIfNonPreemptible(
              sym, 0, R_ABS, addendRelType);
 }
 
-void RelocationBaseSection::addReloc(DynamicReloc::Kind kind, RelType dynType,
-                                     InputSectionBase &inputSec,
-                                     uint64_t offsetInSec, Symbol &sym,
-                                     int64_t addend, RelExpr expr,
-                                     RelType addendRelType) {
-  // Write the addends to the relocated address if required. We skip
-  // it if the written value would be zero.
-  if (config->writeAddends && (expr != R_ADDEND || addend != 0))
-    inputSec.relocations.push_back(
-        {expr, addendRelType, offsetInSec, addend, &sym});
-  addReloc({dynType, &inputSec, offsetInSec, kind, sym, addend, expr});
-}
-
-void RelocationBaseSection::addReloc(const DynamicReloc &reloc) {
-  if (reloc.type == target->relativeRel)
-    ++numRelativeRelocs;
-  relocs.push_back(reloc);
+void RelocationBaseSection::mergeRels() {
+  size_t newSize = relocs.size();
+  for (const auto &v : relocsVec)
+    newSize += v.size();
+  relocs.reserve(newSize);
+  for (const auto &v : relocsVec)
+    for (const DynamicReloc &rel : v)
+      addReloc(rel);
+  relocsVec.clear();
 }
 
 void RelocationBaseSection::finalizeContents() {
@@ -1673,6 +1645,16 @@ RelrBaseSection::RelrBaseSection()
                        config->useAndroidRelrTags ? SHT_ANDROID_RELR : SHT_RELR,
                        config->wordsize, ".relr.dyn") {}
 
+void RelrBaseSection::mergeRels() {
+  size_t newSize = relocs.size();
+  for (const auto &v : relocsVec)
+    newSize += v.size();
+  relocs.reserve(newSize);
+  for (const auto &v : relocsVec)
+    llvm::append_range(relocs, v);
+  relocsVec.clear();
+}
+
 template <class ELFT>
 static void encodeDynamicReloc(typename ELFT::Rela *p,
                                const DynamicReloc &rel) {
@@ -2208,8 +2190,8 @@ static BssSection *getCommonSec(Symbol *sym) {
 }
 
 static uint32_t getSymSectionIndex(Symbol *sym) {
-  assert(!(sym->needsCopy && sym->isObject()));
-  if (!isa<Defined>(sym) || sym->needsCopy)
+  assert(!(sym->hasFlag(NEEDS_COPY) && sym->isObject()));
+  if (!isa<Defined>(sym) || sym->hasFlag(NEEDS_COPY))
     return SHN_UNDEF;
   if (const OutputSection *os = sym->getOutputSection())
     return os->sectionIndex >= SHN_LORESERVE ? (uint32_t)SHN_XINDEX
@@ -2278,7 +2260,7 @@ template <class ELFT> void SymbolTableSection<ELFT>::writeTo(uint8_t *buf) {
 
     for (SymbolTableEntry &ent : symbols) {
       Symbol *sym = ent.sym;
-      if (sym->isInPlt() && sym->needsCopy)
+      if (sym->isInPlt() && sym->hasFlag(NEEDS_COPY))
         eSym->st_other |= STO_MIPS_PLT;
       if (isMicroMips()) {
         // We already set the less-significant bit for symbols
@@ -2288,8 +2270,8 @@ template <class ELFT> void SymbolTableSection<ELFT>::writeTo(uint8_t *buf) {
         // clear that bit for non-dynamic symbol table, so tools
         // like `objdump` will be able to deal with a correct
         // symbol position.
-        if (sym->isDefined() &&
-            ((sym->stOther & STO_MIPS_MICROMIPS) || sym->needsCopy)) {
+        if (sym->isDefined() && ((sym->stOther & STO_MIPS_MICROMIPS) ||
+                                 sym->hasFlag(NEEDS_COPY))) {
           if (!strTabSec.isDynamic())
             eSym->st_value &= ~1;
           eSym->st_other |= STO_MIPS_MICROMIPS;
@@ -2889,6 +2871,17 @@ createSymbols(ArrayRef<std::vector<GdbIndexSection::NameAttrEntry>> nameAttrs,
   return ret;
 }
 
+// Removes the debug sections that have been replaced by a synthetic section,
+// along with their relocation sections in --emit-relocs mode.
+static void eraseDeadDebugSections() {
+  llvm::erase_if(inputSections, [](InputSectionBase *s) {
+    if (auto *isec = dyn_cast<InputSection>(s))
+      if (InputSectionBase *rel = isec->getRelocatedSection())
+        return !rel->isLive();
+    return !s->isLive();
+  });
+}
+
 // Returns a newly-created .gdb_index section.
 template <class ELFT> GdbIndexSection *GdbIndexSection::create() {
   // Collect InputFiles with .debug_info. See the comment in
@@ -2909,12 +2902,7 @@ template <class ELFT> GdbIndexSection *GdbIndexSection::create() {
       files.insert(isec->file);
   }
   // Drop .rel[a].debug_gnu_pub{names,types} for --emit-relocs.
-  llvm::erase_if(inputSections, [](InputSectionBase *s) {
-    if (auto *isec = dyn_cast<InputSection>(s))
-      if (InputSectionBase *rel = isec->getRelocatedSection())
-        return !rel->isLive();
-    return !s->isLive();
-  });
+  eraseDeadDebugSections();
 
   std::vector<GdbChunk> chunks(files.size());
   std::vector<std::vector<NameAttrEntry>> nameAttrs(files.size());
@@ -3012,6 +3000,322 @@ void GdbIndexSection::writeTo(uint8_t *buf) {
 
 bool GdbIndexSection::isNeeded() const { return !chunks.empty(); }
 
+DebugNamesSection::DebugNamesSection()
+    : SyntheticSection(0, SHT_PROGBITS, 4, ".debug_names") {}
+
+namespace {
+// The names gathered from the .debug_names section of a single object file.
+struct DebugNamesChunk {
+  SmallVector<DebugNamesSection::CuEntry, 0> cus;
+  std::vector<DebugNamesSection::NameData> names;
+  SmallVector<uint16_t, 0> tags;
+};
+} // namespace
+
+template <class ELFT>
+static DebugNamesChunk readDebugNames(ObjFile<ELFT> *file) {
+  using NameData = DebugNamesSection::NameData;
+
+  DWARFContext dwarf(std::make_unique<LLDDwarfObj<ELFT>>(file));
+  auto &dobj = static_cast<const LLDDwarfObj<ELFT> &>(dwarf.getDWARFObj());
+  const LLDDWARFSection &namesSec = dobj.getNamesSection();
+  InputSection *infoSec = dobj.getInfoSection();
+
+  // String offsets in the name table are relative to .debug_str, which is
+  // merged in the output. We translate them when writing the section.
+  InputSectionBase *strSec = nullptr;
+  for (InputSectionBase *sec : file->getSections())
+    if (sec && sec->name == ".debug_str")
+      strSec = sec;
+
+  DebugNamesChunk chunk;
+  if (!infoSec || !strSec)
+    return chunk;
+
+  DWARFDataExtractor data(dobj, namesSec, config->isLE, config->wordsize);
+  DataExtractor strData(dobj.getStrSection(), config->isLE, config->wordsize);
+  DWARFDebugNames index(data, strData);
+  if (Error e = index.extract()) {
+    warn(toString(namesSec.sec) + ": " + toString(std::move(e)));
+    return chunk;
+  }
+
+  for (const DWARFDebugNames::NameIndex &ni : index) {
+    // An object file usually has one name index per compile unit, but a
+    // relocatable link may have concatenated several of them.
+    uint32_t cuBase = chunk.cus.size();
+    for (uint32_t i = 0, e = ni.getCUCount(); i != e; ++i)
+      chunk.cus.push_back({infoSec, ni.getCUOffset(i)});
+    for (const DWARFDebugNames::Abbrev &abbrev : ni.getAbbrevs())
+      chunk.tags.push_back(abbrev.Tag);
+
+    for (const DWARFDebugNames::NameTableEntry &nte : ni) {
+      const char *name = nte.getString();
+      if (!name)
+        continue;
+      // The hash table is optional. If it exists, its hashes are computed
+      // with the same function as ours.
+      uint32_t hash = ni.getBucketCount()
+                          ? ni.getHashArrayEntry(nte.getIndex())
+                          : caseFoldingDjbHash(name);
+      NameData nd{{name, hash}, strSec, uint32_t(nte.getStringOffset()), 0,
+                  {}};
+
+      uint64_t offset = nte.getEntryOffset();
+      for (;;) {
+        Expected<DWARFDebugNames::Entry> ent = ni.getEntry(&offset);
+        if (!ent) {
+          handleAllErrors(
+              ent.takeError(), [](const DWARFDebugNames::SentinelError &) {},
+              [&](const ErrorInfoBase &e) {
+                warn(toString(namesSec.sec) + ": " + e.message());
+              });
+          break;
+        }
+        // Type units are not indexed because their sections may be
+        // deduplicated by COMDAT groups. DW_IDX_parent is dropped as well,
+        // which just means that the parent is unknown.
+        if (ent->lookup(DW_IDX_type_unit))
+          continue;
+        Optional<uint64_t> cuIndex = ent->getCUIndex();
+        Optional<uint64_t> dieOffset = ent->getDIEUnitOffset();
+        if (!cuIndex || *cuIndex >= ni.getCUCount() || !dieOffset)
+          continue;
+        nd.entries.push_back({uint32_t(cuBase + *cuIndex),
+                              uint32_t(*dieOffset), uint16_t(ent->tag())});
+      }
+      if (!nd.entries.empty())
+        chunk.names.push_back(std::move(nd));
+    }
+  }
+  return chunk;
+}
+
+// Merges the names of all chunks by uniquifying them by name. Like
+// createSymbols for .gdb_index, this shards the names by hash so that each
+// thread owns a disjoint set of names. The entries of a name are kept in
+// input file order, so the output is deterministic.
+static std::vector<DebugNamesSection::NameData>
+mergeDebugNames(MutableArrayRef<DebugNamesChunk> chunks) {
+  using NameData = DebugNamesSection::NameData;
+
+  constexpr size_t numShards = 32;
+  size_t concurrency = PowerOf2Floor(
+      std::min<size_t>(hardware_concurrency(parallel::strategy.ThreadsRequested)
+                           .compute_thread_count(),
+                       numShards));
+  std::vector<DenseMap<CachedHashStringRef, size_t>> map(numShards);
+  std::vector<std::vector<NameData>> shards(numShards);
+  size_t shift = 32 - countTrailingZeros(numShards);
+
+  parallelForEachN(0, concurrency, [&](size_t threadId) {
+    for (DebugNamesChunk &chunk : chunks) {
+      for (NameData &nd : chunk.names) {
+        size_t shardId = nd.name.hash() >> shift;
+        if ((shardId & (concurrency - 1)) != threadId)
+          continue;
+
+        size_t &idx = map[shardId][nd.name];
+        if (idx) {
+          SmallVector<DebugNamesSection::NameEntry, 0> &entries =
+              shards[shardId][idx - 1].entries;
+          entries.append(nd.entries.begin(), nd.entries.end());
+          continue;
+        }
+        idx = shards[shardId].size() + 1;
+        shards[shardId].push_back(std::move(nd));
+      }
+    }
+  });
+
+  size_t numNames = 0;
+  for (ArrayRef<NameData> v : shards)
+    numNames += v.size();
+  std::vector<NameData> ret;
+  ret.reserve(numNames);
+  for (std::vector<NameData> &v : shards)
+    for (NameData &nd : v)
+      ret.push_back(std::move(nd));
+  return ret;
+}
+
+// Returns the number of hash buckets for a given number of names. This uses
+// the same heuristic as AsmPrinter's accelerator table emitter.
+static uint32_t getDebugNamesBucketCount(size_t numNames) {
+  if (numNames > 1024)
+    return numNames / 4;
+  if (numNames > 16)
+    return numNames / 2;
+  return numNames ? numNames : 1;
+}
+
+template <class ELFT> DebugNamesSection *DebugNamesSection::create() {
+  // The input name indexes are replaced by the merged one.
+  SetVector<InputFile *> files;
+  for (InputSectionBase *s : inputSections) {
+    if (s->name != ".debug_names")
+      continue;
+    s->markDead();
+    if (isa<InputSection>(s))
+      files.insert(s->file);
+  }
+  eraseDeadDebugSections();
+
+  std::vector<DebugNamesChunk> chunks(files.size());
+  parallelForEachN(0, files.size(), [&](size_t i) {
+    chunks[i] = readDebugNames(cast<ObjFile<ELFT>>(files[i]));
+  });
+
+  // Make compile unit indexes global and collect the tags of all entries.
+  auto *ret = make<DebugNamesSection>();
+  for (DebugNamesChunk &chunk : chunks) {
+    uint32_t cuBase = ret->cus.size();
+    ret->cus.append(chunk.cus.begin(), chunk.cus.end());
+    ret->tags.append(chunk.tags.begin(), chunk.tags.end());
+    if (cuBase)
+      parallelForEach(chunk.names, [&](NameData &nd) {
+        for (NameEntry &ent : nd.entries)
+          ent.cuIndex += cuBase;
+      });
+  }
+  llvm::sort(ret->tags);
+  ret->tags.erase(std::unique(ret->tags.begin(), ret->tags.end()),
+                  ret->tags.end());
+
+  // Names in the same bucket must be contiguous. Sorting by name within a
+  // bucket makes the output independent of the thread count.
+  ret->names = mergeDebugNames(chunks);
+  uint32_t numBuckets = getDebugNamesBucketCount(ret->names.size());
+  ret->bucketCount = numBuckets;
+  parallelSort(ret->names, [=](const NameData &a, const NameData &b) {
+    uint32_t x = a.name.hash() % numBuckets, y = b.name.hash() % numBuckets;
+    if (x != y)
+      return x < y;
+    if (a.name.hash() != b.name.hash())
+      return a.name.hash() < b.name.hash();
+    return a.name.val() < b.name.val();
+  });
+
+  ret->initOutputSize();
+  return ret;
+}
+
+uint32_t DebugNamesSection::getAbbrevCode(uint16_t tag) const {
+  return llvm::lower_bound(tags, tag) - tags.begin() + 1;
+}
+
+static Form getCuIndexForm(uint32_t size) {
+  return size == 1 ? DW_FORM_data1 : size == 2 ? DW_FORM_data2 : DW_FORM_data4;
+}
+
+// Compute the output section size. Every output entry consists of an
+// abbreviation code, DW_IDX_compile_unit and DW_IDX_die_offset.
+void DebugNamesSection::initOutputSize() {
+  cuIndexSize = cus.size() <= 0xff ? 1 : cus.size() <= 0xffff ? 2 : 4;
+
+  abbrevTableSize = 1;
+  for (size_t i = 0, e = tags.size(); i != e; ++i)
+    abbrevTableSize += getULEB128Size(i + 1) + getULEB128Size(tags[i]) +
+                       getULEB128Size(DW_IDX_compile_unit) +
+                       getULEB128Size(getCuIndexForm(cuIndexSize)) +
+                       getULEB128Size(DW_IDX_die_offset) +
+                       getULEB128Size(DW_FORM_ref4) + 2;
+
+  // Compute the size of each entry list in parallel, and then their offsets
+  // in the entry pool.
+  parallelForEach(names, [&](NameData &nd) {
+    uint32_t listSize = 1;
+    for (const NameEntry &ent : nd.entries)
+      listSize += getULEB128Size(getAbbrevCode(ent.tag)) + cuIndexSize + 4;
+    nd.entryOffset = listSize;
+  });
+  uint64_t off = 0;
+  for (NameData &nd : names) {
+    uint32_t listSize = nd.entryOffset;
+    nd.entryOffset = off;
+    off += listSize;
+  }
+
+  size = 36 + cus.size() * 4 + bucketCount * 4 + names.size() * 12 +
+         abbrevTableSize + off;
+  if (size > UINT32_MAX)
+    error(".debug_names: section too large");
+}
+
+void DebugNamesSection::writeTo(uint8_t *buf) {
+  // Write the header. We don't emit type units or an augmentation string.
+  write32(buf, size - 4);
+  write16(buf + 4, 5);
+  write16(buf + 6, 0);
+  write32(buf + 8, cus.size());
+  write32(buf + 12, 0);
+  write32(buf + 16, 0);
+  write32(buf + 20, bucketCount);
+  write32(buf + 24, names.size());
+  write32(buf + 28, abbrevTableSize);
+  write32(buf + 32, 0);
+  buf += 36;
+
+  // Write the CU list.
+  for (CuEntry &cu : cus) {
+    write32(buf, cu.sec->outSecOff + cu.cuOffset);
+    buf += 4;
+  }
+
+  // Write the hash table. A bucket refers to the first of its names by a
+  // 1-based index. Empty buckets are 0.
+  uint8_t *buckets = buf;
+  uint8_t *hashes = buckets + bucketCount * 4;
+  for (size_t i = 0, e = names.size(); i != e; ++i) {
+    uint32_t hash = names[i].name.hash();
+    write32(hashes + i * 4, hash);
+    if (i == 0 || names[i - 1].name.hash() % bucketCount != hash % bucketCount)
+      write32(buckets + (hash % bucketCount) * 4, i + 1);
+  }
+  buf = hashes + names.size() * 4;
+
+  // Write the name table.
+  uint8_t *strOffsets = buf;
+  uint8_t *entryOffsets = strOffsets + names.size() * 4;
+  parallelForEachN(0, names.size(), [&](size_t i) {
+    write32(strOffsets + i * 4,
+            names[i].strSec->getOffset(names[i].strOffset));
+    write32(entryOffsets + i * 4, names[i].entryOffset);
+  });
+  buf = entryOffsets + names.size() * 4;
+
+  // Write the abbreviation table.
+  Form cuIndexForm = getCuIndexForm(cuIndexSize);
+  for (size_t i = 0, e = tags.size(); i != e; ++i) {
+    buf += encodeULEB128(i + 1, buf);
+    buf += encodeULEB128(tags[i], buf);
+    buf += encodeULEB128(DW_IDX_compile_unit, buf);
+    buf += encodeULEB128(cuIndexForm, buf);
+    buf += encodeULEB128(DW_IDX_die_offset, buf);
+    buf += encodeULEB128(DW_FORM_ref4, buf);
+    *buf++ = 0;
+    *buf++ = 0;
+  }
+  *buf++ = 0;
+
+  // Write the entry pool. Each list of entries ends with a 0.
+  parallelForEach(names, [&](const NameData &nd) {
+    uint8_t *p = buf + nd.entryOffset;
+    for (const NameEntry &ent : nd.entries) {
+      p += encodeULEB128(getAbbrevCode(ent.tag), p);
+      if (cuIndexSize == 1)
+        *p = ent.cuIndex;
+      else if (cuIndexSize == 2)
+        write16(p, ent.cuIndex);
+      else
+        write32(p, ent.cuIndex);
+      write32(p + cuIndexSize, ent.dieOffset);
+      p += cuIndexSize + 4;
+    }
+    *p = 0;
+  });
+}
+
 EhFrameHeader::EhFrameHeader()
     : SyntheticSection(SHF_ALLOC, SHT_PROGBITS, 4, ".eh_frame_hdr") {}
 
@@ -3355,7 +3659,7 @@ ARMExidxSyntheticSection::ARMExidxSyntheticSection()
                        config->wordsize, ".ARM.exidx") {}
 
 static InputSection *findExidxSection(InputSection *isec) {
-  for (InputSection *d : isec->dependentSections)
+  for (InputSection *d : isec->getDependentSections())
     if (d->type == SHT_ARM_EXIDX && d->isLive())
       return d;
   return nullptr;
@@ -3849,6 +4153,11 @@ template GdbIndexSection *GdbIndexSection::create<ELF32BE>();
 template GdbIndexSection *GdbIndexSection::create<ELF64LE>();
 template GdbIndexSection *GdbIndexSection::create<ELF64BE>();
 
+template DebugNamesSection *DebugNamesSection::create<ELF32LE>();
+template DebugNamesSection *DebugNamesSection::create<ELF32BE>();
+template DebugNamesSection *DebugNamesSection::create<ELF64LE>();
+template DebugNamesSection *DebugNamesSection::create<ELF64BE>();
+
 template void elf::splitSections<ELF32LE>();
 template void elf::splitSections<ELF32BE>();
 template void elf::splitSections<ELF64LE>();
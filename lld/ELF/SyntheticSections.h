@@ -23,10 +23,12 @@
 #include "DWARF.h"
 #include "EhFrame.h"
 #include "InputSection.h"
+#include "Target.h"
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ADT/MapVector.h"
 #include "llvm/MC/StringTableBuilder.h"
 #include "llvm/Support/Endian.h"
+#include <atomic>
 #include <functional>
 
 namespace lld {
@@ -142,7 +144,7 @@ public:
 
   // Flag to force GOT to be in output if we have relocations
   // that relies on its address.
-  bool hasGotOffRel = false;
+  std::atomic<bool> hasGotOffRel{false};
 
 protected:
   size_t numEntries = 0;
@@ -386,7 +388,7 @@ public:
 
   // Flag to force GotPlt to be in output if we have relocations
   // that relies on its address.
-  bool hasGotPltOffRel = false;
+  std::atomic<bool> hasGotPltOffRel{false};
 
 private:
   SmallVector<const Symbol *, 0> entries;
@@ -519,25 +521,55 @@ public:
   /// Add a dynamic relocation without writing an addend to the output section.
   /// This overload can be used if the addends are written directly instead of
   /// using relocations on the input section (e.g. MipsGotSection::writeTo()).
-  void addReloc(const DynamicReloc &reloc);
+  ///
+  /// If \p shard is true, the relocation is buffered for the relocation scan
+  /// shard of the calling thread and moved to relocs by mergeRels().
+  template <bool shard = false> void addReloc(const DynamicReloc &reloc);
   /// Add a dynamic relocation against \p sym with an optional addend.
+  template <bool shard = false>
   void addSymbolReloc(RelType dynType, InputSectionBase &isec,
                       uint64_t offsetInSec, Symbol &sym, int64_t addend = 0,
-                      llvm::Optional<RelType> addendRelType = llvm::None);
+                      llvm::Optional<RelType> addendRelType = llvm::None) {
+    addReloc<shard>(DynamicReloc::AgainstSymbol, dynType, isec, offsetInSec,
+                    sym, addend, R_ADDEND,
+                    addendRelType ? *addendRelType : target->noneRel);
+  }
   /// Add a relative dynamic relocation that uses the target address of \p sym
   /// (i.e. InputSection::getRelocTargetVA()) + \p addend as the addend.
+  template <bool shard = false>
   void addRelativeReloc(RelType dynType, InputSectionBase &isec,
                         uint64_t offsetInSec, Symbol &sym, int64_t addend,
-                        RelType addendRelType, RelExpr expr);
+                        RelType addendRelType, RelExpr expr) {
+    // This function should only be called for non-preemptible symbols or
+    // RelExpr values that refer to an address inside the output file (e.g. the
+    // address of the GOT entry for a potentially preemptible symbol).
+    assert((!sym.isPreemptible || expr == R_GOT) &&
+           "cannot add relative relocation against preemptible symbol");
+    assert(expr != R_ADDEND && "expected non-addend relocation expression");
+    addReloc<shard>(DynamicReloc::AddendOnlyWithTargetVA, dynType, isec,
+                    offsetInSec, sym, addend, expr, addendRelType);
+  }
   /// Add a dynamic relocation using the target address of \p sym as the addend
   /// if \p sym is non-preemptible. Otherwise add a relocation against \p sym.
   void addAddendOnlyRelocIfNonPreemptible(RelType dynType,
                                           InputSectionBase &isec,
                                           uint64_t offsetInSec, Symbol &sym,
                                           RelType addendRelType);
+  template <bool shard = false>
   void addReloc(DynamicReloc::Kind kind, RelType dynType,
                 InputSectionBase &inputSec, uint64_t offsetInSec, Symbol &sym,
-                int64_t addend, RelExpr expr, RelType addendRelType);
+                int64_t addend, RelExpr expr, RelType addendRelType) {
+    // Write the addends to the relocated address if required. We skip
+    // it if the written value would be zero.
+    if (config->writeAddends && (expr != R_ADDEND || addend != 0))
+      inputSec.relocations.push_back(
+          {expr, addendRelType, offsetInSec, addend, &sym});
+    addReloc<shard>({dynType, &inputSec, offsetInSec, kind, sym, addend, expr});
+  }
+  /// Prepare \p numShards buffers for the relocation scan.
+  void initShards(size_t numShards) { relocsVec.resize(numShards); }
+  /// Append the buffered relocations to relocs in shard order.
+  void mergeRels();
   bool isNeeded() const override { return !relocs.empty(); }
   size_t getSize() const override { return relocs.size() * this->entsize; }
   size_t getRelativeRelocCount() const { return numRelativeRelocs; }
@@ -552,8 +584,22 @@ public:
 
 protected:
   size_t numRelativeRelocs = 0;
+  // Relocations added by the relocation scan, one vector per shard.
+  SmallVector<SmallVector<DynamicReloc, 0>, 0> relocsVec;
 };
 
+template <>
+inline void RelocationBaseSection::addReloc<false>(const DynamicReloc &reloc) {
+  if (reloc.type == target->relativeRel)
+    ++numRelativeRelocs;
+  relocs.push_back(reloc);
+}
+
+template <>
+inline void RelocationBaseSection::addReloc<true>(const DynamicReloc &reloc) {
+  relocsVec[relocScanShard].push_back(reloc);
+}
+
 template <class ELFT>
 class RelocationSection final : public RelocationBaseSection {
   using Elf_Rel = typename ELFT::Rel;
@@ -595,8 +641,21 @@ struct RelativeReloc {
 class RelrBaseSection : public SyntheticSection {
 public:
   RelrBaseSection();
+  // See RelocationBaseSection::addReloc() for the meaning of \p shard.
+  template <bool shard = false>
+  void addRelativeReloc(InputSectionBase &isec, uint64_t offsetInSec) {
+    if (shard)
+      relocsVec[relocScanShard].push_back({&isec, offsetInSec});
+    else
+      relocs.push_back({&isec, offsetInSec});
+  }
+  void initShards(size_t numShards) { relocsVec.resize(numShards); }
+  void mergeRels();
   bool isNeeded() const override { return !relocs.empty(); }
   SmallVector<RelativeReloc, 0> relocs;
+
+protected:
+  SmallVector<SmallVector<RelativeReloc, 0>, 0> relocsVec;
 };
 
 // RelrSection is used to encode offsets for relative relocations.
@@ -828,6 +887,57 @@ private:
   size_t size;
 };
 
+// --debug-names option tells the linker to merge the DWARF v5 .debug_names
+// name indexes of input files into a single name index covering all compile
+// units, so that debuggers do not need to consult one index per unit.
+class DebugNamesSection final : public SyntheticSection {
+public:
+  struct NameEntry {
+    uint32_t cuIndex;
+    uint32_t dieOffset;
+    uint16_t tag;
+  };
+
+  struct NameData {
+    llvm::CachedHashStringRef name;
+    // The .debug_str section and offset of the first occurrence of this name.
+    // They are translated to an output offset when writing.
+    InputSectionBase *strSec;
+    uint32_t strOffset;
+    uint32_t entryOffset;
+    SmallVector<NameEntry, 0> entries;
+  };
+
+  struct CuEntry {
+    InputSection *sec;
+    uint64_t cuOffset;
+  };
+
+  DebugNamesSection();
+  template <typename ELFT> static DebugNamesSection *create();
+  void writeTo(uint8_t *buf) override;
+  size_t getSize() const override { return size; }
+  bool isNeeded() const override { return !cus.empty(); }
+
+private:
+  void initOutputSize();
+  uint32_t getAbbrevCode(uint16_t tag) const;
+
+  // Compile units of all input name indexes, in input file order.
+  SmallVector<CuEntry, 0> cus;
+
+  // Uniquified names, sorted by hash bucket.
+  std::vector<NameData> names;
+
+  // Each distinct tag gets an abbreviation whose code is its index plus one.
+  SmallVector<uint16_t, 0> tags;
+
+  uint32_t bucketCount = 0;
+  uint32_t cuIndexSize = 0;
+  uint32_t abbrevTableSize = 0;
+  size_t size = 0;
+};
+
 // --eh-frame-hdr option tells linker to construct a header for all the
 // .eh_frame sections. This header is placed to a section named .eh_frame_hdr
 // and also to a PT_GNU_EH_FRAME segment.
@@ -1067,7 +1177,7 @@ public:
 //
 // Instead of storing pointers to the .ARM.exidx InputSections from
 // InputObjects, we store pointers to the executable sections that need
-// .ARM.exidx sections. We can then use the dependentSections of these to
+// .ARM.exidx sections. We can then use the dependent sections of these to
 // either find the .ARM.exidx section or know that we need to generate one.
 class ARMExidxSyntheticSection : public SyntheticSection {
 public:
@@ -1095,7 +1205,7 @@ private:
 
   // Instead of storing pointers to the .ARM.exidx InputSections from
   // InputObjects, we store pointers to the executable sections that need
-  // .ARM.exidx sections. We can then use the dependentSections of these to
+  // .ARM.exidx sections. We can then use the dependent sections of these to
   // either find the .ARM.exidx section or know that we need to generate one.
   std::vector<InputSection *> executableSections;
 
@@ -11,6 +11,7 @@
 #include "ARMErrataFix.h"
 #include "CallGraphSort.h"
 #include "Config.h"
+#include "Incremental.h"
 #include "LinkerScript.h"
 #include "MapFile.h"
 #include "OutputSections.h"
@@ -473,6 +474,9 @@ template <class ELFT> void elf::createSyntheticSections() {
   if (config->gdbIndex)
     add(*GdbIndexSection::create<ELFT>());
 
+  if (config->debugNames)
+    add(*DebugNamesSection::create<ELFT>());
+
   // We always need to add rel[a].plt to output if it has entries.
   // Even for static linking it can contain R_[*]_IRELATIVE relocations.
   in.relaPlt = std::make_unique<RelocationSection<ELFT>>(
@@ -601,6 +605,10 @@ template <class ELFT> void Writer<ELFT>::run() {
     if (auto e = buffer->commit())
       error("failed to write to the output file: " + toString(std::move(e)));
   }
+
+  // Save what the next --incremental link needs to patch this output.
+  if (config->incremental && !errorCount())
+    writeIncrementalState<ELFT>();
 }
 
 template <class ELFT, class RelTy>
@@ -1907,21 +1915,7 @@ template <class ELFT> void Writer<ELFT>::finalizeSections() {
     // a linker-script-defined symbol is absolute.
     ppc64noTocRelax.clear();
     if (!config->relocatable) {
-      // Scan all relocations. Each relocation goes through a series of tests to
-      // determine if it needs special treatment, such as creating GOT, PLT,
-      // copy relocations, etc. Note that relocations for non-alloc sections are
-      // directly processed by InputSection::relocateNonAlloc.
-      for (InputSectionBase *sec : inputSections)
-        if (sec->isLive() && isa<InputSection>(sec) && (sec->flags & SHF_ALLOC))
-          scanRelocations<ELFT>(*sec);
-      for (Partition &part : partitions) {
-        for (EhInputSection *sec : part.ehFrame->sections)
-          scanRelocations<ELFT>(*sec);
-        if (part.armExidx && part.armExidx->isLive())
-          for (InputSection *sec : part.armExidx->exidxSections)
-            scanRelocations<ELFT>(*sec);
-      }
-
+      scanRelocations<ELFT>();
       reportUndefinedSymbols<ELFT>();
       postScanRelocations();
     }
@@ -2881,9 +2875,27 @@ template <class ELFT> void Writer<ELFT>::writeSections() {
     if (sec->type == SHT_REL || sec->type == SHT_RELA)
       sec->writeTo<ELFT>(Out::bufferStart + sec->offset);
 
+  // With --stream-output, write the other sections in file offset order and
+  // release the output up to the end of each section once it is written.
+  // Large sections are also released piecewise by OutputSection::writeTo.
+  SmallVector<OutputSection *, 0> sections;
   for (OutputSection *sec : outputSections)
     if (sec->type != SHT_REL && sec->type != SHT_RELA)
-      sec->writeTo<ELFT>(Out::bufferStart + sec->offset);
+      sections.push_back(sec);
+  if (config->streamOutput)
+    llvm::stable_sort(sections, [](OutputSection *a, OutputSection *b) {
+      return a->offset < b->offset;
+    });
+
+  uint64_t released = 0;
+  for (OutputSection *sec : sections) {
+    sec->writeTo<ELFT>(Out::bufferStart + sec->offset);
+    uint64_t end = sec->offset + (sec->type == SHT_NOBITS ? 0 : sec->size);
+    if (config->streamOutput && end > released) {
+      releaseOutputPages(released, end - released);
+      released = end;
+    }
+  }
 
   // Finally, check that all dynamic relocation addends were written correctly.
   if (config->checkDynamicRelocs && config->writeAddends) {
@@ -2913,25 +2925,18 @@ computeHash(llvm::MutableArrayRef<uint8_t> hashBuf,
   hashFn(hashBuf.data(), hashes);
 }
 
-template <class ELFT> void Writer<ELFT>::writeBuildId() {
-  if (!mainPart->buildId || !mainPart->buildId->getParent())
-    return;
-
-  if (config->buildId == BuildIdKind::Hexstring) {
-    for (Partition &part : partitions)
-      part.buildId->writeBuildId(config->buildIdVector);
-    return;
-  }
-
-  // Compute a hash of all sections of the output file.
-  size_t hashSize = mainPart->buildId->hashSize;
-  std::vector<uint8_t> buildId(hashSize);
-  llvm::ArrayRef<uint8_t> buf{Out::bufferStart, size_t(fileSize)};
+void elf::releaseOutputPages(uint64_t offset, uint64_t size) {
+  if (config->streamOutput && size)
+    errorHandler().outputBuffer->releasePages(offset, size);
+}
 
+void elf::computeBuildId(MutableArrayRef<uint8_t> buildId,
+                         ArrayRef<uint8_t> buf) {
+  size_t hashSize = buildId.size();
   switch (config->buildId) {
   case BuildIdKind::Fast:
     computeHash(buildId, buf, [](uint8_t *dest, ArrayRef<uint8_t> arr) {
-      write64le(dest, xxHash64(arr));
+      write64le(dest, xxh3_64bits(arr));
     });
     break;
   case BuildIdKind::Md5:
@@ -2951,6 +2956,21 @@ template <class ELFT> void Writer<ELFT>::writeBuildId() {
   default:
     llvm_unreachable("unknown BuildIdKind");
   }
+}
+
+template <class ELFT> void Writer<ELFT>::writeBuildId() {
+  if (!mainPart->buildId || !mainPart->buildId->getParent())
+    return;
+
+  if (config->buildId == BuildIdKind::Hexstring) {
+    for (Partition &part : partitions)
+      part.buildId->writeBuildId(config->buildIdVector);
+    return;
+  }
+
+  // Compute a hash of all sections of the output file.
+  std::vector<uint8_t> buildId(mainPart->buildId->hashSize);
+  computeBuildId(buildId, {Out::bufferStart, size_t(fileSize)});
   for (Partition &part : partitions)
     part.buildId->writeBuildId(buildId);
 }
@@ -25,6 +25,14 @@ template <class ELFT> void createSyntheticSections();
 void combineEhSections();
 template <class ELFT> void writeResult();
 
+// With --stream-output, writes back [offset, offset + size) of the output
+// buffer to the file and releases the memory that holds it.
+void releaseOutputPages(uint64_t offset, uint64_t size);
+
+// Computes the --build-id hash of the output file contents \p buf.
+void computeBuildId(llvm::MutableArrayRef<uint8_t> buildId,
+                    llvm::ArrayRef<uint8_t> buf);
+
 // This describes a program header entry.
 // Each contains type, access flags and range of output sections that will be
 // placed in it.
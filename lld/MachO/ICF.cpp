@@ -23,24 +23,26 @@ using namespace lld::macho;
 
 class ICF {
 public:
-  ICF(std::vector<ConcatInputSection *> &inputs);
+  ICF(std::vector<ConcatInputSection *> &inputs, uint64_t eqClassBase);
 
   void run();
-  void segregate(size_t begin, size_t end,
-                 std::function<bool(const ConcatInputSection *,
-                                    const ConcatInputSection *)>
-                     equals);
+  void segregate(size_t begin, size_t end, bool constant);
   size_t findBoundary(size_t begin, size_t end);
   void forEachClassRange(size_t begin, size_t end,
-                         std::function<void(size_t, size_t)> func);
-  void forEachClass(std::function<void(size_t, size_t)> func);
+                         llvm::function_ref<void(size_t, size_t)> func);
+  void forEachClass(llvm::function_ref<void(size_t, size_t)> func);
 
   // ICF needs a copy of the inputs vector because its equivalence-class
   // segregation algorithm destroys the proper sequence.
   std::vector<ConcatInputSection *> icfInputs;
+
+  // Equivalence-class IDs assigned by segregate() are offset by eqClassBase
+  // so that they never collide with the unique IDs of ineligible sections.
+  uint64_t eqClassBase;
 };
 
-ICF::ICF(std::vector<ConcatInputSection *> &inputs) {
+ICF::ICF(std::vector<ConcatInputSection *> &inputs, uint64_t eqClassBase)
+    : eqClassBase(eqClassBase) {
   icfInputs.assign(inputs.begin(), inputs.end());
 }
 
@@ -219,7 +221,7 @@ size_t ICF::findBoundary(size_t begin, size_t end) {
 
 // Invoke FUNC on subranges with matching equivalence class
 void ICF::forEachClassRange(size_t begin, size_t end,
-                            std::function<void(size_t, size_t)> func) {
+                            llvm::function_ref<void(size_t, size_t)> func) {
   while (begin < end) {
     size_t mid = findBoundary(begin, end);
     func(begin, mid);
@@ -229,10 +231,11 @@ void ICF::forEachClassRange(size_t begin, size_t end,
 
 // Split icfInputs into shards, then parallelize invocation of FUNC on subranges
 // with matching equivalence class
-void ICF::forEachClass(std::function<void(size_t, size_t)> func) {
+void ICF::forEachClass(llvm::function_ref<void(size_t, size_t)> func) {
   // Only use threads when the benefits outweigh the overhead.
   const size_t threadingThreshold = 1024;
-  if (icfInputs.size() < threadingThreshold) {
+  if (parallel::strategy.ThreadsRequested == 1 ||
+      icfInputs.size() < threadingThreshold) {
     forEachClassRange(0, icfInputs.size(), func);
     ++icfPass;
     return;
@@ -285,19 +288,25 @@ void ICF::run() {
     });
   }
 
-  llvm::stable_sort(
-      icfInputs, [](const ConcatInputSection *a, const ConcatInputSection *b) {
-        return a->icfEqClass[0] < b->icfEqClass[0];
-      });
+  // Group sections by hash. icfEqClass[1] is not read again before segregate()
+  // overwrites it, so we use it to break ties by the original position. This
+  // gives the same order as a stable sort, but lets us sort in parallel.
+  for (size_t i = 0, e = icfInputs.size(); i != e; ++i)
+    icfInputs[i]->icfEqClass[1] = i;
+  parallelSort(icfInputs,
+               [](const ConcatInputSection *a, const ConcatInputSection *b) {
+                 if (a->icfEqClass[0] != b->icfEqClass[0])
+                   return a->icfEqClass[0] < b->icfEqClass[0];
+                 return a->icfEqClass[1] < b->icfEqClass[1];
+               });
   forEachClass(
-      [&](size_t begin, size_t end) { segregate(begin, end, equalsConstant); });
+      [&](size_t begin, size_t end) { segregate(begin, end, true); });
 
   // Split equivalence groups by comparing relocations until convergence
   do {
     icfRepeat = false;
-    forEachClass([&](size_t begin, size_t end) {
-      segregate(begin, end, equalsVariable);
-    });
+    forEachClass(
+        [&](size_t begin, size_t end) { segregate(begin, end, false); });
   } while (icfRepeat);
   log("ICF needed " + Twine(icfPass) + " iterations");
 
@@ -312,24 +321,24 @@ void ICF::run() {
 }
 
 // Split an equivalence class into smaller classes.
-void ICF::segregate(
-    size_t begin, size_t end,
-    std::function<bool(const ConcatInputSection *, const ConcatInputSection *)>
-        equals) {
+void ICF::segregate(size_t begin, size_t end, bool constant) {
   while (begin < end) {
     // Divide [begin, end) into two. Let mid be the start index of the
     // second group.
-    auto bound = std::stable_partition(icfInputs.begin() + begin + 1,
-                                       icfInputs.begin() + end,
-                                       [&](ConcatInputSection *isec) {
-                                         return equals(icfInputs[begin], isec);
-                                       });
+    auto bound = std::stable_partition(
+        icfInputs.begin() + begin + 1, icfInputs.begin() + end,
+        [&](ConcatInputSection *isec) {
+          if (constant)
+            return equalsConstant(icfInputs[begin], isec);
+          return equalsVariable(icfInputs[begin], isec);
+        });
     size_t mid = bound - icfInputs.begin();
 
-    // Split [begin, end) into [begin, mid) and [mid, end). We use mid as an
-    // equivalence class ID because every group ends with a unique index.
+    // Split [begin, end) into [begin, mid) and [mid, end). We use mid as the
+    // basis for the equivalence class ID because every group ends with a
+    // unique index.
     for (size_t i = begin; i < mid; ++i)
-      icfInputs[i]->icfEqClass[(icfPass + 1) % 2] = mid;
+      icfInputs[i]->icfEqClass[(icfPass + 1) % 2] = eqClassBase + mid;
 
     // If we created a group, we need to iterate the main loop again.
     if (mid != end)
@@ -367,12 +376,14 @@ void macho::foldIdenticalSections() {
         if (d->unwindEntry)
           hashable.push_back(d->unwindEntry);
     } else {
-      isec->icfEqClass[0] = ++icfUniqueID;
+      // Both slots are set, since the hash propagation and equalsVariable()
+      // read the slot of the current pass from referenced sections.
+      isec->icfEqClass[0] = isec->icfEqClass[1] = ++icfUniqueID;
     }
   }
   parallelForEach(hashable,
                   [](ConcatInputSection *isec) { isec->hashForICF(); });
   // Now that every input section is either hashed or marked as unique, run the
   // segregation algorithm to detect foldable subsections.
-  ICF(hashable).run();
+  ICF(hashable, icfUniqueID + 1).run();
 }
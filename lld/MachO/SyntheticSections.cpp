@@ -23,6 +23,7 @@
 #include "llvm/Support/EndianStream.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/LEB128.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SHA256.h"
 
@@ -1186,20 +1187,15 @@ uint64_t CodeSignatureSection::getRawSize() const {
 void CodeSignatureSection::writeHashes(uint8_t *buf) const {
   // NOTE: Changes to this functionality should be repeated in llvm-objcopy's
   // MachOWriter::writeSignatureData.
-  uint8_t *code = buf;
-  uint8_t *codeEnd = buf + fileOff;
-  uint8_t *hashes = codeEnd + allHeadersSize;
-  while (code < codeEnd) {
-    StringRef block(reinterpret_cast<char *>(code),
-                    std::min(codeEnd - code, static_cast<ssize_t>(blockSize)));
-    SHA256 hasher;
-    hasher.update(block);
-    StringRef hash = hasher.final();
-    assert(hash.size() == hashSize);
-    memcpy(hashes, hash.data(), hashSize);
-    code += blockSize;
-    hashes += hashSize;
-  }
+  uint8_t *hashes = buf + fileOff + allHeadersSize;
+  // Each page is hashed independently, so hash them in parallel.
+  parallelForEachN(0, getBlockCount(), [&](size_t i) {
+    uint64_t offset = i * blockSize;
+    ArrayRef<uint8_t> block(buf + offset,
+                            std::min<uint64_t>(fileOff - offset, blockSize));
+    std::array<uint8_t, hashSize> hash = SHA256::hash(block);
+    memcpy(hashes + i * hashSize, hash.data(), hashSize);
+  });
 #if defined(__APPLE__)
   // This is macOS-specific work-around and makes no sense for any
   // other host OS. See https://openradar.appspot.com/FB8914231
@@ -1376,21 +1372,58 @@ void CStringSection::finalizeContents() {
 // deduplication of differently-aligned strings.  Finally, the overhead is not
 // huge: using 16-byte alignment (vs no alignment) is only a 0.5% size overhead
 // when linking chromium_framework on x86_64.
-DeduplicatedCStringSection::DeduplicatedCStringSection()
-    : builder(StringTableBuilder::RAW, /*Alignment=*/16) {}
+DeduplicatedCStringSection::DeduplicatedCStringSection() {
+  for (size_t i = 0; i < numShards; ++i)
+    shards.emplace_back(StringTableBuilder::RAW, /*Alignment=*/16);
+}
 
 void DeduplicatedCStringSection::finalizeContents() {
-  // Add all string pieces to the string table builder to create section
-  // contents.
-  for (CStringInputSection *isec : inputs) {
-    for (size_t i = 0, e = isec->pieces.size(); i != e; ++i)
-      if (isec->pieces[i].live)
-        isec->pieces[i].outSecOff =
-            builder.add(isec->getCachedHashStringRef(i));
-    isec->isFinal = true;
+  // Add all string pieces to the string table builders to create section
+  // contents. Each thread visits every piece but only adds the ones that
+  // belong to its own shards, so no locking is needed.
+  size_t concurrency = PowerOf2Floor(
+      std::min<size_t>(hardware_concurrency(parallel::strategy.ThreadsRequested)
+                           .compute_thread_count(),
+                       numShards));
+  parallelForEachN(0, concurrency, [&](size_t threadId) {
+    for (CStringInputSection *isec : inputs) {
+      for (size_t i = 0, e = isec->pieces.size(); i != e; ++i) {
+        StringPiece &piece = isec->pieces[i];
+        if (!piece.live)
+          continue;
+        size_t shardId = getShardId(piece.hash);
+        if ((shardId & (concurrency - 1)) == threadId)
+          piece.outSecOff =
+              shards[shardId].add(isec->getCachedHashStringRef(i));
+      }
+    }
+  });
+
+  // Lay out the shards one after another.
+  uint64_t off = 0;
+  for (size_t i = 0; i < numShards; ++i) {
+    shards[i].finalizeInOrder();
+    if (shards[i].getSize() > 0)
+      off = alignTo(off, 16);
+    shardOffsets[i] = off;
+    off += shards[i].getSize();
   }
+  size = off;
+
+  // Piece offsets are relative to their shard so far; make them relative to
+  // the section.
+  parallelForEach(inputs, [&](CStringInputSection *isec) {
+    for (StringPiece &piece : isec->pieces)
+      if (piece.live)
+        piece.outSecOff += shardOffsets[getShardId(piece.hash)];
+    isec->isFinal = true;
+  });
+}
 
-  builder.finalizeInOrder();
+void DeduplicatedCStringSection::writeTo(uint8_t *buf) const {
+  parallelForEachN(0, numShards, [&](size_t i) {
+    shards[i].write(buf + shardOffsets[i]);
+  });
 }
 
 // This section is actually emitted as __TEXT,__const by ld64, but clang may
@@ -529,12 +529,24 @@ private:
 class DeduplicatedCStringSection final : public CStringSection {
 public:
   DeduplicatedCStringSection();
-  uint64_t getSize() const override { return builder.getSize(); }
+  uint64_t getSize() const override { return size; }
   void finalizeContents() override;
-  void writeTo(uint8_t *buf) const override { builder.write(buf); }
+  void writeTo(uint8_t *buf) const override;
 
 private:
-  llvm::StringTableBuilder builder;
+  // Strings are split into shards by hash so that they can be deduplicated
+  // in parallel, as in ELF's MergeNoTailSection.
+  static constexpr size_t numShards = 32;
+
+  // StringPiece::hash has 31 significant bits; use the top bits to pick a
+  // shard.
+  static size_t getShardId(uint32_t hash) {
+    return hash >> (31 - llvm::countTrailingZeros(numShards));
+  }
+
+  llvm::SmallVector<llvm::StringTableBuilder, 0> shards;
+  uint64_t shardOffsets[numShards];
+  uint64_t size = 0;
 };
 
 /*
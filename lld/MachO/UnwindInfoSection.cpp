@@ -136,10 +136,12 @@ private:
   std::vector<Ptr> personalities;
   SmallDenseMap<std::pair<InputSection *, uint64_t /* addend */>, Symbol *>
       personalityTable;
+  // The LSDA relocation of each entry in cuEntries, or null if it has none.
+  std::vector<Reloc *> lsdaRelocs;
   // Indices into cuEntries for CUEs with a non-null LSDA.
   std::vector<size_t> entriesWithLsda;
-  // Map of cuEntries index to an index within the LSDA array.
-  DenseMap<size_t, uint32_t> lsdaIndex;
+  // Map of cuIndices index to an index within the LSDA array.
+  std::vector<uint32_t> lsdaIndex;
   std::vector<SecondLevelPage> secondLevelPages;
   uint64_t level2PagesOffset = 0;
 };
@@ -411,51 +413,58 @@ template <class Ptr> void UnwindInfoSectionImpl<Ptr>::finalize() {
   symbolsVec = symbols.takeVector();
   relocateCompactUnwind(cuEntries);
 
+  // The LSDA relocations are needed for folding and for the LSDA index, so
+  // look them up once.
+  lsdaRelocs.resize(cuEntries.size());
+  parallelForEachN(0, symbolsVec.size(), [&](size_t i) {
+    lsdaRelocs[i] = findLsdaReloc(symbolsVec[i].second->unwindEntry);
+  });
+
   // Rather than sort & fold the 32-byte entries directly, we create a
-  // vector of indices to entries and sort & fold that instead.
+  // vector of indices to entries and sort & fold that instead. Ties are
+  // broken by index to keep the output deterministic.
   cuIndices.resize(cuEntries.size());
   std::iota(cuIndices.begin(), cuIndices.end(), 0);
-  llvm::sort(cuIndices, [&](size_t a, size_t b) {
-    return cuEntries[a].functionAddress < cuEntries[b].functionAddress;
+  parallelSort(cuIndices, [&](size_t a, size_t b) {
+    if (cuEntries[a].functionAddress != cuEntries[b].functionAddress)
+      return cuEntries[a].functionAddress < cuEntries[b].functionAddress;
+    return a < b;
   });
 
-  // Fold adjacent entries with matching encoding+personality+lsda
-  // We use three iterators on the same cuIndices to fold in-situ:
-  // (1) `foldBegin` is the first of a potential sequence of matching entries
-  // (2) `foldEnd` is the first non-matching entry after `foldBegin`.
-  // The semi-open interval [ foldBegin .. foldEnd ) contains a range
-  // entries that can be folded into a single entry and written to ...
-  // (3) `foldWrite`
-  auto foldWrite = cuIndices.begin();
-  for (auto foldBegin = cuIndices.begin(); foldBegin < cuIndices.end();) {
-    auto foldEnd = foldBegin;
-    while (++foldEnd < cuIndices.end() &&
-           cuEntries[*foldBegin].encoding == cuEntries[*foldEnd].encoding &&
-           cuEntries[*foldBegin].personality ==
-               cuEntries[*foldEnd].personality &&
-           canFoldEncoding(cuEntries[*foldEnd].encoding)) {
-      // In most cases, we can just compare the values of cuEntries[*].lsda.
-      // However, it is possible for -rename_section to cause the LSDA section
-      // (__gcc_except_tab) to be finalized after the unwind info section. In
-      // that case, we don't yet have unique addresses for the LSDA entries.
-      // So we check their relocations instead.
-      // FIXME: should we account for an LSDA at an absolute address? ld64 seems
-      // to support it, but it seems unlikely to be used in practice.
-      Reloc *lsda1 = findLsdaReloc(symbolsVec[*foldBegin].second->unwindEntry);
-      Reloc *lsda2 = findLsdaReloc(symbolsVec[*foldEnd].second->unwindEntry);
-      if (lsda1 == nullptr && lsda2 == nullptr)
-        continue;
-      if (lsda1 == nullptr || lsda2 == nullptr)
-        break;
-      if (lsda1->referent != lsda2->referent)
-        break;
-      if (lsda1->addend != lsda2->addend)
-        break;
-    }
-    *foldWrite++ = *foldBegin;
-    foldBegin = foldEnd;
-  }
-  cuIndices.erase(foldWrite, cuIndices.end());
+  // Fold adjacent entries with matching encoding+personality+lsda.
+  //
+  // In most cases, we can just compare the values of cuEntries[*].lsda.
+  // However, it is possible for -rename_section to cause the LSDA section
+  // (__gcc_except_tab) to be finalized after the unwind info section. In
+  // that case, we don't yet have unique addresses for the LSDA entries.
+  // So we check their relocations instead.
+  // FIXME: should we account for an LSDA at an absolute address? ld64 seems
+  // to support it, but it seems unlikely to be used in practice.
+  //
+  // Matching is an equivalence relation, so an entry matches the first entry
+  // of its run iff it matches its predecessor. That lets us compare all
+  // adjacent pairs in parallel and then compact the vector in one pass.
+  auto canFold = [&](size_t prev, size_t cur) {
+    if (cuEntries[prev].encoding != cuEntries[cur].encoding ||
+        cuEntries[prev].personality != cuEntries[cur].personality ||
+        !canFoldEncoding(cuEntries[cur].encoding))
+      return false;
+    Reloc *lsda1 = lsdaRelocs[prev];
+    Reloc *lsda2 = lsdaRelocs[cur];
+    if (lsda1 == nullptr || lsda2 == nullptr)
+      return lsda1 == lsda2;
+    return lsda1->referent == lsda2->referent &&
+           lsda1->addend == lsda2->addend;
+  };
+  std::vector<uint8_t> folded(cuIndices.size());
+  parallelForEachN(1, cuIndices.size(), [&](size_t i) {
+    folded[i] = canFold(cuIndices[i - 1], cuIndices[i]);
+  });
+  size_t numFolded = 0;
+  for (size_t i = 0, e = cuIndices.size(); i != e; ++i)
+    if (!folded[i])
+      cuIndices[numFolded++] = cuIndices[i];
+  cuIndices.resize(numFolded);
 
   encodePersonalities();
 
@@ -542,11 +551,11 @@ template <class Ptr> void UnwindInfoSectionImpl<Ptr>::finalize() {
     }
   }
 
-  for (size_t idx : cuIndices) {
-    lsdaIndex[idx] = entriesWithLsda.size();
-    const Defined *d = symbolsVec[idx].second;
-    if (findLsdaReloc(d->unwindEntry))
-      entriesWithLsda.push_back(idx);
+  lsdaIndex.resize(cuIndices.size());
+  for (size_t i = 0, e = cuIndices.size(); i != e; ++i) {
+    lsdaIndex[i] = entriesWithLsda.size();
+    if (lsdaRelocs[cuIndices[i]])
+      entriesWithLsda.push_back(cuIndices[i]);
   }
 
   // compute size of __TEXT,__unwind_info section
@@ -602,7 +611,7 @@ void UnwindInfoSectionImpl<Ptr>::writeTo(uint8_t *buf) const {
     iep->functionOffset = cuEntries[idx].functionAddress - in.header->addr;
     iep->secondLevelPagesSectionOffset = l2PagesOffset;
     iep->lsdaIndexArraySectionOffset =
-        lsdaOffset + lsdaIndex.lookup(idx) *
+        lsdaOffset + lsdaIndex[page.entryIndex] *
                          sizeof(unwind_info_section_header_lsda_index_entry);
     iep++;
     l2PagesOffset += SECOND_LEVEL_PAGE_BYTES;
@@ -620,26 +629,27 @@ void UnwindInfoSectionImpl<Ptr>::writeTo(uint8_t *buf) const {
   // LSDAs
   auto *lep =
       reinterpret_cast<unwind_info_section_header_lsda_index_entry *>(iep);
-  for (size_t idx : entriesWithLsda) {
+  parallelForEachN(0, entriesWithLsda.size(), [&](size_t i) {
+    size_t idx = entriesWithLsda[i];
     const CompactUnwindEntry<Ptr> &cu = cuEntries[idx];
-    const Defined *d = symbolsVec[idx].second;
-    if (Reloc *r = findLsdaReloc(d->unwindEntry)) {
-      uint64_t va;
-      if (auto *isec = r->referent.dyn_cast<InputSection *>()) {
-        va = isec->getVA(r->addend);
-      } else {
-        auto *sym = r->referent.get<Symbol *>();
-        va = sym->getVA() + r->addend;
-      }
-      lep->lsdaOffset = va - in.header->addr;
+    Reloc *r = lsdaRelocs[idx];
+    uint64_t va;
+    if (auto *isec = r->referent.dyn_cast<InputSection *>()) {
+      va = isec->getVA(r->addend);
+    } else {
+      auto *sym = r->referent.get<Symbol *>();
+      va = sym->getVA() + r->addend;
     }
-    lep->functionOffset = cu.functionAddress - in.header->addr;
-    lep++;
-  }
+    lep[i].lsdaOffset = va - in.header->addr;
+    lep[i].functionOffset = cu.functionAddress - in.header->addr;
+  });
 
-  // Level-2 pages
-  auto *pp = reinterpret_cast<uint32_t *>(lep);
-  for (const SecondLevelPage &page : secondLevelPages) {
+  // Level-2 pages. Each page has a fixed size, so they are written in
+  // parallel.
+  auto *pages = reinterpret_cast<uint32_t *>(lep + entriesWithLsda.size());
+  parallelForEachN(0, secondLevelPages.size(), [&](size_t pageIdx) {
+    const SecondLevelPage &page = secondLevelPages[pageIdx];
+    uint32_t *pp = pages + pageIdx * SECOND_LEVEL_PAGE_WORDS;
     if (page.kind == UNWIND_SECOND_LEVEL_COMPRESSED) {
       uintptr_t functionAddressBase =
           cuEntries[cuIndices[page.entryIndex]].functionAddress;
@@ -681,8 +691,7 @@ void UnwindInfoSectionImpl<Ptr>::writeTo(uint8_t *buf) const {
         *ep++ = cue.encoding;
       }
     }
-    pp += SECOND_LEVEL_PAGE_WORDS;
-  }
+  });
 }
 
 UnwindInfoSection *macho::makeUnwindInfoSection() {
@@ -22,6 +22,7 @@
 #define LLD_COMMON_MEMORY_H
 
 #include "llvm/Support/Allocator.h"
+#include "llvm/Support/PerThreadAllocator.h"
 #include "llvm/Support/StringSaver.h"
 #include <vector>
 
@@ -31,12 +32,15 @@ namespace lld {
 extern llvm::BumpPtrAllocator bAlloc;
 extern llvm::StringSaver saver;
 
+// Use this arena instead of bAlloc if you allocate from more than one thread.
+extern llvm::ConcurrentBumpPtrAllocator cbAlloc;
+
 void freeArena();
 
 // These two classes are hack to keep track of all
 // SpecificBumpPtrAllocator instances.
 struct SpecificAllocBase {
-  SpecificAllocBase() { instances.push_back(this); }
+  SpecificAllocBase();
   virtual ~SpecificAllocBase() = default;
   virtual void reset() = 0;
   static std::vector<SpecificAllocBase *> instances;
@@ -44,20 +48,22 @@ struct SpecificAllocBase {
 
 template <class T> struct SpecificAlloc : public SpecificAllocBase {
   void reset() override { alloc.DestroyAll(); }
-  llvm::SpecificBumpPtrAllocator<T> alloc;
+  llvm::ConcurrentSpecificBumpPtrAllocator<T> alloc;
 };
 
 // Use a static local for these singletons so they are only registered if an
 // object of this instance is ever constructed. Otherwise we will create and
 // register ELF allocators for COFF and the reverse.
 template <typename T>
-inline llvm::SpecificBumpPtrAllocator<T> &getSpecificAllocSingleton() {
+inline llvm::ConcurrentSpecificBumpPtrAllocator<T> &
+getSpecificAllocSingleton() {
   static SpecificAlloc<T> instance;
   return instance.alloc;
 }
 
 // Use this arena if your object has a destructor.
-// Your destructor will be invoked from freeArena().
+// Your destructor will be invoked from freeArena(). It is safe to call make()
+// from multiple threads.
 template <typename T, typename... U> T *make(U &&... args) {
   return new (getSpecificAllocSingleton<T>().Allocate())
       T(std::forward<U>(args)...);
@@ -523,6 +523,31 @@ public:
   SBSymbolContext ResolveSymbolContextForAddress(const SBAddress &addr,
                                                  uint32_t resolve_scope);
 
+  /// Resolve many load addresses into symbol contexts at once.
+  ///
+  /// This is much faster than calling ResolveLoadAddress() and
+  /// ResolveSymbolContextForAddress() for each address when symbolicating
+  /// many backtraces, because addresses in different modules are resolved in
+  /// parallel.
+  ///
+  /// \param[in] array
+  ///     The load addresses to resolve.
+  ///
+  /// \param[in] array_len
+  ///     The number of addresses in \a array.
+  ///
+  /// \param[in] resolve_scope
+  ///     The parts of the symbol contexts to fill in, a combination of
+  ///     lldb::SymbolContextItem values.
+  ///
+  /// \return
+  ///     A list with one symbol context for each address, in the same
+  ///     order. Addresses that are not in a module get a symbol context
+  ///     with only the target set.
+  lldb::SBSymbolContextList
+  ResolveSymbolContextsForLoadAddresses(uint64_t *array, size_t array_len,
+                                        uint32_t resolve_scope);
+
   /// Read target memory. If a target process is running then memory
   /// is read from here. Otherwise the memory is read from the object
   /// files. For a target whose bytes are sized as a multiple of host
@@ -353,6 +353,12 @@ private:
                                 /// multiple processes.
   size_t m_condition_hash; ///< For testing whether the condition source code
                            ///changed.
+  struct SimpleCondition;
+  std::unique_ptr<SimpleCondition>
+      m_simple_condition_up; ///< The condition, if it is simple enough to be
+                             /// evaluated without the expression parser.
+  size_t m_simple_condition_hash; ///< The hash of the condition source code
+                                  /// m_simple_condition_up was parsed from.
   lldb::break_id_t m_loc_id; ///< Breakpoint location ID.
   StoppointHitCounter m_hit_counter; ///< Number of times this breakpoint
                                      /// location has been hit.
@@ -339,10 +339,24 @@ private:
   void SymbolIndicesToSymbolContextList(std::vector<uint32_t> &symbol_indexes,
                                         SymbolContextList &sc_list);
 
+  /// The parts of a demangled function name that the name indexes use.
+  struct DemangledFunctionName {
+    /// The base name, or empty if the symbol is not a function with one.
+    ConstString base_name;
+    /// The declaration context from ConstString::GetCString(), or null if the
+    /// function has none.
+    const char *decl_context = nullptr;
+    bool is_ctor_or_dtor = false;
+  };
+
+  /// Demangles the names of all symbols for InitNameIndexes, in parallel for
+  /// large symbol tables. Returns the function name parts for each symbol.
+  std::vector<DemangledFunctionName> DemangleSymbolNames();
+
   void RegisterMangledNameEntry(
-      uint32_t value, std::set<const char *> &class_contexts,
-      std::vector<std::pair<NameToIndexMap::Entry, const char *>> &backlog,
-      RichManglingContext &rmc);
+      uint32_t value, const DemangledFunctionName &name,
+      std::set<const char *> &class_contexts,
+      std::vector<std::pair<NameToIndexMap::Entry, const char *>> &backlog);
 
   void RegisterBacklogEntry(const NameToIndexMap::Entry &entry,
                             const char *decl_context,
@@ -57,8 +57,17 @@ protected:
   InvalidRanges m_invalid_ranges;
   Process &m_process;
   uint32_t m_L2_cache_line_byte_size;
+  // The address at which the next L2 cache miss continues the previous one.
+  lldb::addr_t m_next_sequential_miss = LLDB_INVALID_ADDRESS;
+  // How many L2 cache lines the next sequential miss reads at once.
+  uint32_t m_prefetch_line_count = 1;
 
 private:
+  // Called on an L2 cache miss at the start of a cache line. If the misses
+  // are sequential, reads several cache lines with a single read from the
+  // process. Returns true if the line at line_addr was added to the cache.
+  bool PrefetchCacheLines(lldb::addr_t line_addr);
+
   MemoryCache(const MemoryCache &) = delete;
   const MemoryCache &operator=(const MemoryCache &) = delete;
 };
@@ -96,6 +96,8 @@ public:
 
   void SetPreloadSymbols(bool b);
 
+  bool GetParallelModuleLoad() const;
+
   bool GetDisableASLR() const;
 
   void SetDisableASLR(bool b);
@@ -1137,6 +1139,26 @@ public:
   bool ResolveLoadAddress(lldb::addr_t load_addr, Address &so_addr,
                           uint32_t stop_id = SectionLoadHistory::eStopIDNow);
 
+  /// Resolve many load addresses into symbol contexts at once.
+  ///
+  /// Addresses are grouped by the module that contains them, and the groups
+  /// are resolved in parallel. Each module is only locked by the one thread
+  /// resolving its addresses.
+  ///
+  /// \param[in] load_addrs
+  ///     The load addresses to resolve.
+  ///
+  /// \param[in] resolve_scope
+  ///     The parts of the symbol contexts to fill in.
+  ///
+  /// \param[out] sc_list
+  ///     Gets one symbol context appended for each address, in the order of
+  ///     \a load_addrs. Addresses that are not in a module get a symbol
+  ///     context with only the target set.
+  void ResolveSymbolContextsForLoadAddresses(
+      llvm::ArrayRef<lldb::addr_t> load_addrs,
+      lldb::SymbolContextItem resolve_scope, SymbolContextList &sc_list);
+
   bool SetSectionLoadAddress(const lldb::SectionSP &section,
                              lldb::addr_t load_addr,
                              bool warn_multiple = false);
@@ -471,6 +471,8 @@ public:
 
   void Clear() { m_entries.clear(); }
 
+  void Reserve(typename Collection::size_type size) { m_entries.reserve(size); }
+
   bool IsEmpty() const { return m_entries.empty(); }
 
   size_t GetSize() const { return m_entries.size(); }
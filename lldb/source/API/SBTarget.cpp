@@ -681,6 +681,26 @@ SBTarget::ResolveSymbolContextForAddress(const SBAddress &addr,
   return sc;
 }
 
+SBSymbolContextList
+SBTarget::ResolveSymbolContextsForLoadAddresses(uint64_t *array,
+                                               size_t array_len,
+                                               uint32_t resolve_scope) {
+  LLDB_RECORD_METHOD(lldb::SBSymbolContextList, SBTarget,
+                     ResolveSymbolContextsForLoadAddresses,
+                     (uint64_t *, size_t, uint32_t), array, array_len,
+                     resolve_scope);
+
+  SBSymbolContextList sb_sc_list;
+  TargetSP target_sp(GetSP());
+  if (target_sp && array && array_len) {
+    std::lock_guard<std::recursive_mutex> guard(target_sp->GetAPIMutex());
+    target_sp->ResolveSymbolContextsForLoadAddresses(
+        llvm::makeArrayRef(array, array_len),
+        static_cast<SymbolContextItem>(resolve_scope), *sb_sc_list);
+  }
+  return sb_sc_list;
+}
+
 size_t SBTarget::ReadMemory(const SBAddress addr, void *buf, size_t size,
                             lldb::SBError &error) {
   LLDB_RECORD_METHOD(size_t, SBTarget, ReadMemory,
@@ -18,12 +18,18 @@
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Symbol/Symbol.h"
 #include "lldb/Symbol/TypeSystem.h"
+#include "lldb/Target/Language.h"
 #include "lldb/Target/Process.h"
+#include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/StackFrame.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Target/ThreadSpec.h"
 #include "lldb/Utility/Log.h"
+#include "lldb/Utility/RegisterValue.h"
 #include "lldb/Utility/StreamString.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -34,7 +40,8 @@ BreakpointLocation::BreakpointLocation(break_id_t loc_id, Breakpoint &owner,
     : m_being_created(true), m_should_resolve_indirect_functions(false),
       m_is_reexported(false), m_is_indirect(false), m_address(addr),
       m_owner(owner), m_options_up(), m_bp_site_sp(), m_condition_mutex(),
-      m_condition_hash(0), m_loc_id(loc_id), m_hit_counter() {
+      m_condition_hash(0), m_simple_condition_hash(0), m_loc_id(loc_id),
+      m_hit_counter() {
   if (check_for_resolver) {
     Symbol *symbol = m_address.CalculateSymbolContextSymbol();
     if (symbol && symbol->IsIndirect()) {
@@ -231,6 +238,216 @@ const char *BreakpointLocation::GetConditionText(size_t *hash) const {
       .GetConditionText(hash);
 }
 
+/// A condition of the form "<lhs> <op> <integer>" that can be evaluated by
+/// reading a variable or a register of the stopped frame, without going
+/// through the expression parser. <lhs> is either "$<register>" or a path of
+/// member accesses and constant subscripts starting at a variable, and <op>
+/// is one of the C comparison operators.
+///
+/// Evaluating a condition through a UserExpression materializes its
+/// variables and runs the IR interpreter or the JIT on every hit, which
+/// dominates the cost of a conditional breakpoint that is hit often. Conditions
+/// this simple make up most of them in practice.
+///
+/// The constant is restricted to the range of int, and a negative constant
+/// to signed operands, so that comparing the values numerically gives the same
+/// result as the usual arithmetic conversions of C. Anything that is not
+/// understood here falls back to the expression parser.
+struct BreakpointLocation::SimpleCondition {
+  enum class Op { EQ, NE, LT, LE, GT, GE };
+
+  std::string lhs;
+  bool is_register = false;
+  Op op = Op::EQ;
+  int64_t rhs = 0;
+
+  static std::unique_ptr<SimpleCondition> Parse(llvm::StringRef text);
+
+  /// Returns the value of the condition, or None if it cannot be evaluated
+  /// here and the expression parser should be used instead.
+  llvm::Optional<bool> Evaluate(ExecutionContext &exe_ctx) const;
+
+private:
+  bool Compare(int64_t value) const;
+  static bool IsVariablePath(llvm::StringRef path);
+};
+
+std::unique_ptr<BreakpointLocation::SimpleCondition>
+BreakpointLocation::SimpleCondition::Parse(llvm::StringRef text) {
+  text = text.trim();
+  // Find the comparison operator, skipping the "->" of member accesses.
+  size_t op_pos = 0;
+  while (op_pos < text.size() &&
+         !llvm::StringRef("=!<>").contains(text[op_pos]))
+    op_pos += text.substr(op_pos).startswith("->") ? 2 : 1;
+  if (op_pos == 0 || op_pos >= text.size())
+    return nullptr;
+
+  auto cond = std::make_unique<SimpleCondition>();
+  llvm::StringRef lhs = text.take_front(op_pos).rtrim();
+  llvm::StringRef rest = text.drop_front(op_pos);
+  if (rest.consume_front("=="))
+    cond->op = Op::EQ;
+  else if (rest.consume_front("!="))
+    cond->op = Op::NE;
+  else if (rest.consume_front("<="))
+    cond->op = Op::LE;
+  else if (rest.consume_front(">="))
+    cond->op = Op::GE;
+  else if (rest.consume_front("<"))
+    cond->op = Op::LT;
+  else if (rest.consume_front(">"))
+    cond->op = Op::GT;
+  else
+    return nullptr;
+
+  // Integer literals with a suffix or outside the range of int have a type
+  // other than int, which changes how C converts the operands.
+  llvm::StringRef rhs = rest.trim();
+  bool negative = rhs.consume_front("-");
+  uint64_t magnitude;
+  if (rhs.getAsInteger(0, magnitude))
+    return nullptr;
+  if (magnitude > (negative ? uint64_t(INT32_MAX) + 1 : uint64_t(INT32_MAX)))
+    return nullptr;
+  cond->rhs = negative ? -int64_t(magnitude) : int64_t(magnitude);
+
+  if (lhs.consume_front("$")) {
+    if (lhs.empty() || !llvm::all_of(lhs, [](char c) {
+          return llvm::isAlnum(c) || c == '_';
+        }))
+      return nullptr;
+    cond->is_register = true;
+  } else if (!IsVariablePath(lhs)) {
+    return nullptr;
+  }
+  cond->lhs = lhs.str();
+  return cond;
+}
+
+bool BreakpointLocation::SimpleCondition::IsVariablePath(llvm::StringRef path) {
+  auto consume_identifier = [&path]() {
+    if (path.empty() || !(llvm::isAlpha(path.front()) || path.front() == '_'))
+      return false;
+    path = path.drop_while([](char c) { return llvm::isAlnum(c) || c == '_'; });
+    return true;
+  };
+
+  if (!consume_identifier())
+    return false;
+  while (!path.empty()) {
+    if (path.consume_front(".") || path.consume_front("->")) {
+      if (!consume_identifier())
+        return false;
+    } else if (path.consume_front("[")) {
+      size_t digits = path.find_first_not_of("0123456789");
+      if (digits == 0 || digits == llvm::StringRef::npos ||
+          path[digits] != ']')
+        return false;
+      path = path.drop_front(digits + 1);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+llvm::Optional<bool>
+BreakpointLocation::SimpleCondition::Evaluate(ExecutionContext &exe_ctx) const {
+  StackFrame *frame = exe_ctx.GetFramePtr();
+  if (!frame)
+    return llvm::None;
+
+  if (is_register) {
+    RegisterContextSP reg_ctx_sp = frame->GetRegisterContext();
+    if (!reg_ctx_sp)
+      return llvm::None;
+    const RegisterInfo *reg_info = reg_ctx_sp->GetRegisterInfoByName(lhs);
+    if (!reg_info || reg_info->byte_size == 0 ||
+        reg_info->byte_size > sizeof(uint64_t))
+      return llvm::None;
+    RegisterValue reg_value;
+    if (!reg_ctx_sp->ReadRegister(reg_info, reg_value))
+      return llvm::None;
+    bool success = false;
+    if (reg_info->encoding == eEncodingSint) {
+      int64_t value = reg_value.GetAsUInt64(0, &success);
+      // Sign extend registers narrower than 64 bits.
+      unsigned shift = 64 - reg_info->byte_size * 8;
+      value = int64_t(uint64_t(value) << shift) >> shift;
+      return success ? llvm::Optional<bool>(Compare(value)) : llvm::None;
+    }
+    if (reg_info->encoding != eEncodingUint || rhs < 0)
+      return llvm::None;
+    uint64_t value = reg_value.GetAsUInt64(0, &success);
+    if (!success)
+      return llvm::None;
+    // Compare in the unsigned domain; rhs is known to be non-negative.
+    if (value > uint64_t(INT64_MAX))
+      return op == Op::NE || op == Op::GT || op == Op::GE;
+    return Compare(int64_t(value));
+  }
+
+  VariableSP var_sp;
+  Status error;
+  ValueObjectSP valobj_sp = frame->GetValueForVariableExpressionPath(
+      lhs, eNoDynamicValues,
+      StackFrame::eExpressionPathOptionCheckPtrVsMember |
+          StackFrame::eExpressionPathOptionsNoFragileObjcIvar |
+          StackFrame::eExpressionPathOptionsNoSyntheticChildren |
+          StackFrame::eExpressionPathOptionsNoSyntheticArrayRange,
+      var_sp, error);
+  if (!valobj_sp || error.Fail())
+    return llvm::None;
+
+  // Only plain integers and null pointer checks are handled here. Enums may be
+  // scoped and then cannot be compared with integers at all.
+  const uint32_t type_info = valobj_sp->GetCompilerType().GetTypeInfo();
+  bool success = false;
+  if (type_info & eTypeIsPointer) {
+    if (rhs != 0 || (op != Op::EQ && op != Op::NE))
+      return llvm::None;
+    uint64_t value = valobj_sp->GetValueAsUnsigned(0, &success);
+    return success ? llvm::Optional<bool>((value == 0) == (op == Op::EQ))
+                   : llvm::None;
+  }
+  if ((type_info & (eTypeIsScalar | eTypeIsInteger)) !=
+          (eTypeIsScalar | eTypeIsInteger) ||
+      (type_info & eTypeIsEnumeration))
+    return llvm::None;
+
+  if (type_info & eTypeIsSigned) {
+    int64_t value = valobj_sp->GetValueAsSigned(0, &success);
+    return success ? llvm::Optional<bool>(Compare(value)) : llvm::None;
+  }
+  if (rhs < 0)
+    return llvm::None;
+  uint64_t value = valobj_sp->GetValueAsUnsigned(0, &success);
+  if (!success)
+    return llvm::None;
+  if (value > uint64_t(INT64_MAX))
+    return op == Op::NE || op == Op::GT || op == Op::GE;
+  return Compare(int64_t(value));
+}
+
+bool BreakpointLocation::SimpleCondition::Compare(int64_t value) const {
+  switch (op) {
+  case Op::EQ:
+    return value == rhs;
+  case Op::NE:
+    return value != rhs;
+  case Op::LT:
+    return value < rhs;
+  case Op::LE:
+    return value <= rhs;
+  case Op::GT:
+    return value > rhs;
+  case Op::GE:
+    return value >= rhs;
+  }
+  llvm_unreachable("unhandled comparison operator");
+}
+
 bool BreakpointLocation::ConditionSaysStop(ExecutionContext &exe_ctx,
                                            Status &error) {
   Log *log = lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_BREAKPOINTS);
@@ -242,11 +459,35 @@ bool BreakpointLocation::ConditionSaysStop(ExecutionContext &exe_ctx,
 
   if (!condition_text) {
     m_user_expression_sp.reset();
+    m_simple_condition_up.reset();
     return false;
   }
 
   error.Clear();
 
+  if (condition_hash != m_simple_condition_hash) {
+    m_simple_condition_up.reset();
+    // Variable paths and registers mean the same thing in the expression
+    // parser only for the C family of languages.
+    CompileUnit *comp_unit = m_address.CalculateSymbolContextCompileUnit();
+    LanguageType language =
+        comp_unit ? comp_unit->GetLanguage() : eLanguageTypeUnknown;
+    if (language == eLanguageTypeUnknown ||
+        Language::LanguageIsCFamily(language))
+      m_simple_condition_up = SimpleCondition::Parse(condition_text);
+    m_simple_condition_hash = condition_hash;
+  }
+
+  if (m_simple_condition_up) {
+    if (llvm::Optional<bool> ret = m_simple_condition_up->Evaluate(exe_ctx)) {
+      LLDB_LOGF(log,
+                "Condition evaluated without the expression parser, result "
+                "is %s.\n",
+                *ret ? "true" : "false");
+      return *ret;
+    }
+  }
+
   DiagnosticManager diagnostics;
 
   if (condition_hash != m_condition_hash || !m_user_expression_sp ||
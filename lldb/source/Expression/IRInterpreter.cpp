@@ -196,6 +196,26 @@ public:
     return false;
   }
 
+  bool EvaluateFloatValue(APFloat &result, const Value *value,
+                          Module &module) {
+    lldb_private::Scalar scalar;
+
+    if (!EvaluateValue(scalar, value, module))
+      return false;
+
+    Type *type = value->getType();
+    result = APFloat(type->getFltSemantics(),
+                     scalar.UInt128(APInt()).zextOrTrunc(
+                         type->getPrimitiveSizeInBits()));
+    return true;
+  }
+
+  bool AssignFloatValue(const Value *value, const APFloat &result,
+                        Module &module) {
+    return AssignValue(value, lldb_private::Scalar(result.bitcastToAPInt()),
+                       module);
+  }
+
   bool AssignValue(const Value *value, lldb_private::Scalar scalar,
                    Module &module) {
     lldb::addr_t process_address = ResolveValue(value, module);
@@ -447,6 +467,24 @@ static const char *infinite_loop_error = "Interpreter ran for too many cycles";
 static const char *too_many_functions_error =
     "Interpreter doesn't handle modules with multiple function bodies.";
 
+// The interpreter computes in APFloat, and stores the values in memory with
+// the same size as their integer bit patterns, so it handles the IEEE types
+// that fit in 64 bits.
+static bool CanInterpretFloatingPoint(const llvm::Instruction &inst) {
+  auto is_supported = [](const Type *type) {
+    if (type->isFloatingPointTy())
+      return type->isHalfTy() || type->isFloatTy() || type->isDoubleTy();
+    return !type->isIntegerTy() || type->getPrimitiveSizeInBits() <= 64;
+  };
+
+  if (!is_supported(inst.getType()))
+    return false;
+  for (const Value *operand : inst.operand_values())
+    if (!is_supported(operand->getType()))
+      return false;
+  return true;
+}
+
 static bool CanResolveConstant(llvm::Constant *constant) {
   switch (constant->getValueID()) {
   default:
@@ -565,6 +603,26 @@ bool IRInterpreter::CanInterpret(llvm::Module &module, llvm::Function &function,
           break;
         }
       } break;
+      case Instruction::FAdd:
+      case Instruction::FCmp:
+      case Instruction::FDiv:
+      case Instruction::FMul:
+      case Instruction::FNeg:
+      case Instruction::FPExt:
+      case Instruction::FPToSI:
+      case Instruction::FPToUI:
+      case Instruction::FPTrunc:
+      case Instruction::FSub:
+      case Instruction::SIToFP:
+      case Instruction::UIToFP:
+        if (!CanInterpretFloatingPoint(ii)) {
+          LLDB_LOGF(log, "Unsupported floating-point type: %s",
+                    PrintValue(&ii).c_str());
+          error.SetErrorToGenericError();
+          error.SetErrorString(unsupported_operand_error);
+          return false;
+        }
+        break;
       case Instruction::And:
       case Instruction::AShr:
       case Instruction::IntToPtr:
@@ -1020,6 +1078,164 @@ bool IRInterpreter::Interpret(llvm::Module &module, llvm::Function &function,
         LLDB_LOGF(log, "  Poffset : %s", frame.SummarizeValue(inst).c_str());
       }
     } break;
+    case Instruction::FAdd:
+    case Instruction::FSub:
+    case Instruction::FMul:
+    case Instruction::FDiv: {
+      Value *lhs = inst->getOperand(0);
+      Value *rhs = inst->getOperand(1);
+
+      APFloat L(0.0);
+      APFloat R(0.0);
+
+      if (!frame.EvaluateFloatValue(L, lhs, module)) {
+        LLDB_LOGF(log, "Couldn't evaluate %s", PrintValue(lhs).c_str());
+        error.SetErrorToGenericError();
+        error.SetErrorString(bad_value_error);
+        return false;
+      }
+
+      if (!frame.EvaluateFloatValue(R, rhs, module)) {
+        LLDB_LOGF(log, "Couldn't evaluate %s", PrintValue(rhs).c_str());
+        error.SetErrorToGenericError();
+        error.SetErrorString(bad_value_error);
+        return false;
+      }
+
+      switch (inst->getOpcode()) {
+      default:
+        break;
+      case Instruction::FAdd:
+        L.add(R, APFloat::rmNearestTiesToEven);
+        break;
+      case Instruction::FSub:
+        L.subtract(R, APFloat::rmNearestTiesToEven);
+        break;
+      case Instruction::FMul:
+        L.multiply(R, APFloat::rmNearestTiesToEven);
+        break;
+      case Instruction::FDiv:
+        L.divide(R, APFloat::rmNearestTiesToEven);
+        break;
+      }
+
+      frame.AssignFloatValue(inst, L, module);
+
+      if (log) {
+        LLDB_LOGF(log, "Interpreted a %s", inst->getOpcodeName());
+        LLDB_LOGF(log, "  L : %s", frame.SummarizeValue(lhs).c_str());
+        LLDB_LOGF(log, "  R : %s", frame.SummarizeValue(rhs).c_str());
+        LLDB_LOGF(log, "  = : %s", frame.SummarizeValue(inst).c_str());
+      }
+    } break;
+    case Instruction::FNeg: {
+      Value *source = inst->getOperand(0);
+
+      APFloat S(0.0);
+
+      if (!frame.EvaluateFloatValue(S, source, module)) {
+        LLDB_LOGF(log, "Couldn't evaluate %s", PrintValue(source).c_str());
+        error.SetErrorToGenericError();
+        error.SetErrorString(bad_value_error);
+        return false;
+      }
+
+      S.changeSign();
+      frame.AssignFloatValue(inst, S, module);
+    } break;
+    case Instruction::FPExt:
+    case Instruction::FPTrunc: {
+      Value *source = inst->getOperand(0);
+
+      APFloat S(0.0);
+
+      if (!frame.EvaluateFloatValue(S, source, module)) {
+        LLDB_LOGF(log, "Couldn't evaluate %s", PrintValue(source).c_str());
+        error.SetErrorToGenericError();
+        error.SetErrorString(bad_value_error);
+        return false;
+      }
+
+      bool loses_info;
+      S.convert(inst->getType()->getFltSemantics(),
+                APFloat::rmNearestTiesToEven, &loses_info);
+      frame.AssignFloatValue(inst, S, module);
+    } break;
+    case Instruction::SIToFP:
+    case Instruction::UIToFP: {
+      Value *source = inst->getOperand(0);
+
+      lldb_private::Scalar S;
+
+      if (!frame.EvaluateValue(S, source, module)) {
+        LLDB_LOGF(log, "Couldn't evaluate %s", PrintValue(source).c_str());
+        error.SetErrorToGenericError();
+        error.SetErrorString(bad_value_error);
+        return false;
+      }
+
+      const bool is_signed = inst->getOpcode() == Instruction::SIToFP;
+      APInt source_value = S.UInt128(APInt()).zextOrTrunc(
+          source->getType()->getPrimitiveSizeInBits());
+      APFloat result(inst->getType()->getFltSemantics());
+      result.convertFromAPInt(source_value, is_signed,
+                              APFloat::rmNearestTiesToEven);
+      frame.AssignFloatValue(inst, result, module);
+    } break;
+    case Instruction::FPToSI:
+    case Instruction::FPToUI: {
+      Value *source = inst->getOperand(0);
+
+      APFloat S(0.0);
+
+      if (!frame.EvaluateFloatValue(S, source, module)) {
+        LLDB_LOGF(log, "Couldn't evaluate %s", PrintValue(source).c_str());
+        error.SetErrorToGenericError();
+        error.SetErrorString(bad_value_error);
+        return false;
+      }
+
+      const bool is_unsigned = inst->getOpcode() == Instruction::FPToUI;
+      APSInt result(inst->getType()->getPrimitiveSizeInBits(), is_unsigned);
+      bool is_exact;
+      S.convertToInteger(result, APFloat::rmTowardZero, &is_exact);
+      frame.AssignValue(inst, lldb_private::Scalar(result), module);
+    } break;
+    case Instruction::FCmp: {
+      const FCmpInst *fcmp_inst = cast<FCmpInst>(inst);
+
+      Value *lhs = inst->getOperand(0);
+      Value *rhs = inst->getOperand(1);
+
+      APFloat L(0.0);
+      APFloat R(0.0);
+
+      if (!frame.EvaluateFloatValue(L, lhs, module)) {
+        LLDB_LOGF(log, "Couldn't evaluate %s", PrintValue(lhs).c_str());
+        error.SetErrorToGenericError();
+        error.SetErrorString(bad_value_error);
+        return false;
+      }
+
+      if (!frame.EvaluateFloatValue(R, rhs, module)) {
+        LLDB_LOGF(log, "Couldn't evaluate %s", PrintValue(rhs).c_str());
+        error.SetErrorToGenericError();
+        error.SetErrorString(bad_value_error);
+        return false;
+      }
+
+      lldb_private::Scalar result(
+          FCmpInst::compare(L, R, fcmp_inst->getPredicate()));
+
+      frame.AssignValue(inst, result, module);
+
+      if (log) {
+        LLDB_LOGF(log, "Interpreted an FCmpInst");
+        LLDB_LOGF(log, "  L : %s", frame.SummarizeValue(lhs).c_str());
+        LLDB_LOGF(log, "  R : %s", frame.SummarizeValue(rhs).c_str());
+        LLDB_LOGF(log, "  = : %s", frame.SummarizeValue(inst).c_str());
+      }
+    } break;
     case Instruction::ICmp: {
       const ICmpInst *icmp_inst = cast<ICmpInst>(inst);
 
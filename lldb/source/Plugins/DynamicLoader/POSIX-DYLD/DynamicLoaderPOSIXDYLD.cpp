@@ -23,6 +23,8 @@
 #include "lldb/Target/ThreadPlanRunToAddress.h"
 #include "lldb/Utility/Log.h"
 #include "lldb/Utility/ProcessInfo.h"
+#include "llvm/ADT/StringSet.h"
+#include "llvm/Support/ThreadPool.h"
 
 #include <memory>
 
@@ -433,6 +435,7 @@ void DynamicLoaderPOSIXDYLD::RefreshModules() {
       E = m_rendezvous.end();
       m_initial_modules_added = true;
     }
+    PreloadModules(I, E);
     for (; I != E; ++I) {
       ModuleSP module_sp =
           LoadModuleAtAddress(I->file_spec, I->link_addr, I->base_addr, true);
@@ -604,6 +607,7 @@ void DynamicLoaderPOSIXDYLD::LoadAllCurrentModules() {
     module_names.push_back(I->file_spec);
   m_process->PrefetchModuleSpecs(
       module_names, m_process->GetTarget().GetArchitecture().GetTriple());
+  PreloadModules(m_rendezvous.begin(), m_rendezvous.end());
 
   for (I = m_rendezvous.begin(), E = m_rendezvous.end(); I != E; ++I) {
     ModuleSP module_sp =
@@ -625,6 +629,38 @@ void DynamicLoaderPOSIXDYLD::LoadAllCurrentModules() {
   m_initial_modules_added = true;
 }
 
+void DynamicLoaderPOSIXDYLD::PreloadModules(DYLDRendezvous::iterator begin,
+                                            DYLDRendezvous::iterator end) {
+  Target &target = m_process->GetTarget();
+  if (!target.GetParallelModuleLoad())
+    return;
+
+  // Only create each module once, and leave the ones the target already has
+  // to LoadModuleAtAddress.
+  std::vector<ModuleSpec> module_specs;
+  llvm::StringSet<> seen_paths;
+  for (DYLDRendezvous::iterator I = begin; I != end; ++I) {
+    ModuleSpec module_spec(I->file_spec, target.GetArchitecture());
+    if (!seen_paths.insert(I->file_spec.GetPath()).second ||
+        target.GetImages().FindFirstModule(module_spec))
+      continue;
+    module_specs.push_back(module_spec);
+  }
+  if (module_specs.size() < 2)
+    return;
+
+  // Target::GetOrCreateModule takes the locks of the module lists only while
+  // it updates them, and preloads the symbols of the module outside of them,
+  // so most of the work runs in parallel. Notifying the target here would
+  // resolve breakpoints on every thread, so the callers batch that instead.
+  llvm::ThreadPool pool(llvm::optimal_concurrency(module_specs.size()));
+  for (const ModuleSpec &module_spec : module_specs)
+    pool.async([&target, &module_spec]() {
+      target.GetOrCreateModule(module_spec, false /* notify */);
+    });
+  pool.wait();
+}
+
 addr_t DynamicLoaderPOSIXDYLD::ComputeLoadOffset() {
   addr_t virt_entry;
 
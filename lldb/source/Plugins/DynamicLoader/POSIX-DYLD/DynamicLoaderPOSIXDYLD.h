@@ -138,6 +138,15 @@ protected:
   /// of all dependent modules.
   virtual void LoadAllCurrentModules();
 
+  /// Creates the modules for the entries in [\p begin, \p end) that the
+  /// target does not have yet, and preloads their symbols, on a thread pool.
+  ///
+  /// The modules are added to the target without notifying it, so callers
+  /// must load their sections and then report them all with a single
+  /// Target::ModulesDidLoad call.
+  void PreloadModules(DYLDRendezvous::iterator begin,
+                      DYLDRendezvous::iterator end);
+
   void LoadVDSO();
 
   // Loading an interpreter module (if present) assuming m_interpreter_base
@@ -166,16 +166,20 @@ Status ProcessElfCore::DoLoadCore() {
 
   m_thread_data_valid = true;
 
+  // Cores of large processes have one PT_LOAD segment per mapping, which can
+  // be hundreds of thousands of them.
+  m_core_aranges.Reserve(segments.size());
+  m_core_range_infos.Reserve(segments.size());
+
   bool ranges_are_sorted = true;
   lldb::addr_t vm_addr = 0;
   /// Walk through segments and Thread and Address Map information.
   /// PT_NOTE - Contains Thread and Register information
   /// PT_LOAD - Contains a contiguous range of Process Address Space
   for (const elf::ELFProgramHeader &H : segments) {
-    DataExtractor data = core->GetSegmentData(H);
-
     // Parse thread contexts and auxv structure
     if (H.p_type == llvm::ELF::PT_NOTE) {
+      DataExtractor data = core->GetSegmentData(H);
       if (llvm::Error error = ParseThreadContextsFromNoteSegment(H, data))
         return Status(std::move(error));
     }
@@ -335,38 +339,41 @@ size_t ProcessElfCore::DoReadMemory(lldb::addr_t addr, void *buf, size_t size,
   // Get the address range
   const VMRangeToFileOffset::Entry *address_range =
       m_core_aranges.FindEntryThatContains(addr);
-  if (address_range == nullptr || address_range->GetRangeEnd() < addr) {
+  if (address_range == nullptr) {
     error.SetErrorStringWithFormat("core file does not contain 0x%" PRIx64,
                                    addr);
     return 0;
   }
 
-  // Convert the address into core file offset
-  const lldb::addr_t offset = addr - address_range->GetRangeBase();
-  const lldb::addr_t file_start = address_range->data.GetRangeBase();
-  const lldb::addr_t file_end = address_range->data.GetRangeEnd();
-  size_t bytes_to_read = size; // Number of bytes to read from the core file
-  size_t bytes_copied = 0;   // Number of bytes actually read from the core file
-  lldb::addr_t bytes_left =
-      0; // Number of bytes available in the core file from the given address
-
-  // Don't proceed if core file doesn't contain the actual data for this
-  // address range.
-  if (file_start == file_end)
-    return 0;
-
-  // Figure out how many on-disk bytes remain in this segment starting at the
-  // given offset
-  if (file_end > file_start + offset)
-    bytes_left = file_end - (file_start + offset);
-
-  if (bytes_to_read > bytes_left)
-    bytes_to_read = bytes_left;
+  // A read may cross into the next PT_LOAD segment, for example when a
+  // mapping was split by a permission change. Keep copying as long as the
+  // following segment starts where the current one ends, so that callers
+  // don't have to retry with a second read.
+  uint8_t *dst = static_cast<uint8_t *>(buf);
+  size_t bytes_copied = 0; // Number of bytes actually read from the core file
+  while (address_range && bytes_copied < size) {
+    // Convert the address into core file offset
+    const lldb::addr_t cur_addr = addr + bytes_copied;
+    const lldb::addr_t offset = cur_addr - address_range->GetRangeBase();
+    const lldb::addr_t file_start = address_range->data.GetRangeBase();
+    const lldb::addr_t file_end = address_range->data.GetRangeEnd();
+
+    // Figure out how many on-disk bytes remain in this segment starting at the
+    // given offset. Don't proceed if the core file doesn't contain the actual
+    // data for this part of the address range.
+    if (file_end <= file_start + offset)
+      break;
+    const size_t bytes_to_read = std::min<lldb::addr_t>(
+        size - bytes_copied, file_end - (file_start + offset));
+    const size_t bytes_read = core_objfile->CopyData(
+        offset + file_start, bytes_to_read, dst + bytes_copied);
+    bytes_copied += bytes_read;
+    if (bytes_read != bytes_to_read ||
+        cur_addr + bytes_read != address_range->GetRangeEnd())
+      break;
 
-  // If there is data available on the core file read it
-  if (bytes_to_read)
-    bytes_copied =
-        core_objfile->CopyData(offset + file_start, bytes_to_read, buf);
+    address_range = m_core_aranges.FindEntryThatContains(cur_addr + bytes_read);
+  }
 
   return bytes_copied;
 }
@@ -858,6 +865,10 @@ llvm::Error ProcessElfCore::parseLinuxNotes(llvm::ArrayRef<CoreNote> notes) {
       lldb::offset_t offset = 0;
       const uint64_t count = note.data.GetAddress(&offset);
       note.data.GetAddress(&offset); // Skip page size
+      // Each entry takes at least three addresses, which bounds the count of a
+      // corrupt note by its size.
+      m_nt_file_entries.reserve(std::min<uint64_t>(
+          count, note.data.GetByteSize() / (3 * note.data.GetAddressByteSize())));
       for (uint64_t i = 0; i < count; ++i) {
         NT_FILE_Entry entry;
         entry.start = note.data.GetAddress(&offset);
@@ -20,6 +20,9 @@
 #include "lldb/Utility/DataExtractor.h"
 #include "lldb/Utility/Stream.h"
 #include "lldb/Utility/Timer.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/DJB.h"
 #include "llvm/Support/FormatVariadic.h"
 #include "llvm/Support/ThreadPool.h"
 
@@ -69,8 +72,8 @@ void ManualDWARFIndex::Index() {
                           lldb::eDescriptionLevelBrief);
 
   // Include 2 passes per unit to index for extracting DIEs from the unit and
-  // indexing the unit, and then 8 extra entries for finalizing each index set.
-  const uint64_t total_progress = units_to_index.size() * 2 + 8;
+  // indexing the unit, and then 9 extra entries for finalizing each index set.
+  const uint64_t total_progress = units_to_index.size() * 2 + 9;
   Progress progress(
       llvm::formatv("Manually indexing DWARF for {0}", module_desc.GetData()),
       total_progress);
@@ -129,6 +132,14 @@ void ManualDWARFIndex::Index() {
   pool.async(finalize_fn, &IndexSet::globals);
   pool.async(finalize_fn, &IndexSet::types);
   pool.async(finalize_fn, &IndexSet::namespaces);
+  pool.async([this, &sets, &progress]() {
+    auto &result = m_set.type_decl_context_hashes;
+    for (auto &set : sets)
+      result.insert(result.end(), set.type_decl_context_hashes.begin(),
+                    set.type_decl_context_hashes.end());
+    llvm::sort(result, llvm::less_first());
+    progress.Increment();
+  });
   pool.wait();
 
   SaveToCache();
@@ -162,6 +173,56 @@ void ManualDWARFIndex::IndexUnit(DWARFUnit &unit, SymbolFileDWARFDwo *dwp,
   }
 }
 
+uint32_t ManualDWARFIndex::HashDeclContext(const DWARFDeclContext &context) {
+  // DWARFDeclContext::operator== compares the names at each level, and treats
+  // DW_TAG_class_type and DW_TAG_structure_type as the same, so only hash the
+  // names. A missing name only matches a missing name.
+  llvm::SmallString<128> names;
+  for (uint32_t i = 0; i < context.GetSize(); ++i) {
+    if (const char *name = context[i].name) {
+      names.append(name);
+      names.push_back('\0');
+    } else {
+      names.push_back('\1');
+    }
+  }
+  return llvm::djbHash(names);
+}
+
+/// Computes the same declaration context as DWARFDIE::GetDWARFDeclContext(),
+/// but only if it does not need any DIE outside of \a unit. Returns None if a
+/// DIE on the way has a DW_AT_specification or DW_AT_abstract_origin, which
+/// GetParentDeclContextDIE() would follow.
+static llvm::Optional<DWARFDeclContext>
+GetDWARFDeclContextInUnit(DWARFUnit &unit, const DWARFDebugInfoEntry &die) {
+  DWARFDeclContext context;
+  for (const DWARFDebugInfoEntry *entry = &die;;) {
+    const dw_tag_t tag = entry->Tag();
+    if (tag == DW_TAG_compile_unit || tag == DW_TAG_partial_unit)
+      return context;
+    DWARFFormValue form_value;
+    if (entry->GetAttributeValue(&unit, DW_AT_specification, form_value) ||
+        entry->GetAttributeValue(&unit, DW_AT_abstract_origin, form_value))
+      return llvm::None;
+    context.AppendDeclContext(tag, entry->GetName(&unit));
+
+    const DWARFDebugInfoEntry *parent = entry->GetParent();
+    for (; parent; parent = parent->GetParent()) {
+      const dw_tag_t parent_tag = parent->Tag();
+      if (parent_tag == DW_TAG_compile_unit ||
+          parent_tag == DW_TAG_partial_unit)
+        return context;
+      if (parent_tag == DW_TAG_namespace ||
+          parent_tag == DW_TAG_structure_type ||
+          parent_tag == DW_TAG_union_type || parent_tag == DW_TAG_class_type)
+        break;
+    }
+    if (!parent)
+      return context;
+    entry = parent;
+  }
+}
+
 void ManualDWARFIndex::IndexUnitImpl(DWARFUnit &unit,
                                      const LanguageType cu_language,
                                      IndexSet &set) {
@@ -319,6 +380,12 @@ void ManualDWARFIndex::IndexUnitImpl(DWARFUnit &unit,
         set.types.Insert(ConstString(name), ref);
       if (mangled_cstr && !is_declaration)
         set.types.Insert(ConstString(mangled_cstr), ref);
+      if ((name || mangled_cstr) && !is_declaration) {
+        if (llvm::Optional<DWARFDeclContext> context =
+                GetDWARFDeclContextInUnit(unit, die))
+          set.type_decl_context_hashes.emplace_back(ref,
+                                                    HashDeclContext(*context));
+      }
       break;
 
     case DW_TAG_namespace:
@@ -398,8 +465,19 @@ void ManualDWARFIndex::GetTypes(
     llvm::function_ref<bool(DWARFDIE die)> callback) {
   Index();
   auto name = context[0].name;
-  m_set.types.Find(ConstString(name),
-                   DIERefCallback(callback, llvm::StringRef(name)));
+  const uint32_t hash = HashDeclContext(context);
+  auto die_callback = DIERefCallback(callback, llvm::StringRef(name));
+  const auto &hashes = m_set.type_decl_context_hashes;
+  m_set.types.Find(ConstString(name), [&](DIERef ref) {
+    // Skip DIEs whose declaration context is known not to match, which saves
+    // parsing their units just to find out.
+    auto pos = llvm::lower_bound(
+        hashes, ref,
+        [](const auto &entry, DIERef ref) { return entry.first < ref; });
+    if (pos != hashes.end() && pos->first == ref && pos->second != hash)
+      return true;
+    return die_callback(ref);
+  });
 }
 
 void ManualDWARFIndex::GetNamespaces(
@@ -500,10 +578,11 @@ enum DataID {
   kDataIDGlobals,
   kDataIDTypes,
   kDataIDNamespaces,
+  kDataIDTypeDeclContextHashes,
   kDataIDEnd = 255u,
 
 };
-constexpr uint32_t CURRENT_CACHE_VERSION = 1;
+constexpr uint32_t CURRENT_CACHE_VERSION = 2;
 
 bool ManualDWARFIndex::IndexSet::Decode(const DataExtractor &data,
                                         lldb::offset_t *offset_ptr) {
@@ -558,6 +637,19 @@ bool ManualDWARFIndex::IndexSet::Decode(const DataExtractor &data,
       if (!namespaces.Decode(data, offset_ptr, strtab))
         return false;
       break;
+    case kDataIDTypeDeclContextHashes: {
+      const uint32_t count = data.GetU32(offset_ptr);
+      type_decl_context_hashes.clear();
+      type_decl_context_hashes.reserve(count);
+      for (uint32_t i = 0; i < count; ++i) {
+        llvm::Optional<DIERef> die_ref = DIERef::Decode(data, offset_ptr);
+        if (!die_ref || !data.ValidOffsetForDataOfSize(*offset_ptr, 4))
+          return false;
+        const uint32_t hash = data.GetU32(offset_ptr);
+        type_decl_context_hashes.emplace_back(*die_ref, hash);
+      }
+      break;
+    }
     case kDataIDEnd:
       // We got to the end of our NameToDIE encodings.
       done = true;
@@ -613,6 +705,14 @@ void ManualDWARFIndex::IndexSet::Encode(DataEncoder &encoder) const {
     index_encoder.AppendU8(kDataIDNamespaces);
     namespaces.Encode(index_encoder, strtab);
   }
+  if (!type_decl_context_hashes.empty()) {
+    index_encoder.AppendU8(kDataIDTypeDeclContextHashes);
+    index_encoder.AppendU32(type_decl_context_hashes.size());
+    for (const auto &entry : type_decl_context_hashes) {
+      entry.first.Encode(index_encoder);
+      index_encoder.AppendU32(entry.second);
+    }
+  }
   index_encoder.AppendU8(kDataIDEnd);
 
   // Now that all strings have been gathered, we will emit the string table.
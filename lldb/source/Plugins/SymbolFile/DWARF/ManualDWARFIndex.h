@@ -12,8 +12,11 @@
 #include "Plugins/SymbolFile/DWARF/DWARFIndex.h"
 #include "Plugins/SymbolFile/DWARF/NameToDIE.h"
 #include "llvm/ADT/DenseSet.h"
+#include <utility>
+#include <vector>
 
 class DWARFDebugInfo;
+class DWARFDeclContext;
 class SymbolFileDWARFDwo;
 
 namespace lldb_private {
@@ -65,6 +68,12 @@ public:
     NameToDIE globals;
     NameToDIE types;
     NameToDIE namespaces;
+    /// Hashes of the declaration contexts of the DIEs in \a types, sorted by
+    /// DIERef. They let lookups by declaration context skip DIEs that cannot
+    /// match without parsing their units. DIEs whose declaration context
+    /// goes through a DW_AT_specification or DW_AT_abstract_origin have no
+    /// hash, and are always checked.
+    std::vector<std::pair<DIERef, uint32_t>> type_decl_context_hashes;
     bool Decode(const DataExtractor &data, lldb::offset_t *offset_ptr);
     void Encode(DataEncoder &encoder) const;
     bool operator==(const IndexSet &rhs) const {
@@ -74,10 +83,15 @@ public:
              function_selectors == rhs.function_selectors &&
              objc_class_selectors == rhs.objc_class_selectors &&
              globals == rhs.globals && types == rhs.types &&
-             namespaces == rhs.namespaces;
+             namespaces == rhs.namespaces &&
+             type_decl_context_hashes == rhs.type_decl_context_hashes;
     }
   };
 
+  /// Hash the names in a declaration context. Contexts that compare equal
+  /// always have the same hash.
+  static uint32_t HashDeclContext(const DWARFDeclContext &context);
+
 private:
   void Index();
 
@@ -27,6 +27,7 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/DJB.h"
+#include "llvm/Support/ThreadPool.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -297,9 +298,9 @@ void Symtab::InitNameIndexes() {
     std::vector<std::pair<NameToIndexMap::Entry, const char *>> backlog;
     backlog.reserve(num_symbols / 2);
 
-    // Instantiation of the demangler is expensive, so better use a single one
-    // for all entries during batch processing.
-    RichManglingContext rmc;
+    // Demangling is what takes the time, and each symbol can be demangled on
+    // its own, so do it up front on as many threads as there are.
+    std::vector<DemangledFunctionName> demangled_names = DemangleSymbolNames();
     for (uint32_t value = 0; value < num_symbols; ++value) {
       Symbol *symbol = &m_symbols[value];
 
@@ -326,11 +327,9 @@ void Symtab::InitNameIndexes() {
           name_to_index.Append(stripped, value);
         }
 
-        const SymbolType type = symbol->GetType();
-        if (type == eSymbolTypeCode || type == eSymbolTypeResolver) {
-          if (mangled.DemangleWithRichManglingInfo(rmc, lldb_skip_name))
-            RegisterMangledNameEntry(value, class_contexts, backlog, rmc);
-        }
+        if (demangled_names[value].base_name)
+          RegisterMangledNameEntry(value, demangled_names[value],
+                                   class_contexts, backlog);
       }
 
       // Symbol name strings that didn't match a Mangled::ManglingScheme, are
@@ -378,24 +377,73 @@ void Symtab::InitNameIndexes() {
   }
 }
 
-void Symtab::RegisterMangledNameEntry(
-    uint32_t value, std::set<const char *> &class_contexts,
-    std::vector<std::pair<NameToIndexMap::Entry, const char *>> &backlog,
-    RichManglingContext &rmc) {
-  // Only register functions that have a base name.
-  rmc.ParseFunctionBaseName();
-  llvm::StringRef base_name = rmc.GetBufferRef();
-  if (base_name.empty())
-    return;
+std::vector<Symtab::DemangledFunctionName> Symtab::DemangleSymbolNames() {
+  const size_t num_symbols = m_symbols.size();
+  std::vector<DemangledFunctionName> names(num_symbols);
 
-  // The base name will be our entry's name.
-  NameToIndexMap::Entry entry(ConstString(base_name), value);
+  auto demangle_range = [this, &names](size_t begin, size_t end) {
+    // Instantiation of the demangler is expensive, so better use a single one
+    // for all entries of a range.
+    RichManglingContext rmc;
+    for (size_t i = begin; i < end; ++i) {
+      Symbol &symbol = m_symbols[i];
+      if (symbol.IsTrampoline() || symbol.IsSyntheticWithAutoGeneratedName())
+        continue;
 
-  rmc.ParseFunctionDeclContextName();
-  llvm::StringRef decl_context = rmc.GetBufferRef();
+      Mangled &mangled = symbol.GetMangled();
+      if (!mangled.GetMangledName())
+        continue;
+
+      const SymbolType type = symbol.GetType();
+      if ((type == eSymbolTypeCode || type == eSymbolTypeResolver) &&
+          mangled.DemangleWithRichManglingInfo(rmc, lldb_skip_name)) {
+        // Only register functions that have a base name.
+        rmc.ParseFunctionBaseName();
+        llvm::StringRef base_name = rmc.GetBufferRef();
+        if (!base_name.empty()) {
+          DemangledFunctionName &name = names[i];
+          name.base_name = ConstString(base_name);
+          rmc.ParseFunctionDeclContextName();
+          llvm::StringRef decl_context = rmc.GetBufferRef();
+          if (!decl_context.empty()) {
+            name.decl_context = ConstString(decl_context).GetCString();
+            name.is_ctor_or_dtor = rmc.IsCtorOrDtor();
+          }
+        }
+      }
+
+      // InitNameIndexes asks for every demangled name, so compute the ones
+      // the rich demangling skipped while we are on this thread.
+      mangled.GetDemangledName();
+    }
+  };
+
+  const size_t chunk_size = 4096;
+  if (num_symbols <= chunk_size) {
+    demangle_range(0, num_symbols);
+    return names;
+  }
+
+  // Every symbol only touches its own Mangled, and ConstString can be used
+  // from any thread.
+  const size_t num_chunks = (num_symbols + chunk_size - 1) / chunk_size;
+  llvm::ThreadPool pool(llvm::optimal_concurrency(num_chunks));
+  for (size_t begin = 0; begin < num_symbols; begin += chunk_size)
+    pool.async(demangle_range, begin,
+               std::min(begin + chunk_size, num_symbols));
+  pool.wait();
+  return names;
+}
+
+void Symtab::RegisterMangledNameEntry(
+    uint32_t value, const DemangledFunctionName &name,
+    std::set<const char *> &class_contexts,
+    std::vector<std::pair<NameToIndexMap::Entry, const char *>> &backlog) {
+  // The base name will be our entry's name.
+  NameToIndexMap::Entry entry(name.base_name, value);
 
   // Register functions with no context.
-  if (decl_context.empty()) {
+  if (!name.decl_context) {
     // This has to be a basename
     auto &basename_to_index =
         GetNameToSymbolIndexMap(lldb::eFunctionNameTypeBase);
@@ -407,16 +455,15 @@ void Symtab::RegisterMangledNameEntry(
     return;
   }
 
-  // Make sure we have a pool-string pointer and see if we already know the
-  // context name.
-  const char *decl_context_ccstr = ConstString(decl_context).GetCString();
+  // See if we already know the context name.
+  const char *decl_context_ccstr = name.decl_context;
   auto it = class_contexts.find(decl_context_ccstr);
 
   auto &method_to_index =
       GetNameToSymbolIndexMap(lldb::eFunctionNameTypeMethod);
   // Register constructors and destructors. They are methods and create
   // declaration contexts.
-  if (rmc.IsCtorOrDtor()) {
+  if (name.is_ctor_or_dtor) {
     method_to_index.Append(entry);
     if (it == class_contexts.end())
       class_contexts.insert(it, decl_context_ccstr);
@@ -13,12 +13,16 @@
 #include "lldb/Utility/RangeMap.h"
 #include "lldb/Utility/State.h"
 
+#include <algorithm>
 #include <cinttypes>
 #include <memory>
 
 using namespace lldb;
 using namespace lldb_private;
 
+// The most L2 cache lines a single miss reads from the process.
+static const uint32_t g_max_prefetch_line_count = 16;
+
 // MemoryCache constructor
 MemoryCache::MemoryCache(Process &process)
     : m_mutex(), m_L1_cache(), m_L2_cache(), m_invalid_ranges(),
@@ -35,6 +39,8 @@ void MemoryCache::Clear(bool clear_invalid_ranges) {
   if (clear_invalid_ranges)
     m_invalid_ranges.Clear();
   m_L2_cache_line_byte_size = m_process.GetMemoryCacheLineSize();
+  m_next_sequential_miss = LLDB_INVALID_ADDRESS;
+  m_prefetch_line_count = 1;
 }
 
 void MemoryCache::AddL1CacheData(lldb::addr_t addr, const void *src,
@@ -122,6 +128,53 @@ bool MemoryCache::RemoveInvalidRange(lldb::addr_t base_addr,
   return false;
 }
 
+bool MemoryCache::PrefetchCacheLines(addr_t line_addr) {
+  const uint32_t cache_line_byte_size = m_L2_cache_line_byte_size;
+
+  // Read more lines at once every time a miss continues where the previous
+  // one ended, which is what walking an array or a structure does, and go
+  // back to a single line as soon as the reads jump elsewhere.
+  if (line_addr == m_next_sequential_miss)
+    m_prefetch_line_count =
+        std::min(m_prefetch_line_count * 2, g_max_prefetch_line_count);
+  else
+    m_prefetch_line_count = 1;
+  m_next_sequential_miss = line_addr + cache_line_byte_size;
+
+  // Don't read lines that are already cached or known to be unreadable.
+  uint32_t line_count = 1;
+  for (addr_t next_addr = m_next_sequential_miss;
+       line_count < m_prefetch_line_count && next_addr > line_addr;
+       ++line_count, next_addr += cache_line_byte_size) {
+    if (m_L2_cache.count(next_addr) ||
+        m_invalid_ranges.FindEntryThatContains(next_addr))
+      break;
+  }
+  if (line_count < 2)
+    return false;
+
+  DataBufferHeap buffer(line_count * cache_line_byte_size, 0);
+  Status error;
+  size_t bytes_read = m_process.ReadMemoryFromInferior(
+      line_addr, buffer.GetBytes(), buffer.GetByteSize(), error);
+  if (bytes_read < cache_line_byte_size) {
+    // The memory after the first line may not be readable, which can fail
+    // the whole read, so leave the first line to a read of its own.
+    m_prefetch_line_count = 1;
+    return false;
+  }
+
+  // Only keep the lines that were read in full. A partial line at the end is
+  // read again, on its own, when it is needed.
+  size_t offset = 0;
+  for (; offset + cache_line_byte_size <= bytes_read;
+       offset += cache_line_byte_size)
+    m_L2_cache[line_addr + offset] = std::make_shared<DataBufferHeap>(
+        buffer.GetBytes() + offset, cache_line_byte_size);
+  m_next_sequential_miss = line_addr + offset;
+  return true;
+}
+
 size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
                          Status &error) {
   size_t bytes_left = dst_len;
@@ -224,6 +277,8 @@ size_t MemoryCache::Read(addr_t addr, void *dst, size_t dst_len,
 
       if (bytes_left > 0) {
         assert((curr_addr % cache_line_byte_size) == 0);
+        if (PrefetchCacheLines(curr_addr))
+          continue;
         std::unique_ptr<DataBufferHeap> data_buffer_heap_up(
             new DataBufferHeap(cache_line_byte_size, 0));
         size_t process_bytes_read = m_process.ReadMemoryFromInferior(
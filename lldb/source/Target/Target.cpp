@@ -59,8 +59,10 @@
 #include "lldb/Utility/StreamString.h"
 #include "lldb/Utility/Timer.h"
 
+#include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/ScopeExit.h"
 #include "llvm/ADT/SetVector.h"
+#include "llvm/Support/ThreadPool.h"
 
 #include <memory>
 #include <mutex>
@@ -2884,6 +2886,45 @@ bool Target::ResolveLoadAddress(addr_t load_addr, Address &so_addr,
   return m_section_load_history.ResolveLoadAddress(stop_id, load_addr, so_addr);
 }
 
+void Target::ResolveSymbolContextsForLoadAddresses(
+    llvm::ArrayRef<lldb::addr_t> load_addrs, SymbolContextItem resolve_scope,
+    SymbolContextList &sc_list) {
+  std::vector<Address> addrs(load_addrs.size());
+  std::vector<SymbolContext> sym_ctxs(load_addrs.size(),
+                                      SymbolContext(shared_from_this()));
+
+  // Group the addresses by module, keeping the first-seen order of the
+  // modules so that the work is split the same way on every run.
+  llvm::MapVector<Module *, std::vector<size_t>> addrs_by_module;
+  for (size_t i = 0; i < load_addrs.size(); ++i) {
+    if (!ResolveLoadAddress(load_addrs[i], addrs[i]))
+      continue;
+    if (ModuleSP module_sp = addrs[i].GetModule())
+      addrs_by_module[module_sp.get()].push_back(i);
+  }
+
+  auto resolve_module = [&](const std::vector<size_t> &indices) {
+    for (size_t i : indices) {
+      ModuleSP module_sp = addrs[i].GetModule();
+      if (module_sp)
+        module_sp->ResolveSymbolContextForAddress(addrs[i], resolve_scope,
+                                                  sym_ctxs[i]);
+    }
+  };
+
+  if (addrs_by_module.size() > 1) {
+    llvm::ThreadPool pool(llvm::optimal_concurrency(addrs_by_module.size()));
+    for (const auto &entry : addrs_by_module)
+      pool.async(resolve_module, std::cref(entry.second));
+    pool.wait();
+  } else if (!addrs_by_module.empty()) {
+    resolve_module(addrs_by_module.front().second);
+  }
+
+  for (const SymbolContext &sc : sym_ctxs)
+    sc_list.Append(sc);
+}
+
 bool Target::ResolveFileAddress(lldb::addr_t file_addr,
                                 Address &resolved_addr) {
   return m_images.ResolveFileAddress(file_addr, resolved_addr);
@@ -3912,6 +3953,12 @@ void TargetProperties::SetPreloadSymbols(bool b) {
   m_collection_sp->SetPropertyAtIndexAsBoolean(nullptr, idx, b);
 }
 
+bool TargetProperties::GetParallelModuleLoad() const {
+  const uint32_t idx = ePropertyParallelModuleLoad;
+  return m_collection_sp->GetPropertyAtIndexAsBoolean(
+      nullptr, idx, g_target_properties[idx].default_uint_value != 0);
+}
+
 bool TargetProperties::GetDisableASLR() const {
   const uint32_t idx = ePropertyDisableASLR;
   return m_collection_sp->GetPropertyAtIndexAsBoolean(
@@ -952,6 +952,18 @@ std::string CreateUniqueVariableNameForDisplay(lldb::SBValue v,
   return name_builder.GetData();
 }
 
+bool HasIndexedChildren(lldb::SBValue v) {
+  if (v.GetType().IsArrayType())
+    return true;
+  // The type of a value with a synthetic child provider doesn't say what its
+  // children are, so look at the name of the first one. Synthetic providers
+  // compute their children lazily, so this doesn't create the others.
+  if (!v.IsSynthetic() || v.GetNumChildren() == 0)
+    return false;
+  const char *name = v.GetChildAtIndex(0).GetName();
+  return name && llvm::StringRef(name) == "[0]";
+}
+
 // "Variable": {
 //   "type": "object",
 //   "description": "A Variable is a name/value pair. Optionally a variable
@@ -1028,10 +1040,15 @@ llvm::json::Value CreateVariable(lldb::SBValue v, int64_t variablesReference,
   EmplaceSafeString(object, "type", type_cstr ? type_cstr : NO_TYPENAME);
   if (varID != INT64_MAX)
     object.try_emplace("id", varID);
-  if (v.MightHaveChildren())
+  if (v.MightHaveChildren()) {
     object.try_emplace("variablesReference", variablesReference);
-  else
+    // Let the client page through large arrays and containers instead of
+    // asking for all of their children at once.
+    if (HasIndexedChildren(v))
+      object.try_emplace("indexedVariables", (int64_t)v.GetNumChildren());
+  } else {
     object.try_emplace("variablesReference", (int64_t)0);
+  }
   lldb::SBStream evaluateStream;
   v.GetExpressionPath(evaluateStream);
   const char *evaluateName = evaluateStream.GetData();
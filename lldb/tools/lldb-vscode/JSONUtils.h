@@ -411,6 +411,14 @@ const char *GetNonNullVariableName(lldb::SBValue value);
 std::string CreateUniqueVariableNameForDisplay(lldb::SBValue v,
                                                bool is_name_duplicated);
 
+/// Check if the children of a value are elements, like those of an array or
+/// of a container with a synthetic child provider, rather than members.
+///
+/// 
+eturn
+///     True if the children of \a v are named "[0]", "[1]" and so on.
+bool HasIndexedChildren(lldb::SBValue v);
+
 /// Create a "Variable" object for a LLDB thread object.
 ///
 /// This function will fill in the following keys in the returned
@@ -426,6 +434,8 @@ std::string CreateUniqueVariableNameForDisplay(lldb::SBValue v,
 ///   "variablesReference" - Zero if the variable has no children,
 ///          non-zero integer otherwise which can be used to expand
 ///          the variable.
+///   "indexedVariables" - The number of children, if they are indexed, so
+///          that clients can fetch them one page at a time.
 ///   "evaluateName" - The name of the variable to use in expressions
 ///                    as a string.
 ///
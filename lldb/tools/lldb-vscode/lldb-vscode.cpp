@@ -2914,6 +2914,7 @@ void request_variables(const llvm::json::Object &request) {
       GetUnsigned(arguments, "variablesReference", 0);
   const int64_t start = GetSigned(arguments, "start", 0);
   const int64_t count = GetSigned(arguments, "count", 0);
+  const llvm::StringRef filter = GetString(arguments, "filter");
   bool hex = false;
   auto format = arguments->getObject("format");
   if (format)
@@ -2957,9 +2958,14 @@ void request_variables(const llvm::json::Object &request) {
     // We are expanding a variable that has children, so we will return its
     // children.
     lldb::SBValue variable = g_vsc.variables.GetVariable(variablesReference);
-    if (variable.IsValid()) {
-      const auto num_children = variable.GetNumChildren();
-      const int64_t end_idx = start + ((count == 0) ? num_children : count);
+    // Values with indexed children reported them as "indexedVariables", so
+    // they have no named ones. Clients that page through the indexed ones
+    // ask for the named ones first, and would otherwise get everything.
+    if (variable.IsValid() &&
+        !(filter == "named" && HasIndexedChildren(variable))) {
+      const int64_t num_children = variable.GetNumChildren();
+      const int64_t end_idx =
+          (count == 0) ? num_children : std::min(start + count, num_children);
       for (auto i = start; i < end_idx; ++i) {
         lldb::SBValue child = variable.GetChildAtIndex(i);
         if (!child.IsValid())
@@ -168,6 +168,14 @@ TEST(DWARFIndexCachingTest, ManualDWARFIndexIndexSetEncodeDecode) {
       DIERef(llvm::None, DIERef::Section::DebugInfo, ++die_offset));
   EncodeDecode(set);
   set.namespaces.Clear();
+  // Make sure an IndexSet with only items in
+  // IndexSet::type_decl_context_hashes can be encoded and decoded correctly.
+  set.type_decl_context_hashes.emplace_back(
+      DIERef(llvm::None, DIERef::Section::DebugInfo, ++die_offset), 0x11223344);
+  set.type_decl_context_hashes.emplace_back(
+      DIERef(100, DIERef::Section::DebugInfo, ++die_offset), 0x55667788);
+  EncodeDecode(set);
+  set.type_decl_context_hashes.clear();
   // Make sure that an IndexSet with item in all NameToDIE maps can be
   // be encoded and decoded correctly.
   set.function_basenames.Insert(
@@ -194,5 +202,7 @@ TEST(DWARFIndexCachingTest, ManualDWARFIndexIndexSetEncodeDecode) {
   set.namespaces.Insert(
       ConstString("h"),
       DIERef(llvm::None, DIERef::Section::DebugInfo, ++die_offset));
+  set.type_decl_context_hashes.emplace_back(
+      DIERef(llvm::None, DIERef::Section::DebugInfo, die_offset), 0x11223344);
   EncodeDecode(set);
 }
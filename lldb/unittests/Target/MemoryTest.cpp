@@ -0,0 +1,147 @@
+//===-- MemoryTest.cpp ----------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Target/Memory.h"
+#include "Plugins/Platform/Linux/PlatformLinux.h"
+#include "lldb/Core/Debugger.h"
+#include "lldb/Host/FileSystem.h"
+#include "lldb/Host/HostInfo.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Utility/ArchSpec.h"
+#include "lldb/Utility/Reproducer.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <vector>
+
+using namespace lldb_private;
+using namespace lldb_private::repro;
+using namespace lldb;
+
+namespace {
+class MemoryCacheTest : public ::testing::Test {
+public:
+  void SetUp() override {
+    llvm::cantFail(Reproducer::Initialize(ReproducerMode::Off, llvm::None));
+    FileSystem::Initialize();
+    HostInfo::Initialize();
+    platform_linux::PlatformLinux::Initialize();
+  }
+  void TearDown() override {
+    platform_linux::PlatformLinux::Terminate();
+    HostInfo::Terminate();
+    FileSystem::Terminate();
+    Reproducer::Terminate();
+  }
+};
+
+/// A process whose memory holds the low byte of each address, up to
+/// m_memory_end, and which records the size of every read.
+class DummyProcess : public Process {
+public:
+  using Process::Process;
+
+  bool CanDebug(lldb::TargetSP target, bool plugin_specified_by_name) override {
+    return true;
+  }
+  Status DoDestroy() override { return {}; }
+  void RefreshStateAfterStop() override {}
+  size_t DoReadMemory(lldb::addr_t vm_addr, void *buf, size_t size,
+                      Status &error) override {
+    m_reads.push_back(size);
+    if (vm_addr >= m_memory_end) {
+      error.SetErrorString("unreadable");
+      return 0;
+    }
+    size = std::min<size_t>(size, m_memory_end - vm_addr);
+    for (size_t i = 0; i < size; ++i)
+      static_cast<uint8_t *>(buf)[i] = static_cast<uint8_t>(vm_addr + i);
+    return size;
+  }
+  bool DoUpdateThreadList(ThreadList &old_thread_list,
+                          ThreadList &new_thread_list) override {
+    return false;
+  }
+  llvm::StringRef GetPluginName() override { return "Dummy"; }
+
+  lldb::addr_t m_memory_end = LLDB_INVALID_ADDRESS;
+  std::vector<size_t> m_reads;
+};
+
+std::shared_ptr<DummyProcess> CreateProcess(DebuggerSP &debugger_sp) {
+  ArchSpec arch("x86_64-pc-linux");
+  Platform::SetHostPlatform(
+      platform_linux::PlatformLinux::CreateInstance(true, &arch));
+
+  TargetSP target_sp;
+  PlatformSP platform_sp;
+  debugger_sp->GetTargetList().CreateTarget(
+      *debugger_sp, "", arch, eLoadDependentsNo, platform_sp, target_sp);
+  if (!target_sp)
+    return nullptr;
+  ListenerSP listener_sp(Listener::MakeListener("dummy"));
+  return std::make_shared<DummyProcess>(target_sp, listener_sp);
+}
+
+/// Reads [begin, end) from the cache in chunks of chunk_size bytes, and
+/// checks that every byte has the value DummyProcess gives it.
+void ReadChunks(MemoryCache &cache, lldb::addr_t begin, lldb::addr_t end,
+                size_t chunk_size) {
+  std::vector<uint8_t> chunk(chunk_size);
+  for (lldb::addr_t addr = begin; addr < end; addr += chunk_size) {
+    Status error;
+    ASSERT_EQ(chunk_size, cache.Read(addr, chunk.data(), chunk_size, error));
+    for (size_t i = 0; i < chunk_size; ++i)
+      ASSERT_EQ(static_cast<uint8_t>(addr + i), chunk[i]);
+  }
+}
+} // namespace
+
+TEST_F(MemoryCacheTest, SequentialReadsGrowPrefetch) {
+  DebuggerSP debugger_sp = Debugger::CreateInstance();
+  std::shared_ptr<DummyProcess> process_sp = CreateProcess(debugger_sp);
+  ASSERT_TRUE(process_sp);
+  MemoryCache cache(*process_sp);
+  const size_t line_size = cache.GetMemoryCacheLineSize();
+
+  // The first miss reads one line, and each miss that continues the previous
+  // one reads twice as many.
+  ReadChunks(cache, 0, 15 * line_size, 8);
+  EXPECT_EQ(std::vector<size_t>(
+                {line_size, 2 * line_size, 4 * line_size, 8 * line_size}),
+            process_sp->m_reads);
+}
+
+TEST_F(MemoryCacheTest, ScatteredReadsReadOneLine) {
+  DebuggerSP debugger_sp = Debugger::CreateInstance();
+  std::shared_ptr<DummyProcess> process_sp = CreateProcess(debugger_sp);
+  ASSERT_TRUE(process_sp);
+  MemoryCache cache(*process_sp);
+  const size_t line_size = cache.GetMemoryCacheLineSize();
+
+  for (lldb::addr_t addr : {0, 8, 4, 2, 6})
+    ReadChunks(cache, addr * line_size, addr * line_size + 16, 16);
+  EXPECT_EQ(std::vector<size_t>(5, line_size), process_sp->m_reads);
+}
+
+TEST_F(MemoryCacheTest, PrefetchStopsAtUnreadableMemory) {
+  DebuggerSP debugger_sp = Debugger::CreateInstance();
+  std::shared_ptr<DummyProcess> process_sp = CreateProcess(debugger_sp);
+  ASSERT_TRUE(process_sp);
+  MemoryCache cache(*process_sp);
+  const size_t line_size = cache.GetMemoryCacheLineSize();
+  process_sp->m_memory_end = 5 * line_size;
+
+  // The third miss asks for four lines when only two are left, and the next
+  // one fails to read anything, which must not fail the reads before it.
+  ReadChunks(cache, 0, 5 * line_size, 8);
+  Status error;
+  uint8_t buf[16];
+  EXPECT_EQ(0u, cache.Read(5 * line_size, buf, sizeof(buf), error));
+  EXPECT_TRUE(error.Fail());
+}
@@ -0,0 +1,192 @@
+//===- FlatHashMap.cpp - FlatHashMap, DenseMap and StringMap benchmarks ---===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Compares FlatHashMap against DenseMap and StringMap on key distributions
+// that resemble those of the compiler's hottest maps:
+//
+// - Pointers: IR objects, AST nodes and input sections are allocated from
+//   bump allocators, so the keys are increasing addresses with small, mixed
+//   strides (Value * in ValueMap, Decl * in Sema, InputSection * in lld).
+// - Integers: value, register and type numbers are assigned densely in
+//   increasing order with occasional gaps.
+// - Strings: mangled C++ symbol names with long shared prefixes, as seen by
+//   lld's symbol table.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/FlatHashMap.h"
+#include "llvm/ADT/StringMap.h"
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+// Returns 2 * N keys. The even-indexed ones are inserted into the map and the
+// odd-indexed ones are used for unsuccessful lookups, so that both sets come
+// from the same distribution.
+std::vector<const void *> getPointerKeys(size_t N) {
+  static const unsigned Sizes[] = {24, 32, 32, 40, 48, 64, 72, 96, 128};
+  std::mt19937_64 Rng(N);
+  std::vector<const void *> Keys;
+  uintptr_t Addr = 0x7f0000000000;
+  for (size_t I = 0; I != 2 * N; ++I) {
+    Keys.push_back(reinterpret_cast<const void *>(Addr));
+    Addr += Sizes[Rng() % array_lengthof(Sizes)];
+  }
+  return Keys;
+}
+
+std::vector<unsigned> getIntegerKeys(size_t N) {
+  std::mt19937_64 Rng(N);
+  std::vector<unsigned> Keys;
+  unsigned Id = 0;
+  for (size_t I = 0; I != 2 * N; ++I) {
+    Keys.push_back(Id);
+    Id += Rng() % 8 == 0 ? 1 + Rng() % 16 : 1;
+  }
+  return Keys;
+}
+
+std::vector<std::string> getStringStorage(size_t N) {
+  static const char *Namespaces[] = {"_ZN4llvm", "_ZN5clang", "_ZNSt3__1",
+                                     "_ZN3lld3elf"};
+  static const char *Classes[] = {"12DenseMapBaseI", "8SmallVectorI",
+                                  "4Sema", "10ASTContext", "13InputSectionI",
+                                  "6detail"};
+  std::mt19937_64 Rng(N);
+  std::vector<std::string> Storage;
+  for (size_t I = 0; I != 2 * N; ++I) {
+    std::string S = Namespaces[Rng() % array_lengthof(Namespaces)];
+    S += Classes[Rng() % array_lengthof(Classes)];
+    S += std::to_string(Rng() % 100000);
+    S += "E";
+    S += std::to_string(I);
+    S += "Ev";
+    Storage.push_back(std::move(S));
+  }
+  return Storage;
+}
+
+std::vector<StringRef> getStringKeys(size_t N) {
+  static std::vector<std::string> Storage;
+  Storage = getStringStorage(N);
+  return std::vector<StringRef>(Storage.begin(), Storage.end());
+}
+
+template <typename KeyT> std::vector<KeyT> getKeys(size_t N);
+template <> std::vector<const void *> getKeys(size_t N) {
+  return getPointerKeys(N);
+}
+template <> std::vector<unsigned> getKeys(size_t N) {
+  return getIntegerKeys(N);
+}
+template <> std::vector<StringRef> getKeys(size_t N) {
+  return getStringKeys(N);
+}
+
+// Splits the keys into the ones to insert and the ones to miss, each in a
+// random order.
+template <typename KeyT>
+void splitKeys(std::vector<KeyT> Keys, std::vector<KeyT> &Present,
+               std::vector<KeyT> &Absent) {
+  for (size_t I = 0; I != Keys.size(); ++I)
+    (I % 2 ? Absent : Present).push_back(Keys[I]);
+  std::mt19937_64 Rng(Keys.size());
+  std::shuffle(Present.begin(), Present.end(), Rng);
+  std::shuffle(Absent.begin(), Absent.end(), Rng);
+}
+
+template <typename MapT, typename KeyT>
+void BM_Insert(benchmark::State &State) {
+  std::vector<KeyT> Present, Absent;
+  splitKeys(getKeys<KeyT>(State.range(0)), Present, Absent);
+  for (auto _ : State) {
+    MapT M;
+    for (const KeyT &K : Present)
+      M.try_emplace(K, 0);
+    benchmark::DoNotOptimize(M);
+  }
+  State.SetItemsProcessed(State.iterations() * Present.size());
+}
+
+template <typename MapT, typename KeyT>
+void BM_LookupHit(benchmark::State &State) {
+  std::vector<KeyT> Present, Absent;
+  splitKeys(getKeys<KeyT>(State.range(0)), Present, Absent);
+  MapT M;
+  for (const KeyT &K : Present)
+    M.try_emplace(K, 0);
+  for (auto _ : State)
+    for (const KeyT &K : Present)
+      benchmark::DoNotOptimize(M.find(K));
+  State.SetItemsProcessed(State.iterations() * Present.size());
+}
+
+template <typename MapT, typename KeyT>
+void BM_LookupMiss(benchmark::State &State) {
+  std::vector<KeyT> Present, Absent;
+  splitKeys(getKeys<KeyT>(State.range(0)), Present, Absent);
+  MapT M;
+  for (const KeyT &K : Present)
+    M.try_emplace(K, 0);
+  for (auto _ : State)
+    for (const KeyT &K : Absent)
+      benchmark::DoNotOptimize(M.find(K));
+  State.SetItemsProcessed(State.iterations() * Absent.size());
+}
+
+// Erases and reinserts a quarter of the keys per iteration, which is how
+// worklists and use-lists churn through their maps.
+template <typename MapT, typename KeyT>
+void BM_EraseInsert(benchmark::State &State) {
+  std::vector<KeyT> Present, Absent;
+  splitKeys(getKeys<KeyT>(State.range(0)), Present, Absent);
+  MapT M;
+  for (const KeyT &K : Present)
+    M.try_emplace(K, 0);
+  size_t NumChurn = Present.size() / 4;
+  for (auto _ : State) {
+    for (size_t I = 0; I != NumChurn; ++I)
+      M.erase(Present[I]);
+    for (size_t I = 0; I != NumChurn; ++I)
+      M.try_emplace(Present[I], 0);
+  }
+  State.SetItemsProcessed(State.iterations() * NumChurn * 2);
+}
+
+using PtrDenseMap = DenseMap<const void *, unsigned>;
+using PtrFlatHashMap = FlatHashMap<const void *, unsigned>;
+using IntDenseMap = DenseMap<unsigned, unsigned>;
+using IntFlatHashMap = FlatHashMap<unsigned, unsigned>;
+using StrDenseMap = DenseMap<StringRef, unsigned>;
+using StrFlatHashMap = FlatHashMap<StringRef, unsigned>;
+using StrStringMap = StringMap<unsigned>;
+
+} // namespace
+
+#define MAP_BENCHMARKS(MapT, KeyT)                                             \
+  BENCHMARK_TEMPLATE(BM_Insert, MapT, KeyT)->Range(64, 1 << 20);               \
+  BENCHMARK_TEMPLATE(BM_LookupHit, MapT, KeyT)->Range(64, 1 << 20);            \
+  BENCHMARK_TEMPLATE(BM_LookupMiss, MapT, KeyT)->Range(64, 1 << 20);           \
+  BENCHMARK_TEMPLATE(BM_EraseInsert, MapT, KeyT)->Range(64, 1 << 20)
+
+MAP_BENCHMARKS(PtrDenseMap, const void *);
+MAP_BENCHMARKS(PtrFlatHashMap, const void *);
+MAP_BENCHMARKS(IntDenseMap, unsigned);
+MAP_BENCHMARKS(IntFlatHashMap, unsigned);
+MAP_BENCHMARKS(StrDenseMap, StringRef);
+MAP_BENCHMARKS(StrFlatHashMap, StringRef);
+MAP_BENCHMARKS(StrStringMap, StringRef);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,178 @@
+//===- MCRelaxation.cpp - Assembler relaxation benchmarks -----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Measures assembling x86-64 code whose branches relax in a chain, which
+// makes MCAssembler::layout iterate to its fixed point many times:
+//
+// - BackwardChain: range(0) branches, each to the label just before the
+//   previous branch. A branch only needs its long form once the previous
+//   one has grown, and the first one always does.
+// - ForwardChain: the same, with each branch to the label just after the
+//   next branch, and the last branch always long.
+//
+// The "LayoutPasses" counter is the number of relaxation steps, read from
+// the MC statistics when they are enabled.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/MC/MCAsmBackend.h"
+#include "llvm/MC/MCAsmInfo.h"
+#include "llvm/MC/MCCodeEmitter.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCObjectFileInfo.h"
+#include "llvm/MC/MCObjectWriter.h"
+#include "llvm/MC/MCParser/MCAsmParser.h"
+#include "llvm/MC/MCParser/MCTargetAsmParser.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/MC/MCStreamer.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/MC/MCTargetOptions.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include <memory>
+#include <string>
+
+using namespace llvm;
+
+namespace {
+
+const char *const TripleName = "x86_64-unknown-linux-gnu";
+
+// With this much padding between two branches, a short branch across the
+// padding and one other branch stays in range if that other branch is short,
+// and not if it is long.
+const unsigned Padding = 123;
+
+std::string buildBackwardChain(unsigned NumBranches) {
+  std::string Asm;
+  raw_string_ostream OS(Asm);
+  OS << "\t.text\n";
+  OS << "L0:\n";
+  OS << "\tjmp far\n";
+  for (unsigned I = 1; I <= NumBranches; ++I) {
+    OS << "\t.fill " << Padding << ", 1, 0x90\n";
+    OS << "L" << I << ":\n";
+    OS << "\tjmp L" << I - 1 << "\n";
+  }
+  OS << "\t.fill 256, 1, 0x90\n";
+  OS << "far:\n";
+  return OS.str();
+}
+
+std::string buildForwardChain(unsigned NumBranches) {
+  std::string Asm;
+  raw_string_ostream OS(Asm);
+  OS << "\t.text\n";
+  OS << "near:\n";
+  OS << "\t.fill 256, 1, 0x90\n";
+  for (unsigned I = 0; I != NumBranches; ++I) {
+    OS << "\tjmp L" << I + 1 << "\n";
+    OS << "L" << I << ":\n";
+    OS << "\t.fill " << Padding << ", 1, 0x90\n";
+  }
+  OS << "\tjmp near\n";
+  OS << "L" << NumBranches << ":\n";
+  return OS.str();
+}
+
+/// Assembles Asm into an in-memory ELF object. Returns false if the x86
+/// target is not built or the input does not assemble.
+bool assemble(const std::string &Asm, SmallVectorImpl<char> &Object) {
+  std::string Error;
+  const Target *T = TargetRegistry::lookupTarget(TripleName, Error);
+  if (!T)
+    return false;
+
+  MCTargetOptions MCOptions;
+  std::unique_ptr<MCRegisterInfo> MRI(T->createMCRegInfo(TripleName));
+  std::unique_ptr<MCAsmInfo> MAI(
+      T->createMCAsmInfo(*MRI, TripleName, MCOptions));
+  std::unique_ptr<MCSubtargetInfo> STI(
+      T->createMCSubtargetInfo(TripleName, "generic", ""));
+  std::unique_ptr<MCInstrInfo> MCII(T->createMCInstrInfo());
+
+  SourceMgr SrcMgr;
+  SrcMgr.AddNewSourceBuffer(MemoryBuffer::getMemBuffer(Asm, "<bench>"),
+                            SMLoc());
+  MCContext Ctx(Triple(TripleName), MAI.get(), MRI.get(), STI.get(), &SrcMgr,
+                &MCOptions);
+  std::unique_ptr<MCObjectFileInfo> MOFI(
+      T->createMCObjectFileInfo(Ctx, /*PIC=*/false));
+  Ctx.setObjectFileInfo(MOFI.get());
+
+  raw_svector_ostream OS(Object);
+  MCCodeEmitter *CE = T->createMCCodeEmitter(*MCII, *MRI, Ctx);
+  MCAsmBackend *MAB = T->createMCAsmBackend(*STI, *MRI, MCOptions);
+  std::unique_ptr<MCStreamer> Str(T->createMCObjectStreamer(
+      Triple(TripleName), Ctx, std::unique_ptr<MCAsmBackend>(MAB),
+      MAB->createObjectWriter(OS), std::unique_ptr<MCCodeEmitter>(CE), *STI,
+      /*RelaxAll=*/false, /*IncrementalLinkerCompatible=*/false,
+      /*DWARFMustBeAtTheEnd=*/false));
+
+  std::unique_ptr<MCAsmParser> Parser(
+      createMCAsmParser(SrcMgr, Ctx, *Str, *MAI));
+  std::unique_ptr<MCTargetAsmParser> TAP(
+      T->createMCAsmParser(*STI, *Parser, *MCII, MCOptions));
+  if (!TAP)
+    return false;
+  Parser->setTargetParser(*TAP);
+  return !Parser->Run(/*NoInitialTextSection=*/false);
+}
+
+void runAssembler(benchmark::State &State, const std::string &Asm) {
+  InitializeAllTargetInfos();
+  InitializeAllTargetMCs();
+  InitializeAllAsmParsers();
+  EnableStatistics(/*DoPrintOnExit=*/false);
+
+  size_t ObjectSize = 0;
+  for (auto _ : State) {
+    SmallString<0> Object;
+    if (!assemble(Asm, Object)) {
+      State.SkipWithError("cannot assemble for x86-64");
+      return;
+    }
+    ObjectSize = Object.size();
+  }
+
+  for (const auto &Stat : GetStatistics())
+    if (Stat.first == "RelaxationSteps")
+      State.counters["LayoutPasses"] =
+          double(Stat.second) / State.iterations();
+  ResetStatistics();
+  State.counters["ObjectBytes"] = ObjectSize;
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+
+void BM_BackwardChain(benchmark::State &State) {
+  runAssembler(State, buildBackwardChain(State.range(0)));
+}
+
+void BM_ForwardChain(benchmark::State &State) {
+  runAssembler(State, buildForwardChain(State.range(0)));
+}
+
+} // namespace
+
+BENCHMARK(BM_BackwardChain)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ForwardChain)
+    ->RangeMultiplier(4)
+    ->Range(16, 4096)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,176 @@
+//===- MCStartup.cpp - Target MC setup and table lookup benchmarks --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Measures the per-process work a short-lived MC tool does before it gets to
+// its input, which is dominated by the TableGen-generated target tables:
+//
+// - CreateMC: create the register, asm, subtarget and instruction info of
+//   each built target in Triples.
+// - ParseSystemRegisters: assemble range(0) RISC-V CSR accesses by name,
+//   each of which is a lookup in a generated searchable table index.
+//
+// Targets which are not built are skipped. Load-time relocation of the
+// tables happens before main and is not part of these numbers; compare
+// `readelf -r` of the library or time a trivial tool invocation for it.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/MC/MCAsmBackend.h"
+#include "llvm/MC/MCAsmInfo.h"
+#include "llvm/MC/MCCodeEmitter.h"
+#include "llvm/MC/MCContext.h"
+#include "llvm/MC/MCInstrInfo.h"
+#include "llvm/MC/MCObjectFileInfo.h"
+#include "llvm/MC/MCObjectWriter.h"
+#include "llvm/MC/MCParser/MCAsmParser.h"
+#include "llvm/MC/MCParser/MCTargetAsmParser.h"
+#include "llvm/MC/MCRegisterInfo.h"
+#include "llvm/MC/MCStreamer.h"
+#include "llvm/MC/MCSubtargetInfo.h"
+#include "llvm/MC/MCTargetOptions.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include <memory>
+#include <string>
+
+using namespace llvm;
+
+namespace {
+
+const char *const Triples[] = {
+    "x86_64-unknown-linux-gnu", "aarch64-unknown-linux-gnu",
+    "armv7-unknown-linux-gnueabihf", "riscv64-unknown-linux-gnu",
+    "powerpc64le-unknown-linux-gnu", "amdgcn-amd-amdhsa",
+};
+
+const char *const RISCVTriple = "riscv64-unknown-linux-gnu";
+
+const char *const CSRNames[] = {
+    "mstatus", "misa",     "mie",     "mtvec",     "mscratch", "mepc",
+    "mcause",  "mtval",    "mip",     "sstatus",   "sie",      "stvec",
+    "sepc",    "scause",   "stval",   "satp",      "cycle",    "instret",
+    "fflags",  "frm",      "fcsr",    "vstart",    "vl",       "vtype",
+    "hstatus", "hedeleg",  "hideleg", "hgatp",     "dcsr",     "dpc",
+    "tselect", "mhartid",
+};
+
+void initializeTargets() {
+  InitializeAllTargetInfos();
+  InitializeAllTargetMCs();
+  InitializeAllAsmParsers();
+}
+
+void BM_CreateMC(benchmark::State &State) {
+  initializeTargets();
+
+  unsigned NumTargets = 0;
+  for (auto _ : State) {
+    NumTargets = 0;
+    for (const char *TripleName : Triples) {
+      std::string Error;
+      const Target *T = TargetRegistry::lookupTarget(TripleName, Error);
+      if (!T)
+        continue;
+      MCTargetOptions MCOptions;
+      std::unique_ptr<MCRegisterInfo> MRI(T->createMCRegInfo(TripleName));
+      std::unique_ptr<MCAsmInfo> MAI(
+          T->createMCAsmInfo(*MRI, TripleName, MCOptions));
+      std::unique_ptr<MCSubtargetInfo> STI(
+          T->createMCSubtargetInfo(TripleName, "", ""));
+      std::unique_ptr<MCInstrInfo> MCII(T->createMCInstrInfo());
+      benchmark::DoNotOptimize(MCII.get());
+      ++NumTargets;
+    }
+  }
+  if (!NumTargets)
+    State.SkipWithError("none of the targets is built");
+  State.counters["Targets"] = NumTargets;
+}
+
+std::string buildCSRAccesses(unsigned NumAccesses) {
+  std::string Asm;
+  raw_string_ostream OS(Asm);
+  OS << "\t.text\n";
+  for (unsigned I = 0; I != NumAccesses; ++I)
+    OS << "\tcsrr a0, " << CSRNames[I % array_lengthof(CSRNames)] << "\n";
+  return OS.str();
+}
+
+/// Assembles Asm for RISC-V into an in-memory ELF object. Returns false if
+/// the target is not built or the input does not assemble.
+bool assemble(const std::string &Asm, SmallVectorImpl<char> &Object) {
+  std::string Error;
+  const Target *T = TargetRegistry::lookupTarget(RISCVTriple, Error);
+  if (!T)
+    return false;
+
+  MCTargetOptions MCOptions;
+  std::unique_ptr<MCRegisterInfo> MRI(T->createMCRegInfo(RISCVTriple));
+  std::unique_ptr<MCAsmInfo> MAI(
+      T->createMCAsmInfo(*MRI, RISCVTriple, MCOptions));
+  std::unique_ptr<MCSubtargetInfo> STI(
+      T->createMCSubtargetInfo(RISCVTriple, "generic-rv64", ""));
+  std::unique_ptr<MCInstrInfo> MCII(T->createMCInstrInfo());
+
+  SourceMgr SrcMgr;
+  SrcMgr.AddNewSourceBuffer(MemoryBuffer::getMemBuffer(Asm, "<bench>"),
+                            SMLoc());
+  MCContext Ctx(Triple(RISCVTriple), MAI.get(), MRI.get(), STI.get(), &SrcMgr,
+                &MCOptions);
+  std::unique_ptr<MCObjectFileInfo> MOFI(
+      T->createMCObjectFileInfo(Ctx, /*PIC=*/false));
+  Ctx.setObjectFileInfo(MOFI.get());
+
+  raw_svector_ostream OS(Object);
+  MCCodeEmitter *CE = T->createMCCodeEmitter(*MCII, *MRI, Ctx);
+  MCAsmBackend *MAB = T->createMCAsmBackend(*STI, *MRI, MCOptions);
+  std::unique_ptr<MCStreamer> Str(T->createMCObjectStreamer(
+      Triple(RISCVTriple), Ctx, std::unique_ptr<MCAsmBackend>(MAB),
+      MAB->createObjectWriter(OS), std::unique_ptr<MCCodeEmitter>(CE), *STI,
+      /*RelaxAll=*/false, /*IncrementalLinkerCompatible=*/false,
+      /*DWARFMustBeAtTheEnd=*/false));
+
+  std::unique_ptr<MCAsmParser> Parser(
+      createMCAsmParser(SrcMgr, Ctx, *Str, *MAI));
+  std::unique_ptr<MCTargetAsmParser> TAP(
+      T->createMCAsmParser(*STI, *Parser, *MCII, MCOptions));
+  if (!TAP)
+    return false;
+  Parser->setTargetParser(*TAP);
+  return !Parser->Run(/*NoInitialTextSection=*/false);
+}
+
+void BM_ParseSystemRegisters(benchmark::State &State) {
+  initializeTargets();
+
+  std::string Asm = buildCSRAccesses(State.range(0));
+  for (auto _ : State) {
+    SmallString<0> Object;
+    if (!assemble(Asm, Object)) {
+      State.SkipWithError("cannot assemble for RISC-V");
+      return;
+    }
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+
+} // namespace
+
+BENCHMARK(BM_CreateMC)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ParseSystemRegisters)
+    ->RangeMultiplier(8)
+    ->Range(64, 32768)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,186 @@
+//===- RegAllocSplit.cpp - Register allocator splitting benchmarks --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Measures code generation for the host target on the kind of function that
+// makes live range splitting in the greedy register allocator expensive: the
+// dispatch loop of an interpreter, where a set of state values is live across
+// every case of a large switch and the calls in the cases clobber the
+// registers holding them.
+//
+// - Interpreter: range(0) cases and a fixed number of state values.
+// - InterpreterState: a fixed number of cases and range(0) state values.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/IR/Module.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Target/TargetOptions.h"
+#include <memory>
+
+using namespace llvm;
+
+namespace {
+
+std::unique_ptr<TargetMachine> createHostTargetMachine() {
+  std::string Error;
+  std::string Triple = sys::getProcessTriple();
+  const Target *T = TargetRegistry::lookupTarget(Triple, Error);
+  if (!T)
+    return nullptr;
+  return std::unique_ptr<TargetMachine>(T->createTargetMachine(
+      Triple, "generic", "", TargetOptions(), None, None,
+      CodeGenOpt::Default));
+}
+
+// Builds
+//
+//   i64 @interp(i16* %code, i64 %n)
+//
+// which runs the opcodes in %code through a loop switching over NumCases
+// cases. Every case updates one of NumState values, which are live around the
+// whole loop, and passes another one to an external call.
+std::unique_ptr<Module> buildInterpreter(LLVMContext &Ctx,
+                                         const TargetMachine &TM,
+                                         unsigned NumCases,
+                                         unsigned NumState) {
+  auto M = std::make_unique<Module>("bench", Ctx);
+  M->setTargetTriple(TM.getTargetTriple().str());
+  M->setDataLayout(TM.createDataLayout());
+
+  IRBuilder<> B(Ctx);
+  Type *Int64Ty = B.getInt64Ty();
+  FunctionCallee Ext = M->getOrInsertFunction(
+      "ext", FunctionType::get(Int64Ty, {Int64Ty}, false));
+  Function *F = Function::Create(
+      FunctionType::get(Int64Ty, {B.getInt16Ty()->getPointerTo(), Int64Ty},
+                        false),
+      GlobalValue::ExternalLinkage, "interp", M.get());
+  Argument *Code = F->getArg(0);
+  Argument *N = F->getArg(1);
+
+  BasicBlock *Entry = BasicBlock::Create(Ctx, "entry", F);
+  BasicBlock *Loop = BasicBlock::Create(Ctx, "loop", F);
+  BasicBlock *Latch = BasicBlock::Create(Ctx, "latch", F);
+  BasicBlock *Exit = BasicBlock::Create(Ctx, "exit", F);
+
+  B.SetInsertPoint(Entry);
+  B.CreateBr(Loop);
+
+  // The loop header carries the program counter and the state values.
+  B.SetInsertPoint(Loop);
+  PHINode *PC = B.CreatePHI(Int64Ty, 2, "pc");
+  SmallVector<PHINode *, 32> State;
+  for (unsigned I = 0; I != NumState; ++I) {
+    State.push_back(B.CreatePHI(Int64Ty, 2));
+    State.back()->addIncoming(B.getInt64(I), Entry);
+  }
+  PC->addIncoming(B.getInt64(0), Entry);
+  Value *Op = B.CreateZExt(
+      B.CreateLoad(B.getInt16Ty(), B.CreateGEP(B.getInt16Ty(), Code, PC)),
+      Int64Ty);
+  SwitchInst *SI = B.CreateSwitch(Op, Latch, NumCases);
+
+  // The latch merges the state values from every case.
+  B.SetInsertPoint(Latch);
+  SmallVector<PHINode *, 32> Merged;
+  for (unsigned I = 0; I != NumState; ++I) {
+    Merged.push_back(B.CreatePHI(Int64Ty, NumCases + 1));
+    Merged.back()->addIncoming(State[I], Loop);
+  }
+
+  for (unsigned C = 0; C != NumCases; ++C) {
+    BasicBlock *Case = BasicBlock::Create(Ctx, "case", F, Latch);
+    SI->addCase(B.getInt64(C), Case);
+    B.SetInsertPoint(Case);
+    unsigned Dst = C % NumState;
+    Value *Arg = State[(C + 2) % NumState];
+    Value *Res = B.CreateCall(Ext, {Arg});
+    Value *NewVal = B.CreateAdd(
+        B.CreateMul(State[(C + 1) % NumState], B.getInt64(C + 3)), Res);
+    B.CreateBr(Latch);
+    for (unsigned I = 0; I != NumState; ++I)
+      Merged[I]->addIncoming(I == Dst ? NewVal : State[I], Case);
+  }
+
+  B.SetInsertPoint(Latch);
+  Value *NextPC = B.CreateAdd(PC, B.getInt64(1));
+  PC->addIncoming(NextPC, Latch);
+  for (unsigned I = 0; I != NumState; ++I)
+    State[I]->addIncoming(Merged[I], Latch);
+  B.CreateCondBr(B.CreateICmpEQ(NextPC, N), Exit, Loop);
+
+  B.SetInsertPoint(Exit);
+  Value *Sum = Merged.front();
+  for (unsigned I = 1; I != NumState; ++I)
+    Sum = B.CreateXor(Sum, Merged[I]);
+  B.CreateRet(Sum);
+  return M;
+}
+
+void runCodeGen(benchmark::State &State, unsigned NumCases,
+                unsigned NumState) {
+  InitializeNativeTarget();
+  InitializeNativeTargetAsmPrinter();
+  std::unique_ptr<TargetMachine> TM = createHostTargetMachine();
+  if (!TM) {
+    State.SkipWithError("no target for the host");
+    return;
+  }
+
+  size_t ObjectSize = 0;
+  for (auto _ : State) {
+    State.PauseTiming();
+    LLVMContext Ctx;
+    std::unique_ptr<Module> M =
+        buildInterpreter(Ctx, *TM, NumCases, NumState);
+    SmallString<0> Object;
+    raw_svector_ostream OS(Object);
+    legacy::PassManager PM;
+    if (TM->addPassesToEmitFile(PM, OS, nullptr, CGFT_ObjectFile)) {
+      State.SkipWithError("cannot emit an object file for the host");
+      return;
+    }
+    State.ResumeTiming();
+
+    PM.run(*M);
+    ObjectSize = Object.size();
+  }
+  State.counters["ObjectBytes"] = ObjectSize;
+  State.SetItemsProcessed(State.iterations() * NumCases);
+}
+
+void BM_Interpreter(benchmark::State &State) {
+  runCodeGen(State, State.range(0), 24);
+}
+
+void BM_InterpreterState(benchmark::State &State) {
+  runCodeGen(State, 128, State.range(0));
+}
+
+} // namespace
+
+BENCHMARK(BM_Interpreter)
+    ->RangeMultiplier(4)
+    ->Range(16, 1024)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_InterpreterState)
+    ->RangeMultiplier(2)
+    ->Range(4, 64)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,153 @@
+//===- UseList.cpp - Use and User layout benchmarks -----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Measures the memory taken by operands and the speed of the operations that
+// walk use-lists, on functions shaped like those of a merged LTO module:
+//
+// - Operands: the bytes of Use storage per instruction, for a mix of binary
+//   operators, calls and PHIs, reported as counters.
+// - RAUW: replaceAllUsesWith on a value with many users, which relinks every
+//   Use onto the new value's list.
+// - GetUser: walking the users of a value whose users have many operands,
+//   which finds each User from its Use.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "llvm/IR/BasicBlock.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include <memory>
+
+using namespace llvm;
+
+namespace {
+
+struct TestFunction {
+  LLVMContext Context;
+  std::unique_ptr<Module> M;
+  Function *F;
+  BasicBlock *Entry;
+
+  TestFunction() : M(std::make_unique<Module>("bench", Context)) {
+    Type *Int64Ty = Type::getInt64Ty(Context);
+    FunctionType *FTy = FunctionType::get(Int64Ty, {Int64Ty, Int64Ty}, false);
+    F = Function::Create(FTy, GlobalValue::ExternalLinkage, "f", M.get());
+    Entry = BasicBlock::Create(Context, "entry", F);
+  }
+
+  Argument *getArg(unsigned I) { return F->getArg(I); }
+};
+
+// Builds N instructions in the proportions of an optimized C++ module: mostly
+// binary operators, with calls of a few arguments and PHIs of a few incoming
+// values.
+void buildMixedBody(TestFunction &TF, size_t N) {
+  IRBuilder<> B(TF.Entry);
+  Type *Int64Ty = B.getInt64Ty();
+  FunctionCallee Callee = TF.M->getOrInsertFunction(
+      "callee", FunctionType::get(Int64Ty, {Int64Ty, Int64Ty, Int64Ty}, false));
+  BasicBlock *Loop = BasicBlock::Create(TF.Context, "loop", TF.F);
+  BasicBlock *Exit = BasicBlock::Create(TF.Context, "exit", TF.F);
+  B.CreateBr(Loop);
+  B.SetInsertPoint(Loop);
+  SmallVector<PHINode *, 16> PHIs;
+  Value *Last = TF.getArg(0);
+  for (size_t I = 0; I != N; ++I) {
+    switch (I % 8) {
+    case 0: {
+      // The PHIs go at the top of the loop; their back edge values are
+      // filled in once the loop body exists.
+      PHINode *PN = PHINode::Create(Int64Ty, 2);
+      Loop->getInstList().push_front(PN);
+      PN->addIncoming(TF.getArg(1), TF.Entry);
+      PHIs.push_back(PN);
+      break;
+    }
+    case 1:
+      Last = B.CreateCall(Callee, {Last, TF.getArg(0), TF.getArg(1)});
+      break;
+    default:
+      Last = B.CreateAdd(Last, TF.getArg(I % 2));
+      break;
+    }
+  }
+  for (PHINode *PN : PHIs)
+    PN->addIncoming(Last, Loop);
+  B.CreateCondBr(B.CreateICmpEQ(Last, TF.getArg(1)), Exit, Loop);
+  B.SetInsertPoint(Exit);
+  B.CreateRet(Last);
+}
+
+void BM_OperandMemory(benchmark::State &State) {
+  size_t NumOperands = 0, NumInstructions = 0;
+  for (auto _ : State) {
+    TestFunction TF;
+    buildMixedBody(TF, State.range(0));
+    State.PauseTiming();
+    NumOperands = NumInstructions = 0;
+    for (BasicBlock &BB : *TF.F)
+      for (Instruction &I : BB) {
+        NumOperands += I.getNumOperands();
+        ++NumInstructions;
+      }
+    State.ResumeTiming();
+  }
+  State.counters["UseBytes"] = NumOperands * sizeof(Use);
+  State.counters["UseBytesPerInst"] =
+      double(NumOperands * sizeof(Use)) / NumInstructions;
+  State.SetItemsProcessed(State.iterations() * State.range(0));
+}
+
+void BM_RAUW(benchmark::State &State) {
+  TestFunction TF;
+  IRBuilder<> B(TF.Entry);
+  Value *A = B.CreateAdd(TF.getArg(0), TF.getArg(1));
+  Value *C = B.CreateSub(TF.getArg(0), TF.getArg(1));
+  for (int64_t I = 0; I != State.range(0); ++I)
+    B.CreateMul(A, TF.getArg(I % 2));
+  B.CreateRet(A);
+  for (auto _ : State) {
+    A->replaceAllUsesWith(C);
+    C->replaceAllUsesWith(A);
+  }
+  State.SetItemsProcessed(State.iterations() * State.range(0) * 2);
+}
+
+// Calls with range(0) operands each, so that every getUser() walks the
+// waymarks of an operand list of that length.
+void BM_GetUser(benchmark::State &State) {
+  TestFunction TF;
+  Type *Int64Ty = Type::getInt64Ty(TF.Context);
+  unsigned NumArgs = State.range(0);
+  SmallVector<Type *, 16> ArgTys(NumArgs, Int64Ty);
+  FunctionCallee Callee = TF.M->getOrInsertFunction(
+      "callee", FunctionType::get(Int64Ty, ArgTys, false));
+  IRBuilder<> B(TF.Entry);
+  SmallVector<Value *, 16> Args(NumArgs, TF.getArg(0));
+  const unsigned NumCalls = 1024;
+  for (unsigned I = 0; I != NumCalls; ++I)
+    B.CreateCall(Callee, Args);
+  B.CreateRet(TF.getArg(1));
+  for (auto _ : State)
+    for (User *U : TF.getArg(0)->users())
+      benchmark::DoNotOptimize(U);
+  State.SetItemsProcessed(State.iterations() * NumCalls * NumArgs);
+}
+
+} // namespace
+
+BENCHMARK(BM_OperandMemory)->Range(1 << 10, 1 << 18);
+BENCHMARK(BM_RAUW)->Range(1 << 6, 1 << 16);
+BENCHMARK(BM_GetUser)->RangeMultiplier(4)->Range(1, 256);
+
+BENCHMARK_MAIN();
@@ -137,6 +137,26 @@ if(LLVM_ENABLE_ZLIB)
   set(LLVM_ENABLE_ZLIB "${HAVE_ZLIB}")
 endif()
 
+if(LLVM_ENABLE_ZSTD)
+  if(LLVM_ENABLE_ZSTD STREQUAL FORCE_ON)
+    find_package(zstd REQUIRED)
+  elseif(NOT LLVM_USE_SANITIZER MATCHES "Memory.*")
+    find_package(zstd)
+  endif()
+  if(zstd_FOUND)
+    # ZSTD_compress2 and the advanced streaming API appeared in zstd 1.4.0.
+    cmake_push_check_state()
+    list(APPEND CMAKE_REQUIRED_INCLUDES ${zstd_INCLUDE_DIRS})
+    list(APPEND CMAKE_REQUIRED_LIBRARIES ${zstd_LIBRARY})
+    check_symbol_exists(ZSTD_compress2 zstd.h HAVE_ZSTD)
+    cmake_pop_check_state()
+    if(LLVM_ENABLE_ZSTD STREQUAL FORCE_ON AND NOT HAVE_ZSTD)
+      message(FATAL_ERROR "Failed to configure zstd")
+    endif()
+  endif()
+  set(LLVM_ENABLE_ZSTD "${HAVE_ZSTD}")
+endif()
+
 if(LLVM_ENABLE_LIBXML2)
   if(LLVM_ENABLE_LIBXML2 STREQUAL FORCE_ON)
     find_package(LibXml2 REQUIRED)
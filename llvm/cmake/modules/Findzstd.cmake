@@ -0,0 +1,30 @@
+# Try to find the zstd library
+#
+# If successful, the following variables will be defined:
+# zstd_INCLUDE_DIRS
+# zstd_LIBRARY
+# zstd_FOUND
+#
+# Additionally, the following import target will be defined:
+# zstd::libzstd
+
+find_path(zstd_INCLUDE_DIR NAMES zstd.h)
+find_library(zstd_LIBRARY NAMES zstd zstd_static)
+
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(
+    zstd DEFAULT_MSG
+    zstd_LIBRARY zstd_INCLUDE_DIR
+)
+
+if(zstd_FOUND)
+  set(zstd_INCLUDE_DIRS ${zstd_INCLUDE_DIR})
+  if(NOT TARGET zstd::libzstd)
+    add_library(zstd::libzstd UNKNOWN IMPORTED)
+    set_target_properties(zstd::libzstd PROPERTIES
+      IMPORTED_LOCATION ${zstd_LIBRARY}
+      INTERFACE_INCLUDE_DIRECTORIES ${zstd_INCLUDE_DIR})
+  endif()
+endif()
+
+mark_as_advanced(zstd_INCLUDE_DIR zstd_LIBRARY)
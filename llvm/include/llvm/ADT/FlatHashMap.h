@@ -0,0 +1,702 @@
+//===- llvm/ADT/FlatHashMap.h - Open-addressing hash map --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the FlatHashMap class, an open-addressing hash map that
+// keeps one control byte per bucket and probes a group of control bytes at a
+// time with SIMD instructions where available.
+//
+// The table stores its buckets and an array of control bytes in a single
+// allocation. A control byte is either empty, deleted (a tombstone), or holds
+// the low 7 bits of the hash of the key in the corresponding bucket. A lookup
+// compares those 7 bits against a whole group of control bytes at once and
+// only touches the buckets whose bits match, so most unsuccessful probes never
+// read a key. The first Group::Width - 1 control bytes are mirrored after the
+// end of the array, which lets a group be loaded at any bucket index.
+//
+// FlatHashMap uses the isEqual and getHashValue members of DenseMapInfo-style
+// traits. Unlike DenseMap, it does not reserve an empty and a tombstone key,
+// so any value of KeyT can be stored.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_ADT_FLATHASHMAP_H
+#define LLVM_ADT_FLATHASHMAP_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/DenseMapInfo.h"
+#include "llvm/ADT/EpochTracker.h"
+#include "llvm/Support/Compiler.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemAlloc.h"
+#include "llvm/Support/type_traits.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LLVM_FLATHASHMAP_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON) && !defined(__AARCH64EB__)
+#define LLVM_FLATHASHMAP_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace llvm {
+
+namespace detail {
+
+/// Control byte values of buckets that don't hold an entry. Control bytes of
+/// full buckets are in [0, 127].
+enum : int8_t { FlatHashCtrlEmpty = -128, FlatHashCtrlDeleted = -2 };
+
+/// A set of buckets within a group of \p Width buckets. Bucket I is
+/// represented by a bit in [I << Shift, (I + 1) << Shift) of the mask.
+template <typename T, unsigned Width, unsigned Shift> class FlatHashBitMask {
+  static constexpr unsigned UnusedBits = sizeof(T) * 8 - (Width << Shift);
+  T Mask;
+
+public:
+  explicit FlatHashBitMask(T Mask) : Mask(Mask) {}
+  explicit operator bool() const { return Mask != 0; }
+
+  // The following must not be called on an empty set.
+
+  /// Returns the index of the first bucket in the set.
+  unsigned lowest() const {
+    return countTrailingZeros(Mask, ZB_Undefined) >> Shift;
+  }
+  void clearLowest() { Mask &= Mask - 1; }
+
+  /// Returns the number of buckets before the first bucket in the set.
+  unsigned trailingZeros() const { return lowest(); }
+  /// Returns the number of buckets after the last bucket in the set.
+  unsigned leadingZeros() const {
+    return (countLeadingZeros(Mask, ZB_Undefined) - UnusedBits) >> Shift;
+  }
+};
+
+#if LLVM_FLATHASHMAP_SSE2
+/// A group of 16 control bytes, compared with SSE2 instructions.
+class FlatHashGroup {
+  __m128i Ctrl;
+
+public:
+  static constexpr unsigned Width = 16;
+  using BitMask = FlatHashBitMask<uint32_t, Width, 0>;
+
+  explicit FlatHashGroup(const int8_t *Pos)
+      : Ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i *>(Pos))) {}
+
+  /// Returns the buckets whose control byte is \p H2.
+  BitMask match(int8_t H2) const {
+    return BitMask(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(H2), Ctrl)));
+  }
+  BitMask matchEmpty() const { return match(FlatHashCtrlEmpty); }
+  BitMask matchEmptyOrDeleted() const {
+    return BitMask(
+        _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), Ctrl)));
+  }
+};
+#elif LLVM_FLATHASHMAP_NEON
+/// A group of 8 control bytes, compared with NEON instructions.
+class FlatHashGroup {
+  int8x8_t Ctrl;
+
+public:
+  static constexpr unsigned Width = 8;
+  using BitMask = FlatHashBitMask<uint64_t, Width, 3>;
+
+private:
+  static BitMask toMask(uint8x8_t V) {
+    return BitMask(vget_lane_u64(vreinterpret_u64_u8(V), 0) &
+                   0x8080808080808080ULL);
+  }
+
+public:
+  explicit FlatHashGroup(const int8_t *Pos) : Ctrl(vld1_s8(Pos)) {}
+
+  /// Returns the buckets whose control byte is \p H2.
+  BitMask match(int8_t H2) const {
+    return toMask(vceq_s8(Ctrl, vdup_n_s8(H2)));
+  }
+  BitMask matchEmpty() const { return match(FlatHashCtrlEmpty); }
+  BitMask matchEmptyOrDeleted() const {
+    return toMask(vcgt_s8(vdup_n_s8(-1), Ctrl));
+  }
+};
+#else
+/// A group of 8 control bytes, compared as a 64-bit word.
+class FlatHashGroup {
+  static constexpr uint64_t Lsbs = 0x0101010101010101ULL;
+  static constexpr uint64_t Msbs = 0x8080808080808080ULL;
+  uint64_t Ctrl;
+
+public:
+  static constexpr unsigned Width = 8;
+  using BitMask = FlatHashBitMask<uint64_t, Width, 3>;
+
+  explicit FlatHashGroup(const int8_t *Pos)
+      : Ctrl(support::endian::read64le(Pos)) {}
+
+  /// Returns the buckets whose control byte is \p H2. This may include a false
+  /// positive following a true match, which the caller filters out when it
+  /// compares the keys.
+  BitMask match(int8_t H2) const {
+    uint64_t X = Ctrl ^ (Lsbs * static_cast<uint8_t>(H2));
+    return BitMask((X - Lsbs) & ~X & Msbs);
+  }
+  // Empty is 0b10000000 and deleted is 0b11111110, so empty and deleted
+  // control bytes are those with the high bit set and bit 1 or bit 0 clear.
+  BitMask matchEmpty() const { return BitMask(Ctrl & (~Ctrl << 6) & Msbs); }
+  BitMask matchEmptyOrDeleted() const {
+    return BitMask(Ctrl & (~Ctrl << 7) & Msbs);
+  }
+};
+#endif
+
+} // end namespace detail
+
+template <typename KeyT, typename ValueT,
+          typename KeyInfoT = DenseMapInfo<KeyT>>
+class FlatHashMap : public DebugEpochBase {
+  template <typename T>
+  using const_arg_type_t = typename const_pointer_or_const_ref<T>::type;
+  using BucketT = detail::DenseMapPair<KeyT, ValueT>;
+  using Group = detail::FlatHashGroup;
+
+  BucketT *Buckets = nullptr;
+  int8_t *Ctrl = nullptr;
+  unsigned NumEntries = 0;
+  unsigned NumTombstones = 0;
+  unsigned NumBuckets = 0;
+
+  template <bool IsConst> class Iterator;
+
+public:
+  using size_type = unsigned;
+  using key_type = KeyT;
+  using mapped_type = ValueT;
+  using value_type = BucketT;
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  /// Create a FlatHashMap that can hold \p InitialReserve entries before
+  /// growing.
+  explicit FlatHashMap(unsigned InitialReserve = 0) {
+    if (InitialReserve)
+      allocateBuckets(getMinBucketToReserveForEntries(InitialReserve));
+  }
+
+  FlatHashMap(const FlatHashMap &Other) { copyFrom(Other); }
+
+  FlatHashMap(FlatHashMap &&Other) { swap(Other); }
+
+  FlatHashMap(std::initializer_list<value_type> Vals)
+      : FlatHashMap(Vals.size()) {
+    insert(Vals.begin(), Vals.end());
+  }
+
+  template <typename InputIt> FlatHashMap(const InputIt &I, const InputIt &E) {
+    reserve(std::distance(I, E));
+    insert(I, E);
+  }
+
+  ~FlatHashMap() {
+    destroyAll();
+    deallocateBuckets();
+  }
+
+  FlatHashMap &operator=(const FlatHashMap &Other) {
+    if (&Other != this) {
+      FlatHashMap Tmp(Other);
+      swap(Tmp);
+    }
+    return *this;
+  }
+
+  FlatHashMap &operator=(FlatHashMap &&Other) {
+    FlatHashMap Tmp(std::move(Other));
+    swap(Tmp);
+    return *this;
+  }
+
+  void swap(FlatHashMap &RHS) {
+    incrementEpoch();
+    RHS.incrementEpoch();
+    std::swap(Buckets, RHS.Buckets);
+    std::swap(Ctrl, RHS.Ctrl);
+    std::swap(NumEntries, RHS.NumEntries);
+    std::swap(NumTombstones, RHS.NumTombstones);
+    std::swap(NumBuckets, RHS.NumBuckets);
+  }
+
+  iterator begin() {
+    if (empty())
+      return end();
+    return iterator(Buckets, Ctrl, Ctrl + NumBuckets, *this);
+  }
+  iterator end() {
+    return iterator(Buckets + NumBuckets, Ctrl + NumBuckets,
+                    Ctrl + NumBuckets, *this);
+  }
+  const_iterator begin() const {
+    if (empty())
+      return end();
+    return const_iterator(Buckets, Ctrl, Ctrl + NumBuckets, *this);
+  }
+  const_iterator end() const {
+    return const_iterator(Buckets + NumBuckets, Ctrl + NumBuckets,
+                          Ctrl + NumBuckets, *this);
+  }
+
+  LLVM_NODISCARD bool empty() const { return NumEntries == 0; }
+  unsigned size() const { return NumEntries; }
+
+  /// Grow the map so that it can contain at least \p NumEntries items before
+  /// resizing again.
+  void reserve(size_type NumEntries) {
+    unsigned NewNumBuckets = getMinBucketToReserveForEntries(NumEntries);
+    incrementEpoch();
+    if (NewNumBuckets > NumBuckets)
+      rehash(NewNumBuckets);
+  }
+
+  void clear() {
+    incrementEpoch();
+    if (NumEntries == 0 && NumTombstones == 0)
+      return;
+    destroyAll();
+    std::memset(Ctrl, detail::FlatHashCtrlEmpty, getNumCtrlBytes(NumBuckets));
+    NumEntries = 0;
+    NumTombstones = 0;
+  }
+
+  /// Return 1 if the specified key is in the map, 0 otherwise.
+  size_type count(const_arg_type_t<KeyT> Val) const {
+    return lookupBucket(Val) ? 1 : 0;
+  }
+
+  bool contains(const_arg_type_t<KeyT> Val) const {
+    return lookupBucket(Val) != nullptr;
+  }
+
+  iterator find(const_arg_type_t<KeyT> Val) { return find_as(Val); }
+  const_iterator find(const_arg_type_t<KeyT> Val) const {
+    return find_as(Val);
+  }
+
+  /// Alternate version of find() which allows a different, and possibly less
+  /// expensive, key type. The KeyInfoT is responsible for supplying methods
+  /// getHashValue(LookupKeyT) and isEqual(LookupKeyT, KeyT) for each key type
+  /// used.
+  template <class LookupKeyT> iterator find_as(const LookupKeyT &Val) {
+    if (const BucketT *B = lookupBucket(Val))
+      return makeIterator(const_cast<BucketT *>(B));
+    return end();
+  }
+  template <class LookupKeyT>
+  const_iterator find_as(const LookupKeyT &Val) const {
+    if (const BucketT *B = lookupBucket(Val))
+      return makeIterator(B);
+    return end();
+  }
+
+  /// Return the entry for the specified key, or a default constructed value
+  /// if no such entry exists.
+  ValueT lookup(const_arg_type_t<KeyT> Val) const {
+    if (const BucketT *B = lookupBucket(Val))
+      return B->getSecond();
+    return ValueT();
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // If the key is already in the map, it returns false and doesn't update the
+  // value.
+  std::pair<iterator, bool> insert(const std::pair<KeyT, ValueT> &KV) {
+    return try_emplace(KV.first, KV.second);
+  }
+  std::pair<iterator, bool> insert(std::pair<KeyT, ValueT> &&KV) {
+    return try_emplace(std::move(KV.first), std::move(KV.second));
+  }
+
+  /// Range insertion of pairs.
+  template <typename InputIt> void insert(InputIt I, InputIt E) {
+    for (; I != E; ++I)
+      insert(*I);
+  }
+
+  // Inserts key,value pair into the map if the key isn't already in the map.
+  // The value is constructed in-place if the key is not in the map, otherwise
+  // it is not moved.
+  template <typename... Ts>
+  std::pair<iterator, bool> try_emplace(KeyT &&Key, Ts &&... Args) {
+    return tryEmplaceImpl(std::move(Key), std::forward<Ts>(Args)...);
+  }
+  template <typename... Ts>
+  std::pair<iterator, bool> try_emplace(const KeyT &Key, Ts &&... Args) {
+    return tryEmplaceImpl(Key, std::forward<Ts>(Args)...);
+  }
+
+  template <typename V>
+  std::pair<iterator, bool> insert_or_assign(const KeyT &Key, V &&Val) {
+    auto Ret = try_emplace(Key, std::forward<V>(Val));
+    if (!Ret.second)
+      Ret.first->second = std::forward<V>(Val);
+    return Ret;
+  }
+  template <typename V>
+  std::pair<iterator, bool> insert_or_assign(KeyT &&Key, V &&Val) {
+    auto Ret = try_emplace(std::move(Key), std::forward<V>(Val));
+    if (!Ret.second)
+      Ret.first->second = std::forward<V>(Val);
+    return Ret;
+  }
+
+  bool erase(const KeyT &Val) {
+    const BucketT *B = lookupBucket(Val);
+    if (!B)
+      return false;
+    eraseBucket(B - Buckets);
+    return true;
+  }
+  void erase(iterator I) { eraseBucket(&*I - Buckets); }
+
+  value_type &FindAndConstruct(const KeyT &Key) {
+    return *try_emplace(Key).first;
+  }
+  ValueT &operator[](const KeyT &Key) { return FindAndConstruct(Key).second; }
+
+  value_type &FindAndConstruct(KeyT &&Key) {
+    return *try_emplace(std::move(Key)).first;
+  }
+  ValueT &operator[](KeyT &&Key) {
+    return FindAndConstruct(std::move(Key)).second;
+  }
+
+  /// Return the approximate size (in bytes) of the actual map. This is just
+  /// the raw memory used by the map; if entries point to heap data it is not
+  /// included.
+  size_t getMemorySize() const { return getAllocationSize(NumBuckets); }
+
+private:
+  /// Mixes the 32-bit hash from KeyInfoT into 64 bits. The low 7 bits of the
+  /// result are stored in the control byte, and the remaining bits pick the
+  /// first group to probe. Many DenseMapInfo hashes are weak in their low
+  /// bits, so fold the well-mixed high half of the product into them.
+  template <typename LookupKeyT>
+  static uint64_t getHash(const LookupKeyT &Val) {
+    uint64_t H = KeyInfoT::getHashValue(Val) * 0x9E3779B97F4A7C15ULL;
+    return H ^ (H >> 32);
+  }
+  static int8_t getH2(uint64_t Hash) { return Hash & 0x7F; }
+
+  static unsigned getNumCtrlBytes(unsigned NumBuckets) {
+    return NumBuckets + Group::Width - 1;
+  }
+  static size_t getAllocationSize(unsigned NumBuckets) {
+    if (NumBuckets == 0)
+      return 0;
+    return sizeof(BucketT) * NumBuckets + getNumCtrlBytes(NumBuckets);
+  }
+
+  /// Returns the number of buckets to allocate to ensure that the map can
+  /// accommodate \p NumEntries without growing, with a maximum load factor of
+  /// 7/8.
+  static unsigned getMinBucketToReserveForEntries(unsigned NumEntries) {
+    if (NumEntries == 0)
+      return 0;
+    return std::max<uint64_t>(NextPowerOf2(uint64_t(NumEntries) * 8 / 7),
+                              Group::Width);
+  }
+
+  iterator makeIterator(BucketT *B) {
+    return iterator(B, Ctrl + (B - Buckets), Ctrl + NumBuckets, *this, true);
+  }
+  const_iterator makeIterator(const BucketT *B) const {
+    return const_iterator(B, Ctrl + (B - Buckets), Ctrl + NumBuckets, *this,
+                          true);
+  }
+
+  void setCtrl(unsigned I, int8_t Val) {
+    Ctrl[I] = Val;
+    if (I < Group::Width - 1)
+      Ctrl[NumBuckets + I] = Val;
+  }
+
+  /// Probes groups starting at the bucket selected by \p Hash. The sequence
+  /// advances by Group::Width, 2 * Group::Width, ... buckets, which visits
+  /// every group of a power-of-two sized table.
+  template <typename LookupKeyT>
+  const BucketT *lookupBucket(const LookupKeyT &Val, uint64_t Hash) const {
+    if (NumBuckets == 0)
+      return nullptr;
+    const unsigned Mask = NumBuckets - 1;
+    const int8_t H2 = getH2(Hash);
+    unsigned Pos = (Hash >> 7) & Mask;
+    for (unsigned Step = Group::Width;; Step += Group::Width) {
+      Group G(Ctrl + Pos);
+      for (auto M = G.match(H2); M; M.clearLowest()) {
+        const BucketT *B = Buckets + ((Pos + M.lowest()) & Mask);
+        if (LLVM_LIKELY(KeyInfoT::isEqual(Val, B->getFirst())))
+          return B;
+      }
+      if (LLVM_LIKELY(G.matchEmpty()))
+        return nullptr;
+      Pos = (Pos + Step) & Mask;
+    }
+  }
+  template <typename LookupKeyT>
+  const BucketT *lookupBucket(const LookupKeyT &Val) const {
+    return lookupBucket(Val, getHash(Val));
+  }
+
+  /// Returns the first empty or deleted bucket in the probe sequence of
+  /// \p Hash.
+  unsigned findNonFullBucket(uint64_t Hash) const {
+    const unsigned Mask = NumBuckets - 1;
+    unsigned Pos = (Hash >> 7) & Mask;
+    for (unsigned Step = Group::Width;; Step += Group::Width) {
+      if (auto M = Group(Ctrl + Pos).matchEmptyOrDeleted())
+        return (Pos + M.lowest()) & Mask;
+      Pos = (Pos + Step) & Mask;
+    }
+  }
+
+  /// Claims a bucket for a new entry with hash \p Hash and returns its index,
+  /// growing or rehashing the table if it would exceed the 7/8 maximum load
+  /// factor.
+  unsigned prepareInsert(uint64_t Hash) {
+    incrementEpoch();
+    if (NumBuckets == 0)
+      allocateBuckets(Group::Width);
+    unsigned I = findNonFullBucket(Hash);
+    if (Ctrl[I] == detail::FlatHashCtrlEmpty &&
+        uint64_t(NumEntries + NumTombstones + 1) * 8 >
+            uint64_t(NumBuckets) * 7) {
+      // If tombstones take up enough of the table, rehashing at the same size
+      // frees sufficient space, and doing so is cheaper than growing.
+      if (uint64_t(NumEntries + 1) * 32 <= uint64_t(NumBuckets) * 25)
+        rehash(NumBuckets);
+      else
+        rehash(NumBuckets * 2);
+      I = findNonFullBucket(Hash);
+    }
+    if (Ctrl[I] == detail::FlatHashCtrlDeleted)
+      --NumTombstones;
+    setCtrl(I, getH2(Hash));
+    ++NumEntries;
+    return I;
+  }
+
+  template <typename KeyArgT, typename... Ts>
+  std::pair<iterator, bool> tryEmplaceImpl(KeyArgT &&Key, Ts &&... Args) {
+    uint64_t Hash = getHash(Key);
+    if (const BucketT *B = lookupBucket(Key, Hash))
+      return std::make_pair(makeIterator(const_cast<BucketT *>(B)), false);
+
+    // prepareInsert() may reallocate Buckets, so call it first.
+    unsigned I = prepareInsert(Hash);
+    BucketT *B = Buckets + I;
+    ::new (&B->getFirst()) KeyT(std::forward<KeyArgT>(Key));
+    ::new (&B->getSecond()) ValueT(std::forward<Ts>(Args)...);
+    return std::make_pair(makeIterator(B), true);
+  }
+
+  void eraseBucket(unsigned I) {
+    Buckets[I].getSecond().~ValueT();
+    Buckets[I].getFirst().~KeyT();
+    --NumEntries;
+
+    // If no group of buckets containing I has ever been full, no probe
+    // sequence has skipped past I, and the bucket can be marked empty rather
+    // than deleted.
+    const unsigned Mask = NumBuckets - 1;
+    auto EmptyBefore = Group(Ctrl + ((I - Group::Width) & Mask)).matchEmpty();
+    auto EmptyAfter = Group(Ctrl + I).matchEmpty();
+    if (EmptyBefore && EmptyAfter &&
+        EmptyAfter.trailingZeros() + EmptyBefore.leadingZeros() <
+            Group::Width) {
+      setCtrl(I, detail::FlatHashCtrlEmpty);
+    } else {
+      setCtrl(I, detail::FlatHashCtrlDeleted);
+      ++NumTombstones;
+    }
+  }
+
+  void allocateBuckets(unsigned Num) {
+    assert(isPowerOf2_32(Num) && Num >= Group::Width &&
+           "# buckets must be a power of two no smaller than a group!");
+    NumBuckets = Num;
+    Buckets = static_cast<BucketT *>(
+        allocate_buffer(getAllocationSize(Num), alignof(BucketT)));
+    Ctrl = reinterpret_cast<int8_t *>(Buckets + Num);
+    std::memset(Ctrl, detail::FlatHashCtrlEmpty, getNumCtrlBytes(Num));
+    NumEntries = 0;
+    NumTombstones = 0;
+  }
+
+  void deallocateBuckets() {
+    if (NumBuckets)
+      deallocate_buffer(Buckets, getAllocationSize(NumBuckets),
+                        alignof(BucketT));
+  }
+
+  void destroyAll() {
+    for (unsigned I = 0; I != NumBuckets; ++I) {
+      if (Ctrl[I] >= 0) {
+        Buckets[I].getSecond().~ValueT();
+        Buckets[I].getFirst().~KeyT();
+      }
+    }
+  }
+
+  void rehash(unsigned Num) {
+    BucketT *OldBuckets = Buckets;
+    int8_t *OldCtrl = Ctrl;
+    unsigned OldNumBuckets = NumBuckets;
+    unsigned OldNumEntries = NumEntries;
+    allocateBuckets(Num);
+    NumEntries = OldNumEntries;
+
+    for (unsigned I = 0; I != OldNumBuckets; ++I) {
+      if (OldCtrl[I] < 0)
+        continue;
+      BucketT &Old = OldBuckets[I];
+      uint64_t Hash = getHash(Old.getFirst());
+      unsigned J = findNonFullBucket(Hash);
+      setCtrl(J, getH2(Hash));
+      ::new (&Buckets[J].getFirst()) KeyT(std::move(Old.getFirst()));
+      ::new (&Buckets[J].getSecond()) ValueT(std::move(Old.getSecond()));
+      Old.getSecond().~ValueT();
+      Old.getFirst().~KeyT();
+    }
+
+    if (OldNumBuckets)
+      deallocate_buffer(OldBuckets, getAllocationSize(OldNumBuckets),
+                        alignof(BucketT));
+  }
+
+  void copyFrom(const FlatHashMap &Other) {
+    if (Other.NumBuckets == 0)
+      return;
+    allocateBuckets(Other.NumBuckets);
+    std::memcpy(Ctrl, Other.Ctrl, getNumCtrlBytes(NumBuckets));
+    for (unsigned I = 0; I != NumBuckets; ++I) {
+      if (Ctrl[I] >= 0) {
+        ::new (&Buckets[I].getFirst()) KeyT(Other.Buckets[I].getFirst());
+        ::new (&Buckets[I].getSecond()) ValueT(Other.Buckets[I].getSecond());
+      }
+    }
+    NumEntries = Other.NumEntries;
+    NumTombstones = Other.NumTombstones;
+  }
+};
+
+template <typename KeyT, typename ValueT, typename KeyInfoT>
+template <bool IsConst>
+class FlatHashMap<KeyT, ValueT, KeyInfoT>::Iterator
+    : DebugEpochBase::HandleBase {
+  friend class FlatHashMap;
+  friend class Iterator<!IsConst>;
+
+public:
+  using difference_type = ptrdiff_t;
+  using value_type =
+      typename std::conditional<IsConst, const BucketT, BucketT>::type;
+  using pointer = value_type *;
+  using reference = value_type &;
+  using iterator_category = std::forward_iterator_tag;
+
+private:
+  pointer Ptr = nullptr;
+  const int8_t *CtrlPtr = nullptr;
+  const int8_t *CtrlEnd = nullptr;
+
+  Iterator(pointer Pos, const int8_t *CtrlPos, const int8_t *CtrlE,
+           const DebugEpochBase &Epoch, bool NoAdvance = false)
+      : DebugEpochBase::HandleBase(&Epoch), Ptr(Pos), CtrlPtr(CtrlPos),
+        CtrlEnd(CtrlE) {
+    assert(isHandleInSync() && "invalid construction!");
+    if (!NoAdvance)
+      AdvancePastEmptyBuckets();
+  }
+
+  void AdvancePastEmptyBuckets() {
+    while (CtrlPtr != CtrlEnd && *CtrlPtr < 0) {
+      ++CtrlPtr;
+      ++Ptr;
+    }
+  }
+
+public:
+  Iterator() = default;
+
+  // Converting ctor from non-const iterators to const iterators. SFINAE'd out
+  // for const iterator destinations so it doesn't end up as a user defined
+  // copy constructor.
+  template <bool IsConstSrc,
+            typename = std::enable_if_t<!IsConstSrc && IsConst>>
+  Iterator(const Iterator<IsConstSrc> &I)
+      : DebugEpochBase::HandleBase(I), Ptr(I.Ptr), CtrlPtr(I.CtrlPtr),
+        CtrlEnd(I.CtrlEnd) {}
+
+  reference operator*() const {
+    assert(isHandleInSync() && "invalid iterator access!");
+    assert(CtrlPtr != CtrlEnd && "dereferencing end() iterator");
+    return *Ptr;
+  }
+  pointer operator->() const {
+    assert(isHandleInSync() && "invalid iterator access!");
+    assert(CtrlPtr != CtrlEnd && "dereferencing end() iterator");
+    return Ptr;
+  }
+
+  friend bool operator==(const Iterator &LHS, const Iterator &RHS) {
+    assert((!LHS.Ptr || LHS.isHandleInSync()) && "handle not in sync!");
+    assert((!RHS.Ptr || RHS.isHandleInSync()) && "handle not in sync!");
+    assert(LHS.getEpochAddress() == RHS.getEpochAddress() &&
+           "comparing incomparable iterators!");
+    return LHS.Ptr == RHS.Ptr;
+  }
+  friend bool operator!=(const Iterator &LHS, const Iterator &RHS) {
+    return !(LHS == RHS);
+  }
+
+  Iterator &operator++() { // Preincrement
+    assert(isHandleInSync() && "invalid iterator access!");
+    assert(CtrlPtr != CtrlEnd && "incrementing end() iterator");
+    ++CtrlPtr;
+    ++Ptr;
+    AdvancePastEmptyBuckets();
+    return *this;
+  }
+  Iterator operator++(int) { // Postincrement
+    assert(isHandleInSync() && "invalid iterator access!");
+    Iterator Tmp = *this;
+    ++*this;
+    return Tmp;
+  }
+};
+
+template <typename KeyT, typename ValueT, typename KeyInfoT>
+inline size_t capacity_in_bytes(const FlatHashMap<KeyT, ValueT, KeyInfoT> &X) {
+  return X.getMemorySize();
+}
+
+} // end namespace llvm
+
+#endif // LLVM_ADT_FLATHASHMAP_H
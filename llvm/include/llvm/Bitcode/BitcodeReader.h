@@ -21,6 +21,7 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Threading.h"
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -153,6 +154,13 @@ typedef llvm::function_ref<Optional<std::string>(StringRef)>
       std::unique_ptr<MemoryBuffer> &&Buffer, LLVMContext &Context,
       bool ShouldLazyLoadMetadata = false, bool IsImporting = false);
 
+  /// Materialize all of \p M, which must have been read lazily from bitcode,
+  /// like Module::materializeAll() does. While this thread builds the IR of a
+  /// function, the records of the function bodies after it are decoded on the
+  /// threads of \p S. Building the IR itself stays on this thread, because an
+  /// LLVMContext can only be used by one thread at a time.
+  Error materializeAllInParallel(Module &M, ThreadPoolStrategy S);
+
   /// Read the header of the specified bitcode buffer and extract just the
   /// triple information. If successful, this returns a string. On error, this
   /// returns "".
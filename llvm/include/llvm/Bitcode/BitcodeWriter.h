@@ -13,11 +13,13 @@
 #ifndef LLVM_BITCODE_BITCODEWRITER_H
 #define LLVM_BITCODE_BITCODEWRITER_H
 
+#include "llvm/ADT/Optional.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/IR/ModuleSummaryIndex.h"
 #include "llvm/MC/StringTableBuilder.h"
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Threading.h"
 #include <map>
 #include <memory>
 #include <string>
@@ -45,6 +47,8 @@ class raw_ostream;
 
     std::vector<Module *> Mods;
 
+    Optional<ThreadPoolStrategy> EncodeStrategy;
+
   public:
     /// Create a BitcodeWriter that writes to Buffer.
     BitcodeWriter(SmallVectorImpl<char> &Buffer, raw_fd_stream *FS = nullptr);
@@ -86,6 +90,12 @@ class raw_ostream;
     /// Can be used to produce the same module hash for a minimized bitcode
     /// used just for the thin link as in the regular full bitcode that will
     /// be used in the backend.
+    /// Encode the function blocks of modules written after this call on
+    /// threads picked by \p S. The bitcode is the same as when it is written
+    /// on one thread. Modules that preserve use-list order are always written
+    /// on one thread.
+    void setEncodeStrategy(ThreadPoolStrategy S) { EncodeStrategy = S; }
+
     void writeModule(const Module &M, bool ShouldPreserveUseListOrder = false,
                      const ModuleSummaryIndex *Index = nullptr,
                      bool GenerateHash = false, ModuleHash *ModHash = nullptr);
@@ -227,6 +227,17 @@ public:
     }
   }
 
+  /// Copy whole words written by another BitstreamWriter to the stream, which
+  /// must be at a 32-bit boundary. \p Words must mean the same wherever they
+  /// start, as complete blocks written at a 32-bit boundary do when both
+  /// writers have the same BLOCKINFO abbreviations.
+  void emitWords(StringRef Words) {
+    assert(CurBit == 0 && "Not 32-bit aligned");
+    assert((Words.size() & 3) == 0 && "Not a whole number of words");
+    Out.append(Words.begin(), Words.end());
+    FlushToFile();
+  }
+
   void EmitVBR(uint32_t Val, unsigned NumBits) {
     assert(NumBits <= 32 && "Too many bits to emit!");
     uint32_t Threshold = 1U << (NumBits-1);
@@ -294,6 +294,12 @@ namespace llvm {
       segments.clear();
     }
 
+    /// Release the spare capacity of the segment and value number vectors
+    /// once the range is not expected to grow much, such as after it was
+    /// computed. Vectors grown one element at a time can otherwise hold up to
+    /// twice the memory they need.
+    void shrinkToFit();
+
     size_t size() const {
       return segments.size();
     }
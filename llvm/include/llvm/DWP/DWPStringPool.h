@@ -4,7 +4,9 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/MC/MCSection.h"
 #include "llvm/MC/MCStreamer.h"
+#include "llvm/Support/Allocator.h"
 #include <cassert>
+#include <cstring>
 
 namespace llvm {
 class DWPStringPool {
@@ -33,6 +35,7 @@ class DWPStringPool {
   MCStreamer &Out;
   MCSection *Sec;
   DenseMap<const char *, uint32_t, CStrDenseMapInfo> Pool;
+  BumpPtrAllocator Alloc;
   uint32_t Offset = 0;
 
 public:
@@ -41,14 +44,20 @@ public:
   uint32_t getOffset(const char *Str, unsigned Length) {
     assert(strlen(Str) + 1 == Length && "Ensure length hint is correct");
 
-    auto Pair = Pool.insert(std::make_pair(Str, Offset));
-    if (Pair.second) {
-      Out.SwitchSection(Sec);
-      Out.emitBytes(StringRef(Str, Length));
-      Offset += Length;
-    }
+    auto It = Pool.find(Str);
+    if (It != Pool.end())
+      return It->second;
 
-    return Pair.first->second;
+    // The pool keeps its own copy of every string, so that the input file a
+    // string came from can be released once it has been written out.
+    char *Copy = Alloc.Allocate<char>(Length);
+    memcpy(Copy, Str, Length);
+    Pool.insert(std::make_pair(Copy, Offset));
+    Out.SwitchSection(Sec);
+    Out.emitBytes(StringRef(Copy, Length));
+    uint32_t StrOffset = Offset;
+    Offset += Length;
+    return StrOffset;
   }
 };
 } // namespace llvm
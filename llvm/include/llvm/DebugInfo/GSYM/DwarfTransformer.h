@@ -62,9 +62,10 @@ private:
   /// Handle any DIE (debug info entry) from the DWARF.
   ///
   /// This function will find all DW_TAG_subprogram DIEs that convert them into
-  /// GSYM FuntionInfo objects and add them to the GsymCreator supplied during
-  /// construction. The DIE and all its children will be recursively parsed
-  /// with calls to this function.
+  /// GSYM FuntionInfo objects and collect them in the compile unit info, for
+  /// the caller to add to the GsymCreator supplied during construction. The
+  /// DIE and all its children will be recursively parsed with calls to this
+  /// function.
   ///
   /// \param Strm The thread specific log stream for any non fatal errors and
   /// warnings. Once a thread has finished parsing an entire compile unit, all
@@ -196,6 +196,12 @@ public:
   /// \param   FI The function info object to emplace into our functions list.
   void addFunctionInfo(FunctionInfo &&FI);
 
+  /// Add a batch of function infos to this GSYM creator, taking the lock
+  /// once for all of them.
+  ///
+  /// \param   FIs The function info objects to move into our functions list.
+  void addFunctionInfos(std::vector<FunctionInfo> &&FIs);
+
   /// Finalize the data in the GSYM creator prior to saving the data out.
   ///
   /// Finalize must be called after all FunctionInfo objects have been added
@@ -13,6 +13,8 @@
 #ifndef LLVM_DEBUGINFO_SYMBOLIZE_SYMBOLIZE_H
 #define LLVM_DEBUGINFO_SYMBOLIZE_SYMBOLIZE_H
 
+#include "llvm/ADT/ilist_node.h"
+#include "llvm/ADT/simple_ilist.h"
 #include "llvm/DebugInfo/Symbolize/SymbolizableModule.h"
 #include "llvm/Object/Binary.h"
 #include "llvm/Object/ELFObjectFile.h"
@@ -20,6 +22,7 @@
 #include "llvm/Support/Error.h"
 #include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -34,6 +37,37 @@ using namespace object;
 using FunctionNameKind = DILineInfoSpecifier::FunctionNameKind;
 using FileLineInfoKind = DILineInfoSpecifier::FileLineInfoKind;
 
+/// A binary cached by LLVMSymbolizer, linked into its list of binaries in the
+/// order they were last used. An empty binary records that the file could not
+/// be loaded; it is not part of the list and is never evicted.
+class CachedBinary : public ilist_node<CachedBinary> {
+public:
+  CachedBinary() = default;
+  CachedBinary(OwningBinary<Binary> Bin) : Bin(std::move(Bin)) {}
+
+  OwningBinary<Binary> &operator*() { return Bin; }
+  OwningBinary<Binary> *operator->() { return &Bin; }
+
+  /// Adds an action that drops something built from this binary when the
+  /// binary is evicted. Actions run in the reverse of the order they were
+  /// added in.
+  void pushEvictor(std::function<void()> NewEvictor);
+
+  /// Runs the registered evictors. The last one removes the binary itself,
+  /// so they are moved out of it first.
+  void evict() {
+    std::function<void()> Evictors = std::move(Evictor);
+    if (Evictors)
+      Evictors();
+  }
+
+  size_t size() { return Bin.getBinary()->getData().size(); }
+
+private:
+  OwningBinary<Binary> Bin;
+  std::function<void()> Evictor;
+};
+
 class LLVMSymbolizer {
 public:
   struct Options {
@@ -49,6 +83,9 @@ public:
     std::string FallbackDebugPath;
     std::string DWPName;
     std::vector<std::string> DebugFileDirectory;
+    /// Total size of the binaries pruneCache() keeps loaded.
+    size_t MaxCacheSize =
+        sizeof(size_t) == 4 ? 512 * 1024 * 1024 : 4ULL * 1024 * 1024 * 1024;
   };
 
   LLVMSymbolizer() = default;
@@ -79,6 +116,12 @@ public:
                  object::SectionedAddress ModuleOffset);
   void flush();
 
+  /// Evicts the least recently used binaries, and the modules built from
+  /// them, until the cached binaries fit in Options::MaxCacheSize. The most
+  /// recently used binary is always kept. This invalidates any reference into
+  /// the results of earlier queries.
+  void pruneCache();
+
   static std::string
   DemangleName(const std::string &Name,
                const SymbolizableModule *DbiModuleDescriptor);
@@ -136,6 +179,17 @@ private:
   Expected<ObjectFile *> getOrCreateObject(const std::string &Path,
                                            const std::string &ArchName);
 
+  /// Moves a cached binary to the most recently used end of LRUBinaries.
+  void recordAccess(CachedBinary &Bin);
+
+  /// Same for the binaries holding both objects of \p Objects.
+  void recordAccess(const ObjectPair &Objects);
+
+  /// Registers \p Evictor with the binaries holding both objects of
+  /// \p Objects, so that whatever is built from the pair goes away with
+  /// either of them.
+  void pushEvictor(const ObjectPair &Objects, std::function<void()> Evictor);
+
   std::map<std::string, std::unique_ptr<SymbolizableModule>, std::less<>>
       Modules;
 
@@ -144,7 +198,13 @@ private:
       ObjectPairForPathArch;
 
   /// Contains parsed binary for each path, or parsing error.
-  std::map<std::string, OwningBinary<Binary>> BinaryForPath;
+  std::map<std::string, CachedBinary> BinaryForPath;
+
+  /// The loaded binaries of BinaryForPath, least recently used first.
+  simple_ilist<CachedBinary> LRUBinaries;
+
+  /// Sum of the sizes of the binaries in LRUBinaries.
+  size_t CacheSize = 0;
 
   /// Parsed object file for path/architecture pair, where "path" refers
   /// to Mach-O universal binary.
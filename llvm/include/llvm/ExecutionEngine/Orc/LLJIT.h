@@ -268,6 +268,7 @@ public:
   CompileFunctionCreator CreateCompileFunction;
   PlatformSetupFunction SetUpPlatform;
   unsigned NumCompileThreads = 0;
+  ObjectCache *ObjCache = nullptr;
 
   /// Called prior to JIT class construcion to fix up defaults.
   Error prepareForConstruction();
@@ -338,6 +339,17 @@ public:
     return impl();
   }
 
+  /// Set an ObjectCache for the default compile function.
+  ///
+  /// The cache is queried before compiling each module and notified of newly
+  /// compiled objects. See PersistentObjectCache for a cache that persists
+  /// across processes. The cache must outlive the JIT instance. It is ignored
+  /// if a custom CompileFunctionCreator is set.
+  SetterImpl &setObjectCache(ObjectCache *ObjCache) {
+    impl().ObjCache = ObjCache;
+    return impl();
+  }
+
   /// Set up an PlatformSetupFunction.
   ///
   /// If this method is not called then setUpGenericLLVMIRPlatform
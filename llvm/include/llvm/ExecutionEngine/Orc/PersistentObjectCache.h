@@ -0,0 +1,65 @@
+//===- PersistentObjectCache.h - On-disk object cache for ORC ---*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// An ObjectCache that keeps compiled objects on disk across processes.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_PERSISTENTOBJECTCACHE_H
+#define LLVM_EXECUTIONENGINE_ORC_PERSISTENTOBJECTCACHE_H
+
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ExecutionEngine/ObjectCache.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include <mutex>
+#include <string>
+
+namespace llvm {
+
+class Module;
+
+namespace orc {
+
+/// An ObjectCache that stores compiled objects in a directory, keyed by a
+/// hash of the module's bitcode. Identical modules compiled by later processes
+/// are then loaded from disk instead of being recompiled.
+///
+/// The key does not capture code generation options: use a different
+/// directory or KeyPrefix for each target configuration sharing a cache.
+///
+/// Objects are written to a temporary file and renamed into place, so several
+/// processes may share a cache directory. The cache is best-effort: I/O errors
+/// result in a recompile, never in a failure.
+///
+/// This class is thread-safe and can be used with ConcurrentIRCompiler.
+class PersistentObjectCache : public ObjectCache {
+public:
+  PersistentObjectCache(std::string CacheDir, std::string KeyPrefix = "")
+      : CacheDir(std::move(CacheDir)), KeyPrefix(std::move(KeyPrefix)) {}
+
+  void notifyObjectCompiled(const Module *M, MemoryBufferRef Obj) override;
+
+  std::unique_ptr<MemoryBuffer> getObject(const Module *M) override;
+
+private:
+  std::string getKey(const Module &M) const;
+  std::string getCachePath(StringRef Key) const;
+
+  std::string CacheDir;
+  std::string KeyPrefix;
+
+  // Keys computed by getObject for modules that missed the cache, to avoid
+  // hashing them again when they are compiled.
+  std::mutex PendingKeysMutex;
+  DenseMap<const Module *, std::string> PendingKeys;
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_PERSISTENTOBJECTCACHE_H
@@ -0,0 +1,122 @@
+//===- TieredCompileLayer.h - Recompile hot functions -----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// JIT layer that emits functions with a cheap compiler first and recompiles
+// the ones that turn out to be hot with an optimizing compiler.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILELAYER_H
+#define LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILELAYER_H
+
+#include "llvm/ExecutionEngine/Orc/IndirectionUtils.h"
+#include "llvm/ExecutionEngine/Orc/Layer.h"
+#include "llvm/ExecutionEngine/Orc/LazyReexports.h"
+#include "llvm/ExecutionEngine/Orc/ThreadSafeModule.h"
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace llvm {
+
+class Function;
+class Module;
+
+namespace orc {
+
+/// A layer that compiles code in two tiers.
+///
+/// Modules are first emitted through Tier0Layer (typically an IRCompileLayer
+/// at -O0), with a counter at the entry of every externally visible function.
+/// Callers reach these functions through indirect stubs. When a function has
+/// been entered HotThreshold times, a task is dispatched on the
+/// ExecutionSession that recompiles it through Tier1Layer (typically an
+/// IRTransformLayer running the optimization pipeline over an optimizing
+/// IRCompileLayer) and then points the function's stub at the new body.
+///
+/// The tier-1 module contains the hot function and available_externally copies
+/// of the other functions in its source module, so the optimizer can inline
+/// them. Calls that are not inlined still go through the stubs and benefit
+/// from their callees being tiered up independently.
+///
+/// The tier-0 counters call back into this layer directly, so JIT'd code must
+/// run in the JIT process, and the layer must outlive it. Modules with static
+/// initializers are emitted through Tier0Layer without tiering.
+class TieredCompileLayer : public IRLayer {
+public:
+  /// Builder for IndirectStubsManagers.
+  using IndirectStubsManagerBuilder =
+      std::function<std::unique_ptr<IndirectStubsManager>()>;
+
+  /// Construct a TieredCompileLayer.
+  TieredCompileLayer(ExecutionSession &ES, IRLayer &Tier0Layer,
+                     IRLayer &Tier1Layer, LazyCallThroughManager &LCTMgr,
+                     IndirectStubsManagerBuilder BuildIndirectStubsManager,
+                     uint64_t HotThreshold = 1000);
+
+  /// Emits the given module. This should not be called by clients: it will be
+  /// called by the JIT when a definition added via the add method is requested.
+  void emit(std::unique_ptr<MaterializationResponsibility> R,
+            ThreadSafeModule TSM) override;
+
+  /// Returns the number of functions that have been recompiled by tier 1.
+  uint64_t getNumTieredUp() const { return NumTieredUp; }
+
+private:
+  struct PerDylibResources {
+  public:
+    PerDylibResources(JITDylib &ImplD,
+                      std::unique_ptr<IndirectStubsManager> ISMgr)
+        : ImplD(ImplD), ISMgr(std::move(ISMgr)) {}
+    JITDylib &getImplDylib() { return ImplD; }
+    IndirectStubsManager &getISManager() { return *ISMgr; }
+
+  private:
+    JITDylib &ImplD;
+    std::unique_ptr<IndirectStubsManager> ISMgr;
+  };
+
+  using PerDylibResourcesMap = std::map<const JITDylib *, PerDylibResources>;
+
+  /// Everything needed to recompile one function.
+  struct TierUpInfo {
+    JITDylib *ImplD = nullptr;
+    IndirectStubsManager *ISMgr = nullptr;
+    std::shared_ptr<ThreadSafeModule> Source;
+    std::string IRName;
+    SymbolStringPtr PublicName;
+  };
+
+  PerDylibResources &getPerDylibResources(JITDylib &TargetD);
+
+  void addEntryCounter(Function &F, uint64_t Id);
+
+  static void tierUpCallback(void *Ctx, uint64_t Id);
+
+  void tierUp(uint64_t Id);
+
+  mutable std::mutex TieredLayerMutex;
+
+  IRLayer &Tier0Layer;
+  IRLayer &Tier1Layer;
+  LazyCallThroughManager &LCTMgr;
+  IndirectStubsManagerBuilder BuildIndirectStubsManager;
+  uint64_t HotThreshold;
+  PerDylibResourcesMap DylibResources;
+  SymbolLinkagePromoter PromoteSymbols;
+  std::vector<TierUpInfo> TierUps;
+  std::atomic<uint64_t> NumTieredUp{0};
+};
+
+} // end namespace orc
+} // end namespace llvm
+
+#endif // LLVM_EXECUTIONENGINE_ORC_TIEREDCOMPILELAYER_H
@@ -152,6 +152,14 @@ public:
   void enableDebugTypeODRUniquing();
   void disableDebugTypeODRUniquing();
 
+  /// Make uniquing integer and floating-point constants, MDStrings and
+  /// uniqued metadata nodes safe to do on several threads at once. The rest of
+  /// the context, such as other constants and the use lists of values, is
+  /// still not thread-safe. This must be called before other threads use the
+  /// context, and can't be undone.
+  void enableConcurrentUniquing();
+  bool isConcurrentUniquingEnabled() const;
+
   /// Defines the type of a yield callback.
   /// \see LLVMContext::setYieldCallback.
   using YieldCallbackTy = void (*)(LLVMContext *Context, void *OpaqueHandle);
@@ -48,11 +48,13 @@
 #include "llvm/IR/PassManagerInternal.h"
 #include "llvm/Pass.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/TypeName.h"
 #include <algorithm>
 #include <cassert>
 #include <cstring>
+#include <functional>
 #include <iterator>
 #include <list>
 #include <memory>
@@ -1237,6 +1239,71 @@ createModuleToFunctionPassAdaptor(FunctionPassT &&Pass,
       EagerlyInvalidate);
 }
 
+/// Trivial adaptor that runs a function pass over the functions of a module
+/// on a thread pool.
+///
+/// Each worker thread runs its own instance of the pass, from \c CreatePass,
+/// with its own FunctionAnalysisManager, whose analyses are registered by
+/// \c RegisterAnalyses. Function analyses computed by a worker are dropped
+/// once its pass has run, and the analyses in the module's
+/// FunctionAnalysisManager are invalidated as the pass requests. The per-pass
+/// instrumentation inside a worker's pipeline is turned off; the before and
+/// after callbacks of the adaptor's own pass run under a lock.
+///
+/// The LLVMContext is not thread-safe, so this is only correct for passes that
+/// do not touch state shared between functions. Such a pass must not create
+/// constants, types, metadata or attributes, and must not add or remove a use
+/// of anything that is not local to the function: globals, constants and
+/// metadata have use lists that other functions modify too. Passes that only
+/// read the IR, or that only rewrite instructions whose operands are all local
+/// to the function, qualify; most of LLVM's transforms do not, and must be run
+/// with a ModuleToFunctionPassAdaptor.
+class ParallelModuleToFunctionPassAdaptor
+    : public PassInfoMixin<ParallelModuleToFunctionPassAdaptor> {
+public:
+  using PassConceptT = detail::PassConcept<Function, FunctionAnalysisManager>;
+  using CreatePassFn = std::function<std::unique_ptr<PassConceptT>()>;
+  using RegisterAnalysesFn = std::function<void(FunctionAnalysisManager &)>;
+
+  ParallelModuleToFunctionPassAdaptor(CreatePassFn CreatePass,
+                                      RegisterAnalysesFn RegisterAnalyses,
+                                      ThreadPoolStrategy S)
+      : CreatePass(std::move(CreatePass)),
+        RegisterAnalyses(std::move(RegisterAnalyses)), S(S) {}
+
+  /// Runs the function pass across every function in the module.
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &AM);
+  void printPipeline(raw_ostream &OS,
+                     function_ref<StringRef(StringRef)> MapClassName2PassName);
+
+  static bool isRequired() { return true; }
+
+private:
+  CreatePassFn CreatePass;
+  RegisterAnalysesFn RegisterAnalyses;
+  ThreadPoolStrategy S;
+};
+
+/// A function to deduce the type of the function pass that \p CreatePass
+/// returns and wrap it in the parallel adaptor.
+template <typename CreatePassT>
+ParallelModuleToFunctionPassAdaptor createParallelModuleToFunctionPassAdaptor(
+    CreatePassT CreatePass,
+    ParallelModuleToFunctionPassAdaptor::RegisterAnalysesFn RegisterAnalyses,
+    ThreadPoolStrategy S) {
+  using FunctionPassT = decltype(CreatePass());
+  using PassModelT =
+      detail::PassModel<Function, FunctionPassT, PreservedAnalyses,
+                        FunctionAnalysisManager>;
+  return ParallelModuleToFunctionPassAdaptor(
+      [CreatePass]() {
+        return std::unique_ptr<
+            ParallelModuleToFunctionPassAdaptor::PassConceptT>(
+            new PassModelT(CreatePass()));
+      },
+      std::move(RegisterAnalyses), S);
+}
+
 /// A utility pass template to force an analysis result to be available.
 ///
 /// If there are extra arguments at the pass's run level there may also be
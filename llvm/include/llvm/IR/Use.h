@@ -56,8 +56,9 @@ private:
       removeFromList();
   }
 
-  /// Constructor
-  Use(User *Parent) : Parent(Parent) {}
+  /// Constructor - Only for User's operand allocation, which must call
+  /// initWaymarks() once all of a User's Uses are constructed.
+  Use() = default;
 
 public:
   friend class Value;
@@ -69,8 +70,9 @@ public:
   /// Returns the User that contains this Use.
   ///
   /// For an instruction operand, for example, this will return the
-  /// instruction.
-  User *getUser() const { return Parent; };
+  /// instruction. This walks the waymarks to the end of the User's operands,
+  /// so it takes time logarithmic in the operand number.
+  User *getUser() const;
 
   inline void set(Value *Val);
 
@@ -89,25 +91,43 @@ public:
   /// a User changes.
   static void zap(Use *Start, const Use *Stop, bool del = false);
 
+  /// The pointer that follows the Uses of a User whose operands are hung off,
+  /// with its bit set to tell it apart from a User laid out after its Uses.
+  using UserRef = PointerIntPair<User *, 1, unsigned>;
+
 private:
+  /// The number of low bits of Prev that hold waymarks.
+  static constexpr unsigned NumWaymarkBits =
+      PointerLikeTypeTraits<Use **>::NumLowBitsAvailable;
+  struct Waymarker;
+
+  /// Writes the waymarks that lead every Use in [Start, Stop) to Stop, which
+  /// is where the User or its UserRef is.
+  static void initWaymarks(Use *Start, Use *Stop);
+
 
   Value *Val = nullptr;
   Use *Next = nullptr;
-  Use **Prev = nullptr;
-  User *Parent = nullptr;
+  /// The address of the pointer to this Use, whose low bits are taken by the
+  /// waymarks that getUser() follows.
+  PointerIntPair<Use **, NumWaymarkBits, unsigned> Prev;
+
+  Use **getPrev() const { return Prev.getPointer(); }
+  void setPrev(Use **NewPrev) { Prev.setPointer(NewPrev); }
 
   void addToList(Use **List) {
     Next = *List;
     if (Next)
-      Next->Prev = &Next;
-    Prev = List;
-    *Prev = this;
+      Next->setPrev(&Next);
+    setPrev(List);
+    *List = this;
   }
 
   void removeFromList() {
-    *Prev = Next;
+    Use **StrippedPrev = getPrev();
+    *StrippedPrev = Next;
     if (Next)
-      Next->Prev = Prev;
+      Next->setPrev(StrippedPrev);
   }
 };
 
@@ -81,6 +81,7 @@ private:
   Module &Composite;
   IdentifiedStructTypeSet IdentifiedStructTypes;
   MDMapT SharedMDs; ///< A Metadata map to use for all calls to \a move().
+  uint64_t NumMoves = 0; ///< The number of calls to \a move() so far.
 };
 
 } // End llvm namespace
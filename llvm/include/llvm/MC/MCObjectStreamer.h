@@ -67,6 +67,13 @@ class MCObjectStreamer : public MCStreamer {
   void emitInstructionImpl(const MCInst &Inst, const MCSubtargetInfo &STI);
   void resolvePendingFixups();
 
+  /// Reallocate the contents and fixups of a data fragment that a new
+  /// fragment is about to follow, if much of their capacity is unused. Data
+  /// fragments grow an instruction at a time and are kept until the object
+  /// is written, so a large one can otherwise hold up to twice the memory
+  /// it needs.
+  void releaseSpareCapacity(MCFragment &F);
+
 protected:
   MCObjectStreamer(MCContext &Context, std::unique_ptr<MCAsmBackend> TAB,
                    std::unique_ptr<MCObjectWriter> OW,
@@ -87,6 +94,8 @@ public:
 
   void insert(MCFragment *F) {
     flushPendingLabels(F);
+    if (MCFragment *Prev = getCurrentFragment())
+      releaseSpareCapacity(*Prev);
     MCSection *CurSection = getCurrentSectionOnly();
     CurSection->getFragmentList().insert(CurInsertionPoint, F);
     F->setParent(CurSection);
@@ -0,0 +1,113 @@
+//===--------------------- BatchSimulator.h ---------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+///
+/// This file defines a class for simulating many independent blocks of code
+/// on one subtarget in-process, without going through the llvm-mca tool and
+/// its views.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_MCA_BATCHSIMULATOR_H
+#define LLVM_MCA_BATCHSIMULATOR_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/MC/MCInst.h"
+#include "llvm/MCA/Context.h"
+#include "llvm/MCA/InstrBuilder.h"
+#include "llvm/Support/Error.h"
+#include "llvm/Support/JSON.h"
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace llvm {
+
+class MCInstrAnalysis;
+class MCInstrInfo;
+class MCRegisterInfo;
+class MCSubtargetInfo;
+class Target;
+
+namespace mca {
+
+/// The numbers llvm-mca prints in its summary view, for one simulated block.
+struct BlockSummary {
+  unsigned Iterations = 0;
+  unsigned Instructions = 0; // Per iteration.
+  unsigned TotalCycles = 0;
+  unsigned TotalUOps = 0;
+  unsigned DispatchWidth = 0;
+  double BlockRThroughput = 0.0;
+};
+
+/// Returns the same object as the "SummaryView" of llvm-mca's JSON report.
+json::Value toJSON(const BlockSummary &S);
+
+/// Simulates blocks of code on the default pipeline of one subtarget.
+///
+/// The target objects are created once by the caller and shared by every
+/// simulation, and the instruction descriptors computed from the scheduling
+/// model are kept across blocks. Simulating a batch of blocks runs them on a
+/// thread pool, with one InstrBuilder per thread; the target objects are only
+/// read while blocks are simulated.
+class BatchSimulator {
+  const Target &TheTarget;
+  const MCSubtargetInfo &STI;
+  const MCInstrInfo &MCII;
+  const MCRegisterInfo &MRI;
+  const MCInstrAnalysis *MCIA;
+  const PipelineOptions PO;
+  const unsigned Iterations;
+  const bool UseCustomBehaviour;
+
+  // Maps the resource state index used by instruction descriptors back to
+  // the processor resource ID of the scheduling model.
+  SmallVector<unsigned, 8> ResIdx2ProcResID;
+
+  // Instruction builders which are not in use by a simulation.
+  std::mutex BuildersLock;
+  std::vector<std::unique_ptr<InstrBuilder>> FreeBuilders;
+
+  std::unique_ptr<InstrBuilder> takeBuilder();
+  void returnBuilder(std::unique_ptr<InstrBuilder> IB);
+
+  Expected<BlockSummary> simulate(InstrBuilder &IB, ArrayRef<MCInst> Block);
+
+public:
+  /// Blocks are simulated for \p Iter iterations, or llvm-mca's default if
+  /// \p Iter is zero. Targets' CustomBehaviour and InstrPostProcess classes
+  /// are used unless \p EnableCustomBehaviour is false.
+  BatchSimulator(const Target &T, const MCSubtargetInfo &STI,
+                 const MCInstrInfo &MCII, const MCRegisterInfo &MRI,
+                 const MCInstrAnalysis *MCIA, const PipelineOptions &PO,
+                 unsigned Iter = 0, bool EnableCustomBehaviour = true);
+
+  BatchSimulator(const BatchSimulator &) = delete;
+  BatchSimulator &operator=(const BatchSimulator &) = delete;
+
+  /// Simulates \p Block on the calling thread.
+  Expected<BlockSummary> simulate(ArrayRef<MCInst> Block);
+
+  /// Simulates every block of \p Blocks using up to \p NumThreads threads,
+  /// or all hardware threads if \p NumThreads is zero. \p Consumer is called
+  /// on the calling thread with the index and result of each block, in the
+  /// order of \p Blocks, as soon as that block and the ones before it are
+  /// done, so that results can be streamed out while later blocks are still
+  /// being simulated.
+  void simulate(
+      ArrayRef<ArrayRef<MCInst>> Blocks, unsigned NumThreads,
+      function_ref<void(unsigned, Expected<BlockSummary>)> Consumer);
+};
+
+} // namespace mca
+} // namespace llvm
+
+#endif // LLVM_MCA_BATCHSIMULATOR_H
@@ -54,10 +54,11 @@ private:
   Decompressor(StringRef Data);
 
   Error consumeCompressedGnuHeader();
-  Error consumeCompressedZLibHeader(bool Is64Bit, bool IsLittleEndian);
+  Error consumeCompressedHeader(bool Is64Bit, bool IsLittleEndian);
 
   StringRef SectionData;
   uint64_t DecompressedSize;
+  uint64_t CompressionType;
 };
 
 } // end namespace object
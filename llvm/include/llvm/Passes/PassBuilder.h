@@ -83,6 +83,17 @@ public:
   // analyses after various module->function or cgscc->function adaptors in the
   // default pipelines.
   bool EagerlyInvalidateAnalyses;
+
+  /// Tuning option to run NewGVN, which is built on MemorySSA, in place of GVN,
+  /// whose memdep queries can take quadratic time on large functions. NewGVN
+  /// does no load PRE, so GVNHoist runs after it. Its default value is that of
+  /// the flag: `-enable-newgvn`.
+  bool NewGVN;
+
+  /// Directory in which the module optimization pipeline keeps the functions
+  /// its function passes produced, see CachingModuleToFunctionPassAdaptor.
+  /// The functions are not cached if it is empty, which is the default.
+  std::string FunctionCacheDir;
 };
 
 /// This class provides access to building LLVM's passes.
@@ -562,6 +573,8 @@ private:
   void addVectorPasses(OptimizationLevel Level, FunctionPassManager &FPM,
                        bool IsFullLTO);
 
+  std::string getFunctionCacheExtraKey() const;
+
   static Optional<std::vector<PipelineElement>>
   parsePipelineText(StringRef Text);
 
@@ -159,6 +159,24 @@ inline StringRef getInstrProfCounterBiasVarName() {
   return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_COUNTER_BIAS_VAR);
 }
 
+/// Return the name of the thread-local variable holding the offset of the
+/// current thread's counter shard, used with per-thread counters.
+inline StringRef getInstrProfCounterShardOffsetVarName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_COUNTER_SHARD_OFFSET_VAR);
+}
+
+/// Return the name of the runtime function that allocates the counter shard
+/// of the current thread and returns its offset.
+inline StringRef getInstrProfInitCounterShardFuncName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_INIT_COUNTER_SHARD_FUNC);
+}
+
+/// Return the name of the thread-local variable counting function entries
+/// modulo the sampling period, used with sampled instrumentation.
+inline StringRef getInstrProfSamplingVarName() {
+  return INSTR_PROF_QUOTE(INSTR_PROF_PROFILE_SAMPLING_VAR);
+}
+
 /// Return the marker used to separate PGO names during serialization.
 inline StringRef getInstrProfNameSeparator() { return "\01"; }
 
@@ -88,20 +88,24 @@ public:
   BumpPtrAllocatorImpl(BumpPtrAllocatorImpl &&Old)
       : AllocatorT(static_cast<AllocatorT &&>(Old)), CurPtr(Old.CurPtr),
         End(Old.End), Slabs(std::move(Old.Slabs)),
+        FreeSlabs(std::move(Old.FreeSlabs)),
         CustomSizedSlabs(std::move(Old.CustomSizedSlabs)),
         BytesAllocated(Old.BytesAllocated), RedZoneSize(Old.RedZoneSize) {
     Old.CurPtr = Old.End = nullptr;
     Old.BytesAllocated = 0;
     Old.Slabs.clear();
+    Old.FreeSlabs.clear();
     Old.CustomSizedSlabs.clear();
   }
 
   ~BumpPtrAllocatorImpl() {
+    DeallocateFreeSlabs();
     DeallocateSlabs(Slabs.begin(), Slabs.end());
     DeallocateCustomSizedSlabs();
   }
 
   BumpPtrAllocatorImpl &operator=(BumpPtrAllocatorImpl &&RHS) {
+    DeallocateFreeSlabs();
     DeallocateSlabs(Slabs.begin(), Slabs.end());
     DeallocateCustomSizedSlabs();
 
@@ -110,12 +114,14 @@ public:
     BytesAllocated = RHS.BytesAllocated;
     RedZoneSize = RHS.RedZoneSize;
     Slabs = std::move(RHS.Slabs);
+    FreeSlabs = std::move(RHS.FreeSlabs);
     CustomSizedSlabs = std::move(RHS.CustomSizedSlabs);
     AllocatorT::operator=(static_cast<AllocatorT &&>(RHS));
 
     RHS.CurPtr = RHS.End = nullptr;
     RHS.BytesAllocated = 0;
     RHS.Slabs.clear();
+    RHS.FreeSlabs.clear();
     RHS.CustomSizedSlabs.clear();
     return *this;
   }
@@ -124,6 +130,8 @@ public:
   /// to the beginning of it, freeing all memory allocated so far.
   void Reset() {
     // Deallocate all but the first slab, and deallocate all custom-sized slabs.
+    DeallocateFreeSlabs();
+    FreeSlabs.clear();
     DeallocateCustomSizedSlabs();
     CustomSizedSlabs.clear();
 
@@ -140,6 +148,29 @@ public:
     Slabs.erase(std::next(Slabs.begin()), Slabs.end());
   }
 
+  /// Free all memory allocated so far, like Reset, but keep the slabs for
+  /// the allocations that follow instead of returning all but the first to
+  /// the underlying allocator. This suits an allocator that is filled to a
+  /// similar size over and over. Custom-sized slabs are still deallocated.
+  void ResetKeepingSlabs() {
+    DeallocateCustomSizedSlabs();
+    CustomSizedSlabs.clear();
+
+    if (Slabs.empty())
+      return;
+
+    BytesAllocated = 0;
+    CurPtr = (char *)Slabs.front();
+    End = CurPtr + SlabSize;
+
+    for (size_t I = 0, E = Slabs.size(); I != E; ++I)
+      __asan_poison_memory_region(Slabs[I], computeSlabSize(I));
+    // StartNewSlab takes free slabs from the back, so keep them in reverse
+    // order to reuse each one at the index it was allocated for.
+    FreeSlabs.append(Slabs.rbegin(), std::prev(Slabs.rend()));
+    Slabs.erase(std::next(Slabs.begin()), Slabs.end());
+  }
+
   /// Allocate space at the specified alignment.
   // This method is *not* marked noalias, because
   // SpecificBumpPtrAllocator::DestroyAll() loops over all allocations, and
@@ -279,6 +310,8 @@ public:
     size_t TotalMemory = 0;
     for (auto I = Slabs.begin(), E = Slabs.end(); I != E; ++I)
       TotalMemory += computeSlabSize(std::distance(Slabs.begin(), I));
+    for (size_t I = 0, E = FreeSlabs.size(); I != E; ++I)
+      TotalMemory += computeSlabSize(getFreeSlabIndex(I));
     for (const auto &PtrAndSize : CustomSizedSlabs)
       TotalMemory += PtrAndSize.second;
     return TotalMemory;
@@ -307,6 +340,10 @@ private:
   /// The slabs allocated so far.
   SmallVector<void *, 4> Slabs;
 
+  /// The slabs kept by ResetKeepingSlabs that are not in use, the next one
+  /// to use last.
+  SmallVector<void *, 0> FreeSlabs;
+
   /// Custom-sized slabs allocated for too-large allocation requests.
   SmallVector<std::pair<void *, size_t>, 0> CustomSizedSlabs;
 
@@ -334,7 +371,9 @@ private:
     size_t AllocatedSlabSize = computeSlabSize(Slabs.size());
 
     void *NewSlab =
-        AllocatorT::Allocate(AllocatedSlabSize, alignof(std::max_align_t));
+        FreeSlabs.empty()
+            ? AllocatorT::Allocate(AllocatedSlabSize, alignof(std::max_align_t))
+            : FreeSlabs.pop_back_val();
     // We own the new slab and don't want anyone reading anything other than
     // pieces returned from this method.  So poison the whole slab.
     __asan_poison_memory_region(NewSlab, AllocatedSlabSize);
@@ -354,6 +393,18 @@ private:
     }
   }
 
+  /// Returns the index in Slabs that FreeSlabs[I] will be used at.
+  size_t getFreeSlabIndex(size_t I) const {
+    return Slabs.size() + FreeSlabs.size() - 1 - I;
+  }
+
+  /// Deallocate the slabs kept by ResetKeepingSlabs.
+  void DeallocateFreeSlabs() {
+    for (size_t I = 0, E = FreeSlabs.size(); I != E; ++I)
+      AllocatorT::Deallocate(FreeSlabs[I], computeSlabSize(getFreeSlabIndex(I)),
+                             alignof(std::max_align_t));
+  }
+
   /// Deallocate all memory for custom sized slabs.
   void DeallocateCustomSizedSlabs() {
     for (auto &PtrAndSize : CustomSizedSlabs) {
@@ -284,6 +284,8 @@ public:
   SmallVector<OptionCategory *, 1>
       Categories;                    // The Categories this option belongs to
   SmallPtrSet<SubCommand *, 1> Subs; // The subcommands this option belongs to.
+  Option *NextPendingOption = nullptr; // Options not yet registered with the
+                                       // parser, in construction order.
 
   inline enum NumOccurrencesFlag getNumOccurrencesFlag() const {
     return (enum NumOccurrencesFlag)Occurrences;
@@ -348,7 +350,10 @@ protected:
 public:
   virtual ~Option() = default;
 
-  // addArgument - Register this argument with the commandline system.
+  // addArgument - Register this argument with the commandline system. The
+  // option is only added to its subcommands when the command line is parsed or
+  // the registered options are queried, so that static constructors do not pay
+  // for options that are never used.
   //
   void addArgument();
 
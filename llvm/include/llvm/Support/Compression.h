@@ -14,6 +14,7 @@
 #define LLVM_SUPPORT_COMPRESSION_H
 
 #include "llvm/Support/DataTypes.h"
+#include <memory>
 
 namespace llvm {
 template <typename T> class SmallVectorImpl;
@@ -43,6 +44,75 @@ uint32_t crc32(StringRef Buffer);
 
 }  // End of namespace zlib
 
+namespace zstd {
+
+static constexpr int NoCompression = -5;
+static constexpr int BestSpeedCompression = 1;
+static constexpr int DefaultCompression = 5;
+static constexpr int BestSizeCompression = 12;
+
+bool isAvailable();
+
+/// Compresses \p InputBuffer as a single zstd frame. If \p Threads is
+/// nonzero and zstd was built with multithreading support, the input is
+/// compressed by that many worker threads.
+Error compress(StringRef InputBuffer, SmallVectorImpl<char> &CompressedBuffer,
+               int Level = DefaultCompression, unsigned Threads = 0);
+
+/// Decompresses \p InputBuffer, which may consist of several concatenated
+/// zstd frames. \p UncompressedSize must be at least the size of the
+/// decompressed data and is set to the actual size on success.
+Error uncompress(StringRef InputBuffer, char *UncompressedBuffer,
+                 size_t &UncompressedSize);
+
+Error uncompress(StringRef InputBuffer,
+                 SmallVectorImpl<char> &UncompressedBuffer,
+                 size_t UncompressedSize);
+
+/// A streaming zstd compressor. Data passed to write() is compressed into a
+/// single zstd frame that is appended to the output buffer; finish() ends the
+/// frame. The output buffer may be drained by the caller between calls.
+class StreamCompressor {
+public:
+  StreamCompressor(int Level = DefaultCompression, unsigned Threads = 0);
+  StreamCompressor(const StreamCompressor &) = delete;
+  StreamCompressor &operator=(const StreamCompressor &) = delete;
+  ~StreamCompressor();
+
+  /// Compresses \p Input, appending any produced output to \p Out.
+  Error write(StringRef Input, SmallVectorImpl<char> &Out);
+
+  /// Flushes all buffered data and ends the frame. The compressor can be
+  /// reused for another frame afterwards.
+  Error finish(SmallVectorImpl<char> &Out);
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> I;
+};
+
+/// A streaming zstd decompressor. Compressed data can be fed in chunks split
+/// at arbitrary points.
+class StreamDecompressor {
+public:
+  StreamDecompressor();
+  StreamDecompressor(const StreamDecompressor &) = delete;
+  StreamDecompressor &operator=(const StreamDecompressor &) = delete;
+  ~StreamDecompressor();
+
+  /// Decompresses \p Input, appending the decompressed data to \p Out.
+  Error write(StringRef Input, SmallVectorImpl<char> &Out);
+
+  /// Returns true if the data seen so far ends at a frame boundary.
+  bool isFinished() const;
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> I;
+};
+
+} // End of namespace zstd
+
 } // End of namespace llvm
 
 #endif
@@ -76,6 +76,12 @@ public:
   /// but keeps the memory mapping alive.
   virtual void discard() {}
 
+  /// Writes the pages in [Offset, Offset + Size) back to the file and releases
+  /// the memory that holds them, if the buffer is a memory-mapped file. The
+  /// contents of the buffer are unchanged. This reduces the memory footprint
+  /// of large outputs that are written front to back.
+  virtual void releasePages(size_t Offset, size_t Size) {}
+
 protected:
   FileOutputBuffer(StringRef Path) : FinalPath(Path) {}
 
@@ -1264,6 +1264,35 @@ std::error_code getUniqueID(const Twine Path, UniqueID &Result);
 /// is returned on error.
 ErrorOr<space_info> disk_space(const Twine &Path);
 
+/// Hints about how a mapped_file_region will be accessed. They only affect
+/// performance and are ignored where the system does not support them.
+enum MapFlags : unsigned {
+  MF_None = 0,
+
+  /// Fault the whole mapping in when it is created (MAP_POPULATE), so that
+  /// reading it later takes no page faults.
+  MF_Populate = 1,
+
+  /// The mapping will mostly be read in order (MADV_SEQUENTIAL).
+  MF_Sequential = 2,
+
+  /// Start reading the whole mapping in the background (MADV_WILLNEED).
+  MF_WillNeed = 4,
+
+  /// Back the mapping with transparent huge pages if possible
+  /// (MADV_HUGEPAGE).
+  MF_HugePages = 8,
+};
+
+inline MapFlags operator|(MapFlags A, MapFlags B) {
+  return MapFlags(unsigned(A) | unsigned(B));
+}
+
+inline MapFlags &operator|=(MapFlags &A, MapFlags B) {
+  A = A | B;
+  return A;
+}
+
 /// This class represents a memory mapped file. It is based on
 /// boost::iostreams::mapped_file.
 class mapped_file_region {
@@ -1300,7 +1329,8 @@ private:
   void unmapImpl();
   void dontNeedImpl();
 
-  std::error_code init(sys::fs::file_t FD, uint64_t Offset, mapmode Mode);
+  std::error_code init(sys::fs::file_t FD, uint64_t Offset, mapmode Mode,
+                       MapFlags Flags);
 
 public:
   mapped_file_region() = default;
@@ -1315,8 +1345,9 @@ public:
   mapped_file_region &operator=(const mapped_file_region &) = delete;
 
   /// \param fd An open file descriptor to map. Does not take ownership of fd.
+  /// \param flags Hints about how the mapping will be accessed.
   mapped_file_region(sys::fs::file_t fd, mapmode mode, size_t length, uint64_t offset,
-                     std::error_code &ec);
+                     std::error_code &ec, MapFlags flags = MF_None);
 
   ~mapped_file_region() { unmapImpl(); }
 
@@ -1330,6 +1361,16 @@ public:
   }
   void dontNeed() { dontNeedImpl(); }
 
+  /// Tell the OS that [Offset, Offset + Length) will be read soon, so that it
+  /// can start reading those pages in before they are accessed.
+  void willNeed(size_t Offset, size_t Length);
+
+  /// Write back the modified pages of a readwrite mapping that lie entirely
+  /// within [Offset, Offset + Length) and tell the OS that they are no longer
+  /// needed. The contents of the mapping are unchanged; the pages are read
+  /// back from the file if they are accessed again.
+  void flushAndDontNeed(size_t Offset, size_t Length);
+
   size_t size() const;
   char *data() const;
 
@@ -34,6 +34,7 @@ using file_t = void *;
 #else
 using file_t = int;
 #endif
+enum MapFlags : unsigned;
 } // namespace fs
 } // namespace sys
 
@@ -81,6 +82,11 @@ public:
   /// function should not be called on a writable buffer.
   virtual void dontNeedIfMmap() {}
 
+  /// For MemoryBuffer_MMap, tell the kernel that the bytes in
+  /// [Offset, Offset + Length) of the buffer will be read soon, so that it can
+  /// start reading them in. This calls madvise(MADV_WILLNEED) on *NIX systems.
+  virtual void willNeedIfMmap(size_t Offset, size_t Length) {}
+
   /// Open the specified file as a MemoryBuffer, returning a new MemoryBuffer
   /// if successful, otherwise returning null.
   ///
@@ -90,9 +96,13 @@ public:
   /// \param IsVolatile Set to true to indicate that the contents of the file
   /// can change outside the user's control, e.g. when libclang tries to parse
   /// while the user is editing/updating the file or if the file is on an NFS.
+  ///
+  /// \param Flags Hints about how the file will be read, which are used if
+  /// the file is memory mapped. See sys::fs::MapFlags.
   static ErrorOr<std::unique_ptr<MemoryBuffer>>
   getFile(const Twine &Filename, bool IsText = false,
-          bool RequiresNullTerminator = true, bool IsVolatile = false);
+          bool RequiresNullTerminator = true, bool IsVolatile = false,
+          sys::fs::MapFlags Flags = {});
 
   /// Read all of the specified file into a MemoryBuffer as a stream
   /// (i.e. until EOF reached). This is useful for special files that
@@ -105,7 +115,8 @@ public:
   /// Since this is in the middle of a file, the buffer is not null terminated.
   static ErrorOr<std::unique_ptr<MemoryBuffer>>
   getOpenFileSlice(sys::fs::file_t FD, const Twine &Filename, uint64_t MapSize,
-                   int64_t Offset, bool IsVolatile = false);
+                   int64_t Offset, bool IsVolatile = false,
+                   sys::fs::MapFlags Flags = {});
 
   /// Given an already-open file descriptor, read the file and return a
   /// MemoryBuffer.
@@ -115,7 +126,8 @@ public:
   /// while the user is editing/updating the file or if the file is on an NFS.
   static ErrorOr<std::unique_ptr<MemoryBuffer>>
   getOpenFile(sys::fs::file_t FD, const Twine &Filename, uint64_t FileSize,
-              bool RequiresNullTerminator = true, bool IsVolatile = false);
+              bool RequiresNullTerminator = true, bool IsVolatile = false,
+              sys::fs::MapFlags Flags = {});
 
   /// Open the specified memory range as a MemoryBuffer. Note that InputData
   /// must be null terminated if RequiresNullTerminator is true.
@@ -143,7 +155,8 @@ public:
   /// Map a subrange of the specified file as a MemoryBuffer.
   static ErrorOr<std::unique_ptr<MemoryBuffer>>
   getFileSlice(const Twine &Filename, uint64_t MapSize, uint64_t Offset,
-               bool IsVolatile = false);
+               bool IsVolatile = false,
+               sys::fs::MapFlags Flags = {});
 
   //===--------------------------------------------------------------------===//
   // Provided for performance analysis.
@@ -26,13 +26,15 @@ struct PGOOptions {
              std::string ProfileRemappingFile = "", PGOAction Action = NoAction,
              CSPGOAction CSAction = NoCSAction,
              bool DebugInfoForProfiling = false,
-             bool PseudoProbeForProfiling = false)
+             bool PseudoProbeForProfiling = false,
+             bool AtomicCounterUpdate = false)
       : ProfileFile(ProfileFile), CSProfileGenFile(CSProfileGenFile),
         ProfileRemappingFile(ProfileRemappingFile), Action(Action),
         CSAction(CSAction), DebugInfoForProfiling(DebugInfoForProfiling ||
                                                   (Action == SampleUse &&
                                                    !PseudoProbeForProfiling)),
-        PseudoProbeForProfiling(PseudoProbeForProfiling) {
+        PseudoProbeForProfiling(PseudoProbeForProfiling),
+        AtomicCounterUpdate(AtomicCounterUpdate) {
     // Note, we do allow ProfileFile.empty() for Action=IRUse LTO can
     // callback with IRUse action without ProfileFile.
 
@@ -59,6 +61,9 @@ struct PGOOptions {
   CSPGOAction CSAction;
   bool DebugInfoForProfiling;
   bool PseudoProbeForProfiling;
+  /// Update the counters of IR instrumentation atomically, so that they can
+  /// be shared by threads or, in continuous mode, by processes.
+  bool AtomicCounterUpdate;
 };
 } // namespace llvm
 
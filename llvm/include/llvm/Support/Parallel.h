@@ -18,10 +18,13 @@
 #include <algorithm>
 #include <condition_variable>
 #include <functional>
+#include <memory>
 #include <mutex>
 
 namespace llvm {
 
+class ThreadPoolTaskGroup;
+
 namespace parallel {
 
 // Strategy for the default executor used by the parallel routines provided by
@@ -33,38 +36,11 @@ namespace detail {
 
 #if LLVM_ENABLE_THREADS
 
-class Latch {
-  uint32_t Count;
-  mutable std::mutex Mutex;
-  mutable std::condition_variable Cond;
-
-public:
-  explicit Latch(uint32_t Count = 0) : Count(Count) {}
-  ~Latch() {
-    // Ensure at least that sync() was called.
-    assert(Count == 0);
-  }
-
-  void inc() {
-    std::lock_guard<std::mutex> lock(Mutex);
-    ++Count;
-  }
-
-  void dec() {
-    std::lock_guard<std::mutex> lock(Mutex);
-    if (--Count == 0)
-      Cond.notify_all();
-  }
-
-  void sync() const {
-    std::unique_lock<std::mutex> lock(Mutex);
-    Cond.wait(lock, [&] { return Count == 0; });
-  }
-};
-
+/// A group of tasks run on the thread pool shared by the parallel routines.
+/// Waiting for a group from a thread of the pool runs queued tasks of the
+/// group, so task groups can be nested.
 class TaskGroup {
-  Latch L;
-  bool Parallel;
+  std::unique_ptr<ThreadPoolTaskGroup> Group;
 
 public:
   TaskGroup();
@@ -72,7 +48,7 @@ public:
 
   void spawn(std::function<void()> f);
 
-  void sync() const { L.sync(); }
+  void sync() const;
 };
 
 const ptrdiff_t MinParallelSize = 1024;
@@ -0,0 +1,169 @@
+//===- PerThreadAllocator.h - Arena for concurrent allocation ---*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+///
+/// This file defines PerThreadAllocator, an arena that any number of threads
+/// can allocate from at the same time. Each thread allocates from its own
+/// allocator of the wrapped type, so allocation is as fast as it is for that
+/// allocator and takes no lock. All memory belongs to the arena and is freed
+/// at once, as for BumpPtrAllocator.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_PERTHREADALLOCATOR_H
+#define LLVM_SUPPORT_PERTHREADALLOCATOR_H
+
+#include "llvm/Support/Allocator.h"
+#include "llvm/Support/Compiler.h"
+#include <atomic>
+#include <utility>
+
+namespace llvm {
+
+namespace detail {
+/// Returns an index that no other running thread has. Indices are small and
+/// dense, because an exited thread's index is given to the next new thread.
+unsigned getPerThreadAllocatorIndex();
+} // end namespace detail
+
+/// Wraps one \p AllocatorT per thread.
+///
+/// Allocating is safe from any thread at any time. Everything else, such as
+/// Reset(), DestroyAll() and the statistics, must not run concurrently with
+/// allocation, typically because it runs after the parallel phase ends.
+///
+/// Memory may be used by any thread once allocated; only the allocation
+/// itself is per thread.
+template <typename AllocatorT> class PerThreadAllocator {
+public:
+  PerThreadAllocator() = default;
+  PerThreadAllocator(const PerThreadAllocator &) = delete;
+  PerThreadAllocator &operator=(const PerThreadAllocator &) = delete;
+
+  ~PerThreadAllocator() {
+    for (std::atomic<std::atomic<AllocatorT *> *> &C : Chunks) {
+      std::atomic<AllocatorT *> *Slots = C.load(std::memory_order_relaxed);
+      if (!Slots)
+        continue;
+      for (unsigned I = 0; I != ChunkSize; ++I)
+        delete Slots[I].load(std::memory_order_relaxed);
+      delete[] Slots;
+    }
+  }
+
+  /// Returns the calling thread's allocator.
+  AllocatorT &get() {
+    unsigned Index = detail::getPerThreadAllocatorIndex();
+    if (LLVM_LIKELY(Index < NumChunks * ChunkSize)) {
+      std::atomic<AllocatorT *> *Slots =
+          Chunks[Index / ChunkSize].load(std::memory_order_acquire);
+      if (LLVM_LIKELY(Slots))
+        if (AllocatorT *A = Slots[Index % ChunkSize].load(
+                std::memory_order_relaxed))
+          return *A;
+    }
+    return create(Index);
+  }
+
+  /// Allocates from the calling thread's allocator. Takes the same arguments
+  /// as AllocatorT::Allocate.
+  template <typename... ArgTs>
+  auto Allocate(ArgTs &&...Args)
+      -> decltype(std::declval<AllocatorT &>().Allocate(
+          std::forward<ArgTs>(Args)...)) {
+    return get().Allocate(std::forward<ArgTs>(Args)...);
+  }
+
+  /// Allocates space for \p Num objects of type \p T from the calling
+  /// thread's allocator, as AllocatorBase::Allocate does.
+  template <typename T> T *Allocate(size_t Num = 1) {
+    return get().template Allocate<T>(Num);
+  }
+
+  /// Deallocating is a no-op for bump pointer allocators.
+  void Deallocate(const void *Ptr, size_t Size, size_t Alignment) {}
+
+  /// Frees all memory allocated by all threads. Only for allocators that have
+  /// Reset(), such as BumpPtrAllocator.
+  void Reset() {
+    forEach([](AllocatorT &A) { A.Reset(); });
+  }
+
+  /// Calls the destructors of all objects allocated by all threads and frees
+  /// the memory. Only for SpecificBumpPtrAllocator.
+  void DestroyAll() {
+    forEach([](AllocatorT &A) { A.DestroyAll(); });
+  }
+
+  size_t getTotalMemory() {
+    size_t Total = 0;
+    forEach([&](AllocatorT &A) { Total += A.getTotalMemory(); });
+    return Total;
+  }
+
+  size_t getBytesAllocated() {
+    size_t Total = 0;
+    forEach([&](AllocatorT &A) { Total += A.getBytesAllocated(); });
+    return Total;
+  }
+
+  /// Calls \p Fn on the allocator of every thread that has allocated.
+  template <typename FnT> void forEach(FnT Fn) {
+    for (std::atomic<std::atomic<AllocatorT *> *> &C : Chunks) {
+      std::atomic<AllocatorT *> *Slots = C.load(std::memory_order_acquire);
+      if (!Slots)
+        continue;
+      for (unsigned I = 0; I != ChunkSize; ++I)
+        if (AllocatorT *A = Slots[I].load(std::memory_order_acquire))
+          Fn(*A);
+    }
+  }
+
+private:
+  // Thread allocators are found through a two-level table indexed by thread
+  // index, so that an arena that is only used by a few threads stays small.
+  // A slot is only ever written by the one thread that has its index.
+  static constexpr unsigned ChunkSize = 64;
+  static constexpr unsigned NumChunks = 64;
+  std::atomic<std::atomic<AllocatorT *> *> Chunks[NumChunks] = {};
+
+  LLVM_ATTRIBUTE_NOINLINE AllocatorT &create(unsigned Index) {
+    if (Index >= NumChunks * ChunkSize)
+      report_fatal_error("too many threads for PerThreadAllocator");
+
+    std::atomic<std::atomic<AllocatorT *> *> &C = Chunks[Index / ChunkSize];
+    std::atomic<AllocatorT *> *Slots = C.load(std::memory_order_acquire);
+    if (!Slots) {
+      auto *New = new std::atomic<AllocatorT *>[ChunkSize]();
+      if (C.compare_exchange_strong(Slots, New, std::memory_order_acq_rel))
+        Slots = New;
+      else
+        delete[] New;
+    }
+
+    std::atomic<AllocatorT *> &Slot = Slots[Index % ChunkSize];
+    AllocatorT *A = Slot.load(std::memory_order_relaxed);
+    if (!A) {
+      A = new AllocatorT();
+      Slot.store(A, std::memory_order_release);
+    }
+    return *A;
+  }
+};
+
+/// A BumpPtrAllocator that can be allocated from concurrently.
+using ConcurrentBumpPtrAllocator = PerThreadAllocator<BumpPtrAllocator>;
+
+/// A SpecificBumpPtrAllocator that can be allocated from concurrently.
+template <typename T>
+using ConcurrentSpecificBumpPtrAllocator =
+    PerThreadAllocator<SpecificBumpPtrAllocator<T>>;
+
+} // end namespace llvm
+
+#endif // LLVM_SUPPORT_PERTHREADALLOCATOR_H
@@ -0,0 +1,67 @@
+//===- PerfCounters.h - Hardware performance counters -----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+///
+/// This file declares an interface for sampling the hardware performance
+/// counters of the calling thread, so that Timer and the time trace profiler
+/// can report cycles, cache misses and branch misses for an interval.
+///
+/// Counters are read through perf_event_open on Linux. Elsewhere, or where
+/// the kernel does not allow unprivileged counting, every value reads as zero.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_SUPPORT_PERFCOUNTERS_H
+#define LLVM_SUPPORT_PERFCOUNTERS_H
+
+#include "llvm/Support/DataTypes.h"
+
+namespace llvm {
+
+/// Counts of hardware events and the peak resident set size. A sample from
+/// readPerfCounters() holds running totals; subtracting two samples gives the
+/// counts for the interval between them.
+struct PerfCounterValues {
+  uint64_t Cycles = 0;
+  uint64_t Instructions = 0;
+  uint64_t CacheMisses = 0;
+  uint64_t BranchMisses = 0;
+  /// Peak resident set size of the process in bytes. For an interval, this
+  /// is how much the peak grew.
+  uint64_t PeakRSS = 0;
+
+  void operator+=(const PerfCounterValues &RHS) {
+    Cycles += RHS.Cycles;
+    Instructions += RHS.Instructions;
+    CacheMisses += RHS.CacheMisses;
+    BranchMisses += RHS.BranchMisses;
+    PeakRSS += RHS.PeakRSS;
+  }
+  void operator-=(const PerfCounterValues &RHS) {
+    Cycles -= RHS.Cycles;
+    Instructions -= RHS.Instructions;
+    CacheMisses -= RHS.CacheMisses;
+    BranchMisses -= RHS.BranchMisses;
+    PeakRSS -= RHS.PeakRSS;
+  }
+};
+
+/// Returns true if -track-perf-counters asks Timer and the time trace
+/// profiler to record hardware counters.
+bool perfCountersEnabled();
+
+/// Returns true if the calling thread can count hardware events.
+bool perfCountersAvailable();
+
+/// Samples the hardware counters of the calling thread. The counters start
+/// the first time a thread calls this, and they count user-space events only.
+PerfCounterValues readPerfCounters();
+
+} // end namespace llvm
+
+#endif // LLVM_SUPPORT_PERFCOUNTERS_H
@@ -71,7 +71,7 @@ private:
       uint32_t L[BLOCK_LENGTH / 4];
     } Buffer;
     uint32_t State[HASH_LENGTH / 4];
-    uint32_t ByteCount;
+    uint64_t ByteCount;
     uint8_t BufferOffset;
   } InternalState;
 
@@ -0,0 +1,87 @@
+//===- llvm/Support/SuffixArray.h - Array for substrings --------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file defines the Suffix Array class, which finds the same repeated
+// substrings as the Suffix Tree in less memory.
+//
+//===----------------------------------------------------------------------===//
+#ifndef LLVM_SUPPORT_SUFFIXARRAY_H
+#define LLVM_SUPPORT_SUFFIXARRAY_H
+
+#include "llvm/ADT/ArrayRef.h"
+#include "llvm/Support/SuffixTree.h"
+#include <vector>
+
+namespace llvm {
+
+/// A suffix array with its longest common prefix (LCP) array, used to find
+/// repeated substrings.
+///
+/// A suffix array holds the start index of every suffix of a string, sorted
+/// in lexicographic order. The LCP array holds the length of the longest
+/// common prefix of each pair of adjacent suffixes in that order. Every
+/// internal node of the suffix tree of the string corresponds to an interval
+/// of the suffix array. The suffixes in that interval share a prefix that is
+/// as long as the node's string.
+///
+/// The repeated substrings are the same as those visited by
+/// SuffixTree::RepeatedSubstringIterator. For each internal node of the
+/// suffix tree that is at least two elements long and has at least two leaf
+/// children, there is one substring. Its start indices are those of that
+/// node's leaf children, in increasing order. As is the case for the outliner's
+/// instruction mapping, the last element of the string must be unique.
+///
+/// The arrays take four unsigned integers per element of the string, where
+/// the suffix tree takes a few nodes of several words each. The suffix array
+/// is sorted by prefix doubling, and each round of sorting runs in parallel.
+class SuffixArray {
+public:
+  using RepeatedSubstring = SuffixTree::RepeatedSubstring;
+
+  /// Each element is an integer representing an instruction in the module.
+  ArrayRef<unsigned> Str;
+
+  /// Construct a suffix array from a sequence of unsigned integers and find
+  /// its repeated substrings.
+  ///
+  /// \param Str The string to construct the suffix array for.
+  SuffixArray(const std::vector<unsigned> &Str);
+
+  /// The start index of each suffix, in lexicographic order of the suffixes.
+  ArrayRef<unsigned> getSuffixes() const { return Suffixes; }
+
+  /// LCP[I] is the length of the longest common prefix of the suffixes
+  /// starting at Suffixes[I - 1] and Suffixes[I]. LCP[0] is zero.
+  ArrayRef<unsigned> getLCP() const { return LCP; }
+
+  using iterator = std::vector<RepeatedSubstring>::const_iterator;
+  iterator begin() const { return Repeats.begin(); }
+  iterator end() const { return Repeats.end(); }
+
+private:
+  /// The minimum length of a repeated substring to find, as in the suffix
+  /// tree.
+  const unsigned MinLength = 2;
+
+  std::vector<unsigned> Suffixes;
+  std::vector<unsigned> LCP;
+  std::vector<RepeatedSubstring> Repeats;
+
+  /// Sort the suffixes of Str into Suffixes.
+  void buildSuffixes();
+
+  /// Compute LCP from Suffixes with Kasai's algorithm.
+  void buildLCP();
+
+  /// Walk the LCP intervals bottom-up and collect Repeats.
+  void findRepeats();
+};
+
+} // namespace llvm
+
+#endif // LLVM_SUPPORT_SUFFIXARRAY_H
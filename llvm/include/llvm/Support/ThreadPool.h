@@ -6,7 +6,7 @@
 //
 //===----------------------------------------------------------------------===//
 //
-// This file defines a crude C++11 based thread pool.
+// This file defines a work-stealing C++11 based thread pool.
 //
 //===----------------------------------------------------------------------===//
 
@@ -21,6 +21,7 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -29,13 +30,28 @@
 
 namespace llvm {
 
+class ThreadPoolTaskGroup;
+
 /// A ThreadPool for asynchronous parallel execution on a defined number of
 /// threads.
 ///
-/// The pool keeps a vector of threads alive, waiting on a condition variable
-/// for some work to become available.
+/// Each worker thread owns a queue of tasks. Tasks submitted by a worker go to
+/// the back of its own queue and the worker runs them last in, first out.
+/// Tasks submitted from other threads go to a shared queue. A worker that runs
+/// out of work takes tasks from the shared queue, and then steals the oldest
+/// tasks from the queues of other workers. Workers without work sleep on a
+/// condition variable.
+///
+/// Tasks can be put into a ThreadPoolTaskGroup, which can be waited for on its
+/// own and which carries the priority of its tasks. A worker thread that waits
+/// for a group runs queued tasks of that group instead of blocking, so that
+/// tasks can wait for groups of tasks they spawned without deadlocking the
+/// pool.
 class ThreadPool {
 public:
+  /// The priority of a task. Idle threads run tasks of higher priority first.
+  enum class Priority { High, Normal, Low };
+
   /// Construct a pool using the hardware strategy \p S for mapping hardware
   /// execution resources (threads, cores, CPUs)
   /// Defaults to using the maximum execution resources in the system, but
@@ -54,17 +70,40 @@ public:
     return async(std::move(Task));
   }
 
+  /// Overload, task will be in the given task group.
+  template <typename Function, typename... Args>
+  inline auto async(ThreadPoolTaskGroup &Group, Function &&F,
+                    Args &&...ArgList) {
+    auto Task =
+        std::bind(std::forward<Function>(F), std::forward<Args>(ArgList)...);
+    return async(Group, std::move(Task));
+  }
+
   /// Asynchronous submission of a task to the pool. The returned future can be
   /// used to wait for the task to finish and is *non-blocking* on destruction.
   template <typename Func>
   auto async(Func &&F) -> std::shared_future<decltype(F())> {
-    return asyncImpl(std::function<decltype(F())()>(std::forward<Func>(F)));
+    return asyncImpl(std::function<decltype(F())()>(std::forward<Func>(F)),
+                     nullptr);
+  }
+
+  template <typename Func>
+  auto async(ThreadPoolTaskGroup &Group, Func &&F)
+      -> std::shared_future<decltype(F())> {
+    return asyncImpl(std::function<decltype(F())()>(std::forward<Func>(F)),
+                     &Group);
   }
 
   /// Blocking wait for all the threads to complete and the queue to be empty.
-  /// It is an error to try to add new tasks while blocking on this call.
+  /// It is an error to try to add new tasks while blocking on this call, or to
+  /// call this from a worker thread of the pool.
   void wait();
 
+  /// Blocking wait for all the tasks in the given group to complete. If called
+  /// from a worker thread of the pool, the thread runs queued tasks of the
+  /// group while waiting.
+  void wait(ThreadPoolTaskGroup &Group);
+
   // TODO: misleading legacy name warning!
   // Returns the maximum number of worker threads in the pool, not the current
   // number of threads!
@@ -99,30 +138,17 @@ private:
             std::move(F)};
   }
 
-  bool workCompletedUnlocked() { return !ActiveThreads && Tasks.empty(); }
-
   /// Asynchronous submission of a task to the pool. The returned future can be
   /// used to wait for the task to finish and is *non-blocking* on destruction.
   template <typename ResTy>
-  std::shared_future<ResTy> asyncImpl(std::function<ResTy()> Task) {
+  std::shared_future<ResTy> asyncImpl(std::function<ResTy()> Task,
+                                      ThreadPoolTaskGroup *Group) {
 
 #if LLVM_ENABLE_THREADS
     /// Wrap the Task in a std::function<void()> that sets the result of the
     /// corresponding future.
     auto R = createTaskAndFuture(Task);
-
-    int requestedThreads;
-    {
-      // Lock the queue and push the new task
-      std::unique_lock<std::mutex> LockGuard(QueueLock);
-
-      // Don't allow enqueueing after disabling the pool
-      assert(EnableFlag && "Queuing a thread during ThreadPool destruction");
-      Tasks.push(std::move(R.first));
-      requestedThreads = ActiveThreads + Tasks.size();
-    }
-    QueueCondition.notify_one();
-    grow(requestedThreads);
+    enqueue(std::move(R.first), Group);
     return R.second.share();
 
 #else // LLVM_ENABLE_THREADS Disabled
@@ -131,45 +157,125 @@ private:
     auto Future = std::async(std::launch::deferred, std::move(Task)).share();
     // Wrap the future so that both ThreadPool::wait() can operate and the
     // returned future can be sync'ed on.
-    Tasks.push([Future]() { Future.get(); });
+    enqueue([Future]() { Future.get(); }, Group);
     return Future;
 #endif
   }
 
+  struct Task {
+    std::function<void()> Fn;
+    ThreadPoolTaskGroup *Group = nullptr;
+  };
+
+  /// Queue a task and wake up a thread to run it.
+  void enqueue(std::function<void()> Fn, ThreadPoolTaskGroup *Group);
+
+  /// Run a task and account for its completion.
+  void runTask(Task &T);
+
 #if LLVM_ENABLE_THREADS
+  struct WorkQueue;
+
+  static constexpr unsigned NumPriorities = 3;
+
   // Grow to ensure that we have at least `requested` Threads, but do not go
   // over MaxThreadCount.
   void grow(int requested);
-#endif
+
+  /// The main loop of worker thread \p WorkerIndex.
+  void processTasks(unsigned WorkerIndex);
+
+  /// Take the next task to run on worker thread \p WorkerIndex, or on a thread
+  /// outside the pool if \p WorkerIndex is -1. If \p Group is not null, only
+  /// take tasks of that group. Returns false if there is no such task.
+  bool popTask(int WorkerIndex, ThreadPoolTaskGroup *Group, Task &T);
+
+  /// Wake up threads waiting in wait().
+  void notifyCompletion();
 
   /// Threads in flight
   std::vector<llvm::thread> Threads;
   /// Lock protecting access to the Threads vector.
   mutable std::mutex ThreadsLock;
+  /// The number of threads in Threads, readable without ThreadsLock.
+  std::atomic<unsigned> NumThreads{0};
 
-  /// Tasks waiting for execution in the pool.
-  std::queue<std::function<void()>> Tasks;
+  /// Task queues. Queues[0] is the shared queue for tasks submitted from
+  /// outside the pool, Queues[I + 1] belongs to worker thread I.
+  std::unique_ptr<WorkQueue[]> Queues;
+
+  /// The number of queued tasks of each priority, so that searching for work
+  /// can skip priorities without any.
+  std::atomic<unsigned> QueuedTasks[NumPriorities];
+
+  /// The total number of queued tasks.
+  std::atomic<unsigned> TotalQueuedTasks{0};
 
-  /// Locking and signaling for accessing the Tasks queue.
-  std::mutex QueueLock;
-  std::condition_variable QueueCondition;
+  /// The number of tasks submitted but not yet completed.
+  std::atomic<unsigned> OutstandingTasks{0};
+
+  /// Idle worker threads sleep on this condition.
+  std::mutex SleepLock;
+  std::condition_variable SleepCondition;
+  std::atomic<unsigned> NumSleeping{0};
 
   /// Signaling for job completion
+  std::mutex CompletionLock;
   std::condition_variable CompletionCondition;
 
-  /// Keep track of the number of thread actually busy
-  unsigned ActiveThreads = 0;
-
-#if LLVM_ENABLE_THREADS // avoids warning for unused variable
   /// Signal for the destruction of the pool, asking thread to exit.
-  bool EnableFlag = true;
-#endif
+  std::atomic<bool> EnableFlag{true};
 
   const ThreadPoolStrategy Strategy;
+#else
+  /// Tasks waiting for execution in the pool.
+  std::deque<Task> Tasks;
+#endif
 
   /// Maximum number of threads to potentially grow this pool to.
   const unsigned MaxThreadCount;
 };
-}
+
+/// A group of tasks to be run on a ThreadPool. Tasks of a group can be waited
+/// for separately from the other tasks of the pool, and they share a priority.
+class ThreadPoolTaskGroup {
+public:
+  /// The ThreadPool argument is the thread pool to forward calls to.
+  explicit ThreadPoolTaskGroup(
+      ThreadPool &Pool,
+      ThreadPool::Priority Prio = ThreadPool::Priority::Normal)
+      : Pool(Pool), Prio(Prio) {}
+
+  /// Blocking destructor: will wait for all the tasks in the group to complete
+  /// by calling ThreadPool::wait().
+  ~ThreadPoolTaskGroup() { wait(); }
+
+  /// Calls ThreadPool::async() for this group.
+  template <typename Function, typename... Args>
+  inline auto async(Function &&F, Args &&...ArgList) {
+    return Pool.async(*this, std::forward<Function>(F),
+                      std::forward<Args>(ArgList)...);
+  }
+
+  /// Calls ThreadPool::wait() for this group.
+  void wait() { Pool.wait(*this); }
+
+  ThreadPool::Priority getPriority() const { return Prio; }
+
+private:
+  friend class ThreadPool;
+
+  ThreadPool &Pool;
+  const ThreadPool::Priority Prio;
+
+  /// The number of tasks submitted but not yet completed.
+  std::atomic<unsigned> OutstandingTasks{0};
+  /// The number of tasks submitted but not yet started.
+  std::atomic<unsigned> QueuedTasks{0};
+  /// The number of worker threads sleeping in ThreadPool::wait() for this
+  /// group.
+  std::atomic<unsigned> NumWaiters{0};
+};
+} // namespace llvm
 
 #endif // LLVM_SUPPORT_THREADPOOL_H
@@ -20,8 +20,17 @@ TimeTraceProfiler *getTimeTraceProfilerInstance();
 /// Initialize the time trace profiler.
 /// This sets up the global \p TimeTraceProfilerInstance
 /// variable to be the profiler instance.
+///
+/// If \p RingBufferSize is nonzero, the profiler runs in ring-buffer mode: it
+/// keeps only the most recent \p RingBufferSize sections (rounded up to a
+/// power of two) that lasted at least \p TimeTraceGranularity microseconds, in
+/// fixed-size records that are allocated up front. Section names are interned
+/// and details are truncated, so recording a section does not allocate. This
+/// mode is cheap enough to leave enabled and write a trace only when a run
+/// turns out to be slow. The per-name totals still cover every section.
 void timeTraceProfilerInitialize(unsigned TimeTraceGranularity,
-                                 StringRef ProcName);
+                                 StringRef ProcName,
+                                 size_t RingBufferSize = 0);
 
 /// Cleanup the time trace profiler, if it was initialized.
 void timeTraceProfilerCleanup();
@@ -34,6 +43,10 @@ inline bool timeTraceProfilerEnabled() {
   return getTimeTraceProfilerInstance() != nullptr;
 }
 
+/// Returns the time in microseconds since the profiler on this thread was
+/// initialized.
+uint64_t timeTraceProfilerElapsedUs();
+
 /// Write profiling data to output stream.
 /// Data produced is JSON, in Chrome "Trace Event" format, see
 /// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU/preview
@@ -50,7 +63,9 @@ Error timeTraceProfilerWrite(StringRef PreferredFileName,
 /// Manually begin a time section, with the given \p Name and \p Detail.
 /// Profiler copies the string data, so the pointers can be given into
 /// temporaries. Time sections can be hierarchical; every Begin must have a
-/// matching End pair but they can nest.
+/// matching End pair but they can nest. In ring-buffer mode the \p Detail
+/// callback is still called for every section, so hot callers should prefer
+/// the StringRef overload.
 void timeTraceProfilerBegin(StringRef Name, StringRef Detail);
 void timeTraceProfilerBegin(StringRef Name,
                             llvm::function_ref<std::string()> Detail);
@@ -12,6 +12,7 @@
 #include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/DataTypes.h"
+#include "llvm/Support/PerfCounters.h"
 #include <cassert>
 #include <string>
 #include <utility>
@@ -29,6 +30,7 @@ class TimeRecord {
   double SystemTime;             ///< System time elapsed.
   ssize_t MemUsed;               ///< Memory allocated (in bytes).
   uint64_t InstructionsExecuted; ///< Number of instructions executed
+  PerfCounterValues Counters;    ///< Hardware counters, if -track-perf-counters
 public:
   TimeRecord()
       : WallTime(0), UserTime(0), SystemTime(0), MemUsed(0),
@@ -46,6 +48,7 @@ public:
   double getWallTime() const { return WallTime; }
   ssize_t getMemUsed() const { return MemUsed; }
   uint64_t getInstructionsExecuted() const { return InstructionsExecuted; }
+  const PerfCounterValues &getPerfCounters() const { return Counters; }
 
   bool operator<(const TimeRecord &T) const {
     // Sort by Wall Time elapsed, as it is the only thing really accurate
@@ -58,6 +61,7 @@ public:
     SystemTime += RHS.SystemTime;
     MemUsed += RHS.MemUsed;
     InstructionsExecuted += RHS.InstructionsExecuted;
+    Counters += RHS.Counters;
   }
   void operator-=(const TimeRecord &RHS) {
     WallTime -= RHS.WallTime;
@@ -65,6 +69,7 @@ public:
     SystemTime -= RHS.SystemTime;
     MemUsed -= RHS.MemUsed;
     InstructionsExecuted -= RHS.InstructionsExecuted;
+    Counters -= RHS.Counters;
   }
 
   /// Print the current time record to \p OS, with a breakdown showing
@@ -20,6 +20,7 @@
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Support/Chrono.h"
+#include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Path.h"
@@ -39,6 +40,7 @@ namespace llvm {
 class MemoryBuffer;
 class MemoryBufferRef;
 class Twine;
+class raw_ostream;
 
 namespace vfs {
 
@@ -942,6 +944,61 @@ public:
   void write(llvm::raw_ostream &OS);
 };
 
+/// A file system that answers status queries for the files in a directory
+/// tree, such as an SDK or a directory of system headers, from a stat cache
+/// written by \c writeStatCache. The cache replaces the status calls and the
+/// failed opens of header search in the tree, which every compilation repeats
+/// and which are slow on network file systems, and it is shared by all the
+/// processes that read it.
+///
+/// Paths in the tree that are not in the cache are reported as missing
+/// without asking the underlying file system. Files are still opened and
+/// directories still listed through the underlying file system. The cache is
+/// only used while the root of the tree has the modification time it had
+/// when the cache was written, and it must be written again whenever
+/// anything else in the tree changes.
+class StatCacheFileSystem : public ProxyFileSystem {
+public:
+  ~StatCacheFileSystem() override;
+
+  /// Creates a file system on top of \p FS that uses the stat cache in
+  /// \p CacheBuffer. Fails if the buffer is not a stat cache, or if the root
+  /// of the tree changed since the cache was written.
+  static Expected<IntrusiveRefCntPtr<StatCacheFileSystem>>
+  create(std::unique_ptr<MemoryBuffer> CacheBuffer,
+         IntrusiveRefCntPtr<FileSystem> FS);
+
+  /// Writes a stat cache for the directory tree at the absolute path \p Root
+  /// of the real file system to \p OS.
+  static Error writeStatCache(StringRef Root, raw_ostream &OS);
+
+  llvm::ErrorOr<Status> status(const Twine &Path) override;
+  llvm::ErrorOr<std::unique_ptr<File>>
+  openFileForRead(const Twine &Path) override;
+
+private:
+  StatCacheFileSystem(std::unique_ptr<MemoryBuffer> CacheBuffer,
+                      IntrusiveRefCntPtr<FileSystem> FS, StringRef Root,
+                      const char *Entries, uint32_t NumEntries,
+                      StringRef Names);
+
+  enum class LookupResult { Found, Missing, Unknown };
+
+  /// Looks up \p Path in the cache. Returns Unknown for paths outside the
+  /// tree and for paths the cache cannot answer, such as the ones below a
+  /// symbolic link to a directory.
+  LookupResult lookup(const Twine &Path, Status &Result);
+
+  /// Returns the entry for \p Name, relative to the root, or null.
+  const char *findEntry(StringRef Name) const;
+
+  std::unique_ptr<MemoryBuffer> CacheBuffer;
+  StringRef Root;
+  const char *Entries;
+  uint32_t NumEntries;
+  StringRef Names;
+};
+
 } // namespace vfs
 } // namespace llvm
 
@@ -21,6 +21,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
+#include <memory>
 #include <string>
 #if __cplusplus > 201402L
 #include <string_view>
@@ -457,9 +458,25 @@ class raw_fd_ostream : public raw_pwrite_stream {
 
   uint64_t pos = 0;
 
+  /// The buffers and writer thread used after enableAsyncWrites().
+  struct AsyncWriter;
+  std::unique_ptr<AsyncWriter> Async;
+
   /// See raw_ostream::write_impl.
   void write_impl(const char *Ptr, size_t Size) override;
 
+  /// Hand \p Ptr to the writer thread. It is either the current buffer, which
+  /// is swapped for a free one, or data written around the buffer, which is
+  /// copied.
+  void write_async(const char *Ptr, size_t Size);
+
+  /// Wait until the writer thread has written every queued buffer.
+  void wait_for_async_writes();
+
+  /// Flush the stream, stop the writer thread and go back to writing
+  /// synchronously.
+  void finish_async_writes();
+
   void pwrite_impl(const char *Ptr, size_t Size, uint64_t Offset) override;
 
   /// Return the current position within the stream, not counting the bytes
@@ -517,6 +534,22 @@ public:
 
   bool isRegularFile() const { return IsRegularFile; }
 
+  /// Write buffers on a background thread so that filling the stream does not
+  /// wait for write(2). The stream fills one of \p NumBuffers buffers of
+  /// \p BufferSize bytes each while the others are written in order. It only
+  /// blocks when all of them are waiting to be written.
+  ///
+  /// flush() only queues the buffer. close(), seek(), pwrite() and the
+  /// destructor wait for all queued writes and report their errors, so data
+  /// is on the file descriptor by the time they return, as it is
+  /// without this mode. Errors of other writes show up in error() only after
+  /// one of these calls.
+  ///
+  /// This has no effect unless the stream writes to a regular file, or when
+  /// LLVM is built without threads.
+  void enableAsyncWrites(size_t BufferSize = 1024 * 1024,
+                         unsigned NumBuffers = 4);
+
   /// Flushes the stream and repositions the underlying file descriptor position
   /// to the offset specified from the beginning of the file.
   uint64_t seek(uint64_t off);
@@ -320,6 +320,10 @@ private:
 protected:
   uint8_t Opc; // Used by UnOpInit, BinOpInit, and TernOpInit
 
+  /// Used by BitsInit, ListInit and DagInit: set when the uniqued value is
+  /// created if all of its elements are trivially resolved.
+  bool TriviallyResolved = false;
+
 private:
   virtual void anchor();
 
@@ -342,6 +346,11 @@ public:
   /// stuck operations? Unset values are concrete.
   virtual bool isConcrete() const { return false; }
 
+  /// Does resolveReferences return this value itself, whatever the resolver?
+  /// This holds for plain values and for aggregates made only of them, and
+  /// lets resolution skip such aggregates without visiting their elements.
+  bool isTriviallyResolved() const;
+
   /// Print this value.
   void print(raw_ostream &OS) const { OS << getAsString(); }
 
@@ -1880,8 +1889,8 @@ public:
 
   /// Stop phase timing and print the report.
   void stopPhaseTiming() {
-    if (TimingGroup)
-      delete TimingGroup;
+    delete TimingGroup;
+    TimingGroup = nullptr;
   }
 
   //===--------------------------------------------------------------------===//
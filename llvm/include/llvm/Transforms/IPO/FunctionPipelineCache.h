@@ -0,0 +1,92 @@
+//===- FunctionPipelineCache.h - Cache optimized functions ------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+///
+/// This file declares an experimental module-to-function pass adaptor that
+/// keeps the result of a function pipeline in an on-disk cache shared between
+/// compiler invocations. It is meant for the inline functions and template
+/// instantiations that every translation unit including a header optimizes
+/// again, with the same input and the same pipeline.
+///
+/// Before running the pipeline on a function, the adaptor extracts the function
+/// into a module of its own, together with declarations of the globals it
+/// refers to and the initializers of the constants among them, and hashes that
+/// module with the pipeline. On a miss, the pipeline runs and the optimized
+/// function is extracted the same way and stored under the hash, like the
+/// ThinLTO cache stores backend results. On a hit, the cached body replaces the
+/// function's body and the pipeline does not run.
+///
+/// The key covers the IR of the function and of everything a function pass may
+/// look at, but not command-line options that change what passes do, so the
+/// cache directory must not be shared between compilers run with different
+/// internal options.
+///
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_TRANSFORMS_IPO_FUNCTIONPIPELINECACHE_H
+#define LLVM_TRANSFORMS_IPO_FUNCTIONPIPELINECACHE_H
+
+#include "llvm/IR/PassManager.h"
+#include <memory>
+#include <string>
+
+namespace llvm {
+
+/// Runs a function pass over every function in a module, like
+/// ModuleToFunctionPassAdaptor, but takes the result for a function from the
+/// cache in \c CacheDir when the same function went through the same pass
+/// before.
+///
+/// \c ExtraKey is hashed into every key. It should hold whatever else changes
+/// the result of the pass, such as the target CPU and features.
+///
+/// Functions with debug info, prefix or prologue data, address-taken blocks,
+/// or references to unnamed globals are not cached; the pass runs on them as
+/// usual.
+class CachingModuleToFunctionPassAdaptor
+    : public PassInfoMixin<CachingModuleToFunctionPassAdaptor> {
+public:
+  using PassConceptT = detail::PassConcept<Function, FunctionAnalysisManager>;
+
+  CachingModuleToFunctionPassAdaptor(std::unique_ptr<PassConceptT> Pass,
+                                     std::string CacheDir,
+                                     std::string ExtraKey = "")
+      : Pass(std::move(Pass)), CacheDir(std::move(CacheDir)),
+        ExtraKey(std::move(ExtraKey)) {}
+
+  PreservedAnalyses run(Module &M, ModuleAnalysisManager &AM);
+  void printPipeline(raw_ostream &OS,
+                     function_ref<StringRef(StringRef)> MapClassName2PassName);
+
+  static bool isRequired() { return true; }
+
+private:
+  std::unique_ptr<PassConceptT> Pass;
+  std::string CacheDir;
+  std::string ExtraKey;
+};
+
+/// A function to deduce a function pass type and wrap it in the
+/// caching adaptor.
+template <typename FunctionPassT>
+CachingModuleToFunctionPassAdaptor
+createCachingModuleToFunctionPassAdaptor(FunctionPassT &&Pass,
+                                         std::string CacheDir,
+                                         std::string ExtraKey = "") {
+  using PassModelT =
+      detail::PassModel<Function, FunctionPassT, PreservedAnalyses,
+                        FunctionAnalysisManager>;
+  return CachingModuleToFunctionPassAdaptor(
+      std::unique_ptr<CachingModuleToFunctionPassAdaptor::PassConceptT>(
+          new PassModelT(std::forward<FunctionPassT>(Pass))),
+      std::move(CacheDir), std::move(ExtraKey));
+}
+
+} // end namespace llvm
+
+#endif // LLVM_TRANSFORMS_IPO_FUNCTIONPIPELINECACHE_H
@@ -69,6 +69,14 @@ private:
   // vector of counter load/store pairs to be register promoted.
   std::vector<LoadStorePair> PromotionCandidates;
 
+  // The offset of the current thread's counter shard, loaded at the entry of
+  // the function being lowered when per-thread counters are enabled.
+  Value *CounterShardOffset = nullptr;
+
+  // Whether the current thread is in a sampling burst, computed at the entry
+  // of the function being lowered when sampled instrumentation is enabled.
+  Value *SamplingCond = nullptr;
+
   int64_t TotalCountersPromoted = 0;
 
   /// Lower instrumentation intrinsics in the function. Returns true if there
@@ -81,6 +89,20 @@ private:
   /// Returns true if relocating counters at runtime is enabled.
   bool isRuntimeCounterRelocationEnabled() const;
 
+  /// Returns true if counters are updated in per-thread shards.
+  bool isPerThreadCountersEnabled() const;
+
+  /// Load the offset of the current thread's counter shard at the entry of
+  /// \p F, and allocate the shard if the thread does not have one yet.
+  Value *emitCounterShardOffset(Function &F);
+
+  /// Returns true if counters are only updated in periodic sampling bursts.
+  bool isSamplingEnabled() const;
+
+  /// Advance the sampling state of the current thread at the entry of \p F,
+  /// and return whether the counters of this call should be updated.
+  Value *emitSamplingCond(Function &F);
+
   /// Returns true if profile counter update register promotion is enabled.
   bool isCounterPromotionEnabled() const;
 
@@ -12,6 +12,7 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/IR/Instruction.h"
 #include "llvm/Support/Compiler.h"
@@ -29,6 +30,10 @@ class InstructionWorklist {
   /// combine has finished. This means that these instructions will be visited
   /// in the order they have been added.
   SmallSetVector<Instruction *, 16> Deferred;
+  /// While tracking changes, the instructions added or pushed since tracking
+  /// started.
+  SmallPtrSet<Instruction *, 16> Changed;
+  bool TrackChanges = false;
 
 public:
   InstructionWorklist() = default;
@@ -42,6 +47,8 @@ public:
   /// Instructions will be visited in the order they are added.
   /// You likely want to use this method.
   void add(Instruction *I) {
+    if (TrackChanges)
+      Changed.insert(I);
     if (Deferred.insert(I))
       LLVM_DEBUG(dbgs() << "ADD DEFERRED: " << *I << '\n');
   }
@@ -59,6 +66,8 @@ public:
     assert(I);
     assert(I->getParent() && "Instruction not inserted yet?");
 
+    if (TrackChanges)
+      Changed.insert(I);
     if (WorklistMap.insert(std::make_pair(I, Worklist.size())).second) {
       LLVM_DEBUG(dbgs() << "ADD: " << *I << '\n');
       Worklist.push_back(I);
@@ -91,6 +100,7 @@ public:
     }
 
     Deferred.remove(I);
+    Changed.erase(I);
   }
 
   Instruction *removeOne() {
@@ -108,6 +118,21 @@ public:
       push(cast<Instruction>(U));
   }
 
+  /// Starts recording the instructions that are added or pushed, which are
+  /// those that changed and those next to a change.
+  void startTrackingChanges() {
+    Changed.clear();
+    TrackChanges = true;
+  }
+
+  /// Stops recording, and returns the instructions recorded. Only removed
+  /// instructions are dropped from the set, so it may hold instructions that
+  /// were deleted otherwise, and must only be checked for membership.
+  SmallPtrSet<Instruction *, 16> takeChanges() {
+    TrackChanges = false;
+    return std::move(Changed);
+  }
+
   /// Check that the worklist is empty and nuke the backing store for the map.
   void zap() {
     assert(WorklistMap.empty() && "Worklist empty, but map not?");
@@ -551,6 +551,7 @@ PreservedAnalyses CGSCCToFunctionPassAdaptor::run(LazyCallGraph::SCC &C,
 
     PreservedAnalyses PassPA;
     {
+      TimeTraceScope FunctionScope("OptFunction", F.getName());
       TimeTraceScope TimeScope(Pass->name());
       PassPA = Pass->run(F, FAM);
     }
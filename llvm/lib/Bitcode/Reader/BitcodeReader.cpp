@@ -69,6 +69,7 @@
 #include "llvm/Support/ManagedStatic.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
 #include <cassert>
@@ -544,6 +545,32 @@ class BitcodeReader : public BitcodeReaderBase, public GVMaterializer {
   DenseMap<Function *, std::vector<BasicBlock *>> BasicBlockFwdRefs;
   std::deque<Function *> BasicBlockFwdRefQueue;
 
+  /// The records of a function block, decoded on another thread so that
+  /// parseFunctionBody() only has to build the IR. Sub-blocks are skipped
+  /// and read from the stream as usual.
+  struct PredecodedFunctionBody {
+    struct DecodedRecord {
+      uint64_t StartBit; // After the abbreviation ID.
+      uint64_t EndBit;
+      unsigned Code;
+      size_t OpsBegin;
+      size_t OpsEnd;
+    };
+    std::vector<DecodedRecord> Records;
+    SmallVector<uint64_t, 0> Ops;
+    size_t NextRecord = 0;
+    std::shared_future<void> Done;
+
+    void decode(BitstreamCursor &Cursor, uint64_t FuncBit);
+    Expected<unsigned> readRecord(BitstreamCursor &Stream, unsigned AbbrevID,
+                                  SmallVectorImpl<uint64_t> &Vals);
+  };
+  DenseMap<Function *, std::unique_ptr<PredecodedFunctionBody>>
+      PredecodedBodies;
+
+  /// If set, materializeModule() decodes function bodies on these threads.
+  Optional<ThreadPoolStrategy> DecodeStrategy;
+
   /// Indicates that we are using a new encoding for instruction operands where
   /// most operands in the current FUNCTION_BLOCK are encoded relative to the
   /// instruction number, for a more compact encoding.  Some instruction
@@ -572,6 +599,8 @@ public:
   Error materializeModule() override;
   std::vector<StructType *> getIdentifiedStructTypes() const override;
 
+  void setDecodeStrategy(ThreadPoolStrategy S) { DecodeStrategy = S; }
+
   /// Main interface to parsing a bitcode buffer.
   /// \returns true if an error occurred.
   Error parseBitcodeInto(
@@ -719,6 +748,7 @@ private:
   Error rememberAndSkipMetadata();
   Error typeCheckLoadStoreInst(Type *ValType, Type *PtrType);
   Error parseFunctionBody(Function *F);
+  Error materializeFunctionsInParallel();
   Error globalCleanup();
   Error resolveGlobalAndIndirectSymbolInits();
   Error parseUseLists();
@@ -3972,6 +4002,14 @@ Error BitcodeReader::parseFunctionBody(Function *F) {
   unsigned ModuleValueListSize = ValueList.size();
   unsigned ModuleMDLoaderSize = MDLoader->size();
 
+  std::unique_ptr<PredecodedFunctionBody> Predecoded;
+  auto PBI = PredecodedBodies.find(F);
+  if (PBI != PredecodedBodies.end()) {
+    Predecoded = std::move(PBI->second);
+    PredecodedBodies.erase(PBI);
+    Predecoded->Done.wait();
+  }
+
   // Add all the function arguments to the value table.
 #ifndef NDEBUG
   unsigned ArgNo = 0;
@@ -4053,7 +4091,9 @@ Error BitcodeReader::parseFunctionBody(Function *F) {
     // Read a record.
     Record.clear();
     Instruction *I = nullptr;
-    Expected<unsigned> MaybeBitCode = Stream.readRecord(Entry.ID, Record);
+    Expected<unsigned> MaybeBitCode =
+        Predecoded ? Predecoded->readRecord(Stream, Entry.ID, Record)
+                   : Stream.readRecord(Entry.ID, Record);
     if (!MaybeBitCode)
       return MaybeBitCode.takeError();
     switch (unsigned BitCode = MaybeBitCode.get()) {
@@ -5554,6 +5594,61 @@ OutOfRecordLoop:
   return Error::success();
 }
 
+void BitcodeReader::PredecodedFunctionBody::decode(BitstreamCursor &Cursor,
+                                                   uint64_t FuncBit) {
+  // Errors are dropped here. parseFunctionBody() reads every record that was
+  // not decoded ahead from the stream, and reports the error then.
+  if (errorToBool(Cursor.JumpToBit(FuncBit)) ||
+      errorToBool(Cursor.EnterSubBlock(bitc::FUNCTION_BLOCK_ID)))
+    return;
+
+  while (true) {
+    Expected<BitstreamEntry> MaybeEntry = Cursor.advance();
+    if (!MaybeEntry) {
+      consumeError(MaybeEntry.takeError());
+      return;
+    }
+    BitstreamEntry Entry = MaybeEntry.get();
+
+    switch (Entry.Kind) {
+    case BitstreamEntry::Error:
+    case BitstreamEntry::EndBlock:
+      return;
+    case BitstreamEntry::SubBlock:
+      if (errorToBool(Cursor.SkipBlock()))
+        return;
+      continue;
+    case BitstreamEntry::Record:
+      break;
+    }
+
+    uint64_t StartBit = Cursor.GetCurrentBitNo();
+    size_t OpsBegin = Ops.size();
+    Expected<unsigned> MaybeCode = Cursor.readRecord(Entry.ID, Ops);
+    if (!MaybeCode) {
+      consumeError(MaybeCode.takeError());
+      Ops.truncate(OpsBegin);
+      return;
+    }
+    Records.push_back(
+        {StartBit, Cursor.GetCurrentBitNo(), *MaybeCode, OpsBegin, Ops.size()});
+  }
+}
+
+Expected<unsigned> BitcodeReader::PredecodedFunctionBody::readRecord(
+    BitstreamCursor &Stream, unsigned AbbrevID,
+    SmallVectorImpl<uint64_t> &Vals) {
+  if (NextRecord == Records.size() ||
+      Records[NextRecord].StartBit != Stream.GetCurrentBitNo())
+    return Stream.readRecord(AbbrevID, Vals);
+
+  const DecodedRecord &R = Records[NextRecord++];
+  Vals.append(Ops.begin() + R.OpsBegin, Ops.begin() + R.OpsEnd);
+  if (Error JumpFailed = Stream.JumpToBit(R.EndBit))
+    return std::move(JumpFailed);
+  return R.Code;
+}
+
 /// Find the function body in the bitcode stream
 Error BitcodeReader::findFunctionInStream(
     Function *F,
@@ -5697,9 +5792,14 @@ Error BitcodeReader::materializeModule() {
 
   // Iterate over the module, deserializing any functions that are still on
   // disk.
-  for (Function &F : *TheModule) {
-    if (Error Err = materialize(&F))
+  if (DecodeStrategy) {
+    if (Error Err = materializeFunctionsInParallel())
       return Err;
+  } else {
+    for (Function &F : *TheModule) {
+      if (Error Err = materialize(&F))
+        return Err;
+    }
   }
   // At this point, if there are any function bodies, parse the rest of
   // the bits in the module past the last function block we have recorded
@@ -5745,6 +5845,47 @@ Error BitcodeReader::materializeModule() {
   return Error::success();
 }
 
+/// Materializes the functions of the module in order, like materializeModule()
+/// does, while the bodies of the functions that follow are decoded on the
+/// threads of DecodeStrategy. Only building the IR needs the LLVMContext, and
+/// that stays on this thread. At most a window of bodies is decoded ahead, to
+/// bound the memory held by decoded records.
+Error BitcodeReader::materializeFunctionsInParallel() {
+  std::vector<Function *> Functions;
+  for (Function &F : *TheModule)
+    Functions.push_back(&F);
+
+  ThreadPool Pool(*DecodeStrategy);
+  size_t Window = 16 * Pool.getThreadCount();
+  size_t NextToDecode = 0;
+
+  for (size_t I = 0, E = Functions.size(); I != E; ++I) {
+    for (; NextToDecode != std::min(I + Window, E); ++NextToDecode) {
+      Function *F = Functions[NextToDecode];
+      if (!F->isMaterializable())
+        continue;
+      // Bodies whose position is not known yet are found and parsed by
+      // materialize() as usual.
+      auto DFII = DeferredFunctionInfo.find(F);
+      if (DFII == DeferredFunctionInfo.end() || DFII->second == 0)
+        continue;
+
+      auto Body = std::make_unique<PredecodedFunctionBody>();
+      PredecodedFunctionBody *B = Body.get();
+      uint64_t FuncBit = DFII->second;
+      BitstreamCursor Cursor = Stream;
+      B->Done = Pool.async([B, Cursor, FuncBit]() mutable {
+        B->decode(Cursor, FuncBit);
+      });
+      PredecodedBodies[F] = std::move(Body);
+    }
+
+    if (Error Err = materialize(Functions[I]))
+      return Err;
+  }
+  return Error::success();
+}
+
 std::vector<StructType *> BitcodeReader::getIdentifiedStructTypes() const {
   return IdentifiedStructTypes;
 }
@@ -6042,8 +6183,16 @@ std::vector<FunctionSummary::EdgeTy>
 ModuleSummaryIndexBitcodeReader::makeCallList(ArrayRef<uint64_t> Record,
                                               bool IsOldProfileFormat,
                                               bool HasProfile, bool HasRelBF) {
+  // Each edge takes the callee and, depending on the format, one or two more
+  // fields. Reserve exactly the number of edges, since the lists of all the
+  // functions in the combined index stay alive for the whole thin link.
+  unsigned FieldsPerEdge = 1;
+  if (IsOldProfileFormat)
+    FieldsPerEdge += HasProfile ? 2 : 1;
+  else if (HasProfile || HasRelBF)
+    FieldsPerEdge += 1;
   std::vector<FunctionSummary::EdgeTy> Ret;
-  Ret.reserve(Record.size());
+  Ret.reserve(Record.size() / FieldsPerEdge);
   for (unsigned I = 0, E = Record.size(); I != E; ++I) {
     CalleeInfo::HotnessType Hotness = CalleeInfo::HotnessType::Unknown;
     uint64_t RelBF = 0;
@@ -7068,6 +7217,13 @@ Expected<std::unique_ptr<Module>> llvm::getOwningLazyBitcodeModule(
   return MOrErr;
 }
 
+Error llvm::materializeAllInParallel(Module &M, ThreadPoolStrategy S) {
+  // BitcodeReader is the only GVMaterializer.
+  if (GVMaterializer *R = M.getMaterializer())
+    static_cast<BitcodeReader *>(R)->setDecodeStrategy(S);
+  return M.materializeAll();
+}
+
 Expected<std::unique_ptr<Module>>
 BitcodeModule::parseModule(LLVMContext &Context,
                            DataLayoutCallbackTy DataLayoutCallback) {
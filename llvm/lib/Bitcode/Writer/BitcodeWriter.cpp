@@ -68,8 +68,10 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/MathExtras.h"
 #include "llvm/Support/SHA1.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -205,6 +207,15 @@ public:
               assignValueId(CallEdge.first.getGUID());
   }
 
+  /// Constructs a ModuleBitcodeWriterBase object that writes parts of
+  /// \p Parent's module to \p Stream, numbering values as \p Parent does.
+  ModuleBitcodeWriterBase(const ModuleBitcodeWriterBase &Parent,
+                          BitstreamWriter &Stream)
+      : BitcodeWriterBase(Stream, Parent.StrtabBuilder), M(Parent.M),
+        VE(Parent.VE), Index(Parent.Index),
+        GUIDToValueIdMap(Parent.GUIDToValueIdMap),
+        GlobalValueId(Parent.GlobalValueId) {}
+
 protected:
   void writePerModuleGlobalValueSummary();
 
@@ -260,6 +271,9 @@ class ModuleBitcodeWriter : public ModuleBitcodeWriterBase {
   /// The start bit of the identification block.
   uint64_t BitcodeStartBit;
 
+  /// If set, function blocks are encoded on these threads.
+  Optional<ThreadPoolStrategy> EncodeStrategy;
+
 public:
   /// Constructs a ModuleBitcodeWriter object for the given Module,
   /// writing to the provided \p Buffer.
@@ -273,6 +287,16 @@ public:
         Buffer(Buffer), GenerateHash(GenerateHash), ModHash(ModHash),
         BitcodeStartBit(Stream.GetCurrentBitNo()) {}
 
+  /// Constructs a ModuleBitcodeWriter object that writes function blocks of
+  /// \p Parent's module to \p Stream, for \p Parent to copy into its own.
+  ModuleBitcodeWriter(const ModuleBitcodeWriter &Parent,
+                      SmallVectorImpl<char> &Buffer, BitstreamWriter &Stream)
+      : ModuleBitcodeWriterBase(Parent, Stream), Buffer(Buffer),
+        GenerateHash(false), ModHash(nullptr), BitcodeStartBit(0) {}
+
+  /// Encode function blocks on threads picked by \p S.
+  void setEncodeStrategy(ThreadPoolStrategy S) { EncodeStrategy = S; }
+
   /// Emit the current module to the bitstream.
   void write();
 
@@ -397,6 +421,8 @@ private:
   void
   writeFunction(const Function &F,
                 DenseMap<const Function *, uint64_t> &FunctionToBitcodeIndex);
+  bool writeFunctionsInParallel(
+      DenseMap<const Function *, uint64_t> &FunctionToBitcodeIndex);
   void writeBlockInfo();
   void writeModuleHash(size_t BlockStartPos);
 
@@ -3391,6 +3417,71 @@ void ModuleBitcodeWriter::writeFunction(
   Stream.ExitBlock();
 }
 
+/// Write all function blocks, encoding them on the threads of EncodeStrategy.
+/// Returns false, having written nothing, if they must be written serially.
+///
+/// A function block that starts at a 32-bit boundary is encoded the same
+/// wherever it starts: it only uses its own abbreviations and those from
+/// BLOCKINFO, its length is relative to its start, and it ends at a 32-bit
+/// boundary, where the next one starts. So each worker writes blocks for some
+/// of the functions to its own stream, which has the same BLOCKINFO and a copy
+/// of the value numbering, and each block is then copied to Stream in order.
+bool ModuleBitcodeWriter::writeFunctionsInParallel(
+    DenseMap<const Function *, uint64_t> &FunctionToBitcodeIndex) {
+  // Use-list orders are consumed in function order as blocks are written.
+  if (!EncodeStrategy || VE.shouldPreserveUseListOrder())
+    return false;
+  if (Stream.GetCurrentBitNo() % 32)
+    return false;
+
+  std::vector<const Function *> Functions;
+  for (const Function &F : M)
+    if (!F.isDeclaration())
+      Functions.push_back(&F);
+  unsigned NumWorkers = std::min<size_t>(EncodeStrategy->compute_thread_count(),
+                                         Functions.size());
+  if (NumWorkers < 2)
+    return false;
+
+  struct EncodedFunction {
+    unsigned Worker;
+    size_t Begin, End;
+  };
+  std::vector<EncodedFunction> Encoded(Functions.size());
+  std::vector<SmallVector<char, 0>> Buffers(NumWorkers);
+  std::atomic<size_t> NextFunction{0};
+
+  ThreadPool Pool(*EncodeStrategy);
+  for (unsigned I = 0; I != NumWorkers; ++I)
+    Pool.async([&, I] {
+      SmallVector<char, 0> &WorkerBuffer = Buffers[I];
+      BitstreamWriter WorkerStream(WorkerBuffer);
+      ModuleBitcodeWriter Worker(*this, WorkerBuffer, WorkerStream);
+      DenseMap<const Function *, uint64_t> WorkerIndex;
+
+      // Function blocks are nested in the module block, so their abbrev IDs
+      // have its width.
+      WorkerStream.EnterSubblock(bitc::MODULE_BLOCK_ID, 3);
+      Worker.writeBlockInfo();
+      for (size_t Idx = NextFunction++; Idx < Functions.size();
+           Idx = NextFunction++) {
+        size_t Begin = WorkerBuffer.size();
+        Worker.writeFunction(*Functions[Idx], WorkerIndex);
+        Encoded[Idx] = {I, Begin, WorkerBuffer.size()};
+      }
+      WorkerStream.ExitBlock();
+    });
+  Pool.wait();
+
+  for (size_t Idx = 0, E = Functions.size(); Idx != E; ++Idx) {
+    const EncodedFunction &EF = Encoded[Idx];
+    FunctionToBitcodeIndex[Functions[Idx]] = Stream.GetCurrentBitNo();
+    Stream.emitWords(
+        StringRef(Buffers[EF.Worker].data() + EF.Begin, EF.End - EF.Begin));
+  }
+  return true;
+}
+
 // Emit blockinfo, which defines the standard abbreviations etc.
 void ModuleBitcodeWriter::writeBlockInfo() {
   // We only want to emit block info records for blocks that have multiple
@@ -4432,9 +4523,10 @@ void ModuleBitcodeWriter::write() {
 
   // Emit function bodies.
   DenseMap<const Function *, uint64_t> FunctionToBitcodeIndex;
-  for (const Function &F : M)
-    if (!F.isDeclaration())
-      writeFunction(F, FunctionToBitcodeIndex);
+  if (!writeFunctionsInParallel(FunctionToBitcodeIndex))
+    for (const Function &F : M)
+      if (!F.isDeclaration())
+        writeFunction(F, FunctionToBitcodeIndex);
 
   // Need to write after the above call to WriteFunction which populates
   // the summary information in the index.
@@ -4611,6 +4703,8 @@ void BitcodeWriter::writeModule(const Module &M,
   ModuleBitcodeWriter ModuleWriter(M, Buffer, StrtabBuilder, *Stream,
                                    ShouldPreserveUseListOrder, Index,
                                    GenerateHash, ModHash);
+  if (EncodeStrategy)
+    ModuleWriter.setEncodeStrategy(*EncodeStrategy);
   ModuleWriter.write();
 }
 
@@ -502,6 +502,28 @@ ValueEnumerator::ValueEnumerator(const Module &M,
   organizeMetadata();
 }
 
+ValueEnumerator::ValueEnumerator(const ValueEnumerator &Other)
+    : TypeMap(Other.TypeMap), Types(Other.Types), ValueMap(Other.ValueMap),
+      Values(Other.Values), Comdats(Other.Comdats), MDs(Other.MDs),
+      FunctionMDs(Other.FunctionMDs), MetadataMap(Other.MetadataMap),
+      FunctionMDInfo(Other.FunctionMDInfo),
+      ShouldPreserveUseListOrder(Other.ShouldPreserveUseListOrder),
+      AttributeGroupMap(Other.AttributeGroupMap),
+      AttributeGroups(Other.AttributeGroups),
+      AttributeListMap(Other.AttributeListMap),
+      AttributeLists(Other.AttributeLists),
+      GlobalBasicBlockIDs(Other.GlobalBasicBlockIDs),
+      InstructionMap(Other.InstructionMap),
+      InstructionCount(Other.InstructionCount),
+      BasicBlocks(Other.BasicBlocks), NumModuleValues(Other.NumModuleValues),
+      NumModuleMDs(Other.NumModuleMDs), NumMDStrings(Other.NumMDStrings),
+      FirstFuncConstantID(Other.FirstFuncConstantID),
+      FirstInstID(Other.FirstInstID) {
+  // Use-list orders are consumed as functions are written, so they can't be
+  // shared between copies.
+  assert(Other.UseListOrders.empty() && "Can't copy use-list orders");
+}
+
 unsigned ValueEnumerator::getInstructionID(const Instruction *Inst) const {
   InstructionMapType::const_iterator I = InstructionMap.find(Inst);
   assert(I != InstructionMap.end() && "Instruction is not mapped!");
@@ -139,7 +139,10 @@ private:
 
 public:
   ValueEnumerator(const Module &M, bool ShouldPreserveUseListOrder);
-  ValueEnumerator(const ValueEnumerator &) = delete;
+  /// Copies the module-level numbering, so that functions can be incorporated
+  /// into the copy independently of the original. Both must not have use-list
+  /// orders to write.
+  ValueEnumerator(const ValueEnumerator &Other);
   ValueEnumerator &operator=(const ValueEnumerator &) = delete;
 
   void dump() const;
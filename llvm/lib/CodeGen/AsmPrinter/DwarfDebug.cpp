@@ -52,6 +52,7 @@
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/MD5.h"
 #include "llvm/Support/MathExtras.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Target/TargetLoweringObjectFile.h"
@@ -1264,6 +1265,7 @@ void DwarfDebug::finishSubprogramDefinitions() {
 }
 
 void DwarfDebug::finalizeModuleInfo() {
+  TimeTraceScope TimeScope("DwarfDebug::finalizeModuleInfo");
   const TargetLoweringObjectFile &TLOF = Asm->getObjFileLowering();
 
   finishSubprogramDefinitions();
@@ -1405,6 +1407,7 @@ void DwarfDebug::finalizeModuleInfo() {
 
 // Emit all Dwarf sections that should come after the content.
 void DwarfDebug::endModule() {
+  TimeTraceScope TimeScope("DwarfDebug::endModule");
   // Terminate the pending line table.
   if (PrevCU)
     terminateLineTable(PrevCU);
@@ -2196,6 +2199,7 @@ void DwarfDebug::skippedNonDebugFunction() {
 
 // Gather and emit post-function debug information.
 void DwarfDebug::endFunctionImpl(const MachineFunction *MF) {
+  TimeTraceScope TimeScope("DwarfDebug::endFunction", MF->getName());
   const DISubprogram *SP = MF->getFunction().getSubprogram();
 
   assert(CurFn == MF &&
@@ -2294,12 +2298,14 @@ void DwarfDebug::recordSourceLine(unsigned Line, unsigned Col, const MDNode *S,
 
 // Emit the debug info section.
 void DwarfDebug::emitDebugInfo() {
+  TimeTraceScope TimeScope("DwarfDebug::emitDebugInfo");
   DwarfFile &Holder = useSplitDwarf() ? SkeletonHolder : InfoHolder;
   Holder.emitUnits(/* UseOffsets */ false);
 }
 
 // Emit the abbreviation section.
 void DwarfDebug::emitAbbreviations() {
+  TimeTraceScope TimeScope("DwarfDebug::emitAbbreviations");
   DwarfFile &Holder = useSplitDwarf() ? SkeletonHolder : InfoHolder;
 
   Holder.emitAbbrevs(Asm->getObjFileLowering().getDwarfAbbrevSection());
@@ -2315,6 +2321,7 @@ void DwarfDebug::emitStringOffsetsTableHeader() {
 template <typename AccelTableT>
 void DwarfDebug::emitAccel(AccelTableT &Accel, MCSection *Section,
                            StringRef TableName) {
+  TimeTraceScope TimeScope("DwarfDebug::emitAccel", TableName);
   Asm->OutStreamer->SwitchSection(Section);
 
   // Emit the full data.
@@ -2322,6 +2329,7 @@ void DwarfDebug::emitAccel(AccelTableT &Accel, MCSection *Section,
 }
 
 void DwarfDebug::emitAccelDebugNames() {
+  TimeTraceScope TimeScope("DwarfDebug::emitAccelDebugNames");
   // Don't emit anything if we have no compilation units to index.
   if (getUnits().empty())
     return;
@@ -2426,6 +2434,7 @@ static dwarf::PubIndexEntryDescriptor computeIndexValue(DwarfUnit *CU,
 /// emitDebugPubSections - Emit visible names and types into debug pubnames and
 /// pubtypes sections.
 void DwarfDebug::emitDebugPubSections() {
+  TimeTraceScope TimeScope("DwarfDebug::emitDebugPubSections");
   for (const auto &NU : CUMap) {
     DwarfCompileUnit *TheU = NU.second;
     if (!TheU->hasDwarfPubSections())
@@ -2500,6 +2509,7 @@ void DwarfDebug::emitDebugPubSection(bool GnuStyle, StringRef Name,
 
 /// Emit null-terminated strings into a debug str section.
 void DwarfDebug::emitDebugStr() {
+  TimeTraceScope TimeScope("DwarfDebug::emitDebugStr");
   MCSection *StringOffsetsSection = nullptr;
   if (useSegmentedStringOffsetsTable()) {
     emitStringOffsetsTableHeader();
@@ -2864,6 +2874,7 @@ void DwarfDebug::emitDebugLocImpl(MCSection *Sec) {
 
 // Emit locations into the .debug_loc/.debug_loclists section.
 void DwarfDebug::emitDebugLoc() {
+  TimeTraceScope TimeScope("DwarfDebug::emitDebugLoc");
   emitDebugLocImpl(
       getDwarfVersion() >= 5
           ? Asm->getObjFileLowering().getDwarfLoclistsSection()
@@ -2872,6 +2883,7 @@ void DwarfDebug::emitDebugLoc() {
 
 // Emit locations into the .debug_loc.dwo/.debug_loclists.dwo section.
 void DwarfDebug::emitDebugLocDWO() {
+  TimeTraceScope TimeScope("DwarfDebug::emitDebugLocDWO");
   if (getDwarfVersion() >= 5) {
     emitDebugLocImpl(
         Asm->getObjFileLowering().getDwarfLoclistsDWOSection());
@@ -2912,6 +2924,7 @@ struct ArangeSpan {
 // Emit a debug aranges section, containing a CU lookup for any
 // address we can tie back to a CU.
 void DwarfDebug::emitDebugARanges() {
+  TimeTraceScope TimeScope("DwarfDebug::emitDebugARanges");
   // Provides a unique id per text section.
   MapVector<MCSection *, SmallVector<SymbolCU, 8>> SectionMap;
 
@@ -3103,6 +3116,7 @@ void DwarfDebug::emitDebugRangesImpl(const DwarfFile &Holder, MCSection *Section
 /// Emit address ranges into the .debug_ranges section or into the DWARF v5
 /// .debug_rnglists section.
 void DwarfDebug::emitDebugRanges() {
+  TimeTraceScope TimeScope("DwarfDebug::emitDebugRanges");
   const auto &Holder = useSplitDwarf() ? SkeletonHolder : InfoHolder;
 
   emitDebugRangesImpl(Holder,
@@ -3251,6 +3265,7 @@ void DwarfDebug::emitDebugMacinfoImpl(MCSection *Section) {
 
 /// Emit macros into a debug macinfo/macro section.
 void DwarfDebug::emitDebugMacinfo() {
+  TimeTraceScope TimeScope("DwarfDebug::emitDebugMacinfo");
   auto &ObjLower = Asm->getObjFileLowering();
   emitDebugMacinfoImpl(UseDebugMacroSection
                            ? ObjLower.getDwarfMacroSection()
@@ -3297,6 +3312,7 @@ DwarfCompileUnit &DwarfDebug::constructSkeletonCU(const DwarfCompileUnit &CU) {
 // Emit the .debug_info.dwo section for separated dwarf. This contains the
 // compile units that would normally be in debug_info.
 void DwarfDebug::emitDebugInfoDWO() {
+  TimeTraceScope TimeScope("DwarfDebug::emitDebugInfoDWO");
   assert(useSplitDwarf() && "No split dwarf debug info?");
   // Don't emit relocations into the dwo file.
   InfoHolder.emitUnits(/* UseOffsets */ true);
@@ -3337,6 +3353,7 @@ void DwarfDebug::emitDebugStrDWO() {
 
 // Emit address pool.
 void DwarfDebug::emitDebugAddr() {
+  TimeTraceScope TimeScope("DwarfDebug::emitDebugAddr");
   AddrPool.emit(*Asm, Asm->getObjFileLowering().getDwarfAddrSection());
 }
 
@@ -14,6 +14,7 @@
 #include "llvm/IR/DebugInfoMetadata.h"
 #include "llvm/IR/Metadata.h"
 #include "llvm/MC/MCStreamer.h"
+#include "llvm/Support/TimeProfiler.h"
 #include <algorithm>
 #include <cstdint>
 
@@ -57,6 +58,7 @@ void DwarfFile::emitUnit(DwarfUnit *TheU, bool UseOffsets) {
 
 // Compute the size and offset for each DIE.
 void DwarfFile::computeSizeAndOffsets() {
+  TimeTraceScope TimeScope("DwarfFile::computeSizeAndOffsets");
   // Offset from the first CU in the debug info section is 0 initially.
   uint64_t SecOffset = 0;
 
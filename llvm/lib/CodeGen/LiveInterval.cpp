@@ -541,6 +541,22 @@ void LiveRange::RenumberValues() {
   }
 }
 
+/// Reallocate V to its size if more than a quarter of its heap capacity is
+/// unused.
+template <typename VectorT> static void shrinkVectorToFit(VectorT &V) {
+  if (V.capacity() <= VectorT().capacity() ||
+      V.capacity() - V.size() <= V.size() / 4)
+    return;
+  VectorT Tmp(V.begin(), V.end());
+  V.swap(Tmp);
+}
+
+void LiveRange::shrinkToFit() {
+  assert(segmentSet == nullptr && "Cannot shrink a range using a segment set");
+  shrinkVectorToFit(segments);
+  shrinkVectorToFit(valnos);
+}
+
 void LiveRange::addSegmentToSet(Segment S) {
   CalcLiveRangeUtilSet(this).addSegment(S);
 }
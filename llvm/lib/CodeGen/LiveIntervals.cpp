@@ -207,9 +207,18 @@ void LiveIntervals::computeVirtRegs() {
       continue;
     LiveInterval &LI = createEmptyInterval(Reg);
     bool NeedSplit = computeVirtRegInterval(LI);
-    if (NeedSplit) {
-      SmallVector<LiveInterval*, 8> SplitLIs;
+    SmallVector<LiveInterval*, 8> SplitLIs;
+    if (NeedSplit)
       splitSeparateComponents(LI, SplitLIs);
+
+    // The intervals were built a segment at a time. On large functions they
+    // are the bulk of the memory CodeGen holds, so drop their spare capacity
+    // before they are kept alive for the rest of register allocation.
+    SplitLIs.push_back(&LI);
+    for (LiveInterval *SplitLI : SplitLIs) {
+      SplitLI->shrinkToFit();
+      for (LiveInterval::SubRange &SR : SplitLI->subranges())
+        SR.shrinkToFit();
     }
   }
 }
@@ -70,6 +70,7 @@
 #include "llvm/InitializePasses.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/SuffixArray.h"
 #include "llvm/Support/SuffixTree.h"
 #include "llvm/Support/raw_ostream.h"
 #include <functional>
@@ -103,6 +104,12 @@ static cl::opt<unsigned> OutlinerReruns(
     cl::desc(
         "Number of times to rerun the outliner after the initial outline"));
 
+static cl::opt<bool> OutlinerUseSuffixArray(
+    "machine-outliner-use-suffix-array", cl::init(false), cl::Hidden,
+    cl::desc("Find repeated instruction sequences with a suffix array, which "
+             "takes less memory than the suffix tree and is sorted in "
+             "parallel"));
+
 namespace {
 
 /// Maps \p MachineInstrs to unsigned integers and stores the mappings.
@@ -513,12 +520,9 @@ void MachineOutliner::emitOutlinedFunctionRemark(OutlinedFunction &OF) {
 void MachineOutliner::findCandidates(
     InstructionMapper &Mapper, std::vector<OutlinedFunction> &FunctionList) {
   FunctionList.clear();
-  SuffixTree ST(Mapper.UnsignedVec);
 
-  // First, find all of the repeated substrings in the tree of minimum length
-  // 2.
   std::vector<Candidate> CandidatesForRepeatedSeq;
-  for (const SuffixTree::RepeatedSubstring &RS : ST) {
+  auto AddRepeatedSubstring = [&](const SuffixTree::RepeatedSubstring &RS) {
     CandidatesForRepeatedSeq.clear();
     unsigned StringLen = RS.Length;
     for (const unsigned &StartIdx : RS.StartIndices) {
@@ -566,7 +570,7 @@ void MachineOutliner::findCandidates(
     // Create an OutlinedFunction to store it and check if it'd be beneficial
     // to outline.
     if (CandidatesForRepeatedSeq.size() < 2)
-      continue;
+      return;
 
     // Arbitrarily choose a TII from the first candidate.
     // FIXME: Should getOutliningCandidateInfo move to TargetMachine?
@@ -579,16 +583,27 @@ void MachineOutliner::findCandidates(
     // If we deleted too many candidates, then there's nothing worth outlining.
     // FIXME: This should take target-specified instruction sizes into account.
     if (OF.Candidates.size() < 2)
-      continue;
+      return;
 
     // Is it better to outline this candidate than not?
     if (OF.getBenefit() < 1) {
       emitNotOutliningCheaperRemark(StringLen, CandidatesForRepeatedSeq, OF);
-      continue;
+      return;
     }
 
     FunctionList.push_back(OF);
+  };
+
+  // Find all of the repeated substrings of minimum length 2 in the mapping.
+  if (OutlinerUseSuffixArray) {
+    SuffixArray SA(Mapper.UnsignedVec);
+    for (const SuffixTree::RepeatedSubstring &RS : SA)
+      AddRepeatedSubstring(RS);
+    return;
   }
+  SuffixTree ST(Mapper.UnsignedVec);
+  for (const SuffixTree::RepeatedSubstring &RS : ST)
+    AddRepeatedSubstring(RS);
 }
 
 MachineFunction *MachineOutliner::createOutlinedFunction(
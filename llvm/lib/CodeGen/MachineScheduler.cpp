@@ -75,6 +75,7 @@ using namespace llvm;
 #define DEBUG_TYPE "machine-scheduler"
 
 STATISTIC(NumClustered, "Number of load/store pairs clustered");
+STATISTIC(NumWindowedRegions, "Number of huge regions scheduled in windows");
 
 namespace llvm {
 
@@ -143,6 +144,18 @@ static cl::opt<unsigned>
                          cl::desc("The threshold for fast cluster"),
                          cl::init(1000));
 
+/// Avoid quadratic complexity in building and scheduling the DAG of unusually
+/// large regions by scheduling them in windows.
+static cl::opt<unsigned> WindowThreshold(
+    "misched-window-threshold", cl::Hidden,
+    cl::desc("Schedule regions of more than N instructions in windows "
+             "(0 = never)"),
+    cl::init(8192));
+static cl::opt<unsigned>
+    WindowSize("misched-window-size", cl::Hidden,
+               cl::desc("Number of instructions in a scheduling window"),
+               cl::init(1024));
+
 // DAG subtrees must have at least this many nodes.
 static const unsigned MinSubtreeSize = 8;
 
@@ -487,6 +500,32 @@ struct SchedRegion {
 
 using MBBRegionsVector = SmallVector<SchedRegion, 16>;
 
+/// Add the region [RegionBegin, RegionEnd) to Regions in windows of at most
+/// WindowSize instructions, bottom-up. The instruction between two windows
+/// stays in place, like a scheduling boundary, so that scheduling one window
+/// does not move the end of the next.
+static void addWindowedRegion(MachineBasicBlock::iterator RegionBegin,
+                              MachineBasicBlock::iterator RegionEnd,
+                              MBBRegionsVector &Regions) {
+  ++NumWindowedRegions;
+  unsigned NumWindowInstrs = 0;
+  MachineBasicBlock::iterator WindowEnd = RegionEnd;
+  for (MachineBasicBlock::iterator I = RegionEnd; I != RegionBegin;) {
+    --I;
+    if (I->isDebugOrPseudoInstr())
+      continue;
+    if (NumWindowInstrs < WindowSize) {
+      ++NumWindowInstrs;
+      continue;
+    }
+    Regions.push_back(SchedRegion(std::next(I), WindowEnd, NumWindowInstrs));
+    WindowEnd = I;
+    NumWindowInstrs = 0;
+  }
+  if (NumWindowInstrs != 0)
+    Regions.push_back(SchedRegion(RegionBegin, WindowEnd, NumWindowInstrs));
+}
+
 static void
 getSchedRegions(MachineBasicBlock *MBB,
                 MBBRegionsVector &Regions,
@@ -521,7 +560,11 @@ getSchedRegions(MachineBasicBlock *MBB,
 
     // It's possible we found a scheduling region that only has debug
     // instructions. Don't bother scheduling these.
-    if (NumRegionInstrs != 0)
+    if (NumRegionInstrs == 0)
+      continue;
+    if (WindowThreshold && WindowSize && NumRegionInstrs > WindowThreshold)
+      addWindowedRegion(I, RegionEnd, Regions);
+    else
       Regions.push_back(SchedRegion(I, RegionEnd, NumRegionInstrs));
   }
 
@@ -87,6 +87,8 @@ using namespace llvm;
 STATISTIC(NumGlobalSplits, "Number of split global live ranges");
 STATISTIC(NumLocalSplits,  "Number of split local live ranges");
 STATISTIC(NumEvicted,      "Number of interferences evicted");
+STATISTIC(NumSplitBudgetExhausted,
+          "Number of functions that exhausted the region splitting budget");
 
 static cl::opt<SplitEditor::ComplementSpillMode> SplitSpillMode(
     "split-spill-mode", cl::Hidden,
@@ -133,6 +135,13 @@ static cl::opt<bool> ConsiderLocalIntervalCost(
              "candidate when choosing the best split candidate."),
     cl::init(false));
 
+static cl::opt<uint64_t> SplitBudget(
+    "regalloc-split-budget", cl::Hidden,
+    cl::desc("Maximum amount of region splitting work per function, in live "
+             "blocks visited per split candidate, before the allocator falls "
+             "back to per-block splitting (0 = unlimited)"),
+    cl::init(20000000));
+
 static RegisterRegAlloc greedyRegAlloc("greedy", "greedy register allocator",
                                        createGreedyRegisterAllocator);
 
@@ -1480,6 +1489,9 @@ unsigned RAGreedy::calculateRegionSplitCost(LiveInterval &VirtReg,
   unsigned BestCand = NoCand;
   for (MCPhysReg PhysReg : Order) {
     assert(PhysReg);
+    // Keep the best candidate found so far once the budget runs out.
+    if (chargeSplitBudget(SA->getNumLiveBlocks()))
+      break;
     if (IgnoreCSR && EvictAdvisor->isUnusedCalleeSavedReg(PhysReg))
       continue;
 
@@ -2079,8 +2091,9 @@ unsigned RAGreedy::trySplit(LiveInterval &VirtReg, AllocationOrder &Order,
 
   // First try to split around a region spanning multiple blocks. RS_Split2
   // ranges already made dubious progress with region splitting, so they go
-  // straight to single block splitting.
-  if (ExtraInfo->getStage(VirtReg) < RS_Split2) {
+  // straight to single block splitting, as do all ranges once the function
+  // is out of splitting budget.
+  if (ExtraInfo->getStage(VirtReg) < RS_Split2 && !SplitBudgetExhausted) {
     MCRegister PhysReg = tryRegionSplit(VirtReg, Order, NewVRegs);
     if (PhysReg || !NewVRegs.empty())
       return PhysReg;
@@ -2090,6 +2103,29 @@ unsigned RAGreedy::trySplit(LiveInterval &VirtReg, AllocationOrder &Order,
   return tryBlockSplit(VirtReg, Order, NewVRegs);
 }
 
+bool RAGreedy::chargeSplitBudget(uint64_t Units) {
+  if (SplitBudgetExhausted)
+    return true;
+  SplitBudgetUsed += Units;
+  if (!SplitBudget || SplitBudgetUsed <= SplitBudget)
+    return false;
+
+  SplitBudgetExhausted = true;
+  ++NumSplitBudgetExhausted;
+  LLVM_DEBUG(dbgs() << "Region splitting budget exhausted in "
+                    << MF->getName() << '\n');
+  ORE->emit([&]() {
+    DebugLoc Loc;
+    if (auto *SP = MF->getFunction().getSubprogram())
+      Loc = DILocation::get(SP->getContext(), SP->getLine(), 1, SP);
+    return MachineOptimizationRemarkMissed(DEBUG_TYPE, "SplitBudget", Loc,
+                                           &MF->front())
+           << "region splitting budget exhausted; falling back to per-block "
+              "splitting";
+  });
+  return true;
+}
+
 //===----------------------------------------------------------------------===//
 //                          Last Chance Recoloring
 //===----------------------------------------------------------------------===//
@@ -2938,6 +2974,8 @@ bool RAGreedy::runOnMachineFunction(MachineFunction &mf) {
   GlobalCand.resize(32);  // This will grow as needed.
   SetOfBrokenHints.clear();
   LastEvicted.clear();
+  SplitBudgetUsed = 0;
+  SplitBudgetExhausted = false;
 
   allocatePhysRegs();
   tryHintsRecoloring();
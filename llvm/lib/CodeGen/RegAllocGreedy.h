@@ -324,6 +324,15 @@ private:
   /// by a split candidate when choosing the best split candidate.
   bool EnableAdvancedRASplitCost;
 
+  /// Work done by region splitting in the current function, counted in live
+  /// blocks visited per split candidate.
+  uint64_t SplitBudgetUsed = 0;
+
+  /// True once SplitBudgetUsed went over -regalloc-split-budget. From then
+  /// on, global live ranges are not region split and go straight to the
+  /// cheaper per-block splitting.
+  bool SplitBudgetExhausted = false;
+
   /// Set of broken hints that may be reconciled later because of eviction.
   SmallSetVector<LiveInterval *, 8> SetOfBrokenHints;
 
@@ -502,6 +511,10 @@ private:
 
   /// Report the statistic for each loop.
   void reportStats();
+
+  /// Charge Units of work to the region splitting budget of the current
+  /// function. Returns true if the budget is exhausted.
+  bool chargeSplitBudget(uint64_t Units);
 };
 } // namespace llvm
 #endif // #ifndef LLVM_CODEGEN_REGALLOCGREEDY_H_
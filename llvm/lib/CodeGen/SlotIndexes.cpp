@@ -75,7 +75,22 @@ bool SlotIndexes::runOnMachineFunction(MachineFunction &fn) {
   MBBRanges.resize(mf->getNumBlockIDs());
   idx2MBBMap.reserve(mf->size());
 
-  indexList.push_back(createEntry(nullptr, index));
+  // Size the map and allocate the entries of the initial numbering as a
+  // single array up front. On large functions this avoids growing the map
+  // by rehashing, and keeps the entries in the order the list visits them.
+  unsigned NumInstrs = 0;
+  for (MachineBasicBlock &MBB : *mf)
+    for (MachineInstr &MI : MBB)
+      if (!MI.isDebugOrPseudoInstr())
+        ++NumInstrs;
+  mi2iMap.reserve(NumInstrs);
+  IndexListEntry *NextEntry =
+      ileAllocator.Allocate<IndexListEntry>(NumInstrs + mf->size() + 1);
+  auto createInitialEntry = [&](MachineInstr *MI, unsigned Index) {
+    return new (NextEntry++) IndexListEntry(MI, Index);
+  };
+
+  indexList.push_back(createInitialEntry(nullptr, index));
 
   // Iterate over the function.
   for (MachineBasicBlock &MBB : *mf) {
@@ -87,7 +102,8 @@ bool SlotIndexes::runOnMachineFunction(MachineFunction &fn) {
         continue;
 
       // Insert a store index for the instr.
-      indexList.push_back(createEntry(&MI, index += SlotIndex::InstrDist));
+      indexList.push_back(
+          createInitialEntry(&MI, index += SlotIndex::InstrDist));
 
       // Save this base index in the maps.
       mi2iMap.insert(std::make_pair(
@@ -95,7 +111,8 @@ bool SlotIndexes::runOnMachineFunction(MachineFunction &fn) {
     }
 
     // We insert one blank instructions between basic blocks.
-    indexList.push_back(createEntry(nullptr, index += SlotIndex::InstrDist));
+    indexList.push_back(
+        createInitialEntry(nullptr, index += SlotIndex::InstrDist));
 
     MBBRanges[MBB.getNumber()].first = blockStartIndex;
     MBBRanges[MBB.getNumber()].second = SlotIndex(&indexList.back(),
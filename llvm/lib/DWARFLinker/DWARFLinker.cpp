@@ -30,6 +30,8 @@
 #include "llvm/Support/LEB128.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/ThreadPool.h"
+#include <future>
+#include <memory>
 #include <vector>
 
 namespace llvm {
@@ -2540,8 +2542,42 @@ bool DWARFLinker::link() {
     }
   };
 
+  // Extracting the DIEs of an object file does not depend on any other object
+  // file. When more threads are available than the two running analyze and
+  // clone, the others extract the DIEs of the next few object files ahead of
+  // the analysis, which then finds them already parsed.
+  std::unique_ptr<ThreadPool> LoadPool;
+  unsigned NumThreads = Options.Threads == 0
+                            ? hardware_concurrency().compute_thread_count()
+                            : Options.Threads;
+  if (NumThreads > 2)
+    LoadPool =
+        std::make_unique<ThreadPool>(hardware_concurrency(NumThreads - 2));
+  std::vector<std::shared_future<void>> Loaded(NumObjects);
+  unsigned NumScheduledLoads = 0;
+  auto LoadAhead = [&](size_t I) {
+    if (!LoadPool)
+      return;
+    // Only keep a few object files per thread in flight, as the extracted
+    // DIEs stay in memory until the object file is cloned.
+    size_t Window = 2 * LoadPool->getThreadCount();
+    for (; NumScheduledLoads < NumObjects && NumScheduledLoads <= I + Window;
+         ++NumScheduledLoads) {
+      auto &Context = ObjectContexts[NumScheduledLoads];
+      if (Context.Skip || !Context.File.Dwarf)
+        continue;
+      Loaded[NumScheduledLoads] = LoadPool->async([&Context]() {
+        for (const auto &CU : Context.File.Dwarf->compile_units())
+          CU->getUnitDIE(/*ExtractUnitDIEOnly=*/false);
+      });
+    }
+    if (Loaded[I].valid())
+      Loaded[I].wait();
+  };
+
   auto AnalyzeAll = [&]() {
     for (unsigned I = 0, E = NumObjects; I != E; ++I) {
+      LoadAhead(I);
       AnalyzeLambda(I);
 
       std::unique_lock<std::mutex> LockGuard(ProcessedFilesMutex);
@@ -565,18 +565,16 @@ Error write(MCStreamer &Out, ArrayRef<std::string> Inputs) {
 
   DWPStringPool Strings(Out, StrSection);
 
-  SmallVector<OwningBinary<object::ObjectFile>, 128> Objects;
-  Objects.reserve(Inputs.size());
-
-  std::deque<SmallString<32>> UncompressedSections;
-
+  // Everything taken from an input is copied into the output, the string
+  // pool or the index entries, so each input and its decompressed sections
+  // are released before the next one is read.
   for (const auto &Input : Inputs) {
     auto ErrOrObj = object::ObjectFile::createObjectFile(Input);
     if (!ErrOrObj)
       return ErrOrObj.takeError();
 
     auto &Obj = *ErrOrObj->getBinary();
-    Objects.push_back(std::move(*ErrOrObj));
+    std::deque<SmallString<32>> UncompressedSections;
 
     UnitIndexEntry CurEntry = {};
 
@@ -1049,10 +1049,22 @@ DWARFContext::DIEsForAddress DWARFContext::getDIEsForAddress(uint64_t Address) {
     if (!DIE.isValid())
       continue;
 
-    if (DIE.getTag() == DW_TAG_lexical_block &&
-        DIE.addressRangeContainsAddress(Address)) {
-      Result.BlockDIE = DIE;
-      break;
+    if (DIE.getTag() == DW_TAG_lexical_block ||
+        DIE.getTag() == DW_TAG_inlined_subroutine) {
+      if (DIE.addressRangeContainsAddress(Address)) {
+        if (DIE.getTag() == DW_TAG_lexical_block) {
+          Result.BlockDIE = DIE;
+          break;
+        }
+      } else {
+        // The scopes nested in this one lie within its ranges, so if it has
+        // any, none of its children can contain the address either.
+        Expected<DWARFAddressRangesVector> Ranges = DIE.getAddressRanges();
+        if (Ranges && !Ranges->empty())
+          continue;
+        if (!Ranges)
+          consumeError(Ranges.takeError());
+      }
     }
 
     append_range(Worklist, DIE);
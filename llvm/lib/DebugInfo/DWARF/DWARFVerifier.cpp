@@ -334,6 +334,9 @@ unsigned DWARFVerifier::verifyUnits(const DWARFUnitVector &Units) {
         verifyUnitContents(*Unit, UnitLocalReferences, CrossUnitReferences);
     NumDebugInfoErrors += verifyDebugInfoReferences(
         UnitLocalReferences, [&](uint64_t Offset) { return Unit.get(); });
+    // The checks that follow mostly need the unit DIE alone, and parse the
+    // unit again when they need more, so do not keep every unit in memory.
+    Unit->clearDIEs(/*KeepCUDie=*/true);
     ++Index;
   }
 
@@ -1524,6 +1527,7 @@ unsigned DWARFVerifier::verifyDebugNames(const DWARFSection &AccelSection,
       auto *CU = cast<DWARFCompileUnit>(U.get());
       for (const DWARFDebugInfoEntry &Die : CU->dies())
         NumErrors += verifyNameIndexCompleteness(DWARFDie(CU, &Die), *NI);
+      CU->clearDIEs(/*KeepCUDie=*/true);
     }
   }
   return NumErrors;
@@ -30,6 +30,9 @@ struct llvm::gsym::CUInfo {
   std::vector<uint32_t> FileCache;
   uint64_t Language = 0;
   uint8_t AddrSize = 0;
+  /// The function infos made from this compile unit, added to the GsymCreator
+  /// in one batch once the whole unit is converted.
+  std::vector<FunctionInfo> FuncInfos;
 
   CUInfo(DWARFContext &DICtx, DWARFCompileUnit *CU) {
     LineTable = DICtx.getLineTableForUnit(CU);
@@ -415,7 +418,7 @@ void DwarfTransformer::handleDie(raw_ostream &OS, CUInfo &CUI, DWARFDie Die) {
         FI.Inline->Ranges.insert(FI.Range);
         parseInlineInfo(Gsym, CUI, Die, 0, FI, *FI.Inline);
       }
-      Gsym.addFunctionInfo(std::move(FI));
+      CUI.FuncInfos.push_back(std::move(FI));
     }
   } break;
   default:
@@ -434,6 +437,7 @@ Error DwarfTransformer::convert(uint32_t NumThreads) {
       DWARFDie Die = CU->getUnitDIE(false);
       CUInfo CUI(DICtx, dyn_cast<DWARFCompileUnit>(CU.get()));
       handleDie(Log, CUI, Die);
+      Gsym.addFunctionInfos(std::move(CUI.FuncInfos));
     }
   } else {
     // LLVM Dwarf parser is not thread-safe and we need to parse all DWARF up
@@ -463,6 +467,7 @@ Error DwarfTransformer::convert(uint32_t NumThreads) {
           std::string ThreadLogStorage;
           raw_string_ostream ThreadOS(ThreadLogStorage);
           handleDie(ThreadOS, CUI, Die);
+          Gsym.addFunctionInfos(std::move(CUI.FuncInfos));
           ThreadOS.flush();
           if (!ThreadLogStorage.empty()) {
             // Print ThreadLogStorage lines into an actual stream under a lock
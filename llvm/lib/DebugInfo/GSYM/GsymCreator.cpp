@@ -10,11 +10,13 @@
 #include "llvm/DebugInfo/GSYM/Header.h"
 #include "llvm/DebugInfo/GSYM/LineTable.h"
 #include "llvm/MC/StringTableBuilder.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 
 #include <algorithm>
 #include <cassert>
 #include <functional>
+#include <iterator>
 #include <vector>
 
 using namespace llvm;
@@ -195,7 +197,7 @@ llvm::Error GsymCreator::finalize(llvm::raw_ostream &OS) {
   Finalized = true;
 
   // Sort function infos so we can emit sorted functions.
-  llvm::sort(Funcs);
+  parallelSort(Funcs.begin(), Funcs.end());
 
   // Don't let the string table indexes change by finalizing in order.
   StrTab.finalizeInOrder();
@@ -327,6 +329,15 @@ void GsymCreator::addFunctionInfo(FunctionInfo &&FI) {
   Funcs.emplace_back(std::move(FI));
 }
 
+void GsymCreator::addFunctionInfos(std::vector<FunctionInfo> &&FIs) {
+  std::lock_guard<std::mutex> Guard(Mutex);
+  for (const FunctionInfo &FI : FIs)
+    Ranges.insert(FI.Range);
+  Funcs.insert(Funcs.end(), std::make_move_iterator(FIs.begin()),
+               std::make_move_iterator(FIs.end()));
+  FIs.clear();
+}
+
 void GsymCreator::forEachFunctionInfo(
     std::function<bool(FunctionInfo &)> const &Callback) {
   std::lock_guard<std::mutex> Guard(Mutex);
@@ -200,11 +200,62 @@ LLVMSymbolizer::symbolizeFrame(const std::string &ModuleName,
 
 void LLVMSymbolizer::flush() {
   ObjectForUBPathAndArch.clear();
+  LRUBinaries.clear();
+  CacheSize = 0;
   BinaryForPath.clear();
   ObjectPairForPathArch.clear();
   Modules.clear();
 }
 
+void LLVMSymbolizer::pruneCache() {
+  while (CacheSize > Opts.MaxCacheSize && !LRUBinaries.empty() &&
+         std::next(LRUBinaries.begin()) != LRUBinaries.end()) {
+    CachedBinary &Bin = LRUBinaries.front();
+    CacheSize -= Bin.size();
+    LRUBinaries.pop_front();
+    Bin.evict();
+  }
+}
+
+void LLVMSymbolizer::recordAccess(CachedBinary &Bin) {
+  if (Bin->getBinary() == nullptr)
+    return;
+  LRUBinaries.remove(Bin);
+  LRUBinaries.push_back(Bin);
+}
+
+void LLVMSymbolizer::recordAccess(const ObjectPair &Objects) {
+  for (const ObjectFile *Obj : {Objects.first, Objects.second}) {
+    if (!Obj)
+      continue;
+    auto I = BinaryForPath.find(Obj->getFileName().str());
+    if (I != BinaryForPath.end())
+      recordAccess(I->second);
+  }
+}
+
+void LLVMSymbolizer::pushEvictor(const ObjectPair &Objects,
+                                 std::function<void()> Evictor) {
+  auto I = BinaryForPath.find(Objects.first->getFileName().str());
+  auto J = BinaryForPath.find(Objects.second->getFileName().str());
+  if (I != BinaryForPath.end())
+    I->second.pushEvictor(Evictor);
+  if (J != BinaryForPath.end() && J != I)
+    J->second.pushEvictor(std::move(Evictor));
+}
+
+void CachedBinary::pushEvictor(std::function<void()> NewEvictor) {
+  if (!Evictor) {
+    Evictor = std::move(NewEvictor);
+    return;
+  }
+  Evictor = [OldEvictor = std::move(Evictor),
+             NewEvictor = std::move(NewEvictor)]() {
+    NewEvictor();
+    OldEvictor();
+  };
+}
+
 namespace {
 
 // For Path="/path/to/foo" and Basename="foo" assume that debug info is in
@@ -495,7 +546,9 @@ LLVMSymbolizer::getOrCreateObjectPair(const std::string &Path,
   if (!DbgObj)
     DbgObj = Obj;
   ObjectPair Res = std::make_pair(Obj, DbgObj);
-  ObjectPairForPathArch.emplace(std::make_pair(Path, ArchName), Res);
+  auto Key = std::make_pair(Path, ArchName);
+  ObjectPairForPathArch.emplace(Key, Res);
+  pushEvictor(Res, [this, Key]() { ObjectPairForPathArch.erase(Key); });
   return Res;
 }
 
@@ -505,13 +558,18 @@ LLVMSymbolizer::getOrCreateObject(const std::string &Path,
   Binary *Bin;
   auto Pair = BinaryForPath.emplace(Path, OwningBinary<Binary>());
   if (!Pair.second) {
-    Bin = Pair.first->second.getBinary();
+    Bin = Pair.first->second->getBinary();
+    recordAccess(Pair.first->second);
   } else {
     Expected<OwningBinary<Binary>> BinOrErr = createBinary(Path);
     if (!BinOrErr)
       return BinOrErr.takeError();
-    Pair.first->second = std::move(BinOrErr.get());
-    Bin = Pair.first->second.getBinary();
+    CachedBinary &CachedBin = Pair.first->second;
+    *CachedBin = std::move(BinOrErr.get());
+    CachedBin.pushEvictor([this, I = Pair.first]() { BinaryForPath.erase(I); });
+    LRUBinaries.push_back(CachedBin);
+    CacheSize += CachedBin.size();
+    Bin = CachedBin->getBinary();
   }
 
   if (!Bin)
@@ -530,8 +588,10 @@ LLVMSymbolizer::getOrCreateObject(const std::string &Path,
       return ObjOrErr.takeError();
     }
     ObjectFile *Res = ObjOrErr->get();
-    ObjectForUBPathAndArch.emplace(std::make_pair(Path, ArchName),
-                                   std::move(ObjOrErr.get()));
+    auto Key = std::make_pair(Path, ArchName);
+    ObjectForUBPathAndArch.emplace(Key, std::move(ObjOrErr.get()));
+    Pair.first->second.pushEvictor(
+        [this, Key]() { ObjectForUBPathAndArch.erase(Key); });
     return Res;
   }
   if (Bin->isObject()) {
@@ -559,10 +619,6 @@ LLVMSymbolizer::createModuleInfo(const ObjectFile *Obj,
 
 Expected<SymbolizableModule *>
 LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
-  auto I = Modules.find(ModuleName);
-  if (I != Modules.end())
-    return I->second.get();
-
   std::string BinaryName = ModuleName;
   std::string ArchName = Opts.DefaultArch;
   size_t ColonPos = ModuleName.find_last_of(':');
@@ -574,6 +630,16 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
       ArchName = ArchStr;
     }
   }
+
+  auto I = Modules.find(ModuleName);
+  if (I != Modules.end()) {
+    auto Objects =
+        ObjectPairForPathArch.find(std::make_pair(BinaryName, ArchName));
+    if (Objects != ObjectPairForPathArch.end())
+      recordAccess(Objects->second);
+    return I->second.get();
+  }
+
   auto ObjectsOrErr = getOrCreateObjectPair(BinaryName, ArchName);
   if (!ObjectsOrErr) {
     // Failed to find valid object file.
@@ -608,7 +674,11 @@ LLVMSymbolizer::getOrCreateModuleInfo(const std::string &ModuleName) {
     Context = DWARFContext::create(
         *Objects.second, DWARFContext::ProcessDebugRelocations::Process,
         nullptr, Opts.DWPName);
-  return createModuleInfo(Objects.first, std::move(Context), ModuleName);
+  auto ModuleOrErr =
+      createModuleInfo(Objects.first, std::move(Context), ModuleName);
+  if (ModuleOrErr)
+    pushEvictor(Objects, [this, ModuleName]() { Modules.erase(ModuleName); });
+  return ModuleOrErr;
 }
 
 Expected<SymbolizableModule *>
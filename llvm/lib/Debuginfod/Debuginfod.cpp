@@ -23,6 +23,7 @@
 #include "llvm/Support/Caching.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileUtilities.h"
+#include "llvm/Support/LockFileManager.h"
 #include "llvm/Support/xxhash.h"
 
 namespace llvm {
@@ -134,6 +135,24 @@ Expected<std::string> getCachedOrDownloadArtifact(
   AddStreamFn &CacheAddStream = *CacheAddStreamOrErr;
   if (!CacheAddStream)
     return std::string(AbsCachedArtifactPath);
+
+  // Another process sharing the cache may be downloading the same artifact.
+  // Wait for it to finish and look the artifact up again, rather than
+  // downloading it twice. If the lock cannot be taken, or the other process
+  // gave up, download the artifact without coordinating.
+  SmallString<64> LockPath;
+  sys::path::append(LockPath, CacheDirectoryPath, "debuginfod-" + UniqueKey);
+  LockFileManager Locker(LockPath);
+  if (Locker == LockFileManager::LFS_Shared) {
+    auto Seconds = std::chrono::duration_cast<std::chrono::seconds>(Timeout);
+    Locker.waitForUnlock(std::max<unsigned>(1, Seconds.count()));
+    CacheAddStreamOrErr = Cache(Task, UniqueKey);
+    if (!CacheAddStreamOrErr)
+      return CacheAddStreamOrErr.takeError();
+    if (!CacheAddStream)
+      return std::string(AbsCachedArtifactPath);
+  }
+
   // The artifact was not found in the local cache, query the debuginfod
   // servers.
   if (!HTTPClient::isAvailable())
@@ -174,6 +193,14 @@ Expected<std::string> getCachedOrDownloadArtifact(
 
     *FileStream->OS << StringRef(Response.Body->getBufferStart(),
                                  Response.Body->getBufferSize());
+    // Commit the artifact to the cache before pruning it.
+    FileStream.reset();
+
+    Expected<CachePruningPolicy> PruningPolicyOrErr =
+        parseCachePruningPolicy(std::getenv("DEBUGINFOD_CACHE_POLICY"));
+    if (!PruningPolicyOrErr)
+      return PruningPolicyOrErr.takeError();
+    pruneCache(CacheDirectoryPath, *PruningPolicyOrErr);
 
     // Return the path to the artifact on disk.
     return std::string(AbsCachedArtifactPath);
@@ -15,6 +15,7 @@
 
 #include "llvm/ADT/DenseSet.h"
 #include "llvm/ExecutionEngine/JITLink/JITLink.h"
+#include "llvm/Support/Parallel.h"
 
 #define DEBUG_TYPE "jitlink"
 
@@ -123,23 +124,49 @@ private:
   Error fixUpBlocks(LinkGraph &G) const override {
     LLVM_DEBUG(dbgs() << "Fixing up blocks:\n");
 
+    // Fixups only write to the working memory of the block they belong to and
+    // only read the (final) addresses of their targets, so blocks can be fixed
+    // up independently. Do that in parallel for graphs with enough relocations
+    // to outweigh the cost of dispatching work.
+    constexpr size_t ParallelFixupThreshold = 1 << 14;
+    std::vector<Block *> Blocks;
+    size_t NumEdges = 0;
     for (auto *B : G.blocks()) {
-      LLVM_DEBUG(dbgs() << "  " << *B << ":\n");
-
-      // Copy Block data and apply fixups.
-      LLVM_DEBUG(dbgs() << "    Applying fixups.\n");
-      assert((!B->isZeroFill() || B->edges_size() == 0) &&
-             "Edges in zero-fill block?");
-      for (auto &E : B->edges()) {
-
-        // Skip non-relocation edges.
-        if (!E.isRelocation())
-          continue;
-
-        // Dispatch to LinkerImpl for fixup.
-        if (auto Err = impl().applyFixup(G, *B, E))
-          return Err;
-      }
+      Blocks.push_back(B);
+      NumEdges += B->edges_size();
+    }
+
+    bool FixUpInParallel = NumEdges >= ParallelFixupThreshold;
+    // Keep the debug output of fixups in order.
+    LLVM_DEBUG(FixUpInParallel = false);
+
+    if (FixUpInParallel)
+      return parallelForEachError(
+          Blocks, [&](Block *B) { return fixUpBlock(G, *B); });
+
+    for (auto *B : Blocks)
+      if (auto Err = fixUpBlock(G, *B))
+        return Err;
+
+    return Error::success();
+  }
+
+  Error fixUpBlock(LinkGraph &G, Block &B) const {
+    LLVM_DEBUG(dbgs() << "  " << B << ":\n");
+
+    // Copy Block data and apply fixups.
+    LLVM_DEBUG(dbgs() << "    Applying fixups.\n");
+    assert((!B.isZeroFill() || B.edges_size() == 0) &&
+           "Edges in zero-fill block?");
+    for (auto &E : B.edges()) {
+
+      // Skip non-relocation edges.
+      if (!E.isRelocation())
+        continue;
+
+      // Dispatch to LinkerImpl for fixup.
+      if (auto Err = impl().applyFixup(G, B, E))
+        return Err;
     }
 
     return Error::success();
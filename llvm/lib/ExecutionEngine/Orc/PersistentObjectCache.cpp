@@ -0,0 +1,112 @@
+//===----- PersistentObjectCache.cpp - On-disk object cache for ORC -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/PersistentObjectCache.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/raw_ostream.h"
+
+#define DEBUG_TYPE "orc"
+
+namespace llvm {
+namespace orc {
+
+std::string PersistentObjectCache::getKey(const Module &M) const {
+  SmallString<0> Bitcode;
+  {
+    raw_svector_ostream OS(Bitcode);
+    WriteBitcodeToFile(M, OS);
+  }
+
+  SHA1 Hasher;
+  Hasher.update(KeyPrefix);
+  Hasher.update(StringRef("\0", 1));
+  Hasher.update(M.getTargetTriple());
+  Hasher.update(StringRef("\0", 1));
+  Hasher.update(M.getDataLayoutStr());
+  Hasher.update(StringRef("\0", 1));
+  Hasher.update(Bitcode);
+  return toHex(Hasher.final(), /*LowerCase=*/true);
+}
+
+std::string PersistentObjectCache::getCachePath(StringRef Key) const {
+  SmallString<128> Path(CacheDir);
+  sys::path::append(Path, Key + ".o");
+  return std::string(Path);
+}
+
+std::unique_ptr<MemoryBuffer>
+PersistentObjectCache::getObject(const Module *M) {
+  std::string Key = getKey(*M);
+  auto Buffer =
+      MemoryBuffer::getFile(getCachePath(Key), /*IsText=*/false,
+                            /*RequiresNullTerminator=*/false);
+  if (Buffer) {
+    LLVM_DEBUG(dbgs() << "Object cache hit for " << M->getModuleIdentifier()
+                      << " (" << Key << ")\n");
+    return std::move(*Buffer);
+  }
+
+  LLVM_DEBUG(dbgs() << "Object cache miss for " << M->getModuleIdentifier()
+                    << " (" << Key << ")\n");
+  std::lock_guard<std::mutex> Lock(PendingKeysMutex);
+  PendingKeys[M] = std::move(Key);
+  return nullptr;
+}
+
+void PersistentObjectCache::notifyObjectCompiled(const Module *M,
+                                                 MemoryBufferRef Obj) {
+  std::string Key;
+  {
+    std::lock_guard<std::mutex> Lock(PendingKeysMutex);
+    auto I = PendingKeys.find(M);
+    if (I != PendingKeys.end()) {
+      Key = std::move(I->second);
+      PendingKeys.erase(I);
+    }
+  }
+  if (Key.empty())
+    Key = getKey(*M);
+
+  if (sys::fs::create_directories(CacheDir))
+    return;
+
+  // Write to a temporary file and rename it into place so that concurrent
+  // readers never observe a partially written object.
+  const std::string Path = getCachePath(Key);
+  int FD;
+  SmallString<128> TempPath;
+  if (sys::fs::createUniqueFile(Path + ".tmp-%%%%%%", FD, TempPath))
+    return;
+
+  bool WriteFailed;
+  {
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    OS << Obj.getBuffer();
+    OS.close();
+    WriteFailed = OS.has_error();
+    OS.clear_error();
+  }
+
+  if (WriteFailed || sys::fs::rename(TempPath, Path)) {
+    sys::fs::remove(TempPath);
+    return;
+  }
+
+  LLVM_DEBUG(dbgs() << "Object cache stored " << M->getModuleIdentifier()
+                    << " (" << Key << ")\n");
+}
+
+} // end namespace orc
+} // end namespace llvm
@@ -0,0 +1,282 @@
+//===------ TieredCompileLayer.cpp - Recompile hot functions --------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ExecutionEngine/Orc/TieredCompileLayer.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/MDBuilder.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Transforms/Utils/BasicBlockUtils.h"
+
+#define DEBUG_TYPE "orc"
+
+using namespace llvm;
+using namespace llvm::orc;
+
+/// Returns true if F can be given a counter and later be redirected.
+static bool canTierUp(const Function &F) {
+  if (F.isDeclaration() || F.hasFnAttribute(Attribute::Naked))
+    return false;
+  // Aliases and block addresses must refer to the definition itself.
+  return llvm::none_of(F.users(), [](const User *U) {
+    return isa<GlobalAlias>(U) || isa<BlockAddress>(U);
+  });
+}
+
+/// Renames F's definition to <name><Suffix> and makes every use of F refer to
+/// a declaration under the original name instead, i.e. to the public stub.
+/// Returns the new name of the definition.
+static std::string redirectToStub(Function &F, StringRef Suffix) {
+  std::string Name = F.getName().str();
+  F.setName(Name + Suffix);
+
+  auto *Decl = cloneFunctionDecl(*F.getParent(), F);
+  Decl->setName(Name);
+  Decl->setLinkage(GlobalValue::ExternalLinkage);
+  F.replaceAllUsesWith(Decl);
+
+  F.setLinkage(GlobalValue::ExternalLinkage);
+  F.setVisibility(GlobalValue::HiddenVisibility);
+  F.setComdat(nullptr);
+  return F.getName().str();
+}
+
+TieredCompileLayer::TieredCompileLayer(
+    ExecutionSession &ES, IRLayer &Tier0Layer, IRLayer &Tier1Layer,
+    LazyCallThroughManager &LCTMgr,
+    IndirectStubsManagerBuilder BuildIndirectStubsManager,
+    uint64_t HotThreshold)
+    : IRLayer(ES, Tier0Layer.getManglingOptions()), Tier0Layer(Tier0Layer),
+      Tier1Layer(Tier1Layer), LCTMgr(LCTMgr),
+      BuildIndirectStubsManager(std::move(BuildIndirectStubsManager)),
+      HotThreshold(HotThreshold) {
+  assert(HotThreshold > 0 && "HotThreshold must be non-zero");
+}
+
+void TieredCompileLayer::emit(std::unique_ptr<MaterializationResponsibility> R,
+                              ThreadSafeModule TSM) {
+  assert(TSM && "Null module");
+
+  auto &ES = getExecutionSession();
+
+  // The initializer symbol would not survive the move to the impl dylib.
+  if (R->getInitializerSymbol()) {
+    Tier0Layer.emit(std::move(R), std::move(TSM));
+    return;
+  }
+
+  // Promote local symbols so that tier-1 modules can refer to them, and find
+  // the functions to instrument.
+  std::vector<std::pair<std::string, SymbolStringPtr>> ToInstrument;
+  TSM.withModuleDo([&](Module &M) {
+    {
+      std::lock_guard<std::mutex> Lock(TieredLayerMutex);
+      PromoteSymbols(M);
+    }
+    MangleAndInterner Mangle(ES, M.getDataLayout());
+    for (auto &F : M.functions()) {
+      if (!canTierUp(F))
+        continue;
+      auto Name = Mangle(F.getName());
+      if (R->getSymbols().count(Name))
+        ToInstrument.push_back({F.getName().str(), std::move(Name)});
+    }
+  });
+
+  if (ToInstrument.empty()) {
+    Tier0Layer.emit(std::move(R), std::move(TSM));
+    return;
+  }
+
+  auto &PDR = getPerDylibResources(R->getTargetJITDylib());
+
+  // Keep an uninstrumented copy of the module to build tier-1 code from.
+  auto Source = std::make_shared<ThreadSafeModule>(cloneToNewContext(TSM));
+
+  SymbolAliasMap NonCallables;
+  SymbolAliasMap Callables;
+  TSM.withModuleDo([&](Module &M) {
+    MangleAndInterner Mangle(ES, M.getDataLayout());
+    for (auto &KV : ToInstrument) {
+      auto &F = *M.getFunction(KV.first);
+
+      uint64_t Id;
+      {
+        std::lock_guard<std::mutex> Lock(TieredLayerMutex);
+        Id = TierUps.size();
+        TierUps.push_back({&PDR.getImplDylib(), &PDR.getISManager(), Source,
+                           KV.first, KV.second});
+      }
+      addEntryCounter(F, Id);
+
+      Callables[KV.second] =
+          SymbolAliasMapEntry(Mangle(redirectToStub(F, ".tier0")),
+                              R->getSymbols().lookup(KV.second));
+    }
+  });
+
+  for (auto &KV : R->getSymbols()) {
+    auto &Name = KV.first;
+    auto &Flags = KV.second;
+    if (Callables.count(Name))
+      continue;
+    if (Flags.isCallable())
+      Callables[Name] = SymbolAliasMapEntry(Name, Flags);
+    else
+      NonCallables[Name] = SymbolAliasMapEntry(Name, Flags);
+  }
+
+  if (auto Err = Tier0Layer.add(PDR.getImplDylib(), std::move(TSM))) {
+    ES.reportError(std::move(Err));
+    R->failMaterialization();
+    return;
+  }
+
+  if (!NonCallables.empty())
+    if (auto Err =
+            R->replace(reexports(PDR.getImplDylib(), std::move(NonCallables),
+                                 JITDylibLookupFlags::MatchAllSymbols))) {
+      ES.reportError(std::move(Err));
+      R->failMaterialization();
+      return;
+    }
+  if (auto Err = R->replace(lazyReexports(LCTMgr, PDR.getISManager(),
+                                          PDR.getImplDylib(),
+                                          std::move(Callables)))) {
+    ES.reportError(std::move(Err));
+    R->failMaterialization();
+    return;
+  }
+}
+
+TieredCompileLayer::PerDylibResources &
+TieredCompileLayer::getPerDylibResources(JITDylib &TargetD) {
+  std::lock_guard<std::mutex> Lock(TieredLayerMutex);
+
+  auto I = DylibResources.find(&TargetD);
+  if (I == DylibResources.end()) {
+    auto &ImplD = getExecutionSession().createBareJITDylib(TargetD.getName() +
+                                                           ".tiered");
+    JITDylibSearchOrder NewLinkOrder;
+    TargetD.withLinkOrderDo([&](const JITDylibSearchOrder &TargetLinkOrder) {
+      NewLinkOrder = TargetLinkOrder;
+    });
+
+    assert(!NewLinkOrder.empty() && NewLinkOrder.front().first == &TargetD &&
+           NewLinkOrder.front().second ==
+               JITDylibLookupFlags::MatchAllSymbols &&
+           "TargetD must be at the front of its own search order and match "
+           "non-exported symbol");
+    NewLinkOrder.insert(std::next(NewLinkOrder.begin()),
+                        {&ImplD, JITDylibLookupFlags::MatchAllSymbols});
+    ImplD.setLinkOrder(NewLinkOrder, false);
+    TargetD.setLinkOrder(std::move(NewLinkOrder), false);
+
+    PerDylibResources PDR(ImplD, BuildIndirectStubsManager());
+    I = DylibResources.insert(std::make_pair(&TargetD, std::move(PDR))).first;
+  }
+
+  return I->second;
+}
+
+void TieredCompileLayer::addEntryCounter(Function &F, uint64_t Id) {
+  Module &M = *F.getParent();
+  LLVMContext &Ctx = M.getContext();
+  auto *Int64Ty = Type::getInt64Ty(Ctx);
+  auto *Counter = new GlobalVariable(M, Int64Ty, false,
+                                     GlobalValue::InternalLinkage,
+                                     ConstantInt::get(Int64Ty, 0),
+                                     F.getName() + ".tier.count");
+
+  // Count after the static allocas so that they stay in the entry block.
+  BasicBlock &Entry = F.getEntryBlock();
+  auto IP = Entry.getFirstInsertionPt();
+  while (isa<AllocaInst>(*IP))
+    ++IP;
+
+  IRBuilder<> B(&Entry, IP);
+  auto *Count = B.CreateAtomicRMW(AtomicRMWInst::Add, Counter, B.getInt64(1),
+                                  MaybeAlign(8), AtomicOrdering::Monotonic);
+  auto *IsHot = cast<Instruction>(B.CreateICmpEQ(
+      Count, B.getInt64(HotThreshold - 1), "tier.hot"));
+  Instruction *Then = SplitBlockAndInsertIfThen(
+      IsHot, IsHot->getNextNode(), /*Unreachable=*/false,
+      MDBuilder(Ctx).createBranchWeights(1, HotThreshold));
+
+  // Call tierUpCallback(this, Id) through its in-process address.
+  B.SetInsertPoint(Then);
+  auto *CallbackTy = FunctionType::get(B.getVoidTy(),
+                                       {B.getInt8PtrTy(), Int64Ty}, false);
+  auto *Callback = ConstantExpr::getIntToPtr(
+      B.getInt64(pointerToJITTargetAddress(&tierUpCallback)),
+      CallbackTy->getPointerTo());
+  auto *Self = ConstantExpr::getIntToPtr(
+      B.getInt64(pointerToJITTargetAddress(this)), B.getInt8PtrTy());
+  B.CreateCall(CallbackTy, Callback, {Self, B.getInt64(Id)});
+}
+
+void TieredCompileLayer::tierUpCallback(void *Ctx, uint64_t Id) {
+  auto &Layer = *static_cast<TieredCompileLayer *>(Ctx);
+  Layer.getExecutionSession().dispatchTask(makeGenericNamedTask(
+      [&Layer, Id]() { Layer.tierUp(Id); }, "tier-up recompilation"));
+}
+
+void TieredCompileLayer::tierUp(uint64_t Id) {
+  auto &ES = getExecutionSession();
+
+  TierUpInfo Info;
+  {
+    std::lock_guard<std::mutex> Lock(TieredLayerMutex);
+    Info = TierUps[Id];
+  }
+
+  // Clone every function body so that the optimizer can inline callees, but
+  // only keep the hot one: the others remain available_externally.
+  auto TSM = cloneToNewContext(*Info.Source, [](const GlobalValue &GV) {
+    return isa<Function>(GV) || GV.hasAppendingLinkage();
+  });
+  SymbolStringPtr Tier1Name;
+  TSM.withModuleDo([&](Module &M) {
+    auto &F = *M.getFunction(Info.IRName);
+    for (auto &G : M.functions()) {
+      if (&G == &F || G.isDeclaration())
+        continue;
+      G.setLinkage(GlobalValue::AvailableExternallyLinkage);
+      G.setComdat(nullptr);
+    }
+    MangleAndInterner Mangle(ES, M.getDataLayout());
+    Tier1Name = Mangle(redirectToStub(F, ".tier1"));
+  });
+
+  LLVM_DEBUG(dbgs() << "Tiering up " << Info.PublicName << "\n");
+
+  if (auto Err = Tier1Layer.add(*Info.ImplD, std::move(TSM))) {
+    ES.reportError(std::move(Err));
+    return;
+  }
+
+  auto Sym = ES.lookup(
+      makeJITDylibSearchOrder(Info.ImplD, JITDylibLookupFlags::MatchAllSymbols),
+      Tier1Name);
+  if (!Sym) {
+    ES.reportError(Sym.takeError());
+    return;
+  }
+
+  // A first call that is still resolving through the lazy call-through
+  // manager may overwrite this with the tier-0 address. That is harmless:
+  // the function just stays at tier 0.
+  if (auto Err = Info.ISMgr->updatePointer(*Info.PublicName,
+                                           Sym->getAddress())) {
+    ES.reportError(std::move(Err));
+    return;
+  }
+  ++NumTieredUp;
+}
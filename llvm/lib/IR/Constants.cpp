@@ -919,7 +919,9 @@ Constant *ConstantInt::getBool(Type *Ty, bool V) {
 ConstantInt *ConstantInt::get(LLVMContext &Context, const APInt &V) {
   // get an existing value or the insertion position
   LLVMContextImpl *pImpl = Context.pImpl;
-  std::unique_ptr<ConstantInt> &Slot = pImpl->IntConstants[V];
+  auto &Shard = pImpl->getIntConstantShard(V);
+  UniquingLock<std::mutex> Lock(pImpl->ConcurrentUniquing, Shard.Mutex);
+  std::unique_ptr<ConstantInt> &Slot = Shard.Map[V];
   if (!Slot) {
     // Get the corresponding integer type for the bit width of the value.
     IntegerType *ITy = IntegerType::get(Context, V.getBitWidth());
@@ -1074,7 +1076,9 @@ Constant *ConstantFP::getZeroValueForNegation(Type *Ty) {
 ConstantFP* ConstantFP::get(LLVMContext &Context, const APFloat& V) {
   LLVMContextImpl* pImpl = Context.pImpl;
 
-  std::unique_ptr<ConstantFP> &Slot = pImpl->FPConstants[V];
+  auto &Shard = pImpl->getFPConstantShard(V);
+  UniquingLock<std::mutex> Lock(pImpl->ConcurrentUniquing, Shard.Mutex);
+  std::unique_ptr<ConstantFP> &Slot = Shard.Map[V];
 
   if (!Slot) {
     Type *Ty = Type::getFloatingPointTy(Context, V.getSemantics());
@@ -62,6 +62,8 @@ DILocation *DILocation::getImpl(LLVMContext &Context, unsigned Line,
   // Fixup column.
   adjustColumn(Column);
 
+  UniquingLock<std::recursive_mutex> Lock(Context.pImpl->ConcurrentUniquing,
+                                          Context.pImpl->MetadataMutex);
   if (Storage == Uniqued) {
     if (auto *N = getUniqued(Context.pImpl->DILocations,
                              DILocationInfo::KeyTy(Line, Column, Scope,
@@ -286,6 +288,8 @@ GenericDINode *GenericDINode::getImpl(LLVMContext &Context, unsigned Tag,
                                       MDString *Header,
                                       ArrayRef<Metadata *> DwarfOps,
                                       StorageType Storage, bool ShouldCreate) {
+  UniquingLock<std::recursive_mutex> Lock(Context.pImpl->ConcurrentUniquing,
+                                          Context.pImpl->MetadataMutex);
   unsigned Hash = 0;
   if (Storage == Uniqued) {
     GenericDINodeInfo::KeyTy Key(Tag, Header, DwarfOps);
@@ -313,6 +317,8 @@ void GenericDINode::recalculateHash() {
 #define UNWRAP_ARGS_IMPL(...) __VA_ARGS__
 #define UNWRAP_ARGS(ARGS) UNWRAP_ARGS_IMPL ARGS
 #define DEFINE_GETIMPL_LOOKUP(CLASS, ARGS)                                     \
+  UniquingLock<std::recursive_mutex> MetadataLock(                             \
+      Context.pImpl->ConcurrentUniquing, Context.pImpl->MetadataMutex);        \
   do {                                                                         \
     if (Storage == Uniqued) {                                                  \
       if (auto *N = getUniqued(Context.pImpl->CLASS##s,                        \
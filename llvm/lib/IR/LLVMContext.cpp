@@ -328,6 +328,14 @@ void LLVMContext::enableDebugTypeODRUniquing() {
 
 void LLVMContext::disableDebugTypeODRUniquing() { pImpl->DITypeMap.reset(); }
 
+void LLVMContext::enableConcurrentUniquing() {
+  pImpl->ConcurrentUniquing = true;
+}
+
+bool LLVMContext::isConcurrentUniquingEnabled() const {
+  return pImpl->ConcurrentUniquing;
+}
+
 void LLVMContext::setDiscardValueNames(bool Discard) {
   pImpl->DiscardValueNames = Discard;
 }
@@ -100,8 +100,10 @@ LLVMContextImpl::~LLVMContextImpl() {
   CPNConstants.clear();
   UVConstants.clear();
   PVConstants.clear();
-  IntConstants.clear();
-  FPConstants.clear();
+  for (ConstantShard<IntMapTy> &Shard : IntConstants)
+    Shard.Map.clear();
+  for (ConstantShard<FPMapTy> &Shard : FPConstants)
+    Shard.Map.clear();
   CDSConstants.clear();
 
   // Destroy attribute node lists.
@@ -46,6 +46,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -1330,6 +1331,24 @@ public:
   }
 };
 
+/// Locks a mutex of a context if the context is in concurrent uniquing mode.
+template <typename MutexT> class UniquingLock {
+  MutexT *M;
+
+public:
+  UniquingLock(bool ConcurrentUniquing, MutexT &Mutex)
+      : M(ConcurrentUniquing ? &Mutex : nullptr) {
+    if (M)
+      M->lock();
+  }
+  UniquingLock(const UniquingLock &) = delete;
+  UniquingLock &operator=(const UniquingLock &) = delete;
+  ~UniquingLock() {
+    if (M)
+      M->unlock();
+  }
+};
+
 class LLVMContextImpl {
 public:
   /// OwnedModules - The set of modules instantiated in this context, and which
@@ -1370,24 +1389,54 @@ public:
   LLVMContext::YieldCallbackTy YieldCallback = nullptr;
   void *YieldOpaqueHandle = nullptr;
 
+  /// Set by LLVMContext::enableConcurrentUniquing(). If set, the uniquing
+  /// tables that have a mutex below are only used with it held.
+  bool ConcurrentUniquing = false;
+
+  /// Integer and floating-point constants are split into shards by the top
+  /// bits of their hash, so that threads uniquing different constants rarely
+  /// wait for each other. The DenseMap of a shard uses the low bits.
+  template <typename MapT> struct ConstantShard {
+    std::mutex Mutex;
+    MapT Map;
+  };
+  static constexpr unsigned ConstantShardBits = 4;
+  static constexpr unsigned NumConstantShards = 1 << ConstantShardBits;
+  static unsigned getConstantShardIndex(unsigned Hash) {
+    return Hash >> (32 - ConstantShardBits);
+  }
+
   using IntMapTy =
       DenseMap<APInt, std::unique_ptr<ConstantInt>, DenseMapAPIntKeyInfo>;
-  IntMapTy IntConstants;
+  ConstantShard<IntMapTy> IntConstants[NumConstantShards];
+  ConstantShard<IntMapTy> &getIntConstantShard(const APInt &V) {
+    return IntConstants[getConstantShardIndex(
+        DenseMapAPIntKeyInfo::getHashValue(V))];
+  }
 
   using FPMapTy =
       DenseMap<APFloat, std::unique_ptr<ConstantFP>, DenseMapAPFloatKeyInfo>;
-  FPMapTy FPConstants;
+  ConstantShard<FPMapTy> FPConstants[NumConstantShards];
+  ConstantShard<FPMapTy> &getFPConstantShard(const APFloat &V) {
+    return FPConstants[getConstantShardIndex(
+        DenseMapAPFloatKeyInfo::getHashValue(V))];
+  }
 
   FoldingSet<AttributeImpl> AttrsSet;
   FoldingSet<AttributeListImpl> AttrsLists;
   FoldingSet<AttributeSetNode> AttrsSetNodes;
 
+  std::mutex MDStringMutex;
   StringMap<MDString, BumpPtrAllocator> MDStringCache;
   DenseMap<Value *, ValueAsMetadata *> ValuesAsMetadata;
   DenseMap<Metadata *, MetadataAsValue *> MetadataAsValues;
 
   DenseMap<const Value *, ValueName *> ValueNames;
 
+  /// Guards the uniqued metadata node sets and ValuesAsMetadata. Creating a
+  /// node tracks its operands, so this is held from looking the node up until
+  /// it is stored, and may be taken again while creating its operands.
+  std::recursive_mutex MetadataMutex;
 #define HANDLE_MDNODE_LEAF_UNIQUABLE(CLASS)                                    \
   DenseSet<CLASS *, CLASS##Info> CLASS##s;
 #include "llvm/IR/Metadata.def"
@@ -1445,6 +1494,8 @@ public:
   BumpPtrAllocator Alloc;
   UniqueStringSaver Saver{Alloc};
 
+  /// Guards IntegerTypes, and Alloc while a new IntegerType is allocated.
+  std::mutex IntegerTypesMutex;
   DenseMap<unsigned, IntegerType *> IntegerTypes;
 
   using FunctionTypeSet = DenseSet<FunctionType *, FunctionTypeKeyInfo>;
@@ -369,6 +369,8 @@ ValueAsMetadata *ValueAsMetadata::get(Value *V) {
   assert(V && "Unexpected null Value");
 
   auto &Context = V->getContext();
+  UniquingLock<std::recursive_mutex> Lock(Context.pImpl->ConcurrentUniquing,
+                                          Context.pImpl->MetadataMutex);
   auto *&Entry = Context.pImpl->ValuesAsMetadata[V];
   if (!Entry) {
     assert((isa<Constant>(V) || isa<Argument>(V) || isa<Instruction>(V)) &&
@@ -471,6 +473,8 @@ void ValueAsMetadata::handleRAUW(Value *From, Value *To) {
 //
 
 MDString *MDString::get(LLVMContext &Context, StringRef Str) {
+  UniquingLock<std::mutex> Lock(Context.pImpl->ConcurrentUniquing,
+                                Context.pImpl->MDStringMutex);
   auto &Store = Context.pImpl->MDStringCache;
   auto I = Store.try_emplace(Str);
   auto &MapEntry = I.first->getValue();
@@ -799,6 +803,9 @@ template <class NodeTy> struct MDNode::HasCachedHash {
 
 MDNode *MDNode::uniquify() {
   assert(!hasSelfReference(this) && "Cannot uniquify a self-referencing node");
+  LLVMContextImpl *pImpl = getContext().pImpl;
+  UniquingLock<std::recursive_mutex> Lock(pImpl->ConcurrentUniquing,
+                                          pImpl->MetadataMutex);
 
   // Try to insert into uniquing store.
   switch (getMetadataID()) {
@@ -817,6 +824,9 @@ MDNode *MDNode::uniquify() {
 }
 
 void MDNode::eraseFromStore() {
+  LLVMContextImpl *pImpl = getContext().pImpl;
+  UniquingLock<std::recursive_mutex> Lock(pImpl->ConcurrentUniquing,
+                                          pImpl->MetadataMutex);
   switch (getMetadataID()) {
   default:
     llvm_unreachable("Invalid or non-uniquable subclass of MDNode");
@@ -830,6 +840,8 @@ void MDNode::eraseFromStore() {
 
 MDTuple *MDTuple::getImpl(LLVMContext &Context, ArrayRef<Metadata *> MDs,
                           StorageType Storage, bool ShouldCreate) {
+  UniquingLock<std::recursive_mutex> Lock(Context.pImpl->ConcurrentUniquing,
+                                          Context.pImpl->MetadataMutex);
   unsigned Hash = 0;
   if (Storage == Uniqued) {
     MDTupleInfo::KeyTy Key(MDs);
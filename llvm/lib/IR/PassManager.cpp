@@ -11,6 +11,9 @@
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/PassManagerImpl.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/ThreadPool.h"
+#include <atomic>
+#include <mutex>
 
 using namespace llvm;
 
@@ -124,6 +127,7 @@ PreservedAnalyses ModuleToFunctionPassAdaptor::run(Module &M,
 
     PreservedAnalyses PassPA;
     {
+      TimeTraceScope FunctionScope("OptFunction", F.getName());
       TimeTraceScope TimeScope(Pass->name(), F.getName());
       PassPA = Pass->run(F, FAM);
     }
@@ -150,6 +154,91 @@ PreservedAnalyses ModuleToFunctionPassAdaptor::run(Module &M,
   return PA;
 }
 
+void ParallelModuleToFunctionPassAdaptor::printPipeline(
+    raw_ostream &OS, function_ref<StringRef(StringRef)> MapClassName2PassName) {
+  OS << "parallel-function(";
+  CreatePass()->printPipeline(OS, MapClassName2PassName);
+  OS << ")";
+}
+
+PreservedAnalyses
+ParallelModuleToFunctionPassAdaptor::run(Module &M,
+                                         ModuleAnalysisManager &AM) {
+  FunctionAnalysisManager &FAM =
+      AM.getResult<FunctionAnalysisManagerModuleProxy>(M).getManager();
+  PassInstrumentation PI = AM.getResult<PassInstrumentationAnalysis>(M);
+
+  std::vector<Function *> Functions;
+  for (Function &F : M)
+    if (!F.isDeclaration())
+      Functions.push_back(&F);
+
+  // Whether each function's pass ran, and what it preserved.
+  std::vector<Optional<PreservedAnalyses>> FunctionPAs(Functions.size());
+  std::atomic<size_t> NextFunction{0};
+  std::mutex PIMutex;
+
+  auto RunWorker = [&]() {
+    std::unique_ptr<PassConceptT> Pass = CreatePass();
+
+    // Registered first, so that RegisterAnalyses can't register one with the
+    // (not thread-safe) callbacks.
+    FunctionAnalysisManager WorkerFAM;
+    WorkerFAM.registerPass([] { return PassInstrumentationAnalysis(); });
+    WorkerFAM.registerPass(
+        [&] { return ModuleAnalysisManagerFunctionProxy(AM); });
+    RegisterAnalyses(WorkerFAM);
+
+    for (size_t I = NextFunction++; I < Functions.size(); I = NextFunction++) {
+      Function &F = *Functions[I];
+      {
+        std::lock_guard<std::mutex> Lock(PIMutex);
+        if (!PI.runBeforePass<Function>(*Pass, F))
+          continue;
+      }
+
+      PreservedAnalyses PassPA;
+      {
+        TimeTraceScope FunctionScope("OptFunction", F.getName());
+        TimeTraceScope TimeScope(Pass->name(), F.getName());
+        PassPA = Pass->run(F, WorkerFAM);
+      }
+
+      {
+        std::lock_guard<std::mutex> Lock(PIMutex);
+        PI.runAfterPass(*Pass, F, PassPA);
+      }
+      WorkerFAM.clear(F, F.getName());
+      FunctionPAs[I] = std::move(PassPA);
+    }
+  };
+
+  unsigned NumWorkers =
+      std::min<size_t>(S.compute_thread_count(), Functions.size());
+  if (NumWorkers > 1) {
+    ThreadPool Pool(S);
+    for (unsigned I = 0; I != NumWorkers; ++I)
+      Pool.async(RunWorker);
+    Pool.wait();
+  } else {
+    RunWorker();
+  }
+
+  PreservedAnalyses PA = PreservedAnalyses::all();
+  for (size_t I = 0, E = Functions.size(); I != E; ++I) {
+    if (!FunctionPAs[I])
+      continue;
+    FAM.invalidate(*Functions[I], *FunctionPAs[I]);
+    PA.intersect(std::move(*FunctionPAs[I]));
+  }
+
+  // As in ModuleToFunctionPassAdaptor, the function analyses need no more
+  // invalidation, and no functions were added or removed.
+  PA.preserveSet<AllAnalysesOn<Function>>();
+  PA.preserve<FunctionAnalysisManagerModuleProxy>();
+  return PA;
+}
+
 AnalysisSetKey CFGAnalyses::SetKey;
 
 AnalysisSetKey PreservedAnalyses::AllAnalysesKey;
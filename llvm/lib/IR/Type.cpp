@@ -326,6 +326,8 @@ IntegerType *IntegerType::get(LLVMContext &C, unsigned NumBits) {
     break;
   }
 
+  UniquingLock<std::mutex> Lock(C.pImpl->ConcurrentUniquing,
+                                C.pImpl->IntegerTypesMutex);
   IntegerType *&Entry = C.pImpl->IntegerTypes[NumBits];
 
   if (!Entry)
@@ -7,27 +7,54 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/IR/Use.h"
+#include "llvm/ADT/Waymarking.h"
 #include "llvm/IR/User.h"
 #include "llvm/IR/Value.h"
+#include <iterator>
 #include <new>
 
 namespace llvm {
 
+// The waymarks are written from the end of the operand list backwards, so the
+// head of the waymarked array is the last Use and is found walking forwards.
+struct Use::Waymarker {
+  using Traits = detail::WaymarkingTraits<NumWaymarkBits>;
+  static void setWaymark(Use &U, unsigned Tag) { U.Prev.setInt(Tag); }
+  static unsigned getWaymark(const Use &U) { return U.Prev.getInt(); }
+};
+
+void Use::initWaymarks(Use *Start, Use *Stop) {
+  using Iter = std::reverse_iterator<Use *>;
+  fillWaymarks<Iter, Waymarker>(Iter(Stop), Iter(Start));
+}
+
+User *Use::getUser() const {
+  using Iter = std::reverse_iterator<const Use *>;
+  const Use *End = followWaymarks<Iter, Waymarker>(Iter(this + 1)).base();
+  const UserRef *Ref = reinterpret_cast<const UserRef *>(End);
+  return Ref->getInt() ? Ref->getPointer()
+                       : reinterpret_cast<User *>(const_cast<Use *>(End));
+}
+
 void Use::swap(Use &RHS) {
   if (Val == RHS.Val)
     return;
 
+  // The waymarks belong to the positions of the Uses, so only the pointer
+  // parts of Prev are exchanged.
   std::swap(Val, RHS.Val);
   std::swap(Next, RHS.Next);
-  std::swap(Prev, RHS.Prev);
+  Use **OldPrev = getPrev();
+  setPrev(RHS.getPrev());
+  RHS.setPrev(OldPrev);
 
-  *Prev = this;
+  *getPrev() = this;
   if (Next)
-    Next->Prev = &Next;
+    Next->setPrev(&Next);
 
-  *RHS.Prev = &RHS;
+  *RHS.getPrev() = &RHS;
   if (RHS.Next)
-    RHS.Next->Prev = &RHS.Next;
+    RHS.Next->setPrev(&RHS.Next);
 }
 
 unsigned Use::getOperandNo() const {
@@ -46,16 +46,21 @@ void User::allocHungoffUses(unsigned N, bool IsPhi) {
 
   static_assert(alignof(Use) >= alignof(BasicBlock *),
                 "Alignment is insufficient for 'hung-off-uses' pieces");
+  static_assert(alignof(Use) >= alignof(Use::UserRef),
+                "Alignment is insufficient for 'hung-off-uses' pieces");
 
-  // Allocate the array of Uses
-  size_t size = N * sizeof(Use);
+  // Allocate the array of Uses, followed by the UserRef that their waymarks
+  // lead to.
+  size_t size = N * sizeof(Use) + sizeof(Use::UserRef);
   if (IsPhi)
     size += N * sizeof(BasicBlock *);
   Use *Begin = static_cast<Use*>(::operator new(size));
   Use *End = Begin + N;
   setOperandList(Begin);
-  for (; Begin != End; Begin++)
-    new (Begin) Use(this);
+  for (Use *U = Begin; U != End; U++)
+    new (U) Use();
+  new (End) Use::UserRef(this, 1);
+  Use::initWaymarks(Begin, End);
 }
 
 void User::growHungoffUses(unsigned NewNumUses, bool IsPhi) {
@@ -76,8 +81,10 @@ void User::growHungoffUses(unsigned NewNumUses, bool IsPhi) {
 
   // If this is a Phi, then we need to copy the BB pointers too.
   if (IsPhi) {
-    auto *OldPtr = reinterpret_cast<char *>(OldOps + OldNumUses);
-    auto *NewPtr = reinterpret_cast<char *>(NewOps + NewNumUses);
+    auto *OldPtr = reinterpret_cast<char *>(
+        reinterpret_cast<Use::UserRef *>(OldOps + OldNumUses) + 1);
+    auto *NewPtr = reinterpret_cast<char *>(
+        reinterpret_cast<Use::UserRef *>(NewOps + NewNumUses) + 1);
     std::copy(OldPtr, OldPtr + (OldNumUses * sizeof(BasicBlock *)), NewPtr);
   }
   Use::zap(OldOps, OldOps + OldNumUses, true);
@@ -133,8 +140,9 @@ void *User::allocateFixedOperandUser(size_t Size, unsigned Us,
   Obj->NumUserOperands = Us;
   Obj->HasHungOffUses = false;
   Obj->HasDescriptor = DescBytes != 0;
-  for (; Start != End; Start++)
-    new (Start) Use(Obj);
+  for (Use *U = Start; U != End; U++)
+    new (U) Use();
+  Use::initWaymarks(Start, End);
 
   if (DescBytes != 0) {
     auto *DescInfo = reinterpret_cast<DescriptorInfo *>(Storage + DescBytes);
@@ -1001,12 +1001,12 @@ void Value::reverseUseList() {
   while (Current) {
     Use *Next = Current->Next;
     Current->Next = Head;
-    Head->Prev = &Current->Next;
+    Head->setPrev(&Current->Next);
     Head = Current;
     Current = Next;
   }
   UseList = Head;
-  Head->Prev = &UseList;
+  Head->setPrev(&UseList);
 }
 
 bool Value::isSwiftError() const {
@@ -1406,6 +1406,29 @@ ThinBackend lto::createWriteIndexesThinBackend(
   };
 }
 
+/// Estimates how long the backend for a module takes, as the number of
+/// instructions in the live functions it defines or imports. Dead functions are
+/// dropped before optimization, and imported functions are optimized again in
+/// every module that imports them.
+static uint64_t
+estimateBackendCost(const ModuleSummaryIndex &Index,
+                    const GVSummaryMapTy &DefinedGVSummaries,
+                    const FunctionImporter::ImportMapTy &ImportList) {
+  uint64_t Cost = 0;
+  auto AddCost = [&](const GlobalValueSummary *S) {
+    if (!S || !Index.isGlobalValueLive(S))
+      return;
+    if (auto *FS = dyn_cast<FunctionSummary>(S))
+      Cost += FS->instCount();
+  };
+  for (auto &GVS : DefinedGVSummaries)
+    AddCost(GVS.second);
+  for (auto &Src : ImportList)
+    for (GlobalValue::GUID GUID : Src.second)
+      AddCost(Index.findSummaryInModule(GUID, Src.first()));
+  return Cost;
+}
+
 Error LTO::runThinLTO(AddStreamFn AddStream, FileCache Cache,
                       const DenseSet<GlobalValue::GUID> &GUIDPreservedSymbols) {
   timeTraceProfilerBegin("ThinLink", StringRef(""));
@@ -1560,15 +1583,27 @@ Error LTO::runThinLTO(AddStreamFn AddStream, FileCache Cache,
       if (Error E = ProcessOneModule(I))
         return E;
   } else {
-    // When executing in parallel, process largest bitsize modules first to
+    // When executing in parallel, process the most expensive modules first to
     // improve parallelism, and avoid starving the thread pool near the end.
     // This saves about 15 sec on a 36-core machine while link `clang.exe` (out
-    // of 100 sec).
+    // of 100 sec). The cost comes from the summaries, which also account for
+    // imported functions; modules of the same cost, such as the ones without
+    // summaries, go largest bitsize first.
     std::vector<BitcodeModule *> ModulesVec;
+    std::vector<uint64_t> Costs;
     ModulesVec.reserve(ModuleMap.size());
-    for (auto &Mod : ModuleMap)
+    Costs.reserve(ModuleMap.size());
+    for (auto &Mod : ModuleMap) {
       ModulesVec.push_back(&Mod.second);
-    for (int I : generateModulesOrdering(ModulesVec))
+      Costs.push_back(estimateBackendCost(
+          ThinLTO.CombinedIndex, ModuleToDefinedGVSummaries[Mod.first],
+          ImportLists[Mod.first]));
+    }
+    std::vector<int> ModulesOrdering = generateModulesOrdering(ModulesVec);
+    llvm::stable_sort(ModulesOrdering, [&](int LeftIndex, int RightIndex) {
+      return Costs[LeftIndex] > Costs[RightIndex];
+    });
+    for (int I : ModulesOrdering)
       if (Error E = ProcessOneModule(I))
         return E;
   }
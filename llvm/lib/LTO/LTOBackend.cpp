@@ -73,6 +73,12 @@ static cl::opt<bool> ThinLTOAssumeMerged(
     cl::desc("Assume the input has already undergone ThinLTO function "
              "importing and the other pre-optimization pipeline changes."));
 
+static cl::opt<bool> SplitCodeGenPreserveLocals(
+    "lto-split-codegen-preserve-locals", cl::init(false),
+    cl::desc("When splitting the module for parallel code generation, keep "
+             "local symbols local by placing each of them in the partition of "
+             "its users instead of externalizing and renaming it."));
+
 namespace llvm {
 extern cl::opt<bool> NoPGOWarnMismatch;
 }
@@ -473,7 +479,7 @@ static void splitCodeGen(const Config &C, TargetMachine *TM,
             // copied into the thread's context.
             std::move(BC), ThreadCount++);
       },
-      false);
+      SplitCodeGenPreserveLocals);
 
   // Because the inner lambda (which runs in a worker thread) captures our local
   // variables, we need to wait for the worker threads to terminate before we
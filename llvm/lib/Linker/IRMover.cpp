@@ -20,6 +20,7 @@
 #include "llvm/IR/TypeFinder.h"
 #include "llvm/Object/ModuleSymbolTable.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Transforms/Utils/Cloning.h"
 #include <utility>
@@ -401,6 +402,10 @@ class IRLinker {
   std::vector<GlobalValue *> Worklist;
   std::vector<std::pair<GlobalValue *, Value*>> RAUWWorklist;
 
+  /// The initializers of the appending variables in DstM that were replaced by
+  /// their concatenation with the ones in SrcM.
+  SmallVector<Constant *, 4> ReplacedAppendingInits;
+
   void maybeAdd(GlobalValue *GV) {
     if (ValuesToLink.insert(GV).second)
       Worklist.push_back(GV);
@@ -542,6 +547,13 @@ public:
   ~IRLinker() { SharedMDs = std::move(*ValueMap.getMDMap()); }
 
   Error run();
+
+  /// Returns the initializers of the appending variables that linking
+  /// replaced. They are left dead once run() succeeds.
+  ArrayRef<Constant *> getReplacedAppendingInits() const {
+    return ReplacedAppendingInits;
+  }
+
   Value *materialize(Value *V, bool ForIndirectSymbol);
 };
 }
@@ -964,6 +976,9 @@ IRLinker::linkAppendingVarProto(GlobalVariable *DstGV,
       (DstGV && !DstGV->isDeclaration()) ? DstGV->getInitializer() : nullptr,
       IsOldStructor, SrcElements);
 
+  if (DstGV && !DstGV->isDeclaration())
+    ReplacedAppendingInits.push_back(DstGV->getInitializer());
+
   // Replace any uses of the two global variables with uses of the new
   // global.
   if (DstGV) {
@@ -1681,6 +1696,15 @@ Error IRMover::move(
                        std::move(Src), ValuesToLink, std::move(AddLazyFor),
                        IsPerformingImport);
   Error E = TheIRLinker.run();
-  Composite.dropTriviallyDeadConstantArrays();
+  // Every module with an llvm.global_ctors or llvm.used leaves behind a dead
+  // initializer holding the entries of all the modules linked before it, so
+  // these are destroyed right away. Sweeping the whole context for the other
+  // dead arrays after every module would take time quadratic in the number of
+  // modules, so that is only done after the 1st, 2nd, 4th, 8th... module.
+  for (Constant *C : TheIRLinker.getReplacedAppendingInits())
+    if (isa<ConstantArray>(C) && C->use_empty())
+      C->destroyConstant();
+  if (isPowerOf2_64(++NumMoves))
+    Composite.dropTriviallyDeadConstantArrays();
   return E;
 }
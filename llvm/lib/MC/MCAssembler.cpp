@@ -69,6 +69,7 @@ STATISTIC(FragmentLayouts, "Number of fragment layouts");
 STATISTIC(ObjectBytes, "Number of emitted object file bytes");
 STATISTIC(RelaxationSteps, "Number of assembler layout and relaxation steps");
 STATISTIC(RelaxedInstructions, "Number of relaxed instructions");
+STATISTIC(RelaxedFragments, "Number of fragments that changed size in layout");
 
 } // end namespace stats
 } // end anonymous namespace
@@ -1191,24 +1192,22 @@ bool MCAssembler::relaxFragment(MCAsmLayout &Layout, MCFragment &F) {
 }
 
 bool MCAssembler::layoutSectionOnce(MCAsmLayout &Layout, MCSection &Sec) {
-  // Holds the first fragment which needed relaxing during this layout. It will
-  // remain NULL if none were relaxed.
-  // When a fragment is relaxed, all the fragments following it should get
-  // invalidated because their offset is going to change.
-  MCFragment *FirstRelaxedFragment = nullptr;
-
-  // Attempt to relax all the fragments in the section.
+  // Attempt to relax all the fragments in the section. When a fragment is
+  // relaxed, the fragments following it are invalidated right away, because
+  // their offsets are going to change. The fragments visited later in this
+  // pass then see those new offsets, and are laid out again only as far as
+  // their fixups need. A chain of branches each of which only needs
+  // relaxing once the one before it grew then takes one pass, not one pass
+  // per branch.
+  bool WasRelaxed = false;
   for (MCFragment &Frag : Sec) {
-    // Check if this is a fragment that needs relaxation.
-    bool RelaxedFrag = relaxFragment(Layout, Frag);
-    if (RelaxedFrag && !FirstRelaxedFragment)
-      FirstRelaxedFragment = &Frag;
-  }
-  if (FirstRelaxedFragment) {
-    Layout.invalidateFragmentsFrom(FirstRelaxedFragment);
-    return true;
+    if (!relaxFragment(Layout, Frag))
+      continue;
+    ++stats::RelaxedFragments;
+    Layout.invalidateFragmentsFrom(&Frag);
+    WasRelaxed = true;
   }
-  return false;
+  return WasRelaxed;
 }
 
 bool MCAssembler::layoutOnce(MCAsmLayout &Layout) {
@@ -185,6 +185,26 @@ MCFragment *MCObjectStreamer::getCurrentFragment() const {
   return nullptr;
 }
 
+/// Reallocate V to its size if it is large and more than a quarter of its
+/// capacity is unused.
+template <typename T> static void shrinkToFit(SmallVectorImpl<T> &V) {
+  // Small vectors may still be in their inline storage, and are not worth a
+  // reallocation anyway.
+  const size_t MinSize = 256;
+  if (V.size() < MinSize || V.capacity() - V.size() <= V.size() / 4)
+    return;
+  SmallVector<T, 0> Tmp(V.begin(), V.end());
+  V.swap(Tmp);
+}
+
+void MCObjectStreamer::releaseSpareCapacity(MCFragment &F) {
+  auto *DF = dyn_cast<MCDataFragment>(&F);
+  if (!DF)
+    return;
+  shrinkToFit(DF->getContents());
+  shrinkToFit(DF->getFixups());
+}
+
 static bool canReuseDataFragment(const MCDataFragment &F,
                                  const MCAssembler &Assembler,
                                  const MCSubtargetInfo *STI) {
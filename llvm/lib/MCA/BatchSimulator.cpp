@@ -0,0 +1,164 @@
+//===--------------------- BatchSimulator.cpp -------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+/// \file
+///
+/// This file implements the BatchSimulator class.
+///
+//===----------------------------------------------------------------------===//
+
+#include "llvm/MCA/BatchSimulator.h"
+#include "llvm/ADT/Optional.h"
+#include "llvm/MC/TargetRegistry.h"
+#include "llvm/MCA/CustomBehaviour.h"
+#include "llvm/MCA/Pipeline.h"
+#include "llvm/MCA/SourceMgr.h"
+#include "llvm/MCA/Support.h"
+#include "llvm/Support/ThreadPool.h"
+
+namespace llvm {
+namespace mca {
+
+json::Value toJSON(const BlockSummary &S) {
+  unsigned TotalInstructions = S.Instructions * S.Iterations;
+  return json::Object(
+      {{"Iterations", S.Iterations},
+       {"Instructions", TotalInstructions},
+       {"TotalCycles", S.TotalCycles},
+       {"TotaluOps", S.TotalUOps},
+       {"DispatchWidth", S.DispatchWidth},
+       {"uOpsPerCycle", (double)S.TotalUOps / S.TotalCycles},
+       {"IPC", (double)TotalInstructions / S.TotalCycles},
+       {"BlockRThroughput", S.BlockRThroughput}});
+}
+
+BatchSimulator::BatchSimulator(const Target &T, const MCSubtargetInfo &STI,
+                               const MCInstrInfo &MCII,
+                               const MCRegisterInfo &MRI,
+                               const MCInstrAnalysis *MCIA,
+                               const PipelineOptions &PO, unsigned Iter,
+                               bool EnableCustomBehaviour)
+    : TheTarget(T), STI(STI), MCII(MCII), MRI(MRI), MCIA(MCIA), PO(PO),
+      Iterations(Iter), UseCustomBehaviour(EnableCustomBehaviour) {
+  const MCSchedModel &SM = STI.getSchedModel();
+  SmallVector<uint64_t, 8> ProcResourceMasks(SM.getNumProcResourceKinds());
+  computeProcResourceMasks(SM, ProcResourceMasks);
+  ResIdx2ProcResID.resize(SM.getNumProcResourceKinds());
+  for (unsigned I = 1, E = SM.getNumProcResourceKinds(); I < E; ++I)
+    ResIdx2ProcResID[getResourceStateIndex(ProcResourceMasks[I])] = I;
+}
+
+std::unique_ptr<InstrBuilder> BatchSimulator::takeBuilder() {
+  {
+    std::lock_guard<std::mutex> Lock(BuildersLock);
+    if (!FreeBuilders.empty()) {
+      std::unique_ptr<InstrBuilder> IB = std::move(FreeBuilders.back());
+      FreeBuilders.pop_back();
+      return IB;
+    }
+  }
+  return std::make_unique<InstrBuilder>(STI, MCII, MRI, MCIA);
+}
+
+void BatchSimulator::returnBuilder(std::unique_ptr<InstrBuilder> IB) {
+  std::lock_guard<std::mutex> Lock(BuildersLock);
+  FreeBuilders.push_back(std::move(IB));
+}
+
+Expected<BlockSummary> BatchSimulator::simulate(InstrBuilder &IB,
+                                                ArrayRef<MCInst> Block) {
+  if (Block.empty())
+    return createStringError(inconvertibleErrorCode(),
+                             "no instructions to simulate");
+
+  std::unique_ptr<InstrPostProcess> IPP;
+  if (UseCustomBehaviour)
+    IPP.reset(TheTarget.createInstrPostProcess(STI, MCII));
+  if (!IPP)
+    IPP = std::make_unique<InstrPostProcess>(STI, MCII);
+
+  // Variant descriptors are cached by MCInst address, which the next block
+  // may reuse.
+  IB.clear();
+  SmallVector<std::unique_ptr<Instruction>> LoweredSequence;
+  for (const MCInst &MCI : Block) {
+    Expected<std::unique_ptr<Instruction>> Inst = IB.createInstruction(MCI);
+    if (!Inst)
+      return Inst.takeError();
+    IPP->postProcessInstruction(Inst.get(), MCI);
+    LoweredSequence.emplace_back(std::move(Inst.get()));
+  }
+
+  SourceMgr S(LoweredSequence, Iterations);
+  std::unique_ptr<CustomBehaviour> CB;
+  if (UseCustomBehaviour)
+    CB.reset(TheTarget.createCustomBehaviour(STI, S, MCII));
+  if (!CB)
+    CB = std::make_unique<CustomBehaviour>(STI, S, MCII);
+
+  Context MCA(MRI, STI);
+  std::unique_ptr<Pipeline> P = MCA.createDefaultPipeline(PO, S, *CB);
+  Expected<unsigned> Cycles = P->run();
+  if (!Cycles)
+    return Cycles.takeError();
+
+  // Every instruction of the block retires once per iteration, so the
+  // resource usage of one iteration can be read from the descriptors.
+  const MCSchedModel &SM = STI.getSchedModel();
+  SmallVector<unsigned, 8> ProcResourceUsage(SM.getNumProcResourceKinds());
+  unsigned NumMicroOps = 0;
+  for (const std::unique_ptr<Instruction> &Inst : LoweredSequence) {
+    const InstrDesc &Desc = Inst->getDesc();
+    NumMicroOps += Desc.NumMicroOps;
+    for (const std::pair<uint64_t, ResourceUsage> &RU : Desc.Resources)
+      if (RU.second.size())
+        ProcResourceUsage[ResIdx2ProcResID[getResourceStateIndex(RU.first)]] +=
+            RU.second.size();
+  }
+
+  BlockSummary Summary;
+  Summary.Iterations = S.getNumIterations();
+  Summary.Instructions = Block.size();
+  Summary.TotalCycles = *Cycles;
+  Summary.TotalUOps = NumMicroOps * Summary.Iterations;
+  Summary.DispatchWidth = PO.DispatchWidth ? PO.DispatchWidth : SM.IssueWidth;
+  Summary.BlockRThroughput = computeBlockRThroughput(
+      SM, Summary.DispatchWidth, NumMicroOps, ProcResourceUsage);
+  return Summary;
+}
+
+Expected<BlockSummary> BatchSimulator::simulate(ArrayRef<MCInst> Block) {
+  std::unique_ptr<InstrBuilder> IB = takeBuilder();
+  Expected<BlockSummary> Result = simulate(*IB, Block);
+  returnBuilder(std::move(IB));
+  return Result;
+}
+
+void BatchSimulator::simulate(
+    ArrayRef<ArrayRef<MCInst>> Blocks, unsigned NumThreads,
+    function_ref<void(unsigned, Expected<BlockSummary>)> Consumer) {
+  std::vector<Optional<Expected<BlockSummary>>> Results(Blocks.size());
+  std::vector<std::shared_future<void>> Done;
+  Done.reserve(Blocks.size());
+
+  ThreadPool Pool(hardware_concurrency(NumThreads));
+  for (unsigned I = 0, E = Blocks.size(); I != E; ++I)
+    Done.push_back(Pool.async([this, &Blocks, &Results, I] {
+      Results[I].emplace(simulate(Blocks[I]));
+    }));
+
+  // Hand the results out in order. Without thread support, waiting for a
+  // block runs its simulation here.
+  for (unsigned I = 0, E = Blocks.size(); I != E; ++I) {
+    Done[I].wait();
+    Consumer(I, std::move(*Results[I]));
+    Results[I].reset();
+  }
+}
+
+} // namespace mca
+} // namespace llvm
@@ -25,6 +25,7 @@
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/Format.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SmallVectorMemoryBuffer.h"
 #include "llvm/Support/ToolOutputFile.h"
@@ -472,7 +473,43 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
       Entry.second = Entry.second > 1 ? 1 : 0;
   }
 
-  for (const NewArchiveMember &M : NewMembers) {
+  // Reading the symbols of the members is by far the most expensive part, so
+  // do it for all of them in parallel, each into a string of its own, and
+  // merge the results in member order below.
+  struct MemberSymbols {
+    std::string Names;
+    std::vector<unsigned> Offsets;
+    bool HasObject = false;
+  };
+  std::vector<MemberSymbols> AllSymbols(NeedSymbols ? NewMembers.size() : 0);
+  std::vector<Error> Errors;
+  Errors.reserve(AllSymbols.size());
+  for (size_t I = 0, E = AllSymbols.size(); I != E; ++I)
+    Errors.push_back(Error::success());
+  parallelForEachN(0, AllSymbols.size(), [&](size_t I) {
+    MemberSymbols &Syms = AllSymbols[I];
+    raw_string_ostream Names(Syms.Names);
+    Expected<std::vector<unsigned>> SymbolsOrErr = getSymbols(
+        NewMembers[I].Buf->getMemBufferRef(), Names, Syms.HasObject);
+    if (!SymbolsOrErr) {
+      Errors[I] = SymbolsOrErr.takeError();
+      return;
+    }
+    Names.flush();
+    Syms.Offsets = std::move(*SymbolsOrErr);
+  });
+  // Report the error for the first member that failed, as before.
+  for (Error &E : Errors) {
+    if (!E)
+      continue;
+    Error Err = std::move(E);
+    for (Error &Rest : Errors)
+      consumeError(std::move(Rest));
+    return std::move(Err);
+  }
+
+  for (size_t I = 0, E = NewMembers.size(); I != E; ++I) {
+    const NewArchiveMember &M = NewMembers[I];
     std::string Header;
     raw_string_ostream Out(Header);
 
@@ -510,11 +547,15 @@ computeMemberData(raw_ostream &StringTable, raw_ostream &SymNames,
 
     std::vector<unsigned> Symbols;
     if (NeedSymbols) {
-      Expected<std::vector<unsigned>> SymbolsOrErr =
-          getSymbols(Buf, SymNames, HasObject);
-      if (auto E = SymbolsOrErr.takeError())
-        return std::move(E);
-      Symbols = std::move(*SymbolsOrErr);
+      MemberSymbols &Syms = AllSymbols[I];
+      uint64_t Base = SymNames.tell();
+      Symbols = std::move(Syms.Offsets);
+      for (unsigned &Offset : Symbols)
+        Offset += Base;
+      SymNames << Syms.Names;
+      HasObject |= Syms.HasObject;
+      // The names are in SymNames now.
+      std::string().swap(Syms.Names);
     }
 
     Pos += Header.size() + Data.size() + Padding.size();
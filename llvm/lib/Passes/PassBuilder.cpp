@@ -101,6 +101,7 @@
 #include "llvm/Transforms/IPO/ForceFunctionAttrs.h"
 #include "llvm/Transforms/IPO/FunctionAttrs.h"
 #include "llvm/Transforms/IPO/FunctionImport.h"
+#include "llvm/Transforms/IPO/FunctionPipelineCache.h"
 #include "llvm/Transforms/IPO/GlobalDCE.h"
 #include "llvm/Transforms/IPO/GlobalOpt.h"
 #include "llvm/Transforms/IPO/GlobalSplit.h"
@@ -256,6 +257,11 @@ cl::opt<bool> PrintPipelinePasses(
              "(best-effort only)."));
 } // namespace llvm
 
+static cl::opt<std::string> FunctionPipelineCacheDir(
+    "function-pipeline-cache-dir", cl::Hidden,
+    cl::desc("Directory in which cached-function(...) keeps the functions "
+             "its pipeline produced (experimental)"));
+
 namespace {
 
 // The following passes/analyses have custom names, otherwise their name will
@@ -372,6 +378,17 @@ bool shouldPopulateClassToPassNames() {
 
 } // namespace
 
+/// Returns what the functions in a function pipeline cache depend on besides
+/// their IR and the pipeline: the target's cost model steers what the passes
+/// do.
+std::string PassBuilder::getFunctionCacheExtraKey() const {
+  if (!TM)
+    return "";
+  return (Twine(TM->getTargetTriple().str()) + "," + TM->getTargetCPU() + "," +
+          TM->getTargetFeatureString())
+      .str();
+}
+
 PassBuilder::PassBuilder(TargetMachine *TM, PipelineTuningOptions PTO,
                          Optional<PGOOptions> PGOOpt,
                          PassInstrumentationCallbacks *PIC)
@@ -851,6 +868,8 @@ static bool isModulePassName(StringRef Name, CallbacksT &Callbacks) {
     return true;
   if (Name == "function" || Name == "function<eager-inv>")
     return true;
+  if (Name == "cached-function")
+    return true;
 
   // Explicitly handle custom-parsed pass names.
   if (parseRepeatPassName(Name))
@@ -1060,6 +1079,19 @@ Error PassBuilder::parseModulePass(ModulePassManager &MPM,
                                                     Name != "function"));
       return Error::success();
     }
+    if (Name == "cached-function") {
+      if (FunctionPipelineCacheDir.empty())
+        return make_error<StringError>(
+            "cached-function requires -function-pipeline-cache-dir",
+            inconvertibleErrorCode());
+      FunctionPassManager FPM;
+      if (auto Err = parseFunctionPassPipeline(FPM, InnerPipeline))
+        return Err;
+      MPM.addPass(createCachingModuleToFunctionPassAdaptor(
+          std::move(FPM), FunctionPipelineCacheDir,
+          getFunctionCacheExtraKey()));
+      return Error::success();
+    }
     if (auto Count = parseRepeatPassName(Name)) {
       ModulePassManager NestedMPM;
       if (auto Err = parseModulePassPipeline(NestedMPM, InnerPipeline))
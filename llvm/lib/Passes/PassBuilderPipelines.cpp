@@ -14,6 +14,7 @@
 ///
 //===----------------------------------------------------------------------===//
 
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Analysis/AliasAnalysis.h"
 #include "llvm/Analysis/BasicAliasAnalysis.h"
 #include "llvm/Analysis/CGSCCPassManager.h"
@@ -46,6 +47,7 @@
 #include "llvm/Transforms/IPO/ElimAvailExtern.h"
 #include "llvm/Transforms/IPO/ForceFunctionAttrs.h"
 #include "llvm/Transforms/IPO/FunctionAttrs.h"
+#include "llvm/Transforms/IPO/FunctionPipelineCache.h"
 #include "llvm/Transforms/IPO/GlobalDCE.h"
 #include "llvm/Transforms/IPO/GlobalOpt.h"
 #include "llvm/Transforms/IPO/GlobalSplit.h"
@@ -182,19 +184,6 @@ static cl::opt<bool> EnableMergeFunctions(
     "enable-merge-functions", cl::init(false), cl::Hidden,
     cl::desc("Enable function merging as part of the optimization pipeline"));
 
-PipelineTuningOptions::PipelineTuningOptions() {
-  LoopInterleaving = true;
-  LoopVectorization = true;
-  SLPVectorization = false;
-  LoopUnrolling = true;
-  ForgetAllSCEVInLoopUnroll = ForgetSCEVInLoopUnroll;
-  LicmMssaOptCap = SetLicmMssaOptCap;
-  LicmMssaNoAccForPromotionCap = SetLicmMssaNoAccForPromotionCap;
-  CallGraphProfile = true;
-  MergeFunctions = EnableMergeFunctions;
-  EagerlyInvalidateAnalyses = EnableEagerlyInvalidateAnalyses;
-}
-
 namespace llvm {
 
 extern cl::opt<unsigned> MaxDevirtIterations;
@@ -225,6 +214,20 @@ extern cl::opt<bool> DisablePreInliner;
 extern cl::opt<int> PreInlineThreshold;
 } // namespace llvm
 
+PipelineTuningOptions::PipelineTuningOptions() {
+  LoopInterleaving = true;
+  LoopVectorization = true;
+  SLPVectorization = false;
+  LoopUnrolling = true;
+  ForgetAllSCEVInLoopUnroll = ForgetSCEVInLoopUnroll;
+  LicmMssaOptCap = SetLicmMssaOptCap;
+  LicmMssaNoAccForPromotionCap = SetLicmMssaNoAccForPromotionCap;
+  CallGraphProfile = true;
+  MergeFunctions = EnableMergeFunctions;
+  EagerlyInvalidateAnalyses = EnableEagerlyInvalidateAnalyses;
+  NewGVN = RunNewGVN;
+}
+
 void PassBuilder::invokePeepholeEPCallbacks(FunctionPassManager &FPM,
                                             OptimizationLevel Level) {
   for (auto &C : PeepholeEPCallbacks)
@@ -238,6 +241,22 @@ static void addAnnotationRemarksPass(ModulePassManager &MPM) {
   MPM.addPass(createModuleToFunctionPassAdaptor(std::move(FPM)));
 }
 
+// Helper to add the pass that eliminates redundant instructions and loads.
+static void addGVNPasses(FunctionPassManager &FPM,
+                         const PipelineTuningOptions &PTO) {
+  if (!PTO.NewGVN) {
+    FPM.addPass(GVNPass());
+    return;
+  }
+
+  // NewGVN does no load PRE. GVNHoist hoists the loads and expressions that
+  // are redundant on every path from a branch, which covers common cases of
+  // it, and uses the MemorySSA that NewGVN builds rather than memdep.
+  FPM.addPass(NewGVNPass());
+  if (!EnableGVNHoist)
+    FPM.addPass(GVNHoistPass());
+}
+
 // Helper to check if the current compilation phase is preparing for LTO
 static bool isLTOPreLink(ThinOrFullLTOPhase Phase) {
   return Phase == ThinOrFullLTOPhase::ThinLTOPreLink ||
@@ -529,10 +548,7 @@ PassBuilder::buildFunctionSimplificationPipeline(OptimizationLevel Level,
 
   // Eliminate redundancies.
   FPM.addPass(MergedLoadStoreMotionPass());
-  if (RunNewGVN)
-    FPM.addPass(NewGVNPass());
-  else
-    FPM.addPass(GVNPass());
+  addGVNPasses(FPM, PTO);
 
   // Sparse conditional constant propagation.
   // FIXME: It isn't clear why we do this *after* loop passes rather than
@@ -656,6 +672,7 @@ void PassBuilder::addPGOInstrPasses(ModulePassManager &MPM,
   // Do counter promotion at Level greater than O0.
   Options.DoCounterPromotion = true;
   Options.UseBFIInPromotion = IsCS;
+  Options.Atomic = PGOOpt && PGOOpt->AtomicCounterUpdate;
   MPM.addPass(InstrProfiling(Options, IsCS));
 }
 
@@ -681,6 +698,7 @@ void PassBuilder::addPGOInstrPassesForO0(ModulePassManager &MPM,
   // Do not do counter promotion at O0.
   Options.DoCounterPromotion = false;
   Options.UseBFIInPromotion = IsCS;
+  Options.Atomic = PGOOpt && PGOOpt->AtomicCounterUpdate;
   MPM.addPass(InstrProfiling(Options, IsCS));
 }
 
@@ -1141,7 +1159,14 @@ PassBuilder::buildModuleOptimizationPipeline(OptimizationLevel Level,
   // information for all local globals here, the late loop passes and notably
   // the vectorizer will be able to use them to help recognize vectorizable
   // memory operations.
-  MPM.addPass(RequireAnalysisPass<GlobalsAA, Module>());
+  //
+  // GlobalsAA describes the whole module, which is not part of the key of the
+  // functions in the function cache, so when caching the function passes must
+  // not see it.
+  if (PTO.FunctionCacheDir.empty())
+    MPM.addPass(RequireAnalysisPass<GlobalsAA, Module>());
+  else
+    MPM.addPass(InvalidateAnalysisPass<GlobalsAA>());
 
   FunctionPassManager OptimizePM;
   OptimizePM.addPass(Float2IntPass());
@@ -1207,8 +1232,14 @@ PassBuilder::buildModuleOptimizationPipeline(OptimizationLevel Level,
   OptimizePM.addPass(CoroCleanupPass());
 
   // Add the core optimizing pipeline.
-  MPM.addPass(createModuleToFunctionPassAdaptor(std::move(OptimizePM),
-                                                PTO.EagerlyInvalidateAnalyses));
+  if (PTO.FunctionCacheDir.empty())
+    MPM.addPass(createModuleToFunctionPassAdaptor(
+        std::move(OptimizePM), PTO.EagerlyInvalidateAnalyses));
+  else
+    MPM.addPass(createCachingModuleToFunctionPassAdaptor(
+        std::move(OptimizePM), PTO.FunctionCacheDir,
+        getFunctionCacheExtraKey() + ",O" + utostr(Level.getSpeedupLevel()) +
+            "s" + utostr(Level.getSizeLevel())));
 
   for (auto &C : OptimizerLastEPCallbacks)
     C(MPM, Level);
@@ -1612,10 +1643,7 @@ PassBuilder::buildLTODefaultPipeline(OptimizationLevel Level,
       LICMPass(PTO.LicmMssaOptCap, PTO.LicmMssaNoAccForPromotionCap),
       /*USeMemorySSA=*/true, /*UseBlockFrequencyInfo=*/true));
 
-  if (RunNewGVN)
-    MainFPM.addPass(NewGVNPass());
-  else
-    MainFPM.addPass(GVNPass());
+  addGVNPasses(MainFPM, PTO);
 
   // Remove dead memcpy()'s.
   MainFPM.addPass(MemCpyOptPass());
@@ -38,10 +38,14 @@
 
 using namespace llvm;
 
+// Text profiles are parsed as null-terminated text. Indexed profiles are
+// binary and need no terminator, which lets a large one always be mapped, so
+// that the compiles using it share its pages instead of each reading a copy.
 static Expected<std::unique_ptr<MemoryBuffer>>
-setupMemoryBuffer(const Twine &Path) {
+setupMemoryBuffer(const Twine &Path, bool IsText = true) {
   ErrorOr<std::unique_ptr<MemoryBuffer>> BufferOrErr =
-      MemoryBuffer::getFileOrSTDIN(Path, /*IsText=*/true);
+      MemoryBuffer::getFileOrSTDIN(Path, IsText,
+                                   /*RequiresNullTerminator=*/IsText);
   if (std::error_code EC = BufferOrErr.getError())
     return errorCodeToError(EC);
   return std::move(BufferOrErr.get());
@@ -94,7 +98,7 @@ InstrProfReader::create(std::unique_ptr<MemoryBuffer> Buffer,
 Expected<std::unique_ptr<IndexedInstrProfReader>>
 IndexedInstrProfReader::create(const Twine &Path, const Twine &RemappingPath) {
   // Set up the buffer to read.
-  auto BufferOrError = setupMemoryBuffer(Path);
+  auto BufferOrError = setupMemoryBuffer(Path, /*IsText=*/false);
   if (Error E = BufferOrError.takeError())
     return std::move(E);
 
@@ -818,30 +818,41 @@ std::error_code SampleProfileReaderExtBinaryBase::readFuncProfiles() {
         }
       }
     } else {
+      // Look the functions of the module up in the offset table, and only
+      // scan the whole table when names have to go through the remapper.
+      // The profiles are then read in the order they are laid out in the
+      // section, so that a mapped profile is paged in front to back.
+      std::vector<uint64_t> Offsets;
+      Offsets.reserve(std::min<size_t>(FuncsToUse.size(),
+                                       FuncOffsetTable.size()));
       if (useMD5()) {
         for (auto Name : FuncsToUse) {
           auto GUID = std::to_string(MD5Hash(Name));
           auto iter = FuncOffsetTable.find(StringRef(GUID));
-          if (iter == FuncOffsetTable.end())
-            continue;
-          const uint8_t *FuncProfileAddr = Start + iter->second;
-          assert(FuncProfileAddr < End && "out of LBRProfile section");
-          if (std::error_code EC = readFuncProfile(FuncProfileAddr))
-            return EC;
+          if (iter != FuncOffsetTable.end())
+            Offsets.push_back(iter->second);
+        }
+      } else if (!Remapper) {
+        for (auto Name : FuncsToUse) {
+          auto iter = FuncOffsetTable.find(SampleContext(Name));
+          if (iter != FuncOffsetTable.end())
+            Offsets.push_back(iter->second);
         }
       } else {
-        for (auto NameOffset : FuncOffsetTable) {
-          SampleContext FContext(NameOffset.first);
-          auto FuncName = FContext.getName();
-          if (!FuncsToUse.count(FuncName) &&
-              (!Remapper || !Remapper->exist(FuncName)))
+        for (const auto &NameOffset : FuncOffsetTable) {
+          auto FuncName = NameOffset.first.getName();
+          if (!FuncsToUse.count(FuncName) && !Remapper->exist(FuncName))
             continue;
-          const uint8_t *FuncProfileAddr = Start + NameOffset.second;
-          assert(FuncProfileAddr < End && "out of LBRProfile section");
-          if (std::error_code EC = readFuncProfile(FuncProfileAddr))
-            return EC;
+          Offsets.push_back(NameOffset.second);
         }
       }
+      llvm::sort(Offsets);
+      for (uint64_t Offset : Offsets) {
+        const uint8_t *FuncProfileAddr = Start + Offset;
+        assert(FuncProfileAddr < End && "out of LBRProfile section");
+        if (std::error_code EC = readFuncProfile(FuncProfileAddr))
+          return EC;
+      }
     }
     Data = End;
   }
@@ -146,6 +146,17 @@ raw_ostream &operator<<(raw_ostream &OS, const PrintArg& Arg) {
   return OS;
 }
 
+// Options that have been constructed but not yet added to their subcommands,
+// linked through Option::NextPendingOption in construction order. Adding an
+// option hashes its name into the OptionsMap of every subcommand it belongs
+// to, and a tool links thousands of options whose constructors run before
+// main. Option::addArgument only appends the option to this list, and the
+// parser registers the pending options the first time it needs its maps. Both
+// are constant-initialized, so they are usable from the static constructors of
+// other translation units.
+static Option *PendingOptions = nullptr;
+static Option **PendingOptionsTail = &PendingOptions;
+
 class CommandLineParser {
 public:
   // Globals for name and overview of program.  Program name is not a string to
@@ -254,6 +265,21 @@ public:
     }
   }
 
+  // Adds the options constructed since the last call to their subcommands, in
+  // the order they were constructed. That order is the order in which
+  // positional arguments are assigned.
+  void registerPendingOptions() {
+    Option *O = PendingOptions;
+    PendingOptions = nullptr;
+    PendingOptionsTail = &PendingOptions;
+    while (O) {
+      Option *Next = O->NextPendingOption;
+      O->NextPendingOption = nullptr;
+      addOption(O);
+      O = Next;
+    }
+  }
+
   void addOption(Option *O, bool ProcessDefaultOption = false) {
     if (!ProcessDefaultOption && O->isDefaultOption()) {
       DefaultOptions.push_back(O);
@@ -302,6 +328,7 @@ public:
   }
 
   void removeOption(Option *O) {
+    registerPendingOptions();
     if (O->Subs.empty())
       removeOption(O, &*TopLevelSubCommand);
     else {
@@ -341,6 +368,7 @@ public:
   }
 
   void updateArgStr(Option *O, StringRef NewName) {
+    registerPendingOptions();
     if (O->Subs.empty())
       updateArgStr(O, NewName, &*TopLevelSubCommand);
     else {
@@ -416,6 +444,13 @@ public:
     registerSubCommand(&*AllSubCommands);
 
     DefaultOptions.clear();
+
+    // Like the registered options, the pending ones are forgotten.
+    while (Option *O = PendingOptions) {
+      PendingOptions = O->NextPendingOption;
+      O->NextPendingOption = nullptr;
+    }
+    PendingOptionsTail = &PendingOptions;
   }
 
 private:
@@ -445,7 +480,8 @@ extrahelp::extrahelp(StringRef Help) : morehelp(Help) {
 }
 
 void Option::addArgument() {
-  GlobalParser->addOption(this);
+  *PendingOptionsTail = this;
+  PendingOptionsTail = &NextPendingOption;
   FullyInitialized = true;
 }
 
@@ -1368,6 +1404,17 @@ void CommandLineParser::ResetAllOptionOccurrences() {
   // Reset all option values to look like they have never been seen before.
   // Options might be reset twice (they can be reference in both OptionsMap
   // and one of the other members), but that does not harm.
+  //
+  // Pending options have never been parsed, but their values may have been set
+  // directly, so they are reset too. This does not register them, which keeps
+  // tools that reset before every run from registering options they never
+  // parse. Resetting a cl::DefaultOption unregisters it and so registers the
+  // remaining pending options, which are then reset in the loop below.
+  for (Option *O = PendingOptions; O;) {
+    Option *Next = O->NextPendingOption;
+    O->reset();
+    O = Next;
+  }
   for (auto *SC : RegisteredSubCommands) {
     for (auto &O : SC->OptionsMap)
       O.second->reset();
@@ -1385,6 +1432,7 @@ bool CommandLineParser::ParseCommandLineOptions(int argc,
                                                 StringRef Overview,
                                                 raw_ostream *Errs,
                                                 bool LongOptionsUseDoubleDash) {
+  registerPendingOptions();
   assert(hasOptions() && "No options specified!");
 
   // Expand response files.
@@ -2250,6 +2298,7 @@ public:
   }
 
   void printHelp() {
+    GlobalParser->registerPendingOptions();
     SubCommand *Sub = GlobalParser->getActiveSubCommand();
     auto &OptionsMap = Sub->OptionsMap;
     auto &PositionalOpts = Sub->PositionalOpts;
@@ -2574,6 +2623,7 @@ static void initCommonOptions() {
   *CommonOptions;
   initDebugCounterOptions();
   initGraphWriterOptions();
+  initPerfCounterOptions();
   initSignalsOptions();
   initStatisticOptions();
   initTimerOptions();
@@ -2634,6 +2684,7 @@ void CommandLineParser::printOptionValues() {
   if (!CommonOptions->PrintOptions && !CommonOptions->PrintAllOptions)
     return;
 
+  registerPendingOptions();
   SmallVector<std::pair<const char *, Option *>, 128> Opts;
   sortOpts(ActiveSubCommand->OptionsMap, Opts, /*ShowHidden*/ true);
 
@@ -2673,6 +2724,7 @@ void cl::AddExtraVersionPrinter(VersionPrinterTy func) {
 
 StringMap<Option *> &cl::getRegisteredOptions(SubCommand &Sub) {
   initCommonOptions();
+  GlobalParser->registerPendingOptions();
   auto &Subs = GlobalParser->RegisteredSubCommands;
   (void)Subs;
   assert(is_contained(Subs, &Sub));
@@ -2686,6 +2738,7 @@ cl::getRegisteredSubcommands() {
 
 void cl::HideUnrelatedOptions(cl::OptionCategory &Category, SubCommand &Sub) {
   initCommonOptions();
+  GlobalParser->registerPendingOptions();
   for (auto &I : Sub.OptionsMap) {
     bool Unrelated = true;
     for (auto &Cat : I.second->Categories) {
@@ -2700,6 +2753,7 @@ void cl::HideUnrelatedOptions(cl::OptionCategory &Category, SubCommand &Sub) {
 void cl::HideUnrelatedOptions(ArrayRef<const cl::OptionCategory *> Categories,
                               SubCommand &Sub) {
   initCommonOptions();
+  GlobalParser->registerPendingOptions();
   for (auto &I : Sub.OptionsMap) {
     bool Unrelated = true;
     for (auto &Cat : I.second->Categories) {
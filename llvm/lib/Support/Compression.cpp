@@ -13,6 +13,7 @@
 #include "llvm/Support/Compression.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/ADT/Twine.h"
 #include "llvm/Config/config.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Error.h"
@@ -20,13 +21,19 @@
 #if LLVM_ENABLE_ZLIB
 #include <zlib.h>
 #endif
+#if LLVM_ENABLE_ZSTD
+#include <zstd.h>
+#endif
 
 using namespace llvm;
 
-#if LLVM_ENABLE_ZLIB
-static Error createError(StringRef Err) {
+#if LLVM_ENABLE_ZLIB || LLVM_ENABLE_ZSTD
+static Error createError(const Twine &Err) {
   return make_error<StringError>(Err, inconvertibleErrorCode());
 }
+#endif
+
+#if LLVM_ENABLE_ZLIB
 
 static StringRef convertZlibCodeToString(int Code) {
   switch (Code) {
@@ -104,3 +111,194 @@ uint32_t zlib::crc32(StringRef Buffer) {
   llvm_unreachable("zlib::crc32 is unavailable");
 }
 #endif
+
+#if LLVM_ENABLE_ZSTD
+static Error createZstdError(size_t Code) {
+  return createError(Twine("zstd error: ") + ZSTD_getErrorName(Code));
+}
+
+bool zstd::isAvailable() { return true; }
+
+Error zstd::compress(StringRef InputBuffer,
+                     SmallVectorImpl<char> &CompressedBuffer, int Level,
+                     unsigned Threads) {
+  ZSTD_CCtx *Ctx = ZSTD_createCCtx();
+  if (!Ctx)
+    report_bad_alloc_error("ZSTD_createCCtx failed");
+  ZSTD_CCtx_setParameter(Ctx, ZSTD_c_compressionLevel, Level);
+  // This fails if zstd was built without multithreading support, in which
+  // case we compress on the calling thread.
+  if (Threads)
+    ZSTD_CCtx_setParameter(Ctx, ZSTD_c_nbWorkers, Threads);
+
+  size_t CompressedSize = ::ZSTD_compressBound(InputBuffer.size());
+  CompressedBuffer.resize_for_overwrite(CompressedSize);
+  size_t Res = ::ZSTD_compress2(Ctx, CompressedBuffer.data(), CompressedSize,
+                                InputBuffer.data(), InputBuffer.size());
+  ZSTD_freeCCtx(Ctx);
+  if (ZSTD_isError(Res)) {
+    CompressedBuffer.clear();
+    return createZstdError(Res);
+  }
+  // Tell MemorySanitizer that zstd output buffer is fully initialized.
+  // This avoids a false report when running LLVM with uninstrumented zstd.
+  __msan_unpoison(CompressedBuffer.data(), Res);
+  CompressedBuffer.truncate(Res);
+  return Error::success();
+}
+
+Error zstd::uncompress(StringRef InputBuffer, char *UncompressedBuffer,
+                       size_t &UncompressedSize) {
+  size_t Res = ::ZSTD_decompress(UncompressedBuffer, UncompressedSize,
+                                 InputBuffer.data(), InputBuffer.size());
+  if (ZSTD_isError(Res))
+    return createZstdError(Res);
+  // Tell MemorySanitizer that zstd output buffer is fully initialized.
+  // This avoids a false report when running LLVM with uninstrumented zstd.
+  __msan_unpoison(UncompressedBuffer, Res);
+  UncompressedSize = Res;
+  return Error::success();
+}
+
+Error zstd::uncompress(StringRef InputBuffer,
+                       SmallVectorImpl<char> &UncompressedBuffer,
+                       size_t UncompressedSize) {
+  UncompressedBuffer.resize_for_overwrite(UncompressedSize);
+  Error E =
+      uncompress(InputBuffer, UncompressedBuffer.data(), UncompressedSize);
+  UncompressedBuffer.truncate(UncompressedSize);
+  return E;
+}
+
+struct zstd::StreamCompressor::Impl {
+  ZSTD_CCtx *Ctx;
+  ~Impl() { ZSTD_freeCCtx(Ctx); }
+
+  Error compress(ZSTD_inBuffer &In, SmallVectorImpl<char> &Out,
+                 ZSTD_EndDirective Mode) {
+    const size_t ChunkSize = ZSTD_CStreamOutSize();
+    for (;;) {
+      size_t OldSize = Out.size();
+      Out.resize_for_overwrite(OldSize + ChunkSize);
+      ZSTD_outBuffer Buf = {Out.data() + OldSize, ChunkSize, 0};
+      size_t Res = ZSTD_compressStream2(Ctx, &Buf, &In, Mode);
+      __msan_unpoison(Buf.dst, Buf.pos);
+      Out.truncate(OldSize + Buf.pos);
+      if (ZSTD_isError(Res)) {
+        ZSTD_CCtx_reset(Ctx, ZSTD_reset_session_only);
+        return createZstdError(Res);
+      }
+      // When ending the frame, a zero return value means that everything has
+      // been flushed. Otherwise we are done once all input is consumed.
+      if (Mode == ZSTD_e_end ? Res == 0 : In.pos == In.size)
+        return Error::success();
+    }
+  }
+};
+
+zstd::StreamCompressor::StreamCompressor(int Level, unsigned Threads)
+    : I(new Impl) {
+  I->Ctx = ZSTD_createCCtx();
+  if (!I->Ctx)
+    report_bad_alloc_error("ZSTD_createCCtx failed");
+  ZSTD_CCtx_setParameter(I->Ctx, ZSTD_c_compressionLevel, Level);
+  if (Threads)
+    ZSTD_CCtx_setParameter(I->Ctx, ZSTD_c_nbWorkers, Threads);
+}
+
+zstd::StreamCompressor::~StreamCompressor() = default;
+
+Error zstd::StreamCompressor::write(StringRef Input,
+                                    SmallVectorImpl<char> &Out) {
+  ZSTD_inBuffer In = {Input.data(), Input.size(), 0};
+  return I->compress(In, Out, ZSTD_e_continue);
+}
+
+Error zstd::StreamCompressor::finish(SmallVectorImpl<char> &Out) {
+  ZSTD_inBuffer In = {nullptr, 0, 0};
+  return I->compress(In, Out, ZSTD_e_end);
+}
+
+struct zstd::StreamDecompressor::Impl {
+  ZSTD_DCtx *Ctx;
+  // The last value returned by ZSTD_decompressStream, which is 0 when a frame
+  // has been completely decoded and flushed.
+  size_t LastRes = 0;
+  ~Impl() { ZSTD_freeDCtx(Ctx); }
+};
+
+zstd::StreamDecompressor::StreamDecompressor() : I(new Impl) {
+  I->Ctx = ZSTD_createDCtx();
+  if (!I->Ctx)
+    report_bad_alloc_error("ZSTD_createDCtx failed");
+}
+
+zstd::StreamDecompressor::~StreamDecompressor() = default;
+
+Error zstd::StreamDecompressor::write(StringRef Input,
+                                      SmallVectorImpl<char> &Out) {
+  const size_t ChunkSize = ZSTD_DStreamOutSize();
+  ZSTD_inBuffer In = {Input.data(), Input.size(), 0};
+  ZSTD_outBuffer Buf;
+  // Keep going while there is input left or the decompressor filled the whole
+  // output chunk, in which case it may still hold buffered data.
+  do {
+    size_t OldSize = Out.size();
+    Out.resize_for_overwrite(OldSize + ChunkSize);
+    Buf = {Out.data() + OldSize, ChunkSize, 0};
+    size_t Res = ZSTD_decompressStream(I->Ctx, &Buf, &In);
+    __msan_unpoison(Buf.dst, Buf.pos);
+    Out.truncate(OldSize + Buf.pos);
+    if (ZSTD_isError(Res)) {
+      ZSTD_DCtx_reset(I->Ctx, ZSTD_reset_session_only);
+      I->LastRes = 0;
+      return createZstdError(Res);
+    }
+    I->LastRes = Res;
+  } while (In.pos != In.size || Buf.pos == Buf.size);
+  return Error::success();
+}
+
+bool zstd::StreamDecompressor::isFinished() const { return I->LastRes == 0; }
+
+#else
+bool zstd::isAvailable() { return false; }
+Error zstd::compress(StringRef InputBuffer,
+                     SmallVectorImpl<char> &CompressedBuffer, int Level,
+                     unsigned Threads) {
+  llvm_unreachable("zstd::compress is unavailable");
+}
+Error zstd::uncompress(StringRef InputBuffer, char *UncompressedBuffer,
+                       size_t &UncompressedSize) {
+  llvm_unreachable("zstd::uncompress is unavailable");
+}
+Error zstd::uncompress(StringRef InputBuffer,
+                       SmallVectorImpl<char> &UncompressedBuffer,
+                       size_t UncompressedSize) {
+  llvm_unreachable("zstd::uncompress is unavailable");
+}
+struct zstd::StreamCompressor::Impl {};
+zstd::StreamCompressor::StreamCompressor(int Level, unsigned Threads) {
+  llvm_unreachable("zstd::StreamCompressor is unavailable");
+}
+zstd::StreamCompressor::~StreamCompressor() = default;
+Error zstd::StreamCompressor::write(StringRef Input,
+                                    SmallVectorImpl<char> &Out) {
+  llvm_unreachable("zstd::StreamCompressor is unavailable");
+}
+Error zstd::StreamCompressor::finish(SmallVectorImpl<char> &Out) {
+  llvm_unreachable("zstd::StreamCompressor is unavailable");
+}
+struct zstd::StreamDecompressor::Impl {};
+zstd::StreamDecompressor::StreamDecompressor() {
+  llvm_unreachable("zstd::StreamDecompressor is unavailable");
+}
+zstd::StreamDecompressor::~StreamDecompressor() = default;
+Error zstd::StreamDecompressor::write(StringRef Input,
+                                      SmallVectorImpl<char> &Out) {
+  llvm_unreachable("zstd::StreamDecompressor is unavailable");
+}
+bool zstd::StreamDecompressor::isFinished() const {
+  llvm_unreachable("zstd::StreamDecompressor is unavailable");
+}
+#endif
@@ -18,6 +18,7 @@ namespace llvm {
 // of eagerly loading everything on program startup.
 void initDebugCounterOptions();
 void initGraphWriterOptions();
+void initPerfCounterOptions();
 void initSignalsOptions();
 void initStatisticOptions();
 void initTimerOptions();
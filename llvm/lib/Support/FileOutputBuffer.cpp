@@ -65,6 +65,10 @@ public:
     consumeError(Temp.discard());
   }
 
+  void releasePages(size_t Offset, size_t Size) override {
+    Buffer.flushAndDontNeed(Offset, Size);
+  }
+
 private:
   fs::mapped_file_region Buffer;
   fs::TempFile Temp;
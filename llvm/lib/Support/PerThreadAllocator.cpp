@@ -0,0 +1,55 @@
+//===- PerThreadAllocator.cpp - Arena for concurrent allocation -----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/PerThreadAllocator.h"
+#include <mutex>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+// Hands out thread indices and takes them back when threads exit. It is
+// leaked so that threads that exit during or after static destruction can
+// still return their index.
+struct IndexPool {
+  std::mutex Mu;
+  unsigned NextIndex = 0;         // GUARDED_BY(Mu)
+  std::vector<unsigned> Released; // GUARDED_BY(Mu)
+
+  static IndexPool &get() {
+    static IndexPool *Pool = new IndexPool;
+    return *Pool;
+  }
+};
+
+struct ThreadIndex {
+  unsigned Index;
+
+  ThreadIndex() {
+    IndexPool &Pool = IndexPool::get();
+    std::lock_guard<std::mutex> Lock(Pool.Mu);
+    if (Pool.Released.empty()) {
+      Index = Pool.NextIndex++;
+    } else {
+      Index = Pool.Released.back();
+      Pool.Released.pop_back();
+    }
+  }
+
+  ~ThreadIndex() {
+    IndexPool &Pool = IndexPool::get();
+    std::lock_guard<std::mutex> Lock(Pool.Mu);
+    Pool.Released.push_back(Index);
+  }
+};
+} // namespace
+
+unsigned llvm::detail::getPerThreadAllocatorIndex() {
+  static thread_local ThreadIndex TI;
+  return TI.Index;
+}
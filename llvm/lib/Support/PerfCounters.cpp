@@ -0,0 +1,132 @@
+//===- PerfCounters.cpp - Hardware performance counters -------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/PerfCounters.h"
+#include "DebugOptions.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/ManagedStatic.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace llvm;
+
+namespace {
+struct CreateTrackPerfCounters {
+  static void *call() {
+    return new cl::opt<bool>(
+        "track-perf-counters",
+        cl::desc("Record hardware performance counters in -time-passes "
+                 "and -time-trace output (Linux only)"),
+        cl::Hidden);
+  }
+};
+} // namespace
+static ManagedStatic<cl::opt<bool>, CreateTrackPerfCounters> TrackPerfCounters;
+
+void llvm::initPerfCounterOptions() { *TrackPerfCounters; }
+
+bool llvm::perfCountersEnabled() { return *TrackPerfCounters; }
+
+#if defined(__linux__)
+
+namespace {
+/// The counters of one thread, opened as a single perf event group so that
+/// they are scheduled onto the PMU together and read with one system call.
+class PerfEventGroup {
+  enum { NumEvents = 4 };
+
+  /// The events, in the order of the fields of PerfCounterValues.
+  static constexpr uint64_t Events[NumEvents] = {
+      PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+      PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+
+  int FDs[NumEvents];
+  /// The position of each event in a group read, or -1 if the event could
+  /// not be opened.
+  int Slots[NumEvents];
+  int LeaderFD = -1;
+  unsigned NumOpen = 0;
+
+public:
+  PerfEventGroup() {
+    for (unsigned I = 0; I != NumEvents; ++I) {
+      perf_event_attr Attr = {};
+      Attr.size = sizeof(Attr);
+      Attr.type = PERF_TYPE_HARDWARE;
+      Attr.config = Events[I];
+      Attr.exclude_kernel = 1;
+      Attr.exclude_hv = 1;
+      Attr.read_format = PERF_FORMAT_GROUP;
+      FDs[I] = syscall(SYS_perf_event_open, &Attr, /*pid=*/0, /*cpu=*/-1,
+                       LeaderFD, /*flags=*/0);
+      Slots[I] = -1;
+      if (FDs[I] < 0)
+        continue;
+      if (LeaderFD < 0)
+        LeaderFD = FDs[I];
+      Slots[I] = NumOpen++;
+    }
+  }
+
+  ~PerfEventGroup() {
+    for (int FD : FDs)
+      if (FD >= 0)
+        ::close(FD);
+  }
+
+  bool isOpen() const { return LeaderFD >= 0; }
+
+  void read(PerfCounterValues &Values) const {
+    if (!isOpen())
+      return;
+    uint64_t Buffer[1 + NumEvents];
+    if (::read(LeaderFD, Buffer, sizeof(Buffer)) < ssize_t(sizeof(uint64_t)))
+      return;
+    auto Get = [&](unsigned I) -> uint64_t {
+      return Slots[I] >= 0 && uint64_t(Slots[I]) < Buffer[0]
+                 ? Buffer[1 + Slots[I]]
+                 : 0;
+    };
+    Values.Cycles = Get(0);
+    Values.Instructions = Get(1);
+    Values.CacheMisses = Get(2);
+    Values.BranchMisses = Get(3);
+  }
+};
+
+constexpr uint64_t PerfEventGroup::Events[];
+} // namespace
+
+static PerfEventGroup &getThreadGroup() {
+  static thread_local PerfEventGroup Group;
+  return Group;
+}
+
+bool llvm::perfCountersAvailable() { return getThreadGroup().isOpen(); }
+
+PerfCounterValues llvm::readPerfCounters() {
+  PerfCounterValues Values;
+  getThreadGroup().read(Values);
+  struct rusage RU;
+  if (::getrusage(RUSAGE_SELF, &RU) == 0)
+    Values.PeakRSS = uint64_t(RU.ru_maxrss) * 1024;
+  return Values;
+}
+
+#else
+
+bool llvm::perfCountersAvailable() { return false; }
+
+PerfCounterValues llvm::readPerfCounters() { return PerfCounterValues(); }
+
+#endif
@@ -16,11 +16,25 @@
 
 #include "llvm/Support/SHA1.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Compiler.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/Host.h"
 #include <string.h>
 
+// The SHA extensions are used if the host supports them: on x86 they are
+// detected at runtime, on AArch64 they must be enabled at compile time.
+#if (defined(__x86_64__) || defined(__i386__)) &&                              \
+    (defined(__GNUC__) || defined(__clang__))
+#define SHA1_X86_SHA
+#include <immintrin.h>
+#elif defined(__aarch64__) && !defined(__AARCH64EB__) &&                       \
+    (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+#define SHA1_ARM_SHA
+#include <arm_neon.h>
+#endif
+
 using namespace llvm;
 
 #if defined(BYTE_ORDER) && defined(BIG_ENDIAN) && BYTE_ORDER == BIG_ENDIAN
@@ -82,6 +96,211 @@ static inline void r4(uint32_t &A, uint32_t &B, uint32_t &C, uint32_t &D,
 #define SEED_3 0x10325476
 #define SEED_4 0xc3d2e1f0
 
+#ifdef SHA1_X86_SHA
+#define SHA1_TARGET __attribute__((target("sha,sse4.1,ssse3")))
+
+// Four rounds using the message words in Msg. E holds e for these rounds, and
+// ENext receives the value of ABCD that e of the next four rounds derives from.
+template <int Func>
+SHA1_TARGET LLVM_ATTRIBUTE_ALWAYS_INLINE static void
+rounds4(__m128i &ABCD, __m128i &E, __m128i &ENext, __m128i Msg) {
+  E = _mm_sha1nexte_epu32(E, Msg);
+  ENext = ABCD;
+  ABCD = _mm_sha1rnds4_epu32(ABCD, E, Func);
+}
+
+SHA1_TARGET static void hashBlocksX86(uint32_t *State, const uint8_t *Data,
+                                      size_t NumBlocks) {
+  // Reverses the bytes of the block, which puts the first big-endian word in
+  // the highest lane.
+  const __m128i Mask =
+      _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+  __m128i ABCD = _mm_shuffle_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(State)), 0x1B);
+  __m128i E0 = _mm_set_epi32(State[4], 0, 0, 0);
+  __m128i E1;
+
+  for (; NumBlocks; --NumBlocks, Data += 64) {
+    const __m128i *In = reinterpret_cast<const __m128i *>(Data);
+    __m128i ABCDSave = ABCD;
+    __m128i E0Save = E0;
+    __m128i M0 = _mm_shuffle_epi8(_mm_loadu_si128(In), Mask);
+    __m128i M1 = _mm_shuffle_epi8(_mm_loadu_si128(In + 1), Mask);
+    __m128i M2 = _mm_shuffle_epi8(_mm_loadu_si128(In + 2), Mask);
+    __m128i M3 = _mm_shuffle_epi8(_mm_loadu_si128(In + 3), Mask);
+
+    // Rounds 0-15. Each group of four rounds also computes part of the
+    // message words of the following groups.
+    E0 = _mm_add_epi32(E0, M0);
+    E1 = ABCD;
+    ABCD = _mm_sha1rnds4_epu32(ABCD, E0, 0);
+    rounds4<0>(ABCD, E1, E0, M1);
+    M0 = _mm_sha1msg1_epu32(M0, M1);
+    rounds4<0>(ABCD, E0, E1, M2);
+    M1 = _mm_sha1msg1_epu32(M1, M2);
+    M0 = _mm_xor_si128(M0, M2);
+    rounds4<0>(ABCD, E1, E0, M3);
+    M0 = _mm_sha1msg2_epu32(M0, M3);
+    M2 = _mm_sha1msg1_epu32(M2, M3);
+    M1 = _mm_xor_si128(M1, M3);
+
+    // Rounds 16-67. The message schedule repeats every four groups.
+#define SHA1_SCHEDULE(Cur, Next, Prev, Prev2)                                  \
+  Next = _mm_sha1msg2_epu32(Next, Cur);                                        \
+  Prev = _mm_sha1msg1_epu32(Prev, Cur);                                        \
+  Prev2 = _mm_xor_si128(Prev2, Cur);
+    rounds4<0>(ABCD, E0, E1, M0);
+    SHA1_SCHEDULE(M0, M1, M3, M2)
+    rounds4<1>(ABCD, E1, E0, M1);
+    SHA1_SCHEDULE(M1, M2, M0, M3)
+    rounds4<1>(ABCD, E0, E1, M2);
+    SHA1_SCHEDULE(M2, M3, M1, M0)
+    rounds4<1>(ABCD, E1, E0, M3);
+    SHA1_SCHEDULE(M3, M0, M2, M1)
+    rounds4<1>(ABCD, E0, E1, M0);
+    SHA1_SCHEDULE(M0, M1, M3, M2)
+    rounds4<1>(ABCD, E1, E0, M1);
+    SHA1_SCHEDULE(M1, M2, M0, M3)
+    rounds4<2>(ABCD, E0, E1, M2);
+    SHA1_SCHEDULE(M2, M3, M1, M0)
+    rounds4<2>(ABCD, E1, E0, M3);
+    SHA1_SCHEDULE(M3, M0, M2, M1)
+    rounds4<2>(ABCD, E0, E1, M0);
+    SHA1_SCHEDULE(M0, M1, M3, M2)
+    rounds4<2>(ABCD, E1, E0, M1);
+    SHA1_SCHEDULE(M1, M2, M0, M3)
+    rounds4<2>(ABCD, E0, E1, M2);
+    SHA1_SCHEDULE(M2, M3, M1, M0)
+    rounds4<3>(ABCD, E1, E0, M3);
+    SHA1_SCHEDULE(M3, M0, M2, M1)
+    rounds4<3>(ABCD, E0, E1, M0);
+    SHA1_SCHEDULE(M0, M1, M3, M2)
+#undef SHA1_SCHEDULE
+
+    // Rounds 68-79 only finish the last message words.
+    rounds4<3>(ABCD, E1, E0, M1);
+    M2 = _mm_sha1msg2_epu32(M2, M1);
+    M3 = _mm_xor_si128(M3, M1);
+    rounds4<3>(ABCD, E0, E1, M2);
+    M3 = _mm_sha1msg2_epu32(M3, M2);
+    rounds4<3>(ABCD, E1, E0, M3);
+
+    E0 = _mm_sha1nexte_epu32(E0, E0Save);
+    ABCD = _mm_add_epi32(ABCD, ABCDSave);
+  }
+
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(State),
+                   _mm_shuffle_epi32(ABCD, 0x1B));
+  State[4] = _mm_extract_epi32(E0, 3);
+}
+#undef SHA1_TARGET
+#endif
+
+#ifdef SHA1_ARM_SHA
+// Four rounds using the message words in Msg, with the round function of
+// rounds Func * 20 to Func * 20 + 19.
+template <int Func>
+LLVM_ATTRIBUTE_ALWAYS_INLINE static void
+rounds4(uint32x4_t &ABCD, uint32_t &E, uint32x4_t Msg, uint32_t K) {
+  uint32_t ENext = vsha1h_u32(vgetq_lane_u32(ABCD, 0));
+  uint32x4_t WK = vaddq_u32(Msg, vdupq_n_u32(K));
+  if (Func == 0)
+    ABCD = vsha1cq_u32(ABCD, E, WK);
+  else if (Func == 2)
+    ABCD = vsha1mq_u32(ABCD, E, WK);
+  else
+    ABCD = vsha1pq_u32(ABCD, E, WK);
+  E = ENext;
+}
+
+// Computes the message words of the group four groups after M0.
+LLVM_ATTRIBUTE_ALWAYS_INLINE static uint32x4_t
+schedule(uint32x4_t M0, uint32x4_t M1, uint32x4_t M2, uint32x4_t M3) {
+  return vsha1su1q_u32(vsha1su0q_u32(M0, M1, M2), M3);
+}
+
+static void hashBlocksArm(uint32_t *State, const uint8_t *Data,
+                          size_t NumBlocks) {
+  static const uint32_t K[] = {SHA1_K0, SHA1_K20, SHA1_K40, SHA1_K60};
+  uint32x4_t ABCD = vld1q_u32(State);
+  uint32_t E = State[4];
+
+  for (; NumBlocks; --NumBlocks, Data += 64) {
+    uint32x4_t ABCDSave = ABCD;
+    uint32_t ESave = E;
+    uint32x4_t M0 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(Data)));
+    uint32x4_t M1 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(Data + 16)));
+    uint32x4_t M2 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(Data + 32)));
+    uint32x4_t M3 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(Data + 48)));
+
+    // Each group of four rounds is followed by the computation of the
+    // message words four groups ahead, until all 80 words are known.
+    rounds4<0>(ABCD, E, M0, K[0]);
+    M0 = schedule(M0, M1, M2, M3);
+    rounds4<0>(ABCD, E, M1, K[0]);
+    M1 = schedule(M1, M2, M3, M0);
+    rounds4<0>(ABCD, E, M2, K[0]);
+    M2 = schedule(M2, M3, M0, M1);
+    rounds4<0>(ABCD, E, M3, K[0]);
+    M3 = schedule(M3, M0, M1, M2);
+    rounds4<0>(ABCD, E, M0, K[0]);
+    M0 = schedule(M0, M1, M2, M3);
+    rounds4<1>(ABCD, E, M1, K[1]);
+    M1 = schedule(M1, M2, M3, M0);
+    rounds4<1>(ABCD, E, M2, K[1]);
+    M2 = schedule(M2, M3, M0, M1);
+    rounds4<1>(ABCD, E, M3, K[1]);
+    M3 = schedule(M3, M0, M1, M2);
+    rounds4<1>(ABCD, E, M0, K[1]);
+    M0 = schedule(M0, M1, M2, M3);
+    rounds4<1>(ABCD, E, M1, K[1]);
+    M1 = schedule(M1, M2, M3, M0);
+    rounds4<2>(ABCD, E, M2, K[2]);
+    M2 = schedule(M2, M3, M0, M1);
+    rounds4<2>(ABCD, E, M3, K[2]);
+    M3 = schedule(M3, M0, M1, M2);
+    rounds4<2>(ABCD, E, M0, K[2]);
+    M0 = schedule(M0, M1, M2, M3);
+    rounds4<2>(ABCD, E, M1, K[2]);
+    M1 = schedule(M1, M2, M3, M0);
+    rounds4<2>(ABCD, E, M2, K[2]);
+    M2 = schedule(M2, M3, M0, M1);
+    rounds4<3>(ABCD, E, M3, K[3]);
+    M3 = schedule(M3, M0, M1, M2);
+    rounds4<3>(ABCD, E, M0, K[3]);
+    rounds4<3>(ABCD, E, M1, K[3]);
+    rounds4<3>(ABCD, E, M2, K[3]);
+    rounds4<3>(ABCD, E, M3, K[3]);
+
+    ABCD = vaddq_u32(ABCD, ABCDSave);
+    E += ESave;
+  }
+
+  vst1q_u32(State, ABCD);
+  State[4] = E;
+}
+#endif
+
+using HashBlocksFn = void (*)(uint32_t *State, const uint8_t *Data,
+                              size_t NumBlocks);
+
+// Returns a function that hashes whole blocks with the SHA extensions of the
+// host, or null if they are not available.
+static HashBlocksFn getHardwareHashBlocks() {
+  static const HashBlocksFn Fn = []() -> HashBlocksFn {
+#if defined(SHA1_X86_SHA)
+    StringMap<bool> Features;
+    if (sys::getHostCPUFeatures(Features) && Features.lookup("sha") &&
+        Features.lookup("sse4.1") && Features.lookup("ssse3"))
+      return hashBlocksX86;
+#elif defined(SHA1_ARM_SHA)
+    return hashBlocksArm;
+#endif
+    return nullptr;
+  }();
+  return Fn;
+}
+
 void SHA1::init() {
   InternalState.State[0] = SEED_0;
   InternalState.State[1] = SEED_1;
@@ -93,6 +312,14 @@ void SHA1::init() {
 }
 
 void SHA1::hashBlock() {
+  if (HashBlocksFn HashBlocks = getHardwareHashBlocks()) {
+    uint8_t Block[BLOCK_LENGTH];
+    for (size_t I = 0; I < BLOCK_LENGTH / 4; ++I)
+      support::endian::write32be(Block + I * 4, InternalState.Buffer.L[I]);
+    HashBlocks(InternalState.State, Block, 1);
+    return;
+  }
+
   uint32_t A = InternalState.State[0];
   uint32_t B = InternalState.State[1];
   uint32_t C = InternalState.State[2];
@@ -222,6 +449,16 @@ void SHA1::update(ArrayRef<uint8_t> Data) {
     Data = Data.drop_front(Remainder);
   }
 
+  // Hash whole blocks directly from the input if the host can.
+  if (Data.size() >= BLOCK_LENGTH) {
+    if (HashBlocksFn HashBlocks = getHardwareHashBlocks()) {
+      assert(InternalState.BufferOffset == 0);
+      size_t NumBlocks = Data.size() / BLOCK_LENGTH;
+      HashBlocks(InternalState.State, Data.data(), NumBlocks);
+      Data = Data.drop_front(NumBlocks * BLOCK_LENGTH);
+    }
+  }
+
   // Fast buffer filling for large inputs.
   while (Data.size() >= BLOCK_LENGTH) {
     assert(InternalState.BufferOffset == 0);
@@ -251,16 +488,17 @@ void SHA1::pad() {
   while (InternalState.BufferOffset != 56)
     addUncounted(0x00);
 
-  // Append length in the last 8 bytes
-  addUncounted(0); // We're only using 32 bit lengths
-  addUncounted(0); // But SHA-1 supports 64 bit lengths
-  addUncounted(0); // So zero pad the top bits
-  addUncounted(InternalState.ByteCount >> 29); // Shifting to multiply by 8
-  addUncounted(InternalState.ByteCount >>
-               21); // as SHA-1 supports bitstreams as well as
-  addUncounted(InternalState.ByteCount >> 13); // byte.
-  addUncounted(InternalState.ByteCount >> 5);
-  addUncounted(InternalState.ByteCount << 3);
+  uint64_t Len = InternalState.ByteCount << 3; // bit size
+
+  // Append length in the last 8 bytes big endian encoded
+  addUncounted(Len >> 56);
+  addUncounted(Len >> 48);
+  addUncounted(Len >> 40);
+  addUncounted(Len >> 32);
+  addUncounted(Len >> 24);
+  addUncounted(Len >> 16);
+  addUncounted(Len >> 8);
+  addUncounted(Len);
 }
 
 StringRef SHA1::final() {
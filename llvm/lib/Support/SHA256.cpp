@@ -21,11 +21,25 @@
 
 #include "llvm/Support/SHA256.h"
 #include "llvm/ADT/ArrayRef.h"
+#include "llvm/ADT/StringMap.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/Compiler.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/Host.h"
 #include <string.h>
 
+// The SHA extensions are used if the host supports them: on x86 they are
+// detected at runtime, on AArch64 they must be enabled at compile time.
+#if (defined(__x86_64__) || defined(__i386__)) &&                              \
+    (defined(__GNUC__) || defined(__clang__))
+#define SHA256_X86_SHA
+#include <immintrin.h>
+#elif defined(__aarch64__) && !defined(__AARCH64EB__) &&                       \
+    (defined(__ARM_FEATURE_CRYPTO) || defined(__ARM_FEATURE_SHA2))
+#define SHA256_ARM_SHA
+#include <arm_neon.h>
+#endif
+
 namespace llvm {
 
 #if defined(BYTE_ORDER) && defined(BIG_ENDIAN) && BYTE_ORDER == BIG_ENDIAN
@@ -52,6 +66,185 @@ namespace llvm {
     M1 += SIGMA_2(M2) + M3 + SIGMA_3(M4);                                      \
   } while (0);
 
+#if defined(SHA256_X86_SHA) || defined(SHA256_ARM_SHA)
+static const uint32_t K[64] = {
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1,
+    0x923F82A4, 0xAB1C5ED5, 0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3,
+    0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174, 0xE49B69C1, 0xEFBE4786,
+    0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147,
+    0x06CA6351, 0x14292967, 0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13,
+    0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85, 0xA2BFE8A1, 0xA81A664B,
+    0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A,
+    0x5B9CCA4F, 0x682E6FF3, 0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208,
+    0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2,
+};
+#endif
+
+#ifdef SHA256_X86_SHA
+#define SHA256_TARGET __attribute__((target("sha,sse4.1,ssse3")))
+
+// Four rounds using the message words in Msg, starting at round I.
+SHA256_TARGET LLVM_ATTRIBUTE_ALWAYS_INLINE static void
+rounds4(__m128i &ABEF, __m128i &CDGH, __m128i Msg, size_t I) {
+  const __m128i *Key = reinterpret_cast<const __m128i *>(K + I);
+  Msg = _mm_add_epi32(Msg, _mm_loadu_si128(Key));
+  CDGH = _mm_sha256rnds2_epu32(CDGH, ABEF, Msg);
+  ABEF = _mm_sha256rnds2_epu32(ABEF, CDGH, _mm_shuffle_epi32(Msg, 0x0E));
+}
+
+// Finishes the message words following Cur, of which Next holds the partial
+// result of sha256msg1.
+SHA256_TARGET LLVM_ATTRIBUTE_ALWAYS_INLINE static __m128i
+schedule(__m128i Next, __m128i Prev, __m128i Cur) {
+  Next = _mm_add_epi32(Next, _mm_alignr_epi8(Cur, Prev, 4));
+  return _mm_sha256msg2_epu32(Next, Cur);
+}
+
+SHA256_TARGET static void hashBlocksX86(uint32_t *State, const uint8_t *Data,
+                                        size_t NumBlocks) {
+  // Swaps the bytes of each 32-bit word.
+  const __m128i Mask =
+      _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+  // The round instructions take the state as ABEF and CDGH.
+  __m128i DCBA = _mm_loadu_si128(reinterpret_cast<const __m128i *>(State));
+  __m128i HGFE = _mm_loadu_si128(reinterpret_cast<const __m128i *>(State + 4));
+  __m128i CDAB = _mm_shuffle_epi32(DCBA, 0xB1);
+  __m128i EFGH = _mm_shuffle_epi32(HGFE, 0x1B);
+  __m128i ABEF = _mm_alignr_epi8(CDAB, EFGH, 8);
+  __m128i CDGH = _mm_blend_epi16(EFGH, CDAB, 0xF0);
+
+  for (; NumBlocks; --NumBlocks, Data += 64) {
+    const __m128i *In = reinterpret_cast<const __m128i *>(Data);
+    __m128i ABEFSave = ABEF;
+    __m128i CDGHSave = CDGH;
+    __m128i M0 = _mm_shuffle_epi8(_mm_loadu_si128(In), Mask);
+    __m128i M1 = _mm_shuffle_epi8(_mm_loadu_si128(In + 1), Mask);
+    __m128i M2 = _mm_shuffle_epi8(_mm_loadu_si128(In + 2), Mask);
+    __m128i M3 = _mm_shuffle_epi8(_mm_loadu_si128(In + 3), Mask);
+
+    // Each group of four rounds also computes part of the message words of
+    // the following groups.
+    rounds4(ABEF, CDGH, M0, 0);
+    rounds4(ABEF, CDGH, M1, 4);
+    M0 = _mm_sha256msg1_epu32(M0, M1);
+    rounds4(ABEF, CDGH, M2, 8);
+    M1 = _mm_sha256msg1_epu32(M1, M2);
+    rounds4(ABEF, CDGH, M3, 12);
+    M0 = schedule(M0, M2, M3);
+    M2 = _mm_sha256msg1_epu32(M2, M3);
+    for (size_t I = 16; I < 48; I += 16) {
+      rounds4(ABEF, CDGH, M0, I);
+      M1 = schedule(M1, M3, M0);
+      M3 = _mm_sha256msg1_epu32(M3, M0);
+      rounds4(ABEF, CDGH, M1, I + 4);
+      M2 = schedule(M2, M0, M1);
+      M0 = _mm_sha256msg1_epu32(M0, M1);
+      rounds4(ABEF, CDGH, M2, I + 8);
+      M3 = schedule(M3, M1, M2);
+      M1 = _mm_sha256msg1_epu32(M1, M2);
+      rounds4(ABEF, CDGH, M3, I + 12);
+      M0 = schedule(M0, M2, M3);
+      M2 = _mm_sha256msg1_epu32(M2, M3);
+    }
+    rounds4(ABEF, CDGH, M0, 48);
+    M1 = schedule(M1, M3, M0);
+    M3 = _mm_sha256msg1_epu32(M3, M0);
+    rounds4(ABEF, CDGH, M1, 52);
+    M2 = schedule(M2, M0, M1);
+    rounds4(ABEF, CDGH, M2, 56);
+    M3 = schedule(M3, M1, M2);
+    rounds4(ABEF, CDGH, M3, 60);
+
+    ABEF = _mm_add_epi32(ABEF, ABEFSave);
+    CDGH = _mm_add_epi32(CDGH, CDGHSave);
+  }
+
+  __m128i FEBA = _mm_shuffle_epi32(ABEF, 0x1B);
+  __m128i DCHG = _mm_shuffle_epi32(CDGH, 0xB1);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(State),
+                   _mm_blend_epi16(FEBA, DCHG, 0xF0));
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(State + 4),
+                   _mm_alignr_epi8(DCHG, FEBA, 8));
+}
+#undef SHA256_TARGET
+#endif
+
+#ifdef SHA256_ARM_SHA
+// Four rounds using the message words in Msg, starting at round I.
+LLVM_ATTRIBUTE_ALWAYS_INLINE static void
+rounds4(uint32x4_t &ABCD, uint32x4_t &EFGH, uint32x4_t Msg, size_t I) {
+  uint32x4_t WK = vaddq_u32(Msg, vld1q_u32(K + I));
+  uint32x4_t Save = ABCD;
+  ABCD = vsha256hq_u32(ABCD, EFGH, WK);
+  EFGH = vsha256h2q_u32(EFGH, Save, WK);
+}
+
+// Computes the message words of the group four groups after M0.
+LLVM_ATTRIBUTE_ALWAYS_INLINE static uint32x4_t
+schedule(uint32x4_t M0, uint32x4_t M1, uint32x4_t M2, uint32x4_t M3) {
+  return vsha256su1q_u32(vsha256su0q_u32(M0, M1), M2, M3);
+}
+
+static void hashBlocksArm(uint32_t *State, const uint8_t *Data,
+                          size_t NumBlocks) {
+  uint32x4_t ABCD = vld1q_u32(State);
+  uint32x4_t EFGH = vld1q_u32(State + 4);
+
+  for (; NumBlocks; --NumBlocks, Data += 64) {
+    uint32x4_t ABCDSave = ABCD;
+    uint32x4_t EFGHSave = EFGH;
+    uint32x4_t M0 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(Data)));
+    uint32x4_t M1 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(Data + 16)));
+    uint32x4_t M2 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(Data + 32)));
+    uint32x4_t M3 = vreinterpretq_u32_u8(vrev32q_u8(vld1q_u8(Data + 48)));
+
+    for (size_t I = 0; I < 48; I += 16) {
+      rounds4(ABCD, EFGH, M0, I);
+      M0 = schedule(M0, M1, M2, M3);
+      rounds4(ABCD, EFGH, M1, I + 4);
+      M1 = schedule(M1, M2, M3, M0);
+      rounds4(ABCD, EFGH, M2, I + 8);
+      M2 = schedule(M2, M3, M0, M1);
+      rounds4(ABCD, EFGH, M3, I + 12);
+      M3 = schedule(M3, M0, M1, M2);
+    }
+    rounds4(ABCD, EFGH, M0, 48);
+    rounds4(ABCD, EFGH, M1, 52);
+    rounds4(ABCD, EFGH, M2, 56);
+    rounds4(ABCD, EFGH, M3, 60);
+
+    ABCD = vaddq_u32(ABCD, ABCDSave);
+    EFGH = vaddq_u32(EFGH, EFGHSave);
+  }
+
+  vst1q_u32(State, ABCD);
+  vst1q_u32(State + 4, EFGH);
+}
+#endif
+
+using HashBlocksFn = void (*)(uint32_t *State, const uint8_t *Data,
+                              size_t NumBlocks);
+
+// Returns a function that hashes whole blocks with the SHA extensions of the
+// host, or null if they are not available.
+static HashBlocksFn getHardwareHashBlocks() {
+  static const HashBlocksFn Fn = []() -> HashBlocksFn {
+#if defined(SHA256_X86_SHA)
+    StringMap<bool> Features;
+    if (sys::getHostCPUFeatures(Features) && Features.lookup("sha") &&
+        Features.lookup("sse4.1") && Features.lookup("ssse3"))
+      return hashBlocksX86;
+#elif defined(SHA256_ARM_SHA)
+    return hashBlocksArm;
+#endif
+    return nullptr;
+  }();
+  return Fn;
+}
+
 void SHA256::init() {
   InternalState.State[0] = 0x6A09E667;
   InternalState.State[1] = 0xBB67AE85;
@@ -66,6 +259,14 @@ void SHA256::init() {
 }
 
 void SHA256::hashBlock() {
+  if (HashBlocksFn HashBlocks = getHardwareHashBlocks()) {
+    uint8_t Block[BLOCK_LENGTH];
+    for (size_t I = 0; I < BLOCK_LENGTH / 4; ++I)
+      support::endian::write32be(Block + I * 4, InternalState.Buffer.L[I]);
+    HashBlocks(InternalState.State, Block, 1);
+    return;
+  }
+
   uint32_t A = InternalState.State[0];
   uint32_t B = InternalState.State[1];
   uint32_t C = InternalState.State[2];
@@ -201,6 +402,16 @@ void SHA256::update(ArrayRef<uint8_t> Data) {
     Data = Data.drop_front(Remainder);
   }
 
+  // Hash whole blocks directly from the input if the host can.
+  if (Data.size() >= BLOCK_LENGTH) {
+    if (HashBlocksFn HashBlocks = getHardwareHashBlocks()) {
+      assert(InternalState.BufferOffset == 0);
+      size_t NumBlocks = Data.size() / BLOCK_LENGTH;
+      HashBlocks(InternalState.State, Data.data(), NumBlocks);
+      Data = Data.drop_front(NumBlocks * BLOCK_LENGTH);
+    }
+  }
+
   // Fast buffer filling for large inputs.
   while (Data.size() >= BLOCK_LENGTH) {
     assert(InternalState.BufferOffset == 0);
@@ -0,0 +1,121 @@
+//===- llvm/Support/SuffixArray.cpp - Implement Suffix Array ----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements the Suffix Array class.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/SuffixArray.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Parallel.h"
+#include <numeric>
+
+using namespace llvm;
+
+SuffixArray::SuffixArray(const std::vector<unsigned> &Str) : Str(Str) {
+  buildSuffixes();
+  buildLCP();
+  findRepeats();
+}
+
+void SuffixArray::buildSuffixes() {
+  unsigned N = Str.size();
+  Suffixes.resize(N);
+  std::iota(Suffixes.begin(), Suffixes.end(), 0);
+  if (N < 2)
+    return;
+
+  // Rank[I] orders the suffix starting at I by its first K elements. Each
+  // round sorts the suffixes by the ranks of their first K and next K
+  // elements, which orders them by their first 2 * K elements. A suffix that
+  // ends within the next K elements sorts before those that don't.
+  std::vector<unsigned> Rank(Str.begin(), Str.end());
+  std::vector<unsigned> NewRank(N);
+  for (unsigned K = 1;; K *= 2) {
+    auto Key = [&](unsigned I) {
+      return std::make_pair(Rank[I], I + K < N ? uint64_t(Rank[I + K]) + 1 : 0);
+    };
+    parallelSort(Suffixes, [&](unsigned L, unsigned R) {
+      return Key(L) < Key(R);
+    });
+
+    NewRank[Suffixes[0]] = 0;
+    for (unsigned I = 1; I != N; ++I)
+      NewRank[Suffixes[I]] = NewRank[Suffixes[I - 1]] +
+                             (Key(Suffixes[I - 1]) < Key(Suffixes[I]));
+    Rank.swap(NewRank);
+
+    // Once every suffix has a rank of its own, they are in their final order.
+    if (Rank[Suffixes[N - 1]] == N - 1 || K >= N)
+      break;
+  }
+}
+
+void SuffixArray::buildLCP() {
+  unsigned N = Str.size();
+  LCP.assign(N, 0);
+  std::vector<unsigned> Rank(N);
+  for (unsigned I = 0; I != N; ++I)
+    Rank[Suffixes[I]] = I;
+
+  // The suffix starting at I + 1 shares at least Len - 1 elements with the
+  // suffix before it, if the suffix starting at I shared Len with its own.
+  unsigned Len = 0;
+  for (unsigned I = 0; I != N; ++I) {
+    if (Rank[I] == 0) {
+      Len = 0;
+      continue;
+    }
+    unsigned Prev = Suffixes[Rank[I] - 1];
+    while (I + Len < N && Prev + Len < N && Str[I + Len] == Str[Prev + Len])
+      ++Len;
+    LCP[Rank[I]] = Len;
+    if (Len)
+      --Len;
+  }
+}
+
+void SuffixArray::findRepeats() {
+  unsigned N = Str.size();
+
+  // An LCP interval that is still open, with the suffixes that are leaves
+  // directly below the node it corresponds to.
+  struct Interval {
+    unsigned Lcp;
+    std::vector<unsigned> Leaves;
+  };
+  std::vector<Interval> Stack;
+  Stack.push_back({0, {}});
+
+  auto Close = [&]() {
+    Interval &I = Stack.back();
+    if (I.Lcp >= MinLength && I.Leaves.size() >= 2) {
+      llvm::sort(I.Leaves);
+      Repeats.push_back({I.Lcp, std::move(I.Leaves)});
+    }
+    Stack.pop_back();
+  };
+
+  // The node right above the leaf for Suffixes[I] is as deep as the longer of
+  // LCP[I] and LCP[I + 1]. When that is LCP[I + 1], its interval starts with
+  // this leaf.
+  for (unsigned I = 0; I != N; ++I) {
+    unsigned Left = LCP[I];
+    while (Stack.back().Lcp > Left)
+      Close();
+    if (Stack.back().Lcp < Left)
+      Stack.push_back({Left, {}});
+    unsigned Right = I + 1 < N ? LCP[I + 1] : 0;
+    if (Right <= Left)
+      Stack.back().Leaves.push_back(Suffixes[I]);
+    else
+      Stack.push_back({Right, {Suffixes[I]}});
+  }
+  while (Stack.size() > 1)
+    Close();
+}
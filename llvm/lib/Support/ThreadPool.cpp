@@ -6,95 +6,236 @@
 //
 //===----------------------------------------------------------------------===//
 //
-// This file implements a crude C++11 based thread pool.
+// This file implements a work-stealing C++11 based thread pool.
 //
 //===----------------------------------------------------------------------===//
 
 #include "llvm/Support/ThreadPool.h"
 
 #include "llvm/Config/llvm-config.h"
+#include "llvm/Support/Compiler.h"
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/raw_ostream.h"
 
 using namespace llvm;
 
+// Takes the first task of Group, or any task if Group is null, from the front
+// or the back of a queue.
+template <typename TaskT>
+static bool takeTask(std::deque<TaskT> &Queue, ThreadPoolTaskGroup *Group,
+                     bool FromBack, TaskT &T) {
+  auto Matches = [&](const TaskT &Candidate) {
+    return !Group || Candidate.Group == Group;
+  };
+  if (FromBack) {
+    auto It = std::find_if(Queue.rbegin(), Queue.rend(), Matches);
+    if (It == Queue.rend())
+      return false;
+    T = std::move(*It);
+    Queue.erase(std::next(It).base());
+    return true;
+  }
+  auto It = std::find_if(Queue.begin(), Queue.end(), Matches);
+  if (It == Queue.end())
+    return false;
+  T = std::move(*It);
+  Queue.erase(It);
+  return true;
+}
+
 #if LLVM_ENABLE_THREADS
 
+struct ThreadPool::WorkQueue {
+  std::mutex Lock;
+  std::deque<Task> Tasks[NumPriorities];
+  /// The number of tasks in Tasks, readable without Lock.
+  std::atomic<unsigned> Size{0};
+};
+
+// The pool and the index of the worker thread that is running this thread.
+static LLVM_THREAD_LOCAL ThreadPool *CurrentPool = nullptr;
+static LLVM_THREAD_LOCAL unsigned CurrentWorker = 0;
+
 ThreadPool::ThreadPool(ThreadPoolStrategy S)
-    : Strategy(S), MaxThreadCount(S.compute_thread_count()) {}
+    : Strategy(S), MaxThreadCount(S.compute_thread_count()) {
+  Queues.reset(new WorkQueue[MaxThreadCount + 1]);
+  for (std::atomic<unsigned> &Count : QueuedTasks)
+    Count = 0;
+}
 
 void ThreadPool::grow(int requested) {
-  std::unique_lock<std::mutex> LockGuard(ThreadsLock);
-  if (Threads.size() >= MaxThreadCount)
+  if (NumThreads >= MaxThreadCount)
     return; // Already hit the max thread pool size.
+  std::unique_lock<std::mutex> LockGuard(ThreadsLock);
   int newThreadCount = std::min<int>(requested, MaxThreadCount);
   while (static_cast<int>(Threads.size()) < newThreadCount) {
     int ThreadID = Threads.size();
     Threads.emplace_back([this, ThreadID] {
       Strategy.apply_thread_strategy(ThreadID);
-      while (true) {
-        std::function<void()> Task;
-        {
-          std::unique_lock<std::mutex> LockGuard(QueueLock);
-          // Wait for tasks to be pushed in the queue
-          QueueCondition.wait(LockGuard,
-                              [&] { return !EnableFlag || !Tasks.empty(); });
-          // Exit condition
-          if (!EnableFlag && Tasks.empty())
-            return;
-          // Yeah, we have a task, grab it and release the lock on the queue
-
-          // We first need to signal that we are active before popping the queue
-          // in order for wait() to properly detect that even if the queue is
-          // empty, there is still a task in flight.
-          ++ActiveThreads;
-          Task = std::move(Tasks.front());
-          Tasks.pop();
-        }
-        // Run the task we just grabbed
-        Task();
-
-        bool Notify;
-        {
-          // Adjust `ActiveThreads`, in case someone waits on ThreadPool::wait()
-          std::lock_guard<std::mutex> LockGuard(QueueLock);
-          --ActiveThreads;
-          Notify = workCompletedUnlocked();
-        }
-        // Notify task completion if this is the last active thread, in case
-        // someone waits on ThreadPool::wait().
-        if (Notify)
-          CompletionCondition.notify_all();
-      }
+      processTasks(ThreadID);
     });
+    NumThreads = Threads.size();
+  }
+}
+
+void ThreadPool::enqueue(std::function<void()> Fn, ThreadPoolTaskGroup *Group) {
+  // Don't allow enqueueing after disabling the pool
+  assert(EnableFlag && "Queuing a thread during ThreadPool destruction");
+
+  unsigned Prio = unsigned(Group ? Group->Prio : Priority::Normal);
+  unsigned Outstanding = ++OutstandingTasks;
+  if (Group)
+    ++Group->OutstandingTasks;
+
+  // Workers queue tasks locally; everyone else uses the shared queue.
+  WorkQueue &Queue = Queues[CurrentPool == this ? CurrentWorker + 1 : 0];
+  {
+    std::lock_guard<std::mutex> LockGuard(Queue.Lock);
+    Queue.Tasks[Prio].push_back({std::move(Fn), Group});
+    ++Queue.Size;
+    ++QueuedTasks[Prio];
+    ++TotalQueuedTasks;
+    if (Group)
+      ++Group->QueuedTasks;
+  }
+
+  // Wake up an idle worker. Worker threads waiting for the group sleep on
+  // another condition, and they may want to run the task themselves.
+  if (NumSleeping) {
+    { std::lock_guard<std::mutex> LockGuard(SleepLock); }
+    SleepCondition.notify_one();
+  }
+  if (Group && Group->NumWaiters)
+    notifyCompletion();
+  grow(Outstanding);
+}
+
+bool ThreadPool::popTask(int WorkerIndex, ThreadPoolTaskGroup *Group,
+                         Task &T) {
+  // Look at the thread's own queue first, taking the newest task, which is the
+  // most likely to have its data in cache. Then take the oldest task of the
+  // other queues in round-robin order. Tasks of a group all have the priority
+  // of the group.
+  unsigned NumQueues = MaxThreadCount + 1;
+  unsigned Own = WorkerIndex + 1;
+  unsigned Begin = Group ? unsigned(Group->Prio) : 0;
+  unsigned End = Group ? Begin + 1 : NumPriorities;
+  for (unsigned Prio = Begin; Prio < End; ++Prio) {
+    if (!QueuedTasks[Prio])
+      continue;
+    for (unsigned I = 0; I < NumQueues; ++I) {
+      WorkQueue &Queue = Queues[(Own + I) % NumQueues];
+      if (!Queue.Size)
+        continue;
+      std::lock_guard<std::mutex> LockGuard(Queue.Lock);
+      bool FromBack = I == 0 && WorkerIndex >= 0;
+      if (takeTask(Queue.Tasks[Prio], Group, FromBack, T)) {
+        --Queue.Size;
+        --QueuedTasks[Prio];
+        --TotalQueuedTasks;
+        if (T.Group)
+          --T.Group->QueuedTasks;
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+void ThreadPool::runTask(Task &T) {
+  T.Fn();
+
+  // A group may be destroyed as soon as its last task completes, so do not
+  // touch it after that.
+  bool Notify = T.Group && --T.Group->OutstandingTasks == 0;
+  if (--OutstandingTasks == 0)
+    Notify = true;
+  if (Notify)
+    notifyCompletion();
+}
+
+void ThreadPool::notifyCompletion() {
+  // Taking the lock makes sure that a thread between checking its wait
+  // condition and going to sleep does not miss the notification.
+  { std::lock_guard<std::mutex> LockGuard(CompletionLock); }
+  CompletionCondition.notify_all();
+}
+
+void ThreadPool::processTasks(unsigned WorkerIndex) {
+  CurrentPool = this;
+  CurrentWorker = WorkerIndex;
+  while (true) {
+    Task T;
+    if (popTask(WorkerIndex, nullptr, T)) {
+      runTask(T);
+      continue;
+    }
+
+    // Wait for tasks to be pushed in the queues
+    std::unique_lock<std::mutex> LockGuard(SleepLock);
+    ++NumSleeping;
+    SleepCondition.wait(LockGuard,
+                        [&] { return !EnableFlag || TotalQueuedTasks; });
+    --NumSleeping;
+    // Exit condition
+    if (!EnableFlag && !TotalQueuedTasks)
+      return;
   }
 }
 
 void ThreadPool::wait() {
+  assert(!isWorkerThread() && "waiting for the pool from one of its threads");
   // Wait for all threads to complete and the queue to be empty
-  std::unique_lock<std::mutex> LockGuard(QueueLock);
-  CompletionCondition.wait(LockGuard, [&] { return workCompletedUnlocked(); });
+  std::unique_lock<std::mutex> LockGuard(CompletionLock);
+  CompletionCondition.wait(LockGuard, [&] { return !OutstandingTasks; });
 }
 
-bool ThreadPool::isWorkerThread() const {
-  std::unique_lock<std::mutex> LockGuard(ThreadsLock);
-  llvm::thread::id CurrentThreadId = llvm::this_thread::get_id();
-  for (const llvm::thread &Thread : Threads)
-    if (CurrentThreadId == Thread.get_id())
-      return true;
-  return false;
+void ThreadPool::wait(ThreadPoolTaskGroup &Group) {
+  if (!isWorkerThread()) {
+    std::unique_lock<std::mutex> LockGuard(CompletionLock);
+    CompletionCondition.wait(LockGuard,
+                             [&] { return !Group.OutstandingTasks; });
+    return;
+  }
+
+  // A worker thread must not block while tasks of the group are queued, since
+  // all other workers may be waiting too. Run them here. Once none are left,
+  // the remaining tasks of the group are running on other threads; sleep until
+  // they complete or one of them queues another task of the group.
+  while (Group.OutstandingTasks) {
+    Task T;
+    if (popTask(CurrentWorker, &Group, T)) {
+      runTask(T);
+      continue;
+    }
+    std::unique_lock<std::mutex> LockGuard(CompletionLock);
+    ++Group.NumWaiters;
+    CompletionCondition.wait(LockGuard, [&] {
+      return !Group.OutstandingTasks || Group.QueuedTasks;
+    });
+    --Group.NumWaiters;
+  }
 }
 
+bool ThreadPool::isWorkerThread() const { return CurrentPool == this; }
+
 // The destructor joins all threads, waiting for completion.
 ThreadPool::~ThreadPool() {
   {
-    std::unique_lock<std::mutex> LockGuard(QueueLock);
+    std::unique_lock<std::mutex> LockGuard(SleepLock);
     EnableFlag = false;
   }
-  QueueCondition.notify_all();
+  SleepCondition.notify_all();
   std::unique_lock<std::mutex> LockGuard(ThreadsLock);
-  for (auto &Worker : Threads)
-    Worker.join();
+  llvm::thread::id CurrentThreadId = llvm::this_thread::get_id();
+  for (auto &Worker : Threads) {
+    // A pool can be destroyed by one of its tasks, e.g. when the program
+    // exits from a task.
+    if (Worker.get_id() == CurrentThreadId)
+      Worker.detach();
+    else
+      Worker.join();
+  }
 }
 
 #else // LLVM_ENABLE_THREADS Disabled
@@ -108,15 +249,38 @@ ThreadPool::ThreadPool(ThreadPoolStrategy S) : MaxThreadCount(1) {
   }
 }
 
+void ThreadPool::enqueue(std::function<void()> Fn, ThreadPoolTaskGroup *Group) {
+  if (Group) {
+    ++Group->OutstandingTasks;
+    ++Group->QueuedTasks;
+  }
+  Tasks.push_back({std::move(Fn), Group});
+}
+
+void ThreadPool::runTask(Task &T) {
+  if (T.Group)
+    --T.Group->QueuedTasks;
+  T.Fn();
+  if (T.Group)
+    --T.Group->OutstandingTasks;
+}
+
 void ThreadPool::wait() {
   // Sequential implementation running the tasks
   while (!Tasks.empty()) {
-    auto Task = std::move(Tasks.front());
-    Tasks.pop();
-    Task();
+    Task T = std::move(Tasks.front());
+    Tasks.pop_front();
+    runTask(T);
   }
 }
 
+void ThreadPool::wait(ThreadPoolTaskGroup &Group) {
+  // Sequential implementation running the tasks of the group
+  Task T;
+  while (takeTask(Tasks, &Group, /*FromBack=*/false, T))
+    runTask(T);
+}
+
 bool ThreadPool::isWorkerThread() const {
   report_fatal_error("LLVM compiled without multithreading");
 }
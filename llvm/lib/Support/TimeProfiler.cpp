@@ -15,12 +15,17 @@
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/JSON.h"
+#include "llvm/Support/MathExtras.h"
 #include "llvm/Support/Path.h"
+#include "llvm/Support/PerfCounters.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Threading.h"
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <cstring>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -51,6 +56,9 @@ struct Entry {
   TimePointType End;
   const std::string Name;
   const std::string Detail;
+  // The counters when the section began, and once it has ended, the counts
+  // for the section.
+  PerfCounterValues Counters;
 
   Entry(TimePointType &&S, TimePointType &&E, std::string &&N, std::string &&Dt)
       : Start(std::move(S)), End(std::move(E)), Name(std::move(N)),
@@ -71,25 +79,92 @@ struct Entry {
         .count();
   }
 };
+
+// A section recorded in ring-buffer mode. Records have a fixed size and refer
+// to their name by an interned id, so beginning and ending a section does not
+// allocate. The detail is truncated to what fits in the record.
+struct RingEntry {
+  TimePointType Start;
+  TimePointType End;
+  uint32_t NameId;
+  uint8_t DetailSize;
+  char Detail[64 - 2 * sizeof(TimePointType) - sizeof(uint32_t) -
+              sizeof(uint8_t)];
+
+  StringRef getDetail() const { return StringRef(Detail, DetailSize); }
+};
+
+// Section names seen in ring-buffer mode, shared by all threads. Each thread
+// caches the ids it has looked up, so the lock is only taken the first time a
+// thread sees a name.
+struct NameTable {
+  std::mutex Mu;
+  StringMap<uint32_t> Ids;      // GUARDED_BY(Mu)
+  std::vector<StringRef> Names; // GUARDED_BY(Mu)
+
+  uint32_t intern(StringRef Name) {
+    std::lock_guard<std::mutex> Lock(Mu);
+    auto It = Ids.try_emplace(Name, Names.size());
+    if (It.second)
+      Names.push_back(It.first->getKey());
+    return It.first->getValue();
+  }
+};
 } // namespace
 
+static ManagedStatic<NameTable> InternedNames;
+
 struct llvm::TimeTraceProfiler {
-  TimeTraceProfiler(unsigned TimeTraceGranularity = 0, StringRef ProcName = "")
+  TimeTraceProfiler(unsigned TimeTraceGranularity = 0, StringRef ProcName = "",
+                    size_t RingBufferSize = 0)
       : BeginningOfTime(system_clock::now()), StartTime(steady_clock::now()),
         ProcName(ProcName), Pid(sys::Process::getProcessId()),
-        Tid(llvm::get_threadid()), TimeTraceGranularity(TimeTraceGranularity) {
+        Tid(llvm::get_threadid()), TimeTraceGranularity(TimeTraceGranularity),
+        TrackPerfCounters(perfCountersEnabled()) {
     llvm::get_thread_name(ThreadName);
+    if (RingBufferSize) {
+      RingSize = PowerOf2Ceil(RingBufferSize);
+      Ring.reset(new RingEntry[RingSize]);
+    }
   }
 
+  bool isRingBuffer() const { return RingSize != 0; }
+
   void begin(std::string Name, llvm::function_ref<std::string()> Detail) {
     Stack.emplace_back(steady_clock::now(), TimePointType(), std::move(Name),
                        Detail());
+    if (TrackPerfCounters)
+      Stack.back().Counters = readPerfCounters();
+  }
+
+  void beginRing(StringRef Name, StringRef Detail) {
+    RingStack.emplace_back();
+    RingEntry &E = RingStack.back();
+    E.NameId = getNameId(Name);
+    E.DetailSize = std::min(Detail.size(), sizeof(E.Detail));
+    memcpy(E.Detail, Detail.data(), E.DetailSize);
+    E.Start = steady_clock::now();
+  }
+
+  uint32_t getNameId(StringRef Name) {
+    auto It = NameIds.try_emplace(Name, 0);
+    if (It.second)
+      It.first->second = InternedNames->intern(Name);
+    return It.first->second;
   }
 
   void end() {
+    if (isRingBuffer())
+      return endRing();
+
     assert(!Stack.empty() && "Must call begin() first");
     Entry &E = Stack.back();
     E.End = steady_clock::now();
+    if (TrackPerfCounters) {
+      PerfCounterValues Now = readPerfCounters();
+      Now -= E.Counters;
+      E.Counters = Now;
+    }
 
     // Check that end times monotonically increase.
     assert((Entries.empty() ||
@@ -120,6 +195,43 @@ struct llvm::TimeTraceProfiler {
     Stack.pop_back();
   }
 
+  void endRing() {
+    assert(!RingStack.empty() && "Must call begin() first");
+    RingEntry &E = RingStack.back();
+    E.End = steady_clock::now();
+    DurationType Duration = E.End - E.Start;
+
+    // Publish the record after it has been written, so that a reader that
+    // acquires RingHead sees complete records. There is only one writer.
+    if (duration_cast<microseconds>(Duration).count() >= TimeTraceGranularity) {
+      uint64_t Head = RingHead.load(std::memory_order_relaxed);
+      Ring[Head & (RingSize - 1)] = E;
+      RingHead.store(Head + 1, std::memory_order_release);
+    }
+
+    // Totals are kept per name id and, unlike the records themselves, are
+    // never overwritten. As above, only the topmost section of each name
+    // counts.
+    if (llvm::none_of(
+            llvm::drop_begin(llvm::reverse(RingStack)),
+            [&](const RingEntry &Val) { return Val.NameId == E.NameId; })) {
+      if (E.NameId >= TotalsById.size())
+        TotalsById.resize(E.NameId + 1);
+      TotalsById[E.NameId].first++;
+      TotalsById[E.NameId].second += Duration;
+    }
+
+    RingStack.pop_back();
+  }
+
+  // Calls F on the records that are still in the ring buffer, oldest first.
+  template <typename Fn> void forEachRingEntry(Fn F) const {
+    uint64_t Head = RingHead.load(std::memory_order_acquire);
+    uint64_t First = Head > RingSize ? Head - RingSize : 0;
+    for (uint64_t I = First; I != Head; ++I)
+      F(Ring[I & (RingSize - 1)]);
+  }
+
   // Write events from this TimeTraceProfilerInstance and
   // ThreadTimeTraceProfilerInstances.
   void write(raw_pwrite_stream &OS) {
@@ -127,19 +239,37 @@ struct llvm::TimeTraceProfiler {
     std::lock_guard<std::mutex> Lock(Mu);
     assert(Stack.empty() &&
            "All profiler sections should be ended when calling write");
+    assert(RingStack.empty() &&
+           "All profiler sections should be ended when calling write");
     assert(llvm::all_of(*ThreadTimeTraceProfilerInstances,
-                        [](const auto &TTP) { return TTP->Stack.empty(); }) &&
+                        [](const auto &TTP) {
+                          return TTP->Stack.empty() && TTP->RingStack.empty();
+                        }) &&
            "All profiler sections should be ended when calling write");
 
+    // Ring-buffer records only hold name ids. The table only grows, so the
+    // names stay valid after the lock is released.
+    std::vector<StringRef> Names;
+    {
+      std::lock_guard<std::mutex> Lock(InternedNames->Mu);
+      Names = InternedNames->Names;
+    }
+
     json::OStream J(OS);
     J.objectBegin();
     J.attributeBegin("traceEvents");
     J.arrayBegin();
 
     // Emit all events for the main flame graph.
-    auto writeEvent = [&](const auto &E, uint64_t Tid) {
-      auto StartUs = E.getFlameGraphStartUs(StartTime);
-      auto DurUs = E.getFlameGraphDurUs();
+    auto writeEvent = [&](TimePointType Start, TimePointType End,
+                          StringRef Name, StringRef Detail, uint64_t Tid,
+                          const PerfCounterValues *Counters) {
+      auto StartUs = (time_point_cast<microseconds>(Start) -
+                      time_point_cast<microseconds>(StartTime))
+                         .count();
+      auto DurUs = (time_point_cast<microseconds>(End) -
+                    time_point_cast<microseconds>(Start))
+                       .count();
 
       J.object([&] {
         J.attribute("pid", Pid);
@@ -147,17 +277,35 @@ struct llvm::TimeTraceProfiler {
         J.attribute("ph", "X");
         J.attribute("ts", StartUs);
         J.attribute("dur", DurUs);
-        J.attribute("name", E.Name);
-        if (!E.Detail.empty()) {
-          J.attributeObject("args", [&] { J.attribute("detail", E.Detail); });
+        J.attribute("name", Name);
+        if (!Detail.empty() || Counters) {
+          J.attributeObject("args", [&] {
+            if (!Detail.empty())
+              J.attribute("detail", Detail);
+            if (Counters) {
+              J.attribute("cycles", int64_t(Counters->Cycles));
+              J.attribute("instructions", int64_t(Counters->Instructions));
+              J.attribute("cache-misses", int64_t(Counters->CacheMisses));
+              J.attribute("branch-misses", int64_t(Counters->BranchMisses));
+              J.attribute("peak-rss", int64_t(Counters->PeakRSS));
+            }
+          });
         }
       });
     };
-    for (const Entry &E : Entries)
-      writeEvent(E, this->Tid);
+    // Ring-buffer records are fixed-size and carry no counters.
+    auto writeEvents = [&](const TimeTraceProfiler &TTP) {
+      for (const Entry &E : TTP.Entries)
+        writeEvent(E.Start, E.End, E.Name, E.Detail, TTP.Tid,
+                   TTP.TrackPerfCounters ? &E.Counters : nullptr);
+      TTP.forEachRingEntry([&](const RingEntry &E) {
+        writeEvent(E.Start, E.End, Names[E.NameId], E.getDetail(), TTP.Tid,
+                   nullptr);
+      });
+    };
+    writeEvents(*this);
     for (const TimeTraceProfiler *TTP : *ThreadTimeTraceProfilerInstances)
-      for (const Entry &E : TTP->Entries)
-        writeEvent(E, TTP->Tid);
+      writeEvents(*TTP);
 
     // Emit totals by section name as additional "thread" events, sorted from
     // longest one.
@@ -168,18 +316,21 @@ struct llvm::TimeTraceProfiler {
 
     // Combine all CountAndTotalPerName from threads into one.
     StringMap<CountAndDurationType> AllCountAndTotalPerName;
-    auto combineStat = [&](const auto &Stat) {
-      StringRef Key = Stat.getKey();
-      auto Value = Stat.getValue();
+    auto combineStat = [&](StringRef Key, const CountAndDurationType &Value) {
       auto &CountAndTotal = AllCountAndTotalPerName[Key];
       CountAndTotal.first += Value.first;
       CountAndTotal.second += Value.second;
     };
-    for (const auto &Stat : CountAndTotalPerName)
-      combineStat(Stat);
+    auto combineStats = [&](const TimeTraceProfiler &TTP) {
+      for (const auto &Stat : TTP.CountAndTotalPerName)
+        combineStat(Stat.getKey(), Stat.getValue());
+      for (size_t Id = 0, E = TTP.TotalsById.size(); Id != E; ++Id)
+        if (TTP.TotalsById[Id].first)
+          combineStat(Names[Id], TTP.TotalsById[Id]);
+    };
+    combineStats(*this);
     for (const TimeTraceProfiler *TTP : *ThreadTimeTraceProfilerInstances)
-      for (const auto &Stat : TTP->CountAndTotalPerName)
-        combineStat(Stat);
+      combineStats(*TTP);
 
     std::vector<NameAndCountAndDurationType> SortedTotals;
     SortedTotals.reserve(AllCountAndTotalPerName.size());
@@ -248,6 +399,16 @@ struct llvm::TimeTraceProfiler {
   SmallVector<Entry, 16> Stack;
   SmallVector<Entry, 128> Entries;
   StringMap<CountAndDurationType> CountAndTotalPerName;
+
+  // Ring-buffer mode. RingSize is a power of two, or zero if the profiler
+  // keeps every section in Entries instead.
+  SmallVector<RingEntry, 16> RingStack;
+  std::unique_ptr<RingEntry[]> Ring;
+  size_t RingSize = 0;
+  std::atomic<uint64_t> RingHead{0};
+  StringMap<uint32_t> NameIds;
+  SmallVector<CountAndDurationType, 0> TotalsById;
+
   const time_point<system_clock> BeginningOfTime;
   const TimePointType StartTime;
   const std::string ProcName;
@@ -257,14 +418,19 @@ struct llvm::TimeTraceProfiler {
 
   // Minimum time granularity (in microseconds)
   const unsigned TimeTraceGranularity;
+
+  // Whether sections record hardware counters (-track-perf-counters).
+  const bool TrackPerfCounters;
 };
 
 void llvm::timeTraceProfilerInitialize(unsigned TimeTraceGranularity,
-                                       StringRef ProcName) {
+                                       StringRef ProcName,
+                                       size_t RingBufferSize) {
   assert(TimeTraceProfilerInstance == nullptr &&
          "Profiler should not be initialized");
   TimeTraceProfilerInstance = new TimeTraceProfiler(
-      TimeTraceGranularity, llvm::sys::path::filename(ProcName));
+      TimeTraceGranularity, llvm::sys::path::filename(ProcName),
+      RingBufferSize);
 }
 
 // Removes all TimeTraceProfilerInstances.
@@ -312,15 +478,31 @@ Error llvm::timeTraceProfilerWrite(StringRef PreferredFileName,
   return Error::success();
 }
 
+uint64_t llvm::timeTraceProfilerElapsedUs() {
+  assert(TimeTraceProfilerInstance != nullptr &&
+         "Profiler object can't be null");
+  return duration_cast<microseconds>(steady_clock::now() -
+                                     TimeTraceProfilerInstance->StartTime)
+      .count();
+}
+
 void llvm::timeTraceProfilerBegin(StringRef Name, StringRef Detail) {
-  if (TimeTraceProfilerInstance != nullptr)
+  if (TimeTraceProfilerInstance == nullptr)
+    return;
+  if (TimeTraceProfilerInstance->isRingBuffer())
+    TimeTraceProfilerInstance->beginRing(Name, Detail);
+  else
     TimeTraceProfilerInstance->begin(std::string(Name),
                                      [&]() { return std::string(Detail); });
 }
 
 void llvm::timeTraceProfilerBegin(StringRef Name,
                                   llvm::function_ref<std::string()> Detail) {
-  if (TimeTraceProfilerInstance != nullptr)
+  if (TimeTraceProfilerInstance == nullptr)
+    return;
+  if (TimeTraceProfilerInstance->isRingBuffer())
+    TimeTraceProfilerInstance->beginRing(Name, Detail());
+  else
     TimeTraceProfilerInstance->begin(std::string(Name), Detail);
 }
 
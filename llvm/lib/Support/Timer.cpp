@@ -171,15 +171,23 @@ TimeRecord TimeRecord::getCurrentTime(bool Start) {
   sys::TimePoint<> now;
   std::chrono::nanoseconds user, sys;
 
+  bool TrackCounters = perfCountersEnabled();
   if (Start) {
     Result.MemUsed = getMemUsage();
+    if (TrackCounters)
+      Result.Counters = readPerfCounters();
     Result.InstructionsExecuted = getCurInstructionsExecuted();
     sys::Process::GetTimeUsage(now, user, sys);
   } else {
     sys::Process::GetTimeUsage(now, user, sys);
     Result.InstructionsExecuted = getCurInstructionsExecuted();
+    if (TrackCounters)
+      Result.Counters = readPerfCounters();
     Result.MemUsed = getMemUsage();
   }
+  // Without rusage instruction counts, report the hardware counter instead.
+  if (!Result.InstructionsExecuted)
+    Result.InstructionsExecuted = Result.Counters.Instructions;
 
   Result.WallTime = Seconds(now.time_since_epoch()).count();
   Result.UserTime = Seconds(user).count();
@@ -229,6 +237,16 @@ void TimeRecord::print(const TimeRecord &Total, raw_ostream &OS) const {
     OS << format("%9" PRId64 "  ", (int64_t)getMemUsed());
   if (Total.getInstructionsExecuted())
     OS << format("%9" PRId64 "  ", (int64_t)getInstructionsExecuted());
+
+  const PerfCounterValues &TotalCounters = Total.getPerfCounters();
+  if (TotalCounters.Cycles)
+    OS << format("%12" PRId64 "  ", (int64_t)Counters.Cycles);
+  if (TotalCounters.CacheMisses)
+    OS << format("%12" PRId64 "  ", (int64_t)Counters.CacheMisses);
+  if (TotalCounters.BranchMisses)
+    OS << format("%12" PRId64 "  ", (int64_t)Counters.BranchMisses);
+  if (TotalCounters.PeakRSS)
+    OS << format("%12" PRId64 "  ", (int64_t)Counters.PeakRSS);
 }
 
 
@@ -390,6 +408,15 @@ void TimerGroup::PrintQueuedTimers(raw_ostream &OS) {
     OS << "  ---Mem---";
   if (Total.getInstructionsExecuted())
     OS << "  ---Instr---";
+  const PerfCounterValues &TotalCounters = Total.getPerfCounters();
+  if (TotalCounters.Cycles)
+    OS << "  ---Cycles---";
+  if (TotalCounters.CacheMisses)
+    OS << "  -Cache Miss-";
+  if (TotalCounters.BranchMisses)
+    OS << "  --Br Miss---";
+  if (TotalCounters.PeakRSS)
+    OS << "  --Peak RSS--";
   OS << "  --- Name ---\n";
 
   // Loop through all of the timing data, printing it out.
@@ -487,6 +514,23 @@ const char *TimerGroup::printJSONValues(raw_ostream &OS, const char *delim) {
       OS << delim;
       printJSONValue(OS, R, ".instr", T.getInstructionsExecuted());
     }
+    const PerfCounterValues &Counters = T.getPerfCounters();
+    if (Counters.Cycles) {
+      OS << delim;
+      printJSONValue(OS, R, ".cycles", Counters.Cycles);
+    }
+    if (Counters.CacheMisses) {
+      OS << delim;
+      printJSONValue(OS, R, ".cache-misses", Counters.CacheMisses);
+    }
+    if (Counters.BranchMisses) {
+      OS << delim;
+      printJSONValue(OS, R, ".branch-misses", Counters.BranchMisses);
+    }
+    if (Counters.PeakRSS) {
+      OS << delim;
+      printJSONValue(OS, R, ".peak-rss", Counters.PeakRSS);
+    }
   }
   TimersToPrint.clear();
   return delim;
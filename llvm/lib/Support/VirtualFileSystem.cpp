@@ -28,6 +28,8 @@
 #include "llvm/Support/Chrono.h"
 #include "llvm/Support/Compiler.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Endian.h"
+#include "llvm/Support/EndianStream.h"
 #include "llvm/Support/Errc.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/ErrorOr.h"
@@ -2482,3 +2484,279 @@ recursive_directory_iterator::increment(std::error_code &EC) {
 
   return *this;
 }
+
+//===-----------------------------------------------------------------------===/
+// StatCacheFileSystem implementation
+//===-----------------------------------------------------------------------===/
+
+// A stat cache is, in little endian:
+//
+//   char     Magic[8]
+//   uint32_t Version
+//   uint32_t NumEntries
+//   uint64_t RootMTime        nanoseconds since the epoch
+//   uint32_t RootSize
+//   char     Root[RootSize]
+//   Entry    Entries[NumEntries], sorted by name
+//   char     Names[]
+//
+// where an entry holds the offset and size of its name in Names, relative to
+// the root, and the status of the file or directory it names.
+namespace {
+namespace statcache {
+const char Magic[8] = {'L', 'L', 'V', 'M', 'S', 'T', 'A', 'T'};
+const uint32_t Version = 1;
+const size_t HeaderSize = 28;
+
+enum EntryField : size_t {
+  NameOffset = 0,
+  NameSize = 4,
+  Device = 8,
+  File = 16,
+  MTime = 24,
+  Size = 32,
+  User = 40,
+  Group = 44,
+  Type = 48,
+  Perms = 52,
+  Flags = 56,
+  EntrySize = 60
+};
+
+// Nothing is known about the paths below the entry, because it is a symbolic
+// link to a directory which was not walked.
+const uint32_t FlagOpaque = 1;
+} // end namespace statcache
+} // end anonymous namespace
+
+StatCacheFileSystem::StatCacheFileSystem(
+    std::unique_ptr<MemoryBuffer> CacheBuffer,
+    IntrusiveRefCntPtr<FileSystem> FS, StringRef Root, const char *Entries,
+    uint32_t NumEntries, StringRef Names)
+    : ProxyFileSystem(std::move(FS)), CacheBuffer(std::move(CacheBuffer)),
+      Root(Root), Entries(Entries), NumEntries(NumEntries), Names(Names) {}
+
+StatCacheFileSystem::~StatCacheFileSystem() = default;
+
+Expected<IntrusiveRefCntPtr<StatCacheFileSystem>>
+StatCacheFileSystem::create(std::unique_ptr<MemoryBuffer> CacheBuffer,
+                            IntrusiveRefCntPtr<FileSystem> FS) {
+  using namespace support::endian;
+  StringRef Data = CacheBuffer->getBuffer();
+  if (Data.size() < statcache::HeaderSize ||
+      !Data.startswith(StringRef(statcache::Magic, sizeof(statcache::Magic))))
+    return createStringError(errc::invalid_argument, "not a stat cache");
+  if (read32le(Data.data() + 8) != statcache::Version)
+    return createStringError(errc::invalid_argument,
+                             "unsupported stat cache version");
+
+  uint32_t NumEntries = read32le(Data.data() + 12);
+  uint64_t RootMTime = read64le(Data.data() + 16);
+  uint32_t RootSize = read32le(Data.data() + 24);
+  uint64_t EntriesOffset = statcache::HeaderSize + uint64_t(RootSize);
+  uint64_t NamesOffset =
+      EntriesOffset + uint64_t(NumEntries) * statcache::EntrySize;
+  if (NamesOffset > Data.size())
+    return createStringError(errc::invalid_argument, "truncated stat cache");
+  StringRef Root = Data.substr(statcache::HeaderSize, RootSize);
+  StringRef Names = Data.substr(NamesOffset);
+  for (uint32_t I = 0; I != NumEntries; ++I) {
+    const char *Entry =
+        Data.data() + EntriesOffset + I * uint64_t(statcache::EntrySize);
+    if (uint64_t(read32le(Entry + statcache::NameOffset)) +
+            read32le(Entry + statcache::NameSize) >
+        Names.size())
+      return createStringError(errc::invalid_argument, "truncated stat cache");
+  }
+
+  ErrorOr<Status> RootStatus = FS->status(Root);
+  if (!RootStatus)
+    return createFileError(Root, RootStatus.getError());
+  if (uint64_t(RootStatus->getLastModificationTime()
+                   .time_since_epoch()
+                   .count()) != RootMTime)
+    return createStringError(errc::invalid_argument,
+                             "'%s' changed since the stat cache was written",
+                             Root.str().c_str());
+
+  return IntrusiveRefCntPtr<StatCacheFileSystem>(new StatCacheFileSystem(
+      std::move(CacheBuffer), std::move(FS), Root,
+      Data.data() + EntriesOffset, NumEntries, Names));
+}
+
+const char *StatCacheFileSystem::findEntry(StringRef Name) const {
+  using namespace support::endian;
+  auto GetName = [&](uint32_t I) {
+    const char *Entry = Entries + I * uint64_t(statcache::EntrySize);
+    return Names.substr(read32le(Entry + statcache::NameOffset),
+                        read32le(Entry + statcache::NameSize));
+  };
+  uint32_t Lo = 0, Hi = NumEntries;
+  while (Lo < Hi) {
+    uint32_t Mid = Lo + (Hi - Lo) / 2;
+    if (GetName(Mid) < Name)
+      Lo = Mid + 1;
+    else
+      Hi = Mid;
+  }
+  if (Lo == NumEntries || GetName(Lo) != Name)
+    return nullptr;
+  return Entries + Lo * uint64_t(statcache::EntrySize);
+}
+
+StatCacheFileSystem::LookupResult
+StatCacheFileSystem::lookup(const Twine &Path, Status &Result) {
+  using namespace support::endian;
+  SmallString<256> AbsPath;
+  Path.toVector(AbsPath);
+  if (getUnderlyingFS().makeAbsolute(AbsPath))
+    return LookupResult::Unknown;
+  sys::path::native(AbsPath);
+  sys::path::remove_dots(AbsPath);
+  // A '..' after a symbolic link does not lead to the parent in the tree.
+  if (llvm::is_contained(make_range(sys::path::begin(AbsPath),
+                                    sys::path::end(AbsPath)),
+                         ".."))
+    return LookupResult::Unknown;
+
+  StringRef Name = AbsPath;
+  if (!Name.consume_front(Root))
+    return LookupResult::Unknown;
+  if (!Name.empty() && !Root.empty() &&
+      !sys::path::is_separator(Root.back()) &&
+      !sys::path::is_separator(Name.front()))
+    return LookupResult::Unknown;
+  while (!Name.empty() && sys::path::is_separator(Name.front()))
+    Name = Name.drop_front();
+  while (!Name.empty() && sys::path::is_separator(Name.back()))
+    Name = Name.drop_back();
+
+  if (const char *Entry = findEntry(Name)) {
+    Result = Status(
+        Path,
+        UniqueID(read64le(Entry + statcache::Device),
+                 read64le(Entry + statcache::File)),
+        sys::TimePoint<>(
+            std::chrono::nanoseconds(read64le(Entry + statcache::MTime))),
+        read32le(Entry + statcache::User), read32le(Entry + statcache::Group),
+        read64le(Entry + statcache::Size),
+        file_type(read32le(Entry + statcache::Type)),
+        perms(read32le(Entry + statcache::Perms)));
+    return LookupResult::Found;
+  }
+
+  // The path is missing if the closest ancestor in the cache is a directory
+  // whose contents were walked.
+  while (!Name.empty()) {
+    Name = sys::path::parent_path(Name);
+    if (const char *Entry = findEntry(Name)) {
+      if (file_type(read32le(Entry + statcache::Type)) ==
+              file_type::directory_file &&
+          !(read32le(Entry + statcache::Flags) & statcache::FlagOpaque))
+        return LookupResult::Missing;
+      return LookupResult::Unknown;
+    }
+  }
+  return LookupResult::Unknown;
+}
+
+ErrorOr<Status> StatCacheFileSystem::status(const Twine &Path) {
+  Status Result;
+  switch (lookup(Path, Result)) {
+  case LookupResult::Found:
+    return Result;
+  case LookupResult::Missing:
+    return make_error_code(llvm::errc::no_such_file_or_directory);
+  case LookupResult::Unknown:
+    break;
+  }
+  return ProxyFileSystem::status(Path);
+}
+
+ErrorOr<std::unique_ptr<File>>
+StatCacheFileSystem::openFileForRead(const Twine &Path) {
+  Status Result;
+  if (lookup(Path, Result) == LookupResult::Missing)
+    return make_error_code(llvm::errc::no_such_file_or_directory);
+  return ProxyFileSystem::openFileForRead(Path);
+}
+
+Error StatCacheFileSystem::writeStatCache(StringRef Root, raw_ostream &OS) {
+  SmallString<256> RootPath(Root);
+  sys::path::native(RootPath);
+  sys::path::remove_dots(RootPath);
+  if (!sys::path::is_absolute(RootPath))
+    return createStringError(errc::invalid_argument,
+                             "'%s' is not an absolute path",
+                             RootPath.c_str());
+  while (RootPath.size() > sys::path::root_path(RootPath).size() &&
+         sys::path::is_separator(RootPath.back()))
+    RootPath.pop_back();
+
+  sys::fs::file_status RootStatus;
+  if (std::error_code EC = sys::fs::status(RootPath, RootStatus))
+    return createFileError(RootPath, EC);
+  if (RootStatus.type() != file_type::directory_file)
+    return createFileError(RootPath,
+                           make_error_code(errc::not_a_directory));
+
+  struct Entry {
+    std::string Name;
+    file_status Status;
+    uint32_t Flags;
+  };
+  std::vector<Entry> Entries;
+  Entries.push_back({"", RootStatus, 0});
+  std::error_code EC;
+  for (sys::fs::recursive_directory_iterator I(RootPath, EC,
+                                               /*follow_symlinks=*/false),
+       E;
+       I != E && !EC; I.increment(EC)) {
+    file_status Status;
+    // Leave out broken symbolic links, which do not exist for status either.
+    if (sys::fs::status(I->path(), Status))
+      continue;
+    StringRef Name = StringRef(I->path()).drop_front(RootPath.size());
+    while (!Name.empty() && sys::path::is_separator(Name.front()))
+      Name = Name.drop_front();
+    uint32_t Flags = 0;
+    if (I->type() == file_type::symlink_file &&
+        Status.type() == file_type::directory_file)
+      Flags |= statcache::FlagOpaque;
+    Entries.push_back({Name.str(), Status, Flags});
+  }
+  if (EC)
+    return createFileError(RootPath, EC);
+  llvm::sort(Entries, [](const Entry &LHS, const Entry &RHS) {
+    return LHS.Name < RHS.Name;
+  });
+
+  support::endian::Writer W(OS, support::little);
+  OS.write(statcache::Magic, sizeof(statcache::Magic));
+  W.write<uint32_t>(statcache::Version);
+  W.write<uint32_t>(Entries.size());
+  W.write<uint64_t>(RootStatus.getLastModificationTime()
+                        .time_since_epoch()
+                        .count());
+  W.write<uint32_t>(RootPath.size());
+  OS << RootPath;
+  uint32_t NameOffset = 0;
+  for (const Entry &E : Entries) {
+    const file_status &S = E.Status;
+    W.write<uint32_t>(NameOffset);
+    W.write<uint32_t>(E.Name.size());
+    W.write<uint64_t>(S.getUniqueID().getDevice());
+    W.write<uint64_t>(S.getUniqueID().getFile());
+    W.write<uint64_t>(S.getLastModificationTime().time_since_epoch().count());
+    W.write<uint64_t>(S.getSize());
+    W.write<uint32_t>(S.getUser());
+    W.write<uint32_t>(S.getGroup());
+    W.write<uint32_t>(uint32_t(S.type()));
+    W.write<uint32_t>(uint32_t(S.permissions()));
+    W.write<uint32_t>(E.Flags);
+    NameOffset += E.Name.size();
+  }
+  for (const Entry &E : Entries)
+    OS << E.Name;
+  return Error::success();
+}
@@ -23,11 +23,15 @@
 #include "llvm/Support/NativeFormatting.h"
 #include "llvm/Support/Process.h"
 #include "llvm/Support/Program.h"
+#include "llvm/Support/thread.h"
 #include <algorithm>
 #include <cctype>
 #include <cerrno>
+#include <condition_variable>
 #include <cstdio>
+#include <deque>
 #include <iterator>
+#include <mutex>
 #include <sys/stat.h>
 
 // <fcntl.h> may provide O_BINARY.
@@ -661,6 +665,8 @@ raw_fd_ostream::raw_fd_ostream(int fd, bool shouldClose, bool unbuffered,
 raw_fd_ostream::~raw_fd_ostream() {
   if (FD >= 0) {
     flush();
+    if (Async)
+      finish_async_writes();
     if (ShouldClose) {
       if (auto EC = sys::Process::SafelyCloseFileDescriptor(FD))
         error_detected(EC);
@@ -735,18 +741,9 @@ static bool write_console_impl(int FD, StringRef Data) {
 }
 #endif
 
-void raw_fd_ostream::write_impl(const char *Ptr, size_t Size) {
-  assert(FD >= 0 && "File already closed.");
-  pos += Size;
-
-#if defined(_WIN32)
-  // If this is a Windows console device, try re-encoding from UTF-8 to UTF-16
-  // and using WriteConsoleW. If that fails, fall back to plain write().
-  if (IsWindowsConsole)
-    if (write_console_impl(FD, StringRef(Ptr, Size)))
-      return;
-#endif
-
+// Writes all of [Ptr, Ptr + Size) to FD, retrying short and interrupted
+// writes.
+static std::error_code writeFully(int FD, const char *Ptr, size_t Size) {
   // The maximum write size is limited to INT32_MAX. A write
   // greater than SSIZE_MAX is implementation-defined in POSIX,
   // and Windows _write requires 32 bit input.
@@ -779,8 +776,7 @@ void raw_fd_ostream::write_impl(const char *Ptr, size_t Size) {
         continue;
 
       // Otherwise it's a non-recoverable error. Note it and quit.
-      error_detected(std::error_code(errno, std::generic_category()));
-      break;
+      return std::error_code(errno, std::generic_category());
     }
 
     // The write may have written some or all of the data. Update the
@@ -789,12 +785,34 @@ void raw_fd_ostream::write_impl(const char *Ptr, size_t Size) {
     Ptr += ret;
     Size -= ret;
   } while (Size > 0);
+  return std::error_code();
+}
+
+void raw_fd_ostream::write_impl(const char *Ptr, size_t Size) {
+  assert(FD >= 0 && "File already closed.");
+  pos += Size;
+
+#if defined(_WIN32)
+  // If this is a Windows console device, try re-encoding from UTF-8 to UTF-16
+  // and using WriteConsoleW. If that fails, fall back to plain write().
+  if (IsWindowsConsole)
+    if (write_console_impl(FD, StringRef(Ptr, Size)))
+      return;
+#endif
+
+  if (Async)
+    return write_async(Ptr, Size);
+
+  if (std::error_code EC = writeFully(FD, Ptr, Size))
+    error_detected(EC);
 }
 
 void raw_fd_ostream::close() {
   assert(ShouldClose);
   ShouldClose = false;
   flush();
+  if (Async)
+    finish_async_writes();
   if (auto EC = sys::Process::SafelyCloseFileDescriptor(FD))
     error_detected(EC);
   FD = -1;
@@ -803,6 +821,8 @@ void raw_fd_ostream::close() {
 uint64_t raw_fd_ostream::seek(uint64_t off) {
   assert(SupportsSeeking && "Stream does not support seeking!");
   flush();
+  if (Async)
+    wait_for_async_writes();
 #ifdef _WIN32
   pos = ::_lseeki64(FD, off, SEEK_SET);
 #elif defined(HAVE_LSEEK64)
@@ -815,6 +835,116 @@ uint64_t raw_fd_ostream::seek(uint64_t off) {
   return pos;
 }
 
+struct raw_fd_ostream::AsyncWriter {
+  size_t BufferSize;
+  std::unique_ptr<char[]> Storage;
+
+  std::mutex Mu;
+  std::condition_variable Cond;
+  // Buffers that the stream can fill next.
+  SmallVector<char *, 4> Free;
+  // Filled buffers and their sizes, in the order they are to be written.
+  std::deque<std::pair<char *, size_t>> Queue;
+  // True while the writer thread is writing a buffer it took from Queue.
+  bool Busy = false;
+  bool Stop = false;
+  // The first error the writer thread ran into.
+  std::error_code EC;
+
+  llvm::thread Writer;
+
+  AsyncWriter(size_t BufferSize, unsigned NumBuffers)
+      : BufferSize(BufferSize), Storage(new char[BufferSize * NumBuffers]) {
+    for (unsigned I = 0; I != NumBuffers; ++I)
+      Free.push_back(Storage.get() + I * BufferSize);
+  }
+
+  char *takeFreeBuffer(std::unique_lock<std::mutex> &Lock) {
+    Cond.wait(Lock, [&] { return !Free.empty(); });
+    return Free.pop_back_val();
+  }
+
+  void run(int FD) {
+    std::unique_lock<std::mutex> Lock(Mu);
+    while (true) {
+      Cond.wait(Lock, [&] { return Stop || !Queue.empty(); });
+      if (Queue.empty())
+        return;
+      std::pair<char *, size_t> Buf = Queue.front();
+      Queue.pop_front();
+      Busy = true;
+      Lock.unlock();
+      std::error_code WriteEC = writeFully(FD, Buf.first, Buf.second);
+      Lock.lock();
+      Busy = false;
+      if (WriteEC && !EC)
+        EC = WriteEC;
+      Free.push_back(Buf.first);
+      Cond.notify_all();
+    }
+  }
+};
+
+void raw_fd_ostream::enableAsyncWrites(size_t BufferSize,
+                                       unsigned NumBuffers) {
+#if LLVM_ENABLE_THREADS
+  assert(BufferSize && NumBuffers >= 2 && "Need at least two buffers");
+  if (Async || FD < 0 || !IsRegularFile)
+    return;
+  flush();
+  Async = std::make_unique<AsyncWriter>(BufferSize, NumBuffers);
+  Async->Writer = llvm::thread([this] { Async->run(FD); });
+  std::unique_lock<std::mutex> Lock(Async->Mu);
+  SetBuffer(Async->takeFreeBuffer(Lock), BufferSize);
+#endif
+}
+
+void raw_fd_ostream::write_async(const char *Ptr, size_t Size) {
+  std::unique_lock<std::mutex> Lock(Async->Mu);
+
+  // raw_ostream writes data that does not fit in the buffer directly, while
+  // the buffer is empty. That data is the caller's, so copy it.
+  if (Ptr != getBufferStart()) {
+    while (Size) {
+      char *Buf = Async->takeFreeBuffer(Lock);
+      size_t N = std::min(Size, Async->BufferSize);
+      memcpy(Buf, Ptr, N);
+      Async->Queue.push_back({Buf, N});
+      Async->Cond.notify_all();
+      Ptr += N;
+      Size -= N;
+    }
+    return;
+  }
+
+  Async->Queue.push_back({const_cast<char *>(Ptr), Size});
+  Async->Cond.notify_all();
+  SetBuffer(Async->takeFreeBuffer(Lock), Async->BufferSize);
+}
+
+void raw_fd_ostream::wait_for_async_writes() {
+  std::unique_lock<std::mutex> Lock(Async->Mu);
+  Async->Cond.wait(Lock, [&] { return Async->Queue.empty() && !Async->Busy; });
+  if (Async->EC) {
+    error_detected(Async->EC);
+    Async->EC = std::error_code();
+  }
+}
+
+void raw_fd_ostream::finish_async_writes() {
+  // The buffers are about to go away, so stop using them.
+  SetUnbuffered();
+  {
+    std::lock_guard<std::mutex> Lock(Async->Mu);
+    Async->Stop = true;
+  }
+  Async->Cond.notify_all();
+  Async->Writer.join();
+  if (Async->EC)
+    error_detected(Async->EC);
+  Async.reset();
+}
+
 void raw_fd_ostream::pwrite_impl(const char *Ptr, size_t Size,
                                  uint64_t Offset) {
   uint64_t Pos = tell();
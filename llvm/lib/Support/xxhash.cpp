@@ -36,11 +36,31 @@
  * everything but a simple interface for computing XXh64. */
 
 #include "llvm/Support/xxhash.h"
+#include "llvm/Support/Compiler.h"
 #include "llvm/Support/Endian.h"
 
 #include <stdlib.h>
 #include <string.h>
 
+// The XXH3 long input loop has SSE2 and NEON versions selected at compile
+// time, and an AVX2 version selected at runtime on x86 ELF and Mach-O hosts.
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define XXH3_SSE2
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#define XXH3_AVX2
+#include <immintrin.h>
+#elif (defined(__GNUC__) || defined(__clang__)) && !defined(_WIN32)
+#define XXH3_AVX2
+#define XXH3_DISPATCH_AVX2
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) && defined(__aarch64__) && !defined(__AARCH64EB__)
+#define XXH3_NEON
+#include <arm_neon.h>
+#endif
+
 using namespace llvm;
 using namespace support;
 
@@ -68,6 +88,15 @@ static uint64_t mergeRound(uint64_t Acc, uint64_t Val) {
   return Acc;
 }
 
+static uint64_t XXH64_avalanche(uint64_t Hash) {
+  Hash ^= Hash >> 33;
+  Hash *= PRIME64_2;
+  Hash ^= Hash >> 29;
+  Hash *= PRIME64_3;
+  Hash ^= Hash >> 32;
+  return Hash;
+}
+
 uint64_t llvm::xxHash64(StringRef Data) {
   size_t Len = Data.size();
   uint64_t Seed = 0;
@@ -124,15 +153,607 @@ uint64_t llvm::xxHash64(StringRef Data) {
     P++;
   }
 
-  H64 ^= H64 >> 33;
-  H64 *= PRIME64_2;
-  H64 ^= H64 >> 29;
-  H64 *= PRIME64_3;
-  H64 ^= H64 >> 32;
-
-  return H64;
+  return XXH64_avalanche(H64);
 }
 
 uint64_t llvm::xxHash64(ArrayRef<uint8_t> Data) {
   return xxHash64({(const char *)Data.data(), Data.size()});
 }
+
+// XXH3 is a different algorithm from XXH64 that shares its primes. Short
+// inputs are mixed with dedicated code paths; inputs longer than 240 bytes
+// are accumulated in 64-byte stripes into eight 64-bit lanes, which is the
+// part that benefits from SIMD.
+
+static const uint32_t PRIME32_1 = 0x9E3779B1U;
+static const uint32_t PRIME32_2 = 0x85EBCA77U;
+static const uint32_t PRIME32_3 = 0xC2B2AE3DU;
+
+static const uint64_t PRIME_MX1 = 0x165667919E3779F9ULL;
+static const uint64_t PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+constexpr size_t XXH3_SECRETSIZE_MIN = 136;
+constexpr size_t XXH_SECRET_DEFAULT_SIZE = 192;
+
+// The default secret of XXH3.
+alignas(64) static const uint8_t kSecret[XXH_SECRET_DEFAULT_SIZE] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c,
+    0xf7, 0x21, 0xad, 0x1c, 0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb,
+    0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f, 0xcb, 0x79, 0xe6, 0x4e,
+    0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6,
+    0x81, 0x3a, 0x26, 0x4c, 0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb,
+    0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3, 0x71, 0x64, 0x48, 0x97,
+    0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7,
+    0xc7, 0x0b, 0x4f, 0x1d, 0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31,
+    0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64, 0xea, 0xc5, 0xac, 0x83,
+    0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26,
+    0x29, 0xd4, 0x68, 0x9e, 0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc,
+    0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce, 0x45, 0xcb, 0x3a, 0x8f,
+    0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+static uint32_t rotl32(uint32_t X, size_t R) {
+  return (X << R) | (X >> (32 - R));
+}
+
+static XXH128_hash_t XXH_mult64to128(uint64_t LHS, uint64_t RHS) {
+#if defined(__SIZEOF_INT128__)
+  __uint128_t Product = (__uint128_t)LHS * RHS;
+  return {uint64_t(Product), uint64_t(Product >> 64)};
+#else
+  uint64_t LoLo = (LHS & 0xFFFFFFFF) * (RHS & 0xFFFFFFFF);
+  uint64_t HiLo = (LHS >> 32) * (RHS & 0xFFFFFFFF);
+  uint64_t LoHi = (LHS & 0xFFFFFFFF) * (RHS >> 32);
+  uint64_t HiHi = (LHS >> 32) * (RHS >> 32);
+  uint64_t Cross = (LoLo >> 32) + (HiLo & 0xFFFFFFFF) + LoHi;
+  uint64_t Upper = (HiLo >> 32) + (Cross >> 32) + HiHi;
+  uint64_t Lower = (Cross << 32) | (LoLo & 0xFFFFFFFF);
+  return {Lower, Upper};
+#endif
+}
+
+static uint64_t XXH3_mul128_fold64(uint64_t LHS, uint64_t RHS) {
+  XXH128_hash_t Product = XXH_mult64to128(LHS, RHS);
+  return Product.low64 ^ Product.high64;
+}
+
+static uint64_t XXH3_avalanche(uint64_t Hash) {
+  Hash ^= Hash >> 37;
+  Hash *= PRIME_MX1;
+  Hash ^= Hash >> 32;
+  return Hash;
+}
+
+static uint64_t XXH3_rrmxmx(uint64_t Hash, uint64_t Len) {
+  Hash ^= rotl64(Hash, 49) ^ rotl64(Hash, 24);
+  Hash *= PRIME_MX2;
+  Hash ^= (Hash >> 35) + Len;
+  Hash *= PRIME_MX2;
+  Hash ^= Hash >> 28;
+  return Hash;
+}
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+static uint64_t XXH3_len_1to3_64b(const uint8_t *Input, size_t Len,
+                                  const uint8_t *Secret) {
+  const uint8_t C1 = Input[0];
+  const uint8_t C2 = Input[Len >> 1];
+  const uint8_t C3 = Input[Len - 1];
+  uint32_t Combined = ((uint32_t)C1 << 16) | ((uint32_t)C2 << 24) |
+                      ((uint32_t)C3 << 0) | ((uint32_t)Len << 8);
+  uint64_t Bitflip =
+      (uint64_t)(endian::read32le(Secret) ^ endian::read32le(Secret + 4));
+  return XXH64_avalanche(uint64_t(Combined) ^ Bitflip);
+}
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+static uint64_t XXH3_len_4to8_64b(const uint8_t *Input, size_t Len,
+                                  const uint8_t *Secret) {
+  const uint32_t Input1 = endian::read32le(Input);
+  const uint32_t Input2 = endian::read32le(Input + Len - 4);
+  uint64_t Bitflip =
+      endian::read64le(Secret + 8) ^ endian::read64le(Secret + 16);
+  const uint64_t Input64 = Input2 + ((uint64_t)Input1 << 32);
+  return XXH3_rrmxmx(Input64 ^ Bitflip, Len);
+}
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+static uint64_t XXH3_len_9to16_64b(const uint8_t *Input, size_t Len,
+                                   const uint8_t *Secret) {
+  uint64_t Bitflip1 =
+      endian::read64le(Secret + 24) ^ endian::read64le(Secret + 32);
+  uint64_t Bitflip2 =
+      endian::read64le(Secret + 40) ^ endian::read64le(Secret + 48);
+  uint64_t InputLo = endian::read64le(Input) ^ Bitflip1;
+  uint64_t InputHi = endian::read64le(Input + Len - 8) ^ Bitflip2;
+  uint64_t Acc = Len + ByteSwap_64(InputLo) + InputHi +
+                 XXH3_mul128_fold64(InputLo, InputHi);
+  return XXH3_avalanche(Acc);
+}
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+static uint64_t XXH3_len_0to16_64b(const uint8_t *Input, size_t Len,
+                                   const uint8_t *Secret) {
+  if (LLVM_LIKELY(Len > 8))
+    return XXH3_len_9to16_64b(Input, Len, Secret);
+  if (LLVM_LIKELY(Len >= 4))
+    return XXH3_len_4to8_64b(Input, Len, Secret);
+  if (Len)
+    return XXH3_len_1to3_64b(Input, Len, Secret);
+  return XXH64_avalanche(endian::read64le(Secret + 56) ^
+                         endian::read64le(Secret + 64));
+}
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+static uint64_t XXH3_mix16B(const uint8_t *Input, const uint8_t *Secret) {
+  uint64_t LHS = endian::read64le(Input) ^ endian::read64le(Secret);
+  uint64_t RHS = endian::read64le(Input + 8) ^ endian::read64le(Secret + 8);
+  return XXH3_mul128_fold64(LHS, RHS);
+}
+
+// For mid range keys, XXH3 uses a Mum-hash variant.
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+static uint64_t XXH3_len_17to128_64b(const uint8_t *Input, size_t Len,
+                                     const uint8_t *Secret) {
+  uint64_t Acc = Len * PRIME64_1;
+  if (Len > 32) {
+    if (Len > 64) {
+      if (Len > 96) {
+        Acc += XXH3_mix16B(Input + 48, Secret + 96);
+        Acc += XXH3_mix16B(Input + Len - 64, Secret + 112);
+      }
+      Acc += XXH3_mix16B(Input + 32, Secret + 64);
+      Acc += XXH3_mix16B(Input + Len - 48, Secret + 80);
+    }
+    Acc += XXH3_mix16B(Input + 16, Secret + 32);
+    Acc += XXH3_mix16B(Input + Len - 32, Secret + 48);
+  }
+  Acc += XXH3_mix16B(Input + 0, Secret + 0);
+  Acc += XXH3_mix16B(Input + Len - 16, Secret + 16);
+  return XXH3_avalanche(Acc);
+}
+
+constexpr size_t XXH3_MIDSIZE_MAX = 240;
+constexpr size_t XXH3_MIDSIZE_STARTOFFSET = 3;
+constexpr size_t XXH3_MIDSIZE_LASTOFFSET = 17;
+
+LLVM_ATTRIBUTE_NOINLINE
+static uint64_t XXH3_len_129to240_64b(const uint8_t *Input, size_t Len,
+                                      const uint8_t *Secret) {
+  uint64_t Acc = (uint64_t)Len * PRIME64_1;
+  const unsigned NbRounds = Len / 16;
+  for (unsigned I = 0; I < 8; ++I)
+    Acc += XXH3_mix16B(Input + 16 * I, Secret + 16 * I);
+  Acc = XXH3_avalanche(Acc);
+
+  for (unsigned I = 8; I < NbRounds; ++I)
+    Acc += XXH3_mix16B(Input + 16 * I,
+                       Secret + 16 * (I - 8) + XXH3_MIDSIZE_STARTOFFSET);
+  // Last bytes.
+  Acc += XXH3_mix16B(Input + Len - 16,
+                     Secret + XXH3_SECRETSIZE_MIN - XXH3_MIDSIZE_LASTOFFSET);
+  return XXH3_avalanche(Acc);
+}
+
+constexpr size_t XXH_STRIPE_LEN = 64;
+constexpr size_t XXH_SECRET_CONSUME_RATE = 8;
+constexpr size_t XXH_ACC_NB = XXH_STRIPE_LEN / sizeof(uint64_t);
+constexpr size_t XXH_SECRET_LASTACC_START = 7;
+constexpr size_t XXH_SECRET_MERGEACCS_START = 11;
+
+// Each accumulate512 kernel mixes one 64-byte stripe into the accumulator,
+// and each scrambleAcc kernel scrambles it at the end of a block. All of them
+// compute the same values.
+
+#if !defined(XXH3_SSE2) && !defined(XXH3_NEON)
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+static void accumulate512Scalar(uint64_t *Acc, const uint8_t *Input,
+                                const uint8_t *Secret) {
+  for (size_t I = 0; I < XXH_ACC_NB; ++I) {
+    uint64_t DataVal = endian::read64le(Input + 8 * I);
+    uint64_t DataKey = DataVal ^ endian::read64le(Secret + 8 * I);
+    Acc[I ^ 1] += DataVal;
+    Acc[I] += uint32_t(DataKey) * (DataKey >> 32);
+  }
+}
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+static void scrambleAccScalar(uint64_t *Acc, const uint8_t *Secret) {
+  for (size_t I = 0; I < XXH_ACC_NB; ++I) {
+    uint64_t A = Acc[I];
+    A ^= A >> 47;
+    A ^= endian::read64le(Secret + 8 * I);
+    A *= PRIME32_1;
+    Acc[I] = A;
+  }
+}
+#endif
+
+#ifdef XXH3_SSE2
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+static void accumulate512Sse2(uint64_t *Acc, const uint8_t *Input,
+                              const uint8_t *Secret) {
+  __m128i *XAcc = reinterpret_cast<__m128i *>(Acc);
+  const __m128i *XInput = reinterpret_cast<const __m128i *>(Input);
+  const __m128i *XSecret = reinterpret_cast<const __m128i *>(Secret);
+  for (size_t I = 0; I < XXH_STRIPE_LEN / sizeof(__m128i); ++I) {
+    __m128i DataVec = _mm_loadu_si128(XInput + I);
+    __m128i KeyVec = _mm_loadu_si128(XSecret + I);
+    __m128i DataKey = _mm_xor_si128(DataVec, KeyVec);
+    // Multiply the low and high 32-bit halves of each 64-bit lane.
+    __m128i DataKeyHi = _mm_shuffle_epi32(DataKey, _MM_SHUFFLE(0, 3, 0, 1));
+    __m128i Product = _mm_mul_epu32(DataKey, DataKeyHi);
+    // Add the input to the neighbouring lane.
+    __m128i DataSwap = _mm_shuffle_epi32(DataVec, _MM_SHUFFLE(1, 0, 3, 2));
+    __m128i Sum = _mm_add_epi64(XAcc[I], DataSwap);
+    XAcc[I] = _mm_add_epi64(Product, Sum);
+  }
+}
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+static void scrambleAccSse2(uint64_t *Acc, const uint8_t *Secret) {
+  __m128i *XAcc = reinterpret_cast<__m128i *>(Acc);
+  const __m128i *XSecret = reinterpret_cast<const __m128i *>(Secret);
+  const __m128i Prime32 = _mm_set1_epi32((int)PRIME32_1);
+  for (size_t I = 0; I < XXH_STRIPE_LEN / sizeof(__m128i); ++I) {
+    __m128i AccVec = XAcc[I];
+    __m128i Shifted = _mm_srli_epi64(AccVec, 47);
+    __m128i DataVec = _mm_xor_si128(AccVec, Shifted);
+    __m128i KeyVec = _mm_loadu_si128(XSecret + I);
+    __m128i DataKey = _mm_xor_si128(DataVec, KeyVec);
+    // A 64x32-bit multiply made of two 32x32-bit ones.
+    __m128i DataKeyHi = _mm_shuffle_epi32(DataKey, _MM_SHUFFLE(0, 3, 0, 1));
+    __m128i ProdLo = _mm_mul_epu32(DataKey, Prime32);
+    __m128i ProdHi = _mm_mul_epu32(DataKeyHi, Prime32);
+    XAcc[I] = _mm_add_epi64(ProdLo, _mm_slli_epi64(ProdHi, 32));
+  }
+}
+#endif
+
+#ifdef XXH3_AVX2
+#ifdef XXH3_DISPATCH_AVX2
+#define XXH3_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define XXH3_TARGET_AVX2
+#endif
+
+XXH3_TARGET_AVX2 LLVM_ATTRIBUTE_ALWAYS_INLINE static void
+accumulate512Avx2(uint64_t *Acc, const uint8_t *Input, const uint8_t *Secret) {
+  __m256i *XAcc = reinterpret_cast<__m256i *>(Acc);
+  const __m256i *XInput = reinterpret_cast<const __m256i *>(Input);
+  const __m256i *XSecret = reinterpret_cast<const __m256i *>(Secret);
+  for (size_t I = 0; I < XXH_STRIPE_LEN / sizeof(__m256i); ++I) {
+    __m256i DataVec = _mm256_loadu_si256(XInput + I);
+    __m256i KeyVec = _mm256_loadu_si256(XSecret + I);
+    __m256i DataKey = _mm256_xor_si256(DataVec, KeyVec);
+    __m256i DataKeyHi = _mm256_srli_epi64(DataKey, 32);
+    __m256i Product = _mm256_mul_epu32(DataKey, DataKeyHi);
+    __m256i DataSwap = _mm256_shuffle_epi32(DataVec, _MM_SHUFFLE(1, 0, 3, 2));
+    __m256i Sum = _mm256_add_epi64(XAcc[I], DataSwap);
+    XAcc[I] = _mm256_add_epi64(Product, Sum);
+  }
+}
+
+XXH3_TARGET_AVX2 LLVM_ATTRIBUTE_ALWAYS_INLINE static void
+scrambleAccAvx2(uint64_t *Acc, const uint8_t *Secret) {
+  __m256i *XAcc = reinterpret_cast<__m256i *>(Acc);
+  const __m256i *XSecret = reinterpret_cast<const __m256i *>(Secret);
+  const __m256i Prime32 = _mm256_set1_epi32((int)PRIME32_1);
+  for (size_t I = 0; I < XXH_STRIPE_LEN / sizeof(__m256i); ++I) {
+    __m256i AccVec = XAcc[I];
+    __m256i Shifted = _mm256_srli_epi64(AccVec, 47);
+    __m256i DataVec = _mm256_xor_si256(AccVec, Shifted);
+    __m256i KeyVec = _mm256_loadu_si256(XSecret + I);
+    __m256i DataKey = _mm256_xor_si256(DataVec, KeyVec);
+    __m256i DataKeyHi = _mm256_srli_epi64(DataKey, 32);
+    __m256i ProdLo = _mm256_mul_epu32(DataKey, Prime32);
+    __m256i ProdHi = _mm256_mul_epu32(DataKeyHi, Prime32);
+    XAcc[I] = _mm256_add_epi64(ProdLo, _mm256_slli_epi64(ProdHi, 32));
+  }
+}
+#endif
+
+#ifdef XXH3_NEON
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+static void accumulate512Neon(uint64_t *Acc, const uint8_t *Input,
+                              const uint8_t *Secret) {
+  for (size_t I = 0; I < XXH_ACC_NB; I += 2) {
+    uint64x2_t AccVec = vld1q_u64(Acc + I);
+    uint64x2_t DataVec = vreinterpretq_u64_u8(vld1q_u8(Input + 8 * I));
+    uint64x2_t KeyVec = vreinterpretq_u64_u8(vld1q_u8(Secret + 8 * I));
+    uint64x2_t DataKey = veorq_u64(DataVec, KeyVec);
+    // Add the input to the neighbouring lane, then add the product of the
+    // low and high 32-bit halves of each lane of DataKey.
+    AccVec = vaddq_u64(AccVec, vextq_u64(DataVec, DataVec, 1));
+    AccVec = vmlal_u32(AccVec, vmovn_u64(DataKey), vshrn_n_u64(DataKey, 32));
+    vst1q_u64(Acc + I, AccVec);
+  }
+}
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+static void scrambleAccNeon(uint64_t *Acc, const uint8_t *Secret) {
+  const uint32x2_t Prime32 = vdup_n_u32(PRIME32_1);
+  for (size_t I = 0; I < XXH_ACC_NB; I += 2) {
+    uint64x2_t AccVec = vld1q_u64(Acc + I);
+    uint64x2_t KeyVec = vreinterpretq_u64_u8(vld1q_u8(Secret + 8 * I));
+    AccVec = veorq_u64(AccVec, vshrq_n_u64(AccVec, 47));
+    AccVec = veorq_u64(AccVec, KeyVec);
+    // A 64x32-bit multiply made of two 32x32-bit ones.
+    uint64x2_t ProdHi = vmull_u32(vshrn_n_u64(AccVec, 32), Prime32);
+    AccVec = vmlal_u32(vshlq_n_u64(ProdHi, 32), vmovn_u64(AccVec), Prime32);
+    vst1q_u64(Acc + I, AccVec);
+  }
+}
+#endif
+
+// Defines hashLongLoop<Name>, which accumulates an input longer than
+// XXH3_MIDSIZE_MAX into Acc with the given kernels. This is a macro rather
+// than a template so that the AVX2 instance can carry its target attribute.
+#define XXH3_DEFINE_HASH_LONG_LOOP(Name, Target)                               \
+  Target static void hashLongLoop##Name(uint64_t *Acc, const uint8_t *Input,   \
+                                        size_t Len, const uint8_t *Secret) {   \
+    const size_t NbStripesPerBlock =                                           \
+        (XXH_SECRET_DEFAULT_SIZE - XXH_STRIPE_LEN) / XXH_SECRET_CONSUME_RATE;  \
+    const size_t BlockLen = XXH_STRIPE_LEN * NbStripesPerBlock;                \
+    const size_t NbBlocks = (Len - 1) / BlockLen;                              \
+    for (size_t N = 0; N < NbBlocks; ++N) {                                    \
+      for (size_t S = 0; S < NbStripesPerBlock; ++S)                           \
+        accumulate512##Name(Acc, Input + N * BlockLen + S * XXH_STRIPE_LEN,    \
+                            Secret + S * XXH_SECRET_CONSUME_RATE);             \
+      scrambleAcc##Name(Acc,                                                   \
+                        Secret + XXH_SECRET_DEFAULT_SIZE - XXH_STRIPE_LEN);    \
+    }                                                                          \
+    /* Last partial block. */                                                  \
+    const size_t NbStripes =                                                   \
+        ((Len - 1) - BlockLen * NbBlocks) / XXH_STRIPE_LEN;                    \
+    for (size_t S = 0; S < NbStripes; ++S)                                     \
+      accumulate512##Name(Acc,                                                 \
+                          Input + NbBlocks * BlockLen + S * XXH_STRIPE_LEN,    \
+                          Secret + S * XXH_SECRET_CONSUME_RATE);               \
+    /* Last stripe. */                                                         \
+    accumulate512##Name(Acc, Input + Len - XXH_STRIPE_LEN,                     \
+                        Secret + XXH_SECRET_DEFAULT_SIZE - XXH_STRIPE_LEN -    \
+                            XXH_SECRET_LASTACC_START);                         \
+  }
+
+#ifdef XXH3_SSE2
+XXH3_DEFINE_HASH_LONG_LOOP(Sse2, )
+#endif
+#ifdef XXH3_AVX2
+XXH3_DEFINE_HASH_LONG_LOOP(Avx2, XXH3_TARGET_AVX2)
+#endif
+#ifdef XXH3_NEON
+XXH3_DEFINE_HASH_LONG_LOOP(Neon, )
+#endif
+#if !defined(XXH3_SSE2) && !defined(XXH3_NEON)
+XXH3_DEFINE_HASH_LONG_LOOP(Scalar, )
+#endif
+
+using HashLongLoopFn = void (*)(uint64_t *, const uint8_t *, size_t,
+                                const uint8_t *);
+
+static HashLongLoopFn selectHashLongLoop() {
+#if defined(XXH3_DISPATCH_AVX2)
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+    return hashLongLoopAvx2;
+  return hashLongLoopSse2;
+#elif defined(XXH3_AVX2)
+  return hashLongLoopAvx2;
+#elif defined(XXH3_SSE2)
+  return hashLongLoopSse2;
+#elif defined(XXH3_NEON)
+  return hashLongLoopNeon;
+#else
+  return hashLongLoopScalar;
+#endif
+}
+
+static void XXH3_hashLong(uint64_t *Acc, const uint8_t *Input, size_t Len) {
+  static const HashLongLoopFn HashLongLoop = selectHashLongLoop();
+  HashLongLoop(Acc, Input, Len, kSecret);
+}
+
+static uint64_t XXH3_mergeAccs(const uint64_t *Acc, const uint8_t *Secret,
+                               uint64_t Start) {
+  uint64_t Result64 = Start;
+  for (size_t I = 0; I < 4; ++I)
+    Result64 += XXH3_mul128_fold64(Acc[2 * I] ^
+                                       endian::read64le(Secret + 16 * I),
+                                   Acc[2 * I + 1] ^
+                                       endian::read64le(Secret + 16 * I + 8));
+  return XXH3_avalanche(Result64);
+}
+
+LLVM_ATTRIBUTE_NOINLINE
+static uint64_t XXH3_hashLong_64b(const uint8_t *Input, size_t Len) {
+  alignas(64) uint64_t Acc[XXH_ACC_NB] = {PRIME32_3, PRIME64_1, PRIME64_2,
+                                          PRIME64_3, PRIME64_4, PRIME32_2,
+                                          PRIME64_5, PRIME32_1};
+  XXH3_hashLong(Acc, Input, Len);
+  return XXH3_mergeAccs(Acc, kSecret + XXH_SECRET_MERGEACCS_START,
+                        (uint64_t)Len * PRIME64_1);
+}
+
+uint64_t llvm::xxh3_64bits(ArrayRef<uint8_t> Data) {
+  auto *In = Data.data();
+  size_t Len = Data.size();
+  if (Len <= 16)
+    return XXH3_len_0to16_64b(In, Len, kSecret);
+  if (Len <= 128)
+    return XXH3_len_17to128_64b(In, Len, kSecret);
+  if (Len <= XXH3_MIDSIZE_MAX)
+    return XXH3_len_129to240_64b(In, Len, kSecret);
+  return XXH3_hashLong_64b(In, Len);
+}
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+static XXH128_hash_t XXH3_len_1to3_128b(const uint8_t *Input, size_t Len,
+                                        const uint8_t *Secret) {
+  const uint8_t C1 = Input[0];
+  const uint8_t C2 = Input[Len >> 1];
+  const uint8_t C3 = Input[Len - 1];
+  uint32_t CombinedL = ((uint32_t)C1 << 16) | ((uint32_t)C2 << 24) |
+                       ((uint32_t)C3 << 0) | ((uint32_t)Len << 8);
+  uint32_t CombinedH = rotl32(ByteSwap_32(CombinedL), 13);
+  uint64_t BitflipL =
+      (uint64_t)(endian::read32le(Secret) ^ endian::read32le(Secret + 4));
+  uint64_t BitflipH =
+      (uint64_t)(endian::read32le(Secret + 8) ^ endian::read32le(Secret + 12));
+  XXH128_hash_t H128;
+  H128.low64 = XXH64_avalanche(uint64_t(CombinedL) ^ BitflipL);
+  H128.high64 = XXH64_avalanche(uint64_t(CombinedH) ^ BitflipH);
+  return H128;
+}
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+static XXH128_hash_t XXH3_len_4to8_128b(const uint8_t *Input, size_t Len,
+                                        const uint8_t *Secret) {
+  const uint32_t InputLo = endian::read32le(Input);
+  const uint32_t InputHi = endian::read32le(Input + Len - 4);
+  const uint64_t Input64 = InputLo + ((uint64_t)InputHi << 32);
+  uint64_t Bitflip =
+      endian::read64le(Secret + 16) ^ endian::read64le(Secret + 24);
+  uint64_t Keyed = Input64 ^ Bitflip;
+
+  // Shift Len to the left to ensure it is even; this avoids even multiplies.
+  XXH128_hash_t M128 = XXH_mult64to128(Keyed, PRIME64_1 + (Len << 2));
+  M128.high64 += (M128.low64 << 1);
+  M128.low64 ^= (M128.high64 >> 3);
+
+  M128.low64 ^= M128.low64 >> 35;
+  M128.low64 *= PRIME_MX2;
+  M128.low64 ^= M128.low64 >> 28;
+  M128.high64 = XXH3_avalanche(M128.high64);
+  return M128;
+}
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+static XXH128_hash_t XXH3_len_9to16_128b(const uint8_t *Input, size_t Len,
+                                         const uint8_t *Secret) {
+  uint64_t BitflipL =
+      endian::read64le(Secret + 32) ^ endian::read64le(Secret + 40);
+  uint64_t BitflipH =
+      endian::read64le(Secret + 48) ^ endian::read64le(Secret + 56);
+  uint64_t InputLo = endian::read64le(Input);
+  uint64_t InputHi = endian::read64le(Input + Len - 8);
+  XXH128_hash_t M128 =
+      XXH_mult64to128(InputLo ^ InputHi ^ BitflipL, PRIME64_1);
+  M128.low64 += (uint64_t)(Len - 1) << 54;
+  InputHi ^= BitflipH;
+  M128.high64 += InputHi + uint64_t(uint32_t(InputHi)) * (PRIME32_2 - 1);
+  M128.low64 ^= ByteSwap_64(M128.high64);
+
+  // 128x64 multiply: H128 = M128 * PRIME64_2.
+  XXH128_hash_t H128 = XXH_mult64to128(M128.low64, PRIME64_2);
+  H128.high64 += M128.high64 * PRIME64_2;
+  H128.low64 = XXH3_avalanche(H128.low64);
+  H128.high64 = XXH3_avalanche(H128.high64);
+  return H128;
+}
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+static XXH128_hash_t XXH3_len_0to16_128b(const uint8_t *Input, size_t Len,
+                                         const uint8_t *Secret) {
+  if (Len > 8)
+    return XXH3_len_9to16_128b(Input, Len, Secret);
+  if (Len >= 4)
+    return XXH3_len_4to8_128b(Input, Len, Secret);
+  if (Len)
+    return XXH3_len_1to3_128b(Input, Len, Secret);
+  uint64_t BitflipL =
+      endian::read64le(Secret + 64) ^ endian::read64le(Secret + 72);
+  uint64_t BitflipH =
+      endian::read64le(Secret + 80) ^ endian::read64le(Secret + 88);
+  return {XXH64_avalanche(BitflipL), XXH64_avalanche(BitflipH)};
+}
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+static XXH128_hash_t XXH128_mix32B(XXH128_hash_t Acc, const uint8_t *Input1,
+                                   const uint8_t *Input2,
+                                   const uint8_t *Secret) {
+  Acc.low64 += XXH3_mix16B(Input1, Secret + 0);
+  Acc.low64 ^= endian::read64le(Input2) + endian::read64le(Input2 + 8);
+  Acc.high64 += XXH3_mix16B(Input2, Secret + 16);
+  Acc.high64 ^= endian::read64le(Input1) + endian::read64le(Input1 + 8);
+  return Acc;
+}
+
+static XXH128_hash_t XXH3_finalize_128b(XXH128_hash_t Acc, size_t Len) {
+  XXH128_hash_t H128;
+  H128.low64 = Acc.low64 + Acc.high64;
+  H128.high64 = (Acc.low64 * PRIME64_1) + (Acc.high64 * PRIME64_4) +
+                ((uint64_t)Len * PRIME64_2);
+  H128.low64 = XXH3_avalanche(H128.low64);
+  H128.high64 = (uint64_t)0 - XXH3_avalanche(H128.high64);
+  return H128;
+}
+
+LLVM_ATTRIBUTE_ALWAYS_INLINE
+static XXH128_hash_t XXH3_len_17to128_128b(const uint8_t *Input, size_t Len,
+                                           const uint8_t *Secret) {
+  XXH128_hash_t Acc;
+  Acc.low64 = Len * PRIME64_1;
+  Acc.high64 = 0;
+  if (Len > 32) {
+    if (Len > 64) {
+      if (Len > 96)
+        Acc = XXH128_mix32B(Acc, Input + 48, Input + Len - 64, Secret + 96);
+      Acc = XXH128_mix32B(Acc, Input + 32, Input + Len - 48, Secret + 64);
+    }
+    Acc = XXH128_mix32B(Acc, Input + 16, Input + Len - 32, Secret + 32);
+  }
+  Acc = XXH128_mix32B(Acc, Input, Input + Len - 16, Secret);
+  return XXH3_finalize_128b(Acc, Len);
+}
+
+LLVM_ATTRIBUTE_NOINLINE
+static XXH128_hash_t XXH3_len_129to240_128b(const uint8_t *Input, size_t Len,
+                                            const uint8_t *Secret) {
+  XXH128_hash_t Acc;
+  Acc.low64 = Len * PRIME64_1;
+  Acc.high64 = 0;
+  for (size_t I = 32; I < 160; I += 32)
+    Acc = XXH128_mix32B(Acc, Input + I - 32, Input + I - 16, Secret + I - 32);
+  Acc.low64 = XXH3_avalanche(Acc.low64);
+  Acc.high64 = XXH3_avalanche(Acc.high64);
+  for (size_t I = 160; I <= Len; I += 32)
+    Acc = XXH128_mix32B(Acc, Input + I - 32, Input + I - 16,
+                        Secret + XXH3_MIDSIZE_STARTOFFSET + I - 160);
+  // Last bytes.
+  Acc = XXH128_mix32B(Acc, Input + Len - 16, Input + Len - 32,
+                      Secret + XXH3_SECRETSIZE_MIN - XXH3_MIDSIZE_LASTOFFSET -
+                          16);
+  return XXH3_finalize_128b(Acc, Len);
+}
+
+LLVM_ATTRIBUTE_NOINLINE
+static XXH128_hash_t XXH3_hashLong_128b(const uint8_t *Input, size_t Len) {
+  alignas(64) uint64_t Acc[XXH_ACC_NB] = {PRIME32_3, PRIME64_1, PRIME64_2,
+                                          PRIME64_3, PRIME64_4, PRIME32_2,
+                                          PRIME64_5, PRIME32_1};
+  XXH3_hashLong(Acc, Input, Len);
+  XXH128_hash_t H128;
+  H128.low64 = XXH3_mergeAccs(Acc, kSecret + XXH_SECRET_MERGEACCS_START,
+                              (uint64_t)Len * PRIME64_1);
+  H128.high64 = XXH3_mergeAccs(Acc,
+                               kSecret + XXH_SECRET_DEFAULT_SIZE -
+                                   sizeof(Acc) - XXH_SECRET_MERGEACCS_START,
+                               ~((uint64_t)Len * PRIME64_2));
+  return H128;
+}
+
+XXH128_hash_t llvm::xxh3_128bits(ArrayRef<uint8_t> Data) {
+  auto *In = Data.data();
+  size_t Len = Data.size();
+  if (Len <= 16)
+    return XXH3_len_0to16_128b(In, Len, kSecret);
+  if (Len <= 128)
+    return XXH3_len_17to128_128b(In, Len, kSecret);
+  if (Len <= XXH3_MIDSIZE_MAX)
+    return XXH3_len_129to240_128b(In, Len, kSecret);
+  return XXH3_hashLong_128b(In, Len);
+}
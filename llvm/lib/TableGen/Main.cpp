@@ -17,15 +17,22 @@
 #include "llvm/TableGen/Main.h"
 #include "TGParser.h"
 #include "llvm/ADT/StringExtras.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/StringSaver.h"
+#include "llvm/Support/Threading.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/TableGen/Error.h"
 #include "llvm/TableGen/Record.h"
 #include <algorithm>
 #include <cstdio>
 #include <system_error>
+#ifdef LLVM_ON_UNIX
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 using namespace llvm;
 
 static cl::opt<std::string>
@@ -59,6 +66,19 @@ static cl::opt<bool> NoWarnOnUnusedTemplateArgs(
     "no-warn-on-unused-template-args",
     cl::desc("Disable unused template argument warnings."));
 
+static cl::list<std::string>
+EmitJobs("emit",
+         cl::desc("Run a backend on the parsed records as if invoked with "
+                  "only these options, e.g. \"-gen-instr-info -o Out.inc\". "
+                  "Repeat to parse the input once for several outputs."),
+         cl::value_desc("options"));
+
+static cl::opt<unsigned>
+EmitParallelism("emit-jobs",
+                cl::desc("Number of -emit backends to run in parallel "
+                         "(default: number of hardware threads)"),
+                cl::init(0));
+
 static int reportError(const char *ProgName, Twine Msg) {
   errs() << ProgName << ": " << Msg;
   errs().flush();
@@ -87,37 +107,10 @@ static int createDependencyFile(const TGParser &Parser, const char *argv0) {
   return 0;
 }
 
-int llvm::TableGenMain(const char *argv0, TableGenMainFn *MainFn) {
-  RecordKeeper Records;
-
-  if (TimePhases)
-    Records.startPhaseTiming();
-
-  // Parse the input file.
-
-  Records.startTimer("Parse, build records");
-  ErrorOr<std::unique_ptr<MemoryBuffer>> FileOrErr =
-      MemoryBuffer::getFileOrSTDIN(InputFilename, /*IsText=*/true);
-  if (std::error_code EC = FileOrErr.getError())
-    return reportError(argv0, "Could not open input file '" + InputFilename +
-                                  "': " + EC.message() + "\n");
-
-  Records.saveInputFilename(InputFilename);
-
-  // Tell SrcMgr about this buffer, which is what TGParser will pick up.
-  SrcMgr.AddNewSourceBuffer(std::move(*FileOrErr), SMLoc());
-
-  // Record the location of the include directory so that the lexer can find
-  // it later.
-  SrcMgr.setIncludeDirs(IncludeDirs);
-
-  TGParser Parser(SrcMgr, MacroNames, Records, NoWarnOnUnusedTemplateArgs);
-
-  if (Parser.ParseFile())
-    return 1;
-  Records.stopTimer();
-
-  // Write output to memory.
+/// Run the backend selected by the current options on \p Records and write
+/// its output, and the dependency file if requested.
+static int runBackend(const char *argv0, TableGenMainFn *MainFn,
+                      RecordKeeper &Records, const TGParser &Parser) {
   Records.startBackendTimer("Backend overall");
   std::string OutString;
   raw_string_ostream Out(OutString);
@@ -164,3 +157,106 @@ int llvm::TableGenMain(const char *argv0, TableGenMainFn *MainFn) {
     return reportError(argv0, Twine(ErrorsPrinted) + " errors.\n");
   return 0;
 }
+
+/// Run the backend described by the options in \p Job. All options are reset
+/// first, so only the options given in \p Job apply.
+static int runEmitJob(const char *argv0, StringRef Job, TableGenMainFn *MainFn,
+                      RecordKeeper &Records, const TGParser &Parser) {
+  BumpPtrAllocator Alloc;
+  StringSaver Saver(Alloc);
+  SmallVector<const char *, 8> Argv = {argv0};
+  cl::TokenizeGNUCommandLine(Job, Saver, Argv);
+
+  cl::ResetAllOptionOccurrences();
+  if (!cl::ParseCommandLineOptions(Argv.size(), Argv.data(), "", &errs()))
+    return 1;
+  return runBackend(argv0, MainFn, Records, Parser);
+}
+
+/// Run the -emit backends on the records parsed once. On Unix, each backend
+/// runs in a forked process, which shares the parsed records copy-on-write
+/// and keeps the backends, which are not thread-safe, isolated from each
+/// other. Elsewhere, the backends run one after the other.
+static int runEmitJobs(const char *argv0, TableGenMainFn *MainFn,
+                       RecordKeeper &Records, const TGParser &Parser) {
+  // Running a job resets the options, including -emit itself.
+  std::vector<std::string> Jobs(EmitJobs.begin(), EmitJobs.end());
+  int Status = 0;
+
+#ifdef LLVM_ON_UNIX
+  unsigned MaxRunning = EmitParallelism;
+  if (MaxRunning == 0)
+    MaxRunning = hardware_concurrency().compute_thread_count();
+
+  outs().flush();
+  errs().flush();
+  unsigned Running = 0;
+  auto WaitForJob = [&]() {
+    int WaitStatus;
+    if (wait(&WaitStatus) < 0 || !WIFEXITED(WaitStatus) ||
+        WEXITSTATUS(WaitStatus) != 0)
+      Status = 1;
+    --Running;
+  };
+
+  for (const std::string &Job : Jobs) {
+    if (Running == MaxRunning)
+      WaitForJob();
+
+    pid_t Pid = fork();
+    if (Pid == 0) {
+      int Ret = runEmitJob(argv0, Job, MainFn, Records, Parser);
+      outs().flush();
+      errs().flush();
+      _exit(Ret);
+    }
+    if (Pid < 0)
+      return reportError(argv0, "cannot run '" + Job + "'\n");
+    ++Running;
+  }
+  while (Running)
+    WaitForJob();
+#else
+  for (const std::string &Job : Jobs)
+    if (runEmitJob(argv0, Job, MainFn, Records, Parser))
+      Status = 1;
+#endif
+
+  return Status;
+}
+
+int llvm::TableGenMain(const char *argv0, TableGenMainFn *MainFn) {
+  RecordKeeper Records;
+
+  if (TimePhases)
+    Records.startPhaseTiming();
+
+  // Parse the input file.
+
+  Records.startTimer("Parse, build records");
+  ErrorOr<std::unique_ptr<MemoryBuffer>> FileOrErr =
+      MemoryBuffer::getFileOrSTDIN(InputFilename, /*IsText=*/true);
+  if (std::error_code EC = FileOrErr.getError())
+    return reportError(argv0, "Could not open input file '" + InputFilename +
+                                  "': " + EC.message() + "\n");
+
+  Records.saveInputFilename(InputFilename);
+
+  // Tell SrcMgr about this buffer, which is what TGParser will pick up.
+  SrcMgr.AddNewSourceBuffer(std::move(*FileOrErr), SMLoc());
+
+  // Record the location of the include directory so that the lexer can find
+  // it later.
+  SrcMgr.setIncludeDirs(IncludeDirs);
+
+  TGParser Parser(SrcMgr, MacroNames, Records, NoWarnOnUnusedTemplateArgs);
+
+  if (Parser.ParseFile())
+    return 1;
+  Records.stopTimer();
+
+  if (!EmitJobs.empty())
+    return runEmitJobs(argv0, MainFn, Records, Parser);
+
+  return runBackend(argv0, MainFn, Records, Parser);
+}
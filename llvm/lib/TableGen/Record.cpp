@@ -335,6 +335,28 @@ void Init::anchor() {}
 LLVM_DUMP_METHOD void Init::dump() const { return print(errs()); }
 #endif
 
+bool Init::isTriviallyResolved() const {
+  switch (getKind()) {
+  case IK_BitInit:
+  case IK_IntInit:
+  case IK_StringInit:
+  case IK_DefInit:
+  case IK_UnsetInit:
+    return true;
+  case IK_BitsInit:
+  case IK_ListInit:
+  case IK_DagInit:
+    return TriviallyResolved;
+  default:
+    return false;
+  }
+}
+
+static bool areTriviallyResolved(ArrayRef<Init *> Range) {
+  return llvm::all_of(Range,
+                      [](const Init *I) { return I->isTriviallyResolved(); });
+}
+
 UnsetInit *UnsetInit::get() { return &Context->TheUnsetInit; }
 
 Init *UnsetInit::getCastTo(RecTy *Ty) const {
@@ -386,6 +408,7 @@ BitsInit *BitsInit::get(ArrayRef<Init *> Range) {
   BitsInit *I = new(Mem) BitsInit(Range.size());
   std::uninitialized_copy(Range.begin(), Range.end(),
                           I->getTrailingObjects<Init *>());
+  I->TriviallyResolved = areTriviallyResolved(Range);
   Context->TheBitsInitPool.InsertNode(I, IP);
   return I;
 }
@@ -455,6 +478,9 @@ std::string BitsInit::getAsString() const {
 // resolveReferences - If there are any field references that refer to fields
 // that have been filled in, we can propagate the values now.
 Init *BitsInit::resolveReferences(Resolver &R) const {
+  if (TriviallyResolved)
+    return const_cast<BitsInit *>(this);
+
   bool Changed = false;
   SmallVector<Init *, 16> NewBits(getNumBits());
 
@@ -609,6 +635,7 @@ ListInit *ListInit::get(ArrayRef<Init *> Range, RecTy *EltTy) {
   ListInit *I = new (Mem) ListInit(Range.size(), EltTy);
   std::uninitialized_copy(Range.begin(), Range.end(),
                           I->getTrailingObjects<Init *>());
+  I->TriviallyResolved = areTriviallyResolved(Range);
   Context->TheListInitPool.InsertNode(I, IP);
   return I;
 }
@@ -673,6 +700,9 @@ Record *ListInit::getElementAsRecord(unsigned i) const {
 }
 
 Init *ListInit::resolveReferences(Resolver &R) const {
+  if (TriviallyResolved)
+    return const_cast<ListInit *>(this);
+
   SmallVector<Init*, 8> Resolved;
   Resolved.reserve(size());
   bool Changed = false;
@@ -2134,6 +2164,8 @@ DagInit *DagInit::get(Init *V, StringInit *VN, ArrayRef<Init *> ArgRange,
                           I->getTrailingObjects<Init *>());
   std::uninitialized_copy(NameRange.begin(), NameRange.end(),
                           I->getTrailingObjects<StringInit *>());
+  I->TriviallyResolved =
+      V->isTriviallyResolved() && areTriviallyResolved(ArgRange);
   Context->TheDagInitPool.InsertNode(I, IP);
   return I;
 }
@@ -2164,6 +2196,9 @@ Record *DagInit::getOperatorAsDef(ArrayRef<SMLoc> Loc) const {
 }
 
 Init *DagInit::resolveReferences(Resolver &R) const {
+  if (TriviallyResolved)
+    return const_cast<DagInit *>(this);
+
   SmallVector<Init*, 8> NewArgs;
   NewArgs.reserve(arg_size());
   bool ArgsChanged = false;
@@ -56,6 +56,15 @@ static cl::opt<bool> EnableMachineCombinerPass("x86-machine-combiner",
                                cl::desc("Enable the machine combiner pass"),
                                cl::init(true), cl::Hidden);
 
+// FIXME: Default this to 0 for x86-64 once GlobalISel covers enough of -O0
+// code that falling back to SelectionDAG is rare.
+static cl::opt<int> EnableGlobalISelAtO(
+    "x86-enable-global-isel-at-O", cl::Hidden,
+    cl::desc("Enable GlobalISel for x86-64 at or below an opt level, falling "
+             "back to SelectionDAG for functions it cannot select (-1 to "
+             "disable)"),
+    cl::init(-1));
+
 extern "C" LLVM_EXTERNAL_VISIBILITY void LLVMInitializeX86Target() {
   // Register the target.
   RegisterTargetMachine<X86TargetMachine> X(getTheX86_32Target());
@@ -225,6 +234,16 @@ X86TargetMachine::X86TargetMachine(const Target &T, const Triple &TT,
     this->Options.NoTrapAfterNoreturn = TT.isOSBinFormatMachO();
   }
 
+  // Enable GlobalISel at or below EnableGlobalISelAtO for x86-64. Functions
+  // GlobalISel fails on are selected by SelectionDAG instead; pass
+  // -global-isel-abort=2 to get a remark for each of them.
+  if (getOptLevel() <= EnableGlobalISelAtO &&
+      TT.getArch() == Triple::x86_64 && !TT.isX32() &&
+      getCodeModel() != CodeModel::Large) {
+    setGlobalISel(true);
+    setGlobalISelAbort(GlobalISelAbortMode::Disable);
+  }
+
   setMachineOutliner(true);
 
   // x86 supports the debug entry values.
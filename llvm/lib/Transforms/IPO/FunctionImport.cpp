@@ -14,6 +14,7 @@
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SetVector.h"
+#include "llvm/ADT/SmallPtrSet.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/Statistic.h"
 #include "llvm/ADT/StringMap.h"
@@ -43,6 +44,7 @@
 #include "llvm/Support/Error.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Transforms/IPO/Internalize.h"
@@ -51,6 +53,7 @@
 #include "llvm/Transforms/Utils/ValueMapper.h"
 #include <cassert>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <system_error>
@@ -125,6 +128,11 @@ static cl::opt<bool> PrintImportFailures(
     "print-import-failures", cl::init(false), cl::Hidden,
     cl::desc("Print information for functions rejected for importing"));
 
+static cl::opt<bool> ParallelImportComputation(
+    "parallel-import-computation", cl::init(true), cl::Hidden,
+    cl::desc("Compute the imports of the modules in the thin link in "
+             "parallel"));
+
 static cl::opt<bool> ComputeDead("compute-dead", cl::init(true), cl::Hidden,
                                  cl::desc("Compute dead symbols"));
 
@@ -511,7 +519,10 @@ static void computeImportForFunction(
 
     const auto AdjThreshold = GetAdjustedThreshold(Threshold, IsHotCallsite);
 
-    ImportCount++;
+    // Only count when there is a cutoff, since the modules may be processed
+    // in parallel otherwise.
+    if (ImportCutoff >= 0)
+      ImportCount++;
 
     // Insert the newly imported function to the worklist.
     Worklist.emplace_back(ResolvedCalleeSummary, AdjThreshold);
@@ -659,13 +670,45 @@ void llvm::ComputeCrossModuleImport(
     StringMap<FunctionImporter::ImportMapTy> &ImportLists,
     StringMap<FunctionImporter::ExportSetTy> &ExportLists) {
   // For each module that has function defined, compute the import/export lists.
-  for (auto &DefinedGVSummaries : ModuleToDefinedGVSummaries) {
-    auto &ImportList = ImportLists[DefinedGVSummaries.first()];
-    LLVM_DEBUG(dbgs() << "Computing import for Module '"
-                      << DefinedGVSummaries.first() << "'\n");
-    ComputeImportForModule(DefinedGVSummaries.second, Index,
-                           DefinedGVSummaries.first(), ImportList,
-                           &ExportLists);
+  // The modules only share the export lists, so each module collects the
+  // exports that its imports cause in lists of its own, which are merged into
+  // ExportLists once the module is done. The import cutoff counts imports
+  // across modules, and the failures are printed while computing, so either
+  // of them needs the modules one at a time.
+  bool InParallel = ParallelImportComputation && ImportCutoff < 0 &&
+                    !PrintImportFailures;
+#ifndef NDEBUG
+  InParallel &= !DebugFlag;
+#endif
+  if (InParallel) {
+    // Create the import lists first, since StringMap insertion is not
+    // thread-safe. The entries do not move when the map grows.
+    std::vector<std::pair<const StringMapEntry<GVSummaryMapTy> *,
+                          FunctionImporter::ImportMapTy *>>
+        Modules;
+    Modules.reserve(ModuleToDefinedGVSummaries.size());
+    for (auto &DefinedGVSummaries : ModuleToDefinedGVSummaries)
+      Modules.emplace_back(&DefinedGVSummaries,
+                           &ImportLists[DefinedGVSummaries.first()]);
+
+    std::mutex ExportListsMutex;
+    parallelForEach(Modules, [&](const auto &Module) {
+      StringMap<FunctionImporter::ExportSetTy> ModuleExportLists;
+      ComputeImportForModule(Module.first->second, Index, Module.first->first(),
+                             *Module.second, &ModuleExportLists);
+      std::lock_guard<std::mutex> Lock(ExportListsMutex);
+      for (auto &ELI : ModuleExportLists)
+        ExportLists[ELI.first()].insert(ELI.second.begin(), ELI.second.end());
+    });
+  } else {
+    for (auto &DefinedGVSummaries : ModuleToDefinedGVSummaries) {
+      auto &ImportList = ImportLists[DefinedGVSummaries.first()];
+      LLVM_DEBUG(dbgs() << "Computing import for Module '"
+                        << DefinedGVSummaries.first() << "'\n");
+      ComputeImportForModule(DefinedGVSummaries.second, Index,
+                             DefinedGVSummaries.first(), ImportList,
+                             &ExportLists);
+    }
   }
 
   // When computing imports we only added the variables and functions being
@@ -1240,15 +1283,34 @@ Expected<bool> FunctionImporter::importFunctions(
       return std::move(Err);
 
     auto &ImportGUIDs = FunctionsToImportPerModule->second;
+    // Computing the GUID of every global in a large source module to find the
+    // few imported from it takes a while, so when the index has the names of
+    // the globals to import, look them up by name instead.
+    SmallPtrSet<const GlobalValue *, 16> NamedImports;
+    bool HaveNames = all_of(ImportGUIDs, [&](GlobalValue::GUID GUID) {
+      ValueInfo VI = Index.getValueInfo(GUID);
+      if (!VI || VI.name().empty())
+        return false;
+      const GlobalValue *GV = SrcModule->getNamedValue(VI.name());
+      if (!GV || GV->getGUID() != GUID)
+        return false;
+      NamedImports.insert(GV);
+      return true;
+    });
+    auto IsImported = [&](const GlobalValue &GV) {
+      if (HaveNames)
+        return NamedImports.count(&GV) != 0;
+      return ImportGUIDs.count(GV.getGUID()) != 0;
+    };
+
     // Find the globals to import
     SetVector<GlobalValue *> GlobalsToImport;
     for (Function &F : *SrcModule) {
       if (!F.hasName())
         continue;
-      auto GUID = F.getGUID();
-      auto Import = ImportGUIDs.count(GUID);
+      bool Import = IsImported(F);
       LLVM_DEBUG(dbgs() << (Import ? "Is" : "Not") << " importing function "
-                        << GUID << " " << F.getName() << " from "
+                        << F.getGUID() << " " << F.getName() << " from "
                         << SrcModule->getSourceFileName() << "\n");
       if (Import) {
         if (Error Err = F.materialize())
@@ -1267,10 +1329,9 @@ Expected<bool> FunctionImporter::importFunctions(
     for (GlobalVariable &GV : SrcModule->globals()) {
       if (!GV.hasName())
         continue;
-      auto GUID = GV.getGUID();
-      auto Import = ImportGUIDs.count(GUID);
+      bool Import = IsImported(GV);
       LLVM_DEBUG(dbgs() << (Import ? "Is" : "Not") << " importing global "
-                        << GUID << " " << GV.getName() << " from "
+                        << GV.getGUID() << " " << GV.getName() << " from "
                         << SrcModule->getSourceFileName() << "\n");
       if (Import) {
         if (Error Err = GV.materialize())
@@ -1281,10 +1342,9 @@ Expected<bool> FunctionImporter::importFunctions(
     for (GlobalAlias &GA : SrcModule->aliases()) {
       if (!GA.hasName())
         continue;
-      auto GUID = GA.getGUID();
-      auto Import = ImportGUIDs.count(GUID);
+      bool Import = IsImported(GA);
       LLVM_DEBUG(dbgs() << (Import ? "Is" : "Not") << " importing alias "
-                        << GUID << " " << GA.getName() << " from "
+                        << GA.getGUID() << " " << GA.getName() << " from "
                         << SrcModule->getSourceFileName() << "\n");
       if (Import) {
         if (Error Err = GA.materialize())
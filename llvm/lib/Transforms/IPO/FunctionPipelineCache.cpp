@@ -0,0 +1,530 @@
+//===- FunctionPipelineCache.cpp - Cache optimized function bodies --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file implements CachingModuleToFunctionPassAdaptor, which stores the
+// functions a function pipeline produced in an on-disk cache, and splices them
+// in when the same function goes through the same pipeline again.
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/IPO/FunctionPipelineCache.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/IR/DerivedTypes.h"
+#include "llvm/IR/Function.h"
+#include "llvm/IR/GlobalVariable.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/PassInstrumentation.h"
+#include "llvm/Support/Caching.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SHA1.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/ValueMapper.h"
+
+using namespace llvm;
+
+#define DEBUG_TYPE "function-pipeline-cache"
+
+STATISTIC(NumCacheHits, "Number of functions taken from the cache");
+STATISTIC(NumCacheMisses, "Number of functions optimized and cached");
+STATISTIC(NumUncacheable, "Number of functions that could not be cached");
+STATISTIC(NumUnusableEntries,
+          "Number of cache entries that could not be spliced in");
+
+namespace {
+
+/// Maps the types of a cache entry to the types of the module that the entry
+/// is spliced into. When the context already has an identified struct of the
+/// same name, the bitcode reader gives the entry's struct a new name, such as
+/// "struct.S.3" for "struct.S", so such a struct is mapped back to the
+/// existing one if their bodies are the same.
+class CacheEntryTypeRemapper final : public ValueMapTypeRemapper {
+public:
+  Type *remapType(Type *Ty) override;
+
+private:
+  DenseMap<Type *, Type *> MappedTypes;
+
+  /// The types mapped so far, in order, so that the mappings made while
+  /// matching a struct can be undone when the struct does not match.
+  SmallVector<Type *, 16> Log;
+
+  Type *record(Type *Ty, Type *Result) {
+    MappedTypes[Ty] = Result;
+    Log.push_back(Ty);
+    return Result;
+  }
+
+  Type *remapStruct(StructType *ST);
+};
+
+/// Materializes the globals a function refers to, by name, in another module.
+///
+/// When extracting a function into a cache entry, every global becomes a
+/// declaration, except that constants with a definitive initializer keep it,
+/// since function passes fold loads from them. When splicing an entry into a
+/// module, globals are taken from \c Resolved, and the others, which the
+/// pipeline created, are copied.
+class GlobalMaterializer final : public ValueMaterializer {
+public:
+  GlobalMaterializer(Module &Dst, ValueToValueMapTy &VMap,
+                     ValueMapTypeRemapper *TypeMapper = nullptr,
+                     const DenseMap<const GlobalValue *, GlobalValue *>
+                         *Resolved = nullptr)
+      : Dst(Dst), VMap(VMap), TypeMapper(TypeMapper), Resolved(Resolved) {}
+
+  Value *materialize(Value *V) override;
+
+  /// Maps the initializers of the global variables that were copied.
+  void finish();
+
+  /// Returns true if some global had no name to be found by.
+  bool failed() const { return Failed; }
+
+  /// The names and linkages of the globals that were materialized, in order.
+  StringRef getLinkages() const { return Linkages; }
+
+private:
+  Module &Dst;
+  ValueToValueMapTy &VMap;
+  ValueMapTypeRemapper *TypeMapper;
+  const DenseMap<const GlobalValue *, GlobalValue *> *Resolved;
+  SmallVector<std::pair<const GlobalVariable *, GlobalVariable *>, 8>
+      PendingInitializers;
+  std::string Linkages;
+  bool Failed = false;
+
+  GlobalValue *copyPrototype(const GlobalValue &SrcGV, bool IsDefinition);
+};
+
+} // end anonymous namespace
+
+Type *CacheEntryTypeRemapper::remapType(Type *Ty) {
+  auto It = MappedTypes.find(Ty);
+  if (It != MappedTypes.end())
+    return It->second;
+
+  auto *ST = dyn_cast<StructType>(Ty);
+  if (ST && !ST->isLiteral())
+    return remapStruct(ST);
+
+  SmallVector<Type *, 8> Elements;
+  bool Changed = false;
+  for (Type *ElementTy : Ty->subtypes()) {
+    Elements.push_back(remapType(ElementTy));
+    Changed |= Elements.back() != ElementTy;
+  }
+  if (!Changed)
+    return record(Ty, Ty);
+
+  switch (Ty->getTypeID()) {
+  case Type::ArrayTyID:
+    return record(Ty, ArrayType::get(Elements[0], Ty->getArrayNumElements()));
+  case Type::FixedVectorTyID:
+  case Type::ScalableVectorTyID:
+    return record(Ty, VectorType::get(Elements[0],
+                                      cast<VectorType>(Ty)->getElementCount()));
+  case Type::PointerTyID:
+    return record(Ty,
+                  PointerType::get(Elements[0], Ty->getPointerAddressSpace()));
+  case Type::FunctionTyID:
+    return record(Ty, FunctionType::get(Elements[0],
+                                        makeArrayRef(Elements).drop_front(),
+                                        cast<FunctionType>(Ty)->isVarArg()));
+  case Type::StructTyID:
+    return record(Ty, StructType::get(Ty->getContext(), Elements,
+                                      ST->isPacked()));
+  default:
+    llvm_unreachable("unexpected type with subtypes");
+  }
+}
+
+Type *CacheEntryTypeRemapper::remapStruct(StructType *ST) {
+  StringRef Name = ST->getName();
+  size_t Dot = Name.rfind('.');
+  unsigned Suffix;
+  StructType *Existing = nullptr;
+  if (Dot != StringRef::npos && !Name.substr(Dot + 1).getAsInteger(10, Suffix))
+    Existing =
+        StructType::getTypeByName(ST->getContext(), Name.take_front(Dot));
+  if (!Existing || Existing == ST || Existing->isOpaque() != ST->isOpaque() ||
+      Existing->isPacked() != ST->isPacked() ||
+      Existing->getNumElements() != ST->getNumElements())
+    return record(ST, ST);
+
+  // Assume that the structs match while comparing their elements, which may
+  // refer back to them.
+  size_t Start = Log.size();
+  record(ST, Existing);
+  for (unsigned I = 0, E = ST->getNumElements(); I != E; ++I) {
+    if (remapType(ST->getElementType(I)) == Existing->getElementType(I))
+      continue;
+    for (Type *Mapped : drop_begin(Log, Start))
+      MappedTypes.erase(Mapped);
+    Log.truncate(Start);
+    return record(ST, ST);
+  }
+  return Existing;
+}
+
+/// Returns \p Attrs with the types of byval, sret and the other type
+/// attributes mapped through \p TypeMapper.
+static AttributeList remapAttributeTypes(LLVMContext &C, AttributeList Attrs,
+                                         ValueMapTypeRemapper &TypeMapper) {
+  for (unsigned I = 0; I < Attrs.getNumAttrSets(); ++I) {
+    for (int AttrIdx = Attribute::FirstTypeAttr;
+         AttrIdx <= Attribute::LastTypeAttr; AttrIdx++) {
+      Attribute::AttrKind TypedAttr = (Attribute::AttrKind)AttrIdx;
+      if (Type *Ty = Attrs.getAttributeAtIndex(I, TypedAttr).getValueAsType())
+        Attrs = Attrs.replaceAttributeTypeAtIndex(C, I, TypedAttr,
+                                                  TypeMapper.remapType(Ty));
+    }
+  }
+  return Attrs;
+}
+
+Value *GlobalMaterializer::materialize(Value *V) {
+  auto *SrcGV = dyn_cast<GlobalValue>(V);
+  if (!SrcGV)
+    return nullptr;
+
+  if (Resolved) {
+    auto It = Resolved->find(SrcGV);
+    if (It != Resolved->end())
+      return It->second;
+    auto *SrcGVar = dyn_cast<GlobalVariable>(SrcGV);
+    return copyPrototype(*SrcGV, SrcGVar && SrcGVar->hasInitializer());
+  }
+
+  // Without a name, the global could not be found again when splicing.
+  if (!SrcGV->hasName()) {
+    Failed = true;
+    return nullptr;
+  }
+
+  // A function pass may look at the linkage of a global it refers to, which
+  // the declarations in the entry do not keep.
+  Linkages += SrcGV->getName();
+  Linkages += '\0';
+  Linkages += utostr(SrcGV->getLinkage());
+  Linkages += '\0';
+
+  auto *SrcGVar = dyn_cast<GlobalVariable>(SrcGV);
+  return copyPrototype(*SrcGV, SrcGVar && SrcGVar->isConstant() &&
+                                   SrcGVar->hasDefinitiveInitializer());
+}
+
+GlobalValue *GlobalMaterializer::copyPrototype(const GlobalValue &SrcGV,
+                                               bool IsDefinition) {
+  Type *Ty = SrcGV.getValueType();
+  if (TypeMapper)
+    Ty = TypeMapper->remapType(Ty);
+
+  GlobalValue *NewGV;
+  if (auto *FTy = dyn_cast<FunctionType>(Ty)) {
+    Function *NewF =
+        Function::Create(FTy, GlobalValue::ExternalLinkage,
+                         SrcGV.getAddressSpace(), SrcGV.getName(), &Dst);
+    if (auto *SrcF = dyn_cast<Function>(&SrcGV)) {
+      NewF->copyAttributesFrom(SrcF);
+      if (TypeMapper)
+        NewF->setAttributes(remapAttributeTypes(
+            NewF->getContext(), NewF->getAttributes(), *TypeMapper));
+      // These refer to other constants, and a declaration needs none of them.
+      NewF->setPersonalityFn(nullptr);
+      NewF->setPrefixData(nullptr);
+      NewF->setPrologueData(nullptr);
+    }
+    NewGV = NewF;
+  } else {
+    auto *SrcGVar = dyn_cast<GlobalVariable>(&SrcGV);
+    auto *NewGVar = new GlobalVariable(
+        Dst, Ty, SrcGVar && SrcGVar->isConstant(), GlobalValue::ExternalLinkage,
+        /*Initializer=*/nullptr, SrcGV.getName(), /*InsertBefore=*/nullptr,
+        SrcGV.getThreadLocalMode(), SrcGV.getAddressSpace());
+    if (SrcGVar)
+      NewGVar->copyAttributesFrom(SrcGVar);
+    if (IsDefinition) {
+      NewGVar->setLinkage(SrcGV.getLinkage());
+      PendingInitializers.push_back({SrcGVar, NewGVar});
+    }
+    NewGV = NewGVar;
+  }
+
+  if (!isa<GlobalObject>(SrcGV)) {
+    NewGV->setVisibility(SrcGV.getVisibility());
+    NewGV->setUnnamedAddr(SrcGV.getUnnamedAddr());
+    NewGV->setDLLStorageClass(SrcGV.getDLLStorageClass());
+    NewGV->setDSOLocal(SrcGV.isDSOLocal());
+  }
+  return NewGV;
+}
+
+void GlobalMaterializer::finish() {
+  while (!PendingInitializers.empty()) {
+    const GlobalVariable *SrcGVar;
+    GlobalVariable *NewGVar;
+    std::tie(SrcGVar, NewGVar) = PendingInitializers.pop_back_val();
+    NewGVar->setInitializer(MapValue(SrcGVar->getInitializer(), VMap, RF_None,
+                                     TypeMapper, this));
+  }
+}
+
+/// Returns true if \p F can be moved into a cache entry and back.
+static bool isCacheable(const Function &F) {
+  // FIXME: Debug info would have to be moved with the function, and the
+  // entries could only be shared between identical compile units.
+  if (!F.hasName() || F.getSubprogram() || F.hasPrefixData() ||
+      F.hasPrologueData())
+    return false;
+  return none_of(F, [](const BasicBlock &BB) { return BB.hasAddressTaken(); });
+}
+
+/// Copies \p F into a module of its own, with declarations of the globals it
+/// refers to. Returns null if some global cannot be referred to by name. If
+/// \p Linkages is not null, it is set to the linkages of those globals.
+static std::unique_ptr<Module> extractFunction(const Function &F,
+                                               std::string *Linkages) {
+  const Module &M = *F.getParent();
+  auto Entry = std::make_unique<Module>("", F.getContext());
+  Entry->setDataLayout(M.getDataLayout());
+  Entry->setTargetTriple(M.getTargetTriple());
+
+  ValueToValueMapTy VMap;
+  GlobalMaterializer Materializer(*Entry, VMap);
+  Function *NewF = Function::Create(F.getFunctionType(), F.getLinkage(),
+                                    F.getAddressSpace(), F.getName(),
+                                    Entry.get());
+  for (const Argument &A : F.args()) {
+    Argument *NewA = NewF->getArg(A.getArgNo());
+    NewA->setName(A.getName());
+    VMap[&A] = NewA;
+  }
+  // Functions with debug info are not cached, so there are no compile units
+  // for CloneFunctionInto to add to !llvm.dbg.cu, as it does for a function
+  // cloned into a different module.
+  SmallVector<ReturnInst *, 8> Returns;
+  CloneFunctionInto(NewF, &F, VMap, CloneFunctionChangeType::ClonedModule,
+                    Returns, "", nullptr, nullptr, &Materializer);
+
+  if (NamedMDNode *Flags = M.getModuleFlagsMetadata()) {
+    NamedMDNode *NewFlags = Entry->getOrInsertModuleFlagsMetadata();
+    for (const MDNode *Flag : Flags->operands())
+      NewFlags->addOperand(
+          MapMetadata(Flag, VMap, RF_None, nullptr, &Materializer));
+  }
+  Materializer.finish();
+
+  if (Materializer.failed())
+    return nullptr;
+  if (Linkages)
+    *Linkages = Materializer.getLinkages().str();
+  return Entry;
+}
+
+static std::string computeCacheKey(StringRef ExtraKey, StringRef Pipeline,
+                                   StringRef Linkages, const Module &Input) {
+  SHA1 Hasher;
+  Hasher.update(LLVM_VERSION_STRING);
+
+  auto AddString = [&](StringRef Str) {
+    Hasher.update(Str);
+    Hasher.update(ArrayRef<uint8_t>{0});
+  };
+  AddString(ExtraKey);
+  AddString(Pipeline);
+  AddString(Linkages);
+
+  SmallVector<char, 0> Bitcode;
+  raw_svector_ostream OS(Bitcode);
+  WriteBitcodeToFile(Input, OS);
+  Hasher.update(StringRef(Bitcode.data(), Bitcode.size()));
+  return toHex(Hasher.result());
+}
+
+/// Replaces the body of \p F with the body of the function of the same name
+/// in \p Entry. \p Input is the entry that \p F was looked up with. Returns
+/// false, and leaves \p F alone, if the entry does not fit \p F's module.
+static bool spliceCachedBody(Function &F, Module &Entry, const Module &Input,
+                             FunctionAnalysisManager &FAM) {
+  Function *CachedF = Entry.getFunction(F.getName());
+  if (!CachedF || CachedF->isDeclaration())
+    return false;
+  CacheEntryTypeRemapper TypeMapper;
+  if (TypeMapper.remapType(CachedF->getFunctionType()) != F.getFunctionType())
+    return false;
+
+  // Globals that the function referred to before the pipeline ran are the
+  // module's own, since the entry was found by their names and contents.
+  // Declarations the pipeline added, of library functions for example, refer
+  // to the module's global of that name if there is one. Other globals the
+  // pipeline created are copied, with a new name if theirs is taken.
+  Module &M = *F.getParent();
+  DenseMap<const GlobalValue *, GlobalValue *> Resolved;
+  for (const GlobalValue &GV : Entry.global_values()) {
+    if (&GV == CachedF)
+      continue;
+    if (!GV.hasName())
+      return false;
+    GlobalValue *Existing = M.getNamedValue(GV.getName());
+    if (Existing && (Input.getNamedValue(GV.getName()) || GV.isDeclaration())) {
+      if (TypeMapper.remapType(GV.getValueType()) !=
+              Existing->getValueType() ||
+          GV.getAddressSpace() != Existing->getAddressSpace())
+        return false;
+      Resolved[&GV] = Existing;
+      continue;
+    }
+    // Only the contents of constants are kept in an entry.
+    if (isa<GlobalVariable>(GV) == GV.isDeclaration())
+      return false;
+    if (Existing && !GV.hasLocalLinkage())
+      return false;
+  }
+
+  // Drop the analyses of the old body before deleting it; deleteBody() also
+  // resets the linkage, which stays the module's.
+  FAM.clear(F, F.getName());
+  GlobalValue::LinkageTypes Linkage = F.getLinkage();
+  F.deleteBody();
+  F.setLinkage(Linkage);
+
+  ValueToValueMapTy VMap;
+  VMap[CachedF] = &F;
+  for (const Argument &A : CachedF->args())
+    VMap[&A] = F.getArg(A.getArgNo());
+  GlobalMaterializer Materializer(M, VMap, &TypeMapper, &Resolved);
+  SmallVector<ReturnInst *, 8> Returns;
+  CloneFunctionInto(&F, CachedF, VMap, CloneFunctionChangeType::ClonedModule,
+                    Returns, "", nullptr, &TypeMapper, &Materializer);
+  F.setAttributes(
+      remapAttributeTypes(F.getContext(), F.getAttributes(), TypeMapper));
+  Materializer.finish();
+  return true;
+}
+
+void CachingModuleToFunctionPassAdaptor::printPipeline(
+    raw_ostream &OS, function_ref<StringRef(StringRef)> MapClassName2PassName) {
+  OS << "cached-function(";
+  Pass->printPipeline(OS, MapClassName2PassName);
+  OS << ")";
+}
+
+PreservedAnalyses
+CachingModuleToFunctionPassAdaptor::run(Module &M, ModuleAnalysisManager &AM) {
+  FunctionAnalysisManager &FAM =
+      AM.getResult<FunctionAnalysisManagerModuleProxy>(M).getManager();
+  PassInstrumentation PI = AM.getResult<PassInstrumentationAnalysis>(M);
+
+  std::string Pipeline;
+  raw_string_ostream PipelineOS(Pipeline);
+  Pass->printPipeline(PipelineOS,
+                      [](StringRef ClassName) { return ClassName; });
+  PipelineOS.flush();
+
+  // On a hit, the cache hands the entry to this callback before the lookup
+  // returns. Once a new entry is written, it hands that one too.
+  std::unique_ptr<MemoryBuffer> EntryBuffer;
+  Expected<FileCache> CacheOrErr =
+      localCache("FunctionPipelineCache", "llvmcache-fn", CacheDir,
+                 [&](unsigned, std::unique_ptr<MemoryBuffer> MB) {
+                   EntryBuffer = std::move(MB);
+                 });
+  if (!CacheOrErr) {
+    // Run the pass on every function if the cache can't be used.
+    Error E = CacheOrErr.takeError();
+    LLVM_DEBUG(dbgs() << "Not using the function pipeline cache: "
+                      << toString(std::move(E)) << "\n");
+    consumeError(std::move(E));
+  }
+
+  auto RunCached = [&](Function &F) -> PreservedAnalyses {
+    std::string Linkages;
+    std::unique_ptr<Module> Input;
+    if (CacheOrErr && isCacheable(F))
+      Input = extractFunction(F, &Linkages);
+    if (!Input) {
+      ++NumUncacheable;
+      return Pass->run(F, FAM);
+    }
+
+    EntryBuffer.reset();
+    Expected<AddStreamFn> AddStreamOrErr =
+        (*CacheOrErr)(0, computeCacheKey(ExtraKey, Pipeline, Linkages, *Input));
+    if (!AddStreamOrErr) {
+      consumeError(AddStreamOrErr.takeError());
+      ++NumUncacheable;
+      return Pass->run(F, FAM);
+    }
+
+    if (!*AddStreamOrErr) {
+      Expected<std::unique_ptr<Module>> EntryOrErr =
+          parseBitcodeFile(EntryBuffer->getMemBufferRef(), F.getContext());
+      if (EntryOrErr && spliceCachedBody(F, **EntryOrErr, *Input, FAM)) {
+        ++NumCacheHits;
+        return PreservedAnalyses::none();
+      }
+      if (!EntryOrErr)
+        consumeError(EntryOrErr.takeError());
+      ++NumUnusableEntries;
+      return Pass->run(F, FAM);
+    }
+
+    ++NumCacheMisses;
+    PreservedAnalyses PassPA = Pass->run(F, FAM);
+    std::unique_ptr<Module> Output;
+    if (isCacheable(F))
+      Output = extractFunction(F, nullptr);
+    if (!Output)
+      return PassPA;
+    Expected<std::unique_ptr<CachedFileStream>> StreamOrErr =
+        (*AddStreamOrErr)(0);
+    if (!StreamOrErr) {
+      consumeError(StreamOrErr.takeError());
+      return PassPA;
+    }
+    // The entry is committed when the stream is destroyed.
+    WriteBitcodeToFile(*Output, *(*StreamOrErr)->OS);
+    return PassPA;
+  };
+
+  PreservedAnalyses PA = PreservedAnalyses::all();
+  for (Function &F : M) {
+    if (F.isDeclaration())
+      continue;
+
+    if (!PI.runBeforePass<Function>(*Pass, F))
+      continue;
+
+    PreservedAnalyses PassPA;
+    {
+      TimeTraceScope TimeScope(Pass->name(), F.getName());
+      PassPA = RunCached(F);
+    }
+
+    PI.runAfterPass(*Pass, F, PassPA);
+
+    FAM.invalidate(F, PassPA);
+    PA.intersect(std::move(PassPA));
+  }
+
+  // As for ModuleToFunctionPassAdaptor, the functions' analyses have been
+  // invalidated above.
+  PA.preserveSet<AllAnalysesOn<Function>>();
+  PA.preserve<FunctionAnalysisManagerModuleProxy>();
+  return PA;
+}
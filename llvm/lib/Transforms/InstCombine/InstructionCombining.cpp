@@ -117,6 +117,8 @@ using namespace llvm::PatternMatch;
 STATISTIC(NumWorklistIterations,
           "Number of instruction combining iterations performed");
 
+STATISTIC(NumVisited  , "Number of insts visited");
+STATISTIC(NumReseeded , "Number of insts seeded into later iterations");
 STATISTIC(NumCombined , "Number of insts combined");
 STATISTIC(NumConstProp, "Number of constant folds");
 STATISTIC(NumDeadInst , "Number of dead inst eliminated");
@@ -144,6 +146,12 @@ static cl::opt<unsigned> LimitMaxIterations(
     cl::desc("Limit the maximum number of instruction combining iterations"),
     cl::init(InstCombineDefaultMaxIterations));
 
+static cl::opt<bool> IncrementalWorklist(
+    "instcombine-incremental-worklist",
+    cl::desc("Seed iterations after the first only with the instructions that "
+             "changed in the previous one, and their operands and users"),
+    cl::init(true), cl::Hidden);
+
 static cl::opt<unsigned> InfiniteLoopDetectionThreshold(
     "instcombine-infinite-loop-threshold",
     cl::desc("Number of instruction combining iterations considered an "
@@ -3908,6 +3916,7 @@ bool InstCombinerImpl::run() {
 
     if (!DebugCounter::shouldExecute(VisitCounter))
       continue;
+    ++NumVisited;
 
     // Instruction isn't dead, see if we can constant propagate it.
     if (!I->use_empty() &&
@@ -4118,9 +4127,29 @@ public:
 /// them to the worklist (this significantly speeds up instcombine on code where
 /// many instructions are dead or constant).  Additionally, if we find a branch
 /// whose condition is a known constant, we only visit the reachable successors.
-static bool prepareICWorklistFromFunction(Function &F, const DataLayout &DL,
-                                          const TargetLibraryInfo *TLI,
-                                          InstructionWorklist &ICWorklist) {
+/// Returns true if \p I, one of its operands or one of its users is in
+/// \p Changed.
+static bool isNearChange(Instruction &I,
+                         const SmallPtrSetImpl<Instruction *> &Changed) {
+  if (Changed.count(&I))
+    return true;
+  for (Value *Op : I.operands())
+    if (auto *OpI = dyn_cast<Instruction>(Op))
+      if (Changed.count(OpI))
+        return true;
+  return any_of(I.users(), [&](User *U) {
+    return Changed.count(cast<Instruction>(U));
+  });
+}
+
+/// Populates \p ICWorklist with the instructions of \p F, in the order they
+/// should be visited. If \p Changed is not null, only the instructions near
+/// a change in it are added, and the changes made here are added to it.
+static bool
+prepareICWorklistFromFunction(Function &F, const DataLayout &DL,
+                              const TargetLibraryInfo *TLI,
+                              InstructionWorklist &ICWorklist,
+                              SmallPtrSetImpl<Instruction *> *Changed) {
   bool MadeIRChange = false;
   SmallPtrSet<BasicBlock *, 32> Visited;
   SmallVector<BasicBlock*, 256> Worklist;
@@ -4144,6 +4173,9 @@ static bool prepareICWorklistFromFunction(Function &F, const DataLayout &DL,
         if (Constant *C = ConstantFoldInstruction(&Inst, DL, TLI)) {
           LLVM_DEBUG(dbgs() << "IC: ConstFold to: " << *C << " from: " << Inst
                             << '\n');
+          if (Changed)
+            for (User *U : Inst.users())
+              Changed->insert(cast<Instruction>(U));
           Inst.replaceAllUsesWith(C);
           ++NumConstProp;
           if (isInstructionTriviallyDead(&Inst, TLI))
@@ -4167,6 +4199,8 @@ static bool prepareICWorklistFromFunction(Function &F, const DataLayout &DL,
                             << "\n    Old = " << *C
                             << "\n    New = " << *FoldRes << '\n');
           U = FoldRes;
+          if (Changed)
+            Changed->insert(&Inst);
           MadeIRChange = true;
         }
       }
@@ -4235,6 +4269,11 @@ static bool prepareICWorklistFromFunction(Function &F, const DataLayout &DL,
       continue;
     }
 
+    if (Changed) {
+      if (!isNearChange(*Inst, *Changed))
+        continue;
+      ++NumReseeded;
+    }
     ICWorklist.push(Inst);
   }
 
@@ -4265,7 +4304,9 @@ static bool combineInstructionsOverFunction(
   if (ShouldLowerDbgDeclare)
     MadeIRChange = LowerDbgDeclare(F);
 
-  // Iterate while there is work to do.
+  // Iterate while there is work to do. With an incremental worklist, the
+  // instructions an iteration changed are where the next one starts.
+  SmallPtrSet<Instruction *, 16> Changed;
   unsigned Iteration = 0;
   while (true) {
     ++NumWorklistIterations;
@@ -4287,13 +4328,20 @@ static bool combineInstructionsOverFunction(
     LLVM_DEBUG(dbgs() << "\n\nINSTCOMBINE ITERATION #" << Iteration << " on "
                       << F.getName() << "\n");
 
-    MadeIRChange |= prepareICWorklistFromFunction(F, DL, &TLI, Worklist);
+    bool Incremental = IncrementalWorklist && Iteration > 1;
+    MadeIRChange |= prepareICWorklistFromFunction(
+        F, DL, &TLI, Worklist, Incremental ? &Changed : nullptr);
 
     InstCombinerImpl IC(Worklist, Builder, F.hasMinSize(), AA, AC, TLI, TTI, DT,
                         ORE, BFI, PSI, DL, LI);
     IC.MaxArraySizeForCombine = MaxArraySize;
 
-    if (!IC.run())
+    if (IncrementalWorklist)
+      Worklist.startTrackingChanges();
+    bool Combined = IC.run();
+    if (IncrementalWorklist)
+      Changed = Worklist.takeChanges();
+    if (!Combined)
       break;
 
     MadeIRChange = true;
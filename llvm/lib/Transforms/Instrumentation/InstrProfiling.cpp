@@ -34,9 +34,11 @@
 #include "llvm/IR/GlobalValue.h"
 #include "llvm/IR/GlobalVariable.h"
 #include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/InstIterator.h"
 #include "llvm/IR/Instruction.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/MDBuilder.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Type.h"
 #include "llvm/InitializePasses.h"
@@ -79,6 +81,33 @@ cl::opt<bool>
                              cl::desc("Enable relocating counters at runtime."),
                              cl::init(false));
 
+cl::opt<bool> PerThreadCounters(
+    "instrprof-per-thread-counters", cl::ZeroOrMore,
+    cl::desc("Update profile counters in lazily allocated per-thread copies, "
+             "which are summed when the profile is written. Ignored when "
+             "counters are relocated at runtime."),
+    cl::init(false));
+
+cl::opt<bool> SampledInstrumentation(
+    "sampled-instrumentation", cl::ZeroOrMore,
+    cl::desc("Only update profile counters in periodic bursts of function "
+             "entries, counted per thread. Ignored when counters are "
+             "relocated at runtime."),
+    cl::init(false));
+
+cl::opt<unsigned> SampledInstrPeriod(
+    "sampled-instr-period", cl::ZeroOrMore,
+    cl::desc("The number of function entries in a sampling period, see "
+             "-sampled-instrumentation."),
+    cl::init(65535));
+
+cl::opt<unsigned> SampledInstrBurstDuration(
+    "sampled-instr-burst-duration", cl::ZeroOrMore,
+    cl::desc("The number of function entries at the start of each sampling "
+             "period for which profile counters are updated, see "
+             "-sampled-instrumentation."),
+    cl::init(200));
+
 cl::opt<bool> ValueProfileStaticAlloc(
     "vp-static-alloc",
     cl::desc("Do static counter allocation for value profiler"),
@@ -448,19 +477,35 @@ llvm::createInstrProfilingLegacyPass(const InstrProfOptions &Options,
 bool InstrProfiling::lowerIntrinsics(Function *F) {
   bool MadeChange = false;
   PromotionCandidates.clear();
-  for (BasicBlock &BB : *F) {
-    for (Instruction &Instr : llvm::make_early_inc_range(BB)) {
-      if (auto *IPIS = dyn_cast<InstrProfIncrementInstStep>(&Instr)) {
-        lowerIncrement(IPIS);
-        MadeChange = true;
-      } else if (auto *IPI = dyn_cast<InstrProfIncrementInst>(&Instr)) {
-        lowerIncrement(IPI);
-        MadeChange = true;
-      } else if (auto *IPVP = dyn_cast<InstrProfValueProfileInst>(&Instr)) {
-        lowerValueProfileInst(IPVP);
-        MadeChange = true;
-      }
-    }
+
+  // The shard offset and sampling condition are emitted before lowering, as
+  // they are used by all of the counter updates of the function.
+  CounterShardOffset = nullptr;
+  SamplingCond = nullptr;
+  if (llvm::any_of(instructions(F), [](Instruction &I) {
+        return isa<InstrProfIncrementInst>(I);
+      })) {
+    if (isPerThreadCountersEnabled())
+      CounterShardOffset = emitCounterShardOffset(*F);
+    if (isSamplingEnabled())
+      SamplingCond = emitSamplingCond(*F);
+  }
+
+  // Sampled counter updates split blocks, so collect the intrinsics first.
+  SmallVector<InstrProfInstBase *, 16> Intrinsics;
+  for (Instruction &Instr : instructions(F))
+    if (isa<InstrProfIncrementInst>(Instr) ||
+        isa<InstrProfValueProfileInst>(Instr))
+      Intrinsics.push_back(cast<InstrProfInstBase>(&Instr));
+
+  for (InstrProfInstBase *Instr : Intrinsics) {
+    if (auto *IPIS = dyn_cast<InstrProfIncrementInstStep>(Instr))
+      lowerIncrement(IPIS);
+    else if (auto *IPI = dyn_cast<InstrProfIncrementInst>(Instr))
+      lowerIncrement(IPI);
+    else
+      lowerValueProfileInst(cast<InstrProfValueProfileInst>(Instr));
+    MadeChange = true;
   }
 
   if (!MadeChange)
@@ -482,6 +527,110 @@ bool InstrProfiling::isRuntimeCounterRelocationEnabled() const {
   return TT.isOSFuchsia();
 }
 
+/// Move the static allocas to the start of \p Entry, so that they stay static
+/// if the block is split, and return the insertion point following them.
+static BasicBlock::iterator hoistStaticAllocas(BasicBlock &Entry) {
+  BasicBlock::iterator IP = Entry.getFirstInsertionPt();
+  for (Instruction &I : llvm::make_early_inc_range(Entry)) {
+    auto *AI = dyn_cast<AllocaInst>(&I);
+    if (!AI || !AI->isStaticAlloca())
+      continue;
+    if (&*IP == AI)
+      ++IP;
+    else
+      AI->moveBefore(&*IP);
+  }
+  return IP;
+}
+
+bool InstrProfiling::isPerThreadCountersEnabled() const {
+  return PerThreadCounters && !isRuntimeCounterRelocationEnabled();
+}
+
+Value *InstrProfiling::emitCounterShardOffset(Function &F) {
+  LLVMContext &Ctx = M->getContext();
+  Type *IntPtrTy = M->getDataLayout().getIntPtrType(Ctx);
+
+  GlobalVariable *OffsetVar =
+      M->getGlobalVariable(getInstrProfCounterShardOffsetVarName());
+  if (!OffsetVar) {
+    // The variable is defined by the runtime, one per shared object.
+    OffsetVar = new GlobalVariable(
+        *M, IntPtrTy, false, GlobalValue::ExternalLinkage, nullptr,
+        getInstrProfCounterShardOffsetVarName(), nullptr,
+        GlobalValue::GeneralDynamicTLSModel);
+    OffsetVar->setVisibility(GlobalVariable::HiddenVisibility);
+  }
+
+  BasicBlock::iterator IP = hoistStaticAllocas(F.getEntryBlock());
+  // Load the offset, and call into the runtime on the first use by a thread:
+  //
+  //   %offset = load @__llvm_profile_counter_shard_offset
+  //   if (%offset == 0)
+  //     %offset = call @__llvm_profile_init_counter_shard()
+  IRBuilder<> Builder(&*IP);
+  LoadInst *Offset = Builder.CreateLoad(IntPtrTy, OffsetVar, "pgo.shard");
+  Value *NeedsInit =
+      Builder.CreateICmpEQ(Offset, ConstantInt::get(IntPtrTy, 0));
+  Instruction *InitTerm = SplitBlockAndInsertIfThen(
+      NeedsInit, &*IP, /*Unreachable=*/false,
+      MDBuilder(Ctx).createBranchWeights(1, (1U << 20) - 1));
+
+  Builder.SetInsertPoint(InitTerm);
+  FunctionCallee InitFn = M->getOrInsertFunction(
+      getInstrProfInitCounterShardFuncName(), IntPtrTy);
+  CallInst *InitOffset = Builder.CreateCall(InitFn);
+
+  PHINode *Phi = PHINode::Create(IntPtrTy, 2, "pgo.shard.offset",
+                                 &IP->getParent()->front());
+  Phi->addIncoming(Offset, Offset->getParent());
+  Phi->addIncoming(InitOffset, InitTerm->getParent());
+  return Phi;
+}
+
+bool InstrProfiling::isSamplingEnabled() const {
+  if (!SampledInstrumentation || isRuntimeCounterRelocationEnabled())
+    return false;
+  if (SampledInstrBurstDuration == 0 ||
+      SampledInstrBurstDuration >= SampledInstrPeriod)
+    report_fatal_error("-sampled-instr-burst-duration must be non-zero and "
+                       "smaller than -sampled-instr-period");
+  return true;
+}
+
+Value *InstrProfiling::emitSamplingCond(Function &F) {
+  LLVMContext &Ctx = M->getContext();
+  Type *Int32Ty = Type::getInt32Ty(Ctx);
+
+  GlobalVariable *SamplingVar =
+      M->getGlobalVariable(getInstrProfSamplingVarName());
+  if (!SamplingVar) {
+    // The variable is defined by the runtime, one per shared object.
+    SamplingVar = new GlobalVariable(
+        *M, Int32Ty, false, GlobalValue::ExternalLinkage, nullptr,
+        getInstrProfSamplingVarName(), nullptr,
+        GlobalValue::GeneralDynamicTLSModel);
+    SamplingVar->setVisibility(GlobalVariable::HiddenVisibility);
+  }
+
+  // Count the function entries of the thread modulo the period, and update
+  // the counters during the first entries of each period:
+  //
+  //   %entries = load @__llvm_profile_sampling
+  //   %sampled = %entries < BurstDuration
+  //   @__llvm_profile_sampling = (%entries + 1) % Period
+  IRBuilder<> Builder(&*hoistStaticAllocas(F.getEntryBlock()));
+  LoadInst *Entries = Builder.CreateLoad(Int32Ty, SamplingVar, "pgo.entries");
+  Value *Sampled = Builder.CreateICmpULT(
+      Entries, Builder.getInt32(SampledInstrBurstDuration), "pgo.sampled");
+  Value *Next = Builder.CreateAdd(Entries, Builder.getInt32(1));
+  Value *Wrap =
+      Builder.CreateICmpUGE(Next, Builder.getInt32(SampledInstrPeriod));
+  Builder.CreateStore(Builder.CreateSelect(Wrap, Builder.getInt32(0), Next),
+                      SamplingVar);
+  return Sampled;
+}
+
 bool InstrProfiling::isCounterPromotionEnabled() const {
   if (DoCounterPromotion.getNumOccurrences() > 0)
     return DoCounterPromotion;
@@ -726,6 +875,24 @@ void InstrProfiling::lowerIncrement(InstrProfIncrementInst *Inc) {
     }
     auto *Add = Builder.CreateAdd(Builder.CreatePtrToInt(Addr, Int64Ty), LI);
     Addr = Builder.CreateIntToPtr(Add, Int64PtrTy);
+  } else if (CounterShardOffset) {
+    Type *IntPtrTy = CounterShardOffset->getType();
+    auto *Add = Builder.CreateAdd(Builder.CreatePtrToInt(Addr, IntPtrTy),
+                                  CounterShardOffset);
+    Addr = Builder.CreateIntToPtr(Add, Addr->getType());
+  }
+
+  // Only update the counter during the sampling bursts. The counters section
+  // is not touched otherwise, which is where the overhead of instrumentation
+  // comes from in hot code.
+  if (SamplingCond) {
+    MDNode *Weights = MDBuilder(M->getContext())
+                          .createBranchWeights(SampledInstrBurstDuration,
+                                               SampledInstrPeriod -
+                                                   SampledInstrBurstDuration);
+    Instruction *ThenTerm = SplitBlockAndInsertIfThen(
+        SamplingCond, Inc, /*Unreachable=*/false, Weights);
+    Builder.SetInsertPoint(ThenTerm);
   }
 
   if (Options.Atomic || AtomicCounterUpdateAll ||
@@ -737,7 +904,8 @@ void InstrProfiling::lowerIncrement(InstrProfIncrementInst *Inc) {
     Value *Load = Builder.CreateLoad(IncStep->getType(), Addr, "pgocount");
     auto *Count = Builder.CreateAdd(Load, Inc->getStep());
     auto *Store = Builder.CreateStore(Count, Addr);
-    if (isCounterPromotionEnabled())
+    // Sampled updates are conditional, and can't be promoted out of loops.
+    if (isCounterPromotionEnabled() && !SamplingCond)
       PromotionCandidates.emplace_back(cast<Instruction>(Load), Store);
   }
   Inc->eraseFromParent();
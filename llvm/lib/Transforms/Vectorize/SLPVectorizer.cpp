@@ -108,6 +108,8 @@ using namespace slpvectorizer;
 #define DEBUG_TYPE "SLP"
 
 STATISTIC(NumVectorInstructions, "Number of vector instructions generated");
+STATISTIC(NumBudgetExhausted,
+          "Number of functions where the compile-time budget ran out");
 
 cl::opt<bool> RunSLPVectorization("vectorize-slp", cl::init(true), cl::Hidden,
                                   cl::desc("Run the SLP vectorization passes"));
@@ -146,6 +148,16 @@ static cl::opt<int>
 ScheduleRegionSizeBudget("slp-schedule-budget", cl::init(100000), cl::Hidden,
     cl::desc("Limit the size of the SLP scheduling region per block"));
 
+/// Limits the work done per function, counted in scalars visited while building
+/// trees and while computing their costs. Once it is used up, the remaining
+/// trees in the function are not built. This keeps large straight-line
+/// functions, such as unrolled kernels, from taking superlinear time; it is far
+/// higher than what other functions need.
+static cl::opt<unsigned> CompileTimeBudget(
+    "slp-compile-time-budget", cl::init(4000000), cl::Hidden,
+    cl::desc("Limit the work done by the SLP vectorizer per function "
+             "(0 = unlimited)"));
+
 static cl::opt<int> MinVectorRegSizeOption(
     "slp-min-reg-size", cl::init(128), cl::Hidden,
     cl::desc("Attempt to vectorize for this register size in bits"));
@@ -898,6 +910,10 @@ public:
 
   OptimizationRemarkEmitter *getORE() { return ORE; }
 
+  /// \returns true if the compile-time budget of the function is used up, so
+  /// that no more trees should be built.
+  bool isBudgetExhausted() const { return BudgetExhausted; }
+
   /// This structure holds any data we need about the edges being traversed
   /// during buildTree_rec(). We keep track of:
   /// (i) the user TreeEntry index, and
@@ -2755,6 +2771,15 @@ private:
   const DataLayout *DL;
   OptimizationRemarkEmitter *ORE;
 
+  /// Adds \p Units to the work done in the function. \returns false if that
+  /// uses up the compile-time budget.
+  bool chargeBudget(unsigned Units);
+
+  /// The work done in the function so far, and whether it exceeded the
+  /// budget.
+  uint64_t BudgetUsed = 0;
+  bool BudgetExhausted = false;
+
   unsigned MaxVecRegSize; // This is set by TTI or overridden by cl::opt.
   unsigned MinVecRegSize; // Set by cl::opt (default: 128).
 
@@ -3494,11 +3519,32 @@ void BoUpSLP::buildTree(ArrayRef<Value *> Roots,
                         ArrayRef<Value *> UserIgnoreLst) {
   deleteTree();
   UserIgnoreList = UserIgnoreLst;
-  if (!allSameType(Roots))
+  if (!allSameType(Roots) || isBudgetExhausted())
     return;
   buildTree_rec(Roots, 0, EdgeInfo());
 }
 
+bool BoUpSLP::chargeBudget(unsigned Units) {
+  if (BudgetExhausted)
+    return false;
+  BudgetUsed += Units;
+  if (!CompileTimeBudget || BudgetUsed <= CompileTimeBudget)
+    return true;
+
+  LLVM_DEBUG(dbgs() << "SLP: Compile-time budget exhausted in "
+                    << F->getName() << ".\n");
+  BudgetExhausted = true;
+  ++NumBudgetExhausted;
+  ORE->emit([&]() {
+    return OptimizationRemarkMissed(SV_NAME, "CompileTimeBudget",
+                                    F->getSubprogram(), &F->getEntryBlock())
+           << "SLP vectorization stopped after the compile-time budget of "
+           << ore::NV("Budget", CompileTimeBudget.getValue())
+           << " was used up";
+  });
+  return false;
+}
+
 namespace {
 /// Tracks the state we can represent the loads in the given sequence.
 enum class LoadsState { Gather, Vectorize, ScatterVectorize };
@@ -3617,6 +3663,14 @@ void BoUpSLP::buildTree_rec(ArrayRef<Value *> VL, unsigned Depth,
     return;
   }
 
+  if (!chargeBudget(VL.size())) {
+    LLVM_DEBUG(dbgs() << "SLP: Gathering due to compile-time budget.\n");
+    if (TryToFindDuplicates(S))
+      newTreeEntry(VL, None /*not vectorized*/, S, UserTreeIdx,
+                   ReuseShuffleIndicies);
+    return;
+  }
+
   // Don't handle scalable vectors
   if (S.getOpcode() == Instruction::ExtractElement &&
       isa<ScalableVectorType>(
@@ -5637,8 +5691,12 @@ InstructionCost BoUpSLP::getTreeCost(ArrayRef<Value *> VectorizedVals) {
 
   unsigned BundleWidth = VectorizableTree[0]->Scalars.size();
 
+  // The cost of the tree is still computed once the budget runs out: the tree
+  // is built by then, and its remaining entries are gathers.
+  chargeBudget(ExternalUses.size());
   for (unsigned I = 0, E = VectorizableTree.size(); I < E; ++I) {
     TreeEntry &TE = *VectorizableTree[I].get();
+    chargeBudget(TE.Scalars.size());
 
     InstructionCost C = getEntryCost(&TE, VectorizedVals);
     Cost += C;
@@ -8087,6 +8145,10 @@ bool SLPVectorizerPass::runImpl(Function &F, ScalarEvolution *SE_,
 
   // Scan the blocks in the function in post order.
   for (auto BB : post_order(&F.getEntryBlock())) {
+    // Stop looking for seeds once no more trees can be built.
+    if (R.isBudgetExhausted())
+      break;
+
     collectSeedInstructions(BB);
 
     // Vectorize trees that end at stores.
@@ -11,9 +11,11 @@
 //===----------------------------------------------------------------------===//
 #include "llvm/XRay/Trace.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/Sequence.h"
 #include "llvm/Support/DataExtractor.h"
 #include "llvm/Support/Error.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/XRay/BlockIndexer.h"
 #include "llvm/XRay/BlockVerifier.h"
 #include "llvm/XRay/FDRRecordConsumer.h"
@@ -304,45 +306,58 @@ Error loadFDRLog(StringRef Data, bool IsLittleEndian,
       return E;
   }
 
-  // Then we verify the consistency of the blocks.
-  {
-    for (auto &PTB : Index) {
-      auto &Blocks = PTB.second;
-      for (auto &B : Blocks) {
-        BlockVerifier Verifier;
-        for (auto *R : B.Records)
-          if (auto E = R->apply(Verifier))
-            return E;
-        if (auto E = Verifier.verify())
-          return E;
-      }
-    }
-  }
-
-  // This is now the meat of the algorithm. Here we sort the blocks according to
-  // the Walltime record in each of the blocks for the same thread. This allows
-  // us to more consistently recreate the execution trace in temporal order.
-  // After the sort, we then reconstitute `Trace` records using a stateful
-  // visitor associated with a single process+thread pair.
-  {
-    for (auto &PTB : Index) {
-      auto &Blocks = PTB.second;
-      llvm::sort(Blocks, [](const BlockIndexer::Block &L,
-                            const BlockIndexer::Block &R) {
-        return (L.WallclockTime->seconds() < R.WallclockTime->seconds() &&
-                L.WallclockTime->nanos() < R.WallclockTime->nanos());
-      });
-      auto Adder = [&](const XRayRecord &R) { Records.push_back(R); };
-      TraceExpander Expander(Adder, FileHeader.Version);
-      for (auto &B : Blocks) {
-        for (auto *R : B.Records)
-          if (auto E = R->apply(Expander))
-            return E;
-      }
-      if (auto E = Expander.flush())
-        return E;
-    }
-  }
+  // Then we verify the consistency of the blocks, and reconstitute the trace
+  // of each process+thread pair. The blocks of different threads are
+  // independent, so each pair is processed in parallel into its own list of
+  // records, and the lists are then concatenated in the order of the index so
+  // that the result does not depend on the number of threads.
+  std::vector<BlockIndexer::Index::value_type *> ThreadBlocks;
+  ThreadBlocks.reserve(Index.size());
+  for (auto &PTB : Index)
+    ThreadBlocks.push_back(&PTB);
+  std::vector<std::vector<XRayRecord>> ThreadRecords(ThreadBlocks.size());
+
+  if (auto E = parallelForEachError(
+          seq<size_t>(0, ThreadBlocks.size()), [&](size_t I) -> Error {
+            auto &Blocks = ThreadBlocks[I]->second;
+            for (auto &B : Blocks) {
+              BlockVerifier Verifier;
+              for (auto *R : B.Records)
+                if (auto E = R->apply(Verifier))
+                  return E;
+              if (auto E = Verifier.verify())
+                return E;
+            }
+
+            // This is now the meat of the algorithm. Here we sort the blocks
+            // according to the Walltime record in each of the blocks for the
+            // same thread. This allows us to more consistently recreate the
+            // execution trace in temporal order. After the sort, we then
+            // reconstitute `Trace` records using a stateful visitor associated
+            // with a single process+thread pair.
+            llvm::sort(Blocks, [](const BlockIndexer::Block &L,
+                                  const BlockIndexer::Block &R) {
+              return (L.WallclockTime->seconds() < R.WallclockTime->seconds() &&
+                      L.WallclockTime->nanos() < R.WallclockTime->nanos());
+            });
+            auto &Out = ThreadRecords[I];
+            auto Adder = [&](const XRayRecord &R) { Out.push_back(R); };
+            TraceExpander Expander(Adder, FileHeader.Version);
+            for (auto &B : Blocks) {
+              for (auto *R : B.Records)
+                if (auto E = R->apply(Expander))
+                  return E;
+            }
+            return Expander.flush();
+          }))
+    return E;
+
+  size_t NumRecords = Records.size();
+  for (auto &Out : ThreadRecords)
+    NumRecords += Out.size();
+  Records.reserve(NumRecords);
+  for (auto &Out : ThreadRecords)
+    Records.insert(Records.end(), Out.begin(), Out.end());
 
   return Error::success();
 }
@@ -156,6 +156,12 @@ static cl::opt<bool>
                           "manager and verify the result is the same."),
                  cl::init(false));
 
+static cl::opt<bool> AsyncOutput(
+    "async-output",
+    cl::desc("Write the output file on a background thread, so that code "
+             "generation does not wait for the file system"),
+    cl::init(false), cl::Hidden);
+
 static cl::opt<bool> DiscardValueNames(
     "discard-value-names",
     cl::desc("Discard names from Value (other than GlobalValue)."),
@@ -298,6 +304,12 @@ static std::unique_ptr<ToolOutputFile> GetOutputStream(const char *TargetName,
     return nullptr;
   }
 
+  // Assembly is written while functions are compiled, so its writes overlap
+  // code generation. Objects are written at the end, where the writes overlap
+  // serializing the later sections.
+  if (AsyncOutput)
+    FDOut->os().enableAsyncWrites();
+
   return FDOut;
 }
 
@@ -41,6 +41,10 @@
 
 #include "CoverageExporterLcov.h"
 #include "CoverageReport.h"
+#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
+#include <algorithm>
+#include <future>
 
 using namespace llvm;
 
@@ -196,10 +200,41 @@ void renderFile(raw_ostream &OS, const coverage::CoverageMapping &Coverage,
 void renderFiles(raw_ostream &OS, const coverage::CoverageMapping &Coverage,
                  ArrayRef<std::string> SourceFiles,
                  ArrayRef<FileCoverageSummary> FileReports,
-                 bool ExportSummaryOnly, bool SkipFunctions) {
-  for (unsigned I = 0, E = SourceFiles.size(); I < E; ++I)
-    renderFile(OS, Coverage, SourceFiles[I], FileReports[I], ExportSummaryOnly,
-               SkipFunctions);
+                 const CoverageViewOptions &Options) {
+  ThreadPoolStrategy S = hardware_concurrency(Options.NumThreads);
+  if (Options.NumThreads == 0) {
+    // If NumThreads is not specified, create one thread for each input, up to
+    // the number of hardware cores.
+    S = heavyweight_hardware_concurrency(SourceFiles.size());
+    S.Limit = true;
+  }
+  ThreadPool Pool(S);
+
+  // Every file is rendered into a buffer of its own, and the buffers are
+  // written out in order as they complete. Only a few files per thread are
+  // rendered ahead of the one being written, so the report is never held in
+  // memory as a whole.
+  size_t Window = 4 * size_t(Pool.getThreadCount());
+  std::vector<std::string> Buffers(SourceFiles.size());
+  std::vector<std::shared_future<void>> Rendered(SourceFiles.size());
+  auto RenderFile = [&](size_t I) {
+    Rendered[I] = Pool.async([&, I] {
+      raw_string_ostream BufOS(Buffers[I]);
+      renderFile(BufOS, Coverage, SourceFiles[I], FileReports[I],
+                 Options.ExportSummaryOnly, Options.SkipFunctions);
+    });
+  };
+
+  size_t Next = std::min(Window, SourceFiles.size());
+  for (size_t I = 0; I != Next; ++I)
+    RenderFile(I);
+  for (size_t I = 0, E = SourceFiles.size(); I != E; ++I) {
+    Rendered[I].wait();
+    OS << Buffers[I];
+    std::string().swap(Buffers[I]);
+    if (Next != E)
+      RenderFile(Next++);
+  }
 }
 
 } // end anonymous namespace
@@ -217,6 +252,5 @@ void CoverageExporterLcov::renderRoot(ArrayRef<std::string> SourceFiles) {
   FileCoverageSummary Totals = FileCoverageSummary("Totals");
   auto FileReports = CoverageReport::prepareFileReports(Coverage, Totals,
                                                         SourceFiles, Options);
-  renderFiles(OS, Coverage, SourceFiles, FileReports, Options.ExportSummaryOnly,
-              Options.SkipFunctions);
+  renderFiles(OS, Coverage, SourceFiles, FileReports, Options);
 }
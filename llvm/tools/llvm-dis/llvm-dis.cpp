@@ -74,6 +74,12 @@ static cl::opt<bool>
                                  "then materialize only the metadata"),
                         cl::cat(DisCategory));
 
+static cl::opt<unsigned>
+    NumThreads("num-threads",
+               cl::desc("Number of threads used to decode function bodies "
+                        "(0 = all available threads)"),
+               cl::init(1), cl::cat(DisCategory));
+
 static cl::opt<bool> PrintThinLTOIndexOnly(
     "print-thinlto-index-only",
     cl::desc("Only read thinlto index and print the index as LLVM assembly."),
@@ -199,6 +205,9 @@ int main(int argc, char **argv) {
             MB.getLazyModule(Context, MaterializeMetadata, SetImporting));
         if (MaterializeMetadata)
           ExitOnErr(M->materializeMetadata());
+        else if (NumThreads != 1)
+          ExitOnErr(
+              materializeAllInParallel(*M, hardware_concurrency(NumThreads)));
         else
           ExitOnErr(M->materializeAll());
       }
@@ -41,6 +41,7 @@
 #include "llvm/MC/MCSubtargetInfo.h"
 #include "llvm/MC/MCTargetOptionsCommandFlags.h"
 #include "llvm/MC/TargetRegistry.h"
+#include "llvm/MCA/BatchSimulator.h"
 #include "llvm/MCA/CodeEmitter.h"
 #include "llvm/MCA/Context.h"
 #include "llvm/MCA/CustomBehaviour.h"
@@ -58,8 +59,10 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Support/TargetSelect.h"
+#include "llvm/Support/ThreadPool.h"
 #include "llvm/Support/ToolOutputFile.h"
 #include "llvm/Support/WithColor.h"
+#include <mutex>
 
 using namespace llvm;
 
@@ -224,6 +227,21 @@ static cl::opt<bool> ShowBarriers(
     cl::desc("Print memory barrier information in the instruction info view"),
     cl::cat(ViewOptions), cl::init(false));
 
+static cl::opt<unsigned>
+    NumThreads("num-threads",
+               cl::desc("Number of threads used to simulate code regions "
+                        "(0 = all available threads)"),
+               cl::cat(ToolOptions), cl::init(1));
+
+static cl::alias NumThreadsA("j", cl::desc("Alias for --num-threads"),
+                             cl::aliasopt(NumThreads));
+
+static cl::opt<bool>
+    Batch("batch",
+          cl::desc("Print only the summary of each code region, as one line "
+                   "of JSON per region, as soon as the region is done"),
+          cl::cat(ToolOptions), cl::init(false));
+
 static cl::opt<bool> DisableCustomBehaviour(
     "disable-cb",
     cl::desc(
@@ -296,16 +314,297 @@ static void processViewOptions(bool IsOutOfOrder) {
 }
 
 // Returns true on success.
-static bool runPipeline(mca::Pipeline &P) {
+static bool runPipeline(mca::Pipeline &P, raw_ostream &ErrOS) {
   // Handle pipeline errors here.
   Expected<unsigned> Cycles = P.run();
   if (!Cycles) {
-    WithColor::error() << toString(Cycles.takeError());
+    WithColor::error(ErrOS) << toString(Cycles.takeError());
     return false;
   }
   return true;
 }
 
+namespace {
+
+/// Simulates code regions and prints their reports. The target objects are
+/// shared and only read, so that several RegionSimulators can run on
+/// different threads; everything which is mutated while a region is
+/// simulated or printed belongs to one RegionSimulator.
+class RegionSimulator {
+  const Target &TheTarget;
+  const MCSubtargetInfo &STI;
+  const MCInstrInfo &MCII;
+  const MCRegisterInfo &MRI;
+  const mca::PipelineOptions &PO;
+  bool IsOutOfOrder;
+
+  mca::InstrBuilder IB;
+  std::unique_ptr<MCInstPrinter> IP;
+  std::unique_ptr<MCCodeEmitter> MCE;
+  std::unique_ptr<MCAsmBackend> MAB;
+
+public:
+  RegionSimulator(const Target &T, const MCSubtargetInfo &STI,
+                  const MCInstrInfo &MCII, const MCRegisterInfo &MRI,
+                  const MCInstrAnalysis *MCIA, MCContext &Ctx,
+                  const mca::PipelineOptions &PO, bool IsOutOfOrder,
+                  std::unique_ptr<MCInstPrinter> IP)
+      : TheTarget(T), STI(STI), MCII(MCII), MRI(MRI), PO(PO),
+        IsOutOfOrder(IsOutOfOrder), IB(STI, MCII, MRI, MCIA),
+        IP(std::move(IP)) {
+    MCE.reset(TheTarget.createMCCodeEmitter(MCII, MRI, Ctx));
+    assert(MCE && "Unable to create code emitter!");
+    MAB.reset(TheTarget.createMCAsmBackend(
+        STI, MRI, mc::InitMCTargetOptionsFromFlags()));
+    assert(MAB && "Unable to create asm backend!");
+  }
+
+  /// Simulates Region, which is number RegionIdx in the output, and prints
+  /// its report to OS, or adds it to JSONOutput with -json. Errors and
+  /// warnings are printed to ErrOS. Returns true on success.
+  bool run(const mca::CodeRegion &Region, unsigned RegionIdx, raw_ostream &OS,
+           json::Object &JSONOutput, raw_ostream &ErrOS);
+};
+
+} // end of anonymous namespace
+
+bool RegionSimulator::run(const mca::CodeRegion &Region, unsigned RegionIdx,
+                          raw_ostream &OS, json::Object &JSONOutput,
+                          raw_ostream &ErrOS) {
+  const MCSchedModel &SM = STI.getSchedModel();
+
+  IB.clear();
+
+  // Lower the MCInst sequence into an mca::Instruction sequence.
+  ArrayRef<MCInst> Insts = Region.getInstructions();
+  mca::CodeEmitter CE(STI, *MAB, *MCE, Insts);
+
+  std::unique_ptr<mca::InstrPostProcess> IPP;
+  if (!DisableCustomBehaviour) {
+    IPP = std::unique_ptr<mca::InstrPostProcess>(
+        TheTarget.createInstrPostProcess(STI, MCII));
+  }
+  if (!IPP)
+    // If the target doesn't have its own IPP implemented (or the
+    // -disable-cb flag is set) then we use the base class
+    // (which does nothing).
+    IPP = std::make_unique<mca::InstrPostProcess>(STI, MCII);
+
+  SmallVector<std::unique_ptr<mca::Instruction>> LoweredSequence;
+  for (const MCInst &MCI : Insts) {
+    Expected<std::unique_ptr<mca::Instruction>> Inst =
+        IB.createInstruction(MCI);
+    if (!Inst) {
+      if (auto NewE = handleErrors(
+              Inst.takeError(),
+              [this, &ErrOS](const mca::InstructionError<MCInst> &IE) {
+                std::string InstructionStr;
+                raw_string_ostream SS(InstructionStr);
+                WithColor::error(ErrOS) << IE.Message << '\n';
+                IP->printInst(&IE.Inst, 0, "", STI, SS);
+                SS.flush();
+                WithColor::note(ErrOS)
+                    << "instruction: " << InstructionStr << '\n';
+              })) {
+        // Default case.
+        WithColor::error(ErrOS) << toString(std::move(NewE));
+      }
+      return false;
+    }
+
+    IPP->postProcessInstruction(Inst.get(), MCI);
+
+    LoweredSequence.emplace_back(std::move(Inst.get()));
+  }
+
+  mca::SourceMgr S(LoweredSequence, PrintInstructionTables ? 1 : Iterations);
+
+  if (PrintInstructionTables) {
+    //  Create a pipeline, stages, and a printer.
+    auto P = std::make_unique<mca::Pipeline>();
+    P->appendStage(std::make_unique<mca::EntryStage>(S));
+    P->appendStage(std::make_unique<mca::InstructionTables>(SM));
+
+    mca::PipelinePrinter Printer(*P, Region, RegionIdx, STI, PO);
+    if (PrintJson) {
+      Printer.addView(std::make_unique<mca::InstructionView>(STI, *IP, Insts));
+    }
+
+    // Create the views for this pipeline, execute, and emit a report.
+    if (PrintInstructionInfoView) {
+      Printer.addView(std::make_unique<mca::InstructionInfoView>(
+          STI, MCII, CE, ShowEncoding, Insts, *IP, LoweredSequence,
+          ShowBarriers));
+    }
+    Printer.addView(
+        std::make_unique<mca::ResourcePressureView>(STI, *IP, Insts));
+
+    if (!runPipeline(*P, ErrOS))
+      return false;
+
+    if (PrintJson) {
+      Printer.printReport(JSONOutput);
+    } else {
+      Printer.printReport(OS);
+    }
+
+    return true;
+  }
+
+  // Create the CustomBehaviour object for enforcing Target Specific
+  // behaviours and dependencies that aren't expressed well enough
+  // in the tablegen. CB cannot depend on the list of MCInst or
+  // the source code (but it can depend on the list of
+  // mca::Instruction or any objects that can be reconstructed
+  // from the target information).
+  std::unique_ptr<mca::CustomBehaviour> CB;
+  if (!DisableCustomBehaviour)
+    CB = std::unique_ptr<mca::CustomBehaviour>(
+        TheTarget.createCustomBehaviour(STI, S, MCII));
+  if (!CB)
+    // If the target doesn't have its own CB implemented (or the -disable-cb
+    // flag is set) then we use the base class (which does nothing).
+    CB = std::make_unique<mca::CustomBehaviour>(STI, S, MCII);
+
+  // Create a context to control ownership of the pipeline hardware.
+  mca::Context MCA(MRI, STI);
+
+  // Create a basic pipeline simulating an out-of-order backend.
+  auto P = MCA.createDefaultPipeline(PO, S, *CB);
+
+  mca::PipelinePrinter Printer(*P, Region, RegionIdx, STI, PO);
+
+  // Targets can define their own custom Views that exist within their
+  // /lib/Target/ directory so that the View can utilize their CustomBehaviour
+  // or other backend symbols / functionality that are not already exposed
+  // through one of the MC-layer classes. These Views will be initialized
+  // using the CustomBehaviour::getViews() variants.
+  // If a target makes a custom View that does not depend on their target
+  // CB or their backend, they should put the View within
+  // /tools/llvm-mca/Views/ instead.
+  if (!DisableCustomBehaviour) {
+    std::vector<std::unique_ptr<mca::View>> CBViews =
+        CB->getStartViews(*IP, Insts);
+    for (auto &CBView : CBViews)
+      Printer.addView(std::move(CBView));
+  }
+
+  // When we output JSON, we add a view that contains the instructions
+  // and CPU resource information.
+  if (PrintJson) {
+    auto IV = std::make_unique<mca::InstructionView>(STI, *IP, Insts);
+    Printer.addView(std::move(IV));
+  }
+
+  if (PrintSummaryView)
+    Printer.addView(
+        std::make_unique<mca::SummaryView>(SM, Insts, DispatchWidth));
+
+  if (EnableBottleneckAnalysis) {
+    if (!IsOutOfOrder) {
+      WithColor::warning(ErrOS)
+          << "bottleneck analysis is not supported for in-order CPU '" << MCPU
+          << "'.\n";
+    }
+    Printer.addView(std::make_unique<mca::BottleneckAnalysis>(
+        STI, *IP, Insts, S.getNumIterations()));
+  }
+
+  if (PrintInstructionInfoView)
+    Printer.addView(std::make_unique<mca::InstructionInfoView>(
+        STI, MCII, CE, ShowEncoding, Insts, *IP, LoweredSequence,
+        ShowBarriers));
+
+  // Fetch custom Views that are to be placed after the InstructionInfoView.
+  // Refer to the comment paired with the CB->getStartViews(*IP, Insts); line
+  // for more info.
+  if (!DisableCustomBehaviour) {
+    std::vector<std::unique_ptr<mca::View>> CBViews =
+        CB->getPostInstrInfoViews(*IP, Insts);
+    for (auto &CBView : CBViews)
+      Printer.addView(std::move(CBView));
+  }
+
+  if (PrintDispatchStats)
+    Printer.addView(std::make_unique<mca::DispatchStatistics>());
+
+  if (PrintSchedulerStats)
+    Printer.addView(std::make_unique<mca::SchedulerStatistics>(STI));
+
+  if (PrintRetireStats)
+    Printer.addView(std::make_unique<mca::RetireControlUnitStatistics>(SM));
+
+  if (PrintRegisterFileStats)
+    Printer.addView(std::make_unique<mca::RegisterFileStatistics>(STI));
+
+  if (PrintResourcePressureView)
+    Printer.addView(
+        std::make_unique<mca::ResourcePressureView>(STI, *IP, Insts));
+
+  if (PrintTimelineView) {
+    unsigned TimelineIterations =
+        TimelineMaxIterations ? TimelineMaxIterations : 10;
+    Printer.addView(std::make_unique<mca::TimelineView>(
+        STI, *IP, Insts, std::min(TimelineIterations, S.getNumIterations()),
+        TimelineMaxCycles));
+  }
+
+  // Fetch custom Views that are to be placed after all other Views.
+  // Refer to the comment paired with the CB->getStartViews(*IP, Insts); line
+  // for more info.
+  if (!DisableCustomBehaviour) {
+    std::vector<std::unique_ptr<mca::View>> CBViews =
+        CB->getEndViews(*IP, Insts);
+    for (auto &CBView : CBViews)
+      Printer.addView(std::move(CBView));
+  }
+
+  if (!runPipeline(*P, ErrOS))
+    return false;
+
+  if (PrintJson) {
+    Printer.printReport(JSONOutput);
+  } else {
+    Printer.printReport(OS);
+  }
+
+  return true;
+}
+
+/// Simulates every region with mca::BatchSimulator and prints one line of
+/// JSON per region, in order, as soon as the region is done. Returns true if
+/// every region could be simulated.
+static bool runBatch(const Target &TheTarget, const MCSubtargetInfo &STI,
+                     const MCInstrInfo &MCII, const MCRegisterInfo &MRI,
+                     const MCInstrAnalysis *MCIA,
+                     const mca::PipelineOptions &PO,
+                     ArrayRef<const mca::CodeRegion *> Regions,
+                     raw_ostream &OS) {
+  mca::BatchSimulator Simulator(TheTarget, STI, MCII, MRI, MCIA, PO,
+                                Iterations, !DisableCustomBehaviour);
+  std::vector<ArrayRef<MCInst>> Blocks;
+  Blocks.reserve(Regions.size());
+  for (const mca::CodeRegion *Region : Regions)
+    Blocks.push_back(Region->getInstructions());
+
+  bool Succeeded = true;
+  Simulator.simulate(
+      Blocks, NumThreads,
+      [&](unsigned RegionIdx, Expected<mca::BlockSummary> Summary) {
+        json::Object JO({{"Index", RegionIdx},
+                         {"Name", Regions[RegionIdx]->getDescription()}});
+        if (Summary) {
+          JO.try_emplace("SummaryView", *Summary);
+        } else {
+          Succeeded = false;
+          JO.try_emplace("Error", toString(Summary.takeError()));
+        }
+        OS << formatv("{0}", json::Value(std::move(JO))) << '\n';
+        OS.flush();
+      });
+  return Succeeded;
+}
+
 int main(int argc, char **argv) {
   InitLLVM X(argc, argv);
 
@@ -463,230 +762,105 @@ int main(int argc, char **argv) {
 
   std::unique_ptr<ToolOutputFile> TOF = std::move(*OF);
 
-  const MCSchedModel &SM = STI->getSchedModel();
-
-  // Create an instruction builder.
-  mca::InstrBuilder IB(*STI, *MCII, *MRI, MCIA.get());
-
-  // Create a context to control ownership of the pipeline hardware.
-  mca::Context MCA(*MRI, *STI);
-
   mca::PipelineOptions PO(MicroOpQueue, DecoderThroughput, DispatchWidth,
                           RegisterFileSize, LoadQueueSize, StoreQueueSize,
                           AssumeNoAlias, EnableBottleneckAnalysis);
 
-  // Number each region in the sequence.
-  unsigned RegionIdx = 0;
-
-  std::unique_ptr<MCCodeEmitter> MCE(
-      TheTarget->createMCCodeEmitter(*MCII, *MRI, Ctx));
-  assert(MCE && "Unable to create code emitter!");
-
-  std::unique_ptr<MCAsmBackend> MAB(TheTarget->createMCAsmBackend(
-      *STI, *MRI, mc::InitMCTargetOptionsFromFlags()));
-  assert(MAB && "Unable to create asm backend!");
-
-  json::Object JSONOutput;
-  for (const std::unique_ptr<mca::CodeRegion> &Region : Regions) {
-    // Skip empty code regions.
-    if (Region->empty())
-      continue;
-
-    IB.clear();
-
-    // Lower the MCInst sequence into an mca::Instruction sequence.
-    ArrayRef<MCInst> Insts = Region->getInstructions();
-    mca::CodeEmitter CE(*STI, *MAB, *MCE, Insts);
+  // Number each non-empty region in the sequence.
+  std::vector<const mca::CodeRegion *> RegionsToRun;
+  for (const std::unique_ptr<mca::CodeRegion> &Region : Regions)
+    if (!Region->empty())
+      RegionsToRun.push_back(Region.get());
+
+  if (Batch) {
+    bool Succeeded = runBatch(*TheTarget, *STI, *MCII, *MRI, MCIA.get(), PO,
+                              RegionsToRun, TOF->os());
+    TOF->keep();
+    return Succeeded ? 0 : 1;
+  }
 
-    std::unique_ptr<mca::InstrPostProcess> IPP;
-    if (!DisableCustomBehaviour) {
-      IPP = std::unique_ptr<mca::InstrPostProcess>(
-          TheTarget->createInstrPostProcess(*STI, *MCII));
+  // Every thread simulates regions with a RegionSimulator of its own. The
+  // first one uses the instruction printer created above.
+  std::mutex SimulatorsLock;
+  std::vector<std::unique_ptr<RegionSimulator>> FreeSimulators;
+  auto TakeSimulator = [&]() {
+    std::lock_guard<std::mutex> Lock(SimulatorsLock);
+    if (!FreeSimulators.empty()) {
+      std::unique_ptr<RegionSimulator> Sim = std::move(FreeSimulators.back());
+      FreeSimulators.pop_back();
+      return Sim;
     }
-    if (!IPP)
-      // If the target doesn't have its own IPP implemented (or the
-      // -disable-cb flag is set) then we use the base class
-      // (which does nothing).
-      IPP = std::make_unique<mca::InstrPostProcess>(*STI, *MCII);
-
-    SmallVector<std::unique_ptr<mca::Instruction>> LoweredSequence;
-    for (const MCInst &MCI : Insts) {
-      Expected<std::unique_ptr<mca::Instruction>> Inst =
-          IB.createInstruction(MCI);
-      if (!Inst) {
-        if (auto NewE = handleErrors(
-                Inst.takeError(),
-                [&IP, &STI](const mca::InstructionError<MCInst> &IE) {
-                  std::string InstructionStr;
-                  raw_string_ostream SS(InstructionStr);
-                  WithColor::error() << IE.Message << '\n';
-                  IP->printInst(&IE.Inst, 0, "", *STI, SS);
-                  SS.flush();
-                  WithColor::note()
-                      << "instruction: " << InstructionStr << '\n';
-                })) {
-          // Default case.
-          WithColor::error() << toString(std::move(NewE));
-        }
-        return 1;
-      }
-
-      IPP->postProcessInstruction(Inst.get(), MCI);
-
-      LoweredSequence.emplace_back(std::move(Inst.get()));
+    std::unique_ptr<MCInstPrinter> SimIP = std::move(IP);
+    if (!SimIP) {
+      SimIP.reset(TheTarget->createMCInstPrinter(
+          Triple(TripleName), AssemblerDialect, *MAI, *MCII, *MRI));
+      SimIP->setPrintImmHex(PrintImmHex);
     }
+    return std::make_unique<RegionSimulator>(*TheTarget, *STI, *MCII, *MRI,
+                                             MCIA.get(), Ctx, PO, IsOutOfOrder,
+                                             std::move(SimIP));
+  };
+  auto ReturnSimulator = [&](std::unique_ptr<RegionSimulator> Sim) {
+    std::lock_guard<std::mutex> Lock(SimulatorsLock);
+    FreeSimulators.push_back(std::move(Sim));
+  };
 
-    mca::SourceMgr S(LoweredSequence, PrintInstructionTables ? 1 : Iterations);
-
-    if (PrintInstructionTables) {
-      //  Create a pipeline, stages, and a printer.
-      auto P = std::make_unique<mca::Pipeline>();
-      P->appendStage(std::make_unique<mca::EntryStage>(S));
-      P->appendStage(std::make_unique<mca::InstructionTables>(SM));
-
-      mca::PipelinePrinter Printer(*P, *Region, RegionIdx, *STI, PO);
-      if (PrintJson) {
-        Printer.addView(
-            std::make_unique<mca::InstructionView>(*STI, *IP, Insts));
-      }
-
-      // Create the views for this pipeline, execute, and emit a report.
-      if (PrintInstructionInfoView) {
-        Printer.addView(std::make_unique<mca::InstructionInfoView>(
-            *STI, *MCII, CE, ShowEncoding, Insts, *IP, LoweredSequence,
-            ShowBarriers));
-      }
-      Printer.addView(
-          std::make_unique<mca::ResourcePressureView>(*STI, *IP, Insts));
-
-      if (!runPipeline(*P))
+  json::Object JSONOutput;
+  if (NumThreads == 1 || RegionsToRun.size() < 2) {
+    std::unique_ptr<RegionSimulator> Sim = TakeSimulator();
+    for (unsigned RegionIdx = 0, E = RegionsToRun.size(); RegionIdx != E;
+         ++RegionIdx)
+      if (!Sim->run(*RegionsToRun[RegionIdx], RegionIdx, TOF->os(), JSONOutput,
+                    errs()))
         return 1;
-
-      if (PrintJson) {
-        Printer.printReport(JSONOutput);
-      } else {
-        Printer.printReport(TOF->os());
-      }
-
-      ++RegionIdx;
-      continue;
-    }
-
-    // Create the CustomBehaviour object for enforcing Target Specific
-    // behaviours and dependencies that aren't expressed well enough
-    // in the tablegen. CB cannot depend on the list of MCInst or
-    // the source code (but it can depend on the list of
-    // mca::Instruction or any objects that can be reconstructed
-    // from the target information).
-    std::unique_ptr<mca::CustomBehaviour> CB;
-    if (!DisableCustomBehaviour)
-      CB = std::unique_ptr<mca::CustomBehaviour>(
-          TheTarget->createCustomBehaviour(*STI, S, *MCII));
-    if (!CB)
-      // If the target doesn't have its own CB implemented (or the -disable-cb
-      // flag is set) then we use the base class (which does nothing).
-      CB = std::make_unique<mca::CustomBehaviour>(*STI, S, *MCII);
-
-    // Create a basic pipeline simulating an out-of-order backend.
-    auto P = MCA.createDefaultPipeline(PO, S, *CB);
-
-    mca::PipelinePrinter Printer(*P, *Region, RegionIdx, *STI, PO);
-
-    // Targets can define their own custom Views that exist within their
-    // /lib/Target/ directory so that the View can utilize their CustomBehaviour
-    // or other backend symbols / functionality that are not already exposed
-    // through one of the MC-layer classes. These Views will be initialized
-    // using the CustomBehaviour::getViews() variants.
-    // If a target makes a custom View that does not depend on their target
-    // CB or their backend, they should put the View within
-    // /tools/llvm-mca/Views/ instead.
-    if (!DisableCustomBehaviour) {
-      std::vector<std::unique_ptr<mca::View>> CBViews =
-          CB->getStartViews(*IP, Insts);
-      for (auto &CBView : CBViews)
-        Printer.addView(std::move(CBView));
-    }
-
-    // When we output JSON, we add a view that contains the instructions
-    // and CPU resource information.
-    if (PrintJson) {
-      auto IV = std::make_unique<mca::InstructionView>(*STI, *IP, Insts);
-      Printer.addView(std::move(IV));
-    }
-
-    if (PrintSummaryView)
-      Printer.addView(
-          std::make_unique<mca::SummaryView>(SM, Insts, DispatchWidth));
-
-    if (EnableBottleneckAnalysis) {
-      if (!IsOutOfOrder) {
-        WithColor::warning()
-            << "bottleneck analysis is not supported for in-order CPU '" << MCPU
-            << "'.\n";
-      }
-      Printer.addView(std::make_unique<mca::BottleneckAnalysis>(
-          *STI, *IP, Insts, S.getNumIterations()));
-    }
-
-    if (PrintInstructionInfoView)
-      Printer.addView(std::make_unique<mca::InstructionInfoView>(
-          *STI, *MCII, CE, ShowEncoding, Insts, *IP, LoweredSequence,
-          ShowBarriers));
-
-    // Fetch custom Views that are to be placed after the InstructionInfoView.
-    // Refer to the comment paired with the CB->getStartViews(*IP, Insts); line
-    // for more info.
-    if (!DisableCustomBehaviour) {
-      std::vector<std::unique_ptr<mca::View>> CBViews =
-          CB->getPostInstrInfoViews(*IP, Insts);
-      for (auto &CBView : CBViews)
-        Printer.addView(std::move(CBView));
-    }
-
-    if (PrintDispatchStats)
-      Printer.addView(std::make_unique<mca::DispatchStatistics>());
-
-    if (PrintSchedulerStats)
-      Printer.addView(std::make_unique<mca::SchedulerStatistics>(*STI));
-
-    if (PrintRetireStats)
-      Printer.addView(std::make_unique<mca::RetireControlUnitStatistics>(SM));
-
-    if (PrintRegisterFileStats)
-      Printer.addView(std::make_unique<mca::RegisterFileStatistics>(*STI));
-
-    if (PrintResourcePressureView)
-      Printer.addView(
-          std::make_unique<mca::ResourcePressureView>(*STI, *IP, Insts));
-
-    if (PrintTimelineView) {
-      unsigned TimelineIterations =
-          TimelineMaxIterations ? TimelineMaxIterations : 10;
-      Printer.addView(std::make_unique<mca::TimelineView>(
-          *STI, *IP, Insts, std::min(TimelineIterations, S.getNumIterations()),
-          TimelineMaxCycles));
-    }
-
-    // Fetch custom Views that are to be placed after all other Views.
-    // Refer to the comment paired with the CB->getStartViews(*IP, Insts); line
-    // for more info.
-    if (!DisableCustomBehaviour) {
-      std::vector<std::unique_ptr<mca::View>> CBViews =
-          CB->getEndViews(*IP, Insts);
-      for (auto &CBView : CBViews)
-        Printer.addView(std::move(CBView));
-    }
-
-    if (!runPipeline(*P))
-      return 1;
-
-    if (PrintJson) {
-      Printer.printReport(JSONOutput);
-    } else {
-      Printer.printReport(TOF->os());
+  } else {
+    // Simulate the regions in parallel into buffers, and print them in order
+    // as soon as they and the regions before them are done.
+    struct RegionOutput {
+      std::string Report;
+      std::string Diagnostics;
+      json::Object JSONReport;
+      bool Succeeded = false;
+    };
+    std::vector<RegionOutput> Outputs(RegionsToRun.size());
+    std::vector<std::shared_future<void>> Done;
+    Done.reserve(RegionsToRun.size());
+
+    ThreadPool Pool(hardware_concurrency(NumThreads));
+    for (unsigned RegionIdx = 0, E = RegionsToRun.size(); RegionIdx != E;
+         ++RegionIdx)
+      Done.push_back(Pool.async([&, RegionIdx] {
+        RegionOutput &Out = Outputs[RegionIdx];
+        raw_string_ostream OS(Out.Report);
+        raw_string_ostream ErrOS(Out.Diagnostics);
+        // Only the first region creates the array of regions.
+        if (RegionIdx)
+          Out.JSONReport.try_emplace("CodeRegions", json::Array());
+        std::unique_ptr<RegionSimulator> Sim = TakeSimulator();
+        Out.Succeeded = Sim->run(*RegionsToRun[RegionIdx], RegionIdx, OS,
+                                 Out.JSONReport, ErrOS);
+        ReturnSimulator(std::move(Sim));
+      }));
+
+    for (unsigned RegionIdx = 0, E = RegionsToRun.size(); RegionIdx != E;
+         ++RegionIdx) {
+      Done[RegionIdx].wait();
+      RegionOutput &Out = Outputs[RegionIdx];
+      errs() << Out.Diagnostics;
+      // The pool waits for the regions which are still running when it goes
+      // out of scope, before the objects they use do.
+      if (!Out.Succeeded)
+        return 1;
+      if (!PrintJson)
+        TOF->os() << Out.Report;
+      else if (!RegionIdx)
+        JSONOutput = std::move(Out.JSONReport);
+      else
+        JSONOutput.getArray("CodeRegions")
+            ->push_back(
+                std::move((*Out.JSONReport.getArray("CodeRegions"))[0]));
+      Out = RegionOutput();
     }
-
-    ++RegionIdx;
   }
 
   if (PrintJson)
@@ -33,6 +33,7 @@
 #include "llvm/Support/ErrorOr.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/Memory.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 #include <algorithm>
@@ -44,6 +45,7 @@
 #include <string>
 #include <system_error>
 #include <utility>
+#include <vector>
 
 using namespace llvm;
 using namespace llvm::ELF;
@@ -507,15 +509,34 @@ static Error replaceAndRemoveSections(const CommonConfig &Config,
     return E;
 
   if (Config.CompressionType != DebugCompressionType::None) {
+    // Compress all the sections in parallel first, since that is where the
+    // time goes for large debug sections, and only add them to the object,
+    // which is not thread-safe, afterwards.
+    SmallVector<const SectionBase *, 13> ToCompress;
+    for (const SectionBase &Sec : Obj.sections())
+      if (isCompressable(Sec))
+        ToCompress.push_back(&Sec);
+    std::vector<Optional<Expected<CompressedSection>>> Compressed(
+        ToCompress.size());
+    parallelForEachN(0, ToCompress.size(), [&](size_t I) {
+      Compressed[I].emplace(
+          CompressedSection::create(*ToCompress[I], Config.CompressionType));
+    });
+    Error CompressErr = Error::success();
+    for (Optional<Expected<CompressedSection>> &NewSection : Compressed)
+      if (!*NewSection)
+        CompressErr =
+            joinErrors(std::move(CompressErr), NewSection->takeError());
+    if (CompressErr)
+      return CompressErr;
+
+    size_t Next = 0;
     if (Error Err = replaceDebugSections(
             Obj, isCompressable,
-            [&Config, &Obj](const SectionBase *S) -> Expected<SectionBase *> {
-              Expected<CompressedSection> NewSection =
-                  CompressedSection::create(*S, Config.CompressionType);
-              if (!NewSection)
-                return NewSection.takeError();
-
-              return &Obj.addSection<CompressedSection>(std::move(*NewSection));
+            [&](const SectionBase *S) -> Expected<SectionBase *> {
+              assert(ToCompress[Next] == S && "sections visited out of order");
+              return &Obj.addSection<CompressedSection>(
+                  std::move(**Compressed[Next++]));
             }))
       return Err;
   } else if (Config.DecompressDebugSections) {
@@ -20,6 +20,7 @@
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileOutputBuffer.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/Path.h"
 #include <algorithm>
 #include <cstddef>
@@ -2099,15 +2100,28 @@ template <class ELFT> void ELFWriter<ELFT>::writeShdrs() {
 }
 
 template <class ELFT> Error ELFWriter<ELFT>::writeSectionData() {
-  for (SectionBase &Sec : Obj.sections())
-    // Segments are responsible for writing their contents, so only write the
-    // section data if the section is not in a segment. Note that this renders
-    // sections in segments effectively immutable.
+  // Segments are responsible for writing their contents, so only write the
+  // section data if the section is not in a segment. Note that this renders
+  // sections in segments effectively immutable.
+  std::vector<const SectionBase *> ToWrite;
+  for (const SectionBase &Sec : Obj.sections())
     if (Sec.ParentSegment == nullptr)
-      if (Error Err = Sec.accept(*SecWriter))
-        return Err;
+      ToWrite.push_back(&Sec);
+
+  // The sections do not overlap in the output and the section writer has no
+  // state of its own, so copying and decompressing them can run in parallel.
+  std::vector<Error> Errors;
+  Errors.reserve(ToWrite.size());
+  for (size_t I = 0, E = ToWrite.size(); I != E; ++I)
+    Errors.push_back(Error::success());
+  parallelForEachN(0, ToWrite.size(), [&](size_t I) {
+    Errors[I] = ToWrite[I]->accept(*SecWriter);
+  });
 
-  return Error::success();
+  Error Err = Error::success();
+  for (Error &E : Errors)
+    Err = joinErrors(std::move(Err), std::move(E));
+  return Err;
 }
 
 template <class ELFT> void ELFWriter<ELFT>::writeSegmentData() {
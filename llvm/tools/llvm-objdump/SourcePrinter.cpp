@@ -369,12 +369,21 @@ void SourcePrinter::printSourceLine(formatted_raw_ostream &OS,
   if (!Symbolizer)
     return;
 
+  // All the instructions in a row of the line table have the same line info.
+  auto Row = llvm::partition_point(CachedRows, [&](const CachedRow &R) {
+    return R.End <= Address.Address;
+  });
+  if (Row != CachedRows.end() && Row->Begin > Address.Address)
+    Row = CachedRows.end();
+
   DILineInfo LineInfo = DILineInfo();
-  Expected<DILineInfo> ExpectedLineInfo =
-      Symbolizer->symbolizeCode(*Obj, Address);
-  std::string ErrorMessage;
-  if (ExpectedLineInfo) {
+  if (Row != CachedRows.end() && Row->Info) {
+    LineInfo = *Row->Info;
+  } else if (Expected<DILineInfo> ExpectedLineInfo =
+                 Symbolizer->symbolizeCode(*Obj, Address)) {
     LineInfo = *ExpectedLineInfo;
+    if (Row != CachedRows.end())
+      Row->Info = LineInfo;
   } else if (!WarnedInvalidDebugInfo) {
     WarnedInvalidDebugInfo = true;
     // TODO Untested.
@@ -419,6 +428,39 @@ void SourcePrinter::printSourceLine(formatted_raw_ostream &OS,
   OldLineInfo = LineInfo;
 }
 
+void SourcePrinter::cacheLineInfo(object::SectionedAddress Address,
+                                  uint64_t Size) {
+  CachedRows.clear();
+  if (!Symbolizer)
+    return;
+
+  if (!DICtx)
+    DICtx = DWARFContext::create(*Obj);
+  DWARFCompileUnit *CU = DICtx->getCompileUnitForAddress(Address.Address);
+  if (!CU)
+    return;
+  const DWARFDebugLine::LineTable *LineTable = DICtx->getLineTableForUnit(CU);
+  std::vector<uint32_t> RowIndices;
+  if (!LineTable ||
+      !LineTable->lookupAddressRange(Address, Size, RowIndices))
+    return;
+
+  // A row covers the addresses up to the next row of its sequence, which is
+  // the row after it in the table. The last row of a sequence only marks its
+  // end.
+  for (uint32_t I : RowIndices) {
+    const DWARFDebugLine::Row &Row = LineTable->Rows[I];
+    if (Row.EndSequence || I + 1 >= LineTable->Rows.size())
+      continue;
+    uint64_t End = LineTable->Rows[I + 1].Address.Address;
+    if (Row.Address.Address < End)
+      CachedRows.push_back({Row.Address.Address, End, None});
+  }
+  llvm::sort(CachedRows, [](const CachedRow &LHS, const CachedRow &RHS) {
+    return LHS.Begin < RHS.Begin;
+  });
+}
+
 void SourcePrinter::printLines(formatted_raw_ostream &OS,
                                const DILineInfo &LineInfo, StringRef Delimiter,
                                LiveVariablePrinter &LVP) {
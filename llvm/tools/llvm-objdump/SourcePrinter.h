@@ -138,6 +138,18 @@ protected:
   StringSet<> MissingSources;
   // Only emit 'invalid debug info' warning once.
   bool WarnedInvalidDebugInfo = false;
+  // Debug info for finding the line table rows of the range being
+  // disassembled. Created on first use.
+  std::unique_ptr<DWARFContext> DICtx;
+  // The address ranges [Begin, End) of the rows of the line table covering
+  // the range being disassembled, sorted by address, with the line info of
+  // each once it is known.
+  struct CachedRow {
+    uint64_t Begin;
+    uint64_t End;
+    Optional<DILineInfo> Info;
+  };
+  std::vector<CachedRow> CachedRows;
 
 private:
   bool cacheSource(const DILineInfo &LineInfoFile);
@@ -153,6 +165,10 @@ public:
   SourcePrinter() = default;
   SourcePrinter(const object::ObjectFile *Obj, StringRef DefaultArch);
   virtual ~SourcePrinter() = default;
+  /// Looks up the line table rows covering [Address, Address + Size), which
+  /// is about to be disassembled. printSourceLine then symbolizes only the
+  /// first instruction of each row and reuses its line info for the others.
+  void cacheLineInfo(object::SectionedAddress Address, uint64_t Size);
   virtual void printSourceLine(formatted_raw_ostream &OS,
                                object::SectionedAddress Address,
                                StringRef ObjectFilename,
@@ -1403,6 +1403,11 @@ static void disassembleObject(const Target *TheTarget, const ObjectFile *Obj,
       bool DumpARMELFData = false;
       formatted_raw_ostream FOS(outs());
 
+      if ((PrintSource || PrintLines) && Index < End)
+        SP.cacheLineInfo(
+            {SectionAddr + Index + VMAAdjustment, Section.getIndex()},
+            End - Index);
+
       std::unordered_map<uint64_t, std::string> AllLabels;
       if (SymbolizeOperands)
         collectLocalBranchTargets(Bytes, MIA, DisAsm, IP, PrimarySTI,
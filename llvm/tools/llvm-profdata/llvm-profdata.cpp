@@ -36,6 +36,7 @@
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/WithColor.h"
 #include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/xxhash.h"
 #include <algorithm>
 
 using namespace llvm;
@@ -234,11 +235,14 @@ static void overlapInput(const std::string &BaseFilename,
   }
 }
 
-/// Load an input into a writer context.
+/// Load an input into the writer contexts in \p Shards. Each function goes to
+/// the context its name hashes to, so every function is only kept once however
+/// many contexts the inputs are loaded into. The first context also keeps the
+/// errors and the kind of the profile.
 static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
                       const InstrProfCorrelator *Correlator,
-                      WriterContext *WC) {
-  std::unique_lock<std::mutex> CtxGuard{WC->Lock};
+                      ArrayRef<WriterContext *> Shards) {
+  WriterContext *WC = Shards.front();
 
   // Copy the filename, because llvm::ThreadPool copied the input "const
   // WeightedFile &" by value, making a reference to the filename within it
@@ -249,47 +253,76 @@ static void loadInput(const WeightedFile &Input, SymbolRemapper *Remapper,
   if (Error E = ReaderOrErr.takeError()) {
     // Skip the empty profiles by returning sliently.
     instrprof_error IPE = InstrProfError::take(std::move(E));
-    if (IPE != instrprof_error::empty_raw_profile)
+    if (IPE != instrprof_error::empty_raw_profile) {
+      std::unique_lock<std::mutex> CtxGuard{WC->Lock};
       WC->Errors.emplace_back(make_error<InstrProfError>(IPE), Filename);
+    }
     return;
   }
 
   auto Reader = std::move(ReaderOrErr.get());
-  bool IsIRProfile = Reader->isIRLevelProfile();
-  bool HasCSIRProfile = Reader->hasCSIRLevelProfile();
-  if (Error E = WC->Writer.setIsIRLevelProfile(IsIRProfile, HasCSIRProfile)) {
-    consumeError(std::move(E));
-    WC->Errors.emplace_back(
-        make_error<StringError>(
-            "Merge IR generated profile with Clang generated profile.",
-            std::error_code()),
-        Filename);
-    return;
-  }
-  WC->Writer.setInstrEntryBBEnabled(Reader->instrEntryBBEnabled());
+  {
+    std::unique_lock<std::mutex> CtxGuard{WC->Lock};
+    bool IsIRProfile = Reader->isIRLevelProfile();
+    bool HasCSIRProfile = Reader->hasCSIRLevelProfile();
+    if (Error E =
+            WC->Writer.setIsIRLevelProfile(IsIRProfile, HasCSIRProfile)) {
+      consumeError(std::move(E));
+      WC->Errors.emplace_back(
+          make_error<StringError>(
+              "Merge IR generated profile with Clang generated profile.",
+              std::error_code()),
+          Filename);
+      return;
+    }
+    WC->Writer.setInstrEntryBBEnabled(Reader->instrEntryBBEnabled());
+  }
+
+  // Hand the records to their contexts in batches, so that the loaders take
+  // the lock of a context once per batch rather than once per record. The
+  // names of the records point into the reader, so every batch is handed over
+  // before it goes away.
+  const size_t BatchSize = 256;
+  std::vector<std::vector<NamedInstrProfRecord>> Batches(Shards.size());
+  auto AddBatch = [&](size_t Shard) {
+    WriterContext *SWC = Shards[Shard];
+    std::unique_lock<std::mutex> CtxGuard{SWC->Lock};
+    for (NamedInstrProfRecord &I : Batches[Shard]) {
+      const StringRef FuncName = I.Name;
+      bool Reported = false;
+      SWC->Writer.addRecord(std::move(I), Input.Weight, [&](Error E) {
+        if (Reported) {
+          consumeError(std::move(E));
+          return;
+        }
+        Reported = true;
+        // Only show hint the first time an error occurs.
+        instrprof_error IPE = InstrProfError::take(std::move(E));
+        std::unique_lock<std::mutex> ErrGuard{SWC->ErrLock};
+        bool firstTime = SWC->WriterErrorCodes.insert(IPE).second;
+        handleMergeWriterError(make_error<InstrProfError>(IPE),
+                               Input.Filename, FuncName, firstTime);
+      });
+    }
+    Batches[Shard].clear();
+  };
 
   for (auto &I : *Reader) {
     if (Remapper)
       I.Name = (*Remapper)(I.Name);
-    const StringRef FuncName = I.Name;
-    bool Reported = false;
-    WC->Writer.addRecord(std::move(I), Input.Weight, [&](Error E) {
-      if (Reported) {
-        consumeError(std::move(E));
-        return;
-      }
-      Reported = true;
-      // Only show hint the first time an error occurs.
-      instrprof_error IPE = InstrProfError::take(std::move(E));
-      std::unique_lock<std::mutex> ErrGuard{WC->ErrLock};
-      bool firstTime = WC->WriterErrorCodes.insert(IPE).second;
-      handleMergeWriterError(make_error<InstrProfError>(IPE), Input.Filename,
-                             FuncName, firstTime);
-    });
+    size_t Shard = Shards.size() == 1 ? 0 : xxHash64(I.Name) % Shards.size();
+    Batches[Shard].push_back(std::move(I));
+    if (Batches[Shard].size() == BatchSize)
+      AddBatch(Shard);
   }
+  for (size_t Shard = 0, E = Shards.size(); Shard != E; ++Shard)
+    AddBatch(Shard);
+
   if (Reader->hasError())
-    if (Error E = Reader->getError())
+    if (Error E = Reader->getError()) {
+      std::unique_lock<std::mutex> CtxGuard{WC->Lock};
       WC->Errors.emplace_back(std::move(E), Filename);
+    }
 }
 
 /// Merge the \p Src writer context into \p Dst.
@@ -354,48 +387,36 @@ static void mergeInstrProfile(const WeightedFileVector &Inputs,
   if (NumThreads == 0)
     NumThreads = std::min(hardware_concurrency().compute_thread_count(),
                           unsigned((Inputs.size() + 1) / 2));
-  // FIXME: There's a bug here, where setting NumThreads = Inputs.size() fails
-  // the merge_empty_profile.test because the InstrProfWriter.ProfileKind isn't
-  // merged, thus the emitted file ends up with a PF_Unknown kind.
 
   // Initialize the writer contexts.
   SmallVector<std::unique_ptr<WriterContext>, 4> Contexts;
-  for (unsigned I = 0; I < NumThreads; ++I)
+  SmallVector<WriterContext *, 4> Shards;
+  for (unsigned I = 0; I < NumThreads; ++I) {
     Contexts.emplace_back(std::make_unique<WriterContext>(
         OutputSparse, ErrorLock, WriterErrorCodes));
+    Shards.push_back(Contexts.back().get());
+  }
 
   if (NumThreads == 1) {
     for (const auto &Input : Inputs)
-      loadInput(Input, Remapper, Correlator.get(), Contexts[0].get());
+      loadInput(Input, Remapper, Correlator.get(), Shards);
   } else {
     ThreadPool Pool(hardware_concurrency(NumThreads));
 
-    // Load the inputs in parallel (N/NumThreads serial steps).
-    unsigned Ctx = 0;
-    for (const auto &Input : Inputs) {
-      Pool.async(loadInput, Input, Remapper, Correlator.get(),
-                 Contexts[Ctx].get());
-      Ctx = (Ctx + 1) % NumThreads;
-    }
+    // Load the inputs in parallel. Every function is kept in one of the
+    // contexts only, so the memory needed does not grow with NumThreads.
+    for (const auto &Input : Inputs)
+      Pool.async([&, Input] {
+        loadInput(Input, Remapper, Correlator.get(), Shards);
+      });
     Pool.wait();
 
-    // Merge the writer contexts together (~ lg(NumThreads) serial steps).
-    unsigned Mid = Contexts.size() / 2;
-    unsigned End = Contexts.size();
-    assert(Mid > 0 && "Expected more than one context");
-    do {
-      for (unsigned I = 0; I < Mid; ++I)
-        Pool.async(mergeWriterContexts, Contexts[I].get(),
-                   Contexts[I + Mid].get());
-      Pool.wait();
-      if (End & 1) {
-        Pool.async(mergeWriterContexts, Contexts[0].get(),
-                   Contexts[End - 1].get());
-        Pool.wait();
-      }
-      End = Mid;
-      Mid /= 2;
-    } while (Mid > 0);
+    // The contexts hold disjoint sets of functions, so merging them into the
+    // first one only moves records. Free every context once it is merged.
+    while (Contexts.size() > 1) {
+      mergeWriterContexts(Contexts.front().get(), Contexts.back().get());
+      Contexts.pop_back();
+    }
   }
 
   // Handle deferred errors encountered during merging. If the number of errors
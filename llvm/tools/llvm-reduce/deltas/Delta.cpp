@@ -128,19 +128,15 @@ static bool increaseGranularity(std::vector<Chunk> &Chunks) {
   }
   return SplitOne;
 }
-// Check if \p ChunkToCheckForUninterestingness is interesting. Returns the
-// modified module if the chunk resulted in a reduction.
-template <typename T>
-static std::unique_ptr<ReducerWorkItem>
-CheckChunk(Chunk &ChunkToCheckForUninterestingness,
-           std::unique_ptr<ReducerWorkItem> Clone, TestRunner &Test,
-           function_ref<void(Oracle &, T &)> ExtractChunksFromModule,
-           std::set<Chunk> &UninterestingChunks,
-           std::vector<Chunk> &ChunksStillConsideredInteresting) {
-  // Take all of ChunksStillConsideredInteresting chunks, except those we've
-  // already deemed uninteresting (UninterestingChunks) but didn't remove
-  // from ChunksStillConsideredInteresting yet, and additionally ignore
-  // ChunkToCheckForUninterestingness chunk.
+/// Returns the chunks to keep to check whether
+/// \p ChunkToCheckForUninterestingness is interesting: all of
+/// ChunksStillConsideredInteresting, except those we've already deemed
+/// uninteresting (UninterestingChunks) but didn't remove from
+/// ChunksStillConsideredInteresting yet, and ChunkToCheckForUninterestingness.
+static std::vector<Chunk>
+getChunksToKeep(const Chunk &ChunkToCheckForUninterestingness,
+                const std::set<Chunk> &UninterestingChunks,
+                ArrayRef<Chunk> ChunksStillConsideredInteresting) {
   std::vector<Chunk> CurrentChunks;
   CurrentChunks.reserve(ChunksStillConsideredInteresting.size() -
                         UninterestingChunks.size() - 1);
@@ -149,7 +145,21 @@ CheckChunk(Chunk &ChunkToCheckForUninterestingness,
             return !UninterestingChunks.count(C) &&
                    C != ChunkToCheckForUninterestingness;
           });
+  return CurrentChunks;
+}
 
+// Check if \p ChunkToCheckForUninterestingness is interesting, by keeping only
+// \p CurrentChunks. Returns the modified module if the chunk resulted in a
+// reduction. If \p Cancelled returns true once the module has been reduced,
+// the test is not run and nullptr is returned.
+template <typename T>
+static std::unique_ptr<ReducerWorkItem>
+CheckChunk(const Chunk &ChunkToCheckForUninterestingness,
+           std::unique_ptr<ReducerWorkItem> Clone, TestRunner &Test,
+           function_ref<void(Oracle &, T &)> ExtractChunksFromModule,
+           const std::set<Chunk> &UninterestingChunks,
+           ArrayRef<Chunk> CurrentChunks,
+           function_ref<bool()> Cancelled = nullptr) {
   // Generate Module with only Targets inside Current Chunks
   Oracle O(CurrentChunks);
   ExtractChunksFromModule(O, *Clone);
@@ -165,6 +175,9 @@ CheckChunk(Chunk &ChunkToCheckForUninterestingness,
     return nullptr;
   }
 
+  if (Cancelled && Cancelled())
+    return nullptr;
+
   errs() << "Ignoring: ";
   ChunkToCheckForUninterestingness.print();
   for (const Chunk &C : UninterestingChunks)
@@ -179,14 +192,24 @@ CheckChunk(Chunk &ChunkToCheckForUninterestingness,
   return Clone;
 }
 
+/// The state shared by the candidates of one batch of chunks tested in
+/// parallel. Candidates are numbered in chunk order within their batch.
+struct ParallelBatch {
+  /// The program at the start of the round, as bitcode.
+  std::shared_ptr<const SmallString<0>> OriginalBC;
+  /// The lowest number of a candidate which reduced the program. Candidates
+  /// after it cannot be committed any more, so they skip their test.
+  std::atomic<unsigned> FirstReduced{UINT_MAX};
+};
+
 template <typename T>
 SmallString<0> ProcessChunkFromSerializedBitcode(
-    Chunk &ChunkToCheckForUninterestingness, TestRunner &Test,
-    function_ref<void(Oracle &, T &)> ExtractChunksFromModule,
-    std::set<Chunk> &UninterestingChunks,
-    std::vector<Chunk> &ChunksStillConsideredInteresting,
-    SmallString<0> &OriginalBC, std::atomic<bool> &AnyReduced) {
+    const Chunk &ChunkToCheckForUninterestingness, unsigned CandidateIdx,
+    TestRunner &Test, function_ref<void(Oracle &, T &)> ExtractChunksFromModule,
+    const std::set<Chunk> &UninterestingChunks, ArrayRef<Chunk> CurrentChunks,
+    ParallelBatch &Batch) {
   LLVMContext Ctx;
+  const SmallString<0> &OriginalBC = *Batch.OriginalBC;
   Expected<std::unique_ptr<Module>> MOrErr = parseBitcodeFile(
       MemoryBufferRef(StringRef(OriginalBC.data(), OriginalBC.size()),
                       "<llvm-reduce tmp module>"),
@@ -197,14 +220,19 @@ SmallString<0> ProcessChunkFromSerializedBitcode(
   CloneMMM->M = std::move(MOrErr.get());
 
   SmallString<0> Result;
-  if (std::unique_ptr<ReducerWorkItem> ChunkResult =
-          CheckChunk(ChunkToCheckForUninterestingness, std::move(CloneMMM),
-                     Test, ExtractChunksFromModule, UninterestingChunks,
-                     ChunksStillConsideredInteresting)) {
+  if (std::unique_ptr<ReducerWorkItem> ChunkResult = CheckChunk(
+          ChunkToCheckForUninterestingness, std::move(CloneMMM), Test,
+          ExtractChunksFromModule, UninterestingChunks, CurrentChunks,
+          [&] { return CandidateIdx > Batch.FirstReduced; })) {
+    // Communicate that the candidate reduced the program, so that the ones
+    // after it are not tested any more.
+    unsigned FirstReduced = Batch.FirstReduced;
+    while (CandidateIdx < FirstReduced &&
+           !Batch.FirstReduced.compare_exchange_weak(FirstReduced,
+                                                     CandidateIdx))
+      ;
     raw_svector_ostream BCOS(Result);
     WriteBitcodeToFile(*ChunkResult->M, BCOS);
-    // Communicate that the task reduced a chunk.
-    AnyReduced = true;
   }
   return Result;
 }
@@ -264,7 +292,6 @@ void runDeltaPassInt(
     increaseGranularity(ChunksStillConsideredInteresting);
   }
 
-  std::atomic<bool> AnyReduced;
   std::unique_ptr<ThreadPool> ChunkThreadPoolPtr;
   if (NumJobs > 1)
     ChunkThreadPoolPtr =
@@ -278,9 +305,10 @@ void runDeltaPassInt(
 
     // When running with more than one thread, serialize the original bitcode
     // to OriginalBC.
-    SmallString<0> OriginalBC;
+    std::shared_ptr<SmallString<0>> OriginalBC;
     if (NumJobs > 1) {
-      raw_svector_ostream BCOS(OriginalBC);
+      OriginalBC = std::make_shared<SmallString<0>>();
+      raw_svector_ostream BCOS(*OriginalBC);
       WriteBitcodeToFile(*Test.getProgram().M, BCOS);
     }
 
@@ -300,27 +328,38 @@ void runDeltaPassInt(
         ThreadPool &ChunkThreadPool = *ChunkThreadPoolPtr;
         TaskQueue.clear();
 
-        AnyReduced = false;
-        // Queue jobs to process NumInitialTasks chunks in parallel using
-        // ChunkThreadPool. When the tasks are added to the pool, parse the
-        // original module from OriginalBC with a fresh LLVMContext object. This
-        // ensures that the cloned module of each task uses an independent
-        // LLVMContext object. If a task reduces the input, serialize the result
-        // back in the corresponding Result element.
-        for (unsigned J = 0; J < NumInitialTasks; ++J) {
+        // Candidates of an earlier batch which are still running belong to
+        // a batch which committed a reduction, so they skip their test. They
+        // own everything they use, as they may outlive this round.
+        auto Batch = std::make_shared<ParallelBatch>();
+        Batch->OriginalBC = OriginalBC;
+
+        // Queue a task which tests the chunk at position CandidateIdx of the
+        // batch using ChunkThreadPool. The task parses the original module
+        // from OriginalBC with a fresh LLVMContext object. This ensures that
+        // the cloned module of each task uses an independent LLVMContext
+        // object. If a task reduces the input, it serializes the result back
+        // as its return value.
+        auto QueueCandidate = [&](unsigned CandidateIdx) {
+          const Chunk &ChunkToCheck = *(I + CandidateIdx);
+          std::vector<Chunk> CurrentChunks = getChunksToKeep(
+              ChunkToCheck, UninterestingChunks,
+              ChunksStillConsideredInteresting);
           TaskQueue.emplace_back(ChunkThreadPool.async(
-              [J, I, &Test, &ExtractChunksFromModule, &UninterestingChunks,
-               &ChunksStillConsideredInteresting, &OriginalBC, &AnyReduced]() {
+              [&Test, &ExtractChunksFromModule, ChunkToCheck, CandidateIdx,
+               UninterestingChunks, CurrentChunks, Batch]() {
                 return ProcessChunkFromSerializedBitcode(
-                    *(I + J), Test, ExtractChunksFromModule,
-                    UninterestingChunks, ChunksStillConsideredInteresting,
-                    OriginalBC, AnyReduced);
+                    ChunkToCheck, CandidateIdx, Test, ExtractChunksFromModule,
+                    UninterestingChunks, CurrentChunks, *Batch);
               }));
-        }
-
-        // Start processing results of the queued tasks. We wait for the first
-        // task in the queue to finish. If it reduced a chunk, we parse the
-        // result and exit the loop.
+        };
+        for (unsigned J = 0; J < NumInitialTasks; ++J)
+          QueueCandidate(J);
+
+        // Start processing results of the queued tasks in chunk order, so
+        // that the reduction which is committed does not depend on timing.
+        // We wait for the first task in the queue to finish. If it reduced a
+        // chunk, we parse the result and exit the loop.
         //  Otherwise we will try to schedule a new task, if
         //  * no other pending job reduced a chunk and
         //  * we have not reached the end of the chunk.
@@ -333,21 +372,14 @@ void runDeltaPassInt(
           TaskQueue.pop_front();
           if (Res.empty()) {
             unsigned NumScheduledTasks = NumChunksProcessed + TaskQueue.size();
-            if (!AnyReduced && I + NumScheduledTasks != E) {
-              Chunk &ChunkToCheck = *(I + NumScheduledTasks);
-              TaskQueue.emplace_back(ChunkThreadPool.async(
-                  [&Test, &ExtractChunksFromModule, &UninterestingChunks,
-                   &ChunksStillConsideredInteresting, &OriginalBC,
-                   &ChunkToCheck, &AnyReduced]() {
-                    return ProcessChunkFromSerializedBitcode(
-                        ChunkToCheck, Test, ExtractChunksFromModule,
-                        UninterestingChunks, ChunksStillConsideredInteresting,
-                        OriginalBC, AnyReduced);
-                  }));
-            }
+            if (Batch->FirstReduced == UINT_MAX && I + NumScheduledTasks != E)
+              QueueCandidate(NumScheduledTasks);
             continue;
           }
 
+          // Every candidate before this one found its chunk interesting, so
+          // this is the reduction to commit. The task has already made the
+          // candidates after it skip their test.
           Expected<std::unique_ptr<Module>> MOrErr = parseBitcodeFile(
               MemoryBufferRef(StringRef(Res.data(), Res.size()),
                               "<llvm-reduce tmp module>"),
@@ -361,9 +393,11 @@ void runDeltaPassInt(
         // Forward I to the last chunk processed in parallel.
         I += NumChunksProcessed - 1;
       } else {
-        Result = CheckChunk(*I, cloneReducerWorkItem(Test.getProgram()), Test,
-                            ExtractChunksFromModule, UninterestingChunks,
-                            ChunksStillConsideredInteresting);
+        Result = CheckChunk(
+            *I, cloneReducerWorkItem(Test.getProgram()), Test,
+            ExtractChunksFromModule, UninterestingChunks,
+            getChunksToKeep(*I, UninterestingChunks,
+                            ChunksStillConsideredInteresting));
       }
 
       if (!Result)
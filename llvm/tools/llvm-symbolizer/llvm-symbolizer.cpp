@@ -284,6 +284,8 @@ int main(int argc, char **argv) {
   } else {
     Opts.PathStyle = DILineInfoSpecifier::FileLineInfoKind::AbsoluteFilePath;
   }
+  if (Args.hasArg(OPT_cache_size_EQ))
+    parseIntArg(Args, OPT_cache_size_EQ, Opts.MaxCacheSize);
   Opts.DebugFileDirectory = Args.getAllArgValues(OPT_debug_file_directory_EQ);
   Opts.DefaultArch = Args.getLastArgValue(OPT_default_arch_EQ).str();
   Opts.Demangle = Args.hasFlag(OPT_demangle, OPT_no_demangle, !IsAddr2Line);
@@ -351,12 +353,15 @@ int main(int argc, char **argv) {
       symbolizeInput(Args, AdjustVMA, IsAddr2Line, Style, StrippedInputString,
                      Symbolizer, *Printer);
       outs().flush();
+      Symbolizer.pruneCache();
     }
   } else {
     Printer->listBegin();
-    for (StringRef Address : InputAddresses)
+    for (StringRef Address : InputAddresses) {
       symbolizeInput(Args, AdjustVMA, IsAddr2Line, Style, Address, Symbolizer,
                      *Printer);
+      Symbolizer.pruneCache();
+    }
     Printer->listEnd();
   }
 
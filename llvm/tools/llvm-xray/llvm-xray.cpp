@@ -17,16 +17,24 @@
 //
 #include "xray-registry.h"
 #include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Parallel.h"
 #include "llvm/Support/raw_ostream.h"
 
 using namespace llvm;
 using namespace llvm::xray;
 
+static cl::opt<unsigned>
+    Threads("threads",
+            cl::desc("number of threads used to load FDR mode traces; 0 uses "
+                     "all of the available hardware threads"),
+            cl::init(0), cl::sub(*cl::AllSubCommands));
+
 int main(int argc, char *argv[]) {
   cl::ParseCommandLineOptions(argc, argv,
                               "XRay Tools\n\n"
                               "  This program consolidates multiple XRay trace "
                               "processing tools for convenient access.\n");
+  parallel::strategy = hardware_concurrency(Threads);
   for (auto *SC : cl::getRegisteredSubcommands()) {
     if (*SC) {
       // If no subcommand was provided, we need to explicitly check if this is
@@ -0,0 +1,260 @@
+//===- llvm/unittest/ADT/FlatHashMapTest.cpp - FlatHashMap unit tests -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/ADT/FlatHashMap.h"
+#include "llvm/ADT/StringRef.h"
+#include "gtest/gtest.h"
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+
+using namespace llvm;
+
+namespace {
+
+/// A test class that tries to check that construction and destruction
+/// occur correctly.
+class CtorTester {
+  static std::set<CtorTester *> Constructed;
+  int Value;
+
+public:
+  explicit CtorTester(int Value = 0) : Value(Value) {
+    EXPECT_TRUE(Constructed.insert(this).second);
+  }
+  CtorTester(const CtorTester &Arg) : Value(Arg.Value) {
+    EXPECT_TRUE(Constructed.insert(this).second);
+  }
+  CtorTester &operator=(const CtorTester &) = default;
+  ~CtorTester() { EXPECT_EQ(1u, Constructed.erase(this)); }
+
+  int getValue() const { return Value; }
+  bool operator==(const CtorTester &RHS) const { return Value == RHS.Value; }
+
+  static size_t getNumConstructed() { return Constructed.size(); }
+};
+
+std::set<CtorTester *> CtorTester::Constructed;
+
+struct CtorTesterMapInfo {
+  static unsigned getHashValue(const CtorTester &Val) {
+    return Val.getValue() * 37u;
+  }
+  static bool isEqual(const CtorTester &LHS, const CtorTester &RHS) {
+    return LHS == RHS;
+  }
+};
+
+// A hash that puts every key in the same probe sequence.
+struct CollidingMapInfo {
+  static unsigned getHashValue(unsigned) { return 0; }
+  static bool isEqual(unsigned LHS, unsigned RHS) { return LHS == RHS; }
+};
+
+TEST(FlatHashMapTest, EmptyMap) {
+  FlatHashMap<unsigned, unsigned> M;
+  EXPECT_TRUE(M.empty());
+  EXPECT_EQ(0u, M.size());
+  EXPECT_TRUE(M.begin() == M.end());
+  EXPECT_EQ(0u, M.count(1));
+  EXPECT_TRUE(M.find(1) == M.end());
+  EXPECT_EQ(0u, M.lookup(1));
+  EXPECT_FALSE(M.erase(1));
+  EXPECT_EQ(0u, M.getMemorySize());
+  M.clear();
+  EXPECT_TRUE(M.empty());
+}
+
+TEST(FlatHashMapTest, InsertFindErase) {
+  FlatHashMap<unsigned, unsigned> M;
+  EXPECT_TRUE(M.insert({1, 10}).second);
+  EXPECT_FALSE(M.insert({1, 20}).second);
+  EXPECT_EQ(10u, M.lookup(1));
+  EXPECT_EQ(1u, M.size());
+
+  auto It = M.find(1);
+  ASSERT_TRUE(It != M.end());
+  EXPECT_EQ(1u, It->first);
+  EXPECT_EQ(10u, It->second);
+  EXPECT_TRUE(M.contains(1));
+  EXPECT_FALSE(M.contains(2));
+
+  M[2] = 20;
+  EXPECT_EQ(20u, M[2]);
+  EXPECT_EQ(2u, M.size());
+
+  EXPECT_FALSE(M.insert_or_assign(2, 30).second);
+  EXPECT_EQ(30u, M.lookup(2));
+  EXPECT_TRUE(M.insert_or_assign(3, 40).second);
+
+  EXPECT_TRUE(M.erase(1));
+  EXPECT_FALSE(M.erase(1));
+  EXPECT_EQ(0u, M.count(1));
+  M.erase(M.find(2));
+  EXPECT_EQ(1u, M.size());
+  EXPECT_EQ(40u, M.lookup(3));
+}
+
+// Keys that DenseMap reserves as its empty and tombstone markers are ordinary
+// keys for FlatHashMap.
+TEST(FlatHashMapTest, AllKeysAllowed) {
+  FlatHashMap<unsigned, unsigned> M;
+  M[DenseMapInfo<unsigned>::getEmptyKey()] = 1;
+  M[DenseMapInfo<unsigned>::getTombstoneKey()] = 2;
+  M[0] = 3;
+  EXPECT_EQ(1u, M.lookup(DenseMapInfo<unsigned>::getEmptyKey()));
+  EXPECT_EQ(2u, M.lookup(DenseMapInfo<unsigned>::getTombstoneKey()));
+  EXPECT_EQ(3u, M.lookup(0));
+  EXPECT_EQ(3u, M.size());
+}
+
+TEST(FlatHashMapTest, Iteration) {
+  FlatHashMap<unsigned, unsigned> M;
+  for (unsigned I = 0; I != 1000; ++I)
+    M[I] = I * 2;
+
+  std::set<unsigned> Seen;
+  for (const auto &KV : M) {
+    EXPECT_EQ(KV.first * 2, KV.second);
+    EXPECT_TRUE(Seen.insert(KV.first).second);
+  }
+  EXPECT_EQ(1000u, Seen.size());
+
+  const auto &CM = M;
+  FlatHashMap<unsigned, unsigned>::const_iterator CI = M.begin();
+  EXPECT_TRUE(CI == CM.begin());
+  EXPECT_EQ(1000, std::distance(CM.begin(), CM.end()));
+}
+
+TEST(FlatHashMapTest, ReserveDoesNotGrow) {
+  FlatHashMap<unsigned, unsigned> M;
+  M.reserve(1000);
+  size_t MemorySize = M.getMemorySize();
+  for (unsigned I = 0; I != 1000; ++I)
+    M[I] = I;
+  EXPECT_EQ(MemorySize, M.getMemorySize());
+
+  FlatHashMap<unsigned, unsigned> N(100);
+  MemorySize = N.getMemorySize();
+  for (unsigned I = 0; I != 100; ++I)
+    N[I] = I;
+  EXPECT_EQ(MemorySize, N.getMemorySize());
+}
+
+TEST(FlatHashMapTest, CopyAndMove) {
+  FlatHashMap<unsigned, std::string> M = {{1, "one"}, {2, "two"}};
+  FlatHashMap<unsigned, std::string> Copy(M);
+  EXPECT_EQ(2u, Copy.size());
+  EXPECT_EQ("one", Copy.lookup(1));
+  Copy[3] = "three";
+  EXPECT_EQ(2u, M.size());
+
+  FlatHashMap<unsigned, std::string> Moved(std::move(Copy));
+  EXPECT_EQ(3u, Moved.size());
+  EXPECT_EQ("three", Moved.lookup(3));
+
+  M = Moved;
+  EXPECT_EQ(3u, M.size());
+  FlatHashMap<unsigned, std::string> Empty;
+  Copy = Empty;
+  EXPECT_TRUE(Copy.empty());
+  Copy[4] = "four";
+  EXPECT_EQ(1u, Copy.size());
+  M = FlatHashMap<unsigned, std::string>();
+  EXPECT_TRUE(M.empty());
+
+  M.swap(Moved);
+  EXPECT_EQ(3u, M.size());
+  EXPECT_TRUE(Moved.empty());
+}
+
+TEST(FlatHashMapTest, MoveOnlyValues) {
+  FlatHashMap<unsigned, std::unique_ptr<int>> M;
+  for (int I = 0; I != 100; ++I)
+    M.try_emplace(I, std::make_unique<int>(I));
+  for (int I = 0; I != 100; ++I)
+    EXPECT_EQ(I, *M.find(I)->second);
+}
+
+TEST(FlatHashMapTest, ConstructDestruct) {
+  {
+    FlatHashMap<CtorTester, CtorTester, CtorTesterMapInfo> M;
+    for (int I = 0; I != 100; ++I)
+      M.try_emplace(CtorTester(I), I + 1);
+    EXPECT_EQ(200u, CtorTester::getNumConstructed());
+    for (int I = 0; I < 100; I += 2)
+      EXPECT_TRUE(M.erase(CtorTester(I)));
+    EXPECT_EQ(100u, CtorTester::getNumConstructed());
+
+    FlatHashMap<CtorTester, CtorTester, CtorTesterMapInfo> Copy(M);
+    EXPECT_EQ(200u, CtorTester::getNumConstructed());
+    Copy.clear();
+    EXPECT_EQ(100u, CtorTester::getNumConstructed());
+  }
+  EXPECT_EQ(0u, CtorTester::getNumConstructed());
+}
+
+TEST(FlatHashMapTest, Collisions) {
+  FlatHashMap<unsigned, unsigned, CollidingMapInfo> M;
+  for (unsigned I = 0; I != 300; ++I)
+    M[I] = I;
+  for (unsigned I = 0; I < 300; I += 3)
+    EXPECT_TRUE(M.erase(I));
+  for (unsigned I = 0; I != 300; ++I)
+    EXPECT_EQ(I % 3 != 0, M.contains(I));
+}
+
+// Repeatedly inserting and erasing must reuse tombstones and rehash in place
+// rather than growing without bound.
+TEST(FlatHashMapTest, Churn) {
+  FlatHashMap<unsigned, unsigned> M;
+  for (unsigned I = 0; I != 80; ++I)
+    M[I] = I;
+  size_t MemorySize = M.getMemorySize();
+  for (unsigned I = 80; I != 100000; ++I) {
+    EXPECT_TRUE(M.erase(I - 80));
+    M[I] = I;
+  }
+  EXPECT_EQ(80u, M.size());
+  EXPECT_EQ(MemorySize, M.getMemorySize());
+}
+
+TEST(FlatHashMapTest, RandomOperations) {
+  std::mt19937 Rng(0);
+  FlatHashMap<unsigned, unsigned> M;
+  std::map<unsigned, unsigned> Ref;
+  for (unsigned I = 0; I != 200000; ++I) {
+    unsigned Key = Rng() % 5000;
+    switch (Rng() % 3) {
+    case 0:
+      EXPECT_EQ(Ref.insert({Key, I}).second, M.insert({Key, I}).second);
+      break;
+    case 1:
+      EXPECT_EQ(Ref.erase(Key) != 0, M.erase(Key));
+      break;
+    case 2:
+      EXPECT_EQ(Ref.count(Key), M.count(Key));
+      break;
+    }
+  }
+  EXPECT_EQ(Ref.size(), M.size());
+  for (const auto &KV : M)
+    EXPECT_EQ(Ref[KV.first], KV.second);
+}
+
+TEST(FlatHashMapTest, FindAs) {
+  FlatHashMap<StringRef, unsigned> M;
+  M["foo"] = 1;
+  M["bar"] = 2;
+  EXPECT_EQ(1u, M.find_as(StringRef("foo"))->second);
+  EXPECT_TRUE(M.find_as(StringRef("baz")) == M.end());
+}
+
+} // namespace
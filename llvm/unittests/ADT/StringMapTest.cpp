@@ -595,6 +595,27 @@ TEST(StringMapCustomTest, EmplaceTest) {
   EXPECT_EQ(42, Map["abcd"].Data);
 }
 
+// Test the lookup and insertion overloads taking a precomputed hash.
+TEST(StringMapCustomTest, PrecomputedHash) {
+  StringMap<int> Map;
+  uint32_t FooHash = StringMap<int>::hash("foo");
+  EXPECT_TRUE(Map.find("foo", FooHash) == Map.end());
+
+  auto Result = Map.try_emplace_with_hash("foo", FooHash, 1);
+  EXPECT_TRUE(Result.second);
+  EXPECT_EQ(1, Result.first->second);
+  Result = Map.try_emplace_with_hash("foo", FooHash, 2);
+  EXPECT_FALSE(Result.second);
+  EXPECT_EQ(1, Result.first->second);
+
+  // Entries inserted either way are visible to both kinds of lookup.
+  Map.try_emplace("bar", 3);
+  const StringMap<int> &ConstMap = Map;
+  EXPECT_EQ(1, ConstMap.find("foo", FooHash)->second);
+  EXPECT_EQ(3, ConstMap.find("bar", StringMap<int>::hash("bar"))->second);
+  EXPECT_EQ(1, Map.lookup("foo"));
+}
+
 // Test that StringMapEntryBase can handle size_t wide sizes.
 TEST(StringMapCustomTest, StringMapEntryBaseSize) {
   size_t LargeValue;
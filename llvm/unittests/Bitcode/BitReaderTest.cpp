@@ -255,4 +255,91 @@ TEST(BitReaderTest, MaterializeFunctionsForBlockAddrInFunctionAfter) {
   EXPECT_FALSE(verifyModule(*M, &dbgs()));
 }
 
+// Tests that decoding function bodies on other threads gives the same module
+// as materializing them one at a time.
+TEST(BitReaderTest, MaterializeAllInParallel) {
+  std::string Assembly = "@g = global i32 0\n"
+                         "declare void @ext(i32)\n";
+  for (unsigned I = 0; I != 100; ++I) {
+    std::string N = std::to_string(I);
+    Assembly += "define i32 @f" + N + "(i32 %a, i32 %b) {\n"
+                "entry:\n"
+                "  %x = add i32 %a, " + N + "\n"
+                "  %c = icmp sgt i32 %x, %b\n"
+                "  br i1 %c, label %t, label %e\n"
+                "t:\n"
+                "  call void @ext(i32 ptrtoint (i8* blockaddress(@f" + N +
+                ", %e) to i32))\n"
+                "  br label %e\n"
+                "e:\n"
+                "  %p = phi i32 [ %x, %entry ], [ " + N + ", %t ]\n"
+                "  store i32 %p, i32* @g\n"
+                "  ret i32 %p\n"
+                "}\n";
+  }
+
+  auto Print = [](const Module &M) {
+    std::string S;
+    raw_string_ostream OS(S);
+    M.print(OS, nullptr);
+    return OS.str();
+  };
+
+  SmallString<1024> SerialMem;
+  LLVMContext SerialContext;
+  std::unique_ptr<Module> Serial =
+      getLazyModuleFromAssembly(SerialContext, SerialMem, Assembly.c_str());
+  ASSERT_FALSE(Serial->materializeAll());
+
+  SmallString<1024> ParallelMem;
+  LLVMContext ParallelContext;
+  std::unique_ptr<Module> Parallel =
+      getLazyModuleFromAssembly(ParallelContext, ParallelMem, Assembly.c_str());
+  ASSERT_FALSE(materializeAllInParallel(*Parallel, hardware_concurrency(4)));
+  EXPECT_FALSE(verifyModule(*Parallel, &dbgs()));
+  EXPECT_EQ(Print(*Serial), Print(*Parallel));
+}
+
+TEST(BitReaderTest, WriteInParallel) {
+  std::string Assembly = "@g = global i32 0\n"
+                         "declare void @ext(i32)\n"
+                         "declare void @md(metadata)\n";
+  for (unsigned I = 0; I != 100; ++I) {
+    std::string N = std::to_string(I);
+    Assembly += "define i32 @f" + N + "(i32 %a, i32 %b) !annot !0 {\n"
+                "entry:\n"
+                "  %x = add i32 %a, " + N + "\n"
+                "  call void @md(metadata i32 %x)\n"
+                "  %c = icmp sgt i32 %x, %b, !annot !{!\"f" + N + "\"}\n"
+                "  br i1 %c, label %t, label %e\n"
+                "t:\n"
+                "  call void @ext(i32 ptrtoint (i8* blockaddress(@f" + N +
+                ", %e) to i32))\n"
+                "  br label %e\n"
+                "e:\n"
+                "  %p = phi i32 [ %x, %entry ], [ " + N + ", %t ]\n"
+                "  store i32 %p, i32* @g\n"
+                "  ret i32 %p\n"
+                "}\n";
+  }
+  Assembly += "!0 = !{!\"fn\"}\n";
+
+  LLVMContext Context;
+  std::unique_ptr<Module> M = parseAssembly(Context, Assembly.c_str());
+
+  SmallString<1024> SerialMem;
+  raw_svector_ostream OS(SerialMem);
+  WriteBitcodeToFile(*M, OS);
+
+  SmallString<1024> ParallelMem;
+  {
+    BitcodeWriter Writer(ParallelMem);
+    Writer.setEncodeStrategy(hardware_concurrency(4));
+    Writer.writeModule(*M);
+    Writer.writeSymtab();
+    Writer.writeStrtab();
+  }
+  EXPECT_EQ(SerialMem, ParallelMem);
+}
+
 } // end namespace
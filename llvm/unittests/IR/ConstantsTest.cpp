@@ -9,6 +9,7 @@
 #include "llvm/IR/Constants.h"
 #include "llvm-c/Core.h"
 #include "llvm/AsmParser/Parser.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/InstrTypes.h"
 #include "llvm/IR/Instruction.h"
@@ -16,6 +17,7 @@
 #include "llvm/IR/Module.h"
 #include "llvm/Support/SourceMgr.h"
 #include "gtest/gtest.h"
+#include <thread>
 
 namespace llvm {
 namespace {
@@ -790,5 +792,41 @@ TEST(ConstantsTest, ComdatUserTracking) {
   EXPECT_TRUE(Users.size() == 0);
 }
 
+#if LLVM_ENABLE_THREADS
+TEST(ConstantsTest, ConcurrentUniquing) {
+  LLVMContext Context;
+  Context.enableConcurrentUniquing();
+
+  // Every thread gets the same constants, starting at a different one. The
+  // 37-bit type is not one of the context's built-in integer types.
+  constexpr unsigned NumThreads = 8, NumValues = 1000;
+  std::vector<std::vector<Constant *>> Constants(NumThreads);
+  std::vector<std::thread> Threads;
+  for (unsigned T = 0; T != NumThreads; ++T)
+    Threads.emplace_back([&, T] {
+      std::vector<Constant *> &Cs = Constants[T];
+      Cs.resize(3 * NumValues);
+      for (unsigned I = 0; I != NumValues; ++I) {
+        unsigned V = (I + T * 97) % NumValues;
+        Cs[3 * V] = ConstantInt::get(Context, APInt(32, V));
+        Cs[3 * V + 1] = ConstantInt::get(Context, APInt(37, V));
+        Cs[3 * V + 2] = ConstantFP::get(Context, APFloat(V + 0.5));
+      }
+    });
+  for (std::thread &T : Threads)
+    T.join();
+
+  for (unsigned T = 1; T != NumThreads; ++T)
+    EXPECT_EQ(Constants[0], Constants[T]);
+  for (unsigned V = 0; V != NumValues; ++V) {
+    EXPECT_EQ(V, cast<ConstantInt>(Constants[0][3 * V])->getZExtValue());
+    EXPECT_EQ(37u, Constants[0][3 * V + 1]->getType()->getIntegerBitWidth());
+    EXPECT_EQ(V + 0.5,
+              cast<ConstantFP>(Constants[0][3 * V + 2])->getValueAPF()
+                  .convertToDouble());
+  }
+}
+#endif
+
 } // end anonymous namespace
 } // end namespace llvm
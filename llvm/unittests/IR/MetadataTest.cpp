@@ -9,6 +9,7 @@
 #include "llvm/IR/Metadata.h"
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Config/llvm-config.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/IR/DIBuilder.h"
 #include "llvm/IR/DebugInfo.h"
@@ -22,6 +23,7 @@
 #include "llvm/IR/Verifier.h"
 #include "llvm/Support/raw_ostream.h"
 #include "gtest/gtest.h"
+#include <thread>
 using namespace llvm;
 
 namespace {
@@ -3573,4 +3575,44 @@ TEST_F(DebugVariableTest, DenseMap) {
   EXPECT_EQ(DebugVariableMap.find(DebugVariableFragB)->second, 12u);
 }
 
+#if LLVM_ENABLE_THREADS
+typedef MetadataTest ConcurrentUniquingTest;
+
+TEST_F(ConcurrentUniquingTest, Nodes) {
+  Context.enableConcurrentUniquing();
+  DISubprogram *SP = getSubprogram();
+
+  // Every thread gets the same metadata, starting at a different node.
+  constexpr unsigned NumThreads = 8, NumValues = 500;
+  std::vector<std::vector<Metadata *>> Nodes(NumThreads);
+  std::vector<std::thread> Threads;
+  for (unsigned T = 0; T != NumThreads; ++T)
+    Threads.emplace_back([&, T] {
+      std::vector<Metadata *> &MDs = Nodes[T];
+      MDs.resize(3 * NumValues);
+      for (unsigned I = 0; I != NumValues; ++I) {
+        unsigned V = (I + T * 61) % NumValues;
+        MDString *S = MDString::get(Context, "s" + std::to_string(V));
+        Metadata *Ops[] = {S, ConstantAsMetadata::get(ConstantInt::get(
+                                  Type::getInt32Ty(Context), V))};
+        MDs[3 * V] = S;
+        MDs[3 * V + 1] = MDTuple::get(Context, Ops);
+        MDs[3 * V + 2] = DILocation::get(Context, V + 1, 1, SP);
+      }
+    });
+  for (std::thread &T : Threads)
+    T.join();
+
+  for (unsigned T = 1; T != NumThreads; ++T)
+    EXPECT_EQ(Nodes[0], Nodes[T]);
+  for (unsigned V = 0; V != NumValues; ++V) {
+    EXPECT_EQ("s" + std::to_string(V),
+              cast<MDString>(Nodes[0][3 * V])->getString());
+    auto *Tuple = cast<MDTuple>(Nodes[0][3 * V + 1]);
+    EXPECT_EQ(Nodes[0][3 * V], Tuple->getOperand(0));
+    EXPECT_EQ(V + 1, cast<DILocation>(Nodes[0][3 * V + 2])->getLine());
+  }
+}
+#endif
+
 } // end namespace
@@ -12,6 +12,7 @@
 #include "llvm/AsmParser/Parser.h"
 #include "llvm/IR/Dominators.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/InstIterator.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/PassManagerImpl.h"
@@ -19,6 +20,9 @@
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/Transforms/Scalar/SimplifyCFG.h"
 #include "gtest/gtest.h"
+#include <atomic>
+#include <list>
+#include <mutex>
 
 using namespace llvm;
 
@@ -950,4 +954,70 @@ TEST_F(PassManagerTest, FunctionPassCFGCheckerWrapped) {
   FPM.addPass(TestSimplifyCFGWrapperPass(InnerFPM));
   FPM.run(*F, FAM);
 }
+
+TEST_F(PassManagerTest, ParallelModuleToFunctionPassAdaptor) {
+  std::string IR;
+  for (int I = 0; I != 64; ++I)
+    IR += "define i32 @f" + std::to_string(I) + "(i32 %x) {\n"
+          "  %y = add i32 %x, %x\n"
+          "  ret i32 %y\n"
+          "}\n";
+  M = parseIR(Context, IR.c_str());
+
+  FunctionAnalysisManager FAM;
+  int FunctionAnalysisRuns = 0;
+  FAM.registerPass([&] { return TestFunctionAnalysis(FunctionAnalysisRuns); });
+  ModuleAnalysisManager MAM;
+  MAM.registerPass([&] { return FunctionAnalysisManagerModuleProxy(FAM); });
+  FAM.registerPass([&] { return ModuleAnalysisManagerFunctionProxy(MAM); });
+  MAM.registerPass([&] { return PassInstrumentationAnalysis(); });
+  FAM.registerPass([&] { return PassInstrumentationAnalysis(); });
+
+  // Cache an analysis for every function, to check what gets invalidated.
+  for (Function &F : *M)
+    FAM.getResult<TestFunctionAnalysis>(F);
+  EXPECT_EQ(64, FunctionAnalysisRuns);
+
+  // Each worker's analysis manager counts its own analysis runs.
+  std::mutex WorkerRunsMutex;
+  std::list<int> WorkerRuns;
+  auto RegisterAnalyses = [&](FunctionAnalysisManager &WorkerFAM) {
+    std::lock_guard<std::mutex> Lock(WorkerRunsMutex);
+    WorkerRuns.push_back(0);
+    int *Runs = &WorkerRuns.back();
+    WorkerFAM.registerPass([=] { return TestFunctionAnalysis(*Runs); });
+  };
+
+  std::atomic<int> AnalyzedInstrCount{0};
+  LambdaPass::FuncT Func = [&](Function &F, FunctionAnalysisManager &AM) {
+    auto &AR = AM.getResult<TestFunctionAnalysis>(F);
+    AnalyzedInstrCount += AR.InstructionCount;
+    // Rename the instructions, which only touches the function.
+    for (Instruction &I : instructions(F))
+      if (!I.getType()->isVoidTy())
+        I.setName("renamed");
+    return F.getName() == "f0" ? PreservedAnalyses::none()
+                               : PreservedAnalyses::all();
+  };
+
+  ModulePassManager MPM;
+  MPM.addPass(createParallelModuleToFunctionPassAdaptor(
+      [&] { return LambdaPass(Func); }, RegisterAnalyses,
+      hardware_concurrency(4)));
+  MPM.run(*M, MAM);
+
+  EXPECT_EQ(128, AnalyzedInstrCount);
+  int TotalWorkerRuns = 0;
+  for (int Runs : WorkerRuns)
+    TotalWorkerRuns += Runs;
+  EXPECT_EQ(64, TotalWorkerRuns);
+
+  // Only the analysis of the function whose pass preserved nothing is gone.
+  EXPECT_EQ(64, FunctionAnalysisRuns);
+  for (Function &F : *M) {
+    EXPECT_EQ(F.getName() != "f0",
+              FAM.getCachedResult<TestFunctionAnalysis>(F) != nullptr);
+    EXPECT_TRUE(F.getEntryBlock().front().getName().startswith("renamed"));
+  }
+}
 }
@@ -9,6 +9,7 @@
 #include "llvm/IR/User.h"
 #include "llvm/AsmParser/Parser.h"
 #include "llvm/IR/Function.h"
+#include "llvm/IR/Constants.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Module.h"
@@ -173,4 +174,48 @@ TEST(UserTest, PersonalityUser) {
   EXPECT_TRUE(TestF->user_empty());
 }
 
+// Uses don't store their User; getUser() finds it from the Use's position.
+TEST(UserTest, GetUserFromOperands) {
+  LLVMContext Context;
+  Module M("", Context);
+  Type *Int32Ty = Type::getInt32Ty(Context);
+  FunctionType *FTy = FunctionType::get(Type::getVoidTy(Context), false);
+  Function *F = Function::Create(FTy, GlobalValue::ExternalLinkage, "f", &M);
+  BasicBlock *BB = BasicBlock::Create(Context, "entry", F);
+
+  // Fixed operands, laid out before the User.
+  for (unsigned NumOps : {1u, 2u, 17u, 100u, 1000u}) {
+    SmallVector<Value *, 16> Args(NumOps, ConstantInt::get(Int32Ty, 0));
+    SmallVector<Type *, 16> ArgTys(NumOps, Int32Ty);
+    FunctionCallee Callee = M.getOrInsertFunction(
+        "callee" + std::to_string(NumOps),
+        FunctionType::get(Type::getVoidTy(Context), ArgTys, false));
+    CallInst *CI = CallInst::Create(Callee, Args, "", BB);
+    for (Use &U : CI->operands()) {
+      EXPECT_EQ(CI, U.getUser());
+      EXPECT_EQ(unsigned(&U - CI->op_begin()), U.getOperandNo());
+    }
+  }
+
+  // Hung-off operands, including the incoming blocks of a PHI that grows
+  // past its reserved space.
+  PHINode *PN = PHINode::Create(Int32Ty, 1, "", BB);
+  for (unsigned I = 0; I != 300; ++I)
+    PN->addIncoming(ConstantInt::get(Int32Ty, I), BB);
+  for (unsigned I = 0; I != 300; ++I) {
+    Use &U = PN->getOperandUse(I);
+    EXPECT_EQ(PN, U.getUser());
+    EXPECT_EQ(I, U.getOperandNo());
+    EXPECT_EQ(BB, PN->getIncomingBlock(I));
+    EXPECT_EQ(I, cast<ConstantInt>(PN->getIncomingValue(I))->getZExtValue());
+  }
+
+  // Swapping Uses exchanges their values but not their Users.
+  PN->getOperandUse(0).swap(PN->getOperandUse(299));
+  EXPECT_EQ(299u, cast<ConstantInt>(PN->getIncomingValue(0))->getZExtValue());
+  EXPECT_EQ(PN, PN->getOperandUse(0).getUser());
+  EXPECT_EQ(299u, PN->getOperandUse(299).getOperandNo());
+  ReturnInst::Create(Context, BB);
+}
+
 } // end anonymous namespace
@@ -15,6 +15,7 @@
 #include "llvm/IR/Function.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Module.h"
+#include "llvm/IR/Verifier.h"
 #include "llvm/Linker/Linker.h"
 #include "llvm/Support/SourceMgr.h"
 #include "gtest/gtest.h"
@@ -359,4 +360,38 @@ TEST_F(LinkModuleTest, RemangleIntrinsics) {
   ASSERT_EQ(F->getNumUses(), (unsigned)2);
 }
 
+TEST_F(LinkModuleTest, AppendingVariablesOfManyModules) {
+  LLVMContext C;
+  SMDiagnostic Err;
+  auto Dst = std::make_unique<Module>("Linked", C);
+  Linker L(*Dst);
+
+  // The linker destroys the initializer of llvm.global_ctors each time it
+  // appends to it, and only sweeps the context for dead constants now and
+  // then.
+  const unsigned NumModules = 10;
+  for (unsigned I = 0; I != NumModules; ++I) {
+    std::string Src =
+        ("@llvm.global_ctors = appending global [1 x { i32, void ()*, i8* }] "
+         "[{ i32, void ()*, i8* } { i32 65535, void ()* @ctor" +
+         Twine(I) +
+         ", i8* null }]\n"
+         "define internal void @ctor" +
+         Twine(I) + "() {\n  ret void\n}\n")
+            .str();
+    std::unique_ptr<Module> M = parseAssemblyString(Src, Err, C);
+    ASSERT_TRUE(M);
+    ASSERT_FALSE(L.linkInModule(std::move(M)));
+  }
+
+  GlobalVariable *Ctors = Dst->getNamedGlobal("llvm.global_ctors");
+  ASSERT_TRUE(Ctors);
+  auto *Init = cast<ConstantArray>(Ctors->getInitializer());
+  ASSERT_EQ(NumModules, Init->getNumOperands());
+  for (unsigned I = 0; I != NumModules; ++I)
+    EXPECT_EQ(("ctor" + Twine(I)).str(),
+              Init->getOperand(I)->getAggregateElement(1)->getName());
+  EXPECT_FALSE(verifyModule(*Dst, &errs()));
+}
+
 } // end anonymous namespace
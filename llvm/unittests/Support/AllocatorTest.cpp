@@ -79,6 +79,44 @@ TEST(AllocatorTest, TestReset) {
   EXPECT_EQ(2U, Alloc.GetNumSlabs());
 }
 
+TEST(AllocatorTest, TestResetKeepingSlabs) {
+  // Grow the slabs after every two, so that reused slabs must keep their
+  // place to be large enough.
+  BumpPtrAllocatorImpl<MallocAllocator, 4096, 4096, 2> Alloc;
+
+  void *Ptrs[8];
+  for (void *&Ptr : Ptrs)
+    Ptr = Alloc.Allocate(3000, 1);
+  size_t NumSlabs = Alloc.GetNumSlabs();
+  size_t TotalMemory = Alloc.getTotalMemory();
+  (void)Alloc.Allocate(10000, 1);
+
+  // The custom-sized slab goes, the other slabs stay.
+  Alloc.ResetKeepingSlabs();
+  EXPECT_EQ(1U, Alloc.GetNumSlabs());
+  EXPECT_EQ(0U, Alloc.getBytesAllocated());
+  EXPECT_EQ(TotalMemory, Alloc.getTotalMemory());
+
+  for (void *Ptr : Ptrs)
+    EXPECT_EQ(Ptr, Alloc.Allocate(3000, 1));
+  EXPECT_EQ(NumSlabs, Alloc.GetNumSlabs());
+  EXPECT_EQ(TotalMemory, Alloc.getTotalMemory());
+
+  // Slabs left unused in a smaller round are kept as well.
+  Alloc.ResetKeepingSlabs();
+  EXPECT_EQ(Ptrs[0], Alloc.Allocate(3000, 1));
+  EXPECT_EQ(Ptrs[1], Alloc.Allocate(3000, 1));
+  Alloc.ResetKeepingSlabs();
+  for (void *Ptr : Ptrs)
+    EXPECT_EQ(Ptr, Alloc.Allocate(3000, 1));
+  EXPECT_EQ(TotalMemory, Alloc.getTotalMemory());
+
+  Alloc.ResetKeepingSlabs();
+  Alloc.Reset();
+  EXPECT_EQ(1U, Alloc.GetNumSlabs());
+  EXPECT_EQ(4096U, Alloc.getTotalMemory());
+}
+
 // Test some allocations at varying alignments.
 TEST(AllocatorTest, TestAlignment) {
   BumpPtrAllocator Alloc;
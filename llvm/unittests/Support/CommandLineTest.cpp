@@ -1959,4 +1959,27 @@ TEST(CommandLineTest, ResetAllOptionOccurrences) {
   EXPECT_EQ(0, (int)ExtraArgs.size());
 }
 
+TEST(CommandLineTest, RenameBeforeRegistration) {
+  cl::ResetCommandLineParser();
+
+  // The option is only added to the subcommand's map when the map is first
+  // needed, so renaming it before then must not leave the old name behind.
+  StackOption<bool> Option("old-name");
+  Option.setArgStr("new-name");
+  StackOption<std::string> First(cl::Positional);
+  StackOption<std::string> Second(cl::Positional);
+
+  StringMap<cl::Option *> &Map = cl::getRegisteredOptions();
+  EXPECT_EQ(0u, Map.count("old-name"));
+  EXPECT_EQ(1u, Map.count("new-name"));
+
+  // Positional arguments are assigned in construction order.
+  const char *Args[] = {"prog", "-new-name", "a", "b"};
+  EXPECT_TRUE(
+      cl::ParseCommandLineOptions(4, Args, StringRef(), &llvm::nulls()));
+  EXPECT_TRUE(Option);
+  EXPECT_EQ("a", First);
+  EXPECT_EQ("b", Second);
+}
+
 } // anonymous namespace
@@ -15,6 +15,7 @@
 #include "llvm/ADT/StringRef.h"
 #include "llvm/Config/config.h"
 #include "llvm/Support/Error.h"
+#include "llvm/Testing/Support/Error.h"
 #include "gtest/gtest.h"
 
 using namespace llvm;
@@ -73,4 +74,96 @@ TEST(CompressionTest, ZlibCRC32) {
 
 #endif
 
+#if LLVM_ENABLE_ZSTD
+
+void TestZstdCompression(StringRef Input, int Level, unsigned Threads = 0) {
+  SmallString<32> Compressed;
+  SmallString<32> Uncompressed;
+
+  Error E = zstd::compress(Input, Compressed, Level, Threads);
+  EXPECT_FALSE(E);
+  consumeError(std::move(E));
+
+  // Check that uncompressed buffer is the same as original.
+  E = zstd::uncompress(Compressed, Uncompressed, Input.size());
+  EXPECT_FALSE(E);
+  consumeError(std::move(E));
+
+  EXPECT_EQ(Input, Uncompressed);
+  if (Input.size() > 0) {
+    // Uncompression fails if expected length is too short.
+    E = zstd::uncompress(Compressed, Uncompressed, Input.size() - 1);
+    EXPECT_EQ("zstd error: Destination buffer is too small",
+              llvm::toString(std::move(E)));
+  }
+}
+
+TEST(CompressionTest, Zstd) {
+  TestZstdCompression("", zstd::DefaultCompression);
+
+  TestZstdCompression("hello, world!", zstd::NoCompression);
+  TestZstdCompression("hello, world!", zstd::BestSizeCompression);
+  TestZstdCompression("hello, world!", zstd::BestSpeedCompression);
+  TestZstdCompression("hello, world!", zstd::DefaultCompression);
+
+  const size_t kSize = 1024;
+  char BinaryData[kSize];
+  for (size_t i = 0; i < kSize; ++i) {
+    BinaryData[i] = i & 255;
+  }
+  StringRef BinaryDataStr(BinaryData, kSize);
+
+  TestZstdCompression(BinaryDataStr, zstd::NoCompression);
+  TestZstdCompression(BinaryDataStr, zstd::BestSizeCompression);
+  TestZstdCompression(BinaryDataStr, zstd::BestSpeedCompression);
+  TestZstdCompression(BinaryDataStr, zstd::DefaultCompression);
+  TestZstdCompression(BinaryDataStr, zstd::DefaultCompression, 2);
+}
+
+TEST(CompressionTest, ZstdStream) {
+  std::string Input;
+  for (size_t i = 0; i < (1 << 20); ++i)
+    Input += std::to_string(i % 1000);
+
+  // Compress in small pieces, then append a second frame.
+  zstd::StreamCompressor C(zstd::BestSpeedCompression, 2);
+  SmallString<32> Compressed;
+  for (size_t I = 0, E = Input.size(); I < E; I += 4099)
+    ASSERT_THAT_ERROR(C.write(StringRef(Input).slice(I, I + 4099), Compressed),
+                      Succeeded());
+  ASSERT_THAT_ERROR(C.finish(Compressed), Succeeded());
+  ASSERT_THAT_ERROR(C.write("hello, world!", Compressed), Succeeded());
+  ASSERT_THAT_ERROR(C.finish(Compressed), Succeeded());
+  std::string Expected = Input + "hello, world!";
+
+  // Decompress in pieces that split frames at arbitrary points.
+  zstd::StreamDecompressor D;
+  SmallString<32> Uncompressed;
+  for (size_t I = 0, E = Compressed.size(); I < E; I += 1021)
+    ASSERT_THAT_ERROR(D.write(Compressed.slice(I, I + 1021), Uncompressed),
+                      Succeeded());
+  EXPECT_TRUE(D.isFinished());
+  EXPECT_EQ(Expected, Uncompressed);
+
+  // A truncated frame is not finished.
+  zstd::StreamDecompressor Truncated;
+  SmallString<32> Partial;
+  ASSERT_THAT_ERROR(
+      Truncated.write(Compressed.str().drop_back(), Partial), Succeeded());
+  EXPECT_FALSE(Truncated.isFinished());
+
+  // The one-shot interface accepts concatenated frames too.
+  Uncompressed.clear();
+  ASSERT_THAT_ERROR(
+      zstd::uncompress(Compressed, Uncompressed, Expected.size()),
+      Succeeded());
+  EXPECT_EQ(Expected, Uncompressed);
+
+  Error E = D.write("not a zstd frame", Uncompressed);
+  EXPECT_EQ("zstd error: Unknown frame descriptor",
+            llvm::toString(std::move(E)));
+}
+
+#endif
+
 }
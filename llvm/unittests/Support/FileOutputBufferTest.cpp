@@ -155,6 +155,34 @@ TEST(FileOutputBuffer, Test) {
   ASSERT_EQ(File6Size, 0ULL);
   ASSERT_NO_ERROR(fs::remove(File6.str()));
 
+  // TEST 7: Released pages keep their contents.
+  SmallString<128> File7(TestDirectory);
+  File7.append("/file7");
+  {
+    Expected<std::unique_ptr<FileOutputBuffer>> BufferOrErr =
+        FileOutputBuffer::create(File7, 1 << 20);
+    ASSERT_NO_ERROR(errorToErrorCode(BufferOrErr.takeError()));
+    std::unique_ptr<FileOutputBuffer> &Buffer = *BufferOrErr;
+    memset(Buffer->getBufferStart(), 'A', Buffer->getBufferSize());
+    Buffer->releasePages(1, Buffer->getBufferSize() - 2);
+    EXPECT_EQ('A', Buffer->getBufferStart()[0]);
+    EXPECT_EQ('A', Buffer->getBufferStart()[12345]);
+    EXPECT_EQ('A', Buffer->getBufferEnd()[-1]);
+    // Released pages can still be written to.
+    memcpy(Buffer->getBufferStart() + 12345, "AABBCCDDEEFFGGHHIIJJ", 20);
+    ASSERT_NO_ERROR(errorToErrorCode(Buffer->commit()));
+  }
+  {
+    ErrorOr<std::unique_ptr<MemoryBuffer>> BufOrErr =
+        MemoryBuffer::getFile(File7);
+    ASSERT_NO_ERROR(BufOrErr.getError());
+    StringRef Data = (*BufOrErr)->getBuffer();
+    ASSERT_EQ(Data.size(), 1u << 20);
+    EXPECT_EQ(Data.substr(12345, 20), "AABBCCDDEEFFGGHHIIJJ");
+    EXPECT_EQ(Data.count('A'), Data.size() - 18);
+  }
+  ASSERT_NO_ERROR(fs::remove(File7.str()));
+
   // Clean up.
   ASSERT_NO_ERROR(fs::remove(TestDirectory.str()));
 }
@@ -410,6 +410,37 @@ TEST_F(MemoryBufferTest, mmapVolatileNoNull) {
   EXPECT_TRUE(MB->getBuffer().startswith("01234567"));
 }
 
+TEST_F(MemoryBufferTest, mmapWithFlags) {
+  int FD;
+  SmallString<64> TestPath;
+  ASSERT_NO_ERROR(sys::fs::createTemporaryFile(
+      "MemoryBufferTest_mmapWithFlags", "temp", FD, TestPath));
+  FileRemover Cleanup(TestPath);
+  raw_fd_ostream OF(FD, true);
+  unsigned PageSize = sys::Process::getPageSizeEstimate();
+  unsigned FileWrites = (PageSize * 8) / 8;
+  for (unsigned i = 0; i < FileWrites; ++i)
+    OF << "01234567";
+  OF.close();
+
+  // The flags are only hints, so every combination must give the same
+  // contents.
+  for (unsigned Flags = 0; Flags != 16; ++Flags) {
+    auto MBOrError = MemoryBuffer::getFileSlice(
+        TestPath, PageSize * 4, PageSize + 3, /*IsVolatile=*/false,
+        sys::fs::MapFlags(Flags));
+    ASSERT_NO_ERROR(MBOrError.getError());
+    OwningBuffer MB = std::move(*MBOrError);
+    EXPECT_EQ(MB->getBufferKind(), MemoryBuffer::MemoryBuffer_MMap);
+    ASSERT_EQ(MB->getBufferSize(), PageSize * 4);
+    EXPECT_TRUE(MB->getBuffer().startswith("34567012"));
+    MB->willNeedIfMmap(0, MB->getBufferSize());
+    MB->willNeedIfMmap(PageSize - 1, 2);
+    MB->willNeedIfMmap(MB->getBufferSize() - 1, 1);
+    EXPECT_TRUE(MB->getBuffer().endswith("01234567012"));
+  }
+}
+
 // Test that SmallVector without a null terminator gets one.
 TEST(SmallVectorMemoryBufferTest, WithoutNullTerminatorRequiresNullTerminator) {
   SmallString<0> Data("some data");
@@ -14,6 +14,7 @@
 #include "llvm/Support/Parallel.h"
 #include "gtest/gtest.h"
 #include <array>
+#include <atomic>
 #include <random>
 
 uint32_t array[1024 * 1024];
@@ -92,4 +93,14 @@ TEST(Parallel, ForEachError) {
   EXPECT_EQ(errText, std::string("asdf\nasdf\nasdf"));
 }
 
+TEST(Parallel, NestedForEach) {
+  // Nested parallel loops run on the same thread pool; waiting for an inner
+  // loop must not deadlock it.
+  std::atomic<uint32_t> count{0};
+  parallelForEachN(0, 64, [&](size_t) {
+    parallelForEachN(0, 2048, [&](size_t) { ++count; });
+  });
+  EXPECT_EQ(count, 64u * 2048u);
+}
+
 #endif
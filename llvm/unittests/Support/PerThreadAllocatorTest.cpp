@@ -0,0 +1,114 @@
+//===- PerThreadAllocatorTest.cpp - PerThreadAllocator tests --------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/PerThreadAllocator.h"
+#include "gtest/gtest.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+TEST(PerThreadAllocatorTest, SingleThread) {
+  ConcurrentBumpPtrAllocator Alloc;
+  EXPECT_EQ(0u, Alloc.getBytesAllocated());
+  EXPECT_EQ(&Alloc.get(), &Alloc.get());
+
+  uint64_t *A = Alloc.Allocate<uint64_t>(10);
+  uint64_t *B = Alloc.Allocate<uint64_t>(10);
+  EXPECT_NE(A, B);
+  EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(A) % alignof(uint64_t));
+  EXPECT_EQ(160u, Alloc.getBytesAllocated());
+  EXPECT_LE(160u, Alloc.getTotalMemory());
+
+  Alloc.Reset();
+  EXPECT_EQ(0u, Alloc.getBytesAllocated());
+}
+
+TEST(PerThreadAllocatorTest, ManyThreads) {
+  constexpr unsigned NumThreads = 8;
+  constexpr unsigned NumAllocs = 10000;
+  ConcurrentBumpPtrAllocator Alloc;
+  std::vector<std::vector<unsigned *>> Ptrs(NumThreads);
+  std::vector<BumpPtrAllocator *> Allocators(NumThreads);
+  std::atomic<unsigned> NumReady(0);
+
+  std::vector<std::thread> Threads;
+  for (unsigned T = 0; T != NumThreads; ++T) {
+    Threads.emplace_back([&, T] {
+      // Keep every thread alive until all have their allocator, so that no
+      // two of them share a thread index.
+      Allocators[T] = &Alloc.get();
+      ++NumReady;
+      while (NumReady != NumThreads)
+        std::this_thread::yield();
+      for (unsigned I = 0; I != NumAllocs; ++I) {
+        unsigned *P = Alloc.Allocate<unsigned>();
+        *P = T * NumAllocs + I;
+        Ptrs[T].push_back(P);
+      }
+    });
+  }
+  for (std::thread &T : Threads)
+    T.join();
+
+  // Every thread had its own allocator while all of them were running.
+  std::vector<BumpPtrAllocator *> Sorted = Allocators;
+  std::sort(Sorted.begin(), Sorted.end());
+  EXPECT_TRUE(std::adjacent_find(Sorted.begin(), Sorted.end()) == Sorted.end());
+
+  // No allocation was handed out twice.
+  for (unsigned T = 0; T != NumThreads; ++T)
+    for (unsigned I = 0; I != NumAllocs; ++I)
+      EXPECT_EQ(T * NumAllocs + I, *Ptrs[T][I]);
+
+  EXPECT_EQ(NumThreads * NumAllocs * sizeof(unsigned),
+            Alloc.getBytesAllocated());
+  unsigned NumAllocators = 0;
+  Alloc.forEach([&](BumpPtrAllocator &) { ++NumAllocators; });
+  EXPECT_EQ(NumThreads, NumAllocators);
+}
+
+// Threads that run one after another reuse the same index, so the arena does
+// not grow an allocator per thread ever started.
+TEST(PerThreadAllocatorTest, ThreadIndexReuse) {
+  ConcurrentBumpPtrAllocator Alloc;
+  for (unsigned I = 0; I != 100; ++I)
+    std::thread([&] { Alloc.Allocate<char>(1); }).join();
+  unsigned NumAllocators = 0;
+  Alloc.forEach([&](BumpPtrAllocator &) { ++NumAllocators; });
+  EXPECT_GE(2u, NumAllocators);
+  EXPECT_EQ(100u, Alloc.getBytesAllocated());
+}
+
+struct Counted {
+  static std::atomic<unsigned> NumLive;
+  Counted() { ++NumLive; }
+  ~Counted() { --NumLive; }
+};
+std::atomic<unsigned> Counted::NumLive;
+
+TEST(PerThreadAllocatorTest, DestroyAll) {
+  ConcurrentSpecificBumpPtrAllocator<Counted> Alloc;
+  std::vector<std::thread> Threads;
+  for (unsigned T = 0; T != 4; ++T)
+    Threads.emplace_back([&] {
+      for (unsigned I = 0; I != 1000; ++I)
+        new (Alloc.Allocate()) Counted();
+    });
+  for (std::thread &T : Threads)
+    T.join();
+  EXPECT_EQ(4000u, Counted::NumLive);
+  Alloc.DestroyAll();
+  EXPECT_EQ(0u, Counted::NumLive);
+}
+
+} // namespace
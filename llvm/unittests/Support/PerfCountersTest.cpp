@@ -0,0 +1,44 @@
+//===- unittests/Support/PerfCountersTest.cpp - PerfCounters tests --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/PerfCounters.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+unsigned spin(unsigned N) {
+  volatile unsigned X = 0;
+  for (unsigned I = 0; I != N; ++I)
+    X = X + I;
+  return X;
+}
+
+TEST(PerfCountersTest, Interval) {
+  PerfCounterValues Start = readPerfCounters();
+  spin(1000000);
+  PerfCounterValues End = readPerfCounters();
+  EXPECT_GE(End.Cycles, Start.Cycles);
+  EXPECT_GE(End.Instructions, Start.Instructions);
+  EXPECT_GE(End.CacheMisses, Start.CacheMisses);
+  EXPECT_GE(End.BranchMisses, Start.BranchMisses);
+  EXPECT_GE(End.PeakRSS, Start.PeakRSS);
+
+  PerfCounterValues Interval = End;
+  Interval -= Start;
+  EXPECT_EQ(End.Instructions - Start.Instructions, Interval.Instructions);
+  Interval += Start;
+  EXPECT_EQ(End.Cycles, Interval.Cycles);
+
+  // The loop runs at least one instruction per iteration.
+  if (perfCountersAvailable() && End.Instructions)
+    EXPECT_GE(End.Instructions - Start.Instructions, 1000000u);
+}
+
+} // end anonymous namespace
@@ -0,0 +1,72 @@
+//===- unittests/Support/SuffixArrayTest.cpp - suffix array tests ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/SuffixArray.h"
+#include "gtest/gtest.h"
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+using Repeat = std::pair<unsigned, std::vector<unsigned>>;
+
+template <typename RangeT> std::set<Repeat> collect(RangeT &Repeats) {
+  std::set<Repeat> Result;
+  for (const SuffixTree::RepeatedSubstring &RS : Repeats) {
+    std::vector<unsigned> StartIndices = RS.StartIndices;
+    llvm::sort(StartIndices);
+    Result.insert({RS.Length, StartIndices});
+  }
+  return Result;
+}
+
+TEST(SuffixArrayTest, TestSuffixesAndLCP) {
+  std::vector<unsigned> Data = {2, 1, 2, 1, 3};
+  SuffixArray SA(Data);
+  EXPECT_EQ(std::vector<unsigned>({1, 3, 0, 2, 4}),
+            std::vector<unsigned>(SA.getSuffixes().begin(),
+                                  SA.getSuffixes().end()));
+  EXPECT_EQ(std::vector<unsigned>({0, 1, 0, 2, 0}),
+            std::vector<unsigned>(SA.getLCP().begin(), SA.getLCP().end()));
+}
+
+TEST(SuffixArrayTest, TestLongerRepetition) {
+  std::vector<unsigned> Data = {1, 2, 3, 1, 2, 3, 4};
+  SuffixArray SA(Data);
+  std::set<Repeat> Expected = {{3, {0, 3}}, {2, {1, 4}}};
+  EXPECT_EQ(Expected, collect(SA));
+}
+
+TEST(SuffixArrayTest, TestSingleCharacterRepeat) {
+  std::vector<unsigned> Data = {1, 1, 1, 1, 1, 1, 2};
+  SuffixArray SA(Data);
+  std::set<Repeat> Expected = {{5, {0, 1}}};
+  EXPECT_EQ(Expected, collect(SA));
+}
+
+// The suffix array finds the same repeated substrings as the suffix tree.
+TEST(SuffixArrayTest, TestMatchesSuffixTree) {
+  std::mt19937 Rand(0);
+  for (unsigned Iter = 0; Iter != 500; ++Iter) {
+    unsigned Len = Rand() % 64 + 1;
+    unsigned Alphabet = Rand() % 4 + 1;
+    std::vector<unsigned> Data;
+    for (unsigned I = 1; I != Len; ++I)
+      Data.push_back(Rand() % Alphabet);
+    // Like the outliner's mapping, the string ends with a unique element.
+    Data.push_back(-3);
+    SuffixTree ST(Data);
+    SuffixArray SA(Data);
+    ASSERT_EQ(collect(ST), collect(SA));
+  }
+}
+
+} // namespace
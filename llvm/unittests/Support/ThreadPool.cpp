@@ -194,6 +194,65 @@ TEST_F(ThreadPoolTest, PoolDestruction) {
   ASSERT_EQ(5, checked_in);
 }
 
+TEST_F(ThreadPoolTest, GroupWait) {
+  CHECK_UNSUPPORTED();
+  // Test that waiting for a group does not wait for other tasks.
+  std::atomic_int checked_in1{0};
+  std::atomic_int checked_in2{0};
+  ThreadPool Pool(hardware_concurrency(2));
+  ThreadPoolTaskGroup Group1(Pool);
+  ThreadPoolTaskGroup Group2(Pool);
+  Group1.async([this, &checked_in1] {
+    waitForMainThread();
+    ++checked_in1;
+  });
+  for (size_t i = 0; i < 5; ++i)
+    Group2.async([&checked_in2] { ++checked_in2; });
+  Group2.wait();
+  ASSERT_EQ(0, checked_in1);
+  ASSERT_EQ(5, checked_in2);
+  setMainThreadReady();
+  Group1.wait();
+  ASSERT_EQ(1, checked_in1);
+}
+
+TEST_F(ThreadPoolTest, NestedGroupWait) {
+  CHECK_UNSUPPORTED();
+  // Test that a task can wait for a group of tasks it spawned, even if there
+  // is no other thread to run them.
+  std::atomic_int checked_in{0};
+  ThreadPool Pool(hardware_concurrency(1));
+  ThreadPoolTaskGroup Outer(Pool);
+  Outer.async([&] {
+    ThreadPoolTaskGroup Inner(Pool);
+    for (size_t i = 0; i < 5; ++i)
+      Inner.async([&checked_in] { ++checked_in; });
+    Inner.wait();
+    ASSERT_EQ(5, checked_in);
+    ++checked_in;
+  });
+  Outer.wait();
+  ASSERT_EQ(6, checked_in);
+}
+
+TEST_F(ThreadPoolTest, Priorities) {
+  CHECK_UNSUPPORTED();
+  // With a single thread kept busy until all tasks are queued, tasks run in
+  // order of priority.
+  std::vector<int> Order;
+  ThreadPool Pool(hardware_concurrency(1));
+  ThreadPoolTaskGroup Low(Pool, ThreadPool::Priority::Low);
+  ThreadPoolTaskGroup Normal(Pool);
+  ThreadPoolTaskGroup High(Pool, ThreadPool::Priority::High);
+  Pool.async([this] { waitForMainThread(); });
+  Low.async([&Order] { Order.push_back(3); });
+  Normal.async([&Order] { Order.push_back(2); });
+  High.async([&Order] { Order.push_back(1); });
+  setMainThreadReady();
+  Pool.wait();
+  ASSERT_EQ((std::vector<int>{1, 2, 3}), Order);
+}
+
 #if LLVM_ENABLE_THREADS == 1
 
 // FIXME: Skip some tests below on non-Windows because multi-socket systems
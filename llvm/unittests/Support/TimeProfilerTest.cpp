@@ -0,0 +1,128 @@
+//===- unittests/TimeProfilerTest.cpp - Time profiler tests ---------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/JSON.h"
+#include "gtest/gtest.h"
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace llvm;
+
+namespace {
+
+struct Event {
+  std::string Name;
+  std::string Detail;
+  int64_t Count = 0;
+};
+
+// Writes the profile and returns the section events in order, followed by the
+// per-name totals.
+void writeProfile(std::vector<Event> &Sections,
+                  std::map<std::string, int64_t> &Totals) {
+  SmallString<1024> Buffer;
+  raw_svector_ostream OS(Buffer);
+  timeTraceProfilerWrite(OS);
+  timeTraceProfilerCleanup();
+
+  Expected<json::Value> Profile = json::parse(Buffer);
+  ASSERT_TRUE(bool(Profile));
+  const json::Array *TraceEvents =
+      Profile->getAsObject()->getArray("traceEvents");
+  ASSERT_NE(nullptr, TraceEvents);
+  for (const json::Value &V : *TraceEvents) {
+    const json::Object *O = V.getAsObject();
+    if (O->getString("ph") != StringRef("X"))
+      continue;
+    StringRef Name = *O->getString("name");
+    const json::Object *Args = O->getObject("args");
+    if (Name.consume_front("Total ")) {
+      Totals[Name.str()] = *Args->getInteger("count");
+      continue;
+    }
+    Event E;
+    E.Name = Name.str();
+    if (Args)
+      E.Detail = Args->getString("detail")->str();
+    Sections.push_back(E);
+  }
+}
+
+TEST(TimeProfiler, Sections) {
+  timeTraceProfilerInitialize(0, "test");
+  {
+    TimeTraceScope Outer("Outer", "file.cpp");
+    TimeTraceScope Inner("Inner");
+  }
+
+  std::vector<Event> Sections;
+  std::map<std::string, int64_t> Totals;
+  writeProfile(Sections, Totals);
+  ASSERT_EQ(2u, Sections.size());
+  EXPECT_EQ("Inner", Sections[0].Name);
+  EXPECT_EQ("Outer", Sections[1].Name);
+  EXPECT_EQ("file.cpp", Sections[1].Detail);
+  EXPECT_EQ(1, Totals["Outer"]);
+  EXPECT_EQ(1, Totals["Inner"]);
+}
+
+TEST(TimeProfiler, RingBufferKeepsNewestSections) {
+  timeTraceProfilerInitialize(0, "test", /*RingBufferSize=*/4);
+  for (int I = 0; I != 10; ++I) {
+    TimeTraceScope Outer("Outer", [&] { return std::to_string(I); });
+    TimeTraceScope Inner("Inner");
+  }
+
+  std::vector<Event> Sections;
+  std::map<std::string, int64_t> Totals;
+  writeProfile(Sections, Totals);
+  ASSERT_EQ(4u, Sections.size());
+  EXPECT_EQ("Inner", Sections[0].Name);
+  EXPECT_EQ("Outer", Sections[1].Name);
+  EXPECT_EQ("8", Sections[1].Detail);
+  EXPECT_EQ("Inner", Sections[2].Name);
+  EXPECT_EQ("Outer", Sections[3].Name);
+  EXPECT_EQ("9", Sections[3].Detail);
+
+  // Totals count every section, including the overwritten ones.
+  EXPECT_EQ(10, Totals["Outer"]);
+  EXPECT_EQ(10, Totals["Inner"]);
+}
+
+TEST(TimeProfiler, RingBufferNestedSameName) {
+  timeTraceProfilerInitialize(0, "test", /*RingBufferSize=*/16);
+  {
+    TimeTraceScope Outer("Instantiate");
+    TimeTraceScope Inner("Instantiate");
+  }
+
+  std::vector<Event> Sections;
+  std::map<std::string, int64_t> Totals;
+  writeProfile(Sections, Totals);
+  EXPECT_EQ(2u, Sections.size());
+  EXPECT_EQ(1, Totals["Instantiate"]);
+}
+
+TEST(TimeProfiler, RingBufferTruncatesDetail) {
+  timeTraceProfilerInitialize(0, "test", /*RingBufferSize=*/16);
+  std::string LongDetail(1000, 'x');
+  { TimeTraceScope Scope("Scope", LongDetail); }
+
+  std::vector<Event> Sections;
+  std::map<std::string, int64_t> Totals;
+  writeProfile(Sections, Totals);
+  ASSERT_EQ(1u, Sections.size());
+  EXPECT_FALSE(Sections[0].Detail.empty());
+  EXPECT_LT(Sections[0].Detail.size(), LongDetail.size());
+  EXPECT_EQ(std::string::npos, Sections[0].Detail.find_first_not_of('x'));
+}
+
+} // end anonymous namespace
@@ -14,6 +14,7 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/SourceMgr.h"
+#include "llvm/Testing/Support/Error.h"
 #include "llvm/Testing/Support/SupportHelpers.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -883,6 +884,56 @@ TEST(ProxyFileSystemTest, Basic) {
   EXPECT_FALSE(Local);
 }
 
+TEST(StatCacheFileSystemTest, Basic) {
+  TempDir TestDirectory("stat-cache-test", /*Unique*/ true);
+  TempDir _a(TestDirectory.path("a"));
+  TempFile _ab(TestDirectory.path("a/b.h"), "", "contents");
+
+  SmallString<0> Cache;
+  raw_svector_ostream OS(Cache);
+  ASSERT_THAT_ERROR(
+      vfs::StatCacheFileSystem::writeStatCache(TestDirectory.path(), OS),
+      Succeeded());
+  // Not in the cache, and it does not change the root either.
+  TempFile _ac(TestDirectory.path("a/c.h"), "", "contents");
+
+  IntrusiveRefCntPtr<vfs::FileSystem> RealFS = vfs::getRealFileSystem();
+  auto FSOrErr = vfs::StatCacheFileSystem::create(
+      MemoryBuffer::getMemBufferCopy(Cache), RealFS);
+  ASSERT_THAT_EXPECTED(FSOrErr, Succeeded());
+  vfs::FileSystem &FS = **FSOrErr;
+
+  ErrorOr<vfs::Status> Stat = FS.status(TestDirectory.path("a/b.h"));
+  ASSERT_TRUE(Stat);
+  EXPECT_TRUE(Stat->isRegularFile());
+  EXPECT_EQ(8u, Stat->getSize());
+  EXPECT_EQ(TestDirectory.path("a/b.h"), Stat->getName());
+  EXPECT_TRUE(Stat->equivalent(*RealFS->status(TestDirectory.path("a/b.h"))));
+  Stat = FS.status(TestDirectory.path("a"));
+  ASSERT_TRUE(Stat);
+  EXPECT_TRUE(Stat->isDirectory());
+  auto File = FS.openFileForRead(TestDirectory.path("a/b.h"));
+  ASSERT_TRUE(File);
+  EXPECT_EQ("contents", (*(*File)->getBuffer("ignored"))->getBuffer());
+
+  // Everything else in the tree is missing.
+  EXPECT_EQ(std::make_error_code(std::errc::no_such_file_or_directory),
+            FS.status(TestDirectory.path("a/c.h")).getError());
+  EXPECT_EQ(std::make_error_code(std::errc::no_such_file_or_directory),
+            FS.openFileForRead(TestDirectory.path("a/c.h")).getError());
+  EXPECT_FALSE(FS.status(TestDirectory.path("x/y.h")));
+
+  // Paths outside the tree are left to the underlying file system.
+  EXPECT_TRUE(FS.status(sys::path::parent_path(TestDirectory.path())));
+}
+
+TEST(StatCacheFileSystemTest, Invalid) {
+  EXPECT_THAT_EXPECTED(
+      vfs::StatCacheFileSystem::create(MemoryBuffer::getMemBuffer("junk"),
+                                       vfs::getRealFileSystem()),
+      Failed());
+}
+
 class InMemoryFileSystemTest : public ::testing::Test {
 protected:
   llvm::vfs::InMemoryFileSystem FS;
@@ -502,6 +502,39 @@ TEST(raw_ostreamTest, writeToOutputFile) {
   checkFileData(Path, "HelloWorld");
 }
 
+TEST(raw_ostreamTest, asyncWrites) {
+  SmallString<64> Path;
+  int FD;
+  ASSERT_FALSE(sys::fs::createTemporaryFile("foo", "bar", FD, Path));
+  FileRemover Cleanup(Path);
+
+  // Use small buffers so that the writer thread cycles through them, and mix
+  // writes that go through the buffer with ones that are larger than it.
+  std::string Expected;
+  {
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    OS.enableAsyncWrites(/*BufferSize=*/64, /*NumBuffers=*/2);
+    for (int I = 0; I != 1000; ++I) {
+      std::string Line = "line " + std::to_string(I) + "\n";
+      if (I % 100 == 0)
+        Line += std::string(300, 'a' + I / 100);
+      OS << Line;
+      Expected += Line;
+    }
+
+    // pwrite waits for the queued writes, so it overwrites the data that was
+    // written before it.
+    OS.pwrite("LINE", 4, 0);
+    Expected.replace(0, 4, "LINE");
+    OS << "tail";
+    Expected += "tail";
+    EXPECT_EQ(Expected.size(), OS.tell());
+    OS.close();
+    EXPECT_FALSE(OS.has_error());
+  }
+  checkFileData(Path, Expected);
+}
+
 TEST(raw_ostreamTest, writeToNonexistingPath) {
   StringRef FileName = "/_bad/_path";
   std::string ErrorMessage = toString(createFileError(
@@ -59,6 +59,21 @@ TEST(sha1_hash_test, Update) {
   ASSERT_EQ("3E4A614101AD84985AB0FE54DC12A6D71551E5AE", Hash);
 }
 
+TEST(sha1_hash_test, LongInput) {
+  // Whole blocks are hashed straight from the input, with the SHA extensions
+  // if the host has them. Check that this agrees with the buffered path.
+  std::string Input(1000000, 'a');
+  std::array<uint8_t, 20> Vec = SHA1::hash(
+      {reinterpret_cast<const uint8_t *>(Input.data()), Input.size()});
+  std::string Hash = toHex({(const char *)Vec.data(), 20});
+  ASSERT_EQ("34AA973CD4C4DAA4F61EEB2BDBAD27316534016F", Hash);
+
+  SHA1 sha1;
+  sha1.update(StringRef(Input).take_front(1));
+  sha1.update(StringRef(Input).drop_front(1));
+  ASSERT_EQ(Hash, toHex(sha1.final()));
+}
+
 // Check that getting the intermediate hash in the middle of the stream does
 // not invalidate the final result.
 TEST(raw_sha1_ostreamTest, Intermediate) {
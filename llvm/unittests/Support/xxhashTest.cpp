@@ -9,6 +9,8 @@
 #include "llvm/Support/xxhash.h"
 #include "gtest/gtest.h"
 
+#include <vector>
+
 using namespace llvm;
 
 TEST(xxhashTest, Basic) {
@@ -17,3 +19,51 @@ TEST(xxhashTest, Basic) {
   EXPECT_EQ(0x69196c1b3af0bff9U,
             xxHash64("0123456789abcdefghijklmnopqrstuvwxyz"));
 }
+
+// Fills a buffer with the same pseudo-random bytes as xxHash's sanity checks.
+static std::vector<uint8_t> getSanityBuffer(size_t Size) {
+  std::vector<uint8_t> Buffer(Size);
+  uint64_t ByteGen = 0x9E3779B1U;
+  for (uint8_t &B : Buffer) {
+    B = ByteGen >> 56;
+    ByteGen *= 11400714785074694797ULL;
+  }
+  return Buffer;
+}
+
+TEST(xxhashTest, xxh3) {
+  // The lengths cover every code path, including partial and full blocks of
+  // the long input loop.
+  struct {
+    size_t Len;
+    uint64_t Hash64;
+    XXH128_hash_t Hash128;
+  } Tests[] = {
+      {0, 0x2d06800538d394c2U, {0x6001c324468d497fU, 0x99aa06d3014798d8U}},
+      {1, 0xc44bdff4074eecdbU, {0xc44bdff4074eecdbU, 0xa6cd5e9392000f6aU}},
+      {6, 0x27b56a84cd2d7325U, {0x3e7039bdda43cfc6U, 0x082afe0b8162d12aU}},
+      {12, 0xa713daf0dfbb77e7U, {0x061a192713f69ad9U, 0x6e3efd8fc7802b18U}},
+      {24, 0xa3fe70bf9d3510ebU, {0x1e7044d28b1b901dU, 0x0ce966e4678d3761U}},
+      {48, 0x397da259ecba1f11U, {0xf942219aed80f67bU, 0xa002ac4e5478227eU}},
+      {80, 0xbcdefbbb2c47c90aU, {0x454ae6bf7a8a532dU, 0xfdf2cefde9eaac8aU}},
+      {195, 0xcd94217ee362ec3aU, {0x3fb593c086a66075U, 0x7729543a26b207eeU}},
+      {403, 0xcdeb804d65c6dea4U, {0xcdeb804d65c6dea4U, 0x1b6de21e332dd73dU}},
+      {512, 0x617e49599013cb6bU, {0x617e49599013cb6bU, 0x18d2d110dcc9bca1U}},
+      {1025, 0xd870c0fa13211c6aU, {0xd870c0fa13211c6aU, 0xfd3ee4fe7f2954c6U}},
+      {2048, 0xdd59e2c3a5f038e0U, {0xdd59e2c3a5f038e0U, 0xf736557fd47073a5U}},
+      {2240, 0x6e73a90539cf2948U, {0x6e73a90539cf2948U, 0xccb134fbfa7ce49dU}},
+      {2367, 0xcb37aeb9e5d361edU, {0xcb37aeb9e5d361edU, 0xe89c0f6ff369b427U}},
+      {4096, 0xe91206429d1f48f9U, {0xe91206429d1f48f9U, 0xb9cfaea2ca5626a4U}},
+  };
+
+  std::vector<uint8_t> Buffer = getSanityBuffer(4096);
+  for (const auto &T : Tests) {
+    ArrayRef<uint8_t> Data = makeArrayRef(Buffer).take_front(T.Len);
+    EXPECT_EQ(T.Hash64, xxh3_64bits(Data)) << "Len = " << T.Len;
+    XXH128_hash_t Hash128 = xxh3_128bits(Data);
+    EXPECT_EQ(T.Hash128.low64, Hash128.low64) << "Len = " << T.Len;
+    EXPECT_EQ(T.Hash128.high64, Hash128.high64) << "Len = " << T.Len;
+  }
+
+  EXPECT_EQ(0xab6e5f64077e7d8aU, xxh3_64bits("foo"));
+}
@@ -0,0 +1,144 @@
+//===- FunctionPipelineCacheTest.cpp - Unit tests for the pipeline cache --===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Transforms/IPO/FunctionPipelineCache.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/Verifier.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+/// Redirects calls of @slow to @fast, and counts the functions it ran on.
+struct RedirectCallsPass : PassInfoMixin<RedirectCallsPass> {
+  int &Runs;
+
+  explicit RedirectCallsPass(int &Runs) : Runs(Runs) {}
+
+  PreservedAnalyses run(Function &F, FunctionAnalysisManager &) {
+    ++Runs;
+    for (Instruction &I : instructions(F)) {
+      auto *CI = dyn_cast<CallInst>(&I);
+      Function *Callee = CI ? CI->getCalledFunction() : nullptr;
+      if (!Callee || Callee->getName() != "slow")
+        continue;
+      CI->setCalledFunction(F.getParent()->getOrInsertFunction(
+          "fast", Callee->getFunctionType(), Callee->getAttributes()));
+    }
+    return PreservedAnalyses::none();
+  }
+};
+
+const char *const TestIR = R"IR(
+  %struct.S = type { i32, i32 }
+
+  @table = private unnamed_addr constant [2 x i32] [i32 1, i32 TABLE]
+
+  declare i32 @slow(%struct.S*)
+
+  define linkonce_odr i32 @f(%struct.S* %s) {
+    %p = getelementptr [2 x i32], [2 x i32]* @table, i64 0, i64 1
+    %v = load i32, i32* %p
+    %r = call i32 @slow(%struct.S* %s)
+    %sum = add i32 %v, %r
+    ret i32 %sum
+  }
+)IR";
+
+class FunctionPipelineCacheTest : public testing::Test {
+protected:
+  SmallString<128> CacheDir;
+
+  void SetUp() override {
+    ASSERT_FALSE(sys::fs::createUniqueDirectory("fn-cache", CacheDir));
+  }
+  void TearDown() override { sys::fs::remove_directories(CacheDir); }
+
+  std::unique_ptr<Module> parse(LLVMContext &Ctx, StringRef Table) {
+    std::string IR = TestIR;
+    IR.replace(IR.find("TABLE"), 5, Table.str());
+    SMDiagnostic Err;
+    std::unique_ptr<Module> M = parseAssemblyString(IR, Err, Ctx);
+    if (!M)
+      Err.print("FunctionPipelineCacheTest", errs());
+    return M;
+  }
+
+  /// Runs RedirectCallsPass through the cache and returns how many functions
+  /// it ran on.
+  int run(Module &M) {
+    int Runs = 0;
+    FunctionAnalysisManager FAM;
+    ModuleAnalysisManager MAM;
+    MAM.registerPass([&] { return FunctionAnalysisManagerModuleProxy(FAM); });
+    MAM.registerPass([&] { return PassInstrumentationAnalysis(); });
+    FAM.registerPass([&] { return ModuleAnalysisManagerFunctionProxy(MAM); });
+    FAM.registerPass([&] { return PassInstrumentationAnalysis(); });
+
+    ModulePassManager MPM;
+    MPM.addPass(createCachingModuleToFunctionPassAdaptor(
+        RedirectCallsPass(Runs), std::string(CacheDir)));
+    MPM.run(M, MAM);
+    return Runs;
+  }
+
+  static std::string print(const Function &F) {
+    std::string S;
+    raw_string_ostream OS(S);
+    OS << F;
+    return OS.str();
+  }
+};
+
+TEST_F(FunctionPipelineCacheTest, ReusesOptimizedBody) {
+  LLVMContext Ctx1;
+  std::unique_ptr<Module> M1 = parse(Ctx1, "2");
+  ASSERT_TRUE(M1);
+  EXPECT_EQ(1, run(*M1));
+
+  // The second module is in a context of its own, which already has a
+  // %struct.S when the entry is read.
+  LLVMContext Ctx2;
+  std::unique_ptr<Module> M2 = parse(Ctx2, "2");
+  ASSERT_TRUE(M2);
+  EXPECT_EQ(0, run(*M2));
+  EXPECT_FALSE(verifyModule(*M2, &errs()));
+
+  Function *Fast = M2->getFunction("fast");
+  ASSERT_TRUE(Fast);
+  EXPECT_TRUE(Fast->isDeclaration());
+  EXPECT_EQ(print(*M1->getFunction("f")), print(*M2->getFunction("f")));
+  EXPECT_EQ(GlobalValue::LinkOnceODRLinkage,
+            M2->getFunction("f")->getLinkage());
+  Type *ArgTy = M2->getFunction("f")->getArg(0)->getType();
+  EXPECT_EQ(StructType::getTypeByName(Ctx2, "struct.S"),
+            ArgTy->getPointerElementType());
+}
+
+TEST_F(FunctionPipelineCacheTest, MissesWhenConstantsDiffer) {
+  LLVMContext Ctx1;
+  std::unique_ptr<Module> M1 = parse(Ctx1, "2");
+  ASSERT_TRUE(M1);
+  EXPECT_EQ(1, run(*M1));
+
+  // Passes may fold loads from the table, so its contents are part of the key.
+  LLVMContext Ctx2;
+  std::unique_ptr<Module> M2 = parse(Ctx2, "3");
+  ASSERT_TRUE(M2);
+  EXPECT_EQ(1, run(*M2));
+  EXPECT_FALSE(verifyModule(*M2, &errs()));
+}
+
+} // end anonymous namespace
@@ -75,6 +75,55 @@ TEST(FDRTraceWriterTest, WriteToStringBufferVersion3) {
                           Field(&XRayRecord::Type, Eq(RecordTypes::EXIT))));
 }
 
+// Traces with buffers from several threads are reconstituted independently
+// for each thread, so make sure that the records of all of the threads are
+// loaded.
+TEST(FDRTraceWriterTest, WriteToStringBufferMultipleThreads) {
+  std::string Data;
+  raw_string_ostream OS(Data);
+  XRayFileHeader H;
+  H.Version = 3;
+  H.Type = 1;
+  H.ConstantTSC = true;
+  H.NonstopTSC = true;
+  H.CycleFrequency = 3e9;
+  FDRTraceWriter Writer(OS, H);
+  for (int32_t TId : {2, 1, 3}) {
+    auto L = LogBuilder()
+                 .add<BufferExtents>(80)
+                 .add<NewBufferRecord>(TId)
+                 .add<WallclockRecord>(1, 1)
+                 .add<PIDRecord>(1)
+                 .add<NewCPUIDRecord>(1, TId * 1000)
+                 .add<FunctionRecord>(RecordTypes::ENTER, TId, 1)
+                 .add<FunctionRecord>(RecordTypes::EXIT, TId, 100)
+                 .consume();
+    for (auto &P : L)
+      ASSERT_FALSE(errorToBool(P->apply(Writer)));
+  }
+  OS.flush();
+
+  DataExtractor DE(Data, sys::IsLittleEndianHost, 8);
+  auto TraceOrErr = loadTrace(DE, true);
+  if (!TraceOrErr)
+    FAIL() << TraceOrErr.takeError();
+  auto &Trace = TraceOrErr.get();
+
+  EXPECT_THAT(Trace, ElementsAre(Field(&XRayRecord::TId, Eq(1u)),
+                                 Field(&XRayRecord::TId, Eq(1u)),
+                                 Field(&XRayRecord::TId, Eq(2u)),
+                                 Field(&XRayRecord::TId, Eq(2u)),
+                                 Field(&XRayRecord::TId, Eq(3u)),
+                                 Field(&XRayRecord::TId, Eq(3u))));
+  EXPECT_THAT(Trace,
+              ElementsAre(Field(&XRayRecord::Type, Eq(RecordTypes::ENTER)),
+                          Field(&XRayRecord::Type, Eq(RecordTypes::EXIT)),
+                          Field(&XRayRecord::Type, Eq(RecordTypes::ENTER)),
+                          Field(&XRayRecord::Type, Eq(RecordTypes::EXIT)),
+                          Field(&XRayRecord::Type, Eq(RecordTypes::ENTER)),
+                          Field(&XRayRecord::Type, Eq(RecordTypes::EXIT))));
+}
+
 // This version is almost exactly the same as above, except writing version 2
 // logs, without the PID records.
 TEST(FDRTraceWriterTest, WriteToStringBufferVersion2) {
@@ -12,6 +12,7 @@
 
 #include "CodeGenDAGPatterns.h"
 #include "DAGISelMatcher.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/TableGen/Record.h"
 #include "llvm/TableGen/TableGenBackend.h"
@@ -72,12 +73,23 @@ static unsigned getResultPatternSize(TreePatternNode *P,
 }
 
 namespace {
+/// PatternSortKey - The parts of a pattern's sort order which are expensive to
+/// compute.  They are computed once per pattern rather than on every
+/// comparison made by the sort.
+struct PatternSortKey {
+  int Complexity;
+  unsigned Cost;
+  unsigned Size;
+};
+
 // PatternSortingPredicate - return true if we prefer to match LHS before RHS.
 // In particular, we want to match maximal patterns first and lowest cost within
 // a particular complexity first.
 struct PatternSortingPredicate {
-  PatternSortingPredicate(CodeGenDAGPatterns &cgp) : CGP(cgp) {}
-  CodeGenDAGPatterns &CGP;
+  PatternSortingPredicate(
+      const DenseMap<const PatternToMatch *, PatternSortKey> &keys)
+      : Keys(keys) {}
+  const DenseMap<const PatternToMatch *, PatternSortKey> &Keys;
 
   bool operator()(const PatternToMatch *LHS, const PatternToMatch *RHS) {
     const TreePatternNode *LT = LHS->getSrcPattern();
@@ -91,24 +103,23 @@ struct PatternSortingPredicate {
     if (LHSVT.isFloatingPoint() != RHSVT.isFloatingPoint())
       return RHSVT.isFloatingPoint();
 
+    const PatternSortKey &LHSKey = Keys.find(LHS)->second;
+    const PatternSortKey &RHSKey = Keys.find(RHS)->second;
+
     // Otherwise, if the patterns might both match, sort based on complexity,
     // which means that we prefer to match patterns that cover more nodes in the
     // input over nodes that cover fewer.
-    int LHSSize = LHS->getPatternComplexity(CGP);
-    int RHSSize = RHS->getPatternComplexity(CGP);
-    if (LHSSize > RHSSize) return true;   // LHS -> bigger -> less cost
-    if (LHSSize < RHSSize) return false;
+    if (LHSKey.Complexity > RHSKey.Complexity)
+      return true; // LHS -> bigger -> less cost
+    if (LHSKey.Complexity < RHSKey.Complexity)
+      return false;
 
     // If the patterns have equal complexity, compare generated instruction cost
-    unsigned LHSCost = getResultPatternCost(LHS->getDstPattern(), CGP);
-    unsigned RHSCost = getResultPatternCost(RHS->getDstPattern(), CGP);
-    if (LHSCost < RHSCost) return true;
-    if (LHSCost > RHSCost) return false;
+    if (LHSKey.Cost < RHSKey.Cost) return true;
+    if (LHSKey.Cost > RHSKey.Cost) return false;
 
-    unsigned LHSPatSize = getResultPatternSize(LHS->getDstPattern(), CGP);
-    unsigned RHSPatSize = getResultPatternSize(RHS->getDstPattern(), CGP);
-    if (LHSPatSize < RHSPatSize) return true;
-    if (LHSPatSize > RHSPatSize) return false;
+    if (LHSKey.Size < RHSKey.Size) return true;
+    if (LHSKey.Size > RHSKey.Size) return false;
 
     // Sort based on the UID of the pattern, to reflect source order.
     // Note that this is not guaranteed to be unique, since a single source
@@ -153,12 +164,17 @@ void DAGISelEmitter::run(raw_ostream &OS) {
   // Add all the patterns to a temporary list so we can sort them.
   Records.startTimer("Sort patterns");
   std::vector<const PatternToMatch*> Patterns;
-  for (const PatternToMatch &PTM : CGP.ptms())
+  DenseMap<const PatternToMatch *, PatternSortKey> SortKeys;
+  for (const PatternToMatch &PTM : CGP.ptms()) {
     Patterns.push_back(&PTM);
+    SortKeys[&PTM] = {PTM.getPatternComplexity(CGP),
+                      getResultPatternCost(PTM.getDstPattern(), CGP),
+                      getResultPatternSize(PTM.getDstPattern(), CGP)};
+  }
 
   // We want to process the matches in order of minimal cost.  Sort the patterns
   // so the least cost one is at the start.
-  llvm::stable_sort(Patterns, PatternSortingPredicate(CGP));
+  llvm::stable_sort(Patterns, PatternSortingPredicate(SortKeys));
 
   // Convert each variant of each pattern into a Matcher.
   Records.startTimer("Convert to matchers");
@@ -21,6 +21,7 @@
 #include "llvm/Support/SourceMgr.h"
 #include "llvm/TableGen/Error.h"
 #include "llvm/TableGen/Record.h"
+#include "llvm/TableGen/StringToOffsetTable.h"
 #include <algorithm>
 #include <set>
 #include <string>
@@ -156,8 +157,10 @@ private:
                                   const SearchIndex &Index,
                                   const GenericField &Field, TypeContext Ctx) {
     if (isa<StringRecTy>(Field.RecType)) {
+      // Index tables refer to their keys by offset into a string table, so
+      // that they need no relocations.
       if (Ctx == TypeInStaticStruct)
-        return "const char *";
+        return "unsigned";
       if (Ctx == TypeInTempStruct)
         return "std::string";
       return "StringRef";
@@ -331,8 +334,6 @@ void SearchableTableEmitter::emitLookupFunction(const GenericTable &Table,
     OS << "    unsigned _index;\n";
     OS << "  };\n";
 
-    OS << "  static const struct IndexType Index[] = {\n";
-
     std::vector<std::pair<Record *, unsigned>> Entries;
     Entries.reserve(Table.Entries.size());
     for (unsigned i = 0; i < Table.Entries.size(); ++i)
@@ -343,22 +344,36 @@ void SearchableTableEmitter::emitLookupFunction(const GenericTable &Table,
       return compareBy(LHS.first, RHS.first, Index);
     });
 
+    StringToOffsetTable IndexStrings;
+    std::string IndexRowsText;
+    raw_string_ostream IndexRowsOS(IndexRowsText);
     IndexRowsStorage.reserve(Entries.size());
     for (const auto &Entry : Entries) {
       IndexRowsStorage.push_back(Entry.first);
 
-      OS << "    { ";
+      IndexRowsOS << "    { ";
       ListSeparator LS;
       for (const auto &Field : Index.Fields) {
-        std::string Repr = primaryRepresentation(
-            Index.Loc, Field, Entry.first->getValueInit(Field.Name));
-        if (isa<StringRecTy>(Field.RecType))
-          Repr = StringRef(Repr).upper();
-        OS << LS << Repr;
+        Init *I = Entry.first->getValueInit(Field.Name);
+        StringInit *SI = dyn_cast<StringInit>(I);
+        if (SI && isa<StringRecTy>(Field.RecType)) {
+          IndexRowsOS << LS << IndexStrings.GetOrAddStringOffset(
+                                   SI->getValue().upper());
+          continue;
+        }
+        IndexRowsOS << LS << primaryRepresentation(Index.Loc, Field, I);
       }
-      OS << ", " << Entry.second << " },\n";
+      IndexRowsOS << ", " << Entry.second << " },\n";
+    }
+
+    if (!IndexStrings.Empty()) {
+      OS << "  static const char IndexStrings[] =\n";
+      IndexStrings.EmitString(OS);
+      OS << ";\n";
     }
 
+    OS << "  static const struct IndexType Index[] = {\n";
+    OS << IndexRowsOS.str();
     OS << "  };\n\n";
 
     IndexTypeName = "IndexType";
@@ -431,7 +446,8 @@ void SearchableTableEmitter::emitLookupFunction(const GenericTable &Table,
 
   for (const auto &Field : Index.Fields) {
     if (isa<StringRecTy>(Field.RecType)) {
-      OS << "      int Cmp" << Field.Name << " = StringRef(LHS." << Field.Name
+      OS << "      int Cmp" << Field.Name << " = StringRef("
+         << (IsPrimary ? "" : "IndexStrings + ") << "LHS." << Field.Name
          << ").compare(RHS." << Field.Name << ");\n";
       OS << "      if (Cmp" << Field.Name << " < 0) return true;\n";
       OS << "      if (Cmp" << Field.Name << " > 0) return false;\n";
@@ -457,8 +473,12 @@ void SearchableTableEmitter::emitLookupFunction(const GenericTable &Table,
 
   OS << "  if (Idx == Table.end()";
 
-  for (const auto &Field : Index.Fields)
-    OS << " ||\n      Key." << Field.Name << " != Idx->" << Field.Name;
+  for (const auto &Field : Index.Fields) {
+    OS << " ||\n      Key." << Field.Name << " != ";
+    if (!IsPrimary && isa<StringRecTy>(Field.RecType))
+      OS << "IndexStrings + ";
+    OS << "Idx->" << Field.Name;
+  }
   OS << ")\n    return nullptr;\n";
 
   if (IsPrimary)
@@ -0,0 +1,177 @@
+//===- AsyncRuntime.cpp - MLIR async runtime benchmarks -------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Measures the task scheduling overhead of the async runtime:
+//
+// - Spawn: latency of spawning independent tasks from the main thread and
+//   awaiting them with a group.
+// - SpawnTree: recursively spawned tasks, the pattern produced by
+//   `async-parallel-for` with async block dispatch.
+// - ParallelFor: a fixed amount of work split into blocks of varying size,
+//   showing where dispatch overhead starts to dominate.
+//
+// Work runs on the runtime's worker threads, so rates are computed from wall
+// time. The number of worker threads is controlled by the
+// `MLIR_ASYNC_RUNTIME_NUM_THREADS` environment variable.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "mlir/ExecutionEngine/AsyncRuntime.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/ErrorHandling.h"
+
+using namespace mlir::runtime;
+
+// The runtime library only exports its symbols through the runner interface.
+extern "C" void __mlir_runner_init(llvm::StringMap<void *> &exportSymbols);
+
+namespace {
+
+/// The async runtime API, resolved from the runtime library.
+struct Runtime {
+  void (*addRef)(RefCountedObjPtr, int64_t);
+  void (*dropRef)(RefCountedObjPtr, int64_t);
+  AsyncToken *(*createToken)();
+  AsyncGroup *(*createGroup)(int64_t);
+  void (*emplaceToken)(AsyncToken *);
+  int64_t (*addTokenToGroup)(AsyncToken *, AsyncGroup *);
+  void (*awaitAllInGroup)(AsyncGroup *);
+  void (*execute)(CoroHandle, CoroResume);
+};
+
+const Runtime &getRuntime() {
+  static const Runtime runtime = [] {
+    llvm::StringMap<void *> symbols;
+    __mlir_runner_init(symbols);
+    auto lookup = [&](llvm::StringRef name, auto &fn) {
+      void *ptr = symbols.lookup(name);
+      if (!ptr)
+        llvm::report_fatal_error(llvm::Twine("missing async runtime symbol ") +
+                                 name);
+      fn = reinterpret_cast<std::remove_reference_t<decltype(fn)>>(ptr);
+    };
+    Runtime rt;
+    lookup("mlirAsyncRuntimeAddRef", rt.addRef);
+    lookup("mlirAsyncRuntimeDropRef", rt.dropRef);
+    lookup("mlirAsyncRuntimeCreateToken", rt.createToken);
+    lookup("mlirAsyncRuntimeCreateGroup", rt.createGroup);
+    lookup("mlirAsyncRuntimeEmplaceToken", rt.emplaceToken);
+    lookup("mlirAsyncRuntimeAddTokenToGroup", rt.addTokenToGroup);
+    lookup("mlirAsyncRuntimeAwaitAllInGroup", rt.awaitAllInGroup);
+    lookup("mlirAsyncRuntimeExecute", rt.execute);
+    return rt;
+  }();
+  return runtime;
+}
+
+/// A task computing `body(begin, end)` over an iteration range. Ranges larger
+/// than `blockSize` are split in two, and the first half is spawned as a new
+/// task, like the async block dispatch of `async-parallel-for`.
+struct RangeTask {
+  int64_t begin, end, blockSize;
+  AsyncToken *token;
+  void (*body)(int64_t, int64_t);
+};
+
+void runRange(int64_t begin, int64_t end, int64_t blockSize,
+              void (*body)(int64_t, int64_t));
+
+void resumeRangeTask(void *handle) {
+  auto *task = static_cast<RangeTask *>(handle);
+  runRange(task->begin, task->end, task->blockSize, task->body);
+  getRuntime().emplaceToken(task->token);
+  delete task;
+}
+
+void runRange(int64_t begin, int64_t end, int64_t blockSize,
+              void (*body)(int64_t, int64_t)) {
+  const Runtime &rt = getRuntime();
+  if (end - begin <= blockSize)
+    return body(begin, end);
+
+  int64_t mid = begin + (end - begin) / 2;
+  AsyncToken *token = rt.createToken();
+  AsyncGroup *group = rt.createGroup(1);
+  rt.execute(new RangeTask{begin, mid, blockSize, token, body},
+             resumeRangeTask);
+  rt.addTokenToGroup(token, group);
+  rt.dropRef(token, 1);
+
+  runRange(mid, end, blockSize, body);
+  rt.awaitAllInGroup(group);
+  rt.dropRef(group, 1);
+}
+
+void emptyBody(int64_t, int64_t) {}
+
+void computeBody(int64_t begin, int64_t end) {
+  float acc = 0;
+  for (int64_t i = begin; i < end; ++i)
+    acc += static_cast<float>(i) * 0.5f;
+  benchmark::DoNotOptimize(acc);
+}
+
+//===----------------------------------------------------------------------===//
+// Benchmarks
+//===----------------------------------------------------------------------===//
+
+void benchmarkSpawn(benchmark::State &state) {
+  const Runtime &rt = getRuntime();
+  int64_t numTasks = state.range(0);
+  for (auto _ : state) {
+    AsyncGroup *group = rt.createGroup(numTasks);
+    for (int64_t i = 0; i < numTasks; ++i) {
+      AsyncToken *token = rt.createToken();
+      rt.addRef(token, 1);
+      rt.execute(token, [](void *handle) {
+        getRuntime().emplaceToken(static_cast<AsyncToken *>(handle));
+        getRuntime().dropRef(handle, 1);
+      });
+      rt.addTokenToGroup(token, group);
+      rt.dropRef(token, 1);
+    }
+    rt.awaitAllInGroup(group);
+    rt.dropRef(group, 1);
+  }
+  state.SetItemsProcessed(numTasks * state.iterations());
+}
+BENCHMARK(benchmarkSpawn)
+    ->RangeMultiplier(10)
+    ->Range(10, 100000)
+    ->UseRealTime();
+
+void benchmarkSpawnTree(benchmark::State &state) {
+  int64_t numTasks = state.range(0);
+  for (auto _ : state)
+    runRange(0, numTasks, /*blockSize=*/1, emptyBody);
+  state.SetItemsProcessed(numTasks * state.iterations());
+}
+BENCHMARK(benchmarkSpawnTree)
+    ->RangeMultiplier(10)
+    ->Range(10, 100000)
+    ->UseRealTime();
+
+void benchmarkParallelFor(benchmark::State &state) {
+  const int64_t numIterations = 1 << 22;
+  int64_t blockSize = state.range(0);
+  for (auto _ : state)
+    runRange(0, numIterations, blockSize, computeBody);
+  state.SetItemsProcessed(numIterations * state.iterations());
+  state.counters["blocks"] = (numIterations + blockSize - 1) / blockSize;
+}
+BENCHMARK(benchmarkParallelFor)
+    ->RangeMultiplier(4)
+    ->Range(64, 1 << 22)
+    ->UseRealTime()
+    ->Unit(benchmark::kMicrosecond);
+
+} // namespace
+
+BENCHMARK_MAIN();
@@ -0,0 +1,302 @@
+//===- CompileTime.cpp - MLIR compile time benchmarks ---------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Measures the throughput of the core MLIR infrastructure on modules of
+// increasing size:
+//
+// - Parse, Print, Verify: the textual format and the verifier.
+// - WriteBytecode, ParseBytecode: the bytecode format.
+// - Pipeline: common passes and conversions, run through the pass manager.
+//
+// The synthetic modules contain functions of arithmetic chains with foldable
+// operations, redundant expressions and calls to a private function, so that
+// canonicalization, CSE and inlining have work to do. Additional IR files,
+// e.g. taken from real models, may be passed as positional arguments:
+//
+//   MLIRCompileTime [benchmark flags] [input.mlir...]
+//
+// Each benchmark reports the number of operations processed per second as
+// `ops`, and the benchmarks that build a module report the heap memory held by
+// the module as `bytes_per_op`. Multi-threading is disabled, so that results
+// are comparable between machines. For trend tracking, run with
+// `--benchmark_repetitions=N --benchmark_report_aggregates_only=true
+// --benchmark_format=json` and compare the medians.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "mlir/Bytecode/BytecodeWriter.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/IR/Verifier.h"
+#include "mlir/InitAllDialects.h"
+#include "mlir/InitAllPasses.h"
+#include "mlir/Parser.h"
+#include "mlir/Pass/PassManager.h"
+#include "mlir/Pass/PassRegistry.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Process.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace mlir;
+
+namespace {
+
+/// The pass pipelines measured by the Pipeline benchmarks.
+struct PipelineInfo {
+  const char *name;
+  const char *pipeline;
+};
+const PipelineInfo pipelines[] = {
+    {"CSE", "cse"},
+    {"Canonicalize", "canonicalize"},
+    {"Inline", "inline"},
+    {"ArithToLLVM", "builtin.func(convert-arith-to-llvm)"},
+    {"LowerToLLVM", "builtin.func(convert-arith-to-llvm),convert-std-to-llvm"},
+};
+
+/// Build the textual IR of a synthetic module with `numFuncs` functions of
+/// `opsPerFunc` arithmetic operations each.
+std::string generateModule(unsigned numFuncs, unsigned opsPerFunc) {
+  std::string ir;
+  llvm::raw_string_ostream os(ir);
+  os << "func private @callee(%a: i32, %b: i32) -> i32 {\n"
+        "  %0 = arith.addi %a, %b : i32\n"
+        "  %1 = arith.muli %0, %a : i32\n"
+        "  return %1 : i32\n"
+        "}\n";
+  for (unsigned f = 0; f != numFuncs; ++f) {
+    os << "func @f" << f << "(%arg0: i32, %arg1: i32) -> i32 {\n"
+       << "  %c0 = arith.constant 0 : i32\n"
+       << "  %c1 = arith.constant 1 : i32\n"
+       << "  %v0 = arith.addi %arg0, %arg1 : i32\n";
+    for (unsigned i = 1; i < opsPerFunc; ++i) {
+      os << "  %v" << i << " = ";
+      switch (i % 4) {
+      case 0: // Folded away by canonicalization.
+        os << "arith.addi %v" << i - 1 << ", %c0 : i32\n";
+        break;
+      case 1: // Duplicated by the next operation, which is removed by CSE.
+        os << "arith.muli %v" << i - 1 << ", %arg1 : i32\n";
+        break;
+      case 2:
+        os << "arith.muli %v" << i - 2 << ", %arg1 : i32\n";
+        break;
+      case 3: // Inlined.
+        os << "call @callee(%v" << i - 1 << ", %v" << i - 2
+           << ") : (i32, i32) -> i32\n";
+        break;
+      }
+    }
+    os << "  return %v" << opsPerFunc - 1 << " : i32\n}\n";
+  }
+  return os.str();
+}
+
+/// Return the context used by all of the benchmarks.
+MLIRContext &getContext() {
+  static MLIRContext *context = [] {
+    DialectRegistry registry;
+    registerAllDialects(registry);
+    auto *context = new MLIRContext(registry);
+    context->disableMultithreading();
+    context->loadAllAvailableDialects();
+    return context;
+  }();
+  return *context;
+}
+
+/// Parse the given IR, aborting on failure.
+OwningModuleRef parse(StringRef ir) {
+  OwningModuleRef module = parseSourceString(ir, &getContext());
+  if (!module)
+    llvm::report_fatal_error("failed to parse benchmark input");
+  return module;
+}
+
+/// Return the number of operations nested within `module`.
+int64_t countOps(ModuleOp module) {
+  int64_t numOps = 0;
+  module.walk([&](Operation *) { ++numOps; });
+  return numOps;
+}
+
+/// Record the operation throughput of the benchmark.
+void setOpsCounter(benchmark::State &state, int64_t numOps) {
+  state.counters["ops"] = benchmark::Counter(
+      numOps * state.iterations(), benchmark::Counter::kIsRate);
+}
+
+//===----------------------------------------------------------------------===//
+// Benchmarks
+//===----------------------------------------------------------------------===//
+
+/// The source of the IR to benchmark, either a synthetic module or a file.
+using IRSource = std::function<std::string(benchmark::State &)>;
+
+/// Return a source for a synthetic module sized by the benchmark's arguments.
+IRSource getSyntheticSource() {
+  return [](benchmark::State &state) {
+    return generateModule(state.range(0), /*opsPerFunc=*/32);
+  };
+}
+
+/// Return a source for the IR file at `path`.
+IRSource getFileSource(std::string path) {
+  return [path](benchmark::State &) {
+    auto fileOrErr = llvm::MemoryBuffer::getFile(path);
+    if (!fileOrErr)
+      llvm::report_fatal_error("failed to open benchmark input " +
+                               llvm::Twine(path));
+    return (*fileOrErr)->getBuffer().str();
+  };
+}
+
+void benchmarkParse(benchmark::State &state, IRSource source) {
+  std::string ir = source(state);
+  int64_t numOps = countOps(*parse(ir));
+
+  size_t mallocBefore = llvm::sys::Process::GetMallocUsage();
+  size_t moduleBytes = 0;
+  for (auto _ : state) {
+    OwningModuleRef module = parse(ir);
+    if (!moduleBytes)
+      moduleBytes = llvm::sys::Process::GetMallocUsage() - mallocBefore;
+    state.PauseTiming();
+    module = nullptr;
+    state.ResumeTiming();
+  }
+  setOpsCounter(state, numOps);
+  state.counters["bytes_per_op"] = double(moduleBytes) / numOps;
+  state.SetBytesProcessed(ir.size() * state.iterations());
+}
+
+void benchmarkPrint(benchmark::State &state, IRSource source) {
+  OwningModuleRef module = parse(source(state));
+  std::string output;
+  for (auto _ : state) {
+    output.clear();
+    llvm::raw_string_ostream os(output);
+    module->print(os);
+    os.flush();
+    benchmark::DoNotOptimize(output.data());
+  }
+  setOpsCounter(state, countOps(*module));
+  state.SetBytesProcessed(output.size() * state.iterations());
+}
+
+void benchmarkVerify(benchmark::State &state, IRSource source) {
+  OwningModuleRef module = parse(source(state));
+  for (auto _ : state) {
+    if (failed(verify(*module)))
+      llvm::report_fatal_error("benchmark input failed to verify");
+  }
+  setOpsCounter(state, countOps(*module));
+}
+
+void benchmarkWriteBytecode(benchmark::State &state, IRSource source) {
+  OwningModuleRef module = parse(source(state));
+  std::string output;
+  for (auto _ : state) {
+    output.clear();
+    llvm::raw_string_ostream os(output);
+    writeBytecodeToFile(*module, os);
+    os.flush();
+    benchmark::DoNotOptimize(output.data());
+  }
+  setOpsCounter(state, countOps(*module));
+  state.SetBytesProcessed(output.size() * state.iterations());
+}
+
+void benchmarkParseBytecode(benchmark::State &state, IRSource source) {
+  OwningModuleRef module = parse(source(state));
+  int64_t numOps = countOps(*module);
+  std::string bytecode;
+  {
+    llvm::raw_string_ostream os(bytecode);
+    writeBytecodeToFile(*module, os);
+  }
+  module = nullptr;
+
+  for (auto _ : state) {
+    module = parse(bytecode);
+    state.PauseTiming();
+    module = nullptr;
+    state.ResumeTiming();
+  }
+  setOpsCounter(state, numOps);
+  state.SetBytesProcessed(bytecode.size() * state.iterations());
+}
+
+void benchmarkPipeline(benchmark::State &state, IRSource source,
+                       const char *pipeline) {
+  std::string ir = source(state);
+  int64_t numOps = countOps(*parse(ir));
+
+  PassManager pm(&getContext());
+  if (failed(parsePassPipeline(pipeline, pm)))
+    llvm::report_fatal_error("failed to parse benchmark pipeline");
+  for (auto _ : state) {
+    state.PauseTiming();
+    OwningModuleRef module = parse(ir);
+    state.ResumeTiming();
+
+    if (failed(pm.run(*module)))
+      llvm::report_fatal_error("benchmark pipeline failed");
+
+    state.PauseTiming();
+    module = nullptr;
+    state.ResumeTiming();
+  }
+  setOpsCounter(state, numOps);
+}
+
+/// Register all of the benchmarks for the given source of IR. Synthetic
+/// sources are registered with a range of module sizes, given in number of
+/// functions.
+void registerBenchmarks(StringRef sourceName, IRSource source,
+                        bool isSynthetic) {
+  auto add = [&](StringRef name, auto fn) {
+    std::string fullName = (name + "/" + sourceName).str();
+    auto *bench = benchmark::RegisterBenchmark(
+        fullName.c_str(),
+        [=](benchmark::State &state) { fn(state, source); });
+    bench->Unit(benchmark::kMillisecond);
+    if (isSynthetic)
+      bench->RangeMultiplier(10)->Range(10, 1000);
+  };
+  add("Parse", benchmarkParse);
+  add("Print", benchmarkPrint);
+  add("Verify", benchmarkVerify);
+  add("WriteBytecode", benchmarkWriteBytecode);
+  add("ParseBytecode", benchmarkParseBytecode);
+  for (const PipelineInfo &info : pipelines) {
+    const char *pipeline = info.pipeline;
+    add(std::string("Pipeline/") + info.name,
+        [pipeline](benchmark::State &state, const IRSource &source) {
+          benchmarkPipeline(state, source, pipeline);
+        });
+  }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  registerAllPasses();
+
+  // Any arguments left after the benchmark flags are IR files to benchmark.
+  benchmark::Initialize(&argc, argv);
+  registerBenchmarks("synthetic", getSyntheticSource(), /*isSynthetic=*/true);
+  for (int i = 1; i < argc; ++i)
+    registerBenchmarks(argv[i], getFileSource(argv[i]), /*isSynthetic=*/false);
+
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
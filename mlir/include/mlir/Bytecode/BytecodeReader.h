@@ -0,0 +1,44 @@
+//===- BytecodeReader.h - MLIR Bytecode Reader ------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This header defines interfaces to read MLIR bytecode files/streams.
+//
+// The reader is part of the MLIRParser library: `parseSourceFile` and friends
+// detect bytecode buffers and dispatch to it, so most clients never need to
+// call it directly.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef MLIR_BYTECODE_BYTECODEREADER_H
+#define MLIR_BYTECODE_BYTECODEREADER_H
+
+#include "mlir/Support/LLVM.h"
+#include "mlir/Support/LogicalResult.h"
+
+namespace llvm {
+class MemoryBufferRef;
+} // namespace llvm
+
+namespace mlir {
+class Block;
+class LocationAttr;
+class MLIRContext;
+
+/// Returns true if the given buffer starts with the magic bytes that signal
+/// MLIR bytecode.
+bool isBytecode(llvm::MemoryBufferRef buffer);
+
+/// Read the operations defined within the given memory buffer, containing MLIR
+/// bytecode, into the provided block. If `sourceFileLoc` is non-null, it is
+/// populated with a file location representing the start of the buffer.
+LogicalResult readBytecodeFile(llvm::MemoryBufferRef buffer, Block *block,
+                               MLIRContext *context,
+                               LocationAttr *sourceFileLoc = nullptr);
+} // namespace mlir
+
+#endif // MLIR_BYTECODE_BYTECODEREADER_H
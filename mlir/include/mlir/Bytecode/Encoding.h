@@ -0,0 +1,126 @@
+//===- Encoding.h - MLIR binary format encoding information -----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This header defines enum values describing the structure of MLIR bytecode
+// files.
+//
+// A bytecode file is laid out as:
+//
+//   bytecode {
+//     magic: "ML\xefR",
+//     version: varint,
+//     producer: varint-length string,
+//     section*
+//   }
+//
+//   section {
+//     id: byte,
+//     length: varint,
+//     data: byte[length]
+//   }
+//
+// Every section in `Section::ID` must be present exactly once. Variable width
+// integers are LEB128 encoded, signed ones SLEB128.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef MLIR_BYTECODE_ENCODING_H
+#define MLIR_BYTECODE_ENCODING_H
+
+#include <cstdint>
+
+namespace mlir {
+namespace bytecode {
+//===----------------------------------------------------------------------===//
+// General constants
+//===----------------------------------------------------------------------===//
+
+enum {
+  /// The current bytecode version.
+  kVersion = 0,
+};
+
+/// The magic number at the start of every bytecode file.
+static constexpr char kMagic[] = {'M', 'L', '\xef', 'R'};
+
+//===----------------------------------------------------------------------===//
+// Sections
+//===----------------------------------------------------------------------===//
+
+namespace Section {
+enum ID : uint8_t {
+  /// This section contains strings referenced within the bytecode:
+  ///   numStrings: varint, { length: varint, data: byte[length] }*
+  kString = 0,
+
+  /// This section contains the dialects and operation names referenced within
+  /// the bytecode:
+  ///   numDialects: varint, { name: string index }*
+  ///   numOpNames: varint, { dialect: varint, name: string index }*
+  kDialect = 1,
+
+  /// This section contains the encoded attributes and types, back to back in
+  /// index order, attributes first.
+  kAttrType = 2,
+
+  /// This section contains the offset table for `kAttrType`:
+  ///   numAttrs: varint, numTypes: varint,
+  ///   { dialect: varint, sizeAndIsCustom: varint }*
+  /// Entries that are not custom hold the textual assembly form.
+  kAttrTypeOffset = 3,
+
+  /// This section contains the operations of the top-level block:
+  ///   numOps: varint, operation*
+  kIR = 4,
+
+  /// The total number of section types.
+  kNumSections = 5,
+};
+} // namespace Section
+
+//===----------------------------------------------------------------------===//
+// IR Section
+//===----------------------------------------------------------------------===//
+
+/// An operation is encoded as:
+///
+///   operation {
+///     name: varint,
+///     encodingMask: byte,
+///     location: attribute index,
+///     attrDict: attribute index?,
+///     numResults: varint?, resultTypes: type index[]?,
+///     numOperands: varint?, operands: value index[]?,
+///     numSuccessors: varint?, successors: block index[]?,
+///     numRegions: varint?, region*
+///   }
+///
+///   region { numBlocks: varint, block* }
+///   block {
+///     numOpsAndHasArgs: varint,      // (numOps << 1) | hasArgs
+///     numArgs: varint?, { type: type index, loc: attribute index }*,
+///     operation*
+///   }
+///
+/// Values are numbered in the order they are defined: results of an operation
+/// before the values of its regions, block arguments before the operations of
+/// the block. Block indices are relative to the parent region.
+namespace OpEncodingMask {
+enum : uint8_t {
+  kHasAttrs = 0x01,
+  kHasResults = 0x02,
+  kHasOperands = 0x04,
+  kHasSuccessors = 0x08,
+  kHasRegions = 0x10,
+};
+} // namespace OpEncodingMask
+
+} // namespace bytecode
+} // namespace mlir
+
+#endif // MLIR_BYTECODE_ENCODING_H
@@ -10,6 +10,7 @@
 #define MLIR_IR_BUILTINATTRIBUTES_H
 
 #include "mlir/IR/BuiltinAttributeInterfaces.h"
+#include "mlir/IR/DialectResourceBlobManager.h"
 #include "mlir/IR/SubElementInterfaces.h"
 #include "llvm/ADT/APFloat.h"
 #include "llvm/ADT/Sequence.h"
@@ -729,6 +730,47 @@ public:
     return denseAttr && denseAttr.isSplat();
   }
 };
+
+//===----------------------------------------------------------------------===//
+// DenseResourceElementsHandle
+//===----------------------------------------------------------------------===//
+
+/// A handle to a blob owned by the resource blob manager of the builtin
+/// dialect. Handles compare and hash by the blob entry they refer to, never by
+/// the contents of the blob.
+class DenseResourceElementsHandle {
+public:
+  using BlobEntry = DialectResourceBlobManager::BlobEntry;
+
+  DenseResourceElementsHandle(BlobEntry *entry = nullptr) : entry(entry) {}
+
+  /// Return the key of the referenced blob.
+  StringRef getKey() const { return entry->getKey(); }
+
+  /// Return the referenced blob, or nullptr if its data hasn't been provided
+  /// yet.
+  AsmResourceBlob *getBlob() const { return entry->getBlob(); }
+
+  /// Return the blob entry referenced by this handle.
+  BlobEntry *getEntry() const { return entry; }
+
+  bool operator==(const DenseResourceElementsHandle &other) const {
+    return entry == other.entry;
+  }
+  bool operator!=(const DenseResourceElementsHandle &other) const {
+    return !(*this == other);
+  }
+
+  /// Return the blob manager of the builtin dialect in the given context.
+  static DialectResourceBlobManager &getManager(MLIRContext *context);
+
+private:
+  BlobEntry *entry;
+};
+
+inline llvm::hash_code hash_value(DenseResourceElementsHandle handle) {
+  return llvm::hash_value(handle.getEntry());
+}
 } // namespace mlir
 
 //===----------------------------------------------------------------------===//
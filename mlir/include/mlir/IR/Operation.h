@@ -303,16 +303,31 @@ public:
   // Operations may optionally carry a list of attributes that associate
   // constants to names.  Attributes may be dynamically added and removed over
   // the lifetime of an operation.
+  //
+  // Attributes are generally held in a uniqued DictionaryAttr. Modifying
+  // individual attributes switches the operation to an owned, non-uniqued
+  // attribute list that is updated in place, and the dictionary is only
+  // re-uniqued once it is requested again. This avoids uniquing a new
+  // dictionary for every intermediate state of a sequence of modifications.
+  // Note that requesting the full set of attributes of a modified operation
+  // may thus modify its storage, which is not safe to do concurrently with
+  // other accesses to the same operation.
 
   /// Return all of the attributes on this operation.
-  ArrayRef<NamedAttribute> getAttrs() { return attrs.getValue(); }
+  ArrayRef<NamedAttribute> getAttrs() { return getAttrDictionary().getValue(); }
 
   /// Return all of the attributes on this operation as a DictionaryAttr.
-  DictionaryAttr getAttrDictionary() { return attrs; }
+  DictionaryAttr getAttrDictionary() {
+    if (LLVM_UNLIKELY(attrs.is<NamedAttrList *>()))
+      return materializeAttrDictionary();
+    return attrs.get<Attribute>().cast<DictionaryAttr>();
+  }
 
   /// Set the attribute dictionary on this operation.
   void setAttrs(DictionaryAttr newAttrs) {
     assert(newAttrs && "expected valid attribute dictionary");
+    if (auto *attrList = attrs.dyn_cast<NamedAttrList *>())
+      delete attrList;
     attrs = newAttrs;
   }
   void setAttrs(ArrayRef<NamedAttribute> newAttrs) {
@@ -320,8 +335,16 @@ public:
   }
 
   /// Return the specified attribute if present, null otherwise.
-  Attribute getAttr(StringAttr name) { return attrs.get(name); }
-  Attribute getAttr(StringRef name) { return attrs.get(name); }
+  Attribute getAttr(StringAttr name) {
+    if (auto *attrList = attrs.dyn_cast<NamedAttrList *>())
+      return attrList->get(name);
+    return attrs.get<Attribute>().cast<DictionaryAttr>().get(name);
+  }
+  Attribute getAttr(StringRef name) {
+    if (auto *attrList = attrs.dyn_cast<NamedAttrList *>())
+      return attrList->get(name);
+    return attrs.get<Attribute>().cast<DictionaryAttr>().get(name);
+  }
 
   template <typename AttrClass>
   AttrClass getAttrOfType(StringAttr name) {
@@ -334,8 +357,8 @@ public:
 
   /// Return true if the operation has an attribute with the provided name,
   /// false otherwise.
-  bool hasAttr(StringAttr name) { return attrs.contains(name); }
-  bool hasAttr(StringRef name) { return attrs.contains(name); }
+  bool hasAttr(StringAttr name) { return static_cast<bool>(getAttr(name)); }
+  bool hasAttr(StringRef name) { return static_cast<bool>(getAttr(name)); }
   template <typename AttrClass, typename NameT>
   bool hasAttrOfType(NameT &&name) {
     return static_cast<bool>(
@@ -345,9 +368,8 @@ public:
   /// If the an attribute exists with the specified name, change it to the new
   /// value. Otherwise, add a new attribute with the specified name/value.
   void setAttr(StringAttr name, Attribute value) {
-    NamedAttrList attributes(attrs);
-    if (attributes.set(name, value) != value)
-      attrs = attributes.getDictionary(getContext());
+    if (getAttr(name) != value)
+      getMutableAttrList().set(name, value);
   }
   void setAttr(StringRef name, Attribute value) {
     setAttr(StringAttr::get(getContext(), name), value);
@@ -357,11 +379,9 @@ public:
   /// attribute that was erased, or nullptr if there was no attribute with such
   /// name.
   Attribute removeAttr(StringAttr name) {
-    NamedAttrList attributes(attrs);
-    Attribute removedAttr = attributes.erase(name);
-    if (removedAttr)
-      attrs = attributes.getDictionary(getContext());
-    return removedAttr;
+    if (!hasAttr(name))
+      return Attribute();
+    return getMutableAttrList().erase(name);
   }
   Attribute removeAttr(StringRef name) {
     return removeAttr(StringAttr::get(getContext(), name));
@@ -715,8 +735,18 @@ private:
   /// This holds the name of the operation.
   OperationName name;
 
-  /// This holds general named attributes for the operation.
-  DictionaryAttr attrs;
+  /// Return the owned attribute list of this operation, switching to it from
+  /// the uniqued attribute dictionary if necessary.
+  NamedAttrList &getMutableAttrList();
+
+  /// Unique the owned attribute list of this operation into a dictionary, and
+  /// switch back to holding the dictionary.
+  DictionaryAttr materializeAttrDictionary();
+
+  /// This holds general named attributes for the operation. This is either a
+  /// uniqued DictionaryAttr, or an owned attribute list for operations whose
+  /// attributes were modified since the dictionary was last requested.
+  llvm::PointerUnion<Attribute, NamedAttrList *> attrs;
 
   // allow ilist_traits access to 'block' field.
   friend struct llvm::ilist_traits<Operation>;
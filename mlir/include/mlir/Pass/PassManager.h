@@ -222,6 +222,19 @@ public:
   /// Runs the verifier after each individual pass.
   void enableVerifier(bool enabled = true);
 
+  /// Reuse the results of previous runs for nested pipelines. When enabled,
+  /// the pass manager records the result of each successful run of a nested
+  /// pipeline, keyed by the structural fingerprint of the operation it ran on.
+  /// If a later call to `run` finds an operation with the same fingerprint,
+  /// e.g. because the same function is compiled again, the recorded result is
+  /// copied into the operation instead of running the pipeline again. Results
+  /// that are not reused during a call to `run` are dropped at the next call.
+  ///
+  /// This is only valid if the nested pipelines are deterministic, and only
+  /// depend on the operation they run on, e.g. not on the contents of other
+  /// symbols. Instrumentations are not notified for reused results.
+  void enableIncrementalExecution(bool enabled = true);
+
   //===--------------------------------------------------------------------===//
   // Instrumentations
   //===--------------------------------------------------------------------===//
@@ -404,6 +417,10 @@ private:
 
   /// A flag that indicates if the IR should be verified in between passes.
   bool verifyPasses : 1;
+
+  /// A flag that indicates if the results of nested pipelines are reused
+  /// between runs.
+  bool incrementalExecution : 1;
 };
 
 /// Register a set of useful command-line options that can be used to configure
@@ -15,6 +15,8 @@
 #define MLIR_REWRITE_PATTERNAPPLICATOR_H
 
 #include "mlir/Rewrite/FrozenRewritePatternSet.h"
+#include "llvm/Support/Mutex.h"
+#include <chrono>
 
 namespace mlir {
 class PatternRewriter;
@@ -23,6 +25,59 @@ namespace detail {
 class PDLByteCodeMutableState;
 } // namespace detail
 
+//===----------------------------------------------------------------------===//
+// PatternProfile
+//===----------------------------------------------------------------------===//
+
+/// This class records, for each pattern, the number of times a match was
+/// attempted, the number of times it was successfully applied, and the time
+/// spent matching and rewriting. A profile may be shared between several
+/// PatternApplicators, e.g. those running on different threads, which
+/// accumulate locally and merge their results when destroyed.
+class PatternProfile {
+public:
+  /// The profiling information recorded for a single pattern.
+  struct Entry {
+    /// Return the fraction of match attempts that succeeded.
+    double getSuccessRate() const {
+      return numAttempts ? double(numSuccesses) / numAttempts : 0.0;
+    }
+
+    Entry &operator+=(const Entry &rhs) {
+      numAttempts += rhs.numAttempts;
+      numSuccesses += rhs.numSuccesses;
+      time += rhs.time;
+      return *this;
+    }
+
+    uint64_t numAttempts = 0;
+    uint64_t numSuccesses = 0;
+    std::chrono::nanoseconds time{0};
+  };
+  using EntryMap = DenseMap<const Pattern *, Entry>;
+
+  /// Merge the given entries into this profile.
+  void merge(const EntryMap &newEntries);
+
+  /// Return a snapshot of the entries currently held by this profile.
+  EntryMap getEntries() const;
+
+  /// Print the profile to the given stream, with the patterns that took the
+  /// most time first.
+  void print(raw_ostream &os) const;
+
+private:
+  /// A mutex guarding access to the entries.
+  mutable llvm::sys::SmartMutex<true> mutex;
+
+  /// The recorded profile entries.
+  EntryMap entries;
+};
+
+//===----------------------------------------------------------------------===//
+// PatternApplicator
+//===----------------------------------------------------------------------===//
+
 /// This class manages the application of a group of rewrite patterns, with a
 /// user-provided cost model.
 class PatternApplicator {
@@ -63,6 +118,18 @@ public:
   /// Walk all of the patterns within the applicator.
   void walkAllPatterns(function_ref<void(const Pattern &)> walk);
 
+  /// Record the match attempts, successes and time of each applied pattern
+  /// into `profile`. The data is accumulated locally, and merged into the
+  /// profile when this applicator is destroyed.
+  void enableProfiling(PatternProfile &profile);
+
+  /// Reorder patterns by their success rate in `profile`, so that patterns
+  /// that are more likely to apply are attempted first. Only patterns with the
+  /// same static benefit are reordered, so the order implied by the benefits
+  /// of the default cost model is preserved. This should be invoked after the
+  /// cost model has been applied.
+  void applyProfileGuidedOrder(const PatternProfile &profile);
+
 private:
   /// The list that owns the patterns used within this applicator.
   const FrozenRewritePatternSet &frozenPatternList;
@@ -73,6 +140,12 @@ private:
   SmallVector<const RewritePattern *, 1> anyOpPatterns;
   /// The mutable state used during execution of the PDL bytecode.
   std::unique_ptr<detail::PDLByteCodeMutableState> mutableByteCodeState;
+
+  /// The profile to merge the locally recorded profiling data into, if
+  /// profiling is enabled.
+  PatternProfile *profile = nullptr;
+  /// The profiling data recorded by this applicator.
+  PatternProfile::EntryMap profileEntries;
 };
 
 } // namespace mlir
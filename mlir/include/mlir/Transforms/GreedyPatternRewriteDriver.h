@@ -17,6 +17,50 @@
 #include "mlir/Rewrite/FrozenRewritePatternSet.h"
 
 namespace mlir {
+class PatternProfile;
+
+/// This class collects statistics about a run of the
+/// GreedyPatternRewriteDriver, broken down by the name of the processed
+/// operations. This is intended to help finding the operations that dominate
+/// the cost of a rewrite, and to guide the ordering of their patterns.
+class GreedyRewriteStatistics {
+public:
+  /// The statistics collected for a single operation name.
+  struct OpStatistics {
+    /// The number of times an operation was popped from the worklist.
+    uint64_t numVisits = 0;
+    /// The number of times an operation was folded.
+    uint64_t numFolded = 0;
+    /// The number of times an operation was erased as trivially dead.
+    uint64_t numErasedDead = 0;
+    /// The number of pattern match attempts, and how many of them resulted in
+    /// a successful rewrite.
+    uint64_t numPatternAttempts = 0;
+    uint64_t numPatternSuccesses = 0;
+
+    OpStatistics &operator+=(const OpStatistics &rhs);
+  };
+
+  /// Return the statistics for the given operation name.
+  OpStatistics &operator[](OperationName name) { return opStats[name]; }
+
+  /// Merge the statistics of `rhs` into this object.
+  GreedyRewriteStatistics &operator+=(const GreedyRewriteStatistics &rhs);
+
+  /// Return the statistics accumulated over all operation names.
+  OpStatistics getTotal() const;
+
+  /// Print the statistics, per operation name, sorted by the number of pattern
+  /// attempts.
+  void print(raw_ostream &os) const;
+
+  /// The number of times the driver seeded its worklist with all of the
+  /// operations of the simplified regions.
+  uint64_t numFullTraversals = 0;
+
+private:
+  DenseMap<OperationName, OpStatistics> opStats;
+};
 
 /// This class allows control over how the GreedyPatternRewriteDriver works.
 class GreedyRewriteConfig {
@@ -37,6 +81,30 @@ public:
   /// to disable this iteration limit.
   int64_t maxIterations = 10;
 
+  /// When set to true, only the first iteration visits all of the operations.
+  /// Operations are afterwards only revisited if they were inserted or
+  /// modified, if one of the values they use or define was replaced, or if a
+  /// single use operand producer may be simplified. A new full traversal is
+  /// only performed when region simplification changed the IR, and each full
+  /// traversal counts towards `maxIterations`. This saves re-running every
+  /// pattern on unchanged IR just to confirm that a fixed point was reached,
+  /// but it may miss rewrites of patterns that match on IR other than the
+  /// immediate operands and users of an operation.
+  bool useChangeDrivenRevisits = false;
+
+  /// If non-null, statistics about the rewrite are accumulated into this
+  /// object.
+  GreedyRewriteStatistics *statistics = nullptr;
+
+  /// If non-null, the match attempts, successes and time of each pattern are
+  /// recorded into this profile.
+  PatternProfile *patternProfile = nullptr;
+
+  /// If non-null, patterns with the same benefit are attempted in order of
+  /// their success rate within this profile. This may be the same profile as
+  /// `patternProfile`, in which case the order adapts to previous runs.
+  const PatternProfile *patternOrderProfile = nullptr;
+
   static constexpr int64_t kNoIterationLimit = -1;
 };
 
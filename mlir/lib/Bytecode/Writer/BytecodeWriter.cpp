@@ -0,0 +1,468 @@
+//===- BytecodeWriter.cpp - MLIR Bytecode Writer --------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Bytecode/BytecodeWriter.h"
+#include "mlir/Bytecode/BytecodeImplementation.h"
+#include "mlir/Bytecode/Encoding.h"
+#include "mlir/IR/BuiltinDialect.h"
+#include "mlir/IR/Operation.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/LEB128.h"
+#include "llvm/Support/raw_ostream.h"
+#include <vector>
+
+using namespace mlir;
+
+//===----------------------------------------------------------------------===//
+// EncodingEmitter
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// This class functions as the underlying encoding emitter for the bytecode
+/// writer. This class is a bit different compared to other types of encoders;
+/// it does not use a single buffer, but instead may contain several buffers
+/// (per-section buffers) that get concatenated into the final output.
+class EncodingEmitter {
+public:
+  /// Write the current contents to the provided stream.
+  void writeTo(raw_ostream &os) const {
+    os.write(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+  }
+
+  /// Return the current size of the encoded buffer.
+  size_t size() const { return bytes.size(); }
+
+  /// Reset the emitter, dropping any encoded data.
+  void clear() { bytes.clear(); }
+
+  //===--------------------------------------------------------------------===//
+  // Emission
+  //===--------------------------------------------------------------------===//
+
+  /// Emit a single byte.
+  void emitByte(uint8_t byte) { bytes.push_back(byte); }
+
+  /// Emit a range of bytes.
+  void emitBytes(ArrayRef<uint8_t> data) {
+    bytes.append(data.begin(), data.end());
+  }
+
+  /// Emit the contents of another emitter.
+  void emitBytes(const EncodingEmitter &other) { emitBytes(other.bytes); }
+
+  /// Emit a variable length integer.
+  void emitVarInt(uint64_t value) {
+    uint8_t encoded[16];
+    unsigned size = llvm::encodeULEB128(value, encoded);
+    emitBytes({encoded, size});
+  }
+
+  /// Emit a signed variable length integer.
+  void emitSignedVarInt(int64_t value) {
+    uint8_t encoded[16];
+    unsigned size = llvm::encodeSLEB128(value, encoded);
+    emitBytes({encoded, size});
+  }
+
+  /// Emit a string prefixed by its length.
+  void emitString(StringRef str) {
+    emitVarInt(str.size());
+    emitBytes({reinterpret_cast<const uint8_t *>(str.data()), str.size()});
+  }
+
+  /// Emit a section with the given id and contents.
+  void emitSection(bytecode::Section::ID id, const EncodingEmitter &contents) {
+    emitByte(id);
+    emitVarInt(contents.size());
+    emitBytes(contents);
+  }
+
+private:
+  /// The encoded data.
+  SmallVector<uint8_t, 0> bytes;
+};
+
+//===----------------------------------------------------------------------===//
+// BytecodeWriter
+//===----------------------------------------------------------------------===//
+
+class BytecodeWriter {
+public:
+  BytecodeWriter(Operation *op) { numberValues(op); }
+
+  /// Write the bytecode for the given root operation.
+  void write(Operation *rootOp, raw_ostream &os, StringRef producer);
+
+  //===--------------------------------------------------------------------===//
+  // Numbering
+  //===--------------------------------------------------------------------===//
+
+  unsigned getStringID(StringRef str) {
+    auto it = stringIDs.try_emplace(str, strings.size());
+    if (it.second)
+      strings.push_back(it.first->getKey());
+    return it.first->second;
+  }
+
+  unsigned getDialectID(StringRef dialect) {
+    auto it = dialectIDs.try_emplace(dialect, dialects.size());
+    if (it.second)
+      dialects.push_back(getStringID(dialect));
+    return it.first->second;
+  }
+
+  unsigned getOpNameID(OperationName name) {
+    auto it = opNameIDs.try_emplace(name, opNames.size());
+    if (it.second)
+      opNames.push_back(name);
+    return it.first->second;
+  }
+
+  unsigned getAttrID(Attribute attr) {
+    assert(attr && "expected valid attribute");
+    auto it = attrIDs.try_emplace(attr, attrs.size());
+    if (it.second)
+      attrs.push_back(attr);
+    return it.first->second;
+  }
+
+  unsigned getTypeID(Type type) {
+    assert(type && "expected valid type");
+    auto it = typeIDs.try_emplace(type, types.size());
+    if (it.second)
+      types.push_back(type);
+    return it.first->second;
+  }
+
+private:
+  /// Assign value and block numbers to the IR nested under `op`, in the order
+  /// in which the reader will define them.
+  void numberValues(Operation *op);
+
+  //===--------------------------------------------------------------------===//
+  // Sections
+  //===--------------------------------------------------------------------===//
+
+  void writeOperation(EncodingEmitter &emitter, Operation *op);
+  void writeRegion(EncodingEmitter &emitter, Region &region);
+  void writeAttrTypeSections(EncodingEmitter &entryEmitter,
+                             EncodingEmitter &offsetEmitter);
+  void writeDialectSection(EncodingEmitter &emitter);
+  void writeStringSection(EncodingEmitter &emitter);
+
+  /// Encode a single attribute or type entry into `entryEmitter`, returning
+  /// true if the entry used the dialect's custom encoding.
+  template <typename T>
+  bool writeAttrTypeEntry(EncodingEmitter &entryEmitter, T entry);
+
+  /// Strings, in the order they are referenced.
+  llvm::StringMap<unsigned> stringIDs;
+  std::vector<StringRef> strings;
+
+  /// Dialect namespaces, referenced by string index.
+  llvm::StringMap<unsigned> dialectIDs;
+  std::vector<unsigned> dialects;
+
+  /// Operation names.
+  DenseMap<OperationName, unsigned> opNameIDs;
+  std::vector<OperationName> opNames;
+
+  /// Attributes and types. Encoding an entry may reference further entries,
+  /// which are appended to these lists.
+  DenseMap<Attribute, unsigned> attrIDs;
+  std::vector<Attribute> attrs;
+  DenseMap<Type, unsigned> typeIDs;
+  std::vector<Type> types;
+
+  /// Values and blocks of the IR being written.
+  DenseMap<Value, unsigned> valueIDs;
+  DenseMap<Block *, unsigned> blockIDs;
+  unsigned nextValueID = 0;
+};
+
+//===----------------------------------------------------------------------===//
+// DialectWriter
+//===----------------------------------------------------------------------===//
+
+/// The writer handed to BytecodeDialectInterface hooks.
+class DialectWriter : public DialectBytecodeWriter {
+public:
+  DialectWriter(BytecodeWriter &writer, EncodingEmitter &emitter)
+      : writer(writer), emitter(emitter) {}
+
+  void writeAttribute(Attribute attr) override {
+    emitter.emitVarInt(writer.getAttrID(attr));
+  }
+  void writeType(Type type) override {
+    emitter.emitVarInt(writer.getTypeID(type));
+  }
+
+  void writeVarInt(uint64_t value) override { emitter.emitVarInt(value); }
+  void writeSignedVarInt(int64_t value) override {
+    emitter.emitSignedVarInt(value);
+  }
+
+  void writeAPIntWithKnownWidth(const APInt &value) override {
+    unsigned bitWidth = value.getBitWidth();
+
+    // If the value is a single byte, just emit it directly without going
+    // through a varint.
+    if (bitWidth <= 8)
+      return emitter.emitByte(value.getLimitedValue());
+
+    // If the value fits within a single varint, emit it directly.
+    if (bitWidth <= 64)
+      return emitter.emitSignedVarInt(value.getSExtValue());
+
+    // Otherwise, we need to encode a variable number of active words. We use
+    // active words instead of the number of total words under the observation
+    // that smaller values will be more common.
+    unsigned numActiveWords = value.getActiveWords();
+    emitter.emitVarInt(numActiveWords);
+
+    const uint64_t *rawValueData = value.getRawData();
+    for (unsigned i = 0; i < numActiveWords; ++i)
+      emitter.emitVarInt(rawValueData[i]);
+  }
+
+  void writeAPFloatWithKnownSemantics(const APFloat &value) override {
+    writeAPIntWithKnownWidth(value.bitcastToAPInt());
+  }
+
+  void writeOwnedString(StringRef str) override {
+    emitter.emitVarInt(writer.getStringID(str));
+  }
+
+  void writeOwnedBlob(ArrayRef<char> blob) override {
+    emitter.emitVarInt(blob.size());
+    emitter.emitBytes(
+        {reinterpret_cast<const uint8_t *>(blob.data()), blob.size()});
+  }
+
+private:
+  BytecodeWriter &writer;
+  EncodingEmitter &emitter;
+};
+} // namespace
+
+void BytecodeWriter::numberValues(Operation *op) {
+  for (Value result : op->getResults())
+    valueIDs.try_emplace(result, nextValueID++);
+  for (Region &region : op->getRegions()) {
+    unsigned nextBlockID = 0;
+    for (Block &block : region) {
+      blockIDs.try_emplace(&block, nextBlockID++);
+      for (BlockArgument arg : block.getArguments())
+        valueIDs.try_emplace(arg, nextValueID++);
+      for (Operation &nestedOp : block)
+        numberValues(&nestedOp);
+    }
+  }
+}
+
+void BytecodeWriter::write(Operation *rootOp, raw_ostream &os,
+                           StringRef producer) {
+  // Encode the IR first, which collects the operation names, attributes and
+  // types that the other sections describe.
+  EncodingEmitter irEmitter;
+  irEmitter.emitVarInt(/*numOps=*/1);
+  writeOperation(irEmitter, rootOp);
+
+  // Encoding attributes and types may reference further strings, so the
+  // string section is emitted last.
+  EncodingEmitter attrTypeEmitter, offsetEmitter;
+  writeAttrTypeSections(attrTypeEmitter, offsetEmitter);
+  EncodingEmitter dialectEmitter;
+  writeDialectSection(dialectEmitter);
+  EncodingEmitter stringEmitter;
+  writeStringSection(stringEmitter);
+
+  EncodingEmitter emitter;
+  emitter.emitBytes({reinterpret_cast<const uint8_t *>(bytecode::kMagic),
+                     sizeof(bytecode::kMagic)});
+  emitter.emitVarInt(bytecode::kVersion);
+  emitter.emitString(producer);
+  emitter.emitSection(bytecode::Section::kString, stringEmitter);
+  emitter.emitSection(bytecode::Section::kDialect, dialectEmitter);
+  emitter.emitSection(bytecode::Section::kAttrType, attrTypeEmitter);
+  emitter.emitSection(bytecode::Section::kAttrTypeOffset, offsetEmitter);
+  emitter.emitSection(bytecode::Section::kIR, irEmitter);
+  emitter.writeTo(os);
+}
+
+//===----------------------------------------------------------------------===//
+// IR Section
+
+void BytecodeWriter::writeOperation(EncodingEmitter &emitter, Operation *op) {
+  using namespace bytecode;
+  emitter.emitVarInt(getOpNameID(op->getName()));
+
+  uint8_t opEncodingMask = 0;
+  DictionaryAttr attrDict = op->getAttrDictionary();
+  if (!attrDict.empty())
+    opEncodingMask |= OpEncodingMask::kHasAttrs;
+  if (op->getNumResults())
+    opEncodingMask |= OpEncodingMask::kHasResults;
+  if (op->getNumOperands())
+    opEncodingMask |= OpEncodingMask::kHasOperands;
+  if (op->getNumSuccessors())
+    opEncodingMask |= OpEncodingMask::kHasSuccessors;
+  if (op->getNumRegions())
+    opEncodingMask |= OpEncodingMask::kHasRegions;
+  emitter.emitByte(opEncodingMask);
+
+  emitter.emitVarInt(getAttrID(op->getLoc()));
+  if (opEncodingMask & OpEncodingMask::kHasAttrs)
+    emitter.emitVarInt(getAttrID(attrDict));
+
+  if (opEncodingMask & OpEncodingMask::kHasResults) {
+    emitter.emitVarInt(op->getNumResults());
+    for (Type type : op->getResultTypes())
+      emitter.emitVarInt(getTypeID(type));
+  }
+  if (opEncodingMask & OpEncodingMask::kHasOperands) {
+    emitter.emitVarInt(op->getNumOperands());
+    for (Value operand : op->getOperands())
+      emitter.emitVarInt(valueIDs.lookup(operand));
+  }
+  if (opEncodingMask & OpEncodingMask::kHasSuccessors) {
+    emitter.emitVarInt(op->getNumSuccessors());
+    for (Block *successor : op->getSuccessors())
+      emitter.emitVarInt(blockIDs.lookup(successor));
+  }
+  if (opEncodingMask & OpEncodingMask::kHasRegions) {
+    emitter.emitVarInt(op->getNumRegions());
+    for (Region &region : op->getRegions())
+      writeRegion(emitter, region);
+  }
+}
+
+void BytecodeWriter::writeRegion(EncodingEmitter &emitter, Region &region) {
+  emitter.emitVarInt(region.getBlocks().size());
+  for (Block &block : region) {
+    bool hasArgs = !block.args_empty();
+    emitter.emitVarInt((block.getOperations().size() << 1) | hasArgs);
+    if (hasArgs) {
+      emitter.emitVarInt(block.getNumArguments());
+      for (BlockArgument arg : block.getArguments()) {
+        emitter.emitVarInt(getTypeID(arg.getType()));
+        emitter.emitVarInt(getAttrID(arg.getLoc()));
+      }
+    }
+    for (Operation &op : block)
+      writeOperation(emitter, &op);
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Attribute and Type Sections
+
+/// Encode `attr` or `type` with the given dialect interface.
+static LogicalResult writeCustomEntry(const BytecodeDialectInterface &iface,
+                                      Attribute attr,
+                                      DialectBytecodeWriter &writer) {
+  return iface.writeAttribute(attr, writer);
+}
+static LogicalResult writeCustomEntry(const BytecodeDialectInterface &iface,
+                                      Type type,
+                                      DialectBytecodeWriter &writer) {
+  return iface.writeType(type, writer);
+}
+
+template <typename T>
+bool BytecodeWriter::writeAttrTypeEntry(EncodingEmitter &entryEmitter,
+                                        T entry) {
+  // Try the dialect's custom encoding first.
+  Dialect &dialect = entry.getDialect();
+  if (const auto *iface =
+          dialect.getRegisteredInterface<BytecodeDialectInterface>()) {
+    DialectWriter dialectWriter(*this, entryEmitter);
+    if (succeeded(writeCustomEntry(*iface, entry, dialectWriter)))
+      return true;
+    entryEmitter.clear();
+  }
+
+  // Otherwise, fall back to the textual assembly format.
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  entry.print(os);
+  os.flush();
+  entryEmitter.emitBytes(
+      {reinterpret_cast<const uint8_t *>(str.data()), str.size()});
+  return false;
+}
+
+void BytecodeWriter::writeAttrTypeSections(EncodingEmitter &entryEmitter,
+                                           EncodingEmitter &offsetEmitter) {
+  // Encoding an entry may number further attributes and types, so keep going
+  // until every numbered entry has been encoded. Attribute entries precede
+  // type entries in the final section, so encode them separately.
+  EncodingEmitter attrEntries, attrOffsets, typeEntries, typeOffsets;
+  auto writeEntry = [&](auto entry, EncodingEmitter &entries,
+                        EncodingEmitter &offsets) {
+    EncodingEmitter emitter;
+    bool hasCustomEncoding = writeAttrTypeEntry(emitter, entry);
+    offsets.emitVarInt(getDialectID(entry.getDialect().getNamespace()));
+    offsets.emitVarInt((uint64_t(emitter.size()) << 1) | hasCustomEncoding);
+    entries.emitBytes(emitter);
+  };
+
+  size_t numAttrsWritten = 0, numTypesWritten = 0;
+  while (numAttrsWritten != attrs.size() || numTypesWritten != types.size()) {
+    while (numAttrsWritten != attrs.size())
+      writeEntry(attrs[numAttrsWritten++], attrEntries, attrOffsets);
+    while (numTypesWritten != types.size())
+      writeEntry(types[numTypesWritten++], typeEntries, typeOffsets);
+  }
+
+  entryEmitter.emitBytes(attrEntries);
+  entryEmitter.emitBytes(typeEntries);
+
+  offsetEmitter.emitVarInt(attrs.size());
+  offsetEmitter.emitVarInt(types.size());
+  offsetEmitter.emitBytes(attrOffsets);
+  offsetEmitter.emitBytes(typeOffsets);
+}
+
+//===----------------------------------------------------------------------===//
+// Dialect and String Sections
+
+void BytecodeWriter::writeDialectSection(EncodingEmitter &emitter) {
+  // Number the dialects of the operation names first, so that the dialect list
+  // is complete before it is emitted.
+  std::vector<unsigned> opNameDialects;
+  opNameDialects.reserve(opNames.size());
+  for (OperationName name : opNames)
+    opNameDialects.push_back(getDialectID(name.getDialectNamespace()));
+
+  emitter.emitVarInt(dialects.size());
+  for (unsigned dialectStringID : dialects)
+    emitter.emitVarInt(dialectStringID);
+
+  emitter.emitVarInt(opNames.size());
+  for (size_t i = 0, e = opNames.size(); i != e; ++i) {
+    emitter.emitVarInt(opNameDialects[i]);
+    emitter.emitVarInt(getStringID(opNames[i].getStringRef()));
+  }
+}
+
+void BytecodeWriter::writeStringSection(EncodingEmitter &emitter) {
+  emitter.emitVarInt(strings.size());
+  for (StringRef str : strings)
+    emitter.emitString(str);
+}
+
+//===----------------------------------------------------------------------===//
+// Entry Points
+//===----------------------------------------------------------------------===//
+
+void mlir::writeBytecodeToFile(Operation *op, raw_ostream &os,
+                               StringRef producer) {
+  BytecodeWriter(op).write(op, os, producer);
+}
@@ -17,15 +17,19 @@
 
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
+#include <cstdlib>
+#include <deque>
 #include <functional>
 #include <iostream>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <vector>
 
 #include "llvm/ADT/StringMap.h"
-#include "llvm/Support/ThreadPool.h"
+#include "llvm/Support/Threading.h"
 
 using namespace mlir::runtime;
 
@@ -40,6 +44,194 @@ namespace {
 // Forward declare class defined below.
 class RefCounted;
 
+// -------------------------------------------------------------------------- //
+// WorkStealingScheduler runs async tasks on a fixed set of worker threads.
+//
+// Each worker owns a deque of tasks. Tasks spawned from a worker thread are
+// pushed to the back of its own deque and popped from the back (LIFO), which
+// keeps recursively dispatched work (e.g. `async-parallel-for` block
+// dispatch) hot in the cache and avoids contention on a global queue. Idle
+// workers steal from the front of other workers' deques, i.e. the oldest and
+// typically largest pieces of work. Tasks spawned from other threads are
+// distributed round robin over the worker deques.
+//
+// Workers go to sleep only when there are no queued tasks at all, so spawning
+// a task is a deque push plus an atomic increment in the common case where
+// all workers are busy.
+// -------------------------------------------------------------------------- //
+
+class WorkStealingScheduler {
+public:
+  using Task = std::function<void()>;
+
+  explicit WorkStealingScheduler(unsigned numThreads)
+      : numQueuedTasks(0), numPendingTasks(0), numSleepingWorkers(0),
+        nextWorker(0), stop(false) {
+    workers.reserve(numThreads);
+    for (unsigned i = 0; i < numThreads; ++i)
+      workers.push_back(std::make_unique<Worker>());
+    threads.reserve(numThreads);
+    for (unsigned i = 0; i < numThreads; ++i)
+      threads.emplace_back([this, i] { workerLoop(i); });
+  }
+
+  ~WorkStealingScheduler() {
+    wait();
+    {
+      std::unique_lock<std::mutex> lock(sleepMu);
+      stop = true;
+    }
+    sleepCv.notify_all();
+    for (std::thread &thread : threads)
+      thread.join();
+  }
+
+  // Schedules `task` for asynchronous execution.
+  void spawn(Task task) {
+    numPendingTasks.fetch_add(1);
+
+    Worker &worker = currentScheduler == this
+                         ? *workers[currentWorker]
+                         : *workers[nextWorker.fetch_add(1) % workers.size()];
+    {
+      std::unique_lock<std::mutex> lock(worker.mu);
+      worker.tasks.push_back(std::move(task));
+    }
+
+    // Wake up a sleeping worker. Sleeping workers increment the number of
+    // sleepers before checking the number of queued tasks, so at least one of
+    // the two threads observes the other's update.
+    numQueuedTasks.fetch_add(1);
+    if (numSleepingWorkers.load() > 0) {
+      std::unique_lock<std::mutex> lock(sleepMu);
+      sleepCv.notify_one();
+    }
+  }
+
+  // Runs one queued task on the calling worker thread. Returns false if there
+  // was no task to run. Used by workers that block on an async value, so that
+  // they make progress instead of holding up a thread.
+  bool runPendingTask() {
+    assert(isWorkerThread() && "must be called from a worker thread");
+    Task task;
+    if (!popOrSteal(currentWorker, task))
+      return false;
+    run(task);
+    return true;
+  }
+
+  // Returns true if the calling thread is one of this scheduler's workers.
+  bool isWorkerThread() const { return currentScheduler == this; }
+
+  // Blocks until all spawned tasks have completed.
+  void wait() {
+    std::unique_lock<std::mutex> lock(doneMu);
+    doneCv.wait(lock, [this] { return numPendingTasks.load() == 0; });
+  }
+
+private:
+  struct Worker {
+    std::mutex mu;
+    std::deque<Task> tasks;
+  };
+
+  void workerLoop(unsigned index) {
+    currentScheduler = this;
+    currentWorker = index;
+
+    Task task;
+    while (true) {
+      if (popOrSteal(index, task)) {
+        run(task);
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(sleepMu);
+      numSleepingWorkers.fetch_add(1);
+      sleepCv.wait(lock, [this] { return stop || numQueuedTasks.load() > 0; });
+      numSleepingWorkers.fetch_sub(1);
+      if (stop)
+        return;
+    }
+  }
+
+  // Pops a task from the back of the worker's own deque, or steals one from
+  // the front of another worker's deque.
+  bool popOrSteal(unsigned index, Task &task) {
+    if (numQueuedTasks.load(std::memory_order_relaxed) == 0)
+      return false;
+
+    auto take = [&](Worker &worker, bool back) {
+      std::unique_lock<std::mutex> lock(worker.mu);
+      if (worker.tasks.empty())
+        return false;
+      if (back) {
+        task = std::move(worker.tasks.back());
+        worker.tasks.pop_back();
+      } else {
+        task = std::move(worker.tasks.front());
+        worker.tasks.pop_front();
+      }
+      numQueuedTasks.fetch_sub(1);
+      return true;
+    };
+
+    if (take(*workers[index], /*back=*/true))
+      return true;
+    for (size_t i = 1, e = workers.size(); i < e; ++i)
+      if (take(*workers[(index + i) % e], /*back=*/false))
+        return true;
+    return false;
+  }
+
+  void run(Task &task) {
+    task();
+    task = nullptr;
+
+    if (numPendingTasks.fetch_sub(1) == 1) {
+      std::unique_lock<std::mutex> lock(doneMu);
+      doneCv.notify_all();
+    }
+  }
+
+  std::vector<std::unique_ptr<Worker>> workers;
+  std::vector<std::thread> threads;
+
+  // The number of tasks sitting in the worker deques.
+  std::atomic<int64_t> numQueuedTasks;
+  // The number of tasks spawned but not yet completed.
+  std::atomic<int64_t> numPendingTasks;
+  std::atomic<int> numSleepingWorkers;
+  // The worker deque that receives the next task spawned by a non-worker.
+  std::atomic<unsigned> nextWorker;
+
+  std::mutex sleepMu;
+  std::condition_variable sleepCv;
+  bool stop;
+
+  std::mutex doneMu;
+  std::condition_variable doneCv;
+
+  // The scheduler and worker index of the current thread, if it is a worker.
+  static thread_local WorkStealingScheduler *currentScheduler;
+  static thread_local unsigned currentWorker;
+};
+
+thread_local WorkStealingScheduler *WorkStealingScheduler::currentScheduler =
+    nullptr;
+thread_local unsigned WorkStealingScheduler::currentWorker = 0;
+
+// Returns the number of worker threads of the async runtime. It can be
+// overridden with the `MLIR_ASYNC_RUNTIME_NUM_THREADS` environment variable.
+static unsigned getNumWorkerThreads() {
+  if (const char *env = std::getenv("MLIR_ASYNC_RUNTIME_NUM_THREADS")) {
+    int numThreads = std::atoi(env);
+    if (numThreads > 0)
+      return numThreads;
+  }
+  return llvm::hardware_concurrency().compute_thread_count();
+}
+
 // -------------------------------------------------------------------------- //
 // AsyncRuntime orchestrates all async operations and Async runtime API is built
 // on top of the default runtime instance.
@@ -47,10 +239,11 @@ class RefCounted;
 
 class AsyncRuntime {
 public:
-  AsyncRuntime() : numRefCountedObjects(0) {}
+  AsyncRuntime()
+      : numRefCountedObjects(0), scheduler(getNumWorkerThreads()) {}
 
   ~AsyncRuntime() {
-    threadPool.wait(); // wait for the completion of all async tasks
+    scheduler.wait(); // wait for the completion of all async tasks
     assert(getNumRefCountedObjects() == 0 &&
            "all ref counted objects must be destroyed");
   }
@@ -59,7 +252,7 @@ public:
     return numRefCountedObjects.load(std::memory_order_relaxed);
   }
 
-  llvm::ThreadPool &getThreadPool() { return threadPool; }
+  WorkStealingScheduler &getScheduler() { return scheduler; }
 
 private:
   friend class RefCounted;
@@ -74,7 +267,7 @@ private:
   }
 
   std::atomic<int64_t> numRefCountedObjects;
-  llvm::ThreadPool threadPool;
+  WorkStealingScheduler scheduler;
 };
 
 // -------------------------------------------------------------------------- //
@@ -214,6 +407,8 @@ struct AsyncGroup : public RefCounted {
   AsyncGroup(AsyncRuntime *runtime, int64_t size)
       : RefCounted(runtime), pendingTokens(size), numErrors(0), rank(0) {}
 
+  // Pending tokens and errors are updated without holding the mutex, only the
+  // last token to become ready takes it to run the awaiters.
   std::atomic<int> pendingTokens;
   std::atomic<int> numErrors;
   std::atomic<int> rank;
@@ -254,10 +449,45 @@ extern "C" AsyncGroup *mlirAsyncRuntimeCreateGroup(int64_t size) {
   return group;
 }
 
+// Runs the awaiters of a value that became ready. The first awaiter is run
+// inline on the current thread, and the remaining ones are spawned, so that a
+// value awaited by multiple coroutines resumes them in parallel.
+static void runAwaiters(std::vector<std::function<void()>> &awaiters) {
+  if (awaiters.empty())
+    return;
+  auto &scheduler = getDefaultAsyncRuntime()->getScheduler();
+  for (size_t i = 1, e = awaiters.size(); i < e; ++i)
+    scheduler.spawn(std::move(awaiters[i]));
+  awaiters.front()();
+}
+
+// Blocks until `isReady` returns true. Worker threads keep running queued
+// tasks while waiting, otherwise blocking awaits inside async tasks could
+// starve the runtime of threads.
+template <typename IsReady>
+static void waitUntilReady(std::mutex &mu, std::condition_variable &cv,
+                           IsReady isReady) {
+  if (isReady())
+    return;
+
+  auto &scheduler = getDefaultAsyncRuntime()->getScheduler();
+  if (!scheduler.isWorkerThread()) {
+    std::unique_lock<std::mutex> lock(mu);
+    cv.wait(lock, isReady);
+    return;
+  }
+
+  while (!isReady()) {
+    if (scheduler.runPendingTask())
+      continue;
+    std::unique_lock<std::mutex> lock(mu);
+    cv.wait_for(lock, std::chrono::microseconds(100), isReady);
+  }
+}
+
 extern "C" int64_t mlirAsyncRuntimeAddTokenToGroup(AsyncToken *token,
                                                    AsyncGroup *group) {
   std::unique_lock<std::mutex> lockToken(token->mu);
-  std::unique_lock<std::mutex> lockGroup(group->mu);
 
   // Get the rank of the token inside the group before we drop the reference.
   int rank = group->rank.fetch_add(1);
@@ -273,28 +503,29 @@ extern "C" int64_t mlirAsyncRuntimeAddTokenToGroup(AsyncToken *token,
 
     // Run all group awaiters if it was the last token in the group.
     if (group->pendingTokens.fetch_sub(1) == 1) {
-      group->cv.notify_all();
-      for (auto &awaiter : group->awaiters)
-        awaiter();
+      std::vector<std::function<void()>> awaiters;
+      {
+        std::unique_lock<std::mutex> lockGroup(group->mu);
+        awaiters.swap(group->awaiters);
+        group->cv.notify_all();
+      }
+      runAwaiters(awaiters);
     }
   };
 
   if (State(token->state).isAvailableOrError()) {
     // Update group pending tokens immediately and maybe run awaiters.
+    lockToken.unlock();
     onTokenReady();
 
   } else {
     // Update group pending tokens when token will become ready. Because this
     // will happen asynchronously we must ensure that `group` is alive until
-    // then, and re-ackquire the lock.
+    // then.
     group->addRef();
 
     token->awaiters.emplace_back([group, onTokenReady]() {
-      // Make sure that `dropRef` does not destroy the mutex owned by the lock.
-      {
-        std::unique_lock<std::mutex> lockGroup(group->mu);
-        onTokenReady();
-      }
+      onTokenReady();
       group->dropRef();
     });
   }
@@ -308,14 +539,16 @@ static void setTokenState(AsyncToken *token, State state) {
   assert(state.isAvailableOrError() && "must be terminal state");
   assert(State(token->state).isUnavailable() && "token must be unavailable");
 
-  // Make sure that `dropRef` does not destroy the mutex owned by the lock.
+  // Awaiters run after releasing the lock, so that they can await or add
+  // this token to a group without deadlocking.
+  std::vector<std::function<void()>> awaiters;
   {
     std::unique_lock<std::mutex> lock(token->mu);
     token->state = state;
+    awaiters.swap(token->awaiters);
     token->cv.notify_all();
-    for (auto &awaiter : token->awaiters)
-      awaiter();
   }
+  runAwaiters(awaiters);
 
   // Async tokens created with a ref count `2` to keep token alive until the
   // async task completes. Drop this reference explicitly when token emplaced.
@@ -326,14 +559,16 @@ static void setValueState(AsyncValue *value, State state) {
   assert(state.isAvailableOrError() && "must be terminal state");
   assert(State(value->state).isUnavailable() && "value must be unavailable");
 
-  // Make sure that `dropRef` does not destroy the mutex owned by the lock.
+  // Awaiters run after releasing the lock, so that they can await or add
+  // this value to a group without deadlocking.
+  std::vector<std::function<void()>> awaiters;
   {
     std::unique_lock<std::mutex> lock(value->mu);
     value->state = state;
+    awaiters.swap(value->awaiters);
     value->cv.notify_all();
-    for (auto &awaiter : value->awaiters)
-      awaiter();
   }
+  runAwaiters(awaiters);
 
   // Async values created with a ref count `2` to keep value alive until the
   // async task completes. Drop this reference explicitly when value emplaced.
@@ -369,23 +604,20 @@ extern "C" bool mlirAsyncRuntimeIsGroupError(AsyncGroup *group) {
 }
 
 extern "C" void mlirAsyncRuntimeAwaitToken(AsyncToken *token) {
-  std::unique_lock<std::mutex> lock(token->mu);
-  if (!State(token->state).isAvailableOrError())
-    token->cv.wait(
-        lock, [token] { return State(token->state).isAvailableOrError(); });
+  waitUntilReady(token->mu, token->cv, [token] {
+    return State(token->state).isAvailableOrError();
+  });
 }
 
 extern "C" void mlirAsyncRuntimeAwaitValue(AsyncValue *value) {
-  std::unique_lock<std::mutex> lock(value->mu);
-  if (!State(value->state).isAvailableOrError())
-    value->cv.wait(
-        lock, [value] { return State(value->state).isAvailableOrError(); });
+  waitUntilReady(value->mu, value->cv, [value] {
+    return State(value->state).isAvailableOrError();
+  });
 }
 
 extern "C" void mlirAsyncRuntimeAwaitAllInGroup(AsyncGroup *group) {
-  std::unique_lock<std::mutex> lock(group->mu);
-  if (group->pendingTokens != 0)
-    group->cv.wait(lock, [group] { return group->pendingTokens == 0; });
+  waitUntilReady(group->mu, group->cv,
+                 [group] { return group->pendingTokens == 0; });
 }
 
 // Returns a pointer to the storage owned by the async value.
@@ -396,13 +628,18 @@ extern "C" ValueStorage mlirAsyncRuntimeGetValueStorage(AsyncValue *value) {
 
 extern "C" void mlirAsyncRuntimeExecute(CoroHandle handle, CoroResume resume) {
   auto *runtime = getDefaultAsyncRuntime();
-  runtime->getThreadPool().async([handle, resume]() { (*resume)(handle); });
+  runtime->getScheduler().spawn([handle, resume]() { (*resume)(handle); });
 }
 
 extern "C" void mlirAsyncRuntimeAwaitTokenAndExecute(AsyncToken *token,
                                                      CoroHandle handle,
                                                      CoroResume resume) {
   auto execute = [handle, resume]() { (*resume)(handle); };
+
+  // Fast path: the token is already available, resume without locking.
+  if (State(token->state).isAvailableOrError())
+    return execute();
+
   std::unique_lock<std::mutex> lock(token->mu);
   if (State(token->state).isAvailableOrError()) {
     lock.unlock();
@@ -416,6 +653,11 @@ extern "C" void mlirAsyncRuntimeAwaitValueAndExecute(AsyncValue *value,
                                                      CoroHandle handle,
                                                      CoroResume resume) {
   auto execute = [handle, resume]() { (*resume)(handle); };
+
+  // Fast path: the value is already available, resume without locking.
+  if (State(value->state).isAvailableOrError())
+    return execute();
+
   std::unique_lock<std::mutex> lock(value->mu);
   if (State(value->state).isAvailableOrError()) {
     lock.unlock();
@@ -429,6 +671,11 @@ extern "C" void mlirAsyncRuntimeAwaitAllInGroupAndExecute(AsyncGroup *group,
                                                           CoroHandle handle,
                                                           CoroResume resume) {
   auto execute = [handle, resume]() { (*resume)(handle); };
+
+  // Fast path: all tokens are already available, resume without locking.
+  if (group->pendingTokens == 0)
+    return execute();
+
   std::unique_lock<std::mutex> lock(group->mu);
   if (group->pendingTokens == 0) {
     lock.unlock();
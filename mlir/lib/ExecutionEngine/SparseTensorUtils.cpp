@@ -26,7 +26,9 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <memory>
 #include <numeric>
+#include <thread>
 #include <vector>
 
 //===----------------------------------------------------------------------===//
@@ -63,12 +65,54 @@
 // In both cases (I) and (II), the SparseTensorStorage format is externally
 // only visible as an opaque pointer.
 //
+// Reading external formats, sorting the coordinate scheme, and constructing
+// the storage scheme from it are multithreaded for large tensors. The number
+// of threads defaults to the hardware concurrency, and can be set with the
+// MLIR_SPARSE_NUM_THREADS environment variable.
+//
 //===----------------------------------------------------------------------===//
 
 namespace {
 
 static constexpr int kColWidth = 1025;
 
+/// The minimum number of elements (or lines) processed by each thread.
+static constexpr uint64_t kMinWorkPerThread = 1 << 16;
+
+/// Returns the maximum number of threads used by the runtime kernels.
+static unsigned getMaxNumThreads() {
+  static const unsigned maxNumThreads = [] {
+    if (const char *env = getenv("MLIR_SPARSE_NUM_THREADS")) {
+      unsigned long numThreads = strtoul(env, nullptr, 10);
+      if (numThreads)
+        return static_cast<unsigned>(numThreads);
+    }
+    unsigned numThreads = std::thread::hardware_concurrency();
+    return numThreads ? numThreads : 1u;
+  }();
+  return maxNumThreads;
+}
+
+/// Returns the number of threads to use for the given amount of work.
+static unsigned getNumThreads(uint64_t work) {
+  uint64_t numThreads = std::min<uint64_t>(getMaxNumThreads(),
+                                           work / kMinWorkPerThread);
+  return numThreads ? static_cast<unsigned>(numThreads) : 1u;
+}
+
+/// Invokes `fn(t)` for each `t` in [0, n), each on its own thread. The calling
+/// thread processes `t == 0`.
+template <typename FnT>
+static void parallelFor(unsigned n, FnT fn) {
+  std::vector<std::thread> threads;
+  threads.reserve(n - 1);
+  for (unsigned t = 1; t < n; t++)
+    threads.emplace_back(fn, t);
+  fn(0);
+  for (std::thread &thread : threads)
+    thread.join();
+}
+
 /// A sparse tensor element in coordinate scheme (value and indices).
 /// For example, a rank-1 vector element would look like
 ///   ({i}, a[i])
@@ -103,12 +147,73 @@ public:
       assert(ind[r] < sizes[r]); // within bounds
     elements.emplace_back(ind, val);
   }
-  /// Sorts elements lexicographically by index.
+  /// Adds all of the given elements.
+  void append(std::vector<Element<V>> &&newElements) {
+    assert(!iteratorLocked && "Attempt to append() after startIterator()");
+#ifndef NDEBUG
+    for (const Element<V> &e : newElements) {
+      assert(e.indices.size() == getRank());
+      for (uint64_t r = 0, rank = getRank(); r < rank; r++)
+        assert(e.indices[r] < sizes[r]); // within bounds
+    }
+#endif
+    if (elements.empty() && elements.capacity() <= newElements.size()) {
+      elements = std::move(newElements);
+      return;
+    }
+    elements.insert(elements.end(),
+                    std::make_move_iterator(newElements.begin()),
+                    std::make_move_iterator(newElements.end()));
+  }
+  /// Sorts elements lexicographically by index. Large tensors are sorted by
+  /// sorting chunks of the elements in parallel, and then merging pairs of
+  /// sorted chunks in parallel until a single one remains.
   void sort() {
     assert(!iteratorLocked && "Attempt to sort() after startIterator()");
     // TODO: we may want to cache an `isSorted` bit, to avoid
     // unnecessary/redundant sorting.
-    std::sort(elements.begin(), elements.end(), lexOrder);
+    uint64_t nnz = elements.size();
+    unsigned numChunks = getNumThreads(nnz);
+    if (numChunks == 1) {
+      std::sort(elements.begin(), elements.end(), lexOrder);
+      return;
+    }
+    std::vector<uint64_t> bounds(numChunks + 1);
+    for (unsigned t = 0; t <= numChunks; t++)
+      bounds[t] = nnz * t / numChunks;
+    auto begin = elements.begin();
+    parallelFor(numChunks, [&](unsigned t) {
+      std::sort(begin + bounds[t], begin + bounds[t + 1], lexOrder);
+    });
+    for (unsigned width = 1; width < numChunks; width *= 2) {
+      unsigned numMerges = (numChunks + 2 * width - 1) / (2 * width);
+      parallelFor(numMerges, [&](unsigned m) {
+        unsigned lo = 2 * m * width;
+        unsigned mid = std::min(lo + width, numChunks);
+        unsigned hi = std::min(lo + 2 * width, numChunks);
+        if (mid < hi)
+          std::inplace_merge(begin + bounds[lo], begin + bounds[mid],
+                             begin + bounds[hi], lexOrder);
+      });
+    }
+  }
+  /// Combines elements with the same indices into a single element, whose
+  /// value is the sum of their values. Precondition: the elements must be
+  /// lexicographically sorted.
+  void deduplicate() {
+    assert(!iteratorLocked && "Attempt to deduplicate() after startIterator()");
+    if (elements.empty())
+      return;
+    uint64_t last = 0;
+    for (uint64_t i = 1, nnz = elements.size(); i < nnz; i++) {
+      if (elements[i].indices == elements[last].indices) {
+        elements[last].value += elements[i].value;
+        continue;
+      }
+      if (++last != i)
+        elements[last] = std::move(elements[i]);
+    }
+    elements.erase(elements.begin() + last + 1, elements.end());
   }
   /// Returns rank.
   uint64_t getRank() const { return sizes.size(); }
@@ -273,10 +378,11 @@ public:
     if (tensor) {
       // Lexicographically sort the tensor, to ensure precondition of `fromCOO`.
       tensor->sort();
+      tensor->deduplicate();
       const std::vector<Element<V>> &elements = tensor->getElements();
       uint64_t nnz = elements.size();
       values.reserve(nnz);
-      fromCOO(elements, 0, nnz, 0);
+      fromCOOParallel(elements);
     } else if (allDense) {
       values.resize(sz, 0);
     }
@@ -403,6 +509,81 @@ public:
   }
 
 private:
+  /// Tag type for the constructor of partial storage schemes.
+  struct PartialTag {};
+
+  /// Constructs an empty sparse tensor storage scheme with the same
+  /// dimensions and per-dimension dense/sparse annotations as `other`, which
+  /// is used to construct a part of `other` on a separate thread.
+  SparseTensorStorage(const SparseTensorStorage &other, PartialTag)
+      : sizes(other.sizes), rev(other.rev), idx(getRank()),
+        pointers(getRank()), indices(getRank()) {
+    for (uint64_t r = 0, rank = getRank(); r < rank; r++)
+      if (other.isCompressedDim(r))
+        pointers[r].push_back(0);
+  }
+
+  /// Initializes sparse tensor storage scheme from a memory-resident sparse
+  /// tensor in coordinate scheme, like `fromCOO`. For large tensors, the
+  /// elements are split at boundaries of the outermost dimension, each part
+  /// is constructed on a separate thread, and the parts are concatenated.
+  /// Precondition: the `elements` must be lexicographically sorted.
+  void fromCOOParallel(const std::vector<Element<V>> &elements) {
+    uint64_t nnz = elements.size();
+    unsigned numParts = getNumThreads(nnz);
+    if (numParts == 1) {
+      fromCOO(elements, 0, nnz, 0);
+      return;
+    }
+    // Split the elements into parts, each covering a range of indices in the
+    // outermost dimension.
+    std::vector<uint64_t> bounds(numParts + 1, nnz);
+    std::vector<uint64_t> indexBounds(numParts + 1, sizes[0]);
+    bounds[0] = indexBounds[0] = 0;
+    for (unsigned t = 1; t < numParts; t++) {
+      uint64_t b = std::max(nnz * t / numParts, bounds[t - 1]);
+      while (b > 0 && b < nnz &&
+             elements[b].indices[0] == elements[b - 1].indices[0])
+        b++;
+      bounds[t] = b;
+      indexBounds[t] = b < nnz ? elements[b].indices[0] : sizes[0];
+    }
+    std::vector<std::unique_ptr<SparseTensorStorage>> parts(numParts);
+    parallelFor(numParts, [&](unsigned t) {
+      parts[t].reset(new SparseTensorStorage(*this, PartialTag()));
+      uint64_t full = parts[t]->fromCOOSegments(elements, bounds[t],
+                                                bounds[t + 1], 0,
+                                                indexBounds[t]);
+      // The pointer structure of the outermost dimension is finalized after
+      // concatenation, but a dense dimension must be filled in up to the start
+      // of the next part.
+      if (!isCompressedDim(0))
+        for (; full < indexBounds[t + 1]; full++)
+          parts[t]->endDim(1);
+    });
+    for (const std::unique_ptr<SparseTensorStorage> &part : parts)
+      append(*part);
+    if (isCompressedDim(0))
+      pointers[0].push_back(indices[0].size());
+  }
+
+  /// Appends the contents of a partial storage scheme, constructed for the
+  /// outermost indices that follow those already in this storage scheme.
+  void append(const SparseTensorStorage &part) {
+    for (uint64_t d = 0, rank = getRank(); d < rank; d++) {
+      if (!isCompressedDim(d))
+        continue;
+      // Skip the leading zero of the part's pointers, and offset the others
+      // by the indices that precede those of the part.
+      uint64_t offset = indices[d].size();
+      for (uint64_t k = 1, e = part.pointers[d].size(); k < e; k++)
+        pointers[d].push_back(part.pointers[d][k] + offset);
+      indices[d].insert(indices[d].end(), part.indices[d].begin(),
+                        part.indices[d].end());
+    }
+    values.insert(values.end(), part.values.begin(), part.values.end());
+  }
+
   /// Initializes sparse tensor storage scheme from a memory-resident sparse
   /// tensor in coordinate scheme. This method prepares the pointers and
   /// indices arrays under the given per-dimension dense/sparse annotations.
@@ -417,7 +598,25 @@ private:
       return;
     }
     // Visit all elements in this interval.
-    uint64_t full = 0;
+    uint64_t full = fromCOOSegments(elements, lo, hi, d, /*full=*/0);
+    // Finalize the sparse pointer structure at this dimension.
+    if (isCompressedDim(d)) {
+      pointers[d].push_back(indices[d].size());
+    } else {
+      // For dense storage we must fill in all the zero values after
+      // the last element.
+      for (uint64_t sz = sizes[d]; full < sz; full++)
+        endDim(d + 1);
+    }
+  }
+
+  /// Visits the segments of elements with the same index in dimension `d`
+  /// within [lo, hi), for `fromCOO`. For a dense dimension, the zero values
+  /// are filled in starting at index `full`. Returns the index following the
+  /// last filled in index.
+  uint64_t fromCOOSegments(const std::vector<Element<V>> &elements,
+                           uint64_t lo, uint64_t hi, uint64_t d,
+                           uint64_t full) {
     while (lo < hi) { // If `hi` is unchanged, then `lo < elements.size()`.
       // Find segment in interval with same index elements in this dimension.
       uint64_t i = elements[lo].indices[d];
@@ -439,15 +638,7 @@ private:
       // And move on to next segment in interval.
       lo = seg;
     }
-    // Finalize the sparse pointer structure at this dimension.
-    if (isCompressedDim(d)) {
-      pointers[d].push_back(indices[d].size());
-    } else {
-      // For dense storage we must fill in all the zero values after
-      // the last element.
-      for (uint64_t sz = sizes[d]; full < sz; full++)
-        endDim(d + 1);
-    }
+    return full;
   }
 
   /// Stores the sparse tensor storage scheme into a memory-resident sparse
@@ -624,6 +815,91 @@ static void readExtFROSTTHeader(FILE *file, char *filename, char *line,
   fgets(line, kColWidth, file); // end of line
 }
 
+/// Parses the nonzero element on the given line, and adds it to `elements`
+/// (twice for off-diagonal elements of symmetric matrices).
+template <typename V>
+static void parseElement(char *linePtr, uint64_t rank, const uint64_t *perm,
+                         bool isSymmetric, std::vector<uint64_t> &indices,
+                         std::vector<Element<V>> &elements) {
+  for (uint64_t r = 0; r < rank; r++) {
+    uint64_t idx = strtoul(linePtr, &linePtr, 10);
+    // Add 0-based index.
+    indices[perm[r]] = idx - 1;
+  }
+  // The external formats always store the numerical values with the type
+  // double, but we cast these values to the sparse tensor object type.
+  double value = strtod(linePtr, &linePtr);
+  elements.emplace_back(indices, value);
+  // We currently chose to deal with symmetric matrices by fully constructing
+  // them. In the future, we may want to make symmetry implicit for storage
+  // reasons.
+  if (isSymmetric && indices[0] != indices[1])
+    elements.emplace_back(std::vector<uint64_t>{indices[1], indices[0]},
+                          value);
+}
+
+/// Reads the `nnz` nonzero elements that remain in the given file in parallel
+/// into `tensor`. The remainder of the file is read into memory, and split at
+/// line boundaries into chunks that are parsed on separate threads.
+template <typename V>
+static void readElementsParallel(FILE *file, char *filename, uint64_t rank,
+                                 const uint64_t *perm, bool isSymmetric,
+                                 uint64_t nnz, unsigned numChunks,
+                                 SparseTensorCOO<V> *tensor) {
+  long start = ftell(file);
+  if (start < 0 || fseek(file, 0, SEEK_END) != 0) {
+    fprintf(stderr, "Cannot read data in %s\n", filename);
+    exit(1);
+  }
+  long end = ftell(file);
+  fseek(file, start, SEEK_SET);
+  std::vector<char> buffer(end - start + 1);
+  size_t size = fread(buffer.data(), 1, end - start, file);
+  buffer[size] = '\0';
+  char *data = buffer.data();
+
+  // Split the data into chunks of whole lines, and count the lines of each
+  // chunk, so that exactly `nnz` lines are parsed overall.
+  std::vector<char *> bounds(numChunks + 1, data + size);
+  bounds[0] = data;
+  for (unsigned t = 1; t < numChunks; t++) {
+    char *b = std::max(data + size * t / numChunks, bounds[t - 1]);
+    while (b > data && b < data + size && b[-1] != '\n')
+      b++;
+    bounds[t] = b;
+  }
+  std::vector<uint64_t> numLines(numChunks + 1, 0);
+  parallelFor(numChunks, [&](unsigned t) {
+    char *b = bounds[t], *e = bounds[t + 1];
+    numLines[t + 1] = std::count(b, e, '\n') + (e > b && e[-1] != '\n');
+  });
+  for (unsigned t = 0; t < numChunks; t++)
+    numLines[t + 1] += numLines[t];
+  if (numLines[numChunks] < nnz) {
+    fprintf(stderr, "Cannot find next line of data in %s\n", filename);
+    exit(1);
+  }
+
+  std::vector<std::vector<Element<V>>> chunkElements(numChunks);
+  parallelFor(numChunks, [&](unsigned t) {
+    uint64_t lo = std::min(numLines[t], nnz);
+    uint64_t hi = std::min(numLines[t + 1], nnz);
+    std::vector<uint64_t> indices(rank);
+    std::vector<Element<V>> &elements = chunkElements[t];
+    elements.reserve(hi - lo);
+    char *linePtr = bounds[t];
+    for (uint64_t k = lo; k < hi; k++) {
+      parseElement(linePtr, rank, perm, isSymmetric, indices, elements);
+      linePtr = strchr(linePtr, '\n');
+      if (!linePtr)
+        break;
+      linePtr++;
+    }
+  });
+  for (std::vector<Element<V>> &elements : chunkElements)
+    tensor->append(std::move(elements));
+}
+
 /// Reads a sparse tensor with the given filename into a memory-resident
 /// sparse tensor in coordinate scheme.
 template <typename V>
@@ -657,28 +933,25 @@ static SparseTensorCOO<V> *openSparseTensorCOO(char *filename, uint64_t rank,
            "dimension size mismatch");
   SparseTensorCOO<V> *tensor =
       SparseTensorCOO<V>::newSparseTensorCOO(rank, idata + 2, perm, nnz);
-  //  Read all nonzero elements.
+  //  Read all nonzero elements, in parallel for large tensors.
+  unsigned numThreads = getNumThreads(nnz);
+  if (numThreads > 1) {
+    readElementsParallel(file, filename, rank, perm, isSymmetric, nnz,
+                         numThreads, tensor);
+    fclose(file);
+    return tensor;
+  }
   std::vector<uint64_t> indices(rank);
+  std::vector<Element<V>> elements;
   for (uint64_t k = 0; k < nnz; k++) {
     if (!fgets(line, kColWidth, file)) {
       fprintf(stderr, "Cannot find next line of data in %s\n", filename);
       exit(1);
     }
-    char *linePtr = line;
-    for (uint64_t r = 0; r < rank; r++) {
-      uint64_t idx = strtoul(linePtr, &linePtr, 10);
-      // Add 0-based index.
-      indices[perm[r]] = idx - 1;
-    }
-    // The external formats always store the numerical values with the type
-    // double, but we cast these values to the sparse tensor object type.
-    double value = strtod(linePtr, &linePtr);
-    tensor->add(indices, value);
-    // We currently chose to deal with symmetric matrices by fully constructing
-    // them. In the future, we may want to make symmetry implicit for storage
-    // reasons.
-    if (isSymmetric && indices[0] != indices[1])
-      tensor->add({indices[1], indices[0]}, value);
+    elements.clear();
+    parseElement(line, rank, perm, isSymmetric, indices, elements);
+    for (const Element<V> &e : elements)
+      tensor->add(e.indices, e.value);
   }
   // Close the file and return tensor.
   fclose(file);
@@ -1717,6 +1717,12 @@ void AsmPrinter::Impl::printAttribute(Attribute attr,
          << llvm::toHex(opaqueAttr.getValue()) << "\">";
     }
 
+  } else if (auto resourceAttr = attr.dyn_cast<DenseResourceElementsAttr>()) {
+    // The data of the resource is not printed, only its handle.
+    os << "dense_resource<";
+    ::printKeywordOrString(resourceAttr.getRawHandle().getKey(), os);
+    os << '>';
+
   } else if (auto intOrFpEltAttr = attr.dyn_cast<DenseIntOrFPElementsAttr>()) {
     if (printerFlags.shouldElideElementsAttr(intOrFpEltAttr)) {
       printElidedElementsAttr(os);
@@ -36,7 +36,8 @@ using namespace mlir::detail;
 
 void BuiltinDialect::registerAttributes() {
   addAttributes<AffineMapAttr, ArrayAttr, DenseIntOrFPElementsAttr,
-                DenseStringElementsAttr, DictionaryAttr, FloatAttr,
+                DenseResourceElementsAttr, DenseStringElementsAttr,
+                DictionaryAttr, FloatAttr,
                 SymbolRefAttr, IntegerAttr, IntegerSetAttr, OpaqueAttr,
                 OpaqueElementsAttr, SparseElementsAttr, StringAttr, TypeAttr,
                 UnitAttr>();
@@ -1228,6 +1229,53 @@ bool DenseIntElementsAttr::classof(Attribute attr) {
          attr.getType().cast<ShapedType>().getElementType().isIntOrIndex();
 }
 
+//===----------------------------------------------------------------------===//
+// DenseResourceElementsAttr
+//===----------------------------------------------------------------------===//
+
+DialectResourceBlobManager &
+DenseResourceElementsHandle::getManager(MLIRContext *context) {
+  auto *dialect = context->getLoadedDialect<BuiltinDialect>();
+  return dialect->getRegisteredInterface<ResourceBlobManagerDialectInterface>()
+      ->getBlobManager();
+}
+
+DenseResourceElementsAttr DenseResourceElementsAttr::get(ShapedType type,
+                                                         StringRef blobName,
+                                                         AsmResourceBlob blob) {
+  DialectResourceBlobManager &manager =
+      DenseResourceElementsHandle::getManager(type.getContext());
+  return get(type, &manager.insert(blobName, std::move(blob)));
+}
+
+LogicalResult
+DenseResourceElementsAttr::verify(function_ref<InFlightDiagnostic()> emitError,
+                                  ShapedType type,
+                                  DenseResourceElementsHandle handle) {
+  if (!type.hasStaticShape())
+    return emitError() << "expected a statically shaped type, but got "
+                       << type;
+  Type eltType = type.getElementType();
+  if (!eltType.isIntOrFloat() || eltType.getIntOrFloatBitWidth() % 8 != 0)
+    return emitError() << "expected an integer or floating point element "
+                          "type with a byte-multiple bit width, but got "
+                       << eltType;
+  if (!handle.getEntry())
+    return emitError() << "expected a valid resource handle";
+
+  // The data may be provided after the attribute is created, so only check
+  // its size when it is available.
+  if (AsmResourceBlob *blob = handle.getBlob()) {
+    uint64_t expectedSize =
+        type.getNumElements() * (eltType.getIntOrFloatBitWidth() / 8);
+    if (blob->getData().size() != expectedSize)
+      return emitError() << "resource '" << handle.getKey() << "' holds "
+                         << blob->getData().size() << " bytes, but "
+                         << expectedSize << " are expected for type " << type;
+  }
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // OpaqueElementsAttr
 //===----------------------------------------------------------------------===//
@@ -0,0 +1,1017 @@
+//===- BuiltinDialectBytecode.cpp - Builtin Bytecode Implementation -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "BuiltinDialectBytecode.h"
+#include "mlir/Bytecode/BytecodeImplementation.h"
+#include "mlir/IR/BuiltinDialect.h"
+#include "mlir/IR/BuiltinTypes.h"
+#include "mlir/IR/Diagnostics.h"
+#include "llvm/ADT/TypeSwitch.h"
+
+using namespace mlir;
+
+//===----------------------------------------------------------------------===//
+// Encoding
+//===----------------------------------------------------------------------===//
+
+namespace {
+namespace builtin_encoding {
+/// This enum contains marker codes used to indicate which attribute is
+/// currently being decoded, and how it should be decoded. The order of these
+/// codes should generally be unchanged, as any changes will inevitably break
+/// compatibility with older bytecode.
+enum AttributeCode {
+  ///   ArrayAttr {
+  ///     elements: Attribute[]
+  ///   }
+  kArrayAttr = 0,
+
+  ///   DictionaryAttr {
+  ///     attrs: <StringAttr, Attribute>[]
+  ///   }
+  kDictionaryAttr = 1,
+
+  ///   StringAttr {
+  ///     value: string
+  ///   }
+  kStringAttr = 2,
+
+  ///   StringAttrWithType {
+  ///     value: string,
+  ///     type: Type
+  ///   }
+  kStringAttrWithType = 3,
+
+  ///   FlatSymbolRefAttr {
+  ///     rootReference: StringAttr
+  ///   }
+  kFlatSymbolRefAttr = 4,
+
+  ///   SymbolRefAttr {
+  ///     rootReference: StringAttr,
+  ///     leafReferences: FlatSymbolRefAttr[]
+  ///   }
+  kSymbolRefAttr = 5,
+
+  ///   TypeAttr {
+  ///     value: Type
+  ///   }
+  kTypeAttr = 6,
+
+  ///   UnitAttr {
+  ///   }
+  kUnitAttr = 7,
+
+  ///   IntegerAttr {
+  ///     type: Type
+  ///     value: APInt,
+  ///   }
+  kIntegerAttr = 8,
+
+  ///   FloatAttr {
+  ///     type: FloatType
+  ///     value: APFloat
+  ///   }
+  kFloatAttr = 9,
+
+  ///   DenseIntOrFPElementsAttr {
+  ///     type: ShapedType,
+  ///     data: blob
+  ///   }
+  kDenseIntOrFPElementsAttr = 10,
+
+  ///   UnknownLoc {
+  ///   }
+  kUnknownLoc = 11,
+
+  ///   FileLineColLoc {
+  ///     file: StringAttr,
+  ///     line: varint,
+  ///     column: varint
+  ///   }
+  kFileLineColLoc = 12,
+
+  ///   NameLoc {
+  ///     name: StringAttr,
+  ///     childLoc: LocationAttr
+  ///   }
+  kNameLoc = 13,
+
+  ///   CallSiteLoc {
+  ///    callee: LocationAttr,
+  ///    caller: LocationAttr
+  ///   }
+  kCallSiteLoc = 14,
+
+  ///   FusedLoc {
+  ///     locations: LocationAttr[]
+  ///   }
+  kFusedLoc = 15,
+
+  ///   FusedLocWithMetadata {
+  ///     locations: LocationAttr[],
+  ///     metadata: Attribute
+  ///   }
+  kFusedLocWithMetadata = 16,
+
+  ///   DenseResourceElementsAttr {
+  ///     type: ShapedType,
+  ///     key: string,
+  ///     hasData: varint,
+  ///     alignment: varint?,
+  ///     data: blob?
+  ///   }
+  kDenseResourceElementsAttr = 17,
+};
+
+/// This enum contains marker codes used to indicate which type is currently
+/// being decoded, and how it should be decoded. The order of these codes should
+/// generally be unchanged, as any changes will inevitably break compatibility
+/// with older bytecode.
+enum TypeCode {
+  ///   IntegerType {
+  ///     widthAndSignedness: varint // (width << 2) | (signedness)
+  ///   }
+  kIntegerType = 0,
+
+  ///   IndexType {
+  ///   }
+  kIndexType = 1,
+
+  ///   FunctionType {
+  ///     inputs: Type[],
+  ///     results: Type[]
+  ///   }
+  kFunctionType = 2,
+
+  ///   BFloat16Type {
+  ///   }
+  kBFloat16Type = 3,
+
+  ///   Float16Type {
+  ///   }
+  kFloat16Type = 4,
+
+  ///   Float32Type {
+  ///   }
+  kFloat32Type = 5,
+
+  ///   Float64Type {
+  ///   }
+  kFloat64Type = 6,
+
+  ///   Float80Type {
+  ///   }
+  kFloat80Type = 7,
+
+  ///   Float128Type {
+  ///   }
+  kFloat128Type = 8,
+
+  ///   ComplexType {
+  ///     elementType: Type
+  ///   }
+  kComplexType = 9,
+
+  ///   MemRefType {
+  ///     shape: svarint[],
+  ///     elementType: Type,
+  ///     layout: Attribute
+  ///   }
+  kMemRefType = 10,
+
+  ///   MemRefTypeWithMemSpace {
+  ///     memorySpace: Attribute,
+  ///     shape: svarint[],
+  ///     elementType: Type,
+  ///     layout: Attribute
+  ///   }
+  kMemRefTypeWithMemSpace = 11,
+
+  ///   NoneType {
+  ///   }
+  kNoneType = 12,
+
+  ///   RankedTensorType {
+  ///     shape: svarint[],
+  ///     elementType: Type,
+  ///   }
+  kRankedTensorType = 13,
+
+  ///   RankedTensorTypeWithEncoding {
+  ///     encoding: Attribute,
+  ///     shape: svarint[],
+  ///     elementType: Type
+  ///   }
+  kRankedTensorTypeWithEncoding = 14,
+
+  ///   TupleType {
+  ///     elementTypes: Type[]
+  ///   }
+  kTupleType = 15,
+
+  ///   UnrankedMemRefType {
+  ///     elementType: Type
+  ///   }
+  kUnrankedMemRefType = 16,
+
+  ///   UnrankedMemRefTypeWithMemSpace {
+  ///     memorySpace: Attribute,
+  ///     elementType: Type
+  ///   }
+  kUnrankedMemRefTypeWithMemSpace = 17,
+
+  ///   UnrankedTensorType {
+  ///     elementType: Type
+  ///   }
+  kUnrankedTensorType = 18,
+
+  ///   VectorType {
+  ///     shape: svarint[],
+  ///     elementType: Type
+  ///   }
+  kVectorType = 19,
+
+  ///   VectorTypeWithScalableDims {
+  ///     numScalableDims: varint,
+  ///     shape: svarint[],
+  ///     elementType: Type
+  ///   }
+  kVectorTypeWithScalableDims = 20,
+};
+
+} // namespace builtin_encoding
+} // namespace
+
+//===----------------------------------------------------------------------===//
+// BuiltinDialectBytecodeInterface
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// This class implements the bytecode interface for the builtin dialect.
+struct BuiltinDialectBytecodeInterface : public BytecodeDialectInterface {
+  BuiltinDialectBytecodeInterface(Dialect *dialect)
+      : BytecodeDialectInterface(dialect) {}
+
+  MLIRContext *getContext() const { return getDialect()->getContext(); }
+
+  //===--------------------------------------------------------------------===//
+  // Attributes
+
+  Attribute readAttribute(DialectBytecodeReader &reader) const override;
+  ArrayAttr readArrayAttr(DialectBytecodeReader &reader) const;
+  DictionaryAttr readDictionaryAttr(DialectBytecodeReader &reader) const;
+  StringAttr readStringAttr(DialectBytecodeReader &reader, bool hasType) const;
+  SymbolRefAttr readSymbolRefAttr(DialectBytecodeReader &reader,
+                                  bool hasNestedRefs) const;
+  TypeAttr readTypeAttr(DialectBytecodeReader &reader) const;
+  IntegerAttr readIntegerAttr(DialectBytecodeReader &reader) const;
+  FloatAttr readFloatAttr(DialectBytecodeReader &reader) const;
+  DenseElementsAttr
+  readDenseIntOrFPElementsAttr(DialectBytecodeReader &reader) const;
+  DenseResourceElementsAttr
+  readDenseResourceElementsAttr(DialectBytecodeReader &reader) const;
+  LocationAttr readFileLineColLoc(DialectBytecodeReader &reader) const;
+  LocationAttr readNameLoc(DialectBytecodeReader &reader) const;
+  LocationAttr readCallSiteLoc(DialectBytecodeReader &reader) const;
+  LocationAttr readFusedLoc(DialectBytecodeReader &reader,
+                            bool hasMetadata) const;
+
+  LogicalResult writeAttribute(Attribute attr,
+                               DialectBytecodeWriter &writer) const override;
+  void write(ArrayAttr attr, DialectBytecodeWriter &writer) const;
+  void write(DictionaryAttr attr, DialectBytecodeWriter &writer) const;
+  void write(StringAttr attr, DialectBytecodeWriter &writer) const;
+  void write(SymbolRefAttr attr, DialectBytecodeWriter &writer) const;
+  void write(TypeAttr attr, DialectBytecodeWriter &writer) const;
+  LogicalResult write(IntegerAttr attr, DialectBytecodeWriter &writer) const;
+  LogicalResult write(FloatAttr attr, DialectBytecodeWriter &writer) const;
+  void write(DenseIntOrFPElementsAttr attr,
+             DialectBytecodeWriter &writer) const;
+  void write(DenseResourceElementsAttr attr,
+             DialectBytecodeWriter &writer) const;
+  void write(FileLineColLoc attr, DialectBytecodeWriter &writer) const;
+  void write(NameLoc attr, DialectBytecodeWriter &writer) const;
+  void write(CallSiteLoc attr, DialectBytecodeWriter &writer) const;
+  void write(FusedLoc attr, DialectBytecodeWriter &writer) const;
+
+  //===--------------------------------------------------------------------===//
+  // Types
+
+  Type readType(DialectBytecodeReader &reader) const override;
+  IntegerType readIntegerType(DialectBytecodeReader &reader) const;
+  FunctionType readFunctionType(DialectBytecodeReader &reader) const;
+  MemRefType readMemRefType(DialectBytecodeReader &reader,
+                            bool hasMemSpace) const;
+  RankedTensorType readRankedTensorType(DialectBytecodeReader &reader,
+                                        bool hasEncoding) const;
+  TupleType readTupleType(DialectBytecodeReader &reader) const;
+  UnrankedMemRefType readUnrankedMemRefType(DialectBytecodeReader &reader,
+                                            bool hasMemSpace) const;
+  VectorType readVectorType(DialectBytecodeReader &reader,
+                            bool hasScalableDims) const;
+
+  LogicalResult writeType(Type type,
+                          DialectBytecodeWriter &writer) const override;
+  void write(IntegerType type, DialectBytecodeWriter &writer) const;
+  void write(FunctionType type, DialectBytecodeWriter &writer) const;
+  void write(MemRefType type, DialectBytecodeWriter &writer) const;
+  void write(RankedTensorType type, DialectBytecodeWriter &writer) const;
+  void write(TupleType type, DialectBytecodeWriter &writer) const;
+  void write(UnrankedMemRefType type, DialectBytecodeWriter &writer) const;
+  void write(VectorType type, DialectBytecodeWriter &writer) const;
+};
+
+/// Read a list of signed dimension sizes.
+static LogicalResult readShape(DialectBytecodeReader &reader,
+                               SmallVectorImpl<int64_t> &shape) {
+  return reader.readList(
+      shape, [&](int64_t &dim) { return reader.readSignedVarInt(dim); });
+}
+
+/// Write a list of signed dimension sizes.
+static void writeShape(DialectBytecodeWriter &writer, ArrayRef<int64_t> shape) {
+  writer.writeList(shape, [&](int64_t dim) { writer.writeSignedVarInt(dim); });
+}
+
+/// Returns the bit width used to encode the value of an integer attribute of
+/// the given type.
+static unsigned getIntegerBitWidth(Type type) {
+  if (type.isIndex())
+    return IndexType::kInternalStorageBitWidth;
+  return type.cast<IntegerType>().getWidth();
+}
+} // namespace
+
+std::unique_ptr<DialectInterface>
+builtin_dialect_detail::createBytecodeInterface(Dialect *dialect) {
+  return std::make_unique<BuiltinDialectBytecodeInterface>(dialect);
+}
+
+//===----------------------------------------------------------------------===//
+// Attributes: Reader
+
+Attribute BuiltinDialectBytecodeInterface::readAttribute(
+    DialectBytecodeReader &reader) const {
+  uint64_t code;
+  if (failed(reader.readVarInt(code)))
+    return Attribute();
+  switch (code) {
+  case builtin_encoding::kArrayAttr:
+    return readArrayAttr(reader);
+  case builtin_encoding::kDictionaryAttr:
+    return readDictionaryAttr(reader);
+  case builtin_encoding::kStringAttr:
+    return readStringAttr(reader, /*hasType=*/false);
+  case builtin_encoding::kStringAttrWithType:
+    return readStringAttr(reader, /*hasType=*/true);
+  case builtin_encoding::kFlatSymbolRefAttr:
+    return readSymbolRefAttr(reader, /*hasNestedRefs=*/false);
+  case builtin_encoding::kSymbolRefAttr:
+    return readSymbolRefAttr(reader, /*hasNestedRefs=*/true);
+  case builtin_encoding::kTypeAttr:
+    return readTypeAttr(reader);
+  case builtin_encoding::kUnitAttr:
+    return UnitAttr::get(getContext());
+  case builtin_encoding::kIntegerAttr:
+    return readIntegerAttr(reader);
+  case builtin_encoding::kFloatAttr:
+    return readFloatAttr(reader);
+  case builtin_encoding::kDenseIntOrFPElementsAttr:
+    return readDenseIntOrFPElementsAttr(reader);
+  case builtin_encoding::kUnknownLoc:
+    return UnknownLoc::get(getContext());
+  case builtin_encoding::kFileLineColLoc:
+    return readFileLineColLoc(reader);
+  case builtin_encoding::kNameLoc:
+    return readNameLoc(reader);
+  case builtin_encoding::kCallSiteLoc:
+    return readCallSiteLoc(reader);
+  case builtin_encoding::kFusedLoc:
+    return readFusedLoc(reader, /*hasMetadata=*/false);
+  case builtin_encoding::kDenseResourceElementsAttr:
+    return readDenseResourceElementsAttr(reader);
+  case builtin_encoding::kFusedLocWithMetadata:
+    return readFusedLoc(reader, /*hasMetadata=*/true);
+  default:
+    reader.emitError() << "unknown builtin attribute code: " << code;
+    return Attribute();
+  }
+}
+
+ArrayAttr BuiltinDialectBytecodeInterface::readArrayAttr(
+    DialectBytecodeReader &reader) const {
+  SmallVector<Attribute> elements;
+  if (failed(reader.readAttributes(elements)))
+    return ArrayAttr();
+  return ArrayAttr::get(getContext(), elements);
+}
+
+DictionaryAttr BuiltinDialectBytecodeInterface::readDictionaryAttr(
+    DialectBytecodeReader &reader) const {
+  uint64_t numAttrs;
+  if (failed(reader.readVarInt(numAttrs)))
+    return DictionaryAttr();
+
+  SmallVector<NamedAttribute> attrs;
+  for (uint64_t i = 0; i < numAttrs; ++i) {
+    StringAttr name;
+    Attribute value;
+    if (failed(reader.readAttribute(name)) ||
+        failed(reader.readAttribute(value)))
+      return DictionaryAttr();
+    attrs.emplace_back(name, value);
+  }
+  return DictionaryAttr::get(getContext(), attrs);
+}
+
+StringAttr
+BuiltinDialectBytecodeInterface::readStringAttr(DialectBytecodeReader &reader,
+                                                bool hasType) const {
+  StringRef string;
+  if (failed(reader.readString(string)))
+    return StringAttr();
+
+  // Read the type if present.
+  Type type;
+  if (!hasType)
+    return StringAttr::get(getContext(), string);
+  if (failed(reader.readType(type)))
+    return StringAttr();
+  return StringAttr::get(string, type);
+}
+
+SymbolRefAttr BuiltinDialectBytecodeInterface::readSymbolRefAttr(
+    DialectBytecodeReader &reader, bool hasNestedRefs) const {
+  StringAttr rootReference;
+  if (failed(reader.readAttribute(rootReference)))
+    return SymbolRefAttr();
+  SmallVector<FlatSymbolRefAttr> nestedReferences;
+  if (hasNestedRefs && failed(reader.readAttributes(nestedReferences)))
+    return SymbolRefAttr();
+  return SymbolRefAttr::get(rootReference, nestedReferences);
+}
+
+TypeAttr BuiltinDialectBytecodeInterface::readTypeAttr(
+    DialectBytecodeReader &reader) const {
+  Type type;
+  if (failed(reader.readType(type)))
+    return TypeAttr();
+  return TypeAttr::get(type);
+}
+
+IntegerAttr BuiltinDialectBytecodeInterface::readIntegerAttr(
+    DialectBytecodeReader &reader) const {
+  Type type;
+  if (failed(reader.readType(type)))
+    return IntegerAttr();
+  if (!type.isa<IndexType, IntegerType>()) {
+    reader.emitError() << "expected integer or index type for IntegerAttr, but "
+                          "got: "
+                       << type;
+    return IntegerAttr();
+  }
+
+  FailureOr<APInt> value =
+      reader.readAPIntWithKnownWidth(getIntegerBitWidth(type));
+  if (failed(value))
+    return IntegerAttr();
+  return IntegerAttr::get(type, *value);
+}
+
+FloatAttr BuiltinDialectBytecodeInterface::readFloatAttr(
+    DialectBytecodeReader &reader) const {
+  FloatType type;
+  if (failed(reader.readType(type)))
+    return FloatAttr();
+  FailureOr<APFloat> value =
+      reader.readAPFloatWithKnownSemantics(type.getFloatSemantics());
+  if (failed(value))
+    return FloatAttr();
+  return FloatAttr::get(type, *value);
+}
+
+DenseElementsAttr BuiltinDialectBytecodeInterface::readDenseIntOrFPElementsAttr(
+    DialectBytecodeReader &reader) const {
+  ShapedType type;
+  ArrayRef<char> blob;
+  if (failed(reader.readType(type)) || failed(reader.readBlob(blob)))
+    return DenseElementsAttr();
+
+  bool isSplat;
+  if (!DenseElementsAttr::isValidRawBuffer(type, blob, isSplat)) {
+    reader.emitError() << "invalid dense element data for type " << type;
+    return DenseElementsAttr();
+  }
+  return DenseElementsAttr::getFromRawBuffer(type, blob, isSplat);
+}
+
+DenseResourceElementsAttr
+BuiltinDialectBytecodeInterface::readDenseResourceElementsAttr(
+    DialectBytecodeReader &reader) const {
+  ShapedType type;
+  StringRef key;
+  uint64_t hasData;
+  if (failed(reader.readType(type)) || failed(reader.readString(key)) ||
+      failed(reader.readVarInt(hasData)))
+    return DenseResourceElementsAttr();
+
+  DialectResourceBlobManager &manager =
+      DenseResourceElementsHandle::getManager(getContext());
+  if (!hasData)
+    return DenseResourceElementsAttr::get(type, &manager.getOrInsert(key));
+
+  uint64_t alignment;
+  ArrayRef<char> data;
+  if (failed(reader.readVarInt(alignment)) || failed(reader.readBlob(data)))
+    return DenseResourceElementsAttr();
+  if (!llvm::isPowerOf2_64(alignment)) {
+    reader.emitError() << "invalid alignment " << alignment
+                       << " for resource '" << key << "'";
+    return DenseResourceElementsAttr();
+  }
+
+  // The bytecode buffer doesn't outlive the reader, so the data is copied.
+  // Populate an existing entry that is still waiting for its data, otherwise
+  // register a new one.
+  AsmResourceBlob blob = HeapAsmResourceBlob::allocateAndCopy(data, alignment);
+  DialectResourceBlobManager::BlobEntry *entry = &manager.getOrInsert(key);
+  if (!entry->getBlob())
+    entry->setBlob(std::move(blob));
+  else
+    entry = &manager.insert(key, std::move(blob));
+  return DenseResourceElementsAttr::get(type, entry);
+}
+
+LocationAttr BuiltinDialectBytecodeInterface::readFileLineColLoc(
+    DialectBytecodeReader &reader) const {
+  StringAttr filename;
+  uint64_t line, column;
+  if (failed(reader.readAttribute(filename)) ||
+      failed(reader.readVarInt(line)) || failed(reader.readVarInt(column)))
+    return LocationAttr();
+  return FileLineColLoc::get(filename, line, column);
+}
+
+LocationAttr BuiltinDialectBytecodeInterface::readNameLoc(
+    DialectBytecodeReader &reader) const {
+  StringAttr name;
+  LocationAttr childLoc;
+  if (failed(reader.readAttribute(name)) ||
+      failed(reader.readAttribute(childLoc)))
+    return LocationAttr();
+  return NameLoc::get(name, childLoc);
+}
+
+LocationAttr BuiltinDialectBytecodeInterface::readCallSiteLoc(
+    DialectBytecodeReader &reader) const {
+  LocationAttr callee, caller;
+  if (failed(reader.readAttribute(callee)) ||
+      failed(reader.readAttribute(caller)))
+    return LocationAttr();
+  return CallSiteLoc::get(callee, caller);
+}
+
+LocationAttr
+BuiltinDialectBytecodeInterface::readFusedLoc(DialectBytecodeReader &reader,
+                                              bool hasMetadata) const {
+  SmallVector<LocationAttr> locAttrs;
+  if (failed(reader.readAttributes(locAttrs)))
+    return LocationAttr();
+  SmallVector<Location> locations(locAttrs.begin(), locAttrs.end());
+
+  Attribute metadata;
+  if (hasMetadata && failed(reader.readAttribute(metadata)))
+    return LocationAttr();
+  return FusedLoc::get(locations, metadata, getContext());
+}
+
+//===----------------------------------------------------------------------===//
+// Attributes: Writer
+
+LogicalResult BuiltinDialectBytecodeInterface::writeAttribute(
+    Attribute attr, DialectBytecodeWriter &writer) const {
+  return TypeSwitch<Attribute, LogicalResult>(attr)
+      .Case<ArrayAttr, DictionaryAttr, StringAttr, SymbolRefAttr, TypeAttr,
+            DenseIntOrFPElementsAttr, DenseResourceElementsAttr,
+            FileLineColLoc, NameLoc, CallSiteLoc, FusedLoc>([&](auto attr) {
+        write(attr, writer);
+        return success();
+      })
+      .Case<IntegerAttr, FloatAttr>(
+          [&](auto attr) { return write(attr, writer); })
+      .Case([&](UnitAttr) {
+        writer.writeVarInt(builtin_encoding::kUnitAttr);
+        return success();
+      })
+      .Case([&](UnknownLoc) {
+        writer.writeVarInt(builtin_encoding::kUnknownLoc);
+        return success();
+      })
+      .Default([&](Attribute) { return failure(); });
+}
+
+void BuiltinDialectBytecodeInterface::write(
+    ArrayAttr attr, DialectBytecodeWriter &writer) const {
+  writer.writeVarInt(builtin_encoding::kArrayAttr);
+  writer.writeAttributes(attr.getValue());
+}
+
+void BuiltinDialectBytecodeInterface::write(
+    DictionaryAttr attr, DialectBytecodeWriter &writer) const {
+  writer.writeVarInt(builtin_encoding::kDictionaryAttr);
+  writer.writeList(attr.getValue(), [&](NamedAttribute attr) {
+    writer.writeAttribute(attr.getName());
+    writer.writeAttribute(attr.getValue());
+  });
+}
+
+void BuiltinDialectBytecodeInterface::write(
+    StringAttr attr, DialectBytecodeWriter &writer) const {
+  // We only encode the type if it isn't NoneType, which is significantly less
+  // common.
+  Type type = attr.getType();
+  if (!type.isa<NoneType>()) {
+    writer.writeVarInt(builtin_encoding::kStringAttrWithType);
+    writer.writeOwnedString(attr.getValue());
+    writer.writeType(type);
+    return;
+  }
+  writer.writeVarInt(builtin_encoding::kStringAttr);
+  writer.writeOwnedString(attr.getValue());
+}
+
+void BuiltinDialectBytecodeInterface::write(
+    SymbolRefAttr attr, DialectBytecodeWriter &writer) const {
+  ArrayRef<FlatSymbolRefAttr> nestedRefs = attr.getNestedReferences();
+  writer.writeVarInt(nestedRefs.empty() ? builtin_encoding::kFlatSymbolRefAttr
+                                        : builtin_encoding::kSymbolRefAttr);
+
+  writer.writeAttribute(attr.getRootReference());
+  if (!nestedRefs.empty())
+    writer.writeAttributes(nestedRefs);
+}
+
+void BuiltinDialectBytecodeInterface::write(
+    TypeAttr attr, DialectBytecodeWriter &writer) const {
+  writer.writeVarInt(builtin_encoding::kTypeAttr);
+  writer.writeType(attr.getValue());
+}
+
+LogicalResult
+BuiltinDialectBytecodeInterface::write(IntegerAttr attr,
+                                       DialectBytecodeWriter &writer) const {
+  // Integer attributes may also carry other types in legacy code, leave those
+  // to the textual format.
+  Type type = attr.getType();
+  if (!type.isa<IndexType, IntegerType>())
+    return failure();
+  writer.writeVarInt(builtin_encoding::kIntegerAttr);
+  writer.writeType(type);
+  writer.writeAPIntWithKnownWidth(attr.getValue());
+  return success();
+}
+
+LogicalResult
+BuiltinDialectBytecodeInterface::write(FloatAttr attr,
+                                       DialectBytecodeWriter &writer) const {
+  if (!attr.getType().isa<FloatType>())
+    return failure();
+  writer.writeVarInt(builtin_encoding::kFloatAttr);
+  writer.writeType(attr.getType());
+  writer.writeAPFloatWithKnownSemantics(attr.getValue());
+  return success();
+}
+
+void BuiltinDialectBytecodeInterface::write(
+    DenseIntOrFPElementsAttr attr, DialectBytecodeWriter &writer) const {
+  writer.writeVarInt(builtin_encoding::kDenseIntOrFPElementsAttr);
+  writer.writeType(attr.getType());
+  writer.writeOwnedBlob(attr.getRawData());
+}
+
+void BuiltinDialectBytecodeInterface::write(
+    DenseResourceElementsAttr attr, DialectBytecodeWriter &writer) const {
+  writer.writeVarInt(builtin_encoding::kDenseResourceElementsAttr);
+  writer.writeType(attr.getType());
+  writer.writeOwnedString(attr.getRawHandle().getKey());
+
+  // Data that hasn't been provided yet is left for the reader to provide.
+  AsmResourceBlob *blob = attr.getBlob();
+  writer.writeVarInt(blob ? 1 : 0);
+  if (!blob)
+    return;
+  writer.writeVarInt(std::max<size_t>(blob->getDataAlignment(), 1));
+  writer.writeOwnedBlob(blob->getData());
+}
+
+void BuiltinDialectBytecodeInterface::write(
+    FileLineColLoc attr, DialectBytecodeWriter &writer) const {
+  writer.writeVarInt(builtin_encoding::kFileLineColLoc);
+  writer.writeAttribute(attr.getFilename());
+  writer.writeVarInt(attr.getLine());
+  writer.writeVarInt(attr.getColumn());
+}
+
+void BuiltinDialectBytecodeInterface::write(
+    NameLoc attr, DialectBytecodeWriter &writer) const {
+  writer.writeVarInt(builtin_encoding::kNameLoc);
+  writer.writeAttribute(attr.getName());
+  writer.writeAttribute(attr.getChildLoc());
+}
+
+void BuiltinDialectBytecodeInterface::write(
+    CallSiteLoc attr, DialectBytecodeWriter &writer) const {
+  writer.writeVarInt(builtin_encoding::kCallSiteLoc);
+  writer.writeAttribute(attr.getCallee());
+  writer.writeAttribute(attr.getCaller());
+}
+
+void BuiltinDialectBytecodeInterface::write(
+    FusedLoc attr, DialectBytecodeWriter &writer) const {
+  Attribute metadata = attr.getMetadata();
+  writer.writeVarInt(metadata ? builtin_encoding::kFusedLocWithMetadata
+                              : builtin_encoding::kFusedLoc);
+  writer.writeList(attr.getLocations(),
+                   [&](Location loc) { writer.writeAttribute(loc); });
+  if (metadata)
+    writer.writeAttribute(metadata);
+}
+
+//===----------------------------------------------------------------------===//
+// Types: Reader
+
+Type BuiltinDialectBytecodeInterface::readType(
+    DialectBytecodeReader &reader) const {
+  uint64_t code;
+  if (failed(reader.readVarInt(code)))
+    return Type();
+  MLIRContext *context = getContext();
+  switch (code) {
+  case builtin_encoding::kIntegerType:
+    return readIntegerType(reader);
+  case builtin_encoding::kIndexType:
+    return IndexType::get(context);
+  case builtin_encoding::kFunctionType:
+    return readFunctionType(reader);
+  case builtin_encoding::kBFloat16Type:
+    return BFloat16Type::get(context);
+  case builtin_encoding::kFloat16Type:
+    return Float16Type::get(context);
+  case builtin_encoding::kFloat32Type:
+    return Float32Type::get(context);
+  case builtin_encoding::kFloat64Type:
+    return Float64Type::get(context);
+  case builtin_encoding::kFloat80Type:
+    return Float80Type::get(context);
+  case builtin_encoding::kFloat128Type:
+    return Float128Type::get(context);
+  case builtin_encoding::kComplexType: {
+    Type elementType;
+    if (failed(reader.readType(elementType)))
+      return Type();
+    return ComplexType::get(elementType);
+  }
+  case builtin_encoding::kMemRefType:
+    return readMemRefType(reader, /*hasMemSpace=*/false);
+  case builtin_encoding::kMemRefTypeWithMemSpace:
+    return readMemRefType(reader, /*hasMemSpace=*/true);
+  case builtin_encoding::kNoneType:
+    return NoneType::get(context);
+  case builtin_encoding::kRankedTensorType:
+    return readRankedTensorType(reader, /*hasEncoding=*/false);
+  case builtin_encoding::kRankedTensorTypeWithEncoding:
+    return readRankedTensorType(reader, /*hasEncoding=*/true);
+  case builtin_encoding::kTupleType:
+    return readTupleType(reader);
+  case builtin_encoding::kUnrankedMemRefType:
+    return readUnrankedMemRefType(reader, /*hasMemSpace=*/false);
+  case builtin_encoding::kUnrankedMemRefTypeWithMemSpace:
+    return readUnrankedMemRefType(reader, /*hasMemSpace=*/true);
+  case builtin_encoding::kUnrankedTensorType: {
+    Type elementType;
+    if (failed(reader.readType(elementType)))
+      return Type();
+    return UnrankedTensorType::get(elementType);
+  }
+  case builtin_encoding::kVectorType:
+    return readVectorType(reader, /*hasScalableDims=*/false);
+  case builtin_encoding::kVectorTypeWithScalableDims:
+    return readVectorType(reader, /*hasScalableDims=*/true);
+  default:
+    reader.emitError() << "unknown builtin type code: " << code;
+    return Type();
+  }
+}
+
+IntegerType BuiltinDialectBytecodeInterface::readIntegerType(
+    DialectBytecodeReader &reader) const {
+  uint64_t encoding;
+  if (failed(reader.readVarInt(encoding)))
+    return IntegerType();
+  uint64_t width = encoding >> 2;
+  if (width > IntegerType::kMaxWidth) {
+    reader.emitError() << "integer bitwidth is limited to "
+                       << IntegerType::kMaxWidth << " bits";
+    return IntegerType();
+  }
+  return IntegerType::get(
+      getContext(), width,
+      static_cast<IntegerType::SignednessSemantics>(encoding & 0x3));
+}
+
+FunctionType BuiltinDialectBytecodeInterface::readFunctionType(
+    DialectBytecodeReader &reader) const {
+  SmallVector<Type> inputs, results;
+  if (failed(reader.readTypes(inputs)) || failed(reader.readTypes(results)))
+    return FunctionType();
+  return FunctionType::get(getContext(), inputs, results);
+}
+
+MemRefType
+BuiltinDialectBytecodeInterface::readMemRefType(DialectBytecodeReader &reader,
+                                                bool hasMemSpace) const {
+  Attribute memorySpace;
+  if (hasMemSpace && failed(reader.readAttribute(memorySpace)))
+    return MemRefType();
+  SmallVector<int64_t> shape;
+  Type elementType;
+  MemRefLayoutAttrInterface layout;
+  if (failed(readShape(reader, shape)) ||
+      failed(reader.readType(elementType)) ||
+      failed(reader.readAttribute(layout)))
+    return MemRefType();
+  return MemRefType::get(shape, elementType, layout, memorySpace);
+}
+
+RankedTensorType BuiltinDialectBytecodeInterface::readRankedTensorType(
+    DialectBytecodeReader &reader, bool hasEncoding) const {
+  Attribute encoding;
+  if (hasEncoding && failed(reader.readAttribute(encoding)))
+    return RankedTensorType();
+  SmallVector<int64_t> shape;
+  Type elementType;
+  if (failed(readShape(reader, shape)) || failed(reader.readType(elementType)))
+    return RankedTensorType();
+  return RankedTensorType::get(shape, elementType, encoding);
+}
+
+TupleType BuiltinDialectBytecodeInterface::readTupleType(
+    DialectBytecodeReader &reader) const {
+  SmallVector<Type> elements;
+  if (failed(reader.readTypes(elements)))
+    return TupleType();
+  return TupleType::get(getContext(), elements);
+}
+
+UnrankedMemRefType BuiltinDialectBytecodeInterface::readUnrankedMemRefType(
+    DialectBytecodeReader &reader, bool hasMemSpace) const {
+  Attribute memorySpace;
+  if (hasMemSpace && failed(reader.readAttribute(memorySpace)))
+    return UnrankedMemRefType();
+  Type elementType;
+  if (failed(reader.readType(elementType)))
+    return UnrankedMemRefType();
+  return UnrankedMemRefType::get(elementType, memorySpace);
+}
+
+VectorType
+BuiltinDialectBytecodeInterface::readVectorType(DialectBytecodeReader &reader,
+                                                bool hasScalableDims) const {
+  uint64_t numScalableDims = 0;
+  if (hasScalableDims && failed(reader.readVarInt(numScalableDims)))
+    return VectorType();
+  SmallVector<int64_t> shape;
+  Type elementType;
+  if (failed(readShape(reader, shape)) || failed(reader.readType(elementType)))
+    return VectorType();
+  return VectorType::get(shape, elementType, numScalableDims);
+}
+
+//===----------------------------------------------------------------------===//
+// Types: Writer
+
+LogicalResult BuiltinDialectBytecodeInterface::writeType(
+    Type type, DialectBytecodeWriter &writer) const {
+  return TypeSwitch<Type, LogicalResult>(type)
+      .Case<IntegerType, FunctionType, MemRefType, RankedTensorType, TupleType,
+            UnrankedMemRefType, VectorType>([&](auto type) {
+        write(type, writer);
+        return success();
+      })
+      .Case([&](IndexType) {
+        writer.writeVarInt(builtin_encoding::kIndexType);
+        return success();
+      })
+      .Case([&](BFloat16Type) {
+        writer.writeVarInt(builtin_encoding::kBFloat16Type);
+        return success();
+      })
+      .Case([&](Float16Type) {
+        writer.writeVarInt(builtin_encoding::kFloat16Type);
+        return success();
+      })
+      .Case([&](Float32Type) {
+        writer.writeVarInt(builtin_encoding::kFloat32Type);
+        return success();
+      })
+      .Case([&](Float64Type) {
+        writer.writeVarInt(builtin_encoding::kFloat64Type);
+        return success();
+      })
+      .Case([&](Float80Type) {
+        writer.writeVarInt(builtin_encoding::kFloat80Type);
+        return success();
+      })
+      .Case([&](Float128Type) {
+        writer.writeVarInt(builtin_encoding::kFloat128Type);
+        return success();
+      })
+      .Case([&](ComplexType type) {
+        writer.writeVarInt(builtin_encoding::kComplexType);
+        writer.writeType(type.getElementType());
+        return success();
+      })
+      .Case([&](NoneType) {
+        writer.writeVarInt(builtin_encoding::kNoneType);
+        return success();
+      })
+      .Case([&](UnrankedTensorType type) {
+        writer.writeVarInt(builtin_encoding::kUnrankedTensorType);
+        writer.writeType(type.getElementType());
+        return success();
+      })
+      .Default([&](Type) { return failure(); });
+}
+
+void BuiltinDialectBytecodeInterface::write(
+    IntegerType type, DialectBytecodeWriter &writer) const {
+  writer.writeVarInt(builtin_encoding::kIntegerType);
+  writer.writeVarInt((type.getWidth() << 2) | type.getSignedness());
+}
+
+void BuiltinDialectBytecodeInterface::write(
+    FunctionType type, DialectBytecodeWriter &writer) const {
+  writer.writeVarInt(builtin_encoding::kFunctionType);
+  writer.writeTypes(type.getInputs());
+  writer.writeTypes(type.getResults());
+}
+
+void BuiltinDialectBytecodeInterface::write(
+    MemRefType type, DialectBytecodeWriter &writer) const {
+  if (Attribute memSpace = type.getMemorySpace()) {
+    writer.writeVarInt(builtin_encoding::kMemRefTypeWithMemSpace);
+    writer.writeAttribute(memSpace);
+  } else {
+    writer.writeVarInt(builtin_encoding::kMemRefType);
+  }
+  writeShape(writer, type.getShape());
+  writer.writeType(type.getElementType());
+  writer.writeAttribute(type.getLayout());
+}
+
+void BuiltinDialectBytecodeInterface::write(
+    RankedTensorType type, DialectBytecodeWriter &writer) const {
+  if (Attribute encoding = type.getEncoding()) {
+    writer.writeVarInt(builtin_encoding::kRankedTensorTypeWithEncoding);
+    writer.writeAttribute(encoding);
+  } else {
+    writer.writeVarInt(builtin_encoding::kRankedTensorType);
+  }
+  writeShape(writer, type.getShape());
+  writer.writeType(type.getElementType());
+}
+
+void BuiltinDialectBytecodeInterface::write(
+    TupleType type, DialectBytecodeWriter &writer) const {
+  writer.writeVarInt(builtin_encoding::kTupleType);
+  writer.writeTypes(type.getTypes());
+}
+
+void BuiltinDialectBytecodeInterface::write(
+    UnrankedMemRefType type, DialectBytecodeWriter &writer) const {
+  if (Attribute memSpace = type.getMemorySpace()) {
+    writer.writeVarInt(builtin_encoding::kUnrankedMemRefTypeWithMemSpace);
+    writer.writeAttribute(memSpace);
+  } else {
+    writer.writeVarInt(builtin_encoding::kUnrankedMemRefType);
+  }
+  writer.writeType(type.getElementType());
+}
+
+void BuiltinDialectBytecodeInterface::write(
+    VectorType type, DialectBytecodeWriter &writer) const {
+  if (unsigned numScalableDims = type.getNumScalableDims()) {
+    writer.writeVarInt(builtin_encoding::kVectorTypeWithScalableDims);
+    writer.writeVarInt(numScalableDims);
+  } else {
+    writer.writeVarInt(builtin_encoding::kVectorType);
+  }
+  writeShape(writer, type.getShape());
+  writer.writeType(type.getElementType());
+}
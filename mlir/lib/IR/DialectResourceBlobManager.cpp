@@ -0,0 +1,130 @@
+//===- DialectResourceBlobManager.cpp - Dialect Blob Management -----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/IR/DialectResourceBlobManager.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/MemoryBuffer.h"
+
+using namespace mlir;
+
+//===----------------------------------------------------------------------===//
+// AsmResourceBlob
+//===----------------------------------------------------------------------===//
+
+AsmResourceBlob HeapAsmResourceBlob::allocate(size_t size, size_t align) {
+  char *data = reinterpret_cast<char *>(
+      llvm::allocate_buffer(std::max<size_t>(size, 1), align));
+  auto deleter = [size](const void *data, size_t align) {
+    llvm::deallocate_buffer(const_cast<void *>(data),
+                            std::max<size_t>(size, 1), align);
+  };
+  return AsmResourceBlob(ArrayRef<char>(data, size), align, deleter);
+}
+
+AsmResourceBlob HeapAsmResourceBlob::allocateAndCopy(ArrayRef<char> data,
+                                                     size_t align) {
+  AsmResourceBlob blob = allocate(data.size(), align);
+  std::memcpy(const_cast<char *>(blob.getData().data()), data.data(),
+              data.size());
+  return blob;
+}
+
+AsmResourceBlob MemoryBufferAsmResourceBlob::allocate(
+    std::unique_ptr<llvm::MemoryBuffer> buffer, size_t align) {
+  StringRef contents = buffer->getBuffer();
+  assert(llvm::isAddrAligned(llvm::Align(align), contents.data()) &&
+         "buffer is not sufficiently aligned");
+
+  // The deleter owns the buffer, which unmaps the data when destroyed.
+  std::shared_ptr<llvm::MemoryBuffer> ownedBuffer(std::move(buffer));
+  auto deleter = [ownedBuffer](const void *, size_t) mutable {
+    ownedBuffer.reset();
+  };
+  return AsmResourceBlob(ArrayRef<char>(contents.data(), contents.size()),
+                         align, deleter);
+}
+
+FailureOr<AsmResourceBlob>
+MemoryBufferAsmResourceBlob::allocateFromFile(StringRef path, size_t align) {
+  auto fileOrErr = llvm::MemoryBuffer::getFile(
+      path, /*IsText=*/false, /*RequiresNullTerminator=*/false);
+  if (!fileOrErr)
+    return failure();
+
+  // Large files are memory mapped, and thus page aligned. Small files may be
+  // read into a heap buffer that doesn't satisfy the requested alignment, in
+  // which case we copy the (small) contents into a properly aligned blob.
+  std::unique_ptr<llvm::MemoryBuffer> &buffer = *fileOrErr;
+  StringRef contents = buffer->getBuffer();
+  if (!llvm::isAddrAligned(llvm::Align(align), contents.data())) {
+    return HeapAsmResourceBlob::allocateAndCopy(
+        ArrayRef<char>(contents.data(), contents.size()), align);
+  }
+  return allocate(std::move(buffer), align);
+}
+
+//===----------------------------------------------------------------------===//
+// DialectResourceBlobManager
+//===----------------------------------------------------------------------===//
+
+auto DialectResourceBlobManager::lookup(StringRef name) -> BlobEntry * {
+  llvm::sys::SmartScopedReader<true> reader(blobMapLock);
+
+  auto it = blobMap.find(name);
+  return it != blobMap.end() ? &it->second : nullptr;
+}
+
+void DialectResourceBlobManager::update(StringRef name,
+                                        AsmResourceBlob &&newBlob) {
+  BlobEntry *entry = lookup(name);
+  assert(entry && "`update` expects an existing entry for the provided name");
+  entry->setBlob(std::move(newBlob));
+}
+
+auto DialectResourceBlobManager::insert(StringRef name,
+                                        Optional<AsmResourceBlob> blob)
+    -> BlobEntry & {
+  llvm::sys::SmartScopedWriter<true> writer(blobMapLock);
+
+  // Functor used to attempt insertion with a given name.
+  auto tryInsertion = [&](StringRef name) -> BlobEntry * {
+    auto it = blobMap.try_emplace(name, BlobEntry());
+    if (it.second) {
+      it.first->second.initialize(it.first->getKey(), std::move(blob));
+      return &it.first->second;
+    }
+    return nullptr;
+  };
+
+  // Try inserting with the name provided by the user.
+  if (BlobEntry *entry = tryInsertion(name))
+    return *entry;
+
+  // If an entry already exists for the user provided name, tweak the name and
+  // re-attempt insertion until we find one that is unique.
+  llvm::SmallString<32> nameStorage(name);
+  nameStorage.push_back('_');
+  size_t nameCounter = 1;
+  do {
+    Twine(nameCounter++).toVector(nameStorage);
+
+    // Try inserting with the new name.
+    if (BlobEntry *entry = tryInsertion(nameStorage))
+      return *entry;
+    nameStorage.resize(name.size() + 1);
+  } while (true);
+}
+
+auto DialectResourceBlobManager::getOrInsert(StringRef name) -> BlobEntry & {
+  llvm::sys::SmartScopedWriter<true> writer(blobMapLock);
+
+  auto it = blobMap.try_emplace(name, BlobEntry());
+  if (it.second)
+    it.first->second.initialize(it.first->getKey(), llvm::None);
+  return it.first->second;
+}
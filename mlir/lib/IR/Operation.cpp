@@ -154,6 +154,9 @@ Operation::~Operation() {
     llvm::report_fatal_error("operation destroyed but still has uses");
   }
 #endif
+  if (auto *attrList = attrs.dyn_cast<NamedAttrList *>())
+    delete attrList;
+
   // Explicitly run the destructors for the operands.
   if (hasOperandStorage)
     getOperandStorage().~OperandStorage();
@@ -177,6 +180,23 @@ void Operation::destroy() {
   free(rawMem);
 }
 
+NamedAttrList &Operation::getMutableAttrList() {
+  if (auto *attrList = attrs.dyn_cast<NamedAttrList *>())
+    return *attrList;
+  auto *attrList =
+      new NamedAttrList(attrs.get<Attribute>().cast<DictionaryAttr>());
+  attrs = attrList;
+  return *attrList;
+}
+
+DictionaryAttr Operation::materializeAttrDictionary() {
+  auto *attrList = attrs.get<NamedAttrList *>();
+  DictionaryAttr dictionary = attrList->getDictionary(getContext());
+  delete attrList;
+  attrs = dictionary;
+  return dictionary;
+}
+
 /// Return true if this operation is a proper ancestor of the `other`
 /// operation.
 bool Operation::isProperAncestor(Operation *other) {
@@ -541,7 +561,8 @@ Operation *Operation::cloneWithoutRegions(BlockAndValueMapping &mapper) {
     successors.push_back(mapper.lookupOrDefault(successor));
 
   // Create the new operation.
-  auto *newOp = create(getLoc(), getName(), getResultTypes(), operands, attrs,
+  auto *newOp = create(getLoc(), getName(), getResultTypes(), operands,
+                       getAttrDictionary(),
                        successors, getNumRegions());
 
   // Remember the mapping of any results.
@@ -90,6 +90,10 @@ Attribute Parser::parseAttribute(Type type) {
   case Token::kw_dense:
     return parseDenseElementsAttr(type);
 
+  // Parse a dense resource elements attribute.
+  case Token::kw_dense_resource:
+    return parseDenseResourceElementsAttr(type);
+
   // Parse a dictionary attribute.
   case Token::l_brace: {
     NamedAttrList elements;
@@ -222,6 +226,7 @@ OptionalParseResult Parser::parseOptionalAttribute(Attribute &attribute,
   case Token::kw_affine_map:
   case Token::kw_affine_set:
   case Token::kw_dense:
+  case Token::kw_dense_resource:
   case Token::kw_false:
   case Token::kw_loc:
   case Token::kw_opaque:
@@ -831,6 +836,43 @@ Attribute Parser::parseDenseElementsAttr(Type attrType) {
   return literalParser.getAttr(loc, type);
 }
 
+/// Parse a dense resource elements attribute.
+///
+///   dense-resource-elements-attribute ::=
+///     `dense_resource` `<` resource-handle `>` `:` shaped-type
+///   resource-handle ::= bare-id | string-literal
+///
+/// The data of the referenced resource is not part of the textual form. If no
+/// resource with the given key is registered yet, an empty entry is created
+/// that the data can be provided to later on.
+Attribute Parser::parseDenseResourceElementsAttr(Type attrType) {
+  llvm::SMLoc loc = getToken().getLoc();
+  consumeToken(Token::kw_dense_resource);
+  if (parseToken(Token::less, "expected '<' after 'dense_resource'"))
+    return nullptr;
+
+  std::string key;
+  if (getToken().is(Token::string)) {
+    key = getToken().getStringValue();
+  } else if (getToken().is(Token::bare_identifier) || getToken().isKeyword()) {
+    key = getTokenSpelling().str();
+  } else {
+    return (emitError("expected resource handle"), nullptr);
+  }
+  consumeToken();
+
+  if (parseToken(Token::greater, "expected '>'"))
+    return nullptr;
+  auto type = parseElementsLiteralType(attrType);
+  if (!type)
+    return nullptr;
+
+  DialectResourceBlobManager &manager =
+      DenseResourceElementsHandle::getManager(getContext());
+  return getChecked<DenseResourceElementsAttr>(loc, type,
+                                               &manager.getOrInsert(key));
+}
+
 /// Parse an opaque elements attribute.
 Attribute Parser::parseOpaqueElementsAttr(Type attrType) {
   llvm::SMLoc loc = getToken().getLoc();
@@ -0,0 +1,882 @@
+//===- BytecodeReader.cpp - MLIR Bytecode Reader --------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Bytecode/BytecodeReader.h"
+#include "mlir/Bytecode/BytecodeImplementation.h"
+#include "mlir/Bytecode/Encoding.h"
+#include "mlir/IR/BuiltinDialect.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/OpImplementation.h"
+#include "mlir/IR/Verifier.h"
+#include "mlir/Parser.h"
+#include "llvm/ADT/ScopeExit.h"
+#include "llvm/Support/LEB128.h"
+#include "llvm/Support/MemoryBufferRef.h"
+
+using namespace mlir;
+
+//===----------------------------------------------------------------------===//
+// EncodingReader
+//===----------------------------------------------------------------------===//
+
+namespace {
+/// This class provides the primitive routines for decoding a bytecode buffer.
+class EncodingReader {
+public:
+  explicit EncodingReader(ArrayRef<uint8_t> contents, Location fileLoc)
+      : dataIt(contents.data()), dataEnd(contents.end()), fileLoc(fileLoc) {}
+  explicit EncodingReader(StringRef contents, Location fileLoc)
+      : EncodingReader({reinterpret_cast<const uint8_t *>(contents.data()),
+                        contents.size()},
+                       fileLoc) {}
+
+  /// Returns true if the entire section has been read.
+  bool empty() const { return dataIt == dataEnd; }
+
+  /// Returns the remaining size of the bytecode.
+  size_t size() const { return dataEnd - dataIt; }
+
+  /// Emit an error using the given arguments.
+  template <typename... Args>
+  InFlightDiagnostic emitError(Args &&...args) const {
+    return ::mlir::emitError(fileLoc).append(std::forward<Args>(args)...);
+  }
+
+  /// Parse a single byte from the stream.
+  LogicalResult parseByte(uint8_t &value) {
+    if (empty())
+      return emitError("attempting to parse a byte at the end of the bytecode");
+    value = *dataIt++;
+    return success();
+  }
+
+  /// Parse a range of bytes of 'length' into the given result.
+  LogicalResult parseBytes(size_t length, ArrayRef<uint8_t> &result) {
+    if (length > size()) {
+      return emitError("attempting to parse ", length, " bytes when only ",
+                       size(), " remain");
+    }
+    result = {dataIt, length};
+    dataIt += length;
+    return success();
+  }
+
+  /// Parse a variable length encoded integer from the byte stream.
+  LogicalResult parseVarInt(uint64_t &result) {
+    unsigned numBytes;
+    const char *error = nullptr;
+    result = llvm::decodeULEB128(dataIt, &numBytes, dataEnd, &error);
+    if (error)
+      return emitError("invalid varint: ", error);
+    dataIt += numBytes;
+    return success();
+  }
+
+  /// Parse a signed variable length encoded integer from the byte stream.
+  LogicalResult parseSignedVarInt(int64_t &result) {
+    unsigned numBytes;
+    const char *error = nullptr;
+    result = llvm::decodeSLEB128(dataIt, &numBytes, dataEnd, &error);
+    if (error)
+      return emitError("invalid signed varint: ", error);
+    dataIt += numBytes;
+    return success();
+  }
+
+  /// Parse a string prefixed by its length.
+  LogicalResult parseString(StringRef &result) {
+    uint64_t length;
+    ArrayRef<uint8_t> bytes;
+    if (failed(parseVarInt(length)) || failed(parseBytes(length, bytes)))
+      return failure();
+    result = StringRef(reinterpret_cast<const char *>(bytes.data()),
+                       bytes.size());
+    return success();
+  }
+
+  /// Parse a section header, placing the kind of section in `sectionID` and
+  /// the contents of the section in `sectionData`.
+  LogicalResult parseSection(bytecode::Section::ID &sectionID,
+                             ArrayRef<uint8_t> &sectionData) {
+    uint8_t sectionIDAndAlignment;
+    uint64_t length;
+    if (failed(parseByte(sectionIDAndAlignment)) ||
+        failed(parseVarInt(length)))
+      return failure();
+    sectionID = static_cast<bytecode::Section::ID>(sectionIDAndAlignment);
+    if (sectionID >= bytecode::Section::kNumSections)
+      return emitError("invalid section ID: ", unsigned(sectionID));
+    return parseBytes(static_cast<size_t>(length), sectionData);
+  }
+
+  Location getLoc() const { return fileLoc; }
+
+private:
+  /// The current data iterator, and an iterator to the end of the buffer.
+  const uint8_t *dataIt, *dataEnd;
+
+  /// A location for the bytecode used to report errors.
+  Location fileLoc;
+};
+
+/// Check that an index is within the bounds of an entry list. `entryStr` is
+/// used to produce better error messages.
+static LogicalResult resolveIndex(EncodingReader &reader, uint64_t index,
+                                  size_t numEntries, StringRef entryStr) {
+  if (index >= numEntries)
+    return reader.emitError("invalid ", entryStr, " index: ", index);
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// BytecodeReader
+//===----------------------------------------------------------------------===//
+
+class DialectReader;
+
+/// This class is used to read a bytecode buffer and translate it into MLIR.
+class BytecodeReader {
+public:
+  BytecodeReader(Location fileLoc, MLIRContext *context)
+      : fileLoc(fileLoc), context(context) {}
+
+  /// Read the bytecode defined within `buffer` into the given block.
+  LogicalResult read(llvm::MemoryBufferRef buffer, Block *block);
+
+  //===--------------------------------------------------------------------===//
+  // Attributes and Types
+
+  /// Resolve the attribute or type at the given index, parsing it on first use.
+  Attribute resolveAttribute(EncodingReader &reader, uint64_t index);
+  Type resolveType(EncodingReader &reader, uint64_t index);
+
+  /// Parse an attribute or type index and resolve it.
+  template <typename T>
+  LogicalResult parseAttribute(EncodingReader &reader, T &result) {
+    uint64_t index;
+    if (failed(reader.parseVarInt(index)))
+      return failure();
+    Attribute attr = resolveAttribute(reader, index);
+    if (!attr)
+      return failure();
+    if ((result = attr.dyn_cast<T>()))
+      return success();
+    return reader.emitError("expected attribute of type: ",
+                            llvm::getTypeName<T>(), ", but got: ", attr);
+  }
+  LogicalResult parseType(EncodingReader &reader, Type &result) {
+    uint64_t index;
+    if (failed(reader.parseVarInt(index)))
+      return failure();
+    result = resolveType(reader, index);
+    return success(!!result);
+  }
+
+  /// Parse a string index and resolve it.
+  LogicalResult parseSharedString(EncodingReader &reader, StringRef &result) {
+    uint64_t index;
+    if (failed(reader.parseVarInt(index)) ||
+        failed(resolveIndex(reader, index, strings.size(),
+                                       "string")))
+      return failure();
+    result = strings[index];
+    return success();
+  }
+
+private:
+  /// An attribute or type entry, parsed lazily.
+  template <typename T>
+  struct AttrTypeEntry {
+    /// The entry, or null if it hasn't been resolved yet.
+    T entry = {};
+    /// The index of the dialect owning this entry.
+    uint64_t dialect = 0;
+    /// The encoded data of the entry.
+    ArrayRef<uint8_t> data;
+    /// Whether the data uses the dialect's custom encoding, or is the
+    /// textual assembly format.
+    bool hasCustomEncoding = false;
+    /// Set while the entry is being resolved, to detect cycles.
+    bool isResolving = false;
+  };
+
+  /// A dialect referenced by the bytecode, loaded on first use.
+  struct BytecodeDialect {
+    StringRef name;
+    Dialect *dialect = nullptr;
+    bool loaded = false;
+  };
+
+  /// An operation name referenced by the bytecode, resolved on first use.
+  struct BytecodeOperationName {
+    uint64_t dialect = 0;
+    StringRef name;
+    Optional<OperationName> opName;
+  };
+
+  //===--------------------------------------------------------------------===//
+  // Sections
+
+  LogicalResult parseStringSection(ArrayRef<uint8_t> sectionData);
+  LogicalResult parseDialectSection(ArrayRef<uint8_t> sectionData);
+  LogicalResult parseAttrTypeSections(ArrayRef<uint8_t> entryData,
+                                      ArrayRef<uint8_t> offsetData);
+  LogicalResult parseIRSection(ArrayRef<uint8_t> sectionData, Block *block);
+
+  /// Load the dialect at the given index, returning null (without an error)
+  /// if it is not registered.
+  FailureOr<Dialect *> loadDialect(EncodingReader &reader, uint64_t index);
+
+  /// Resolve the given attribute or type entry.
+  template <typename T>
+  T resolveEntry(EncodingReader &reader, std::vector<AttrTypeEntry<T>> &entries,
+                 uint64_t index, StringRef entryType);
+  template <typename T>
+  T parseCustomEntry(const BytecodeDialectInterface &iface,
+                     DialectReader &reader);
+  Attribute parseAsmEntry(StringRef asmStr, Attribute);
+  Type parseAsmEntry(StringRef asmStr, Type);
+
+  //===--------------------------------------------------------------------===//
+  // IR
+
+  LogicalResult parseOperation(EncodingReader &reader, Block *block);
+  LogicalResult parseRegion(EncodingReader &reader, Region &region);
+  LogicalResult parseOperationName(EncodingReader &reader,
+                                   OperationName &opName);
+  LogicalResult parseOperand(EncodingReader &reader, Value &value);
+
+  /// Define the next value with `value`, resolving any forward references to
+  /// it.
+  void defineValue(Value value);
+
+  /// The location of the bytecode, used for errors.
+  Location fileLoc;
+  MLIRContext *context;
+
+  std::vector<StringRef> strings;
+  std::vector<BytecodeDialect> dialects;
+  std::vector<BytecodeOperationName> opNames;
+  std::vector<AttrTypeEntry<Attribute>> attrs;
+  std::vector<AttrTypeEntry<Type>> types;
+
+  /// The values defined so far, in definition order, and placeholders for
+  /// values used before their definition.
+  std::vector<Value> values;
+  DenseMap<uint64_t, Operation *> forwardRefOps;
+
+  /// The blocks of the region currently being parsed.
+  std::vector<Block *> regionBlocks;
+};
+
+//===----------------------------------------------------------------------===//
+// DialectReader
+//===----------------------------------------------------------------------===//
+
+/// The reader handed to BytecodeDialectInterface hooks.
+class DialectReader : public DialectBytecodeReader {
+public:
+  DialectReader(BytecodeReader &bytecodeReader, EncodingReader &reader,
+                MLIRContext *context)
+      : bytecodeReader(bytecodeReader), reader(reader), context(context) {}
+
+  InFlightDiagnostic emitError(const Twine &msg) override {
+    return reader.emitError(msg);
+  }
+
+  MLIRContext *getContext() const override { return context; }
+
+  LogicalResult readAttribute(Attribute &result) override {
+    return bytecodeReader.parseAttribute(reader, result);
+  }
+  LogicalResult readType(Type &result) override {
+    return bytecodeReader.parseType(reader, result);
+  }
+
+  LogicalResult readVarInt(uint64_t &result) override {
+    return reader.parseVarInt(result);
+  }
+  LogicalResult readSignedVarInt(int64_t &result) override {
+    return reader.parseSignedVarInt(result);
+  }
+
+  FailureOr<APInt> readAPIntWithKnownWidth(unsigned bitWidth) override {
+    // Small values are encoded using a single byte.
+    if (bitWidth <= 8) {
+      uint8_t value;
+      if (failed(reader.parseByte(value)))
+        return failure();
+      return APInt(bitWidth, value);
+    }
+
+    // Large values up to 64 bits are encoded using a single varint.
+    if (bitWidth <= 64) {
+      int64_t value;
+      if (failed(reader.parseSignedVarInt(value)))
+        return failure();
+      return APInt(bitWidth, value, /*isSigned=*/true);
+    }
+
+    // Otherwise, for really big values we encode the array of active words in
+    // the value.
+    uint64_t numActiveWords;
+    if (failed(reader.parseVarInt(numActiveWords)))
+      return failure();
+    if (numActiveWords > APInt::getNumWords(bitWidth)) {
+      reader.emitError("invalid number of words for APInt of width ", bitWidth,
+                       ": ", numActiveWords);
+      return failure();
+    }
+    SmallVector<uint64_t, 4> words(numActiveWords);
+    for (uint64_t i = 0; i < numActiveWords; ++i)
+      if (failed(reader.parseVarInt(words[i])))
+        return failure();
+    return APInt(bitWidth, words);
+  }
+
+  FailureOr<APFloat>
+  readAPFloatWithKnownSemantics(const llvm::fltSemantics &semantics) override {
+    FailureOr<APInt> intVal =
+        readAPIntWithKnownWidth(APFloat::getSizeInBits(semantics));
+    if (failed(intVal))
+      return failure();
+    return APFloat(semantics, *intVal);
+  }
+
+  LogicalResult readString(StringRef &result) override {
+    return bytecodeReader.parseSharedString(reader, result);
+  }
+
+  LogicalResult readBlob(ArrayRef<char> &result) override {
+    uint64_t size;
+    ArrayRef<uint8_t> data;
+    if (failed(reader.parseVarInt(size)) ||
+        failed(reader.parseBytes(static_cast<size_t>(size), data)))
+      return failure();
+    result = {reinterpret_cast<const char *>(data.data()), data.size()};
+    return success();
+  }
+
+private:
+  BytecodeReader &bytecodeReader;
+  EncodingReader &reader;
+  MLIRContext *context;
+};
+} // namespace
+
+//===----------------------------------------------------------------------===//
+// Top-level parsing
+
+LogicalResult BytecodeReader::read(llvm::MemoryBufferRef buffer, Block *block) {
+  EncodingReader reader(buffer.getBuffer(), fileLoc);
+
+  // Skip over the bytecode header, this should have already been checked.
+  ArrayRef<uint8_t> magic;
+  if (failed(reader.parseBytes(sizeof(bytecode::kMagic), magic)))
+    return failure();
+
+  // Parse the bytecode version and producer.
+  uint64_t version;
+  StringRef producer;
+  if (failed(reader.parseVarInt(version)) ||
+      failed(reader.parseString(producer)))
+    return failure();
+  if (version != bytecode::kVersion) {
+    return reader.emitError("bytecode version ", version,
+                            " is not supported by this reader, which expects "
+                            "version ",
+                            unsigned(bytecode::kVersion), " (producer: '",
+                            producer, "')");
+  }
+
+  // Collect the sections of the bytecode.
+  Optional<ArrayRef<uint8_t>> sectionDatas[bytecode::Section::kNumSections];
+  while (!reader.empty()) {
+    bytecode::Section::ID sectionID;
+    ArrayRef<uint8_t> sectionData;
+    if (failed(reader.parseSection(sectionID, sectionData)))
+      return failure();
+    if (sectionDatas[sectionID])
+      return reader.emitError("duplicate top-level section: ",
+                              unsigned(sectionID));
+    sectionDatas[sectionID] = sectionData;
+  }
+  for (int i = 0; i < bytecode::Section::kNumSections; ++i)
+    if (!sectionDatas[i])
+      return reader.emitError("missing data for top-level section: ", i);
+
+  // Process the sections that the IR refers to, then the IR itself.
+  if (failed(parseStringSection(*sectionDatas[bytecode::Section::kString])) ||
+      failed(parseDialectSection(*sectionDatas[bytecode::Section::kDialect])) ||
+      failed(parseAttrTypeSections(
+          *sectionDatas[bytecode::Section::kAttrType],
+          *sectionDatas[bytecode::Section::kAttrTypeOffset])))
+    return failure();
+  return parseIRSection(*sectionDatas[bytecode::Section::kIR], block);
+}
+
+//===----------------------------------------------------------------------===//
+// String and Dialect Sections
+
+LogicalResult
+BytecodeReader::parseStringSection(ArrayRef<uint8_t> sectionData) {
+  EncodingReader reader(sectionData, fileLoc);
+  uint64_t numStrings;
+  if (failed(reader.parseVarInt(numStrings)))
+    return failure();
+  // Each string occupies at least one byte, use that to sanity check the
+  // count before allocating.
+  if (numStrings > reader.size())
+    return reader.emitError("invalid number of strings: ", numStrings);
+  strings.resize(numStrings);
+  for (StringRef &string : strings)
+    if (failed(reader.parseString(string)))
+      return failure();
+  if (!reader.empty())
+    return reader.emitError("unexpected trailing data in string section");
+  return success();
+}
+
+LogicalResult
+BytecodeReader::parseDialectSection(ArrayRef<uint8_t> sectionData) {
+  EncodingReader reader(sectionData, fileLoc);
+
+  uint64_t numDialects;
+  if (failed(reader.parseVarInt(numDialects)))
+    return failure();
+  if (numDialects > reader.size())
+    return reader.emitError("invalid number of dialects: ", numDialects);
+  dialects.resize(numDialects);
+  for (BytecodeDialect &dialect : dialects)
+    if (failed(parseSharedString(reader, dialect.name)))
+      return failure();
+
+  uint64_t numOpNames;
+  if (failed(reader.parseVarInt(numOpNames)))
+    return failure();
+  if (numOpNames > reader.size())
+    return reader.emitError("invalid number of operation names: ",
+                            numOpNames);
+  opNames.resize(numOpNames);
+  for (BytecodeOperationName &opName : opNames) {
+    if (failed(reader.parseVarInt(opName.dialect)) ||
+        failed(resolveIndex(reader, opName.dialect,
+                                               dialects.size(), "dialect")) ||
+        failed(parseSharedString(reader, opName.name)))
+      return failure();
+  }
+  if (!reader.empty())
+    return reader.emitError("unexpected trailing data in dialect section");
+  return success();
+}
+
+FailureOr<Dialect *> BytecodeReader::loadDialect(EncodingReader &reader,
+                                                 uint64_t index) {
+  BytecodeDialect &dialect = dialects[index];
+  if (!dialect.loaded) {
+    dialect.dialect = context->getOrLoadDialect(dialect.name);
+    dialect.loaded = true;
+  }
+  return dialect.dialect;
+}
+
+//===----------------------------------------------------------------------===//
+// Attribute and Type Sections
+
+LogicalResult
+BytecodeReader::parseAttrTypeSections(ArrayRef<uint8_t> entryData,
+                                      ArrayRef<uint8_t> offsetData) {
+  EncodingReader offsetReader(offsetData, fileLoc);
+  uint64_t numAttrs, numTypes;
+  if (failed(offsetReader.parseVarInt(numAttrs)) ||
+      failed(offsetReader.parseVarInt(numTypes)))
+    return failure();
+  // Each offset entry occupies at least two bytes.
+  if (numAttrs + numTypes > offsetReader.size())
+    return offsetReader.emitError("invalid number of attributes and types");
+  attrs.resize(numAttrs);
+  types.resize(numTypes);
+
+  // Slice the entry data according to the sizes in the offset table.
+  EncodingReader entryReader(entryData, fileLoc);
+  auto parseOffsets = [&](auto &entries) -> LogicalResult {
+    for (auto &entry : entries) {
+      uint64_t sizeAndIsCustom;
+      if (failed(offsetReader.parseVarInt(entry.dialect)) ||
+          failed(resolveIndex(
+              offsetReader, entry.dialect, dialects.size(), "dialect")) ||
+          failed(offsetReader.parseVarInt(sizeAndIsCustom)) ||
+          failed(entryReader.parseBytes(sizeAndIsCustom >> 1, entry.data)))
+        return failure();
+      entry.hasCustomEncoding = sizeAndIsCustom & 1;
+    }
+    return success();
+  };
+  if (failed(parseOffsets(attrs)) || failed(parseOffsets(types)))
+    return failure();
+
+  if (!offsetReader.empty())
+    return offsetReader.emitError(
+        "unexpected trailing data in attribute/type offset section");
+  if (!entryReader.empty())
+    return entryReader.emitError(
+        "unexpected trailing data in attribute/type section");
+  return success();
+}
+
+Attribute BytecodeReader::resolveAttribute(EncodingReader &reader,
+                                           uint64_t index) {
+  return resolveEntry(reader, attrs, index, "Attribute");
+}
+Type BytecodeReader::resolveType(EncodingReader &reader, uint64_t index) {
+  return resolveEntry(reader, types, index, "Type");
+}
+
+template <>
+Attribute
+BytecodeReader::parseCustomEntry(const BytecodeDialectInterface &iface,
+                                 DialectReader &reader) {
+  return iface.readAttribute(reader);
+}
+template <>
+Type BytecodeReader::parseCustomEntry(const BytecodeDialectInterface &iface,
+                                      DialectReader &reader) {
+  return iface.readType(reader);
+}
+
+Attribute BytecodeReader::parseAsmEntry(StringRef asmStr, Attribute) {
+  size_t numRead = 0;
+  Attribute attr = ::mlir::parseAttribute(asmStr, context, numRead);
+  return attr && numRead == asmStr.size() ? attr : Attribute();
+}
+Type BytecodeReader::parseAsmEntry(StringRef asmStr, Type) {
+  size_t numRead = 0;
+  Type type = ::mlir::parseType(asmStr, context, numRead);
+  return type && numRead == asmStr.size() ? type : Type();
+}
+
+template <typename T>
+T BytecodeReader::resolveEntry(EncodingReader &reader,
+                               std::vector<AttrTypeEntry<T>> &entries,
+                               uint64_t index, StringRef entryType) {
+  if (failed(resolveIndex(reader, index, entries.size(), entryType)))
+    return T();
+
+  AttrTypeEntry<T> &entry = entries[index];
+  if (entry.entry)
+    return entry.entry;
+  if (entry.isResolving) {
+    reader.emitError("cyclic reference to ", entryType, " #", index);
+    return T();
+  }
+  entry.isResolving = true;
+  auto resetResolving =
+      llvm::make_scope_exit([&] { entries[index].isResolving = false; });
+
+  EncodingReader entryReader(entry.data, fileLoc);
+  T result;
+  if (!entry.hasCustomEncoding) {
+    StringRef asmStr(reinterpret_cast<const char *>(entry.data.data()),
+                     entry.data.size());
+    result = parseAsmEntry(asmStr, T());
+    if (!result) {
+      reader.emitError("failed to parse ", entryType, " #", index,
+                       " from its assembly format: ", asmStr);
+      return T();
+    }
+  } else {
+    FailureOr<Dialect *> dialect = loadDialect(reader, entry.dialect);
+    if (failed(dialect))
+      return T();
+    if (!*dialect) {
+      reader.emitError("dialect '", dialects[entry.dialect].name,
+                       "' is unknown, but is needed to read ", entryType,
+                       " #", index);
+      return T();
+    }
+    const auto *iface =
+        (*dialect)->getRegisteredInterface<BytecodeDialectInterface>();
+    if (!iface) {
+      reader.emitError("dialect '", dialects[entry.dialect].name,
+                       "' does not implement the bytecode interface");
+      return T();
+    }
+
+    DialectReader dialectReader(*this, entryReader, context);
+    result = parseCustomEntry<T>(*iface, dialectReader);
+    if (!result)
+      return T();
+    if (!entryReader.empty()) {
+      reader.emitError("unexpected trailing bytes after ", entryType, " #",
+                       index, " entry");
+      return T();
+    }
+  }
+
+  // Re-fetch the entry, parsing may have resolved other entries.
+  entries[index].entry = result;
+  return result;
+}
+
+//===----------------------------------------------------------------------===//
+// IR Section
+
+LogicalResult BytecodeReader::parseIRSection(ArrayRef<uint8_t> sectionData,
+                                             Block *block) {
+  EncodingReader reader(sectionData, fileLoc);
+
+  // Parse into a temporary top-level operation, so that the IR can be verified
+  // before it is handed out, like the textual parser does.
+  OwningOpRef<ModuleOp> topLevelOp(ModuleOp::create(fileLoc));
+  uint64_t numOps;
+  if (failed(reader.parseVarInt(numOps)))
+    return failure();
+  for (uint64_t i = 0; i < numOps; ++i)
+    if (failed(parseOperation(reader, topLevelOp->getBody())))
+      return failure();
+  if (!reader.empty())
+    return reader.emitError("unexpected trailing data in IR section");
+
+  // Any remaining forward references refer to values that were never defined.
+  if (!forwardRefOps.empty()) {
+    for (auto &it : forwardRefOps)
+      it.second->destroy();
+    forwardRefOps.clear();
+    return reader.emitError(
+        "not all forward references to values were resolved");
+  }
+
+  if (failed(verify(*topLevelOp)))
+    return failure();
+
+  // Splice the parsed operations over to the provided top-level block.
+  auto &parsedOps = topLevelOp->getBody()->getOperations();
+  auto &destOps = block->getOperations();
+  destOps.splice(destOps.empty() ? destOps.end() : std::prev(destOps.end()),
+                 parsedOps, parsedOps.begin(), parsedOps.end());
+  return success();
+}
+
+LogicalResult BytecodeReader::parseOperationName(EncodingReader &reader,
+                                                 OperationName &opName) {
+  uint64_t index;
+  if (failed(reader.parseVarInt(index)) ||
+      failed(resolveIndex(reader, index,
+                                                   opNames.size(),
+                                                   "operation name")))
+    return failure();
+
+  BytecodeOperationName &name = opNames[index];
+  if (!name.opName) {
+    // Load the dialect of the operation, mirroring the textual parser.
+    FailureOr<Dialect *> dialect = loadDialect(reader, name.dialect);
+    if (failed(dialect))
+      return failure();
+    name.opName.emplace(name.name, context);
+    if (!name.opName->isRegistered() && !*dialect &&
+        !context->allowsUnregisteredDialects()) {
+      return reader.emitError(
+          "operation '", name.name,
+          "' was read with an unregistered dialect. If this is intended, "
+          "please use -allow-unregistered-dialect with the MLIR tool used");
+    }
+  }
+  opName = *name.opName;
+  return success();
+}
+
+LogicalResult BytecodeReader::parseOperand(EncodingReader &reader,
+                                           Value &value) {
+  uint64_t index;
+  if (failed(reader.parseVarInt(index)))
+    return failure();
+  if (index < values.size()) {
+    value = values[index];
+    return success();
+  }
+
+  // This is a forward reference, create a placeholder that is replaced once
+  // the value is defined.
+  Operation *&placeholder = forwardRefOps[index];
+  if (!placeholder) {
+    OperationName name("builtin.unrealized_conversion_cast", context);
+    placeholder = Operation::create(fileLoc, name, NoneType::get(context),
+                                    /*operands=*/{}, /*attributes=*/llvm::None,
+                                    /*successors=*/{}, /*numRegions=*/0);
+  }
+  value = placeholder->getResult(0);
+  return success();
+}
+
+void BytecodeReader::defineValue(Value value) {
+  uint64_t index = values.size();
+  values.push_back(value);
+
+  auto it = forwardRefOps.find(index);
+  if (it == forwardRefOps.end())
+    return;
+  Operation *placeholder = it->second;
+  placeholder->getResult(0).replaceAllUsesWith(value);
+  placeholder->destroy();
+  forwardRefOps.erase(it);
+}
+
+LogicalResult BytecodeReader::parseOperation(EncodingReader &reader,
+                                             Block *block) {
+  using namespace bytecode;
+
+  OperationName opName("", context);
+  uint8_t opMask;
+  LocationAttr loc;
+  if (failed(parseOperationName(reader, opName)) ||
+      failed(reader.parseByte(opMask)) || failed(parseAttribute(reader, loc)))
+    return failure();
+
+  DictionaryAttr attrs;
+  if ((opMask & OpEncodingMask::kHasAttrs) &&
+      failed(parseAttribute(reader, attrs)))
+    return failure();
+
+  SmallVector<Type> resultTypes;
+  if (opMask & OpEncodingMask::kHasResults) {
+    uint64_t numResults;
+    if (failed(reader.parseVarInt(numResults)))
+      return failure();
+    if (numResults > reader.size())
+      return reader.emitError("invalid number of results: ", numResults);
+    resultTypes.resize(numResults);
+    for (Type &type : resultTypes)
+      if (failed(parseType(reader, type)))
+        return failure();
+  }
+
+  SmallVector<Value> operands;
+  if (opMask & OpEncodingMask::kHasOperands) {
+    uint64_t numOperands;
+    if (failed(reader.parseVarInt(numOperands)))
+      return failure();
+    if (numOperands > reader.size())
+      return reader.emitError("invalid number of operands: ", numOperands);
+    operands.resize(numOperands);
+    for (Value &operand : operands)
+      if (failed(parseOperand(reader, operand)))
+        return failure();
+  }
+
+  SmallVector<Block *> successors;
+  if (opMask & OpEncodingMask::kHasSuccessors) {
+    uint64_t numSuccessors;
+    if (failed(reader.parseVarInt(numSuccessors)))
+      return failure();
+    if (numSuccessors > reader.size())
+      return reader.emitError("invalid number of successors: ",
+                              numSuccessors);
+    successors.resize(numSuccessors);
+    for (Block *&successor : successors) {
+      uint64_t index;
+      if (failed(reader.parseVarInt(index)) ||
+          failed(resolveIndex(reader, index, regionBlocks.size(),
+                                         "successor")))
+        return failure();
+      successor = regionBlocks[index];
+    }
+  }
+
+  uint64_t numRegions = 0;
+  if ((opMask & OpEncodingMask::kHasRegions) &&
+      failed(reader.parseVarInt(numRegions)))
+    return failure();
+  if (numRegions > reader.size())
+    return reader.emitError("invalid number of regions: ", numRegions);
+
+  Operation *op = Operation::create(loc, opName, resultTypes, operands, attrs,
+                                    successors, numRegions);
+  block->push_back(op);
+  for (Value result : op->getResults())
+    defineValue(result);
+
+  // Parse the regions. Note that this clobbers `regionBlocks`, the caller
+  // resets it before each operation.
+  for (Region &region : op->getRegions())
+    if (failed(parseRegion(reader, region)))
+      return failure();
+  return success();
+}
+
+LogicalResult BytecodeReader::parseRegion(EncodingReader &reader,
+                                          Region &region) {
+  uint64_t numBlocks;
+  if (failed(reader.parseVarInt(numBlocks)))
+    return failure();
+  if (numBlocks > reader.size())
+    return reader.emitError("invalid number of blocks: ", numBlocks);
+
+  // Create all of the blocks up front, so that successors can refer to blocks
+  // that come later in the region.
+  regionBlocks.clear();
+  regionBlocks.reserve(numBlocks);
+  for (uint64_t i = 0; i < numBlocks; ++i) {
+    regionBlocks.push_back(new Block());
+    region.push_back(regionBlocks.back());
+  }
+
+  // Copy the block list, as nested regions reuse `regionBlocks`.
+  std::vector<Block *> blocks = regionBlocks;
+  for (Block *block : blocks) {
+    uint64_t numOpsAndHasArgs;
+    if (failed(reader.parseVarInt(numOpsAndHasArgs)))
+      return failure();
+
+    if (numOpsAndHasArgs & 1) {
+      uint64_t numArgs;
+      if (failed(reader.parseVarInt(numArgs)))
+        return failure();
+      if (numArgs > reader.size())
+        return reader.emitError("invalid number of block arguments: ",
+                                numArgs);
+      for (uint64_t i = 0; i < numArgs; ++i) {
+        Type type;
+        LocationAttr loc;
+        if (failed(parseType(reader, type)) ||
+            failed(parseAttribute(reader, loc)))
+          return failure();
+        defineValue(block->addArgument(type, loc));
+      }
+    }
+
+    for (uint64_t i = 0, e = numOpsAndHasArgs >> 1; i < e; ++i) {
+      regionBlocks = blocks;
+      if (failed(parseOperation(reader, block)))
+        return failure();
+    }
+  }
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// Entry Points
+//===----------------------------------------------------------------------===//
+
+bool mlir::isBytecode(llvm::MemoryBufferRef buffer) {
+  return buffer.getBuffer().startswith(
+      StringRef(bytecode::kMagic, sizeof(bytecode::kMagic)));
+}
+
+LogicalResult mlir::readBytecodeFile(llvm::MemoryBufferRef buffer, Block *block,
+                                     MLIRContext *context,
+                                     LocationAttr *sourceFileLoc) {
+  Location fileLoc = FileLineColLoc::get(context, buffer.getBufferIdentifier(),
+                                         /*line=*/0, /*column=*/0);
+  if (sourceFileLoc)
+    *sourceFileLoc = fileLoc;
+  if (!isBytecode(buffer))
+    return emitError(fileLoc, "input buffer is not an MLIR bytecode file");
+
+  BytecodeReader reader(fileLoc, context);
+  return reader.read(buffer, block);
+}
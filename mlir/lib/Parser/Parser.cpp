@@ -12,6 +12,7 @@
 
 #include "Parser.h"
 #include "AsmParserImpl.h"
+#include "mlir/Bytecode/BytecodeReader.h"
 #include "mlir/IR/AffineMap.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/Dialect.h"
@@ -2224,6 +2225,10 @@ LogicalResult mlir::parseSourceFile(const llvm::SourceMgr &sourceMgr,
   if (sourceFileLoc)
     *sourceFileLoc = parserLoc;
 
+  // Dispatch bytecode buffers to the bytecode reader.
+  if (isBytecode(*sourceBuf))
+    return readBytecodeFile(*sourceBuf, block, context);
+
   SymbolState aliasState;
   ParserState state(sourceMgr, context, aliasState, asmState);
   return TopLevelOperationParser(state).parse(block, parserLoc);
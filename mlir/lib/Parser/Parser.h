@@ -257,6 +257,9 @@ public:
 
   /// Parse a dense elements attribute.
   Attribute parseDenseElementsAttr(Type attrType);
+
+  /// Parse a dense resource elements attribute.
+  Attribute parseDenseResourceElementsAttr(Type attrType);
   ShapedType parseElementsLiteralType(Type type);
 
   /// Parse a sparse elements attribute.
@@ -12,6 +12,7 @@
 
 #include "mlir/Pass/Pass.h"
 #include "PassDetail.h"
+#include "mlir/IR/BlockAndValueMapping.h"
 #include "mlir/IR/Diagnostics.h"
 #include "mlir/IR/Dialect.h"
 #include "mlir/IR/Threading.h"
@@ -23,6 +24,7 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/CrashRecoveryContext.h"
 #include "llvm/Support/Mutex.h"
+#include "llvm/Support/SHA1.h"
 #include "llvm/Support/Signals.h"
 #include "llvm/Support/Threading.h"
 #include "llvm/Support/ToolOutputFile.h"
@@ -339,6 +341,204 @@ LogicalResult OpPassManager::initialize(MLIRContext *context,
   return success();
 }
 
+//===----------------------------------------------------------------------===//
+// OperationFingerPrint
+//===----------------------------------------------------------------------===//
+
+template <typename T>
+static void addDataToHash(llvm::SHA1 &hasher, const T &data) {
+  hasher.update(
+      ArrayRef<uint8_t>(reinterpret_cast<const uint8_t *>(&data), sizeof(T)));
+}
+
+OperationFingerPrint::OperationFingerPrint(Operation *topOp, bool structural) {
+  llvm::SHA1 hasher;
+
+  if (!structural) {
+    // Hash each of the operations based upon their mutable bits:
+    topOp->walk([&](Operation *op) {
+      //   - Operation pointer
+      addDataToHash(hasher, op);
+      //   - Attributes
+      addDataToHash(hasher, op->getAttrDictionary());
+      //   - Blocks in Regions
+      for (Region &region : op->getRegions()) {
+        for (Block &block : region) {
+          addDataToHash(hasher, &block);
+          for (BlockArgument arg : block.getArguments())
+            addDataToHash(hasher, arg);
+        }
+      }
+      //   - Location
+      addDataToHash(hasher, op->getLoc().getAsOpaquePointer());
+      //   - Operands
+      for (Value operand : op->getOperands())
+        addDataToHash(hasher, operand);
+      //   - Successors
+      for (unsigned i = 0, e = op->getNumSuccessors(); i != e; ++i)
+        addDataToHash(hasher, op->getSuccessor(i));
+    });
+    hash = hasher.result();
+    return;
+  }
+
+  // Number the blocks and values defined under the top operation, so that
+  // references to them are hashed independently of their address. Values
+  // defined above the top operation are hashed by address.
+  DenseMap<const void *, unsigned> ids;
+  topOp->walk<WalkOrder::PreOrder>([&](Operation *op) {
+    for (Value result : op->getResults())
+      ids.try_emplace(result.getAsOpaquePointer(), ids.size());
+    for (Region &region : op->getRegions()) {
+      for (Block &block : region) {
+        ids.try_emplace(&block, ids.size());
+        for (BlockArgument arg : block.getArguments())
+          ids.try_emplace(arg.getAsOpaquePointer(), ids.size());
+      }
+    }
+  });
+  auto addReferenceToHash = [&](const void *ptr) {
+    auto it = ids.find(ptr);
+    if (it != ids.end())
+      addDataToHash(hasher, it->second);
+    else
+      addDataToHash(hasher, ptr);
+  };
+
+  // Hash each of the operations based upon their structure. Names, types,
+  // attributes and locations are uniqued within the context, so their address
+  // identifies their contents:
+  topOp->walk<WalkOrder::PreOrder>([&](Operation *op) {
+    //   - Name, attributes and location
+    addDataToHash(hasher, op->getName().getAsOpaquePointer());
+    addDataToHash(hasher, op->getAttrDictionary().getAsOpaquePointer());
+    addDataToHash(hasher, op->getLoc().getAsOpaquePointer());
+    //   - Result types
+    addDataToHash(hasher, op->getNumResults());
+    for (Type type : op->getResultTypes())
+      addDataToHash(hasher, type.getAsOpaquePointer());
+    //   - Operands
+    addDataToHash(hasher, op->getNumOperands());
+    for (Value operand : op->getOperands())
+      addReferenceToHash(operand.getAsOpaquePointer());
+    //   - Successors
+    addDataToHash(hasher, op->getNumSuccessors());
+    for (Block *successor : op->getSuccessors())
+      addReferenceToHash(successor);
+    //   - Shape of the regions, and block argument types
+    addDataToHash(hasher, op->getNumRegions());
+    for (Region &region : op->getRegions()) {
+      addDataToHash(hasher, region.getBlocks().size());
+      for (Block &block : region) {
+        addDataToHash(hasher, block.getOperations().size());
+        addDataToHash(hasher, block.getNumArguments());
+        for (BlockArgument arg : block.getArguments())
+          addDataToHash(hasher, arg.getType().getAsOpaquePointer());
+      }
+    }
+  });
+  hash = hasher.result();
+}
+
+//===----------------------------------------------------------------------===//
+// IncrementalExecutionCache
+//===----------------------------------------------------------------------===//
+
+namespace mlir {
+namespace detail {
+/// The results of previous runs of the pipelines held by an OpToOpPassAdaptor,
+/// keyed by the structural fingerprint of the operation they ran on.
+struct IncrementalExecutionCache {
+  struct Entry {
+    Entry(Operation *result, unsigned lastUsedRun)
+        : result(result), lastUsedRun(lastUsedRun) {}
+    ~Entry() { result->destroy(); }
+
+    /// A detached operation holding the attributes and regions of the
+    /// operation after the pipeline ran.
+    Operation *result;
+
+    /// The last run of the pass manager that used this entry.
+    unsigned lastUsedRun;
+  };
+
+  /// Start the run `runID` of the pass manager. Entries that were not used
+  /// during the previous run are dropped, as are all entries if the held
+  /// pipelines changed. The cache may be shared by several adaptors, so this
+  /// may be called multiple times for the same run.
+  void beginRun(StringRef newPipelineKey, unsigned runID) {
+    if (runID == currentRunID)
+      return;
+    currentRunID = runID;
+    if (newPipelineKey != pipelineKey) {
+      entries.clear();
+      pipelineKey = newPipelineKey.str();
+    }
+    for (auto it = entries.begin(), e = entries.end(); it != e;) {
+      auto current = it++;
+      if (current->second->lastUsedRun != currentRun)
+        entries.erase(current);
+    }
+    ++currentRun;
+  }
+
+  /// Return the entry for the given fingerprint, or null if there is none.
+  Entry *lookup(const OperationFingerPrint &fingerPrint) {
+    llvm::sys::SmartScopedLock<true> lock(mutex);
+    auto it = entries.find(fingerPrint.getHash());
+    if (it == entries.end())
+      return nullptr;
+    it->second->lastUsedRun = currentRun;
+    return it->second.get();
+  }
+
+  /// Record `op` as the result of running the pipeline on an operation with
+  /// the given fingerprint.
+  void insert(const OperationFingerPrint &fingerPrint, Operation *op) {
+    // Copy the attributes and regions into a detached operation. The operands
+    // and results of `op` are not copied, as they refer to the surrounding IR.
+    OperationState state(op->getLoc(), op->getName());
+    state.addAttributes(op->getAttrs());
+    BlockAndValueMapping mapper;
+    for (Region &region : op->getRegions())
+      region.cloneInto(state.addRegion(), mapper);
+    auto entry = std::make_unique<Entry>(Operation::create(state), currentRun);
+
+    llvm::sys::SmartScopedLock<true> lock(mutex);
+    entries.try_emplace(fingerPrint.getHash(), std::move(entry));
+  }
+
+  /// Replace the attributes and regions of `op` with a copy of the result
+  /// recorded in `entry`.
+  static void restore(Operation *op, const Entry &entry) {
+    Operation *result = entry.result;
+    op->setLoc(result->getLoc());
+    op->setAttrs(result->getAttrDictionary());
+    BlockAndValueMapping mapper;
+    for (auto it : llvm::zip(op->getRegions(), result->getRegions())) {
+      Region &region = std::get<0>(it);
+      region.dropAllReferences();
+      region.getBlocks().clear();
+      std::get<1>(it).cloneInto(&region, mapper);
+    }
+  }
+
+  /// The recorded results. Entries are only removed in `beginRun`, which is
+  /// never called concurrently with a run of the pipelines.
+  llvm::StringMap<std::unique_ptr<Entry>> entries;
+  llvm::sys::SmartMutex<true> mutex;
+
+  /// The textual form of the held pipelines when the entries were recorded.
+  std::string pipelineKey;
+
+  /// The current run of the pass manager, as a local counter used to age the
+  /// entries and as the global identifier passed to `beginRun`.
+  unsigned currentRun = 0;
+  unsigned currentRunID = 0;
+};
+} // namespace detail
+} // namespace mlir
+
 //===----------------------------------------------------------------------===//
 // OpToOpPassAdaptor
 //===----------------------------------------------------------------------===//
@@ -544,10 +744,8 @@ void OpToOpPassAdaptor::runOnOperationImpl(bool verifyPasses) {
           continue;
 
         // Run the held pipeline over the current operation.
-        unsigned initGeneration = mgr->impl->initializationGeneration;
-        if (failed(runPipeline(mgr->getPasses(), &op, am.nest(&op),
-                               verifyPasses, initGeneration, instrumentor,
-                               &parentInfo)))
+        if (failed(runNestedPipeline(*mgr, &op, am.nest(&op), verifyPasses,
+                                     instrumentor, &parentInfo)))
           return signalPassFailure();
       }
     }
@@ -609,10 +807,9 @@ void OpToOpPassAdaptor::runOnOperationAsyncImpl(bool verifyPasses) {
                            opPMPair.first->getName().getIdentifier(), *context);
     assert(pm && "expected valid pass manager for operation");
 
-    unsigned initGeneration = pm->impl->initializationGeneration;
     LogicalResult pipelineResult =
-        runPipeline(pm->getPasses(), opPMPair.first, opPMPair.second,
-                    verifyPasses, initGeneration, instrumentor, &parentInfo);
+        runNestedPipeline(*pm, opPMPair.first, opPMPair.second, verifyPasses,
+                          instrumentor, &parentInfo);
 
     // Reset the active bit for this pass manager.
     activePMs[pmIndex].store(false);
@@ -624,6 +821,46 @@ void OpToOpPassAdaptor::runOnOperationAsyncImpl(bool verifyPasses) {
     signalPassFailure();
 }
 
+LogicalResult OpToOpPassAdaptor::runNestedPipeline(
+    OpPassManager &pm, Operation *op, AnalysisManager am, bool verifyPasses,
+    PassInstrumentor *instrumentor,
+    const PassInstrumentation::PipelineParentInfo *parentInfo) {
+  unsigned initGeneration = pm.impl->initializationGeneration;
+  if (!incrementalCache)
+    return runPipeline(pm.getPasses(), op, am, verifyPasses, initGeneration,
+                       instrumentor, parentInfo);
+
+  // Reuse the result of a previous run if the operation is unchanged.
+  OperationFingerPrint fingerPrint(op, /*structural=*/true);
+  if (auto *entry = incrementalCache->lookup(fingerPrint)) {
+    IncrementalExecutionCache::restore(op, *entry);
+    am.invalidate(PreservedAnalyses());
+    return success();
+  }
+
+  if (failed(runPipeline(pm.getPasses(), op, am, verifyPasses, initGeneration,
+                         instrumentor, parentInfo)))
+    return failure();
+  incrementalCache->insert(fingerPrint, op);
+  return success();
+}
+
+void OpToOpPassAdaptor::setIncrementalExecution(bool enable) {
+  if (!enable)
+    incrementalCache.reset();
+  else if (!incrementalCache)
+    incrementalCache = std::make_shared<IncrementalExecutionCache>();
+}
+
+void OpToOpPassAdaptor::beginIncrementalRun(unsigned runID) {
+  if (!incrementalCache)
+    return;
+  std::string pipelineKey;
+  llvm::raw_string_ostream os(pipelineKey);
+  printAsTextualPipeline(os);
+  incrementalCache->beginRun(os.str(), runID);
+}
+
 //===----------------------------------------------------------------------===//
 // PassManager
 //===----------------------------------------------------------------------===//
@@ -632,12 +869,34 @@ PassManager::PassManager(MLIRContext *ctx, Nesting nesting,
                          StringRef operationName)
     : OpPassManager(StringAttr::get(ctx, operationName), nesting), context(ctx),
       initializationKey(DenseMapInfo<llvm::hash_code>::getTombstoneKey()),
-      passTiming(false), verifyPasses(true) {}
+      passTiming(false), verifyPasses(true), incrementalExecution(false) {}
 
 PassManager::~PassManager() = default;
 
 void PassManager::enableVerifier(bool enabled) { verifyPasses = enabled; }
 
+void PassManager::enableIncrementalExecution(bool enabled) {
+  incrementalExecution = enabled;
+}
+
+/// Update the incremental execution state of the adaptors nested within `pm`,
+/// including the copies used for multi-threaded execution.
+static void prepareIncrementalExecution(OpPassManager &pm, bool enabled,
+                                        unsigned runID) {
+  for (Pass &pass : pm.getPasses()) {
+    auto *adaptor = dyn_cast<OpToOpPassAdaptor>(&pass);
+    if (!adaptor)
+      continue;
+    adaptor->setIncrementalExecution(enabled);
+    adaptor->beginIncrementalRun(runID);
+    for (OpPassManager &nestedPM : adaptor->getPassManagers())
+      prepareIncrementalExecution(nestedPM, enabled, runID);
+    for (auto &executor : adaptor->getParallelPassManagers())
+      for (OpPassManager &nestedPM : executor)
+        prepareIncrementalExecution(nestedPM, enabled, runID);
+  }
+}
+
 /// Run the passes within this manager on the provided operation.
 LogicalResult PassManager::run(Operation *op) {
   MLIRContext *context = getContext();
@@ -648,6 +907,9 @@ LogicalResult PassManager::run(Operation *op) {
   // Before running, make sure to coalesce any adjacent pass adaptors in the
   // pipeline.
   getImpl().coalesceAdjacentAdaptorPasses();
+  static std::atomic<unsigned> nextIncrementalRunID(0);
+  prepareIncrementalExecution(*this, incrementalExecution,
+                              ++nextIncrementalRunID);
 
   // Register all dialects for the current pipeline.
   DialectRegistry dependentDialects;
@@ -13,6 +13,37 @@
 
 namespace mlir {
 namespace detail {
+struct IncrementalExecutionCache;
+
+//===----------------------------------------------------------------------===//
+// OperationFingerPrint
+//===----------------------------------------------------------------------===//
+
+/// A unique fingerprint for a specific operation, and all of it's internal
+/// operations.
+class OperationFingerPrint {
+public:
+  /// Compute the fingerprint of `topOp`. By default, the fingerprint includes
+  /// the addresses of the nested operations, blocks and values, and thus
+  /// changes on any mutation of the IR. If `structural` is true, only the
+  /// structure of the IR is hashed instead: two equivalent operations within
+  /// the same context, e.g. the result of parsing the same IR twice, have the
+  /// same structural fingerprint.
+  OperationFingerPrint(Operation *topOp, bool structural = false);
+
+  bool operator==(const OperationFingerPrint &other) const {
+    return hash == other.hash;
+  }
+  bool operator!=(const OperationFingerPrint &other) const {
+    return !(*this == other);
+  }
+
+  /// Return the raw bytes of the fingerprint.
+  StringRef getHash() const { return hash; }
+
+private:
+  SmallString<20> hash;
+};
 
 //===----------------------------------------------------------------------===//
 // OpToOpPassAdaptor
@@ -47,7 +78,23 @@ public:
   /// Returns the adaptor pass name.
   std::string getAdaptorName();
 
+  /// Enable or disable the reuse of the results of previous runs of the held
+  /// pipelines. See `PassManager::enableIncrementalExecution`.
+  void setIncrementalExecution(bool enable);
+
+  /// Notify the adaptor that the run `runID` of the pass manager is starting.
+  /// This drops the cached results that were not used during the previous run.
+  void beginIncrementalRun(unsigned runID);
+
 private:
+  /// Run the pipeline of `pm` on `op`, or reuse the result of a previous run
+  /// if incremental execution is enabled and `op` did not change since.
+  LogicalResult runNestedPipeline(OpPassManager &pm, Operation *op,
+                                  AnalysisManager am, bool verifyPasses,
+                                  PassInstrumentor *instrumentor,
+                                  const PassInstrumentation::PipelineParentInfo
+                                      *parentInfo);
+
   /// Run this pass adaptor synchronously.
   void runOnOperationImpl(bool verifyPasses);
 
@@ -78,6 +125,11 @@ private:
   /// on different threads. This is used when threading is enabled.
   SmallVector<SmallVector<OpPassManager, 1>, 8> asyncExecutors;
 
+  /// The results of previous runs of the held pipelines, or null if
+  /// incremental execution is disabled. Shared with the copies of this
+  /// adaptor.
+  std::shared_ptr<IncrementalExecutionCache> incrementalCache;
+
   // For accessing "runPipeline".
   friend class mlir::PassManager;
 };
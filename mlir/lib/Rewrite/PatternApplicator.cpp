@@ -14,12 +14,63 @@
 #include "mlir/Rewrite/PatternApplicator.h"
 #include "ByteCode.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Format.h"
 
 #define DEBUG_TYPE "pattern-application"
 
 using namespace mlir;
 using namespace mlir::detail;
 
+//===----------------------------------------------------------------------===//
+// PatternProfile
+//===----------------------------------------------------------------------===//
+
+void PatternProfile::merge(const EntryMap &newEntries) {
+  llvm::sys::SmartScopedLock<true> lock(mutex);
+  for (auto &it : newEntries)
+    entries[it.first] += it.second;
+}
+
+auto PatternProfile::getEntries() const -> EntryMap {
+  llvm::sys::SmartScopedLock<true> lock(mutex);
+  return entries;
+}
+
+void PatternProfile::print(raw_ostream &os) const {
+  using ProfileEntry = std::pair<const Pattern *, Entry>;
+  EntryMap snapshot = getEntries();
+  std::vector<ProfileEntry> sortedEntries(snapshot.begin(), snapshot.end());
+  llvm::sort(sortedEntries,
+             [](const ProfileEntry &lhs, const ProfileEntry &rhs) {
+               return lhs.second.time > rhs.second.time;
+             });
+
+  os << "===" << std::string(73, '-') << "===\n"
+     << "Pattern statistics\n"
+     << "===" << std::string(73, '-') << "===\n"
+     << "  Time (ms)   Attempts  Successes   Rate  Pattern\n";
+  for (const ProfileEntry &entry : sortedEntries) {
+    const Pattern *pattern = entry.first;
+    const Entry &stats = entry.second;
+    os << llvm::format("%11.3f %10llu %10llu %5.1f%%  ",
+                       stats.time.count() / 1.0e6,
+                       (unsigned long long)stats.numAttempts,
+                       (unsigned long long)stats.numSuccesses,
+                       stats.getSuccessRate() * 100.0);
+    if (!pattern->getDebugName().empty())
+      os << pattern->getDebugName();
+    else
+      os << "<unnamed>";
+    if (Optional<OperationName> rootKind = pattern->getRootKind())
+      os << " (" << *rootKind << ")";
+    os << "\n";
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// PatternApplicator
+//===----------------------------------------------------------------------===//
+
 PatternApplicator::PatternApplicator(
     const FrozenRewritePatternSet &frozenPatternList)
     : frozenPatternList(frozenPatternList) {
@@ -28,7 +79,10 @@ PatternApplicator::PatternApplicator(
     bytecode->initializeMutableState(*mutableByteCodeState);
   }
 }
-PatternApplicator::~PatternApplicator() = default;
+PatternApplicator::~PatternApplicator() {
+  if (profile && !profileEntries.empty())
+    profile->merge(profileEntries);
+}
 
 #ifndef NDEBUG
 /// Log a message for a pattern that is impossible to match.
@@ -123,6 +177,43 @@ void PatternApplicator::walkAllPatterns(
   }
 }
 
+void PatternApplicator::enableProfiling(PatternProfile &newProfile) {
+  if (profile && !profileEntries.empty())
+    profile->merge(profileEntries);
+  profileEntries.clear();
+  profile = &newProfile;
+}
+
+void PatternApplicator::applyProfileGuidedOrder(
+    const PatternProfile &guidingProfile) {
+  PatternProfile::EntryMap entries = guidingProfile.getEntries();
+  if (entries.empty())
+    return;
+  auto getSuccessRate = [&](const Pattern *pattern) {
+    auto it = entries.find(pattern);
+    return it == entries.end() ? 0.0 : it->second.getSuccessRate();
+  };
+
+  // Reorder each run of patterns with the same static benefit. The lists are
+  // already sorted by benefit, so these runs are contiguous.
+  auto processPatternList = [&](SmallVectorImpl<const RewritePattern *> &list) {
+    for (auto it = list.begin(), e = list.end(); it != e;) {
+      PatternBenefit benefit = (*it)->getBenefit();
+      auto runEnd = std::find_if(it, e, [&](const RewritePattern *pattern) {
+        return pattern->getBenefit() != benefit;
+      });
+      std::stable_sort(it, runEnd,
+                       [&](const Pattern *lhs, const Pattern *rhs) {
+                         return getSuccessRate(lhs) > getSuccessRate(rhs);
+                       });
+      it = runEnd;
+    }
+  };
+  for (auto &it : patterns)
+    processPatternList(it.second);
+  processPatternList(anyOpPatterns);
+}
+
 LogicalResult PatternApplicator::matchAndRewrite(
     Operation *op, PatternRewriter &rewriter,
     function_ref<bool(const Pattern &)> canApply,
@@ -190,9 +281,12 @@ LogicalResult PatternApplicator::matchAndRewrite(
     // Operation `op` may be invalidated after applying the rewrite pattern.
     Operation *dumpRootOp = getDumpRootOp(op);
 #endif
+    std::chrono::steady_clock::time_point startTime;
+    if (profile)
+      startTime = std::chrono::steady_clock::now();
     if (pdlMatch) {
       bytecode->rewrite(rewriter, *pdlMatch, *mutableByteCodeState);
-      result = success(!onSuccess || succeeded(onSuccess(*bestPattern)));
+      result = success();
     } else {
       const auto *pattern = static_cast<const RewritePattern *>(bestPattern);
 
@@ -201,10 +295,15 @@ LogicalResult PatternApplicator::matchAndRewrite(
       result = pattern->matchAndRewrite(op, rewriter);
       LLVM_DEBUG(llvm::dbgs() << "\"" << pattern->getDebugName() << "\" result "
                               << succeeded(result) << "\n");
-
-      if (succeeded(result) && onSuccess && failed(onSuccess(*pattern)))
-        result = failure();
     }
+    if (profile) {
+      PatternProfile::Entry &entry = profileEntries[bestPattern];
+      ++entry.numAttempts;
+      entry.numSuccesses += succeeded(result);
+      entry.time += std::chrono::steady_clock::now() - startTime;
+    }
+    if (succeeded(result) && onSuccess && failed(onSuccess(*bestPattern)))
+      result = failure();
     if (succeeded(result)) {
       LLVM_DEBUG(logSucessfulPatternApplication(dumpRootOp));
       break;
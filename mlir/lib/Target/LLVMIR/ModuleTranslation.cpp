@@ -102,56 +102,27 @@ static llvm::Type *getInnermostElementType(llvm::Type *type) {
   } while (true);
 }
 
-/// Convert a dense elements attribute to an LLVM IR constant using its raw data
-/// storage if possible. This supports elements attributes of tensor or vector
-/// type and avoids constructing separate objects for individual values of the
-/// innermost dimension. Constants for other dimensions are still constructed
-/// recursively. Returns null if constructing from raw data is not supported for
-/// this type, e.g., element type is not a power-of-two-sized primitive. Reports
-/// other errors at `loc`.
-static llvm::Constant *
-convertDenseElementsAttr(Location loc, DenseElementsAttr denseElementsAttr,
-                         llvm::Type *llvmType,
-                         const ModuleTranslation &moduleTranslation) {
-  if (!denseElementsAttr)
-    return nullptr;
-
+/// Build an LLVM IR constant of `llvmType` from the raw, non-splat, element
+/// data `rawData` of a tensor or vector of `type`. This avoids constructing
+/// separate objects for individual values of the innermost dimension.
+/// Constants for other dimensions are still constructed recursively. Returns
+/// null if constructing from raw data is not supported for this type.
+static llvm::Constant *buildConstantFromRawData(Location loc, ShapedType type,
+                                                ArrayRef<char> rawData,
+                                                llvm::Type *llvmType) {
   llvm::Type *innermostLLVMType = getInnermostElementType(llvmType);
-  if (!llvm::ConstantDataSequential::isElementTypeCompatible(innermostLLVMType))
-    return nullptr;
-
-  ShapedType type = denseElementsAttr.getType();
-  if (type.getNumElements() == 0)
-    return nullptr;
 
   // Compute the shape of all dimensions but the innermost. Note that the
   // innermost dimension may be that of the vector element type.
   bool hasVectorElementType = type.getElementType().isa<VectorType>();
   unsigned numAggregates =
-      denseElementsAttr.getNumElements() /
-      (hasVectorElementType ? 1
-                            : denseElementsAttr.getType().getShape().back());
+      type.getNumElements() /
+      (hasVectorElementType ? 1 : type.getShape().back());
   ArrayRef<int64_t> outerShape = type.getShape();
   if (!hasVectorElementType)
     outerShape = outerShape.drop_back();
 
-  // Handle the case of vector splat, LLVM has special support for it.
-  if (denseElementsAttr.isSplat() &&
-      (type.isa<VectorType>() || hasVectorElementType)) {
-    llvm::Constant *splatValue = LLVM::detail::getLLVMConstant(
-        innermostLLVMType, denseElementsAttr.getSplatValue<Attribute>(), loc,
-        moduleTranslation, /*isTopLevel=*/false);
-    llvm::Constant *splatVector =
-        llvm::ConstantDataVector::getSplat(0, splatValue);
-    SmallVector<llvm::Constant *> constants(numAggregates, splatVector);
-    ArrayRef<llvm::Constant *> constantsRef = constants;
-    return buildSequentialConstant(constantsRef, outerShape, llvmType, loc);
-  }
-  if (denseElementsAttr.isSplat())
-    return nullptr;
-
-  // In case of non-splat, create a constructor for the innermost constant from
-  // a piece of raw data.
+  // Create a constructor for the innermost constant from a piece of raw data.
   std::function<llvm::Constant *(StringRef)> buildCstData;
   if (type.isa<TensorType>()) {
     auto vectorElementType = type.getElementType().dyn_cast<VectorType>();
@@ -178,12 +149,11 @@ convertDenseElementsAttr(Location loc, DenseElementsAttr denseElementsAttr,
   // Create innermost constants and defer to the default constant creation
   // mechanism for other dimensions.
   SmallVector<llvm::Constant *> constants;
-  unsigned aggregateSize = denseElementsAttr.getType().getShape().back() *
+  unsigned aggregateSize = type.getShape().back() *
                            (innermostLLVMType->getScalarSizeInBits() / 8);
   constants.reserve(numAggregates);
   for (unsigned i = 0; i < numAggregates; ++i) {
-    StringRef data(denseElementsAttr.getRawData().data() + i * aggregateSize,
-                   aggregateSize);
+    StringRef data(rawData.data() + i * aggregateSize, aggregateSize);
     constants.push_back(buildCstData(data));
   }
 
@@ -191,6 +161,92 @@ convertDenseElementsAttr(Location loc, DenseElementsAttr denseElementsAttr,
   return buildSequentialConstant(constantsRef, outerShape, llvmType, loc);
 }
 
+/// Convert a dense elements attribute to an LLVM IR constant using its raw data
+/// storage if possible. This supports elements attributes of tensor or vector
+/// type and avoids constructing separate objects for individual values of the
+/// innermost dimension. Constants for other dimensions are still constructed
+/// recursively. Returns null if constructing from raw data is not supported for
+/// this type, e.g., element type is not a power-of-two-sized primitive. Reports
+/// other errors at `loc`.
+static llvm::Constant *
+convertDenseElementsAttr(Location loc, DenseElementsAttr denseElementsAttr,
+                         llvm::Type *llvmType,
+                         const ModuleTranslation &moduleTranslation) {
+  if (!denseElementsAttr)
+    return nullptr;
+
+  llvm::Type *innermostLLVMType = getInnermostElementType(llvmType);
+  if (!llvm::ConstantDataSequential::isElementTypeCompatible(innermostLLVMType))
+    return nullptr;
+
+  ShapedType type = denseElementsAttr.getType();
+  if (type.getNumElements() == 0)
+    return nullptr;
+
+  // Handle the case of vector splat, LLVM has special support for it.
+  bool hasVectorElementType = type.getElementType().isa<VectorType>();
+  if (denseElementsAttr.isSplat() &&
+      (type.isa<VectorType>() || hasVectorElementType)) {
+    unsigned numAggregates =
+        denseElementsAttr.getNumElements() /
+        (hasVectorElementType ? 1 : type.getShape().back());
+    ArrayRef<int64_t> outerShape = type.getShape();
+    if (!hasVectorElementType)
+      outerShape = outerShape.drop_back();
+
+    llvm::Constant *splatValue = LLVM::detail::getLLVMConstant(
+        innermostLLVMType, denseElementsAttr.getSplatValue<Attribute>(), loc,
+        moduleTranslation, /*isTopLevel=*/false);
+    llvm::Constant *splatVector =
+        llvm::ConstantDataVector::getSplat(0, splatValue);
+    SmallVector<llvm::Constant *> constants(numAggregates, splatVector);
+    ArrayRef<llvm::Constant *> constantsRef = constants;
+    return buildSequentialConstant(constantsRef, outerShape, llvmType, loc);
+  }
+  if (denseElementsAttr.isSplat())
+    return nullptr;
+
+  // In case of non-splat, create the constant from the raw data.
+  return buildConstantFromRawData(loc, type, denseElementsAttr.getRawData(),
+                                  llvmType);
+}
+
+/// Convert a dense resource elements attribute to an LLVM IR constant built
+/// from the data of the referenced blob. The blob data is only read here, when
+/// the constant is actually materialized. Reports an error at `loc` and returns
+/// null if the data of the resource isn't available.
+static llvm::Constant *
+convertDenseResourceElementsAttr(Location loc,
+                                 DenseResourceElementsAttr resourceAttr,
+                                 llvm::Type *llvmType) {
+  AsmResourceBlob *blob = resourceAttr.getBlob();
+  if (!blob) {
+    emitError(loc) << "data of resource '"
+                   << resourceAttr.getRawHandle().getKey()
+                   << "' is not available";
+    return nullptr;
+  }
+
+  llvm::Type *innermostLLVMType = getInnermostElementType(llvmType);
+  ShapedType type = resourceAttr.getType();
+  if (!llvm::ConstantDataSequential::isElementTypeCompatible(
+          innermostLLVMType) ||
+      innermostLLVMType->getScalarSizeInBits() !=
+          type.getElementType().getIntOrFloatBitWidth()) {
+    emitError(loc) << "resource elements of type " << type.getElementType()
+                   << " cannot be converted to an LLVM constant";
+    return nullptr;
+  }
+  if (type.getNumElements() == 0)
+    return llvm::ConstantAggregateZero::get(llvmType);
+
+  llvm::Constant *result =
+      buildConstantFromRawData(loc, type, blob->getData(), llvmType);
+  if (!result)
+    emitError(loc) << "unsupported type for resource elements: " << type;
+  return result;
+}
+
 /// Create an LLVM IR constant of `llvmType` from the MLIR attribute `attr`.
 /// This currently supports integer, floating point, splat and dense element
 /// attributes and combinations thereof. Also, an array attribute with two
@@ -282,6 +338,10 @@ llvm::Constant *mlir::LLVM::detail::getLLVMConstant(
     return result;
   }
 
+  // Resource elements are only available as raw data.
+  if (auto resourceAttr = attr.dyn_cast<DenseResourceElementsAttr>())
+    return convertDenseResourceElementsAttr(loc, resourceAttr, llvmType);
+
   // Fall back to element-by-element construction otherwise.
   if (auto elementsAttr = attr.dyn_cast<ElementsAttr>()) {
     assert(elementsAttr.getType().hasStaticShape());
@@ -13,6 +13,7 @@
 
 #include "PassDetail.h"
 #include "mlir/IR/Dominance.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/Passes.h"
 #include "mlir/Transforms/Utils.h"
@@ -21,6 +22,7 @@
 #include "llvm/ADT/ScopedHashTable.h"
 #include "llvm/Support/Allocator.h"
 #include "llvm/Support/RecyclingAllocator.h"
+#include <atomic>
 #include <deque>
 
 using namespace mlir;
@@ -52,8 +54,20 @@ struct SimpleOperationInfo : public llvm::DenseMapInfo<Operation *> {
 } // namespace
 
 namespace {
-/// Simple common sub-expression elimination.
-struct CSE : public CSEBase<CSE> {
+/// Simple common sub-expression elimination over a set of regions.
+class CSEDriver {
+public:
+  CSEDriver(DominanceInfo &domInfo,
+            const DenseSet<Operation *> *skippedIsolatedOps = nullptr)
+      : domInfo(&domInfo), skippedIsolatedOps(skippedIsolatedOps) {}
+
+  /// Simplify all of the operations nested within `op`, and erase those that
+  /// were found to be redundant.
+  void simplify(Operation *op);
+
+  /// The number of operations CSE'd and DCE'd by this driver.
+  unsigned numCSE = 0, numDCE = 0;
+
   /// Shared implementation of operation elimination and scoped map definitions.
   using AllocatorTy = llvm::RecyclingAllocator<
       llvm::BumpPtrAllocator,
@@ -84,17 +98,24 @@ struct CSE : public CSEBase<CSE> {
   void simplifyBlock(ScopedMapTy &knownValues, Block *bb, bool hasSSADominance);
   void simplifyRegion(ScopedMapTy &knownValues, Region &region);
 
-  void runOnOperation() override;
-
 private:
   /// Operations marked as dead and to be erased.
   std::vector<Operation *> opsToErase;
   DominanceInfo *domInfo = nullptr;
+
+  /// An optional set of isolated operations that have already been processed,
+  /// and should be skipped by this driver.
+  const DenseSet<Operation *> *skippedIsolatedOps;
+};
+
+/// Common sub-expression elimination pass.
+struct CSE : public CSEBase<CSE> {
+  void runOnOperation() override;
 };
 } // namespace
 
 /// Attempt to eliminate a redundant operation.
-LogicalResult CSE::simplifyOperation(ScopedMapTy &knownValues, Operation *op,
+LogicalResult CSEDriver::simplifyOperation(ScopedMapTy &knownValues, Operation *op,
                                      bool hasSSADominance) {
   // Don't simplify terminator operations.
   if (op->hasTrait<OpTrait::IsTerminator>())
@@ -161,7 +182,7 @@ LogicalResult CSE::simplifyOperation(ScopedMapTy &knownValues, Operation *op,
   return failure();
 }
 
-void CSE::simplifyBlock(ScopedMapTy &knownValues, Block *bb,
+void CSEDriver::simplifyBlock(ScopedMapTy &knownValues, Block *bb,
                         bool hasSSADominance) {
   for (auto &op : *bb) {
     // If the operation is simplified, we don't process any held regions.
@@ -176,6 +197,8 @@ void CSE::simplifyBlock(ScopedMapTy &knownValues, Block *bb,
     // the given 'knownValues' map. This would cause the insertion of implicit
     // captures in explicit capture only regions.
     if (op.mightHaveTrait<OpTrait::IsIsolatedFromAbove>()) {
+      if (skippedIsolatedOps && skippedIsolatedOps->count(&op))
+        continue;
       ScopedMapTy nestedKnownValues;
       for (auto &region : op.getRegions())
         simplifyRegion(nestedKnownValues, region);
@@ -188,7 +211,7 @@ void CSE::simplifyBlock(ScopedMapTy &knownValues, Block *bb,
   }
 }
 
-void CSE::simplifyRegion(ScopedMapTy &knownValues, Region &region) {
+void CSEDriver::simplifyRegion(ScopedMapTy &knownValues, Region &region) {
   // If the region is empty there is nothing to do.
   if (region.empty())
     return;
@@ -243,29 +266,63 @@ void CSE::simplifyRegion(ScopedMapTy &knownValues, Region &region) {
   }
 }
 
-void CSE::runOnOperation() {
+void CSEDriver::simplify(Operation *op) {
   /// A scoped hash table of defining operations within a region.
   ScopedMapTy knownValues;
-
-  domInfo = &getAnalysis<DominanceInfo>();
-  Operation *rootOp = getOperation();
-
-  for (auto &region : rootOp->getRegions())
+  for (auto &region : op->getRegions())
     simplifyRegion(knownValues, region);
 
-  // If no operations were erased, then we mark all analyses as preserved.
-  if (opsToErase.empty())
-    return markAllAnalysesPreserved();
-
   /// Erase any operations that were marked as dead during simplification.
   for (auto *op : opsToErase)
     op->erase();
   opsToErase.clear();
+}
+
+void CSE::runOnOperation() {
+  Operation *rootOp = getOperation();
+  MLIRContext *context = &getContext();
+
+  // Operations that are isolated from above are simplified with their own
+  // scope, so those directly nested under the root can be processed in
+  // parallel. Each of them uses its own dominance info, as computing it
+  // lazily isn't thread safe.
+  SmallVector<Operation *> isolatedOps;
+  if (context->isMultithreadingEnabled()) {
+    for (Region &region : rootOp->getRegions())
+      for (Block &block : region)
+        for (Operation &op : block)
+          if (op.getNumRegions() != 0 &&
+              op.hasTrait<OpTrait::IsIsolatedFromAbove>())
+            isolatedOps.push_back(&op);
+  }
+  DenseSet<Operation *> processedIsolatedOps;
+  std::atomic<unsigned> numParallelCSE(0), numParallelDCE(0);
+  if (isolatedOps.size() > 1) {
+    (void)failableParallelForEach(context, isolatedOps, [&](Operation *op) {
+      DominanceInfo isolatedDomInfo(op);
+      CSEDriver driver(isolatedDomInfo);
+      driver.simplify(op);
+      numParallelCSE += driver.numCSE;
+      numParallelDCE += driver.numDCE;
+      return success();
+    });
+    processedIsolatedOps.insert(isolatedOps.begin(), isolatedOps.end());
+  }
+
+  CSEDriver driver(getAnalysis<DominanceInfo>(), &processedIsolatedOps);
+  driver.simplify(rootOp);
+  unsigned totalCSE = driver.numCSE + numParallelCSE;
+  unsigned totalDCE = driver.numDCE + numParallelDCE;
+  numCSE += totalCSE;
+  numDCE += totalDCE;
+
+  // If no operations were simplified, then we mark all analyses as preserved.
+  if (totalCSE == 0 && totalDCE == 0)
+    return markAllAnalysesPreserved();
 
   // We currently don't remove region operations, so mark dominance as
   // preserved.
   markAnalysesPreserved<DominanceInfo, PostDominanceInfo>();
-  domInfo = nullptr;
 }
 
 std::unique_ptr<Pass> mlir::createCSEPass() { return std::make_unique<CSE>(); }
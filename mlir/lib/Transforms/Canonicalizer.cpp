@@ -12,9 +12,14 @@
 //===----------------------------------------------------------------------===//
 
 #include "PassDetail.h"
+#include "mlir/IR/Threading.h"
 #include "mlir/Pass/Pass.h"
+#include "mlir/Rewrite/PatternApplicator.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 #include "mlir/Transforms/Passes.h"
+#include "llvm/Support/Debug.h"
+
+#define DEBUG_TYPE "canonicalize"
 
 using namespace mlir;
 
@@ -29,17 +34,28 @@ struct Canonicalizer : public CanonicalizerBase<Canonicalizer> {
     this->enabledPatterns = enabledPatterns;
   }
 
-  Canonicalizer() {
-    // Default constructed Canonicalizer takes its settings from command line
-    // options.
-    config.useTopDownTraversal = topDownProcessingEnabled;
-    config.enableRegionSimplification = enableRegionSimplification;
-    config.maxIterations = maxIterations;
+  /// Default constructed Canonicalizer takes its settings from its options.
+  Canonicalizer() : useOptionsForConfig(true) {}
+
+  ~Canonicalizer() override {
+    // The profile is shared between the clones of this pass, print it once the
+    // last one is destroyed.
+    if (printPatternStatistics && patternProfile.use_count() == 1)
+      patternProfile->print(llvm::errs());
   }
 
   /// Initialize the canonicalizer by building the set of patterns used during
   /// execution.
   LogicalResult initialize(MLIRContext *context) override {
+    // The options are only known once the pass pipeline has been parsed, so
+    // the config is populated here rather than on construction.
+    if (useOptionsForConfig) {
+      config.useTopDownTraversal = topDownProcessingEnabled;
+      config.enableRegionSimplification = enableRegionSimplification;
+      config.maxIterations = maxIterations;
+      config.useChangeDrivenRevisits = changeDriven;
+    }
+
     RewritePatternSet owningPatterns(context);
     for (auto *dialect : context->getLoadedDialects())
       dialect->getCanonicalizationPatterns(owningPatterns);
@@ -51,12 +67,66 @@ struct Canonicalizer : public CanonicalizerBase<Canonicalizer> {
     return success();
   }
   void runOnOperation() override {
-    (void)applyPatternsAndFoldGreedily(getOperation()->getRegions(), patterns,
-                                       config);
+    GreedyRewriteStatistics stats;
+    GreedyRewriteConfig runConfig = config;
+    runConfig.statistics = &stats;
+    if (printPatternStatistics || profileGuidedOrder)
+      runConfig.patternProfile = patternProfile.get();
+    if (profileGuidedOrder)
+      runConfig.patternOrderProfile = patternProfile.get();
+
+    // Operations that are isolated from above can't be affected by rewrites
+    // of their siblings, so those directly nested under the root are
+    // canonicalized in parallel first. This follows the same threading
+    // contract as running the pass nested on those operations. The root is
+    // processed afterwards, which finds little left to do within them.
+    Operation *rootOp = getOperation();
+    MLIRContext *context = &getContext();
+    SmallVector<Operation *> isolatedOps;
+    if (parallelizeIsolated && context->isMultithreadingEnabled()) {
+      for (Region &region : rootOp->getRegions())
+        for (Block &block : region)
+          for (Operation &op : block)
+            if (op.getNumRegions() != 0 &&
+                op.hasTrait<OpTrait::IsIsolatedFromAbove>())
+              isolatedOps.push_back(&op);
+    }
+    if (isolatedOps.size() > 1) {
+      std::vector<GreedyRewriteStatistics> isolatedStats(isolatedOps.size());
+      (void)failableParallelForEachN(
+          context, 0, isolatedOps.size(), [&](size_t index) {
+            GreedyRewriteConfig isolatedConfig = runConfig;
+            isolatedConfig.statistics = &isolatedStats[index];
+            (void)applyPatternsAndFoldGreedily(
+                isolatedOps[index]->getRegions(), patterns, isolatedConfig);
+            return success();
+          });
+      for (const GreedyRewriteStatistics &opStats : isolatedStats)
+        stats += opStats;
+    }
+
+    (void)applyPatternsAndFoldGreedily(rootOp->getRegions(), patterns,
+                                       runConfig);
+
+    GreedyRewriteStatistics::OpStatistics total = stats.getTotal();
+    numVisited += total.numVisits;
+    numFolded += total.numFolded;
+    numErasedDead += total.numErasedDead;
+    numPatternAttempts += total.numPatternAttempts;
+    numPatternSuccesses += total.numPatternSuccesses;
+    numFullTraversals += stats.numFullTraversals;
+    LLVM_DEBUG(stats.print(llvm::dbgs()));
   }
 
+  /// Whether the config should be populated from the pass options.
+  bool useOptionsForConfig = false;
+
   GreedyRewriteConfig config;
   FrozenRewritePatternSet patterns;
+
+  /// The pattern profile shared between all clones of this pass.
+  std::shared_ptr<PatternProfile> patternProfile =
+      std::make_shared<PatternProfile>();
 };
 } // namespace
 
@@ -18,6 +18,7 @@
 #include "llvm/ADT/DenseMap.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/ScopedPrinter.h"
 #include "llvm/Support/raw_ostream.h"
 
@@ -25,6 +26,62 @@ using namespace mlir;
 
 #define DEBUG_TYPE "greedy-rewriter"
 
+//===----------------------------------------------------------------------===//
+// GreedyRewriteStatistics
+//===----------------------------------------------------------------------===//
+
+auto GreedyRewriteStatistics::OpStatistics::operator+=(const OpStatistics &rhs)
+    -> OpStatistics & {
+  numVisits += rhs.numVisits;
+  numFolded += rhs.numFolded;
+  numErasedDead += rhs.numErasedDead;
+  numPatternAttempts += rhs.numPatternAttempts;
+  numPatternSuccesses += rhs.numPatternSuccesses;
+  return *this;
+}
+
+GreedyRewriteStatistics &
+GreedyRewriteStatistics::operator+=(const GreedyRewriteStatistics &rhs) {
+  for (auto &it : rhs.opStats)
+    opStats[it.first] += it.second;
+  numFullTraversals += rhs.numFullTraversals;
+  return *this;
+}
+
+auto GreedyRewriteStatistics::getTotal() const -> OpStatistics {
+  OpStatistics total;
+  for (auto &it : opStats)
+    total += it.second;
+  return total;
+}
+
+void GreedyRewriteStatistics::print(raw_ostream &os) const {
+  // Sort the operations by the number of pattern attempts, the most expensive
+  // operations first.
+  using StatEntry = std::pair<OperationName, OpStatistics>;
+  std::vector<StatEntry> entries(opStats.begin(), opStats.end());
+  llvm::sort(entries, [](const StatEntry &lhs, const StatEntry &rhs) {
+    if (lhs.second.numPatternAttempts != rhs.second.numPatternAttempts)
+      return lhs.second.numPatternAttempts > rhs.second.numPatternAttempts;
+    return lhs.first.getStringRef() < rhs.first.getStringRef();
+  });
+
+  auto printRow = [&](StringRef name, const OpStatistics &stats) {
+    os << llvm::format("%10llu %10llu %10llu %10llu %10llu  ",
+                       stats.numVisits, stats.numFolded, stats.numErasedDead,
+                       stats.numPatternAttempts, stats.numPatternSuccesses)
+       << name << "\n";
+  };
+  os << "===" << std::string(73, '-') << "===\n"
+     << "Greedy rewrite statistics (" << numFullTraversals
+     << " full traversals)\n"
+     << "===" << std::string(73, '-') << "===\n"
+     << "    Visits     Folded       Dead   Attempts  Successes  Operation\n";
+  for (const StatEntry &entry : entries)
+    printRow(entry.first.getStringRef(), entry.second);
+  printRow("Total", getTotal());
+}
+
 //===----------------------------------------------------------------------===//
 // GreedyPatternRewriteDriver
 //===----------------------------------------------------------------------===//
@@ -74,6 +131,18 @@ protected:
   /// PatternRewriter hook for erasing a dead operation.
   void eraseOp(Operation *op) override;
 
+  // When an operation is modified in place, it may be simplified further. This
+  // is only tracked for change driven revisits, otherwise the next full
+  // traversal takes care of it.
+  void finalizeRootUpdate(Operation *op) override;
+
+  // Operations moved into a new context by these hooks may be simplified
+  // further. This is only tracked for change driven revisits.
+  void inlineRegionBefore(Region &region, Region &parent,
+                          Region::iterator before) override;
+  void mergeBlocks(Block *source, Block *dest,
+                   ValueRange argValues = llvm::None) override;
+
   /// PatternRewriter hook for notifying match failure reasons.
   LogicalResult
   notifyMatchFailure(Operation *op,
@@ -93,6 +162,22 @@ protected:
   OperationFolder folder;
 
 private:
+  /// Seed the worklist with all of the operations nested within `regions`.
+  void seedWorklist(MutableArrayRef<Region> regions);
+
+  /// Process all of the operations in the worklist. Returns true if the IR was
+  /// changed.
+  bool processWorklist();
+
+  /// Add the users of the results of `op` to the worklist.
+  void addUsersToWorklist(Operation *op);
+
+  /// Return the statistics to update for `op`, or nullptr if statistics are
+  /// not being collected.
+  GreedyRewriteStatistics::OpStatistics *getStatistics(Operation *op) {
+    return config.statistics ? &(*config.statistics)[op->getName()] : nullptr;
+  }
+
   /// Configuration information for how to simplify.
   GreedyRewriteConfig config;
 
@@ -111,9 +196,71 @@ GreedyPatternRewriteDriver::GreedyPatternRewriteDriver(
 
   // Apply a simple cost model based solely on pattern benefit.
   matcher.applyDefaultCostModel();
+  if (config.patternOrderProfile)
+    matcher.applyProfileGuidedOrder(*config.patternOrderProfile);
+  if (config.patternProfile)
+    matcher.enableProfiling(*config.patternProfile);
 }
 
 bool GreedyPatternRewriteDriver::simplify(MutableArrayRef<Region> regions) {
+  bool changed = false;
+  bool needsFullTraversal = true;
+  unsigned iteration = 0;
+  do {
+    // In the default mode, every iteration revisits all of the operations. With
+    // change driven revisits, the worklist is only re-seeded if the regions
+    // were simplified, as the set of changed operations isn't tracked there.
+    if (needsFullTraversal || !config.useChangeDrivenRevisits)
+      seedWorklist(regions);
+
+    changed = processWorklist();
+
+    // After applying patterns, make sure that the CFG of each of the regions
+    // is kept up to date.
+    bool regionsChanged = config.enableRegionSimplification &&
+                          succeeded(simplifyRegions(*this, regions));
+    if (config.useChangeDrivenRevisits) {
+      // Every change made by the patterns has already been followed up on
+      // through the worklist, so only region simplification requires another
+      // iteration.
+      changed = regionsChanged;
+      needsFullTraversal = regionsChanged;
+    } else {
+      changed |= regionsChanged;
+    }
+  } while (changed &&
+           (++iteration < config.maxIterations ||
+            config.maxIterations == GreedyRewriteConfig::kNoIterationLimit));
+
+  // Whether the rewrite converges, i.e. wasn't changed in the last iteration.
+  return !changed;
+}
+
+void GreedyPatternRewriteDriver::seedWorklist(MutableArrayRef<Region> regions) {
+  worklist.clear();
+  worklistMap.clear();
+  if (config.statistics)
+    ++config.statistics->numFullTraversals;
+
+  if (!config.useTopDownTraversal) {
+    // Add operations to the worklist in postorder.
+    for (auto &region : regions)
+      region.walk([this](Operation *op) { addToWorklist(op); });
+  } else {
+    // Add all nested operations to the worklist in preorder.
+    for (auto &region : regions)
+      region.walk<WalkOrder::PreOrder>(
+          [this](Operation *op) { worklist.push_back(op); });
+
+    // Reverse the list so our pop-back loop processes them in-order.
+    std::reverse(worklist.begin(), worklist.end());
+    // Remember the reverse index.
+    for (size_t i = 0, e = worklist.size(); i != e; ++i)
+      worklistMap[worklist[i]] = i;
+  }
+}
+
+bool GreedyPatternRewriteDriver::processWorklist() {
 #ifndef NDEBUG
   const char *logLineComment =
       "//===-------------------------------------------===//\n";
@@ -132,142 +279,127 @@ bool GreedyPatternRewriteDriver::simplify(MutableArrayRef<Region> regions) {
   };
 #endif
 
-  bool changed = false;
-  unsigned iteration = 0;
-  do {
-    worklist.clear();
-    worklistMap.clear();
+  // These are scratch vectors used in the folding loop below.
+  SmallVector<Value, 8> originalOperands, resultValues;
 
-    if (!config.useTopDownTraversal) {
-      // Add operations to the worklist in postorder.
-      for (auto &region : regions)
-        region.walk([this](Operation *op) { addToWorklist(op); });
-    } else {
-      // Add all nested operations to the worklist in preorder.
-      for (auto &region : regions)
-        region.walk<WalkOrder::PreOrder>(
-            [this](Operation *op) { worklist.push_back(op); });
-
-      // Reverse the list so our pop-back loop processes them in-order.
-      std::reverse(worklist.begin(), worklist.end());
-      // Remember the reverse index.
-      for (size_t i = 0, e = worklist.size(); i != e; ++i)
-        worklistMap[worklist[i]] = i;
-    }
+  bool changed = false;
+  while (!worklist.empty()) {
+    auto *op = popFromWorklist();
 
-    // These are scratch vectors used in the folding loop below.
-    SmallVector<Value, 8> originalOperands, resultValues;
+    // Nulls get added to the worklist when operations are removed, ignore
+    // them.
+    if (op == nullptr)
+      continue;
 
-    changed = false;
-    while (!worklist.empty()) {
-      auto *op = popFromWorklist();
+    GreedyRewriteStatistics::OpStatistics *stats = getStatistics(op);
+    if (stats)
+      ++stats->numVisits;
+
+    LLVM_DEBUG({
+      logger.getOStream() << "\n";
+      logger.startLine() << logLineComment;
+      logger.startLine() << "Processing operation : '" << op->getName()
+                         << "'(" << op << ") {\n";
+      logger.indent();
+
+      // If the operation has no regions, just print it here.
+      if (op->getNumRegions() == 0) {
+        op->print(
+            logger.startLine(),
+            OpPrintingFlags().printGenericOpForm().elideLargeElementsAttrs());
+        logger.getOStream() << "\n\n";
+      }
+    });
 
-      // Nulls get added to the worklist when operations are removed, ignore
-      // them.
-      if (op == nullptr)
-        continue;
+    // If the operation is trivially dead - remove it.
+    if (isOpTriviallyDead(op)) {
+      notifyOperationRemoved(op);
+      op->erase();
+      changed = true;
+      if (stats)
+        ++stats->numErasedDead;
 
-      LLVM_DEBUG({
-        logger.getOStream() << "\n";
-        logger.startLine() << logLineComment;
-        logger.startLine() << "Processing operation : '" << op->getName()
-                           << "'(" << op << ") {\n";
-        logger.indent();
+      LLVM_DEBUG(logResultWithLine("success", "operation is trivially dead"));
+      continue;
+    }
 
-        // If the operation has no regions, just print it here.
-        if (op->getNumRegions() == 0) {
-          op->print(
-              logger.startLine(),
-              OpPrintingFlags().printGenericOpForm().elideLargeElementsAttrs());
-          logger.getOStream() << "\n\n";
-        }
-      });
+    // Collects all the operands and result uses of the given `op` into work
+    // list. Also remove `op` and nested ops from worklist.
+    originalOperands.assign(op->operand_begin(), op->operand_end());
+    auto preReplaceAction = [&](Operation *op) {
+      // Add the operands to the worklist for visitation.
+      addToWorklist(originalOperands);
 
-      // If the operation is trivially dead - remove it.
-      if (isOpTriviallyDead(op)) {
-        notifyOperationRemoved(op);
-        op->erase();
-        changed = true;
+      // Add all the users of the result to the worklist so we make sure
+      // to revisit them.
+      addUsersToWorklist(op);
 
-        LLVM_DEBUG(logResultWithLine("success", "operation is trivially dead"));
-        continue;
-      }
+      notifyOperationRemoved(op);
+    };
 
-      // Collects all the operands and result uses of the given `op` into work
-      // list. Also remove `op` and nested ops from worklist.
-      originalOperands.assign(op->operand_begin(), op->operand_end());
-      auto preReplaceAction = [&](Operation *op) {
-        // Add the operands to the worklist for visitation.
-        addToWorklist(originalOperands);
-
-        // Add all the users of the result to the worklist so we make sure
-        // to revisit them.
-        for (auto result : op->getResults())
-          for (auto *userOp : result.getUsers())
-            addToWorklist(userOp);
+    // Add the given operation to the worklist.
+    auto collectOps = [this](Operation *op) { addToWorklist(op); };
 
-        notifyOperationRemoved(op);
-      };
+    // Try to fold this op.
+    bool inPlaceUpdate;
+    if ((succeeded(folder.tryToFold(op, collectOps, preReplaceAction,
+                                    &inPlaceUpdate)))) {
+      LLVM_DEBUG(logResultWithLine("success", "operation was folded"));
 
-      // Add the given operation to the worklist.
-      auto collectOps = [this](Operation *op) { addToWorklist(op); };
+      changed = true;
+      if (stats)
+        ++stats->numFolded;
+      if (!inPlaceUpdate)
+        continue;
 
-      // Try to fold this op.
-      bool inPlaceUpdate;
-      if ((succeeded(folder.tryToFold(op, collectOps, preReplaceAction,
-                                      &inPlaceUpdate)))) {
-        LLVM_DEBUG(logResultWithLine("success", "operation was folded"));
+      // The users of an operation updated in place may now be simplified.
+      if (config.useChangeDrivenRevisits)
+        addUsersToWorklist(op);
+    }
 
-        changed = true;
-        if (!inPlaceUpdate)
-          continue;
-      }
+    // Try to match one of the patterns. The rewriter is automatically
+    // notified of any necessary changes, so there is nothing else to do
+    // here.
+    auto canApply = [&](const Pattern &pattern) {
+      LLVM_DEBUG({
+        logger.getOStream() << "\n";
+        logger.startLine() << "* Pattern " << pattern.getDebugName() << " : '"
+                           << op->getName() << " -> (";
+        llvm::interleaveComma(pattern.getGeneratedOps(), logger.getOStream());
+        logger.getOStream() << ")' {\n";
+        logger.indent();
+      });
+      if (stats)
+        ++stats->numPatternAttempts;
+      return true;
+    };
+    auto onFailure = [&](const Pattern &pattern) {
+      LLVM_DEBUG(logResult("failure", "pattern failed to match"));
+    };
+    auto onSuccess = [&](const Pattern &pattern) {
+      LLVM_DEBUG(logResult("success", "pattern applied successfully"));
+      if (stats)
+        ++stats->numPatternSuccesses;
+      return success();
+    };
 
-      // Try to match one of the patterns. The rewriter is automatically
-      // notified of any necessary changes, so there is nothing else to do
-      // here.
+    LogicalResult matchResult =
+        matcher.matchAndRewrite(op, *this, canApply, onFailure, onSuccess);
 #ifndef NDEBUG
-      auto canApply = [&](const Pattern &pattern) {
-        LLVM_DEBUG({
-          logger.getOStream() << "\n";
-          logger.startLine() << "* Pattern " << pattern.getDebugName() << " : '"
-                             << op->getName() << " -> (";
-          llvm::interleaveComma(pattern.getGeneratedOps(), logger.getOStream());
-          logger.getOStream() << ")' {\n";
-          logger.indent();
-        });
-        return true;
-      };
-      auto onFailure = [&](const Pattern &pattern) {
-        LLVM_DEBUG(logResult("failure", "pattern failed to match"));
-      };
-      auto onSuccess = [&](const Pattern &pattern) {
-        LLVM_DEBUG(logResult("success", "pattern applied successfully"));
-        return success();
-      };
-
-      LogicalResult matchResult =
-          matcher.matchAndRewrite(op, *this, canApply, onFailure, onSuccess);
-      if (succeeded(matchResult))
-        LLVM_DEBUG(logResultWithLine("success", "pattern matched"));
-      else
-        LLVM_DEBUG(logResultWithLine("failure", "pattern failed to match"));
-#else
-      LogicalResult matchResult = matcher.matchAndRewrite(op, *this);
+    if (succeeded(matchResult))
+      LLVM_DEBUG(logResultWithLine("success", "pattern matched"));
+    else
+      LLVM_DEBUG(logResultWithLine("failure", "pattern failed to match"));
 #endif
-      changed |= succeeded(matchResult);
-    }
-
-    // After applying patterns, make sure that the CFG of each of the regions
-    // is kept up to date.
-    if (config.enableRegionSimplification)
-      changed |= succeeded(simplifyRegions(*this, regions));
-  } while (changed &&
-           (++iteration < config.maxIterations ||
-            config.maxIterations == GreedyRewriteConfig::kNoIterationLimit));
+    changed |= succeeded(matchResult);
+  }
+  return changed;
+}
 
-  // Whether the rewrite converges, i.e. wasn't changed in the last iteration.
-  return !changed;
+void GreedyPatternRewriteDriver::addUsersToWorklist(Operation *op) {
+  for (auto result : op->getResults())
+    for (auto *userOp : result.getUsers())
+      addToWorklist(userOp);
 }
 
 void GreedyPatternRewriteDriver::addToWorklist(Operation *op) {
@@ -334,9 +466,7 @@ void GreedyPatternRewriteDriver::notifyRootReplaced(Operation *op) {
     logger.startLine() << "** Replace : '" << op->getName() << "'(" << op
                        << ")\n";
   });
-  for (auto result : op->getResults())
-    for (auto *user : result.getUsers())
-      addToWorklist(user);
+  addUsersToWorklist(op);
 }
 
 void GreedyPatternRewriteDriver::eraseOp(Operation *op) {
@@ -347,6 +477,45 @@ void GreedyPatternRewriteDriver::eraseOp(Operation *op) {
   PatternRewriter::eraseOp(op);
 }
 
+void GreedyPatternRewriteDriver::finalizeRootUpdate(Operation *op) {
+  PatternRewriter::finalizeRootUpdate(op);
+  if (!config.useChangeDrivenRevisits)
+    return;
+  LLVM_DEBUG({
+    logger.startLine() << "** Modified: '" << op->getName() << "'(" << op
+                       << ")\n";
+  });
+  addToWorklist(op);
+  addUsersToWorklist(op);
+}
+
+void GreedyPatternRewriteDriver::inlineRegionBefore(Region &region,
+                                                    Region &parent,
+                                                    Region::iterator before) {
+  if (!config.useChangeDrivenRevisits)
+    return PatternRewriter::inlineRegionBefore(region, parent, before);
+
+  // The blocks are moved as a whole, so remember them to find the moved
+  // operations afterwards.
+  SmallVector<Block *, 4> blocks(llvm::make_pointer_range(region));
+  PatternRewriter::inlineRegionBefore(region, parent, before);
+  for (Block *block : blocks)
+    for (Operation &op : *block)
+      addToWorklist(&op);
+}
+
+void GreedyPatternRewriteDriver::mergeBlocks(Block *source, Block *dest,
+                                             ValueRange argValues) {
+  if (!config.useChangeDrivenRevisits)
+    return PatternRewriter::mergeBlocks(source, dest, argValues);
+
+  SmallVector<Operation *, 8> movedOps(
+      llvm::make_pointer_range(source->getOperations()));
+  PatternRewriter::mergeBlocks(source, dest, argValues);
+  for (Operation *op : movedOps)
+    addToWorklist(op);
+}
+
 LogicalResult GreedyPatternRewriteDriver::notifyMatchFailure(
     Operation *op, function_ref<void(Diagnostic &)> reasonCallback) {
   LLVM_DEBUG({
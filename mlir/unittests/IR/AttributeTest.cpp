@@ -6,6 +6,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinAttributes.h"
 #include "mlir/IR/BuiltinTypes.h"
 #include "gtest/gtest.h"
@@ -250,4 +251,59 @@ TEST(SparseElementsAttrTest, GetZero) {
   EXPECT_TRUE(zeroStringValue.getType() == stringTy);
 }
 
+
+//===----------------------------------------------------------------------===//
+// DenseResourceElementsAttr
+//===----------------------------------------------------------------------===//
+
+TEST(DenseResourceElementsAttrTest, UnmanagedBlob) {
+  MLIRContext context;
+  Builder builder(&context);
+
+  // The attribute references the data directly, without copying it.
+  std::vector<int32_t> data = {1, 2, 3, 4};
+  auto type = RankedTensorType::get({2, 2}, builder.getI32Type());
+  auto attr = DenseResourceElementsAttr::get(
+      type, "resource", UnmanagedAsmResourceBlob::allocate<int32_t>(data));
+  ASSERT_TRUE(attr.getBlob());
+  EXPECT_EQ(attr.getBlob()->getData().data(), (const char *)data.data());
+  EXPECT_EQ(attr.getRawHandle().getKey(), "resource");
+
+  Optional<ArrayRef<int32_t>> values = attr.tryGetAsArrayRef<int32_t>();
+  ASSERT_TRUE(values.hasValue());
+  EXPECT_EQ(*values, llvm::makeArrayRef(data));
+
+  // Accessing the data with a mismatched storage size fails.
+  EXPECT_FALSE(attr.tryGetAsArrayRef<int64_t>().hasValue());
+
+  // Attributes are uniqued by handle, not by content: a second blob with the
+  // same name and data gets a distinct handle.
+  auto otherAttr = DenseResourceElementsAttr::get(
+      type, "resource", UnmanagedAsmResourceBlob::allocate<int32_t>(data));
+  EXPECT_NE(attr, otherAttr);
+  EXPECT_NE(otherAttr.getRawHandle().getKey(), "resource");
+}
+
+TEST(DenseResourceElementsAttrTest, LazyData) {
+  MLIRContext context;
+  Builder builder(&context);
+
+  // A handle may be referenced before its data is provided.
+  DialectResourceBlobManager &manager =
+      DenseResourceElementsHandle::getManager(&context);
+  auto type = RankedTensorType::get({3}, builder.getF32Type());
+  auto attr =
+      DenseResourceElementsAttr::get(type, &manager.getOrInsert("lazy"));
+  EXPECT_FALSE(attr.getBlob());
+  EXPECT_FALSE(attr.tryGetAsArrayRef<float>().hasValue());
+
+  float data[] = {1.0f, 2.0f, 3.0f};
+  manager.update("lazy", HeapAsmResourceBlob::allocateAndCopy(
+                             llvm::makeArrayRef<float>(data)));
+  Optional<ArrayRef<float>> values = attr.tryGetAsArrayRef<float>();
+  ASSERT_TRUE(values.hasValue());
+  EXPECT_EQ(*values, llvm::makeArrayRef<float>(data));
+  EXPECT_NE(values->data(), data);
+}
+
 } // namespace
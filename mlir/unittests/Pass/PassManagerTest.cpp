@@ -12,6 +12,7 @@
 #include "mlir/Pass/Pass.h"
 #include "gtest/gtest.h"
 
+#include <atomic>
 #include <memory>
 
 using namespace mlir;
@@ -76,6 +77,75 @@ TEST(PassManagerTest, OpSpecificAnalysis) {
   }
 }
 
+namespace {
+/// Pass that annotates a FuncOp and counts the number of times it ran.
+struct CountingFunctionPass
+    : public PassWrapper<CountingFunctionPass, OperationPass<FuncOp>> {
+  CountingFunctionPass(std::atomic<int> &numRuns) : numRuns(numRuns) {}
+  void runOnOperation() override {
+    ++numRuns;
+    FuncOp op = getOperation();
+    op->setAttr("annotated", UnitAttr::get(op.getContext()));
+  }
+  std::atomic<int> &numRuns;
+};
+
+/// Create a module with functions with the given names.
+OwningModuleRef createModule(MLIRContext &context, ArrayRef<StringRef> names) {
+  Builder builder(&context);
+  OwningModuleRef module(ModuleOp::create(builder.getUnknownLoc()));
+  for (StringRef name : names) {
+    FuncOp func =
+        FuncOp::create(builder.getUnknownLoc(), name,
+                       builder.getFunctionType(llvm::None, llvm::None));
+    func.setPrivate();
+    module->push_back(func);
+  }
+  return module;
+}
+} // namespace
+
+TEST(PassManagerTest, IncrementalExecution) {
+  MLIRContext context;
+  std::atomic<int> numRuns(0);
+  PassManager pm(&context);
+  pm.addNestedPass<FuncOp>(std::make_unique<CountingFunctionPass>(numRuns));
+  pm.enableIncrementalExecution();
+
+  auto isAnnotated = [](ModuleOp module) {
+    return llvm::all_of(module.getOps<FuncOp>(), [](FuncOp func) {
+      return func->hasAttr("annotated");
+    });
+  };
+
+  OwningModuleRef first = createModule(context, {"a", "b"});
+  ASSERT_TRUE(succeeded(pm.run(first.get())));
+  EXPECT_EQ(numRuns, 2);
+  EXPECT_TRUE(isAnnotated(first.get()));
+
+  // An identical module reuses the results of the first run.
+  OwningModuleRef second = createModule(context, {"a", "b"});
+  ASSERT_TRUE(succeeded(pm.run(second.get())));
+  EXPECT_EQ(numRuns, 2);
+  EXPECT_TRUE(isAnnotated(second.get()));
+
+  // Only the new function is processed.
+  OwningModuleRef third = createModule(context, {"a", "c"});
+  ASSERT_TRUE(succeeded(pm.run(third.get())));
+  EXPECT_EQ(numRuns, 3);
+  EXPECT_TRUE(isAnnotated(third.get()));
+
+  // The result for "b" was unused by the last run, and is dropped.
+  OwningModuleRef fourth = createModule(context, {"b"});
+  ASSERT_TRUE(succeeded(pm.run(fourth.get())));
+  EXPECT_EQ(numRuns, 4);
+
+  // Disabling incremental execution runs the pipeline again.
+  pm.enableIncrementalExecution(false);
+  ASSERT_TRUE(succeeded(pm.run(second.get())));
+  EXPECT_EQ(numRuns, 6);
+}
+
 namespace {
 struct InvalidPass : Pass {
   InvalidPass() : Pass(TypeID::get<InvalidPass>(), StringRef("invalid_op")) {}
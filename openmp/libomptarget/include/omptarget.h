@@ -15,8 +15,10 @@
 #define _OMPTARGET_H_
 
 #include <deque>
+#include <functional>
 #include <stddef.h>
 #include <stdint.h>
+#include <vector>
 
 #include <SourceInfo.h>
 
@@ -164,6 +166,10 @@ class AsyncInfoTy {
   /// as long as this AsyncInfoTy object.
   std::deque<void *> BufferLocations;
 
+  /// Functions to run once all pending actions are done, e.g. to release the
+  /// device memory they use, in the order they were added.
+  std::vector<std::function<int()>> PostProcessingFunctions;
+
   __tgt_async_info AsyncInfo;
   DeviceTy &Device;
 
@@ -175,11 +181,17 @@ public:
   /// plugin interface.
   operator __tgt_async_info *() { return &AsyncInfo; }
 
-  /// Synchronize all pending actions.
+  /// Synchronize all pending actions, then run the post-processing functions.
   ///
   /// \returns OFFLOAD_FAIL or OFFLOAD_SUCCESS appropriately.
   int synchronize();
 
+  /// Add a function to run once all the actions issued so far are done. This
+  /// lets the actions of a region be issued without waiting in between.
+  void addPostProcessingFunction(std::function<int()> &&Function) {
+    PostProcessingFunctions.emplace_back(std::move(Function));
+  }
+
   /// Return a void* reference with a lifetime that is at least as long as this
   /// AsyncInfoTy object. The location can be used as intermediate buffer.
   void *&getVoidPtrLocation();
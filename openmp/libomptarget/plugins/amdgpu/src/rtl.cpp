@@ -31,6 +31,7 @@
 #include "rt.h"
 
 #include "DeviceEnvironment.h"
+#include "MemoryManager.h"
 #include "get_elf_mach_gfx_name.h"
 #include "omptargetplugin.h"
 #include "print_tracing.h"
@@ -485,6 +486,51 @@ public:
   std::vector<hsa_amd_memory_pool_t> DeviceFineGrainedMemoryPools;
   std::vector<hsa_amd_memory_pool_t> DeviceCoarseGrainedMemoryPools;
 
+  /// A class responsible for allocating and freeing memory in the
+  /// coarse-grained memory pool of a device.
+  class AMDGPUDeviceAllocatorTy : public DeviceAllocatorTy {
+    const int DeviceId;
+    RTLDeviceInfoTy &DeviceInfo;
+
+  public:
+    AMDGPUDeviceAllocatorTy(int DeviceId, RTLDeviceInfoTy &DeviceInfo)
+        : DeviceId(DeviceId), DeviceInfo(DeviceInfo) {}
+
+    void *allocate(size_t Size, void *, TargetAllocTy) override {
+      if (Size == 0)
+        return nullptr;
+
+      void *Ptr = nullptr;
+      hsa_status_t Err = hsa_amd_memory_pool_allocate(
+          DeviceInfo.getDeviceMemoryPool(DeviceId), Size, 0, &Ptr);
+      if (Err != HSA_STATUS_SUCCESS) {
+        DP("Error when allocating device memory: %s\n", get_error_string(Err));
+        return nullptr;
+      }
+      return Ptr;
+    }
+
+    int free(void *TgtPtr) override {
+      hsa_status_t Err = core::Runtime::Memfree(TgtPtr);
+      if (Err != HSA_STATUS_SUCCESS) {
+        DP("Error when freeing device memory: %s\n", get_error_string(Err));
+        return OFFLOAD_FAIL;
+      }
+      return OFFLOAD_SUCCESS;
+    }
+  };
+
+  /// A vector of device allocators
+  std::vector<AMDGPUDeviceAllocatorTy> DeviceAllocators;
+
+  /// A vector of memory managers, which keep the small allocations freed by
+  /// the target regions in bins for reuse. Since the memory manager is
+  /// non-copyable and non-removable, we wrap them into std::unique_ptr.
+  std::vector<std::unique_ptr<MemoryManagerTy>> MemoryManagers;
+
+  /// Whether use memory manager
+  bool UseMemoryManager = true;
+
   struct implFreePtrDeletor {
     void operator()(void *p) {
       core::Runtime::Memfree(p); // ignore failure to free
@@ -777,6 +823,19 @@ public:
       return;
     }
 
+    for (int i = 0; i < NumberOfDevices; i++)
+      DeviceAllocators.emplace_back(i, *this);
+
+    // Get the size threshold from environment variable
+    std::pair<size_t, bool> Res = MemoryManagerTy::getSizeThresholdFromEnv();
+    UseMemoryManager = Res.second;
+    size_t MemoryManagerThreshold = Res.first;
+
+    if (UseMemoryManager)
+      for (int i = 0; i < NumberOfDevices; i++)
+        MemoryManagers.emplace_back(std::make_unique<MemoryManagerTy>(
+            DeviceAllocators[i], MemoryManagerThreshold));
+
     for (int i = 0; i < NumberOfDevices; i++) {
       uint32_t queue_size = 0;
       {
@@ -830,6 +889,7 @@ public:
     }
     // Run destructors on types that use HSA before
     // impl_finalize removes access to it
+    MemoryManagers.clear();
     deviceStateStore.clear();
     KernelArgPoolMap.clear();
     // Terminate hostrpc before finalizing hsa
@@ -2198,11 +2258,13 @@ void *__tgt_rtl_data_alloc(int device_id, int64_t size, void *, int32_t kind) {
     return NULL;
   }
 
-  hsa_amd_memory_pool_t MemoryPool = DeviceInfo.getDeviceMemoryPool(device_id);
-  hsa_status_t err = hsa_amd_memory_pool_allocate(MemoryPool, size, 0, &ptr);
+  if (DeviceInfo.UseMemoryManager)
+    ptr = DeviceInfo.MemoryManagers[device_id]->allocate(size, nullptr);
+  else
+    ptr = DeviceInfo.DeviceAllocators[device_id].allocate(size, nullptr,
+                                                          (TargetAllocTy)kind);
   DP("Tgt alloc data %ld bytes, (tgt:%016llx).\n", size,
      (long long unsigned)(Elf64_Addr)ptr);
-  ptr = (err == HSA_STATUS_SUCCESS) ? ptr : NULL;
   return ptr;
 }
 
@@ -2250,14 +2312,11 @@ int32_t __tgt_rtl_data_retrieve_async(int device_id, void *hst_ptr,
 
 int32_t __tgt_rtl_data_delete(int device_id, void *tgt_ptr) {
   assert(device_id < DeviceInfo.NumberOfDevices && "Device ID too large");
-  hsa_status_t err;
   DP("Tgt free data (tgt:%016llx).\n", (long long unsigned)(Elf64_Addr)tgt_ptr);
-  err = core::Runtime::Memfree(tgt_ptr);
-  if (err != HSA_STATUS_SUCCESS) {
-    DP("Error when freeing CUDA memory\n");
-    return OFFLOAD_FAIL;
-  }
-  return OFFLOAD_SUCCESS;
+  if (DeviceInfo.UseMemoryManager)
+    return DeviceInfo.MemoryManagers[device_id]->free(tgt_ptr);
+
+  return DeviceInfo.DeviceAllocators[device_id].free(tgt_ptr);
 }
 
 int32_t __tgt_rtl_run_target_team_region(int32_t device_id, void *tgt_entry_ptr,
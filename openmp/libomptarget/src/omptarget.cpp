@@ -29,6 +29,17 @@ int AsyncInfoTy::synchronize() {
            "The device plugin should have nulled the queue to indicate there "
            "are no outstanding actions!");
   }
+  if (Result != OFFLOAD_SUCCESS)
+    return Result;
+
+  // Run the post-processing functions once, in order.
+  std::vector<std::function<int()>> Functions;
+  Functions.swap(PostProcessingFunctions);
+  for (auto &Function : Functions) {
+    Result = Function();
+    if (Result != OFFLOAD_SUCCESS)
+      break;
+  }
   return Result;
 }
 
@@ -600,20 +611,42 @@ int targetDataBegin(ident_t *loc, DeviceTy &Device, int32_t arg_num,
 }
 
 namespace {
-/// This structure contains information to deallocate a target pointer, aka.
-/// used to call the function \p DeviceTy::deallocTgtPtr.
-struct DeallocTgtPtrInfo {
+/// This structure contains information to finish unmapping an argument once
+/// the data retrieved from the device has arrived, aka. to restore the host
+/// pointers of the argument and to call the function
+/// \p DeviceTy::deallocTgtPtr.
+struct PostProcessingInfo {
   /// Host pointer used to look up into the map table
   void *HstPtrBegin;
   /// Size of the data
   int64_t DataSize;
+  /// The mapping type (bitfield)
+  int64_t ArgType;
+  /// Whether the mapping of the argument is removed
+  bool DelEntry;
+  /// Whether the target pointer is deallocated
+  bool DeallocTgtPtr;
   /// Whether it has \p ompx_hold modifier
   bool HasHoldModifier;
-
-  DeallocTgtPtrInfo(void *HstPtr, int64_t Size, bool HasHoldModifier)
-      : HstPtrBegin(HstPtr), DataSize(Size), HasHoldModifier(HasHoldModifier) {}
+  /// Whether the mapped object may contain attached pointers
+  bool MayContainAttachedPointers;
+
+  PostProcessingInfo(void *HstPtr, int64_t Size, int64_t ArgType,
+                     bool DelEntry, bool DeallocTgtPtr, bool HasHoldModifier,
+                     bool MayContainAttachedPointers)
+      : HstPtrBegin(HstPtr), DataSize(Size), ArgType(ArgType),
+        DelEntry(DelEntry), DeallocTgtPtr(DeallocTgtPtr),
+        HasHoldModifier(HasHoldModifier),
+        MayContainAttachedPointers(MayContainAttachedPointers) {}
 };
 
+/// Return whether the map entry for the object of \p TPR was marked as
+/// containing attached pointers.
+static bool mayContainAttachedPointers(const TargetPointerResultTy &TPR) {
+  return TPR.MapTableEntry != HostDataToTargetListTy::iterator{} &&
+         TPR.MapTableEntry->getMayContainAttachedPointers();
+}
+
 /// Apply \p CB to the shadow map pointer entries in the range \p Begin, to
 /// \p Begin + \p Size. \p CB is called with a locked shadow pointer map and the
 /// passed iterator can be updated. If the callback returns OFFLOAD_FAIL the
@@ -621,7 +654,7 @@ struct DeallocTgtPtrInfo {
 template <typename CBTy>
 static void applyToShadowMapEntries(DeviceTy &Device, CBTy CB, void *Begin,
                                     uintptr_t Size,
-                                    const TargetPointerResultTy &TPR) {
+                                    bool MayContainAttachedPointers) {
   // If we have an object that is too small to hold a pointer subobject, no need
   // to do any checking.
   if (Size < sizeof(void *))
@@ -629,8 +662,7 @@ static void applyToShadowMapEntries(DeviceTy &Device, CBTy CB, void *Begin,
 
   // If the map entry for the object was never marked as containing attached
   // pointers, no need to do any checking.
-  if (TPR.MapTableEntry == HostDataToTargetListTy::iterator{} ||
-      !TPR.MapTableEntry->getMayContainAttachedPointers())
+  if (!MayContainAttachedPointers)
     return;
 
   uintptr_t LB = (uintptr_t)Begin;
@@ -656,6 +688,53 @@ static void applyToShadowMapEntries(DeviceTy &Device, CBTy CB, void *Begin,
   Device.ShadowMtx.unlock();
 }
 
+/// Finish unmapping the arguments described by \p PostProcessingInfos once the
+/// data retrieved from the device has arrived.
+static int postProcessingTargetDataEnd(
+    DeviceTy &Device, std::vector<PostProcessingInfo> &PostProcessingInfos,
+    void *FromMapperBase) {
+  for (PostProcessingInfo &Info : PostProcessingInfos) {
+    // If we copied back to the host a struct/array containing pointers, we
+    // need to restore the original host pointer values from their shadow
+    // copies. If the struct is going to be deallocated, remove any remaining
+    // shadow pointer entries for this struct.
+    auto CB = [&](ShadowPtrListTy::iterator &Itr) {
+      // If we copied the struct to the host, we need to restore the pointer.
+      if (Info.ArgType & OMP_TGT_MAPTYPE_FROM) {
+        void **ShadowHstPtrAddr = (void **)Itr->first;
+        *ShadowHstPtrAddr = Itr->second.HstPtrVal;
+        DP("Restoring original host pointer value " DPxMOD " for host "
+           "pointer " DPxMOD "\n",
+           DPxPTR(Itr->second.HstPtrVal), DPxPTR(ShadowHstPtrAddr));
+      }
+      // If the struct is to be deallocated, remove the shadow entry.
+      if (Info.DelEntry) {
+        DP("Removing shadow pointer " DPxMOD "\n", DPxPTR((void **)Itr->first));
+        Itr = Device.ShadowPtrMap.erase(Itr);
+      } else {
+        ++Itr;
+      }
+      return OFFLOAD_SUCCESS;
+    };
+    applyToShadowMapEntries(Device, CB, Info.HstPtrBegin, Info.DataSize,
+                            Info.MayContainAttachedPointers);
+  }
+
+  // Deallocate target pointer
+  for (PostProcessingInfo &Info : PostProcessingInfos) {
+    if (!Info.DeallocTgtPtr ||
+        (FromMapperBase && FromMapperBase == Info.HstPtrBegin))
+      continue;
+    int Ret = Device.deallocTgtPtr(Info.HstPtrBegin, Info.DataSize,
+                                   Info.HasHoldModifier);
+    if (Ret != OFFLOAD_SUCCESS) {
+      REPORT("Deallocating data from device failed.\n");
+      return OFFLOAD_FAIL;
+    }
+  }
+
+  return OFFLOAD_SUCCESS;
+}
 } // namespace
 
 /// Internal function to undo the mapping and retrieve the data from the device.
@@ -664,7 +743,7 @@ int targetDataEnd(ident_t *loc, DeviceTy &Device, int32_t ArgNum,
                   int64_t *ArgTypes, map_var_info_t *ArgNames,
                   void **ArgMappers, AsyncInfoTy &AsyncInfo, bool FromMapper) {
   int Ret;
-  std::vector<DeallocTgtPtrInfo> DeallocTgtPtrs;
+  std::vector<PostProcessingInfo> PostProcessingInfos;
   void *FromMapperBase = nullptr;
   // process each input.
   for (int32_t I = ArgNum - 1; I >= 0; --I) {
@@ -795,56 +874,24 @@ int targetDataEnd(ident_t *loc, DeviceTy &Device, int32_t ArgNum,
         FromMapperBase = HstPtrBegin;
       }
 
-      // If we copied back to the host a struct/array containing pointers, we
-      // need to restore the original host pointer values from their shadow
-      // copies. If the struct is going to be deallocated, remove any remaining
-      // shadow pointer entries for this struct.
-      auto CB = [&](ShadowPtrListTy::iterator &Itr) {
-        // If we copied the struct to the host, we need to restore the pointer.
-        if (ArgTypes[I] & OMP_TGT_MAPTYPE_FROM) {
-          void **ShadowHstPtrAddr = (void **)Itr->first;
-          *ShadowHstPtrAddr = Itr->second.HstPtrVal;
-          DP("Restoring original host pointer value " DPxMOD " for host "
-             "pointer " DPxMOD "\n",
-             DPxPTR(Itr->second.HstPtrVal), DPxPTR(ShadowHstPtrAddr));
-        }
-        // If the struct is to be deallocated, remove the shadow entry.
-        if (DelEntry) {
-          DP("Removing shadow pointer " DPxMOD "\n",
-             DPxPTR((void **)Itr->first));
-          Itr = Device.ShadowPtrMap.erase(Itr);
-        } else {
-          ++Itr;
-        }
-        return OFFLOAD_SUCCESS;
-      };
-      applyToShadowMapEntries(Device, CB, HstPtrBegin, DataSize, TPR);
-
-      // Add pointer to the buffer for later deallocation
-      if (DelEntry && !IsHostPtr)
-        DeallocTgtPtrs.emplace_back(HstPtrBegin, DataSize, HasHoldModifier);
+      // The host pointers are restored and the target pointer deallocated
+      // once the data copied back to the host has arrived.
+      PostProcessingInfos.emplace_back(
+          HstPtrBegin, DataSize, ArgTypes[I], DelEntry, DelEntry && !IsHostPtr,
+          HasHoldModifier, mayContainAttachedPointers(TPR));
     }
   }
 
-  // TODO: We should not synchronize here but pass the AsyncInfo object to the
-  //       allocate/deallocate device APIs.
-  //
-  // We need to synchronize before deallocating data.
-  Ret = AsyncInfo.synchronize();
-  if (Ret != OFFLOAD_SUCCESS)
-    return OFFLOAD_FAIL;
-
-  // Deallocate target pointer
-  for (DeallocTgtPtrInfo &Info : DeallocTgtPtrs) {
-    if (FromMapperBase && FromMapperBase == Info.HstPtrBegin)
-      continue;
-    Ret = Device.deallocTgtPtr(Info.HstPtrBegin, Info.DataSize,
-                               Info.HasHoldModifier);
-    if (Ret != OFFLOAD_SUCCESS) {
-      REPORT("Deallocating data from device failed.\n");
-      return OFFLOAD_FAIL;
-    }
-  }
+  // Instead of synchronizing here, finish unmapping the arguments when the
+  // pending actions are synchronized, so that the kernel and the transfers
+  // issued before and after it are not waited for in between.
+  if (!PostProcessingInfos.empty())
+    AsyncInfo.addPostProcessingFunction(
+        [=, &Device, PostProcessingInfos = std::move(PostProcessingInfos)]()
+            mutable {
+          return postProcessingTargetDataEnd(Device, PostProcessingInfos,
+                                             FromMapperBase);
+        });
 
   return OFFLOAD_SUCCESS;
 }
@@ -884,15 +931,22 @@ static int targetDataContiguous(ident_t *loc, DeviceTy &Device, void *ArgsBase,
       return OFFLOAD_FAIL;
     }
 
-    auto CB = [&](ShadowPtrListTy::iterator &Itr) {
-      void **ShadowHstPtrAddr = (void **)Itr->first;
-      *ShadowHstPtrAddr = Itr->second.HstPtrVal;
-      DP("Restoring original host pointer value " DPxMOD
-         " for host pointer " DPxMOD "\n",
-         DPxPTR(Itr->second.HstPtrVal), DPxPTR(ShadowHstPtrAddr));
+    // The host pointers are restored once the data has arrived.
+    bool MayContainAttachedPointers = mayContainAttachedPointers(TPR);
+    AsyncInfo.addPostProcessingFunction([=, &Device]() {
+      auto CB = [&](ShadowPtrListTy::iterator &Itr) {
+        void **ShadowHstPtrAddr = (void **)Itr->first;
+        *ShadowHstPtrAddr = Itr->second.HstPtrVal;
+        DP("Restoring original host pointer value " DPxMOD
+           " for host pointer " DPxMOD "\n",
+           DPxPTR(Itr->second.HstPtrVal), DPxPTR(ShadowHstPtrAddr));
+        ++Itr;
+        return OFFLOAD_SUCCESS;
+      };
+      applyToShadowMapEntries(Device, CB, HstPtrBegin, ArgSize,
+                              MayContainAttachedPointers);
       return OFFLOAD_SUCCESS;
-    };
-    applyToShadowMapEntries(Device, CB, HstPtrBegin, ArgSize, TPR);
+    });
   }
 
   if (ArgType & OMP_TGT_MAPTYPE_TO) {
@@ -912,9 +966,11 @@ static int targetDataContiguous(ident_t *loc, DeviceTy &Device, void *ArgsBase,
                               sizeof(void *), AsyncInfo);
       if (Ret != OFFLOAD_SUCCESS)
         REPORT("Copying data to device failed.\n");
+      ++Itr;
       return Ret;
     };
-    applyToShadowMapEntries(Device, CB, HstPtrBegin, ArgSize, TPR);
+    applyToShadowMapEntries(Device, CB, HstPtrBegin, ArgSize,
+                            mayContainAttachedPointers(TPR));
   }
   return OFFLOAD_SUCCESS;
 }
@@ -1102,7 +1158,8 @@ class PrivateArgumentManagerTy {
     FirstPrivateArgInfoTy(int Index, const void *HstPtr, int64_t Size,
                           const map_var_info_t HstPtrName = nullptr)
         : Index(Index), HstPtrBegin(reinterpret_cast<const char *>(HstPtr)),
-          HstPtrEnd(HstPtrBegin + Size), AlignedSize(Size + Size % Alignment),
+          HstPtrEnd(HstPtrBegin + Size),
+          AlignedSize((Size + Alignment - 1) / Alignment * Alignment),
           HstPtrName(HstPtrName) {}
   };
 
@@ -1403,12 +1460,19 @@ static int processDataAfter(ident_t *loc, int64_t DeviceId, void *HostPtr,
     return OFFLOAD_FAIL;
   }
 
-  // Free target memory for private arguments
-  Ret = PrivateArgumentManager.free();
-  if (Ret != OFFLOAD_SUCCESS) {
-    REPORT("Failed to deallocate target memory for private args\n");
-    return OFFLOAD_FAIL;
-  }
+  // Free target memory for private arguments once the kernel is done. The
+  // manager is moved into the function to keep the packed arguments alive
+  // until they have been transferred.
+  AsyncInfo.addPostProcessingFunction(
+      [PrivateArgumentManager =
+           std::move(PrivateArgumentManager)]() mutable {
+        int Ret = PrivateArgumentManager.free();
+        if (Ret != OFFLOAD_SUCCESS) {
+          REPORT("Failed to deallocate target memory for private args\n");
+          return OFFLOAD_FAIL;
+        }
+        return OFFLOAD_SUCCESS;
+      });
 
   return OFFLOAD_SUCCESS;
 }
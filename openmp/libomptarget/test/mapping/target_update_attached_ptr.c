@@ -0,0 +1,44 @@
+// RUN: %libomptarget-compile-run-and-check-generic
+
+#include <stdio.h>
+
+struct S {
+  int *p;
+  int n;
+};
+
+int main(void) {
+  int A[10];
+  struct S s = {A, 10};
+
+  for (int i = 0; i < 10; ++i)
+    A[i] = 0;
+
+#pragma omp target enter data map(to : s, s.p[0 : 10])
+
+#pragma omp target map(alloc : s, s.p[0 : 10])
+  {
+    s.n = 20;
+    for (int i = 0; i < s.n / 2; ++i)
+      s.p[i] = i;
+  }
+
+  // The host pointer is restored once the struct has been copied back.
+#pragma omp target update from(s)
+  // CHECK: s.p == A: 1, s.n: 20
+  printf("s.p == A: %d, s.n: %d\n", s.p == A, s.n);
+
+  // The device pointer is restored once the struct has been copied over.
+  s.n = 30;
+#pragma omp target update to(s)
+
+#pragma omp target map(alloc : s, s.p[0 : 10])
+  { s.p[0] = s.n; }
+
+#pragma omp target exit data map(from : s.p[0 : 10]) map(release : s)
+
+  // CHECK: A[0]: 30, A[9]: 9
+  printf("A[0]: %d, A[9]: %d\n", A[0], A[9]);
+
+  return 0;
+}
@@ -2516,6 +2516,16 @@ struct kmp_taskdata { /* aligned during dynamic allocation       */
 // Make sure padding above worked
 KMP_BUILD_ASSERT(sizeof(kmp_taskdata_t) % sizeof(void *) == 0);
 
+// Storage of a lock-free task deque. The deque indices grow monotonically and
+// are mapped onto the slots modulo the size. A full buffer is replaced by one
+// twice as large, and the old one is kept until the deque is freed since
+// thieves may still be reading from it.
+typedef struct kmp_task_deque_buffer {
+  struct kmp_task_deque_buffer *tdb_retired; // Buffer this one replaced
+  kmp_int64 tdb_mask; // Number of slots - 1
+  std::atomic<kmp_taskdata_t *> tdb_tasks[1]; // Slots, dynamically sized
+} kmp_task_deque_buffer_t;
+
 // Data for task team but per thread
 typedef struct kmp_base_thread_data {
   kmp_info_p *td_thr; // Pointer back to thread info
@@ -2523,7 +2533,7 @@ typedef struct kmp_base_thread_data {
   // queued?
   kmp_bootstrap_lock_t td_deque_lock; // Lock for accessing deque
   kmp_taskdata_t *
-      *td_deque; // Deque of tasks encountered by td_thr, dynamically allocated
+      *td_deque; // Deque of tasks given to td_thr, dynamically allocated
   kmp_int32 td_deque_size; // Size of deck
   kmp_uint32 td_deque_head; // Head of deque (will wrap)
   kmp_uint32 td_deque_tail; // Tail of deque (will wrap)
@@ -2534,6 +2544,11 @@ typedef struct kmp_base_thread_data {
   kmp_task_stack_t td_susp_tied_tasks; // Stack of suspended tied tasks for task
 // scheduling constraint
 #endif // BUILD_TIED_TASK_STACK
+  // Lock-free (Chase-Lev) deque of tasks encountered by td_thr. Only td_thr
+  // pushes and pops at the tail, other threads steal at the head.
+  std::atomic<kmp_task_deque_buffer_t *> td_lf_deque;
+  std::atomic<kmp_int64> td_lf_tail; // Next index to push at
+  KMP_ALIGN_CACHE std::atomic<kmp_int64> td_lf_head; // Next index to steal
 } kmp_base_thread_data_t;
 
 #define TASK_DEQUE_BITS 8 // Used solely to define INITIAL_TASK_DEQUE_SIZE
@@ -3111,6 +3126,7 @@ extern int __kmp_env_stksize; /* was KMP_STACKSIZE specified? */
 extern int __kmp_env_blocktime; /* was KMP_BLOCKTIME specified? */
 extern int __kmp_env_checks; /* was KMP_CHECKS specified?    */
 extern int __kmp_env_consistency_check; // was KMP_CONSISTENCY_CHECK specified?
+extern int __kmp_env_barrier_pattern; // was KMP_*_BARRIER_PATTERN specified?
 extern int __kmp_generate_warnings; /* should we issue warnings? */
 extern int __kmp_reserve_warn; /* have we issued reserve_threads warning? */
 
@@ -3702,6 +3718,7 @@ extern int __kmp_barrier(enum barrier_type bt, int gtid, int is_split,
                          void (*reduce)(void *, void *));
 extern void __kmp_end_split_barrier(enum barrier_type bt, int gtid);
 extern int __kmp_barrier_gomp_cancel(int gtid);
+extern void __kmp_select_barrier_pattern();
 
 /*!
  * Tell the fork call which compiler generated the fork call, and therefore how
@@ -42,30 +42,93 @@ void __kmp_print_structure(void); // Forward declaration
 // ---------------------------- Barrier Algorithms ----------------------------
 // Distributed barrier
 
+// Return the topology level whose units the distributed barrier groups its
+// threads by: the smallest memory domain (NUMA node, die or last-level cache)
+// that still holds KMP_DIST_BAR_MIN_DOMAIN_CORES cores, so that on chiplet
+// based processors each group polls flags within one chiplet. Falls back to
+// the socket level, which may be -1 if the topology has no sockets.
+#define KMP_DIST_BAR_MIN_DOMAIN_CORES 4
+static int __kmp_dist_bar_domain_level() {
+  KMP_DEBUG_ASSERT(__kmp_topology);
+  int domain_level = __kmp_topology->get_level(KMP_HW_SOCKET);
+  int core_level = __kmp_topology->get_level(KMP_HW_CORE);
+  if (core_level < 0)
+    return domain_level;
+  const kmp_hw_t domain_types[] = {KMP_HW_NUMA, KMP_HW_DIE, KMP_HW_LLC};
+  for (kmp_hw_t type : domain_types) {
+    int level = __kmp_topology->get_level(type);
+    if (level > domain_level && level < core_level &&
+        __kmp_topology->calculate_ratio(core_level, level) >=
+            KMP_DIST_BAR_MIN_DOMAIN_CORES)
+      domain_level = level;
+  }
+  return domain_level;
+}
+
+// Switch all barriers to the distributed barrier when the user did not pick
+// the barrier patterns and the available processors span several memory
+// domains: its groups then keep the gather and release traffic within a
+// domain, while the tree based barriers cross domains on every level.
+// Called during middle initialization, once the topology is known and before
+// any worker thread has been created.
+void __kmp_select_barrier_pattern() {
+  if (__kmp_env_barrier_pattern || !__kmp_topology)
+    return;
+  // Its spinning threads degrade badly when oversubscribed
+  if (__kmp_avail_proc < 2 * distributedBarrier::IDEAL_CONTENTION ||
+      __kmp_dflt_team_nth > __kmp_avail_proc)
+    return;
+  int domain_level = __kmp_dist_bar_domain_level();
+  if (domain_level < 0 || __kmp_topology->get_count(domain_level) < 2)
+    return;
+
+  KA_TRACE(10, ("__kmp_select_barrier_pattern: using the distributed barrier "
+                "across %d domains\n",
+                __kmp_topology->get_count(domain_level)));
+  for (int i = bs_plain_barrier; i < bs_last_barrier; i++) {
+    __kmp_barrier_gather_pattern[i] = bp_dist_bar;
+    __kmp_barrier_release_pattern[i] = bp_dist_bar;
+  }
+  // The hot teams of the roots registered so far were allocated without the
+  // distributed barrier structure.
+  for (int i = 0; i < __kmp_threads_capacity; i++) {
+    kmp_root_t *root = __kmp_root[i];
+    if (root == NULL || root->r.r_hot_team == NULL)
+      continue;
+    kmp_team_t *hot_team = root->r.r_hot_team;
+    if (hot_team->t.t_max_nproc > 1 && hot_team->t.b == NULL)
+      hot_team->t.b = distributedBarrier::allocate(__kmp_dflt_team_nth_ub);
+  }
+}
+
 // Compute how many threads to have polling each cache-line.
 // We want to limit the number of writes to IDEAL_GO_RESOLUTION.
 void distributedBarrier::computeVarsForN(size_t n) {
-  int nsockets = 1;
+  int ndomains = 1;
   if (__kmp_topology) {
-    int socket_level = __kmp_topology->get_level(KMP_HW_SOCKET);
+    int domain_level = __kmp_dist_bar_domain_level();
     int core_level = __kmp_topology->get_level(KMP_HW_CORE);
-    int ncores_per_socket =
-        __kmp_topology->calculate_ratio(core_level, socket_level);
-    nsockets = __kmp_topology->get_count(socket_level);
+    int ncores_per_domain = 1;
+    if (domain_level >= 0) {
+      ndomains = __kmp_topology->get_count(domain_level);
+      if (core_level >= 0)
+        ncores_per_domain =
+            __kmp_topology->calculate_ratio(core_level, domain_level);
+    }
 
-    if (nsockets <= 0)
-      nsockets = 1;
-    if (ncores_per_socket <= 0)
-      ncores_per_socket = 1;
+    if (ndomains <= 0)
+      ndomains = 1;
+    if (ncores_per_domain <= 0)
+      ncores_per_domain = 1;
 
-    threads_per_go = ncores_per_socket >> 1;
+    threads_per_go = ncores_per_domain >> 1;
     if (!fix_threads_per_go) {
       // Minimize num_gos
       if (threads_per_go > 4) {
         if (KMP_OPTIMIZE_FOR_REDUCTIONS) {
           threads_per_go = threads_per_go >> 1;
         }
-        if (threads_per_go > 4 && nsockets == 1)
+        if (threads_per_go > 4 && ndomains == 1)
           threads_per_go = threads_per_go >> 1;
       }
     }
@@ -75,11 +138,11 @@ void distributedBarrier::computeVarsForN(size_t n) {
     num_gos = n / threads_per_go;
     if (n % threads_per_go)
       num_gos++;
-    if (nsockets == 1 || num_gos == 1)
+    if (ndomains == 1 || num_gos == 1)
       num_groups = 1;
     else {
-      num_groups = num_gos / nsockets;
-      if (num_gos % nsockets)
+      num_groups = num_gos / ndomains;
+      if (num_gos % ndomains)
         num_groups++;
     }
     if (num_groups <= 0)
@@ -421,6 +421,7 @@ int __kmp_env_stksize = FALSE; /* KMP_STACKSIZE specified? */
 int __kmp_env_blocktime = FALSE; /* KMP_BLOCKTIME specified? */
 int __kmp_env_checks = FALSE; /* KMP_CHECKS specified?    */
 int __kmp_env_consistency_check = FALSE; /* KMP_CONSISTENCY_CHECK specified? */
+int __kmp_env_barrier_pattern = FALSE; /* KMP_*_BARRIER_PATTERN specified? */
 
 // From KMP_USE_YIELD:
 // 0 = never yield;
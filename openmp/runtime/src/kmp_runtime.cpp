@@ -7266,6 +7266,9 @@ static void __kmp_do_middle_initialize(void) {
     __kmp_avail_proc = __kmp_xproc;
   }
 
+  // Now that the topology and __kmp_avail_proc are known
+  __kmp_select_barrier_pattern();
+
   // If there were empty places in num_threads list (OMP_NUM_THREADS=,,2,3),
   // correct them now
   j = 0;
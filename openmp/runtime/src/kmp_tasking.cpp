@@ -319,6 +319,269 @@ static void __kmp_realloc_task_deque(kmp_info_t *thread,
   thread_data->td.td_deque_size = new_size;
 }
 
+// __kmp_push_locked_task: Add a task to the tail of the locked deque of a
+// thread, expanding the deque if it is full.
+static void __kmp_push_locked_task(kmp_info_t *thread,
+                                   kmp_thread_data_t *thread_data,
+                                   kmp_taskdata_t *taskdata) {
+  __kmp_acquire_bootstrap_lock(&thread_data->td.td_deque_lock);
+  if (TCR_4(thread_data->td.td_deque_ntasks) >=
+      TASK_DEQUE_SIZE(thread_data->td)) {
+    __kmp_realloc_task_deque(thread, thread_data);
+  }
+  thread_data->td.td_deque[thread_data->td.td_deque_tail] = taskdata;
+  // Wrap index.
+  thread_data->td.td_deque_tail =
+      (thread_data->td.td_deque_tail + 1) & TASK_DEQUE_MASK(thread_data->td);
+  TCW_4(thread_data->td.td_deque_ntasks,
+        TCR_4(thread_data->td.td_deque_ntasks) + 1);
+  __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
+}
+
+// The lock-free deque of a thread holds the tasks the thread pushes itself.
+// It is the deque of Chase and Lev, with the memory orderings of Le et al.
+// ("Correct and Efficient Work-Stealing for Weak Memory Models"): the owner
+// pushes and pops at the tail without atomic read-modify-writes, except to pop
+// the last task, and thieves claim the task at the head with a CAS. A task is
+// only looked at once claimed, as __kmp_task_is_allowed may acquire locks and
+// as a task claimed by another thread may be freed at any time.
+
+// __kmp_alloc_lf_deque_buffer: Allocates the zeroed storage of a lock-free
+// deque of size tasks, size being a power of 2.
+static kmp_task_deque_buffer_t *__kmp_alloc_lf_deque_buffer(kmp_int64 size) {
+  kmp_task_deque_buffer_t *buffer = (kmp_task_deque_buffer_t *)__kmp_allocate(
+      sizeof(kmp_task_deque_buffer_t) +
+      (size - 1) * sizeof(std::atomic<kmp_taskdata_t *>));
+  buffer->tdb_mask = size - 1;
+  return buffer;
+}
+
+// __kmp_grow_lf_deque: Replaces the full storage of the lock-free deque of the
+// calling thread by one twice as large. The tasks keep their indices, so that
+// thieves can keep stealing from the old storage until they see the new one.
+static kmp_task_deque_buffer_t *
+__kmp_grow_lf_deque(kmp_info_t *thread, kmp_thread_data_t *thread_data,
+                    kmp_task_deque_buffer_t *buffer, kmp_int64 head,
+                    kmp_int64 tail) {
+  kmp_int64 size = buffer->tdb_mask + 1;
+  KE_TRACE(10, ("__kmp_grow_lf_deque: T#%d reallocating deque[from "
+                "%" KMP_INT64_SPEC " to %" KMP_INT64_SPEC "] for thread_data "
+                "%p\n",
+                __kmp_gtid_from_thread(thread), size, 2 * size, thread_data));
+
+  kmp_task_deque_buffer_t *new_buffer = __kmp_alloc_lf_deque_buffer(2 * size);
+  for (kmp_int64 i = head; i < tail; ++i) {
+    kmp_taskdata_t *taskdata =
+        KMP_ATOMIC_LD_RLX(&buffer->tdb_tasks[i & buffer->tdb_mask]);
+    KMP_ATOMIC_ST_RLX(&new_buffer->tdb_tasks[i & new_buffer->tdb_mask],
+                      taskdata);
+  }
+  new_buffer->tdb_retired = buffer;
+  KMP_ATOMIC_ST_REL(&thread_data->td.td_lf_deque, new_buffer);
+  return new_buffer;
+}
+
+// __kmp_lf_deque_full: Check if the lock-free deque of the calling thread is
+// full. Thieves can only make room concurrently.
+static inline bool __kmp_lf_deque_full(kmp_thread_data_t *thread_data) {
+  kmp_task_deque_buffer_t *buffer =
+      KMP_ATOMIC_LD_RLX(&thread_data->td.td_lf_deque);
+  return KMP_ATOMIC_LD_RLX(&thread_data->td.td_lf_tail) -
+             KMP_ATOMIC_LD_ACQ(&thread_data->td.td_lf_head) >
+         buffer->tdb_mask;
+}
+
+// __kmp_lf_deque_push: Add a task to the tail of the lock-free deque of the
+// calling thread, expanding the deque if it is full.
+static void __kmp_lf_deque_push(kmp_info_t *thread,
+                                kmp_thread_data_t *thread_data,
+                                kmp_taskdata_t *taskdata) {
+  kmp_int64 tail = KMP_ATOMIC_LD_RLX(&thread_data->td.td_lf_tail);
+  kmp_int64 head = KMP_ATOMIC_LD_ACQ(&thread_data->td.td_lf_head);
+  kmp_task_deque_buffer_t *buffer =
+      KMP_ATOMIC_LD_RLX(&thread_data->td.td_lf_deque);
+  if (tail - head > buffer->tdb_mask)
+    buffer = __kmp_grow_lf_deque(thread, thread_data, buffer, head, tail);
+  KMP_ATOMIC_ST_RLX(&buffer->tdb_tasks[tail & buffer->tdb_mask], taskdata);
+  // Publish the task to the thieves
+  KMP_ATOMIC_ST_REL(&thread_data->td.td_lf_tail, tail + 1);
+}
+
+// __kmp_lf_deque_pop: Remove the task at the tail of the lock-free deque of
+// the calling thread. Returns NULL if the deque is empty, or if a thief got
+// its last task first.
+static kmp_taskdata_t *__kmp_lf_deque_pop(kmp_thread_data_t *thread_data) {
+  kmp_int64 tail = KMP_ATOMIC_LD_RLX(&thread_data->td.td_lf_tail) - 1;
+  // The head only moves forward, so there is no need to claim a task from an
+  // empty deque.
+  if (tail < KMP_ATOMIC_LD_RLX(&thread_data->td.td_lf_head))
+    return NULL;
+  kmp_task_deque_buffer_t *buffer =
+      KMP_ATOMIC_LD_RLX(&thread_data->td.td_lf_deque);
+  KMP_ATOMIC_ST_RLX(&thread_data->td.td_lf_tail, tail);
+  // Either the thieves see the new tail, or this thread sees their new head
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  kmp_int64 head = KMP_ATOMIC_LD_RLX(&thread_data->td.td_lf_head);
+  kmp_taskdata_t *taskdata = NULL;
+  if (head <= tail) {
+    taskdata = KMP_ATOMIC_LD_RLX(&buffer->tdb_tasks[tail & buffer->tdb_mask]);
+    if (head < tail)
+      return taskdata;
+    // Race the thieves for the last task
+    if (!thread_data->td.td_lf_head.compare_exchange_strong(
+            head, head + 1, std::memory_order_seq_cst,
+            std::memory_order_relaxed))
+      taskdata = NULL;
+  }
+  KMP_ATOMIC_ST_RLX(&thread_data->td.td_lf_tail, tail + 1);
+  return taskdata;
+}
+
+// __kmp_lf_deque_peek: Check the Task Scheduling Constraint for the task at
+// index head of the lock-free deque of another thread, without claiming it.
+// The task may be executed and freed by another thread as soon as it is
+// claimed, so the reads are only trusted while the head has not moved. Returns
+// 1 if the task may be scheduled, 0 if not and -1 if it was claimed meanwhile.
+// The mutexinoutset locks are left to __kmp_task_is_allowed once claimed.
+static int __kmp_lf_deque_peek(kmp_thread_data_t *victim_td, kmp_int64 head,
+                               const kmp_taskdata_t *tasknew,
+                               const kmp_int32 is_constrained,
+                               const kmp_taskdata_t *taskcurr) {
+  if (!is_constrained)
+    return 1;
+  kmp_taskdata_t *current = taskcurr->td_last_tied;
+  KMP_DEBUG_ASSERT(current != NULL);
+  // check if the task is not suspended on barrier
+  if (current->td_flags.tasktype != TASK_EXPLICIT &&
+      current->td_taskwait_thread <= 0)
+    return 1;
+  bool tied = tasknew->td_flags.tiedness == TASK_TIED;
+  kmp_taskdata_t *parent = tasknew->td_parent;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (KMP_ATOMIC_LD_RLX(&victim_td->td.td_lf_head) != head)
+    return -1;
+  if (!tied)
+    return 1;
+  // The ancestors of a task are freed after it, so the same check covers them
+  kmp_int32 level = current->td_level;
+  while (parent != current && parent->td_level > level) {
+    kmp_taskdata_t *next = parent->td_parent;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (KMP_ATOMIC_LD_RLX(&victim_td->td.td_lf_head) != head)
+      return -1;
+    parent = next;
+    KMP_DEBUG_ASSERT(parent != NULL);
+  }
+  return parent == current;
+}
+
+// __kmp_lf_deque_steal: Remove the task at the head of the lock-free deque of
+// another thread. Returns NULL if the deque is empty, or if the TSC does not
+// allow to steal its head task.
+//
+// A thread which has finished its tasks at the barrier must be counted as
+// unfinished again before it claims a task, or else the barrier might be
+// released while it executes the task. It is not counted again once all the
+// threads finished, as the deques are then empty.
+static kmp_taskdata_t *
+__kmp_lf_deque_steal(kmp_int32 gtid, kmp_thread_data_t *victim_td,
+                     kmp_task_team_t *task_team,
+                     std::atomic<kmp_int32> *unfinished_threads,
+                     int *thread_finished, kmp_int32 is_constrained,
+                     kmp_taskdata_t *current) {
+  kmp_taskdata_t *taskdata = NULL;
+  bool counted = false;
+  while (1) {
+    kmp_int64 head = KMP_ATOMIC_LD_ACQ(&victim_td->td.td_lf_head);
+    // Either this thread sees the new tail of the owner popping a task, or
+    // the owner sees the new head if this thread claims it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    kmp_int64 tail = KMP_ATOMIC_LD_ACQ(&victim_td->td.td_lf_tail);
+    if (head >= tail)
+      break;
+    kmp_task_deque_buffer_t *buffer =
+        KMP_ATOMIC_LD_ACQ(&victim_td->td.td_lf_deque);
+    taskdata = KMP_ATOMIC_LD_RLX(&buffer->tdb_tasks[head & buffer->tdb_mask]);
+    int allowed =
+        __kmp_lf_deque_peek(victim_td, head, taskdata, is_constrained, current);
+    if (allowed < 0) {
+      taskdata = NULL;
+      continue; // Another thread claimed the task, try the next one
+    }
+    if (!allowed) {
+      taskdata = NULL;
+      break;
+    }
+    if (*thread_finished && !counted) {
+      kmp_int32 count = KMP_ATOMIC_LD_ACQ(unfinished_threads);
+      do {
+        if (count == 0)
+          break;
+      } while (!unfinished_threads->compare_exchange_weak(count, count + 1));
+      if (count == 0) {
+        taskdata = NULL;
+        break;
+      }
+      counted = true;
+      KA_TRACE(20, ("__kmp_steal_task: T#%d inc unfinished_threads to %d: "
+                    "task_team=%p\n",
+                    gtid, count + 1, task_team));
+    }
+    if (victim_td->td.td_lf_head.compare_exchange_strong(
+            head, head + 1, std::memory_order_seq_cst,
+            std::memory_order_relaxed))
+      break;
+    taskdata = NULL; // Another thread claimed the task, try the next one
+  }
+
+  if (counted) {
+    if (taskdata != NULL) {
+      *thread_finished = FALSE;
+    } else {
+#if KMP_DEBUG
+      kmp_int32 count = -1 +
+#endif
+          KMP_ATOMIC_DEC(unfinished_threads);
+      KA_TRACE(20, ("__kmp_steal_task: T#%d dec unfinished_threads to %d: "
+                    "task_team=%p\n",
+                    gtid, count, task_team));
+    }
+  }
+  return taskdata;
+}
+
+// __kmp_lf_deque_drain: Move the tasks of the lock-free deque of the calling
+// thread to its locked deque, where thieves can steal any task the TSC allows
+// rather than only the head one. Needed once untied tasks are encountered, as
+// the tasks which the TSC allows are then not all at the ends of the deque.
+static void __kmp_lf_deque_drain(kmp_info_t *thread,
+                                 kmp_thread_data_t *thread_data) {
+  __kmp_acquire_bootstrap_lock(&thread_data->td.td_deque_lock);
+  // Popping from the tail and adding to the head keeps the tasks in order
+  kmp_taskdata_t *taskdata;
+  while ((taskdata = __kmp_lf_deque_pop(thread_data)) != NULL) {
+    if (TCR_4(thread_data->td.td_deque_ntasks) >=
+        TASK_DEQUE_SIZE(thread_data->td)) {
+      __kmp_realloc_task_deque(thread, thread_data);
+    }
+    thread_data->td.td_deque_head =
+        (thread_data->td.td_deque_head - 1) & TASK_DEQUE_MASK(thread_data->td);
+    thread_data->td.td_deque[thread_data->td.td_deque_head] = taskdata;
+    TCW_4(thread_data->td.td_deque_ntasks,
+          TCR_4(thread_data->td.td_deque_ntasks) + 1);
+  }
+  __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
+}
+
+// __kmp_thread_data_ntasks: Number of tasks in the deques of a thread. It is
+// only a snapshot when read by another thread.
+static inline kmp_int64
+__kmp_thread_data_ntasks(kmp_thread_data_t *thread_data) {
+  kmp_int64 ntasks = KMP_ATOMIC_LD_RLX(&thread_data->td.td_lf_tail) -
+                     KMP_ATOMIC_LD_RLX(&thread_data->td.td_lf_head);
+  return TCR_4(thread_data->td.td_deque_ntasks) + (ntasks > 0 ? ntasks : 0);
+}
+
 //  __kmp_push_task: Add a task to the thread's deque
 static kmp_int32 __kmp_push_task(kmp_int32 gtid, kmp_task_t *task) {
   kmp_info_t *thread = __kmp_threads[gtid];
@@ -381,6 +644,32 @@ static kmp_int32 __kmp_push_task(kmp_int32 gtid, kmp_task_t *task) {
     __kmp_alloc_task_deque(thread, thread_data);
   }
 
+  if (!task_team->tt.tt_untied_task_encountered) {
+    // Check if deque is full
+    if (__kmp_lf_deque_full(thread_data) && __kmp_enable_task_throttling &&
+        __kmp_task_is_allowed(gtid, __kmp_task_stealing_constraint, taskdata,
+                              thread->th.th_current_task)) {
+      KA_TRACE(20, ("__kmp_push_task: T#%d deque is full; returning "
+                    "TASK_NOT_PUSHED for task %p\n",
+                    gtid, taskdata));
+      return TASK_NOT_PUSHED;
+    }
+
+    // No lock needed since only the owner pushes to its lock-free deque. The
+    // deque is expanded if full to push the task which is not allowed to
+    // execute.
+    __kmp_lf_deque_push(thread, thread_data, taskdata);
+    KMP_FSYNC_RELEASING(thread->th.th_current_task); // releasing self
+    KMP_FSYNC_RELEASING(taskdata); // releasing child
+    KA_TRACE(20, ("__kmp_push_task: T#%d returning TASK_SUCCESSFULLY_PUSHED: "
+                  "task=%p\n",
+                  gtid, taskdata));
+    return TASK_SUCCESSFULLY_PUSHED;
+  }
+
+  // Once untied tasks are encountered, the tasks go to the locked deque
+  __kmp_lf_deque_drain(thread, thread_data);
+
   int locked = 0;
   // Check if deque is full
   if (TCR_4(thread_data->td.td_deque_ntasks) >=
@@ -2682,6 +2971,24 @@ static kmp_task_t *__kmp_remove_my_task(kmp_info_t *thread, kmp_int32 gtid,
 
   thread_data = &task_team->tt.tt_threads_data[__kmp_tid_from_gtid(gtid)];
 
+  // The tasks pushed by this thread come first, then the ones given to it
+  if (UNLIKELY(task_team->tt.tt_untied_task_encountered)) {
+    __kmp_lf_deque_drain(thread, thread_data);
+  }
+  taskdata = __kmp_lf_deque_pop(thread_data);
+  if (taskdata != NULL) {
+    if (__kmp_task_is_allowed(gtid, is_constrained, taskdata,
+                              thread->th.th_current_task)) {
+      KA_TRACE(10, ("__kmp_remove_my_task(exit #0): T#%d task %p removed from "
+                    "lock-free deque\n",
+                    gtid, taskdata));
+      task = KMP_TASKDATA_TO_TASK(taskdata);
+      return task;
+    }
+    // The TSC does not allow to execute the tail task, put it back
+    __kmp_lf_deque_push(thread, thread_data, taskdata);
+  }
+
   KA_TRACE(10, ("__kmp_remove_my_task(enter): T#%d ntasks=%d head=%u tail=%u\n",
                 gtid, thread_data->td.td_deque_ntasks,
                 thread_data->td.td_deque_head, thread_data->td.td_deque_tail));
@@ -2766,6 +3073,36 @@ static kmp_task_t *__kmp_steal_task(kmp_info_t *victim_thr, kmp_int32 gtid,
                 victim_td->td.td_deque_ntasks, victim_td->td.td_deque_head,
                 victim_td->td.td_deque_tail));
 
+  // The tasks the victim pushed come first, then the ones given to it
+  current = __kmp_threads[gtid]->th.th_current_task;
+  taskdata =
+      __kmp_lf_deque_steal(gtid, victim_td, task_team, unfinished_threads,
+                           thread_finished, is_constrained, current);
+  if (taskdata != NULL) {
+    if (!__kmp_task_is_allowed(gtid, is_constrained, taskdata, current)) {
+      // A mutexinoutset lock is held by another task, and the stolen task
+      // can't be put back. Move it to the locked deque of this thread.
+      kmp_info_t *thread = __kmp_threads[gtid];
+      kmp_thread_data_t *thread_data =
+          &threads_data[__kmp_tid_from_gtid(gtid)];
+      if (thread_data->td.td_deque == NULL) {
+        __kmp_alloc_task_deque(thread, thread_data);
+      }
+      __kmp_push_locked_task(thread, thread_data, taskdata);
+      KA_TRACE(10, ("__kmp_steal_task(exit #0): T#%d could not execute task %p "
+                    "stolen from T#%d: moved it to its own deque\n",
+                    gtid, taskdata, __kmp_gtid_from_thread(victim_thr)));
+      return NULL;
+    }
+    KMP_COUNT_BLOCK(TASK_stolen);
+    KA_TRACE(10, ("__kmp_steal_task(exit #0): T#%d stole task %p from T#%d: "
+                  "task_team=%p\n",
+                  gtid, taskdata, __kmp_gtid_from_thread(victim_thr),
+                  task_team));
+    task = KMP_TASKDATA_TO_TASK(taskdata);
+    return task;
+  }
+
   if (TCR_4(victim_td->td.td_deque_ntasks) == 0) {
     KA_TRACE(10, ("__kmp_steal_task(exit #1): T#%d could not steal from T#%d: "
                   "task_team=%p ntasks=%d head=%u tail=%u\n",
@@ -2789,7 +3126,6 @@ static kmp_task_t *__kmp_steal_task(kmp_info_t *victim_thr, kmp_int32 gtid,
   }
 
   KMP_DEBUG_ASSERT(victim_td->td.td_deque != NULL);
-  current = __kmp_threads[gtid]->th.th_current_task;
   taskdata = victim_td->td.td_deque[victim_td->td.td_deque_head];
   if (__kmp_task_is_allowed(gtid, is_constrained, taskdata, current)) {
     // Bump head pointer and Wrap.
@@ -2868,6 +3204,37 @@ static kmp_task_t *__kmp_steal_task(kmp_info_t *victim_thr, kmp_int32 gtid,
   return task;
 }
 
+// __kmp_select_victim: Pick a random thread other than tid to steal from.
+// When the threads are bound to places, draw two threads and keep the one
+// bound closest to the calling thread. The places are sorted by topology, so
+// this favors the threads which share caches with the calling thread, while
+// still letting any thread be picked.
+static inline kmp_int32 __kmp_select_victim(kmp_info_t *thread,
+                                            kmp_thread_data_t *threads_data,
+                                            kmp_int32 tid, kmp_int32 nthreads) {
+  kmp_int32 victim_tid = __kmp_get_random(thread) % (nthreads - 1);
+  if (victim_tid >= tid) {
+    ++victim_tid; // Adjusts random distribution to exclude self
+  }
+#if KMP_AFFINITY_SUPPORTED
+  int place = thread->th.th_current_place;
+  if (nthreads > 2 && place >= 0) {
+    kmp_int32 other_tid = __kmp_get_random(thread) % (nthreads - 1);
+    if (other_tid >= tid) {
+      ++other_tid;
+    }
+    int victim_place = threads_data[victim_tid].td.td_thr->th.th_current_place;
+    int other_place = threads_data[other_tid].td.td_thr->th.th_current_place;
+    if (other_place >= 0 &&
+        (victim_place < 0 ||
+         abs(other_place - place) < abs(victim_place - place))) {
+      victim_tid = other_tid;
+    }
+  }
+#endif // KMP_AFFINITY_SUPPORTED
+  return victim_tid;
+}
+
 // __kmp_execute_tasks_template: Choose and execute tasks until either the
 // condition is statisfied (return true) or there are none left (return false).
 //
@@ -2937,10 +3304,8 @@ static inline int __kmp_execute_tasks_template(
             // Pick a random thread. Initial plan was to cycle through all the
             // threads, and only return if we tried to steal from every thread,
             // and failed.  Arch says that's not such a great idea.
-            victim_tid = __kmp_get_random(thread) % (nthreads - 1);
-            if (victim_tid >= tid) {
-              ++victim_tid; // Adjusts random distribution to exclude self
-            }
+            victim_tid = __kmp_select_victim(thread, threads_data, tid,
+                                             nthreads);
             // Found a potential victim
             other_thread = threads_data[victim_tid].td.td_thr;
             // There is a slight chance that __kmp_enable_tasking() did not wake
@@ -3024,7 +3389,8 @@ static inline int __kmp_execute_tasks_template(
       KMP_YIELD(__kmp_library == library_throughput); // Yield before next task
       // If execution of a stolen task results in more tasks being placed on our
       // run queue, reset use_own_tasks
-      if (!use_own_tasks && TCR_4(threads_data[tid].td.td_deque_ntasks) != 0) {
+      if (!use_own_tasks &&
+          __kmp_thread_data_ntasks(&threads_data[tid]) != 0) {
         KA_TRACE(20, ("__kmp_execute_tasks_template: T#%d stolen task spawned "
                       "other tasks, restart\n",
                       gtid));
@@ -3283,6 +3649,8 @@ static void __kmp_alloc_task_deque(kmp_info_t *thread,
   KMP_DEBUG_ASSERT(TCR_4(thread_data->td.td_deque_ntasks) == 0);
   KMP_DEBUG_ASSERT(thread_data->td.td_deque_head == 0);
   KMP_DEBUG_ASSERT(thread_data->td.td_deque_tail == 0);
+  KMP_DEBUG_ASSERT(KMP_ATOMIC_LD_RLX(&thread_data->td.td_lf_head) ==
+                   KMP_ATOMIC_LD_RLX(&thread_data->td.td_lf_tail));
 
   KE_TRACE(
       10,
@@ -3294,6 +3662,8 @@ static void __kmp_alloc_task_deque(kmp_info_t *thread,
   thread_data->td.td_deque = (kmp_taskdata_t **)__kmp_allocate(
       INITIAL_TASK_DEQUE_SIZE * sizeof(kmp_taskdata_t *));
   thread_data->td.td_deque_size = INITIAL_TASK_DEQUE_SIZE;
+  KMP_ATOMIC_ST_REL(&thread_data->td.td_lf_deque,
+                    __kmp_alloc_lf_deque_buffer(INITIAL_TASK_DEQUE_SIZE));
 }
 
 // __kmp_free_task_deque:
@@ -3307,6 +3677,14 @@ static void __kmp_free_task_deque(kmp_thread_data_t *thread_data) {
     thread_data->td.td_deque = NULL;
     __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
   }
+  kmp_task_deque_buffer_t *buffer =
+      KMP_ATOMIC_LD_RLX(&thread_data->td.td_lf_deque);
+  while (buffer != NULL) {
+    kmp_task_deque_buffer_t *retired = buffer->tdb_retired;
+    __kmp_free(buffer);
+    buffer = retired;
+  }
+  KMP_ATOMIC_ST_RLX(&thread_data->td.td_lf_deque, NULL);
 
 #ifdef BUILD_TIED_TASK_STACK
   // GEH: Figure out what to do here for td_susp_tied_tasks
@@ -3798,8 +4176,8 @@ void __kmp_tasking_barrier(kmp_team_t *team, kmp_info_t *thread, int gtid) {
 // __kmp_give_task puts a task into a given thread queue if:
 //  - the queue for that thread was created
 //  - there's space in that queue
-// Because of this, __kmp_push_task needs to check if there's space after
-// getting the lock
+// The task goes to the locked deque of the thread, as only the thread itself
+// pushes to its lock-free deque.
 static bool __kmp_give_task(kmp_info_t *thread, kmp_int32 tid, kmp_task_t *task,
                             kmp_int32 pass) {
   kmp_taskdata_t *taskdata = KMP_TASK_TO_TASKDATA(task);
@@ -0,0 +1,68 @@
+// RUN: %libomp-compile-and-run
+// RUN: %libomp-compile && env KMP_BLOCKTIME=infinite %libomp-run
+// RUN: %libomp-compile && env KMP_PLAIN_BARRIER_PATTERN='dist,dist' KMP_FORKJOIN_BARRIER_PATTERN='dist,dist' KMP_REDUCTION_BARRIER_PATTERN='dist,dist' %libomp-run
+// RUN: %libomp-compile && env KMP_BLOCKTIME=infinite KMP_PLAIN_BARRIER_PATTERN='dist,dist' KMP_FORKJOIN_BARRIER_PATTERN='dist,dist' KMP_REDUCTION_BARRIER_PATTERN='dist,dist' %libomp-run
+// RUN: %libomp-compile && env KMP_PLAIN_BARRIER_PATTERN='hyper,hyper' KMP_FORKJOIN_BARRIER_PATTERN='hyper,hyper' KMP_REDUCTION_BARRIER_PATTERN='hyper,hyper' %libomp-run
+#include <stdio.h>
+#include <omp.h>
+
+/**
+ * Run many back-to-back barriers and reductions while growing and shrinking
+ * the team, which makes the distributed barrier recompute its groups and
+ * resize its flag arrays. Whichever barrier the runtime picks for the
+ * machine, every thread must see all the other threads' updates of the
+ * previous phase at each barrier.
+ */
+
+#define NUM_PHASES 200
+#define MAX_THREADS 32
+
+static int counts[MAX_THREADS];
+
+static int test_team_size(int nthreads) {
+  int errors = 0;
+  int sum = 0;
+  int i;
+
+  for (i = 0; i < MAX_THREADS; i++)
+    counts[i] = 0;
+
+  #pragma omp parallel num_threads(nthreads) reduction(+:errors, sum)
+  {
+    int tid = omp_get_thread_num();
+    int nth = omp_get_num_threads();
+    int phase, t;
+    for (phase = 1; phase <= NUM_PHASES; phase++) {
+      counts[tid] = phase;
+      #pragma omp barrier
+      for (t = 0; t < nth; t++)
+        if (counts[t] != phase)
+          errors++;
+      #pragma omp barrier
+    }
+    sum += tid;
+  }
+
+  if (errors || sum != nthreads * (nthreads - 1) / 2) {
+    printf("failed with %d threads: errors = %d, sum = %d\n", nthreads,
+           errors, sum);
+    return 0;
+  }
+  return 1;
+}
+
+int main() {
+  int n;
+  int max = omp_get_max_threads();
+  if (max > MAX_THREADS)
+    max = MAX_THREADS;
+
+  for (n = 1; n <= max; n++)
+    if (!test_team_size(n))
+      return 1;
+  for (n = max; n >= 1; n /= 2)
+    if (!test_team_size(n))
+      return 1;
+  printf("passed\n");
+  return 0;
+}
@@ -0,0 +1,68 @@
+// RUN: %libomp-compile && env KMP_ENABLE_TASK_THROTTLING=0 %libomp-run
+// RUN: %libomp-compile && env KMP_ENABLE_TASK_THROTTLING=1 %libomp-run
+// RUN: %libomp-compile && env OMP_NUM_THREADS=1 %libomp-run
+
+#include <stdio.h>
+#include <omp.h>
+
+/**
+ * Stress the task deques: one thread pushes many more tasks than fit in the
+ * initial deque while the other threads steal them, and every thread then
+ * spawns nested tied and untied tasks which are popped and stolen
+ * concurrently. Each task must run exactly once.
+ */
+
+#define NUM_TASKS 20000
+#define FIB_N 18
+
+static int fib(int n, int untied) {
+  int x, y;
+  if (n < 2)
+    return n;
+  if (untied) {
+    #pragma omp task shared(x) untied
+    x = fib(n - 1, untied);
+    #pragma omp task shared(y) untied
+    y = fib(n - 2, untied);
+  } else {
+    #pragma omp task shared(x)
+    x = fib(n - 1, untied);
+    #pragma omp task shared(y)
+    y = fib(n - 2, untied);
+  }
+  #pragma omp taskwait
+  return x + y;
+}
+
+int main() {
+  int i;
+  int count = 0;
+  int tied = 0;
+  int untied = 0;
+
+  #pragma omp parallel
+  #pragma omp single
+  {
+    for (i = 0; i < NUM_TASKS; i++) {
+      #pragma omp task
+      {
+        #pragma omp atomic
+        count++;
+      }
+    }
+    #pragma omp taskwait
+
+    #pragma omp task shared(tied)
+    tied = fib(FIB_N, 0);
+    #pragma omp task shared(untied)
+    untied = fib(FIB_N, 1);
+  }
+
+  if (count != NUM_TASKS || tied != 2584 || untied != 2584) {
+    printf("failed: count = %d, tied = %d, untied = %d\n", count, tied,
+           untied);
+    return 1;
+  }
+  printf("passed\n");
+  return 0;
+}
@@ -77,6 +77,11 @@ class ScopBuilder {
   // Build the SCoP for Region @p R.
   void buildScop(Region &R, AssumptionCache &AC);
 
+  /// Charge the isl operations spent so far to the budget of the SCoP.
+  ///
+  /// @return False, after invalidating the SCoP, if the budget is exhausted.
+  bool checkComputeOut();
+
   /// Adjust the dimensions of @p Dom that was constructed for @p OldL
   ///        to be compatible to domains constructed for loop @p NewL.
   ///
@@ -1894,6 +1894,10 @@ private:
   /// A number that uniquely represents a Scop within its function
   const int ID;
 
+  /// Number of isl operations charged to the -polly-scop-computeout budget of
+  /// this SCoP by the analyses that share it.
+  unsigned long ComputeOutCharged = 0;
+
   /// Map of values to the MemoryAccess that writes its definition.
   ///
   /// There must be at most one definition per llvm::Instruction in a SCoP.
@@ -2322,6 +2326,28 @@ public:
   /// @param BB   The BasicBlock where it was triggered.
   void invalidate(AssumptionKind Kind, DebugLoc Loc, BasicBlock *BB = nullptr);
 
+  /// Return the isl operations quota for an analysis of this SCoP.
+  ///
+  /// @param LocalMaxOps The analysis' own bound; 0 means no bound.
+  ///
+  /// @return The smaller of @p LocalMaxOps and what is left of the budget
+  ///         shared by all analyses of this SCoP (-polly-scop-computeout),
+  ///         or 0 if neither bounds the analysis. Once the shared budget is
+  ///         exhausted, the quota is a single operation so that the next
+  ///         analysis gives up immediately.
+  unsigned long getComputeOut(unsigned long LocalMaxOps) const;
+
+  /// Charge the operations counted by the isl context of this SCoP since the
+  /// last reset of its operations counter to the shared budget, and reset the
+  /// counter. Must not be called inside an IslMaxOperationsGuard.
+  ///
+  /// @return False if the shared budget is exhausted.
+  bool chargeComputeOut();
+
+  /// Emit a remark that @p Analysis gave up on this SCoP because it exceeded
+  /// its isl operations quota.
+  void reportComputeOut(StringRef Analysis) const;
+
   /// Get the invalid context for this Scop.
   ///
   /// @return The invalid context of this Scop.
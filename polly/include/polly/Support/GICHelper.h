@@ -487,6 +487,15 @@ public:
     return isl_ctx_last_error(IslCtx) == isl_error_quota;
   }
 };
+
+/// Return the number of operations @p IslCtx counted since the last reset of
+/// its operations counter, saturated at @p Limit.
+///
+/// isl does not expose its operations counter, so it is probed by bisection
+/// with temporary quotas. The probes themselves count as O(log(Limit))
+/// operations. The last error of @p IslCtx is preserved. Must not be called
+/// while an IslQuotaScope is active.
+unsigned long getIslOperations(isl_ctx *IslCtx, unsigned long Limit);
 } // end namespace polly
 
 #endif
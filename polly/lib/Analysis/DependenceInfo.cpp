@@ -369,7 +369,8 @@ void Dependences::calculateDependences(Scop &S) {
 
   isl_union_map *StrictWAW = nullptr;
   {
-    IslMaxOperationsGuard MaxOpGuard(IslCtx.get(), OptComputeOut);
+    IslMaxOperationsGuard MaxOpGuard(IslCtx.get(),
+                                     S.getComputeOut(OptComputeOut));
 
     RAW = WAW = WAR = RED = nullptr;
     isl_union_map *Write = isl_union_map_union(isl_union_map_copy(MustWrite),
@@ -478,8 +479,10 @@ void Dependences::calculateDependences(Scop &S) {
 
     // End of max_operations scope.
   }
+  S.chargeComputeOut();
 
   if (isl_ctx_last_error(IslCtx.get()) == isl_error_quota) {
+    S.reportComputeOut("Dependence analysis");
     isl_union_map_free(RAW);
     isl_union_map_free(WAW);
     isl_union_map_free(WAR);
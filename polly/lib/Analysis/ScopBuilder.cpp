@@ -3267,17 +3267,22 @@ bool ScopBuilder::buildAliasGroups() {
 
   splitAliasGroupsByDomain(AliasGroups);
 
+  // All alias groups draw from the same quota such that a SCoP with many
+  // groups gives up as soon as their total exceeds it.
+  IslMaxOperationsGuard MaxOpGuard(scop->getIslCtx().get(),
+                                   scop->getComputeOut(OptComputeOut), false);
   for (AliasGroupTy &AG : AliasGroups) {
     if (!scop->hasFeasibleRuntimeContext())
       return false;
 
     {
-      IslMaxOperationsGuard MaxOpGuard(scop->getIslCtx().get(), OptComputeOut);
+      IslQuotaScope QuotaScope = MaxOpGuard.enter();
       bool Valid = buildAliasGroup(AG, HasWriteAccess);
       if (!Valid)
         return false;
     }
-    if (isl_ctx_last_error(scop->getIslCtx().get()) == isl_error_quota) {
+    if (MaxOpGuard.hasQuotaExceeded()) {
+      scop->reportComputeOut("Alias check construction");
       scop->invalidate(COMPLEXITY, DebugLoc());
       return false;
     }
@@ -3459,6 +3464,15 @@ static void verifyUses(Scop *S, LoopInfo &LI, DominatorTree &DT) {
 }
 #endif
 
+bool ScopBuilder::checkComputeOut() {
+  if (scop->chargeComputeOut())
+    return true;
+
+  scop->reportComputeOut("SCoP construction");
+  scop->invalidate(COMPLEXITY, DebugLoc());
+  return false;
+}
+
 void ScopBuilder::buildScop(Region &R, AssumptionCache &AC) {
   scop.reset(new Scop(R, SE, LI, DT, *SD.getDetectionContext(&R), ORE,
                       SD.getNextID()));
@@ -3533,6 +3547,11 @@ void ScopBuilder::buildScop(Region &R, AssumptionCache &AC) {
 
   addUserAssumptions(AC, InvalidDomainMap);
 
+  if (!checkComputeOut()) {
+    LLVM_DEBUG(dbgs() << "Bailing-out because of too many isl operations\n");
+    return;
+  }
+
   // Initialize the invalid domain.
   for (ScopStmt &Stmt : scop->Stmts)
     if (Stmt.isBlockStmt())
@@ -3561,6 +3580,11 @@ void ScopBuilder::buildScop(Region &R, AssumptionCache &AC) {
       checkForReductions(Stmt);
   }
 
+  if (!checkComputeOut()) {
+    LLVM_DEBUG(dbgs() << "Bailing-out because of too many isl operations\n");
+    return;
+  }
+
   // Check early for a feasible runtime context.
   if (!scop->hasFeasibleRuntimeContext()) {
     LLVM_DEBUG(dbgs() << "Bailing-out because of unfeasible context (early)\n");
@@ -3589,6 +3613,11 @@ void ScopBuilder::buildScop(Region &R, AssumptionCache &AC) {
   addRecordedAssumptions();
 
   scop->simplifyContexts();
+  if (!checkComputeOut()) {
+    LLVM_DEBUG(dbgs() << "Bailing-out because of too many isl operations\n");
+    return;
+  }
+
   if (!buildAliasChecks()) {
     LLVM_DEBUG(dbgs() << "Bailing-out because could not build alias checks\n");
     return;
@@ -3598,6 +3627,10 @@ void ScopBuilder::buildScop(Region &R, AssumptionCache &AC) {
   canonicalizeDynamicBasePtrs();
   verifyInvariantLoads();
   scop->simplifySCoP(true);
+  if (!checkComputeOut()) {
+    LLVM_DEBUG(dbgs() << "Bailing-out because of too many isl operations\n");
+    return;
+  }
 
   // Check late for a feasible runtime context because profitability did not
   // change.
@@ -133,6 +133,12 @@ static cl::opt<bool>
                     cl::desc("Abort if an isl error is encountered"),
                     cl::init(true), cl::cat(PollyCategory));
 
+static cl::opt<unsigned> ScopComputeOut(
+    "polly-scop-computeout",
+    cl::desc("Bound the isl operations spent on a SCoP by ScopInfo and the "
+             "dependence analysis together (0 means no bound)"),
+    cl::Hidden, cl::init(0), cl::ZeroOrMore, cl::cat(PollyCategory));
+
 static cl::opt<bool> PollyPreciseInbounds(
     "polly-precise-inbounds",
     cl::desc("Take more precise inbounds assumptions (do not scale well)"),
@@ -2047,6 +2053,38 @@ void Scop::invalidate(AssumptionKind Kind, DebugLoc Loc, BasicBlock *BB) {
   addAssumption(Kind, isl::set::empty(getParamSpace()), Loc, AS_ASSUMPTION, BB);
 }
 
+unsigned long Scop::getComputeOut(unsigned long LocalMaxOps) const {
+  if (ScopComputeOut == 0)
+    return LocalMaxOps;
+
+  unsigned long Left = 1;
+  if (ComputeOutCharged < ScopComputeOut)
+    Left = ScopComputeOut - ComputeOutCharged;
+  return LocalMaxOps == 0 ? Left : std::min(LocalMaxOps, Left);
+}
+
+bool Scop::chargeComputeOut() {
+  if (ScopComputeOut == 0)
+    return true;
+
+  if (ComputeOutCharged < ScopComputeOut)
+    ComputeOutCharged += getIslOperations(
+        getIslCtx().get(), ScopComputeOut - ComputeOutCharged);
+  isl_ctx_reset_operations(getIslCtx().get());
+  return ComputeOutCharged < ScopComputeOut;
+}
+
+void Scop::reportComputeOut(StringRef Analysis) const {
+  DebugLoc Beg, End;
+  auto P = getBBPairForRegion(&R);
+  getDebugLocations(P, Beg, End);
+
+  LLVM_DEBUG(dbgs() << Analysis << " exceeded its isl operations quota\n");
+  ORE.emit(OptimizationRemarkAnalysis(DEBUG_TYPE, "ComputeOut", Beg, P.first)
+           << Analysis
+           << " exceeded its isl operations quota, giving up on this SCoP.");
+}
+
 isl::set Scop::getInvalidContext() const { return InvalidContext; }
 
 void Scop::printContext(raw_ostream &OS) const {
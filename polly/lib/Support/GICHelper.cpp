@@ -190,6 +190,34 @@ std::string polly::getIslCompatibleName(const std::string &Prefix,
   return getIslCompatibleName(Prefix, ValStr, Suffix);
 }
 
+unsigned long polly::getIslOperations(isl_ctx *IslCtx, unsigned long Limit) {
+  assert(isl_ctx_get_max_operations(IslCtx) == 0 && "Incorrect nesting");
+  int OldOnError = isl_options_get_on_error(IslCtx);
+  isl_error OldError = isl_ctx_last_error(IslCtx);
+  isl_options_set_on_error(IslCtx, ISL_ON_ERROR_CONTINUE);
+
+  // An allocation fails iff the counter has reached the quota. Successful
+  // probes increment the counter, which is accounted for in Probes.
+  unsigned long Low = 0, High = Limit, Probes = 0;
+  while (Low < High) {
+    unsigned long Mid = Low + (High - Low + 1) / 2;
+    isl_ctx_set_max_operations(IslCtx, Mid + Probes);
+    void *Probe = isl_malloc_or_die(IslCtx, 1);
+    if (Probe) {
+      free(Probe);
+      Probes++;
+      High = Mid - 1;
+    } else {
+      Low = Mid;
+    }
+  }
+
+  isl_ctx_set_max_operations(IslCtx, 0);
+  isl_ctx_set_error(IslCtx, OldError);
+  isl_options_set_on_error(IslCtx, OldOnError);
+  return Low;
+}
+
 #if !defined(NDEBUG) || defined(LLVM_ENABLE_DUMP)
 #define ISL_DUMP_OBJECT_IMPL(NAME)                                             \
   void polly::dumpIslObj(const isl::NAME &Obj) {                               \
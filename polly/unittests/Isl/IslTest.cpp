@@ -1178,4 +1178,34 @@ TEST(Isl, Quota) {
   }
 }
 
+TEST(Isl, Operations) {
+  std::unique_ptr<isl_ctx, decltype(&isl_ctx_free)> Ctx(isl_ctx_alloc(),
+                                                        &isl_ctx_free);
+
+  isl_ctx_reset_operations(Ctx.get());
+  EXPECT_EQ(getIslOperations(Ctx.get(), 1000), 0ul);
+
+  // Each allocation uses at least one operation.
+  isl_ctx_reset_operations(Ctx.get());
+  isl::id::alloc(Ctx.get(), "A", nullptr);
+  isl::id::alloc(Ctx.get(), "B", nullptr);
+  unsigned long Ops = getIslOperations(Ctx.get(), 1000);
+  EXPECT_GE(Ops, 2ul);
+  EXPECT_LT(Ops, 1000ul);
+
+  // Measuring the same amount of work gives the same count.
+  isl_ctx_reset_operations(Ctx.get());
+  isl::id::alloc(Ctx.get(), "C", nullptr);
+  isl::id::alloc(Ctx.get(), "D", nullptr);
+  EXPECT_EQ(getIslOperations(Ctx.get(), 1000), Ops);
+
+  // The count saturates at the limit.
+  EXPECT_EQ(getIslOperations(Ctx.get(), 1), 1ul);
+
+  // The context is left as it was.
+  EXPECT_EQ(isl_ctx_last_error(Ctx.get()), isl_error_none);
+  EXPECT_EQ(isl_options_get_on_error(Ctx.get()), ISL_ON_ERROR_WARN);
+  EXPECT_EQ(isl_ctx_get_max_operations(Ctx.get()), 0ul);
+}
+
 } // anonymous namespace
@@ -0,0 +1,547 @@
+// -*- C++ -*-
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef _PSTL_PARALLEL_BACKEND_STD_THREAD_H
+#define _PSTL_PARALLEL_BACKEND_STD_THREAD_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "pstl_config.h"
+
+// A parallel backend which only needs the standard thread support library.
+// Work is run by a process-wide pool of std::threads, which is started the
+// first time a parallel algorithm needs it. A thread waiting for its tasks to
+// complete runs queued tasks in the meantime, so nested parallelism cannot
+// deadlock the pool.
+
+_PSTL_HIDE_FROM_ABI_PUSH
+
+namespace __pstl
+{
+namespace __std_thread_backend
+{
+
+//------------------------------------------------------------------------
+// use to cancel execution
+//------------------------------------------------------------------------
+inline void
+__cancel_execution()
+{
+}
+
+//------------------------------------------------------------------------
+// raw buffer
+//------------------------------------------------------------------------
+
+template <typename _Tp>
+class __buffer
+{
+    std::allocator<_Tp> __allocator_;
+    _Tp* __ptr_;
+    const std::size_t __buf_size_;
+    __buffer(const __buffer&) = delete;
+    void
+    operator=(const __buffer&) = delete;
+
+  public:
+    __buffer(std::size_t __n) : __allocator_(), __ptr_(__allocator_.allocate(__n)), __buf_size_(__n) {}
+
+    operator bool() const { return __ptr_ != nullptr; }
+    _Tp*
+    get() const
+    {
+        return __ptr_;
+    }
+    ~__buffer() { __allocator_.deallocate(__ptr_, __buf_size_); }
+};
+
+// Ranges of at most this many elements are processed by a single task.
+inline constexpr std::size_t __default_chunk_size = 2048;
+
+// Number of chunks per thread a range is split into, so that threads which
+// finish early can pick up the remaining work.
+inline constexpr std::size_t __chunks_per_thread = 4;
+
+class __task_group;
+
+//------------------------------------------------------------------------
+// thread pool
+//------------------------------------------------------------------------
+
+class __thread_pool
+{
+    std::mutex __mutex_;
+    std::condition_variable __cv_;
+    std::deque<std::function<void()>> __tasks_;
+    std::vector<std::thread> __threads_;
+    bool __stop_ = false;
+
+    friend class __task_group;
+
+    void
+    __worker()
+    {
+        std::unique_lock<std::mutex> __lock(__mutex_);
+        for (;;)
+        {
+            __cv_.wait(__lock, [this] { return __stop_ || !__tasks_.empty(); });
+            if (__tasks_.empty())
+                return;
+            std::function<void()> __task = std::move(__tasks_.front());
+            __tasks_.pop_front();
+            __lock.unlock();
+            __task();
+            __lock.lock();
+        }
+    }
+
+  public:
+    __thread_pool()
+    {
+        // The thread calling into a parallel algorithm takes part in it, so
+        // one thread less than the hardware supports is started.
+        unsigned __n = std::thread::hardware_concurrency();
+        for (unsigned __i = 1; __i < __n; ++__i)
+            __threads_.emplace_back([this] { __worker(); });
+    }
+
+    ~__thread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> __lock(__mutex_);
+            __stop_ = true;
+        }
+        __cv_.notify_all();
+        for (std::thread& __t : __threads_)
+            __t.join();
+    }
+
+    __thread_pool(const __thread_pool&) = delete;
+    __thread_pool&
+    operator=(const __thread_pool&) = delete;
+
+    //! The number of threads taking part in parallel algorithms.
+    std::size_t
+    __concurrency() const
+    {
+        return __threads_.size() + 1;
+    }
+
+    static __thread_pool&
+    __instance()
+    {
+        static __thread_pool __pool;
+        return __pool;
+    }
+};
+
+//------------------------------------------------------------------------
+// task group
+//------------------------------------------------------------------------
+
+//! A set of tasks run by the pool, which __wait() waits for. The first
+//! exception thrown by a task is rethrown by __wait().
+class __task_group
+{
+    __thread_pool& __pool_;
+    // Protected by the mutex of the pool.
+    std::size_t __pending_ = 0;
+    std::exception_ptr __exception_;
+
+    __task_group(const __task_group&) = delete;
+    void
+    operator=(const __task_group&) = delete;
+
+  public:
+    __task_group() : __pool_(__thread_pool::__instance()) {}
+
+    ~__task_group() { __wait_for_tasks(); }
+
+    template <typename _Fp>
+    void
+    __run(_Fp __f)
+    {
+        if (__pool_.__concurrency() == 1)
+        {
+            __f();
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> __lock(__pool_.__mutex_);
+            ++__pending_;
+            __pool_.__tasks_.emplace_back([this, __f]() mutable {
+                std::exception_ptr __exception;
+                try
+                {
+                    __f();
+                }
+                catch (...)
+                {
+                    __exception = std::current_exception();
+                }
+                std::lock_guard<std::mutex> __lock(__pool_.__mutex_);
+                if (__exception && !__exception_)
+                    __exception_ = std::move(__exception);
+                if (--__pending_ == 0)
+                    __pool_.__cv_.notify_all();
+            });
+        }
+        __pool_.__cv_.notify_one();
+    }
+
+    void
+    __wait()
+    {
+        __wait_for_tasks();
+        if (__exception_)
+            std::rethrow_exception(std::exchange(__exception_, nullptr));
+    }
+
+  private:
+    void
+    __wait_for_tasks()
+    {
+        std::unique_lock<std::mutex> __lock(__pool_.__mutex_);
+        while (__pending_ != 0)
+        {
+            if (__pool_.__tasks_.empty())
+            {
+                __pool_.__cv_.wait(__lock);
+                continue;
+            }
+            std::function<void()> __task = std::move(__pool_.__tasks_.front());
+            __pool_.__tasks_.pop_front();
+            __lock.unlock();
+            __task();
+            __lock.lock();
+        }
+    }
+};
+
+//! Split [__first, __last) into chunks and call __f(__chunk_first, __chunk_last, __chunk_index) for each of them in
+//! parallel. Returns the number of chunks, which is 1 if the range is processed serially.
+template <typename _Index, typename _Fp>
+std::size_t
+__for_each_chunk(_Index __first, _Index __last, _Fp __f)
+{
+    const std::size_t __n = __last - __first;
+    const std::size_t __max_chunks = __thread_pool::__instance().__concurrency() * __chunks_per_thread;
+    const std::size_t __n_chunks = std::min((__n + __default_chunk_size - 1) / __default_chunk_size, __max_chunks);
+    if (__n_chunks <= 1)
+    {
+        __f(__first, __last, std::size_t(0));
+        return 1;
+    }
+
+    const std::size_t __chunk_size = __n / __n_chunks;
+    const std::size_t __n_larger_chunks = __n % __n_chunks;
+    auto __chunk_begin = [=](std::size_t __i) {
+        return __first + (__i * __chunk_size + std::min(__i, __n_larger_chunks));
+    };
+
+    __task_group __group;
+    for (std::size_t __i = 1; __i < __n_chunks; ++__i)
+        __group.__run([=] { __f(__chunk_begin(__i), __chunk_begin(__i + 1), __i); });
+    __f(__chunk_begin(0), __chunk_begin(1), std::size_t(0));
+    __group.__wait();
+    return __n_chunks;
+}
+
+template <class _ExecutionPolicy, class _Index, class _Fp>
+void
+__parallel_for(_ExecutionPolicy&&, _Index __first, _Index __last, _Fp __f)
+{
+    __std_thread_backend::__for_each_chunk(__first, __last,
+                                           [__f](_Index __i, _Index __j, std::size_t) { __f(__i, __j); });
+}
+
+template <class _ExecutionPolicy, class _Value, class _Index, typename _RealBody, typename _Reduction>
+_Value
+__parallel_reduce(_ExecutionPolicy&&, _Index __first, _Index __last, const _Value& __identity,
+                  const _RealBody& __real_body, const _Reduction& __reduction)
+{
+    if (__first == __last)
+        return __identity;
+
+    std::vector<std::optional<_Value>> __sums(__thread_pool::__instance().__concurrency() * __chunks_per_thread);
+    const std::size_t __n_chunks = __std_thread_backend::__for_each_chunk(
+        __first, __last,
+        [&](_Index __i, _Index __j, std::size_t __chunk) { __sums[__chunk].emplace(__real_body(__i, __j, __identity)); });
+
+    _Value __sum = std::move(*__sums[0]);
+    for (std::size_t __chunk = 1; __chunk < __n_chunks; ++__chunk)
+        __sum = __reduction(std::move(__sum), std::move(*__sums[__chunk]));
+    return __sum;
+}
+
+template <class _ExecutionPolicy, class _Index, class _UnaryOp, class _Tp, class _BinaryOp, class _Reduce>
+_Tp
+__parallel_transform_reduce(_ExecutionPolicy&&, _Index __first, _Index __last, _UnaryOp __u, _Tp __init,
+                            _BinaryOp __combiner, _Reduce __reduce)
+{
+    if (__first == __last)
+        return __init;
+
+    // Each chunk is reduced starting from its first transformed element, and the sums of the chunks are then
+    // combined in order with __init.
+    std::vector<std::optional<_Tp>> __sums(__thread_pool::__instance().__concurrency() * __chunks_per_thread);
+    const std::size_t __n_chunks =
+        __std_thread_backend::__for_each_chunk(__first, __last, [&](_Index __i, _Index __j, std::size_t __chunk) {
+            _Tp __sum = __u(__i);
+            __sums[__chunk].emplace(__reduce(__i + 1, __j, std::move(__sum)));
+        });
+
+    for (std::size_t __chunk = 0; __chunk < __n_chunks; ++__chunk)
+        __init = __combiner(std::move(__init), std::move(*__sums[__chunk]));
+    return __init;
+}
+
+template <class _ExecutionPolicy, typename _Index, typename _Tp, typename _Rp, typename _Cp, typename _Sp, typename _Ap>
+void
+__parallel_strict_scan(_ExecutionPolicy&&, _Index __n, _Tp __initial, _Rp __reduce, _Cp __combine, _Sp __scan,
+                       _Ap __apex)
+{
+    // TODO: Scans are run serially.
+    _Tp __sum = __initial;
+    if (__n)
+        __sum = __combine(__sum, __reduce(_Index(0), __n));
+    __apex(__sum);
+    if (__n)
+        __scan(_Index(0), __n, __initial);
+}
+
+template <class _ExecutionPolicy, class _Index, class _UnaryOp, class _Tp, class _BinaryOp, class _Reduce, class _Scan>
+_Tp
+__parallel_transform_scan(_ExecutionPolicy&&, _Index __n, _UnaryOp, _Tp __init, _BinaryOp, _Reduce, _Scan __scan)
+{
+    return __scan(_Index(0), __n, __init);
+}
+
+template <class _ExecutionPolicy, typename _F1, typename _F2>
+void
+__parallel_invoke(_ExecutionPolicy&&, _F1&& __f1, _F2&& __f2)
+{
+    __task_group __group;
+    __group.__run([&__f2] { std::forward<_F2>(__f2)(); });
+    std::forward<_F1>(__f1)();
+    __group.__wait();
+}
+
+//------------------------------------------------------------------------
+// parallel_merge
+//------------------------------------------------------------------------
+
+//! Merge [__xs, __xe) and [__ys, __ye) into __zs, splitting the work recursively. __leaf_merge merges the pieces of
+//! at most __default_chunk_size elements.
+template <typename _RandomAccessIterator1, typename _RandomAccessIterator2, typename _RandomAccessIterator3,
+          typename _Compare, typename _LeafMerge>
+void
+__parallel_merge_body(_RandomAccessIterator1 __xs, _RandomAccessIterator1 __xe, _RandomAccessIterator2 __ys,
+                      _RandomAccessIterator2 __ye, _RandomAccessIterator3 __zs, _Compare __comp,
+                      _LeafMerge __leaf_merge)
+{
+    const std::size_t __size_x = __xe - __xs;
+    const std::size_t __size_y = __ye - __ys;
+    if (__size_x + __size_y <= __default_chunk_size)
+    {
+        __leaf_merge(__xs, __xe, __ys, __ye, __zs, __comp);
+        return;
+    }
+
+    // Split the larger range in half, and the other one at the matching position, keeping equal elements of the
+    // first range before those of the second one.
+    _RandomAccessIterator1 __xm;
+    _RandomAccessIterator2 __ym;
+    if (__size_x < __size_y)
+    {
+        __ym = __ys + (__size_y / 2);
+        __xm = std::upper_bound(__xs, __xe, *__ym, __comp);
+    }
+    else
+    {
+        __xm = __xs + (__size_x / 2);
+        __ym = std::lower_bound(__ys, __ye, *__xm, __comp);
+    }
+    _RandomAccessIterator3 __zm = __zs + (__xm - __xs) + (__ym - __ys);
+
+    __task_group __group;
+    __group.__run([=] { __std_thread_backend::__parallel_merge_body(__xm, __xe, __ym, __ye, __zm, __comp, __leaf_merge); });
+    __std_thread_backend::__parallel_merge_body(__xs, __xm, __ys, __ym, __zs, __comp, __leaf_merge);
+    __group.__wait();
+}
+
+template <class _ExecutionPolicy, typename _RandomAccessIterator1, typename _RandomAccessIterator2,
+          typename _RandomAccessIterator3, typename _Compare, typename _LeafMerge>
+void
+__parallel_merge(_ExecutionPolicy&&, _RandomAccessIterator1 __xs, _RandomAccessIterator1 __xe,
+                 _RandomAccessIterator2 __ys, _RandomAccessIterator2 __ye, _RandomAccessIterator3 __zs,
+                 _Compare __comp, _LeafMerge __leaf_merge)
+{
+    if (__thread_pool::__instance().__concurrency() == 1)
+        __leaf_merge(__xs, __xe, __ys, __ye, __zs, __comp);
+    else
+        __std_thread_backend::__parallel_merge_body(__xs, __xe, __ys, __ye, __zs, __comp, __leaf_merge);
+}
+
+//------------------------------------------------------------------------
+// parallel_stable_sort
+//------------------------------------------------------------------------
+
+namespace __sort_details
+{
+
+//! Move-constructs elements into raw memory.
+struct __move_construct
+{
+    template <typename _Iterator, typename _OutputIterator>
+    void
+    operator()(_Iterator __x, _OutputIterator __z) const
+    {
+        using _ValueType = typename std::iterator_traits<_OutputIterator>::value_type;
+        ::new (std::addressof(*__z)) _ValueType(std::move(*__x));
+    }
+};
+
+//! Move-assigns elements to constructed objects.
+struct __move_assign
+{
+    template <typename _Iterator, typename _OutputIterator>
+    void
+    operator()(_Iterator __x, _OutputIterator __z) const
+    {
+        *__z = std::move(*__x);
+    }
+};
+
+//! Stable serial merge of [__xs, __xe) and [__ys, __ye) into __zs, moving the elements with __move.
+template <typename _Move>
+struct __serial_merge
+{
+    template <typename _Iterator1, typename _Iterator2, typename _OutputIterator, typename _Compare>
+    void
+    operator()(_Iterator1 __xs, _Iterator1 __xe, _Iterator2 __ys, _Iterator2 __ye, _OutputIterator __zs,
+               _Compare __comp) const
+    {
+        _Move __move;
+        for (; __xs != __xe && __ys != __ye; ++__zs)
+        {
+            if (__comp(*__ys, *__xs))
+                __move(__ys++, __zs);
+            else
+                __move(__xs++, __zs);
+        }
+        for (; __xs != __xe; ++__xs, ++__zs)
+            __move(__xs, __zs);
+        for (; __ys != __ye; ++__ys, ++__zs)
+            __move(__ys, __zs);
+    }
+};
+
+//! Merge pairs of adjacent sorted runs of __src into __dst, which hold the runs starting at the offsets in __bounds.
+//! Updates __bounds to the runs of __dst.
+template <typename _Move, typename _Iterator, typename _OutputIterator, typename _Compare>
+void
+__merge_runs(_Iterator __src, _OutputIterator __dst, std::vector<std::size_t>& __bounds, _Compare __comp)
+{
+    const std::size_t __n_runs = __bounds.size() - 1;
+    __task_group __group;
+    for (std::size_t __i = 0; __i < __n_runs; __i += 2)
+    {
+        const std::size_t __b = __bounds[__i];
+        const std::size_t __m = __bounds[std::min(__i + 1, __n_runs)];
+        const std::size_t __e = __bounds[std::min(__i + 2, __n_runs)];
+        __group.__run([=] {
+            __std_thread_backend::__parallel_merge_body(__src + __b, __src + __m, __src + __m, __src + __e,
+                                                        __dst + __b, __comp, __serial_merge<_Move>());
+        });
+    }
+    __group.__wait();
+
+    std::vector<std::size_t> __merged;
+    for (std::size_t __i = 0; __i < __n_runs; __i += 2)
+        __merged.push_back(__bounds[__i]);
+    __merged.push_back(__bounds[__n_runs]);
+    __bounds.swap(__merged);
+}
+
+} // namespace __sort_details
+
+template <class _ExecutionPolicy, typename _RandomAccessIterator, typename _Compare, typename _LeafSort>
+void
+__parallel_stable_sort(_ExecutionPolicy&&, _RandomAccessIterator __xs, _RandomAccessIterator __xe, _Compare __comp,
+                       _LeafSort __leaf_sort, std::size_t __nsort = 0)
+{
+    using _ValueType = typename std::iterator_traits<_RandomAccessIterator>::value_type;
+
+    // Partial sorts are left to the leaf sort, which only sorts the first __nsort elements.
+    const std::size_t __n = __xe - __xs;
+    const std::size_t __max_runs = __thread_pool::__instance().__concurrency() * __chunks_per_thread;
+    const std::size_t __n_runs = std::min(__n / __default_chunk_size, __max_runs);
+    if (__n_runs <= 1 || (__nsort != 0 && __nsort < __n))
+    {
+        __leaf_sort(__xs, __xe, __comp);
+        return;
+    }
+
+    // Sort runs of the range in parallel, then merge pairs of runs back and forth between the range and a buffer
+    // until a single run is left.
+    std::vector<std::size_t> __bounds(__n_runs + 1);
+    for (std::size_t __i = 0; __i <= __n_runs; ++__i)
+        __bounds[__i] = __i * __n / __n_runs;
+    {
+        __task_group __group;
+        for (std::size_t __i = 0; __i < __n_runs; ++__i)
+        {
+            _RandomAccessIterator __b = __xs + __bounds[__i], __e = __xs + __bounds[__i + 1];
+            __group.__run([=] { __leaf_sort(__b, __e, __comp); });
+        }
+        __group.__wait();
+    }
+
+    __buffer<_ValueType> __buf(__n);
+    _ValueType* __zs = __buf.get();
+    bool __constructed = false;
+    bool __in_buffer = false;
+    while (__bounds.size() > 2)
+    {
+        if (__in_buffer)
+            __sort_details::__merge_runs<__sort_details::__move_assign>(__zs, __xs, __bounds, __comp);
+        else if (__constructed)
+            __sort_details::__merge_runs<__sort_details::__move_assign>(__xs, __zs, __bounds, __comp);
+        else
+            __sort_details::__merge_runs<__sort_details::__move_construct>(__xs, __zs, __bounds, __comp);
+        __constructed = true;
+        __in_buffer = !__in_buffer;
+    }
+
+    __std_thread_backend::__for_each_chunk(std::size_t(0), __n, [=](std::size_t __i, std::size_t __j, std::size_t) {
+        if (__in_buffer)
+            std::move(__zs + __i, __zs + __j, __xs + __i);
+        std::destroy(__zs + __i, __zs + __j);
+    });
+}
+
+} // namespace __std_thread_backend
+} // namespace __pstl
+
+_PSTL_HIDE_FROM_ABI_POP
+
+#endif /* _PSTL_PARALLEL_BACKEND_STD_THREAD_H */